@@ -84,6 +84,14 @@ MaxValue = 0.500
 StepAmount = 0.001
 DefaultValue = 0.010
 
+[OptionRangeFloat]
+GUIName = OutputScale
+OptionName = OutputScale
+MinValue = 0.250
+MaxValue = 1.000
+StepAmount = 0.250
+DefaultValue = 1.000
+
 [/configuration]
 */
 
@@ -0,0 +1,89 @@
+#include "common/byte_stream.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+static std::vector<u8> MakeTestData(u32 size, bool compressible)
+{
+  std::mt19937 rng(size);
+  std::vector<u8> data(size);
+  for (u32 i = 0; i < size; i++)
+    data[i] = compressible ? static_cast<u8>((i / 64) & 0x7) : static_cast<u8>(rng());
+
+  return data;
+}
+
+TEST(ByteStream, ZstdRoundTrip)
+{
+  for (const u32 size : {1u, 100u, 4096u, 1000003u})
+  {
+    for (const bool compressible : {false, true})
+    {
+      const std::vector<u8> data(MakeTestData(size, compressible));
+      std::vector<u8> compressed;
+      ASSERT_TRUE(ByteStream::CompressZstd(data.data(), size, 0, &compressed));
+      if (compressible && size >= 4096)
+      {
+        ASSERT_LT(compressed.size(), data.size() / 8);
+      }
+
+      std::vector<u8> decompressed(size);
+      ASSERT_TRUE(ByteStream::DecompressZstd(compressed.data(), static_cast<u32>(compressed.size()),
+                                             decompressed.data(), size));
+      ASSERT_EQ(decompressed, data);
+    }
+  }
+}
+
+TEST(ByteStream, ZstdEmptyBuffer)
+{
+  std::vector<u8> compressed;
+  ASSERT_TRUE(ByteStream::CompressZstd(nullptr, 0, 0, &compressed));
+  ASSERT_FALSE(compressed.empty());
+  ASSERT_TRUE(ByteStream::DecompressZstd(compressed.data(), static_cast<u32>(compressed.size()), nullptr, 0));
+}
+
+TEST(ByteStream, ZstdWrongSizeFails)
+{
+  const std::vector<u8> data(MakeTestData(4096, true));
+  std::vector<u8> compressed;
+  ASSERT_TRUE(ByteStream::CompressZstd(data.data(), static_cast<u32>(data.size()), 0, &compressed));
+
+  std::vector<u8> decompressed(data.size() * 2);
+  ASSERT_FALSE(ByteStream::DecompressZstd(compressed.data(), static_cast<u32>(compressed.size()),
+                                          decompressed.data(), static_cast<u32>(data.size() - 1)));
+  ASSERT_FALSE(ByteStream::DecompressZstd(compressed.data(), static_cast<u32>(compressed.size()),
+                                          decompressed.data(), static_cast<u32>(data.size() + 1)));
+}
+
+TEST(ByteStream, ZstdCorruptDataFails)
+{
+  const std::vector<u8> data(MakeTestData(65536, false));
+  std::vector<u8> compressed;
+  ASSERT_TRUE(ByteStream::CompressZstd(data.data(), static_cast<u32>(data.size()), 0, &compressed));
+  std::vector<u8> decompressed(data.size());
+
+  // truncated anywhere, including just the checksum
+  for (const size_t size : {static_cast<size_t>(0), static_cast<size_t>(3), compressed.size() / 2,
+                            compressed.size() - 1, compressed.size() - 4})
+  {
+    ASSERT_FALSE(ByteStream::DecompressZstd(compressed.data(), static_cast<u32>(size), decompressed.data(),
+                                            static_cast<u32>(decompressed.size())))
+      << "size " << size;
+  }
+
+  // a flipped bit anywhere in the frame is caught by the magic number, header, or checksum
+  for (size_t offset = 0; offset < compressed.size(); offset += 997)
+  {
+    std::vector<u8> corrupted(compressed);
+    corrupted[offset] ^= 0x10;
+    ASSERT_FALSE(ByteStream::DecompressZstd(corrupted.data(), static_cast<u32>(corrupted.size()),
+                                            decompressed.data(), static_cast<u32>(decompressed.size())))
+      << "offset " << offset;
+  }
+
+  // garbage which isn't a zstd frame at all
+  const std::vector<u8> garbage(MakeTestData(256, false));
+  ASSERT_FALSE(ByteStream::DecompressZstd(garbage.data(), static_cast<u32>(garbage.size()), decompressed.data(),
+                                          static_cast<u32>(decompressed.size())));
+}
@@ -0,0 +1,146 @@
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/path.h"
+#include "common/string_util.h"
+#include "util/cd_image.h"
+#include "util/cue_parser.h"
+#include <cstdio>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+bool ParseCueSheet(CueParser::File* cue, const char* text, Common::Error* error)
+{
+  std::FILE* fp = std::tmpfile();
+  EXPECT_NE(fp, nullptr);
+  if (!fp)
+    return false;
+
+  std::fputs(text, fp);
+  std::rewind(fp);
+  const bool result = cue->Parse(fp, error);
+  std::fclose(fp);
+  return result;
+}
+
+bool ErrorContains(const Common::Error& error, const char* text)
+{
+  return (error.GetMessage().GetStringView().find(text) != std::string_view::npos);
+}
+} // namespace
+
+TEST(CueParser, WaveFileType)
+{
+  CueParser::File cue;
+  Common::Error error;
+  ASSERT_TRUE(ParseCueSheet(&cue,
+                            "FILE \"game (Track 1).bin\" BINARY\n"
+                            "  TRACK 01 MODE2/2352\n"
+                            "    INDEX 01 00:00:00\n"
+                            "FILE \"game (Track 2).wav\" WAVE\n"
+                            "  TRACK 02 AUDIO\n"
+                            "    INDEX 00 00:00:00\n"
+                            "    INDEX 01 00:02:00\n",
+                            &error));
+
+  const CueParser::Track* track1 = cue.GetTrack(1);
+  ASSERT_NE(track1, nullptr);
+  ASSERT_EQ(track1->file, "game (Track 1).bin");
+  ASSERT_EQ(track1->file_type, CueParser::FileType::Binary);
+
+  const CueParser::Track* track2 = cue.GetTrack(2);
+  ASSERT_NE(track2, nullptr);
+  ASSERT_EQ(track2->file, "game (Track 2).wav");
+  ASSERT_EQ(track2->file_type, CueParser::FileType::Wave);
+  ASSERT_EQ(track2->mode, CueParser::TrackMode::Audio);
+  ASSERT_NE(track2->GetIndex(0), nullptr);
+  ASSERT_NE(track2->GetIndex(1), nullptr);
+}
+
+TEST(CueParser, FLACFilesUseWaveFileType)
+{
+  // rippers write compressed audio with the WAVE type, the format comes from the file itself
+  CueParser::File cue;
+  Common::Error error;
+  ASSERT_TRUE(ParseCueSheet(&cue,
+                            "FILE \"game (Track 1).bin\" BINARY\n"
+                            "  TRACK 01 MODE2/2352\n"
+                            "    INDEX 01 00:00:00\n"
+                            "FILE \"game (Track 2).flac\" WAVE\n"
+                            "  TRACK 02 AUDIO\n"
+                            "    INDEX 01 00:00:00\n"
+                            "  TRACK 03 AUDIO\n"
+                            "    INDEX 01 03:00:00\n",
+                            &error));
+
+  // the type carries over to every track in the file
+  for (const u32 track_number : {2u, 3u})
+  {
+    const CueParser::Track* track = cue.GetTrack(track_number);
+    ASSERT_NE(track, nullptr);
+    ASSERT_EQ(track->file, "game (Track 2).flac");
+    ASSERT_EQ(track->file_type, CueParser::FileType::Wave);
+  }
+  ASSERT_EQ(cue.GetTrack(1)->file_type, CueParser::FileType::Binary);
+}
+
+TEST(CueParser, UnknownFileTypeIsRejected)
+{
+  for (const char* type : {"MP3", "AIFF", "MOTOROLA", "OPUS", ""})
+  {
+    const std::string text = std::string("FILE \"game.bin\" ") + type +
+                             "\n"
+                             "  TRACK 01 MODE2/2352\n"
+                             "    INDEX 01 00:00:00\n";
+
+    CueParser::File cue;
+    Common::Error error;
+    ASSERT_FALSE(ParseCueSheet(&cue, text.c_str(), &error)) << "type '" << type << "'";
+    ASSERT_TRUE(ErrorContains(error, "Only BINARY and WAVE")) << error.GetMessage().GetCharArray();
+  }
+}
+
+TEST(CueParser, WaveFileWhichIsNotFLACIsRejected)
+{
+  const std::string dir = Path::Combine(FileSystem::GetWorkingDirectory(), "cue_parser_wave");
+  FileSystem::RecursiveDeleteDirectory(dir.c_str());
+  ASSERT_TRUE(FileSystem::CreateDirectory(dir.c_str(), false));
+
+  const std::vector<u8> sectors(2352 * 16);
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(Path::Combine(dir, "data.bin").c_str(), sectors.data(), sectors.size()));
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(Path::Combine(dir, "audio.bin").c_str(), sectors.data(), sectors.size()));
+
+  std::vector<u8> wave(sectors);
+  std::memcpy(wave.data(), "RIFF", 4);
+  std::memcpy(wave.data() + 8, "WAVE", 4);
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(Path::Combine(dir, "audio.wav").c_str(), wave.data(), wave.size()));
+
+  const char* cue_template = "FILE \"data.bin\" BINARY\n"
+                             "  TRACK 01 MODE2/2352\n"
+                             "    INDEX 01 00:00:00\n"
+                             "FILE \"%s\" %s\n"
+                             "  TRACK 02 AUDIO\n"
+                             "    INDEX 01 00:00:00\n";
+  const std::string cue_path = Path::Combine(dir, "image.cue");
+  Common::Error error;
+
+  // the same layout with a raw audio track opens fine
+  ASSERT_TRUE(FileSystem::WriteStringToFile(
+    cue_path.c_str(), StringUtil::StdStringFromFormat(cue_template, "audio.bin", "BINARY").c_str()));
+  std::unique_ptr<CDImage> image = CDImage::OpenCueSheetImage(cue_path.c_str(), &error);
+  ASSERT_NE(image, nullptr);
+  ASSERT_EQ(image->GetTrackCount(), 2u);
+  image.reset();
+
+  ASSERT_TRUE(FileSystem::WriteStringToFile(
+    cue_path.c_str(), StringUtil::StdStringFromFormat(cue_template, "audio.wav", "WAVE").c_str()));
+  image = CDImage::OpenCueSheetImage(cue_path.c_str(), &error);
+  ASSERT_EQ(image, nullptr);
+  ASSERT_TRUE(ErrorContains(error, "is not FLAC")) << error.GetMessage().GetCharArray();
+
+  ASSERT_TRUE(FileSystem::RecursiveDeleteDirectory(dir.c_str()));
+}
@@ -0,0 +1,107 @@
+#include "common/fifo_queue.h"
+#include <array>
+#include <deque>
+#include <gtest/gtest.h>
+
+TEST(FIFOQueue, PopRangeEmptyQueue)
+{
+  InlineFIFOQueue<u32, 8> queue;
+  std::array<u32, 8> out;
+  out.fill(0xCCCCCCCCu);
+
+  queue.PopRange(out.data(), 0);
+  ASSERT_TRUE(queue.IsEmpty());
+  ASSERT_EQ(out[0], 0xCCCCCCCCu);
+
+  // a queue emptied with PopRange() keeps working from wherever the head ended up
+  for (u32 i = 0; i < 5; i++)
+    queue.Push(i);
+  queue.PopRange(out.data(), 5);
+  ASSERT_TRUE(queue.IsEmpty());
+  queue.PopRange(out.data(), 0);
+  ASSERT_TRUE(queue.IsEmpty());
+
+  queue.Push(100);
+  ASSERT_EQ(queue.Pop(), 100u);
+}
+
+TEST(FIFOQueue, PopRangePartial)
+{
+  InlineFIFOQueue<u16, 16> queue;
+  for (u16 i = 0; i < 10; i++)
+    queue.Push(i);
+
+  std::array<u16, 4> out = {};
+  queue.PopRange(out.data(), 4);
+  ASSERT_EQ(out, (std::array<u16, 4>{{0, 1, 2, 3}}));
+  ASSERT_EQ(queue.GetSize(), 6u);
+  ASSERT_EQ(queue.Peek(), 4u);
+
+  queue.PopRange(out.data(), 2);
+  ASSERT_EQ(out[0], 4u);
+  ASSERT_EQ(out[1], 5u);
+  ASSERT_EQ(queue.GetSize(), 4u);
+  ASSERT_EQ(queue.Peek(), 6u);
+}
+
+TEST(FIFOQueue, PopRangeWrapsAroundEnd)
+{
+  InlineFIFOQueue<u32, 8> queue;
+  std::array<u32, 8> out = {};
+
+  // move the head to 6, so the next eight elements are split between the end and start of the buffer
+  for (u32 i = 0; i < 6; i++)
+    queue.Push(i);
+  queue.PopRange(out.data(), 6);
+
+  for (u32 i = 0; i < 8; i++)
+    queue.Push(100 + i);
+  ASSERT_TRUE(queue.IsFull());
+  ASSERT_LT(queue.GetContiguousSize(), queue.GetSize());
+
+  queue.PopRange(out.data(), 8);
+  for (u32 i = 0; i < 8; i++)
+    ASSERT_EQ(out[i], 100 + i);
+  ASSERT_TRUE(queue.IsEmpty());
+
+  // a pop which ends exactly at the end of the buffer leaves the head at the start
+  for (u32 i = 0; i < 2; i++)
+    queue.Push(200 + i);
+  queue.PopRange(out.data(), 2);
+  ASSERT_EQ(out[0], 200u);
+  ASSERT_EQ(out[1], 201u);
+  queue.Push(300);
+  ASSERT_EQ(queue.GetReadPointer(), queue.GetDataPointer());
+}
+
+TEST(FIFOQueue, RangesMatchSingleElementOperations)
+{
+  InlineFIFOQueue<u8, 13> queue;
+  std::deque<u8> expected;
+  std::array<u8, 13> buffer;
+  u8 next_value = 0;
+
+  for (u32 iteration = 0; iteration < 1000; iteration++)
+  {
+    const u32 push_count = (iteration * 7) % (queue.GetSpace() + 1);
+    for (u32 i = 0; i < push_count; i++)
+    {
+      buffer[i] = next_value;
+      expected.push_back(next_value);
+      next_value++;
+    }
+    queue.PushRange(buffer.data(), push_count);
+
+    const u32 pop_count = (iteration * 5) % (queue.GetSize() + 1);
+    queue.PopRange(buffer.data(), pop_count);
+    for (u32 i = 0; i < pop_count; i++)
+    {
+      ASSERT_EQ(buffer[i], expected.front());
+      expected.pop_front();
+    }
+
+    ASSERT_EQ(queue.GetSize(), static_cast<u32>(expected.size()));
+    for (u32 i = 0; i < queue.GetSize(); i++)
+      ASSERT_EQ(queue.Peek(i), expected[i]);
+  }
+}
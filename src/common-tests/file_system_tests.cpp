@@ -1,3 +1,135 @@
 #include "common/file_system.h"
+#include "common/path.h"
+#include <algorithm>
+#include <ctime>
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+namespace {
+// Directories modified in the same second as a snapshot are always re-enumerated, so the tests backdate them.
+bool SetModificationTime(const std::string& path, std::time_t time)
+{
+#ifdef _WIN32
+  _utimbuf times = {time, time};
+  return (_utime(path.c_str(), &times) == 0);
+#else
+  utimbuf times = {time, time};
+  return (utime(path.c_str(), &times) == 0);
+#endif
+}
+
+std::vector<std::string> FindCachedNames(const std::string& path, u32 flags)
+{
+  FileSystem::FindResultsArray results;
+  FileSystem::FindFilesCached(path.c_str(), "*", flags | FILESYSTEM_FIND_RELATIVE_PATHS, &results);
+
+  std::vector<std::string> names;
+  for (const FILESYSTEM_FIND_DATA& fd : results)
+    names.push_back(Path::ToNativePath(fd.FileName));
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+class FindFilesCachedTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    FileSystem::ClearFindFilesCache();
+    m_root = Path::Combine(FileSystem::GetWorkingDirectory(), "find_files_cached");
+    m_subdir = Path::Combine(m_root, "sub");
+    FileSystem::RecursiveDeleteDirectory(m_root.c_str());
+    ASSERT_TRUE(FileSystem::CreateDirectory(m_subdir.c_str(), true));
+    ASSERT_TRUE(WriteFile(Path::Combine(m_root, "a.txt")));
+    ASSERT_TRUE(WriteFile(Path::Combine(m_subdir, "b.txt")));
+    Backdate(1000);
+  }
+
+  void TearDown() override
+  {
+    FileSystem::ClearFindFilesCache();
+    FileSystem::RecursiveDeleteDirectory(m_root.c_str());
+  }
+
+  static bool WriteFile(const std::string& path) { return FileSystem::WriteStringToFile(path.c_str(), "test"); }
+
+  void Backdate(std::time_t seconds)
+  {
+    const std::time_t time = std::time(nullptr) - seconds;
+    ASSERT_TRUE(SetModificationTime(m_subdir, time));
+    ASSERT_TRUE(SetModificationTime(m_root, time));
+  }
+
+  std::string SubPath(const char* name) const { return Path::ToNativePath(std::string("sub/") + name); }
+
+  std::string m_root;
+  std::string m_subdir;
+};
+} // namespace
+
+TEST_F(FindFilesCachedTest, UnchangedTreeIsNotWalkedAgain)
+{
+  const u32 flags = FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE;
+  const std::vector<std::string> expected = {"a.txt", SubPath("b.txt")};
+  ASSERT_EQ(FindCachedNames(m_root, flags), expected);
+
+  // an entry added behind the cache's back, with the directory's timestamp put back, isn't seen
+  ASSERT_TRUE(WriteFile(Path::Combine(m_subdir, "c.txt")));
+  Backdate(1000);
+  ASSERT_EQ(FindCachedNames(m_root, flags), expected);
+
+  // until the directory's modification time changes
+  Backdate(2000);
+  ASSERT_EQ(FindCachedNames(m_root, flags), (std::vector<std::string>{"a.txt", SubPath("b.txt"), SubPath("c.txt")}));
+
+  // or the cache is cleared
+  ASSERT_TRUE(WriteFile(Path::Combine(m_root, "d.txt")));
+  Backdate(2000);
+  ASSERT_EQ(FindCachedNames(m_root, flags).size(), 3u);
+  FileSystem::ClearFindFilesCache();
+  ASSERT_EQ(FindCachedNames(m_root, flags).size(), 4u);
+}
+
+TEST_F(FindFilesCachedTest, AddedFileIsFound)
+{
+  const u32 flags = FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE;
+  ASSERT_EQ(FindCachedNames(m_root, flags).size(), 2u);
+
+  ASSERT_TRUE(WriteFile(Path::Combine(m_subdir, "c.txt")));
+  ASSERT_EQ(FindCachedNames(m_root, flags), (std::vector<std::string>{"a.txt", SubPath("b.txt"), SubPath("c.txt")}));
+
+  ASSERT_TRUE(WriteFile(Path::Combine(m_root, "d.txt")));
+  ASSERT_EQ(FindCachedNames(m_root, flags),
+            (std::vector<std::string>{"a.txt", "d.txt", SubPath("b.txt"), SubPath("c.txt")}));
+}
+
+TEST_F(FindFilesCachedTest, RemovedFileIsDropped)
+{
+  const u32 flags = FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE;
+  ASSERT_EQ(FindCachedNames(m_root, flags).size(), 2u);
+
+  ASSERT_TRUE(FileSystem::DeleteFile(Path::Combine(m_subdir, "b.txt").c_str()));
+  ASSERT_EQ(FindCachedNames(m_root, flags), (std::vector<std::string>{"a.txt"}));
+
+  ASSERT_TRUE(FileSystem::DeleteFile(Path::Combine(m_root, "a.txt").c_str()));
+  ASSERT_TRUE(FindCachedNames(m_root, flags).empty());
+}
+
+TEST_F(FindFilesCachedTest, FlagsAndPatternFilterSnapshot)
+{
+  FileSystem::FindResultsArray results;
+  ASSERT_TRUE(FileSystem::FindFilesCached(m_root.c_str(), "*.txt", FILESYSTEM_FIND_FILES, &results));
+  ASSERT_EQ(results.size(), 1u);
+  ASSERT_EQ(results[0].FileName, Path::Combine(m_root, "a.txt"));
+
+  ASSERT_EQ(FindCachedNames(m_root, FILESYSTEM_FIND_FOLDERS), (std::vector<std::string>{"sub"}));
+  ASSERT_FALSE(FileSystem::FindFilesCached(m_root.c_str(), "*.bin", FILESYSTEM_FIND_FILES, &results));
+  ASSERT_TRUE(results.empty());
+}
@@ -0,0 +1,162 @@
+#include "common/file_system.h"
+#include "common/mapped_cache.h"
+#include "common/path.h"
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+namespace {
+enum : u32
+{
+  TEST_CACHE_SIGNATURE = 0x54534554,
+  TEST_CACHE_VERSION = 3,
+};
+
+#pragma pack(push, 1)
+struct TestHeader
+{
+  u32 signature;
+  u32 version;
+  u32 num_buckets;
+  u32 num_records;
+  u32 string_pool_size;
+  u32 pad;
+};
+
+struct TestRecord
+{
+  u64 hash;
+  MappedCache::String key;
+  u32 value;
+  u32 pad;
+};
+#pragma pack(pop)
+
+// Writes a cache mapping each key to its index, returning the filename.
+std::string WriteTestCache(const char* name, const std::vector<std::string>& keys)
+{
+  MappedCache::StringPool string_pool;
+  std::vector<TestRecord> records;
+  for (size_t i = 0; i < keys.size(); i++)
+    records.push_back(TestRecord{MappedCache::HashKey(keys[i]), string_pool.Add(keys[i]), static_cast<u32>(i), 0});
+
+  const u32 num_buckets = MappedCache::GetBucketCount(records.size());
+  std::vector<u32> buckets(num_buckets, MappedCache::EMPTY_BUCKET);
+  for (size_t i = 0; i < records.size(); i++)
+  {
+    const u32 bucket = MappedCache::FindFreeBucket(buckets.data(), num_buckets, records[i].hash,
+                                                   [&records, &string_pool, &i](u32 index) {
+                                                     return string_pool.Get(records[index].key) ==
+                                                            string_pool.Get(records[i].key);
+                                                   });
+    EXPECT_NE(bucket, MappedCache::EMPTY_BUCKET);
+    buckets[bucket] = static_cast<u32>(i);
+  }
+
+  TestHeader header = {};
+  header.signature = TEST_CACHE_SIGNATURE;
+  header.version = TEST_CACHE_VERSION;
+  header.num_buckets = num_buckets;
+  header.num_records = static_cast<u32>(records.size());
+  header.string_pool_size = string_pool.GetSize();
+
+  std::string filename(Path::Combine(FileSystem::GetWorkingDirectory(), name));
+  EXPECT_TRUE(MappedCache::WriteFile(filename, {{&header, sizeof(header)},
+                                                {buckets.data(), sizeof(u32) * buckets.size()},
+                                                {records.data(), sizeof(TestRecord) * records.size()},
+                                                {string_pool.GetData(), string_pool.GetSize()}}));
+  return filename;
+}
+
+bool MapFile(const std::string& filename, FileSystem::MappedFile* file)
+{
+  std::FILE* fp = FileSystem::OpenCFile(filename.c_str(), "rb");
+  if (!fp)
+    return false;
+
+  const bool result = file->Map(fp);
+  std::fclose(fp);
+  return result;
+}
+
+bool IsValidTestCache(const FileSystem::MappedFile& file)
+{
+  if (!MappedCache::CheckHeader(file, sizeof(TestHeader), TEST_CACHE_SIGNATURE, TEST_CACHE_VERSION))
+    return false;
+
+  const TestHeader* header = reinterpret_cast<const TestHeader*>(file.GetData());
+  return MappedCache::IsValidLayout(file, sizeof(TestHeader), header->num_buckets, header->num_records,
+                                    sizeof(TestRecord) * static_cast<u64>(header->num_records),
+                                    header->string_pool_size);
+}
+
+u32 FindKey(const FileSystem::MappedFile& file, const std::string& key)
+{
+  const TestHeader* header = reinterpret_cast<const TestHeader*>(file.GetData());
+  const u32* buckets = MappedCache::GetBuckets(file, sizeof(TestHeader));
+  const TestRecord* records =
+    reinterpret_cast<const TestRecord*>(MappedCache::GetRecords(file, sizeof(TestHeader), header->num_buckets));
+  const u64 hash = MappedCache::HashKey(key);
+  const u32 record_index =
+    MappedCache::Find(buckets, header->num_buckets, header->num_records, hash, [&](u32 index) {
+      return records[index].hash == hash &&
+             MappedCache::GetString(file, header->string_pool_size, records[index].key) == key;
+    });
+  return (record_index != MappedCache::EMPTY_BUCKET) ? records[record_index].value : MappedCache::EMPTY_BUCKET;
+}
+} // namespace
+
+TEST(MappedCache, RoundTrip)
+{
+  std::vector<std::string> keys;
+  for (u32 i = 0; i < 500; i++)
+    keys.push_back("key" + std::to_string(i));
+
+  const std::string filename(WriteTestCache("mapped_cache_round_trip.bin", keys));
+  FileSystem::MappedFile file;
+  ASSERT_TRUE(MapFile(filename, &file));
+  ASSERT_TRUE(IsValidTestCache(file));
+
+  for (u32 i = 0; i < static_cast<u32>(keys.size()); i++)
+    ASSERT_EQ(FindKey(file, keys[i]), i);
+  ASSERT_EQ(FindKey(file, "key500"), MappedCache::EMPTY_BUCKET);
+  ASSERT_EQ(FindKey(file, ""), MappedCache::EMPTY_BUCKET);
+
+  // strings past the end of the pool don't read outside the file
+  const TestHeader* header = reinterpret_cast<const TestHeader*>(file.GetData());
+  ASSERT_TRUE(MappedCache::GetString(file, header->string_pool_size, {header->string_pool_size, 1}).empty());
+
+  file.Unmap();
+  ASSERT_TRUE(FileSystem::DeleteFile(filename.c_str()));
+}
+
+TEST(MappedCache, TruncatedFileIsRejected)
+{
+  const std::string filename(WriteTestCache("mapped_cache_truncated.bin", {"a", "b", "c"}));
+  std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(filename.c_str()));
+  ASSERT_TRUE(data.has_value());
+
+  FileSystem::MappedFile file;
+  for (size_t size : {data->size() - 1, sizeof(TestHeader), sizeof(TestHeader) - 1, static_cast<size_t>(4)})
+  {
+    ASSERT_TRUE(FileSystem::WriteBinaryFile(filename.c_str(), data->data(), size));
+    ASSERT_TRUE(MapFile(filename, &file));
+    ASSERT_FALSE(IsValidTestCache(file)) << "size " << size;
+    file.Unmap();
+  }
+
+  ASSERT_TRUE(FileSystem::DeleteFile(filename.c_str()));
+}
+
+TEST(MappedCache, VersionMismatchIsRejected)
+{
+  const std::string filename(WriteTestCache("mapped_cache_version.bin", {"a", "b", "c"}));
+  FileSystem::MappedFile file;
+  ASSERT_TRUE(MapFile(filename, &file));
+  ASSERT_TRUE(MappedCache::CheckHeader(file, sizeof(TestHeader), TEST_CACHE_SIGNATURE, TEST_CACHE_VERSION));
+  ASSERT_FALSE(MappedCache::CheckHeader(file, sizeof(TestHeader), TEST_CACHE_SIGNATURE, TEST_CACHE_VERSION + 1));
+  ASSERT_FALSE(MappedCache::CheckHeader(file, sizeof(TestHeader), TEST_CACHE_SIGNATURE + 1, TEST_CACHE_VERSION));
+
+  file.Unmap();
+  ASSERT_TRUE(FileSystem::DeleteFile(filename.c_str()));
+}
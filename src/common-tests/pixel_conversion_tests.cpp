@@ -0,0 +1,141 @@
+#include "common/pixel_conversion.h"
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr u32 GUARD_VALUE = 0xCDCDCDCDu;
+constexpr u32 MAX_WIDTH = 67;
+
+// Straightforward per-pixel versions of the conversions, rounding to nearest.
+u32 Scale5To8(u32 value)
+{
+  return (value * 255u + 15u) / 31u;
+}
+
+u32 Scale6To8(u32 value)
+{
+  return (value * 255u + 31u) / 63u;
+}
+
+u32 PackRGBA(u32 r, u32 g, u32 b, u32 a, bool bgra)
+{
+  return (bgra ? (b | (r << 16)) : (r | (b << 16))) | (g << 8) | (a << 24);
+}
+
+u32 ReferenceRGBA5551(u16 value, bool bgra)
+{
+  return PackRGBA(Scale5To8(value & 31u), Scale5To8((value >> 5) & 31u), Scale5To8((value >> 10) & 31u),
+                  (value & 0x8000u) ? 0xFFu : 0u, bgra);
+}
+
+u32 ReferenceRGB565(u16 value)
+{
+  return PackRGBA(Scale5To8(value >> 11), Scale6To8((value >> 5) & 63u), Scale5To8(value & 31u), 0xFFu, false);
+}
+
+std::vector<u8> MakeSource(u32 size)
+{
+  std::mt19937 rng(size);
+  std::vector<u8> data(size);
+  for (u8& value : data)
+    value = static_cast<u8>(rng());
+
+  return data;
+}
+
+u16 ReadPixel16(const u8* src, u32 index)
+{
+  return static_cast<u16>(src[index * 2] | (src[index * 2 + 1] << 8));
+}
+
+// Runs the conversion for every width up to MAX_WIDTH, from both an aligned and an odd source address, checking
+// every pixel against the reference and that nothing past the end of the row is written.
+template<typename Convert, typename Reference>
+void CheckAllWidths(u32 bytes_per_pixel, const Convert& convert, const Reference& reference)
+{
+  const std::vector<u8> source(MakeSource(MAX_WIDTH * bytes_per_pixel + 1));
+  std::vector<u32> dst(MAX_WIDTH + 4);
+
+  for (u32 src_offset = 0; src_offset < 2; src_offset++)
+  {
+    // copy the row so it ends at the end of the allocation, which catches reads past the last pixel with ASan
+    for (u32 width = 0; width <= MAX_WIDTH; width++)
+    {
+      const u8* row_start = source.data() + src_offset;
+      std::vector<u8> row(row_start, row_start + width * bytes_per_pixel);
+
+      std::fill(dst.begin(), dst.end(), GUARD_VALUE);
+      convert(dst.data(), row.data(), width);
+
+      for (u32 i = 0; i < width; i++)
+        ASSERT_EQ(dst[i], reference(row.data(), i)) << "width " << width << " offset " << src_offset << " pixel " << i;
+      for (u32 i = width; i < dst.size(); i++)
+        ASSERT_EQ(dst[i], GUARD_VALUE) << "width " << width << " offset " << src_offset << " pixel " << i;
+    }
+  }
+}
+} // namespace
+
+TEST(PixelConversion, RGBA5551AllValues)
+{
+  std::vector<u16> source(65536);
+  for (u32 i = 0; i < 65536; i++)
+    source[i] = static_cast<u16>(i);
+
+  std::vector<u32> rgba(65536), bgra(65536);
+  PixelConversion::ConvertRGBA5551ToRGBA8(rgba.data(), source.data(), 65536);
+  PixelConversion::ConvertRGBA5551ToBGRA8(bgra.data(), source.data(), 65536);
+  for (u32 i = 0; i < 65536; i++)
+  {
+    ASSERT_EQ(rgba[i], ReferenceRGBA5551(static_cast<u16>(i), false)) << "value " << i;
+    ASSERT_EQ(bgra[i], ReferenceRGBA5551(static_cast<u16>(i), true)) << "value " << i;
+  }
+}
+
+TEST(PixelConversion, RGB565AllValues)
+{
+  std::vector<u16> source(65536);
+  for (u32 i = 0; i < 65536; i++)
+    source[i] = static_cast<u16>(i);
+
+  std::vector<u32> dst(65536);
+  PixelConversion::ConvertRGB565ToRGBA8(dst.data(), source.data(), 65536);
+  for (u32 i = 0; i < 65536; i++)
+    ASSERT_EQ(dst[i], ReferenceRGB565(static_cast<u16>(i))) << "value " << i;
+}
+
+TEST(PixelConversion, RGBA5551Widths)
+{
+  for (const u32 alpha_or : {0u, 0xFF000000u})
+  {
+    CheckAllWidths(
+      2,
+      [alpha_or](u32* dst, const u8* src, u32 count) {
+        PixelConversion::ConvertRGBA5551ToRGBA8(dst, src, count, alpha_or);
+      },
+      [alpha_or](const u8* src, u32 i) { return ReferenceRGBA5551(ReadPixel16(src, i), false) | alpha_or; });
+    CheckAllWidths(
+      2,
+      [alpha_or](u32* dst, const u8* src, u32 count) {
+        PixelConversion::ConvertRGBA5551ToBGRA8(dst, src, count, alpha_or);
+      },
+      [alpha_or](const u8* src, u32 i) { return ReferenceRGBA5551(ReadPixel16(src, i), true) | alpha_or; });
+  }
+}
+
+TEST(PixelConversion, RGB565Widths)
+{
+  CheckAllWidths(2, &PixelConversion::ConvertRGB565ToRGBA8,
+                 [](const u8* src, u32 i) { return ReferenceRGB565(ReadPixel16(src, i)); });
+}
+
+TEST(PixelConversion, RGB888Widths)
+{
+  CheckAllWidths(3, &PixelConversion::ConvertRGB888ToRGBA8, [](const u8* src, u32 i) {
+    return PackRGBA(src[i * 3], src[i * 3 + 1], src[i * 3 + 2], 0xFFu, false);
+  });
+  CheckAllWidths(3, &PixelConversion::ConvertRGB888ToBGRA8, [](const u8* src, u32 i) {
+    return PackRGBA(src[i * 3], src[i * 3 + 1], src[i * 3 + 2], 0xFFu, true);
+  });
+}
@@ -0,0 +1,161 @@
+#include "common/byte_stream.h"
+#include "util/state_wrapper.h"
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+enum class TestEnum : u16
+{
+  A,
+  B = 0x1234,
+};
+
+struct TestState
+{
+  u8 byte = 0;
+  u32 word = 0;
+  s64 dword = 0;
+  float flt = 0.0f;
+  bool flag = false;
+  TestEnum enum_value = TestEnum::A;
+  std::string str;
+  std::array<u16, 5> array = {};
+  std::vector<u32> vec;
+  InlineFIFOQueue<s16, 8> fifo;
+
+  void Fill()
+  {
+    byte = 0xAB;
+    word = 0x12345678u;
+    dword = -1234567890123;
+    flt = 3.5f;
+    flag = true;
+    enum_value = TestEnum::B;
+    str = "state";
+    array = {{1, 2, 3, 4, 5}};
+    vec = {10, 20, 30};
+
+    // leave the queue wrapped around the end of its buffer
+    for (s16 i = 0; i < 6; i++)
+      fifo.Push(i);
+    fifo.Remove(5);
+    for (s16 i = 6; i < 10; i++)
+      fifo.Push(i);
+  }
+
+  bool DoState(StateWrapper& sw)
+  {
+    sw.Do(&byte);
+    sw.Do(&word);
+    sw.Do(&dword);
+    sw.Do(&flt);
+    sw.Do(&flag);
+    sw.Do(&enum_value);
+    sw.Do(&str);
+    sw.Do(&array);
+    sw.Do(&vec);
+    sw.Do(&fifo);
+    return sw.DoMarker("TestState");
+  }
+
+  void Compare(TestState& rhs)
+  {
+    EXPECT_EQ(byte, rhs.byte);
+    EXPECT_EQ(word, rhs.word);
+    EXPECT_EQ(dword, rhs.dword);
+    EXPECT_EQ(flt, rhs.flt);
+    EXPECT_EQ(flag, rhs.flag);
+    EXPECT_EQ(enum_value, rhs.enum_value);
+    EXPECT_EQ(str, rhs.str);
+    EXPECT_EQ(array, rhs.array);
+    EXPECT_EQ(vec, rhs.vec);
+    ASSERT_EQ(fifo.GetSize(), rhs.fifo.GetSize());
+    for (u32 i = 0; i < fifo.GetSize(); i++)
+      EXPECT_EQ(fifo.Peek(i), rhs.fifo.Peek(i));
+  }
+};
+
+constexpr u32 TEST_VERSION = 1;
+
+std::vector<u8> WriteToStream(TestState& state)
+{
+  std::unique_ptr<GrowableMemoryByteStream> stream = ByteStream::CreateGrowableMemoryStream();
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Write, TEST_VERSION);
+  EXPECT_TRUE(state.DoState(sw));
+  EXPECT_FALSE(sw.HasError());
+
+  const u8* data = stream->GetMemoryPointer();
+  return std::vector<u8>(data, data + stream->GetSize());
+}
+} // namespace
+
+TEST(StateWrapper, BufferMatchesStream)
+{
+  TestState state;
+  state.Fill();
+  const std::vector<u8> stream_data(WriteToStream(state));
+
+  std::vector<u8> buffer(1024);
+  StateWrapper sw(buffer.data(), buffer.size(), StateWrapper::Mode::Write, TEST_VERSION);
+  ASSERT_TRUE(state.DoState(sw));
+  ASSERT_FALSE(sw.HasError());
+  buffer.resize(static_cast<size_t>(sw.GetPosition()));
+  ASSERT_EQ(buffer, stream_data);
+}
+
+TEST(StateWrapper, BufferRoundTrip)
+{
+  TestState state;
+  state.Fill();
+  std::vector<u8> buffer(WriteToStream(state));
+
+  TestState loaded;
+  StateWrapper sw(buffer.data(), buffer.size(), StateWrapper::Mode::Read, TEST_VERSION);
+  ASSERT_TRUE(loaded.DoState(sw));
+  ASSERT_FALSE(sw.HasError());
+  ASSERT_EQ(sw.GetPosition(), buffer.size());
+  state.Compare(loaded);
+}
+
+TEST(StateWrapper, BufferWriteOverflowFails)
+{
+  TestState state;
+  state.Fill();
+  const size_t size = WriteToStream(state).size();
+
+  // the bytes before the overflow are written, nothing past the end of the buffer is touched
+  std::vector<u8> buffer(size, 0xCC);
+  StateWrapper sw(buffer.data(), size - 1, StateWrapper::Mode::Write, TEST_VERSION);
+  ASSERT_FALSE(state.DoState(sw));
+  ASSERT_TRUE(sw.HasError());
+  ASSERT_EQ(buffer.back(), 0xCC);
+}
+
+TEST(StateWrapper, BufferReadTruncatedFails)
+{
+  TestState state;
+  state.Fill();
+  std::vector<u8> buffer(WriteToStream(state));
+
+  for (const size_t size : {static_cast<size_t>(0), static_cast<size_t>(3), buffer.size() / 2, buffer.size() - 1})
+  {
+    TestState loaded;
+    loaded.Fill();
+    StateWrapper sw(buffer.data(), size, StateWrapper::Mode::Read, TEST_VERSION);
+    ASSERT_FALSE(loaded.DoState(sw)) << "size " << size;
+    ASSERT_TRUE(sw.HasError());
+    ASSERT_LE(sw.GetPosition(), size);
+  }
+
+  // values which couldn't be read are zeroed
+  TestState loaded;
+  loaded.Fill();
+  StateWrapper sw(buffer.data(), 3, StateWrapper::Mode::Read, TEST_VERSION);
+  loaded.DoState(sw);
+  ASSERT_EQ(loaded.word, 0u);
+  ASSERT_EQ(loaded.dword, 0);
+  ASSERT_FALSE(loaded.flag);
+}
@@ -0,0 +1,142 @@
+#include "common/thread_pool.h"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using Threading::CancellationToken;
+using Threading::ThreadPool;
+
+namespace {
+// Keeps a pool's only worker busy until released, so tests can control what is queued behind it.
+class WorkerBlocker
+{
+public:
+  void Block(ThreadPool& pool, ThreadPool::TaskGroup* group)
+  {
+    pool.Submit(
+      [this]() {
+        m_started.store(true);
+        while (!m_released.load())
+          std::this_thread::yield();
+      },
+      ThreadPool::Priority::High, group);
+
+    while (!m_started.load())
+      std::this_thread::yield();
+  }
+
+  void Release() { m_released.store(true); }
+
+private:
+  std::atomic_bool m_started{false};
+  std::atomic_bool m_released{false};
+};
+} // namespace
+
+TEST(ThreadPool, WaitRunsAllTasks)
+{
+  ThreadPool pool(4, "Test Pool");
+  ThreadPool::TaskGroup group;
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < 1000; i++)
+    pool.Submit([&count]() { count.fetch_add(1); }, ThreadPool::Priority::Normal, &group);
+
+  group.Wait(pool);
+  ASSERT_TRUE(group.IsDone());
+  ASSERT_EQ(count.load(), 1000u);
+}
+
+TEST(ThreadPool, CancelledTasksAreSkipped)
+{
+  ThreadPool pool(1, "Test Pool");
+  ThreadPool::TaskGroup blocker_group;
+  WorkerBlocker blocker;
+  blocker.Block(pool, &blocker_group);
+
+  ThreadPool::TaskGroup group;
+  CancellationToken token;
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < 10; i++)
+    pool.Submit([&count]() { count.fetch_add(1); }, ThreadPool::Priority::Normal, &group, &token);
+
+  token.Cancel();
+  blocker.Release();
+  group.Wait(pool);
+  blocker_group.Wait(pool);
+  ASSERT_EQ(count.load(), 0u);
+}
+
+TEST(ThreadPool, HigherPriorityRunsFirst)
+{
+  ThreadPool pool(1, "Test Pool");
+  ThreadPool::TaskGroup group;
+  WorkerBlocker blocker;
+  blocker.Block(pool, &group);
+
+  std::vector<ThreadPool::Priority> order;
+  for (ThreadPool::Priority priority :
+       {ThreadPool::Priority::Low, ThreadPool::Priority::Normal, ThreadPool::Priority::High})
+  {
+    pool.Submit([&order, priority]() { order.push_back(priority); }, priority, &group);
+  }
+
+  // only the worker runs tasks here, so the vector doesn't need a lock
+  blocker.Release();
+  while (!group.IsDone())
+    std::this_thread::yield();
+
+  group.Wait(pool);
+  ASSERT_EQ(order.size(), 3u);
+  ASSERT_EQ(order[0], ThreadPool::Priority::High);
+  ASSERT_EQ(order[1], ThreadPool::Priority::Normal);
+  ASSERT_EQ(order[2], ThreadPool::Priority::Low);
+}
+
+TEST(ThreadPool, WaitOnlyRunsOwnGroup)
+{
+  ThreadPool pool(1, "Test Pool");
+  ThreadPool::TaskGroup other_group;
+  WorkerBlocker blocker;
+  blocker.Block(pool, &other_group);
+
+  std::atomic_bool other_ran{false};
+  pool.Submit([&other_ran]() { other_ran.store(true); }, ThreadPool::Priority::High, &other_group);
+
+  // the worker is busy, so our task can only run on the calling thread
+  const std::thread::id caller_id = std::this_thread::get_id();
+  ThreadPool::TaskGroup group;
+  std::atomic_bool ran_on_caller{false};
+  pool.Submit([&]() { ran_on_caller.store(std::this_thread::get_id() == caller_id); }, ThreadPool::Priority::Low,
+              &group);
+
+  group.Wait(pool);
+  ASSERT_TRUE(ran_on_caller.load());
+  ASSERT_FALSE(other_ran.load());
+
+  blocker.Release();
+  other_group.Wait(pool);
+  ASSERT_TRUE(other_ran.load());
+}
+
+TEST(ThreadPool, NestedWaitFromWorker)
+{
+  ThreadPool pool(2, "Test Pool");
+  ThreadPool::TaskGroup outer_group;
+  std::atomic<u32> count{0};
+  for (u32 i = 0; i < 8; i++)
+  {
+    pool.Submit(
+      [&pool, &count]() {
+        ThreadPool::TaskGroup inner_group;
+        for (u32 j = 0; j < 8; j++)
+          pool.Submit([&count]() { count.fetch_add(1); }, ThreadPool::Priority::Normal, &inner_group);
+
+        inner_group.Wait(pool);
+      },
+      ThreadPool::Priority::Normal, &outer_group);
+  }
+
+  outer_group.Wait(pool);
+  ASSERT_EQ(count.load(), 64u);
+}
@@ -0,0 +1,285 @@
+#include "allocation_profiler.h"
+
+#ifdef WITH_ALLOCATION_PROFILER
+
+#include "log.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+Log_SetChannel(AllocationProfiler);
+
+namespace AllocationProfiler {
+
+namespace {
+struct TagTotals
+{
+  u64 count;
+  u64 bytes;
+  u32 frames_with_allocations;
+  u32 peak_count;
+};
+} // namespace
+
+static void RecordAllocation(std::size_t size);
+static void* Allocate(std::size_t size);
+static void* AllocateAligned(std::size_t size, std::size_t alignment);
+static void FreeAligned(void* ptr);
+static void LogReport();
+
+// Everything here has to be constant initialized and must not allocate, since operator new can be called from any
+// thread at any time, including before and during static initialization.
+static std::mutex s_tags_mutex;
+static std::array<const char*, MAX_TAGS> s_tag_names = {{"Untagged"}};
+static std::atomic<u32> s_num_tags{1};
+static thread_local u32 s_current_tag = 0;
+
+static std::array<std::atomic<u64>, MAX_TAGS> s_frame_counts = {};
+static std::array<std::atomic<u64>, MAX_TAGS> s_frame_bytes = {};
+
+// only touched by EndFrame()
+static std::array<TagTotals, MAX_TAGS> s_totals = {};
+static u32 s_frames_since_report = 0;
+
+} // namespace AllocationProfiler
+
+u32 AllocationProfiler::RegisterTag(const char* name)
+{
+  std::unique_lock lock(s_tags_mutex);
+  const u32 num_tags = s_num_tags.load(std::memory_order_relaxed);
+  for (u32 i = 0; i < num_tags; i++)
+  {
+    if (std::strcmp(s_tag_names[i], name) == 0)
+      return i;
+  }
+
+  // attribute to untagged once the table is full, rather than losing allocations
+  if (num_tags == MAX_TAGS)
+    return 0;
+
+  s_tag_names[num_tags] = name;
+  s_num_tags.store(num_tags + 1, std::memory_order_release);
+  return num_tags;
+}
+
+u32 AllocationProfiler::SetCurrentTag(u32 tag)
+{
+  const u32 previous_tag = s_current_tag;
+  s_current_tag = tag;
+  return previous_tag;
+}
+
+void AllocationProfiler::RecordAllocation(std::size_t size)
+{
+  const u32 tag = s_current_tag;
+  s_frame_counts[tag].fetch_add(1, std::memory_order_relaxed);
+  s_frame_bytes[tag].fetch_add(size, std::memory_order_relaxed);
+}
+
+void AllocationProfiler::EndFrame()
+{
+  const u32 num_tags = s_num_tags.load(std::memory_order_acquire);
+  for (u32 i = 0; i < num_tags; i++)
+  {
+    const u64 count = s_frame_counts[i].exchange(0, std::memory_order_relaxed);
+    const u64 bytes = s_frame_bytes[i].exchange(0, std::memory_order_relaxed);
+    if (count == 0)
+      continue;
+
+    TagTotals& totals = s_totals[i];
+    totals.count += count;
+    totals.bytes += bytes;
+    totals.frames_with_allocations++;
+    totals.peak_count = std::max(totals.peak_count, static_cast<u32>(std::min<u64>(count, UINT32_MAX)));
+  }
+
+  if (++s_frames_since_report < REPORT_INTERVAL_FRAMES)
+    return;
+
+  // the report's own allocations show up under its tag next frame
+  static const u32 report_tag = RegisterTag("AllocationProfiler");
+  const u32 previous_tag = SetCurrentTag(report_tag);
+  LogReport();
+  SetCurrentTag(previous_tag);
+
+  s_totals = {};
+  s_frames_since_report = 0;
+}
+
+void AllocationProfiler::LogReport()
+{
+  static constexpr u32 MAX_REPORTED_TAGS = 10;
+
+  const u32 num_tags = s_num_tags.load(std::memory_order_acquire);
+  std::array<u32, MAX_TAGS> order;
+  u32 num_allocating_tags = 0;
+  u64 total_count = 0;
+  u64 total_bytes = 0;
+  for (u32 i = 0; i < num_tags; i++)
+  {
+    if (s_totals[i].count == 0)
+      continue;
+
+    order[num_allocating_tags++] = i;
+    total_count += s_totals[i].count;
+    total_bytes += s_totals[i].bytes;
+  }
+
+  std::sort(order.begin(), order.begin() + num_allocating_tags,
+            [](u32 lhs, u32 rhs) { return (s_totals[lhs].count > s_totals[rhs].count); });
+
+  const double frames = static_cast<double>(s_frames_since_report);
+  Log_InfoPrintf("Allocations over the last %u frames: %.1f/frame, %.1f KB/frame", s_frames_since_report,
+                 static_cast<double>(total_count) / frames, static_cast<double>(total_bytes) / 1024.0 / frames);
+
+  for (u32 i = 0; i < std::min(num_allocating_tags, MAX_REPORTED_TAGS); i++)
+  {
+    const TagTotals& totals = s_totals[order[i]];
+    Log_InfoPrintf("  %-28s %10.1f allocs/frame %10.1f KB/frame, in %u frames, peak %u/frame", s_tag_names[order[i]],
+                   static_cast<double>(totals.count) / frames, static_cast<double>(totals.bytes) / 1024.0 / frames,
+                   totals.frames_with_allocations, totals.peak_count);
+  }
+}
+
+void* AllocationProfiler::Allocate(std::size_t size)
+{
+  RecordAllocation(size);
+  return std::malloc(std::max<std::size_t>(size, 1));
+}
+
+void* AllocationProfiler::AllocateAligned(std::size_t size, std::size_t alignment)
+{
+  RecordAllocation(size);
+  size = std::max<std::size_t>(size, 1);
+#ifdef _WIN32
+  return _aligned_malloc(size, alignment);
+#else
+  void* ptr;
+  return (posix_memalign(&ptr, std::max(alignment, sizeof(void*)), size) == 0) ? ptr : nullptr;
+#endif
+}
+
+void AllocationProfiler::FreeAligned(void* ptr)
+{
+#ifdef _WIN32
+  _aligned_free(ptr);
+#else
+  std::free(ptr);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+  void* ptr = AllocationProfiler::Allocate(size);
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return AllocationProfiler::Allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return AllocationProfiler::Allocate(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  void* ptr = AllocationProfiler::AllocateAligned(size, static_cast<std::size_t>(alignment));
+  if (!ptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+  return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return AllocationProfiler::AllocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+  return AllocationProfiler::AllocateAligned(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+  AllocationProfiler::FreeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+  AllocationProfiler::FreeAligned(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  AllocationProfiler::FreeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+  AllocationProfiler::FreeAligned(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  AllocationProfiler::FreeAligned(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+  AllocationProfiler::FreeAligned(ptr);
+}
+
+#endif
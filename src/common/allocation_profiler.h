@@ -0,0 +1,55 @@
+#pragma once
+#include "types.h"
+
+/// Optional instrumentation which counts heap allocations made through operator new, each frame, attributed to the
+/// innermost ALLOCATION_TAG() scope on the allocating thread. It replaces the global allocation operators, so it is
+/// only compiled in when WITH_ALLOCATION_PROFILER is defined (ENABLE_ALLOCATION_PROFILER in CMake).
+namespace AllocationProfiler {
+
+#ifdef WITH_ALLOCATION_PROFILER
+
+static constexpr u32 MAX_TAGS = 64;
+
+/// Number of frames the top allocation sources are logged after.
+static constexpr u32 REPORT_INTERVAL_FRAMES = 300;
+
+/// Returns the index for the tag with the specified name, which must outlive the process. Doesn't allocate.
+u32 RegisterTag(const char* name);
+
+/// Sets the tag allocations on the calling thread are attributed to, and returns the previous one.
+u32 SetCurrentTag(u32 tag);
+
+/// Accumulates the allocations made since the last call, and logs the top sources every REPORT_INTERVAL_FRAMES calls.
+void EndFrame();
+
+class ScopedTag
+{
+public:
+  ALWAYS_INLINE ScopedTag(u32 tag) : m_previous_tag(SetCurrentTag(tag)) {}
+  ALWAYS_INLINE ~ScopedTag() { SetCurrentTag(m_previous_tag); }
+
+  ScopedTag(const ScopedTag&) = delete;
+  ScopedTag& operator=(const ScopedTag&) = delete;
+
+private:
+  u32 m_previous_tag;
+};
+
+#else
+
+ALWAYS_INLINE void EndFrame() {}
+
+#endif
+
+} // namespace AllocationProfiler
+
+#ifdef WITH_ALLOCATION_PROFILER
+#define ALLOCATION_TAG_CONCAT2(a, b) a##b
+#define ALLOCATION_TAG_CONCAT(a, b) ALLOCATION_TAG_CONCAT2(a, b)
+#define ALLOCATION_TAG(name)                                                                                           \
+  static const u32 ALLOCATION_TAG_CONCAT(allocation_tag_id_, __LINE__) = AllocationProfiler::RegisterTag(name);        \
+  const AllocationProfiler::ScopedTag ALLOCATION_TAG_CONCAT(allocation_tag_, __LINE__)(                                \
+    ALLOCATION_TAG_CONCAT(allocation_tag_id_, __LINE__))
+#else
+#define ALLOCATION_TAG(name)
+#endif
@@ -1346,10 +1346,25 @@ bool ByteStream::WriteBinaryToStream(ByteStream* stream, const void* data, size_
 class ZstdCompressStream final : public ByteStream
 {
 public:
-  ZstdCompressStream(ByteStream* dst_stream, int compression_level) : m_dst_stream(dst_stream)
+  ZstdCompressStream(ByteStream* dst_stream, int compression_level, u32 num_workers) : m_dst_stream(dst_stream)
   {
     m_cstream = ZSTD_createCStream();
     ZSTD_CCtx_setParameter(m_cstream, ZSTD_c_compressionLevel, compression_level);
+    if (num_workers > 0)
+    {
+      // not fatal, the stream just compresses on the calling thread instead
+      const size_t ret = ZSTD_CCtx_setParameter(m_cstream, ZSTD_c_nbWorkers, static_cast<int>(num_workers));
+      if (ZSTD_isError(ret))
+      {
+        Log_WarningPrintf("Failed to set %u zstd workers: %s", num_workers,
+                          ZSTD_getErrorString(ZSTD_getErrorCode(ret)));
+      }
+      else
+      {
+        // the default job size scales with the window, which at higher levels exceeds a whole save state
+        ZSTD_CCtx_setParameter(m_cstream, ZSTD_c_jobSize, WORKER_JOB_SIZE);
+      }
+    }
   }
 
   ~ZstdCompressStream() override
@@ -1422,6 +1437,7 @@ private:
   {
     INPUT_BUFFER_SIZE = 131072,
     OUTPUT_BUFFER_SIZE = 65536,
+    WORKER_JOB_SIZE = 1048576,
   };
 
   bool Compress(ZSTD_EndDirective action)
@@ -1455,12 +1471,12 @@ private:
         outbuf.pos = 0;
       }
 
-      if (action == ZSTD_e_end)
+      if (action != ZSTD_e_continue)
       {
-        // break when compression output has finished
+        // break when compression output has finished, workers may still be holding data for flushes too
         if (ret == 0)
         {
-          m_done = true;
+          m_done = (action == ZSTD_e_end);
           break;
         }
       }
@@ -1487,9 +1503,10 @@ private:
   u8 m_output_buffer[OUTPUT_BUFFER_SIZE];
 };
 
-std::unique_ptr<ByteStream> ByteStream::CreateZstdCompressStream(ByteStream* src_stream, int compression_level)
+std::unique_ptr<ByteStream> ByteStream::CreateZstdCompressStream(ByteStream* src_stream, int compression_level,
+                                                                 u32 num_workers /* = 0 */)
 {
-  return std::make_unique<ZstdCompressStream>(src_stream, compression_level);
+  return std::make_unique<ZstdCompressStream>(src_stream, compression_level, num_workers);
 }
 
 class ZstdDecompressStream final : public ByteStream
@@ -1645,3 +1662,43 @@ std::unique_ptr<ByteStream> ByteStream::CreateZstdDecompressStream(ByteStream* s
 {
   return std::make_unique<ZstdDecompressStream>(src_stream, compressed_size);
 }
+
+bool ByteStream::CompressZstd(const void* src, u32 src_size, int compression_level, std::vector<u8>* dst)
+{
+  // the checksum makes corrupted data fail to decompress, rather than decompressing to garbage
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, compression_level);
+  ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+
+  dst->resize(ZSTD_compressBound(src_size));
+  const size_t ret = ZSTD_compress2(cctx, dst->data(), dst->size(), src, src_size);
+  ZSTD_freeCCtx(cctx);
+  if (ZSTD_isError(ret))
+  {
+    Log_ErrorPrintf("ZSTD_compress() failed: %u (%s)", static_cast<unsigned>(ZSTD_getErrorCode(ret)),
+                    ZSTD_getErrorString(ZSTD_getErrorCode(ret)));
+    dst->clear();
+    return false;
+  }
+
+  dst->resize(ret);
+  return true;
+}
+
+bool ByteStream::DecompressZstd(const void* src, u32 src_size, void* dst, u32 dst_size)
+{
+  const size_t ret = ZSTD_decompress(dst, dst_size, src, src_size);
+  if (ZSTD_isError(ret))
+  {
+    Log_ErrorPrintf("ZSTD_decompress() failed: %u (%s)", static_cast<unsigned>(ZSTD_getErrorCode(ret)),
+                    ZSTD_getErrorString(ZSTD_getErrorCode(ret)));
+    return false;
+  }
+  else if (ret != dst_size)
+  {
+    Log_ErrorPrintf("ZSTD_decompress() returned %zu bytes, expected %u", ret, dst_size);
+    return false;
+  }
+
+  return true;
+}
@@ -117,10 +117,16 @@ public:
   // null memory stream
   static std::unique_ptr<NullByteStream> CreateNullStream();
 
-  // zstd stream
-  static std::unique_ptr<ByteStream> CreateZstdCompressStream(ByteStream* src_stream, int compression_level);
+  // zstd stream. with num_workers > 0, compression runs on that many zstd worker threads in the background, and
+  // writes only block when the workers fall behind.
+  static std::unique_ptr<ByteStream> CreateZstdCompressStream(ByteStream* src_stream, int compression_level,
+                                                              u32 num_workers = 0);
   static std::unique_ptr<ByteStream> CreateZstdDecompressStream(ByteStream* src_stream, u32 compressed_size);
 
+  // one-shot zstd compression of a memory buffer, with a checksum. decompression requires the exact uncompressed size.
+  static bool CompressZstd(const void* src, u32 src_size, int compression_level, std::vector<u8>* dst);
+  static bool DecompressZstd(const void* src, u32 src_size, void* dst, u32 dst_size);
+
   // copies one stream's contents to another. rewinds source streams automatically, and returns it back to its old
   // position.
   static bool CopyStream(ByteStream* pDestinationStream, ByteStream* pSourceStream);
@@ -1,4 +1,5 @@
 #include "shader_cache.h"
+#include "../byte_stream.h"
 #include "../d3d11/shader_compiler.h"
 #include "../file_system.h"
 #include "../log.h"
@@ -17,9 +18,31 @@ struct CacheIndexEntry
   u32 shader_type;
   u32 file_offset;
   u32 blob_size;
+  u32 uncompressed_size;
 };
 #pragma pack(pop)
 
+// Shader bytecode and cached PSOs are both zstd compressed in the blob files.
+static constexpr int BLOB_COMPRESSION_LEVEL = 3;
+
+static Microsoft::WRL::ComPtr<ID3DBlob> ReadCompressedBlob(std::FILE* fp, u32 file_offset, u32 blob_size,
+                                                           u32 uncompressed_size)
+{
+  std::vector<u8> compressed(blob_size);
+  if (std::fseek(fp, file_offset, SEEK_SET) != 0 || std::fread(compressed.data(), 1, blob_size, fp) != blob_size)
+    return {};
+
+  Microsoft::WRL::ComPtr<ID3DBlob> blob;
+  HRESULT hr = D3DCreateBlob(uncompressed_size, blob.GetAddressOf());
+  if (FAILED(hr) ||
+      !ByteStream::DecompressZstd(compressed.data(), blob_size, blob->GetBufferPointer(), uncompressed_size))
+  {
+    return {};
+  }
+
+  return blob;
+}
+
 ShaderCache::ShaderCache() = default;
 
 ShaderCache::~ShaderCache()
@@ -188,7 +211,7 @@ bool ShaderCache::ReadExisting(const std::string& index_filename, const std::str
 
     const CacheIndexKey key{entry.source_hash_low, entry.source_hash_high, entry.source_length,
                             static_cast<EntryType>(entry.shader_type)};
-    const CacheIndexData data{entry.file_offset, entry.blob_size};
+    const CacheIndexData data{entry.file_offset, entry.blob_size, entry.uncompressed_size};
     index.emplace(key, data);
   }
 
@@ -305,14 +328,17 @@ ShaderCache::CacheIndexKey ShaderCache::GetPipelineCacheKey(const D3D12_GRAPHICS
 ShaderCache::ComPtr<ID3DBlob> ShaderCache::GetShaderBlob(EntryType type, std::string_view shader_code)
 {
   const auto key = GetShaderCacheKey(type, shader_code);
+  std::unique_lock lock(m_shader_mutex);
   auto iter = m_shader_index.find(key);
   if (iter == m_shader_index.end())
+  {
+    lock.unlock();
     return CompileAndAddShaderBlob(key, shader_code);
+  }
 
-  ComPtr<ID3DBlob> blob;
-  HRESULT hr = D3DCreateBlob(iter->second.blob_size, blob.GetAddressOf());
-  if (FAILED(hr) || std::fseek(m_shader_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-      std::fread(blob->GetBufferPointer(), 1, iter->second.blob_size, m_shader_blob_file) != iter->second.blob_size)
+  ComPtr<ID3DBlob> blob = ReadCompressedBlob(m_shader_blob_file, iter->second.file_offset, iter->second.blob_size,
+                                             iter->second.uncompressed_size);
+  if (!blob)
   {
     Log_ErrorPrintf("Read blob from file failed");
     return {};
@@ -330,10 +356,9 @@ ShaderCache::ComPtr<ID3D12PipelineState> ShaderCache::GetPipelineState(ID3D12Dev
   if (iter == m_pipeline_index.end())
     return CompileAndAddPipeline(device, key, desc);
 
-  ComPtr<ID3DBlob> blob;
-  HRESULT hr = D3DCreateBlob(iter->second.blob_size, blob.GetAddressOf());
-  if (FAILED(hr) || std::fseek(m_pipeline_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-      std::fread(blob->GetBufferPointer(), 1, iter->second.blob_size, m_pipeline_blob_file) != iter->second.blob_size)
+  ComPtr<ID3DBlob> blob = ReadCompressedBlob(m_pipeline_blob_file, iter->second.file_offset,
+                                             iter->second.blob_size, iter->second.uncompressed_size);
+  if (!blob)
   {
     Log_ErrorPrintf("Read blob from file failed");
     return {};
@@ -344,7 +369,7 @@ ShaderCache::ComPtr<ID3D12PipelineState> ShaderCache::GetPipelineState(ID3D12Dev
   desc_with_blob.CachedPSO.CachedBlobSizeInBytes = blob->GetBufferSize();
 
   ComPtr<ID3D12PipelineState> pso;
-  hr = device->CreateGraphicsPipelineState(&desc_with_blob, IID_PPV_ARGS(pso.GetAddressOf()));
+  HRESULT hr = device->CreateGraphicsPipelineState(&desc_with_blob, IID_PPV_ARGS(pso.GetAddressOf()));
   if (FAILED(hr))
   {
     Log_WarningPrintf("Creating cached PSO failed: %08X. Invalidating cache.", hr);
@@ -381,12 +406,25 @@ ShaderCache::ComPtr<ID3DBlob> ShaderCache::CompileAndAddShaderBlob(const CacheIn
   if (!blob)
     return {};
 
-  if (!m_shader_blob_file || std::fseek(m_shader_blob_file, 0, SEEK_END) != 0)
+  std::vector<u8> compressed;
+  if (!ByteStream::CompressZstd(blob->GetBufferPointer(), static_cast<u32>(blob->GetBufferSize()),
+                                BLOB_COMPRESSION_LEVEL, &compressed))
+  {
     return blob;
+  }
+
+  // Another thread may have compiled the same shader in the meantime.
+  std::unique_lock lock(m_shader_mutex);
+  if (m_shader_index.find(key) != m_shader_index.end() || !m_shader_blob_file ||
+      std::fseek(m_shader_blob_file, 0, SEEK_END) != 0)
+  {
+    return blob;
+  }
 
   CacheIndexData data;
   data.file_offset = static_cast<u32>(std::ftell(m_shader_blob_file));
-  data.blob_size = static_cast<u32>(blob->GetBufferSize());
+  data.blob_size = static_cast<u32>(compressed.size());
+  data.uncompressed_size = static_cast<u32>(blob->GetBufferSize());
 
   CacheIndexEntry entry = {};
   entry.source_hash_low = key.source_hash_low;
@@ -395,8 +433,9 @@ ShaderCache::ComPtr<ID3DBlob> ShaderCache::CompileAndAddShaderBlob(const CacheIn
   entry.shader_type = static_cast<u32>(key.type);
   entry.blob_size = data.blob_size;
   entry.file_offset = data.file_offset;
+  entry.uncompressed_size = data.uncompressed_size;
 
-  if (std::fwrite(blob->GetBufferPointer(), 1, entry.blob_size, m_shader_blob_file) != entry.blob_size ||
+  if (std::fwrite(compressed.data(), 1, entry.blob_size, m_shader_blob_file) != entry.blob_size ||
       std::fflush(m_shader_blob_file) != 0 || std::fwrite(&entry, sizeof(entry), 1, m_shader_index_file) != 1 ||
       std::fflush(m_shader_index_file) != 0)
   {
@@ -431,9 +470,17 @@ ShaderCache::CompileAndAddPipeline(ID3D12Device* device, const CacheIndexKey& ke
     return pso;
   }
 
+  std::vector<u8> compressed;
+  if (!ByteStream::CompressZstd(blob->GetBufferPointer(), static_cast<u32>(blob->GetBufferSize()),
+                                BLOB_COMPRESSION_LEVEL, &compressed))
+  {
+    return pso;
+  }
+
   CacheIndexData data;
   data.file_offset = static_cast<u32>(std::ftell(m_pipeline_blob_file));
-  data.blob_size = static_cast<u32>(blob->GetBufferSize());
+  data.blob_size = static_cast<u32>(compressed.size());
+  data.uncompressed_size = static_cast<u32>(blob->GetBufferSize());
 
   CacheIndexEntry entry = {};
   entry.source_hash_low = key.source_hash_low;
@@ -442,8 +489,9 @@ ShaderCache::CompileAndAddPipeline(ID3D12Device* device, const CacheIndexKey& ke
   entry.shader_type = static_cast<u32>(key.type);
   entry.blob_size = data.blob_size;
   entry.file_offset = data.file_offset;
+  entry.uncompressed_size = data.uncompressed_size;
 
-  if (std::fwrite(blob->GetBufferPointer(), 1, entry.blob_size, m_pipeline_blob_file) != entry.blob_size ||
+  if (std::fwrite(compressed.data(), 1, entry.blob_size, m_pipeline_blob_file) != entry.blob_size ||
       std::fflush(m_pipeline_blob_file) != 0 || std::fwrite(&entry, sizeof(entry), 1, m_pipeline_index_file) != 1 ||
       std::fflush(m_pipeline_index_file) != 0)
   {
@@ -4,6 +4,7 @@
 #include "../windows_headers.h"
 #include <cstdio>
 #include <d3d12.h>
+#include <mutex>
 #include <string_view>
 #include <unordered_map>
 #include <vector>
@@ -48,12 +49,13 @@ public:
     return GetShaderBlob(EntryType::ComputeShader, shader_code);
   }
 
+  /// Shaders can be requested from multiple threads at once, pipeline states can not.
   ComPtr<ID3DBlob> GetShaderBlob(EntryType type, std::string_view shader_code);
 
   ComPtr<ID3D12PipelineState> GetPipelineState(ID3D12Device* device, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
 
 private:
-  static constexpr u32 FILE_VERSION = 1;
+  static constexpr u32 FILE_VERSION = 2;
 
   struct CacheIndexKey
   {
@@ -80,6 +82,7 @@ private:
   {
     u32 file_offset;
     u32 blob_size;
+    u32 uncompressed_size;
   };
 
   using CacheIndex = std::unordered_map<CacheIndexKey, CacheIndexData, CacheIndexEntryHasher>;
@@ -105,6 +108,7 @@ private:
   std::FILE* m_shader_index_file = nullptr;
   std::FILE* m_shader_blob_file = nullptr;
   CacheIndex m_shader_index;
+  std::mutex m_shader_mutex;
 
   std::FILE* m_pipeline_index_file = nullptr;
   std::FILE* m_pipeline_blob_file = nullptr;
@@ -4,7 +4,10 @@
 #include "common/scoped_guard.h"
 #include "common/string.h"
 #include "file_system.h"
+#include <algorithm>
 #include <cmath>
+#include <cstring>
+#include <drm_fourcc.h>
 #include <fcntl.h>
 #include <string.h>
 #include <unistd.h>
@@ -23,6 +26,8 @@ DRMDisplay::~DRMDisplay()
   if (m_prev_crtc)
     RestoreBuffer();
 
+  DisablePlaneScaling();
+
   if (m_connector)
     drmModeFreeConnector(m_connector);
 
@@ -245,6 +250,13 @@ void DRMDisplay::RemoveBuffer(u32 fb_id)
 
 void DRMDisplay::PresentBuffer(u32 fb_id, bool wait_for_vsync)
 {
+  if (m_plane_id != 0)
+  {
+    // Blocking atomic commits always wait for the flip. Without vsync, the caller presents from another thread.
+    CommitAtomic(fb_id, 0);
+    return;
+  }
+
   if (!wait_for_vsync)
   {
     u32 connector_id = m_connector->connector_id;
@@ -289,6 +301,235 @@ void DRMDisplay::PresentBuffer(u32 fb_id, bool wait_for_vsync)
   }
 }
 
+bool DRMDisplay::EnablePlaneScaling(u32 src_width, u32 src_height)
+{
+  if (drmSetClientCap(m_card_fd, DRM_CLIENT_CAP_UNIVERSAL_PLANES, 1) != 0 ||
+      drmSetClientCap(m_card_fd, DRM_CLIENT_CAP_ATOMIC, 1) != 0)
+  {
+    Log_WarningPrintf("Atomic modesetting is not supported: %d (%s)", errno, strerror(errno));
+    return false;
+  }
+
+  const u32 plane_id = FindPrimaryPlane();
+  if (plane_id == 0)
+  {
+    Log_WarningPrintf("No primary plane found for CRTC %u", m_crtc_id);
+    return false;
+  }
+
+  const u32 connector_id = m_connector->connector_id;
+  m_atomic_props.connector_crtc_id = GetPropertyID(connector_id, DRM_MODE_OBJECT_CONNECTOR, "CRTC_ID");
+  m_atomic_props.crtc_mode_id = GetPropertyID(m_crtc_id, DRM_MODE_OBJECT_CRTC, "MODE_ID");
+  m_atomic_props.crtc_active = GetPropertyID(m_crtc_id, DRM_MODE_OBJECT_CRTC, "ACTIVE");
+  m_atomic_props.plane_fb_id = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "FB_ID");
+  m_atomic_props.plane_crtc_id = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_ID");
+  m_atomic_props.plane_src_x = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "SRC_X");
+  m_atomic_props.plane_src_y = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "SRC_Y");
+  m_atomic_props.plane_src_w = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "SRC_W");
+  m_atomic_props.plane_src_h = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "SRC_H");
+  m_atomic_props.plane_crtc_x = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_X");
+  m_atomic_props.plane_crtc_y = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_Y");
+  m_atomic_props.plane_crtc_w = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_W");
+  m_atomic_props.plane_crtc_h = GetPropertyID(plane_id, DRM_MODE_OBJECT_PLANE, "CRTC_H");
+
+  const u32* props_begin = reinterpret_cast<const u32*>(&m_atomic_props);
+  if (std::any_of(props_begin, props_begin + sizeof(m_atomic_props) / sizeof(u32), [](u32 id) { return id == 0; }))
+  {
+    Log_WarningPrintf("Missing atomic modesetting properties");
+    return false;
+  }
+
+  if (drmModeCreatePropertyBlob(m_card_fd, m_mode, sizeof(*m_mode), &m_mode_blob_id) != 0)
+  {
+    Log_WarningPrintf("drmModeCreatePropertyBlob() failed: %d (%s)", errno, strerror(errno));
+    return false;
+  }
+
+  m_plane_id = plane_id;
+  m_src_width = src_width;
+  m_src_height = src_height;
+
+  // Not every plane can scale, so check with a throwaway buffer before anything is rendered at this size.
+  drm_mode_create_dumb create_dumb = {};
+  create_dumb.width = src_width;
+  create_dumb.height = src_height;
+  create_dumb.bpp = 32;
+  if (drmIoctl(m_card_fd, DRM_IOCTL_MODE_CREATE_DUMB, &create_dumb) != 0)
+  {
+    Log_WarningPrintf("DRM_IOCTL_MODE_CREATE_DUMB failed: %d (%s)", errno, strerror(errno));
+    DisablePlaneScaling();
+    return false;
+  }
+
+  const std::optional<u32> test_fb_id =
+    AddBuffer(src_width, src_height, DRM_FORMAT_XRGB8888, create_dumb.handle, create_dumb.pitch, 0);
+  const bool test_result = test_fb_id.has_value() &&
+                           CommitAtomic(test_fb_id.value(), DRM_MODE_ATOMIC_TEST_ONLY | DRM_MODE_ATOMIC_ALLOW_MODESET);
+  if (test_fb_id.has_value())
+    RemoveBuffer(test_fb_id.value());
+
+  drm_mode_destroy_dumb destroy_dumb = {};
+  destroy_dumb.handle = create_dumb.handle;
+  drmIoctl(m_card_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy_dumb);
+
+  if (!test_result)
+  {
+    Log_WarningPrintf("Plane %u can't scale %ux%u to %ux%u", plane_id, src_width, src_height, GetWidth(), GetHeight());
+    DisablePlaneScaling();
+    return false;
+  }
+
+  Log_InfoPrintf("Using plane %u to scale %ux%u to %ux%u", plane_id, src_width, src_height, GetWidth(), GetHeight());
+  return true;
+}
+
+void DRMDisplay::DisablePlaneScaling()
+{
+  if (m_mode_blob_id != 0)
+  {
+    drmModeDestroyPropertyBlob(m_card_fd, m_mode_blob_id);
+    m_mode_blob_id = 0;
+  }
+
+  m_plane_id = 0;
+  m_atomic_modeset_done = false;
+}
+
+u32 DRMDisplay::FindPrimaryPlane() const
+{
+  drmModeRes* resources = drmModeGetResources(m_card_fd);
+  if (!resources)
+    return 0;
+
+  // possible_crtcs is a mask of CRTC indices, not IDs
+  int crtc_index = -1;
+  for (int i = 0; i < resources->count_crtcs; i++)
+  {
+    if (resources->crtcs[i] == m_crtc_id)
+    {
+      crtc_index = i;
+      break;
+    }
+  }
+
+  drmModeFreeResources(resources);
+  if (crtc_index < 0)
+    return 0;
+
+  drmModePlaneRes* plane_resources = drmModeGetPlaneResources(m_card_fd);
+  if (!plane_resources)
+    return 0;
+
+  u32 plane_id = 0;
+  for (u32 i = 0; i < plane_resources->count_planes && plane_id == 0; i++)
+  {
+    drmModePlane* plane = drmModeGetPlane(m_card_fd, plane_resources->planes[i]);
+    if (!plane)
+      continue;
+
+    drmModeObjectProperties* props =
+      (plane->possible_crtcs & (1u << crtc_index)) ?
+        drmModeObjectGetProperties(m_card_fd, plane->plane_id, DRM_MODE_OBJECT_PLANE) :
+        nullptr;
+    for (u32 j = 0; props && j < props->count_props; j++)
+    {
+      drmModePropertyRes* prop = drmModeGetProperty(m_card_fd, props->props[j]);
+      if (!prop)
+        continue;
+
+      if (std::strcmp(prop->name, "type") == 0 && props->prop_values[j] == DRM_PLANE_TYPE_PRIMARY)
+        plane_id = plane->plane_id;
+
+      drmModeFreeProperty(prop);
+    }
+
+    if (props)
+      drmModeFreeObjectProperties(props);
+
+    drmModeFreePlane(plane);
+  }
+
+  drmModeFreePlaneResources(plane_resources);
+  return plane_id;
+}
+
+u32 DRMDisplay::GetPropertyID(u32 object_id, u32 object_type, const char* name) const
+{
+  drmModeObjectProperties* props = drmModeObjectGetProperties(m_card_fd, object_id, object_type);
+  if (!props)
+    return 0;
+
+  u32 prop_id = 0;
+  for (u32 i = 0; i < props->count_props && prop_id == 0; i++)
+  {
+    drmModePropertyRes* prop = drmModeGetProperty(m_card_fd, props->props[i]);
+    if (!prop)
+      continue;
+
+    if (std::strcmp(prop->name, name) == 0)
+      prop_id = prop->prop_id;
+
+    drmModeFreeProperty(prop);
+  }
+
+  drmModeFreeObjectProperties(props);
+  return prop_id;
+}
+
+bool DRMDisplay::CommitAtomic(u32 fb_id, u32 flags)
+{
+  drmModeAtomicReq* req = drmModeAtomicAlloc();
+  if (!req)
+    return false;
+
+  // the mode only needs to be set by the first commit
+  if (!m_atomic_modeset_done)
+  {
+    drmModeAtomicAddProperty(req, m_connector->connector_id, m_atomic_props.connector_crtc_id, m_crtc_id);
+    drmModeAtomicAddProperty(req, m_crtc_id, m_atomic_props.crtc_mode_id, m_mode_blob_id);
+    drmModeAtomicAddProperty(req, m_crtc_id, m_atomic_props.crtc_active, 1);
+    flags |= DRM_MODE_ATOMIC_ALLOW_MODESET;
+  }
+
+  // Fit the buffer to the mode, keeping its aspect ratio.
+  const u32 mode_width = GetWidth();
+  const u32 mode_height = GetHeight();
+  u32 dst_width = mode_width;
+  u32 dst_height = (m_src_height * mode_width) / m_src_width;
+  if (dst_height > mode_height)
+  {
+    dst_width = (m_src_width * mode_height) / m_src_height;
+    dst_height = mode_height;
+  }
+
+  // source coordinates are in 16.16 fixed point
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_fb_id, fb_id);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_crtc_id, m_crtc_id);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_src_x, 0);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_src_y, 0);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_src_w, static_cast<u64>(m_src_width) << 16);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_src_h, static_cast<u64>(m_src_height) << 16);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_crtc_x, (mode_width - dst_width) / 2);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_crtc_y, (mode_height - dst_height) / 2);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_crtc_w, dst_width);
+  drmModeAtomicAddProperty(req, m_plane_id, m_atomic_props.plane_crtc_h, dst_height);
+
+  const int res = drmModeAtomicCommit(m_card_fd, req, flags, nullptr);
+  drmModeAtomicFree(req);
+  if (res != 0)
+  {
+    if (!(flags & DRM_MODE_ATOMIC_TEST_ONLY))
+      Log_ErrorPrintf("drmModeAtomicCommit() failed: %d", res);
+
+    return false;
+  }
+
+  if (!(flags & DRM_MODE_ATOMIC_TEST_ONLY))
+    m_atomic_modeset_done = true;
+
+  return true;
+}
+
 bool DRMDisplay::GetCurrentMode(u32* width, u32* height, float* refresh_rate, int card, int connector)
 {
   int card_fd = -1;
@@ -37,6 +37,11 @@ public:
            (static_cast<float>(m_connector->modes[i].htotal) * static_cast<float>(m_connector->modes[i].vtotal));
   }
 
+  /// Switches to atomic modesetting, where buffers of the given size are scaled to the mode by the primary plane.
+  /// Returns false if the driver doesn't support atomic modesetting, or the plane can't scale.
+  bool EnablePlaneScaling(u32 src_width, u32 src_height);
+  bool IsUsingPlaneScaling() const { return (m_plane_id != 0); }
+
   std::optional<u32> AddBuffer(u32 width, u32 height, u32 format, u32 handle, u32 pitch, u32 offset);
   void RemoveBuffer(u32 fb_id);
   void PresentBuffer(u32 fb_id, bool wait_for_vsync);
@@ -47,8 +52,30 @@ private:
     MAX_BUFFERS = 5
   };
 
+  struct AtomicProperties
+  {
+    u32 connector_crtc_id;
+    u32 crtc_mode_id;
+    u32 crtc_active;
+    u32 plane_fb_id;
+    u32 plane_crtc_id;
+    u32 plane_src_x;
+    u32 plane_src_y;
+    u32 plane_src_w;
+    u32 plane_src_h;
+    u32 plane_crtc_x;
+    u32 plane_crtc_y;
+    u32 plane_crtc_w;
+    u32 plane_crtc_h;
+  };
+
   bool TryOpeningCard(int card, u32 width, u32 height, float refresh_rate);
 
+  u32 FindPrimaryPlane() const;
+  u32 GetPropertyID(u32 object_id, u32 object_type, const char* name) const;
+  bool CommitAtomic(u32 fb_id, u32 flags);
+  void DisablePlaneScaling();
+
   int m_card_id = 0;
   int m_card_fd = -1;
   u32 m_crtc_id = 0;
@@ -58,4 +85,12 @@ private:
   drmModeModeInfo* m_mode = nullptr;
 
   drmModeCrtc* m_prev_crtc = nullptr;
+
+  // Atomic modesetting state, only used with plane scaling.
+  AtomicProperties m_atomic_props = {};
+  u32 m_plane_id = 0;
+  u32 m_mode_blob_id = 0;
+  u32 m_src_width = 0;
+  u32 m_src_height = 0;
+  bool m_atomic_modeset_done = false;
 };
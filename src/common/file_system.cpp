@@ -6,7 +6,10 @@
 #include <algorithm>
 #include <cstdlib>
 #include <cstring>
+#include <ctime>
 #include <limits>
+#include <mutex>
+#include <unordered_map>
 
 #ifdef __APPLE__
 #include <mach-o/dyld.h>
@@ -20,6 +23,7 @@
 
 #if defined(_WIN32)
 #include "windows_headers.h"
+#include <io.h>
 #include <share.h>
 #include <shlobj.h>
 #include <winioctl.h>
@@ -28,6 +32,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -720,6 +725,86 @@ s64 FileSystem::GetPathFileSize(const char* Path)
   return sd.Size;
 }
 
+FileSystem::MappedFile::MappedFile() = default;
+
+FileSystem::MappedFile::MappedFile(MappedFile&& mf) noexcept : m_data(mf.m_data), m_size(mf.m_size)
+{
+  mf.m_data = nullptr;
+  mf.m_size = 0;
+}
+
+FileSystem::MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+FileSystem::MappedFile& FileSystem::MappedFile::operator=(MappedFile&& mf) noexcept
+{
+  Unmap();
+  m_data = mf.m_data;
+  m_size = mf.m_size;
+  mf.m_data = nullptr;
+  mf.m_size = 0;
+  return *this;
+}
+
+bool FileSystem::MappedFile::Map(std::FILE* fp)
+{
+  Unmap();
+
+  const s64 size = FSize64(fp);
+  if (size <= 0 || static_cast<u64>(size) > static_cast<u64>(std::numeric_limits<size_t>::max()))
+    return false;
+
+#ifdef _WIN32
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  if (file_handle == INVALID_HANDLE_VALUE)
+    return false;
+
+  // the view keeps the mapping alive
+  const HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (!mapping_handle)
+  {
+    Log_ErrorPrintf("CreateFileMappingW() failed: %u", GetLastError());
+    return false;
+  }
+
+  void* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, static_cast<size_t>(size));
+  CloseHandle(mapping_handle);
+  if (!data)
+  {
+    Log_ErrorPrintf("MapViewOfFile() failed: %u", GetLastError());
+    return false;
+  }
+#else
+  void* data = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fileno(fp), 0);
+  if (data == MAP_FAILED)
+  {
+    Log_ErrorPrintf("mmap() failed: %d", errno);
+    return false;
+  }
+#endif
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<size_t>(size);
+  return true;
+}
+
+void FileSystem::MappedFile::Unmap()
+{
+  if (!m_data)
+    return;
+
+#ifdef _WIN32
+  UnmapViewOfFile(m_data);
+#else
+  munmap(const_cast<u8*>(m_data), m_size);
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+}
+
 std::optional<std::vector<u8>> FileSystem::ReadBinaryFile(const char* filename)
 {
   ManagedCFilePtr fp = OpenManagedCFile(filename, "rb");
@@ -869,6 +954,127 @@ bool FileSystem::CopyFilePath(const char* source, const char* destination, bool
 #endif
 }
 
+namespace {
+struct FindFilesSnapshot
+{
+  std::time_t snapshot_time;
+
+  // every directory in the tree including the root, with the modification time it had when enumerated
+  std::vector<std::pair<std::string, std::time_t>> directories;
+
+  // everything under the root, with relative paths
+  FileSystem::FindResultsArray entries;
+};
+} // namespace
+
+static std::mutex s_find_files_cache_mutex;
+static std::unordered_map<std::string, FindFilesSnapshot> s_find_files_cache;
+
+static bool IsFindFilesSnapshotValid(const FindFilesSnapshot& snapshot)
+{
+  // adding, removing or renaming an entry updates the modification time of the directory containing it. timestamps
+  // only have a resolution of a second, so a directory touched in the same second as the snapshot can't be trusted.
+  for (const auto& [path, mtime] : snapshot.directories)
+  {
+    FILESYSTEM_STAT_DATA sd;
+    if (!FileSystem::StatFile(path.c_str(), &sd) || sd.ModificationTime != mtime || mtime >= snapshot.snapshot_time)
+      return false;
+  }
+
+  return true;
+}
+
+static bool CreateFindFilesSnapshot(const char* path, u32 flags, FindFilesSnapshot* snapshot)
+{
+  FILESYSTEM_STAT_DATA root_sd;
+  if (!FileSystem::StatFile(path, &root_sd) || !(root_sd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY))
+    return false;
+
+  snapshot->snapshot_time = std::time(nullptr);
+  snapshot->directories.clear();
+  snapshot->directories.emplace_back(path, root_sd.ModificationTime);
+  FileSystem::FindFiles(path, "*",
+                        (flags & (FILESYSTEM_FIND_RECURSIVE | FILESYSTEM_FIND_HIDDEN_FILES)) | FILESYSTEM_FIND_FILES |
+                          FILESYSTEM_FIND_FOLDERS | FILESYSTEM_FIND_RELATIVE_PATHS,
+                        &snapshot->entries);
+
+  if (flags & FILESYSTEM_FIND_RECURSIVE)
+  {
+    for (const FILESYSTEM_FIND_DATA& fd : snapshot->entries)
+    {
+      if (fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY)
+      {
+        snapshot->directories.emplace_back(
+          StringUtil::StdStringFromFormat("%s" FS_OSPATH_SEPARATOR_STR "%s", path, fd.FileName.c_str()),
+          fd.ModificationTime);
+      }
+    }
+  }
+
+  return true;
+}
+
+bool FileSystem::FindFilesCached(const char* path, const char* pattern, u32 flags, FindResultsArray* results)
+{
+  if (path[0] == '\0')
+    return false;
+
+  if (!(flags & FILESYSTEM_FIND_KEEP_ARRAY))
+    results->clear();
+
+  // the snapshot always contains files and folders, so only recursion and hidden files need separate snapshots
+  const u32 snapshot_flags = flags & (FILESYSTEM_FIND_RECURSIVE | FILESYSTEM_FIND_HIDDEN_FILES);
+  std::string key = StringUtil::StdStringFromFormat("%u:%s", snapshot_flags, path);
+
+  std::unique_lock lock(s_find_files_cache_mutex);
+  auto iter = s_find_files_cache.find(key);
+  if (iter == s_find_files_cache.end() || !IsFindFilesSnapshotValid(iter->second))
+  {
+    FindFilesSnapshot snapshot;
+    if (!CreateFindFilesSnapshot(path, snapshot_flags, &snapshot))
+    {
+      if (iter != s_find_files_cache.end())
+        s_find_files_cache.erase(iter);
+      return false;
+    }
+
+    Log_DevPrintf("Cached %zu entries in %zu directories for '%s'", snapshot.entries.size(),
+                  snapshot.directories.size(), path);
+    iter = s_find_files_cache.insert_or_assign(std::move(key), std::move(snapshot)).first;
+  }
+
+  const bool has_wildcards = (std::strpbrk(pattern, "*?") != nullptr);
+  const bool wildcard_match_all = (std::strcmp(pattern, "*") == 0);
+  const size_t count_before = results->size();
+  for (const FILESYSTEM_FIND_DATA& fd : iter->second.entries)
+  {
+    if (!(flags & ((fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY) ? FILESYSTEM_FIND_FOLDERS :
+                                                                            FILESYSTEM_FIND_FILES)))
+    {
+      continue;
+    }
+
+    const std::string_view name = Path::GetFileName(fd.FileName);
+    if (has_wildcards ? (!wildcard_match_all && !StringUtil::WildcardMatch(std::string(name).c_str(), pattern)) :
+                        (name != pattern))
+    {
+      continue;
+    }
+
+    FILESYSTEM_FIND_DATA& out = results->emplace_back(fd);
+    if (!(flags & FILESYSTEM_FIND_RELATIVE_PATHS))
+      out.FileName = StringUtil::StdStringFromFormat("%s" FS_OSPATH_SEPARATOR_STR "%s", path, fd.FileName.c_str());
+  }
+
+  return (results->size() > count_before);
+}
+
+void FileSystem::ClearFindFilesCache()
+{
+  std::unique_lock lock(s_find_files_cache_mutex);
+  s_find_files_cache.clear();
+}
+
 #ifdef _WIN32
 
 static u32 TranslateWin32Attributes(u32 Win32Attributes)
@@ -1815,7 +2021,7 @@ bool FileSystem::DeleteDirectory(const char* path)
   if (stat(path, &sysStatData) != 0 || !S_ISDIR(sysStatData.st_mode))
     return false;
 
-  return (unlink(path) == 0);
+  return (rmdir(path) == 0);
 }
 
 std::string FileSystem::GetProgramPath()
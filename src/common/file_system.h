@@ -62,6 +62,13 @@ std::vector<std::string> GetRootDirectoryList();
 /// Search for files
 bool FindFiles(const char* path, const char* pattern, u32 flags, FindResultsArray* results);
 
+/// Search for files, reusing a snapshot of the directory tree while no directory in it has been modified since.
+/// Sizes and timestamps of files which have been changed in place can be stale, only use when the names matter.
+bool FindFilesCached(const char* path, const char* pattern, u32 flags, FindResultsArray* results);
+
+/// Drops all snapshots held by FindFilesCached().
+void ClearFindFilesCache();
+
 /// Stat file
 bool StatFile(const char* path, struct stat* st);
 bool StatFile(std::FILE* fp, struct stat* st);
@@ -122,6 +129,32 @@ private:
 };
 #endif
 
+/// Read-only mapping of a whole file into the address space.
+class MappedFile
+{
+public:
+  MappedFile();
+  MappedFile(MappedFile&& mf) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  ~MappedFile();
+
+  MappedFile& operator=(MappedFile&& mf) noexcept;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ALWAYS_INLINE bool IsValid() const { return (m_data != nullptr); }
+  ALWAYS_INLINE const u8* GetData() const { return m_data; }
+  ALWAYS_INLINE size_t GetSize() const { return m_size; }
+
+  /// Maps the file behind fp. The file can be closed afterwards. Fails for empty files, or if the file does not fit
+  /// in the address space.
+  bool Map(std::FILE* fp);
+  void Unmap();
+
+private:
+  const u8* m_data = nullptr;
+  size_t m_size = 0;
+};
+
 std::optional<std::vector<u8>> ReadBinaryFile(const char* filename);
 std::optional<std::vector<u8>> ReadBinaryFile(std::FILE* fp);
 std::optional<std::string> ReadFileToString(const char* filename);
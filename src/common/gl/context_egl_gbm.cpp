@@ -91,6 +91,16 @@ bool ContextEGLGBM::CreateDisplay()
   m_wi.surface_width = m_drm_display.GetWidth();
   m_wi.surface_height = m_drm_display.GetHeight();
   m_wi.surface_refresh_rate = m_drm_display.GetRefreshRate();
+
+  // Render straight into smaller scanout buffers if the plane can scale them up, instead of at the mode size.
+  if (m_wi.scanout_width > 0 && m_wi.scanout_height > 0 &&
+      (m_wi.scanout_width != m_wi.surface_width || m_wi.scanout_height != m_wi.surface_height) &&
+      m_drm_display.EnablePlaneScaling(m_wi.scanout_width, m_wi.scanout_height))
+  {
+    m_wi.surface_width = m_wi.scanout_width;
+    m_wi.surface_height = m_wi.scanout_height;
+  }
+
   return true;
 }
 
@@ -118,7 +128,7 @@ EGLNativeWindowType ContextEGLGBM::GetNativeWindow(EGLConfig config)
   eglGetConfigAttrib(m_display, config, EGL_NATIVE_VISUAL_ID, &visual_id);
 
   Assert(!m_fb_surface);
-  m_fb_surface = gbm_surface_create(m_gbm_device, m_drm_display.GetWidth(), m_drm_display.GetHeight(),
+  m_fb_surface = gbm_surface_create(m_gbm_device, m_wi.surface_width, m_wi.surface_height,
                                     static_cast<u32>(visual_id), GBM_BO_USE_RENDERING | GBM_BO_USE_SCANOUT);
   if (!m_fb_surface)
   {
@@ -29,7 +29,7 @@ Program::~Program()
   Destroy();
 }
 
-GLuint Program::CompileShader(GLenum type, const std::string_view source)
+GLuint Program::StartCompileShader(GLenum type, const std::string_view source)
 {
   GLuint id = glCreateShader(type);
 
@@ -37,6 +37,12 @@ GLuint Program::CompileShader(GLenum type, const std::string_view source)
   std::array<GLint, 1> source_lengths = {{static_cast<GLint>(source.size())}};
   glShaderSource(id, static_cast<GLsizei>(sources.size()), sources.data(), source_lengths.data());
   glCompileShader(id);
+  return id;
+}
+
+GLuint Program::CompileShader(GLenum type, const std::string_view source)
+{
+  GLuint id = StartCompileShader(type, source);
 
   GLint status = GL_FALSE;
   glGetShaderiv(id, GL_COMPILE_STATUS, &status);
@@ -62,7 +68,7 @@ GLuint Program::CompileShader(GLenum type, const std::string_view source)
                         std::ofstream::out | std::ofstream::binary);
       if (ofs.is_open())
       {
-        ofs.write(sources[0], source_lengths[0]);
+        ofs.write(source.data(), source.size());
         ofs << "\n\nCompile failed, info log:\n";
         ofs << info_log;
         ofs.close();
@@ -121,6 +127,25 @@ bool Program::Compile(const std::string_view vertex_shader, const std::string_vi
   return true;
 }
 
+void Program::StartCompile(const std::string_view vertex_shader, const std::string_view geometry_shader,
+                           const std::string_view fragment_shader)
+{
+  m_program_id = glCreateProgram();
+
+  // the shaders are only flagged for deletion while they're attached
+  const auto attach_shader = [this](GLenum type, const std::string_view source) {
+    if (source.empty())
+      return;
+
+    const GLuint shader_id = StartCompileShader(type, source);
+    glAttachShader(m_program_id, shader_id);
+    glDeleteShader(shader_id);
+  };
+  attach_shader(GL_VERTEX_SHADER, vertex_shader);
+  attach_shader(GL_GEOMETRY_SHADER, geometry_shader);
+  attach_shader(GL_FRAGMENT_SHADER, fragment_shader);
+}
+
 bool Program::CreateFromBinary(const void* data, u32 data_length, u32 data_format)
 {
   GLuint prog = glCreateProgram();
@@ -208,6 +233,12 @@ void Program::BindFragDataIndexed(GLuint color_number /*= 0*/, const char* name
 }
 
 bool Program::Link()
+{
+  StartLink();
+  return FinishLink();
+}
+
+void Program::StartLink()
 {
   glLinkProgram(m_program_id);
 
@@ -217,7 +248,10 @@ bool Program::Link()
   if (m_fragment_shader_id != 0)
     glDeleteShader(m_fragment_shader_id);
   m_fragment_shader_id = 0;
+}
 
+bool Program::FinishLink()
+{
   GLint status = GL_FALSE;
   glGetProgramiv(m_program_id, GL_LINK_STATUS, &status);
 
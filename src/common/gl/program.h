@@ -22,6 +22,11 @@ public:
   bool Compile(const std::string_view vertex_shader, const std::string_view geometry_shader,
                const std::string_view fragment_shader);
 
+  /// Compile() without waiting for the result, so that the driver can compile several programs at once with
+  /// GL_KHR_parallel_shader_compile. Compile errors surface when linking.
+  void StartCompile(const std::string_view vertex_shader, const std::string_view geometry_shader,
+                    const std::string_view fragment_shader);
+
   bool CreateFromBinary(const void* data, u32 data_length, u32 data_format);
 
   bool GetBinary(std::vector<u8>* out_data, u32* out_data_format);
@@ -35,6 +40,10 @@ public:
 
   bool Link();
 
+  /// Split Link(), StartLink() returns immediately and FinishLink() waits for the driver and checks the result.
+  void StartLink();
+  bool FinishLink();
+
   void Bind() const;
 
   void Destroy();
@@ -90,6 +99,8 @@ public:
   Program& operator=(Program&& prog);
 
 private:
+  static GLuint StartCompileShader(GLenum type, const std::string_view source);
+
   static u32 s_last_program_id;
 
   GLuint m_program_id = 0;
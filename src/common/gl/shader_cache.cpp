@@ -1,4 +1,5 @@
 #include "shader_cache.h"
+#include "../byte_stream.h"
 #include "../file_system.h"
 #include "../log.h"
 #include "../md5_digest.h"
@@ -23,9 +24,13 @@ struct CacheIndexEntry
   u32 file_offset;
   u32 blob_size;
   u32 blob_format;
+  u32 uncompressed_size;
 };
 #pragma pack(pop)
 
+// Program binaries are mostly driver metadata and padding, and compress well.
+static constexpr int BLOB_COMPRESSION_LEVEL = 3;
+
 ShaderCache::ShaderCache() = default;
 
 ShaderCache::~ShaderCache()
@@ -58,6 +63,18 @@ void ShaderCache::Open(bool is_gles, std::string_view base_path, u32 version)
   m_base_path = base_path;
   m_version = version;
   m_program_binary_supported = is_gles || GLAD_GL_ARB_get_program_binary;
+  m_parallel_compile_supported = GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+  if (m_parallel_compile_supported)
+  {
+    // let the driver use as many threads as it likes
+    if (GLAD_GL_KHR_parallel_shader_compile)
+      glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    else
+      glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+
+    Log_InfoPrintf("Driver supports parallel shader compilation");
+  }
+
   if (m_program_binary_supported)
   {
     // check that there's at least one format and the extension isn't being "faked"
@@ -179,7 +196,7 @@ bool ShaderCache::ReadExisting(const std::string& index_filename, const std::str
       entry.vertex_source_hash_low,   entry.vertex_source_hash_high,   entry.vertex_source_length,
       entry.geometry_source_hash_low, entry.geometry_source_hash_high, entry.geometry_source_length,
       entry.fragment_source_hash_low, entry.fragment_source_hash_high, entry.fragment_source_length};
-    const CacheIndexData data{entry.file_offset, entry.blob_size, entry.blob_format};
+    const CacheIndexData data{entry.file_offset, entry.blob_size, entry.blob_format, entry.uncompressed_size};
     m_index.emplace(key, data);
   }
 
@@ -264,22 +281,44 @@ std::optional<Program> ShaderCache::GetProgram(const std::string_view vertex_sha
                                                const std::string_view geometry_shader,
                                                const std::string_view fragment_shader, const PreLinkCallback& callback)
 {
-  if (!m_program_binary_supported || !m_blob_file)
+  const bool use_cache = (m_program_binary_supported && m_blob_file);
+  if (!use_cache && m_pending_programs.empty())
     return CompileProgram(vertex_shader, geometry_shader, fragment_shader, callback, false);
 
   const auto key = GetCacheKey(vertex_shader, geometry_shader, fragment_shader);
+  if (auto pending = m_pending_programs.find(key); pending != m_pending_programs.end())
+  {
+    Program prog = std::move(pending->second);
+    m_pending_programs.erase(pending);
+
+    // on failure, compile it again the slow way so the shader errors are logged
+    if (prog.FinishLink() && (!use_cache || AddProgram(key, prog)))
+      return std::optional<Program>(std::move(prog));
+  }
+
+  if (!use_cache)
+    return CompileProgram(vertex_shader, geometry_shader, fragment_shader, callback, false);
+
   auto iter = m_index.find(key);
   if (iter == m_index.end())
     return CompileAndAddProgram(key, vertex_shader, geometry_shader, fragment_shader, callback);
 
-  std::vector<u8> data(iter->second.blob_size);
+  std::vector<u8> compressed(iter->second.blob_size);
   if (std::fseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-      std::fread(data.data(), 1, iter->second.blob_size, m_blob_file) != iter->second.blob_size)
+      std::fread(compressed.data(), 1, iter->second.blob_size, m_blob_file) != iter->second.blob_size)
   {
     Log_ErrorPrintf("Read blob from file failed");
     return {};
   }
 
+  std::vector<u8> data(iter->second.uncompressed_size);
+  if (!ByteStream::DecompressZstd(compressed.data(), iter->second.blob_size, data.data(),
+                                  iter->second.uncompressed_size))
+  {
+    Log_ErrorPrintf("Decompress blob failed");
+    return {};
+  }
+
   Program prog;
   if (prog.CreateFromBinary(data.data(), static_cast<u32>(data.size()), iter->second.blob_format))
     return std::optional<Program>(std::move(prog));
@@ -292,6 +331,29 @@ std::optional<Program> ShaderCache::GetProgram(const std::string_view vertex_sha
     return CompileAndAddProgram(key, vertex_shader, geometry_shader, fragment_shader, callback);
 }
 
+void ShaderCache::PrecompileProgram(const std::string_view vertex_shader, const std::string_view geometry_shader,
+                                    const std::string_view fragment_shader, const PreLinkCallback& callback)
+{
+  if (!m_parallel_compile_supported)
+    return;
+
+  const auto key = GetCacheKey(vertex_shader, geometry_shader, fragment_shader);
+  if (m_index.find(key) != m_index.end() || m_pending_programs.find(key) != m_pending_programs.end())
+    return;
+
+  Program prog;
+  prog.StartCompile(vertex_shader, geometry_shader, fragment_shader);
+
+  if (callback)
+    callback(prog);
+
+  if (m_program_binary_supported && m_blob_file)
+    prog.SetBinaryRetrievableHint();
+
+  prog.StartLink();
+  m_pending_programs.emplace(key, std::move(prog));
+}
+
 std::optional<Program> ShaderCache::CompileProgram(const std::string_view& vertex_shader,
                                                    const std::string_view& geometry_shader,
                                                    const std::string_view& fragment_shader,
@@ -320,21 +382,32 @@ std::optional<Program> ShaderCache::CompileAndAddProgram(const CacheIndexKey& ke
                                                          const PreLinkCallback& callback)
 {
   std::optional<Program> prog = CompileProgram(vertex_shader, geometry_shader, fragment_shader, callback, true);
-  if (!prog)
+  if (!prog || !AddProgram(key, prog.value()))
     return std::nullopt;
 
+  return prog;
+}
+
+bool ShaderCache::AddProgram(const CacheIndexKey& key, Program& prog)
+{
   std::vector<u8> prog_data;
   u32 prog_format = 0;
-  if (!prog->GetBinary(&prog_data, &prog_format))
-    return std::nullopt;
+  if (!prog.GetBinary(&prog_data, &prog_format))
+    return false;
 
-  if (!m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0)
-    return prog;
+  std::vector<u8> compressed;
+  if (!m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0 ||
+      !ByteStream::CompressZstd(prog_data.data(), static_cast<u32>(prog_data.size()), BLOB_COMPRESSION_LEVEL,
+                                &compressed))
+  {
+    return true;
+  }
 
   CacheIndexData data;
   data.file_offset = static_cast<u32>(std::ftell(m_blob_file));
-  data.blob_size = static_cast<u32>(prog_data.size());
+  data.blob_size = static_cast<u32>(compressed.size());
   data.blob_format = prog_format;
+  data.uncompressed_size = static_cast<u32>(prog_data.size());
 
   CacheIndexEntry entry = {};
   entry.vertex_source_hash_low = key.vertex_source_hash_low;
@@ -349,17 +422,18 @@ std::optional<Program> ShaderCache::CompileAndAddProgram(const CacheIndexKey& ke
   entry.file_offset = data.file_offset;
   entry.blob_size = data.blob_size;
   entry.blob_format = data.blob_format;
+  entry.uncompressed_size = data.uncompressed_size;
 
-  if (std::fwrite(prog_data.data(), 1, entry.blob_size, m_blob_file) != entry.blob_size ||
+  if (std::fwrite(compressed.data(), 1, entry.blob_size, m_blob_file) != entry.blob_size ||
       std::fflush(m_blob_file) != 0 || std::fwrite(&entry, sizeof(entry), 1, m_index_file) != 1 ||
       std::fflush(m_index_file) != 0)
   {
     Log_ErrorPrintf("Failed to write shader blob to file");
-    return prog;
+    return true;
   }
 
   m_index.emplace(key, data);
-  return prog;
+  return true;
 }
 
 } // namespace GL
@@ -25,8 +25,14 @@ public:
   std::optional<Program> GetProgram(const std::string_view vertex_shader, const std::string_view geometry_shader,
                                     const std::string_view fragment_shader, const PreLinkCallback& callback = {});
 
+  /// Starts compiling and linking a program in the background when the driver supports
+  /// GL_KHR_parallel_shader_compile, and does nothing otherwise or if the program is already cached. GetProgram() with
+  /// the same sources then waits for it instead of compiling it again.
+  void PrecompileProgram(const std::string_view vertex_shader, const std::string_view geometry_shader,
+                         const std::string_view fragment_shader, const PreLinkCallback& callback = {});
+
 private:
-  static constexpr u32 FILE_VERSION = 3;
+  static constexpr u32 FILE_VERSION = 4;
 
   struct CacheIndexKey
   {
@@ -61,6 +67,7 @@ private:
     u32 file_offset;
     u32 blob_size;
     u32 blob_format;
+    u32 uncompressed_size;
   };
 
   using CacheIndex = std::unordered_map<CacheIndexKey, CacheIndexData, CacheIndexEntryHasher>;
@@ -83,6 +90,9 @@ private:
                                               const std::string_view& geometry_shader,
                                               const std::string_view& fragment_shader, const PreLinkCallback& callback);
 
+  /// Writes a linked program to the cache. Returns false if the driver couldn't provide its binary.
+  bool AddProgram(const CacheIndexKey& key, Program& prog);
+
   std::string m_base_path;
   std::FILE* m_index_file = nullptr;
   std::FILE* m_blob_file = nullptr;
@@ -90,6 +100,10 @@ private:
   CacheIndex m_index;
   u32 m_version = 0;
   bool m_program_binary_supported = false;
+  bool m_parallel_compile_supported = false;
+
+  // Programs from PrecompileProgram() which haven't been picked up by GetProgram() yet.
+  std::unordered_map<CacheIndexKey, Program, CacheIndexEntryHasher> m_pending_programs;
 };
 
 } // namespace GL
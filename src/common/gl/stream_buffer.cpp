@@ -142,6 +142,8 @@ public:
     }
   }
 
+  bool IsRingBuffer() const override { return true; }
+
 protected:
   SyncingStreamBuffer(GLenum target, GLuint buffer_id, u32 size)
     : StreamBuffer(target, buffer_id, size), m_bytes_per_block((size + (NUM_SYNC_POINTS)-1) / NUM_SYNC_POINTS)
@@ -283,6 +285,66 @@ private:
   bool m_coherent;
 };
 
+// Maps each allocation with glMapBufferRange() unsynchronized, relying on the sync objects to avoid overwriting data
+// the GPU is still using. Used where {ARB,EXT}_buffer_storage isn't available, as orphaning can stall on some drivers.
+class MapAndSyncStreamBuffer final : public SyncingStreamBuffer
+{
+public:
+  ~MapAndSyncStreamBuffer() override = default;
+
+  MappingResult Map(u32 alignment, u32 min_size) override
+  {
+    if (m_position > 0)
+      m_position = Common::AlignUp(m_position, alignment);
+
+    AllocateSpace(min_size);
+    DebugAssert((m_position + min_size) <= (m_available_block_index * m_bytes_per_block));
+
+    const u32 free_space_in_block = std::min(m_available_block_index * m_bytes_per_block, m_size) - m_position;
+    Bind();
+    void* mapped_ptr = glMapBufferRange(m_target, m_position, free_space_in_block,
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                          GL_MAP_FLUSH_EXPLICIT_BIT);
+    Assert(mapped_ptr);
+
+    return MappingResult{mapped_ptr, m_position, m_position / alignment, free_space_in_block / alignment};
+  }
+
+  void Unmap(u32 used_size) override
+  {
+    DebugAssert((m_position + used_size) <= m_size);
+
+    Bind();
+    if (used_size > 0)
+      glFlushMappedBufferRange(m_target, 0, used_size);
+    glUnmapBuffer(m_target);
+
+    m_position += used_size;
+  }
+
+  static std::unique_ptr<StreamBuffer> Create(GLenum target, u32 size)
+  {
+    glGetError();
+
+    GLuint buffer_id;
+    glGenBuffers(1, &buffer_id);
+    glBindBuffer(target, buffer_id);
+    glBufferData(target, size, nullptr, GL_STREAM_DRAW);
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR)
+    {
+      glDeleteBuffers(1, &buffer_id);
+      return {};
+    }
+
+    return std::unique_ptr<StreamBuffer>(new MapAndSyncStreamBuffer(target, buffer_id, size));
+  }
+
+private:
+  MapAndSyncStreamBuffer(GLenum target, GLuint buffer_id, u32 size) : SyncingStreamBuffer(target, buffer_id, size) {}
+};
+
 } // namespace detail
 
 std::unique_ptr<StreamBuffer> StreamBuffer::Create(GLenum target, u32 size)
@@ -295,6 +357,14 @@ std::unique_ptr<StreamBuffer> StreamBuffer::Create(GLenum target, u32 size)
       return buf;
   }
 
+  // Prefer unsynchronized mapping over orphaning, as the driver doesn't need to reallocate on every upload.
+  if (GLAD_GL_VERSION_3_0 || GLAD_GL_ES_VERSION_3_0 || GLAD_GL_ARB_map_buffer_range)
+  {
+    buf = detail::MapAndSyncStreamBuffer::Create(target, size);
+    if (buf)
+      return buf;
+  }
+
   // BufferSubData is slower on all drivers except NVIDIA...
 #if 0
   const char* vendor = reinterpret_cast<const char*>(glGetString(GL_VENDOR));
@@ -29,6 +29,10 @@ public:
   virtual MappingResult Map(u32 alignment, u32 min_size) = 0;
   virtual void Unmap(u32 used_size) = 0;
 
+  /// Returns true if mappings are sub-allocated from fence-tracked regions, i.e. each mapping gets its own offset.
+  /// Such buffers can be shared between several kinds of uploads, as long as only one mapping is open at a time.
+  virtual bool IsRingBuffer() const { return false; }
+
   static std::unique_ptr<StreamBuffer> Create(GLenum target, u32 size);
 
 protected:
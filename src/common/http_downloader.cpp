@@ -70,6 +70,28 @@ void HTTPDownloader::CreatePostRequest(std::string url, std::string post_data, R
   LockedAddRequest(req);
 }
 
+void HTTPDownloader::CreateRangeRequest(std::string url, u64 range_start, u64 range_length,
+                                        Request::RangeCallback callback)
+{
+  Request* req = InternalCreateRequest();
+  req->parent = this;
+  req->type = Request::Type::Get;
+  req->url = std::move(url);
+  req->range_start = range_start;
+  req->range_length = range_length;
+  req->range_callback = std::move(callback);
+  req->start_time = Common::Timer::GetCurrentValue();
+
+  std::unique_lock<std::mutex> lock(m_pending_http_request_lock);
+  if (LockedGetActiveRequestCount() < m_max_active_requests)
+  {
+    if (!StartRequest(req))
+      return;
+  }
+
+  LockedAddRequest(req);
+}
+
 bool HTTPDownloader::HasAnyRequests()
 {
   std::unique_lock<std::mutex> lock(m_pending_http_request_lock);
@@ -107,7 +129,10 @@ void HTTPDownloader::LockedPollRequests(std::unique_lock<std::mutex>& lock)
       m_pending_http_requests.erase(m_pending_http_requests.begin() + index);
       lock.unlock();
 
-      req->callback(-1, std::string(), Request::Data());
+      if (req->range_callback)
+        req->range_callback(-1, 0, Request::Data());
+      else
+        req->callback(-1, std::string(), Request::Data());
 
       CloseRequest(req);
 
@@ -129,7 +154,10 @@ void HTTPDownloader::LockedPollRequests(std::unique_lock<std::mutex>& lock)
 
     // run callback with lock unheld
     lock.unlock();
-    req->callback(req->status_code, std::move(req->content_type), std::move(req->data));
+    if (req->range_callback)
+      req->range_callback(req->status_code, req->resource_size, std::move(req->data));
+    else
+      req->callback(req->status_code, std::move(req->content_type), std::move(req->data));
     CloseRequest(req);
     lock.lock();
   }
@@ -174,6 +202,13 @@ void HTTPDownloader::WaitForAllRequests()
     LockedPollRequests(lock);
 }
 
+void HTTPDownloader::WaitForRequestCountBelow(u32 count)
+{
+  std::unique_lock<std::mutex> lock(m_pending_http_request_lock);
+  while (m_pending_http_requests.size() >= count)
+    LockedPollRequests(lock);
+}
+
 void HTTPDownloader::LockedAddRequest(Request* request)
 {
   m_pending_http_requests.push_back(request);
@@ -190,6 +225,16 @@ u32 HTTPDownloader::LockedGetActiveRequestCount()
   return count;
 }
 
+u64 HTTPDownloader::ParseContentRangeSize(const std::string_view& content_range)
+{
+  // bytes <first>-<last>/<size>, size may be * if the server doesn't know it
+  const std::string_view::size_type pos = content_range.rfind('/');
+  if (pos == std::string_view::npos)
+    return 0;
+
+  return StringUtil::FromChars<u64>(StringUtil::StripWhitespace(content_range.substr(pos + 1))).value_or(0);
+}
+
 std::string HTTPDownloader::URLEncode(const std::string_view& str)
 {
   std::string ret;
@@ -15,13 +15,15 @@ class HTTPDownloader
 public:
   enum : s32
   {
-    HTTP_OK = 200
+    HTTP_OK = 200,
+    HTTP_PARTIAL_CONTENT = 206
   };
 
   struct Request
   {
     using Data = std::vector<u8>;
     using Callback = std::function<void(s32 status_code, std::string content_type, Data data)>;
+    using RangeCallback = std::function<void(s32 status_code, u64 resource_size, Data data)>;
 
     enum class Type
     {
@@ -40,6 +42,7 @@ public:
 
     HTTPDownloader* parent;
     Callback callback;
+    RangeCallback range_callback;
     std::string url;
     std::string post_data;
     std::string content_type;
@@ -47,6 +50,9 @@ public:
     u64 start_time;
     s32 status_code = 0;
     u32 content_length = 0;
+    u64 range_start = 0;
+    u64 range_length = 0;  // zero for the whole resource
+    u64 resource_size = 0; // total size from the Content-Range header of partial responses
     Type type = Type::Get;
     std::atomic<State> state{State::Pending};
   };
@@ -65,10 +71,17 @@ public:
   void CreateRequest(std::string url, Request::Callback callback);
   void CreatePostRequest(std::string url, std::string post_data, Request::Callback callback);
 
+  /// Requests range_length bytes starting at range_start. Servers which honour the range respond with
+  /// HTTP_PARTIAL_CONTENT, and the callback receives the size of the whole resource.
+  void CreateRangeRequest(std::string url, u64 range_start, u64 range_length, Request::RangeCallback callback);
+
   bool HasAnyRequests();
   void PollRequests();
   void WaitForAllRequests();
 
+  /// Polls until fewer than count requests are queued or in flight, so callers can bound how many they submit.
+  void WaitForRequestCountBelow(u32 count);
+
   static const char DEFAULT_USER_AGENT[];
 
 protected:
@@ -78,6 +91,9 @@ protected:
   virtual bool StartRequest(Request* request) = 0;
   virtual void CloseRequest(Request* request) = 0;
 
+  /// Returns the resource size from a Content-Range header value, or zero if it isn't known.
+  static u64 ParseContentRangeSize(const std::string_view& content_range);
+
   void LockedAddRequest(Request* request);
   u32 LockedGetActiveRequestCount();
   void LockedPollRequests(std::unique_lock<std::mutex>& lock);
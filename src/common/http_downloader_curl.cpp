@@ -3,6 +3,7 @@
 #include "common/log.h"
 #include "common/string_util.h"
 #include "common/timer.h"
+#include "fmt/format.h"
 #include <algorithm>
 #include <functional>
 #include <pthread.h>
@@ -13,7 +14,14 @@ namespace Common {
 
 HTTPDownloaderCurl::HTTPDownloaderCurl() : HTTPDownloader() {}
 
-HTTPDownloaderCurl::~HTTPDownloaderCurl() = default;
+HTTPDownloaderCurl::~HTTPDownloaderCurl()
+{
+  // in-flight requests still reference the share handle
+  m_thread_pool.reset();
+
+  if (m_share)
+    curl_share_cleanup(m_share);
+}
 
 std::unique_ptr<HTTPDownloader> HTTPDownloader::Create(const char* user_agent)
 {
@@ -49,10 +57,37 @@ bool HTTPDownloaderCurl::Initialize(const char* user_agent)
   }
 
   m_user_agent = user_agent;
-  m_thread_pool = std::make_unique<cb::ThreadPool>(m_max_active_requests);
+
+  m_share = curl_share_init();
+  if (m_share)
+  {
+    curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, &HTTPDownloaderCurl::ShareLockCallback);
+    curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, &HTTPDownloaderCurl::ShareUnlockCallback);
+    curl_share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+#if LIBCURL_VERSION_NUM >= 0x073900
+    curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+#endif
+  }
+  else
+  {
+    Log_WarningPrint("curl_share_init() failed, connections will not be reused");
+  }
+
   return true;
 }
 
+void HTTPDownloaderCurl::ShareLockCallback(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+  static_cast<HTTPDownloaderCurl*>(userptr)->m_share_mutexes[data].lock();
+}
+
+void HTTPDownloaderCurl::ShareUnlockCallback(CURL* handle, curl_lock_data data, void* userptr)
+{
+  static_cast<HTTPDownloaderCurl*>(userptr)->m_share_mutexes[data].unlock();
+}
+
 size_t HTTPDownloaderCurl::WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata)
 {
   Request* req = static_cast<Request*>(userdata);
@@ -64,6 +99,17 @@ size_t HTTPDownloaderCurl::WriteCallback(char* ptr, size_t size, size_t nmemb, v
   return nmemb;
 }
 
+size_t HTTPDownloaderCurl::HeaderCallback(char* ptr, size_t size, size_t nmemb, void* userdata)
+{
+  Request* req = static_cast<Request*>(userdata);
+  const std::string_view header(ptr, size * nmemb);
+  static constexpr std::string_view content_range = "Content-Range:";
+  if (header.length() > content_range.length() && StringUtil::StartsWithNoCase(header, content_range))
+    req->resource_size = ParseContentRangeSize(header.substr(content_range.length()));
+
+  return nmemb;
+}
+
 void HTTPDownloaderCurl::ProcessRequest(Request* req)
 {
   std::unique_lock<std::mutex> cancel_lock(m_cancel_mutex);
@@ -140,6 +186,24 @@ bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
   curl_easy_setopt(req->handle, CURLOPT_WRITEFUNCTION, &HTTPDownloaderCurl::WriteCallback);
   curl_easy_setopt(req->handle, CURLOPT_WRITEDATA, req);
   curl_easy_setopt(req->handle, CURLOPT_NOSIGNAL, 1);
+  curl_easy_setopt(req->handle, CURLOPT_TCP_KEEPALIVE, 1L);
+  curl_easy_setopt(req->handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+  if (m_share)
+    curl_easy_setopt(req->handle, CURLOPT_SHARE, m_share);
+
+  if (request->range_length > 0)
+  {
+    // ranges apply to the encoded body, so don't let the server compress it
+    const std::string range(
+      fmt::format("{}-{}", request->range_start, request->range_start + request->range_length - 1));
+    curl_easy_setopt(req->handle, CURLOPT_RANGE, range.c_str());
+    curl_easy_setopt(req->handle, CURLOPT_HEADERFUNCTION, &HTTPDownloaderCurl::HeaderCallback);
+    curl_easy_setopt(req->handle, CURLOPT_HEADERDATA, req);
+  }
+  else
+  {
+    curl_easy_setopt(req->handle, CURLOPT_ACCEPT_ENCODING, "");
+  }
 
   if (request->type == Request::Type::Post)
   {
@@ -150,6 +214,11 @@ bool HTTPDownloaderCurl::StartRequest(HTTPDownloader::Request* request)
   Log_DevPrintf("Started HTTP request for '%s'", req->url.c_str());
   req->state = Request::State::Started;
   req->start_time = Common::Timer::GetCurrentValue();
+
+  // created on first use, so SetMaxActiveRequests() after Create() still sizes the pool
+  if (!m_thread_pool)
+    m_thread_pool = std::make_unique<cb::ThreadPool>(m_max_active_requests);
+
   m_thread_pool->Schedule(std::bind(&HTTPDownloaderCurl::ProcessRequest, this, req));
   return true;
 }
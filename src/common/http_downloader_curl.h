@@ -30,11 +30,18 @@ private:
   };
 
   static size_t WriteCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
+  static size_t HeaderCallback(char* ptr, size_t size, size_t nmemb, void* userdata);
+  static void ShareLockCallback(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+  static void ShareUnlockCallback(CURL* handle, curl_lock_data data, void* userptr);
   void ProcessRequest(Request* req);
 
   std::string m_user_agent;
   std::unique_ptr<cb::ThreadPool> m_thread_pool;
   std::mutex m_cancel_mutex;
+
+  // lets requests reuse connections, DNS lookups and TLS sessions from earlier requests
+  CURLSH* m_share = nullptr;
+  std::mutex m_share_mutexes[CURL_LOCK_DATA_LAST];
 };
 
 } // namespace FrontendCommon
@@ -3,6 +3,7 @@
 #include "log.h"
 #include "string_util.h"
 #include "timer.h"
+#include "fmt/format.h"
 #include <VersionHelpers.h>
 #include <algorithm>
 Log_SetChannel(HTTPDownloaderWinHttp);
@@ -54,6 +55,13 @@ bool HTTPDownloaderWinHttp::Initialize(const char* user_agent)
     return false;
   }
 
+#ifdef WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL
+  // connections are already pooled per session, HTTP/2 lets concurrent requests share one. Needs Windows 10 1607+.
+  DWORD http2_flags = WINHTTP_PROTOCOL_FLAG_HTTP2;
+  if (!WinHttpSetOption(m_hSession, WINHTTP_OPTION_ENABLE_HTTP_PROTOCOL, &http2_flags, sizeof(http2_flags)))
+    Log_DevPrintf("Failed to enable HTTP/2: %u", GetLastError());
+#endif
+
   return true;
 }
 
@@ -144,6 +152,23 @@ void CALLBACK HTTPDownloaderWinHttp::HTTPStatusCallback(HINTERNET hRequest, DWOR
         }
       }
 
+      if (req->range_length > 0)
+      {
+        DWORD content_range_length = 0;
+        if (!WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_CONTENT_RANGE, WINHTTP_HEADER_NAME_BY_INDEX,
+                                 WINHTTP_NO_OUTPUT_BUFFER, &content_range_length, WINHTTP_NO_HEADER_INDEX) &&
+            GetLastError() == ERROR_INSUFFICIENT_BUFFER && content_range_length >= sizeof(wchar_t))
+        {
+          std::wstring content_range_wstring;
+          content_range_wstring.resize((content_range_length / sizeof(wchar_t)) - 1);
+          if (WinHttpQueryHeaders(hRequest, WINHTTP_QUERY_CONTENT_RANGE, WINHTTP_HEADER_NAME_BY_INDEX,
+                                  content_range_wstring.data(), &content_range_length, WINHTTP_NO_HEADER_INDEX))
+          {
+            req->resource_size = ParseContentRangeSize(StringUtil::WideStringToUTF8String(content_range_wstring));
+          }
+        }
+      }
+
       Log_DevPrintf("Status code %d, content-length is %u", req->status_code, req->content_length);
       req->data.reserve(req->content_length);
       req->state = Request::State::Receiving;
@@ -274,6 +299,13 @@ bool HTTPDownloaderWinHttp::StartRequest(HTTPDownloader::Request* request)
                                 req->post_data.data(), static_cast<DWORD>(req->post_data.size()),
                                 static_cast<DWORD>(req->post_data.size()), reinterpret_cast<DWORD_PTR>(req));
   }
+  else if (req->range_length > 0)
+  {
+    const std::wstring additional_headers(StringUtil::UTF8StringToWideString(
+      fmt::format("Range: bytes={}-{}\r\n", req->range_start, req->range_start + req->range_length - 1)));
+    result = WinHttpSendRequest(req->hRequest, additional_headers.data(), static_cast<DWORD>(additional_headers.size()),
+                                WINHTTP_NO_REQUEST_DATA, 0, 0, reinterpret_cast<DWORD_PTR>(req));
+  }
   else
   {
     result = WinHttpSendRequest(req->hRequest, WINHTTP_NO_ADDITIONAL_HEADERS, 0, WINHTTP_NO_REQUEST_DATA, 0, 0,
@@ -31,6 +31,9 @@ static bool STBBufferSaverJPEG(const RGBA8Image& image, std::vector<u8>* buffer,
 static bool STBFileSaverPNG(const RGBA8Image& image, const char* filename, std::FILE* fp, int quality);
 static bool STBFileSaverJPEG(const RGBA8Image& image, const char* filename, std::FILE* fp, int quality);
 
+static bool DDSBufferLoader(RGBA8Image* image, const void* buffer, size_t buffer_size);
+static bool DDSFileLoader(RGBA8Image* image, const char* filename, std::FILE* fp);
+
 struct FormatHandler
 {
   const char* extension;
@@ -50,6 +53,7 @@ static constexpr FormatHandler s_format_handlers[] = {
   {"jpg", STBBufferLoader, STBBufferSaverJPEG, STBFileLoader, STBFileSaverJPEG},
   {"jpeg", STBBufferLoader, STBBufferSaverJPEG, STBFileLoader, STBFileSaverJPEG},
 #endif
+  {"dds", DDSBufferLoader, nullptr, DDSFileLoader, nullptr},
 };
 
 static const FormatHandler* GetFormatHandler(const std::string_view& extension)
@@ -638,4 +642,327 @@ bool STBFileSaverJPEG(const RGBA8Image& image, const char* filename, std::FILE*
 
   return (stbi_write_jpg_to_func(write_func, fp, image.GetWidth(), image.GetHeight(), 4, image.GetPixels(), quality) !=
           0);
-}
\ No newline at end of file
+}
+
+namespace {
+#pragma pack(push, 1)
+struct DDSPixelFormat
+{
+  u32 size;
+  u32 flags;
+  u32 four_cc;
+  u32 rgb_bit_count;
+  u32 r_bit_mask;
+  u32 g_bit_mask;
+  u32 b_bit_mask;
+  u32 a_bit_mask;
+};
+
+struct DDSHeader
+{
+  u32 magic;
+  u32 size;
+  u32 flags;
+  u32 height;
+  u32 width;
+  u32 pitch_or_linear_size;
+  u32 depth;
+  u32 mip_map_count;
+  u32 reserved1[11];
+  DDSPixelFormat pixel_format;
+  u32 caps;
+  u32 caps2;
+  u32 caps3;
+  u32 caps4;
+  u32 reserved2;
+};
+
+struct DDSHeaderDX10
+{
+  u32 dxgi_format;
+  u32 resource_dimension;
+  u32 misc_flag;
+  u32 array_size;
+  u32 misc_flags2;
+};
+#pragma pack(pop)
+
+enum : u32
+{
+  DDS_MAGIC = 0x20534444, // "DDS "
+  DDPF_ALPHAPIXELS = 0x1,
+  DDPF_FOURCC = 0x4,
+  DDPF_RGB = 0x40,
+
+  DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+  DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+  DXGI_FORMAT_BC1_UNORM = 71,
+  DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+  DXGI_FORMAT_BC2_UNORM = 74,
+  DXGI_FORMAT_BC2_UNORM_SRGB = 75,
+  DXGI_FORMAT_BC3_UNORM = 77,
+  DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+  DXGI_FORMAT_B8G8R8A8_UNORM = 87,
+  DXGI_FORMAT_B8G8R8A8_UNORM_SRGB = 91,
+};
+
+enum class DDSFormat
+{
+  Unknown,
+  RGBA8,
+  BGRA8,
+  BC1,
+  BC2,
+  BC3
+};
+} // namespace
+
+static constexpr u32 MakeFourCC(char a, char b, char c, char d)
+{
+  return static_cast<u32>(static_cast<u8>(a)) | (static_cast<u32>(static_cast<u8>(b)) << 8) |
+         (static_cast<u32>(static_cast<u8>(c)) << 16) | (static_cast<u32>(static_cast<u8>(d)) << 24);
+}
+
+static u32 ExpandRGB565(u16 color)
+{
+  const u32 r = (color >> 11) & 31;
+  const u32 g = (color >> 5) & 63;
+  const u32 b = color & 31;
+  return ((r << 3) | (r >> 2)) | (((g << 2) | (g >> 4)) << 8) | (((b << 3) | (b >> 2)) << 16);
+}
+
+static u32 LerpRGB(u32 c0, u32 c1, u32 w0, u32 w1, u32 div)
+{
+  u32 res = 0;
+  for (u32 shift = 0; shift < 24; shift += 8)
+    res |= ((((c0 >> shift) & 0xFF) * w0 + ((c1 >> shift) & 0xFF) * w1) / div) << shift;
+  return res;
+}
+
+/// Decodes the colour part of a BC1/2/3 block. Alpha is set to opaque, or zero for BC1 punch-through.
+static void DecodeBCColorBlock(const u8* block, bool allow_punch_through, u32 out_pixels[16])
+{
+  u16 c0, c1;
+  u32 indices;
+  std::memcpy(&c0, block, sizeof(c0));
+  std::memcpy(&c1, block + 2, sizeof(c1));
+  std::memcpy(&indices, block + 4, sizeof(indices));
+
+  u32 colors[4];
+  colors[0] = ExpandRGB565(c0) | 0xFF000000u;
+  colors[1] = ExpandRGB565(c1) | 0xFF000000u;
+  if (c0 > c1 || !allow_punch_through)
+  {
+    colors[2] = LerpRGB(colors[0], colors[1], 2, 1, 3) | 0xFF000000u;
+    colors[3] = LerpRGB(colors[0], colors[1], 1, 2, 3) | 0xFF000000u;
+  }
+  else
+  {
+    colors[2] = LerpRGB(colors[0], colors[1], 1, 1, 2) | 0xFF000000u;
+    colors[3] = 0;
+  }
+
+  for (u32 i = 0; i < 16; i++)
+    out_pixels[i] = colors[(indices >> (i * 2)) & 3];
+}
+
+static void DecodeBC2AlphaBlock(const u8* block, u32 pixels[16])
+{
+  u64 alphas;
+  std::memcpy(&alphas, block, sizeof(alphas));
+  for (u32 i = 0; i < 16; i++)
+  {
+    const u32 alpha = static_cast<u32>((alphas >> (i * 4)) & 0xF);
+    pixels[i] = (pixels[i] & 0x00FFFFFFu) | (((alpha << 4) | alpha) << 24);
+  }
+}
+
+static void DecodeBC3AlphaBlock(const u8* block, u32 pixels[16])
+{
+  const u32 a0 = block[0];
+  const u32 a1 = block[1];
+  u32 alphas[8] = {a0, a1};
+  if (a0 > a1)
+  {
+    for (u32 i = 1; i < 7; i++)
+      alphas[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+  }
+  else
+  {
+    for (u32 i = 1; i < 5; i++)
+      alphas[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+    alphas[6] = 0;
+    alphas[7] = 255;
+  }
+
+  u64 indices = 0;
+  std::memcpy(&indices, block + 2, 6);
+  for (u32 i = 0; i < 16; i++)
+    pixels[i] = (pixels[i] & 0x00FFFFFFu) | (alphas[(indices >> (i * 3)) & 7] << 24);
+}
+
+static DDSFormat GetDDSFormat(const DDSHeader& header, const u8* data, size_t data_size, size_t* data_offset)
+{
+  const DDSPixelFormat& pf = header.pixel_format;
+  if (pf.flags & DDPF_FOURCC)
+  {
+    if (pf.four_cc == MakeFourCC('D', 'X', 'T', '1'))
+      return DDSFormat::BC1;
+    else if (pf.four_cc == MakeFourCC('D', 'X', 'T', '2') || pf.four_cc == MakeFourCC('D', 'X', 'T', '3'))
+      return DDSFormat::BC2;
+    else if (pf.four_cc == MakeFourCC('D', 'X', 'T', '4') || pf.four_cc == MakeFourCC('D', 'X', 'T', '5'))
+      return DDSFormat::BC3;
+    else if (pf.four_cc != MakeFourCC('D', 'X', '1', '0'))
+      return DDSFormat::Unknown;
+
+    DDSHeaderDX10 dx10_header;
+    if ((data_size - *data_offset) < sizeof(dx10_header))
+      return DDSFormat::Unknown;
+
+    std::memcpy(&dx10_header, data + *data_offset, sizeof(dx10_header));
+    *data_offset += sizeof(dx10_header);
+
+    switch (dx10_header.dxgi_format)
+    {
+      case DXGI_FORMAT_R8G8B8A8_UNORM:
+      case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+        return DDSFormat::RGBA8;
+      case DXGI_FORMAT_B8G8R8A8_UNORM:
+      case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+        return DDSFormat::BGRA8;
+      case DXGI_FORMAT_BC1_UNORM:
+      case DXGI_FORMAT_BC1_UNORM_SRGB:
+        return DDSFormat::BC1;
+      case DXGI_FORMAT_BC2_UNORM:
+      case DXGI_FORMAT_BC2_UNORM_SRGB:
+        return DDSFormat::BC2;
+      case DXGI_FORMAT_BC3_UNORM:
+      case DXGI_FORMAT_BC3_UNORM_SRGB:
+        return DDSFormat::BC3;
+      default:
+        return DDSFormat::Unknown;
+    }
+  }
+
+  if ((pf.flags & DDPF_RGB) && pf.rgb_bit_count == 32)
+  {
+    if (pf.r_bit_mask == 0x000000FFu && pf.g_bit_mask == 0x0000FF00u && pf.b_bit_mask == 0x00FF0000u)
+      return DDSFormat::RGBA8;
+    else if (pf.r_bit_mask == 0x00FF0000u && pf.g_bit_mask == 0x0000FF00u && pf.b_bit_mask == 0x000000FFu)
+      return DDSFormat::BGRA8;
+  }
+
+  return DDSFormat::Unknown;
+}
+
+bool DDSBufferLoader(RGBA8Image* image, const void* buffer, size_t buffer_size)
+{
+  const u8* data = static_cast<const u8*>(buffer);
+  DDSHeader header;
+  if (buffer_size < sizeof(header))
+  {
+    Log_ErrorPrintf("DDS file is too small");
+    return false;
+  }
+
+  std::memcpy(&header, data, sizeof(header));
+  if (header.magic != DDS_MAGIC || header.size != (sizeof(header) - sizeof(header.magic)) || header.width == 0 ||
+      header.height == 0)
+  {
+    Log_ErrorPrintf("Invalid DDS header");
+    return false;
+  }
+
+  size_t data_offset = sizeof(header);
+  const DDSFormat format = GetDDSFormat(header, data, buffer_size, &data_offset);
+  if (format == DDSFormat::Unknown)
+  {
+    Log_ErrorPrintf("Unsupported DDS pixel format");
+    return false;
+  }
+
+  // only the top mip level is used
+  const u32 width = header.width;
+  const u32 height = header.height;
+  const bool compressed = (format == DDSFormat::BC1 || format == DDSFormat::BC2 || format == DDSFormat::BC3);
+  const u32 blocks_wide = (width + 3) / 4;
+  const u32 blocks_high = (height + 3) / 4;
+  const u32 block_size = (format == DDSFormat::BC1) ? 8 : 16;
+  const size_t required_size = compressed ? (static_cast<size_t>(blocks_wide) * blocks_high * block_size) :
+                                            (static_cast<size_t>(width) * height * sizeof(u32));
+  if ((buffer_size - data_offset) < required_size)
+  {
+    Log_ErrorPrintf("DDS file is truncated");
+    return false;
+  }
+
+  const u8* src = data + data_offset;
+  std::vector<u32> pixels(static_cast<size_t>(width) * height);
+  if (!compressed)
+  {
+    std::memcpy(pixels.data(), src, required_size);
+    if (format == DDSFormat::BGRA8)
+    {
+      for (u32& pixel : pixels)
+        pixel = (pixel & 0xFF00FF00u) | ((pixel >> 16) & 0xFFu) | ((pixel & 0xFFu) << 16);
+    }
+
+    // without an alpha mask, the fourth byte is padding
+    if (!(header.pixel_format.flags & (DDPF_ALPHAPIXELS | DDPF_FOURCC)))
+    {
+      for (u32& pixel : pixels)
+        pixel |= 0xFF000000u;
+    }
+  }
+  else
+  {
+    u32 block_pixels[16];
+    for (u32 by = 0; by < blocks_high; by++)
+    {
+      for (u32 bx = 0; bx < blocks_wide; bx++)
+      {
+        switch (format)
+        {
+          case DDSFormat::BC1:
+            DecodeBCColorBlock(src, true, block_pixels);
+            break;
+
+          case DDSFormat::BC2:
+            DecodeBCColorBlock(src + 8, false, block_pixels);
+            DecodeBC2AlphaBlock(src, block_pixels);
+            break;
+
+          case DDSFormat::BC3:
+          default:
+            DecodeBCColorBlock(src + 8, false, block_pixels);
+            DecodeBC3AlphaBlock(src, block_pixels);
+            break;
+        }
+        src += block_size;
+
+        // blocks on the right and bottom edges can extend past the image
+        const u32 copy_width = std::min(width - bx * 4, 4u);
+        const u32 copy_height = std::min(height - by * 4, 4u);
+        for (u32 y = 0; y < copy_height; y++)
+        {
+          std::memcpy(&pixels[(by * 4 + y) * width + bx * 4], &block_pixels[y * 4], copy_width * sizeof(u32));
+        }
+      }
+    }
+  }
+
+  image->SetPixels(width, height, std::move(pixels));
+  return true;
+}
+
+bool DDSFileLoader(RGBA8Image* image, const char* filename, std::FILE* fp)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(fp);
+  if (!data.has_value())
+  {
+    Log_ErrorPrintf("Failed to read '%s'", filename);
+    return false;
+  }
+
+  return DDSBufferLoader(image, data->data(), data->size());
+}
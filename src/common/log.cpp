@@ -3,8 +3,14 @@
 #include "file_system.h"
 #include "string.h"
 #include "timer.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <memory>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 #if defined(_WIN32)
@@ -28,10 +34,16 @@ struct RegisteredCallback
 std::vector<RegisteredCallback> s_callbacks;
 static std::mutex s_callback_mutex;
 
-static LOGLEVEL s_filter_level = LOGLEVEL_TRACE;
+LOGLEVEL g_filter_level = LOGLEVEL_TRACE;
 
 static Common::Timer::Value s_startTimeStamp = Common::Timer::GetCurrentValue();
 
+// Time the message currently being passed to the callbacks was logged, protected by s_callback_mutex.
+static Common::Timer::Value s_message_timestamp = 0;
+
+// Set while this thread holds s_callback_mutex, so a callback which logs doesn't deadlock on it.
+static thread_local bool s_in_callbacks = false;
+
 static bool s_console_output_enabled = false;
 static String s_console_output_channel_filter;
 static LOGLEVEL s_console_output_level_filter = LOGLEVEL_TRACE;
@@ -57,6 +69,42 @@ std::unique_ptr<std::FILE, void (*)(std::FILE*)> s_fileOutputHandle(nullptr, [](
   }
 });
 
+namespace {
+struct QueuedMessageHeader
+{
+  Common::Timer::Value timestamp;
+  LOGLEVEL level;
+  u32 channel_length;
+  u32 function_length;
+  u32 message_length;
+};
+
+// Messages are copied into a ring buffer by the logging threads, and passed on to the callbacks by the output thread.
+// Declared after the sinks so that the thread is stopped before they are destroyed.
+struct AsyncOutputState
+{
+  static constexpr u32 BUFFER_SIZE = 1024 * 1024;
+  static constexpr u32 MAX_MESSAGE_LENGTH = BUFFER_SIZE / 16;
+
+  ~AsyncOutputState();
+
+  std::mutex mutex;
+  std::condition_variable wake_cv;
+  std::condition_variable done_cv;
+  std::unique_ptr<u8[]> buffer;
+  std::thread thread;
+  u32 read_pos = 0;
+  u32 write_pos = 0;
+  u32 used = 0;
+  u64 queued_count = 0;
+  u64 output_count = 0;
+  bool shutdown = true;
+};
+} // namespace
+
+static AsyncOutputState s_async_output;
+static std::atomic_bool s_async_output_enabled{false};
+
 void RegisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
 {
   RegisteredCallback Callback;
@@ -69,6 +117,9 @@ void RegisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
 
 void UnregisterCallback(CallbackFunctionType callbackFunction, void* pUserParam)
 {
+  // make sure anything logged before the callback was removed still reaches it
+  Flush();
+
   std::lock_guard<std::mutex> guard(s_callback_mutex);
 
   for (auto iter = s_callbacks.begin(); iter != s_callbacks.end(); ++iter)
@@ -91,11 +142,24 @@ bool IsDebugOutputEnabled()
   return s_debug_output_enabled;
 }
 
-static void ExecuteCallbacks(const char* channelName, const char* functionName, LOGLEVEL level, const char* message)
+static void ExecuteCallbacks(const char* channelName, const char* functionName, LOGLEVEL level, const char* message,
+                             Common::Timer::Value timestamp)
 {
-  std::lock_guard<std::mutex> guard(s_callback_mutex);
+  std::unique_lock<std::mutex> guard(s_callback_mutex, std::defer_lock);
+  const bool nested = s_in_callbacks;
+  if (!nested)
+  {
+    guard.lock();
+    s_in_callbacks = true;
+  }
+
+  const Common::Timer::Value outer_timestamp = s_message_timestamp;
+  s_message_timestamp = timestamp;
   for (RegisteredCallback& callback : s_callbacks)
     callback.Function(callback.Parameter, channelName, functionName, level, message);
+
+  s_message_timestamp = outer_timestamp;
+  s_in_callbacks = nested;
 }
 
 static int FormatLogMessageForDisplay(char* buffer, size_t buffer_size, const char* channelName,
@@ -123,7 +187,7 @@ static int FormatLogMessageForDisplay(char* buffer, size_t buffer_size, const ch
   {
     // find time since start of process
     const float message_time =
-      static_cast<float>(Common::Timer::ConvertValueToSeconds(Common::Timer::GetCurrentValue() - s_startTimeStamp));
+      static_cast<float>(Common::Timer::ConvertValueToSeconds(s_message_timestamp - s_startTimeStamp));
 
     if (level <= LOGLEVEL_PERF)
     {
@@ -428,23 +492,184 @@ void SetFileOutputParams(bool enabled, const char* filename, bool timestamps /*
   s_file_output_timestamp = timestamps;
 }
 
+static void CopyToRingBuffer(u32* pos, const void* data, u32 size)
+{
+  const u32 first = std::min(size, AsyncOutputState::BUFFER_SIZE - *pos);
+  std::memcpy(&s_async_output.buffer[*pos], data, first);
+  std::memcpy(&s_async_output.buffer[0], static_cast<const u8*>(data) + first, size - first);
+  *pos = (*pos + size) % AsyncOutputState::BUFFER_SIZE;
+}
+
+static void CopyFromRingBuffer(u32* pos, void* data, u32 size)
+{
+  const u32 first = std::min(size, AsyncOutputState::BUFFER_SIZE - *pos);
+  std::memcpy(data, &s_async_output.buffer[*pos], first);
+  std::memcpy(static_cast<u8*>(data) + first, &s_async_output.buffer[0], size - first);
+  *pos = (*pos + size) % AsyncOutputState::BUFFER_SIZE;
+}
+
+static bool QueueMessage(const char* channelName, const char* functionName, LOGLEVEL level, const char* message,
+                         Common::Timer::Value timestamp)
+{
+  // a callback logging from the output thread can't wait for space, since it's the one which frees it
+  if (std::this_thread::get_id() == s_async_output.thread.get_id())
+    return false;
+
+  QueuedMessageHeader hdr;
+  hdr.timestamp = timestamp;
+  hdr.level = level;
+  hdr.channel_length = static_cast<u32>(std::strlen(channelName));
+  hdr.function_length = static_cast<u32>(std::strlen(functionName));
+  hdr.message_length = std::min(static_cast<u32>(std::strlen(message)), AsyncOutputState::MAX_MESSAGE_LENGTH);
+
+  const u32 size = sizeof(hdr) + hdr.channel_length + hdr.function_length + hdr.message_length;
+
+  std::unique_lock<std::mutex> lock(s_async_output.mutex);
+  s_async_output.done_cv.wait(lock, [size]() {
+    return (s_async_output.shutdown || (AsyncOutputState::BUFFER_SIZE - s_async_output.used) >= size);
+  });
+
+  // thread is stopping, caller should write synchronously
+  if (s_async_output.shutdown)
+    return false;
+
+  const bool was_empty = (s_async_output.used == 0);
+  CopyToRingBuffer(&s_async_output.write_pos, &hdr, sizeof(hdr));
+  CopyToRingBuffer(&s_async_output.write_pos, channelName, hdr.channel_length);
+  CopyToRingBuffer(&s_async_output.write_pos, functionName, hdr.function_length);
+  CopyToRingBuffer(&s_async_output.write_pos, message, hdr.message_length);
+  s_async_output.used += size;
+  s_async_output.queued_count++;
+  lock.unlock();
+
+  if (was_empty)
+    s_async_output.wake_cv.notify_one();
+
+  return true;
+}
+
+static void AsyncOutputThreadEntryPoint()
+{
+  std::vector<char> strings;
+
+  std::unique_lock<std::mutex> lock(s_async_output.mutex);
+  for (;;)
+  {
+    s_async_output.wake_cv.wait(lock, []() { return (s_async_output.shutdown || s_async_output.used > 0); });
+    if (s_async_output.used == 0)
+      break;
+
+    QueuedMessageHeader hdr;
+    CopyFromRingBuffer(&s_async_output.read_pos, &hdr, sizeof(hdr));
+
+    const u32 string_size = hdr.channel_length + hdr.function_length + hdr.message_length;
+    strings.resize(string_size + 3);
+    char* channel_name = strings.data();
+    char* function_name = channel_name + hdr.channel_length + 1;
+    char* message = function_name + hdr.function_length + 1;
+    CopyFromRingBuffer(&s_async_output.read_pos, channel_name, hdr.channel_length);
+    CopyFromRingBuffer(&s_async_output.read_pos, function_name, hdr.function_length);
+    CopyFromRingBuffer(&s_async_output.read_pos, message, hdr.message_length);
+    channel_name[hdr.channel_length] = '\0';
+    function_name[hdr.function_length] = '\0';
+    message[hdr.message_length] = '\0';
+    s_async_output.used -= static_cast<u32>(sizeof(hdr)) + string_size;
+    lock.unlock();
+
+    ExecuteCallbacks(channel_name, function_name, hdr.level, message, hdr.timestamp);
+
+    lock.lock();
+    s_async_output.output_count++;
+    s_async_output.done_cv.notify_all();
+  }
+}
+
+AsyncOutputState::~AsyncOutputState()
+{
+  SetAsyncOutput(false);
+}
+
+bool IsAsyncOutputEnabled()
+{
+  return s_async_output_enabled.load(std::memory_order_relaxed);
+}
+
+void SetAsyncOutput(bool enabled)
+{
+  if (s_async_output_enabled.load(std::memory_order_relaxed) == enabled)
+    return;
+
+  if (enabled)
+  {
+    std::unique_lock<std::mutex> lock(s_async_output.mutex);
+    if (!s_async_output.buffer)
+      s_async_output.buffer = std::make_unique<u8[]>(AsyncOutputState::BUFFER_SIZE);
+
+    s_async_output.shutdown = false;
+    s_async_output.thread = std::thread(AsyncOutputThreadEntryPoint);
+    s_async_output_enabled.store(true, std::memory_order_release);
+  }
+  else
+  {
+    // the output thread drains the queue before exiting
+    s_async_output_enabled.store(false, std::memory_order_release);
+    {
+      std::unique_lock<std::mutex> lock(s_async_output.mutex);
+      s_async_output.shutdown = true;
+    }
+    s_async_output.wake_cv.notify_one();
+    s_async_output.done_cv.notify_all();
+    s_async_output.thread.join();
+  }
+}
+
+void Flush()
+{
+  if (!s_async_output_enabled.load(std::memory_order_acquire) ||
+      std::this_thread::get_id() == s_async_output.thread.get_id())
+  {
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(s_async_output.mutex);
+  const u64 target = s_async_output.queued_count;
+  s_async_output.done_cv.wait(
+    lock, [target]() { return (s_async_output.shutdown || s_async_output.output_count >= target); });
+}
+
+static void OutputMessage(const char* channelName, const char* functionName, LOGLEVEL level, const char* message)
+{
+  const Common::Timer::Value timestamp = Common::Timer::GetCurrentValue();
+  if (s_async_output_enabled.load(std::memory_order_acquire) &&
+      QueueMessage(channelName, functionName, level, message, timestamp))
+  {
+    // don't lose errors if we're about to crash
+    if (level <= LOGLEVEL_ERROR)
+      Flush();
+
+    return;
+  }
+
+  ExecuteCallbacks(channelName, functionName, level, message, timestamp);
+}
+
 void SetFilterLevel(LOGLEVEL level)
 {
   DebugAssert(level < LOGLEVEL_COUNT);
-  s_filter_level = level;
+  g_filter_level = level;
 }
 
 void Write(const char* channelName, const char* functionName, LOGLEVEL level, const char* message)
 {
-  if (level > s_filter_level)
+  if (level > g_filter_level)
     return;
 
-  ExecuteCallbacks(channelName, functionName, level, message);
+  OutputMessage(channelName, functionName, level, message);
 }
 
 void Writef(const char* channelName, const char* functionName, LOGLEVEL level, const char* format, ...)
 {
-  if (level > s_filter_level)
+  if (level > g_filter_level)
     return;
 
   va_list ap;
@@ -455,7 +680,7 @@ void Writef(const char* channelName, const char* functionName, LOGLEVEL level, c
 
 void Writev(const char* channelName, const char* functionName, LOGLEVEL level, const char* format, va_list ap)
 {
-  if (level > s_filter_level)
+  if (level > g_filter_level)
     return;
 
   va_list apCopy;
@@ -472,13 +697,13 @@ void Writev(const char* channelName, const char* functionName, LOGLEVEL level, c
   {
     char buffer[256];
     std::vsnprintf(buffer, countof(buffer), format, ap);
-    ExecuteCallbacks(channelName, functionName, level, buffer);
+    OutputMessage(channelName, functionName, level, buffer);
   }
   else
   {
     char* buffer = new char[requiredSize + 1];
     std::vsnprintf(buffer, requiredSize + 1, format, ap);
-    ExecuteCallbacks(channelName, functionName, level, buffer);
+    OutputMessage(channelName, functionName, level, buffer);
     delete[] buffer;
   }
 }
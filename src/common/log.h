@@ -1,6 +1,7 @@
 #pragma once
 #include "types.h"
 #include <cinttypes>
+#include <cstdarg>
 #include <mutex>
 
 enum LOGLEVEL
@@ -44,6 +45,21 @@ void SetFileOutputParams(bool enabled, const char* filename, bool timestamps = t
 // Sets global filtering level, messages below this level won't be sent to any of the logging sinks.
 void SetFilterLevel(LOGLEVEL level);
 
+// Returns true if messages of the specified level will be formatted and passed on to the sinks.
+extern LOGLEVEL g_filter_level;
+ALWAYS_INLINE bool IsLevelEnabled(LOGLEVEL level)
+{
+  return (level <= g_filter_level);
+}
+
+// When enabled, messages are queued and passed to the callbacks on a background thread.
+// Errors are always flushed before returning to the caller.
+bool IsAsyncOutputEnabled();
+void SetAsyncOutput(bool enabled);
+
+// Waits until all queued messages have been passed to the callbacks.
+void Flush();
+
 // writes a message to the log
 void Write(const char* channelName, const char* functionName, LOGLEVEL level, const char* message);
 void Writef(const char* channelName, const char* functionName, LOGLEVEL level, const char* format, ...) printflike(4, 5);
@@ -51,27 +67,34 @@ void Writev(const char* channelName, const char* functionName, LOGLEVEL level, c
 } // namespace Log
 
 // log wrappers
+// Arguments are not evaluated when the level is filtered out.
 #define Log_SetChannel(ChannelName) static const char* ___LogChannel___ = #ChannelName;
-#define Log_ErrorPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_ERROR, msg)
-#define Log_ErrorPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_ERROR, __VA_ARGS__)
-#define Log_WarningPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_WARNING, msg)
-#define Log_WarningPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_WARNING, __VA_ARGS__)
-#define Log_PerfPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_PERF, msg)
-#define Log_PerfPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_PERF, __VA_ARGS__)
-#define Log_InfoPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_INFO, msg)
-#define Log_InfoPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_INFO, __VA_ARGS__)
-#define Log_VerbosePrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_VERBOSE, msg)
-#define Log_VerbosePrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_VERBOSE, __VA_ARGS__)
-#define Log_DevPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_DEV, msg)
-#define Log_DevPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_DEV, __VA_ARGS__)
-#define Log_ProfilePrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_PROFILE, msg)
-#define Log_ProfilePrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_PROFILE, __VA_ARGS__)
+#define Log_WriteLevel_(level, func, ...)                                                                              \
+  do                                                                                                                   \
+  {                                                                                                                    \
+    if (Log::IsLevelEnabled(level))                                                                                    \
+      Log::func(___LogChannel___, __func__, level, __VA_ARGS__);                                                       \
+  } while (0)
+#define Log_ErrorPrint(msg) Log_WriteLevel_(LOGLEVEL_ERROR, Write, msg)
+#define Log_ErrorPrintf(...) Log_WriteLevel_(LOGLEVEL_ERROR, Writef, __VA_ARGS__)
+#define Log_WarningPrint(msg) Log_WriteLevel_(LOGLEVEL_WARNING, Write, msg)
+#define Log_WarningPrintf(...) Log_WriteLevel_(LOGLEVEL_WARNING, Writef, __VA_ARGS__)
+#define Log_PerfPrint(msg) Log_WriteLevel_(LOGLEVEL_PERF, Write, msg)
+#define Log_PerfPrintf(...) Log_WriteLevel_(LOGLEVEL_PERF, Writef, __VA_ARGS__)
+#define Log_InfoPrint(msg) Log_WriteLevel_(LOGLEVEL_INFO, Write, msg)
+#define Log_InfoPrintf(...) Log_WriteLevel_(LOGLEVEL_INFO, Writef, __VA_ARGS__)
+#define Log_VerbosePrint(msg) Log_WriteLevel_(LOGLEVEL_VERBOSE, Write, msg)
+#define Log_VerbosePrintf(...) Log_WriteLevel_(LOGLEVEL_VERBOSE, Writef, __VA_ARGS__)
+#define Log_DevPrint(msg) Log_WriteLevel_(LOGLEVEL_DEV, Write, msg)
+#define Log_DevPrintf(...) Log_WriteLevel_(LOGLEVEL_DEV, Writef, __VA_ARGS__)
+#define Log_ProfilePrint(msg) Log_WriteLevel_(LOGLEVEL_PROFILE, Write, msg)
+#define Log_ProfilePrintf(...) Log_WriteLevel_(LOGLEVEL_PROFILE, Writef, __VA_ARGS__)
 
 #ifdef _DEBUG
-#define Log_DebugPrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_DEBUG, msg)
-#define Log_DebugPrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_DEBUG, __VA_ARGS__)
-#define Log_TracePrint(msg) Log::Write(___LogChannel___, __func__, LOGLEVEL_TRACE, msg)
-#define Log_TracePrintf(...) Log::Writef(___LogChannel___, __func__, LOGLEVEL_TRACE, __VA_ARGS__)
+#define Log_DebugPrint(msg) Log_WriteLevel_(LOGLEVEL_DEBUG, Write, msg)
+#define Log_DebugPrintf(...) Log_WriteLevel_(LOGLEVEL_DEBUG, Writef, __VA_ARGS__)
+#define Log_TracePrint(msg) Log_WriteLevel_(LOGLEVEL_TRACE, Write, msg)
+#define Log_TracePrintf(...) Log_WriteLevel_(LOGLEVEL_TRACE, Writef, __VA_ARGS__)
 #else
 #define Log_DebugPrint(msg)                                                                                            \
   do                                                                                                                   \
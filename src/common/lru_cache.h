@@ -71,17 +71,24 @@ public:
   {
     while (!m_items.empty() && count > 0)
     {
-      typename MapType::iterator lowest = m_items.end();
-      for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
-      {
-        if (lowest == m_items.end() || iter->second.last_access < lowest->second.last_access)
-          lowest = iter;
-      }
-      m_items.erase(lowest);
+      m_items.erase(FindOldest());
       count--;
     }
   }
 
+  // Evicts the least recently used item, passing its value to the callback before it's destroyed.
+  template<typename Callback>
+  bool EvictOldest(const Callback& callback)
+  {
+    if (m_items.empty())
+      return false;
+
+    typename MapType::iterator oldest = FindOldest();
+    callback(oldest->second.value);
+    m_items.erase(oldest);
+    return true;
+  }
+
   template<typename KeyT>
   bool Remove(const KeyT& key)
   {
@@ -105,6 +112,17 @@ public:
   }
 
 private:
+  typename MapType::iterator FindOldest()
+  {
+    typename MapType::iterator lowest = m_items.end();
+    for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
+    {
+      if (lowest == m_items.end() || iter->second.last_access < lowest->second.last_access)
+        lowest = iter;
+    }
+    return lowest;
+  }
+
   void ShrinkForNewItem()
   {
     if (m_items.size() < m_max_capacity)
@@ -0,0 +1,102 @@
+#include "mapped_cache.h"
+#include "file_system.h"
+#include <cstring>
+#include <vector>
+
+u64 MappedCache::HashKey(const std::string_view& key)
+{
+  // FNV-1a
+  u64 hash = UINT64_C(0xCBF29CE484222325);
+  for (const char ch : key)
+  {
+    hash ^= static_cast<u8>(ch);
+    hash *= UINT64_C(0x100000001B3);
+  }
+
+  return hash;
+}
+
+u32 MappedCache::GetBucketCount(size_t num_keys)
+{
+  u32 num_buckets = MIN_BUCKETS;
+  while (num_buckets < (num_keys * 2))
+    num_buckets *= 2;
+
+  return num_buckets;
+}
+
+bool MappedCache::CheckHeader(const FileSystem::MappedFile& file, size_t header_size, u32 signature, u32 version)
+{
+  if (header_size < (sizeof(u32) * 2) || file.GetSize() < header_size)
+    return false;
+
+  u32 file_signature, file_version;
+  std::memcpy(&file_signature, file.GetData(), sizeof(file_signature));
+  std::memcpy(&file_version, file.GetData() + sizeof(file_signature), sizeof(file_version));
+  return (file_signature == signature && file_version == version);
+}
+
+bool MappedCache::IsValidLayout(const FileSystem::MappedFile& file, size_t header_size, u32 num_buckets, u32 num_keys,
+                                u64 records_size, u32 string_pool_size)
+{
+  return (num_buckets != 0 && (num_buckets & (num_buckets - 1)) == 0 && num_keys < num_buckets &&
+          (header_size + sizeof(u32) * static_cast<u64>(num_buckets) + records_size + string_pool_size) ==
+            file.GetSize());
+}
+
+const u32* MappedCache::GetBuckets(const FileSystem::MappedFile& file, size_t header_size)
+{
+  return reinterpret_cast<const u32*>(file.GetData() + header_size);
+}
+
+const u8* MappedCache::GetRecords(const FileSystem::MappedFile& file, size_t header_size, u32 num_buckets)
+{
+  return file.GetData() + header_size + sizeof(u32) * num_buckets;
+}
+
+std::string_view MappedCache::GetString(const FileSystem::MappedFile& file, u32 string_pool_size, const String& str)
+{
+  if ((static_cast<u64>(str.offset) + str.length) > string_pool_size)
+    return {};
+
+  const char* pool = reinterpret_cast<const char*>(file.GetData() + file.GetSize() - string_pool_size);
+  return std::string_view(pool + str.offset, str.length);
+}
+
+MappedCache::String MappedCache::StringPool::Add(const std::string_view& str)
+{
+  const String ret = {static_cast<u32>(m_data.size()), static_cast<u32>(str.size())};
+  m_data.append(str);
+  return ret;
+}
+
+std::string_view MappedCache::StringPool::Get(const String& str) const
+{
+  return std::string_view(m_data).substr(str.offset, str.length);
+}
+
+bool MappedCache::WriteFile(const std::string& filename, std::initializer_list<Section> sections)
+{
+  size_t size = 0;
+  for (const Section& section : sections)
+    size += section.size;
+
+  std::vector<u8> data(size);
+  u8* data_ptr = data.data();
+  for (const Section& section : sections)
+  {
+    if (section.size > 0)
+      std::memcpy(data_ptr, section.data, section.size);
+    data_ptr += section.size;
+  }
+
+  const std::string temp_filename(filename + ".tmp");
+  if (!FileSystem::WriteBinaryFile(temp_filename.c_str(), data.data(), data.size()) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str()))
+  {
+    FileSystem::DeleteFile(temp_filename.c_str());
+    return false;
+  }
+
+  return true;
+}
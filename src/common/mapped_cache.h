@@ -0,0 +1,114 @@
+#pragma once
+#include "types.h"
+#include <initializer_list>
+#include <string>
+#include <string_view>
+
+namespace FileSystem {
+class MappedFile;
+}
+
+/// Helpers for cache files which are mapped rather than parsed. These are laid out as a header, an open addressing
+/// hash table of u32 indices, fixed-size records, and a string pool at the end of the file which the records point
+/// into. Records are only decoded when they're looked up.
+namespace MappedCache {
+
+enum : u32
+{
+  MIN_BUCKETS = 64,
+  EMPTY_BUCKET = 0xFFFFFFFFu,
+};
+
+/// Reference to a string in the pool.
+struct String
+{
+  u32 offset;
+  u32 length;
+};
+
+/// Contiguous block of the file, used when writing it out.
+struct Section
+{
+  const void* data;
+  size_t size;
+};
+
+/// FNV-1a hash of a key, stored in the records so most mismatches don't need to look at the string pool.
+u64 HashKey(const std::string_view& key);
+
+/// Returns a power of two bucket count which keeps the table at most half full.
+u32 GetBucketCount(size_t num_keys);
+
+/// Returns true if the file is large enough for the header, and it starts with the signature and version. Headers must
+/// begin with these two u32s.
+bool CheckHeader(const FileSystem::MappedFile& file, size_t header_size, u32 signature, u32 version);
+
+/// Returns true if the bucket count can hold num_keys, and the header, buckets, records and string pool add up to the
+/// size of the file.
+bool IsValidLayout(const FileSystem::MappedFile& file, size_t header_size, u32 num_buckets, u32 num_keys,
+                   u64 records_size, u32 string_pool_size);
+
+/// Returns the bucket table, which directly follows the header.
+const u32* GetBuckets(const FileSystem::MappedFile& file, size_t header_size);
+
+/// Returns the start of the records, which directly follow the bucket table.
+const u8* GetRecords(const FileSystem::MappedFile& file, size_t header_size, u32 num_buckets);
+
+/// Returns a string from the pool at the end of the file, or an empty string if it's out of bounds.
+std::string_view GetString(const FileSystem::MappedFile& file, u32 string_pool_size, const String& str);
+
+/// Probes the table for hash, returning the first index for which match(index) is true, or EMPTY_BUCKET. Indices of
+/// num_items or above can only come from a corrupted file, and end the search.
+template<typename T>
+u32 Find(const u32* buckets, u32 num_buckets, u32 num_items, u64 hash, const T& match)
+{
+  const u32 bucket_mask = num_buckets - 1;
+  for (u32 i = 0; i < num_buckets; i++)
+  {
+    const u32 index = buckets[(static_cast<u32>(hash) + i) & bucket_mask];
+    if (index == EMPTY_BUCKET || index >= num_items)
+      break;
+
+    if (match(index))
+      return index;
+  }
+
+  return EMPTY_BUCKET;
+}
+
+/// Returns the bucket a new key with this hash goes in, or EMPTY_BUCKET if is_duplicate(index) is true for one of the
+/// keys already in the table. The table must have a free bucket.
+template<typename T>
+u32 FindFreeBucket(const u32* buckets, u32 num_buckets, u64 hash, const T& is_duplicate)
+{
+  const u32 bucket_mask = num_buckets - 1;
+  u32 bucket = static_cast<u32>(hash) & bucket_mask;
+  while (buckets[bucket] != EMPTY_BUCKET)
+  {
+    if (is_duplicate(buckets[bucket]))
+      return EMPTY_BUCKET;
+
+    bucket = (bucket + 1) & bucket_mask;
+  }
+
+  return bucket;
+}
+
+/// Builds the string pool when writing a cache.
+class StringPool
+{
+public:
+  String Add(const std::string_view& str);
+  std::string_view Get(const String& str) const;
+
+  ALWAYS_INLINE const char* GetData() const { return m_data.data(); }
+  ALWAYS_INLINE u32 GetSize() const { return static_cast<u32>(m_data.size()); }
+
+private:
+  std::string m_data;
+};
+
+/// Writes the sections one after another, through a temporary file so a crash can't leave a truncated cache behind.
+bool WriteFile(const std::string& filename, std::initializer_list<Section> sections);
+
+} // namespace MappedCache
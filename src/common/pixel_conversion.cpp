@@ -0,0 +1,172 @@
+#include "pixel_conversion.h"
+#include "platform.h"
+#include <cstring>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#endif
+
+// Rounded scaling to 8 bits, matching VRAMConvert5To8(). Constants from https://stackoverflow.com/a/9069480
+ALWAYS_INLINE static constexpr u32 Expand5To8(u32 value)
+{
+  return ((value * 527u) + 23u) >> 6;
+}
+ALWAYS_INLINE static constexpr u32 Expand6To8(u32 value)
+{
+  return ((value * 259u) + 33u) >> 6;
+}
+
+ALWAYS_INLINE static u16 LoadPixel16(const u8* src)
+{
+  u16 value;
+  std::memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+template<bool bgra>
+ALWAYS_INLINE static u32 ConvertPixelRGBA5551(u32 value)
+{
+  const u32 r = Expand5To8(value & 31u);
+  const u32 g = Expand5To8((value >> 5) & 31u);
+  const u32 b = Expand5To8((value >> 10) & 31u);
+  const u32 a = (value & 0x8000u) ? 0xFF000000u : 0u;
+  return (bgra ? (b | (r << 16)) : (r | (b << 16))) | (g << 8) | a;
+}
+
+#if defined(CPU_X64)
+
+ALWAYS_INLINE static __m128i Expand5To8(__m128i value)
+{
+  return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(value, _mm_set1_epi16(527)), _mm_set1_epi16(23)), 6);
+}
+
+ALWAYS_INLINE static __m128i Expand6To8(__m128i value)
+{
+  return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(value, _mm_set1_epi16(259)), _mm_set1_epi16(33)), 6);
+}
+
+/// Interleaves the low (RG/BG) and high (BA/RA) halves of eight pixels, and stores them.
+ALWAYS_INLINE static void StorePixels32(u32* dst, __m128i lo, __m128i hi)
+{
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), _mm_unpacklo_epi16(lo, hi));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4), _mm_unpackhi_epi16(lo, hi));
+}
+
+#endif
+
+template<bool bgra>
+ALWAYS_INLINE static void ConvertRGBA5551(u32* dst, const void* src, u32 count, u32 alpha_or)
+{
+  const u8* src_ptr = static_cast<const u8*>(src);
+  u32 i = 0;
+
+#if defined(CPU_X64)
+  const __m128i mask5 = _mm_set1_epi16(0x1F);
+  const __m128i mask8 = _mm_set1_epi16(0xFF);
+  const __m128i lo_or = _mm_set1_epi16(static_cast<s16>(Truncate16(alpha_or)));
+  const __m128i hi_or = _mm_set1_epi16(static_cast<s16>(Truncate16(alpha_or >> 16)));
+  for (; (i + 8) <= count; i += 8)
+  {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += sizeof(u16) * 8;
+
+    const __m128i r = Expand5To8(_mm_and_si128(value, mask5));
+    const __m128i g = Expand5To8(_mm_and_si128(_mm_srli_epi16(value, 5), mask5));
+    const __m128i b = Expand5To8(_mm_and_si128(_mm_srli_epi16(value, 10), mask5));
+    const __m128i a = _mm_and_si128(_mm_srai_epi16(value, 15), mask8);
+    const __m128i lo = _mm_or_si128(_mm_or_si128(bgra ? b : r, _mm_slli_epi16(g, 8)), lo_or);
+    const __m128i hi = _mm_or_si128(_mm_or_si128(bgra ? r : b, _mm_slli_epi16(a, 8)), hi_or);
+    StorePixels32(dst, lo, hi);
+    dst += 8;
+  }
+#endif
+
+  for (; i < count; i++)
+  {
+    *(dst++) = ConvertPixelRGBA5551<bgra>(LoadPixel16(src_ptr)) | alpha_or;
+    src_ptr += sizeof(u16);
+  }
+}
+
+void PixelConversion::ConvertRGBA5551ToRGBA8(u32* dst, const void* src, u32 count, u32 alpha_or)
+{
+  ConvertRGBA5551<false>(dst, src, count, alpha_or);
+}
+
+void PixelConversion::ConvertRGBA5551ToBGRA8(u32* dst, const void* src, u32 count, u32 alpha_or)
+{
+  ConvertRGBA5551<true>(dst, src, count, alpha_or);
+}
+
+void PixelConversion::ConvertRGB565ToRGBA8(u32* dst, const void* src, u32 count)
+{
+  const u8* src_ptr = static_cast<const u8*>(src);
+  u32 i = 0;
+
+#if defined(CPU_X64)
+  const __m128i mask5 = _mm_set1_epi16(0x1F);
+  const __m128i mask6 = _mm_set1_epi16(0x3F);
+  const __m128i alpha = _mm_set1_epi16(static_cast<s16>(0xFF00));
+  for (; (i + 8) <= count; i += 8)
+  {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += sizeof(u16) * 8;
+
+    const __m128i r = Expand5To8(_mm_srli_epi16(value, 11));
+    const __m128i g = Expand6To8(_mm_and_si128(_mm_srli_epi16(value, 5), mask6));
+    const __m128i b = Expand5To8(_mm_and_si128(value, mask5));
+    StorePixels32(dst, _mm_or_si128(r, _mm_slli_epi16(g, 8)), _mm_or_si128(b, alpha));
+    dst += 8;
+  }
+#endif
+
+  for (; i < count; i++)
+  {
+    const u32 value = LoadPixel16(src_ptr);
+    src_ptr += sizeof(u16);
+
+    const u32 r = Expand5To8(value >> 11);
+    const u32 g = Expand6To8((value >> 5) & 63u);
+    const u32 b = Expand5To8(value & 31u);
+    *(dst++) = r | (g << 8) | (b << 16) | 0xFF000000u;
+  }
+}
+
+template<bool bgra>
+ALWAYS_INLINE static void ConvertRGB888(u32* dst, const void* src, u32 count)
+{
+  const u8* src_ptr = static_cast<const u8*>(src);
+  u32 i = 0;
+
+  // Load four bytes per pixel and discard the fourth, which is safe for all but the last pixel.
+  for (; (i + 1) < count; i++)
+  {
+    u32 value;
+    std::memcpy(&value, src_ptr, sizeof(value));
+    src_ptr += 3;
+
+    if constexpr (bgra)
+      value = (value & 0x00FF00u) | ((value & 0xFFu) << 16) | ((value >> 16) & 0xFFu);
+
+    *(dst++) = value | 0xFF000000u;
+  }
+
+  for (; i < count; i++)
+  {
+    const u32 r = src_ptr[0];
+    const u32 g = src_ptr[1];
+    const u32 b = src_ptr[2];
+    src_ptr += 3;
+    *(dst++) = (bgra ? (b | (r << 16)) : (r | (b << 16))) | (g << 8) | 0xFF000000u;
+  }
+}
+
+void PixelConversion::ConvertRGB888ToRGBA8(u32* dst, const void* src, u32 count)
+{
+  ConvertRGB888<false>(dst, src, count);
+}
+
+void PixelConversion::ConvertRGB888ToBGRA8(u32* dst, const void* src, u32 count)
+{
+  ConvertRGB888<true>(dst, src, count);
+}
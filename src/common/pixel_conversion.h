@@ -0,0 +1,26 @@
+#pragma once
+#include "types.h"
+
+/// Row conversion kernels between the 16/24-bit formats used by the console and 32-bit formats.
+/// Sources don't need to be aligned. Alpha values are OR'ed into every output pixel.
+namespace PixelConversion {
+
+/// Red in bits 0-4, green in 5-9, blue in 10-14, alpha in bit 15. The layout of PSX VRAM.
+void ConvertRGBA5551ToRGBA8(u32* dst, const void* src, u32 count, u32 alpha_or = 0);
+void ConvertRGBA5551ToBGRA8(u32* dst, const void* src, u32 count, u32 alpha_or = 0);
+
+/// Blue in bits 0-4, green in 5-9, red in 10-14, alpha in bit 15. GPUTexture::Format::RGBA5551.
+ALWAYS_INLINE static void ConvertBGRA5551ToRGBA8(u32* dst, const void* src, u32 count, u32 alpha_or = 0)
+{
+  // swapping red and blue on both sides is the same conversion
+  ConvertRGBA5551ToBGRA8(dst, src, count, alpha_or);
+}
+
+/// Blue in bits 0-4, green in 5-10, red in 11-15. GPUTexture::Format::RGB565. Alpha is always opaque.
+void ConvertRGB565ToRGBA8(u32* dst, const void* src, u32 count);
+
+/// Packed 24-bit pixels with red in the first byte, as in PSX VRAM. Alpha is always opaque.
+void ConvertRGB888ToRGBA8(u32* dst, const void* src, u32 count);
+void ConvertRGB888ToBGRA8(u32* dst, const void* src, u32 count);
+
+} // namespace PixelConversion
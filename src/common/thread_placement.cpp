@@ -0,0 +1,261 @@
+#include "thread_placement.h"
+#include "log.h"
+#include "threading.h"
+#include "cpuinfo.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <mutex>
+#include <utility>
+#include <vector>
+Log_SetChannel(ThreadPlacement);
+
+#if defined(_WIN32)
+#include "windows_headers.h"
+#elif defined(__APPLE__)
+#include <pthread.h>
+#elif defined(__linux__)
+#include "file_system.h"
+#include "string_util.h"
+#include <fmt/format.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Threading {
+
+namespace {
+struct CoreClassMasks
+{
+  u64 performance = 0;
+  u64 efficiency = 0;
+};
+} // namespace
+
+static CoreClassMasks DetectCoreClasses();
+static const CoreClassMasks& GetCoreClasses();
+static bool RaiseCurrentThreadPriority();
+
+static constexpr std::array<const char*, static_cast<size_t>(ThreadClass::Count)> s_thread_class_names = {
+  {"Emulation", "GPU Renderer", "CD-ROM Reader", "Presentation"}};
+
+static std::atomic_bool s_thread_pinning_enabled{false};
+
+void SetThreadPinningEnabled(bool enabled)
+{
+  s_thread_pinning_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void ApplyThreadPlacement(ThreadClass tc)
+{
+  if (!s_thread_pinning_enabled.load(std::memory_order_relaxed))
+    return;
+
+  const CoreClassMasks& masks = GetCoreClasses();
+  if (masks.efficiency == 0)
+    return;
+
+  const char* name = s_thread_class_names[static_cast<size_t>(tc)];
+  const bool performance = (tc == ThreadClass::Emulation || tc == ThreadClass::GPURenderer);
+
+#ifndef __APPLE__
+  // macOS doesn't do affinity, the QoS class picks the core type there
+  const u64 mask = performance ? masks.performance : masks.efficiency;
+  if (ThreadHandle::GetForCallingThread().SetAffinity(mask))
+    Log_DevPrintf("Pinned %s thread to 0x%" PRIx64, name, mask);
+  else
+    Log_WarningPrintf("Failed to pin %s thread to 0x%" PRIx64, name, mask);
+#endif
+
+  // the presenter is light, but shouldn't be held up by background work on the efficiency cores
+  if ((performance || tc == ThreadClass::Presentation) && !RaiseCurrentThreadPriority())
+    Log_DevPrintf("Not permitted to raise priority of %s thread", name);
+}
+
+const CoreClassMasks& GetCoreClasses()
+{
+  static CoreClassMasks s_masks;
+  static std::once_flag s_masks_once;
+  std::call_once(s_masks_once, []() { s_masks = DetectCoreClasses(); });
+  return s_masks;
+}
+
+CoreClassMasks DetectCoreClasses()
+{
+  CoreClassMasks masks;
+  if (!cpuinfo_initialize())
+  {
+    Log_WarningPrint("Failed to query CPU topology, threads won't be pinned.");
+    return masks;
+  }
+
+  // Only the slowest tier of cores is used for efficiency work, so the middle tier of three-tier SoCs counts as
+  // performance cores. Tiers are told apart by core type where possible: the efficiency class on Windows, or the
+  // microarchitecture elsewhere. Otherwise they're told apart by clock speed, where a gap of more than 20% is needed,
+  // since per-core boost limits vary a little between cores of the same type. Only the first 64 processors are
+  // considered, since that's all an affinity mask can hold.
+  struct Processor
+  {
+    u32 bit;
+    u32 type;
+    u64 frequency;
+  };
+  std::vector<Processor> processors;
+  const u32 num_processors = cpuinfo_get_processors_count();
+  for (u32 i = 0; i < num_processors; i++)
+  {
+    const cpuinfo_processor* proc = cpuinfo_get_processor(i);
+#if defined(_WIN32)
+    if (proc->windows_group_id != 0)
+      continue;
+    const u32 bit = proc->windows_processor_id;
+#elif defined(__linux__)
+    const u32 bit = static_cast<u32>(proc->linux_id);
+#else
+    const u32 bit = i;
+#endif
+    if (bit >= 64)
+      continue;
+
+    u64 frequency = proc->core->frequency;
+#if defined(__linux__)
+    // cpuinfo doesn't know the clocks of x86 cores, but the kernel does
+    if (frequency == 0)
+    {
+      const std::optional<std::string> max_freq = FileSystem::ReadFileToString(
+        fmt::format("/sys/devices/system/cpu/cpu{}/cpufreq/cpuinfo_max_freq", bit).c_str());
+      if (max_freq.has_value())
+        frequency = StringUtil::FromChars<u64>(StringUtil::StripWhitespace(max_freq.value())).value_or(0);
+    }
+#endif
+
+    processors.push_back(Processor{bit, static_cast<u32>(proc->core->uarch), frequency});
+  }
+
+#if defined(_WIN32)
+  // Windows classifies hybrid cores itself, higher efficiency classes are faster
+  DWORD cpu_set_size = 0;
+  GetSystemCpuSetInformation(nullptr, 0, &cpu_set_size, GetCurrentProcess(), 0);
+  std::vector<u8> cpu_sets(cpu_set_size);
+  if (cpu_set_size > 0 &&
+      GetSystemCpuSetInformation(reinterpret_cast<PSYSTEM_CPU_SET_INFORMATION>(cpu_sets.data()), cpu_set_size,
+                                 &cpu_set_size, GetCurrentProcess(), 0))
+  {
+    for (DWORD offset = 0; offset < cpu_set_size;)
+    {
+      const SYSTEM_CPU_SET_INFORMATION* info =
+        reinterpret_cast<const SYSTEM_CPU_SET_INFORMATION*>(cpu_sets.data() + offset);
+      offset += info->Size;
+      if (info->Type != CpuSetInformation || info->CpuSet.Group != 0)
+        continue;
+
+      for (Processor& proc : processors)
+      {
+        if (proc.bit == info->CpuSet.LogicalProcessorIndex)
+          proc.type = info->CpuSet.EfficiencyClass;
+      }
+    }
+  }
+#endif
+
+  if (processors.empty())
+    return masks;
+
+  const bool has_core_types = std::any_of(processors.begin(), processors.end(),
+                                          [&processors](const Processor& p) { return p.type != processors[0].type; });
+  if (has_core_types)
+  {
+#if defined(_WIN32)
+    const u32 efficiency_type =
+      std::min_element(processors.begin(), processors.end(), [](const Processor& lhs, const Processor& rhs) {
+        return lhs.type < rhs.type;
+      })->type;
+#else
+    // the slowest microarchitecture is the one whose fastest core is slowest
+    std::vector<std::pair<u32, u64>> type_frequencies;
+    for (const Processor& proc : processors)
+    {
+      auto it = std::find_if(type_frequencies.begin(), type_frequencies.end(),
+                             [&proc](const auto& tf) { return tf.first == proc.type; });
+      if (it == type_frequencies.end())
+        type_frequencies.emplace_back(proc.type, proc.frequency);
+      else if (it->second != 0)
+        it->second = (proc.frequency != 0) ? std::max(it->second, proc.frequency) : 0;
+    }
+
+    const auto efficiency_it =
+      std::min_element(type_frequencies.begin(), type_frequencies.end(),
+                       [](const auto& lhs, const auto& rhs) { return lhs.second < rhs.second; });
+    if (efficiency_it->second == 0)
+    {
+      Log_InfoPrint("Clock speeds of the core types are unknown, threads won't be pinned.");
+      return masks;
+    }
+
+    const u32 efficiency_type = efficiency_it->first;
+#endif
+
+    for (const Processor& proc : processors)
+    {
+      if (proc.type == efficiency_type)
+        masks.efficiency |= (static_cast<u64>(1) << proc.bit);
+      else
+        masks.performance |= (static_cast<u64>(1) << proc.bit);
+    }
+  }
+  else
+  {
+    std::sort(processors.begin(), processors.end(),
+              [](const Processor& lhs, const Processor& rhs) { return lhs.frequency < rhs.frequency; });
+
+    // the slowest tier ends at the first gap of more than 20%
+    size_t num_efficiency = 0;
+    if (processors.front().frequency != 0)
+    {
+      for (size_t i = 1; i < processors.size(); i++)
+      {
+        if ((processors[i].frequency * 5) > (processors[i - 1].frequency * 6))
+        {
+          num_efficiency = i;
+          break;
+        }
+      }
+    }
+
+    for (size_t i = 0; i < processors.size(); i++)
+    {
+      if (i < num_efficiency)
+        masks.efficiency |= (static_cast<u64>(1) << processors[i].bit);
+      else
+        masks.performance |= (static_cast<u64>(1) << processors[i].bit);
+    }
+  }
+
+  if (masks.efficiency == 0)
+  {
+    Log_InfoPrintf("All %zu processors are the same class, threads won't be pinned.", processors.size());
+    return {};
+  }
+
+  Log_InfoPrintf("Performance cores: 0x%" PRIx64 ", efficiency cores: 0x%" PRIx64, masks.performance,
+                 masks.efficiency);
+  return masks;
+}
+
+bool RaiseCurrentThreadPriority()
+{
+#if defined(_WIN32)
+  return (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL) != 0);
+#elif defined(__APPLE__)
+  return (pthread_set_qos_class_self_np(QOS_CLASS_USER_INTERACTIVE, 0) == 0);
+#elif defined(__linux__)
+  // needs CAP_SYS_NICE or a raised RLIMIT_NICE, most desktop users won't have either
+  return (setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), -5) == 0);
+#else
+  return false;
+#endif
+}
+
+} // namespace Threading
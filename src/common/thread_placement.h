@@ -0,0 +1,23 @@
+#pragma once
+#include "types.h"
+
+namespace Threading {
+
+/// Kinds of long-running threads, which are placed on cores by how much they need single-threaded performance.
+enum class ThreadClass : u8
+{
+  Emulation,    // CPU emulation and everything on its thread, performance cores
+  GPURenderer,  // software renderer backend, performance cores
+  CDROMReader,  // disc image reads and decompression, efficiency cores
+  Presentation, // swap chain presents, efficiency cores
+  Count
+};
+
+/// Enables or disables pinning threads to core classes. Only affects threads which start afterwards.
+void SetThreadPinningEnabled(bool enabled);
+
+/// Pins the calling thread to the cores suited to its class, and raises its priority where the OS lets us. Does
+/// nothing on CPUs where every core is the same.
+void ApplyThreadPlacement(ThreadClass tc);
+
+} // namespace Threading
@@ -0,0 +1,214 @@
+#include "thread_pool.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <thread>
+Log_SetChannel(ThreadPool);
+
+namespace Threading {
+
+static thread_local ThreadPool* s_current_pool = nullptr;
+static thread_local u32 s_current_worker = 0;
+
+ThreadPool::TaskGroup::TaskGroup() = default;
+
+ThreadPool::TaskGroup::~TaskGroup()
+{
+  DebugAssertMsg(IsDone(), "Task group should be complete at destruction");
+}
+
+void ThreadPool::TaskGroup::TaskAdded()
+{
+  m_pending.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void ThreadPool::TaskGroup::TaskDone()
+{
+  // decrement under the lock, so the waiter can't destroy the group before we're done with it
+  std::unique_lock<std::mutex> lock(m_mutex);
+  if (m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    m_cv.notify_all();
+}
+
+void ThreadPool::TaskGroup::Wait(ThreadPool& pool)
+{
+  const u32 home_index = (s_current_pool == &pool) ? s_current_worker : 0;
+  while (!IsDone())
+  {
+    // help out instead of sleeping, this also avoids deadlocks when waiting from a worker
+    QueuedTask task;
+    if (pool.PopTask(home_index, &task, this))
+    {
+      pool.RunTask(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return IsDone(); });
+  }
+
+  // synchronize with the last TaskDone() call
+  std::unique_lock<std::mutex> lock(m_mutex);
+}
+
+ThreadPool::ThreadPool(u32 num_threads, const char* name, u64 affinity_mask) : m_name(name)
+{
+  num_threads = std::max(num_threads, 1u);
+
+  // all workers have to exist before any of them start stealing
+  m_workers.reserve(num_threads);
+  for (u32 i = 0; i < num_threads; i++)
+    m_workers.push_back(std::make_unique<Worker>());
+
+  for (u32 i = 0; i < num_threads; i++)
+    m_workers[i]->thread.Start([this, i, affinity_mask]() { WorkerThreadEntryPoint(i, affinity_mask); });
+
+  Log_DevPrintf("Started %u workers for '%s' (affinity mask 0x%" PRIx64 ")", num_threads, name, affinity_mask);
+}
+
+ThreadPool::~ThreadPool()
+{
+  // workers finish anything which is already queued before exiting
+  {
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    m_shutdown = true;
+  }
+  m_wake_cv.notify_all();
+
+  for (std::unique_ptr<Worker>& worker : m_workers)
+    worker->thread.Join();
+}
+
+ThreadPool& ThreadPool::GetShared()
+{
+  static ThreadPool s_shared_pool(std::max(std::thread::hardware_concurrency(), 2u) - 1, "Shared Pool");
+  return s_shared_pool;
+}
+
+void ThreadPool::Submit(Task task, Priority priority, TaskGroup* group, const CancellationToken* token)
+{
+  if (group)
+    group->TaskAdded();
+
+  // tasks submitted from one of our workers go to its own queue, otherwise spread them around
+  const u32 index = (s_current_pool == this) ? s_current_worker :
+                                               (m_next_queue.fetch_add(1, std::memory_order_relaxed) % GetThreadCount());
+
+  // counted first, so the count never drops below the number of tasks a worker can find
+  m_queued_count.fetch_add(1, std::memory_order_release);
+
+  Worker& worker = *m_workers[index];
+  {
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    worker.queues[static_cast<u32>(priority)].push_back(
+      QueuedTask{std::move(task), group, token ? token->m_cancelled : nullptr});
+  }
+
+  // take the lock so the wakeup can't be lost between a worker's check and its wait
+  {
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+  }
+  m_wake_cv.notify_one();
+}
+
+bool ThreadPool::RunPendingTask()
+{
+  QueuedTask task;
+  if (!PopTask((s_current_pool == this) ? s_current_worker : 0, &task))
+    return false;
+
+  RunTask(task);
+  return true;
+}
+
+bool ThreadPool::PopTask(u32 home_index, QueuedTask* task, const TaskGroup* group)
+{
+  if (m_queued_count.load(std::memory_order_acquire) == 0)
+    return false;
+
+  const u32 num_workers = GetThreadCount();
+  for (u32 priority = 0; priority < static_cast<u32>(Priority::Count); priority++)
+  {
+    for (u32 i = 0; i < num_workers; i++)
+    {
+      Worker& worker = *m_workers[(home_index + i) % num_workers];
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      std::deque<QueuedTask>& queue = worker.queues[priority];
+      if (queue.empty())
+        continue;
+
+      // newest from our own queue, oldest when stealing
+      std::deque<QueuedTask>::iterator iter;
+      if (!group)
+      {
+        iter = (i == 0) ? (queue.end() - 1) : queue.begin();
+      }
+      else if (i == 0)
+      {
+        auto riter = std::find_if(queue.rbegin(), queue.rend(), [group](const QueuedTask& qt) {
+          return (qt.group == group);
+        });
+        if (riter == queue.rend())
+          continue;
+
+        iter = riter.base() - 1;
+      }
+      else
+      {
+        iter = std::find_if(queue.begin(), queue.end(), [group](const QueuedTask& qt) { return (qt.group == group); });
+        if (iter == queue.end())
+          continue;
+      }
+
+      *task = std::move(*iter);
+      queue.erase(iter);
+
+      m_queued_count.fetch_sub(1, std::memory_order_acq_rel);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void ThreadPool::RunTask(QueuedTask& task)
+{
+  if (!task.cancelled || !task.cancelled->load(std::memory_order_acquire))
+    task.task();
+
+  if (task.group)
+    task.group->TaskDone();
+
+  task = {};
+}
+
+void ThreadPool::WorkerThreadEntryPoint(u32 index, u64 affinity_mask)
+{
+  s_current_pool = this;
+  s_current_worker = index;
+
+  const std::string thread_name = m_name + " " + std::to_string(index);
+  SetNameOfCurrentThread(thread_name.c_str());
+
+  if (affinity_mask != 0 && !ThreadHandle::GetForCallingThread().SetAffinity(affinity_mask))
+    Log_WarningPrintf("Failed to set affinity for %s", thread_name.c_str());
+
+  QueuedTask task;
+  for (;;)
+  {
+    if (PopTask(index, &task))
+    {
+      RunTask(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_wake_mutex);
+    m_wake_cv.wait(lock, [this]() { return (m_shutdown || m_queued_count.load(std::memory_order_acquire) > 0); });
+    if (m_shutdown && m_queued_count.load(std::memory_order_acquire) == 0)
+      break;
+  }
+
+  s_current_pool = nullptr;
+}
+
+} // namespace Threading
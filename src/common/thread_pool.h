@@ -0,0 +1,123 @@
+#pragma once
+#include "threading.h"
+#include "types.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Threading {
+
+/// Shared flag which allows queued tasks to be abandoned before they start. Copies refer to the same flag.
+class CancellationToken
+{
+public:
+  CancellationToken() : m_cancelled(std::make_shared<std::atomic_bool>(false)) {}
+
+  ALWAYS_INLINE bool IsCancelled() const { return m_cancelled->load(std::memory_order_acquire); }
+  ALWAYS_INLINE void Cancel() const { m_cancelled->store(true, std::memory_order_release); }
+
+private:
+  friend class ThreadPool;
+
+  std::shared_ptr<std::atomic_bool> m_cancelled;
+};
+
+// --------------------------------------------------------------------------------------
+//  ThreadPool
+// --------------------------------------------------------------------------------------
+// Work-stealing task pool. Each worker owns a queue per priority, which it drains newest-first,
+// and steals oldest-first from the other workers when its own queues are empty. Higher priority
+// tasks are always picked before lower priority tasks anywhere in the pool.
+//
+class ThreadPool
+{
+public:
+  enum class Priority : u8
+  {
+    High,
+    Normal,
+    Low,
+    Count
+  };
+
+  using Task = std::function<void()>;
+
+  /// Tracks completion of a set of tasks. Must outlive the tasks submitted with it.
+  class TaskGroup
+  {
+  public:
+    TaskGroup();
+    ~TaskGroup();
+
+    ALWAYS_INLINE bool IsDone() const { return (m_pending.load(std::memory_order_acquire) == 0); }
+
+    /// Waits for all tasks in the group to finish, running the group's queued tasks on the calling thread in the
+    /// meantime. Tasks from other groups are left to the workers, so the caller isn't held up by unrelated work.
+    void Wait(ThreadPool& pool);
+
+  private:
+    friend ThreadPool;
+
+    void TaskAdded();
+    void TaskDone();
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::atomic<u32> m_pending{0};
+  };
+
+  /// Creates a pool with the specified number of workers. If affinity_mask is non-zero, workers are
+  /// restricted to those processors, e.g. to keep background work off the cores the emulator runs on.
+  ThreadPool(u32 num_threads, const char* name, u64 affinity_mask = 0);
+  ~ThreadPool();
+
+  /// Returns the pool shared by the whole application, with one worker per processor minus one.
+  static ThreadPool& GetShared();
+
+  ALWAYS_INLINE u32 GetThreadCount() const { return static_cast<u32>(m_workers.size()); }
+
+  /// Queues a task. If a group is given, it is notified when the task completes or is skipped.
+  /// Tasks whose token has been cancelled by the time they are dequeued are skipped.
+  void Submit(Task task, Priority priority = Priority::Normal, TaskGroup* group = nullptr,
+              const CancellationToken* token = nullptr);
+
+  /// Runs a single queued task on the calling thread, if there is one.
+  bool RunPendingTask();
+
+private:
+  struct QueuedTask
+  {
+    Task task;
+    TaskGroup* group;
+    std::shared_ptr<std::atomic_bool> cancelled;
+  };
+
+  struct Worker
+  {
+    std::mutex mutex;
+    std::deque<QueuedTask> queues[static_cast<u32>(Priority::Count)];
+    Thread thread;
+  };
+
+  void WorkerThreadEntryPoint(u32 index, u64 affinity_mask);
+
+  /// Takes the next task to run, only considering tasks in group if it is not null.
+  bool PopTask(u32 home_index, QueuedTask* task, const TaskGroup* group = nullptr);
+  void RunTask(QueuedTask& task);
+
+  std::vector<std::unique_ptr<Worker>> m_workers;
+  std::string m_name;
+
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake_cv;
+  std::atomic<u32> m_queued_count{0};
+  std::atomic<u32> m_next_queue{0};
+  bool m_shutdown = false;
+};
+
+} // namespace Threading
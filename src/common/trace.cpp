@@ -0,0 +1,122 @@
+#include "trace.h"
+#include "file_system.h"
+#include "log.h"
+#include "fmt/format.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+Log_SetChannel(Trace);
+
+namespace Trace {
+
+namespace {
+struct Zone
+{
+  const char* name;
+  Common::Timer::Value start_time;
+  Common::Timer::Value end_time;
+};
+
+struct ThreadBuffer
+{
+  std::mutex mutex;
+  std::vector<Zone> zones;
+  u32 thread_index;
+};
+} // namespace
+
+// Stops a forgotten capture from eating all memory, roughly 100MB.
+static constexpr size_t MAX_ZONES_PER_THREAD = 4 * 1024 * 1024;
+
+std::atomic_bool g_capturing{false};
+
+static std::mutex s_buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_buffers;
+static Common::Timer::Value s_capture_start_time = 0;
+static thread_local ThreadBuffer* s_thread_buffer = nullptr;
+
+static std::mutex s_names_mutex;
+static std::unordered_set<std::string> s_names;
+
+} // namespace Trace
+
+void Trace::StartCapture()
+{
+  std::unique_lock lock(s_buffers_mutex);
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    std::unique_lock buffer_lock(buffer->mutex);
+    buffer->zones.clear();
+  }
+
+  s_capture_start_time = Common::Timer::GetCurrentValue();
+  g_capturing.store(true, std::memory_order_release);
+  Log_InfoPrint("Trace capture started.");
+}
+
+bool Trace::StopCapture(const char* filename)
+{
+  g_capturing.store(false, std::memory_order_release);
+
+  std::string json;
+  json.reserve(1024 * 1024);
+  json += "{\"traceEvents\":[\n";
+
+  size_t num_zones = 0;
+  std::unique_lock lock(s_buffers_mutex);
+  for (const std::unique_ptr<ThreadBuffer>& buffer : s_buffers)
+  {
+    std::unique_lock buffer_lock(buffer->mutex);
+    for (const Zone& zone : buffer->zones)
+    {
+      // zones which started before the capture are clamped to its start
+      const Common::Timer::Value start_time = std::max(zone.start_time, s_capture_start_time);
+      fmt::format_to(std::back_inserter(json),
+                     "{}{{\"name\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                     (num_zones > 0) ? ",\n" : "", zone.name,
+                     Common::Timer::ConvertValueToNanoseconds(start_time - s_capture_start_time) / 1000.0,
+                     Common::Timer::ConvertValueToNanoseconds(zone.end_time - start_time) / 1000.0,
+                     buffer->thread_index);
+      num_zones++;
+    }
+
+    buffer->zones.clear();
+    buffer->zones.shrink_to_fit();
+  }
+
+  json += "\n]}\n";
+
+  if (!FileSystem::WriteStringToFile(filename, json))
+  {
+    Log_ErrorPrintf("Failed to write trace to '%s'", filename);
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote %zu trace zones to '%s'.", num_zones, filename);
+  return true;
+}
+
+void Trace::AddZone(const char* name, Common::Timer::Value start_time, Common::Timer::Value end_time)
+{
+  ThreadBuffer* buffer = s_thread_buffer;
+  if (!buffer)
+  {
+    // buffers are never freed, so threads which exit mid-capture still have their zones written
+    std::unique_lock lock(s_buffers_mutex);
+    buffer = s_buffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+    buffer->thread_index = static_cast<u32>(s_buffers.size());
+    s_thread_buffer = buffer;
+  }
+
+  std::unique_lock lock(buffer->mutex);
+  if (buffer->zones.size() < MAX_ZONES_PER_THREAD)
+    buffer->zones.push_back(Zone{name, start_time, end_time});
+}
+
+const char* Trace::InternName(const std::string_view& name)
+{
+  std::unique_lock lock(s_names_mutex);
+  return s_names.emplace(name).first->c_str();
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "timer.h"
+#include "types.h"
+#include <atomic>
+#include <string_view>
+
+/// Scoped-zone tracing, written out in the Chrome trace event format (chrome://tracing, ui.perfetto.dev).
+/// While no capture is running, a zone costs a single relaxed load and branch.
+namespace Trace {
+
+extern std::atomic_bool g_capturing;
+
+ALWAYS_INLINE bool IsCapturing()
+{
+  return g_capturing.load(std::memory_order_relaxed);
+}
+
+/// Discards any previously captured zones, and begins capturing.
+void StartCapture();
+
+/// Stops capturing, and writes the zones to the specified file.
+bool StopCapture(const char* filename);
+
+/// Records a completed zone on the calling thread. The name must outlive the capture.
+void AddZone(const char* name, Common::Timer::Value start_time, Common::Timer::Value end_time);
+
+/// Returns a pointer to a copy of name which lives until the process exits, for zones with dynamic names.
+const char* InternName(const std::string_view& name);
+
+class ScopedZone
+{
+public:
+  ALWAYS_INLINE ScopedZone(const char* name)
+    : m_name(name), m_start_time(IsCapturing() ? Common::Timer::GetCurrentValue() : 0)
+  {
+  }
+
+  ALWAYS_INLINE ~ScopedZone()
+  {
+    if (m_start_time != 0)
+      AddZone(m_name, m_start_time, Common::Timer::GetCurrentValue());
+  }
+
+  ScopedZone(const ScopedZone&) = delete;
+  ScopedZone& operator=(const ScopedZone&) = delete;
+
+private:
+  const char* m_name;
+  Common::Timer::Value m_start_time;
+};
+
+} // namespace Trace
+
+#define TRACE_ZONE_CONCAT2(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT2(a, b)
+#define TRACE_SCOPE(name) const Trace::ScopedZone TRACE_ZONE_CONCAT(trace_zone_, __LINE__)(name)
@@ -111,6 +111,7 @@ void GraphicsPipelineBuilder::Clear()
   m_ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 
   m_shader_stages = {};
+  m_specialization_info = {};
 
   m_vertex_input_state = {};
   m_vertex_input_state.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
@@ -142,6 +143,10 @@ void GraphicsPipelineBuilder::Clear()
   m_multisample_state = {};
   m_multisample_state.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
 
+  m_library_info = {};
+  m_link_info = {};
+  m_libraries = {};
+
   // set defaults
   SetNoCullRasterizationState();
   SetNoDepthTestState();
@@ -194,6 +199,21 @@ void GraphicsPipelineBuilder::SetShaderStage(VkShaderStageFlagBits stage, VkShad
   s.pName = entry_point;
 }
 
+void GraphicsPipelineBuilder::SetSpecializationInfo(VkShaderStageFlagBits stage, const VkSpecializationInfo& info)
+{
+  for (u32 index = 0; index < m_ci.stageCount; index++)
+  {
+    if (m_shader_stages[index].stage == stage)
+    {
+      m_specialization_info[index] = info;
+      m_shader_stages[index].pSpecializationInfo = &m_specialization_info[index];
+      return;
+    }
+  }
+
+  Panic("Shader stage not set");
+}
+
 void GraphicsPipelineBuilder::AddVertexBuffer(u32 binding, u32 stride,
                                               VkVertexInputRate input_rate /*= VK_VERTEX_INPUT_RATE_VERTEX*/)
 {
@@ -402,6 +422,72 @@ void GraphicsPipelineBuilder::SetRenderPass(VkRenderPass render_pass, u32 subpas
   m_ci.subpass = subpass;
 }
 
+void GraphicsPipelineBuilder::SetLibraryFlags(VkGraphicsPipelineLibraryFlagsEXT flags)
+{
+  if (m_library_info.sType != VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT)
+  {
+    m_library_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+    Util::AddPointerToChain(&m_ci, &m_library_info);
+  }
+
+  m_library_info.flags = flags;
+  m_ci.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+}
+
+void GraphicsPipelineBuilder::AddLibrary(VkPipeline library)
+{
+  Assert(m_link_info.libraryCount < MAX_LIBRARIES);
+
+  if (m_link_info.sType != VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR)
+  {
+    m_link_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    m_link_info.pLibraries = m_libraries.data();
+    Util::AddPointerToChain(&m_ci, &m_link_info);
+  }
+
+  m_libraries[m_link_info.libraryCount++] = library;
+}
+
+ComputePipelineBuilder::ComputePipelineBuilder()
+{
+  Clear();
+}
+
+void ComputePipelineBuilder::Clear()
+{
+  m_ci = {};
+  m_ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+  m_ci.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+  m_ci.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+}
+
+VkPipeline ComputePipelineBuilder::Create(VkDevice device, VkPipelineCache pipeline_cache, bool clear /* = true */)
+{
+  VkPipeline pipeline;
+  VkResult res = vkCreateComputePipelines(device, pipeline_cache, 1, &m_ci, nullptr, &pipeline);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateComputePipelines() failed: ");
+    return VK_NULL_HANDLE;
+  }
+
+  if (clear)
+    Clear();
+
+  return pipeline;
+}
+
+void ComputePipelineBuilder::SetShader(VkShaderModule module, const char* entry_point /* = "main" */)
+{
+  m_ci.stage.module = module;
+  m_ci.stage.pName = entry_point;
+}
+
+void ComputePipelineBuilder::SetPipelineLayout(VkPipelineLayout layout)
+{
+  m_ci.layout = layout;
+}
+
 SamplerBuilder::SamplerBuilder()
 {
   Clear();
@@ -546,6 +632,25 @@ void DescriptorSetUpdateBuilder::AddCombinedImageSamplerDescriptorWrite(
   dw.pImageInfo = &ii;
 }
 
+void DescriptorSetUpdateBuilder::AddStorageImageDescriptorWrite(VkDescriptorSet set, u32 binding, VkImageView view,
+                                                                VkImageLayout layout /*= VK_IMAGE_LAYOUT_GENERAL*/)
+{
+  Assert(m_num_writes < MAX_WRITES && m_num_infos < MAX_INFOS);
+
+  VkDescriptorImageInfo& ii = m_infos[m_num_infos++].image;
+  ii.imageView = view;
+  ii.imageLayout = layout;
+  ii.sampler = VK_NULL_HANDLE;
+
+  VkWriteDescriptorSet& dw = m_writes[m_num_writes++];
+  dw.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+  dw.dstSet = set;
+  dw.dstBinding = binding;
+  dw.descriptorCount = 1;
+  dw.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+  dw.pImageInfo = &ii;
+}
+
 void DescriptorSetUpdateBuilder::AddBufferDescriptorWrite(VkDescriptorSet set, u32 binding, VkDescriptorType dtype,
                                                           VkBuffer buffer, u32 offset, u32 size)
 {
@@ -60,7 +60,8 @@ public:
     MAX_VERTEX_ATTRIBUTES = 16,
     MAX_VERTEX_BUFFERS = 8,
     MAX_ATTACHMENTS = 2,
-    MAX_DYNAMIC_STATE = 8
+    MAX_DYNAMIC_STATE = 8,
+    MAX_LIBRARIES = 4
   };
 
   GraphicsPipelineBuilder();
@@ -74,6 +75,9 @@ public:
   void SetGeometryShader(VkShaderModule module) { SetShaderStage(VK_SHADER_STAGE_GEOMETRY_BIT, module, "main"); }
   void SetFragmentShader(VkShaderModule module) { SetShaderStage(VK_SHADER_STAGE_FRAGMENT_BIT, module, "main"); }
 
+  /// Specializes a stage which has already been set. The map entries and data must stay valid until Create().
+  void SetSpecializationInfo(VkShaderStageFlagBits stage, const VkSpecializationInfo& info);
+
   void AddVertexBuffer(u32 binding, u32 stride, VkVertexInputRate input_rate = VK_VERTEX_INPUT_RATE_VERTEX);
   void AddVertexAttribute(u32 location, u32 binding, VkFormat format, u32 offset);
 
@@ -112,9 +116,16 @@ public:
   void SetPipelineLayout(VkPipelineLayout layout);
   void SetRenderPass(VkRenderPass render_pass, u32 subpass);
 
+  /// Creates a pipeline library holding only the given state subsets, requires VK_EXT_graphics_pipeline_library.
+  void SetLibraryFlags(VkGraphicsPipelineLibraryFlagsEXT flags);
+
+  /// Links a pipeline library into the pipeline. The state it holds doesn't need to be set on the builder.
+  void AddLibrary(VkPipeline library);
+
 private:
   VkGraphicsPipelineCreateInfo m_ci;
   std::array<VkPipelineShaderStageCreateInfo, MAX_SHADER_STAGES> m_shader_stages;
+  std::array<VkSpecializationInfo, MAX_SHADER_STAGES> m_specialization_info;
 
   VkPipelineVertexInputStateCreateInfo m_vertex_input_state;
   std::array<VkVertexInputBindingDescription, MAX_VERTEX_BUFFERS> m_vertex_buffers;
@@ -136,6 +147,26 @@ private:
   std::array<VkDynamicState, MAX_DYNAMIC_STATE> m_dynamic_state_values;
 
   VkPipelineMultisampleStateCreateInfo m_multisample_state;
+
+  VkGraphicsPipelineLibraryCreateInfoEXT m_library_info;
+  VkPipelineLibraryCreateInfoKHR m_link_info;
+  std::array<VkPipeline, MAX_LIBRARIES> m_libraries;
+};
+
+class ComputePipelineBuilder
+{
+public:
+  ComputePipelineBuilder();
+
+  void Clear();
+
+  VkPipeline Create(VkDevice device, VkPipelineCache pipeline_cache = VK_NULL_HANDLE, bool clear = true);
+
+  void SetShader(VkShaderModule module, const char* entry_point = "main");
+  void SetPipelineLayout(VkPipelineLayout layout);
+
+private:
+  VkComputePipelineCreateInfo m_ci;
 };
 
 class SamplerBuilder
@@ -178,6 +209,8 @@ public:
   void AddSamplerDescriptorWrite(VkDescriptorSet set, u32 binding, VkSampler sampler);
   void AddCombinedImageSamplerDescriptorWrite(VkDescriptorSet set, u32 binding, VkImageView view, VkSampler sampler,
                                               VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  void AddStorageImageDescriptorWrite(VkDescriptorSet set, u32 binding, VkImageView view,
+                                      VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
   void AddBufferDescriptorWrite(VkDescriptorSet set, u32 binding, VkDescriptorType dtype, VkBuffer buffer, u32 offset,
                                 u32 size);
   void AddBufferViewDescriptorWrite(VkDescriptorSet set, u32 binding, VkDescriptorType dtype, VkBufferView view);
@@ -2,7 +2,9 @@
 #include "../assert.h"
 #include "../log.h"
 #include "../string_util.h"
+#include "../thread_placement.h"
 #include "../window_info.h"
+#include "builders.h"
 #include "swap_chain.h"
 #include "util.h"
 #include <algorithm>
@@ -269,7 +271,7 @@ Vulkan::Context::GPUNameList Vulkan::Context::EnumerateGPUNames(VkInstance insta
 
 bool Vulkan::Context::Create(std::string_view gpu_name, const WindowInfo* wi,
                              std::unique_ptr<SwapChain>* out_swap_chain, bool threaded_presentation,
-                             bool enable_debug_utils, bool enable_validation_layer)
+                             u32 frames_in_flight, bool enable_debug_utils, bool enable_validation_layer)
 {
   AssertMsg(!g_vulkan_context, "Has no current context");
 
@@ -340,6 +342,7 @@ bool Vulkan::Context::Create(std::string_view gpu_name, const WindowInfo* wi,
   }
 
   g_vulkan_context.reset(new Context(instance, gpus[gpu_index], true));
+  g_vulkan_context->m_num_command_buffers = std::clamp<u32>(frames_in_flight, MIN_COMMAND_BUFFERS, MAX_COMMAND_BUFFERS);
 
   // Enable debug reports if the "Host GPU" log category is enabled.
   if (enable_debug_utils)
@@ -471,6 +474,12 @@ bool Vulkan::Context::SelectDeviceExtensions(ExtensionList* extension_list, bool
 
   m_optional_extensions.vk_ext_memory_budget = SupportsExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, false);
   m_optional_extensions.vk_khr_driver_properties = SupportsExtension(VK_KHR_DRIVER_PROPERTIES_EXTENSION_NAME, false);
+  m_optional_extensions.vk_khr_timeline_semaphore =
+    SupportsExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME, false);
+  m_optional_extensions.vk_ext_graphics_pipeline_library =
+    SupportsExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME, false) &&
+    SupportsExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME, false);
+  m_optional_extensions.vk_khr_push_descriptor = SupportsExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME, false);
 
   return true;
 }
@@ -606,6 +615,35 @@ bool Vulkan::Context::CreateDevice(VkSurfaceKHR surface, bool enable_validation_
 
   device_info.pEnabledFeatures = &m_device_features;
 
+  // Timeline semaphores also need the feature bit enabled, not just the extension.
+  VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timeline_semaphore_features = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR};
+  if (m_optional_extensions.vk_khr_timeline_semaphore)
+  {
+    VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    Util::AddPointerToChain(&features2, &timeline_semaphore_features);
+    vkGetPhysicalDeviceFeatures2(m_physical_device, &features2);
+
+    m_optional_extensions.vk_khr_timeline_semaphore = (timeline_semaphore_features.timelineSemaphore == VK_TRUE);
+    if (m_optional_extensions.vk_khr_timeline_semaphore)
+      Util::AddPointerToChain(&device_info, &timeline_semaphore_features);
+  }
+
+  // Same for graphics pipeline libraries.
+  VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_features = {
+    VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+  if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+  {
+    VkPhysicalDeviceFeatures2 features2 = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    Util::AddPointerToChain(&features2, &graphics_pipeline_library_features);
+    vkGetPhysicalDeviceFeatures2(m_physical_device, &features2);
+
+    m_optional_extensions.vk_ext_graphics_pipeline_library =
+      (graphics_pipeline_library_features.graphicsPipelineLibrary == VK_TRUE);
+    if (m_optional_extensions.vk_ext_graphics_pipeline_library)
+      Util::AddPointerToChain(&device_info, &graphics_pipeline_library_features);
+  }
+
   // Enable debug layer on debug builds
   if (enable_validation_layer)
   {
@@ -654,6 +692,18 @@ void Vulkan::Context::ProcessDeviceExtensions()
 
   // query
   vkGetPhysicalDeviceProperties2(m_physical_device, &properties2);
+
+  // don't use timeline semaphores if the loader didn't give us the entry points
+  m_optional_extensions.vk_khr_timeline_semaphore &=
+    (vkGetSemaphoreCounterValueKHR != nullptr && vkWaitSemaphoresKHR != nullptr);
+  m_optional_extensions.vk_khr_push_descriptor &= (vkCmdPushDescriptorSetKHR != nullptr);
+
+  Log_InfoPrintf("VK_KHR_timeline_semaphore is %s",
+                 m_optional_extensions.vk_khr_timeline_semaphore ? "supported" : "NOT supported");
+  Log_InfoPrintf("VK_EXT_graphics_pipeline_library is %s",
+                 m_optional_extensions.vk_ext_graphics_pipeline_library ? "supported" : "NOT supported");
+  Log_InfoPrintf("VK_KHR_push_descriptor is %s",
+                 m_optional_extensions.vk_khr_push_descriptor ? "supported" : "NOT supported");
 }
 
 bool Vulkan::Context::CreateAllocator()
@@ -691,9 +741,15 @@ bool Vulkan::Context::CreateCommandBuffers()
 {
   VkResult res;
 
-  uint32_t frame_index = 0;
-  for (FrameResources& resources : m_frame_resources)
+  // Fall back to per-frame fences if the timeline semaphore can't be created.
+  if (m_optional_extensions.vk_khr_timeline_semaphore && !CreateTimelineSemaphore())
+    Log_WarningPrintf("Failed to create timeline semaphore, using fences instead.");
+
+  Log_InfoPrintf("Using %u frames in flight", m_num_command_buffers);
+
+  for (u32 frame_index = 0; frame_index < m_num_command_buffers; frame_index++)
   {
+    FrameResources& resources = m_frame_resources[frame_index];
     resources.needs_fence_wait = false;
 
     VkCommandPoolCreateInfo pool_info = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr, 0,
@@ -719,15 +775,19 @@ bool Vulkan::Context::CreateCommandBuffers()
     Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), resources.command_buffer, "Frame Command Buffer %u",
                                 frame_index);
 
-    VkFenceCreateInfo fence_info = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, VK_FENCE_CREATE_SIGNALED_BIT};
-
-    res = vkCreateFence(m_device, &fence_info, nullptr, &resources.fence);
-    if (res != VK_SUCCESS)
+    if (m_timeline_semaphore == VK_NULL_HANDLE)
     {
-      LOG_VULKAN_ERROR(res, "vkCreateFence failed: ");
-      return false;
+      VkFenceCreateInfo fence_info = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, VK_FENCE_CREATE_SIGNALED_BIT};
+
+      res = vkCreateFence(m_device, &fence_info, nullptr, &resources.fence);
+      if (res != VK_SUCCESS)
+      {
+        LOG_VULKAN_ERROR(res, "vkCreateFence failed: ");
+        return false;
+      }
+      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), resources.fence, "Frame Fence %u", frame_index);
     }
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), resources.fence, "Frame Fence %u", frame_index);
+
     // TODO: A better way to choose the number of descriptors.
     VkDescriptorPoolSize pool_sizes[] = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1024},
                                          {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1024},
@@ -749,14 +809,29 @@ bool Vulkan::Context::CreateCommandBuffers()
     }
     Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), resources.descriptor_pool, "Frame Descriptor Pool %u",
                                 frame_index);
-
-    ++frame_index;
   }
 
   ActivateCommandBuffer(0);
   return true;
 }
 
+bool Vulkan::Context::CreateTimelineSemaphore()
+{
+  const VkSemaphoreTypeCreateInfoKHR type_info = {VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR, nullptr,
+                                                  VK_SEMAPHORE_TYPE_TIMELINE_KHR, 0};
+  const VkSemaphoreCreateInfo semaphore_info = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, &type_info, 0};
+  VkResult res = vkCreateSemaphore(m_device, &semaphore_info, nullptr, &m_timeline_semaphore);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vkCreateSemaphore failed: ");
+    m_timeline_semaphore = VK_NULL_HANDLE;
+    return false;
+  }
+
+  Vulkan::Util::SetObjectName(m_device, m_timeline_semaphore, "Frame Timeline Semaphore");
+  return true;
+}
+
 void Vulkan::Context::DestroyCommandBuffers()
 {
   for (FrameResources& resources : m_frame_resources)
@@ -786,6 +861,12 @@ void Vulkan::Context::DestroyCommandBuffers()
       resources.command_pool = VK_NULL_HANDLE;
     }
   }
+
+  if (m_timeline_semaphore != VK_NULL_HANDLE)
+  {
+    vkDestroySemaphore(m_device, m_timeline_semaphore, nullptr);
+    m_timeline_semaphore = VK_NULL_HANDLE;
+  }
 }
 
 bool Vulkan::Context::CreateGlobalDescriptorPool()
@@ -794,7 +875,8 @@ bool Vulkan::Context::CreateGlobalDescriptorPool()
   VkDescriptorPoolSize pool_sizes[] = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1024},
                                        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1024},
                                        {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 16},
-                                       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16}};
+                                       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16},
+                                       {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16}};
 
   VkDescriptorPoolCreateInfo pool_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
                                                  nullptr,
@@ -813,8 +895,12 @@ bool Vulkan::Context::CreateGlobalDescriptorPool()
 
   if (m_gpu_timing_supported)
   {
-    const VkQueryPoolCreateInfo query_create_info = {
-      VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0, VK_QUERY_TYPE_TIMESTAMP, NUM_COMMAND_BUFFERS * 2, 0};
+    const VkQueryPoolCreateInfo query_create_info = {VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                                     nullptr,
+                                                     0,
+                                                     VK_QUERY_TYPE_TIMESTAMP,
+                                                     m_num_command_buffers * MAX_TIMESTAMPS_PER_COMMAND_BUFFER,
+                                                     0};
     res = vkCreateQueryPool(m_device, &query_create_info, nullptr, &m_timestamp_query_pool);
     if (res != VK_SUCCESS)
     {
@@ -872,6 +958,27 @@ VkDescriptorSet Vulkan::Context::AllocateDescriptorSet(VkDescriptorSetLayout set
   return descriptor_set;
 }
 
+VkDescriptorSet Vulkan::Context::GetImageSamplerDescriptorSet(VkDescriptorSetLayout set_layout, u32 binding,
+                                                              VkImageView view, VkSampler sampler,
+                                                              VkImageLayout layout)
+{
+  auto& cache = m_frame_resources[m_current_frame].image_sampler_descriptor_sets;
+  const auto key = std::make_tuple(set_layout, binding, view, sampler, layout);
+  auto iter = cache.find(key);
+  if (iter != cache.end())
+    return iter->second;
+
+  VkDescriptorSet ds = AllocateDescriptorSet(set_layout);
+  if (ds == VK_NULL_HANDLE)
+    return VK_NULL_HANDLE;
+
+  DescriptorSetUpdateBuilder dsupdate;
+  dsupdate.AddCombinedImageSamplerDescriptorWrite(ds, binding, view, sampler, layout);
+  dsupdate.Update(m_device);
+  cache.emplace(key, ds);
+  return ds;
+}
+
 VkDescriptorSet Vulkan::Context::AllocateGlobalDescriptorSet(VkDescriptorSetLayout set_layout)
 {
   VkDescriptorSetAllocateInfo allocate_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr,
@@ -896,13 +1003,13 @@ void Vulkan::Context::WaitForFenceCounter(u64 fence_counter)
     return;
 
   // Find the first command buffer which covers this counter value.
-  u32 index = (m_current_frame + 1) % NUM_COMMAND_BUFFERS;
+  u32 index = (m_current_frame + 1) % m_num_command_buffers;
   while (index != m_current_frame)
   {
     if (m_frame_resources[index].fence_counter >= fence_counter)
       break;
 
-    index = (index + 1) % NUM_COMMAND_BUFFERS;
+    index = (index + 1) % m_num_command_buffers;
   }
 
   Assert(index != m_current_frame);
@@ -928,17 +1035,63 @@ bool Vulkan::Context::SetEnableGPUTiming(bool enabled)
   return (enabled == m_gpu_timing_enabled);
 }
 
+void Vulkan::Context::SetGPUTimingSection(u32 section)
+{
+  DebugAssert(section < MAX_GPU_TIMING_SECTIONS);
+  if (m_gpu_timing_section == section)
+    return;
+
+  m_gpu_timing_section = section;
+
+  // keep one query free for the end-of-buffer timestamp
+  FrameResources& resources = m_frame_resources[m_current_frame];
+  if (!m_gpu_timing_enabled || !resources.timestamp_written ||
+      resources.num_timestamps >= (MAX_TIMESTAMPS_PER_COMMAND_BUFFER - 1))
+  {
+    return;
+  }
+
+  vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
+                      m_current_frame * MAX_TIMESTAMPS_PER_COMMAND_BUFFER + resources.num_timestamps);
+  resources.timestamp_sections[resources.num_timestamps] = static_cast<u8>(section);
+  resources.num_timestamps++;
+}
+
+void Vulkan::Context::GetAndResetAccumulatedGPUSectionTimes(float* times, u32 count)
+{
+  for (u32 i = 0; i < count; i++)
+    times[i] = (i < MAX_GPU_TIMING_SECTIONS) ? m_accumulated_gpu_section_times[i] : 0.0f;
+
+  m_accumulated_gpu_section_times.fill(0.0f);
+}
+
 void Vulkan::Context::WaitForCommandBufferCompletion(u32 index)
 {
   // Wait for this command buffer to be completed.
-  VkResult res = vkWaitForFences(m_device, 1, &m_frame_resources[index].fence, VK_TRUE, UINT64_MAX);
-  if (res != VK_SUCCESS)
-    LOG_VULKAN_ERROR(res, "vkWaitForFences failed: ");
+  const u64 now_completed_counter = m_frame_resources[index].fence_counter;
+  if (m_timeline_semaphore != VK_NULL_HANDLE)
+  {
+    const VkSemaphoreWaitInfoKHR wait_info = {
+      VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR, nullptr, 0, 1, &m_timeline_semaphore, &now_completed_counter};
+    VkResult res = vkWaitSemaphoresKHR(m_device, &wait_info, UINT64_MAX);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkWaitSemaphoresKHR failed: ");
+  }
+  else
+  {
+    VkResult res = vkWaitForFences(m_device, 1, &m_frame_resources[index].fence, VK_TRUE, UINT64_MAX);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkWaitForFences failed: ");
+  }
 
+  CleanupCompletedCommandBuffers(now_completed_counter);
+}
+
+void Vulkan::Context::CleanupCompletedCommandBuffers(u64 now_completed_counter)
+{
   // Clean up any resources for command buffers between the last known completed buffer and this
   // now-completed command buffer. If we use >2 buffers, this may be more than one buffer.
-  const u64 now_completed_counter = m_frame_resources[index].fence_counter;
-  u32 cleanup_index = (m_current_frame + 1) % NUM_COMMAND_BUFFERS;
+  u32 cleanup_index = (m_current_frame + 1) % m_num_command_buffers;
   while (cleanup_index != m_current_frame)
   {
     FrameResources& resources = m_frame_resources[cleanup_index];
@@ -952,10 +1105,10 @@ void Vulkan::Context::WaitForCommandBufferCompletion(u32 index)
       resources.cleanup_resources.clear();
     }
 
-    cleanup_index = (cleanup_index + 1) % NUM_COMMAND_BUFFERS;
+    cleanup_index = (cleanup_index + 1) % m_num_command_buffers;
   }
 
-  m_completed_fence_counter = now_completed_counter;
+  m_completed_fence_counter = std::max(m_completed_fence_counter, now_completed_counter);
 }
 
 void Vulkan::Context::SubmitCommandBuffer(VkSemaphore wait_semaphore /* = VK_NULL_HANDLE */,
@@ -969,7 +1122,8 @@ void Vulkan::Context::SubmitCommandBuffer(VkSemaphore wait_semaphore /* = VK_NUL
   if (m_gpu_timing_enabled && resources.timestamp_written)
   {
     vkCmdWriteTimestamp(m_current_command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        m_current_frame * 2 + 1);
+                        m_current_frame * MAX_TIMESTAMPS_PER_COMMAND_BUFFER + resources.num_timestamps);
+    resources.num_timestamps++;
   }
 
   // End the current command buffer.
@@ -1017,11 +1171,26 @@ void Vulkan::Context::DoSubmitCommandBuffer(u32 index, VkSemaphore wait_semaphor
     submit_info.waitSemaphoreCount = 1;
   }
 
+  // The timeline semaphore is signalled with the buffer's fence counter, the binary semaphore's value is ignored.
+  std::array<VkSemaphore, 2> signal_semaphores;
+  std::array<u64, 2> signal_values;
   if (signal_semaphore != VK_NULL_HANDLE)
   {
-    submit_info.signalSemaphoreCount = 1;
-    submit_info.pSignalSemaphores = &signal_semaphore;
+    signal_semaphores[submit_info.signalSemaphoreCount] = signal_semaphore;
+    signal_values[submit_info.signalSemaphoreCount++] = 0;
   }
+
+  VkTimelineSemaphoreSubmitInfoKHR timeline_info = {VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR};
+  if (m_timeline_semaphore != VK_NULL_HANDLE)
+  {
+    signal_semaphores[submit_info.signalSemaphoreCount] = m_timeline_semaphore;
+    signal_values[submit_info.signalSemaphoreCount++] = resources.fence_counter;
+    timeline_info.signalSemaphoreValueCount = submit_info.signalSemaphoreCount;
+    timeline_info.pSignalSemaphoreValues = signal_values.data();
+    submit_info.pNext = &timeline_info;
+  }
+
+  submit_info.pSignalSemaphores = signal_semaphores.data();
   const Vulkan::Util::DebugScope debugScope(m_graphics_queue, "Context::DoSubmitCommandBuffer: %u", index);
 
   VkResult res = vkQueueSubmit(m_graphics_queue, 1, &submit_info, resources.fence);
@@ -1076,6 +1245,8 @@ void Vulkan::Context::WaitForPresentComplete(std::unique_lock<std::mutex>& lock)
 
 void Vulkan::Context::PresentThread()
 {
+  Threading::ApplyThreadPlacement(Threading::ThreadClass::Presentation);
+
   std::unique_lock<std::mutex> lock(m_present_mutex);
   while (!m_present_thread_done.load())
   {
@@ -1117,7 +1288,7 @@ void Vulkan::Context::StopPresentThread()
 
 void Vulkan::Context::MoveToNextCommandBuffer()
 {
-  ActivateCommandBuffer((m_current_frame + 1) % NUM_COMMAND_BUFFERS);
+  ActivateCommandBuffer((m_current_frame + 1) % m_num_command_buffers);
 }
 
 void Vulkan::Context::ActivateCommandBuffer(u32 index)
@@ -1127,14 +1298,29 @@ void Vulkan::Context::ActivateCommandBuffer(u32 index)
   if (!m_present_done.load() && m_queued_present.command_buffer_index == index)
     WaitForPresentComplete();
 
+  // Release anything the GPU has already finished with, without blocking.
+  VkResult res;
+  if (m_timeline_semaphore != VK_NULL_HANDLE)
+  {
+    u64 completed_counter;
+    res = vkGetSemaphoreCounterValueKHR(m_device, m_timeline_semaphore, &completed_counter);
+    if (res == VK_SUCCESS && completed_counter > m_completed_fence_counter)
+      CleanupCompletedCommandBuffers(completed_counter);
+    else if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkGetSemaphoreCounterValueKHR failed: ");
+  }
+
   // Wait for the GPU to finish with all resources for this command buffer.
   if (resources.fence_counter > m_completed_fence_counter)
     WaitForCommandBufferCompletion(index);
 
   // Reset fence to unsignaled before starting.
-  VkResult res = vkResetFences(m_device, 1, &resources.fence);
-  if (res != VK_SUCCESS)
-    LOG_VULKAN_ERROR(res, "vkResetFences failed: ");
+  if (m_timeline_semaphore == VK_NULL_HANDLE)
+  {
+    res = vkResetFences(m_device, 1, &resources.fence);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vkResetFences failed: ");
+  }
 
   // Reset command pools to beginning since we can re-use the memory now
   res = vkResetCommandPool(m_device, resources.command_pool, 0);
@@ -1152,25 +1338,35 @@ void Vulkan::Context::ActivateCommandBuffer(u32 index)
   res = vkResetDescriptorPool(m_device, resources.descriptor_pool, 0);
   if (res != VK_SUCCESS)
     LOG_VULKAN_ERROR(res, "vkResetDescriptorPool failed: ");
+  resources.image_sampler_descriptor_sets.clear();
 
   if (m_gpu_timing_enabled)
   {
-    if (resources.timestamp_written)
+    if (resources.timestamp_written && resources.num_timestamps >= 2)
     {
-      std::array<u64, 2> timestamps;
-      res =
-        vkGetQueryPoolResults(m_device, m_timestamp_query_pool, index * 2, static_cast<u32>(timestamps.size()),
-                              sizeof(u64) * timestamps.size(), timestamps.data(), sizeof(u64), VK_QUERY_RESULT_64_BIT);
+      std::array<u64, MAX_TIMESTAMPS_PER_COMMAND_BUFFER> timestamps;
+      const u32 num_timestamps = resources.num_timestamps;
+      res = vkGetQueryPoolResults(m_device, m_timestamp_query_pool, index * MAX_TIMESTAMPS_PER_COMMAND_BUFFER,
+                                  num_timestamps, sizeof(u64) * num_timestamps, timestamps.data(), sizeof(u64),
+                                  VK_QUERY_RESULT_64_BIT);
       if (res == VK_SUCCESS)
       {
         // if we didn't write the timestamp at the start of the cmdbuffer (just enabled timing), the first TS will be
         // zero
         if (timestamps[0] > 0)
         {
-          const double ns_diff =
-            (timestamps[1] - timestamps[0]) * static_cast<double>(m_device_properties.limits.timestampPeriod);
+          const double period = static_cast<double>(m_device_properties.limits.timestampPeriod);
+          const double ns_diff = (timestamps[num_timestamps - 1] - timestamps[0]) * period;
           m_accumulated_gpu_time =
             static_cast<float>(static_cast<double>(m_accumulated_gpu_time) + (ns_diff / 1000000.0));
+
+          // each interval belongs to the section which was active when its starting timestamp was written
+          for (u32 i = 0; i < (num_timestamps - 1); i++)
+          {
+            const double section_ns_diff = (timestamps[i + 1] - timestamps[i]) * period;
+            float& section_time = m_accumulated_gpu_section_times[resources.timestamp_sections[i]];
+            section_time = static_cast<float>(static_cast<double>(section_time) + (section_ns_diff / 1000000.0));
+          }
         }
       }
       else
@@ -1179,13 +1375,16 @@ void Vulkan::Context::ActivateCommandBuffer(u32 index)
       }
     }
 
-    vkCmdResetQueryPool(resources.command_buffer, m_timestamp_query_pool, index * 2, 2);
+    vkCmdResetQueryPool(resources.command_buffer, m_timestamp_query_pool, index * MAX_TIMESTAMPS_PER_COMMAND_BUFFER,
+                        MAX_TIMESTAMPS_PER_COMMAND_BUFFER);
     vkCmdWriteTimestamp(resources.command_buffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, m_timestamp_query_pool,
-                        index * 2);
+                        index * MAX_TIMESTAMPS_PER_COMMAND_BUFFER);
   }
 
   resources.fence_counter = m_next_fence_counter++;
   resources.timestamp_written = m_gpu_timing_enabled;
+  resources.num_timestamps = m_gpu_timing_enabled ? 1 : 0;
+  resources.timestamp_sections[0] = static_cast<u8>(m_gpu_timing_section);
 
   m_current_frame = index;
   m_current_command_buffer = resources.command_buffer;
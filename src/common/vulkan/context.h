@@ -12,6 +12,7 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 struct WindowInfo;
@@ -25,13 +26,20 @@ class Context
 public:
   enum : u32
   {
-    NUM_COMMAND_BUFFERS = 3
+    MIN_COMMAND_BUFFERS = 2,
+    MAX_COMMAND_BUFFERS = 4,
+    DEFAULT_COMMAND_BUFFERS = 3,
+    MAX_TIMESTAMPS_PER_COMMAND_BUFFER = 64,
+    MAX_GPU_TIMING_SECTIONS = 16
   };
 
   struct OptionalExtensions
   {
     bool vk_ext_memory_budget : 1;
     bool vk_khr_driver_properties : 1;
+    bool vk_khr_timeline_semaphore : 1;
+    bool vk_ext_graphics_pipeline_library : 1;
+    bool vk_khr_push_descriptor : 1;
   };
 
   ~Context();
@@ -48,9 +56,11 @@ public:
   static GPUList EnumerateGPUs(VkInstance instance);
   static GPUNameList EnumerateGPUNames(VkInstance instance);
 
-  // Creates a new context and sets it up as global.
+  // Creates a new context and sets it up as global. frames_in_flight is the number of command buffers which can be
+  // queued to the GPU at once, clamped to [MIN_COMMAND_BUFFERS, MAX_COMMAND_BUFFERS].
   static bool Create(std::string_view gpu_name, const WindowInfo* wi, std::unique_ptr<SwapChain>* out_swap_chain,
-                     bool threaded_presentation, bool enable_debug_utils, bool enable_validation_layer);
+                     bool threaded_presentation, u32 frames_in_flight, bool enable_debug_utils,
+                     bool enable_validation_layer);
 
   // Creates a new context from a pre-existing instance.
   static bool CreateFromExistingInstance(VkInstance instance, VkPhysicalDevice gpu, VkSurfaceKHR surface,
@@ -95,7 +105,14 @@ public:
 
   // Support bits
   ALWAYS_INLINE bool SupportsGeometryShaders() const { return m_device_features.geometryShader == VK_TRUE; }
+  ALWAYS_INLINE bool SupportsTimelineSemaphores() const { return m_timeline_semaphore != VK_NULL_HANDLE; }
+  ALWAYS_INLINE u32 GetFramesInFlight() const { return m_num_command_buffers; }
   ALWAYS_INLINE bool SupportsDualSourceBlend() const { return m_device_features.dualSrcBlend == VK_TRUE; }
+  ALWAYS_INLINE bool SupportsGraphicsPipelineLibrary() const
+  {
+    return m_optional_extensions.vk_ext_graphics_pipeline_library;
+  }
+  ALWAYS_INLINE bool SupportsPushDescriptors() const { return m_optional_extensions.vk_khr_push_descriptor; }
 
   // Helpers for getting constants
   ALWAYS_INLINE u32 GetUniformBufferAlignment() const
@@ -141,16 +158,18 @@ public:
   /// Allocates a descriptor set from the pool reserved for the current frame.
   VkDescriptorSet AllocateDescriptorSet(VkDescriptorSetLayout set_layout);
 
+  /// Returns a set from the current frame's pool with a combined image sampler at binding. Sets are reused within the
+  /// frame, so asking again for the same layout, view and sampler doesn't allocate or update another one.
+  VkDescriptorSet GetImageSamplerDescriptorSet(VkDescriptorSetLayout set_layout, u32 binding, VkImageView view,
+                                               VkSampler sampler,
+                                               VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
   /// Allocates a descriptor set from the pool reserved for the current frame.
   VkDescriptorSet AllocateGlobalDescriptorSet(VkDescriptorSetLayout set_layout);
 
   /// Frees a descriptor set allocated from the global pool.
   void FreeGlobalDescriptorSet(VkDescriptorSet set);
 
-  // Gets the fence that will be signaled when the currently executing command buffer is
-  // queued and executed. Do not wait for this fence before the buffer is executed.
-  ALWAYS_INLINE VkFence GetCurrentCommandBufferFence() const { return m_frame_resources[m_current_frame].fence; }
-
   // Fence "counters" are used to track which commands have been completed by the GPU.
   // If the last completed fence counter is greater or equal to N, it means that the work
   // associated counter N has been completed by the GPU. The value of N to associate with
@@ -193,6 +212,11 @@ public:
   float GetAndResetAccumulatedGPUTime();
   bool SetEnableGPUTiming(bool enabled);
 
+  // GPU time can be broken down into caller-defined sections. Each section change writes a timestamp to the current
+  // command buffer, once the per-buffer limit is hit the remaining work is attributed to the last section.
+  void SetGPUTimingSection(u32 section);
+  void GetAndResetAccumulatedGPUSectionTimes(float* times, u32 count);
+
 private:
   Context(VkInstance instance, VkPhysicalDevice physical_device, bool owns_device);
 
@@ -214,8 +238,10 @@ private:
   bool CreateTextureStreamBuffer();
   void DestroyRenderPassCache();
 
+  bool CreateTimelineSemaphore();
   void ActivateCommandBuffer(u32 index);
   void WaitForCommandBufferCompletion(u32 index);
+  void CleanupCompletedCommandBuffers(u64 completed_counter);
 
   void DoSubmitCommandBuffer(u32 index, VkSemaphore wait_semaphore, VkSemaphore signal_semaphore);
   void DoPresent(VkSemaphore wait_semaphore, VkSwapchainKHR present_swap_chain, uint32_t present_image_index);
@@ -230,10 +256,16 @@ private:
     VkCommandPool command_pool = VK_NULL_HANDLE;
     VkCommandBuffer command_buffer = VK_NULL_HANDLE;
     VkDescriptorPool descriptor_pool = VK_NULL_HANDLE;
-    VkFence fence = VK_NULL_HANDLE;
+    VkFence fence = VK_NULL_HANDLE; // not used with timeline semaphores
     u64 fence_counter = 0;
     bool needs_fence_wait = false;
     bool timestamp_written = false;
+    u32 num_timestamps = 0;
+    std::array<u8, MAX_TIMESTAMPS_PER_COMMAND_BUFFER> timestamp_sections = {};
+
+    // Sets handed out by GetImageSamplerDescriptorSet(), valid until descriptor_pool is reset.
+    std::map<std::tuple<VkDescriptorSetLayout, u32, VkImageView, VkSampler, VkImageLayout>, VkDescriptorSet>
+      image_sampler_descriptor_sets;
 
     std::vector<std::function<void()>> cleanup_resources;
   };
@@ -254,14 +286,20 @@ private:
 
   VkQueryPool m_timestamp_query_pool = VK_NULL_HANDLE;
   float m_accumulated_gpu_time = 0.0f;
+  std::array<float, MAX_GPU_TIMING_SECTIONS> m_accumulated_gpu_section_times = {};
+  u32 m_gpu_timing_section = 0;
   bool m_gpu_timing_enabled = false;
   bool m_gpu_timing_supported = false;
 
-  std::array<FrameResources, NUM_COMMAND_BUFFERS> m_frame_resources;
+  std::array<FrameResources, MAX_COMMAND_BUFFERS> m_frame_resources;
+  u32 m_num_command_buffers = DEFAULT_COMMAND_BUFFERS;
   u64 m_next_fence_counter = 1;
   u64 m_completed_fence_counter = 0;
   u32 m_current_frame;
 
+  // When supported, each command buffer signals its fence counter on this semaphore instead of using a fence.
+  VkSemaphore m_timeline_semaphore = VK_NULL_HANDLE;
+
   StreamBuffer m_texture_upload_buffer;
 
   std::atomic_bool m_last_present_failed{false};
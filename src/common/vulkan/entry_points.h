@@ -212,6 +212,13 @@ extern "C" {
 #define vkBindBufferMemory2 ds_vkBindBufferMemory2
 #define vkBindImageMemory2 ds_vkBindImageMemory2
 
+// VK_KHR_timeline_semaphore
+#define vkGetSemaphoreCounterValueKHR ds_vkGetSemaphoreCounterValueKHR
+#define vkWaitSemaphoresKHR ds_vkWaitSemaphoresKHR
+
+// VK_KHR_push_descriptor
+#define vkCmdPushDescriptorSetKHR ds_vkCmdPushDescriptorSetKHR
+
 #ifdef SUPPORTS_VULKAN_EXCLUSIVE_FULLSCREEN
 #define vkAcquireFullScreenExclusiveModeEXT ds_vkAcquireFullScreenExclusiveModeEXT
 #define vkReleaseFullScreenExclusiveModeEXT ds_vkReleaseFullScreenExclusiveModeEXT
@@ -1,11 +1,14 @@
 #include "shader_cache.h"
 #include "../assert.h"
+#include "../byte_stream.h"
 #include "../file_system.h"
 #include "../log.h"
 #include "../md5_digest.h"
+#include "../timer.h"
 #include "context.h"
 #include "shader_compiler.h"
 #include "util.h"
+#include <algorithm>
 Log_SetChannel(Vulkan::ShaderCache);
 
 // TODO: store the driver version and stuff in the shader header
@@ -17,6 +20,9 @@ namespace Vulkan {
 using ShaderCompiler::SPIRVCodeType;
 using ShaderCompiler::SPIRVCodeVector;
 
+// Blobs are zstd compressed, SPIR-V shrinks to around a quarter of its size.
+static constexpr int BLOB_COMPRESSION_LEVEL = 3;
+
 #pragma pack(push, 4)
 struct VK_PIPELINE_CACHE_HEADER
 {
@@ -35,6 +41,7 @@ struct CacheIndexEntry
   u32 shader_type;
   u32 file_offset;
   u32 blob_size;
+  u32 uncompressed_size;
 };
 #pragma pack(pop)
 
@@ -241,7 +248,8 @@ bool ShaderCache::ReadExistingShaderCache(const std::string& index_filename, con
   {
     CacheIndexEntry entry;
     if (std::fread(&entry, sizeof(entry), 1, m_index_file) != 1 ||
-        (entry.file_offset + entry.blob_size) > blob_file_size)
+        (entry.file_offset + entry.blob_size) > blob_file_size ||
+        (entry.uncompressed_size % sizeof(SPIRVCodeType)) != 0)
     {
       if (std::feof(m_index_file))
         break;
@@ -257,7 +265,7 @@ bool ShaderCache::ReadExistingShaderCache(const std::string& index_filename, con
 
     const CacheIndexKey key{entry.source_hash_low, entry.source_hash_high, entry.source_length,
                             static_cast<ShaderCompiler::Type>(entry.shader_type)};
-    const CacheIndexData data{entry.file_offset, entry.blob_size};
+    const CacheIndexData data{entry.file_offset, entry.blob_size, entry.uncompressed_size};
     m_index.emplace(key, data);
   }
 
@@ -430,18 +438,34 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::GetShaderSPV(ShaderC
                                                                          std::string_view shader_code)
 {
   const auto key = GetCacheKey(type, shader_code);
+  std::unique_lock lock(m_mutex);
   auto iter = m_index.find(key);
   if (iter == m_index.end())
+  {
+    lock.unlock();
     return CompileAndAddShaderSPV(key, shader_code);
+  }
 
-  SPIRVCodeVector spv(iter->second.blob_size);
-  if (std::fseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-      std::fread(spv.data(), sizeof(SPIRVCodeType), iter->second.blob_size, m_blob_file) != iter->second.blob_size)
+  const CacheIndexData data = iter->second;
+  std::vector<u8> compressed(data.blob_size);
+  if (std::fseek(m_blob_file, data.file_offset, SEEK_SET) != 0 ||
+      std::fread(compressed.data(), 1, data.blob_size, m_blob_file) != data.blob_size)
   {
+    lock.unlock();
     Log_ErrorPrintf("Read blob from file failed, recompiling");
     return ShaderCompiler::CompileShader(type, shader_code, m_debug);
   }
 
+  // decompress outside the lock, so other threads can read their blobs in the meantime
+  lock.unlock();
+
+  SPIRVCodeVector spv(data.uncompressed_size / sizeof(SPIRVCodeType));
+  if (!ByteStream::DecompressZstd(compressed.data(), data.blob_size, spv.data(), data.uncompressed_size))
+  {
+    Log_ErrorPrintf("Decompress blob failed, recompiling");
+    return ShaderCompiler::CompileShader(type, shader_code, m_debug);
+  }
+
   return spv;
 }
 
@@ -485,6 +509,41 @@ VkShaderModule ShaderCache::GetComputeShader(std::string_view shader_code)
   return GetShaderModule(ShaderCompiler::Type::Compute, std::move(shader_code));
 }
 
+void ShaderCache::PrecompileShaders(const ShaderCompiler::ShaderSourceList& shaders)
+{
+  ShaderCompiler::ShaderSourceList misses;
+  std::vector<CacheIndexKey> miss_keys;
+  {
+    std::unique_lock lock(m_mutex);
+    for (const auto& [type, source] : shaders)
+    {
+      const CacheIndexKey key = GetCacheKey(type, source);
+      if (m_index.find(key) != m_index.end() ||
+          std::find(miss_keys.begin(), miss_keys.end(), key) != miss_keys.end())
+      {
+        continue;
+      }
+
+      misses.emplace_back(type, source);
+      miss_keys.push_back(key);
+    }
+  }
+
+  if (misses.empty())
+    return;
+
+  Common::Timer timer;
+  std::vector<std::optional<SPIRVCodeVector>> results = ShaderCompiler::CompileShaders(misses, m_debug);
+  for (size_t i = 0; i < results.size(); i++)
+  {
+    // failures are reported again when the shader is requested
+    if (results[i].has_value())
+      AddShaderSPV(miss_keys[i], results[i].value());
+  }
+
+  Log_InfoPrintf("Precompiled %zu shaders in %.2f ms", misses.size(), timer.GetTimeMilliseconds());
+}
+
 std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::CompileAndAddShaderSPV(const CacheIndexKey& key,
                                                                                    std::string_view shader_code)
 {
@@ -492,12 +551,26 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::CompileAndAddShaderS
   if (!spv.has_value())
     return {};
 
-  if (!m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0)
-    return spv;
+  AddShaderSPV(key, spv.value());
+  return spv;
+}
+
+void ShaderCache::AddShaderSPV(const CacheIndexKey& key, const SPIRVCodeVector& spv)
+{
+  const u32 spv_size = static_cast<u32>(spv.size() * sizeof(SPIRVCodeType));
+  std::vector<u8> compressed;
+  if (!ByteStream::CompressZstd(spv.data(), spv_size, BLOB_COMPRESSION_LEVEL, &compressed))
+    return;
+
+  // Another thread may have compiled the same shader in the meantime.
+  std::unique_lock lock(m_mutex);
+  if (m_index.find(key) != m_index.end() || !m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0)
+    return;
 
   CacheIndexData data;
   data.file_offset = static_cast<u32>(std::ftell(m_blob_file));
-  data.blob_size = static_cast<u32>(spv->size());
+  data.blob_size = static_cast<u32>(compressed.size());
+  data.uncompressed_size = spv_size;
 
   CacheIndexEntry entry = {};
   entry.source_hash_low = key.source_hash_low;
@@ -506,17 +579,17 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::CompileAndAddShaderS
   entry.shader_type = static_cast<u32>(key.shader_type);
   entry.blob_size = data.blob_size;
   entry.file_offset = data.file_offset;
+  entry.uncompressed_size = data.uncompressed_size;
 
-  if (std::fwrite(spv->data(), sizeof(SPIRVCodeType), entry.blob_size, m_blob_file) != entry.blob_size ||
+  if (std::fwrite(compressed.data(), 1, entry.blob_size, m_blob_file) != entry.blob_size ||
       std::fflush(m_blob_file) != 0 || std::fwrite(&entry, sizeof(entry), 1, m_index_file) != 1 ||
       std::fflush(m_index_file) != 0)
   {
     Log_ErrorPrintf("Failed to write shader blob to file");
-    return spv;
+    return;
   }
 
   m_index.emplace(key, data);
-  return spv;
 }
 
 } // namespace Vulkan
\ No newline at end of file
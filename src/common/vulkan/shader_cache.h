@@ -5,6 +5,7 @@
 #include "shader_compiler.h"
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -27,6 +28,7 @@ public:
   /// Writes pipeline cache to file, saving all newly compiled pipelines.
   bool FlushPipelineCache();
 
+  /// Shaders can be requested from multiple threads at once.
   std::optional<ShaderCompiler::SPIRVCodeVector> GetShaderSPV(ShaderCompiler::Type type, std::string_view shader_code);
   VkShaderModule GetShaderModule(ShaderCompiler::Type type, std::string_view shader_code);
 
@@ -35,8 +37,11 @@ public:
   VkShaderModule GetFragmentShader(std::string_view shader_code);
   VkShaderModule GetComputeShader(std::string_view shader_code);
 
+  /// Compiles any of the shaders which aren't already in the cache in parallel, so later lookups are hits.
+  void PrecompileShaders(const ShaderCompiler::ShaderSourceList& shaders);
+
 private:
-  static constexpr u32 FILE_VERSION = 2;
+  static constexpr u32 FILE_VERSION = 3;
 
   struct CacheIndexKey
   {
@@ -63,6 +68,7 @@ private:
   {
     u32 file_offset;
     u32 blob_size;
+    u32 uncompressed_size;
   };
 
   using CacheIndex = std::unordered_map<CacheIndexKey, CacheIndexData, CacheIndexEntryHasher>;
@@ -85,12 +91,14 @@ private:
 
   std::optional<ShaderCompiler::SPIRVCodeVector> CompileAndAddShaderSPV(const CacheIndexKey& key,
                                                                         std::string_view shader_code);
+  void AddShaderSPV(const CacheIndexKey& key, const ShaderCompiler::SPIRVCodeVector& spv);
 
   std::FILE* m_index_file = nullptr;
   std::FILE* m_blob_file = nullptr;
   std::string m_pipeline_cache_filename;
 
   CacheIndex m_index;
+  std::mutex m_mutex;
 
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
   u32 m_version = 0;
@@ -2,10 +2,13 @@
 #include "../assert.h"
 #include "../log.h"
 #include "../string_util.h"
+#include "../thread_pool.h"
 #include "util.h"
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <mutex>
 Log_SetChannel(Vulkan::ShaderCompiler);
 
 // glslang includes
@@ -17,8 +20,9 @@ namespace Vulkan::ShaderCompiler {
 // Registers itself for cleanup via atexit
 bool InitializeGlslang();
 
-static unsigned s_next_bad_shader_id = 1;
+static std::atomic<unsigned> s_next_bad_shader_id{1};
 
+static std::mutex glslang_init_mutex;
 static bool glslang_initialized = false;
 
 static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, const char* stage_filename,
@@ -110,6 +114,7 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, cons
 
 bool InitializeGlslang()
 {
+  std::unique_lock lock(glslang_init_mutex);
   if (glslang_initialized)
     return true;
 
@@ -127,6 +132,7 @@ bool InitializeGlslang()
 
 void DeinitializeGlslang()
 {
+  std::unique_lock lock(glslang_init_mutex);
   if (!glslang_initialized)
     return;
 
@@ -175,4 +181,29 @@ std::optional<ShaderCompiler::SPIRVCodeVector> CompileShader(Type type, std::str
   }
 }
 
+std::vector<std::optional<SPIRVCodeVector>> CompileShaders(const ShaderSourceList& sources, bool debug)
+{
+  std::vector<std::optional<SPIRVCodeVector>> results(sources.size());
+  if (sources.size() <= 1)
+  {
+    if (!sources.empty())
+      results[0] = CompileShader(sources[0].first, sources[0].second, debug);
+
+    return results;
+  }
+
+  // glslang keeps its state per-thread, so each shader can be compiled independently.
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  Threading::ThreadPool::TaskGroup group;
+  for (size_t i = 0; i < sources.size(); i++)
+  {
+    pool.Submit(
+      [&sources, &results, i, debug]() { results[i] = CompileShader(sources[i].first, sources[i].second, debug); },
+      Threading::ThreadPool::Priority::High, &group);
+  }
+
+  group.Wait(pool);
+  return results;
+}
+
 } // namespace Vulkan::ShaderCompiler
@@ -2,7 +2,9 @@
 
 #include "../types.h"
 #include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace Vulkan::ShaderCompiler {
@@ -36,4 +38,8 @@ std::optional<SPIRVCodeVector> CompileComputeShader(std::string_view source_code
 
 std::optional<SPIRVCodeVector> CompileShader(Type type, std::string_view source_code, bool debug);
 
+// Compiles several shaders at once, spread across the shared thread pool. Results are in the same order as the sources.
+using ShaderSourceList = std::vector<std::pair<Type, std::string>>;
+std::vector<std::optional<SPIRVCodeVector>> CompileShaders(const ShaderSourceList& sources, bool debug);
+
 } // namespace Vulkan::ShaderCompiler
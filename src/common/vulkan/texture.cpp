@@ -309,7 +309,13 @@ void Vulkan::Texture::TransitionSubresourcesToLayout(VkCommandBuffer command_buf
     case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
       // Image was being used as a shader resource, make sure all reads have finished.
       barrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
-      srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+      srcStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+      break;
+
+    case VK_IMAGE_LAYOUT_GENERAL:
+      // Image was being used as a storage image or for a self-copy, ensure all writes have finished.
+      barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+      srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
       break;
 
     case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
@@ -349,7 +355,13 @@ void Vulkan::Texture::TransitionSubresourcesToLayout(VkCommandBuffer command_buf
 
     case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
       barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-      dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+      dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+      break;
+
+    case VK_IMAGE_LAYOUT_GENERAL:
+      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+                              VK_ACCESS_TRANSFER_WRITE_BIT;
+      dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
       break;
 
     case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
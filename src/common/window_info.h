@@ -34,6 +34,10 @@ struct WindowInfo
   float surface_scale = 1.0f;
   SurfaceFormat surface_format = SurfaceFormat::RGB8;
 
+  // Size to render at when the display hardware can scale up to the surface size (DRM/KMS only). Zero to disable.
+  u32 scanout_width = 0;
+  u32 scanout_height = 0;
+
   // Needed for macOS.
 #ifdef __APPLE__
   void* surface_handle = nullptr;
@@ -57,6 +57,7 @@ static_assert(sizeof(PSEXEHeader) == 0x800);
 
 std::optional<Image> LoadImageFromFile(const char* filename);
 
+Hash GetImageHash(const Image& image);
 const ImageInfo* GetInfoForImage(const Image& image);
 bool IsValidBIOSForRegion(ConsoleRegion console_region, ConsoleRegion bios_region);
 
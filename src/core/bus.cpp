@@ -8,19 +8,26 @@
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
+#include "cpu_recompiler_thunks.h"
 #include "dma.h"
 #include "gpu.h"
 #include "host.h"
 #include "interrupt_controller.h"
 #include "mdec.h"
+#include "mmio_profiler.h"
 #include "pad.h"
 #include "sio.h"
 #include "spu.h"
 #include "timers.h"
 #include "util/state_wrapper.h"
 #include <cstdio>
+#include <limits>
 #include <tuple>
 #include <utility>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#endif
 Log_SetChannel(Bus);
 
 namespace Bus {
@@ -73,6 +80,8 @@ union MEMCTRL
 
 std::bitset<RAM_8MB_CODE_PAGE_COUNT> m_ram_code_bits{};
 u32 m_ram_code_page_count = 0;
+static u32 m_host_page_size = CODE_PAGE_SIZE;
+static u32 m_code_pages_per_protected_page = 1;
 u8* g_ram = nullptr; // 2MB RAM
 u32 g_ram_size = 0;
 u32 g_ram_mask = 0;
@@ -128,6 +137,9 @@ static bool AllocateMemory(bool enable_8mb_ram);
 static void ReleaseMemory();
 
 static void SetCodePageFastmemProtection(u32 page_index, bool writable);
+#ifdef WITH_MMAP_FASTMEM
+static bool HasCodeInProtectedPage(u32 page_index, u32 excluding_page_index);
+#endif
 
 #define FIXUP_HALFWORD_OFFSET(size, offset) ((size >= MemoryAccessSize::HalfWord) ? (offset) : ((offset) & ~1u))
 #define FIXUP_HALFWORD_READ_VALUE(size, offset, value)                                                                 \
@@ -171,6 +183,10 @@ void Shutdown()
 
 void Reset()
 {
+#ifdef WITH_MMIO_PROFILER
+  MMIOProfiler::Reset();
+#endif
+
   std::memset(g_ram, 0, g_ram_size);
   m_MEMCTRL.exp1_base = 0x1F000000;
   m_MEMCTRL.exp2_base = 0x1F802000;
@@ -304,6 +320,22 @@ bool AllocateMemory(bool enable_8mb_ram)
     return false;
   }
 
+  if (g_settings.cpu_huge_pages)
+    Common::MemoryArena::AdviseHugePages(g_ram, ram_size);
+
+  // Code pages stay at 4KB for the LUT and slowmem writes, only mmap protection has to go by the host's pages.
+  m_host_page_size = static_cast<u32>(Common::MemoryArena::GetPageSize());
+  if (m_host_page_size < CODE_PAGE_SIZE || !Common::IsPow2(m_host_page_size) || m_host_page_size > RAM_2MB_SIZE)
+  {
+    Log_ErrorPrintf("Unsupported host page size %u", m_host_page_size);
+    return false;
+  }
+
+  m_code_pages_per_protected_page = m_host_page_size / CODE_PAGE_SIZE;
+  if (m_host_page_size != CODE_PAGE_SIZE)
+    Log_InfoPrintf("Host page size is %u bytes, %u code pages per protected page", m_host_page_size,
+                   m_code_pages_per_protected_page);
+
   g_ram_mask = ram_mask;
   g_ram_size = ram_size;
   m_ram_code_page_count = enable_8mb_ram ? RAM_8MB_CODE_PAGE_COUNT : RAM_2MB_CODE_PAGE_COUNT;
@@ -408,13 +440,16 @@ void UpdateFastmemViews(CPUFastmemMode mode)
         return;
       }
 
-      // mark all pages with code as non-writable
-      for (u32 i = 0; i < m_ram_code_page_count; i++)
+      if (g_settings.cpu_huge_pages)
+        Common::MemoryArena::AdviseHugePages(map_address, g_ram_size);
+
+      // mark all host pages with code as non-writable
+      for (u32 i = 0; i < g_ram_size / CODE_PAGE_SIZE; i += m_code_pages_per_protected_page)
       {
-        if (m_ram_code_bits[i])
+        if (HasCodeInProtectedPage(i, std::numeric_limits<u32>::max()))
         {
-          u8* page_address = map_address + (i * HOST_PAGE_SIZE);
-          if (!m_memory_arena.SetPageProtection(page_address, HOST_PAGE_SIZE, true, false, false))
+          u8* page_address = map_address + (i * CODE_PAGE_SIZE);
+          if (!m_memory_arena.SetPageProtection(page_address, m_host_page_size, true, false, false))
           {
             Log_ErrorPrintf("Failed to write-protect code page at %p", page_address);
             return;
@@ -471,7 +506,7 @@ void UpdateFastmemViews(CPUFastmemMode mode)
   }
 
   auto MapRAM = [](u32 base_address) {
-    for (u32 address = 0; address < g_ram_size; address += HOST_PAGE_SIZE)
+    for (u32 address = 0; address < g_ram_size; address += CODE_PAGE_SIZE)
     {
       SetLUTFastmemPage(base_address + address, &g_ram[address],
                         !m_ram_code_bits[FastmemAddressToLUTPageIndex(address)]);
@@ -546,19 +581,50 @@ void ClearRAMCodePage(u32 index)
   SetCodePageFastmemProtection(index, true);
 }
 
+u32 GetHostPageSize()
+{
+  return m_host_page_size;
+}
+
+u32 GetCodePagesPerProtectedPage()
+{
+  return m_code_pages_per_protected_page;
+}
+
+#ifdef WITH_MMAP_FASTMEM
+
+bool HasCodeInProtectedPage(u32 page_index, u32 excluding_page_index)
+{
+  const u32 first_page_index = page_index & ~(m_code_pages_per_protected_page - 1);
+  for (u32 i = first_page_index; i < (first_page_index + m_code_pages_per_protected_page); i++)
+  {
+    if (i != excluding_page_index && m_ram_code_bits[i])
+      return true;
+  }
+
+  return false;
+}
+
+#endif
+
 void SetCodePageFastmemProtection(u32 page_index, bool writable)
 {
 #ifdef WITH_MMAP_FASTMEM
   if (m_fastmem_mode == CPUFastmemMode::MMap)
   {
-    // unprotect fastmem pages
+    // The host page is shared with the other code pages in it, so its protection only changes with the first page to
+    // gain code, or the last one to lose it.
+    if (HasCodeInProtectedPage(page_index, page_index))
+      return;
+
+    const u32 first_page_index = page_index & ~(m_code_pages_per_protected_page - 1);
     for (const auto& view : m_fastmem_ram_views)
     {
-      u8* page_address = static_cast<u8*>(view.GetBasePointer()) + (page_index * HOST_PAGE_SIZE);
-      if (!m_memory_arena.SetPageProtection(page_address, HOST_PAGE_SIZE, true, writable, false))
+      u8* page_address = static_cast<u8*>(view.GetBasePointer()) + (first_page_index * CODE_PAGE_SIZE);
+      if (!m_memory_arena.SetPageProtection(page_address, m_host_page_size, true, writable, false))
       {
-        Log_ErrorPrintf("Failed to %s code page %u (0x%08X) @ %p", writable ? "unprotect" : "protect", page_index,
-                        page_index * static_cast<u32>(HOST_PAGE_SIZE), page_address);
+        Log_ErrorPrintf("Failed to %s code page %u (0x%08X) @ %p", writable ? "unprotect" : "protect",
+                        first_page_index, first_page_index * static_cast<u32>(CODE_PAGE_SIZE), page_address);
       }
     }
 
@@ -569,7 +635,7 @@ void SetCodePageFastmemProtection(u32 page_index, bool writable)
   if (m_fastmem_mode == CPUFastmemMode::LUT)
   {
     // mirrors...
-    const u32 ram_address = page_index * HOST_PAGE_SIZE;
+    const u32 ram_address = page_index * CODE_PAGE_SIZE;
     for (u32 mirror_start : m_fastmem_ram_mirrors)
       SetLUTFastmemPage(mirror_start + ram_address, &g_ram[ram_address], writable);
   }
@@ -597,7 +663,7 @@ void ClearRAMCodePageFlags()
   {
     for (u32 i = 0; i < m_ram_code_page_count; i++)
     {
-      const u32 addr = (i * HOST_PAGE_SIZE);
+      const u32 addr = (i * CODE_PAGE_SIZE);
       for (u32 mirror_start : m_fastmem_ram_mirrors)
         SetLUTFastmemPage(mirror_start + addr, &g_ram[addr], true);
     }
@@ -606,7 +672,7 @@ void ClearRAMCodePageFlags()
 
 bool IsCodePageAddress(PhysicalMemoryAddress address)
 {
-  return IsRAMAddress(address) ? m_ram_code_bits[(address & g_ram_mask) / HOST_PAGE_SIZE] : false;
+  return IsRAMAddress(address) ? m_ram_code_bits[(address & g_ram_mask) / CODE_PAGE_SIZE] : false;
 }
 
 bool HasCodePagesInRange(PhysicalMemoryAddress start_address, u32 size)
@@ -619,11 +685,11 @@ bool HasCodePagesInRange(PhysicalMemoryAddress start_address, u32 size)
   const u32 end_address = start_address + size;
   while (start_address < end_address)
   {
-    const u32 code_page_index = start_address / HOST_PAGE_SIZE;
+    const u32 code_page_index = start_address / CODE_PAGE_SIZE;
     if (m_ram_code_bits[code_page_index])
       return true;
 
-    start_address += HOST_PAGE_SIZE;
+    start_address += CODE_PAGE_SIZE;
   }
 
   return false;
@@ -805,7 +871,7 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
   }
   else
   {
-    const u32 page_index = offset / HOST_PAGE_SIZE;
+    const u32 page_index = offset / CODE_PAGE_SIZE;
     if constexpr (skip_redundant_writes)
     {
       if constexpr (size == MemoryAccessSize::Byte)
@@ -814,7 +880,7 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
         {
           g_ram[offset] = Truncate8(value);
           if (m_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u8));
         }
       }
       else if constexpr (size == MemoryAccessSize::HalfWord)
@@ -826,7 +892,7 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
         {
           std::memcpy(&g_ram[offset], &new_value, sizeof(u16));
           if (m_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u16));
         }
       }
       else if constexpr (size == MemoryAccessSize::Word)
@@ -837,14 +903,14 @@ ALWAYS_INLINE static TickCount DoRAMAccess(u32 offset, u32& value)
         {
           std::memcpy(&g_ram[offset], &value, sizeof(u32));
           if (m_ram_code_bits[page_index])
-            CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+            CPU::CodeCache::InvalidateBlocksInRange(offset, sizeof(u32));
         }
       }
     }
     else
     {
       if (m_ram_code_bits[page_index])
-        CPU::CodeCache::InvalidateBlocksWithPageIndex(page_index);
+        CPU::CodeCache::InvalidateBlocksInRange(offset, 1u << static_cast<u32>(size));
 
       if constexpr (size == MemoryAccessSize::Byte)
       {
@@ -1339,6 +1405,130 @@ ALWAYS_INLINE static TickCount DoDMAAccess(u32 offset, u32& value)
   }
 }
 
+// I/O registers are decoded through a table of handlers built at compile time, one entry per 16 bytes, instead of
+// walking the chain of address comparisons for every access.
+enum class IORegion : u8
+{
+  Invalid,
+  MemoryControl,
+  Pad,
+  SIO,
+  MemoryControl2,
+  InterruptController,
+  DMA,
+  Timers,
+  CDROM,
+  GPU,
+  MDEC,
+  SPU,
+  Count
+};
+
+enum : u32
+{
+  IO_BASE = MEMCTRL_BASE,
+  IO_SIZE = EXP2_BASE - MEMCTRL_BASE,
+  IO_HANDLER_GRANULARITY = 16,
+  IO_HANDLER_COUNT = IO_SIZE / IO_HANDLER_GRANULARITY,
+};
+
+static_assert(MEMCTRL_SIZE % IO_HANDLER_GRANULARITY == 0 && PAD_BASE % IO_HANDLER_GRANULARITY == 0 &&
+                SIO_BASE % IO_HANDLER_GRANULARITY == 0 && MEMCTRL2_BASE % IO_HANDLER_GRANULARITY == 0 &&
+                INTERRUPT_CONTROLLER_BASE % IO_HANDLER_GRANULARITY == 0 && DMA_BASE % IO_HANDLER_GRANULARITY == 0 &&
+                TIMERS_BASE % IO_HANDLER_GRANULARITY == 0 && TIMERS_SIZE % IO_HANDLER_GRANULARITY == 0 &&
+                CDROM_BASE % IO_HANDLER_GRANULARITY == 0 && GPU_BASE % IO_HANDLER_GRANULARITY == 0 &&
+                MDEC_BASE % IO_HANDLER_GRANULARITY == 0 && MDEC_SIZE % IO_HANDLER_GRANULARITY == 0 &&
+                SPU_BASE % IO_HANDLER_GRANULARITY == 0 && SPU_SIZE % IO_HANDLER_GRANULARITY == 0,
+              "I/O regions are aligned to the handler granularity");
+
+/// Returns the device which decodes the specified I/O address. Matches the order of checks in DoMemoryAccess().
+static constexpr IORegion GetIORegion(PhysicalMemoryAddress address)
+{
+  if (address < MEMCTRL_BASE)
+    return IORegion::Invalid;
+  else if (address < (MEMCTRL_BASE + MEMCTRL_SIZE))
+    return IORegion::MemoryControl;
+  else if (address < (PAD_BASE + PAD_SIZE))
+    return IORegion::Pad;
+  else if (address < (SIO_BASE + SIO_SIZE))
+    return IORegion::SIO;
+  else if (address < (MEMCTRL2_BASE + MEMCTRL2_SIZE))
+    return IORegion::MemoryControl2;
+  else if (address < (INTERRUPT_CONTROLLER_BASE + INTERRUPT_CONTROLLER_SIZE))
+    return IORegion::InterruptController;
+  else if (address < (DMA_BASE + DMA_SIZE))
+    return IORegion::DMA;
+  else if (address < (TIMERS_BASE + TIMERS_SIZE))
+    return IORegion::Timers;
+  else if (address < CDROM_BASE)
+    return IORegion::Invalid;
+  else if (address < (CDROM_BASE + GPU_SIZE))
+    return IORegion::CDROM;
+  else if (address < (GPU_BASE + GPU_SIZE))
+    return IORegion::GPU;
+  else if (address < (MDEC_BASE + MDEC_SIZE))
+    return IORegion::MDEC;
+  else if (address < SPU_BASE)
+    return IORegion::Invalid;
+  else if (address < (SPU_BASE + SPU_SIZE))
+    return IORegion::SPU;
+  else
+    return IORegion::Invalid;
+}
+
+template<MemoryAccessType type, MemoryAccessSize size, IORegion region>
+static TickCount DoIORegionAccess(PhysicalMemoryAddress address, u32& value)
+{
+#ifdef WITH_MMIO_PROFILER
+  MMIOProfiler::RecordAccess(type, size, address, CPU::g_state.current_instruction_pc);
+#endif
+
+  if constexpr (region == IORegion::MemoryControl)
+    return DoMemoryControlAccess<type, size>(address & MEMCTRL_MASK, value);
+  else if constexpr (region == IORegion::Pad)
+    return DoPadAccess<type, size>(address & PAD_MASK, value);
+  else if constexpr (region == IORegion::SIO)
+    return DoSIOAccess<type, size>(address & SIO_MASK, value);
+  else if constexpr (region == IORegion::MemoryControl2)
+    return DoMemoryControl2Access<type, size>(address & MEMCTRL2_MASK, value);
+  else if constexpr (region == IORegion::InterruptController)
+    return DoAccessInterruptController<type, size>(address & INTERRUPT_CONTROLLER_MASK, value);
+  else if constexpr (region == IORegion::DMA)
+    return DoDMAAccess<type, size>(address & DMA_MASK, value);
+  else if constexpr (region == IORegion::Timers)
+    return DoAccessTimers<type, size>(address & TIMERS_MASK, value);
+  else if constexpr (region == IORegion::CDROM)
+    return DoCDROMAccess<type, size>(address & CDROM_MASK, value);
+  else if constexpr (region == IORegion::GPU)
+    return DoGPUAccess<type, size>(address & GPU_MASK, value);
+  else if constexpr (region == IORegion::MDEC)
+    return DoMDECAccess<type, size>(address & MDEC_MASK, value);
+  else if constexpr (region == IORegion::SPU)
+    return DoAccessSPU<type, size>(address & SPU_MASK, value);
+  else
+    return DoInvalidAccess(type, size, address, value);
+}
+
+using IOHandler = TickCount (*)(PhysicalMemoryAddress address, u32& value);
+using IOHandlerTable = std::array<IOHandler, IO_HANDLER_COUNT>;
+
+template<MemoryAccessType type, MemoryAccessSize size, size_t... indices>
+static constexpr IOHandlerTable MakeIOHandlerTable(std::index_sequence<indices...>)
+{
+  return {{&DoIORegionAccess<type, size,
+                              GetIORegion(IO_BASE + static_cast<u32>(indices) * IO_HANDLER_GRANULARITY)>...}};
+}
+
+template<MemoryAccessType type, MemoryAccessSize size>
+static constexpr IOHandlerTable s_io_handlers =
+  MakeIOHandlerTable<type, size>(std::make_index_sequence<IO_HANDLER_COUNT>());
+
+template<MemoryAccessType type, MemoryAccessSize size>
+ALWAYS_INLINE static TickCount DoIOAccess(PhysicalMemoryAddress address, u32& value)
+{
+  return s_io_handlers<type, size>[(address - IO_BASE) / IO_HANDLER_GRANULARITY](address, value);
+}
+
 } // namespace Bus
 
 namespace CPU {
@@ -1417,11 +1607,48 @@ TickCount GetICacheFillTicks(VirtualMemoryAddress address)
   }
 }
 
+static bool AreICacheLinesResident(VirtualMemoryAddress tag, u32 line_count)
+{
+  // the slow path deals with blocks which wrap around the end of the cache
+  const u32 first_line = GetICacheLine(tag);
+  if ((first_line + line_count) > ICACHE_LINES)
+    return false;
+
+  // a block's lines are consecutive, so the tags it expects are too
+  const u32* tags = &g_state.icache_tags[first_line];
+  u32 i = 0;
+#if defined(CPU_X64)
+  const __m128i step = _mm_set1_epi32(static_cast<int>(ICACHE_LINE_SIZE * 4));
+  __m128i expected = _mm_add_epi32(_mm_set1_epi32(static_cast<int>(tag)),
+                                   _mm_setr_epi32(0, ICACHE_LINE_SIZE, ICACHE_LINE_SIZE * 2, ICACHE_LINE_SIZE * 3));
+  for (; (i + 4) <= line_count; i += 4)
+  {
+    const __m128i actual = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&tags[i]));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi32(actual, expected)) != 0xFFFF)
+      return false;
+
+    expected = _mm_add_epi32(expected, step);
+  }
+#endif
+
+  for (; i < line_count; i++)
+  {
+    if (tags[i] != (tag + (i * ICACHE_LINE_SIZE)))
+      return false;
+  }
+
+  return true;
+}
+
 void CheckAndUpdateICacheTags(u32 line_count, TickCount uncached_ticks)
 {
   VirtualMemoryAddress current_pc = g_state.regs.pc & ICACHE_TAG_ADDRESS_MASK;
   if (IsCachedAddress(current_pc))
   {
+    // tight loops are usually fully resident, so only walk the lines when something needs filling
+    if (AreICacheLinesResident(current_pc, line_count))
+      return;
+
     TickCount ticks = 0;
     TickCount cached_ticks_per_line = GetICacheFillTicks(current_pc);
     for (u32 i = 0; i < line_count; i++, current_pc += ICACHE_LINE_SIZE)
@@ -1625,61 +1852,9 @@ static ALWAYS_INLINE TickCount DoMemoryAccess(VirtualMemoryAddress address, u32&
   {
     return DoInvalidAccess(type, size, address, value);
   }
-  else if (address < (MEMCTRL_BASE + MEMCTRL_SIZE))
-  {
-    return DoMemoryControlAccess<type, size>(address & MEMCTRL_MASK, value);
-  }
-  else if (address < (PAD_BASE + PAD_SIZE))
-  {
-    return DoPadAccess<type, size>(address & PAD_MASK, value);
-  }
-  else if (address < (SIO_BASE + SIO_SIZE))
-  {
-    return DoSIOAccess<type, size>(address & SIO_MASK, value);
-  }
-  else if (address < (MEMCTRL2_BASE + MEMCTRL2_SIZE))
-  {
-    return DoMemoryControl2Access<type, size>(address & MEMCTRL2_MASK, value);
-  }
-  else if (address < (INTERRUPT_CONTROLLER_BASE + INTERRUPT_CONTROLLER_SIZE))
-  {
-    return DoAccessInterruptController<type, size>(address & INTERRUPT_CONTROLLER_MASK, value);
-  }
-  else if (address < (DMA_BASE + DMA_SIZE))
-  {
-    return DoDMAAccess<type, size>(address & DMA_MASK, value);
-  }
-  else if (address < (TIMERS_BASE + TIMERS_SIZE))
-  {
-    return DoAccessTimers<type, size>(address & TIMERS_MASK, value);
-  }
-  else if (address < CDROM_BASE)
-  {
-    return DoInvalidAccess(type, size, address, value);
-  }
-  else if (address < (CDROM_BASE + GPU_SIZE))
-  {
-    return DoCDROMAccess<type, size>(address & CDROM_MASK, value);
-  }
-  else if (address < (GPU_BASE + GPU_SIZE))
-  {
-    return DoGPUAccess<type, size>(address & GPU_MASK, value);
-  }
-  else if (address < (MDEC_BASE + MDEC_SIZE))
-  {
-    return DoMDECAccess<type, size>(address & MDEC_MASK, value);
-  }
-  else if (address < SPU_BASE)
-  {
-    return DoInvalidAccess(type, size, address, value);
-  }
-  else if (address < (SPU_BASE + SPU_SIZE))
-  {
-    return DoAccessSPU<type, size>(address & SPU_MASK, value);
-  }
   else if (address < EXP2_BASE)
   {
-    return DoInvalidAccess(type, size, address, value);
+    return DoIOAccess<type, size>(address, value);
   }
   else if (address < (EXP2_BASE + EXP2_SIZE))
   {
@@ -2229,6 +2404,103 @@ void UncheckedWriteMemoryWord(u32 address, u32 value)
   g_state.pending_ticks += DoMemoryAccess<MemoryAccessType::Write, MemoryAccessSize::Word>(address, value);
 }
 
+template<MemoryAccessSize size, Bus::IORegion region>
+static u32 ReadIORegister(u32 address)
+{
+  u32 temp;
+  g_state.pending_ticks += Bus::DoIORegionAccess<MemoryAccessType::Read, size, region>(address, temp);
+  return temp;
+}
+
+template<MemoryAccessSize size, Bus::IORegion region>
+static void WriteIORegister(u32 address, u32 value)
+{
+  g_state.pending_ticks += Bus::DoIORegionAccess<MemoryAccessType::Write, size, region>(address, value);
+}
+
+template<MemoryAccessSize size, size_t... regions>
+static constexpr std::array<IOReadFunction, static_cast<size_t>(Bus::IORegion::Count)>
+MakeIOReadFunctions(std::index_sequence<regions...>)
+{
+  return {{&ReadIORegister<size, static_cast<Bus::IORegion>(regions)>...}};
+}
+
+template<MemoryAccessSize size, size_t... regions>
+static constexpr std::array<IOWriteFunction, static_cast<size_t>(Bus::IORegion::Count)>
+MakeIOWriteFunctions(std::index_sequence<regions...>)
+{
+  return {{&WriteIORegister<size, static_cast<Bus::IORegion>(regions)>...}};
+}
+
+static std::optional<Bus::IORegion> GetConstantIORegion(u32 address)
+{
+  const u32 paddr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
+  const u32 segment = address >> 29;
+  if ((segment != 0 && segment != 4 && segment != 5) || paddr < Bus::IO_BASE ||
+      paddr >= (Bus::IO_BASE + Bus::IO_SIZE))
+  {
+    return std::nullopt;
+  }
+
+  const Bus::IORegion region = Bus::GetIORegion(paddr);
+  if (region == Bus::IORegion::Invalid)
+    return std::nullopt;
+
+  return region;
+}
+
+IOReadFunction GetIOReadFunction(MemoryAccessSize size, u32 address)
+{
+  static constexpr auto byte_functions =
+    MakeIOReadFunctions<MemoryAccessSize::Byte>(std::make_index_sequence<static_cast<size_t>(Bus::IORegion::Count)>());
+  static constexpr auto halfword_functions = MakeIOReadFunctions<MemoryAccessSize::HalfWord>(
+    std::make_index_sequence<static_cast<size_t>(Bus::IORegion::Count)>());
+  static constexpr auto word_functions =
+    MakeIOReadFunctions<MemoryAccessSize::Word>(std::make_index_sequence<static_cast<size_t>(Bus::IORegion::Count)>());
+
+  const std::optional<Bus::IORegion> region = GetConstantIORegion(address);
+  if (!region.has_value())
+    return nullptr;
+
+  const size_t index = static_cast<size_t>(region.value());
+  switch (size)
+  {
+    case MemoryAccessSize::Byte:
+      return byte_functions[index];
+    case MemoryAccessSize::HalfWord:
+      return halfword_functions[index];
+    case MemoryAccessSize::Word:
+    default:
+      return word_functions[index];
+  }
+}
+
+IOWriteFunction GetIOWriteFunction(MemoryAccessSize size, u32 address)
+{
+  static constexpr auto byte_functions =
+    MakeIOWriteFunctions<MemoryAccessSize::Byte>(std::make_index_sequence<static_cast<size_t>(Bus::IORegion::Count)>());
+  static constexpr auto halfword_functions = MakeIOWriteFunctions<MemoryAccessSize::HalfWord>(
+    std::make_index_sequence<static_cast<size_t>(Bus::IORegion::Count)>());
+  static constexpr auto word_functions =
+    MakeIOWriteFunctions<MemoryAccessSize::Word>(std::make_index_sequence<static_cast<size_t>(Bus::IORegion::Count)>());
+
+  const std::optional<Bus::IORegion> region = GetConstantIORegion(address);
+  if (!region.has_value())
+    return nullptr;
+
+  const size_t index = static_cast<size_t>(region.value());
+  switch (size)
+  {
+    case MemoryAccessSize::Byte:
+      return byte_functions[index];
+    case MemoryAccessSize::HalfWord:
+      return halfword_functions[index];
+    case MemoryAccessSize::Word:
+    default:
+      return word_functions[index];
+  }
+}
+
 } // namespace Recompiler::Thunks
 
 } // namespace CPU
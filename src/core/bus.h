@@ -93,8 +93,8 @@ enum : size_t
 
 enum : u32
 {
-  RAM_2MB_CODE_PAGE_COUNT = (RAM_2MB_SIZE + (HOST_PAGE_SIZE + 1)) / HOST_PAGE_SIZE,
-  RAM_8MB_CODE_PAGE_COUNT = (RAM_8MB_SIZE + (HOST_PAGE_SIZE + 1)) / HOST_PAGE_SIZE,
+  RAM_2MB_CODE_PAGE_COUNT = (RAM_2MB_SIZE + (CODE_PAGE_SIZE + 1)) / CODE_PAGE_SIZE,
+  RAM_8MB_CODE_PAGE_COUNT = (RAM_8MB_SIZE + (CODE_PAGE_SIZE + 1)) / CODE_PAGE_SIZE,
 
   FASTMEM_LUT_NUM_PAGES = 0x100000, // 0x100000000 >> 12
   FASTMEM_LUT_NUM_SLOTS = FASTMEM_LUT_NUM_PAGES * 2,
@@ -128,7 +128,7 @@ ALWAYS_INLINE static bool IsRAMAddress(PhysicalMemoryAddress address)
 /// Returns the code page index for a RAM address.
 ALWAYS_INLINE static u32 GetRAMCodePageIndex(PhysicalMemoryAddress address)
 {
-  return (address & g_ram_mask) / HOST_PAGE_SIZE;
+  return (address & g_ram_mask) / CODE_PAGE_SIZE;
 }
 
 /// Returns true if the specified page contains code.
@@ -143,6 +143,13 @@ void ClearRAMCodePage(u32 index);
 /// Clears all code bits for RAM regions.
 void ClearRAMCodePageFlags();
 
+/// Returns the host's page size, which is what mmap fastmem can write-protect code pages at.
+u32 GetHostPageSize();
+
+/// Returns the number of code pages sharing each write-protected page in mmap fastmem. With 16KB host pages, a write
+/// to any of the four code pages makes the whole host page writable, so all four have to be invalidated together.
+u32 GetCodePagesPerProtectedPage();
+
 /// Returns true if the specified address is in a code page.
 bool IsCodePageAddress(PhysicalMemoryAddress address);
 
@@ -8,6 +8,7 @@
 #include "host_interface_progress_callback.h"
 #include "imgui.h"
 #include "interrupt_controller.h"
+#include "mdec.h"
 #include "settings.h"
 #include "spu.h"
 #include "system.h"
@@ -142,6 +143,9 @@ void CDROM::Reset()
   m_last_sector_header_valid = false;
   std::memset(&m_last_subq, 0, sizeof(m_last_subq));
   m_last_cdda_report_frame_nibble = 0xFF;
+  m_auto_read_speedup_hold_sectors = 0;
+  m_auto_read_speedup_last_mdec_blocks = g_mdec.GetTotalBlocksDecoded();
+  m_received_commands = false;
 
   m_next_cd_audio_volume_matrix[0][0] = 0x80;
   m_next_cd_audio_volume_matrix[0][1] = 0x00;
@@ -153,11 +157,11 @@ void CDROM::Reset()
   m_param_fifo.Clear();
   m_response_fifo.Clear();
   m_async_response_fifo.Clear();
-  m_data_fifo.Clear();
+  ClearDataFIFO();
 
   m_current_read_sector_buffer = 0;
   m_current_write_sector_buffer = 0;
-  for (u32 i = 0; i < NUM_SECTOR_BUFFERS; i++)
+  for (u32 i = 0; i < m_sector_buffers.size(); i++)
   {
     m_sector_buffers[i].data.fill(0);
     m_sector_buffers[i].size = 0;
@@ -193,11 +197,11 @@ void CDROM::SoftReset(TickCount ticks_late)
 
   m_param_fifo.Clear();
   m_async_response_fifo.Clear();
-  m_data_fifo.Clear();
+  ClearDataFIFO();
 
   m_current_read_sector_buffer = 0;
   m_current_write_sector_buffer = 0;
-  for (u32 i = 0; i < NUM_SECTOR_BUFFERS; i++)
+  for (u32 i = 0; i < m_sector_buffers.size(); i++)
   {
     m_sector_buffers[i].data.fill(0);
     m_sector_buffers[i].size = 0;
@@ -281,7 +285,24 @@ bool CDROM::DoState(StateWrapper& sw)
   sw.Do(&m_param_fifo);
   sw.Do(&m_response_fifo);
   sw.Do(&m_async_response_fifo);
-  sw.Do(&m_data_fifo);
+
+  if (sw.GetVersion() >= 57)
+  {
+    sw.Do(&m_data_fifo_buffer);
+    sw.Do(&m_data_fifo_position);
+    sw.Do(&m_data_fifo_size);
+    sw.Do(&m_sector_buffers[DETACHED_DATA_FIFO_BUFFER].data);
+  }
+  else
+  {
+    // older states kept a separate copy of the FIFO contents
+    HeapFIFOQueue<u8, DATA_FIFO_SIZE> data_fifo;
+    sw.Do(&data_fifo);
+    m_data_fifo_buffer = DETACHED_DATA_FIFO_BUFFER;
+    m_data_fifo_position = 0;
+    m_data_fifo_size = data_fifo.GetSize();
+    data_fifo.PopRange(m_sector_buffers[DETACHED_DATA_FIFO_BUFFER].data.data(), m_data_fifo_size);
+  }
 
   sw.Do(&m_current_read_sector_buffer);
   sw.Do(&m_current_write_sector_buffer);
@@ -296,6 +317,9 @@ bool CDROM::DoState(StateWrapper& sw)
 
   if (sw.IsReading())
   {
+    // we don't know what happened before the state was saved
+    m_received_commands = true;
+
     if (m_reader.HasMedia())
       m_reader.QueueReadSector(m_requested_lba);
     UpdateCommandEvent();
@@ -342,6 +366,10 @@ void CDROM::InsertMedia(std::unique_ptr<CDImage> media)
   if (m_drive_state != DriveState::ShellOpening)
     StartMotor();
 
+  // the reader thread owns the image from here on, so the cache has to be set up first
+  media->ConfigureDecompressionCache(g_settings.cdrom_chd_hunk_cache_size, g_settings.cdrom_chd_prefetch,
+                                     g_settings.cdrom_precache_compressed);
+  media->ConfigureSubImagePreload(g_settings.cdrom_preload_next_disc, g_settings.cdrom_preload_next_disc_budget_mb);
   m_reader.SetMedia(std::move(media));
   SetHoldPosition(0, true);
 }
@@ -457,7 +485,13 @@ u8 CDROM::ReadRegister(u32 offset)
 
     case 2: // always data FIFO
     {
-      const u8 value = m_data_fifo.Pop();
+      if (IsDataFIFOEmpty())
+      {
+        Log_DevPrintf("Data FIFO read while empty");
+        return 0x00;
+      }
+
+      const u8 value = m_sector_buffers[m_data_fifo_buffer].data[m_data_fifo_position++];
       UpdateStatusRegister();
       Log_DebugPrintf("CDROM read data FIFO -> 0x%08X", ZeroExtend32(value));
       return value;
@@ -537,7 +571,7 @@ void CDROM::WriteRegister(u32 offset, u8 value)
       else
       {
         Log_DebugPrintf("Clearing data FIFO");
-        m_data_fifo.Clear();
+        ClearDataFIFO();
       }
 
       UpdateStatusRegister();
@@ -625,7 +659,7 @@ void CDROM::WriteRegister(u32 offset, u8 value)
       {
         if (HasPendingDiscEvent())
           m_drive_event->InvokeEarly();
-        SPU::GeneratePendingSamples();
+        SPU::GeneratePendingSamples(true);
       }
 
       m_adpcm_muted = adpcm_muted;
@@ -645,15 +679,18 @@ void CDROM::WriteRegister(u32 offset, u8 value)
 
 void CDROM::DMARead(u32* words, u32 word_count)
 {
-  const u32 words_in_fifo = m_data_fifo.GetSize() / 4;
+  const u32 bytes_in_fifo = m_data_fifo_size - m_data_fifo_position;
+  const u32 words_in_fifo = bytes_in_fifo / 4;
   if (words_in_fifo < word_count)
   {
     Log_ErrorPrintf("DMA read on empty/near-empty data FIFO");
     std::memset(words + words_in_fifo, 0, sizeof(u32) * (word_count - words_in_fifo));
   }
 
-  const u32 bytes_to_read = std::min<u32>(word_count * sizeof(u32), m_data_fifo.GetSize());
-  m_data_fifo.PopRange(reinterpret_cast<u8*>(words), bytes_to_read);
+  // copy straight out of the sector buffer, there's no intermediate FIFO
+  const u32 bytes_to_read = std::min<u32>(word_count * sizeof(u32), bytes_in_fifo);
+  std::memcpy(words, m_sector_buffers[m_data_fifo_buffer].data.data() + m_data_fifo_position, bytes_to_read);
+  m_data_fifo_position += bytes_to_read;
 }
 
 void CDROM::SetInterrupt(Interrupt interrupt)
@@ -727,7 +764,7 @@ void CDROM::UpdateStatusRegister()
   m_status.PRMEMPTY = m_param_fifo.IsEmpty();
   m_status.PRMWRDY = !m_param_fifo.IsFull();
   m_status.RSLRRDY = !m_response_fifo.IsEmpty();
-  m_status.DRQSTS = !m_data_fifo.IsEmpty();
+  m_status.DRQSTS = !IsDataFIFOEmpty();
   m_status.BUSYSTS = HasPendingCommand();
 
   g_dma.SetRequest(DMA::Channel::CDROM, m_status.DRQSTS);
@@ -780,12 +817,32 @@ TickCount CDROM::GetTicksForRead()
 {
   const TickCount tps = System::GetTicksPerSecond();
 
-  if (g_settings.cdrom_read_speedup > 1 && !m_mode.cdda && !m_mode.xa_enable && m_mode.double_speed)
-    return tps / (150 * g_settings.cdrom_read_speedup);
+  if (!m_mode.cdda && !m_mode.xa_enable && m_mode.double_speed)
+  {
+    if (g_settings.cdrom_read_speedup > 1)
+      return tps / (150 * g_settings.cdrom_read_speedup);
+    else if (g_settings.cdrom_read_speedup == 0 && m_auto_read_speedup_hold_sectors == 0)
+      return tps / (150 * AUTO_READ_SPEEDUP);
+  }
 
   return m_mode.double_speed ? (tps / 150) : (tps / 75);
 }
 
+void CDROM::UpdateAutoReadSpeedup(bool is_data_sector)
+{
+  // Video is usually streamed from realtime sectors, but not always, so also watch for the MDEC decoding frames.
+  const u32 mdec_blocks = g_mdec.GetTotalBlocksDecoded();
+  const bool streaming = (!is_data_sector || m_mode.cdda || m_mode.xa_enable ||
+                          (m_last_sector_header.sector_mode == 2 && m_last_sector_subheader.submode.realtime) ||
+                          mdec_blocks != m_auto_read_speedup_last_mdec_blocks);
+  m_auto_read_speedup_last_mdec_blocks = mdec_blocks;
+
+  if (streaming)
+    m_auto_read_speedup_hold_sectors = AUTO_READ_SPEEDUP_HOLD_SECTORS;
+  else if (m_auto_read_speedup_hold_sectors > 0)
+    m_auto_read_speedup_hold_sectors--;
+}
+
 TickCount CDROM::GetTicksForSeek(CDImage::LBA new_lba, bool ignore_speed_change)
 {
   static constexpr TickCount MIN_TICKS = 20000;
@@ -898,6 +955,8 @@ CDImage::LBA CDROM::GetNextSectorToBeRead()
 
 void CDROM::BeginCommand(Command command)
 {
+  m_received_commands = true;
+
   TickCount ack_delay = GetAckDelayForCommand(command);
 
   if (HasPendingCommand())
@@ -2317,6 +2376,9 @@ void CDROM::DoSectorRead()
     ProcessDataSectorHeader(m_reader.GetSectorBuffer().data());
   }
 
+  if (g_settings.cdrom_read_speedup == 0)
+    UpdateAutoReadSpeedup(is_data_sector);
+
   u32 next_sector = m_current_lba + 1u;
   if (is_data_sector && m_drive_state == DriveState::Reading)
   {
@@ -2377,6 +2439,8 @@ void CDROM::ProcessDataSector(const u8* raw_sector, const CDImage::SubChannelQ&
     Log_DevPrintf("Sector buffer %u was not read, previous sector dropped",
                   (m_current_write_sector_buffer - 1) % NUM_SECTOR_BUFFERS);
   }
+  if (m_data_fifo_buffer == sb_num && !IsDataFIFOEmpty())
+    DetachDataFIFO(sb_num);
 
   if (m_mode.ignore_bit)
     Log_WarningPrintf("SetMode.4 bit set on read of sector %u", m_current_lba);
@@ -2419,7 +2483,7 @@ void CDROM::ProcessDataSector(const u8* raw_sector, const CDImage::SubChannelQ&
   SetAsyncInterrupt(Interrupt::DataReady);
 }
 
-static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
+static constexpr std::array<std::array<s16, 29>, 7> s_zigzag_table = {
   {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
     0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
     0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
@@ -2442,13 +2506,54 @@ static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
     0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
     0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
 
-static s16 ZigZagInterpolate(const s16* ringbuf, const s16* table, u8 p)
+// The zigzag tables reversed and padded to 32 taps, so they line up with a linear window of the ring buffer that runs
+// from the oldest sample to the newest. The padding taps are zero, and so don't contribute to the sum.
+static constexpr std::array<std::array<s16, 32>, 7> s_zigzag_table_reversed = []() {
+  std::array<std::array<s16, 32>, 7> ret = {};
+  for (u32 i = 0; i < 7; i++)
+  {
+    for (u32 j = 0; j < 29; j++)
+      ret[i][j] = s_zigzag_table[i][28 - j];
+  }
+  return ret;
+}();
+
+static void GetZigZagWindow(const s16* ringbuf, u8 p, s16* window)
 {
-  s32 sum = 0;
   for (u8 i = 0; i < 29; i++)
-    sum += (s32(ringbuf[(p - i) & 0x1F]) * s32(table[i])) / 0x8000;
+    window[i] = ringbuf[(p - 28 + i) & 0x1F];
+  for (u8 i = 29; i < 32; i++)
+    window[i] = 0;
+}
 
-  return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
+static s16 ZigZagInterpolate(const s16* window, const s16* table)
+{
+  // Each product is divided by 0x8000 individually, rounding towards zero, before it's summed.
+#if defined(CPU_X64)
+  __m128i sum = _mm_setzero_si128();
+  for (u32 i = 0; i < 32; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&window[i]));
+    const __m128i coeffs = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&table[i]));
+    const __m128i lo = _mm_mullo_epi16(samples, coeffs);
+    const __m128i hi = _mm_mulhi_epi16(samples, coeffs);
+    const __m128i product_lo = _mm_unpacklo_epi16(lo, hi);
+    const __m128i product_hi = _mm_unpackhi_epi16(lo, hi);
+    const __m128i bias_lo = _mm_and_si128(_mm_srai_epi32(product_lo, 31), _mm_set1_epi32(0x7FFF));
+    const __m128i bias_hi = _mm_and_si128(_mm_srai_epi32(product_hi, 31), _mm_set1_epi32(0x7FFF));
+    sum = _mm_add_epi32(sum, _mm_srai_epi32(_mm_add_epi32(product_lo, bias_lo), 15));
+    sum = _mm_add_epi32(sum, _mm_srai_epi32(_mm_add_epi32(product_hi, bias_hi), 15));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  const s32 result = _mm_cvtsi128_si32(sum);
+#else
+  s32 result = 0;
+  for (u8 i = 0; i < 32; i++)
+    result += (s32(window[i]) * s32(table[i])) / 0x8000;
+#endif
+
+  return static_cast<s16>(std::clamp<s32>(result, -0x8000, 0x7FFF));
 }
 
 template<bool STEREO, bool SAMPLE_RATE>
@@ -2488,10 +2593,18 @@ void CDROM::ResampleXAADPCM(const s16* frames_in, u32 num_frames_in)
       if (sixstep == 0)
       {
         sixstep = 6;
+
+        // all seven output samples use the same window, so unwrap it once
+        std::array<s16, 32> left_window, right_window;
+        GetZigZagWindow(left_ringbuf, p, left_window.data());
+        if constexpr (STEREO)
+          GetZigZagWindow(right_ringbuf, p, right_window.data());
+
         for (u32 j = 0; j < 7; j++)
         {
-          const s16 left_interp = ZigZagInterpolate(left_ringbuf, s_zigzag_table[j].data(), p);
-          const s16 right_interp = STEREO ? ZigZagInterpolate(right_ringbuf, s_zigzag_table[j].data(), p) : left_interp;
+          const s16 left_interp = ZigZagInterpolate(left_window.data(), s_zigzag_table_reversed[j].data());
+          const s16 right_interp =
+            STEREO ? ZigZagInterpolate(right_window.data(), s_zigzag_table_reversed[j].data()) : left_interp;
           AddCDAudioFrame(left_interp, right_interp);
         }
       }
@@ -2574,7 +2687,7 @@ void CDROM::ProcessXAADPCMSector(const u8* raw_sector, const CDImage::SubChannel
   if (m_muted || m_adpcm_muted || g_settings.cdrom_mute_cd_audio)
     return;
 
-  SPU::GeneratePendingSamples();
+  SPU::GeneratePendingSamples(true);
 
   if (m_last_sector_subheader.codinginfo.IsStereo())
   {
@@ -2680,7 +2793,7 @@ void CDROM::ProcessCDDASector(const u8* raw_sector, const CDImage::SubChannelQ&
   if (m_muted || g_settings.cdrom_mute_cd_audio)
     return;
 
-  SPU::GeneratePendingSamples();
+  SPU::GeneratePendingSamples(true);
 
   constexpr bool is_stereo = true;
   constexpr u32 num_samples = CDImage::RAW_SECTOR_SIZE / sizeof(s16) / (is_stereo ? 2 : 1);
@@ -2691,20 +2804,13 @@ void CDROM::ProcessCDDASector(const u8* raw_sector, const CDImage::SubChannelQ&
     m_audio_fifo.Remove(num_samples - remaining_space);
   }
 
-  const u8* sector_ptr = raw_sector;
-  for (u32 i = 0; i < num_samples; i++)
-  {
-    s16 samp_left, samp_right;
-    std::memcpy(&samp_left, sector_ptr, sizeof(samp_left));
-    std::memcpy(&samp_right, sector_ptr + sizeof(s16), sizeof(samp_right));
-    sector_ptr += sizeof(s16) * 2;
-    AddCDAudioFrame(samp_left, samp_right);
-  }
+  // NOTE: assumes LE, the sector is already laid out as left/right pairs in the same format as AddCDAudioFrame().
+  m_audio_fifo.PushRange(reinterpret_cast<const u32*>(raw_sector), num_samples);
 }
 
 void CDROM::LoadDataFIFO()
 {
-  if (!m_data_fifo.IsEmpty())
+  if (!IsDataFIFOEmpty())
   {
     Log_DevPrintf("Load data fifo when not empty");
     return;
@@ -2712,18 +2818,20 @@ void CDROM::LoadDataFIFO()
 
   // any data to load?
   SectorBuffer& sb = m_sector_buffers[m_current_read_sector_buffer];
+  m_data_fifo_buffer = m_current_read_sector_buffer;
+  m_data_fifo_position = 0;
   if (sb.size == 0)
   {
     Log_WarningPrintf("Attempting to load empty sector buffer");
-    m_data_fifo.PushRange(sb.data.data(), RAW_SECTOR_OUTPUT_SIZE);
+    m_data_fifo_size = RAW_SECTOR_OUTPUT_SIZE;
   }
   else
   {
-    m_data_fifo.PushRange(sb.data.data(), sb.size);
+    m_data_fifo_size = sb.size;
     sb.size = 0;
   }
 
-  Log_DebugPrintf("Loaded %u bytes to data FIFO from buffer %u", m_data_fifo.GetSize(), m_current_read_sector_buffer);
+  Log_DebugPrintf("Loaded %u bytes to data FIFO from buffer %u", m_data_fifo_size, m_current_read_sector_buffer);
 
   SectorBuffer& next_sb = m_sector_buffers[m_current_write_sector_buffer];
   if (next_sb.size > 0)
@@ -2740,6 +2848,24 @@ void CDROM::ClearSectorBuffers()
     m_sector_buffers[i].size = 0;
 }
 
+void CDROM::ClearDataFIFO()
+{
+  m_data_fifo_buffer = 0;
+  m_data_fifo_position = 0;
+  m_data_fifo_size = 0;
+}
+
+void CDROM::DetachDataFIFO(u32 sector_buffer)
+{
+  Log_DevPrintf("Sector buffer %u overwritten while in data FIFO, moving %u bytes", sector_buffer,
+                m_data_fifo_size - m_data_fifo_position);
+
+  const u8* src = m_sector_buffers[sector_buffer].data.data() + m_data_fifo_position;
+  u8* dst = m_sector_buffers[DETACHED_DATA_FIFO_BUFFER].data.data() + m_data_fifo_position;
+  std::memcpy(dst, src, m_data_fifo_size - m_data_fifo_position);
+  m_data_fifo_buffer = DETACHED_DATA_FIFO_BUFFER;
+}
+
 void CDROM::DrawDebugWindow()
 {
   static const ImVec4 active_color{1.0f, 1.0f, 1.0f, 1.0f};
@@ -2789,6 +2915,13 @@ void CDROM::DrawDebugWindow()
 
       ImGui::Text("Last Sector: %02X:%02X:%02X (Mode %u)", m_last_sector_header.minute, m_last_sector_header.second,
                   m_last_sector_header.frame, m_last_sector_header.sector_mode);
+
+      if (m_reader.IsUsingThread())
+      {
+        const CDROMAsyncReader::ReadaheadStats stats = m_reader.GetReadaheadStats();
+        ImGui::Text("Readahead: %u/%u sectors, %u hits, %u misses (%u from previous window)", stats.window,
+                    stats.max_window, stats.hits, stats.misses, stats.stash_hits);
+      }
     }
     else
     {
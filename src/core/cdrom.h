@@ -32,6 +32,9 @@ public:
   const std::string& GetMediaFileName() const { return m_reader.GetMediaFileName(); }
   const CDImage* GetMedia() const { return m_reader.GetMedia(); }
   DiscRegion GetDiscRegion() const { return m_disc_region; }
+
+  /// Returns true if the CPU has sent any command to the drive since the last reset.
+  ALWAYS_INLINE bool HasReceivedCommands() const { return m_received_commands; }
   bool IsMediaPS1Disc() const;
   bool DoesMediaRegionMatchConsole() const;
 
@@ -79,6 +82,7 @@ private:
     RESPONSE_FIFO_SIZE = 16,
     DATA_FIFO_SIZE = RAW_SECTOR_OUTPUT_SIZE,
     NUM_SECTOR_BUFFERS = 8,
+    DETACHED_DATA_FIFO_BUFFER = NUM_SECTOR_BUFFERS,
     AUDIO_FIFO_SIZE = 44100 * 2,
     AUDIO_FIFO_LOW_WATERMARK = 10,
 
@@ -87,7 +91,10 @@ private:
     MOTOR_ON_RESPONSE_TICKS = 400000,
 
     MAX_FAST_FORWARD_RATE = 12,
-    FAST_FORWARD_RATE_STEP = 4
+    FAST_FORWARD_RATE_STEP = 4,
+
+    AUTO_READ_SPEEDUP = 8,
+    AUTO_READ_SPEEDUP_HOLD_SECTORS = 150
   };
 
   static constexpr u8 INTERRUPT_REGISTER_MASK = 0x1F;
@@ -290,6 +297,7 @@ private:
   TickCount GetTicksForStop(bool motor_was_on);
   TickCount GetTicksForSpeedChange();
   TickCount GetTicksForTOCRead();
+  void UpdateAutoReadSpeedup(bool is_data_sector);
   CDImage::LBA GetNextSectorToBeRead();
   bool CompleteSeek();
 
@@ -329,6 +337,9 @@ private:
   void ResetAudioDecoder();
   void LoadDataFIFO();
   void ClearSectorBuffers();
+  void ClearDataFIFO();
+  void DetachDataFIFO(u32 sector_buffer);
+  bool IsDataFIFOEmpty() const { return (m_data_fifo_position == m_data_fifo_size); }
 
   template<bool STEREO, bool SAMPLE_RATE>
   void ResampleXAADPCM(const s16* frames_in, u32 num_frames_in);
@@ -380,6 +391,13 @@ private:
   u8 m_async_command_parameter = 0x00;
   s8 m_fast_forward_rate = 0;
 
+  // Automatic read speedup is held off for a number of sectors after any sign of audio or video streaming.
+  u32 m_auto_read_speedup_hold_sectors = 0;
+  u32 m_auto_read_speedup_last_mdec_blocks = 0;
+
+  // Not serialized, only used to decide whether the boot state is still disc-independent.
+  bool m_received_commands = false;
+
   std::array<std::array<u8, 2>, 2> m_cd_audio_volume_matrix{};
   std::array<std::array<u8, 2>, 2> m_next_cd_audio_volume_matrix{};
 
@@ -391,7 +409,6 @@ private:
   InlineFIFOQueue<u8, PARAM_FIFO_SIZE> m_param_fifo;
   InlineFIFOQueue<u8, RESPONSE_FIFO_SIZE> m_response_fifo;
   InlineFIFOQueue<u8, RESPONSE_FIFO_SIZE> m_async_response_fifo;
-  HeapFIFOQueue<u8, DATA_FIFO_SIZE> m_data_fifo;
 
   struct SectorBuffer
   {
@@ -401,7 +418,13 @@ private:
 
   u32 m_current_read_sector_buffer = 0;
   u32 m_current_write_sector_buffer = 0;
-  std::array<SectorBuffer, NUM_SECTOR_BUFFERS> m_sector_buffers;
+
+  // The data FIFO is read straight out of a sector buffer. If that buffer gets overwritten before the FIFO has been
+  // drained, the remaining data is moved to the extra buffer at the end.
+  std::array<SectorBuffer, NUM_SECTOR_BUFFERS + 1> m_sector_buffers;
+  u32 m_data_fifo_buffer = 0;
+  u32 m_data_fifo_position = 0;
+  u32 m_data_fifo_size = 0;
 
   CDROMAsyncReader m_reader;
 
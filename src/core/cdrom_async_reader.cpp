@@ -1,7 +1,9 @@
 #include "cdrom_async_reader.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/thread_placement.h"
 #include "common/timer.h"
+#include <algorithm>
 Log_SetChannel(CDROMAsyncReader);
 
 CDROMAsyncReader::CDROMAsyncReader() = default;
@@ -16,13 +18,21 @@ void CDROMAsyncReader::StartThread(u32 readahead_count)
   if (IsUsingThread())
     StopThread();
 
+  m_readahead_count = readahead_count;
+  m_window_size = readahead_count * MAX_READAHEAD_SCALE;
   m_buffers.clear();
-  m_buffers.resize(readahead_count);
+  m_buffers.resize(m_window_size * 2);
+  m_window_base.store(0);
+  m_readahead_window.store(readahead_count);
+  m_sequential_hits = 0;
+  m_stat_hits.store(0);
+  m_stat_misses.store(0);
+  m_stat_stash_hits.store(0);
   EmptyBuffers();
 
   m_shutdown_flag.store(false);
   m_read_thread = std::thread(&CDROMAsyncReader::WorkerThreadEntryPoint, this);
-  Log_InfoPrintf("Read thread started with readahead of %u sectors", readahead_count);
+  Log_InfoPrintf("Read thread started with readahead of %u sectors (up to %u)", readahead_count, m_window_size);
 }
 
 void CDROMAsyncReader::StopThread()
@@ -37,8 +47,22 @@ void CDROMAsyncReader::StopThread()
   }
 
   m_read_thread.join();
+
+  const ReadaheadStats stats = GetReadaheadStats();
+  Log_DevPrintf("Readahead stats: %u hits, %u misses, %u from previous window, final window %u sectors", stats.hits,
+                stats.misses, stats.stash_hits, stats.window);
+
   EmptyBuffers();
   m_buffers.clear();
+  m_window_size = 0;
+  m_window_base.store(0);
+  m_readahead_count = 0;
+}
+
+CDROMAsyncReader::ReadaheadStats CDROMAsyncReader::GetReadaheadStats() const
+{
+  return ReadaheadStats{m_stat_hits.load(std::memory_order_relaxed), m_stat_misses.load(std::memory_order_relaxed),
+                        m_stat_stash_hits.load(std::memory_order_relaxed), m_readahead_window.load(), m_window_size};
 }
 
 void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
@@ -105,23 +129,34 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
   }
 
   const u32 buffer_count = m_buffer_count.load();
-  if (buffer_count > 0)
+  if (buffer_count > 0 && !m_next_position_set.load())
   {
     // don't re-read the same sector if it was the last one we read
     // the CDC code does this when seeking->reading
+    const u32 window_base = m_window_base.load();
     const u32 buffer_front = m_buffer_front.load();
-    if (m_buffers[buffer_front].lba == lba)
+    if (GetWindowSlot(window_base, buffer_front).lba == lba)
     {
       Log_DebugPrintf("Skipping re-reading same sector %u", lba);
       return;
     }
 
     // did we readahead to the correct sector?
-    const u32 next_buffer = (buffer_front + 1) % static_cast<u32>(m_buffers.size());
-    if (m_buffer_count > 1 && m_buffers[next_buffer].lba == lba)
+    const u32 next_buffer = (buffer_front + 1) % m_window_size;
+    if (m_buffer_count > 1 && GetWindowSlot(window_base, next_buffer).lba == lba)
     {
       // great, don't need a seek, but still kick the thread to start reading ahead again
       Log_DebugPrintf("Readahead buffer hit for sector %u", lba);
+      m_stat_hits.fetch_add(1, std::memory_order_relaxed);
+
+      // a full window of hits means we're streaming, so read further ahead
+      const u32 window = m_readahead_window.load();
+      if (++m_sequential_hits >= window && window < m_window_size)
+      {
+        m_readahead_window.store(std::min(window * 2, m_window_size));
+        m_sequential_hits = 0;
+      }
+
       m_buffer_front.store(next_buffer);
       m_buffer_count.fetch_sub(1);
       m_can_readahead.store(true);
@@ -130,8 +165,11 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
     }
   }
 
-  // we need to toss away our readahead and start fresh
+  // we need to set aside our readahead and start fresh
   Log_DebugPrintf("Readahead buffer miss, queueing seek to %u", lba);
+  m_stat_misses.fetch_add(1, std::memory_order_relaxed);
+  m_sequential_hits = 0;
+
   std::unique_lock<std::mutex> lock(m_mutex);
   m_next_position_set.store(true);
   m_next_position = lba;
@@ -221,6 +259,50 @@ void CDROMAsyncReader::EmptyBuffers()
   m_buffer_front.store(0);
   m_buffer_back.store(0);
   m_buffer_count.store(0);
+  m_stash_front = 0;
+  m_stash_count = 0;
+}
+
+bool CDROMAsyncReader::RestoreStashedWindow(CDImage::LBA lba, CDImage::LBA* next_lba)
+{
+  const u32 stash_base = m_window_size - m_window_base.load();
+  for (u32 i = 0; i < m_stash_count; i++)
+  {
+    const BufferSlot& slot = GetWindowSlot(stash_base, m_stash_front + i);
+    if (slot.lba != lba)
+      continue;
+
+    // let failed reads be retried
+    if (!slot.result)
+      return false;
+
+    // swap the windows, so we can come back to this one too
+    const u32 old_front = m_buffer_front.load();
+    const u32 old_count = m_buffer_count.load();
+    const u32 front = (m_stash_front + i) % m_window_size;
+    const u32 count = m_stash_count - i;
+    m_window_base.store(stash_base);
+    m_buffer_front.store(front);
+    m_buffer_back.store((front + count) % m_window_size);
+    m_buffer_count.store(count);
+    m_stash_front = old_front;
+    m_stash_count = old_count;
+
+    *next_lba = GetWindowSlot(stash_base, front + count - 1).lba + 1;
+    return true;
+  }
+
+  return false;
+}
+
+void CDROMAsyncReader::StashCurrentWindow()
+{
+  m_stash_front = m_buffer_front.load();
+  m_stash_count = m_buffer_count.load();
+  m_window_base.store(m_window_size - m_window_base.load());
+  m_buffer_front.store(0);
+  m_buffer_back.store(0);
+  m_buffer_count.store(0);
 }
 
 bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
@@ -228,9 +310,9 @@ bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
   Common::Timer timer;
 
   const u32 slot = m_buffer_back.load();
-  m_buffer_back.store((slot + 1) % static_cast<u32>(m_buffers.size()));
+  m_buffer_back.store((slot + 1) % m_window_size);
 
-  BufferSlot& buffer = m_buffers[slot];
+  BufferSlot& buffer = GetWindowSlot(m_window_base.load(), slot);
   buffer.lba = m_media->GetPositionOnDisc();
   m_is_reading.store(true);
   lock.unlock();
@@ -261,6 +343,8 @@ void CDROMAsyncReader::ReadSectorNonThreaded(CDImage::LBA lba)
   Common::Timer timer;
 
   m_buffers.resize(1);
+  m_window_size = 1;
+  m_window_base.store(0);
   m_seek_error.store(false);
   EmptyBuffers();
 
@@ -307,6 +391,8 @@ void CDROMAsyncReader::CancelReadahead()
 
 void CDROMAsyncReader::WorkerThreadEntryPoint()
 {
+  Threading::ApplyThreadPlacement(Threading::ThreadClass::CDROMReader);
+
   std::unique_lock lock(m_mutex);
 
   for (;;)
@@ -320,12 +406,33 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
     {
       if (m_next_position_set.load())
       {
-        // discard buffers, we're seeking to a new location
-        const CDImage::LBA seek_location = m_next_position.load();
-        EmptyBuffers();
+        // switch back to the previous window if it has the sector, otherwise set this one aside and start fresh
+        const CDImage::LBA requested_location = m_next_position.load();
+        CDImage::LBA seek_location = requested_location;
+        const bool restored = RestoreStashedWindow(requested_location, &seek_location);
+        if (restored)
+        {
+          Log_DebugPrintf("Readahead hit for sector %u in previous window", requested_location);
+          m_stat_stash_hits.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+          // running past the end of the buffer is still streaming, anything else is random access
+          const u32 window = m_readahead_window.load();
+          const bool sequential =
+            (m_buffer_count.load() > 0 &&
+             GetWindowSlot(m_window_base.load(), m_buffer_back.load() + m_window_size - 1).lba + 1 ==
+               requested_location);
+          m_readahead_window.store(sequential ? std::min(window * 2, m_window_size) :
+                                                std::max(window / 2, std::min<u32>(MIN_READAHEAD_SECTORS, window)));
+          StashCurrentWindow();
+        }
+
         m_next_position_set.store(false);
         m_seek_error.store(false);
         m_is_reading.store(true);
+        if (restored)
+          m_notify_read_complete_cv.notify_all();
         lock.unlock();
 
         // seek without lock held in case it takes time
@@ -340,7 +447,14 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
           continue;
 
         // did we fail the seek?
-        if (!seek_result)
+        if (!seek_result && restored)
+        {
+          // we still have the requested sector, just can't read past it
+          Log_WarningPrintf("Seek to LBA %u failed", seek_location);
+          m_can_readahead.store(false);
+          break;
+        }
+        else if (!seek_result)
         {
           // add the error result, and don't try to read ahead
           Log_WarningPrintf("Seek to LBA %u failed", seek_location);
@@ -357,8 +471,11 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
         break;
 
       // readahead time! read as many sectors as we have space for
-      Log_DebugPrintf("Reading ahead %u sectors...", static_cast<u32>(m_buffers.size()) - m_buffer_count.load());
-      while (m_buffer_count.load() < static_cast<u32>(m_buffers.size()))
+      const u32 readahead_window = m_readahead_window.load();
+      Log_DebugPrintf("Reading ahead %u sectors...",
+                      readahead_window - std::min(m_buffer_count.load(), readahead_window));
+      m_media->SetReadaheadHint(readahead_window);
+      while (m_buffer_count.load() < m_readahead_window.load())
       {
         if (m_next_position_set.load())
         {
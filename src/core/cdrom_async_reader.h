@@ -21,15 +21,27 @@ public:
     bool result;
   };
 
+  struct ReadaheadStats
+  {
+    u32 hits;
+    u32 misses;
+    u32 stash_hits;
+    u32 window;
+    u32 max_window;
+  };
+
   CDROMAsyncReader();
   ~CDROMAsyncReader();
 
-  CDImage::LBA GetLastReadSector() const { return m_buffers[m_buffer_front.load()].lba; }
-  const SectorBuffer& GetSectorBuffer() const { return m_buffers[m_buffer_front.load()].data; }
-  const CDImage::SubChannelQ& GetSectorSubQ() const { return m_buffers[m_buffer_front.load()].subq; }
+  CDImage::LBA GetLastReadSector() const { return GetFrontSlot().lba; }
+  const SectorBuffer& GetSectorBuffer() const { return GetFrontSlot().data; }
+  const CDImage::SubChannelQ& GetSectorSubQ() const { return GetFrontSlot().subq; }
   u32 GetBufferedSectorCount() const { return m_buffer_count.load(); }
   bool HasBufferedSectors() const { return (m_buffer_count.load() > 0); }
-  u32 GetReadaheadCount() const { return static_cast<u32>(m_buffers.size()); }
+  u32 GetReadaheadCount() const { return m_readahead_count; }
+
+  /// Hit/miss counters for the adaptive readahead, since the thread was started.
+  ReadaheadStats GetReadaheadStats() const;
 
   bool HasMedia() const { return static_cast<bool>(m_media); }
   const CDImage* GetMedia() const { return m_media.get(); }
@@ -54,7 +66,24 @@ public:
   bool ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
 
 private:
+  enum : u32
+  {
+    // The readahead window grows up to this many times the configured readahead when streaming.
+    MAX_READAHEAD_SCALE = 4,
+
+    // Random access shrinks the window down to this many sectors.
+    MIN_READAHEAD_SECTORS = 2,
+  };
+
+  ALWAYS_INLINE const BufferSlot& GetFrontSlot() const
+  {
+    return m_buffers[m_window_base.load() + m_buffer_front.load()];
+  }
+  ALWAYS_INLINE BufferSlot& GetWindowSlot(u32 base, u32 index) { return m_buffers[base + (index % m_window_size)]; }
+
   void EmptyBuffers();
+  bool RestoreStashedWindow(CDImage::LBA lba, CDImage::LBA* next_lba);
+  void StashCurrentWindow();
   bool ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock);
   void ReadSectorNonThreaded(CDImage::LBA lba);
   bool InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
@@ -77,8 +106,22 @@ private:
   std::atomic_bool m_can_readahead{false};
   std::atomic_bool m_seek_error{false};
 
+  // Two windows of m_window_size slots. The current window is at m_window_base, the other holds the window from
+  // before the last seek, so games alternating between two regions of the disc don't lose their readahead.
   std::vector<BufferSlot> m_buffers;
+  u32 m_window_size = 0;
+  std::atomic<u32> m_window_base{0};
   std::atomic<u32> m_buffer_front{0};
   std::atomic<u32> m_buffer_back{0};
   std::atomic<u32> m_buffer_count{0};
+  u32 m_stash_front = 0;
+  u32 m_stash_count = 0;
+
+  u32 m_readahead_count = 0;
+  std::atomic<u32> m_readahead_window{0};
+  u32 m_sequential_hits = 0;
+
+  std::atomic<u32> m_stat_hits{0};
+  std::atomic<u32> m_stat_misses{0};
+  std::atomic<u32> m_stat_stash_hits{0};
 };
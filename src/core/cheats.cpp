@@ -1,18 +1,26 @@
 #include "cheats.h"
 #include "bus.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/byte_stream.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/path.h"
 #include "common/string.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "controller.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
 #include "host.h"
+#include "settings.h"
 #include "system.h"
+#include <algorithm>
+#include <bitset>
 #include <cctype>
+#include <cstring>
 #include <iomanip>
+#include <mutex>
 #include <sstream>
 #include <type_traits>
 Log_SetChannel(Cheats);
@@ -20,6 +28,49 @@ static std::array<u32, 256> cht_register; // Used for D7 ,51 & 52 cheat types
 
 using KeyValuePairVector = std::vector<std::pair<std::string, std::string>>;
 
+namespace CheatPackageCache {
+
+enum : u32
+{
+  CHEAT_PACKAGE_CACHE_SIGNATURE = 0x43544843,
+  CHEAT_PACKAGE_CACHE_VERSION = 1,
+};
+
+// The bundled cheat database is indexed by serial on first use. The cache file is a header, records sorted by
+// serial, and a string pool holding the serials followed by the database text, so looking up a game only touches its
+// own codes.
+struct CacheHeader
+{
+  u32 signature;
+  u32 version;
+  u64 chtdb_ts;
+  u32 num_records;
+  u32 string_pool_size;
+};
+
+struct CacheRecord
+{
+  u32 serial_offset;
+  u32 serial_length;
+  u32 codes_offset;
+  u32 codes_length;
+};
+
+static_assert(sizeof(CacheHeader) == 24 && sizeof(CacheRecord) == 16, "Cache structures are packed");
+
+static std::string GetCacheFile();
+static const CacheHeader* GetCacheHeader();
+static const CacheRecord* GetCacheRecords();
+static std::string_view GetCacheString(u32 offset, u32 length);
+static bool LoadCache(u64 chtdb_ts);
+static bool CreateCache(u64 chtdb_ts);
+static bool FindCodes(const std::string_view& serial, std::string_view* codes);
+
+static std::mutex s_cache_mutex;
+static FileSystem::MappedFile s_cache_file;
+
+} // namespace CheatPackageCache
+
 static bool IsValidScanAddress(PhysicalMemoryAddress address)
 {
   if ((address & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION &&
@@ -199,6 +250,8 @@ bool CheatList::LoadFromPCSXRFile(const char* filename)
 
 bool CheatList::LoadFromPCSXRString(const std::string& str)
 {
+  m_program_dirty = true;
+
   std::istringstream iss(str);
 
   std::string line;
@@ -323,6 +376,8 @@ bool CheatList::LoadFromLibretroFile(const char* filename)
 
 bool CheatList::LoadFromLibretroString(const std::string& str)
 {
+  m_program_dirty = true;
+
   std::istringstream iss(str);
   std::string line;
   KeyValuePairVector kvp;
@@ -417,6 +472,8 @@ bool CheatList::LoadFromLibretroString(const std::string& str)
 
 bool CheatList::LoadFromEPSXeString(const std::string& str)
 {
+  m_program_dirty = true;
+
   std::istringstream iss(str);
 
   std::string line;
@@ -553,16 +610,100 @@ void CheatList::Apply()
   if (!m_master_enable)
     return;
 
-  for (const CheatCode& code : m_codes)
+  if (m_program_dirty)
+    CompileProgram();
+
+  for (const ProgramOp& op : m_program)
+  {
+    switch (op.type)
+    {
+      case ProgramOpType::Write8:
+        DoMemoryWrite<u8>(op.address, Truncate8(op.value));
+        break;
+
+      case ProgramOpType::Write16:
+        DoMemoryWrite<u16>(op.address, Truncate16(op.value));
+        break;
+
+      case ProgramOpType::Write32:
+        DoMemoryWrite<u32>(op.address, op.value);
+        break;
+
+      case ProgramOpType::Interpret:
+        m_codes[op.address].Apply();
+        break;
+    }
+  }
+}
+
+bool CheatList::AppendUnconditionalWrites(const CheatCode& cc, std::vector<ProgramOp>* program)
+{
+  const size_t start_size = program->size();
+  for (const CheatCode::Instruction& inst : cc.instructions)
+  {
+    switch (inst.code)
+    {
+      case CheatCode::InstructionCode::Nop:
+        break;
+
+      case CheatCode::InstructionCode::ConstantWrite8:
+        program->push_back(ProgramOp{inst.address, inst.value8, ProgramOpType::Write8});
+        break;
+
+      case CheatCode::InstructionCode::ConstantWrite16:
+        program->push_back(ProgramOp{inst.address, inst.value16, ProgramOpType::Write16});
+        break;
+
+      case CheatCode::InstructionCode::ExtConstantWrite32:
+        program->push_back(ProgramOp{inst.address, inst.value32, ProgramOpType::Write32});
+        break;
+
+      case CheatCode::InstructionCode::ScratchpadWrite16:
+        program->push_back(ProgramOp{CPU::DCACHE_LOCATION | (inst.address & CPU::DCACHE_OFFSET_MASK), inst.value16,
+                                     ProgramOpType::Write16});
+        break;
+
+      case CheatCode::InstructionCode::ExtScratchpadWrite32:
+        program->push_back(ProgramOp{CPU::DCACHE_LOCATION | (inst.address & CPU::DCACHE_OFFSET_MASK), inst.value32,
+                                     ProgramOpType::Write32});
+        break;
+
+      default:
+      {
+        // needs the interpreter, undo anything we added
+        program->resize(start_size);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+void CheatList::CompileProgram()
+{
+  m_program.clear();
+  m_program_dirty = false;
+
+  u32 interpreted_count = 0;
+  for (u32 i = 0; i < static_cast<u32>(m_codes.size()); i++)
   {
-    if (code.enabled)
-      code.Apply();
+    const CheatCode& cc = m_codes[i];
+    if (!cc.enabled || AppendUnconditionalWrites(cc, &m_program))
+      continue;
+
+    m_program.push_back(ProgramOp{i, 0, ProgramOpType::Interpret});
+    interpreted_count++;
   }
+
+  Log_DevPrintf("Compiled %u enabled cheats into %zu operations (%u interpreted)", GetEnabledCodeCount(),
+                m_program.size(), interpreted_count);
 }
 
 void CheatList::AddCode(CheatCode cc)
 {
   m_codes.push_back(std::move(cc));
+  m_program_dirty = true;
 }
 
 void CheatList::SetCode(u32 index, CheatCode cc)
@@ -570,6 +711,7 @@ void CheatList::SetCode(u32 index, CheatCode cc)
   if (index > m_codes.size())
     return;
 
+  m_program_dirty = true;
   if (index == m_codes.size())
   {
     m_codes.push_back(std::move(cc));
@@ -582,6 +724,7 @@ void CheatList::SetCode(u32 index, CheatCode cc)
 void CheatList::RemoveCode(u32 i)
 {
   m_codes.erase(m_codes.begin() + i);
+  m_program_dirty = true;
 }
 
 std::optional<CheatList::Format> CheatList::DetectFileFormat(const char* filename)
@@ -684,17 +827,189 @@ bool CheatList::SaveToPCSXRFile(const char* filename)
   return (std::ferror(fp.get()) == 0);
 }
 
-bool CheatList::LoadFromPackage(const std::string& serial)
+std::string CheatPackageCache::GetCacheFile()
+{
+  return Path::Combine(EmuFolders::Cache, "chtdb.cache");
+}
+
+const CheatPackageCache::CacheHeader* CheatPackageCache::GetCacheHeader()
 {
-  const std::optional<std::string> db_string(Host::ReadResourceFileToString("chtdb.txt"));
+  return reinterpret_cast<const CacheHeader*>(s_cache_file.GetData());
+}
+
+const CheatPackageCache::CacheRecord* CheatPackageCache::GetCacheRecords()
+{
+  return reinterpret_cast<const CacheRecord*>(s_cache_file.GetData() + sizeof(CacheHeader));
+}
+
+std::string_view CheatPackageCache::GetCacheString(u32 offset, u32 length)
+{
+  const CacheHeader* header = GetCacheHeader();
+  const char* pool = reinterpret_cast<const char*>(s_cache_file.GetData() + sizeof(CacheHeader) +
+                                                   sizeof(CacheRecord) * header->num_records);
+  if ((static_cast<u64>(offset) + length) > header->string_pool_size)
+    return {};
+
+  return std::string_view(pool + offset, length);
+}
+
+bool CheatPackageCache::LoadCache(u64 chtdb_ts)
+{
+  const std::string filename(GetCacheFile());
+  std::FILE* fp = FileSystem::OpenCFile(filename.c_str(), "rb");
+  if (!fp)
+    return false;
+
+  const bool mapped = s_cache_file.Map(fp);
+  std::fclose(fp);
+  if (!mapped)
+    return false;
+
+  const CacheHeader* header = GetCacheHeader();
+  if (s_cache_file.GetSize() < sizeof(CacheHeader) || header->signature != CHEAT_PACKAGE_CACHE_SIGNATURE ||
+      header->version != CHEAT_PACKAGE_CACHE_VERSION || header->chtdb_ts != chtdb_ts ||
+      (sizeof(CacheHeader) + sizeof(CacheRecord) * static_cast<u64>(header->num_records) +
+       header->string_pool_size) != s_cache_file.GetSize())
+  {
+    Log_DevPrintf("Cheat package cache is out of date or corrupted, recreating.");
+    s_cache_file.Unmap();
+    return false;
+  }
+
+  return true;
+}
+
+bool CheatPackageCache::CreateCache(u64 chtdb_ts)
+{
+  std::optional<std::string> db_string(Host::ReadResourceFileToString("chtdb.txt"));
   if (!db_string.has_value())
     return false;
 
-  std::istringstream iss(db_string.value());
+  // Index the line after every game's serial. Parsing starts there and stops at the next game, as it always has, so
+  // codes shared by several consecutive serials still load for each of them. The text itself follows the serials.
+  std::vector<std::pair<std::string_view, u32>> serials;
+  const std::string_view db(db_string.value());
+  for (size_t pos = 0; pos < db.size();)
+  {
+    size_t line_end = db.find('\n', pos);
+    line_end = (line_end == std::string_view::npos) ? db.size() : line_end;
+
+    std::string_view line(db.substr(pos, line_end - pos));
+    pos = line_end + 1;
+
+    while (!line.empty() && std::isspace(SignedCharToInt(line.front())))
+      line.remove_prefix(1);
+    while (!line.empty() && std::isspace(SignedCharToInt(line.back())))
+      line.remove_suffix(1);
+    if (line.size() > 1 && line.front() == ':')
+      serials.emplace_back(line.substr(1), static_cast<u32>(std::min(pos, db.size())));
+  }
+
+  // the first entry for a serial wins, like the linear search
+  std::stable_sort(serials.begin(), serials.end(),
+                   [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  serials.erase(std::unique(serials.begin(), serials.end(),
+                            [](const auto& lhs, const auto& rhs) { return lhs.first == rhs.first; }),
+                serials.end());
+
+  std::string string_pool;
+  std::vector<CacheRecord> records;
+  records.reserve(serials.size());
+  for (const auto& [game_serial, codes_offset] : serials)
+  {
+    CacheRecord& record = records.emplace_back();
+    record.serial_offset = static_cast<u32>(string_pool.size());
+    record.serial_length = static_cast<u32>(game_serial.size());
+    record.codes_offset = codes_offset;
+    string_pool.append(game_serial);
+  }
+
+  const u32 text_offset = static_cast<u32>(string_pool.size());
+  for (CacheRecord& record : records)
+  {
+    record.codes_offset += text_offset;
+    record.codes_length = static_cast<u32>(db.size()) + text_offset - record.codes_offset;
+  }
+  string_pool.append(db);
+
+  CacheHeader header = {};
+  header.signature = CHEAT_PACKAGE_CACHE_SIGNATURE;
+  header.version = CHEAT_PACKAGE_CACHE_VERSION;
+  header.chtdb_ts = chtdb_ts;
+  header.num_records = static_cast<u32>(records.size());
+  header.string_pool_size = static_cast<u32>(string_pool.size());
+
+  std::vector<u8> data(sizeof(header) + sizeof(CacheRecord) * records.size() + string_pool.size());
+  u8* data_ptr = data.data();
+  std::memcpy(data_ptr, &header, sizeof(header));
+  data_ptr += sizeof(header);
+  std::memcpy(data_ptr, records.data(), sizeof(CacheRecord) * records.size());
+  data_ptr += sizeof(CacheRecord) * records.size();
+  std::memcpy(data_ptr, string_pool.data(), string_pool.size());
+
+  // write to a temporary file first, so a crash can't leave a truncated cache behind
+  const std::string filename(GetCacheFile());
+  const std::string temp_filename(filename + ".tmp");
+  if (!FileSystem::WriteBinaryFile(temp_filename.c_str(), data.data(), data.size()) ||
+      !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str()))
+  {
+    Log_ErrorPrintf("Failed to write cheat package cache '%s'", filename.c_str());
+    FileSystem::DeleteFile(temp_filename.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("Indexed %zu games in cheat package", records.size());
+  return true;
+}
+
+bool CheatPackageCache::FindCodes(const std::string_view& serial, std::string_view* codes)
+{
+  std::unique_lock lock(s_cache_mutex);
+  if (!s_cache_file.IsValid())
+  {
+    const u64 chtdb_ts = static_cast<u64>(Host::GetResourceFileTimestamp("chtdb.txt").value_or(0));
+    if (!LoadCache(chtdb_ts) && (!CreateCache(chtdb_ts) || !LoadCache(chtdb_ts)))
+      return false;
+  }
+
+  const CacheRecord* records = GetCacheRecords();
+  const CacheRecord* records_end = records + GetCacheHeader()->num_records;
+  const CacheRecord* record =
+    std::lower_bound(records, records_end, serial, [](const CacheRecord& record, const std::string_view& serial) {
+      return GetCacheString(record.serial_offset, record.serial_length) < serial;
+    });
+  if (record == records_end || GetCacheString(record->serial_offset, record->serial_length) != serial)
+    return false;
+
+  // the view runs to the end of the database, the parser stops at the next game, and the mapping is never released
+  *codes = GetCacheString(record->codes_offset, record->codes_length);
+  return true;
+}
+
+bool CheatList::LoadFromPackage(const std::string& serial)
+{
+  m_program_dirty = true;
+
+  std::string_view codes;
+  if (!CheatPackageCache::FindCodes(serial, &codes))
+  {
+    Log_WarningPrintf("No codes found in package for %s", serial.c_str());
+    return false;
+  }
+
   std::string line;
-  while (std::getline(iss, line))
+  char* start;
+  char* end;
+  CheatCode current_code;
+  for (size_t pos = 0; pos < codes.size();)
   {
-    char* start = line.data();
+    // copied a line at a time, since the parsing below modifies it
+    size_t line_end = codes.find('\n', pos);
+    line_end = (line_end == std::string_view::npos) ? codes.size() : line_end;
+    line.assign(codes.substr(pos, line_end - pos));
+    pos = line_end + 1;
+
+    start = line.data();
     while (*start != '\0' && std::isspace(SignedCharToInt(*start)))
       start++;
 
@@ -702,7 +1017,7 @@ bool CheatList::LoadFromPackage(const std::string& serial)
     if (*start == '\0' || *start == ';')
       continue;
 
-    char* end = start + std::strlen(start) - 1;
+    end = start + std::strlen(start) - 1;
     while (end > start && std::isspace(SignedCharToInt(*end)))
     {
       *end = '\0';
@@ -712,88 +1027,59 @@ bool CheatList::LoadFromPackage(const std::string& serial)
     if (start == end)
       continue;
 
-    if (start[0] != ':' || std::strcmp(&start[1], serial.c_str()) != 0)
-      continue;
+    // stop adding codes when we hit a different game
+    if (start[0] == ':' && (!m_codes.empty() || current_code.Valid()))
+      break;
 
-    // game code match
-    CheatCode current_code;
-    while (std::getline(iss, line))
+    if (start[0] == '#')
     {
-      start = line.data();
-      while (*start != '\0' && std::isspace(SignedCharToInt(*start)))
-        start++;
-
-      // skip empty lines
-      if (*start == '\0' || *start == ';')
-        continue;
+      start++;
 
-      end = start + std::strlen(start) - 1;
-      while (end > start && std::isspace(SignedCharToInt(*end)))
+      if (current_code.Valid())
       {
-        *end = '\0';
-        end--;
+        m_codes.push_back(std::move(current_code));
+        current_code = CheatCode();
       }
 
-      if (start == end)
-        continue;
-
-      // stop adding codes when we hit a different game
-      if (start[0] == ':' && (!m_codes.empty() || current_code.Valid()))
-        break;
-
-      if (start[0] == '#')
+      // new code
+      char* slash = std::strrchr(start, '\\');
+      if (slash)
       {
-        start++;
-
-        if (current_code.Valid())
-        {
-          m_codes.push_back(std::move(current_code));
-          current_code = CheatCode();
-        }
-
-        // new code
-        char* slash = std::strrchr(start, '\\');
-        if (slash)
-        {
-          *slash = '\0';
-          current_code.group = start;
-          start = slash + 1;
-        }
-        if (current_code.group.empty())
-          current_code.group = "Ungrouped";
-
-        current_code.description = start;
-        continue;
+        *slash = '\0';
+        current_code.group = start;
+        start = slash + 1;
       }
+      if (current_code.group.empty())
+        current_code.group = "Ungrouped";
 
-      while (!IsHexCharacter(*start) && start != end)
-        start++;
-      if (start == end)
-        continue;
-
-      char* end_ptr;
-      CheatCode::Instruction inst;
-      inst.first = static_cast<u32>(std::strtoul(start, &end_ptr, 16));
-      inst.second = 0;
-      if (end_ptr)
-      {
-        while (!IsHexCharacter(*end_ptr) && end_ptr != end)
-          end_ptr++;
-        if (end_ptr != end)
-          inst.second = static_cast<u32>(std::strtoul(end_ptr, nullptr, 16));
-      }
-      current_code.instructions.push_back(inst);
+      current_code.description = start;
+      continue;
     }
 
-    if (current_code.Valid())
-      m_codes.push_back(std::move(current_code));
+    while (!IsHexCharacter(*start) && start != end)
+      start++;
+    if (start == end)
+      continue;
 
-    Log_InfoPrintf("Loaded %zu codes from package for %s", m_codes.size(), serial.c_str());
-    return !m_codes.empty();
+    char* end_ptr;
+    CheatCode::Instruction inst;
+    inst.first = static_cast<u32>(std::strtoul(start, &end_ptr, 16));
+    inst.second = 0;
+    if (end_ptr)
+    {
+      while (!IsHexCharacter(*end_ptr) && end_ptr != end)
+        end_ptr++;
+      if (end_ptr != end)
+        inst.second = static_cast<u32>(std::strtoul(end_ptr, nullptr, 16));
+    }
+    current_code.instructions.push_back(inst);
   }
 
-  Log_WarningPrintf("No codes found in package for %s", serial.c_str());
-  return false;
+  if (current_code.Valid())
+    m_codes.push_back(std::move(current_code));
+
+  Log_InfoPrintf("Loaded %zu codes from package for %s", m_codes.size(), serial.c_str());
+  return !m_codes.empty();
 }
 
 u32 CheatList::GetEnabledCodeCount() const
@@ -828,6 +1114,7 @@ void CheatList::SetCodeEnabled(u32 index, bool state)
     return;
 
   m_codes[index].enabled = state;
+  m_program_dirty = true;
   if (!state)
     m_codes[index].ApplyOnDisable();
 }
@@ -2821,6 +3108,139 @@ void MemoryScan::ResetSearch()
   m_results.clear();
 }
 
+namespace {
+// RAM is scanned in blocks of this many values, producing one bit per value.
+static constexpr u32 SCAN_BLOCK_SIZE = 64;
+static constexpr u32 SCAN_MIN_BLOCKS_PER_JOB = 1024;
+static constexpr u32 SCAN_MAX_JOBS = 8;
+
+template<typename T, typename C, MemoryScan::Operator Op>
+ALWAYS_INLINE static u64 ScanRAMBlock(const u8* ptr, C comp_value)
+{
+  T values[SCAN_BLOCK_SIZE];
+  std::memcpy(values, ptr, sizeof(values));
+
+  // Branch-free so the compiler can vectorize the comparison.
+  u64 mask = 0;
+  for (u32 i = 0; i < SCAN_BLOCK_SIZE; i++)
+  {
+    const C value = static_cast<C>(values[i]);
+    bool match;
+    if constexpr (Op == MemoryScan::Operator::Equal)
+      match = (value == comp_value);
+    else if constexpr (Op == MemoryScan::Operator::NotEqual)
+      match = (value != comp_value);
+    else if constexpr (Op == MemoryScan::Operator::GreaterThan)
+      match = (value > comp_value);
+    else if constexpr (Op == MemoryScan::Operator::GreaterEqual)
+      match = (value >= comp_value);
+    else if constexpr (Op == MemoryScan::Operator::LessThan)
+      match = (value < comp_value);
+    else // if constexpr (Op == MemoryScan::Operator::LessEqual)
+      match = (value <= comp_value);
+
+    mask |= static_cast<u64>(match) << i;
+  }
+
+  return mask;
+}
+
+template<typename T, typename C, MemoryScan::Operator Op>
+static void ScanRAMBlocks(const u8* ptr, u32 num_blocks, C comp_value, u64* bitmap)
+{
+  for (u32 i = 0; i < num_blocks; i++)
+  {
+    bitmap[i] = ScanRAMBlock<T, C, Op>(ptr, comp_value);
+    ptr += sizeof(T) * SCAN_BLOCK_SIZE;
+  }
+}
+
+template<typename T, typename C>
+static void ScanRAMBlocks(MemoryScan::Operator op, const u8* ptr, u32 num_blocks, C comp_value, u64* bitmap)
+{
+  switch (op)
+  {
+    case MemoryScan::Operator::Equal:
+      ScanRAMBlocks<T, C, MemoryScan::Operator::Equal>(ptr, num_blocks, comp_value, bitmap);
+      break;
+    case MemoryScan::Operator::NotEqual:
+      ScanRAMBlocks<T, C, MemoryScan::Operator::NotEqual>(ptr, num_blocks, comp_value, bitmap);
+      break;
+    case MemoryScan::Operator::GreaterThan:
+      ScanRAMBlocks<T, C, MemoryScan::Operator::GreaterThan>(ptr, num_blocks, comp_value, bitmap);
+      break;
+    case MemoryScan::Operator::GreaterEqual:
+      ScanRAMBlocks<T, C, MemoryScan::Operator::GreaterEqual>(ptr, num_blocks, comp_value, bitmap);
+      break;
+    case MemoryScan::Operator::LessThan:
+      ScanRAMBlocks<T, C, MemoryScan::Operator::LessThan>(ptr, num_blocks, comp_value, bitmap);
+      break;
+    case MemoryScan::Operator::LessEqual:
+      ScanRAMBlocks<T, C, MemoryScan::Operator::LessEqual>(ptr, num_blocks, comp_value, bitmap);
+      break;
+
+    default:
+    {
+      // On the first search, the value and last value are the same, so the remaining operators don't depend on
+      // the contents of memory.
+      const MemoryScan::Result res = {};
+      const u64 mask = res.Filter(op, static_cast<u32>(comp_value), std::is_signed_v<C>) ? ~u64(0) : 0;
+      std::fill_n(bitmap, num_blocks, mask);
+    }
+    break;
+  }
+}
+
+template<typename T, typename C>
+static void ScanRAMBlocksParallel(MemoryScan::Operator op, const u8* ptr, u32 num_blocks, C comp_value,
+                                  u64* bitmap)
+{
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  const u32 num_jobs = std::clamp(std::min(pool.GetThreadCount() + 1, SCAN_MAX_JOBS), 1u,
+                                  std::max(num_blocks / SCAN_MIN_BLOCKS_PER_JOB, 1u));
+  if (num_jobs == 1)
+  {
+    ScanRAMBlocks<T, C>(op, ptr, num_blocks, comp_value, bitmap);
+    return;
+  }
+
+  // Each job writes a disjoint part of the bitmap, so no synchronization is needed beyond the wait.
+  const u32 blocks_per_job = (num_blocks + num_jobs - 1) / num_jobs;
+  Threading::ThreadPool::TaskGroup group;
+  for (u32 i = 1; i < num_jobs; i++)
+  {
+    const u32 first_block = i * blocks_per_job;
+    if (first_block >= num_blocks)
+      break;
+
+    const u32 count = std::min(blocks_per_job, num_blocks - first_block);
+    const u8* job_ptr = ptr + (first_block * sizeof(T) * SCAN_BLOCK_SIZE);
+    u64* job_bitmap = bitmap + first_block;
+    pool.Submit([op, job_ptr, count, comp_value,
+                 job_bitmap]() { ScanRAMBlocks<T, C>(op, job_ptr, count, comp_value, job_bitmap); },
+                Threading::ThreadPool::Priority::High, &group);
+  }
+
+  ScanRAMBlocks<T, C>(op, ptr, std::min(blocks_per_job, num_blocks), comp_value, bitmap);
+  group.Wait(pool);
+}
+
+template<typename T>
+static u32 ReadScanValue(PhysicalMemoryAddress address, bool is_signed)
+{
+  T value;
+  if ((address % sizeof(T)) == 0 && address < Bus::g_ram_size)
+    std::memcpy(&value, &Bus::g_ram[address], sizeof(value));
+  else
+    value = DoMemoryRead<T>(address);
+
+  if constexpr (sizeof(T) == sizeof(u32))
+    return value;
+  else
+    return is_signed ? SignExtend32(value) : ZeroExtend32(value);
+}
+} // namespace
+
 void MemoryScan::Search()
 {
   m_results.clear();
@@ -2828,15 +3248,15 @@ void MemoryScan::Search()
   switch (m_size)
   {
     case MemoryAccessSize::Byte:
-      SearchBytes();
+      SearchType<u8>();
       break;
 
     case MemoryAccessSize::HalfWord:
-      SearchHalfwords();
+      SearchType<u16>();
       break;
 
     case MemoryAccessSize::Word:
-      SearchWords();
+      SearchType<u32>();
       break;
 
     default:
@@ -2844,56 +3264,61 @@ void MemoryScan::Search()
   }
 }
 
-void MemoryScan::SearchBytes()
+template<typename T>
+void MemoryScan::SearchType()
 {
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address++)
-  {
-    if (!IsValidScanAddress(address))
-      continue;
+  PhysicalMemoryAddress address = m_start_address;
 
-    const u8 bvalue = DoMemoryRead<u8>(address);
-
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.value_changed = false;
-
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
-  }
-}
-
-void MemoryScan::SearchHalfwords()
-{
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 2)
+  // Whole blocks which lie within RAM are compared directly from the RAM buffer.
+  if ((address % sizeof(T)) == 0 && address < Bus::g_ram_size && address < m_end_address)
   {
-    if (!IsValidScanAddress(address))
-      continue;
+    const u32 ram_end = std::min(m_end_address, Bus::g_ram_size);
+    const u32 num_blocks = ((ram_end - address) / sizeof(T)) / SCAN_BLOCK_SIZE;
+    if (num_blocks > 0)
+    {
+      using ST = std::make_signed_t<T>;
+      std::vector<u64> bitmap(num_blocks);
+      if (m_signed)
+      {
+        ScanRAMBlocksParallel<ST, s32>(m_operator, &Bus::g_ram[address], num_blocks, static_cast<s32>(m_value),
+                                       bitmap.data());
+      }
+      else
+      {
+        ScanRAMBlocksParallel<T, u32>(m_operator, &Bus::g_ram[address], num_blocks, m_value, bitmap.data());
+      }
 
-    const u16 bvalue = DoMemoryRead<u16>(address);
+      u32 num_matches = 0;
+      for (const u64 mask : bitmap)
+        num_matches += static_cast<u32>(std::bitset<64>(mask).count());
+      m_results.reserve(num_matches);
 
-    Result res;
-    res.address = address;
-    res.value = m_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    res.last_value = res.value;
-    res.value_changed = false;
+      for (u32 block = 0; block < num_blocks; block++)
+      {
+        const PhysicalMemoryAddress block_address = address + (block * sizeof(T) * SCAN_BLOCK_SIZE);
+        for (u64 mask = bitmap[block]; mask != 0; mask &= (mask - 1))
+        {
+          Result res;
+          res.address = block_address + (CountTrailingZeros(mask) * sizeof(T));
+          res.value = ReadScanValue<T>(res.address, m_signed);
+          res.last_value = res.value;
+          res.value_changed = false;
+          m_results.push_back(res);
+        }
+      }
 
-    if (res.Filter(m_operator, m_value, m_signed))
-      m_results.push_back(res);
+      address += num_blocks * sizeof(T) * SCAN_BLOCK_SIZE;
+    }
   }
-}
 
-void MemoryScan::SearchWords()
-{
-  for (PhysicalMemoryAddress address = m_start_address; address < m_end_address; address += 4)
+  for (; address < m_end_address; address += sizeof(T))
   {
     if (!IsValidScanAddress(address))
       continue;
 
     Result res;
     res.address = address;
-    res.value = DoMemoryRead<u32>(address);
+    res.value = ReadScanValue<T>(address, m_signed);
     res.last_value = res.value;
     res.value_changed = false;
 
@@ -2904,20 +3329,16 @@ void MemoryScan::SearchWords()
 
 void MemoryScan::SearchAgain()
 {
-  ResultVector new_results;
-  new_results.reserve(m_results.size());
-  for (Result& res : m_results)
-  {
+  // Filter in place, so we don't need to allocate a new vector for each search.
+  const auto new_end = std::remove_if(m_results.begin(), m_results.end(), [this](Result& res) {
     res.UpdateValue(m_size, m_signed);
+    if (!res.Filter(m_operator, m_value, m_signed))
+      return true;
 
-    if (res.Filter(m_operator, m_value, m_signed))
-    {
-      res.last_value = res.value;
-      new_results.push_back(res);
-    }
-  }
-
-  m_results.swap(new_results);
+    res.last_value = res.value;
+    return false;
+  });
+  m_results.erase(new_end, m_results.end());
 }
 
 void MemoryScan::UpdateResultsValues()
@@ -3053,24 +3474,16 @@ void MemoryScan::Result::UpdateValue(MemoryAccessSize size, bool is_signed)
   switch (size)
   {
     case MemoryAccessSize::Byte:
-    {
-      u8 bvalue = DoMemoryRead<u8>(address);
-      value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    }
-    break;
+      value = ReadScanValue<u8>(address, is_signed);
+      break;
 
     case MemoryAccessSize::HalfWord:
-    {
-      u16 bvalue = DoMemoryRead<u16>(address);
-      value = is_signed ? SignExtend32(bvalue) : ZeroExtend32(bvalue);
-    }
-    break;
+      value = ReadScanValue<u16>(address, is_signed);
+      break;
 
     case MemoryAccessSize::Word:
-    {
-      CPU::SafeReadMemoryWord(address, &value);
-    }
-    break;
+      value = ReadScanValue<u32>(address, is_signed);
+      break;
   }
 
   value_changed = (value != old_value);
@@ -148,7 +148,12 @@ public:
   ~CheatList();
 
   ALWAYS_INLINE const CheatCode& GetCode(u32 i) const { return m_codes[i]; }
-  ALWAYS_INLINE CheatCode& GetCode(u32 i) { return m_codes[i]; }
+  ALWAYS_INLINE CheatCode& GetCode(u32 i)
+  {
+    // caller could change anything about the code
+    m_program_dirty = true;
+    return m_codes[i];
+  }
   ALWAYS_INLINE u32 GetCodeCount() const { return static_cast<u32>(m_codes.size()); }
   ALWAYS_INLINE bool IsCodeEnabled(u32 index) const { return m_codes[index].enabled; }
 
@@ -192,8 +197,30 @@ public:
   void MergeList(const CheatList& cl);
 
 private:
+  // Enabled codes are flattened into a list of operations when the list changes. Codes which are nothing but
+  // unconditional writes are expanded inline, anything with conditions or state falls back to the interpreter.
+  enum class ProgramOpType : u8
+  {
+    Write8,
+    Write16,
+    Write32,
+    Interpret,
+  };
+
+  struct ProgramOp
+  {
+    u32 address; // code index for Interpret
+    u32 value;
+    ProgramOpType type;
+  };
+
+  static bool AppendUnconditionalWrites(const CheatCode& cc, std::vector<ProgramOp>* program);
+  void CompileProgram();
+
   std::vector<CheatCode> m_codes;
+  std::vector<ProgramOp> m_program;
   bool m_master_enable = true;
+  bool m_program_dirty = true;
 };
 
 class MemoryScan
@@ -260,9 +287,8 @@ public:
   void SetResultValue(u32 index, u32 value);
 
 private:
-  void SearchBytes();
-  void SearchHalfwords();
-  void SearchWords();
+  template<typename T>
+  void SearchType();
 
   u32 m_value = 0;
   MemoryAccessSize m_size = MemoryAccessSize::HalfWord;
@@ -1,13 +1,32 @@
 #include "cpu_code_cache.h"
 #include "bus.h"
+#include "common/align.h"
+#include "common/allocation_profiler.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
+#include "common/file_system.h"
 #include "common/log.h"
+#include "common/scoped_guard.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "settings.h"
 #include "system.h"
 #include "timing_event.h"
+#include "util/memory_arena.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
 Log_SetChannel(CPU::CodeCache);
 
 #ifdef WITH_RECOMPILER
@@ -23,6 +42,54 @@ static constexpr u32 RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER = 100;
 static constexpr u32 RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER = 20;
 static constexpr u32 INVALIDATE_THRESHOLD_TO_DISABLE_LINKING = 10;
 
+// Block profiles are capped so a long session can't grow the file without bound.
+static constexpr u32 BLOCK_PROFILE_MAGIC = 0x50425344; // DSBP
+static constexpr u32 BLOCK_PROFILE_VERSION = 1;
+static constexpr u32 MAX_BLOCK_PROFILE_ENTRIES = 65536;
+
+// Block sets carry the guest code itself, so they can be recompiled without the game.
+static constexpr u32 BLOCK_SET_MAGIC = 0x42525344; // DSRB
+static constexpr u32 BLOCK_SET_VERSION = 1;
+
+// Blocks which were rewritten more than this are self-modifying, precompiling them is a waste of time.
+static constexpr u32 MAX_BLOCK_PROFILE_RECOMPILE_COUNT = 4;
+
+// Upper bound on the time spent precompiling between frames, and the number of entries checked per frame.
+static constexpr float BLOCK_PROFILE_PRECOMPILE_TIME_BUDGET_MS = 1.0f;
+static constexpr u32 BLOCK_PROFILE_CHECKS_PER_FRAME = 4096;
+
+// Blocks are extended through their final branch when it executed at least this many times since the last scan,
+// and fell through at least 7/8ths of the time.
+static constexpr u32 TRACE_SCAN_INTERVAL_FRAMES = 16;
+static constexpr u32 TRACE_HOT_BRANCH_COUNT = 256;
+static constexpr u32 MAX_TRACE_BRANCHES = 4;
+static constexpr u32 MAX_TRACE_INSTRUCTIONS = 128;
+
+// Blocks are counted for this many frames before the hottest ones are laid out together, and again after each pass.
+static constexpr u32 HOT_LAYOUT_INTERVAL_FRAMES = 300;
+static constexpr u32 HOT_LAYOUT_MIN_EXECUTIONS = 10000;
+
+// Kernel memory routines which can be performed natively, called through the A0 stub with the function in t1.
+static constexpr u32 BIOS_A0_ENTRY_ADDRESS = 0xA0;
+static constexpr u32 BIOS_A0_TABLE_ADDRESS = 0x200;
+static constexpr u32 BIOS_A0_TABLE_SIZE = 0xC0;
+static constexpr u32 BIOS_A0_STRCPY = 0x19;
+static constexpr u32 BIOS_A0_STRLEN = 0x1B;
+static constexpr u32 BIOS_A0_BZERO = 0x28;
+static constexpr u32 BIOS_A0_MEMCPY = 0x2A;
+static constexpr u32 BIOS_A0_MEMSET = 0x2B;
+
+// Instruction counts of the kernel's implementations, used to charge the time they would have taken.
+static constexpr u32 BIOS_HLE_CALL_INSTRUCTIONS = 16;
+static constexpr u32 BIOS_HLE_STRCPY_INSTRUCTIONS_PER_BYTE = 6;
+static constexpr u32 BIOS_HLE_STRLEN_INSTRUCTIONS_PER_BYTE = 4;
+static constexpr u32 BIOS_HLE_MEMSET_INSTRUCTIONS_PER_BYTE = 4;
+static constexpr u32 BIOS_HLE_MEMCPY_INSTRUCTIONS_PER_BYTE = 6;
+
+// Code pages are split into 64 lines, so writes to lines without code can skip looking at the page's blocks.
+static constexpr u32 CODE_LINES_PER_PAGE = 64;
+static constexpr u32 CODE_LINE_SIZE = CODE_PAGE_SIZE / CODE_LINES_PER_PAGE;
+
 #ifdef WITH_RECOMPILER
 
 // Currently remapping the code buffer doesn't work in macOS or Haiku.
@@ -30,6 +97,18 @@ static constexpr u32 INVALIDATE_THRESHOLD_TO_DISABLE_LINKING = 10;
 #define USE_STATIC_CODE_BUFFER 1
 #endif
 
+// Async compilation needs its buffer next to the main one so blocks can branch between them.
+// AArch32's branch range is too short for the extra space.
+#if defined(USE_STATIC_CODE_BUFFER) && !defined(CPU_AARCH32)
+#define USE_ASYNC_COMPILATION 1
+#endif
+
+// perf picks up symbols for anonymous executable memory from /tmp/perf-<pid>.map.
+#ifdef __linux__
+#define USE_PERF_MAP 1
+#include <unistd.h>
+#endif
+
 #if defined(CPU_AARCH32)
 // Use a smaller code buffer size on AArch32 to have a better chance of being in range.
 static constexpr u32 RECOMPILER_CODE_CACHE_SIZE = 16 * 1024 * 1024;
@@ -40,13 +119,50 @@ static constexpr u32 RECOMPILER_FAR_CODE_CACHE_SIZE = 16 * 1024 * 1024;
 #endif
 static constexpr u32 CODE_WRITE_FAULT_THRESHOLD_FOR_SLOWMEM = 10;
 
+#ifdef USE_ASYNC_COMPILATION
+static constexpr u32 RECOMPILER_ASYNC_CODE_CACHE_SIZE = 16 * 1024 * 1024;
+static constexpr u32 RECOMPILER_ASYNC_FAR_CODE_CACHE_SIZE = 8 * 1024 * 1024;
+#else
+static constexpr u32 RECOMPILER_ASYNC_CODE_CACHE_SIZE = 0;
+static constexpr u32 RECOMPILER_ASYNC_FAR_CODE_CACHE_SIZE = 0;
+#endif
+
 #ifdef USE_STATIC_CODE_BUFFER
+// Block code is split into regions, which are evicted oldest-first when the current one fills up, instead of
+// flushing everything. The dispatchers live in their own region at the start of the storage, and never get evicted.
+static constexpr u32 RECOMPILER_CODE_REGION_COUNT = 4;
+static constexpr u32 RECOMPILER_CODE_REGION_SIZE = RECOMPILER_CODE_CACHE_SIZE / RECOMPILER_CODE_REGION_COUNT;
+static constexpr u32 RECOMPILER_FAR_CODE_REGION_SIZE = RECOMPILER_FAR_CODE_CACHE_SIZE / RECOMPILER_CODE_REGION_COUNT;
+static constexpr u32 RECOMPILER_DISPATCHER_CODE_SIZE = 64 * 1024;
+static constexpr u32 RECOMPILER_DISPATCHER_FAR_CODE_SIZE = 16 * 1024;
 static constexpr u32 RECOMPILER_GUARD_SIZE = 4096;
+static constexpr u32 RECOMPILER_DISPATCHER_STORAGE_SIZE =
+  RECOMPILER_DISPATCHER_CODE_SIZE + RECOMPILER_DISPATCHER_FAR_CODE_SIZE;
+static constexpr u32 RECOMPILER_REGION_STORAGE_SIZE = RECOMPILER_CODE_REGION_SIZE + RECOMPILER_FAR_CODE_REGION_SIZE;
+// The hottest blocks get recompiled next to each other in a region which isn't evicted, so they share i-cache lines and
+// TLB entries instead of being scattered through the regions in compile order.
+static constexpr u32 RECOMPILER_HOT_CODE_SIZE = RECOMPILER_CODE_REGION_SIZE / 4;
+static constexpr u32 RECOMPILER_HOT_FAR_CODE_SIZE = RECOMPILER_FAR_CODE_REGION_SIZE / 4;
+static constexpr u32 RECOMPILER_HOT_STORAGE_SIZE = RECOMPILER_HOT_CODE_SIZE + RECOMPILER_HOT_FAR_CODE_SIZE;
+static constexpr u32 RECOMPILER_STORAGE_SIZE = RECOMPILER_DISPATCHER_STORAGE_SIZE + RECOMPILER_HOT_STORAGE_SIZE +
+                                               RECOMPILER_REGION_STORAGE_SIZE * RECOMPILER_CODE_REGION_COUNT;
+static constexpr u32 RECOMPILER_ASYNC_STORAGE_SIZE =
+  RECOMPILER_ASYNC_CODE_CACHE_SIZE + RECOMPILER_ASYNC_FAR_CODE_CACHE_SIZE;
 alignas(Recompiler::CODE_STORAGE_ALIGNMENT) static u8
-  s_code_storage[RECOMPILER_CODE_CACHE_SIZE + RECOMPILER_FAR_CODE_CACHE_SIZE];
+  s_code_storage[RECOMPILER_STORAGE_SIZE + RECOMPILER_ASYNC_STORAGE_SIZE];
 #endif
 
 static JitCodeBuffer s_code_buffer;
+#ifdef USE_STATIC_CODE_BUFFER
+static std::array<JitCodeBuffer, RECOMPILER_CODE_REGION_COUNT> s_code_regions;
+static u32 s_current_code_region = 0;
+static u32 s_code_region_evictions = 0;
+static u32 s_evicted_block_count = 0;
+static std::vector<CodeBlock*> s_evict_scratch;
+static JitCodeBuffer s_hot_code_region;
+static std::vector<CodeBlock*> s_hot_layout_scratch;
+static bool s_compiling_hot_blocks = false;
+#endif
 static FastMapTable s_fast_map[FAST_MAP_TABLE_COUNT];
 static std::unique_ptr<CodeBlock::HostCodePointer[]> s_fast_map_pointers;
 
@@ -78,6 +194,19 @@ static CodeBlock::HostCodePointer* OffsetFastMapPointer(FastMapTable fake_ptr, u
     return reinterpret_cast<CodeBlock::HostCodePointer*>(fake_byte_ptr + pc);
 }
 
+#ifdef USE_PERF_MAP
+static void UpdatePerfMap();
+static void ClosePerfMap();
+static void WritePerfMapEntry(const void* code, u32 code_size, const char* name);
+static std::FILE* s_perf_map_file = nullptr;
+#endif
+
+static bool InitializeCodeBuffers();
+static void DestroyCodeBuffers();
+static JitCodeBuffer& GetBlockCodeBuffer();
+#ifdef USE_STATIC_CODE_BUFFER
+static void EvictOldestCodeRegion();
+#endif
 static void CompileDispatcher();
 static void FastCompileBlockFunction();
 static void InvalidCodeFunction();
@@ -180,8 +309,9 @@ static void SetFastMap(u32 pc, CodeBlock::HostCodePointer function)
   const FastMapTable table_ptr = DecodeFastMapPointer(slot, encoded_ptr);
   Assert(table_ptr != nullptr && table_ptr != s_fast_map_pointers.get());
 
+  // Blocks which are still being compiled in the background go through the compile function.
   CodeBlock::HostCodePointer* ptr = OffsetFastMapPointer(encoded_ptr, pc);
-  *ptr = function;
+  *ptr = function ? function : FastCompileBlockFunction;
 }
 
 #endif
@@ -202,6 +332,14 @@ static CodeBlock* LookupBlock(CodeBlockKey key, bool allow_flush);
 static bool RevalidateBlock(CodeBlock* block, bool allow_flush);
 
 static bool CompileBlock(CodeBlock* block, bool allow_flush);
+static bool CanExtendTraceThroughBranch(const CodeBlock* block, const CodeBlockInstruction& cbi);
+static bool IsIdleLoopBlock(const CodeBlock* block);
+static void ComputeRegisterLiveness(CodeBlock* block);
+static bool SkipIdleLoop(const CodeBlock* block);
+static bool IsBIOSHLEBlock(const CodeBlock* block);
+static bool HLEBIOSCall();
+static bool HaveBlockBreakpointsChanged(const CodeBlock* block);
+static void ResetIndirectBranchCache(CodeBlock* block);
 static void RemoveReferencesToBlock(CodeBlock* block);
 static void AddBlockToPageMap(CodeBlock* block);
 static void RemoveBlockFromPageMap(CodeBlock* block);
@@ -216,6 +354,49 @@ static void ClearState();
 
 static BlockMap s_blocks;
 static std::array<std::vector<CodeBlock*>, Bus::RAM_8MB_CODE_PAGE_COUNT> m_ram_block_map;
+static std::array<u64, Bus::RAM_8MB_CODE_PAGE_COUNT> s_ram_code_line_masks;
+static std::vector<CodeBlock*> s_invalidate_scratch;
+
+static u64 GetCodeLineMask(u32 page_index, u32 start_address, u32 end_address);
+static void UpdatePageCodeState(u32 page_index);
+
+static u32 s_recompile_count = 0;
+static u32 s_flush_count = 0;
+
+using ExecuteFunction = void (*)();
+
+// Whether the running cached interpreter loop checks block breakpoints.
+static bool s_execute_breakpoints = false;
+
+#pragma pack(push, 1)
+struct BlockProfileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 num_entries;
+};
+
+struct BlockProfileEntry
+{
+  u32 key;
+  u32 instruction_count;
+  u64 instruction_hash;
+  u32 recompile_count;
+};
+#pragma pack(pop)
+
+static bool HashBlockCode(u32 pc, u32 instruction_count, u64* hash);
+static bool GetBlockProfileEntry(const CodeBlock* block, BlockProfileEntry* entry);
+static bool HasSpaceForPrecompiledBlocks();
+
+static std::string s_block_profile_path;
+static std::vector<BlockProfileEntry> s_block_profile_pending;
+static std::vector<bool> s_block_profile_pending_stale; // code didn't match when checked, parallel to the above
+static std::vector<u32> s_block_profile_scratch;
+static u32 s_block_profile_cursor = 0;
+static bool s_block_profile_precompile_active = false;
+
+static std::vector<u32> s_hot_trace_keys;
 
 #ifdef WITH_RECOMPILER
 static HostCodeMap s_host_code_map;
@@ -223,6 +404,96 @@ static HostCodeMap s_host_code_map;
 static void AddBlockToHostCodeMap(CodeBlock* block);
 static void RemoveBlockFromHostCodeMap(CodeBlock* block);
 
+// Sorted guest PCs of loads/stores which were backpatched to slowmem. Kept across invalidation and flushes, so
+// recompiled blocks don't have to fault on the same MMIO accesses again.
+static std::vector<u32> s_slowmem_guest_pcs;
+
+// PCs recorded by the fault handler, which can't allocate. Merged into the list above before the next compile.
+// Any which don't fit are dropped, which only costs another backpatch after the block is recompiled.
+static constexpr u32 MAX_PENDING_SLOWMEM_GUEST_PCS = 64;
+static std::array<u32, MAX_PENDING_SLOWMEM_GUEST_PCS> s_pending_slowmem_guest_pcs;
+static u32 s_pending_slowmem_guest_pc_count = 0;
+
+static bool IsSlowmemGuestPC(u32 pc);
+static void AddSlowmemGuestPC(u32 pc);
+static void MergePendingSlowmemGuestPCs();
+
+struct BlockCompileStatistics
+{
+  u32 key;
+  u32 guest_instructions;
+  u32 host_code_size;
+  u32 far_code_size;
+  u32 spill_count;
+  u32 fastmem_sites;
+  u32 backpatch_count;
+};
+
+#pragma pack(push, 1)
+struct BlockSetHeader
+{
+  u32 magic;
+  u32 version;
+  u32 num_blocks;
+  u32 num_slowmem_pcs;
+};
+
+struct BlockSetEntry
+{
+  u32 key;
+  u32 instruction_count;
+};
+#pragma pack(pop)
+
+// One entry per successful compile, so recompiled blocks show up more than once.
+static std::vector<BlockCompileStatistics> s_compile_statistics;
+
+static void RecordCompileStatistics(CodeBlock* block, u32 far_code_size, u32 spill_count);
+static void RecordBackpatch(const CodeBlock* block);
+
+#ifdef USE_ASYNC_COMPILATION
+struct AsyncCompileJob
+{
+  // Pending block in s_blocks. Only compared against, it may have been freed by the time the job completes.
+  CodeBlock* source;
+
+  // Copy of the block which the host code is generated for, replaces the source when published.
+  std::unique_ptr<CodeBlock> block;
+
+  u32 reserved_code_space;
+  u32 reserved_far_code_space;
+  u32 used_code_space;
+  u32 used_far_code_space;
+  u32 spill_count;
+  bool result;
+};
+
+static bool StartAsyncCompileThread();
+static void StopAsyncCompileThread();
+static void ResetAsyncCompilation();
+static bool QueueAsyncCompile(CodeBlock* block);
+static void PublishAsyncCompiledBlocks();
+static void InterpretPendingBlock(const CodeBlock& block);
+static void AsyncCompileThreadEntryPoint();
+
+static JitCodeBuffer s_async_code_buffer;
+static std::thread s_async_thread;
+static std::mutex s_async_mutex;
+static std::condition_variable s_async_work_cv;
+static std::condition_variable s_async_idle_cv;
+static std::deque<AsyncCompileJob> s_async_queue;
+static std::vector<AsyncCompileJob> s_async_completed;
+static std::atomic_bool s_async_has_completed{false};
+static bool s_async_busy = false;
+static bool s_async_shutdown = false;
+
+// CPU thread only. Worst-case space is reserved when queueing, so the compile thread can never run out.
+static u32 s_async_code_space = 0;
+static u32 s_async_far_code_space = 0;
+static u32 s_async_code_space_used = 0;
+static u32 s_async_far_code_space_used = 0;
+#endif
+
 static bool InitializeFastmem();
 static void ShutdownFastmem();
 static Common::PageFaultHandler::HandlerResult LUTPageFaultHandler(void* exception_pc, void* fault_address,
@@ -240,16 +511,8 @@ void Initialize()
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler())
   {
-#ifdef USE_STATIC_CODE_BUFFER
-    const bool has_buffer = s_code_buffer.Initialize(s_code_storage, sizeof(s_code_storage),
-                                                     RECOMPILER_FAR_CODE_CACHE_SIZE, RECOMPILER_GUARD_SIZE);
-#else
-    const bool has_buffer = false;
-#endif
-    if (!has_buffer && !s_code_buffer.Allocate(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE))
-    {
+    if (!InitializeCodeBuffers())
       Panic("Failed to initialize code space");
-    }
 
     AllocateFastMap();
 
@@ -258,6 +521,11 @@ void Initialize()
 
     CompileDispatcher();
     ResetFastMap();
+
+#ifdef USE_ASYNC_COMPILATION
+    if (g_settings.cpu_recompiler_async_compilation && !StartAsyncCompileThread())
+      Log_ErrorPrintf("Failed to start compile thread, blocks will be compiled synchronously.");
+#endif
   }
 #endif
 }
@@ -267,14 +535,24 @@ void ClearState()
   Bus::ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
+  s_ram_code_line_masks.fill(0);
 
   for (const auto& it : s_blocks)
     delete it.second;
 
   s_blocks.clear();
 #ifdef WITH_RECOMPILER
+#ifdef USE_ASYNC_COMPILATION
+  ResetAsyncCompilation();
+#endif
   s_host_code_map.clear();
   s_code_buffer.Reset();
+#ifdef USE_STATIC_CODE_BUFFER
+  for (JitCodeBuffer& region : s_code_regions)
+    region.Reset();
+  s_current_code_region = 0;
+  s_hot_code_region.Reset();
+#endif
   ResetFastMap();
 #endif
 }
@@ -282,14 +560,37 @@ void ClearState()
 void Shutdown()
 {
   ClearState();
+  s_block_profile_path = {};
+  s_block_profile_pending = {};
+  s_block_profile_pending_stale = {};
+  s_block_profile_scratch = {};
+  s_block_profile_cursor = 0;
+  s_block_profile_precompile_active = false;
+  s_hot_trace_keys = {};
+  s_recompile_count = 0;
+  s_flush_count = 0;
 #ifdef WITH_RECOMPILER
+  s_slowmem_guest_pcs = {};
+  s_pending_slowmem_guest_pc_count = 0;
+  s_compile_statistics = {};
+#ifdef USE_ASYNC_COMPILATION
+  StopAsyncCompileThread();
+#endif
+#ifdef USE_STATIC_CODE_BUFFER
+  s_code_region_evictions = 0;
+  s_evicted_block_count = 0;
+  s_hot_layout_scratch = {};
+#endif
   ShutdownFastmem();
   FreeFastMap();
-  s_code_buffer.Destroy();
+  DestroyCodeBuffers();
+#ifdef USE_PERF_MAP
+  ClosePerfMap();
+#endif
 #endif
 }
 
-template<PGXPMode pgxp_mode>
+template<PGXPMode pgxp_mode, bool icache, bool breakpoints>
 static void ExecuteImpl()
 {
   CodeBlockKey next_block_key;
@@ -321,6 +622,12 @@ static void ExecuteImpl()
     reexecute_block:
       Assert(!(HasPendingInterrupt()));
 
+      if constexpr (breakpoints)
+      {
+        if (block->breakpoint && CheckBlockBreakpoint())
+          break;
+      }
+
 #if 0
       const u32 tick = TimingEvents::GetGlobalTickCounter() + CPU::GetPendingTicks();
       if (tick == 4188233674)
@@ -331,10 +638,13 @@ static void ExecuteImpl()
       LogCurrentState();
 #endif
 
-      if (g_settings.cpu_recompiler_icache)
-        CheckAndUpdateICacheTags(block->icache_line_count, block->uncached_fetch_ticks);
+      if (!block->bios_hle || !HLEBIOSCall())
+      {
+        if constexpr (icache)
+          CheckAndUpdateICacheTags(block->icache_line_count, block->uncached_fetch_ticks);
 
-      InterpretCachedBlock<pgxp_mode>(*block);
+        InterpretCachedBlock<pgxp_mode>(*block);
+      }
 
       if (g_state.pending_ticks >= g_state.downcount)
         break;
@@ -344,6 +654,10 @@ static void ExecuteImpl()
       next_block_key = GetNextBlockKey();
       if (next_block_key.bits == block->key.bits)
       {
+        // nothing can change what an idle loop reads until the next event, so run the events now
+        if (block->idle_loop && SkipIdleLoop(block))
+          break;
+
         // we can jump straight to it if there's no pending interrupts
         // ensure it's not a self-modifying block
         if (!block->invalidated || RevalidateBlock(block, true))
@@ -389,22 +703,133 @@ static void ExecuteImpl()
   g_state.regs.npc = g_state.regs.pc;
 }
 
+template<PGXPMode pgxp_mode>
+static constexpr std::array<std::array<ExecuteFunction, 2>, 2> MakeExecuteFunctions()
+{
+  return {{{{&ExecuteImpl<pgxp_mode, false, false>, &ExecuteImpl<pgxp_mode, false, true>}},
+           {{&ExecuteImpl<pgxp_mode, true, false>, &ExecuteImpl<pgxp_mode, true, true>}}}};
+}
+
 void Execute()
 {
-  if (g_settings.gpu_pgxp_enable)
+  // The loop is specialized on the settings which would otherwise be checked for every block, indexed by PGXP mode,
+  // icache emulation and whether there are any breakpoints.
+  static constexpr std::array<std::array<std::array<ExecuteFunction, 2>, 2>, 3> functions = {
+    {MakeExecuteFunctions<PGXPMode::Disabled>(), MakeExecuteFunctions<PGXPMode::Memory>(),
+     MakeExecuteFunctions<PGXPMode::CPU>()}};
+
+  const u32 pgxp_index = g_settings.gpu_pgxp_enable ? (g_settings.gpu_pgxp_cpu ? 2 : 1) : 0;
+  s_execute_breakpoints = HasAnyBreakpoints();
+  const ExecuteFunction execute =
+    functions[pgxp_index][BoolToUInt32(g_settings.cpu_recompiler_icache)][BoolToUInt32(s_execute_breakpoints)];
+  execute();
+}
+
+#ifdef WITH_RECOMPILER
+
+bool InitializeCodeBuffers()
+{
+#ifdef USE_STATIC_CODE_BUFFER
+  if (!s_code_buffer.Initialize(s_code_storage, RECOMPILER_DISPATCHER_STORAGE_SIZE,
+                                RECOMPILER_DISPATCHER_FAR_CODE_SIZE, RECOMPILER_GUARD_SIZE))
   {
-    if (g_settings.gpu_pgxp_cpu)
-      ExecuteImpl<PGXPMode::CPU>();
-    else
-      ExecuteImpl<PGXPMode::Memory>();
+    return false;
   }
-  else
+
+  if (!s_hot_code_region.Initialize(s_code_storage + RECOMPILER_DISPATCHER_STORAGE_SIZE, RECOMPILER_HOT_STORAGE_SIZE,
+                                   RECOMPILER_HOT_FAR_CODE_SIZE, RECOMPILER_GUARD_SIZE))
+  {
+    return false;
+  }
+
+  for (u32 i = 0; i < RECOMPILER_CODE_REGION_COUNT; i++)
   {
-    ExecuteImpl<PGXPMode::Disabled>();
+    u8* region_storage = s_code_storage + RECOMPILER_DISPATCHER_STORAGE_SIZE + RECOMPILER_HOT_STORAGE_SIZE +
+                         (i * RECOMPILER_REGION_STORAGE_SIZE);
+    if (!s_code_regions[i].Initialize(region_storage, RECOMPILER_REGION_STORAGE_SIZE, RECOMPILER_FAR_CODE_REGION_SIZE,
+                                      RECOMPILER_GUARD_SIZE))
+    {
+      return false;
+    }
   }
+
+  s_current_code_region = 0;
+  if (g_settings.cpu_huge_pages)
+    Common::MemoryArena::AdviseHugePages(s_code_storage, sizeof(s_code_storage));
+
+  return true;
+#else
+  if (!s_code_buffer.Allocate(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE))
+    return false;
+
+  if (g_settings.cpu_huge_pages)
+    Common::MemoryArena::AdviseHugePages(s_code_buffer.GetCodePointer(), s_code_buffer.GetTotalSize());
+
+  return true;
+#endif
 }
 
-#ifdef WITH_RECOMPILER
+void DestroyCodeBuffers()
+{
+#ifdef USE_STATIC_CODE_BUFFER
+  for (JitCodeBuffer& region : s_code_regions)
+    region.Destroy();
+  s_hot_code_region.Destroy();
+#endif
+  s_code_buffer.Destroy();
+}
+
+JitCodeBuffer& GetBlockCodeBuffer()
+{
+#ifdef USE_STATIC_CODE_BUFFER
+  return s_compiling_hot_blocks ? s_hot_code_region : s_code_regions[s_current_code_region];
+#else
+  return s_code_buffer;
+#endif
+}
+
+#ifdef USE_STATIC_CODE_BUFFER
+
+void EvictOldestCodeRegion()
+{
+  // Regions are filled round-robin, so the next one holds the blocks which were compiled longest ago.
+  const u32 region_index = (s_current_code_region + 1) % RECOMPILER_CODE_REGION_COUNT;
+  JitCodeBuffer& region = s_code_regions[region_index];
+  const u8* region_start = region.GetCodePointer();
+  const u8* region_end = region_start + region.GetTotalSize();
+
+  s_evict_scratch.clear();
+  for (const auto& it : s_blocks)
+  {
+    CodeBlock* block = it.second;
+    const u8* host_code = reinterpret_cast<const u8*>(block ? block->host_code : nullptr);
+    if (host_code && host_code >= region_start && host_code < region_end)
+      s_evict_scratch.push_back(block);
+  }
+
+  // Unlinking patches predecessors in other regions back to their resolver, so they'll relink on the next run.
+  s_code_buffer.WriteProtect(false);
+  for (CodeBlock* block : s_evict_scratch)
+  {
+    const bool was_invalidated = block->invalidated;
+    RemoveReferencesToBlock(block);
+    if (was_invalidated)
+      RemoveBlockFromHostCodeMap(block);
+    delete block;
+  }
+  s_code_buffer.WriteProtect(true);
+
+  region.Reset();
+  s_current_code_region = region_index;
+  s_code_region_evictions++;
+  s_evicted_block_count += static_cast<u32>(s_evict_scratch.size());
+
+  Log_WarningPrintf("Out of code space, evicted %zu blocks from region %u (%u evictions, %u blocks total).",
+                    s_evict_scratch.size(), region_index, s_code_region_evictions, s_evicted_block_count);
+  s_evict_scratch.clear();
+}
+
+#endif
 
 void CompileDispatcher()
 {
@@ -420,8 +845,61 @@ void CompileDispatcher()
   }
 
   s_code_buffer.WriteProtect(true);
+
+#ifdef USE_PERF_MAP
+  UpdatePerfMap();
+  if (s_perf_map_file)
+  {
+    // Sizes aren't returned by the code generator, so one symbol covers both dispatchers.
+    WritePerfMapEntry(reinterpret_cast<const void*>(s_asm_dispatcher),
+                      static_cast<u32>(s_code_buffer.GetFreeCodePointer() -
+                                       reinterpret_cast<const u8*>(s_asm_dispatcher)),
+                      "duckstation_dispatcher");
+  }
+#endif
+}
+
+#ifdef USE_PERF_MAP
+
+void UpdatePerfMap()
+{
+  if (!g_settings.cpu_recompiler_perf_map)
+  {
+    ClosePerfMap();
+    return;
+  }
+
+  if (s_perf_map_file)
+    return;
+
+  const std::string path(StringUtil::StdStringFromFormat("/tmp/perf-%d.map", static_cast<int>(getpid())));
+  s_perf_map_file = FileSystem::OpenCFile(path.c_str(), "ab");
+  if (!s_perf_map_file)
+  {
+    Log_ErrorPrintf("Failed to open perf map '%s'", path.c_str());
+    return;
+  }
+
+  Log_InfoPrintf("Writing recompiled block symbols to '%s'", path.c_str());
+}
+
+void ClosePerfMap()
+{
+  if (!s_perf_map_file)
+    return;
+
+  std::fclose(s_perf_map_file);
+  s_perf_map_file = nullptr;
 }
 
+void WritePerfMapEntry(const void* code, u32 code_size, const char* name)
+{
+  std::fprintf(s_perf_map_file, "%" PRIxPTR " %x %s\n", reinterpret_cast<uintptr_t>(code), code_size, name);
+  std::fflush(s_perf_map_file);
+}
+
+#endif
+
 FastMapTable* GetFastMapPointer()
 {
   return s_fast_map;
@@ -471,21 +949,16 @@ void Reinitialize()
 
 #ifdef WITH_RECOMPILER
 
+#ifdef USE_ASYNC_COMPILATION
+  StopAsyncCompileThread();
+#endif
   ShutdownFastmem();
-  s_code_buffer.Destroy();
+  DestroyCodeBuffers();
 
   if (g_settings.IsUsingRecompiler())
   {
-
-#ifdef USE_STATIC_CODE_BUFFER
-    if (!s_code_buffer.Initialize(s_code_storage, sizeof(s_code_storage), RECOMPILER_FAR_CODE_CACHE_SIZE,
-                                  RECOMPILER_GUARD_SIZE))
-#else
-    if (!s_code_buffer.Allocate(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE))
-#endif
-    {
+    if (!InitializeCodeBuffers())
       Panic("Failed to initialize code space");
-    }
 
     if (g_settings.IsUsingFastmem() && !InitializeFastmem())
       Panic("Failed to initialize fastmem");
@@ -493,12 +966,21 @@ void Reinitialize()
     AllocateFastMap();
     CompileDispatcher();
     ResetFastMap();
+
+#ifdef USE_ASYNC_COMPILATION
+    if (g_settings.cpu_recompiler_async_compilation && !StartAsyncCompileThread())
+      Log_ErrorPrintf("Failed to start compile thread, blocks will be compiled synchronously.");
+#endif
   }
 #endif
+
+  // breakpoints only need the debug dispatcher in the interpreter
+  UpdateDebugDispatcherFlag();
 }
 
 void Flush()
 {
+  s_flush_count++;
   ClearState();
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler())
@@ -582,6 +1064,12 @@ CodeBlock* LookupBlock(CodeBlockKey key, bool allow_flush)
 
 bool RevalidateBlock(CodeBlock* block, bool allow_flush)
 {
+  if (HaveBlockBreakpointsChanged(block))
+  {
+    Log_DebugPrintf("Block 0x%08X breakpoints changed - recompiling.", block->GetPC());
+    goto recompile;
+  }
+
   for (const CodeBlockInstruction& cbi : block->instructions)
   {
     u32 new_code = 0;
@@ -603,6 +1091,8 @@ bool RevalidateBlock(CodeBlock* block, bool allow_flush)
   return true;
 
 recompile:
+  s_recompile_count++;
+
   // remove any references to the block from the lookup table.
   // this is an edge case where compiling causes a flush-all due to no space,
   // and we don't want to nuke the block we're compiling...
@@ -661,6 +1151,9 @@ recompile:
 
 bool CompileBlock(CodeBlock* block, bool allow_flush)
 {
+  TRACE_SCOPE("CompileBlock");
+  ALLOCATION_TAG("CompileBlock");
+
   u32 pc = block->GetPC();
   bool is_branch_delay_slot = false;
   bool is_load_delay_slot = false;
@@ -674,11 +1167,30 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
   block->uncached_fetch_ticks = 0;
   block->contains_double_branches = false;
   block->contains_loadstore_instructions = false;
+  block->profile_branches = false;
+  block->branch_taken_count = 0;
+  block->branch_not_taken_count = 0;
+  block->idle_loop = false;
+  block->bios_hle = false;
+  ResetIndirectBranchCache(block);
+
+#ifdef WITH_RECOMPILER
+  MergePendingSlowmemGuestPCs();
+#endif
+
+  // the block is ended before any breakpoint other than its first instruction, so they're only checked on entry
+  const bool check_breakpoints = HasAnyBreakpoints();
+  block->breakpoint = check_breakpoints && HasBreakpointAtAddress(pc);
 
   u32 last_cache_line = ICACHE_LINES;
+  u32 trace_branch_count = 0;
 
   for (;;)
   {
+    // breakpoints in delay slots can't be split off, and are missed
+    if (check_breakpoints && !is_branch_delay_slot && !block->instructions.empty() && HasBreakpointAtAddress(pc))
+      break;
+
     CodeBlockInstruction cbi = {};
     if (!SafeReadInstruction(pc, &cbi.instruction.bits) || !IsInvalidInstruction(cbi.instruction))
       break;
@@ -692,7 +1204,8 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
     cbi.is_load_instruction = IsMemoryLoadInstruction(cbi.instruction);
     cbi.is_store_instruction = IsMemoryStoreInstruction(cbi.instruction);
     cbi.has_load_delay = InstructionHasLoadDelay(cbi.instruction);
-    cbi.can_trap = CanInstructionTrap(cbi.instruction, InUserMode());
+    cbi.can_trap = CanInstructionTrap(cbi.instruction, block->key.user_mode);
+    cbi.interpreter_handler = GetCachedInterpreterHandler(cbi.instruction);
     cbi.is_direct_branch_instruction = IsDirectBranchInstruction(cbi.instruction);
 
     if (g_settings.cpu_recompiler_icache)
@@ -708,6 +1221,9 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
 
     block->contains_loadstore_instructions |= cbi.is_load_instruction;
     block->contains_loadstore_instructions |= cbi.is_store_instruction;
+#ifdef WITH_RECOMPILER
+    cbi.force_slowmem = (cbi.is_load_instruction || cbi.is_store_instruction) && IsSlowmemGuestPC(pc);
+#endif
 
     pc += sizeof(cbi.instruction.bits);
 
@@ -735,8 +1251,19 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
 
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
+    // or it's a trace, in which case we carry on along the fall-through side of the branch
     if (is_branch_delay_slot && !cbi.is_branch_instruction)
-      break;
+    {
+      CodeBlockInstruction& branch_cbi = block->instructions[block->instructions.size() - 2];
+      if (trace_branch_count == block->trace_branch_count || !CanExtendTraceThroughBranch(block, branch_cbi) ||
+          (check_breakpoints && HasBreakpointAtAddress(pc)))
+      {
+        break;
+      }
+
+      branch_cbi.is_trace_side_exit = true;
+      trace_branch_count++;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = cbi.is_branch_instruction;
@@ -753,6 +1280,15 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
   {
     block->instructions.back().is_last_instruction = true;
 
+    // count the outcomes of the final branch, so we know whether it's worth extending the block through it
+    block->trace_branch_count = trace_branch_count;
+    block->profile_branches = (block->instructions.size() >= 2 && block->trace_branch_count < MAX_TRACE_BRANCHES &&
+                               block->instructions.back().is_branch_delay_slot &&
+                               !block->instructions.back().is_branch_instruction &&
+                               CanExtendTraceThroughBranch(block, block->instructions[block->instructions.size() - 2]));
+    block->idle_loop = IsIdleLoopBlock(block);
+    block->bios_hle = IsBIOSHLEBlock(block);
+
 #ifdef _DEBUG
     SmallString disasm;
     Log_DebugPrintf("Block at 0x%08X", block->GetPC());
@@ -773,16 +1309,35 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler())
   {
+    ComputeRegisterLiveness(block);
+    block->statistics_index = UINT32_C(0xFFFFFFFF);
+    block->execution_count = 0;
+#ifdef USE_STATIC_CODE_BUFFER
+    // blocks outside the hot region count how often they run, so the hottest can be moved into it
+    block->count_executions = (g_settings.cpu_recompiler_hot_code_layout && !s_compiling_hot_blocks);
+#endif
+
+#ifdef USE_ASYNC_COMPILATION
+    // The block gets interpreted until the compile thread's code is published.
+    if (!s_compiling_hot_blocks && s_async_thread.joinable() && QueueAsyncCompile(block))
+      return true;
+#endif
+
     // Ensure we're not going to run out of space while compiling this block.
-    if (s_code_buffer.GetFreeCodeSpace() <
+    // Evicting is only safe from the dispatcher, the caller could be executing code in the oldest region.
+    if (GetBlockCodeBuffer().GetFreeCodeSpace() <
           (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
-        s_code_buffer.GetFreeFarCodeSpace() <
+        GetBlockCodeBuffer().GetFreeFarCodeSpace() <
           (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION))
     {
       if (allow_flush)
       {
+#ifdef USE_STATIC_CODE_BUFFER
+        EvictOldestCodeRegion();
+#else
         Log_WarningPrintf("Out of code space, flushing all blocks.");
         Flush();
+#endif
       }
       else
       {
@@ -791,8 +1346,9 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
       }
     }
 
+    const u32 far_code_space_before = GetBlockCodeBuffer().GetFreeFarCodeSpace();
     s_code_buffer.WriteProtect(false);
-    Recompiler::CodeGenerator codegen(&s_code_buffer);
+    Recompiler::CodeGenerator codegen(&GetBlockCodeBuffer());
     const bool compile_result = codegen.CompileBlock(block, &block->host_code, &block->host_code_size);
     s_code_buffer.WriteProtect(true);
 
@@ -801,75 +1357,1383 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
       Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
       return false;
     }
+
+    if (g_settings.cpu_recompiler_statistics)
+    {
+      RecordCompileStatistics(block, far_code_space_before - GetBlockCodeBuffer().GetFreeFarCodeSpace(),
+                              codegen.GetSpillCount());
+    }
   }
 #endif
 
   return true;
 }
 
-#ifdef WITH_RECOMPILER
-
-void FastCompileBlockFunction()
+bool CanExtendTraceThroughBranch(const CodeBlock* block, const CodeBlockInstruction& cbi)
 {
-  CodeBlock* block = LookupBlock(GetNextBlockKey(), true);
-  if (block)
+  // Side exits don't track the delay slot/branch taken state needed for memory exceptions, and icache fetch ticks
+  // are charged for the whole trace when it's entered.
+  if (!g_settings.IsUsingRecompiler() || !g_settings.cpu_recompiler_trace_formation ||
+      g_settings.cpu_recompiler_memory_exceptions || g_settings.cpu_recompiler_icache)
   {
-    s_single_block_asm_dispatcher(block->host_code);
-    return;
+    return false;
   }
 
-  if (g_settings.gpu_pgxp_enable)
-  {
-    if (g_settings.gpu_pgxp_cpu)
-      InterpretUncachedBlock<PGXPMode::CPU>();
-    else
-      InterpretUncachedBlock<PGXPMode::Memory>();
-  }
-  else
+  if (block->instructions.size() >= MAX_TRACE_INSTRUCTIONS)
+    return false;
+
+  // Only plain conditional branches, linking ones write ra regardless of whether they're taken.
+  if (!cbi.is_branch_instruction || !cbi.is_direct_branch_instruction || cbi.is_unconditional_branch_instruction ||
+      cbi.is_branch_delay_slot)
   {
-    InterpretUncachedBlock<PGXPMode::Disabled>();
+    return false;
   }
+
+  return (cbi.instruction.op != InstructionOp::b || (static_cast<u8>(cbi.instruction.i.rt.GetValue()) & 0x1E) != 0x10);
 }
 
-void InvalidCodeFunction()
+/// Returns the registers an idle loop instruction reads and writes, or false if it can't be part of one.
+static bool GetIdleLoopInstructionRegs(const Instruction& inst, u32* read_mask, Reg* write_reg)
 {
-  Log_ErrorPrintf("Trying to execute invalid code at 0x%08X", g_state.regs.pc);
-  if (g_settings.gpu_pgxp_enable)
-  {
-    if (g_settings.gpu_pgxp_cpu)
-      InterpretUncachedBlock<PGXPMode::CPU>();
-    else
-      InterpretUncachedBlock<PGXPMode::Memory>();
-  }
-  else
+  const auto rs = [&inst]() { return (1u << static_cast<u8>(inst.i.rs.GetValue())); };
+  const auto rt = [&inst]() { return (1u << static_cast<u8>(inst.i.rt.GetValue())); };
+  *read_mask = 0;
+  *write_reg = Reg::zero;
+
+  switch (inst.op)
   {
-    InterpretUncachedBlock<PGXPMode::Disabled>();
+    case InstructionOp::funct:
+    {
+      switch (inst.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+          *read_mask = rt();
+          *write_reg = inst.r.rd;
+          return true;
+
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::addu:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          *read_mask = rs() | rt();
+          *write_reg = inst.r.rd;
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    case InstructionOp::lui:
+      *write_reg = inst.i.rt;
+      return true;
+
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+    case InstructionOp::lb:
+    case InstructionOp::lbu:
+    case InstructionOp::lh:
+    case InstructionOp::lhu:
+    case InstructionOp::lw:
+      *read_mask = rs();
+      *write_reg = inst.i.rt;
+      return true;
+
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+      *read_mask = rs() | rt();
+      return true;
+
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+      *read_mask = rs();
+      return true;
+
+    case InstructionOp::b:
+      // bltzal/bgezal write ra
+      *read_mask = rs();
+      return ((static_cast<u8>(inst.i.rt.GetValue()) & 0x1E) != 0x10);
+
+    case InstructionOp::j:
+      return true;
+
+    default:
+      return false;
   }
 }
 
-#endif
+/// Polled locations which only change through DMA or timing events: RAM, the scratchpad and I_STAT.
+static bool IsIdleLoopPollAddress(VirtualMemoryAddress address)
+{
+  const u32 segment = address >> 29;
+  if (segment != 0x00 && segment != 0x04 && segment != 0x05)
+    return false;
 
-static void InvalidateBlock(CodeBlock* block, bool allow_frame_invalidation)
+  const PhysicalMemoryAddress paddr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
+  return (Bus::IsRAMAddress(paddr) || (segment != 0x05 && (paddr & DCACHE_LOCATION_MASK) == DCACHE_LOCATION) ||
+          (paddr & ~UINT32_C(3)) == Bus::INTERRUPT_CONTROLLER_BASE);
+}
+
+/// Computes the addresses loaded by an idle loop. Load bases are either loop invariant, or built from lui/addiu/ori
+/// in the loop itself, which is all IsIdleLoopBlock() allows.
+static bool GetIdleLoopLoadAddresses(const CodeBlock* block, const u32* initial_regs, bool* has_dynamic_address,
+                                     bool* all_addresses_valid)
 {
-  // Invalidate forces the block to be checked again.
-  Log_DebugPrintf("Invalidating block at 0x%08X", block->GetPC());
-  block->invalidated = true;
+  u32 values[static_cast<u32>(Reg::count)] = {};
+  u32 known_mask = 1u; // zero
+  if (initial_regs)
+    std::memcpy(values, initial_regs, sizeof(u32) * 32);
 
-  if (block->can_link)
+  u32 written_mask = 0;
+  *has_dynamic_address = false;
+  *all_addresses_valid = true;
+
+  for (const CodeBlockInstruction& cbi : block->instructions)
   {
-    const u32 frame_number = System::GetFrameNumber();
-    if (allow_frame_invalidation)
+    const Instruction& inst = cbi.instruction;
+    const u8 rs = static_cast<u8>(inst.i.rs.GetValue());
+    u32 read_mask;
+    Reg write_reg;
+    if (!GetIdleLoopInstructionRegs(inst, &read_mask, &write_reg))
+      return false;
+
+    if (cbi.is_load_instruction)
     {
-      const u32 frame_diff = frame_number - block->invalidate_frame_number;
-      if (frame_diff <= INVALIDATE_THRESHOLD_TO_DISABLE_LINKING)
+      if (!(known_mask & (1u << rs)))
       {
-        Log_DevPrintf("Block 0x%08X has been invalidated in %u frames, disabling linking", block->GetPC(), frame_diff);
-        block->can_link = false;
+        // base has to be unchanged by the loop if we don't know its value
+        if (written_mask & (1u << rs))
+          return false;
+
+        *has_dynamic_address = true;
+        if (!initial_regs)
+          continue;
       }
-      else
-      {
-        // It's been a while since this block was modified, so it's all good.
-        block->invalidate_frame_number = frame_number;
+
+      if (!IsIdleLoopPollAddress(values[rs] + inst.i.imm_sext32()))
+        *all_addresses_valid = false;
+    }
+
+    const u8 wr = static_cast<u8>(write_reg);
+    if (wr == 0)
+      continue;
+
+    written_mask |= (1u << wr);
+    if (inst.op == InstructionOp::lui)
+    {
+      values[wr] = inst.i.imm_zext32() << 16;
+      known_mask |= (1u << wr);
+    }
+    else if ((inst.op == InstructionOp::addiu || inst.op == InstructionOp::ori) && (known_mask & (1u << rs)))
+    {
+      values[wr] = (inst.op == InstructionOp::addiu) ? (values[rs] + inst.i.imm_sext32()) :
+                                                       (values[rs] | inst.i.imm_zext32());
+      known_mask |= (1u << wr);
+    }
+    else
+    {
+      known_mask &= ~(1u << wr);
+    }
+  }
+
+  return true;
+}
+
+bool IsIdleLoopBlock(const CodeBlock* block)
+{
+  if (!g_settings.cpu_skip_idle_loops || block->instructions.size() < 2 || block->trace_branch_count > 0)
+    return false;
+
+  // the block has to end with a branch back to its start, with the delay slot being the last instruction
+  const CodeBlockInstruction& branch_cbi = block->instructions[block->instructions.size() - 2];
+  const CodeBlockInstruction& delay_cbi = block->instructions.back();
+  if (!branch_cbi.is_branch_instruction || !branch_cbi.is_direct_branch_instruction ||
+      !delay_cbi.is_branch_delay_slot || delay_cbi.is_branch_instruction ||
+      GetDirectBranchTarget(branch_cbi.instruction, branch_cbi.pc) != block->GetPC())
+  {
+    return false;
+  }
+
+  // Every iteration has to be identical when memory doesn't change: registers the loop reads before writing them
+  // must not be written anywhere in the loop. Values in flight in a load delay slot are too awkward to track.
+  u32 invariant_read_mask = 0;
+  u32 written_mask = 0;
+  u32 load_delay_mask = 0;
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    u32 read_mask;
+    Reg write_reg;
+    if (!GetIdleLoopInstructionRegs(cbi.instruction, &read_mask, &write_reg) || (read_mask & load_delay_mask) != 0 ||
+        (cbi.is_load_instruction && &cbi == &delay_cbi))
+    {
+      return false;
+    }
+
+    invariant_read_mask |= (read_mask & ~written_mask);
+    written_mask |= load_delay_mask;
+    load_delay_mask = 0;
+
+    if (write_reg != Reg::zero)
+    {
+      if (cbi.is_load_instruction)
+        load_delay_mask = (1u << static_cast<u8>(write_reg));
+      else
+        written_mask |= (1u << static_cast<u8>(write_reg));
+    }
+  }
+
+  if ((invariant_read_mask & written_mask) != 0)
+    return false;
+
+  // addresses which are known now can be checked up front, the rest are checked when skipping
+  bool has_dynamic_address, all_addresses_valid;
+  if (!GetIdleLoopLoadAddresses(block, nullptr, &has_dynamic_address, &all_addresses_valid) || !all_addresses_valid)
+    return false;
+
+  Log_DevPrintf("Idle loop detected at 0x%08X (%zu instructions)", block->GetPC(), block->instructions.size());
+  return true;
+}
+
+bool SkipIdleLoop(const CodeBlock* block)
+{
+  if (g_state.pending_ticks >= g_state.downcount || g_state.cop0_regs.sr.Isc)
+    return false;
+
+  bool has_dynamic_address, all_addresses_valid;
+  if (!GetIdleLoopLoadAddresses(block, g_state.regs.r, &has_dynamic_address, &all_addresses_valid) ||
+      !all_addresses_valid)
+  {
+    return false;
+  }
+
+  g_state.pending_ticks = g_state.downcount;
+  return true;
+}
+
+bool IsBIOSHLEBlock(const CodeBlock* block)
+{
+  // only the A0 dispatch stub the kernel installs in low RAM, calls through it are identified by t1
+  return (g_settings.cpu_hle_bios_memory_routines && !block->key.user_mode &&
+          block->key.GetPCPhysicalAddress() == BIOS_A0_ENTRY_ADDRESS);
+}
+
+/// Converts a guest address range to an offset in RAM, if it lies entirely within one RAM mirror.
+static bool GetBIOSHLERAMOffset(u32 address, u32 length, u32* offset)
+{
+  const u32 paddr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
+  if (GetSegmentForAddress(address) == Segment::KSEG2 || !Bus::IsRAMAddress(paddr) ||
+      ((paddr & Bus::g_ram_mask) + length) > Bus::g_ram_size)
+  {
+    return false;
+  }
+
+  *offset = paddr & Bus::g_ram_mask;
+  return true;
+}
+
+/// Returns the length of the string at address, if it's terminated before the end of the RAM mirror.
+static bool GetBIOSHLEStringLength(u32 address, u32* offset, u32* length)
+{
+  if (!GetBIOSHLERAMOffset(address, 1, offset))
+    return false;
+
+  const u8* str = &Bus::g_ram[*offset];
+  const void* terminator = std::memchr(str, 0, Bus::g_ram_size - *offset);
+  if (!terminator)
+    return false;
+
+  *length = static_cast<u32>(static_cast<const u8*>(terminator) - str);
+  return true;
+}
+
+static void InvalidateBIOSHLEWrite(u32 offset, u32 length)
+{
+  const u32 start = Common::AlignDownPow2(offset, sizeof(u32));
+  const u32 end = Common::AlignUpPow2(offset + length, sizeof(u32));
+  InvalidateCodePages(start, (end - start) / sizeof(u32));
+}
+
+bool HLEBIOSCall()
+{
+  // the routine has to be the kernel's own, games which hook the table keep running their replacement
+  const u32 function = g_state.regs.t1;
+  u32 routine_address;
+  if (function >= BIOS_A0_TABLE_SIZE ||
+      !SafeReadMemoryWord(BIOS_A0_TABLE_ADDRESS + function * sizeof(u32), &routine_address) ||
+      (routine_address & PHYSICAL_MEMORY_ADDRESS_MASK) < Bus::BIOS_BASE ||
+      (routine_address & PHYSICAL_MEMORY_ADDRESS_MASK) >= (Bus::BIOS_BASE + Bus::BIOS_SIZE))
+  {
+    return false;
+  }
+
+  // anything in a load delay slot has landed by the time the routine reads its arguments
+  if (g_state.load_delay_reg != Reg::count)
+  {
+    g_state.regs.r[static_cast<u8>(g_state.load_delay_reg)] = g_state.load_delay_value;
+    g_state.load_delay_reg = Reg::count;
+  }
+
+  // Null pointers and non-positive lengths have special cases in the kernel, so leave those to the real thing.
+  const u32 a0 = g_state.regs.a0;
+  const u32 a1 = g_state.regs.a1;
+  const u32 a2 = g_state.regs.a2;
+  u32 result, instructions, reads;
+  switch (function)
+  {
+    case BIOS_A0_STRCPY:
+    {
+      u32 dst, src, length;
+      if (a0 == 0 || a1 == 0 || !GetBIOSHLEStringLength(a1, &src, &length) ||
+          !GetBIOSHLERAMOffset(a0, length + 1, &dst))
+      {
+        return false;
+      }
+
+      for (u32 i = 0; i <= length; i++)
+        Bus::g_ram[dst + i] = Bus::g_ram[src + i];
+
+      InvalidateBIOSHLEWrite(dst, length + 1);
+      result = a0;
+      instructions = BIOS_HLE_STRCPY_INSTRUCTIONS_PER_BYTE * (length + 1);
+      reads = length + 1;
+    }
+    break;
+
+    case BIOS_A0_STRLEN:
+    {
+      u32 src, length;
+      if (a0 == 0 || !GetBIOSHLEStringLength(a0, &src, &length))
+        return false;
+
+      result = length;
+      instructions = BIOS_HLE_STRLEN_INSTRUCTIONS_PER_BYTE * (length + 1);
+      reads = length + 1;
+    }
+    break;
+
+    case BIOS_A0_BZERO:
+    case BIOS_A0_MEMSET:
+    {
+      const u32 length = (function == BIOS_A0_BZERO) ? a1 : a2;
+      const u8 value = (function == BIOS_A0_BZERO) ? 0 : Truncate8(a1);
+      u32 dst;
+      if (a0 == 0 || static_cast<s32>(length) <= 0 || !GetBIOSHLERAMOffset(a0, length, &dst))
+        return false;
+
+      std::memset(&Bus::g_ram[dst], value, length);
+      InvalidateBIOSHLEWrite(dst, length);
+      result = a0;
+      instructions = BIOS_HLE_MEMSET_INSTRUCTIONS_PER_BYTE * length;
+      reads = 0;
+    }
+    break;
+
+    case BIOS_A0_MEMCPY:
+    {
+      u32 dst, src;
+      if (a0 == 0 || a1 == 0 || static_cast<s32>(a2) <= 0 || !GetBIOSHLERAMOffset(a0, a2, &dst) ||
+          !GetBIOSHLERAMOffset(a1, a2, &src))
+      {
+        return false;
+      }
+
+      // the kernel copies forwards a byte at a time, which overlapping copies can observe
+      for (u32 i = 0; i < a2; i++)
+        Bus::g_ram[dst + i] = Bus::g_ram[src + i];
+
+      InvalidateBIOSHLEWrite(dst, a2);
+      result = a0;
+      instructions = BIOS_HLE_MEMCPY_INSTRUCTIONS_PER_BYTE * a2;
+      reads = a2;
+    }
+    break;
+
+    default:
+      return false;
+  }
+
+  // charge what running the uncached ROM code would have cost
+  instructions += BIOS_HLE_CALL_INSTRUCTIONS;
+  g_state.pending_ticks += static_cast<TickCount>(instructions) * (GetInstructionReadTicks(routine_address) + 1) +
+                           static_cast<TickCount>(reads) * Bus::RAM_READ_TICKS;
+
+  g_state.regs.v0 = result;
+  g_state.regs.pc = g_state.regs.ra;
+  g_state.regs.npc = g_state.regs.ra + 4;
+  return true;
+}
+
+/// Returns the GPRs an instruction reads and writes. Anything which can raise an exception or gets interpreted is
+/// treated as reading every register, since the exception handler or interpreter can see all of them.
+static void GetInstructionRegisterUsage(const CodeBlockInstruction& cbi, u32* read_mask, u32* write_mask)
+{
+  static constexpr u32 ALL_REGS = UINT32_C(0xFFFFFFFF);
+  const Instruction& inst = cbi.instruction;
+  const u32 rs = (1u << static_cast<u8>(inst.i.rs.GetValue()));
+  const u32 rt = (1u << static_cast<u8>(inst.i.rt.GetValue()));
+  const u32 rd = (1u << static_cast<u8>(inst.r.rd.GetValue()));
+  const bool memory_access = (cbi.is_load_instruction || cbi.is_store_instruction);
+  const bool can_raise_exception =
+    cbi.can_trap && (!memory_access || g_settings.cpu_recompiler_memory_exceptions);
+
+  u32 reads = ALL_REGS;
+  u32 writes = 0;
+  switch (inst.op)
+  {
+    case InstructionOp::funct:
+    {
+      switch (inst.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+          reads = rt;
+          writes = rd;
+          break;
+
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::add:
+        case InstructionFunct::addu:
+        case InstructionFunct::sub:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          reads = rs | rt;
+          writes = rd;
+          break;
+
+        case InstructionFunct::mult:
+        case InstructionFunct::multu:
+        case InstructionFunct::div:
+        case InstructionFunct::divu:
+          reads = rs | rt;
+          break;
+
+        case InstructionFunct::mfhi:
+        case InstructionFunct::mflo:
+          reads = 0;
+          writes = rd;
+          break;
+
+        case InstructionFunct::mthi:
+        case InstructionFunct::mtlo:
+        case InstructionFunct::jr:
+          reads = rs;
+          break;
+
+        case InstructionFunct::jalr:
+          reads = rs;
+          writes = rd;
+          break;
+
+        default:
+          break;
+      }
+    }
+    break;
+
+    case InstructionOp::b:
+      reads = rs;
+      writes = ((static_cast<u8>(inst.i.rt.GetValue()) & 0x1E) == 0x10) ? (1u << static_cast<u8>(Reg::ra)) : 0;
+      break;
+
+    case InstructionOp::j:
+      reads = 0;
+      break;
+
+    case InstructionOp::jal:
+      reads = 0;
+      writes = (1u << static_cast<u8>(Reg::ra));
+      break;
+
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+      reads = rs | rt;
+      break;
+
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+      reads = rs;
+      break;
+
+    case InstructionOp::addi:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+      reads = rs;
+      writes = rt;
+      break;
+
+    case InstructionOp::lwl:
+    case InstructionOp::lwr:
+      // merges with the old value
+      reads = rs | rt;
+      writes = rt;
+      break;
+
+    case InstructionOp::lui:
+      reads = 0;
+      writes = rt;
+      break;
+
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::sw:
+    case InstructionOp::swl:
+    case InstructionOp::swr:
+      reads = rs | rt;
+      break;
+
+    case InstructionOp::lwc2:
+    case InstructionOp::swc2:
+      reads = rs;
+      break;
+
+    case InstructionOp::cop2:
+    {
+      if (!inst.cop.IsCommonInstruction())
+      {
+        reads = 0;
+        break;
+      }
+
+      switch (inst.cop.CommonOp())
+      {
+        case CopCommonInstruction::mfcn:
+        case CopCommonInstruction::cfcn:
+          reads = 0;
+          writes = rt;
+          break;
+
+        case CopCommonInstruction::mtcn:
+        case CopCommonInstruction::ctcn:
+          reads = rt;
+          break;
+
+        default:
+          break;
+      }
+    }
+    break;
+
+    case InstructionOp::cop0:
+    {
+      // writes to cop0 can raise interrupts, only reads are safe
+      if (inst.cop.IsCommonInstruction() && inst.cop.CommonOp() == CopCommonInstruction::mfcn)
+      {
+        reads = 0;
+        writes = rt;
+      }
+    }
+    break;
+
+    default:
+      break;
+  }
+
+  *read_mask = can_raise_exception ? ALL_REGS : (reads & ~1u);
+  *write_mask = writes & ~1u;
+}
+
+void ComputeRegisterLiveness(CodeBlock* block)
+{
+  static constexpr u32 ALL_REGS = UINT32_C(0xFFFFFFFF);
+  const u32 count = static_cast<u32>(block->instructions.size());
+
+  // A load can write immediately when its delay slot doesn't touch the register, since the result is then the same.
+  // The delay slot of a side exit continues in another block, and the last instruction's delay slot isn't known.
+  // Back-to-back loads to the same register are left alone, the second has to cancel the first.
+  u32 prev_delayed_writes = 0;
+  for (u32 i = 0; i < count; i++)
+  {
+    CodeBlockInstruction& cbi = block->instructions[i];
+    cbi.can_skip_load_delay = false;
+
+    u32 load_reads, load_writes;
+    GetInstructionRegisterUsage(cbi, &load_reads, &load_writes);
+    if (cbi.has_load_delay && !cbi.is_branch_delay_slot && (i + 1) < count && load_writes != 0 &&
+        (prev_delayed_writes & load_writes) == 0)
+    {
+      u32 next_reads, next_writes;
+      GetInstructionRegisterUsage(block->instructions[i + 1], &next_reads, &next_writes);
+      cbi.can_skip_load_delay = (((next_reads | next_writes) & load_writes) == 0);
+    }
+
+    prev_delayed_writes = (cbi.has_load_delay && !cbi.can_skip_load_delay) ? load_writes : 0;
+  }
+
+  // Walk backwards from the exit, where everything is live because we don't know what the successor will read.
+  // Delayed loads only overwrite their register once the following instruction has executed.
+  u32 live = ALL_REGS;
+  for (u32 i = count; i > 0; i--)
+  {
+    CodeBlockInstruction& cbi = block->instructions[i - 1];
+    const CodeBlockInstruction* prev_cbi = (i >= 2) ? &block->instructions[i - 2] : nullptr;
+    if (prev_cbi && prev_cbi->is_trace_side_exit)
+      live = ALL_REGS;
+
+    u32 reads, writes;
+    GetInstructionRegisterUsage(cbi, &reads, &writes);
+    if (cbi.has_load_delay && !cbi.can_skip_load_delay)
+      writes = 0;
+
+    if (prev_cbi && prev_cbi->has_load_delay && !prev_cbi->can_skip_load_delay)
+    {
+      u32 prev_reads, prev_writes;
+      GetInstructionRegisterUsage(*prev_cbi, &prev_reads, &prev_writes);
+      writes |= prev_writes;
+    }
+
+    const u32 live_out = live;
+    live = (live_out & ~writes) | reads;
+    cbi.live_reg_mask = live | live_out;
+  }
+}
+
+#ifdef WITH_RECOMPILER
+
+bool IsSlowmemGuestPC(u32 pc)
+{
+  return std::binary_search(s_slowmem_guest_pcs.begin(), s_slowmem_guest_pcs.end(), pc);
+}
+
+void AddSlowmemGuestPC(u32 pc)
+{
+  if (s_pending_slowmem_guest_pc_count < MAX_PENDING_SLOWMEM_GUEST_PCS)
+    s_pending_slowmem_guest_pcs[s_pending_slowmem_guest_pc_count++] = pc;
+}
+
+void MergePendingSlowmemGuestPCs()
+{
+  for (u32 i = 0; i < s_pending_slowmem_guest_pc_count; i++)
+  {
+    const u32 pc = s_pending_slowmem_guest_pcs[i];
+    const auto it = std::lower_bound(s_slowmem_guest_pcs.begin(), s_slowmem_guest_pcs.end(), pc);
+    if (it == s_slowmem_guest_pcs.end() || *it != pc)
+      s_slowmem_guest_pcs.insert(it, pc);
+  }
+
+  s_pending_slowmem_guest_pc_count = 0;
+}
+
+void RecordCompileStatistics(CodeBlock* block, u32 far_code_size, u32 spill_count)
+{
+  BlockCompileStatistics stats;
+  stats.key = block->key.bits;
+  stats.guest_instructions = static_cast<u32>(block->instructions.size());
+  stats.host_code_size = block->host_code_size;
+  stats.far_code_size = far_code_size;
+  stats.spill_count = spill_count;
+  stats.fastmem_sites = static_cast<u32>(block->loadstore_backpatch_info.size());
+  stats.backpatch_count = 0;
+
+  block->statistics_index = static_cast<u32>(s_compile_statistics.size());
+  s_compile_statistics.push_back(stats);
+}
+
+void RecordBackpatch(const CodeBlock* block)
+{
+  if (block->statistics_index < s_compile_statistics.size())
+    s_compile_statistics[block->statistics_index].backpatch_count++;
+}
+
+void DumpStatistics(const char* csv_path)
+{
+  if (s_compile_statistics.empty())
+  {
+    Log_InfoPrintf("No recompiler statistics were collected.");
+    return;
+  }
+
+  // Bucket 0 holds zero, bucket N holds values in [2^(N-1), 2^N).
+  static constexpr u32 NUM_BUCKETS = 33;
+  struct Metric
+  {
+    const char* name;
+    u32 BlockCompileStatistics::*field;
+  };
+  static constexpr Metric metrics[] = {
+    {"guest instructions", &BlockCompileStatistics::guest_instructions},
+    {"host code bytes", &BlockCompileStatistics::host_code_size},
+    {"far code bytes", &BlockCompileStatistics::far_code_size},
+    {"spills", &BlockCompileStatistics::spill_count},
+    {"fastmem sites", &BlockCompileStatistics::fastmem_sites},
+    {"backpatches", &BlockCompileStatistics::backpatch_count},
+  };
+
+  Log_InfoPrintf("Recompiler statistics for %zu compiled blocks:", s_compile_statistics.size());
+  for (const Metric& metric : metrics)
+  {
+    std::array<u32, NUM_BUCKETS> buckets = {};
+    u64 total = 0;
+    u32 max_value = 0;
+    for (const BlockCompileStatistics& stats : s_compile_statistics)
+    {
+      const u32 value = stats.*metric.field;
+      buckets[(value == 0) ? 0 : (32 - CountLeadingZeros(value))]++;
+      total += value;
+      max_value = std::max(max_value, value);
+    }
+
+    Log_InfoPrintf("  %s: total %" PRIu64 ", mean %.2f, max %u", metric.name, total,
+                   static_cast<double>(total) / static_cast<double>(s_compile_statistics.size()), max_value);
+    for (u32 i = 0; i < NUM_BUCKETS; i++)
+    {
+      if (buckets[i] == 0)
+        continue;
+
+      const u32 low = (i == 0) ? 0 : (1u << (i - 1));
+      const u32 high = (i == 0) ? 0 : static_cast<u32>((u64(1) << i) - 1);
+      Log_InfoPrintf("    [%u, %u]: %u", low, high, buckets[i]);
+    }
+  }
+
+  if (!csv_path)
+    return;
+
+  auto fp = FileSystem::OpenManagedCFile(csv_path, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing recompiler statistics", csv_path);
+    return;
+  }
+
+  std::fprintf(fp.get(), "pc,user_mode,guest_instructions,host_code_size,far_code_size,spills,fastmem_sites,"
+                         "backpatches\n");
+  for (const BlockCompileStatistics& stats : s_compile_statistics)
+  {
+    CodeBlockKey key;
+    key.bits = stats.key;
+    std::fprintf(fp.get(), "0x%08X,%u,%u,%u,%u,%u,%u,%u\n", key.GetPC(), key.user_mode ? 1u : 0u,
+                 stats.guest_instructions, stats.host_code_size, stats.far_code_size, stats.spill_count,
+                 stats.fastmem_sites, stats.backpatch_count);
+  }
+
+  Log_InfoPrintf("Wrote recompiler statistics to '%s'", csv_path);
+}
+
+bool SaveBlockSet(const char* path)
+{
+  std::vector<u8> data(sizeof(BlockSetHeader));
+  u32 num_blocks = 0;
+  for (const auto& it : s_blocks)
+  {
+    // Like the block profile, only linear blocks can be recreated by copying their code back to memory.
+    const CodeBlock* block = it.second;
+    const u32 instruction_count = block ? static_cast<u32>(block->instructions.size()) : 0;
+    if (instruction_count == 0 ||
+        block->instructions.back().pc != (block->GetPC() + (instruction_count - 1) * sizeof(u32)))
+    {
+      continue;
+    }
+
+    BlockSetEntry entry;
+    entry.key = block->key.bits;
+    entry.instruction_count = instruction_count;
+
+    const size_t offset = data.size();
+    data.resize(offset + sizeof(entry) + instruction_count * sizeof(u32));
+    std::memcpy(&data[offset], &entry, sizeof(entry));
+    for (u32 i = 0; i < instruction_count; i++)
+    {
+      std::memcpy(&data[offset + sizeof(entry) + i * sizeof(u32)], &block->instructions[i].instruction.bits,
+                  sizeof(u32));
+    }
+
+    num_blocks++;
+  }
+
+  const size_t slowmem_offset = data.size();
+  data.resize(slowmem_offset + s_slowmem_guest_pcs.size() * sizeof(u32));
+  if (!s_slowmem_guest_pcs.empty())
+    std::memcpy(&data[slowmem_offset], s_slowmem_guest_pcs.data(), s_slowmem_guest_pcs.size() * sizeof(u32));
+
+  BlockSetHeader header;
+  header.magic = BLOCK_SET_MAGIC;
+  header.version = BLOCK_SET_VERSION;
+  header.num_blocks = num_blocks;
+  header.num_slowmem_pcs = static_cast<u32>(s_slowmem_guest_pcs.size());
+  std::memcpy(data.data(), &header, sizeof(header));
+
+  if (!FileSystem::WriteBinaryFile(path, data.data(), data.size()))
+  {
+    Log_ErrorPrintf("Failed to write block set to '%s'", path);
+    return false;
+  }
+
+  Log_InfoPrintf("Saved %u blocks to block set '%s'", num_blocks, path);
+  return true;
+}
+
+static bool CopyBlockSetCode(u32 pc, const u8* code, u32 instruction_count)
+{
+  const PhysicalMemoryAddress address = VirtualAddressToPhysical(pc);
+  const u32 size = instruction_count * sizeof(u32);
+  if (Bus::IsRAMAddress(address) && ((address & Bus::g_ram_mask) + size) <= (Bus::g_ram_mask + 1))
+  {
+    std::memcpy(&Bus::g_ram[address & Bus::g_ram_mask], code, size);
+    return true;
+  }
+  else if (address >= Bus::BIOS_BASE && ((address - Bus::BIOS_BASE) + size) <= Bus::BIOS_SIZE)
+  {
+    std::memcpy(&Bus::g_bios[address - Bus::BIOS_BASE], code, size);
+    return true;
+  }
+
+  return false;
+}
+
+bool ReplayBlockSet(const char* path)
+{
+  AssertMsg(System::IsShutdown(), "Block sets can't be replayed while the system is running");
+  if (!g_settings.IsUsingRecompiler())
+  {
+    Log_ErrorPrintf("Block sets can only be replayed with the recompiler.");
+    return false;
+  }
+
+#ifdef USE_ASYNC_COMPILATION
+  if (s_async_thread.joinable())
+  {
+    Log_ErrorPrintf("Block sets can't be replayed with asynchronous compilation enabled.");
+    return false;
+  }
+#endif
+
+  std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(path));
+  BlockSetHeader header;
+  if (!data.has_value() || data->size() < sizeof(header))
+  {
+    Log_ErrorPrintf("Failed to read block set '%s'", path);
+    return false;
+  }
+
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (header.magic != BLOCK_SET_MAGIC || header.version != BLOCK_SET_VERSION)
+  {
+    Log_ErrorPrintf("Block set '%s' is invalid or from a different version", path);
+    return false;
+  }
+
+  // The saved code overwrites guest memory and the slowmem PCs, so put them back when we're done.
+  std::vector<u8> saved_ram(Bus::g_ram, Bus::g_ram + Bus::g_ram_size);
+  std::vector<u8> saved_bios(Bus::g_bios, Bus::g_bios + Bus::BIOS_SIZE);
+  std::vector<u32> saved_slowmem_guest_pcs(s_slowmem_guest_pcs);
+  ScopedGuard restore_guard([&saved_ram, &saved_bios, &saved_slowmem_guest_pcs]() {
+    std::memcpy(Bus::g_ram, saved_ram.data(), saved_ram.size());
+    std::memcpy(Bus::g_bios, saved_bios.data(), saved_bios.size());
+    s_slowmem_guest_pcs = std::move(saved_slowmem_guest_pcs);
+  });
+
+  // First pass puts all the code in memory, blocks can run into each other.
+  std::vector<CodeBlockKey> keys;
+  keys.reserve(header.num_blocks);
+  size_t offset = sizeof(header);
+  bool truncated = false;
+  for (u32 i = 0; i < header.num_blocks; i++)
+  {
+    BlockSetEntry entry;
+    if ((data->size() - offset) < sizeof(entry))
+    {
+      truncated = true;
+      break;
+    }
+
+    std::memcpy(&entry, data->data() + offset, sizeof(entry));
+    offset += sizeof(entry);
+    if ((data->size() - offset) < (static_cast<size_t>(entry.instruction_count) * sizeof(u32)))
+    {
+      truncated = true;
+      break;
+    }
+
+    CodeBlockKey key;
+    key.bits = entry.key;
+    if (CopyBlockSetCode(key.GetPC(), data->data() + offset, entry.instruction_count))
+      keys.push_back(key);
+    else
+      Log_WarningPrintf("Block 0x%08X in block set is outside of RAM and BIOS, skipping", key.GetPC());
+
+    offset += entry.instruction_count * sizeof(u32);
+  }
+
+  if (truncated || (data->size() - offset) < (static_cast<size_t>(header.num_slowmem_pcs) * sizeof(u32)))
+  {
+    Log_ErrorPrintf("Block set '%s' is truncated", path);
+    return false;
+  }
+
+  s_slowmem_guest_pcs.resize(header.num_slowmem_pcs);
+  if (header.num_slowmem_pcs > 0)
+    std::memcpy(s_slowmem_guest_pcs.data(), data->data() + offset, header.num_slowmem_pcs * sizeof(u32));
+
+  Common::Timer timer;
+  u32 num_compiled = 0;
+  for (const CodeBlockKey& key : keys)
+  {
+    // The blocks aren't added to the cache, only the host code is generated.
+    std::unique_ptr<CodeBlock> block = std::make_unique<CodeBlock>(key);
+    if (CompileBlock(block.get(), true))
+      num_compiled++;
+  }
+
+  Log_InfoPrintf("Recompiled %u of %zu blocks from '%s' in %.2f ms", num_compiled, keys.size(), path,
+                 timer.GetTimeMilliseconds());
+  return true;
+}
+
+#endif
+
+void ResetIndirectBranchCache(CodeBlock* block)
+{
+  // PCs are always aligned, so this can't match, and the compile function resolves whatever the real target is.
+  block->indirect_branch_pc = 1;
+#ifdef WITH_RECOMPILER
+  block->indirect_branch_host_code = FastCompileBlockFunction;
+#endif
+}
+
+void FormHotTraces()
+{
+  if (!g_settings.cpu_recompiler_trace_formation || (System::GetFrameNumber() % TRACE_SCAN_INTERVAL_FRAMES) != 0)
+    return;
+
+  s_hot_trace_keys.clear();
+  for (const auto& it : s_blocks)
+  {
+    CodeBlock* block = it.second;
+    if (!block || !block->profile_branches)
+      continue;
+
+    const u32 taken = block->branch_taken_count;
+    const u32 not_taken = block->branch_not_taken_count;
+    block->branch_taken_count = 0;
+    block->branch_not_taken_count = 0;
+
+    const u32 total = taken + not_taken;
+    if (!block->invalidated && total >= TRACE_HOT_BRANCH_COUNT && taken <= (total / 8))
+      s_hot_trace_keys.push_back(it.first);
+  }
+
+  for (const u32 key : s_hot_trace_keys)
+  {
+    // recompiling can flush the cache, so look the block up again
+    BlockMap::iterator iter = s_blocks.find(key);
+    if (iter == s_blocks.end() || !iter->second || iter->second->invalidated)
+      continue;
+
+    CodeBlock* block = iter->second;
+    Log_DevPrintf("Extending block 0x%08X through hot branch at 0x%08X", block->GetPC(),
+                  block->instructions[block->instructions.size() - 2].pc);
+
+    // same dance as RevalidateBlock(), removing it first means a flush won't free it
+    RemoveReferencesToBlock(block);
+    block->instructions.clear();
+    block->trace_branch_count++;
+
+    if (!CompileBlock(block, true))
+    {
+      Log_PerfPrintf("Failed to compile trace 0x%08X, falling back to interpreter.", block->GetPC());
+      FallbackExistingBlockToInterpreter(block);
+      continue;
+    }
+
+    AddBlockToPageMap(block);
+#ifdef WITH_RECOMPILER
+    SetFastMap(block->GetPC(), block->host_code);
+    AddBlockToHostCodeMap(block);
+#endif
+    s_blocks.emplace(block->key.bits, block);
+  }
+}
+
+void LayoutHotBlocks()
+{
+#if defined(WITH_RECOMPILER) && defined(USE_STATIC_CODE_BUFFER)
+  if (!g_settings.cpu_recompiler_hot_code_layout || (System::GetFrameNumber() % HOT_LAYOUT_INTERVAL_FRAMES) != 0)
+    return;
+
+  s_hot_layout_scratch.clear();
+  for (const auto& it : s_blocks)
+  {
+    CodeBlock* block = it.second;
+    if (!block || !block->count_executions)
+      continue;
+
+    if (!block->invalidated && block->host_code && block->execution_count >= HOT_LAYOUT_MIN_EXECUTIONS)
+      s_hot_layout_scratch.push_back(block);
+    else
+      block->execution_count = 0;
+  }
+
+  // hottest first, so the blocks which run the most end up closest together
+  std::sort(s_hot_layout_scratch.begin(), s_hot_layout_scratch.end(),
+            [](const CodeBlock* lhs, const CodeBlock* rhs) { return (lhs->execution_count > rhs->execution_count); });
+
+  u32 num_laid_out = 0;
+  s_compiling_hot_blocks = true;
+  for (CodeBlock* block : s_hot_layout_scratch)
+  {
+    // the region is only reset by a flush, once it's full the remaining blocks stay where they are
+    if (s_hot_code_region.GetFreeCodeSpace() <
+          (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
+        s_hot_code_region.GetFreeFarCodeSpace() <
+          (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION))
+    {
+      break;
+    }
+
+    // same dance as FormHotTraces(), the old code is left behind in its region until that's evicted
+    RemoveReferencesToBlock(block);
+    block->instructions.clear();
+
+    if (!CompileBlock(block, false))
+    {
+      Log_PerfPrintf("Failed to compile hot block 0x%08X, falling back to interpreter.", block->GetPC());
+      FallbackExistingBlockToInterpreter(block);
+      continue;
+    }
+
+    AddBlockToPageMap(block);
+    SetFastMap(block->GetPC(), block->host_code);
+    AddBlockToHostCodeMap(block);
+    s_blocks.emplace(block->key.bits, block);
+    num_laid_out++;
+  }
+  s_compiling_hot_blocks = false;
+
+  for (CodeBlock* block : s_hot_layout_scratch)
+    block->execution_count = 0;
+
+  if (num_laid_out > 0)
+  {
+    Log_DevPrintf("Moved %u of %zu hot blocks to the hot region, %u bytes left", num_laid_out,
+                  s_hot_layout_scratch.size(), s_hot_code_region.GetFreeCodeSpace());
+  }
+#endif
+}
+
+#ifdef WITH_RECOMPILER
+
+void FastCompileBlockFunction()
+{
+#ifdef USE_ASYNC_COMPILATION
+  PublishAsyncCompiledBlocks();
+#endif
+
+  CodeBlock* block = LookupBlock(GetNextBlockKey(), true);
+  if (block)
+  {
+#ifdef USE_ASYNC_COMPILATION
+    if (!block->host_code)
+    {
+      InterpretPendingBlock(*block);
+      return;
+    }
+#endif
+
+    s_single_block_asm_dispatcher(block->host_code);
+    return;
+  }
+
+  if (g_settings.gpu_pgxp_enable)
+  {
+    if (g_settings.gpu_pgxp_cpu)
+      InterpretUncachedBlock<PGXPMode::CPU>();
+    else
+      InterpretUncachedBlock<PGXPMode::Memory>();
+  }
+  else
+  {
+    InterpretUncachedBlock<PGXPMode::Disabled>();
+  }
+}
+
+void InvalidCodeFunction()
+{
+  Log_ErrorPrintf("Trying to execute invalid code at 0x%08X", g_state.regs.pc);
+  if (g_settings.gpu_pgxp_enable)
+  {
+    if (g_settings.gpu_pgxp_cpu)
+      InterpretUncachedBlock<PGXPMode::CPU>();
+    else
+      InterpretUncachedBlock<PGXPMode::Memory>();
+  }
+  else
+  {
+    InterpretUncachedBlock<PGXPMode::Disabled>();
+  }
+}
+
+#ifdef USE_ASYNC_COMPILATION
+
+bool StartAsyncCompileThread()
+{
+  if (!s_async_code_buffer.Initialize(s_code_storage + RECOMPILER_STORAGE_SIZE, RECOMPILER_ASYNC_STORAGE_SIZE,
+                                      RECOMPILER_ASYNC_FAR_CODE_CACHE_SIZE, RECOMPILER_GUARD_SIZE))
+  {
+    return false;
+  }
+
+  s_async_code_space = s_async_code_buffer.GetFreeCodeSpace();
+  s_async_far_code_space = s_async_code_buffer.GetFreeFarCodeSpace();
+  s_async_code_space_used = 0;
+  s_async_far_code_space_used = 0;
+  s_async_shutdown = false;
+  s_async_thread = std::thread(AsyncCompileThreadEntryPoint);
+  Log_InfoPrintf("Started compile thread with %u/%u bytes of code space", s_async_code_space, s_async_far_code_space);
+  return true;
+}
+
+void StopAsyncCompileThread()
+{
+  if (!s_async_thread.joinable())
+    return;
+
+  ResetAsyncCompilation();
+  {
+    std::unique_lock lock(s_async_mutex);
+    s_async_shutdown = true;
+    s_async_work_cv.notify_one();
+  }
+
+  s_async_thread.join();
+  s_async_code_buffer.Destroy();
+}
+
+void ResetAsyncCompilation()
+{
+  if (!s_async_thread.joinable())
+    return;
+
+  // The block being compiled may reference memory which is about to be reused, so wait for it.
+  std::unique_lock lock(s_async_mutex);
+  s_async_queue.clear();
+  s_async_idle_cv.wait(lock, []() { return !s_async_busy; });
+  s_async_completed.clear();
+  s_async_has_completed.store(false, std::memory_order_relaxed);
+  s_async_code_buffer.Reset();
+  s_async_code_space_used = 0;
+  s_async_far_code_space_used = 0;
+}
+
+bool QueueAsyncCompile(CodeBlock* block)
+{
+  const u32 code_space =
+    static_cast<u32>(block->instructions.size()) * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION;
+  const u32 far_code_space =
+    static_cast<u32>(block->instructions.size()) * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION;
+  if ((s_async_code_space_used + code_space) > s_async_code_space ||
+      (s_async_far_code_space_used + far_code_space) > s_async_far_code_space)
+  {
+    // Out of space until the next flush, compile synchronously instead.
+    return false;
+  }
+
+  // Any previous host code is now stale, the block gets interpreted until the new code is published.
+  block->host_code = nullptr;
+  block->host_code_size = 0;
+  block->loadstore_backpatch_info.clear();
+
+  AsyncCompileJob job;
+  job.source = block;
+  job.block = std::make_unique<CodeBlock>(*block);
+  job.reserved_code_space = code_space;
+  job.reserved_far_code_space = far_code_space;
+  job.used_code_space = 0;
+  job.used_far_code_space = 0;
+  job.spill_count = 0;
+  job.result = false;
+  s_async_code_space_used += code_space;
+  s_async_far_code_space_used += far_code_space;
+
+  std::unique_lock lock(s_async_mutex);
+  s_async_queue.push_back(std::move(job));
+  s_async_work_cv.notify_one();
+  return true;
+}
+
+static bool IsSameBlockCode(const CodeBlock* lhs, const CodeBlock* rhs)
+{
+  if (lhs->instructions.size() != rhs->instructions.size())
+    return false;
+
+  for (size_t i = 0; i < lhs->instructions.size(); i++)
+  {
+    if (lhs->instructions[i].pc != rhs->instructions[i].pc ||
+        lhs->instructions[i].instruction.bits != rhs->instructions[i].instruction.bits)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void PublishAsyncCompiledBlocks()
+{
+  if (!s_async_has_completed.load(std::memory_order_acquire))
+    return;
+
+  std::vector<AsyncCompileJob> jobs;
+  {
+    std::unique_lock lock(s_async_mutex);
+    jobs.swap(s_async_completed);
+    s_async_has_completed.store(false, std::memory_order_relaxed);
+  }
+
+  for (AsyncCompileJob& job : jobs)
+  {
+    // Release the slack between the worst-case reservation and what was actually emitted.
+    s_async_code_space_used -= job.reserved_code_space - job.used_code_space;
+    s_async_far_code_space_used -= job.reserved_far_code_space - job.used_far_code_space;
+
+    // The source block could have been recompiled, flushed or replaced since it was queued.
+    BlockMap::iterator iter = s_blocks.find(job.block->key.bits);
+    if (iter == s_blocks.end() || iter->second != job.source || job.source->host_code ||
+        !IsSameBlockCode(job.source, job.block.get()))
+    {
+      continue;
+    }
+
+    CodeBlock* source = job.source;
+    if (!job.result)
+    {
+      Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", source->GetPC());
+      RemoveReferencesToBlock(source);
+      FallbackExistingBlockToInterpreter(source);
+      continue;
+    }
+
+    // Invalidation is carried over, the new block will be revalidated on its next lookup.
+    CodeBlock* block = job.block.release();
+    block->invalidated = source->invalidated;
+    block->can_link = source->can_link;
+    block->recompile_frame_number = source->recompile_frame_number;
+    block->recompile_count = source->recompile_count;
+    block->invalidate_frame_number = source->invalidate_frame_number;
+    RemoveReferencesToBlock(source);
+    delete source;
+
+    if (g_settings.cpu_recompiler_statistics)
+      RecordCompileStatistics(block, job.used_far_code_space, job.spill_count);
+
+    s_blocks.emplace(block->key.bits, block);
+    AddBlockToHostCodeMap(block);
+    if (!block->invalidated)
+    {
+      AddBlockToPageMap(block);
+      SetFastMap(block->GetPC(), block->host_code);
+    }
+  }
+}
+
+void InterpretPendingBlock(const CodeBlock& block)
+{
+  if (block.breakpoint && CheckBlockBreakpoint())
+    return;
+
+  if (g_settings.cpu_recompiler_icache)
+    CheckAndUpdateICacheTags(block.icache_line_count, block.uncached_fetch_ticks);
+
+  if (g_settings.gpu_pgxp_enable)
+  {
+    if (g_settings.gpu_pgxp_cpu)
+      InterpretCachedBlock<PGXPMode::CPU>(block);
+    else
+      InterpretCachedBlock<PGXPMode::Memory>(block);
+  }
+  else
+  {
+    InterpretCachedBlock<PGXPMode::Disabled>(block);
+  }
+}
+
+void AsyncCompileThreadEntryPoint()
+{
+  std::unique_lock lock(s_async_mutex);
+  for (;;)
+  {
+    s_async_work_cv.wait(lock, []() { return s_async_shutdown || !s_async_queue.empty(); });
+    if (s_async_shutdown)
+      break;
+
+    AsyncCompileJob job = std::move(s_async_queue.front());
+    s_async_queue.pop_front();
+    s_async_busy = true;
+    lock.unlock();
+
+    const u32 code_space_before = s_async_code_buffer.GetFreeCodeSpace();
+    const u32 far_code_space_before = s_async_code_buffer.GetFreeFarCodeSpace();
+    {
+      Recompiler::CodeGenerator codegen(&s_async_code_buffer);
+      codegen.DisableSpeculativeStateReads();
+      job.result = codegen.CompileBlock(job.block.get(), &job.block->host_code, &job.block->host_code_size);
+      job.spill_count = codegen.GetSpillCount();
+    }
+    job.used_code_space = code_space_before - s_async_code_buffer.GetFreeCodeSpace();
+    job.used_far_code_space = far_code_space_before - s_async_code_buffer.GetFreeFarCodeSpace();
+
+    lock.lock();
+    s_async_busy = false;
+    s_async_completed.push_back(std::move(job));
+    s_async_has_completed.store(true, std::memory_order_release);
+    s_async_idle_cv.notify_all();
+  }
+}
+
+#endif // USE_ASYNC_COMPILATION
+
+#endif
+
+static void InvalidateBlock(CodeBlock* block, bool allow_frame_invalidation)
+{
+  // Invalidate forces the block to be checked again.
+  Log_DebugPrintf("Invalidating block at 0x%08X", block->GetPC());
+  block->invalidated = true;
+
+  if (block->can_link)
+  {
+    const u32 frame_number = System::GetFrameNumber();
+    if (allow_frame_invalidation)
+    {
+      const u32 frame_diff = frame_number - block->invalidate_frame_number;
+      if (frame_diff <= INVALIDATE_THRESHOLD_TO_DISABLE_LINKING)
+      {
+        Log_DevPrintf("Block 0x%08X has been invalidated in %u frames, disabling linking", block->GetPC(), frame_diff);
+        block->can_link = false;
+      }
+      else
+      {
+        // It's been a while since this block was modified, so it's all good.
+        block->invalidate_frame_number = frame_number;
       }
     }
     else
@@ -891,13 +2755,188 @@ void InvalidateBlocksWithPageIndex(u32 page_index)
   DebugAssert(page_index < Bus::RAM_8MB_CODE_PAGE_COUNT);
   auto& blocks = m_ram_block_map[page_index];
   for (CodeBlock* block : blocks)
+  {
     InvalidateBlock(block, true);
 
+    // blocks can span pages, and have to be taken out of the others too, since they're only re-added once
+    const u32 start_page = block->GetStartPageIndex();
+    const u32 end_page = block->GetEndPageIndex();
+    for (u32 page = start_page; page <= end_page; page++)
+    {
+      if (page == page_index)
+        continue;
+
+      auto& page_blocks = m_ram_block_map[page];
+      auto page_block_iter = std::find(page_blocks.begin(), page_blocks.end(), block);
+      Assert(page_block_iter != page_blocks.end());
+      page_blocks.erase(page_block_iter);
+      UpdatePageCodeState(page);
+    }
+  }
+
   // Block will be re-added next execution.
   blocks.clear();
+  s_ram_code_line_masks[page_index] = 0;
   Bus::ClearRAMCodePage(page_index);
 }
 
+u64 GetCodeLineMask(u32 page_index, u32 start_address, u32 end_address)
+{
+  const u32 page_start = page_index * CODE_PAGE_SIZE;
+  const u32 page_end = page_start + CODE_PAGE_SIZE;
+  start_address = std::max(start_address, page_start);
+  end_address = std::min(end_address, page_end);
+  if (start_address >= end_address)
+    return 0;
+
+  const u32 first_line = (start_address - page_start) / CODE_LINE_SIZE;
+  const u32 last_line = (end_address - 1 - page_start) / CODE_LINE_SIZE;
+  const u64 up_to_last = (last_line == (CODE_LINES_PER_PAGE - 1)) ? ~static_cast<u64>(0) :
+                                                                     ((static_cast<u64>(1) << (last_line + 1)) - 1);
+  return up_to_last & ~((static_cast<u64>(1) << first_line) - 1);
+}
+
+const u8* GetRAMCodeLineMaskByte(u32 offset, u8* bit)
+{
+  // masks are stored little-endian on every host we generate code for
+  const u32 page = offset / CODE_PAGE_SIZE;
+  const u32 line = (offset % CODE_PAGE_SIZE) / CODE_LINE_SIZE;
+  *bit = static_cast<u8>(line % 8);
+  return reinterpret_cast<const u8*>(&s_ram_code_line_masks[page]) + (line / 8);
+}
+
+void InvalidateBlocksInRange(PhysicalMemoryAddress start_address, u32 size)
+{
+  const u32 end_address = start_address + size;
+  const u32 start_page = start_address / CODE_PAGE_SIZE;
+  const u32 end_page = (end_address - 1) / CODE_PAGE_SIZE;
+  for (u32 page = start_page; page <= end_page && page < Bus::RAM_8MB_CODE_PAGE_COUNT; page++)
+  {
+    if (!Bus::IsRAMCodePage(page) ||
+        (s_ram_code_line_masks[page] & GetCodeLineMask(page, start_address, end_address)) == 0)
+    {
+      continue;
+    }
+
+    // blocks can span pages, so take them out of all of them, not just this one
+    s_invalidate_scratch.clear();
+    for (CodeBlock* block : m_ram_block_map[page])
+    {
+      const u32 block_start = block->key.GetPCPhysicalAddress();
+      const u32 block_end = block_start + block->GetSizeInBytes();
+      if (block_start < end_address && start_address < block_end)
+        s_invalidate_scratch.push_back(block);
+    }
+
+    for (CodeBlock* block : s_invalidate_scratch)
+    {
+      RemoveBlockFromPageMap(block);
+      InvalidateBlock(block, true);
+    }
+
+    // the mask can shrink now that the overwritten blocks are gone
+    UpdatePageCodeState(page);
+  }
+}
+
+void UpdatePageCodeState(u32 page_index)
+{
+  u64 mask = 0;
+  for (const CodeBlock* block : m_ram_block_map[page_index])
+  {
+    const u32 block_start = block->key.GetPCPhysicalAddress();
+    mask |= GetCodeLineMask(page_index, block_start, block_start + block->GetSizeInBytes());
+  }
+
+  s_ram_code_line_masks[page_index] = mask;
+  if (m_ram_block_map[page_index].empty())
+    Bus::ClearRAMCodePage(page_index);
+}
+
+void InvalidateBlocksForBreakpoint(VirtualMemoryAddress address)
+{
+  for (const auto& it : s_blocks)
+  {
+    CodeBlock* block = it.second;
+    if (!block || block->invalidated || address < block->GetPC() ||
+        address >= (block->GetPC() + block->GetSizeInBytes()))
+    {
+      continue;
+    }
+
+    // revalidation sees that the breakpoints have changed, and recompiles it
+    RemoveBlockFromPageMap(block);
+    InvalidateBlock(block, false);
+  }
+
+  // the cached interpreter has to switch to the loop which checks breakpoints, or back
+  if (g_settings.cpu_execution_mode == CPUExecutionMode::CachedInterpreter &&
+      HasAnyBreakpoints() != s_execute_breakpoints)
+  {
+    ForceDispatcherExit();
+  }
+}
+
+bool HaveBlockBreakpointsChanged(const CodeBlock* block)
+{
+  if (!HasAnyBreakpoints())
+    return block->breakpoint;
+
+  if (block->breakpoint != HasBreakpointAtAddress(block->GetPC()))
+    return true;
+
+  for (size_t i = 1; i < block->instructions.size(); i++)
+  {
+    const CodeBlockInstruction& cbi = block->instructions[i];
+    if (!cbi.is_branch_delay_slot && HasBreakpointAtAddress(cbi.pc))
+      return true;
+  }
+
+  return false;
+}
+
+void GetCodeBufferStatistics(CodeBufferStatistics* stats)
+{
+#if defined(WITH_RECOMPILER) && defined(USE_STATIC_CODE_BUFFER)
+  stats->region_count = RECOMPILER_CODE_REGION_COUNT;
+  stats->current_region = s_current_code_region;
+  stats->eviction_count = s_code_region_evictions;
+  stats->evicted_block_count = s_evicted_block_count;
+#else
+  stats->region_count = 1;
+  stats->current_region = 0;
+  stats->eviction_count = 0;
+  stats->evicted_block_count = 0;
+#endif
+  stats->recompile_count = s_recompile_count;
+  stats->flush_count = s_flush_count;
+}
+
+bool GetBlockStatistics(VirtualMemoryAddress pc, BlockStatistics* stats)
+{
+  CodeBlockKey key = {};
+  key.SetPC(pc);
+
+  for (u32 user_mode = 0; user_mode < 2; user_mode++)
+  {
+    key.user_mode = (user_mode != 0);
+    const auto iter = s_blocks.find(key.bits);
+    if (iter == s_blocks.end() || !iter->second)
+      continue;
+
+    const CodeBlock* block = iter->second;
+    stats->instruction_count = static_cast<u32>(block->instructions.size());
+    stats->recompile_count = block->recompile_count;
+    stats->recompile_frame_number = block->recompile_frame_number;
+    stats->invalidate_frame_number = block->invalidate_frame_number;
+    stats->invalidated = block->invalidated;
+    stats->can_link = block->can_link;
+    return true;
+  }
+
+  return false;
+}
+
 void InvalidateAll()
 {
   for (auto& it : s_blocks)
@@ -910,11 +2949,209 @@ void InvalidateAll()
   Bus::ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
+  s_ram_code_line_masks.fill(0);
+}
+
+bool HashBlockCode(u32 pc, u32 instruction_count, u64* hash)
+{
+  s_block_profile_scratch.resize(instruction_count);
+  for (u32 i = 0; i < instruction_count; i++)
+  {
+    if (!SafeReadInstruction(pc + (i * sizeof(u32)), &s_block_profile_scratch[i]))
+      return false;
+  }
+
+  *hash = XXH64(s_block_profile_scratch.data(), instruction_count * sizeof(u32), 0);
+  return true;
+}
+
+bool GetBlockProfileEntry(const CodeBlock* block, BlockProfileEntry* entry)
+{
+  // Double branches pull in code from elsewhere, so they can't be matched by reading memory linearly.
+  const u32 instruction_count = static_cast<u32>(block->instructions.size());
+  if (instruction_count == 0 || block->recompile_count > MAX_BLOCK_PROFILE_RECOMPILE_COUNT ||
+      block->instructions.back().pc != (block->GetPC() + (instruction_count - 1) * sizeof(u32)))
+  {
+    return false;
+  }
+
+  s_block_profile_scratch.resize(instruction_count);
+  for (u32 i = 0; i < instruction_count; i++)
+    s_block_profile_scratch[i] = block->instructions[i].instruction.bits;
+
+  entry->key = block->key.bits;
+  entry->instruction_count = instruction_count;
+  entry->instruction_hash = XXH64(s_block_profile_scratch.data(), instruction_count * sizeof(u32), 0);
+  entry->recompile_count = block->recompile_count;
+  return true;
+}
+
+bool HasSpaceForPrecompiledBlocks()
+{
+#ifdef WITH_RECOMPILER
+  // Leave room for blocks which weren't in the profile, flushing would throw away everything we've precompiled.
+  if (g_settings.IsUsingRecompiler())
+  {
+#ifdef USE_STATIC_CODE_BUFFER
+    // Only the current region counts, precompiled blocks in older regions would be evicted first.
+    return (GetBlockCodeBuffer().GetFreeCodeSpace() >= (RECOMPILER_CODE_REGION_SIZE / 4) &&
+            GetBlockCodeBuffer().GetFreeFarCodeSpace() >= (RECOMPILER_FAR_CODE_REGION_SIZE / 4));
+#else
+    return (s_code_buffer.GetFreeCodeSpace() >= (RECOMPILER_CODE_CACHE_SIZE / 4) &&
+            s_code_buffer.GetFreeFarCodeSpace() >= (RECOMPILER_FAR_CODE_CACHE_SIZE / 4));
+#endif
+  }
+#endif
+
+  return true;
+}
+
+void LoadBlockProfile(std::string path)
+{
+  s_block_profile_path = std::move(path);
+  s_block_profile_pending.clear();
+  s_block_profile_pending_stale.clear();
+  s_block_profile_cursor = 0;
+  s_block_profile_precompile_active = false;
+
+  std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(s_block_profile_path.c_str()));
+  if (!data.has_value())
+  {
+    Log_InfoPrintf("No block profile found at '%s'", s_block_profile_path.c_str());
+    return;
+  }
+
+  BlockProfileHeader header;
+  if (data->size() < sizeof(header))
+  {
+    Log_WarningPrintf("Block profile '%s' is truncated", s_block_profile_path.c_str());
+    return;
+  }
+
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (header.magic != BLOCK_PROFILE_MAGIC || header.version != BLOCK_PROFILE_VERSION ||
+      header.num_entries > MAX_BLOCK_PROFILE_ENTRIES ||
+      data->size() < (sizeof(header) + header.num_entries * sizeof(BlockProfileEntry)))
+  {
+    Log_WarningPrintf("Block profile '%s' is invalid or from a different version, ignoring", s_block_profile_path.c_str());
+    return;
+  }
+
+  s_block_profile_pending.resize(header.num_entries);
+  std::memcpy(s_block_profile_pending.data(), data->data() + sizeof(header),
+              header.num_entries * sizeof(BlockProfileEntry));
+  s_block_profile_pending_stale.assign(header.num_entries, false);
+  s_block_profile_precompile_active = !s_block_profile_pending.empty();
+  Log_InfoPrintf("Loaded %u blocks from profile '%s'", header.num_entries, s_block_profile_path.c_str());
+}
+
+void SaveBlockProfile()
+{
+  if (s_block_profile_path.empty())
+    return;
+
+  std::vector<BlockProfileEntry> entries;
+  entries.reserve(s_blocks.size() + s_block_profile_pending.size());
+  for (const auto& it : s_blocks)
+  {
+    BlockProfileEntry entry;
+    if (it.second && GetBlockProfileEntry(it.second, &entry))
+      entries.push_back(entry);
+  }
+
+  // Carry over blocks from the previous profile which we didn't get to this time, unless the code at their address
+  // was different whenever we looked. Those would otherwise stay in the profile forever.
+  for (size_t i = 0; i < s_block_profile_pending.size(); i++)
+  {
+    const BlockProfileEntry& entry = s_block_profile_pending[i];
+    if (!s_block_profile_pending_stale[i] && s_blocks.find(entry.key) == s_blocks.end())
+      entries.push_back(entry);
+  }
+
+  if (entries.size() > MAX_BLOCK_PROFILE_ENTRIES)
+    entries.resize(MAX_BLOCK_PROFILE_ENTRIES);
+
+  BlockProfileHeader header;
+  header.magic = BLOCK_PROFILE_MAGIC;
+  header.version = BLOCK_PROFILE_VERSION;
+  header.num_entries = static_cast<u32>(entries.size());
+
+  std::vector<u8> data(sizeof(header) + entries.size() * sizeof(BlockProfileEntry));
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::memcpy(data.data() + sizeof(header), entries.data(), entries.size() * sizeof(BlockProfileEntry));
+  if (!FileSystem::WriteBinaryFile(s_block_profile_path.c_str(), data.data(), data.size()))
+  {
+    Log_ErrorPrintf("Failed to write block profile to '%s'", s_block_profile_path.c_str());
+    return;
+  }
+
+  Log_InfoPrintf("Saved %u blocks to profile '%s'", header.num_entries, s_block_profile_path.c_str());
+}
+
+void PrecompileProfiledBlocks()
+{
+  if (!s_block_profile_precompile_active)
+    return;
+
+  Common::Timer timer;
+  u32 num_compiled = 0;
+  for (u32 checks = 0; checks < BLOCK_PROFILE_CHECKS_PER_FRAME && !s_block_profile_pending.empty(); checks++)
+  {
+    // checked first, so a run of stale entries can't skip it
+    if (timer.GetTimeMilliseconds() >= BLOCK_PROFILE_PRECOMPILE_TIME_BUDGET_MS)
+      break;
+
+    if (s_block_profile_cursor >= s_block_profile_pending.size())
+      s_block_profile_cursor = 0;
+
+    const BlockProfileEntry entry = s_block_profile_pending[s_block_profile_cursor];
+    if (s_blocks.find(entry.key) == s_blocks.end())
+    {
+      // Code for this block hasn't been loaded yet (or was overwritten), try again next frame.
+      CodeBlockKey key;
+      key.bits = entry.key;
+
+      u64 hash;
+      if (!HashBlockCode(key.GetPC(), entry.instruction_count, &hash) || hash != entry.instruction_hash)
+      {
+        s_block_profile_pending_stale[s_block_profile_cursor] = true;
+        s_block_profile_cursor++;
+        continue;
+      }
+
+      s_block_profile_pending_stale[s_block_profile_cursor] = false;
+      if (!HasSpaceForPrecompiledBlocks())
+      {
+        Log_WarningPrintf("Code space is running low, stopping block precompilation with %zu blocks remaining",
+                          s_block_profile_pending.size());
+        s_block_profile_precompile_active = false;
+        break;
+      }
+
+      if (LookupBlock(key, false))
+        num_compiled++;
+    }
+
+    // Block is either compiled now, or was already compiled by execution, so we don't need it any more.
+    s_block_profile_pending[s_block_profile_cursor] = s_block_profile_pending.back();
+    s_block_profile_pending.pop_back();
+    s_block_profile_pending_stale[s_block_profile_cursor] = s_block_profile_pending_stale.back();
+    s_block_profile_pending_stale.pop_back();
+  }
+
+  if (num_compiled > 0)
+  {
+    Log_DevPrintf("Precompiled %u profiled blocks in %.2f ms, %zu remaining", num_compiled,
+                  timer.GetTimeMilliseconds(), s_block_profile_pending.size());
+  }
+
+  if (s_block_profile_pending.empty())
+    s_block_profile_precompile_active = false;
 }
 
 void RemoveReferencesToBlock(CodeBlock* block)
 {
-  BlockMap::iterator iter = s_blocks.find(block->key.GetPC());
+  BlockMap::iterator iter = s_blocks.find(block->key.bits);
   Assert(iter != s_blocks.end() && iter->second == block);
 
 #ifdef WITH_RECOMPILER
@@ -939,11 +3176,14 @@ void AddBlockToPageMap(CodeBlock* block)
   if (!block->IsInRAM())
     return;
 
+  const u32 start_address = block->key.GetPCPhysicalAddress();
+  const u32 end_address = start_address + block->GetSizeInBytes();
   const u32 start_page = block->GetStartPageIndex();
   const u32 end_page = block->GetEndPageIndex();
   for (u32 page = start_page; page <= end_page; page++)
   {
     m_ram_block_map[page].push_back(block);
+    s_ram_code_line_masks[page] |= GetCodeLineMask(page, start_address, end_address);
     Bus::SetRAMCodePage(page);
   }
 }
@@ -1013,6 +3253,10 @@ void UnlinkBlock(CodeBlock* block)
       Log_ProfilePrintf("Backpatching %p(%08x) [predecessor] to jump to resolver", li.host_pc, li.block->GetPC());
       Recompiler::CodeGenerator::BackpatchBranch(li.host_pc, li.host_pc_size, li.host_resolve_pc);
     }
+    else if (li.block->indirect_branch_host_code == block->host_code)
+    {
+      ResetIndirectBranchCache(li.block);
+    }
 #endif
 
     li.block->link_successors.erase(iter);
@@ -1039,6 +3283,7 @@ void UnlinkBlock(CodeBlock* block)
     li.block->link_predecessors.erase(iter);
   }
   block->link_successors.clear();
+  ResetIndirectBranchCache(block);
 
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler() && g_settings.cpu_recompiler_block_linking)
@@ -1053,8 +3298,23 @@ void AddBlockToHostCodeMap(CodeBlock* block)
   if (!g_settings.IsUsingRecompiler())
     return;
 
+  // Blocks pending async compilation don't have any host code yet.
+  if (!block->host_code)
+    return;
+
   auto ir = s_host_code_map.emplace(block->host_code, block);
   Assert(ir.second);
+
+#ifdef USE_PERF_MAP
+  // perf has no way to retire a symbol, a later entry covering the same address takes precedence.
+  if (s_perf_map_file)
+  {
+    const std::string& serial = System::GetRunningSerial();
+    const std::string name(StringUtil::StdStringFromFormat(
+      "psx_%s%s%08X", serial.c_str(), serial.empty() ? "" : "_", block->GetPC()));
+    WritePerfMapEntry(reinterpret_cast<const void*>(block->host_code), block->host_code_size, name.c_str());
+  }
+#endif
 }
 
 void RemoveBlockFromHostCodeMap(CodeBlock* block)
@@ -1062,6 +3322,9 @@ void RemoveBlockFromHostCodeMap(CodeBlock* block)
   if (!g_settings.IsUsingRecompiler())
     return;
 
+  if (!block->host_code)
+    return;
+
   HostCodeMap::iterator hc_iter = s_host_code_map.find(block->host_code);
   Assert(hc_iter != s_host_code_map.end());
   s_host_code_map.erase(hc_iter);
@@ -1079,8 +3342,12 @@ bool InitializeFastmem()
   Assert(mode != CPUFastmemMode::MMap);
 #endif
 
+#ifdef USE_STATIC_CODE_BUFFER
+  if (!Common::PageFaultHandler::InstallHandler(&s_host_code_map, s_code_storage, sizeof(s_code_storage), handler))
+#else
   if (!Common::PageFaultHandler::InstallHandler(&s_host_code_map, s_code_buffer.GetCodePointer(),
                                                 s_code_buffer.GetTotalSize(), handler))
+#endif
   {
     Log_ErrorPrintf("Failed to install page fault handler");
     return false;
@@ -1134,12 +3401,25 @@ Common::PageFaultHandler::HandlerResult MMapPageFaultHandler(void* exception_pc,
       if (is_write && !g_state.cop0_regs.sr.Isc && Bus::IsRAMAddress(fastmem_address))
       {
         // this is probably a code page, since we aren't going to fault due to requiring fastmem on RAM.
-        const u32 code_page_index = Bus::GetRAMCodePageIndex(fastmem_address);
-        if (Bus::IsRAMCodePage(code_page_index))
+        // the write-protected host page can be larger than a code page, in which case the code pages around the
+        // one written share the fault, and have to be invalidated for the host page to become writable again.
+        const u32 pages_per_protected_page = Bus::GetCodePagesPerProtectedPage();
+        const u32 first_code_page_index =
+          Bus::GetRAMCodePageIndex(fastmem_address) & ~(pages_per_protected_page - 1);
+        bool has_code = false;
+        for (u32 i = 0; i < pages_per_protected_page; i++)
+          has_code |= Bus::IsRAMCodePage(first_code_page_index + i);
+
+        if (has_code)
         {
           if (++lbi.fault_count < CODE_WRITE_FAULT_THRESHOLD_FOR_SLOWMEM)
           {
-            InvalidateBlocksWithPageIndex(code_page_index);
+            for (u32 i = 0; i < pages_per_protected_page; i++)
+            {
+              if (Bus::IsRAMCodePage(first_code_page_index + i))
+                InvalidateBlocksWithPageIndex(first_code_page_index + i);
+            }
+
             return Common::PageFaultHandler::HandlerResult::ContinueExecution;
           }
           else
@@ -1156,6 +3436,10 @@ Common::PageFaultHandler::HandlerResult MMapPageFaultHandler(void* exception_pc,
       s_code_buffer.WriteProtect(true);
       if (backpatch_result)
       {
+        // remember it for when the block is recompiled
+        AddSlowmemGuestPC(lbi.guest_pc);
+        RecordBackpatch(block);
+
         // remove the backpatch entry since we won't be coming back to this one
         block->loadstore_backpatch_info.erase(bpi_iter);
         return Common::PageFaultHandler::HandlerResult::ContinueExecution;
@@ -1200,6 +3484,10 @@ Common::PageFaultHandler::HandlerResult LUTPageFaultHandler(void* exception_pc,
       s_code_buffer.WriteProtect(true);
       if (backpatch_result)
       {
+        // remember it for when the block is recompiled
+        AddSlowmemGuestPC(lbi.guest_pc);
+        RecordBackpatch(block);
+
         // remove the backpatch entry since we won't be coming back to this one
         block->loadstore_backpatch_info.erase(bpi_iter);
         return Common::PageFaultHandler::HandlerResult::ContinueExecution;
@@ -1223,12 +3511,29 @@ Common::PageFaultHandler::HandlerResult LUTPageFaultHandler(void* exception_pc,
 
 #ifdef WITH_RECOMPILER
 
+void CPU::Recompiler::Thunks::SkipIdleLoop(CodeBlock* block)
+{
+  CPU::CodeCache::SkipIdleLoop(block);
+}
+
+bool CPU::Recompiler::Thunks::HLEBIOSCall()
+{
+  return CPU::CodeCache::HLEBIOSCall();
+}
+
 void CPU::Recompiler::Thunks::ResolveBranch(CodeBlock* block, void* host_pc, void* host_resolve_pc, u32 host_pc_size)
 {
   using namespace CPU::CodeCache;
 
   CodeBlockKey key = GetNextBlockKey();
   CodeBlock* successor_block = LookupBlock(key, false);
+
+#ifdef USE_ASYNC_COMPILATION
+  // Successor is still being compiled in the background, leave the branch alone so we try again next time.
+  if (successor_block && !successor_block->host_code)
+    return;
+#endif
+
   if (!successor_block || (successor_block->invalidated && !RevalidateBlock(successor_block, false)) ||
       !block->can_link || !successor_block->can_link)
   {
@@ -1244,6 +3549,39 @@ void CPU::Recompiler::Thunks::ResolveBranch(CodeBlock* block, void* host_pc, voi
   }
 }
 
+void CPU::Recompiler::Thunks::ResolveIndirectBranch(CodeBlock* block)
+{
+  using namespace CPU::CodeCache;
+
+  CodeBlockKey key = GetNextBlockKey();
+  CodeBlock* successor_block = LookupBlock(key, false);
+  if (!successor_block || !successor_block->host_code ||
+      (successor_block->invalidated && !RevalidateBlock(successor_block, false)) || !block->can_link ||
+      !successor_block->can_link || successor_block->key.user_mode != block->key.user_mode)
+  {
+    return;
+  }
+
+  // only the last target is cached, so drop the link to the previous one
+  auto iter = std::find_if(block->link_successors.begin(), block->link_successors.end(),
+                           [](const CodeBlock::LinkInfo& li) { return !li.host_pc; });
+  if (iter != block->link_successors.end())
+  {
+    CodeBlock* previous_block = iter->block;
+    block->link_successors.erase(iter);
+
+    auto pred_iter = std::find_if(previous_block->link_predecessors.begin(), previous_block->link_predecessors.end(),
+                                  [block](const CodeBlock::LinkInfo& li) { return li.block == block; });
+    Assert(pred_iter != previous_block->link_predecessors.end());
+    previous_block->link_predecessors.erase(pred_iter);
+  }
+
+  // the link has no code to patch, it's only there so the cache is reset when the successor goes away
+  LinkBlock(block, successor_block, nullptr, nullptr, 0);
+  block->indirect_branch_pc = successor_block->GetPC();
+  block->indirect_branch_host_code = successor_block->host_code;
+}
+
 void CPU::Recompiler::Thunks::LogPC(u32 pc)
 {
 #if 0
@@ -7,6 +7,7 @@
 #include <array>
 #include <map>
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -39,6 +40,9 @@ union CodeBlockKey
   ALWAYS_INLINE bool operator<(const CodeBlockKey& rhs) const { return bits < rhs.bits; }
 };
 
+/// Executes one instruction in the cached interpreter, without going through the decoder.
+using CachedInterpreterHandler = void (*)(Instruction inst);
+
 struct CodeBlockInstruction
 {
   Instruction instruction;
@@ -54,6 +58,15 @@ struct CodeBlockInstruction
   bool is_last_instruction : 1;
   bool has_load_delay : 1;
   bool can_trap : 1;
+  bool is_trace_side_exit : 1;
+  bool can_skip_load_delay : 1;
+  bool force_slowmem : 1;
+
+  // GPRs whose values can still be read while or after this instruction executes, bit per register.
+  u32 live_reg_mask;
+
+  // Pre-decoded handler for the cached interpreter, or null when the instruction needs the full interpreter.
+  CachedInterpreterHandler interpreter_handler;
 };
 
 struct CodeBlock
@@ -83,6 +96,9 @@ struct CodeBlock
 
 #ifdef WITH_RECOMPILER
   std::vector<Recompiler::LoadStoreBackpatchInfo> loadstore_backpatch_info;
+
+  // Index of the recompiler statistics entry for this compilation of the block, if statistics are being collected.
+  u32 statistics_index = UINT32_C(0xFFFFFFFF);
 #endif
 
   bool contains_loadstore_instructions = false;
@@ -90,14 +106,39 @@ struct CodeBlock
   bool invalidated = false;
   bool can_link = true;
 
+  // Block only polls memory and branches back to itself, so it can skip ahead to the next event.
+  bool idle_loop = false;
+
+  // Block is the kernel's A0 call stub, so known memory routines can be performed natively instead.
+  bool bios_hle = false;
+
+  // Block starts at a breakpoint, which is checked before it executes. Blocks end before any other breakpoint.
+  bool breakpoint = false;
+
+  // Generated code counts executions while count_executions is set, so hot blocks can be moved to the hot region.
+  u32 execution_count = 0;
+  bool count_executions = false;
+
   u32 recompile_frame_number = 0;
   u32 recompile_count = 0;
   u32 invalidate_frame_number = 0;
 
+  // Number of conditional branches the block continues through on their fall-through side.
+  // Outcomes of the final branch are counted while profile_branches is set, to decide whether to extend further.
+  u32 trace_branch_count = 0;
+  u32 branch_taken_count = 0;
+  u32 branch_not_taken_count = 0;
+  bool profile_branches = false;
+
+  // Target of the block's indirect branch the last time it was resolved, jumped to directly while it matches.
+  // Only the PC is compared, blocks which can change the CPU mode don't use it, so the target is in the same mode.
+  u32 indirect_branch_pc = 0;
+  HostCodePointer indirect_branch_host_code = nullptr;
+
   u32 GetPC() const { return key.GetPC(); }
   u32 GetSizeInBytes() const { return static_cast<u32>(instructions.size()) * sizeof(Instruction); }
-  u32 GetStartPageIndex() const { return (key.GetPCPhysicalAddress() / HOST_PAGE_SIZE); }
-  u32 GetEndPageIndex() const { return ((key.GetPCPhysicalAddress() + GetSizeInBytes()) / HOST_PAGE_SIZE); }
+  u32 GetStartPageIndex() const { return (key.GetPCPhysicalAddress() / CODE_PAGE_SIZE); }
+  u32 GetEndPageIndex() const { return ((key.GetPCPhysicalAddress() + GetSizeInBytes()) / CODE_PAGE_SIZE); }
   bool IsInRAM() const
   {
     // TODO: Constant
@@ -137,24 +178,102 @@ void Reinitialize();
 /// Invalidates all blocks which are in the range of the specified code page.
 void InvalidateBlocksWithPageIndex(u32 page_index);
 
+/// Invalidates only the blocks which overlap the specified range of RAM, writes to data sharing a page with code
+/// leave the code alone.
+void InvalidateBlocksInRange(PhysicalMemoryAddress start_address, u32 size);
+
+/// Invalidates any blocks which contain the specified address, so they are split at, or no longer split at, a
+/// breakpoint which has been added or removed there.
+void InvalidateBlocksForBreakpoint(VirtualMemoryAddress address);
+
+/// Returns the byte of the code line masks which covers the specified RAM offset, and the bit for its line. The bit is
+/// set while the line holds code, so generated code can check it before invalidating.
+const u8* GetRAMCodeLineMaskByte(u32 offset, u8* bit);
+
+struct BlockStatistics
+{
+  u32 instruction_count;
+  u32 recompile_count;
+  u32 recompile_frame_number;
+  u32 invalidate_frame_number;
+  bool invalidated;
+  bool can_link;
+};
+
+/// Retrieves statistics for the block starting at the specified address, if one exists. Intended for the debugger.
+bool GetBlockStatistics(VirtualMemoryAddress pc, BlockStatistics* stats);
+
+struct CodeBufferStatistics
+{
+  u32 region_count;
+  u32 current_region;
+  u32 eviction_count;
+  u32 evicted_block_count;
+  u32 recompile_count;
+  u32 flush_count;
+};
+
+/// Retrieves how often the recompiler ran out of code space and had to evict its oldest region, and how often blocks
+/// were recompiled after their code changed or the whole cache was flushed.
+void GetCodeBufferStatistics(CodeBufferStatistics* stats);
+
+#ifdef WITH_RECOMPILER
+/// Logs histograms of the per-block statistics collected while cpu_recompiler_statistics is enabled. If csv_path is
+/// not null, the statistics for every block compiled are written there as well.
+void DumpStatistics(const char* csv_path);
+
+/// Writes the guest code of the blocks in the cache to path, so they can be recompiled later with ReplayBlockSet().
+bool SaveBlockSet(const char* path);
+
+/// Recompiles every block from a set written by SaveBlockSet(), recording statistics for each one. The saved code is
+/// copied into guest memory while compiling, and the previous contents are restored afterwards. This is only intended
+/// for comparing code generator changes offline, and must not be called while the system is running.
+bool ReplayBlockSet(const char* path);
+#endif
+
 /// Invalidates all blocks in the cache.
 void InvalidateAll();
 
+/// Loads a block profile recorded by a previous session. Profiled blocks are compiled ahead of execution once the
+/// code they were recorded with is present in memory.
+void LoadBlockProfile(std::string path);
+
+/// Writes the blocks in the cache, along with any profiled blocks which were not reached, to the profile path.
+void SaveBlockProfile();
+
+/// Compiles profiled blocks whose code matches what is currently in memory, within a fixed time budget.
+/// Call between frames, i.e. not while executing generated code.
+void PrecompileProfiledBlocks();
+
+/// Recompiles blocks whose final branch is hot and almost never taken as traces which continue through it.
+/// Call between frames, i.e. not while executing generated code.
+void FormHotTraces();
+
+/// Recompiles the blocks which ran the most since the last pass next to each other in the hot code region.
+/// Call between frames, i.e. not while executing generated code.
+void LayoutHotBlocks();
+
+/// Returns the handler for an instruction which the cached interpreter can run directly, otherwise nullptr.
+CachedInterpreterHandler GetCachedInterpreterHandler(const Instruction inst);
+
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const CodeBlock& block);
 
 template<PGXPMode pgxp_mode>
 void InterpretUncachedBlock();
 
-/// Invalidates any code pages which overlap the specified range.
+/// Invalidates any blocks which overlap the specified range.
 ALWAYS_INLINE void InvalidateCodePages(PhysicalMemoryAddress address, u32 word_count)
 {
-  const u32 start_page = address / HOST_PAGE_SIZE;
-  const u32 end_page = (address + word_count * sizeof(u32) - sizeof(u32)) / HOST_PAGE_SIZE;
+  const u32 start_page = address / CODE_PAGE_SIZE;
+  const u32 end_page = (address + word_count * sizeof(u32) - sizeof(u32)) / CODE_PAGE_SIZE;
   for (u32 page = start_page; page <= end_page; page++)
   {
     if (Bus::m_ram_code_bits[page])
-      CPU::CodeCache::InvalidateBlocksWithPageIndex(page);
+    {
+      CPU::CodeCache::InvalidateBlocksInRange(address, word_count * sizeof(u32));
+      return;
+    }
   }
 }
 
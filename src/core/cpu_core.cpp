@@ -3,6 +3,7 @@
 #include "common/align.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "cpu_code_cache.h"
 #include "cpu_core_private.h"
 #include "cpu_disasm.h"
 #include "cpu_recompiler_thunks.h"
@@ -1621,7 +1622,10 @@ void DispatchInterrupt()
 
 void UpdateDebugDispatcherFlag()
 {
-  const bool has_any_breakpoints = !s_breakpoints.empty();
+  // The code cache splits blocks at breakpoints and checks them on block entry, so only the interpreter needs the
+  // debug dispatcher for them.
+  const bool has_any_breakpoints =
+    !s_breakpoints.empty() && g_settings.cpu_execution_mode == CPUExecutionMode::Interpreter;
 
   // TODO: cop0 breakpoints
   const auto& dcic = g_state.cop0_regs.dcic;
@@ -1687,6 +1691,7 @@ bool AddBreakpoint(VirtualMemoryAddress address, bool auto_clear, bool enabled)
 
   Breakpoint bp{address, nullptr, auto_clear ? 0 : s_breakpoint_counter++, 0, auto_clear, enabled};
   s_breakpoints.push_back(std::move(bp));
+  CodeCache::InvalidateBlocksForBreakpoint(address);
   UpdateDebugDispatcherFlag();
 
   if (!auto_clear)
@@ -1707,6 +1712,7 @@ bool AddBreakpointWithCallback(VirtualMemoryAddress address, BreakpointCallback
 
   Breakpoint bp{address, callback, 0, 0, false, true};
   s_breakpoints.push_back(std::move(bp));
+  CodeCache::InvalidateBlocksForBreakpoint(address);
   UpdateDebugDispatcherFlag();
   return true;
 }
@@ -1722,6 +1728,7 @@ bool RemoveBreakpoint(VirtualMemoryAddress address)
                                        address);
 
   s_breakpoints.erase(it);
+  CodeCache::InvalidateBlocksForBreakpoint(address);
   UpdateDebugDispatcherFlag();
 
   if (address == s_last_breakpoint_check_pc)
@@ -1732,7 +1739,11 @@ bool RemoveBreakpoint(VirtualMemoryAddress address)
 
 void ClearBreakpoints()
 {
+  const BreakpointList breakpoints(std::move(s_breakpoints));
   s_breakpoints.clear();
+  for (const Breakpoint& bp : breakpoints)
+    CodeCache::InvalidateBlocksForBreakpoint(bp.address);
+
   s_breakpoint_counter = 0;
   s_last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
   UpdateDebugDispatcherFlag();
@@ -1871,7 +1882,23 @@ ALWAYS_INLINE_RELEASE static bool BreakpointCheck()
   }
 
   s_last_breakpoint_check_pc = pc;
-  return System::IsPaused();
+
+  // callbacks can also leave the dispatcher before the instruction runs
+  return System::IsPaused() || g_state.frame_done;
+}
+
+bool CheckBlockBreakpoint()
+{
+  // Unlike the interpreter, we're not called for every instruction, so the pc we stopped at has to be forgotten once
+  // we resume from it, otherwise we'd never stop there again.
+  if (!BreakpointCheck())
+  {
+    s_last_breakpoint_check_pc = INVALID_BREAKPOINT_PC;
+    return false;
+  }
+
+  ForceDispatcherExit();
+  return true;
 }
 
 template<PGXPMode pgxp_mode, bool debug>
@@ -1980,6 +2007,302 @@ void SingleStep()
 
 namespace CodeCache {
 
+// Handlers for the most common instructions, used by the cached interpreter when PGXP is off. These must match the
+// PGXPMode::Disabled paths in ExecuteInstruction(), and instructions which raise exceptions other than through
+// memory accesses or branches stay in the interpreter.
+namespace CachedInterpreterHandlers {
+
+static void nop(const Instruction inst) {}
+
+static void sll(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rt) << inst.r.shamt);
+}
+
+static void srl(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rt) >> inst.r.shamt);
+}
+
+static void sra(const Instruction inst)
+{
+  WriteReg(inst.r.rd, static_cast<u32>(static_cast<s32>(ReadReg(inst.r.rt)) >> inst.r.shamt));
+}
+
+static void sllv(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rt) << (ReadReg(inst.r.rs) & UINT32_C(0x1F)));
+}
+
+static void srlv(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rt) >> (ReadReg(inst.r.rs) & UINT32_C(0x1F)));
+}
+
+static void srav(const Instruction inst)
+{
+  WriteReg(inst.r.rd, static_cast<u32>(static_cast<s32>(ReadReg(inst.r.rt)) >> (ReadReg(inst.r.rs) & UINT32_C(0x1F))));
+}
+
+static void and_(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rs) & ReadReg(inst.r.rt));
+}
+
+static void or_(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rs) | ReadReg(inst.r.rt));
+}
+
+static void xor_(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rs) ^ ReadReg(inst.r.rt));
+}
+
+static void nor(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ~(ReadReg(inst.r.rs) | ReadReg(inst.r.rt)));
+}
+
+static void addu(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rs) + ReadReg(inst.r.rt));
+}
+
+static void subu(const Instruction inst)
+{
+  WriteReg(inst.r.rd, ReadReg(inst.r.rs) - ReadReg(inst.r.rt));
+}
+
+static void slt(const Instruction inst)
+{
+  WriteReg(inst.r.rd, BoolToUInt32(static_cast<s32>(ReadReg(inst.r.rs)) < static_cast<s32>(ReadReg(inst.r.rt))));
+}
+
+static void sltu(const Instruction inst)
+{
+  WriteReg(inst.r.rd, BoolToUInt32(ReadReg(inst.r.rs) < ReadReg(inst.r.rt)));
+}
+
+static void lui(const Instruction inst)
+{
+  WriteReg(inst.i.rt, inst.i.imm_zext32() << 16);
+}
+
+static void andi(const Instruction inst)
+{
+  WriteReg(inst.i.rt, ReadReg(inst.i.rs) & inst.i.imm_zext32());
+}
+
+static void ori(const Instruction inst)
+{
+  WriteReg(inst.i.rt, ReadReg(inst.i.rs) | inst.i.imm_zext32());
+}
+
+static void xori(const Instruction inst)
+{
+  WriteReg(inst.i.rt, ReadReg(inst.i.rs) ^ inst.i.imm_zext32());
+}
+
+static void addiu(const Instruction inst)
+{
+  WriteReg(inst.i.rt, ReadReg(inst.i.rs) + inst.i.imm_sext32());
+}
+
+static void slti(const Instruction inst)
+{
+  WriteReg(inst.i.rt, BoolToUInt32(static_cast<s32>(ReadReg(inst.i.rs)) < static_cast<s32>(inst.i.imm_sext32())));
+}
+
+static void sltiu(const Instruction inst)
+{
+  WriteReg(inst.i.rt, BoolToUInt32(ReadReg(inst.i.rs) < inst.i.imm_sext32()));
+}
+
+static void lb(const Instruction inst)
+{
+  u8 value;
+  if (ReadMemoryByte(ReadReg(inst.i.rs) + inst.i.imm_sext32(), &value))
+    WriteRegDelayed(inst.i.rt, SignExtend32(value));
+}
+
+static void lbu(const Instruction inst)
+{
+  u8 value;
+  if (ReadMemoryByte(ReadReg(inst.i.rs) + inst.i.imm_sext32(), &value))
+    WriteRegDelayed(inst.i.rt, ZeroExtend32(value));
+}
+
+static void lh(const Instruction inst)
+{
+  u16 value;
+  if (ReadMemoryHalfWord(ReadReg(inst.i.rs) + inst.i.imm_sext32(), &value))
+    WriteRegDelayed(inst.i.rt, SignExtend32(value));
+}
+
+static void lhu(const Instruction inst)
+{
+  u16 value;
+  if (ReadMemoryHalfWord(ReadReg(inst.i.rs) + inst.i.imm_sext32(), &value))
+    WriteRegDelayed(inst.i.rt, ZeroExtend32(value));
+}
+
+static void lw(const Instruction inst)
+{
+  u32 value;
+  if (ReadMemoryWord(ReadReg(inst.i.rs) + inst.i.imm_sext32(), &value))
+    WriteRegDelayed(inst.i.rt, value);
+}
+
+static void sb(const Instruction inst)
+{
+  WriteMemoryByte(ReadReg(inst.i.rs) + inst.i.imm_sext32(), ReadReg(inst.i.rt));
+}
+
+static void sh(const Instruction inst)
+{
+  WriteMemoryHalfWord(ReadReg(inst.i.rs) + inst.i.imm_sext32(), ReadReg(inst.i.rt));
+}
+
+static void sw(const Instruction inst)
+{
+  WriteMemoryWord(ReadReg(inst.i.rs) + inst.i.imm_sext32(), ReadReg(inst.i.rt));
+}
+
+static void j(const Instruction inst)
+{
+  g_state.next_instruction_is_branch_delay_slot = true;
+  Branch((g_state.regs.pc & UINT32_C(0xF0000000)) | (inst.j.target << 2));
+}
+
+static void jal(const Instruction inst)
+{
+  WriteReg(Reg::ra, g_state.regs.npc);
+  g_state.next_instruction_is_branch_delay_slot = true;
+  Branch((g_state.regs.pc & UINT32_C(0xF0000000)) | (inst.j.target << 2));
+}
+
+static void beq(const Instruction inst)
+{
+  g_state.next_instruction_is_branch_delay_slot = true;
+  if (ReadReg(inst.i.rs) == ReadReg(inst.i.rt))
+    Branch(g_state.regs.pc + (inst.i.imm_sext32() << 2));
+}
+
+static void bne(const Instruction inst)
+{
+  g_state.next_instruction_is_branch_delay_slot = true;
+  if (ReadReg(inst.i.rs) != ReadReg(inst.i.rt))
+    Branch(g_state.regs.pc + (inst.i.imm_sext32() << 2));
+}
+
+static void blez(const Instruction inst)
+{
+  g_state.next_instruction_is_branch_delay_slot = true;
+  if (static_cast<s32>(ReadReg(inst.i.rs)) <= 0)
+    Branch(g_state.regs.pc + (inst.i.imm_sext32() << 2));
+}
+
+static void bgtz(const Instruction inst)
+{
+  g_state.next_instruction_is_branch_delay_slot = true;
+  if (static_cast<s32>(ReadReg(inst.i.rs)) > 0)
+    Branch(g_state.regs.pc + (inst.i.imm_sext32() << 2));
+}
+
+} // namespace CachedInterpreterHandlers
+
+CachedInterpreterHandler GetCachedInterpreterHandler(const Instruction inst)
+{
+  if (inst.bits == 0)
+    return &CachedInterpreterHandlers::nop;
+
+  switch (inst.op)
+  {
+    case InstructionOp::funct:
+    {
+      switch (inst.r.funct)
+      {
+        case InstructionFunct::sll:
+          return &CachedInterpreterHandlers::sll;
+        case InstructionFunct::srl:
+          return &CachedInterpreterHandlers::srl;
+        case InstructionFunct::sra:
+          return &CachedInterpreterHandlers::sra;
+        case InstructionFunct::sllv:
+          return &CachedInterpreterHandlers::sllv;
+        case InstructionFunct::srlv:
+          return &CachedInterpreterHandlers::srlv;
+        case InstructionFunct::srav:
+          return &CachedInterpreterHandlers::srav;
+        case InstructionFunct::and_:
+          return &CachedInterpreterHandlers::and_;
+        case InstructionFunct::or_:
+          return &CachedInterpreterHandlers::or_;
+        case InstructionFunct::xor_:
+          return &CachedInterpreterHandlers::xor_;
+        case InstructionFunct::nor:
+          return &CachedInterpreterHandlers::nor;
+        case InstructionFunct::addu:
+          return &CachedInterpreterHandlers::addu;
+        case InstructionFunct::subu:
+          return &CachedInterpreterHandlers::subu;
+        case InstructionFunct::slt:
+          return &CachedInterpreterHandlers::slt;
+        case InstructionFunct::sltu:
+          return &CachedInterpreterHandlers::sltu;
+        default:
+          return nullptr;
+      }
+    }
+
+    case InstructionOp::lui:
+      return &CachedInterpreterHandlers::lui;
+    case InstructionOp::andi:
+      return &CachedInterpreterHandlers::andi;
+    case InstructionOp::ori:
+      return &CachedInterpreterHandlers::ori;
+    case InstructionOp::xori:
+      return &CachedInterpreterHandlers::xori;
+    case InstructionOp::addiu:
+      return &CachedInterpreterHandlers::addiu;
+    case InstructionOp::slti:
+      return &CachedInterpreterHandlers::slti;
+    case InstructionOp::sltiu:
+      return &CachedInterpreterHandlers::sltiu;
+    case InstructionOp::lb:
+      return &CachedInterpreterHandlers::lb;
+    case InstructionOp::lbu:
+      return &CachedInterpreterHandlers::lbu;
+    case InstructionOp::lh:
+      return &CachedInterpreterHandlers::lh;
+    case InstructionOp::lhu:
+      return &CachedInterpreterHandlers::lhu;
+    case InstructionOp::lw:
+      return &CachedInterpreterHandlers::lw;
+    case InstructionOp::sb:
+      return &CachedInterpreterHandlers::sb;
+    case InstructionOp::sh:
+      return &CachedInterpreterHandlers::sh;
+    case InstructionOp::sw:
+      return &CachedInterpreterHandlers::sw;
+    case InstructionOp::j:
+      return &CachedInterpreterHandlers::j;
+    case InstructionOp::jal:
+      return &CachedInterpreterHandlers::jal;
+    case InstructionOp::beq:
+      return &CachedInterpreterHandlers::beq;
+    case InstructionOp::bne:
+      return &CachedInterpreterHandlers::bne;
+    case InstructionOp::blez:
+      return &CachedInterpreterHandlers::blez;
+    case InstructionOp::bgtz:
+      return &CachedInterpreterHandlers::bgtz;
+    default:
+      return nullptr;
+  }
+}
+
 template<PGXPMode pgxp_mode>
 void InterpretCachedBlock(const CodeBlock& block)
 {
@@ -2003,14 +2326,21 @@ void InterpretCachedBlock(const CodeBlock& block)
     g_state.regs.pc = g_state.regs.npc;
     g_state.regs.npc += 4;
 
-    // execute the instruction we previously fetched
-    ExecuteInstruction<pgxp_mode, false>();
+    // execute the instruction we previously fetched, skipping the decoder when possible
+    if (pgxp_mode == PGXPMode::Disabled && cbi.interpreter_handler)
+      cbi.interpreter_handler(cbi.instruction);
+    else
+      ExecuteInstruction<pgxp_mode, false>();
 
     // next load delay
     UpdateLoadDelay();
 
     if (g_state.exception_raised)
       break;
+
+    // traces continue past conditional branches, so leave the block if the branch was taken
+    if (cbi.is_branch_delay_slot && !cbi.is_last_instruction && g_state.regs.pc != (&cbi + 1)->pc)
+      break;
   }
 
   // cleanup so the interpreter can kick in if needed
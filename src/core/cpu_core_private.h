@@ -23,6 +23,10 @@ ALWAYS_INLINE void CheckForPendingInterrupt()
 void DispatchInterrupt();
 void UpdateDebugDispatcherFlag();
 
+/// Checks breakpoints when entering a code cache block which starts at one. Returns true if execution was paused,
+/// in which case the block must not be executed.
+bool CheckBlockBreakpoint();
+
 // icache stuff
 ALWAYS_INLINE bool IsCachedAddress(VirtualMemoryAddress address)
 {
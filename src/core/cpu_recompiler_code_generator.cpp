@@ -49,7 +49,10 @@ bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* o
   if (!m_block_linked)
   {
     BlockEpilogue();
-    EmitEndBlock(true, true);
+    if (m_indirect_branch_cache && !m_block_changes_mode)
+      EmitIndirectBranchCacheExit();
+    else
+      EmitEndBlock(true, true);
   }
 
   FinalizeBlock(out_host_code, out_host_code_size);
@@ -961,6 +964,25 @@ void CodeGenerator::BlockPrologue()
   EmitFunctionCall(nullptr, &Thunks::LogPC, Value::FromConstantU32(m_pc));
 #endif
 
+  // leave before executing anything if the breakpoint at the start of the block paused us
+  if (m_block->breakpoint)
+  {
+    Value paused = m_register_cache.AllocateScratch(RegSize_8);
+    EmitFunctionCall(&paused, &CheckBlockBreakpoint);
+    EmitExceptionExitOnBool(paused);
+  }
+
+  if (m_block->count_executions)
+    EmitIncrementBranchCounter(&m_block->execution_count);
+
+  // calls which were performed natively return straight to the dispatcher, with pc set to the return address
+  if (m_block->bios_hle)
+  {
+    Value handled = m_register_cache.AllocateScratch(RegSize_8);
+    EmitFunctionCall(&handled, &Thunks::HLEBIOSCall);
+    EmitExceptionExitOnBool(handled);
+  }
+
   if (m_block->uncached_fetch_ticks > 0 || m_block->icache_line_count > 0)
     EmitICacheCheckAndUpdate();
 
@@ -997,6 +1019,8 @@ void CodeGenerator::InstructionPrologue(const CodeBlockInstruction& cbi, TickCou
   if (m_pc_valid)
     m_pc += 4;
 
+  m_register_cache.SetLiveGuestRegisters(cbi.live_reg_mask);
+
   // reset dirty flags
   if (m_branch_was_taken_dirty)
   {
@@ -1060,6 +1084,19 @@ void CodeGenerator::InstructionEpilogue(const CodeBlockInstruction& cbi)
   }
 }
 
+void CodeGenerator::WriteLoadResult(const CodeBlockInstruction& cbi, Reg reg, Value&& value)
+{
+  if (!cbi.can_skip_load_delay)
+  {
+    m_register_cache.WriteGuestRegisterDelayed(reg, std::move(value));
+    return;
+  }
+
+  // nothing in the delay slot touches the register, so the value can be written straight away
+  EmitCancelInterpreterLoadDelayForReg(reg);
+  m_register_cache.WriteGuestRegister(reg, std::move(value));
+}
+
 void CodeGenerator::TruncateBlockAtCurrentInstruction()
 {
   Log_DevPrintf("Truncating block %08X at %08X", m_block->GetPC(), m_current_instruction->pc);
@@ -1438,7 +1475,7 @@ bool CodeGenerator::Compile_Load(const CodeBlockInstruction& cbi)
       result = EmitLoadGuestMemory(cbi, address, address_spec, RegSize_8);
       ConvertValueSizeInPlace(&result, RegSize_32, (cbi.instruction.op == InstructionOp::lb));
       if (g_settings.gpu_pgxp_enable)
-        EmitFunctionCall(nullptr, PGXP::CPU_LBx, Value::FromConstantU32(cbi.instruction.bits), result, address);
+        EmitPGXPSetRegister(cbi.instruction.i.rt, 0.0f, 0, 0);
 
       if (address_spec)
       {
@@ -1483,7 +1520,7 @@ bool CodeGenerator::Compile_Load(const CodeBlockInstruction& cbi)
       break;
   }
 
-  m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.i.rt, std::move(result));
+  WriteLoadResult(cbi, cbi.instruction.i.rt, std::move(result));
   SpeculativeWriteReg(cbi.instruction.i.rt, value_spec);
 
   InstructionEpilogue(cbi);
@@ -1678,7 +1715,7 @@ bool CodeGenerator::Compile_LoadLeftRight(const CodeBlockInstruction& cbi)
   if (g_settings.gpu_pgxp_enable)
     EmitFunctionCall(nullptr, PGXP::CPU_LW, Value::FromConstantU32(cbi.instruction.bits), mem, address);
 
-  m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.i.rt, std::move(mem));
+  WriteLoadResult(cbi, cbi.instruction.i.rt, std::move(mem));
 
   // TODO: Speculative values
   SpeculativeWriteReg(cbi.instruction.r.rt, std::nullopt);
@@ -1755,7 +1792,7 @@ bool CodeGenerator::Compile_MoveHiLo(const CodeBlockInstruction& cbi)
     {
       Value hi = m_register_cache.ReadGuestRegister(Reg::hi);
       if (g_settings.UsingPGXPCPUMode())
-        EmitFunctionCall(nullptr, &PGXP::CPU_MFHI, Value::FromConstantU32(cbi.instruction.bits), hi);
+        EmitPGXPMoveRegister(cbi.instruction.r.rd, Reg::hi, hi);
 
       m_register_cache.WriteGuestRegister(cbi.instruction.r.rd, std::move(hi));
       SpeculativeWriteReg(cbi.instruction.r.rd, std::nullopt);
@@ -1766,7 +1803,7 @@ bool CodeGenerator::Compile_MoveHiLo(const CodeBlockInstruction& cbi)
     {
       Value rs = m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
       if (g_settings.UsingPGXPCPUMode())
-        EmitFunctionCall(nullptr, &PGXP::CPU_MTHI, Value::FromConstantU32(cbi.instruction.bits), rs);
+        EmitPGXPMoveRegister(Reg::hi, cbi.instruction.r.rd, rs);
 
       m_register_cache.WriteGuestRegister(Reg::hi, std::move(rs));
     }
@@ -1776,7 +1813,7 @@ bool CodeGenerator::Compile_MoveHiLo(const CodeBlockInstruction& cbi)
     {
       Value lo = m_register_cache.ReadGuestRegister(Reg::lo);
       if (g_settings.UsingPGXPCPUMode())
-        EmitFunctionCall(nullptr, &PGXP::CPU_MFLO, Value::FromConstantU32(cbi.instruction.bits), lo);
+        EmitPGXPMoveRegister(cbi.instruction.r.rd, Reg::lo, lo);
 
       m_register_cache.WriteGuestRegister(cbi.instruction.r.rd, std::move(lo));
       SpeculativeWriteReg(cbi.instruction.r.rd, std::nullopt);
@@ -1787,7 +1824,7 @@ bool CodeGenerator::Compile_MoveHiLo(const CodeBlockInstruction& cbi)
     {
       Value rs = m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
       if (g_settings.UsingPGXPCPUMode())
-        EmitFunctionCall(nullptr, &PGXP::CPU_MTLO, Value::FromConstantU32(cbi.instruction.bits), rs);
+        EmitPGXPMoveRegister(Reg::lo, cbi.instruction.r.rd, rs);
 
       m_register_cache.WriteGuestRegister(Reg::lo, std::move(rs));
     }
@@ -1851,8 +1888,7 @@ bool CodeGenerator::Compile_Add(const CodeBlockInstruction& cbi)
   // detect register moves and handle them for pgxp
   if (g_settings.gpu_pgxp_enable && rhs.HasConstantValue(0))
   {
-    EmitFunctionCall(nullptr, &PGXP::CPU_MOVE,
-                     Value::FromConstantU32((static_cast<u32>(dest) << 8) | (static_cast<u32>(lhs_src))), lhs);
+    EmitPGXPMoveRegister(dest, lhs_src, lhs);
   }
   else if (g_settings.UsingPGXPCPUMode())
   {
@@ -2215,7 +2251,7 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
     LabelType branch_taken, branch_not_taken;
     if (condition != Condition::Always)
     {
-      if (!can_link_block)
+      if (!can_link_block && !cbi.is_trace_side_exit)
       {
         // condition is inverted because we want the case for skipping it
         if (lhs.IsValid() && rhs.IsValid())
@@ -2313,6 +2349,32 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
       m_register_cache.PopState();
     }
 
+    if (cbi.is_trace_side_exit)
+    {
+      // mid-trace branch, the delay slot runs on both paths, then we leave the block only if it was taken
+      Assert(condition != Condition::Always && (m_current_instruction + 1) != m_block_end);
+      InstructionEpilogue(cbi);
+      m_current_instruction++;
+      if (!CompileInstruction(*m_current_instruction))
+        return false;
+
+      EmitBranchIfBitClear(take_branch.GetHostRegister(), take_branch.size, 0, &branch_not_taken);
+
+      // flush everything for the exit, but keep the cached state for the rest of the trace
+      const TickCount delayed_cycles_add = m_delayed_cycles_add;
+      const TickCount gte_done_cycle = m_gte_done_cycle;
+      m_register_cache.PushState();
+      BlockEpilogue();
+      WriteNewPC(branch_target, false);
+      EmitEndBlock(true, true);
+      m_register_cache.PopState();
+      m_delayed_cycles_add = delayed_cycles_add;
+      m_gte_done_cycle = gte_done_cycle;
+
+      EmitBindLabel(&branch_not_taken);
+      return true;
+    }
+
     if (can_link_block)
     {
       // if it's an in-block branch, compile the delay slot now
@@ -2341,7 +2403,18 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
         EmitBranchIfBitClear(take_branch.GetHostRegister(), take_branch.size, 0, &branch_not_taken);
         m_register_cache.PushState();
         {
+          if (m_block->profile_branches)
+            EmitIncrementBranchCounter(&m_block->branch_taken_count);
+
           WriteNewPC(branch_target, false);
+
+          // idle loops jump straight to the next event instead of spinning
+          if (m_block->idle_loop)
+          {
+            EmitFunctionCall(nullptr, &CPU::Recompiler::Thunks::SkipIdleLoop, Value::FromConstantPtr(m_block));
+            EmitLoadCPUStructField(pending_ticks.GetHostRegister(), RegSize_32, offsetof(State, pending_ticks));
+          }
+
           EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
                                 &return_to_dispatcher);
 
@@ -2371,11 +2444,20 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
 
       if (condition != Condition::Always)
       {
+        if (m_block->profile_branches)
+          EmitIncrementBranchCounter(&m_block->branch_not_taken_count);
+
         WriteNewPC(next_pc, true);
       }
       else
       {
         WriteNewPC(branch_target, true);
+
+        if (m_block->idle_loop)
+        {
+          EmitFunctionCall(nullptr, &CPU::Recompiler::Thunks::SkipIdleLoop, Value::FromConstantPtr(m_block));
+          EmitLoadCPUStructField(pending_ticks.GetHostRegister(), RegSize_32, offsetof(State, pending_ticks));
+        }
       }
 
       EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
@@ -2446,6 +2528,8 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
       if (cbi.instruction.r.funct == InstructionFunct::jr || cbi.instruction.r.funct == InstructionFunct::jalr)
       {
         // npc = rs, link to rt
+        // the new pc is checked against the last target at the end of the block
+        m_indirect_branch_cache = g_settings.cpu_recompiler_block_linking;
         Value branch_target = m_register_cache.ReadGuestRegister(cbi.instruction.r.rs);
         return DoBranch(Condition::Always, Value(), Value(),
                         (cbi.instruction.r.funct == InstructionFunct::jalr) ? cbi.instruction.r.rd : Reg::count,
@@ -2541,7 +2625,10 @@ bool CodeGenerator::Compile_lui(const CodeBlockInstruction& cbi)
   InstructionPrologue(cbi, 1);
 
   if (g_settings.UsingPGXPCPUMode())
-    EmitFunctionCall(nullptr, &PGXP::CPU_LUI, Value::FromConstantU32(cbi.instruction.bits));
+  {
+    EmitPGXPSetRegister(cbi.instruction.i.rt, static_cast<float>(static_cast<s16>(cbi.instruction.i.imm.GetValue())),
+                        PGXP::CPU_REG_VALUE_LUI_FLAGS, cbi.instruction.i.imm_zext32() << 16);
+  }
 
   // rt <- (imm << 16)
   const u32 value = cbi.instruction.i.imm_zext32() << 16;
@@ -2633,7 +2720,7 @@ bool CodeGenerator::Compile_cop0(const CodeBlockInstruction& cbi)
           if (g_settings.UsingPGXPCPUMode())
             EmitFunctionCall(nullptr, &PGXP::CPU_MFC0, Value::FromConstantU32(cbi.instruction.bits), value);
 
-          m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.r.rt, std::move(value));
+          WriteLoadResult(cbi, cbi.instruction.r.rt, std::move(value));
 
           if (reg == Cop0Reg::SR)
             SpeculativeWriteReg(cbi.instruction.r.rt, m_speculative_constants.cop0_sr);
@@ -2697,6 +2784,7 @@ bool CodeGenerator::Compile_cop0(const CodeBlockInstruction& cbi)
 
         if (cbi.instruction.cop.CommonOp() == CopCommonInstruction::mtcn)
         {
+          m_block_changes_mode |= (reg == Cop0Reg::SR);
           if (reg == Cop0Reg::CAUSE || reg == Cop0Reg::SR)
           {
             // Emit an interrupt check on load of CAUSE/SR.
@@ -2769,6 +2857,7 @@ bool CodeGenerator::Compile_cop0(const CodeBlockInstruction& cbi)
       case Cop0Instruction::rfe:
       {
         InstructionPrologue(cbi, 1);
+        m_block_changes_mode = true;
 
         // shift mode bits right two, preserving upper bits
         static constexpr u32 mode_bits_mask = UINT32_C(0b1111);
@@ -2894,8 +2983,23 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     }
     break;
 
-    case 28: // IRGB
     case 30: // LZCS
+    {
+      // LZCR is the number of leading bits matching the sign bit
+      Value value_in_hr = GetValueInHostRegister(value);
+      Value lzcr = m_register_cache.AllocateScratch(RegSize_32);
+      if (EmitCountLeadingSignBits(lzcr.GetHostRegister(), value_in_hr.GetHostRegister()))
+      {
+        EmitStoreCPUStructField(State::GTERegisterOffset(30), value_in_hr);
+        EmitStoreCPUStructField(State::GTERegisterOffset(31), lzcr);
+        return;
+      }
+
+      EmitFunctionCall(nullptr, &GTE::WriteRegister, Value::FromConstantU32(index), value);
+      return;
+    }
+
+    case 28: // IRGB
     case 63: // FLAG
     {
       EmitFunctionCall(nullptr, &GTE::WriteRegister, Value::FromConstantU32(index), value);
@@ -2982,7 +3086,7 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
             Value::FromConstantU32(cbi.instruction.bits), value, value);
         }
 
-        m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.r.rt, std::move(value));
+        WriteLoadResult(cbi, cbi.instruction.r.rt, std::move(value));
         SpeculativeWriteReg(cbi.instruction.r.rt, std::nullopt);
 
         InstructionEpilogue(cbi);
@@ -3021,12 +3125,16 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
     TickCount func_ticks;
     GTE::InstructionImpl func = GTE::GetInstructionImpl(cbi.instruction.bits, &func_ticks);
 
-    // forward everything to the GTE.
     StallUntilGTEComplete();
     InstructionPrologue(cbi, 1);
 
-    Value instruction_bits = Value::FromConstantU32(cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK);
-    EmitFunctionCall(nullptr, func, instruction_bits);
+    // simple commands can be emitted inline, forward everything else to the GTE.
+    if (!EmitGTEInstruction(cbi.instruction.bits))
+    {
+      Value instruction_bits = Value::FromConstantU32(cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK);
+      EmitFunctionCall(nullptr, func, instruction_bits);
+    }
+
     AddGTETicks(func_ticks);
 
     InstructionEpilogue(cbi);
@@ -3034,8 +3142,62 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
   }
 }
 
+void CodeGenerator::EmitIncrementBranchCounter(u32* counter)
+{
+  Value temp = m_register_cache.AllocateScratch(RegSize_32);
+  EmitLoadGlobal(temp.GetHostRegister(), RegSize_32, counter);
+  EmitInc(temp.GetHostRegister(), RegSize_32);
+  EmitStoreGlobal(counter, temp);
+}
+
+void CodeGenerator::EmitIndirectBranchCacheExit()
+{
+  LabelType return_to_dispatcher, cache_miss;
+
+  // leave it to the dispatcher if events are due
+  {
+    Value pending_ticks = m_register_cache.AllocateScratch(RegSize_32);
+    Value downcount = m_register_cache.AllocateScratch(RegSize_32);
+    EmitLoadCPUStructField(pending_ticks.GetHostRegister(), RegSize_32, offsetof(State, pending_ticks));
+    EmitLoadCPUStructField(downcount.GetHostRegister(), RegSize_32, offsetof(State, downcount));
+    EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
+                          &return_to_dispatcher);
+  }
+
+  {
+    Value pc = m_register_cache.AllocateScratch(RegSize_32);
+    Value cached_pc = m_register_cache.AllocateScratch(RegSize_32);
+    EmitLoadCPUStructField(pc.GetHostRegister(), RegSize_32, offsetof(State, regs.pc));
+    EmitLoadGlobal(cached_pc.GetHostRegister(), RegSize_32, &m_block->indirect_branch_pc);
+    EmitConditionalBranch(Condition::NotEqual, false, pc.GetHostRegister(), cached_pc, &cache_miss);
+  }
+
+  // same target as last time, jump straight to it
+  m_register_cache.PushState();
+  EmitEndBlock(true, false);
+  {
+    Value host_code = m_register_cache.AllocateScratch(HostPointerSize);
+    EmitLoadGlobal(host_code.GetHostRegister(), HostPointerSize, &m_block->indirect_branch_host_code);
+    EmitBranch(host_code.GetHostRegister());
+  }
+  m_register_cache.PopState();
+
+  // remember the new target for next time
+  EmitBindLabel(&cache_miss);
+  EmitFunctionCall(nullptr, &CPU::Recompiler::Thunks::ResolveIndirectBranch, Value::FromConstantPtr(m_block));
+
+  EmitBindLabel(&return_to_dispatcher);
+  EmitEndBlock(true, true);
+}
+
 void CodeGenerator::InitSpeculativeRegs()
 {
+  if (!m_speculative_state_reads)
+  {
+    InvalidateSpeculativeValues();
+    return;
+  }
+
   for (u8 i = 0; i < static_cast<u8>(Reg::count); i++)
     m_speculative_constants.regs[i] = g_state.regs.r[i];
 
@@ -3067,6 +3229,9 @@ CodeGenerator::SpeculativeValue CodeGenerator::SpeculativeReadMemory(VirtualMemo
   if (it != m_speculative_constants.memory.end())
     return it->second;
 
+  if (!m_speculative_state_reads)
+    return std::nullopt;
+
   u32 value;
   if ((phys_addr & DCACHE_LOCATION_MASK) == DCACHE_LOCATION)
   {
@@ -31,6 +31,12 @@ public:
 
   bool CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
 
+  /// Prevents speculative constants from being seeded from guest registers/memory, needed when compiling off-thread.
+  void DisableSpeculativeStateReads() { m_speculative_state_reads = false; }
+
+  /// Returns the number of guest registers spilled while compiling, for the recompiler statistics.
+  u32 GetSpillCount() const { return m_register_cache.GetSpillCount(); }
+
   CodeCache::DispatcherFunction CompileDispatcher();
   CodeCache::SingleBlockDispatcherFunction CompileSingleBlockDispatcher();
 
@@ -75,12 +81,16 @@ public:
   void EmitCancelInterpreterLoadDelayForReg(Reg reg);
   void EmitICacheCheckAndUpdate();
   void EmitStallUntilGTEComplete();
+  bool EmitGTEInstruction(u32 instruction_bits);
+  bool EmitCountLeadingSignBits(HostReg to_reg, HostReg from_reg);
   void EmitLoadCPUStructField(HostReg host_reg, RegSize size, u32 offset);
   void EmitStoreCPUStructField(u32 offset, const Value& value);
   void EmitAddCPUStructField(u32 offset, const Value& value);
   void EmitLoadGlobal(HostReg host_reg, RegSize size, const void* ptr);
   void EmitStoreGlobal(void* ptr, const Value& value);
   void EmitLoadGlobalAddress(HostReg host_reg, const void* ptr);
+  void EmitIncrementBranchCounter(u32* counter);
+  void EmitIndirectBranchCacheExit();
 
   // Automatically generates an exception handler.
   Value GetFastmemLoadBase();
@@ -93,15 +103,21 @@ public:
                                   bool in_far_code);
   void EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const SpeculativeValue& address_spec,
                             RegSize size, const Value& value);
+  void EmitStoreGuestRAMDirect(u32 offset, RegSize size, const Value& value);
   void EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
                                    const Value& value);
   void EmitStoreGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
                                    const Value& value, bool in_far_code);
   void EmitUpdateFastmemBase();
 
+  // Inline PGXP register tracking for the trivial cases, avoiding a call per instruction.
+  void EmitPGXPMoveRegister(Reg dst, Reg src, const Value& src_value);
+  void EmitPGXPSetRegister(Reg reg, float y, u32 flags, u32 value);
+
   // Unconditional branch to pointer. May allocate a scratch register.
   void EmitBranch(const void* address, bool allow_scratch = true);
   void EmitBranch(LabelType* label);
+  void EmitBranch(HostReg reg);
 
   // Branching, generates two paths.
   void EmitConditionalBranch(Condition condition, bool invert, HostReg value, RegSize size, LabelType* label);
@@ -203,6 +219,7 @@ private:
   void BlockEpilogue();
   void InstructionPrologue(const CodeBlockInstruction& cbi, TickCount cycles, bool force_sync = false);
   void InstructionEpilogue(const CodeBlockInstruction& cbi);
+  void WriteLoadResult(const CodeBlockInstruction& cbi, Reg reg, Value&& value);
   void TruncateBlockAtCurrentInstruction();
   void AddPendingCycles(bool commit);
   void AddGTETicks(TickCount ticks);
@@ -255,6 +272,10 @@ private:
   u32 m_pc = 0;
   bool m_pc_valid = false;
   bool m_block_linked = false;
+  bool m_indirect_branch_cache = false;
+
+  // rfe or a write to SR, so the indirect branch target can be in the other mode, which the cache doesn't check
+  bool m_block_changes_mode = false;
 
   // whether various flags need to be reset.
   bool m_current_instruction_in_branch_delay_slot_dirty = false;
@@ -286,6 +307,7 @@ private:
   bool SpeculativeIsCacheIsolated();
 
   SpeculativeConstants m_speculative_constants;
+  bool m_speculative_state_reads = true;
 };
 
 } // namespace CPU::Recompiler
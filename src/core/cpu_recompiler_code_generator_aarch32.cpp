@@ -1214,7 +1214,7 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
   }
 
   m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
+  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), CODE_PAGE_OFFSET_MASK);
   m_emit->ldr(GetHostReg32(RARG1),
               a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG1), a32::LSL, 2)); // pointer load
 
@@ -1261,7 +1261,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   }
 
   m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
+  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), CODE_PAGE_OFFSET_MASK);
   m_emit->ldr(GetHostReg32(RARG1),
               a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG1), a32::LSL, 2)); // pointer load
 
@@ -1420,7 +1420,7 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   // TODO: if this gets backpatched, these instructions are wasted
 
   m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
+  m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), CODE_PAGE_OFFSET_MASK);
   m_emit->ldr(GetHostReg32(RARG1),
               a32::MemOperand(GetHostReg32(fastmem_base), GetHostReg32(RARG1), a32::LSL, 2)); // pointer load
 
@@ -1809,6 +1809,18 @@ void CodeGenerator::EmitStallUntilGTEComplete()
   m_emit->str(GetHostReg32(RARG1), a32::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
 }
 
+bool CodeGenerator::EmitGTEInstruction(u32 instruction_bits)
+{
+  // MAC0 needs 64-bit arithmetic, always call out to the GTE.
+  return false;
+}
+
+bool CodeGenerator::EmitCountLeadingSignBits(HostReg to_reg, HostReg from_reg)
+{
+  // Not inlined on this backend yet, always call out to the GTE.
+  return false;
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s32 displacement = GetPCDisplacement(GetCurrentCodePointer(), address);
@@ -1828,6 +1840,11 @@ void CodeGenerator::EmitBranch(LabelType* label)
   m_emit->b(label);
 }
 
+void CodeGenerator::EmitBranch(HostReg reg)
+{
+  m_emit->bx(GetHostReg32(reg));
+}
+
 static a32::Condition TranslateCondition(Condition condition, bool invert)
 {
   switch (condition)
@@ -2100,11 +2117,10 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
   m_emit->Bind(&no_interrupt);
 
   // TimingEvents::UpdateCPUDowncount:
-  // r0 <- head event->downcount
+  // r0 <- slice downcount
   // downcount <- r0
-  EmitLoadGlobalAddress(0, TimingEvents::GetHeadEventPtr());
+  EmitLoadGlobalAddress(0, TimingEvents::GetSliceDowncountPtr());
   m_emit->ldr(a32::r0, a32::MemOperand(a32::r0));
-  m_emit->ldr(a32::r0, a32::MemOperand(a32::r0, offsetof(TimingEvent, m_downcount)));
   m_emit->str(a32::r0, a32::MemOperand(GetHostReg32(RCPUPTR), offsetof(State, downcount)));
 
   // main dispatch loop
@@ -2140,9 +2156,8 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
 
   // check events then for frame done
   m_emit->ldr(a32::r0, a32::MemOperand(GetHostReg32(RCPUPTR), offsetof(State, pending_ticks)));
-  EmitLoadGlobalAddress(1, TimingEvents::GetHeadEventPtr());
+  EmitLoadGlobalAddress(1, TimingEvents::GetSliceDowncountPtr());
   m_emit->ldr(a32::r1, a32::MemOperand(a32::r1));
-  m_emit->ldr(a32::r1, a32::MemOperand(a32::r1, offsetof(TimingEvent, m_downcount)));
   m_emit->cmp(a32::r0, a32::r1);
   m_emit->b(a32::lt, &frame_done_loop);
   EmitCall(reinterpret_cast<const void*>(&TimingEvents::RunEvents));
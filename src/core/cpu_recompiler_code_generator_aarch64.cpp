@@ -1376,7 +1376,7 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
   else
   {
     m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-    m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
+    m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), CODE_PAGE_OFFSET_MASK);
     m_emit->ldr(GetHostReg64(RARG1), a64::MemOperand(GetFastmemBasePtrReg(), GetHostReg32(RARG1), a64::LSL, 3));
 
     switch (size)
@@ -1448,7 +1448,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   else
   {
     m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-    m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
+    m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), CODE_PAGE_OFFSET_MASK);
     m_emit->ldr(GetHostReg64(RARG1), a64::MemOperand(GetFastmemBasePtrReg(), GetHostReg32(RARG1), a64::LSL, 3));
 
     bpi.host_pc = GetCurrentNearCodePointer();
@@ -1622,7 +1622,7 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
   else
   {
     m_emit->lsr(GetHostReg32(RARG1), GetHostReg32(address_reg), 12);
-    m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), HOST_PAGE_OFFSET_MASK);
+    m_emit->and_(GetHostReg32(RARG2), GetHostReg32(address_reg), CODE_PAGE_OFFSET_MASK);
     m_emit->add(GetHostReg64(RARG3), GetFastmemBasePtrReg(), Bus::FASTMEM_LUT_NUM_PAGES * sizeof(u32*));
     m_emit->ldr(GetHostReg64(RARG1), a64::MemOperand(GetHostReg64(RARG3), GetHostReg32(RARG1), a64::LSL, 3));
 
@@ -1996,6 +1996,18 @@ void CodeGenerator::EmitStallUntilGTEComplete()
   m_emit->str(GetHostReg32(RARG1), a64::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
 }
 
+bool CodeGenerator::EmitGTEInstruction(u32 instruction_bits)
+{
+  // Not inlined on this backend yet, always call out to the GTE.
+  return false;
+}
+
+bool CodeGenerator::EmitCountLeadingSignBits(HostReg to_reg, HostReg from_reg)
+{
+  // Not inlined on this backend yet, always call out to the GTE.
+  return false;
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
@@ -2018,6 +2030,11 @@ void CodeGenerator::EmitBranch(LabelType* label)
   m_emit->B(label);
 }
 
+void CodeGenerator::EmitBranch(HostReg reg)
+{
+  m_emit->br(GetHostReg64(reg));
+}
+
 static a64::Condition TranslateCondition(Condition condition, bool invert)
 {
   switch (condition)
@@ -2304,11 +2321,10 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
   m_emit->Bind(&no_interrupt);
 
   // TimingEvents::UpdateCPUDowncount:
-  // x8 <- head event->downcount
-  // downcount <- x8
-  EmitLoadGlobalAddress(8, TimingEvents::GetHeadEventPtr());
-  m_emit->ldr(a64::x8, a64::MemOperand(a64::x8));
-  m_emit->ldr(a64::w8, a64::MemOperand(a64::x8, offsetof(TimingEvent, m_downcount)));
+  // w8 <- slice downcount
+  // downcount <- w8
+  EmitLoadGlobalAddress(8, TimingEvents::GetSliceDowncountPtr());
+  m_emit->ldr(a64::w8, a64::MemOperand(a64::x8));
   m_emit->str(a64::w8, a64::MemOperand(GetHostReg64(RCPUPTR), offsetof(State, downcount)));
 
   // main dispatch loop
@@ -2345,9 +2361,8 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
 
   // check events then for frame done
   m_emit->ldr(a64::w8, a64::MemOperand(GetHostReg64(RCPUPTR), offsetof(State, pending_ticks)));
-  EmitLoadGlobalAddress(9, TimingEvents::GetHeadEventPtr());
-  m_emit->ldr(a64::x9, a64::MemOperand(a64::x9));
-  m_emit->ldr(a64::w9, a64::MemOperand(a64::x9, offsetof(TimingEvent, m_downcount)));
+  EmitLoadGlobalAddress(9, TimingEvents::GetSliceDowncountPtr());
+  m_emit->ldr(a64::w9, a64::MemOperand(a64::x9));
   m_emit->cmp(a64::w8, a64::w9);
   m_emit->b(&frame_done_loop, a64::lt);
   EmitCall(reinterpret_cast<const void*>(&TimingEvents::RunEvents));
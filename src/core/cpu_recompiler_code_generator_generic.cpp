@@ -1,8 +1,12 @@
+#include "common/align.h"
 #include "common/log.h"
+#include "cpu_code_cache.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_recompiler_code_generator.h"
+#include "pgxp.h"
 #include "settings.h"
+#include <cstring>
 Log_SetChannel(Recompiler::CodeGenerator);
 
 namespace CPU::Recompiler {
@@ -29,14 +33,18 @@ void CodeGenerator::EmitStoreInterpreterLoadDelay(Reg reg, const Value& value)
 Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address,
                                          const SpeculativeValue& address_spec, RegSize size)
 {
+#ifdef WITH_MMIO_PROFILER
+  // recompiled code doesn't otherwise keep the instruction PC up to date, the profiler needs it for register accesses
+  EmitStoreCPUStructField(offsetof(State, current_instruction_pc), Value::FromConstantU32(cbi.pc));
+#endif
+
   if (address.IsConstant() && !SpeculativeIsCacheIsolated())
   {
-    TickCount read_ticks;
-    void* ptr = GetDirectReadMemoryPointer(
-      static_cast<u32>(address.constant_value),
+    const MemoryAccessSize access_size =
       (size == RegSize_8) ? MemoryAccessSize::Byte :
-                            ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word),
-      &read_ticks);
+                            ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word);
+    TickCount read_ticks;
+    void* ptr = GetDirectReadMemoryPointer(static_cast<u32>(address.constant_value), access_size, &read_ticks);
     if (ptr)
     {
       Value result = m_register_cache.AllocateScratch(size);
@@ -55,12 +63,29 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
       m_delayed_cycles_add += read_ticks;
       return result;
     }
+
+    // Misaligned addresses still have to raise an exception, so only aligned accesses can call the device directly.
+    const u32 constant_address = static_cast<u32>(address.constant_value);
+    const Thunks::IOReadFunction io_function = Common::IsAlignedPow2(constant_address, 1u << size) ?
+                                                 Thunks::GetIOReadFunction(access_size, constant_address) :
+                                                 nullptr;
+    if (io_function)
+    {
+      Value result = m_register_cache.AllocateScratch(RegSize_32);
+      AddPendingCycles(true);
+      m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+      EmitFunctionCall(&result, io_function, Value::FromConstantU32(constant_address & PHYSICAL_MEMORY_ADDRESS_MASK));
+      if (size != RegSize_32)
+        ConvertValueSizeInPlace(&result, size, false);
+
+      return result;
+    }
   }
 
   Value result = m_register_cache.AllocateScratch(HostPointerSize);
 
-  const bool use_fastmem =
-    (address_spec ? Bus::CanUseFastmemForAddress(*address_spec) : true) && !SpeculativeIsCacheIsolated();
+  const bool use_fastmem = (address_spec ? Bus::CanUseFastmemForAddress(*address_spec) : true) &&
+                           !SpeculativeIsCacheIsolated() && !cbi.force_slowmem;
   if (address_spec)
   {
     if (!use_fastmem)
@@ -115,12 +140,17 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
 void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address,
                                          const SpeculativeValue& address_spec, RegSize size, const Value& value)
 {
+#ifdef WITH_MMIO_PROFILER
+  // recompiled code doesn't otherwise keep the instruction PC up to date, the profiler needs it for register accesses
+  EmitStoreCPUStructField(offsetof(State, current_instruction_pc), Value::FromConstantU32(cbi.pc));
+#endif
+
   if (address.IsConstant() && !SpeculativeIsCacheIsolated())
   {
-    void* ptr = GetDirectWriteMemoryPointer(
-      static_cast<u32>(address.constant_value),
+    const MemoryAccessSize access_size =
       (size == RegSize_8) ? MemoryAccessSize::Byte :
-                            ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word));
+                            ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word);
+    void* ptr = GetDirectWriteMemoryPointer(static_cast<u32>(address.constant_value), access_size);
     if (ptr)
     {
       if (value.size != size)
@@ -130,10 +160,38 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
 
       return;
     }
+
+    // Cached segment writes go to the icache when isolated, so we need to know the state of SR.Isc for those.
+    const u32 constant_address = static_cast<u32>(address.constant_value);
+    const bool cache_isolation_known =
+      (GetSegmentForAddress(constant_address) == Segment::KSEG1) || m_speculative_constants.cop0_sr.has_value();
+
+    // RAM doesn't have a direct write pointer because code in it has to be invalidated, so do that inline.
+    const Segment segment = GetSegmentForAddress(constant_address);
+    if (cache_isolation_known && Common::IsAlignedPow2(constant_address, 1u << size) &&
+        (segment != Segment::KUSEG || constant_address < 0x20000000u) && segment != Segment::KSEG2 &&
+        Bus::IsRAMAddress(constant_address & PHYSICAL_MEMORY_ADDRESS_MASK))
+    {
+      EmitStoreGuestRAMDirect(constant_address & Bus::g_ram_mask, size, value);
+      return;
+    }
+
+    const Thunks::IOWriteFunction io_function =
+      (cache_isolation_known && Common::IsAlignedPow2(constant_address, 1u << size)) ?
+        Thunks::GetIOWriteFunction(access_size, constant_address) :
+        nullptr;
+    if (io_function)
+    {
+      AddPendingCycles(true);
+      m_register_cache.FlushCallerSavedGuestRegisters(true, true);
+      EmitFunctionCall(nullptr, io_function, Value::FromConstantU32(constant_address & PHYSICAL_MEMORY_ADDRESS_MASK),
+                       value);
+      return;
+    }
   }
 
-  const bool use_fastmem =
-    (address_spec ? Bus::CanUseFastmemForAddress(*address_spec) : true) && !SpeculativeIsCacheIsolated();
+  const bool use_fastmem = (address_spec ? Bus::CanUseFastmemForAddress(*address_spec) : true) &&
+                           !SpeculativeIsCacheIsolated() && !cbi.force_slowmem;
   if (address_spec)
   {
     if (!use_fastmem)
@@ -160,6 +218,67 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
   }
 }
 
+void CodeGenerator::EmitStoreGuestRAMDirect(u32 offset, RegSize size, const Value& value)
+{
+  if (value.size != size)
+    EmitStoreGlobal(&Bus::g_ram[offset], value.ViewAsSize(size));
+  else
+    EmitStoreGlobal(&Bus::g_ram[offset], value);
+
+  // Code pages are only write protected in the fastmem views, so check whether this line holds code ourselves.
+  u8 code_line_bit;
+  const u8* code_line_mask = CodeCache::GetRAMCodeLineMaskByte(offset, &code_line_bit);
+  LabelType no_code;
+  {
+    Value code_lines = m_register_cache.AllocateScratch(RegSize_8);
+    EmitLoadGlobal(code_lines.GetHostRegister(), RegSize_8, code_line_mask);
+    EmitBranchIfBitClear(code_lines.GetHostRegister(), RegSize_8, code_line_bit, &no_code);
+  }
+
+  EmitFunctionCall(nullptr, &CodeCache::InvalidateBlocksInRange, Value::FromConstantU32(offset),
+                   Value::FromConstantU32(1u << size));
+  EmitBindLabel(&no_code);
+}
+
+void CodeGenerator::EmitPGXPMoveRegister(Reg dst, Reg src, const Value& src_value)
+{
+  u8* dst_ptr = PGXP::GetCPURegisterValuePointer(static_cast<u32>(dst));
+  u8* src_ptr = PGXP::GetCPURegisterValuePointer(static_cast<u32>(src));
+  Value temp = m_register_cache.AllocateScratch(RegSize_32);
+
+  // drop the valid bits if the tracked value no longer matches the register
+  LabelType valid;
+  EmitLoadGlobal(temp.GetHostRegister(), RegSize_32, src_ptr + PGXP::CPU_REG_VALUE_VALUE_OFFSET);
+  EmitConditionalBranch(Condition::Equal, false, temp.GetHostRegister(), src_value, &valid);
+  EmitLoadGlobal(temp.GetHostRegister(), RegSize_32, src_ptr + PGXP::CPU_REG_VALUE_FLAGS_OFFSET);
+  EmitAnd(temp.GetHostRegister(), temp.GetHostRegister(),
+          Value::FromConstantU32(PGXP::CPU_REG_VALUE_INVALID_FLAGS_MASK));
+  EmitStoreGlobal(src_ptr + PGXP::CPU_REG_VALUE_FLAGS_OFFSET, temp);
+  EmitBindLabel(&valid);
+
+  if (dst == src)
+    return;
+
+  for (u32 offset = 0; offset < PGXP::CPU_REG_VALUE_SIZE; offset += sizeof(u32))
+  {
+    EmitLoadGlobal(temp.GetHostRegister(), RegSize_32, src_ptr + offset);
+    EmitStoreGlobal(dst_ptr + offset, temp);
+  }
+}
+
+void CodeGenerator::EmitPGXPSetRegister(Reg reg, float y, u32 flags, u32 value)
+{
+  u32 y_bits;
+  std::memcpy(&y_bits, &y, sizeof(y_bits));
+
+  u8* ptr = PGXP::GetCPURegisterValuePointer(static_cast<u32>(reg));
+  EmitStoreGlobal(ptr, Value::FromConstantU32(0));
+  EmitStoreGlobal(ptr + sizeof(float), Value::FromConstantU32(y_bits));
+  EmitStoreGlobal(ptr + sizeof(float) * 2, Value::FromConstantU32(0));
+  EmitStoreGlobal(ptr + PGXP::CPU_REG_VALUE_FLAGS_OFFSET, Value::FromConstantU32(flags));
+  EmitStoreGlobal(ptr + PGXP::CPU_REG_VALUE_VALUE_OFFSET, Value::FromConstantU32(value));
+}
+
 #if 0 // Not used
 
 void CodeGenerator::EmitICacheCheckAndUpdate()
@@ -2,6 +2,7 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "cpu_core.h"
+#include "cpuinfo.h"
 #include "cpu_core_private.h"
 #include "cpu_recompiler_code_generator.h"
 #include "cpu_recompiler_thunks.h"
@@ -85,6 +86,35 @@ static const Xbyak::Reg64 GetFastmemBasePtrReg()
   return GetHostReg64(RMEMBASEPTR);
 }
 
+namespace {
+struct HostFeatures
+{
+  bool bmi2;
+  bool lzcnt;
+};
+} // namespace
+
+// Extensions beyond baseline x86-64 which the emitter can use, queried once since blocks compile on two threads.
+static const HostFeatures& GetHostFeatures()
+{
+  static const HostFeatures features = []() {
+    HostFeatures hf = {};
+    if (cpuinfo_initialize())
+    {
+      hf.bmi2 = cpuinfo_has_x86_bmi2();
+      hf.lzcnt = cpuinfo_has_x86_lzcnt();
+    }
+    else
+    {
+      Log_WarningPrint("Failed to query host CPU features, using baseline code only");
+    }
+
+    Log_InfoPrintf("Host CPU features: BMI2 %s, LZCNT %s", hf.bmi2 ? "yes" : "no", hf.lzcnt ? "yes" : "no");
+    return hf;
+  }();
+  return features;
+}
+
 CodeGenerator::CodeGenerator(JitCodeBuffer* code_buffer)
   : m_code_buffer(code_buffer), m_register_cache(*this),
     m_near_emitter(code_buffer->GetFreeCodeSpace(), code_buffer->GetFreeCodePointer()),
@@ -442,6 +472,16 @@ void CodeGenerator::EmitAdd(HostReg to_reg, HostReg from_reg, const Value& value
 
     case RegSize_32:
     {
+      // LEA is a three-operand add, when the flags aren't needed
+      if (to_reg != from_reg && !set_flags)
+      {
+        if (value.IsConstant())
+          m_emit->lea(GetHostReg32(to_reg), m_emit->dword[GetHostReg64(from_reg) + Truncate32(value.constant_value)]);
+        else
+          m_emit->lea(GetHostReg32(to_reg), m_emit->dword[GetHostReg64(from_reg) + GetHostReg64(value.host_reg)]);
+        break;
+      }
+
       if (to_reg != from_reg)
         m_emit->mov(GetHostReg32(to_reg), GetHostReg32(from_reg));
 
@@ -869,6 +909,16 @@ void CodeGenerator::EmitShl(HostReg to_reg, HostReg from_reg, RegSize size, cons
 {
   DebugAssert(amount_value.IsConstant() || amount_value.IsInHostRegister());
 
+  // BMI2 takes the amount from any register, and doesn't overwrite the source
+  if (!amount_value.IsConstant() && size >= RegSize_32 && GetHostFeatures().bmi2)
+  {
+    if (size == RegSize_32)
+      m_emit->shlx(GetHostReg32(to_reg), GetHostReg32(from_reg), GetHostReg32(amount_value.host_reg));
+    else
+      m_emit->shlx(GetHostReg64(to_reg), GetHostReg64(from_reg), GetHostReg64(amount_value.host_reg));
+    return;
+  }
+
   // We have to use CL for the shift amount :(
   const bool save_cl = (!amount_value.IsConstant() && m_register_cache.IsHostRegInUse(Xbyak::Operand::RCX) &&
                         (!amount_value.IsInHostRegister() || amount_value.host_reg != Xbyak::Operand::RCX));
@@ -938,6 +988,16 @@ void CodeGenerator::EmitShr(HostReg to_reg, HostReg from_reg, RegSize size, cons
 {
   DebugAssert(amount_value.IsConstant() || amount_value.IsInHostRegister());
 
+  // BMI2 takes the amount from any register, and doesn't overwrite the source
+  if (!amount_value.IsConstant() && size >= RegSize_32 && GetHostFeatures().bmi2)
+  {
+    if (size == RegSize_32)
+      m_emit->shrx(GetHostReg32(to_reg), GetHostReg32(from_reg), GetHostReg32(amount_value.host_reg));
+    else
+      m_emit->shrx(GetHostReg64(to_reg), GetHostReg64(from_reg), GetHostReg64(amount_value.host_reg));
+    return;
+  }
+
   // We have to use CL for the shift amount :(
   const bool save_cl = (!amount_value.IsConstant() && m_register_cache.IsHostRegInUse(Xbyak::Operand::RCX) &&
                         (!amount_value.IsInHostRegister() || amount_value.host_reg != Xbyak::Operand::RCX));
@@ -1007,6 +1067,16 @@ void CodeGenerator::EmitSar(HostReg to_reg, HostReg from_reg, RegSize size, cons
 {
   DebugAssert(amount_value.IsConstant() || amount_value.IsInHostRegister());
 
+  // BMI2 takes the amount from any register, and doesn't overwrite the source
+  if (!amount_value.IsConstant() && size >= RegSize_32 && GetHostFeatures().bmi2)
+  {
+    if (size == RegSize_32)
+      m_emit->sarx(GetHostReg32(to_reg), GetHostReg32(from_reg), GetHostReg32(amount_value.host_reg));
+    else
+      m_emit->sarx(GetHostReg64(to_reg), GetHostReg64(from_reg), GetHostReg64(amount_value.host_reg));
+    return;
+  }
+
   // We have to use CL for the shift amount :(
   const bool save_cl = (!amount_value.IsConstant() && m_register_cache.IsHostRegInUse(Xbyak::Operand::RCX) &&
                         (!amount_value.IsInHostRegister() || amount_value.host_reg != Xbyak::Operand::RCX));
@@ -1843,7 +1913,7 @@ void CodeGenerator::EmitLoadGuestRAMFastmem(const Value& address, RegSize size,
     EmitCopyValue(RARG1, address);
     m_emit->mov(GetHostReg32(RARG2), GetHostReg32(RARG1));
     m_emit->shr(GetHostReg32(RARG1), 12);
-    m_emit->and_(GetHostReg32(RARG2), HOST_PAGE_OFFSET_MASK);
+    m_emit->and_(GetHostReg32(RARG2), CODE_PAGE_OFFSET_MASK);
     m_emit->mov(GetHostReg64(RARG1), m_emit->qword[GetFastmemBasePtrReg() + GetHostReg64(RARG1) * 8]);
 
     switch (size)
@@ -1942,7 +2012,7 @@ void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi,
     EmitCopyValue(RARG1, address);
     m_emit->mov(GetHostReg32(RARG2), GetHostReg32(RARG1));
     m_emit->shr(GetHostReg32(RARG1), 12);
-    m_emit->and_(GetHostReg32(RARG2), HOST_PAGE_OFFSET_MASK);
+    m_emit->and_(GetHostReg32(RARG2), CODE_PAGE_OFFSET_MASK);
     m_emit->mov(GetHostReg64(RARG1), m_emit->qword[GetFastmemBasePtrReg() + GetHostReg64(RARG1) * 8]);
     bpi.host_pc = GetCurrentNearCodePointer();
 
@@ -2196,7 +2266,7 @@ void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi,
     EmitCopyValue(RARG1, address);
     m_emit->mov(GetHostReg32(RARG2), GetHostReg32(RARG1));
     m_emit->shr(GetHostReg32(RARG1), 12);
-    m_emit->and_(GetHostReg32(RARG2), HOST_PAGE_OFFSET_MASK);
+    m_emit->and_(GetHostReg32(RARG2), CODE_PAGE_OFFSET_MASK);
     m_emit->mov(GetHostReg64(RARG1),
                 m_emit->qword[GetFastmemBasePtrReg() + GetHostReg64(RARG1) * 8 + (Bus::FASTMEM_LUT_NUM_PAGES * 8)]);
     bpi.host_pc = GetCurrentNearCodePointer();
@@ -2659,7 +2729,27 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
   }
   else
   {
-    VirtualMemoryAddress current_pc = m_pc & ICACHE_TAG_ADDRESS_MASK;
+    // Resident blocks only run a straight sequence of tag compares, the lines are filled out of line on a miss.
+    const VirtualMemoryAddress start_pc = m_pc & ICACHE_TAG_ADDRESS_MASK;
+    const void* miss_code = GetCurrentFarCodePointer();
+    bool has_cached_lines = false;
+    VirtualMemoryAddress current_pc = start_pc;
+    for (u32 i = 0; i < m_block->icache_line_count; i++, current_pc += ICACHE_LINE_SIZE)
+    {
+      if (GetICacheFillTicks(current_pc) <= 0)
+        continue;
+
+      const u32 offset = offsetof(State, icache_tags) + (GetICacheLine(current_pc) * sizeof(u32));
+      m_emit->cmp(m_emit->dword[GetCPUPtrReg() + offset], GetICacheTagForAddress(current_pc));
+      m_emit->jne(miss_code);
+      has_cached_lines = true;
+    }
+    if (!has_cached_lines)
+      return;
+
+    SwitchToFarCode();
+
+    current_pc = start_pc;
     for (u32 i = 0; i < m_block->icache_line_count; i++, current_pc += ICACHE_LINE_SIZE)
     {
       const VirtualMemoryAddress tag = GetICacheTagForAddress(current_pc);
@@ -2677,6 +2767,9 @@ void CodeGenerator::EmitICacheCheckAndUpdate()
       m_emit->add(m_emit->dword[GetCPUPtrReg() + offsetof(State, pending_ticks)], static_cast<u32>(fill_ticks));
       m_emit->L(cache_hit);
     }
+
+    m_emit->jmp(GetCurrentNearCodePointer());
+    SwitchToNearCode();
   }
 }
 
@@ -2696,6 +2789,112 @@ void CodeGenerator::EmitStallUntilGTEComplete()
   m_emit->mov(m_emit->dword[GetCPUPtrReg() + offsetof(State, pending_ticks)], GetHostReg32(RRETURN));
 }
 
+bool CodeGenerator::EmitGTEInstruction(u32 instruction_bits)
+{
+  // FLAG bits written by the inlined commands, error bit included.
+  static constexpr u32 FLAG_MAC0_OVERFLOW = UINT32_C(0x80010000);
+  static constexpr u32 FLAG_MAC0_UNDERFLOW = UINT32_C(0x80008000);
+  static constexpr u32 FLAG_OTZ_SATURATED = UINT32_C(0x80040000);
+
+  const GTE::Instruction inst{instruction_bits};
+  if ((inst.command != 0x06 || (g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)) &&
+      inst.command != 0x2D && inst.command != 0x2E)
+  {
+    return false;
+  }
+
+  Value result = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp2 = m_register_cache.AllocateScratch(RegSize_64);
+  const Xbyak::Reg64 result64 = GetHostReg64(result);
+  const Xbyak::Reg64 temp64 = GetHostReg64(temp);
+  const Xbyak::Reg64 temp2_64 = GetHostReg64(temp2);
+  const auto gte_reg = [](u32 index, u32 half = 0) {
+    return GetCPUPtrReg() + (State::GTERegisterOffset(index) + (half * sizeof(u16)));
+  };
+
+  if (inst.command == 0x06)
+  {
+    // NCLIP: MAC0 = SX0*(SY1-SY2) + SX1*(SY2-SY0) + SX2*(SY0-SY1), same as the six-product form in 64 bits.
+    static constexpr u32 terms[3][3] = {{12, 13, 14}, {13, 14, 12}, {14, 12, 13}};
+    for (u32 i = 0; i < 3; i++)
+    {
+      const Xbyak::Reg64 dst = (i == 0) ? result64 : temp64;
+      m_emit->movsx(dst, m_emit->word[gte_reg(terms[i][1], 1)]);
+      m_emit->movsx(temp2_64, m_emit->word[gte_reg(terms[i][2], 1)]);
+      m_emit->sub(dst, temp2_64);
+      m_emit->movsx(temp2_64, m_emit->word[gte_reg(terms[i][0], 0)]);
+      m_emit->imul(dst, temp2_64);
+      if (i != 0)
+        m_emit->add(result64, temp64);
+    }
+  }
+  else
+  {
+    // AVSZ3/AVSZ4: MAC0 = ZSF * (SZ0? + SZ1 + SZ2 + SZ3)
+    const bool four = (inst.command == 0x2E);
+    m_emit->movzx(GetHostReg32(temp), m_emit->word[gte_reg(17)]);
+    for (u32 index = four ? 16 : 18; index <= 19; index++)
+    {
+      if (index == 17)
+        continue;
+
+      m_emit->movzx(GetHostReg32(temp2), m_emit->word[gte_reg(index)]);
+      m_emit->add(GetHostReg32(temp), GetHostReg32(temp2));
+    }
+
+    m_emit->movsx(result64, m_emit->word[gte_reg(four ? 62 : 61)]);
+    m_emit->imul(result64, temp64);
+  }
+
+  // MAC0 is the truncated result, flagged when it doesn't fit in 32 bits.
+  const Xbyak::Reg32 flags32 = GetHostReg32(temp);
+  m_emit->mov(m_emit->dword[gte_reg(24)], GetHostReg32(result));
+  m_emit->movsxd(temp2_64, GetHostReg32(result));
+  m_emit->xor_(flags32, flags32);
+  m_emit->cmp(result64, temp2_64);
+  m_emit->mov(GetHostReg32(temp2), FLAG_MAC0_OVERFLOW);
+  m_emit->cmovg(flags32, GetHostReg32(temp2));
+  m_emit->mov(GetHostReg32(temp2), FLAG_MAC0_UNDERFLOW);
+  m_emit->cmovl(flags32, GetHostReg32(temp2));
+
+  if (inst.command != 0x06)
+  {
+    // OTZ = clamp(MAC0 >> 12, 0, 0xFFFF), computed from the untruncated result
+    const Xbyak::Reg32 otz32 = GetHostReg32(result);
+    m_emit->sar(result64, 12);
+    m_emit->mov(GetHostReg32(temp2), flags32);
+    m_emit->or_(GetHostReg32(temp2), FLAG_OTZ_SATURATED);
+    m_emit->cmp(otz32, 0xFFFF);
+    m_emit->cmova(flags32, GetHostReg32(temp2));
+    m_emit->xor_(GetHostReg32(temp2), GetHostReg32(temp2));
+    m_emit->test(otz32, otz32);
+    m_emit->cmovs(otz32, GetHostReg32(temp2));
+    m_emit->mov(GetHostReg32(temp2), 0xFFFF);
+    m_emit->cmp(otz32, GetHostReg32(temp2));
+    m_emit->cmovg(otz32, GetHostReg32(temp2));
+    m_emit->mov(m_emit->dword[gte_reg(7)], otz32);
+  }
+
+  m_emit->mov(m_emit->dword[gte_reg(63)], flags32);
+  return true;
+}
+
+bool CodeGenerator::EmitCountLeadingSignBits(HostReg to_reg, HostReg from_reg)
+{
+  // BSR is undefined for zero, so leave it to the GTE without LZCNT
+  if (!GetHostFeatures().lzcnt)
+    return false;
+
+  // flip negative values so that the sign bits become leading zeros
+  DebugAssert(to_reg != from_reg);
+  m_emit->mov(GetHostReg32(to_reg), GetHostReg32(from_reg));
+  m_emit->sar(GetHostReg32(to_reg), 31);
+  m_emit->xor_(GetHostReg32(to_reg), GetHostReg32(from_reg));
+  m_emit->lzcnt(GetHostReg32(to_reg), GetHostReg32(to_reg));
+  return true;
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
@@ -2718,6 +2917,11 @@ void CodeGenerator::EmitBranch(LabelType* label)
   m_emit->jmp(*label);
 }
 
+void CodeGenerator::EmitBranch(HostReg reg)
+{
+  m_emit->jmp(GetHostReg64(reg));
+}
+
 void CodeGenerator::EmitConditionalBranch(Condition condition, bool invert, HostReg value, RegSize size,
                                           LabelType* label)
 {
@@ -3049,11 +3253,10 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
   m_emit->L(no_interrupt);
 
   // TimingEvents::UpdateCPUDowncount:
-  // eax <- head event->downcount
+  // eax <- slice downcount
   // downcount <- eax
-  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetHeadEventPtr());
-  m_emit->mov(m_emit->rax, m_emit->qword[m_emit->rax]);
-  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax + offsetof(TimingEvent, m_downcount)]);
+  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetSliceDowncountPtr());
+  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax]);
   m_emit->mov(m_emit->dword[m_emit->rbp + offsetof(State, downcount)], m_emit->eax);
 
   // main dispatch loop
@@ -3088,9 +3291,8 @@ CodeCache::DispatcherFunction CodeGenerator::CompileDispatcher()
   m_emit->L(downcount_hit);
 
   // check events then for frame done
-  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetHeadEventPtr());
-  m_emit->mov(m_emit->rax, m_emit->qword[m_emit->rax]);
-  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax + offsetof(TimingEvent, m_downcount)]);
+  EmitLoadGlobalAddress(Xbyak::Operand::RAX, TimingEvents::GetSliceDowncountPtr());
+  m_emit->mov(m_emit->eax, m_emit->dword[m_emit->rax]);
   m_emit->cmp(m_emit->eax, m_emit->dword[m_emit->rbp + offsetof(State, pending_ticks)]);
   m_emit->jg(frame_done_loop);
   EmitCall(reinterpret_cast<const void*>(&TimingEvents::RunEvents));
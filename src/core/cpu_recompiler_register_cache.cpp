@@ -860,10 +860,23 @@ bool RegisterCache::EvictOneGuestRegister()
   if (m_state.guest_reg_order_count == 0)
     return false;
 
+  // nothing reads dead registers again before they're overwritten, so they don't need to be stored
+  for (u32 i = m_state.guest_reg_order_count; i > 0; i--)
+  {
+    const Reg reg = m_state.guest_reg_order[i - 1];
+    if (static_cast<u8>(reg) < 32 && !(m_live_guest_reg_mask & (1u << static_cast<u8>(reg))))
+    {
+      Log_ProfilePrintf("Evicting dead guest register %s", GetRegName(reg));
+      InvalidateGuestRegister(reg);
+      return HasFreeHostRegister();
+    }
+  }
+
   // evict the register used the longest time ago
   Reg evict_reg = m_state.guest_reg_order[m_state.guest_reg_order_count - 1];
   Log_ProfilePrintf("Evicting guest register %s", GetRegName(evict_reg));
   FlushGuestRegister(evict_reg, true, true);
+  m_spill_count++;
 
   return HasFreeHostRegister();
 }
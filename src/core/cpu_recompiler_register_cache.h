@@ -342,6 +342,13 @@ public:
   void FlushCallerSavedGuestRegisters(bool invalidate, bool clear_dirty);
   bool EvictOneGuestRegister();
 
+  /// Sets the GPRs which can still be read by the current or later instructions. Dead registers are evicted first,
+  /// and dropped without being written back.
+  void SetLiveGuestRegisters(u32 mask) { m_live_guest_reg_mask = mask; }
+
+  /// Returns the number of live guest registers which had to be written back to free a host register.
+  u32 GetSpillCount() const { return m_spill_count; }
+
   /// Temporarily prevents register allocation.
   void InhibitAllocation();
   void UninhibitAllocation();
@@ -356,6 +363,8 @@ private:
   std::array<HostReg, HostReg_Count> m_host_register_allocation_order{};
 
   HostReg m_cpu_ptr_host_register = {};
+  u32 m_live_guest_reg_mask = UINT32_C(0xFFFFFFFF);
+  u32 m_spill_count = 0;
 
   struct RegAllocState
   {
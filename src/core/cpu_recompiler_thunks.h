@@ -33,7 +33,17 @@ void UncheckedWriteMemoryByte(u32 address, u32 value);
 void UncheckedWriteMemoryHalfWord(u32 address, u32 value);
 void UncheckedWriteMemoryWord(u32 address, u32 value);
 
+// Direct I/O register access for constant addresses, skipping the address decode. Adds the access time to pending
+// ticks. Returns nullptr if the address does not map to a device's registers.
+using IOReadFunction = u32 (*)(u32 address);
+using IOWriteFunction = void (*)(u32 address, u32 value);
+IOReadFunction GetIOReadFunction(MemoryAccessSize size, u32 address);
+IOWriteFunction GetIOWriteFunction(MemoryAccessSize size, u32 address);
+
 void ResolveBranch(CodeBlock* block, void* host_pc, void* host_resolve_pc, u32 host_pc_size);
+void ResolveIndirectBranch(CodeBlock* block);
+void SkipIdleLoop(CodeBlock* block);
+bool HLEBIOSCall();
 void LogPC(u32 pc);
 
 } // namespace Recompiler::Thunks
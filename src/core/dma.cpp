@@ -494,8 +494,8 @@ TickCount DMA::TransferMemoryToDevice(Channel channel, u32 address, u32 incremen
 {
   const u32* src_pointer = reinterpret_cast<u32*>(Bus::g_ram + address);
   const u32 mask = GetAddressMask();
-  if (channel != Channel::GPU &&
-      (static_cast<s32>(increment) < 0 || ((address + (increment * word_count)) & mask) <= address))
+  const bool wraps = (static_cast<s32>(increment) < 0 || ((address + (increment * word_count)) & mask) <= address);
+  if (channel != Channel::GPU && wraps)
   {
     // Use temp buffer if it's wrapping around
     if (m_transfer_buffer.size() < word_count)
@@ -516,13 +516,21 @@ TickCount DMA::TransferMemoryToDevice(Channel channel, u32 address, u32 incremen
     {
       if (g_gpu->BeginDMAWrite())
       {
-        u8* ram_pointer = Bus::g_ram;
-        for (u32 i = 0; i < word_count; i++)
+        if (!wraps)
         {
-          u32 value;
-          std::memcpy(&value, &ram_pointer[address], sizeof(u32));
-          g_gpu->DMAWrite(address, value);
-          address = (address + increment) & mask;
+          // contiguous block, which is always the case for linked-list packets
+          g_gpu->DMAWrite(address, src_pointer, word_count);
+        }
+        else
+        {
+          u8* ram_pointer = Bus::g_ram;
+          for (u32 i = 0; i < word_count; i++)
+          {
+            u32 value;
+            std::memcpy(&value, &ram_pointer[address], sizeof(u32));
+            g_gpu->DMAWrite(address, value);
+            address = (address + increment) & mask;
+          }
         }
         g_gpu->EndDMAWrite();
       }
@@ -557,11 +565,22 @@ TickCount DMA::TransferDeviceToMemory(Channel channel, u32 address, u32 incremen
     // clear ordering table
     u8* ram_pointer = Bus::g_ram;
     const u32 word_count_less_1 = word_count - 1;
-    for (u32 i = 0; i < word_count_less_1; i++)
+    if ((word_count_less_1 * 4) <= address)
     {
-      u32 value = ((address - 4) & mask);
-      std::memcpy(&ram_pointer[address], &value, sizeof(value));
-      address = (address - 4) & mask;
+      // doesn't wrap, so fill upwards from the terminator, each entry pointing to the one below it
+      address -= word_count_less_1 * 4;
+      u32* dest_pointer = reinterpret_cast<u32*>(&ram_pointer[address]);
+      for (u32 i = 1; i < word_count; i++)
+        dest_pointer[i] = address + ((i - 1) * 4);
+    }
+    else
+    {
+      for (u32 i = 0; i < word_count_less_1; i++)
+      {
+        u32 value = ((address - 4) & mask);
+        std::memcpy(&ram_pointer[address], &value, sizeof(value));
+        address = (address - 4) & mask;
+      }
     }
 
     const u32 terminator = UINT32_C(0xFFFFFF);
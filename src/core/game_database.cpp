@@ -1,10 +1,12 @@
 #include "game_database.h"
 #include "common/assert.h"
-#include "common/byte_stream.h"
+#include "common/file_system.h"
 #include "common/heterogeneous_containers.h"
 #include "common/log.h"
+#include "common/mapped_cache.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "common/timer.h"
 #include "host.h"
 #include "rapidjson/document.h"
@@ -12,8 +14,12 @@
 #include "system.h"
 #include "tinyxml2.h"
 #include "util/cd_image.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <sstream>
 Log_SetChannel(GameDatabase);
@@ -28,14 +34,91 @@ namespace GameDatabase {
 enum : u32
 {
   GAME_DATABASE_CACHE_SIGNATURE = 0x45434C48,
-  GAME_DATABASE_CACHE_VERSION = 2,
+  GAME_DATABASE_CACHE_VERSION = 3,
 };
 
+enum : u32
+{
+  CACHE_OPTIONAL_DISPLAY_ACTIVE_START_OFFSET,
+  CACHE_OPTIONAL_DISPLAY_ACTIVE_END_OFFSET,
+  CACHE_OPTIONAL_DISPLAY_LINE_START_OFFSET,
+  CACHE_OPTIONAL_DISPLAY_LINE_END_OFFSET,
+  CACHE_OPTIONAL_DMA_MAX_SLICE_TICKS,
+  CACHE_OPTIONAL_DMA_HALT_TICKS,
+  CACHE_OPTIONAL_GPU_FIFO_SIZE,
+  CACHE_OPTIONAL_GPU_MAX_RUN_AHEAD,
+  CACHE_OPTIONAL_GPU_PGXP_TOLERANCE,
+  CACHE_OPTIONAL_GPU_PGXP_DEPTH_THRESHOLD,
+};
+
+// The cache file is a MappedCache with a hash table of code indices. The records are sorted by serial, and followed by
+// the codes.
+struct CacheHeader
+{
+  u32 signature;
+  u32 version;
+  u64 gamedb_ts;
+  u64 gamesettings_ts;
+  u64 compat_ts;
+  u32 num_records;
+  u32 num_codes;
+  u32 num_buckets;
+  u32 string_pool_size;
+};
+
+struct CacheRecord
+{
+  MappedCache::String serial;
+  MappedCache::String title;
+  MappedCache::String genre;
+  MappedCache::String developer;
+  MappedCache::String publisher;
+  u64 release_date;
+  u32 supported_controllers;
+  u32 traits;
+  u32 dma_max_slice_ticks;
+  u32 dma_halt_ticks;
+  u32 gpu_fifo_size;
+  u32 gpu_max_run_ahead;
+  float gpu_pgxp_tolerance;
+  float gpu_pgxp_depth_threshold;
+  s16 display_active_start_offset;
+  s16 display_active_end_offset;
+  s8 display_line_start_offset;
+  s8 display_line_end_offset;
+  u8 min_players;
+  u8 max_players;
+  u8 min_blocks;
+  u8 max_blocks;
+  u8 compatibility;
+  u8 reserved0;
+  u16 optional_mask;
+  u16 reserved1;
+};
+
+struct CacheCode
+{
+  u64 hash;
+  MappedCache::String code;
+  u32 record_index;
+  u32 reserved;
+};
+static_assert(sizeof(CacheHeader) == 48 && sizeof(CacheRecord) == 96 && sizeof(CacheCode) == 24,
+              "Cache structures are packed");
+static_assert(static_cast<u32>(Trait::Count) <= 32, "Traits fit in cache record");
+
 static Entry* GetMutableEntry(const std::string_view& serial);
 static const Entry* GetEntryForId(const std::string_view& code);
 
 static bool LoadFromCache();
 static bool SaveToCache();
+static const CacheHeader* GetCacheHeader();
+static const CacheRecord* GetCacheRecords();
+static const CacheCode* GetCacheCodes();
+static std::string_view GetCacheString(const MappedCache::String& str);
+static const Entry* GetCachedEntry(u32 index);
+static const Entry* FindCachedEntryForCode(const std::string_view& code);
+static const Entry* FindCachedEntryForSerial(const std::string_view& serial);
 
 static bool LoadGameDBJson();
 static bool ParseJsonEntry(Entry* entry, const rapidjson::Value& value);
@@ -67,23 +150,32 @@ std::array<std::pair<const char*, const char*>, static_cast<u32>(GameDatabase::T
   {"ForceRecompilerLUTFastmem", TRANSLATABLE("GameSettingsTrait", "Force Recompiler LUT Fastmem")},
 }};
 
-static bool s_loaded = false;
+static std::atomic_bool s_loaded{false};
+static std::mutex s_load_mutex;
 static bool s_track_hashes_loaded = false;
 
+// only populated when the cache couldn't be used
 static std::vector<GameDatabase::Entry> s_entries;
 static UnorderedStringMap<u32> s_code_lookup;
 
+static FileSystem::MappedFile s_cache_file;
+static std::vector<std::unique_ptr<GameDatabase::Entry>> s_cache_entries;
+static std::mutex s_cache_entries_mutex;
+
 static TrackHashesMap s_track_hashes_map;
 } // namespace GameDatabase
 
 void GameDatabase::EnsureLoaded()
 {
-  if (s_loaded)
+  if (s_loaded.load(std::memory_order_acquire))
     return;
 
-  Common::Timer timer;
+  // may be racing with a preload
+  std::unique_lock lock(s_load_mutex);
+  if (s_loaded.load(std::memory_order_relaxed))
+    return;
 
-  s_loaded = true;
+  Common::Timer timer;
 
   if (!LoadFromCache())
   {
@@ -93,16 +185,34 @@ void GameDatabase::EnsureLoaded()
     LoadGameDBJson();
     LoadGameSettingsIni();
     LoadGameCompatibilityXml();
-    SaveToCache();
+
+    // switch over to the freshly written cache, so the parsed entries don't need to stay around
+    if (SaveToCache() && LoadFromCache())
+    {
+      s_entries = {};
+      s_code_lookup = {};
+    }
   }
 
+  s_loaded.store(true, std::memory_order_release);
   Log_InfoPrintf("Database load took %.2f ms", timer.GetTimeMilliseconds());
 }
 
+void GameDatabase::PreloadAsync()
+{
+  if (s_loaded.load(std::memory_order_acquire))
+    return;
+
+  Threading::ThreadPool::GetShared().Submit(&GameDatabase::EnsureLoaded);
+}
+
 void GameDatabase::Unload()
 {
+  std::unique_lock lock(s_load_mutex);
   s_entries = {};
   s_code_lookup = {};
+  s_cache_entries.clear();
+  s_cache_file.Unmap();
   s_loaded = false;
 }
 
@@ -110,6 +220,9 @@ const GameDatabase::Entry* GameDatabase::GetEntryForId(const std::string_view& c
 {
   EnsureLoaded();
 
+  if (s_cache_file.IsValid())
+    return FindCachedEntryForCode(code);
+
   auto iter = UnorderedStringMapFind(s_code_lookup, code);
   return (iter != s_code_lookup.end()) ? &s_entries[iter->second] : nullptr;
 }
@@ -118,7 +231,10 @@ std::string GameDatabase::GetSerialForDisc(CDImage* image)
 {
   std::string ret;
 
-  const GameDatabase::Entry* entry = GetEntryForDisc(image);
+  System::ImageIdentification ident;
+  System::IdentifyImage(image, &ident, false);
+
+  const GameDatabase::Entry* entry = GetEntryForIdentification(ident);
   if (entry)
     ret = entry->serial;
 
@@ -141,23 +257,27 @@ std::string GameDatabase::GetSerialForPath(const char* path)
 
 const GameDatabase::Entry* GameDatabase::GetEntryForDisc(CDImage* image)
 {
-  std::string id(System::GetGameIdFromImage(image, false));
-  if (!id.empty())
+  return GetEntryForIdentification(System::GetImageIdentification(image));
+}
+
+const GameDatabase::Entry* GameDatabase::GetEntryForIdentification(const System::ImageIdentification& ident)
+{
+  if (!ident.serial.empty())
   {
-    const Entry* entry = GetEntryForId(id);
+    const Entry* entry = GetEntryForId(ident.serial);
     if (entry)
       return entry;
   }
 
-  std::string hash_id(System::GetGameHashIdFromImage(image));
-  if (!hash_id.empty())
+  if (!ident.hash_id.empty())
   {
-    const Entry* entry = GetEntryForId(hash_id);
+    const Entry* entry = GetEntryForId(ident.hash_id);
     if (entry)
       return entry;
   }
 
-  Log_WarningPrintf("No entry found for disc (exe code: '%s', hash code: '%s')", id.c_str(), hash_id.c_str());
+  Log_WarningPrintf("No entry found for disc (exe code: '%s', hash code: '%s')", ident.serial.c_str(),
+                    ident.hash_id.c_str());
   return nullptr;
 }
 
@@ -165,6 +285,9 @@ const GameDatabase::Entry* GameDatabase::GetEntryForSerial(const std::string_vie
 {
   EnsureLoaded();
 
+  if (s_cache_file.IsValid())
+    return FindCachedEntryForSerial(serial);
+
   return GetMutableEntry(serial);
 }
 
@@ -498,128 +621,172 @@ static void GetTimestamps(u64* gamedb_ts, u64* gamesettings_ts, u64* compat_ts)
   *compat_ts = Host::GetResourceFileTimestamp("database/compatibility.xml").value_or(0);
 }
 
-template<typename T>
-bool ReadOptionalFromStream(ByteStream* stream, std::optional<T>* dest)
+static std::string GetCacheFile()
 {
-  bool has_value;
-  if (!stream->Read2(&has_value, sizeof(has_value)))
-    return false;
+  return Path::Combine(EmuFolders::Cache, "gamedb.cache");
+}
+
+const GameDatabase::CacheHeader* GameDatabase::GetCacheHeader()
+{
+  return reinterpret_cast<const CacheHeader*>(s_cache_file.GetData());
+}
 
-  if (!has_value)
-    return true;
+const GameDatabase::CacheRecord* GameDatabase::GetCacheRecords()
+{
+  return reinterpret_cast<const CacheRecord*>(
+    MappedCache::GetRecords(s_cache_file, sizeof(CacheHeader), GetCacheHeader()->num_buckets));
+}
 
-  T value;
-  if (!stream->Read2(&value, sizeof(T)))
-    return false;
+const GameDatabase::CacheCode* GameDatabase::GetCacheCodes()
+{
+  return reinterpret_cast<const CacheCode*>(reinterpret_cast<const u8*>(GetCacheRecords()) +
+                                            sizeof(CacheRecord) * GetCacheHeader()->num_records);
+}
 
-  *dest = value;
-  return true;
+std::string_view GameDatabase::GetCacheString(const MappedCache::String& str)
+{
+  return MappedCache::GetString(s_cache_file, GetCacheHeader()->string_pool_size, str);
 }
 
 template<typename T>
-bool WriteOptionalToStream(ByteStream* stream, const std::optional<T>& src)
+static void ReadCacheOptional(u16 mask, u32 bit, const T& src, std::optional<T>* dest)
 {
-  const bool has_value = src.has_value();
-  if (!stream->Write2(&has_value, sizeof(has_value)))
-    return false;
+  if (mask & (1u << bit))
+    *dest = src;
+}
 
-  if (!has_value)
-    return true;
+template<typename T>
+static void WriteCacheOptional(u16* mask, u32 bit, T* dest, const std::optional<T>& src)
+{
+  if (!src.has_value())
+    return;
 
-  return stream->Write2(&src.value(), sizeof(T));
+  *mask |= static_cast<u16>(1u << bit);
+  *dest = src.value();
 }
 
-static std::string GetCacheFile()
+const GameDatabase::Entry* GameDatabase::GetCachedEntry(u32 index)
 {
-  return Path::Combine(EmuFolders::Cache, "gamedb.cache");
+  // entries are decoded on first use, game list scanning looks them up from several threads
+  std::unique_lock lock(s_cache_entries_mutex);
+  std::unique_ptr<Entry>& cached = s_cache_entries[index];
+  if (cached)
+    return cached.get();
+
+  const CacheRecord& record = GetCacheRecords()[index];
+  if (record.compatibility >= static_cast<u8>(CompatibilityRating::Count))
+  {
+    Log_WarningPrintf("Game database cache record %u is corrupted", index);
+    return nullptr;
+  }
+
+  std::unique_ptr<Entry> entry = std::make_unique<Entry>();
+  entry->serial = GetCacheString(record.serial);
+  entry->title = GetCacheString(record.title);
+  entry->genre = GetCacheString(record.genre);
+  entry->developer = GetCacheString(record.developer);
+  entry->publisher = GetCacheString(record.publisher);
+  entry->release_date = record.release_date;
+  entry->min_players = record.min_players;
+  entry->max_players = record.max_players;
+  entry->min_blocks = record.min_blocks;
+  entry->max_blocks = record.max_blocks;
+  entry->supported_controllers = record.supported_controllers;
+  entry->compatibility = static_cast<CompatibilityRating>(record.compatibility);
+  entry->traits = std::bitset<static_cast<int>(Trait::Count)>(record.traits);
+
+  const u16 mask = record.optional_mask;
+  ReadCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_ACTIVE_START_OFFSET, record.display_active_start_offset,
+                    &entry->display_active_start_offset);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_ACTIVE_END_OFFSET, record.display_active_end_offset,
+                    &entry->display_active_end_offset);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_LINE_START_OFFSET, record.display_line_start_offset,
+                    &entry->display_line_start_offset);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_LINE_END_OFFSET, record.display_line_end_offset,
+                    &entry->display_line_end_offset);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_DMA_MAX_SLICE_TICKS, record.dma_max_slice_ticks, &entry->dma_max_slice_ticks);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_DMA_HALT_TICKS, record.dma_halt_ticks, &entry->dma_halt_ticks);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_GPU_FIFO_SIZE, record.gpu_fifo_size, &entry->gpu_fifo_size);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_GPU_MAX_RUN_AHEAD, record.gpu_max_run_ahead, &entry->gpu_max_run_ahead);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_GPU_PGXP_TOLERANCE, record.gpu_pgxp_tolerance, &entry->gpu_pgxp_tolerance);
+  ReadCacheOptional(mask, CACHE_OPTIONAL_GPU_PGXP_DEPTH_THRESHOLD, record.gpu_pgxp_depth_threshold,
+                    &entry->gpu_pgxp_depth_threshold);
+
+  cached = std::move(entry);
+  return cached.get();
+}
+
+const GameDatabase::Entry* GameDatabase::FindCachedEntryForCode(const std::string_view& code)
+{
+  const CacheHeader* header = GetCacheHeader();
+  const u32* buckets = MappedCache::GetBuckets(s_cache_file, sizeof(CacheHeader));
+  const CacheCode* codes = GetCacheCodes();
+  const u64 hash = MappedCache::HashKey(code);
+  const u32 code_index =
+    MappedCache::Find(buckets, header->num_buckets, header->num_codes, hash, [codes, hash, &code](u32 index) {
+      return (codes[index].hash == hash && GetCacheString(codes[index].code) == code);
+    });
+  if (code_index == MappedCache::EMPTY_BUCKET)
+    return nullptr;
+
+  const u32 record_index = codes[code_index].record_index;
+  return (record_index < header->num_records) ? GetCachedEntry(record_index) : nullptr;
+}
+
+const GameDatabase::Entry* GameDatabase::FindCachedEntryForSerial(const std::string_view& serial)
+{
+  // records are sorted by serial
+  const CacheRecord* begin = GetCacheRecords();
+  const CacheRecord* end = begin + GetCacheHeader()->num_records;
+  const CacheRecord* iter =
+    std::lower_bound(begin, end, serial, [](const CacheRecord& record, const std::string_view& search) {
+      return GetCacheString(record.serial) < search;
+    });
+  if (iter == end || GetCacheString(iter->serial) != serial)
+    return nullptr;
+
+  return GetCachedEntry(static_cast<u32>(iter - begin));
 }
 
 bool GameDatabase::LoadFromCache()
 {
-  std::unique_ptr<ByteStream> stream(
-    ByteStream::OpenFile(GetCacheFile().c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED));
-  if (!stream)
+  const std::string filename(GetCacheFile());
+  std::FILE* fp = FileSystem::OpenCFile(filename.c_str(), "rb");
+  if (!fp)
   {
     Log_DevPrintf("Cache does not exist, loading full database.");
     return false;
   }
 
-  u64 gamedb_ts, gamesettings_ts, compat_ts;
-  GetTimestamps(&gamedb_ts, &gamesettings_ts, &compat_ts);
+  const bool mapped = s_cache_file.Map(fp);
+  std::fclose(fp);
+  if (!mapped)
+    return false;
 
-  u32 signature, version, num_entries, num_codes;
-  u64 file_gamedb_ts, file_gamesettings_ts, file_compat_ts;
-  if (!stream->ReadU32(&signature) || !stream->ReadU32(&version) || !stream->ReadU64(&file_gamedb_ts) ||
-      !stream->ReadU64(&file_gamesettings_ts) || !stream->ReadU64(&file_compat_ts) || !stream->ReadU32(&num_entries) ||
-      !stream->ReadU32(&num_codes) || signature != GAME_DATABASE_CACHE_SIGNATURE ||
-      version != GAME_DATABASE_CACHE_VERSION)
+  const CacheHeader* header = GetCacheHeader();
+  if (!MappedCache::CheckHeader(s_cache_file, sizeof(CacheHeader), GAME_DATABASE_CACHE_SIGNATURE,
+                                GAME_DATABASE_CACHE_VERSION) ||
+      !MappedCache::IsValidLayout(s_cache_file, sizeof(CacheHeader), header->num_buckets, header->num_codes,
+                                  sizeof(CacheRecord) * static_cast<u64>(header->num_records) +
+                                    sizeof(CacheCode) * static_cast<u64>(header->num_codes),
+                                  header->string_pool_size))
   {
     Log_DevPrintf("Cache header is corrupted or version mismatch.");
+    s_cache_file.Unmap();
     return false;
   }
 
-  if (gamedb_ts != file_gamedb_ts || gamesettings_ts != file_gamesettings_ts || compat_ts != file_compat_ts)
+  u64 gamedb_ts, gamesettings_ts, compat_ts;
+  GetTimestamps(&gamedb_ts, &gamesettings_ts, &compat_ts);
+  if (gamedb_ts != header->gamedb_ts || gamesettings_ts != header->gamesettings_ts || compat_ts != header->compat_ts)
   {
     Log_DevPrintf("Cache is out of date, recreating.");
+    s_cache_file.Unmap();
     return false;
   }
 
-  s_entries.reserve(num_entries);
-
-  for (u32 i = 0; i < num_entries; i++)
-  {
-    Entry& entry = s_entries.emplace_back();
-
-    constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
-    std::array<u8, num_bytes> bits;
-    u8 compatibility;
-
-    if (!stream->ReadSizePrefixedString(&entry.serial) || !stream->ReadSizePrefixedString(&entry.title) ||
-        !stream->ReadSizePrefixedString(&entry.genre) || !stream->ReadSizePrefixedString(&entry.developer) ||
-        !stream->ReadSizePrefixedString(&entry.publisher) || !stream->ReadU64(&entry.release_date) ||
-        !stream->ReadU8(&entry.min_players) || !stream->ReadU8(&entry.max_players) ||
-        !stream->ReadU8(&entry.min_blocks) || !stream->ReadU8(&entry.max_blocks) ||
-        !stream->ReadU32(&entry.supported_controllers) || !stream->ReadU8(&compatibility) ||
-        compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count) ||
-        !stream->Read2(bits.data(), num_bytes) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_active_start_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_active_end_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_line_start_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.display_line_end_offset) ||
-        !ReadOptionalFromStream(stream.get(), &entry.dma_max_slice_ticks) ||
-        !ReadOptionalFromStream(stream.get(), &entry.dma_halt_ticks) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_fifo_size) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_max_run_ahead) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_pgxp_tolerance) ||
-        !ReadOptionalFromStream(stream.get(), &entry.gpu_pgxp_depth_threshold))
-    {
-      Log_DevPrintf("Cache entry is corrupted.");
-      return false;
-    }
-
-    entry.compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility);
-    entry.traits.reset();
-    for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
-    {
-      if ((bits[j / 8] & (1u << (j % 8))) != 0)
-        entry.traits[j] = true;
-    }
-  }
-
-  for (u32 i = 0; i < num_codes; i++)
-  {
-    std::string code;
-    u32 index;
-    if (!stream->ReadSizePrefixedString(&code) || !stream->ReadU32(&index) ||
-        index >= static_cast<u32>(s_entries.size()))
-    {
-      Log_DevPrintf("Cache code entry is corrupted.");
-      return false;
-    }
-
-    s_code_lookup.emplace(std::move(code), index);
-  }
-
+  s_cache_entries.resize(header->num_records);
+  Log_DevPrintf("Mapped game database cache with %u entries and %u codes", header->num_records, header->num_codes);
   return true;
 }
 
@@ -628,66 +795,99 @@ bool GameDatabase::SaveToCache()
   u64 gamedb_ts, gamesettings_ts, compat_ts;
   GetTimestamps(&gamedb_ts, &gamesettings_ts, &compat_ts);
 
-  std::unique_ptr<ByteStream> stream(
-    ByteStream::OpenFile(GetCacheFile().c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE |
-                                                   BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_STREAMED));
-  if (!stream)
-    return false;
-
-  bool result = stream->WriteU32(GAME_DATABASE_CACHE_SIGNATURE);
-  result = result && stream->WriteU32(GAME_DATABASE_CACHE_VERSION);
-  result = result && stream->WriteU64(static_cast<u64>(gamedb_ts));
-  result = result && stream->WriteU64(static_cast<u64>(gamesettings_ts));
-  result = result && stream->WriteU64(static_cast<u64>(compat_ts));
-
-  result = result && stream->WriteU32(static_cast<u32>(s_entries.size()));
-  result = result && stream->WriteU32(static_cast<u32>(s_code_lookup.size()));
-
-  for (const Entry& entry : s_entries)
+  // sort by serial so serial lookups can binary search the mapped records
+  std::vector<u32> order(s_entries.size());
+  for (u32 i = 0; i < static_cast<u32>(order.size()); i++)
+    order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+                   [](u32 lhs, u32 rhs) { return s_entries[lhs].serial < s_entries[rhs].serial; });
+
+  std::vector<u32> record_for_entry(s_entries.size());
+  std::vector<CacheRecord> records;
+  std::vector<CacheCode> codes;
+  MappedCache::StringPool string_pool;
+  records.reserve(s_entries.size());
+  codes.reserve(s_code_lookup.size());
+
+  for (const u32 entry_index : order)
   {
-    result = result && stream->WriteSizePrefixedString(entry.serial);
-    result = result && stream->WriteSizePrefixedString(entry.title);
-    result = result && stream->WriteSizePrefixedString(entry.genre);
-    result = result && stream->WriteSizePrefixedString(entry.developer);
-    result = result && stream->WriteSizePrefixedString(entry.publisher);
-    result = result && stream->WriteU64(entry.release_date);
-    result = result && stream->WriteU8(entry.min_players);
-    result = result && stream->WriteU8(entry.max_players);
-    result = result && stream->WriteU8(entry.min_blocks);
-    result = result && stream->WriteU8(entry.max_blocks);
-    result = result && stream->WriteU32(entry.supported_controllers);
-    result = result && stream->WriteU8(static_cast<u8>(entry.compatibility));
-
-    constexpr u32 num_bytes = (static_cast<u32>(Trait::Count) + 7) / 8;
-    std::array<u8, num_bytes> bits;
-    bits.fill(0);
-    for (u32 j = 0; j < static_cast<int>(Trait::Count); j++)
-    {
-      if (entry.traits[j])
-        bits[j / 8] |= (1u << (j % 8));
-    }
-
-    result = result && stream->Write2(bits.data(), num_bytes);
-
-    result = result && WriteOptionalToStream(stream.get(), entry.display_active_start_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_active_end_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_line_start_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.display_line_end_offset);
-    result = result && WriteOptionalToStream(stream.get(), entry.dma_max_slice_ticks);
-    result = result && WriteOptionalToStream(stream.get(), entry.dma_halt_ticks);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_fifo_size);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_max_run_ahead);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_pgxp_tolerance);
-    result = result && WriteOptionalToStream(stream.get(), entry.gpu_pgxp_depth_threshold);
+    const Entry& entry = s_entries[entry_index];
+    record_for_entry[entry_index] = static_cast<u32>(records.size());
+
+    CacheRecord& record = records.emplace_back();
+    std::memset(&record, 0, sizeof(record));
+    record.serial = string_pool.Add(entry.serial);
+    record.title = string_pool.Add(entry.title);
+    record.genre = string_pool.Add(entry.genre);
+    record.developer = string_pool.Add(entry.developer);
+    record.publisher = string_pool.Add(entry.publisher);
+    record.release_date = entry.release_date;
+    record.supported_controllers = entry.supported_controllers;
+    record.traits = static_cast<u32>(entry.traits.to_ulong());
+    record.min_players = entry.min_players;
+    record.max_players = entry.max_players;
+    record.min_blocks = entry.min_blocks;
+    record.max_blocks = entry.max_blocks;
+    record.compatibility = static_cast<u8>(entry.compatibility);
+
+    u16* mask = &record.optional_mask;
+    WriteCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_ACTIVE_START_OFFSET, &record.display_active_start_offset,
+                       entry.display_active_start_offset);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_ACTIVE_END_OFFSET, &record.display_active_end_offset,
+                       entry.display_active_end_offset);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_LINE_START_OFFSET, &record.display_line_start_offset,
+                       entry.display_line_start_offset);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_DISPLAY_LINE_END_OFFSET, &record.display_line_end_offset,
+                       entry.display_line_end_offset);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_DMA_MAX_SLICE_TICKS, &record.dma_max_slice_ticks,
+                       entry.dma_max_slice_ticks);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_DMA_HALT_TICKS, &record.dma_halt_ticks, entry.dma_halt_ticks);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_GPU_FIFO_SIZE, &record.gpu_fifo_size, entry.gpu_fifo_size);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_GPU_MAX_RUN_AHEAD, &record.gpu_max_run_ahead, entry.gpu_max_run_ahead);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_GPU_PGXP_TOLERANCE, &record.gpu_pgxp_tolerance,
+                       entry.gpu_pgxp_tolerance);
+    WriteCacheOptional(mask, CACHE_OPTIONAL_GPU_PGXP_DEPTH_THRESHOLD, &record.gpu_pgxp_depth_threshold,
+                       entry.gpu_pgxp_depth_threshold);
   }
 
+  // codes are the keys of the lookup map, so they can't be duplicated
+  const u32 num_buckets = MappedCache::GetBucketCount(s_code_lookup.size());
+  std::vector<u32> buckets(num_buckets, MappedCache::EMPTY_BUCKET);
   for (const auto& it : s_code_lookup)
   {
-    result = result && stream->WriteSizePrefixedString(it.first);
-    result = result && stream->WriteU32(it.second);
+    const u64 hash = MappedCache::HashKey(it.first);
+    const u32 bucket = MappedCache::FindFreeBucket(buckets.data(), num_buckets, hash, [](u32) { return false; });
+
+    CacheCode& code = codes.emplace_back();
+    std::memset(&code, 0, sizeof(code));
+    code.hash = hash;
+    code.code = string_pool.Add(it.first);
+    code.record_index = record_for_entry[it.second];
+    buckets[bucket] = static_cast<u32>(codes.size() - 1);
+  }
+
+  CacheHeader header = {};
+  header.signature = GAME_DATABASE_CACHE_SIGNATURE;
+  header.version = GAME_DATABASE_CACHE_VERSION;
+  header.gamedb_ts = gamedb_ts;
+  header.gamesettings_ts = gamesettings_ts;
+  header.compat_ts = compat_ts;
+  header.num_records = static_cast<u32>(records.size());
+  header.num_codes = static_cast<u32>(codes.size());
+  header.num_buckets = num_buckets;
+  header.string_pool_size = string_pool.GetSize();
+
+  const std::string filename(GetCacheFile());
+  if (!MappedCache::WriteFile(filename, {{&header, sizeof(header)},
+                                         {buckets.data(), sizeof(u32) * buckets.size()},
+                                         {records.data(), sizeof(CacheRecord) * records.size()},
+                                         {codes.data(), sizeof(CacheCode) * codes.size()},
+                                         {string_pool.GetData(), string_pool.GetSize()}}))
+  {
+    Log_ErrorPrintf("Failed to write game database cache '%s'", filename.c_str());
+    return false;
   }
 
-  result = result && stream->Flush();
   return true;
 }
 
@@ -11,6 +11,10 @@ class CDImage;
 
 struct Settings;
 
+namespace System {
+struct ImageIdentification;
+}
+
 namespace GameDatabase {
 enum class CompatibilityRating : u32
 {
@@ -84,7 +88,12 @@ struct Entry
 void EnsureLoaded();
 void Unload();
 
+/// Starts loading the database on a worker thread, lookups block until it has finished.
+void PreloadAsync();
+
+/// Looks up the entry for an image the system is booting or running, see System::GetImageIdentification().
 const Entry* GetEntryForDisc(CDImage* image);
+const Entry* GetEntryForIdentification(const System::ImageIdentification& ident);
 const Entry* GetEntryForSerial(const std::string_view& serial);
 std::string GetSerialForDisc(CDImage* image);
 std::string GetSerialForPath(const char* path);
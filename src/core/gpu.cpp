@@ -2,6 +2,7 @@
 #include "common/file_system.h"
 #include "common/heap_array.h"
 #include "common/log.h"
+#include "common/pixel_conversion.h"
 #include "common/string_util.h"
 #include "dma.h"
 #include "host.h"
@@ -14,6 +15,7 @@
 #include "timers.h"
 #include "util/state_wrapper.h"
 #include <cmath>
+#include <cstring>
 Log_SetChannel(GPU);
 
 std::unique_ptr<GPU> g_gpu;
@@ -51,7 +53,8 @@ bool GPU::Initialize()
     Host::AddOSDMessage(Host::TranslateStdString("OSDMessage", "Failed to load post processing shader chain."), 20.0f);
   }
 
-  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu);
+  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu || g_settings.display_log_gpu_timings ||
+                                      g_settings.gpu_dynamic_resolution);
 
   return true;
 }
@@ -72,7 +75,8 @@ void GPU::UpdateSettings()
   // Crop mode calls this, so recalculate the display area
   UpdateCRTCDisplayParameters();
 
-  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu);
+  g_host_display->SetGPUTimingEnabled(g_settings.display_show_gpu || g_settings.display_log_gpu_timings ||
+                                      g_settings.gpu_dynamic_resolution);
 }
 
 bool GPU::IsHardwareRenderer()
@@ -88,6 +92,8 @@ void GPU::CPUClockChanged()
 
 void GPU::UpdateResolutionScale() {}
 
+void GPU::UpdateDynamicResolution(float gpu_time, float frame_time_budget) {}
+
 std::tuple<u32, u32> GPU::GetEffectiveDisplayResolution(bool scaled /* = true */)
 {
   return std::tie(m_crtc_state.display_vram_width, m_crtc_state.display_vram_height);
@@ -111,6 +117,7 @@ void GPU::Reset(bool clear_vram)
   m_crtc_state.in_vblank = false;
   m_crtc_state.interlaced_field = 0;
   m_crtc_state.interlaced_display_field = 0;
+  m_vram_modified_since_vblank = true;
   SoftReset();
   UpdateDisplay();
 }
@@ -417,6 +424,24 @@ void GPU::DMARead(u32* words, u32 word_count)
     words[i] = ReadGPUREAD();
 }
 
+void GPU::DMAWrite(u32 address, const u32* words, u32 word_count)
+{
+  // pack the address/value pairs into a local buffer first, so the FIFO only has to do one copy per chunk
+  static constexpr u32 CHUNK_SIZE = 256;
+  std::array<u64, CHUNK_SIZE> chunk;
+  while (word_count > 0)
+  {
+    const u32 chunk_size = std::min(word_count, CHUNK_SIZE);
+    for (u32 i = 0; i < chunk_size; i++)
+      chunk[i] = (ZeroExtend64(address + (i * static_cast<u32>(sizeof(u32)))) << 32) | ZeroExtend64(words[i]);
+
+    m_fifo.PushRange(chunk.data(), chunk_size);
+    address += chunk_size * sizeof(u32);
+    words += chunk_size;
+    word_count -= chunk_size;
+  }
+}
+
 void GPU::EndDMAWrite()
 {
   m_fifo_pushed = true;
@@ -900,6 +925,7 @@ void GPU::CRTCTickEvent(TickCount ticks)
         // flush any pending draws and "scan out" the image
         FlushRender();
         UpdateDisplay();
+        g_host_display->NotifyDisplayFrame(CheckForDisplayChangesSinceVBlank());
         System::FrameDone();
 
         // switch fields early. this is needed so we draw to the correct one.
@@ -1284,6 +1310,25 @@ void GPU::ClearDisplay() {}
 
 void GPU::UpdateDisplay() {}
 
+bool GPU::CheckForDisplayChangesSinceVBlank()
+{
+  // resolution, colour depth, interlacing and blanking
+  static constexpr u32 DISPLAY_MODE_MASK = 0x00FF0000u;
+
+  const u32 display_mode = m_GPUSTAT.bits & DISPLAY_MODE_MASK;
+  const u64 display_area =
+    ZeroExtend64(m_crtc_state.display_vram_left) | (ZeroExtend64(m_crtc_state.display_vram_top) << 16) |
+    (ZeroExtend64(m_crtc_state.display_vram_width) << 32) | (ZeroExtend64(m_crtc_state.display_vram_height) << 48);
+
+  // interlaced output alternates fields, so is never the same twice in a row
+  const bool changed = (m_vram_modified_since_vblank || IsInterlacedDisplayEnabled() ||
+                        display_mode != m_last_vblank_display_mode || display_area != m_last_vblank_display_area);
+  m_vram_modified_since_vblank = false;
+  m_last_vblank_display_mode = display_mode;
+  m_last_vblank_display_area = display_area;
+  return changed;
+}
+
 void GPU::ReadVRAM(u32 x, u32 y, u32 width, u32 height) {}
 
 void GPU::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
@@ -1369,37 +1414,41 @@ void GPU::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool
   }
 }
 
-void GPU::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
+void GPU::CopyOversizedVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
-  // Break up oversized copies. This behavior has not been verified on console.
-  if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
+  u32 remaining_rows = height;
+  u32 current_src_y = src_y;
+  u32 current_dst_y = dst_y;
+  while (remaining_rows > 0)
   {
-    u32 remaining_rows = height;
-    u32 current_src_y = src_y;
-    u32 current_dst_y = dst_y;
-    while (remaining_rows > 0)
-    {
-      const u32 rows_to_copy =
-        std::min<u32>(remaining_rows, std::min<u32>(VRAM_HEIGHT - current_src_y, VRAM_HEIGHT - current_dst_y));
+    const u32 rows_to_copy =
+      std::min<u32>(remaining_rows, std::min<u32>(VRAM_HEIGHT - current_src_y, VRAM_HEIGHT - current_dst_y));
 
-      u32 remaining_columns = width;
-      u32 current_src_x = src_x;
-      u32 current_dst_x = dst_x;
-      while (remaining_columns > 0)
-      {
-        const u32 columns_to_copy =
-          std::min<u32>(remaining_columns, std::min<u32>(VRAM_WIDTH - current_src_x, VRAM_WIDTH - current_dst_x));
-        CopyVRAM(current_src_x, current_src_y, current_dst_x, current_dst_y, columns_to_copy, rows_to_copy);
-        current_src_x = (current_src_x + columns_to_copy) % VRAM_WIDTH;
-        current_dst_x = (current_dst_x + columns_to_copy) % VRAM_WIDTH;
-        remaining_columns -= columns_to_copy;
-      }
-
-      current_src_y = (current_src_y + rows_to_copy) % VRAM_HEIGHT;
-      current_dst_y = (current_dst_y + rows_to_copy) % VRAM_HEIGHT;
-      remaining_rows -= rows_to_copy;
+    u32 remaining_columns = width;
+    u32 current_src_x = src_x;
+    u32 current_dst_x = dst_x;
+    while (remaining_columns > 0)
+    {
+      const u32 columns_to_copy =
+        std::min<u32>(remaining_columns, std::min<u32>(VRAM_WIDTH - current_src_x, VRAM_WIDTH - current_dst_x));
+      CopyVRAM(current_src_x, current_src_y, current_dst_x, current_dst_y, columns_to_copy, rows_to_copy);
+      current_src_x = (current_src_x + columns_to_copy) % VRAM_WIDTH;
+      current_dst_x = (current_dst_x + columns_to_copy) % VRAM_WIDTH;
+      remaining_columns -= columns_to_copy;
     }
 
+    current_src_y = (current_src_y + rows_to_copy) % VRAM_HEIGHT;
+    current_dst_y = (current_dst_y + rows_to_copy) % VRAM_HEIGHT;
+    remaining_rows -= rows_to_copy;
+  }
+}
+
+void GPU::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
+{
+  // Break up oversized copies. This behavior has not been verified on console.
+  if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
+  {
+    CopyOversizedVRAM(src_x, src_y, dst_x, dst_y, width, height);
     return;
   }
 
@@ -1442,10 +1491,18 @@ void GPU::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 he
   }
 }
 
+void GPU::TrackVRAMRead(u32 x, u32 y, u32 width, u32 height) {}
+
 void GPU::DispatchRenderCommand() {}
 
 void GPU::FlushRender() {}
 
+void GPU::QueueVRAMWrite(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
+{
+  FlushRender();
+  UpdateVRAM(x, y, width, height, data, set_mask, check_mask);
+}
+
 void GPU::SetDrawMode(u16 value)
 {
   GPUDrawModeReg new_mode_reg{static_cast<u16>(value & GPUDrawModeReg::MASK)};
@@ -1508,18 +1565,22 @@ void GPU::SetTextureWindow(u32 value)
   m_draw_mode.texture_window_changed = true;
 }
 
-bool GPU::DumpVRAMToFile(const char* filename)
+void GPU::CopyVRAM(u16* dst)
 {
   ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  std::memcpy(dst, m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+}
 
+bool GPU::DumpVRAMToFile(const char* filename, const u16* vram)
+{
   const char* extension = std::strrchr(filename, '.');
   if (extension && StringUtil::Strcasecmp(extension, ".png") == 0)
   {
-    return DumpVRAMToFile(filename, VRAM_WIDTH, VRAM_HEIGHT, sizeof(u16) * VRAM_WIDTH, m_vram_ptr, true);
+    return DumpVRAMToFile(filename, VRAM_WIDTH, VRAM_HEIGHT, sizeof(u16) * VRAM_WIDTH, vram, true);
   }
   else if (extension && StringUtil::Strcasecmp(extension, ".bin") == 0)
   {
-    return FileSystem::WriteBinaryFile(filename, m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
+    return FileSystem::WriteBinaryFile(filename, vram, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
   }
   else
   {
@@ -1541,19 +1602,12 @@ bool GPU::DumpVRAMToFile(const char* filename, u32 width, u32 height, u32 stride
 
   const char* ptr_in = static_cast<const char*>(buffer);
   u32* ptr_out = rgba8_buf.get();
+  const u32 alpha_or = remove_alpha ? 0xFF000000u : 0u;
   for (u32 row = 0; row < height; row++)
   {
-    const char* row_ptr_in = ptr_in;
-
-    for (u32 col = 0; col < width; col++)
-    {
-      u16 src_col;
-      std::memcpy(&src_col, row_ptr_in, sizeof(u16));
-      row_ptr_in += sizeof(u16);
-      *(ptr_out++) = VRAMRGBA5551ToRGBA8888(remove_alpha ? (src_col | u16(0x8000)) : src_col);
-    }
-
+    PixelConversion::ConvertRGBA5551ToRGBA8(ptr_out, ptr_in, width, alpha_or);
     ptr_in += stride;
+    ptr_out += width;
   }
 
   const auto write_func = [](void* context, void* data, int size) {
@@ -1,6 +1,7 @@
 #pragma once
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
+#include "common/heap_array.h"
 #include "common/rectangle.h"
 #include "gpu_types.h"
 #include "timers.h"
@@ -107,6 +108,9 @@ public:
   {
     m_fifo.Push((ZeroExtend64(address) << 32) | ZeroExtend64(value));
   }
+
+  /// Bulk version of DMAWrite() for a block which is contiguous in RAM, e.g. a linked-list packet.
+  void DMAWrite(u32 address, const u32* words, u32 word_count);
   void EndDMAWrite();
 
   /// Returns true if no data is being sent from VRAM to the DAC or that no portion of VRAM would be visible on screen.
@@ -146,6 +150,12 @@ public:
   /// Updates the resolution scale when it's set to automatic.
   virtual void UpdateResolutionScale();
 
+  /// Raises or lowers the resolution scale to keep the average GPU frame time (ms) within the frame budget.
+  virtual void UpdateDynamicResolution(float gpu_time, float frame_time_budget);
+
+  /// Set while emulating a frame which won't be presented. Renderers may then leave out draws which nothing reads.
+  ALWAYS_INLINE void SetFrameSkip(bool enabled) { m_frame_skip = enabled; }
+
   /// Returns the effective display resolution of the GPU.
   virtual std::tuple<u32, u32> GetEffectiveDisplayResolution(bool scaled = true);
 
@@ -184,8 +194,12 @@ public:
   // Returns the video clock frequency.
   TickCount GetCRTCFrequency() const;
 
-  // Dumps raw VRAM to a file.
-  bool DumpVRAMToFile(const char* filename);
+  // Copies all of VRAM to dst, which must hold VRAM_WIDTH * VRAM_HEIGHT pixels.
+  void CopyVRAM(u16* dst);
+
+  // Dumps a copy of VRAM to a PNG or raw file depending on the extension. Doesn't touch the GPU, so any thread can
+  // write the dump.
+  static bool DumpVRAMToFile(const char* filename, const u16* vram);
 
 protected:
   TickCount CRTCTicksToSystemTicks(TickCount crtc_ticks, TickCount fractional_ticks) const;
@@ -284,11 +298,26 @@ protected:
   virtual void ReadVRAM(u32 x, u32 y, u32 width, u32 height);
   virtual void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color);
   virtual void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask);
+
+  /// Uploads a completed CPU to VRAM transfer after any pending draws. Backends may defer and merge these uploads.
+  virtual void QueueVRAMWrite(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask);
+
   virtual void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height);
+
+  /// Splits a copy which crosses the edge of VRAM into pieces which don't, and passes each to CopyVRAM().
+  void CopyOversizedVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height);
+
+  /// Called before the CPU or a VRAM copy reads an area, so renderers know it has to be kept up to date.
+  virtual void TrackVRAMRead(u32 x, u32 y, u32 width, u32 height);
+
   virtual void DispatchRenderCommand();
   virtual void FlushRender();
   virtual void ClearDisplay();
   virtual void UpdateDisplay();
+
+  /// Returns true if the scanned out image could differ from the one at the last vblank, and resets tracking.
+  bool CheckForDisplayChangesSinceVBlank();
+
   virtual void DrawRendererStats(bool is_idle_frame);
 
   ALWAYS_INLINE void AddDrawTriangleTicks(s32 x1, s32 y1, s32 x2, s32 y2, s32 x3, s32 y3, bool shaded, bool textured,
@@ -334,8 +363,13 @@ protected:
   std::unique_ptr<TimingEvent> m_crtc_tick_event;
   std::unique_ptr<TimingEvent> m_command_tick_event;
 
-  // Pointer to VRAM, used for reads/writes. In the hardware backends, this is the shadow buffer.
-  u16* m_vram_ptr = nullptr;
+  // The only CPU-side copy of VRAM. The software backend, or the hardware renderer's software readback backend, draws
+  // into it on its own thread, so it must be synced before the emulation thread touches it. Without one, it shadows
+  // the hardware renderer's VRAM texture, and is only current for regions which have been read back.
+  HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram_shadow;
+
+  // Pointer to VRAM, used for reads/writes. Always points at m_vram_shadow.
+  u16* m_vram_ptr = m_vram_shadow.data();
 
   union GPUSTAT
   {
@@ -447,6 +481,14 @@ protected:
   bool m_drawing_area_changed = false;
   bool m_force_progressive_scan = false;
   bool m_force_ntsc_timings = false;
+  bool m_frame_skip = false;
+
+  /// Set when VRAM is drawn to or written, so duplicate frames can be detected at vblank.
+  bool m_vram_modified_since_vblank = true;
+
+  /// Display mode and area which was scanned out at the last vblank.
+  u32 m_last_vblank_display_mode = 0;
+  u64 m_last_vblank_display_area = 0;
 
   struct CRTCState
   {
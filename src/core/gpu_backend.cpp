@@ -1,6 +1,7 @@
 #include "gpu_backend.h"
 #include "common/align.h"
 #include "common/log.h"
+#include "common/thread_placement.h"
 #include "common/timer.h"
 #include "settings.h"
 #include "util/state_wrapper.h"
@@ -144,6 +145,8 @@ u32 GPUBackend::GetPendingCommandSize() const
 
 void GPUBackend::PushCommand(GPUBackendCommand* cmd)
 {
+  m_commands_since_sync = true;
+
   if (!m_use_gpu_thread)
   {
     // single-thread mode
@@ -173,7 +176,10 @@ void GPUBackend::StartGPUThread()
 {
   m_gpu_loop_done.store(false);
   m_use_gpu_thread = true;
-  m_gpu_thread.Start([this]() { RunGPULoop(); });
+  m_gpu_thread.Start([this]() {
+    Threading::ApplyThreadPlacement(Threading::ThreadClass::GPURenderer);
+    RunGPULoop();
+  });
   Log_InfoPrint("GPU thread started.");
 }
 
@@ -191,13 +197,23 @@ void GPUBackend::StopGPUThread()
 
 void GPUBackend::Sync(bool allow_sleep)
 {
+  // The previous sync already waited for everything to be drawn.
+  if (!m_commands_since_sync)
+    return;
+
+  m_commands_since_sync = false;
+
   if (!m_use_gpu_thread)
+  {
+    FlushRender();
     return;
+  }
 
   GPUBackendSyncCommand* cmd =
     static_cast<GPUBackendSyncCommand*>(AllocateCommand(GPUBackendCommandType::Sync, sizeof(GPUBackendSyncCommand)));
   cmd->allow_sleep = allow_sleep;
   PushCommand(cmd);
+  m_commands_since_sync = false;
   WakeGPUThread();
 
   m_sync_semaphore.Wait();
@@ -251,6 +267,7 @@ void GPUBackend::RunGPULoop()
         case GPUBackendCommandType::Sync:
         {
           DebugAssert(read_ptr == write_ptr);
+          FlushRender();
           m_sync_semaphore.Post();
           allow_sleep = static_cast<const GPUBackendSyncCommand*>(cmd)->allow_sleep;
         }
@@ -70,6 +70,7 @@ protected:
   std::atomic_bool m_gpu_loop_done{false};
   Threading::Thread m_gpu_thread;
   bool m_use_gpu_thread = false;
+  bool m_commands_since_sync = false;
 
   std::mutex m_sync_mutex;
   std::condition_variable m_sync_cpu_thread_cv;
@@ -350,6 +350,7 @@ bool GPU::HandleRenderPolygonCommand()
 
   m_stats.num_vertices += num_vertices;
   m_stats.num_polygons++;
+  m_vram_modified_since_vblank = true;
   m_render_command.bits = rc.bits;
   m_fifo.RemoveOne();
 
@@ -382,6 +383,7 @@ bool GPU::HandleRenderRectangleCommand()
 
   m_stats.num_vertices++;
   m_stats.num_polygons++;
+  m_vram_modified_since_vblank = true;
   m_render_command.bits = rc.bits;
   m_fifo.RemoveOne();
 
@@ -404,6 +406,7 @@ bool GPU::HandleRenderLineCommand()
 
   m_stats.num_vertices += 2;
   m_stats.num_polygons++;
+  m_vram_modified_since_vblank = true;
   m_render_command.bits = rc.bits;
   m_fifo.RemoveOne();
 
@@ -465,6 +468,7 @@ bool GPU::HandleFillRectangleCommand()
     FillVRAM(dst_x, dst_y, width, height, color);
 
   m_stats.num_vram_fills++;
+  m_vram_modified_since_vblank = true;
   AddCommandTicks(46 + ((width / 8) + 9) * height);
   EndCommand();
   return true;
@@ -502,8 +506,6 @@ void GPU::FinishVRAMWrite()
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
 
-  FlushRender();
-
   if (m_blit_remaining_words == 0)
   {
     if (g_settings.debugging.dump_cpu_to_vram_copies)
@@ -519,11 +521,13 @@ void GPU::FinishVRAMWrite()
                                            reinterpret_cast<const u16*>(m_blit_buffer.data()));
     }
 
-    UpdateVRAM(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height,
-               m_blit_buffer.data(), m_GPUSTAT.set_mask_while_drawing, m_GPUSTAT.check_mask_before_draw);
+    QueueVRAMWrite(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height,
+                   m_blit_buffer.data(), m_GPUSTAT.set_mask_while_drawing, m_GPUSTAT.check_mask_before_draw);
   }
   else
   {
+    FlushRender();
+
     const u32 num_pixels = ZeroExtend32(m_vram_transfer.width) * ZeroExtend32(m_vram_transfer.height);
     const u32 num_words = (num_pixels + 1) / 2;
     const u32 transferred_words = num_words - m_blit_remaining_words;
@@ -553,6 +557,7 @@ void GPU::FinishVRAMWrite()
   m_vram_transfer = {};
   m_blitter_state = BlitterState::Idle;
   m_stats.num_vram_writes++;
+  m_vram_modified_since_vblank = true;
 }
 
 bool GPU::HandleCopyRectangleVRAMToCPUCommand()
@@ -569,6 +574,8 @@ bool GPU::HandleCopyRectangleVRAMToCPUCommand()
                   m_vram_transfer.width, m_vram_transfer.height);
   DebugAssert(m_vram_transfer.col == 0 && m_vram_transfer.row == 0);
 
+  TrackVRAMRead(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height);
+
   // all rendering should be done first...
   FlushRender();
 
@@ -609,11 +616,13 @@ bool GPU::HandleCopyRectangleVRAMToVRAMCommand()
     width == 0 || height == 0 || (src_x == dst_x && src_y == dst_y && !m_GPUSTAT.set_mask_while_drawing);
   if (!skip_copy)
   {
+    TrackVRAMRead(src_x, src_y, width, height);
     FlushRender();
     CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
   }
 
   m_stats.num_vram_copies++;
+  m_vram_modified_since_vblank = true;
   AddCommandTicks(width * height * 2);
   EndCommand();
   return true;
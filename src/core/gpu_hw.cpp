@@ -1,7 +1,10 @@
 #include "gpu_hw.h"
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/log.h"
+#include "common/thread_pool.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "gpu_sw_backend.h"
 #include "host.h"
@@ -10,6 +13,7 @@
 #include "settings.h"
 #include "system.h"
 #include "util/state_wrapper.h"
+#include <atomic>
 #include <cmath>
 #include <sstream>
 #include <tuple>
@@ -35,10 +39,7 @@ ALWAYS_INLINE static bool ShouldDisableColorPerspective()
   return g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_texture_correction && !g_settings.gpu_pgxp_color_correction;
 }
 
-GPU_HW::GPU_HW() : GPU()
-{
-  m_vram_ptr = m_vram_shadow.data();
-}
+GPU_HW::GPU_HW() : GPU() {}
 
 GPU_HW::~GPU_HW()
 {
@@ -70,6 +71,9 @@ bool GPU_HW::Initialize()
   m_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
   m_downsample_mode = GetDownsampleMode(m_resolution_scale);
   m_disable_color_perspective = m_supports_disable_color_perspective && ShouldDisableColorPerspective();
+  m_decoded_texture_cache = m_supports_decoded_texture_cache && g_settings.gpu_decoded_texture_cache;
+  m_texture_mode_batching = m_supports_texture_mode_batching && g_settings.gpu_texture_mode_batching;
+  InvalidateAllDecodedTexturePages();
 
   if (m_multisamples != g_settings.gpu_multisamples)
   {
@@ -81,7 +85,8 @@ bool GPU_HW::Initialize()
   {
     Host::AddOSDMessage(Host::TranslateStdString("OSDMessage", "SSAA is not supported, using MSAA instead."), 20.0f);
   }
-  if (!m_supports_dual_source_blend && TextureFilterRequiresDualSourceBlend(m_texture_filtering))
+  if (!m_supports_dual_source_blend && !m_supports_framebuffer_fetch &&
+      TextureFilterRequiresDualSourceBlend(m_texture_filtering))
   {
     Host::AddFormattedOSDMessage(
       20.0f, Host::TranslateString("OSDMessage", "Texture filter '%s' is not supported with the current renderer."),
@@ -116,6 +121,9 @@ void GPU_HW::Reset(bool clear_vram)
   m_vram_shadow.fill(0);
   if (m_sw_renderer)
     m_sw_renderer->Reset(clear_vram);
+  m_sw_readback_pages.fill(0);
+  UpdateSoftwareRendererDrawReplay();
+  m_vram_read_pages.fill(0);
 
   m_batch = {};
   m_batch_ubo_data = {};
@@ -123,10 +131,20 @@ void GPU_HW::Reset(bool clear_vram)
   m_current_depth = 1;
 
   SetFullVRAMDirtyRectangle();
+  InvalidateAllDecodedTexturePages();
+}
+
+void GPU_HW::ResetGraphicsAPIState()
+{
+  // Queued writes are uploaded with the backend's state, so they can't outlive it.
+  FlushPendingVRAMWrites();
+  GPU::ResetGraphicsAPIState();
 }
 
 bool GPU_HW::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display)
 {
+  FlushPendingVRAMWrites();
+
   if (!GPU::DoState(sw, host_texture, update_display))
     return false;
 
@@ -141,7 +159,7 @@ bool GPU_HW::DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_di
   return true;
 }
 
-void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
+u8 GPU_HW::UpdateHWSettings()
 {
   const u32 resolution_scale = CalculateResolutionScale();
   const u32 multisamples = std::min(m_max_multisamples, g_settings.gpu_multisamples);
@@ -149,16 +167,30 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   const GPUDownsampleMode downsample_mode = GetDownsampleMode(resolution_scale);
   const bool use_uv_limits = ShouldUseUVLimits();
   const bool disable_color_perspective = m_supports_disable_color_perspective && ShouldDisableColorPerspective();
-
-  *framebuffer_changed =
-    (m_resolution_scale != resolution_scale || m_multisamples != multisamples || m_downsample_mode != downsample_mode);
-  *shaders_changed =
-    (m_resolution_scale != resolution_scale || m_multisamples != multisamples ||
-     m_true_color != g_settings.gpu_true_color || m_per_sample_shading != per_sample_shading ||
-     m_scaled_dithering != g_settings.gpu_scaled_dithering || m_texture_filtering != g_settings.gpu_texture_filter ||
-     m_using_uv_limits != use_uv_limits || m_chroma_smoothing != g_settings.gpu_24bit_chroma_smoothing ||
-     m_downsample_mode != downsample_mode || m_pgxp_depth_buffer != g_settings.UsingPGXPDepthBuffer() ||
-     m_disable_color_perspective != disable_color_perspective);
+  const bool decoded_texture_cache = m_supports_decoded_texture_cache && g_settings.gpu_decoded_texture_cache;
+  const bool texture_mode_batching = m_supports_texture_mode_batching && g_settings.gpu_texture_mode_batching;
+
+  // The scale, sample count and depth buffer are baked into every shader, the rest only into the ones using them.
+  u8 changes = HW_SETTINGS_CHANGE_NONE;
+  if (m_resolution_scale != resolution_scale || m_multisamples != multisamples ||
+      m_per_sample_shading != per_sample_shading || m_pgxp_depth_buffer != g_settings.UsingPGXPDepthBuffer() ||
+      m_decoded_texture_cache != decoded_texture_cache)
+  {
+    changes |= HW_SETTINGS_CHANGE_PIPELINES;
+  }
+  if (m_true_color != g_settings.gpu_true_color || m_scaled_dithering != g_settings.gpu_scaled_dithering ||
+      m_texture_filtering != g_settings.gpu_texture_filter || m_using_uv_limits != use_uv_limits ||
+      m_disable_color_perspective != disable_color_perspective || m_texture_mode_batching != texture_mode_batching)
+  {
+    changes |= HW_SETTINGS_CHANGE_BATCH_PIPELINES;
+  }
+  if (m_chroma_smoothing != g_settings.gpu_24bit_chroma_smoothing || m_downsample_mode != downsample_mode)
+    changes |= HW_SETTINGS_CHANGE_UTILITY_PIPELINES;
+  if (m_resolution_scale != resolution_scale || m_multisamples != multisamples ||
+      m_downsample_mode != downsample_mode || m_decoded_texture_cache != decoded_texture_cache)
+  {
+    changes |= HW_SETTINGS_CHANGE_FRAMEBUFFER;
+  }
 
   if (m_resolution_scale != resolution_scale)
   {
@@ -195,14 +227,18 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   m_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
   m_downsample_mode = downsample_mode;
   m_disable_color_perspective = disable_color_perspective;
+  m_decoded_texture_cache = decoded_texture_cache;
+  m_texture_mode_batching = texture_mode_batching;
 
-  if (!m_supports_dual_source_blend && TextureFilterRequiresDualSourceBlend(m_texture_filtering))
+  if (!m_supports_dual_source_blend && !m_supports_framebuffer_fetch &&
+      TextureFilterRequiresDualSourceBlend(m_texture_filtering))
     m_texture_filtering = GPUTextureFilter::Nearest;
 
   if (m_pgxp_depth_buffer != g_settings.UsingPGXPDepthBuffer())
   {
     m_pgxp_depth_buffer = g_settings.UsingPGXPDepthBuffer();
     m_batch.use_depth_buffer = false;
+    m_vram_depth_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
     if (m_pgxp_depth_buffer)
       ClearDepthBuffer();
   }
@@ -210,9 +246,10 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   UpdateSoftwareRenderer(true);
 
   PrintSettingsToLog();
+  return changes;
 }
 
-u32 GPU_HW::CalculateResolutionScale() const
+u32 GPU_HW::GetConfiguredResolutionScale() const
 {
   u32 scale;
   if (g_settings.gpu_resolution_scale != 0)
@@ -234,13 +271,24 @@ u32 GPU_HW::CalculateResolutionScale() const
     scale = static_cast<u32>(std::clamp<s32>(preferred_scale, 1, m_max_resolution_scale));
   }
 
+  return scale;
+}
+
+u32 GPU_HW::CalculateResolutionScale() const
+{
+  u32 scale = GetConfiguredResolutionScale();
+
+  // The configured scale is the upper bound for dynamic resolution.
+  if (g_settings.gpu_dynamic_resolution && m_dynamic_resolution_scale != 0)
+    scale = std::clamp(m_dynamic_resolution_scale, std::min(g_settings.gpu_dynamic_resolution_min_scale, scale), scale);
+
   if (g_settings.gpu_downsample_mode == GPUDownsampleMode::Adaptive && m_supports_adaptive_downsampling && scale > 1 &&
       !Common::IsPow2(scale))
   {
     const u32 new_scale = Common::PreviousPow2(scale);
     Log_InfoPrintf("Resolution scale %ux not supported for adaptive smoothing, using %ux", scale, new_scale);
 
-    if (g_settings.gpu_resolution_scale != 0)
+    if (g_settings.gpu_resolution_scale != 0 && !g_settings.gpu_dynamic_resolution)
     {
       Host::AddFormattedOSDMessage(
         10.0f,
@@ -262,6 +310,72 @@ void GPU_HW::UpdateResolutionScale()
     UpdateSettings();
 }
 
+void GPU_HW::UpdateDynamicResolution(float gpu_time, float frame_time_budget)
+{
+  // Frame time must exceed this fraction of the budget to step down, and is predicted to stay below the other after
+  // stepping up. The gap, and needing several readings in a row, stop it from flipping back and forth.
+  static constexpr float LOWER_THRESHOLD = 0.9f;
+  static constexpr float RAISE_THRESHOLD = 0.75f;
+  static constexpr u32 LOWER_READINGS = 2;
+  static constexpr u32 RAISE_READINGS = 5;
+
+  if (!g_settings.gpu_dynamic_resolution || gpu_time <= 0.0f || frame_time_budget <= 0.0f)
+    return;
+
+  // The first reading after a change includes recreating the framebuffer, so it's not representative.
+  if (m_dynamic_resolution_settling)
+  {
+    m_dynamic_resolution_settling = false;
+    return;
+  }
+
+  // Adaptive downsampling only works with power-of-two scales.
+  const bool pow2_only =
+    (g_settings.gpu_downsample_mode == GPUDownsampleMode::Adaptive && m_supports_adaptive_downsampling);
+  const u32 max_scale =
+    pow2_only ? Common::PreviousPow2(GetConfiguredResolutionScale()) : GetConfiguredResolutionScale();
+  const u32 min_scale = std::min(g_settings.gpu_dynamic_resolution_min_scale, max_scale);
+  const float load = gpu_time / frame_time_budget;
+
+  u32 new_scale = m_resolution_scale;
+  if (load > LOWER_THRESHOLD)
+  {
+    m_dynamic_resolution_raise_count = 0;
+    if (m_resolution_scale > min_scale && ++m_dynamic_resolution_lower_count >= LOWER_READINGS)
+      new_scale = std::max(pow2_only ? (m_resolution_scale / 2) : (m_resolution_scale - 1), min_scale);
+  }
+  else
+  {
+    m_dynamic_resolution_lower_count = 0;
+
+    // GPU time grows with the number of pixels, so scale the current load by the change in area.
+    const u32 next_scale = std::min(pow2_only ? (m_resolution_scale * 2) : (m_resolution_scale + 1), max_scale);
+    const float area_ratio = static_cast<float>(next_scale * next_scale) /
+                             static_cast<float>(m_resolution_scale * m_resolution_scale);
+    if (next_scale > m_resolution_scale && (load * area_ratio) < RAISE_THRESHOLD)
+    {
+      if (++m_dynamic_resolution_raise_count >= RAISE_READINGS)
+        new_scale = next_scale;
+    }
+    else
+    {
+      m_dynamic_resolution_raise_count = 0;
+    }
+  }
+
+  if (new_scale == m_resolution_scale)
+    return;
+
+  Log_InfoPrintf("Dynamic resolution: GPU time %.2fms of %.2fms budget, changing scale from %ux to %ux", gpu_time,
+                 frame_time_budget, m_resolution_scale, new_scale);
+
+  m_dynamic_resolution_scale = new_scale;
+  m_dynamic_resolution_lower_count = 0;
+  m_dynamic_resolution_raise_count = 0;
+  m_dynamic_resolution_settling = true;
+  UpdateResolutionScale();
+}
+
 GPUDownsampleMode GPU_HW::GetDownsampleMode(u32 resolution_scale) const
 {
   if (resolution_scale == 1)
@@ -294,18 +408,109 @@ void GPU_HW::PrintSettingsToLog()
                  (!m_true_color && m_scaled_dithering) ? " (Scaled)" : "");
   Log_InfoPrintf("Texture Filtering: %s", Settings::GetTextureFilterDisplayName(m_texture_filtering));
   Log_InfoPrintf("Dual-source blending: %s", m_supports_dual_source_blend ? "Supported" : "Not supported");
+  Log_InfoPrintf("Framebuffer fetch: %s", m_supports_framebuffer_fetch ? "Supported" : "Not supported");
   Log_InfoPrintf("Using UV limits: %s", m_using_uv_limits ? "YES" : "NO");
   Log_InfoPrintf("Depth buffer: %s", m_pgxp_depth_buffer ? "YES" : "NO");
   Log_InfoPrintf("Downsampling: %s", Settings::GetDownsampleModeDisplayName(m_downsample_mode));
+  Log_InfoPrintf("Decoded texture cache: %s", m_decoded_texture_cache ? "YES" : "NO");
+  Log_InfoPrintf("Texture mode batching: %s", m_texture_mode_batching ? "YES" : "NO");
   Log_InfoPrintf("Using software renderer for readbacks: %s", m_sw_renderer ? "YES" : "NO");
+  Log_InfoPrintf("Software readback region tracking: %s", m_sw_readback_region_tracking ? "YES" : "NO");
 }
 
 void GPU_HW::UpdateVRAMReadTexture()
 {
   m_renderer_stats.num_vram_read_texture_updates++;
+  if (m_decoded_texture_cache)
+    InvalidateDecodedTexturePages(m_vram_dirty_pages);
   ClearVRAMDirtyRectangle();
 }
 
+void GPU_HW::DecodeTexturePage(u32 slot, GPUTextureMode mode, u32 page_x, u32 page_y, u32 palette_x, u32 palette_y)
+{
+  Panic("Decoded texture cache is not supported by this backend");
+}
+
+u32 GPU_HW::GetDecodedTexturePageBits()
+{
+  const u32 key = ZeroExtend32(m_draw_mode.mode_reg.bits & (GPUDrawModeReg::TEXTURE_PAGE_MASK | (3u << 7))) |
+                  (ZeroExtend32(m_draw_mode.palette_reg) << 16);
+  DecodedTexturePage* page = &m_decoded_texture_pages[m_current_decoded_texture_page];
+  if (page->key != key)
+  {
+    // Reuse a slot with the same page and palette, otherwise evict the least recently used.
+    u32 slot = 0;
+    for (u32 i = 0; i < DECODED_TEXTURE_PAGE_SLOTS; i++)
+    {
+      const DecodedTexturePage& it = m_decoded_texture_pages[i];
+      if (it.key == key)
+      {
+        slot = i;
+        break;
+      }
+      if (it.last_used < m_decoded_texture_pages[slot].last_used)
+        slot = i;
+    }
+
+    page = &m_decoded_texture_pages[slot];
+    m_current_decoded_texture_page = slot;
+    if (page->key != key)
+    {
+      // Vertices already in the batch may be referencing the slot we're replacing.
+      if (!IsFlushed())
+        FlushRender();
+
+      const Common::Rectangle<u32> page_rect = m_draw_mode.mode_reg.GetTexturePageRectangle();
+      const Common::Rectangle<u32> palette_rect = m_draw_mode.GetTexturePaletteRectangle();
+      DecodeTexturePage(slot, m_draw_mode.mode_reg.texture_mode, page_rect.left, page_rect.top, palette_rect.left,
+                        palette_rect.top);
+      m_renderer_stats.num_decoded_texture_pages++;
+
+      // Texture pages and palettes can run off the right edge of VRAM, so include the wrapped part too.
+      page->key = key;
+      page->vram_pages.fill(0);
+      SetVRAMPages(page->vram_pages, page_rect.left, page_rect.right, page_rect.top, page_rect.bottom);
+      SetVRAMPages(page->vram_pages, palette_rect.left, palette_rect.right, palette_rect.top, palette_rect.bottom);
+      if (page_rect.right > VRAM_WIDTH)
+        SetVRAMPages(page->vram_pages, 0, page_rect.right - VRAM_WIDTH, page_rect.top, page_rect.bottom);
+      if (palette_rect.right > VRAM_WIDTH)
+        SetVRAMPages(page->vram_pages, 0, palette_rect.right - VRAM_WIDTH, palette_rect.top, palette_rect.bottom);
+    }
+  }
+
+  page->last_used = ++m_decoded_texture_page_counter;
+  return DECODED_TEXTURE_PAGE_VERTEX_BIT | (m_current_decoded_texture_page << 16);
+}
+
+void GPU_HW::InvalidateDecodedTexturePages(const std::array<u16, VRAM_DIRTY_PAGES_Y>& vram_pages)
+{
+  for (DecodedTexturePage& page : m_decoded_texture_pages)
+  {
+    if (page.key == INVALID_DECODED_TEXTURE_PAGE_KEY)
+      continue;
+
+    for (u32 i = 0; i < VRAM_DIRTY_PAGES_Y; i++)
+    {
+      if (page.vram_pages[i] & vram_pages[i])
+      {
+        page.key = INVALID_DECODED_TEXTURE_PAGE_KEY;
+        page.last_used = 0;
+        break;
+      }
+    }
+  }
+}
+
+void GPU_HW::InvalidateAllDecodedTexturePages()
+{
+  for (DecodedTexturePage& page : m_decoded_texture_pages)
+  {
+    page.key = INVALID_DECODED_TEXTURE_PAGE_KEY;
+    page.last_used = 0;
+  }
+  m_decoded_texture_page_counter = 0;
+}
+
 void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
 {
   // Taken from beetle-psx gpu_polygon.cpp
@@ -483,6 +688,26 @@ GPU_HW::SmoothingUBOData GPU_HW::GetSmoothingUBO(u32 level, u32 left, u32 top, u
   return data;
 }
 
+GPU_HW::SmoothingComputeUBOData GPU_HW::GetSmoothingComputeUBO(u32 left, u32 top, u32 width, u32 height, u32* groups_x,
+                                                               u32* groups_y) const
+{
+  // Workgroups are aligned to the tile size in the first mip, so every texel in the lower mips is produced by a
+  // single workgroup.
+  SmoothingComputeUBOData data;
+  data.rect[0] = left;
+  data.rect[1] = top;
+  data.rect[2] = width;
+  data.rect[3] = height;
+  data.base[0] = Common::AlignDownPow2(left >> 1, SMOOTHING_COMPUTE_TILE_SIZE);
+  data.base[1] = Common::AlignDownPow2(top >> 1, SMOOTHING_COMPUTE_TILE_SIZE);
+
+  *groups_x = (((left >> 1) + (width >> 1)) - data.base[0] + (SMOOTHING_COMPUTE_TILE_SIZE - 1)) /
+              SMOOTHING_COMPUTE_TILE_SIZE;
+  *groups_y = (((top >> 1) + (height >> 1)) - data.base[1] + (SMOOTHING_COMPUTE_TILE_SIZE - 1)) /
+              SMOOTHING_COMPUTE_TILE_SIZE;
+  return data;
+}
+
 void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1, float depth)
 {
   const float dx = x1 - x0;
@@ -578,7 +803,10 @@ void GPU_HW::LoadVertices()
     m_current_depth++;
 
   const GPURenderCommand rc{m_render_command.bits};
-  const u32 texpage = ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg) << 16);
+  const u32 texpage = (m_decoded_texpage_bits ?
+                         m_decoded_texpage_bits :
+                         (ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg) << 16))) |
+                      (rc.raw_texture_enable ? BatchVertex::TEXPAGE_RAW_TEXTURE_BIT : 0u);
   const float depth = GetCurrentNormalizedVertexDepth();
 
   switch (rc.primitive)
@@ -596,7 +824,8 @@ void GPU_HW::LoadVertices()
       std::array<BatchVertex, 4> vertices;
       std::array<std::array<s32, 2>, 4> native_vertex_positions;
       std::array<u16, 4> native_texcoords;
-      bool valid_w = g_settings.gpu_pgxp_texture_correction;
+      std::array<u32, 4> pgxp_addrs;
+      std::array<u32, 4> pgxp_values;
       for (u32 i = 0; i < num_vertices; i++)
       {
         const u32 color = (shaded && i > 0) ? (FifoPop() & UINT32_C(0x00FFFFFF)) : first_color;
@@ -610,16 +839,31 @@ void GPU_HW::LoadVertices()
         native_texcoords[i] = texcoord;
         vertices[i].Set(static_cast<float>(native_x), static_cast<float>(native_y), depth, 1.0f, color, texpage,
                         texcoord, 0xFFFF0000u);
-
-        if (pgxp)
-        {
-          valid_w &=
-            PGXP::GetPreciseVertex(Truncate32(maddr_and_pos >> 32), vp.bits, native_x, native_y, m_drawing_offset.x,
-                                   m_drawing_offset.y, &vertices[i].x, &vertices[i].y, &vertices[i].w);
-        }
+        pgxp_addrs[i] = Truncate32(maddr_and_pos >> 32);
+        pgxp_values[i] = vp.bits;
       }
       if (pgxp)
       {
+        std::array<s32, 4> native_xs, native_ys;
+        std::array<float, 4> precise_xs, precise_ys, precise_ws;
+        for (u32 i = 0; i < num_vertices; i++)
+        {
+          native_xs[i] = native_vertex_positions[i][0];
+          native_ys[i] = native_vertex_positions[i][1];
+        }
+
+        const bool valid_w =
+          PGXP::GetPreciseVertices(num_vertices, pgxp_addrs.data(), pgxp_values.data(), native_xs.data(),
+                                   native_ys.data(), m_drawing_offset.x, m_drawing_offset.y, precise_xs.data(),
+                                   precise_ys.data(), precise_ws.data()) &&
+          g_settings.gpu_pgxp_texture_correction;
+        for (u32 i = 0; i < num_vertices; i++)
+        {
+          vertices[i].x = precise_xs[i];
+          vertices[i].y = precise_ys[i];
+          vertices[i].w = precise_ws[i];
+        }
+
         if (!valid_w)
         {
           SetBatchDepthBuffer(false);
@@ -666,7 +910,7 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
         AddDrawTriangleTicks(native_vertex_positions[0][0], native_vertex_positions[0][1],
                              native_vertex_positions[1][0], native_vertex_positions[1][1],
                              native_vertex_positions[2][0], native_vertex_positions[2][1], rc.shading_enable,
@@ -700,7 +944,7 @@ void GPU_HW::LoadVertices()
           const u32 clip_bottom =
             static_cast<u32>(std::clamp<s32>(max_y_123, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-          m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+          IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
           AddDrawTriangleTicks(native_vertex_positions[2][0], native_vertex_positions[2][1],
                                native_vertex_positions[1][0], native_vertex_positions[1][1],
                                native_vertex_positions[3][0], native_vertex_positions[3][1], rc.shading_enable,
@@ -712,7 +956,7 @@ void GPU_HW::LoadVertices()
         }
       }
 
-      if (m_sw_renderer)
+      if (m_sw_renderer && m_sw_replay_draws)
       {
         GPUBackendDrawPolygonCommand* cmd = m_sw_renderer->NewDrawPolygonCommand(num_vertices);
         FillDrawCommand(cmd, rc);
@@ -821,10 +1065,10 @@ void GPU_HW::LoadVertices()
       const u32 clip_bottom =
         static_cast<u32>(std::clamp<s32>(pos_y + rectangle_height, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-      m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+      IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
       AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.texture_enable, rc.transparency_enable);
 
-      if (m_sw_renderer)
+      if (m_sw_renderer && m_sw_replay_draws)
       {
         GPUBackendDrawRectangleCommand* cmd = m_sw_renderer->NewDrawRectangleCommand();
         FillDrawCommand(cmd, rc);
@@ -884,14 +1128,14 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
         AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
         // TODO: Should we do a PGXP lookup here? Most lines are 2D.
         DrawLine(static_cast<float>(start_x), static_cast<float>(start_y), start_color, static_cast<float>(end_x),
                  static_cast<float>(end_y), end_color, depth);
 
-        if (m_sw_renderer)
+        if (m_sw_renderer && m_sw_replay_draws)
         {
           GPUBackendDrawLineCommand* cmd = m_sw_renderer->NewDrawLineCommand(2);
           FillDrawCommand(cmd, rc);
@@ -918,7 +1162,7 @@ void GPU_HW::LoadVertices()
         u32 start_color = rc.color_for_first_vertex;
 
         GPUBackendDrawLineCommand* cmd;
-        if (m_sw_renderer)
+        if (m_sw_renderer && m_sw_replay_draws)
         {
           cmd = m_sw_renderer->NewDrawLineCommand(num_vertices);
           FillDrawCommand(cmd, rc);
@@ -951,7 +1195,7 @@ void GPU_HW::LoadVertices()
             const u32 clip_bottom =
               static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-            m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+            IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
             AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
             // TODO: Should we do a PGXP lookup here? Most lines are 2D.
@@ -1030,14 +1274,10 @@ GPU_HW::VRAMWriteUBOData GPU_HW::GetVRAMWriteUBOData(u32 x, u32 y, u32 width, u3
   return uniforms;
 }
 
-bool GPU_HW::UseVRAMCopyShader(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) const
+bool GPU_HW::UseVRAMCopyShader() const
 {
-  // masking enabled, oversized, or overlapping
-  return (m_GPUSTAT.IsMaskingEnabled() || ((src_x % VRAM_WIDTH) + width) > VRAM_WIDTH ||
-          ((src_y % VRAM_HEIGHT) + height) > VRAM_HEIGHT || ((dst_x % VRAM_WIDTH) + width) > VRAM_WIDTH ||
-          ((dst_y % VRAM_HEIGHT) + height) > VRAM_HEIGHT ||
-          Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)
-            .Intersects(Common::Rectangle<u32>::FromExtents(dst_x, dst_y, width, height)));
+  // API copies can't check or set the mask bit, everything else is copied natively.
+  return m_GPUSTAT.IsMaskingEnabled();
 }
 
 GPU_HW::VRAMCopyUBOData GPU_HW::GetVRAMCopyUBOData(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width,
@@ -1060,6 +1300,9 @@ GPU_HW::VRAMCopyUBOData GPU_HW::GetVRAMCopyUBOData(u32 src_x, u32 src_y, u32 dst
 void GPU_HW::IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect)
 {
   m_vram_dirty_rect.Include(rect);
+  m_vram_readback_dirty_rect.Include(rect);
+  m_vram_depth_dirty_rect.Include(rect);
+  SetVRAMDirtyPages(rect.left, rect.right, rect.top, rect.bottom);
 
   // the vram area can include the texture page, but the game can leave it as-is. in this case, set it as dirty so the
   // shadow texture is updated
@@ -1071,6 +1314,115 @@ void GPU_HW::IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect)
   }
 }
 
+void GPU_HW::SetVRAMPages(std::array<u16, VRAM_DIRTY_PAGES_Y>& pages, u32 left, u32 right, u32 top, u32 bottom)
+{
+  left = std::min<u32>(left, VRAM_WIDTH);
+  right = std::min<u32>(right, VRAM_WIDTH);
+  top = std::min<u32>(top, VRAM_HEIGHT);
+  bottom = std::min<u32>(bottom, VRAM_HEIGHT);
+  if (left >= right || top >= bottom)
+    return;
+
+  const u32 start_page_x = left / VRAM_DIRTY_PAGE_WIDTH;
+  const u32 end_page_x = (right - 1) / VRAM_DIRTY_PAGE_WIDTH;
+  const u16 row_mask = static_cast<u16>(((2u << end_page_x) - 1u) & ~((1u << start_page_x) - 1u));
+  const u32 end_page_y = (bottom - 1) / VRAM_DIRTY_PAGE_HEIGHT;
+  for (u32 page_y = top / VRAM_DIRTY_PAGE_HEIGHT; page_y <= end_page_y; page_y++)
+    pages[page_y] |= row_mask;
+}
+
+bool GPU_HW::AnyVRAMPagesSet(const std::array<u16, VRAM_DIRTY_PAGES_Y>& pages, u32 left, u32 right, u32 top,
+                             u32 bottom)
+{
+  left = std::min<u32>(left, VRAM_WIDTH - 1);
+  right = std::min<u32>(std::max<u32>(right, left + 1), VRAM_WIDTH);
+  top = std::min<u32>(top, VRAM_HEIGHT - 1);
+  bottom = std::min<u32>(std::max<u32>(bottom, top + 1), VRAM_HEIGHT);
+  const u32 start_page_x = left / VRAM_DIRTY_PAGE_WIDTH;
+  const u32 end_page_x = (right - 1) / VRAM_DIRTY_PAGE_WIDTH;
+  const u16 row_mask = static_cast<u16>(((2u << end_page_x) - 1u) & ~((1u << start_page_x) - 1u));
+  const u32 end_page_y = (bottom - 1) / VRAM_DIRTY_PAGE_HEIGHT;
+  for (u32 page_y = top / VRAM_DIRTY_PAGE_HEIGHT; page_y <= end_page_y; page_y++)
+  {
+    if (pages[page_y] & row_mask)
+      return true;
+  }
+
+  return false;
+}
+
+bool GPU_HW::AllVRAMPagesSet(const std::array<u16, VRAM_DIRTY_PAGES_Y>& pages, u32 left, u32 right, u32 top,
+                             u32 bottom)
+{
+  left = std::min<u32>(left, VRAM_WIDTH - 1);
+  right = std::min<u32>(std::max<u32>(right, left + 1), VRAM_WIDTH);
+  top = std::min<u32>(top, VRAM_HEIGHT - 1);
+  bottom = std::min<u32>(std::max<u32>(bottom, top + 1), VRAM_HEIGHT);
+  const u32 start_page_x = left / VRAM_DIRTY_PAGE_WIDTH;
+  const u32 end_page_x = (right - 1) / VRAM_DIRTY_PAGE_WIDTH;
+  const u16 row_mask = static_cast<u16>(((2u << end_page_x) - 1u) & ~((1u << start_page_x) - 1u));
+  const u32 end_page_y = (bottom - 1) / VRAM_DIRTY_PAGE_HEIGHT;
+  for (u32 page_y = top / VRAM_DIRTY_PAGE_HEIGHT; page_y <= end_page_y; page_y++)
+  {
+    if ((pages[page_y] & row_mask) != row_mask)
+      return false;
+  }
+
+  return true;
+}
+
+bool GPU_HW::IsVRAMAreaDirty(const Common::Rectangle<u32>& rect) const
+{
+  return (m_vram_dirty_rect.Intersects(rect) &&
+          AnyVRAMPagesSet(m_vram_dirty_pages, rect.left, rect.right, rect.top, rect.bottom));
+}
+
+const std::vector<Common::Rectangle<u32>>& GPU_HW::GetVRAMDirtyAreas()
+{
+  // Runs of pages in each row become a rectangle, which grows downwards while the rows below have the same run.
+  m_vram_dirty_areas.clear();
+  for (u32 page_y = 0; page_y < VRAM_DIRTY_PAGES_Y; page_y++)
+  {
+    u32 bits = m_vram_dirty_pages[page_y];
+    u32 page_x = 0;
+    while (bits != 0)
+    {
+      const u32 skip = CountTrailingZeros(bits);
+      bits >>= skip;
+      page_x += skip;
+
+      const u32 run = CountTrailingZeros(~bits);
+      bits >>= run;
+
+      const u32 left = page_x * VRAM_DIRTY_PAGE_WIDTH;
+      const u32 right = (page_x + run) * VRAM_DIRTY_PAGE_WIDTH;
+      const u32 top = page_y * VRAM_DIRTY_PAGE_HEIGHT;
+      page_x += run;
+
+      auto iter = std::find_if(m_vram_dirty_areas.begin(), m_vram_dirty_areas.end(),
+                               [left, right, top](const Common::Rectangle<u32>& rc) {
+                                 return (rc.left == left && rc.right == right && rc.bottom == top);
+                               });
+      if (iter != m_vram_dirty_areas.end())
+        iter->bottom += VRAM_DIRTY_PAGE_HEIGHT;
+      else
+        m_vram_dirty_areas.emplace_back(left, top, right, top + VRAM_DIRTY_PAGE_HEIGHT);
+    }
+  }
+
+  return m_vram_dirty_areas;
+}
+
+void GPU_HW::VRAMReadbackCompleted(const Common::Rectangle<u32>& rect)
+{
+  // Partial readbacks leave the rest of the dirty area stale, so only clear it when it's entirely covered.
+  if (rect.left <= m_vram_readback_dirty_rect.left && rect.right >= m_vram_readback_dirty_rect.right &&
+      rect.top <= m_vram_readback_dirty_rect.top && rect.bottom >= m_vram_readback_dirty_rect.bottom)
+  {
+    m_vram_readback_dirty_rect.SetInvalid();
+  }
+}
+
 void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices)
 {
   if (m_batch_current_vertex_ptr)
@@ -1134,11 +1486,25 @@ void GPU_HW::UpdateSoftwareRenderer(bool copy_vram_from_hw)
 {
   const bool current_enabled = (m_sw_renderer != nullptr);
   const bool new_enabled = g_settings.gpu_use_software_renderer_for_readbacks;
+  const bool new_region_tracking = new_enabled && g_settings.gpu_sw_readback_region_tracking;
+  if (m_sw_readback_region_tracking != new_region_tracking)
+  {
+    // Draws outside the tracked pages weren't replayed, so when tracking stops they have to be read back once.
+    if (current_enabled && new_enabled && copy_vram_from_hw && m_sw_readback_region_tracking)
+    {
+      m_sw_readback_pages.fill(0);
+      FlushRender();
+      ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    }
+
+    m_sw_readback_region_tracking = new_region_tracking;
+    m_sw_readback_pages.fill(0);
+    UpdateSoftwareRendererDrawReplay();
+  }
+
   if (current_enabled == new_enabled)
     return;
 
-  m_vram_ptr = m_vram_shadow.data();
-
   if (!new_enabled)
   {
     if (m_sw_renderer)
@@ -1147,17 +1513,19 @@ void GPU_HW::UpdateSoftwareRenderer(bool copy_vram_from_hw)
     return;
   }
 
-  std::unique_ptr<GPU_SW_Backend> sw_renderer = std::make_unique<GPU_SW_Backend>();
-  if (!sw_renderer->Initialize(true))
-    return;
-
-  // We need to fill in the SW renderer's VRAM with the current state for hot toggles.
+  // The SW renderer draws into our shadow buffer, so for hot toggles it only needs to be brought up to date.
   if (copy_vram_from_hw)
   {
     FlushRender();
     ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
-    std::memcpy(sw_renderer->GetVRAM(), m_vram_ptr, sizeof(u16) * VRAM_WIDTH * VRAM_HEIGHT);
+  }
 
+  std::unique_ptr<GPU_SW_Backend> sw_renderer = std::make_unique<GPU_SW_Backend>(m_vram_shadow.data());
+  if (!sw_renderer->Initialize(true))
+    return;
+
+  if (copy_vram_from_hw)
+  {
     // Sync the drawing area.
     GPUBackendSetDrawingAreaCommand* cmd = sw_renderer->NewSetDrawingAreaCommand();
     cmd->new_area = m_drawing_area;
@@ -1165,7 +1533,6 @@ void GPU_HW::UpdateSoftwareRenderer(bool copy_vram_from_hw)
   }
 
   m_sw_renderer = std::move(sw_renderer);
-  m_vram_ptr = m_sw_renderer->GetVRAM();
 }
 
 void GPU_HW::FillBackendCommandParameters(GPUBackendCommand* cmd) const
@@ -1186,10 +1553,51 @@ void GPU_HW::FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) co
   cmd->window = m_draw_mode.texture_window;
 }
 
-void GPU_HW::ReadSoftwareRendererVRAM(u32 x, u32 y, u32 width, u32 height)
+bool GPU_HW::ReadSoftwareRendererVRAM(u32* x, u32* y, u32* width, u32* height)
 {
   DebugAssert(m_sw_renderer);
   m_sw_renderer->Sync(false);
+  if (!m_sw_readback_region_tracking)
+    return true;
+
+  const Common::Rectangle<u32> rect = GetVRAMTransferBounds(*x, *y, *width, *height);
+  if (AllVRAMPagesSet(m_sw_readback_pages, rect.left, rect.right, rect.top, rect.bottom))
+    return true;
+
+  // The SW renderer hasn't been drawing here, so this read has to come from the GPU. The readback lands in the buffer
+  // the SW renderer draws to, which brings the whole pages up to date before it starts replaying draws into them.
+  const u32 left = Common::AlignDownPow2(rect.left, VRAM_DIRTY_PAGE_WIDTH);
+  const u32 right = Common::AlignUpPow2(rect.right, VRAM_DIRTY_PAGE_WIDTH);
+  const u32 top = Common::AlignDownPow2(rect.top, VRAM_DIRTY_PAGE_HEIGHT);
+  const u32 bottom = Common::AlignUpPow2(rect.bottom, VRAM_DIRTY_PAGE_HEIGHT);
+  Log_DevPrintf("Tracking SW renderer readback area %u,%u-%u,%u", left, top, right, bottom);
+  SetVRAMPages(m_sw_readback_pages, left, right, top, bottom);
+  UpdateSoftwareRendererDrawReplay();
+
+  *x = left;
+  *y = top;
+  *width = right - left;
+  *height = bottom - top;
+  return false;
+}
+
+void GPU_HW::UpdateSoftwareRendererDrawReplay()
+{
+  m_sw_replay_draws = !m_sw_readback_region_tracking ||
+                      AnyVRAMPagesSet(m_sw_readback_pages, m_drawing_area.left, m_drawing_area.right + 1,
+                                      m_drawing_area.top, m_drawing_area.bottom + 1);
+}
+
+void GPU_HW::TrackSoftwareRendererTextureReads()
+{
+  // Replayed draws need correct textures too, so anything drawn into them from now on is replayed as well.
+  const Common::Rectangle<u32> texture_rect = m_draw_mode.mode_reg.GetTexturePageRectangle();
+  SetVRAMPages(m_sw_readback_pages, texture_rect.left, texture_rect.right, texture_rect.top, texture_rect.bottom);
+  if (m_draw_mode.mode_reg.IsUsingPalette())
+  {
+    const Common::Rectangle<u32> palette_rect = m_draw_mode.GetTexturePaletteRectangle();
+    SetVRAMPages(m_sw_readback_pages, palette_rect.left, palette_rect.right, palette_rect.top, palette_rect.bottom);
+  }
 }
 
 void GPU_HW::UpdateSoftwareRendererVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask,
@@ -1251,6 +1659,69 @@ void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, b
   }
 }
 
+void GPU_HW::QueueVRAMWrite(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
+{
+  // Draws since the last write have to happen first, which also uploads anything already queued.
+  if (!IsFlushed())
+    FlushRender();
+
+  // Masked writes depend on what's already in VRAM, and replacements are looked up by the size of each write.
+  if (check_mask || (x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT ||
+      g_settings.texture_replacements.AnyReplacementsEnabled())
+  {
+    FlushPendingVRAMWrites();
+    UpdateVRAM(x, y, width, height, data, set_mask, check_mask);
+    return;
+  }
+
+  // Only merge writes which share a whole edge, so the result is still a rectangle.
+  const Common::Rectangle<u32> rect = Common::Rectangle<u32>::FromExtents(x, y, width, height);
+  if (m_pending_vram_write_rect.Valid())
+  {
+    const Common::Rectangle<u32>& prect = m_pending_vram_write_rect;
+    const bool adjacent = (rect.top == prect.top && rect.bottom == prect.bottom && rect.left == prect.right) ||
+                          (rect.left == prect.left && rect.right == prect.right && rect.top == prect.bottom);
+    if (!adjacent || set_mask != m_pending_vram_write_set_mask)
+      FlushPendingVRAMWrites();
+  }
+
+  if (m_pending_vram_write_buffer.empty())
+    m_pending_vram_write_buffer.resize(VRAM_WIDTH * VRAM_HEIGHT);
+
+  const u8* src_ptr = static_cast<const u8*>(data);
+  u16* dst_ptr = &m_pending_vram_write_buffer[y * VRAM_WIDTH + x];
+  for (u32 row = 0; row < height; row++)
+  {
+    std::memcpy(dst_ptr, src_ptr, width * sizeof(u16));
+    src_ptr += width * sizeof(u16);
+    dst_ptr += VRAM_WIDTH;
+  }
+
+  m_pending_vram_write_rect.Include(rect);
+  m_pending_vram_write_set_mask = set_mask;
+
+  // Texture page checks need to see the write before it's uploaded.
+  IncludeVRAMDirtyRectangle(rect);
+}
+
+void GPU_HW::FlushPendingVRAMWrites()
+{
+  if (!m_pending_vram_write_rect.Valid())
+    return;
+
+  const Common::Rectangle<u32> rect = m_pending_vram_write_rect;
+  m_pending_vram_write_rect.SetInvalid();
+
+  // Pack the rows in place, each one only moves towards the start of the buffer.
+  const u32 width = rect.GetWidth();
+  const u32 height = rect.GetHeight();
+  u16* buffer = m_pending_vram_write_buffer.data();
+  for (u32 row = 0; row < height; row++)
+    std::memmove(&buffer[row * width], &buffer[(rect.top + row) * VRAM_WIDTH + rect.left], width * sizeof(u16));
+
+  UpdateVRAM(rect.left, rect.top, width, height, buffer, m_pending_vram_write_set_mask, false);
+}
+
 void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
   IncludeVRAMDirtyRectangle(
@@ -1267,6 +1738,25 @@ void GPU_HW::DispatchRenderCommand()
 {
   const GPURenderCommand rc{m_render_command.bits};
 
+  // Texture reads are learned from every draw, so skipped frames know which pages have to stay up to date.
+  if (rc.IsTexturingEnabled() && m_draw_mode.IsTexturePageChanged())
+  {
+    const Common::Rectangle<u32> texture_rect = m_draw_mode.mode_reg.GetTexturePageRectangle();
+    SetVRAMPages(m_vram_read_pages, texture_rect.left, texture_rect.right, texture_rect.top, texture_rect.bottom);
+    if (m_draw_mode.mode_reg.IsUsingPalette())
+    {
+      const Common::Rectangle<u32> palette_rect = m_draw_mode.GetTexturePaletteRectangle();
+      SetVRAMPages(m_vram_read_pages, palette_rect.left, palette_rect.right, palette_rect.top, palette_rect.bottom);
+    }
+  }
+
+  if (m_frame_skip && !AnyVRAMPagesSet(m_vram_read_pages, m_drawing_area.left, m_drawing_area.right + 1,
+                                       m_drawing_area.top, m_drawing_area.bottom + 1))
+  {
+    SkipRenderCommand();
+    return;
+  }
+
   GPUTextureMode texture_mode;
   if (rc.IsTexturingEnabled())
   {
@@ -1274,20 +1764,27 @@ void GPU_HW::DispatchRenderCommand()
     if (m_draw_mode.IsTexturePageChanged())
     {
       m_draw_mode.ClearTexturePageChangedFlag();
-      if (m_vram_dirty_rect.Valid() && (m_draw_mode.mode_reg.GetTexturePageRectangle().Intersects(m_vram_dirty_rect) ||
-                                        (m_draw_mode.mode_reg.IsUsingPalette() &&
-                                         m_draw_mode.GetTexturePaletteRectangle().Intersects(m_vram_dirty_rect))))
+      if (m_vram_dirty_rect.Valid() &&
+          (IsVRAMAreaDirty(m_draw_mode.mode_reg.GetTexturePageRectangle()) ||
+           (m_draw_mode.mode_reg.IsUsingPalette() && IsVRAMAreaDirty(m_draw_mode.GetTexturePaletteRectangle()))))
       {
         // Log_DevPrintf("Invalidating VRAM read cache due to drawing area overlap");
-        if (!IsFlushed())
-          FlushRender();
-
+        FlushRender();
         UpdateVRAMReadTexture();
       }
     }
 
+    // Pages are decoded from the read texture, so this has to come after it's updated.
+    m_decoded_texpage_bits =
+      (m_decoded_texture_cache && m_draw_mode.mode_reg.IsUsingPalette()) ? GetDecodedTexturePageBits() : 0;
+
     texture_mode = m_draw_mode.mode_reg.texture_mode;
-    if (rc.raw_texture_enable)
+    if (m_texture_mode_batching)
+    {
+      // The mode is decoded from the texpage of each vertex instead.
+      texture_mode = GPUTextureMode::Dynamic;
+    }
+    else if (rc.raw_texture_enable)
     {
       texture_mode =
         static_cast<GPUTextureMode>(static_cast<u8>(texture_mode) | static_cast<u8>(GPUTextureMode::RawTextureBit));
@@ -1296,6 +1793,7 @@ void GPU_HW::DispatchRenderCommand()
   else
   {
     texture_mode = GPUTextureMode::Disabled;
+    m_decoded_texpage_bits = 0;
   }
 
   // has any state changed which requires a new batch?
@@ -1305,6 +1803,22 @@ void GPU_HW::DispatchRenderCommand()
   if (texture_mode != m_batch.texture_mode || transparency_mode != m_batch.transparency_mode ||
       transparency_mode == GPUTransparencyMode::BackgroundMinusForeground || dithering_enable != m_batch.dithering)
   {
+    if (!IsFlushed())
+    {
+      // Switching between textured modes is the only reason for this break which batching could avoid.
+      if (transparency_mode == m_batch.transparency_mode &&
+          transparency_mode != GPUTransparencyMode::BackgroundMinusForeground &&
+          dithering_enable == m_batch.dithering && texture_mode != GPUTextureMode::Disabled &&
+          m_batch.texture_mode != GPUTextureMode::Disabled)
+      {
+        m_renderer_stats.num_texture_mode_batch_breaks++;
+      }
+      else
+      {
+        m_renderer_stats.num_state_batch_breaks++;
+      }
+    }
+
     FlushRender();
   }
 
@@ -1315,7 +1829,11 @@ void GPU_HW::DispatchRenderCommand()
   {
     static constexpr float transparent_alpha[4][2] = {{0.5f, 0.5f}, {1.0f, 1.0f}, {1.0f, 1.0f}, {0.25f, 1.0f}};
 
-    const float src_alpha_factor = transparent_alpha[static_cast<u32>(transparency_mode)][0];
+    // With framebuffer fetch the shader blends by adding the scaled destination to the source, so BG-FG negates it.
+    const float src_alpha_factor = (m_supports_framebuffer_fetch &&
+                                    transparency_mode == GPUTransparencyMode::BackgroundMinusForeground) ?
+                                     -transparent_alpha[static_cast<u32>(transparency_mode)][0] :
+                                     transparent_alpha[static_cast<u32>(transparency_mode)][0];
     const float dst_alpha_factor = transparent_alpha[static_cast<u32>(transparency_mode)][1];
     m_batch_ubo_dirty |= (m_batch_ubo_data.u_src_alpha_factor != src_alpha_factor ||
                           m_batch_ubo_data.u_dst_alpha_factor != dst_alpha_factor);
@@ -1359,35 +1877,71 @@ void GPU_HW::DispatchRenderCommand()
   }
 
   if (m_drawing_area_changed)
-  {
-    m_drawing_area_changed = false;
-    SetScissorFromDrawingArea();
+    UpdateDrawingArea();
 
-    if (m_pgxp_depth_buffer && m_last_depth_z < 1.0f)
-      ClearDepthBuffer();
+  if (m_sw_readback_region_tracking && m_sw_replay_draws && rc.IsTexturingEnabled())
+    TrackSoftwareRendererTextureReads();
 
-    if (m_sw_renderer)
-    {
-      GPUBackendSetDrawingAreaCommand* cmd = m_sw_renderer->NewSetDrawingAreaCommand();
-      cmd->new_area = m_drawing_area;
-      m_sw_renderer->PushCommand(cmd);
-    }
+  LoadVertices();
+}
+
+void GPU_HW::UpdateDrawingArea()
+{
+  m_drawing_area_changed = false;
+  SetScissorFromDrawingArea();
+
+  if (m_pgxp_depth_buffer && m_last_depth_z < 1.0f)
+    ClearDepthBuffer();
+
+  if (m_sw_renderer)
+  {
+    GPUBackendSetDrawingAreaCommand* cmd = m_sw_renderer->NewSetDrawingAreaCommand();
+    cmd->new_area = m_drawing_area;
+    m_sw_renderer->PushCommand(cmd);
+    UpdateSoftwareRendererDrawReplay();
   }
+}
+
+void GPU_HW::SkipRenderCommand()
+{
+  // The vertices still have to be consumed for timing, PGXP and the SW renderer, they're just never drawn. Skipped
+  // commands are kept out of real batches, so the batch state doesn't need to change for them.
+  if (!IsFlushed())
+    FlushRender();
+
+  if (m_drawing_area_changed)
+    UpdateDrawingArea();
 
+  EnsureVertexBufferSpaceForCurrentCommand();
   LoadVertices();
+  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  m_renderer_stats.num_skipped_draws++;
+}
+
+void GPU_HW::TrackVRAMRead(u32 x, u32 y, u32 width, u32 height)
+{
+  const Common::Rectangle<u32> rect = GetVRAMTransferBounds(x, y, width, height);
+  SetVRAMPages(m_vram_read_pages, rect.left, rect.right, rect.top, rect.bottom);
 }
 
 void GPU_HW::FlushRender()
 {
+  // Queued writes always come before the batched draws.
+  FlushPendingVRAMWrites();
+
   if (!m_batch_current_vertex_ptr)
     return;
 
+  TRACE_SCOPE("GPU_HW::FlushRender");
+
   const u32 vertex_count = GetBatchVertexCount();
   UnmapBatchVertexPointer(vertex_count);
 
   if (vertex_count == 0)
     return;
 
+  g_host_display->SetGPUTimingSection(GPUTimingSection::Draw);
+
   if (m_batch_ubo_dirty)
   {
     UploadUniformBuffer(&m_batch_ubo_data, sizeof(m_batch_ubo_data));
@@ -1471,6 +2025,21 @@ void GPU_HW::DrawRendererStats(bool is_idle_frame)
     ImGui::Text("%u", stats.num_batches);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("Batch Breaks (Texture Mode):");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_texture_mode_batch_breaks);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Batch Breaks (Other State):");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_state_batch_breaks);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Draws Skipped:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_skipped_draws);
+    ImGui::NextColumn();
+
     ImGui::TextUnformatted("VRAM Read Texture Updates:");
     ImGui::NextColumn();
     ImGui::Text("%u", stats.num_vram_read_texture_updates);
@@ -1481,6 +2050,11 @@ void GPU_HW::DrawRendererStats(bool is_idle_frame)
     ImGui::Text("%u", stats.num_uniform_buffer_updates);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("Decoded Texture Pages: ");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_decoded_texture_pages);
+    ImGui::NextColumn();
+
     ImGui::Columns(1);
   }
 }
@@ -1492,9 +2066,9 @@ GPU_HW::ShaderCompileProgressTracker::ShaderCompileProgressTracker(std::string t
 {
 }
 
-void GPU_HW::ShaderCompileProgressTracker::Increment()
+void GPU_HW::ShaderCompileProgressTracker::Increment(u32 count /* = 1 */)
 {
-  m_progress++;
+  m_progress += count;
 
   const u64 tv = Common::Timer::GetCurrentValue();
   if ((tv - m_start_time) >= m_min_time && (tv - m_last_update_time) >= m_update_interval)
@@ -1503,3 +2077,50 @@ void GPU_HW::ShaderCompileProgressTracker::Increment()
     m_last_update_time = tv;
   }
 }
+
+bool GPU_HW::ShaderCompileProgressTracker::RunParallel(u32 num_jobs, u32 steps_per_job,
+                                                       const std::function<bool(u32)>& func)
+{
+  std::atomic<u32> next_job{0};
+  std::atomic<u32> jobs_done{0};
+  std::atomic_bool failed{false};
+
+  auto run_job = [&]() {
+    const u32 job = next_job.fetch_add(1, std::memory_order_relaxed);
+    if (job >= num_jobs || failed.load(std::memory_order_relaxed))
+      return false;
+
+    if (!func(job))
+      failed.store(true, std::memory_order_relaxed);
+
+    jobs_done.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  };
+
+  // the calling thread takes jobs too, so it only needs the pool's help for the rest
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  Threading::ThreadPool::TaskGroup group;
+  const u32 num_helpers = std::min(pool.GetThreadCount(), (num_jobs > 0) ? (num_jobs - 1) : 0u);
+  for (u32 i = 0; i < num_helpers; i++)
+  {
+    pool.Submit(
+      [&run_job]() {
+        while (run_job())
+          ;
+      },
+      Threading::ThreadPool::Priority::High, &group);
+  }
+
+  u32 jobs_reported = 0;
+  while (run_job())
+  {
+    const u32 done = jobs_done.load(std::memory_order_relaxed);
+    Increment((done - jobs_reported) * steps_per_job);
+    jobs_reported = done;
+  }
+
+  group.Wait(pool);
+
+  Increment((jobs_done.load(std::memory_order_relaxed) - jobs_reported) * steps_per_job);
+  return !failed.load(std::memory_order_relaxed);
+}
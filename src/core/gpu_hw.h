@@ -2,6 +2,8 @@
 #include "common/heap_array.h"
 #include "gpu.h"
 #include "host_display.h"
+#include <array>
+#include <functional>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -30,6 +32,15 @@ public:
     SeparateFields
   };
 
+  enum : u32
+  {
+    // Each adaptive downsample compute workgroup covers a 16x16 tile of the first mip, which can be reduced in
+    // shared memory down to a single texel, i.e. five mip levels, enough for the maximum resolution scale.
+    SMOOTHING_COMPUTE_TILE_SIZE = 16,
+    MAX_SMOOTHING_COMPUTE_MIP_LEVELS = 5,
+  };
+  static_assert((1u << (MAX_SMOOTHING_COMPUTE_MIP_LEVELS - 1)) == SMOOTHING_COMPUTE_TILE_SIZE);
+
   GPU_HW();
   virtual ~GPU_HW();
 
@@ -39,7 +50,10 @@ public:
   virtual void Reset(bool clear_vram) override;
   virtual bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display) override;
 
+  void ResetGraphicsAPIState() override;
+
   void UpdateResolutionScale() override final;
+  void UpdateDynamicResolution(float gpu_time, float frame_time_budget) override final;
   std::tuple<u32, u32> GetEffectiveDisplayResolution(bool scaled = true) override final;
   std::tuple<u32, u32> GetFullDisplayResolution(bool scaled = true) override final;
 
@@ -57,6 +71,10 @@ protected:
 
   struct BatchVertex
   {
+    // Set in texpage for raw textured primitives, next to the draw mode register bits.
+    static constexpr u32 TEXPAGE_RAW_TEXTURE_BIT = 0x4000u;
+
+
     float x;
     float y;
     float z;
@@ -168,6 +186,10 @@ protected:
     u32 num_batches;
     u32 num_vram_read_texture_updates;
     u32 num_uniform_buffer_updates;
+    u32 num_decoded_texture_pages;
+    u32 num_texture_mode_batch_breaks;
+    u32 num_state_batch_breaks;
+    u32 num_skipped_draws;
   };
 
   class ShaderCompileProgressTracker
@@ -175,7 +197,12 @@ protected:
   public:
     ShaderCompileProgressTracker(std::string title, u32 total);
 
-    void Increment();
+    void Increment(u32 count = 1);
+
+    /// Calls func(job) for every job in [0, num_jobs) across all cores, advancing progress by steps_per_job as
+    /// each one finishes. Returns false if any job failed. The calling thread takes jobs too, and is the only one
+    /// which draws the loading screen.
+    bool RunParallel(u32 num_jobs, u32 steps_per_job, const std::function<bool(u32)>& func);
 
   private:
     std::string m_title;
@@ -195,7 +222,23 @@ protected:
                            static_cast<float>(rgba >> 24) * (1.0f / 255.0f));
   }
 
-  void UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed);
+  /// What has to be rebuilt to apply a settings change. Settings which aren't covered by any of these are read at
+  /// draw or display time, and take effect without rebuilding anything.
+  enum HWSettingsChange : u8
+  {
+    HW_SETTINGS_CHANGE_NONE = 0,
+    HW_SETTINGS_CHANGE_BATCH_PIPELINES = (1 << 0),   // polygon/line/sprite drawing
+    HW_SETTINGS_CHANGE_UTILITY_PIPELINES = (1 << 1), // VRAM fill/copy/write/read, display, downsampling
+    HW_SETTINGS_CHANGE_FRAMEBUFFER = (1 << 2),       // VRAM textures, needs a VRAM round trip
+    HW_SETTINGS_CHANGE_PIPELINES = HW_SETTINGS_CHANGE_BATCH_PIPELINES | HW_SETTINGS_CHANGE_UTILITY_PIPELINES,
+  };
+
+  /// Applies the current settings, and returns the HWSettingsChange bits for the resources which need recreating.
+  u8 UpdateHWSettings();
+
+  /// Returns the texpage bits for vertices sampling the current palette texture page from the decoded texture
+  /// cache, decoding the page first if it isn't cached.
+  u32 GetDecodedTexturePageBits();
 
   virtual void UpdateVRAMReadTexture();
   virtual void UpdateDepthBufferFromMaskBit() = 0;
@@ -206,6 +249,12 @@ protected:
   virtual void UploadUniformBuffer(const void* uniforms, u32 uniforms_size) = 0;
   virtual void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) = 0;
 
+  /// Decodes a 4/8-bit texture page through its palette into a slot of the decoded texture atlas.
+  /// Only called when the backend supports the decoded texture cache. Coordinates are in native VRAM texels.
+  virtual void DecodeTexturePage(u32 slot, GPUTextureMode mode, u32 page_x, u32 page_y, u32 palette_x,
+                                 u32 palette_y);
+
+  u32 GetConfiguredResolutionScale() const;
   u32 CalculateResolutionScale() const;
   GPUDownsampleMode GetDownsampleMode(u32 resolution_scale) const;
 
@@ -218,10 +267,41 @@ protected:
   void SetFullVRAMDirtyRectangle()
   {
     m_vram_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    m_vram_dirty_pages.fill(ALL_VRAM_DIRTY_PAGES_IN_ROW);
+    m_vram_readback_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    m_vram_depth_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
     m_draw_mode.SetTexturePageChanged();
   }
-  void ClearVRAMDirtyRectangle() { m_vram_dirty_rect.SetInvalid(); }
+  void ClearVRAMDirtyRectangle()
+  {
+    m_vram_dirty_rect.SetInvalid();
+    m_vram_dirty_pages.fill(0);
+  }
   void IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect);
+  void IncludeDrawnVRAMRectangle(u32 left, u32 right, u32 top, u32 bottom)
+  {
+    m_vram_dirty_rect.Include(left, right, top, bottom);
+    m_vram_readback_dirty_rect.Include(left, right, top, bottom);
+    m_vram_depth_dirty_rect.Include(left, right, top, bottom);
+    SetVRAMDirtyPages(left, right, top, bottom);
+  }
+  void SetVRAMDirtyPages(u32 left, u32 right, u32 top, u32 bottom)
+  {
+    SetVRAMPages(m_vram_dirty_pages, left, right, top, bottom);
+  }
+
+  /// Returns true if any of the dirty pages overlap the area, i.e. the read texture is out of date there.
+  bool IsVRAMAreaDirty(const Common::Rectangle<u32>& rect) const;
+
+  /// Returns the dirty pages merged into as few rectangles as possible, for copying to the read texture.
+  const std::vector<Common::Rectangle<u32>>& GetVRAMDirtyAreas();
+
+  /// Returns false if the shadow copy of the area is already up to date, so the GPU doesn't need to be synced.
+  bool IsVRAMReadbackRequired(const Common::Rectangle<u32>& rect) const
+  {
+    return m_vram_readback_dirty_rect.Intersects(rect);
+  }
+  void VRAMReadbackCompleted(const Common::Rectangle<u32>& rect);
 
   bool IsFlushed() const { return m_batch_current_vertex_ptr == m_batch_start_vertex_ptr; }
 
@@ -251,7 +331,7 @@ protected:
     }
   }
 
-  /// Returns true if the specified texture filtering mode requires dual-source blending.
+  /// Returns true if the specified texture filtering mode requires dual-source blending (or framebuffer fetch).
   ALWAYS_INLINE bool TextureFilterRequiresDualSourceBlend(GPUTextureFilter filter)
   {
     return (filter == GPUTextureFilter::Bilinear || filter == GPUTextureFilter::JINC2 ||
@@ -274,10 +354,11 @@ protected:
   }
 
   /// We need two-pass rendering when using BG-FG blending and texturing, as the transparency can be enabled
-  /// on a per-pixel basis, and the opaque pixels shouldn't be blended at all.
+  /// on a per-pixel basis, and the opaque pixels shouldn't be blended at all. Not needed with framebuffer fetch, the
+  /// shader blends each pixel itself.
   ALWAYS_INLINE bool NeedsTwoPassRendering() const
   {
-    return (m_batch.texture_mode != GPUTextureMode::Disabled &&
+    return (!m_supports_framebuffer_fetch && m_batch.texture_mode != GPUTextureMode::Disabled &&
             (m_batch.transparency_mode == GPUTransparencyMode::BackgroundMinusForeground ||
              (!m_supports_dual_source_blend && m_batch.transparency_mode != GPUTransparencyMode::Disabled)));
   }
@@ -288,12 +369,21 @@ protected:
     return ((x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT);
   }
 
+  /// Returns true if the specified VRAM copy wraps around the edge of VRAM.
+  ALWAYS_INLINE static bool IsVRAMCopyOversized(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
+  {
+    return (IsVRAMFillOversized(src_x, src_y, width, height) || IsVRAMFillOversized(dst_x, dst_y, width, height));
+  }
+
   ALWAYS_INLINE bool IsUsingSoftwareRendererForReadbacks() { return static_cast<bool>(m_sw_renderer); }
 
   void FillBackendCommandParameters(GPUBackendCommand* cmd) const;
   void FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) const;
   void UpdateSoftwareRenderer(bool copy_vram_from_hw);
-  void ReadSoftwareRendererVRAM(u32 x, u32 y, u32 width, u32 height);
+
+  /// Waits for the SW renderer to catch up. Returns false if the area has to be read back from the GPU instead, which
+  /// happens the first time it's read when region tracking, the area is then widened to whole pages.
+  bool ReadSoftwareRendererVRAM(u32* x, u32* y, u32* width, u32* height);
   void UpdateSoftwareRendererVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask,
                                   bool check_mask);
   void FillSoftwareRendererVRAM(u32 x, u32 y, u32 width, u32 height, u32 color);
@@ -301,7 +391,9 @@ protected:
 
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
+  void QueueVRAMWrite(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
+  void TrackVRAMRead(u32 x, u32 y, u32 width, u32 height) override;
   void DispatchRenderCommand() override;
   void FlushRender() override;
   void DrawRendererStats(bool is_idle_frame) override;
@@ -316,8 +408,8 @@ protected:
   /// Computes the area affected by a VRAM transfer, including wrap-around of X.
   Common::Rectangle<u32> GetVRAMTransferBounds(u32 x, u32 y, u32 width, u32 height) const;
 
-  /// Returns true if the VRAM copy shader should be used (oversized copies, masking).
-  bool UseVRAMCopyShader(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) const;
+  /// Returns true if the VRAM copy shader should be used (masking).
+  bool UseVRAMCopyShader() const;
 
   VRAMFillUBOData GetVRAMFillUBOData(u32 x, u32 y, u32 width, u32 height, u32 color) const;
   VRAMWriteUBOData GetVRAMWriteUBOData(u32 x, u32 y, u32 width, u32 height, u32 buffer_offset, bool set_mask,
@@ -352,7 +444,17 @@ protected:
   SmoothingUBOData GetSmoothingUBO(u32 level, u32 left, u32 top, u32 width, u32 height, u32 tex_width,
                                    u32 tex_height) const;
 
-  HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram_shadow;
+  /// UBO data for generating the whole adaptive smoothing mip chain in a single compute dispatch.
+  struct SmoothingComputeUBOData
+  {
+    u32 rect[4];
+    u32 base[2];
+  };
+
+  /// Returns the UBO data and workgroup counts for the adaptive smoothing compute dispatch.
+  SmoothingComputeUBOData GetSmoothingComputeUBO(u32 left, u32 top, u32 width, u32 height, u32* groups_x,
+                                                 u32* groups_y) const;
+
   std::unique_ptr<GPU_SW_Backend> m_sw_renderer;
 
   BatchVertex* m_batch_start_vertex_ptr = nullptr;
@@ -387,6 +489,17 @@ protected:
   GPUDownsampleMode m_downsample_mode = GPUDownsampleMode::Disabled;
   bool m_using_uv_limits = false;
   bool m_pgxp_depth_buffer = false;
+  bool m_supports_decoded_texture_cache = false;
+  bool m_supports_framebuffer_fetch = false;
+  bool m_decoded_texture_cache = false;
+  bool m_supports_texture_mode_batching = false;
+  bool m_texture_mode_batching = false;
+
+  // Scale picked by dynamic resolution, between the minimum and configured scales. Zero until it first changes.
+  u32 m_dynamic_resolution_scale = 0;
+  u32 m_dynamic_resolution_lower_count = 0;
+  u32 m_dynamic_resolution_raise_count = 0;
+  bool m_dynamic_resolution_settling = false;
 
   BatchConfig m_batch;
   BatchUBOData m_batch_ubo_data = {};
@@ -394,6 +507,80 @@ protected:
   // Bounding box of VRAM area that the GPU has drawn into.
   Common::Rectangle<u32> m_vram_dirty_rect;
 
+  // Area of the depth buffer written since it was last rebuilt from the mask bits, or cleared with the PGXP depth
+  // buffer. Everything outside it is already up to date, so rebuilds and clears only have to touch this area.
+  Common::Rectangle<u32> m_vram_depth_dirty_rect;
+
+  // Pages of VRAM that the GPU has drawn into, one bit per page for each row.
+  enum : u32
+  {
+    VRAM_DIRTY_PAGE_WIDTH = 64,
+    VRAM_DIRTY_PAGE_HEIGHT = 32,
+    VRAM_DIRTY_PAGES_X = VRAM_WIDTH / VRAM_DIRTY_PAGE_WIDTH,
+    VRAM_DIRTY_PAGES_Y = VRAM_HEIGHT / VRAM_DIRTY_PAGE_HEIGHT,
+    ALL_VRAM_DIRTY_PAGES_IN_ROW = (1u << VRAM_DIRTY_PAGES_X) - 1u,
+  };
+  std::array<u16, VRAM_DIRTY_PAGES_Y> m_vram_dirty_pages = {};
+  std::vector<Common::Rectangle<u32>> m_vram_dirty_areas;
+
+  static void SetVRAMPages(std::array<u16, VRAM_DIRTY_PAGES_Y>& pages, u32 left, u32 right, u32 top, u32 bottom);
+
+  // Palette texture pages decoded to RGBA8, in 256x256 slots of an atlas owned by the backend.
+  enum : u32
+  {
+    DECODED_TEXTURE_PAGE_SIZE = 256,
+    DECODED_TEXTURE_ATLAS_SLOTS_X = 8,
+    DECODED_TEXTURE_ATLAS_SIZE = DECODED_TEXTURE_PAGE_SIZE * DECODED_TEXTURE_ATLAS_SLOTS_X,
+    DECODED_TEXTURE_PAGE_SLOTS = DECODED_TEXTURE_ATLAS_SLOTS_X * DECODED_TEXTURE_ATLAS_SLOTS_X,
+    DECODED_TEXTURE_PAGE_VERTEX_BIT = 0x8000u,
+    INVALID_DECODED_TEXTURE_PAGE_KEY = 0xFFFFFFFFu,
+  };
+  struct DecodedTexturePage
+  {
+    u32 key;
+    u32 last_used;
+    std::array<u16, VRAM_DIRTY_PAGES_Y> vram_pages;
+  };
+  std::array<DecodedTexturePage, DECODED_TEXTURE_PAGE_SLOTS> m_decoded_texture_pages = {};
+  u32 m_decoded_texture_page_counter = 0;
+  u32 m_current_decoded_texture_page = 0;
+  u32 m_decoded_texpage_bits = 0;
+
+  /// Drops cached pages whose texture or palette overlaps the given VRAM pages.
+  void InvalidateDecodedTexturePages(const std::array<u16, VRAM_DIRTY_PAGES_Y>& vram_pages);
+  void InvalidateAllDecodedTexturePages();
+
+  // Bounding box of VRAM area that has changed since it was last read back into the shadow copy.
+  Common::Rectangle<u32> m_vram_readback_dirty_rect;
+
+  // Pages the CPU has read back with region tracking on. The SW renderer only replays draws whose drawing area
+  // overlaps them, along with the textures those draws sample.
+  std::array<u16, VRAM_DIRTY_PAGES_Y> m_sw_readback_pages = {};
+  bool m_sw_readback_region_tracking = false;
+  bool m_sw_replay_draws = true;
+
+  static bool AnyVRAMPagesSet(const std::array<u16, VRAM_DIRTY_PAGES_Y>& pages, u32 left, u32 right, u32 top,
+                              u32 bottom);
+  static bool AllVRAMPagesSet(const std::array<u16, VRAM_DIRTY_PAGES_Y>& pages, u32 left, u32 right, u32 top,
+                              u32 bottom);
+  void UpdateSoftwareRendererDrawReplay();
+  void TrackSoftwareRendererTextureReads();
+
+  // Pages which have been sampled as textures, copied from or read by the CPU. Draws elsewhere are left out of
+  // skipped frames, since nothing looks at them before they're drawn again.
+  std::array<u16, VRAM_DIRTY_PAGES_Y> m_vram_read_pages = {};
+
+  void UpdateDrawingArea();
+  void SkipRenderCommand();
+
+  /// Uploads the queued CPU to VRAM writes, if any.
+  void FlushPendingVRAMWrites();
+
+  // Adjacent CPU to VRAM writes are merged here, in VRAM layout, and uploaded together.
+  std::vector<u16> m_pending_vram_write_buffer;
+  Common::Rectangle<u32> m_pending_vram_write_rect;
+  bool m_pending_vram_write_set_mask = false;
+
   // Statistics
   RendererStats m_renderer_stats = {};
   RendererStats m_last_renderer_stats = {};
@@ -171,8 +171,9 @@ void GPU_HW_D3D11::UpdateSettings()
 {
   GPU_HW::UpdateSettings();
 
-  bool framebuffer_changed, shaders_changed;
-  UpdateHWSettings(&framebuffer_changed, &shaders_changed);
+  const u8 changes = UpdateHWSettings();
+  const bool framebuffer_changed = (changes & HW_SETTINGS_CHANGE_FRAMEBUFFER) != 0;
+  const bool shaders_changed = (changes & HW_SETTINGS_CHANGE_PIPELINES) != 0;
 
   if (framebuffer_changed)
   {
@@ -233,6 +234,7 @@ void GPU_HW_D3D11::SetCapabilities()
   m_supports_per_sample_shading = (m_device->GetFeatureLevel() >= D3D_FEATURE_LEVEL_10_1);
   m_supports_adaptive_downsampling = true;
   m_supports_disable_color_perspective = true;
+  m_use_compute_downsampling = (m_device->GetFeatureLevel() >= D3D_FEATURE_LEVEL_11_0);
 
   m_max_multisamples = 1;
   for (u32 multisamples = 2; multisamples < D3D11_MAX_MULTISAMPLE_SAMPLE_COUNT; multisamples++)
@@ -287,8 +289,10 @@ bool GPU_HW_D3D11::CreateFramebuffer()
   {
     const u32 levels = GetAdaptiveDownsamplingMipLevels();
 
+    const u32 bind_flags = D3D11_BIND_SHADER_RESOURCE |
+                           (m_use_compute_downsampling ? D3D11_BIND_UNORDERED_ACCESS : D3D11_BIND_RENDER_TARGET);
     if (!m_downsample_texture.Create(m_device.Get(), texture_width, texture_height, 1, static_cast<u16>(levels), 1,
-                                     texture_format, D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET) ||
+                                     texture_format, bind_flags) ||
         !m_downsample_weight_texture.Create(m_device.Get(), texture_width >> (levels - 1),
                                             texture_height >> (levels - 1), 1, 1, 1, GPUTexture::Format::R8,
                                             D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET))
@@ -309,10 +313,26 @@ bool GPU_HW_D3D11::CreateFramebuffer()
       if (FAILED(hr))
         return false;
 
-      hr = m_device->CreateRenderTargetView(m_downsample_texture, &rtv_desc,
-                                            m_downsample_mip_views[i].second.GetAddressOf());
-      if (FAILED(hr))
-        return false;
+      if (m_use_compute_downsampling)
+      {
+        // mip 0 is copied from the source, the compute shader writes the rest
+        if (i == 0)
+          continue;
+
+        const CD3D11_UNORDERED_ACCESS_VIEW_DESC uav_desc(m_downsample_texture, D3D11_UAV_DIMENSION_TEXTURE2D,
+                                                         m_downsample_texture.GetDXGIFormat(), i);
+        hr = m_device->CreateUnorderedAccessView(m_downsample_texture, &uav_desc,
+                                                 m_downsample_mip_uavs.emplace_back().GetAddressOf());
+        if (FAILED(hr))
+          return false;
+      }
+      else
+      {
+        hr = m_device->CreateRenderTargetView(m_downsample_texture, &rtv_desc,
+                                              m_downsample_mip_views[i].second.GetAddressOf());
+        if (FAILED(hr))
+          return false;
+      }
     }
   }
   else if (m_downsample_mode == GPUDownsampleMode::Box)
@@ -341,6 +361,7 @@ void GPU_HW_D3D11::ClearFramebuffer()
 
 void GPU_HW_D3D11::DestroyFramebuffer()
 {
+  m_downsample_mip_uavs.clear();
   m_downsample_mip_views.clear();
   m_downsample_weight_texture.Destroy();
   m_downsample_texture.Destroy();
@@ -558,28 +579,22 @@ bool GPU_HW_D3D11::CompileShaders()
     progress.Increment();
   }
 
-  for (u8 render_mode = 0; render_mode < 4; render_mode++)
-  {
-    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
-    {
-      for (u8 dithering = 0; dithering < 2; dithering++)
-      {
-        for (u8 interlacing = 0; interlacing < 2; interlacing++)
-        {
-          const std::string ps = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
-
-          m_batch_pixel_shaders[render_mode][texture_mode][dithering][interlacing] =
-            shader_cache.GetPixelShader(m_device.Get(), ps);
-          if (!m_batch_pixel_shaders[render_mode][texture_mode][dithering][interlacing])
-            return false;
-
-          progress.Increment();
-        }
-      }
-    }
-  }
+  // D3DCompile() is slow and the device is free-threaded, so compile and create the pixel shaders across all cores.
+  const bool shaders_compiled = progress.RunParallel(4 * 9 * 2 * 2, 1, [&](u32 job) {
+    const u8 interlacing = static_cast<u8>(job % 2);
+    const u8 dithering = static_cast<u8>((job / 2) % 2);
+    const u8 texture_mode = static_cast<u8>((job / 4) % 9);
+    const u8 render_mode = static_cast<u8>(job / 36);
+    const std::string ps = shadergen.GenerateBatchFragmentShader(
+      static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+      ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+
+    m_batch_pixel_shaders[render_mode][texture_mode][dithering][interlacing] =
+      shader_cache.GetPixelShader(m_device.Get(), ps);
+    return static_cast<bool>(m_batch_pixel_shaders[render_mode][texture_mode][dithering][interlacing]);
+  });
+  if (!shaders_compiled)
+    return false;
 
   m_copy_pixel_shader = shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateCopyFragmentShader());
   if (!m_copy_pixel_shader)
@@ -644,20 +659,29 @@ bool GPU_HW_D3D11::CompileShaders()
 
   if (m_downsample_mode == GPUDownsampleMode::Adaptive)
   {
-    m_downsample_first_pass_pixel_shader =
-      shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleMipFragmentShader(true));
-    m_downsample_mid_pass_pixel_shader =
-      shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleMipFragmentShader(false));
+    if (m_use_compute_downsampling)
+    {
+      m_downsample_mip_compute_shader = shader_cache.GetComputeShader(
+        m_device.Get(), shadergen.GenerateAdaptiveDownsampleMipComputeShader(GetAdaptiveDownsamplingMipLevels()));
+      if (!m_downsample_mip_compute_shader)
+        return false;
+    }
+    else
+    {
+      m_downsample_first_pass_pixel_shader =
+        shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleMipFragmentShader(true));
+      m_downsample_mid_pass_pixel_shader =
+        shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleMipFragmentShader(false));
+      if (!m_downsample_first_pass_pixel_shader || !m_downsample_mid_pass_pixel_shader)
+        return false;
+    }
+
     m_downsample_blur_pass_pixel_shader =
       shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleBlurFragmentShader());
     m_downsample_composite_pixel_shader =
       shader_cache.GetPixelShader(m_device.Get(), shadergen.GenerateAdaptiveDownsampleCompositeFragmentShader());
-
-    if (!m_downsample_first_pass_pixel_shader || !m_downsample_mid_pass_pixel_shader ||
-        !m_downsample_blur_pass_pixel_shader || !m_downsample_composite_pixel_shader)
-    {
+    if (!m_downsample_blur_pass_pixel_shader || !m_downsample_composite_pixel_shader)
       return false;
-    }
   }
   else if (m_downsample_mode == GPUDownsampleMode::Box)
   {
@@ -676,6 +700,7 @@ bool GPU_HW_D3D11::CompileShaders()
 
 void GPU_HW_D3D11::DestroyShaders()
 {
+  m_downsample_mip_compute_shader.Reset();
   m_downsample_composite_pixel_shader.Reset();
   m_downsample_blur_pass_pixel_shader.Reset();
   m_downsample_mid_pass_pixel_shader.Reset();
@@ -924,17 +949,18 @@ void GPU_HW_D3D11::UpdateDisplay()
 
 void GPU_HW_D3D11::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
-  if (IsUsingSoftwareRendererForReadbacks())
-  {
-    ReadSoftwareRendererVRAM(x, y, width, height);
+  if (IsUsingSoftwareRendererForReadbacks() && ReadSoftwareRendererVRAM(&x, &y, &width, &height))
     return;
-  }
 
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
+  // Nothing has been drawn to this area since it was last read back, so the shadow copy is current.
+  if (!IsVRAMReadbackRequired(copy_rect))
+    return;
+
   // Encode the 24-bit texture as 16-bit.
   const u32 uniforms[4] = {copy_rect.left, copy_rect.top, copy_rect.GetWidth(), copy_rect.GetHeight()};
   m_context->RSSetState(m_cull_none_rasterizer_state_no_msaa.Get());
@@ -948,6 +974,7 @@ void GPU_HW_D3D11::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   g_host_display->DownloadTexture(&m_vram_encoding_texture, 0, 0, encoded_width, encoded_height,
                                   reinterpret_cast<u32*>(&m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]),
                                   VRAM_WIDTH * sizeof(u16));
+  VRAMReadbackCompleted(copy_rect);
 
   RestoreGraphicsAPIState();
 }
@@ -1014,14 +1041,22 @@ void GPU_HW_D3D11::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* d
 
 void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  // API copies can't wrap around the edge of VRAM, so oversized copies are done in pieces.
+  const bool use_shader = (UseVRAMCopyShader() || IsUsingMultisampling());
+  if (!use_shader && IsVRAMCopyOversized(src_x, src_y, dst_x, dst_y, width, height))
+  {
+    CopyOversizedVRAM(src_x, src_y, dst_x, dst_y, width, height);
+    return;
+  }
+
   if (IsUsingSoftwareRendererForReadbacks())
     CopySoftwareRendererVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
-  if (UseVRAMCopyShader(src_x, src_y, dst_x, dst_y, width, height) || IsUsingMultisampling())
+  if (use_shader)
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
+    if (IsVRAMAreaDirty(src_bounds))
       UpdateVRAMReadTexture();
     IncludeVRAMDirtyRectangle(dst_bounds);
 
@@ -1047,7 +1082,7 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   // We can't CopySubresourceRegion to the same resource. So use the shadow texture if we can, but that may need to be
   // updated first. Copying to the same resource seemed to work on Windows 10, but breaks on Windows 7. But, it's
   // against the API spec, so better to be safe than sorry.
-  if (m_vram_dirty_rect.Intersects(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)))
+  if (IsVRAMAreaDirty(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)))
     UpdateVRAMReadTexture();
 
   GPU_HW::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
@@ -1065,9 +1100,6 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
 
 void GPU_HW_D3D11::UpdateVRAMReadTexture()
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
-  const CD3D11_BOX src_box(scaled_rect.left, scaled_rect.top, 0, scaled_rect.right, scaled_rect.bottom, 1);
-
   if (m_vram_texture.IsMultisampled())
   {
     m_context->ResolveSubresource(m_vram_read_texture.GetD3DTexture(), 0, m_vram_texture.GetD3DTexture(), 0,
@@ -1075,8 +1107,13 @@ void GPU_HW_D3D11::UpdateVRAMReadTexture()
   }
   else
   {
-    m_context->CopySubresourceRegion(m_vram_read_texture, 0, scaled_rect.left, scaled_rect.top, 0, m_vram_texture, 0,
-                                     &src_box);
+    for (const Common::Rectangle<u32>& area : GetVRAMDirtyAreas())
+    {
+      const auto scaled_rect = area * m_resolution_scale;
+      const CD3D11_BOX src_box(scaled_rect.left, scaled_rect.top, 0, scaled_rect.right, scaled_rect.bottom, 1);
+      m_context->CopySubresourceRegion(m_vram_read_texture, 0, scaled_rect.left, scaled_rect.top, 0, m_vram_texture,
+                                       0, &src_box);
+    }
   }
 
   GPU_HW::UpdateVRAMReadTexture();
@@ -1084,10 +1121,12 @@ void GPU_HW_D3D11::UpdateVRAMReadTexture()
 
 void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
 {
-  if (m_pgxp_depth_buffer)
+  if (m_pgxp_depth_buffer || !m_vram_depth_dirty_rect.Valid())
     return;
 
-  SetViewportAndScissor(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  const Common::Rectangle<u32> scaled_rect(m_vram_depth_dirty_rect * m_resolution_scale);
+  SetViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  SetScissor(scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
 
   m_context->OMSetRenderTargets(0, nullptr, m_vram_depth_view.Get());
   m_context->OMSetDepthStencilState(m_depth_test_always_state.Get(), 0);
@@ -1097,6 +1136,7 @@ void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
   DrawUtilityShader(m_vram_update_depth_pixel_shader.Get(), nullptr, 0);
 
   m_context->PSSetShaderResources(0, 1, m_vram_read_texture.GetD3DSRVArray());
+  m_vram_depth_dirty_rect.SetInvalid();
   RestoreGraphicsAPIState();
 }
 
@@ -1104,8 +1144,12 @@ void GPU_HW_D3D11::ClearDepthBuffer()
 {
   DebugAssert(m_pgxp_depth_buffer);
 
-  m_context->ClearDepthStencilView(m_vram_depth_view.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
   m_last_depth_z = 1.0f;
+  if (!m_vram_depth_dirty_rect.Valid())
+    return;
+
+  m_context->ClearDepthStencilView(m_vram_depth_view.Get(), D3D11_CLEAR_DEPTH, 1.0f, 0);
+  m_vram_depth_dirty_rect.SetInvalid();
 }
 
 void GPU_HW_D3D11::DownsampleFramebuffer(D3D11::Texture& source, u32 left, u32 top, u32 width, u32 height)
@@ -1127,21 +1171,46 @@ void GPU_HW_D3D11::DownsampleFramebufferAdaptive(D3D11::Texture& source, u32 lef
 
   // create mip chain
   const u32 levels = m_downsample_texture.GetLevels();
-  for (u32 level = 1; level < levels; level++)
+  if (m_use_compute_downsampling)
   {
-    static constexpr float clear_color[4] = {};
-
-    SetViewportAndScissor(left >> level, top >> level, width >> level, height >> level);
-    m_context->ClearRenderTargetView(m_downsample_mip_views[level].second.Get(), clear_color);
-    m_context->OMSetRenderTargets(1, m_downsample_mip_views[level].second.GetAddressOf(), nullptr);
-    m_context->PSSetShaderResources(0, 1, m_downsample_mip_views[level - 1].first.GetAddressOf());
-
-    const SmoothingUBOData ubo = GetSmoothingUBO(level, left, top, width, height, m_downsample_texture.GetWidth(),
-                                                 m_downsample_texture.GetHeight());
-    m_context->PSSetShader(
-      (level == 1) ? m_downsample_first_pass_pixel_shader.Get() : m_downsample_mid_pass_pixel_shader.Get(), nullptr, 0);
+    u32 groups_x, groups_y;
+    const SmoothingComputeUBOData ubo = GetSmoothingComputeUBO(left, top, width, height, &groups_x, &groups_y);
     UploadUniformBuffer(&ubo, sizeof(ubo));
-    m_context->Draw(3, 0);
+    m_context->CSSetConstantBuffers(0, 1, m_uniform_stream_buffer.GetD3DBufferArray());
+    m_context->CSSetShaderResources(0, 1, m_downsample_mip_views[0].first.GetAddressOf());
+    const UINT num_uavs = static_cast<UINT>(m_downsample_mip_uavs.size());
+    std::array<ID3D11UnorderedAccessView*, MAX_SMOOTHING_COMPUTE_MIP_LEVELS> uavs = {};
+    for (UINT i = 0; i < num_uavs; i++)
+      uavs[i] = m_downsample_mip_uavs[i].Get();
+    m_context->CSSetUnorderedAccessViews(0, num_uavs, uavs.data(), nullptr);
+    m_context->CSSetShader(m_downsample_mip_compute_shader.Get(), nullptr, 0);
+    m_context->Dispatch(groups_x, groups_y, 1);
+
+    ID3D11ShaderResourceView* const null_srv = nullptr;
+    uavs = {};
+    m_context->CSSetShaderResources(0, 1, &null_srv);
+    m_context->CSSetUnorderedAccessViews(0, num_uavs, uavs.data(), nullptr);
+    m_context->CSSetShader(nullptr, nullptr, 0);
+  }
+  else
+  {
+    for (u32 level = 1; level < levels; level++)
+    {
+      static constexpr float clear_color[4] = {};
+
+      SetViewportAndScissor(left >> level, top >> level, width >> level, height >> level);
+      m_context->ClearRenderTargetView(m_downsample_mip_views[level].second.Get(), clear_color);
+      m_context->OMSetRenderTargets(1, m_downsample_mip_views[level].second.GetAddressOf(), nullptr);
+      m_context->PSSetShaderResources(0, 1, m_downsample_mip_views[level - 1].first.GetAddressOf());
+
+      const SmoothingUBOData ubo = GetSmoothingUBO(level, left, top, width, height, m_downsample_texture.GetWidth(),
+                                                   m_downsample_texture.GetHeight());
+      m_context->PSSetShader((level == 1) ? m_downsample_first_pass_pixel_shader.Get() :
+                                            m_downsample_mid_pass_pixel_shader.Get(),
+                             nullptr, 0);
+      UploadUniformBuffer(&ubo, sizeof(ubo));
+      m_context->Draw(3, 0);
+    }
   }
 
   // blur pass at lowest level
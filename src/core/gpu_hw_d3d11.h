@@ -134,7 +134,12 @@ private:
   ComPtr<ID3D11PixelShader> m_downsample_mid_pass_pixel_shader;
   ComPtr<ID3D11PixelShader> m_downsample_blur_pass_pixel_shader;
   ComPtr<ID3D11PixelShader> m_downsample_composite_pixel_shader;
+  ComPtr<ID3D11ComputeShader> m_downsample_mip_compute_shader;
   D3D11::Texture m_downsample_texture;
   D3D11::Texture m_downsample_weight_texture;
   std::vector<std::pair<ComPtr<ID3D11ShaderResourceView>, ComPtr<ID3D11RenderTargetView>>> m_downsample_mip_views;
+  std::vector<ComPtr<ID3D11UnorderedAccessView>> m_downsample_mip_uavs;
+
+  // Compute shaders with typed UAV stores need feature level 11, otherwise mips are generated one pass per level.
+  bool m_use_compute_downsampling = false;
 };
@@ -132,9 +132,12 @@ void GPU_HW_D3D12::UpdateSettings()
 {
   GPU_HW::UpdateSettings();
 
-  bool framebuffer_changed, shaders_changed;
-  UpdateHWSettings(&framebuffer_changed, &shaders_changed);
+  const u8 changes = UpdateHWSettings();
+  if (changes == HW_SETTINGS_CHANGE_NONE)
+    return;
 
+  const bool framebuffer_changed = (changes & HW_SETTINGS_CHANGE_FRAMEBUFFER) != 0;
+  const bool shaders_changed = (changes & HW_SETTINGS_CHANGE_PIPELINES) != 0;
   if (framebuffer_changed)
   {
     RestoreGraphicsAPIState();
@@ -437,27 +440,21 @@ bool GPU_HW_D3D12::CompilePipelines()
     progress.Increment();
   }
 
-  for (u8 render_mode = 0; render_mode < 4; render_mode++)
-  {
-    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
-    {
-      for (u8 dithering = 0; dithering < 2; dithering++)
-      {
-        for (u8 interlacing = 0; interlacing < 2; interlacing++)
-        {
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
-
-          batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader_cache.GetPixelShader(fs);
-          if (!batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing])
-            return false;
-
-          progress.Increment();
-        }
-      }
-    }
-  }
+  // Compiling the pixel shaders is the slowest part, so spread it across all cores.
+  const bool shaders_compiled = progress.RunParallel(4 * 9 * 2 * 2, 1, [&](u32 job) {
+    const u8 interlacing = static_cast<u8>(job % 2);
+    const u8 dithering = static_cast<u8>((job / 2) % 2);
+    const u8 texture_mode = static_cast<u8>((job / 4) % 9);
+    const u8 render_mode = static_cast<u8>(job / 36);
+    const std::string fs = shadergen.GenerateBatchFragmentShader(
+      static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+      ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+
+    batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader_cache.GetPixelShader(fs);
+    return static_cast<bool>(batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing]);
+  });
+  if (!shaders_compiled)
+    return false;
 
   D3D12::GraphicsPipelineBuilder gpbuilder;
 
@@ -942,17 +939,18 @@ void GPU_HW_D3D12::UpdateDisplay()
 
 void GPU_HW_D3D12::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
-  if (IsUsingSoftwareRendererForReadbacks())
-  {
-    ReadSoftwareRendererVRAM(x, y, width, height);
+  if (IsUsingSoftwareRendererForReadbacks() && ReadSoftwareRendererVRAM(&x, &y, &width, &height))
     return;
-  }
 
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
+  // Nothing has been drawn to this area since it was last read back, so the shadow copy is current.
+  if (!IsVRAMReadbackRequired(copy_rect))
+    return;
+
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
   m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
   m_vram_readback_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
@@ -978,6 +976,7 @@ void GPU_HW_D3D12::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   m_vram_readback_staging_texture.ReadPixels(0, 0, encoded_width, encoded_height,
                                              &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
                                              VRAM_WIDTH * sizeof(u16));
+  VRAMReadbackCompleted(copy_rect);
 
   RestoreGraphicsAPIState();
 }
@@ -1078,14 +1077,22 @@ void GPU_HW_D3D12::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* d
 
 void GPU_HW_D3D12::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  // API copies can't wrap around the edge of VRAM, so oversized copies are done in pieces.
+  const bool use_shader = (UseVRAMCopyShader() || IsUsingMultisampling());
+  if (!use_shader && IsVRAMCopyOversized(src_x, src_y, dst_x, dst_y, width, height))
+  {
+    CopyOversizedVRAM(src_x, src_y, dst_x, dst_y, width, height);
+    return;
+  }
+
   if (IsUsingSoftwareRendererForReadbacks())
     CopySoftwareRendererVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
-  if (UseVRAMCopyShader(src_x, src_y, dst_x, dst_y, width, height) || IsUsingMultisampling())
+  if (use_shader)
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
+    if (IsVRAMAreaDirty(src_bounds))
       UpdateVRAMReadTexture();
     IncludeVRAMDirtyRectangle(dst_bounds);
 
@@ -1109,7 +1116,7 @@ void GPU_HW_D3D12::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
     return;
   }
 
-  if (m_vram_dirty_rect.Intersects(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)))
+  if (IsVRAMAreaDirty(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)))
     UpdateVRAMReadTexture();
 
   GPU_HW::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
@@ -1139,8 +1146,6 @@ void GPU_HW_D3D12::UpdateVRAMReadTexture()
 {
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
 
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
-
   if (m_vram_texture.IsMultisampled())
   {
     m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_RESOLVE_SOURCE);
@@ -1152,10 +1157,14 @@ void GPU_HW_D3D12::UpdateVRAMReadTexture()
     const D3D12_TEXTURE_COPY_LOCATION src = {m_vram_texture.GetResource(), D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX};
     const D3D12_TEXTURE_COPY_LOCATION dst = {m_vram_read_texture.GetResource(),
                                              D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX};
-    const D3D12_BOX src_box = {scaled_rect.left, scaled_rect.top, 0u, scaled_rect.right, scaled_rect.bottom, 1u};
     m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_COPY_SOURCE);
     m_vram_read_texture.TransitionToState(D3D12_RESOURCE_STATE_COPY_DEST);
-    cmdlist->CopyTextureRegion(&dst, scaled_rect.left, scaled_rect.top, 0, &src, &src_box);
+    for (const Common::Rectangle<u32>& area : GetVRAMDirtyAreas())
+    {
+      const auto scaled_rect = area * m_resolution_scale;
+      const D3D12_BOX src_box = {scaled_rect.left, scaled_rect.top, 0u, scaled_rect.right, scaled_rect.bottom, 1u};
+      cmdlist->CopyTextureRegion(&dst, scaled_rect.left, scaled_rect.top, 0, &src, &src_box);
+    }
   }
 
   m_vram_read_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
@@ -1166,6 +1175,9 @@ void GPU_HW_D3D12::UpdateVRAMReadTexture()
 
 void GPU_HW_D3D12::UpdateDepthBufferFromMaskBit()
 {
+  if (!m_vram_depth_dirty_rect.Valid())
+    return;
+
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
 
   m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
@@ -1173,19 +1185,26 @@ void GPU_HW_D3D12::UpdateDepthBufferFromMaskBit()
   cmdlist->OMSetRenderTargets(0, nullptr, FALSE, &m_vram_depth_texture.GetRTVOrDSVDescriptor().cpu_handle);
   cmdlist->SetGraphicsRootDescriptorTable(1, m_vram_texture.GetSRVDescriptor());
   cmdlist->SetPipelineState(m_vram_update_depth_pipeline.Get());
-  D3D12::SetViewportAndScissor(cmdlist, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  const Common::Rectangle<u32> scaled_rect(m_vram_depth_dirty_rect * m_resolution_scale);
+  D3D12::SetViewport(cmdlist, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  D3D12::SetScissor(cmdlist, scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
   cmdlist->DrawInstanced(3, 1, 0, 0);
 
   m_vram_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
+  m_vram_depth_dirty_rect.SetInvalid();
 
   RestoreGraphicsAPIState();
 }
 
 void GPU_HW_D3D12::ClearDepthBuffer()
 {
+  if (!m_vram_depth_dirty_rect.Valid())
+    return;
+
   ID3D12GraphicsCommandList* cmdlist = g_d3d12_context->GetCommandList();
   cmdlist->ClearDepthStencilView(m_vram_depth_texture.GetRTVOrDSVDescriptor(), D3D12_CLEAR_FLAG_DEPTH,
                                  m_pgxp_depth_buffer ? 1.0f : 0.0f, 0, 0, nullptr);
+  m_vram_depth_dirty_rect.SetInvalid();
 }
 
 std::unique_ptr<GPU> GPU::CreateHardwareD3D12Renderer()
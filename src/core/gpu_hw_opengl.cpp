@@ -1,6 +1,7 @@
 #include "gpu_hw_opengl.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/pixel_conversion.h"
 #include "common/timer.h"
 #include "gpu_hw_shadergen.h"
 #include "host.h"
@@ -9,6 +10,7 @@
 #include "system.h"
 #include "texture_replacements.h"
 #include "util/state_wrapper.h"
+#include <limits>
 Log_SetChannel(GPU_HW_OpenGL);
 
 GPU_HW_OpenGL::GPU_HW_OpenGL() : GPU_HW() {}
@@ -75,6 +77,8 @@ bool GPU_HW_OpenGL::Initialize()
     return false;
   }
 
+  CreateSharedStreamBuffer();
+
   if (!CreateVertexBuffer())
   {
     Log_ErrorPrintf("Failed to create vertex buffer");
@@ -220,7 +224,7 @@ void GPU_HW_OpenGL::ResetGraphicsAPIState()
   glDisable(GL_SCISSOR_TEST);
   glDisable(GL_BLEND);
   glBindVertexArray(0);
-  m_uniform_stream_buffer->Unbind();
+  glBindBuffer(GL_UNIFORM_BUFFER, 0);
 }
 
 void GPU_HW_OpenGL::RestoreGraphicsAPIState()
@@ -233,7 +237,7 @@ void GPU_HW_OpenGL::RestoreGraphicsAPIState()
   glEnable(GL_SCISSOR_TEST);
   glDepthMask(GL_TRUE);
   glBindVertexArray(m_vao_id);
-  m_uniform_stream_buffer->Bind();
+  glBindBuffer(GL_UNIFORM_BUFFER, m_uniform_stream_buffer->GetGLBufferId());
   m_vram_read_texture.Bind();
   SetBlendMode();
   m_current_depth_test = 0;
@@ -246,8 +250,9 @@ void GPU_HW_OpenGL::UpdateSettings()
 {
   GPU_HW::UpdateSettings();
 
-  bool framebuffer_changed, shaders_changed;
-  UpdateHWSettings(&framebuffer_changed, &shaders_changed);
+  const u8 changes = UpdateHWSettings();
+  const bool framebuffer_changed = (changes & HW_SETTINGS_CHANGE_FRAMEBUFFER) != 0;
+  const bool shaders_changed = (changes & HW_SETTINGS_CHANGE_PIPELINES) != 0;
 
   if (framebuffer_changed)
   {
@@ -329,6 +334,7 @@ void GPU_HW_OpenGL::SetCapabilities()
     m_use_texture_buffer_for_vram_writes = false;
 #endif
   m_texture_stream_buffer_size = VRAM_UPDATE_TEXTURE_BUFFER_SIZE;
+  m_max_texture_stream_buffer_size = std::numeric_limits<u32>::max();
   if (m_use_texture_buffer_for_vram_writes)
   {
     GLint max_texel_buffer_size;
@@ -341,8 +347,9 @@ void GPU_HW_OpenGL::SetCapabilities()
     }
     else
     {
-      m_texture_stream_buffer_size =
-        std::min<u32>(VRAM_UPDATE_TEXTURE_BUFFER_SIZE, static_cast<u32>(max_texel_buffer_size) * sizeof(u16));
+      m_max_texture_stream_buffer_size = static_cast<u32>(
+        std::min<u64>(static_cast<u64>(max_texel_buffer_size) * sizeof(u16), std::numeric_limits<u32>::max()));
+      m_texture_stream_buffer_size = std::min<u32>(VRAM_UPDATE_TEXTURE_BUFFER_SIZE, m_max_texture_stream_buffer_size);
     }
   }
 
@@ -364,8 +371,9 @@ void GPU_HW_OpenGL::SetCapabilities()
     if (m_use_ssbo_for_vram_writes)
     {
       Log_InfoPrintf("Using shader storage buffers for VRAM writes.");
-      m_texture_stream_buffer_size =
-        static_cast<u32>(std::min<u64>(VRAM_UPDATE_TEXTURE_BUFFER_SIZE, static_cast<u64>(max_ssbo_size)));
+      m_max_texture_stream_buffer_size =
+        static_cast<u32>(std::min<u64>(static_cast<u64>(max_ssbo_size), std::numeric_limits<u32>::max()));
+      m_texture_stream_buffer_size = std::min<u32>(VRAM_UPDATE_TEXTURE_BUFFER_SIZE, m_max_texture_stream_buffer_size);
     }
     else
     {
@@ -382,6 +390,9 @@ void GPU_HW_OpenGL::SetCapabilities()
     (max_dual_source_draw_buffers > 0) &&
     (GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_blend_func_extended || GLAD_GL_EXT_blend_func_extended);
 
+  // Blending in the shader lets BG-FG and non-dual-source batches draw in a single pass.
+  m_supports_framebuffer_fetch = (GLAD_GL_EXT_shader_framebuffer_fetch != 0);
+
   // adaptive smoothing would require texture views, which aren't in GLES.
   m_supports_adaptive_downsampling = false;
 
@@ -452,9 +463,28 @@ void GPU_HW_OpenGL::ClearFramebuffer()
   SetFullVRAMDirtyRectangle();
 }
 
+void GPU_HW_OpenGL::CreateSharedStreamBuffer()
+{
+  // The whole buffer has to be addressable by the VRAM write shader, since the offset can be anywhere in it.
+  const u32 size = VERTEX_BUFFER_SIZE + UNIFORM_BUFFER_SIZE + m_texture_stream_buffer_size;
+  if (size > m_max_texture_stream_buffer_size)
+    return;
+
+  // Vertices, uniforms and VRAM writes are never mapped at the same time, so they can all come from one ring.
+  std::shared_ptr<GL::StreamBuffer> buffer = GL::StreamBuffer::Create(GL_ARRAY_BUFFER, size);
+  if (!buffer || !buffer->IsRingBuffer())
+    return;
+
+  Log_InfoPrintf("Using shared %u KB stream buffer for all uploads.", size / 1024u);
+  m_vertex_stream_buffer = buffer;
+  m_uniform_stream_buffer = buffer;
+  m_texture_stream_buffer = std::move(buffer);
+}
+
 bool GPU_HW_OpenGL::CreateVertexBuffer()
 {
-  m_vertex_stream_buffer = GL::StreamBuffer::Create(GL_ARRAY_BUFFER, VERTEX_BUFFER_SIZE);
+  if (!m_vertex_stream_buffer)
+    m_vertex_stream_buffer = GL::StreamBuffer::Create(GL_ARRAY_BUFFER, VERTEX_BUFFER_SIZE);
   if (!m_vertex_stream_buffer)
     return false;
 
@@ -483,7 +513,8 @@ bool GPU_HW_OpenGL::CreateVertexBuffer()
 
 bool GPU_HW_OpenGL::CreateUniformBuffer()
 {
-  m_uniform_stream_buffer = GL::StreamBuffer::Create(GL_UNIFORM_BUFFER, UNIFORM_BUFFER_SIZE);
+  if (!m_uniform_stream_buffer)
+    m_uniform_stream_buffer = GL::StreamBuffer::Create(GL_UNIFORM_BUFFER, UNIFORM_BUFFER_SIZE);
   if (!m_uniform_stream_buffer)
     return false;
 
@@ -495,7 +526,8 @@ bool GPU_HW_OpenGL::CreateTextureBuffer()
   const GLenum target =
     (m_use_ssbo_for_vram_writes ? GL_SHADER_STORAGE_BUFFER :
                                   (m_use_texture_buffer_for_vram_writes ? GL_TEXTURE_BUFFER : GL_PIXEL_UNPACK_BUFFER));
-  m_texture_stream_buffer = GL::StreamBuffer::Create(target, m_texture_stream_buffer_size);
+  if (!m_texture_stream_buffer)
+    m_texture_stream_buffer = GL::StreamBuffer::Create(target, m_texture_stream_buffer_size);
   if (!m_texture_stream_buffer)
     return false;
 
@@ -506,7 +538,7 @@ bool GPU_HW_OpenGL::CreateTextureBuffer()
     glTexBuffer(GL_TEXTURE_BUFFER, GL_R16UI, m_texture_stream_buffer->GetGLBufferId());
   }
 
-  m_texture_stream_buffer->Unbind();
+  glBindBuffer(target, 0);
   return true;
 }
 
@@ -518,10 +550,42 @@ bool GPU_HW_OpenGL::CompilePrograms()
   const bool use_binding_layout = GPU_HW_ShaderGen::UseGLSLBindingLayout();
   GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
                              m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend,
+                             m_supports_framebuffer_fetch);
 
   ShaderCompileProgressTracker progress("Compiling Programs", (4 * 9 * 2 * 2) + (2 * 3) + (2 * 2) + 1 + 1 + 1 + 1 + 1);
 
+  const auto get_batch_link_callback = [this, use_binding_layout](bool textured) {
+    return [this, textured, use_binding_layout](GL::Program& prog) {
+      if (!use_binding_layout)
+      {
+        prog.BindAttribute(0, "a_pos");
+        prog.BindAttribute(1, "a_col0");
+        if (textured)
+        {
+          prog.BindAttribute(2, "a_texcoord");
+          prog.BindAttribute(3, "a_texpage");
+          prog.BindAttribute(4, "a_uv_limits");
+        }
+
+        if (!IsGLES() || m_supports_dual_source_blend)
+        {
+          if (m_supports_dual_source_blend)
+          {
+            prog.BindFragDataIndexed(0, "o_col0");
+            prog.BindFragDataIndexed(1, "o_col1");
+          }
+          else
+          {
+            prog.BindFragData(0, "o_col0");
+          }
+        }
+      }
+    };
+  };
+
+  // Queue every batch program before waiting for any of them, so drivers with parallel shader compilation can work on
+  // all of them at once. This is a no-op otherwise.
   for (u32 render_mode = 0; render_mode < 4; render_mode++)
   {
     for (u32 texture_mode = 0; texture_mode < 9; texture_mode++)
@@ -531,39 +595,32 @@ bool GPU_HW_OpenGL::CompilePrograms()
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
           const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
-          const std::string batch_vs = shadergen.GenerateBatchVertexShader(textured);
           const std::string fs = shadergen.GenerateBatchFragmentShader(
             static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
             ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+          shader_cache.PrecompileProgram(shadergen.GenerateBatchVertexShader(textured), {}, fs,
+                                         get_batch_link_callback(textured));
+        }
+      }
+    }
+  }
 
-          const auto link_callback = [this, textured, use_binding_layout](GL::Program& prog) {
-            if (!use_binding_layout)
-            {
-              prog.BindAttribute(0, "a_pos");
-              prog.BindAttribute(1, "a_col0");
-              if (textured)
-              {
-                prog.BindAttribute(2, "a_texcoord");
-                prog.BindAttribute(3, "a_texpage");
-                prog.BindAttribute(4, "a_uv_limits");
-              }
-
-              if (!IsGLES() || m_supports_dual_source_blend)
-              {
-                if (m_supports_dual_source_blend)
-                {
-                  prog.BindFragDataIndexed(0, "o_col0");
-                  prog.BindFragDataIndexed(1, "o_col1");
-                }
-                else
-                {
-                  prog.BindFragData(0, "o_col0");
-                }
-              }
-            }
-          };
+  for (u32 render_mode = 0; render_mode < 4; render_mode++)
+  {
+    for (u32 texture_mode = 0; texture_mode < 9; texture_mode++)
+    {
+      for (u8 dithering = 0; dithering < 2; dithering++)
+      {
+        for (u8 interlacing = 0; interlacing < 2; interlacing++)
+        {
+          const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+          const std::string batch_vs = shadergen.GenerateBatchVertexShader(textured);
+          const std::string fs = shadergen.GenerateBatchFragmentShader(
+            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
 
-          std::optional<GL::Program> prog = shader_cache.GetProgram(batch_vs, {}, fs, link_callback);
+          std::optional<GL::Program> prog =
+            shader_cache.GetProgram(batch_vs, {}, fs, get_batch_link_callback(textured));
           if (!prog)
             return false;
 
@@ -748,7 +805,8 @@ void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vert
 
 void GPU_HW_OpenGL::SetBlendMode()
 {
-  if (UseAlphaBlending(m_current_transparency_mode, m_current_render_mode))
+  // The batch shaders do the blending themselves when using framebuffer fetch.
+  if (!m_supports_framebuffer_fetch && UseAlphaBlending(m_current_transparency_mode, m_current_render_mode))
   {
     glEnable(GL_BLEND);
     glBlendEquationSeparate(m_current_transparency_mode == GPUTransparencyMode::BackgroundMinusForeground ?
@@ -833,6 +891,9 @@ void GPU_HW_OpenGL::SetScissorFromDrawingArea()
 
 void GPU_HW_OpenGL::UploadUniformBuffer(const void* data, u32 data_size)
 {
+  // the shared stream buffer can only have one mapping open at a time
+  DebugAssert(!m_batch_start_vertex_ptr || m_uniform_stream_buffer != m_vertex_stream_buffer);
+
   const GL::StreamBuffer::MappingResult res = m_uniform_stream_buffer->Map(m_uniform_buffer_alignment, data_size);
   std::memcpy(res.pointer, data, data_size);
   m_uniform_stream_buffer->Unmap(data_size);
@@ -858,6 +919,7 @@ void GPU_HW_OpenGL::ClearDisplay()
 
 void GPU_HW_OpenGL::UpdateDisplay()
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::Display);
   GPU_HW::UpdateDisplay();
 
   if (g_settings.debugging.show_vram)
@@ -969,17 +1031,19 @@ void GPU_HW_OpenGL::UpdateDisplay()
 
 void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
-  if (IsUsingSoftwareRendererForReadbacks())
-  {
-    ReadSoftwareRendererVRAM(x, y, width, height);
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
+  if (IsUsingSoftwareRendererForReadbacks() && ReadSoftwareRendererVRAM(&x, &y, &width, &height))
     return;
-  }
 
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
+  // Nothing has been drawn to this area since it was last read back, so the shadow copy is current.
+  if (!IsVRAMReadbackRequired(copy_rect))
+    return;
+
   // Encode the 24-bit texture as 16-bit.
   const u32 uniforms[4] = {copy_rect.left, copy_rect.top, copy_rect.GetWidth(), copy_rect.GetHeight()};
   m_vram_encoding_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
@@ -1000,11 +1064,13 @@ void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
                &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
   glPixelStorei(GL_PACK_ALIGNMENT, 4);
   glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+  VRAMReadbackCompleted(copy_rect);
   RestoreGraphicsAPIState();
 }
 
 void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   if (IsUsingSoftwareRendererForReadbacks())
     FillSoftwareRendererVRAM(x, y, width, height, color);
 
@@ -1043,6 +1109,7 @@ void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 
 void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   if (IsUsingSoftwareRendererForReadbacks())
     UpdateSoftwareRendererVRAM(x, y, width, height, data, set_mask, check_mask);
 
@@ -1065,7 +1132,6 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     const auto map_result = m_texture_stream_buffer->Map(sizeof(u16), num_pixels * sizeof(u16));
     std::memcpy(map_result.pointer, data, num_pixels * sizeof(u16));
     m_texture_stream_buffer->Unmap(num_pixels * sizeof(u16));
-    m_texture_stream_buffer->Unbind();
 
     glDisable(GL_BLEND);
     SetDepthFunc((check_mask && !m_pgxp_depth_buffer) ? GL_GEQUAL : GL_ALWAYS);
@@ -1106,25 +1172,17 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 
     const u32 source_stride = width * sizeof(u16);
     const u8* source_ptr = static_cast<const u8*>(data);
-    const u16 mask_or = set_mask ? 0x8000 : 0x0000;
+    const u32 alpha_or = set_mask ? 0xFF000000u : 0u;
     u32* dest_ptr = static_cast<u32*>(map_result.pointer);
     for (u32 row = 0; row < height; row++)
     {
-      const u8* source_row_ptr = source_ptr;
-
-      for (u32 col = 0; col < width; col++)
-      {
-        u16 src_col;
-        std::memcpy(&src_col, source_row_ptr, sizeof(src_col));
-        source_row_ptr += sizeof(src_col);
-        *(dest_ptr++) = VRAMRGBA5551ToRGBA8888(src_col | mask_or);
-      }
-
+      PixelConversion::ConvertRGBA5551ToRGBA8(dest_ptr, source_ptr, width, alpha_or);
       source_ptr += source_stride;
+      dest_ptr += width;
     }
 
     m_texture_stream_buffer->Unmap(num_pixels * sizeof(u32));
-    m_texture_stream_buffer->Bind();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_texture_stream_buffer->GetGLBufferId());
 
     // have to write to the 1x texture first
     if (m_resolution_scale > 1)
@@ -1135,7 +1193,7 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     // update texture data
     glTexSubImage2D(m_vram_texture.GetGLTarget(), 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
                     reinterpret_cast<void*>(static_cast<uintptr_t>(map_result.buffer_offset)));
-    m_texture_stream_buffer->Unbind();
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     if (m_resolution_scale > 1)
     {
@@ -1155,14 +1213,26 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 
 void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  // Copies between overlapping regions of one texture are undefined, so those come from the read texture instead.
+  // That can't be copied to multisampled VRAM, and API copies can't wrap around, so oversized copies are split up.
+  const bool overlapping = Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)
+                             .Intersects(Common::Rectangle<u32>::FromExtents(dst_x, dst_y, width, height));
+  const bool use_shader = (UseVRAMCopyShader() || (overlapping && IsUsingMultisampling()));
+  if (!use_shader && IsVRAMCopyOversized(src_x, src_y, dst_x, dst_y, width, height))
+  {
+    CopyOversizedVRAM(src_x, src_y, dst_x, dst_y, width, height);
+    return;
+  }
+
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   if (IsUsingSoftwareRendererForReadbacks())
     CopySoftwareRendererVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
   const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
   const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
-  const bool src_dirty = m_vram_dirty_rect.Intersects(src_bounds);
+  const bool src_dirty = IsVRAMAreaDirty(src_bounds);
 
-  if (UseVRAMCopyShader(src_x, src_y, dst_x, dst_y, width, height))
+  if (use_shader)
   {
     if (src_dirty)
       UpdateVRAMReadTexture();
@@ -1191,6 +1261,13 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
     return;
   }
 
+  // glBlitFramebufer with same source/destination should be legal, but on Mali (at least Bifrost) it breaks.
+  // So, blits come from the shadow texture like in the other renderers, as do overlapping copies.
+  const bool use_read_texture =
+    (overlapping || (!GLAD_GL_VERSION_4_3 && !GLAD_GL_EXT_copy_image && !GLAD_GL_OES_copy_image));
+  if (use_read_texture && src_dirty)
+    UpdateVRAMReadTexture();
+
   GPU_HW::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
   src_x *= m_resolution_scale;
@@ -1200,28 +1277,24 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   width *= m_resolution_scale;
   height *= m_resolution_scale;
 
+  const GL::Texture& src_texture = use_read_texture ? m_vram_read_texture : m_vram_texture;
   if (GLAD_GL_VERSION_4_3)
   {
-    glCopyImageSubData(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, src_x, src_y, 0,
-                       m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, dst_x, dst_y, 0, width, height, 1);
+    glCopyImageSubData(src_texture.GetGLId(), src_texture.GetGLTarget(), 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
+                       m_vram_texture.GetGLTarget(), 0, dst_x, dst_y, 0, width, height, 1);
   }
   else if (GLAD_GL_EXT_copy_image)
   {
-    glCopyImageSubDataEXT(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, src_x, src_y, 0,
+    glCopyImageSubDataEXT(src_texture.GetGLId(), src_texture.GetGLTarget(), 0, src_x, src_y, 0,
                           m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, dst_x, dst_y, 0, width, height, 1);
   }
   else if (GLAD_GL_OES_copy_image)
   {
-    glCopyImageSubDataOES(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, src_x, src_y, 0,
+    glCopyImageSubDataOES(src_texture.GetGLId(), src_texture.GetGLTarget(), 0, src_x, src_y, 0,
                           m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, dst_x, dst_y, 0, width, height, 1);
   }
   else
   {
-    // glBlitFramebufer with same source/destination should be legal, but on Mali (at least Bifrost) it breaks.
-    // So, blit from the shadow texture, like in the other renderers.
-    if (src_dirty)
-      UpdateVRAMReadTexture();
-
     glDisable(GL_SCISSOR_TEST);
     m_vram_read_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
     glBlitFramebuffer(src_x, src_y, src_x + width, src_y + height, dst_x, dst_y, dst_x + width, dst_y + height,
@@ -1234,34 +1307,47 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
 
 void GPU_HW_OpenGL::UpdateVRAMReadTexture()
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
-  const u32 width = scaled_rect.GetWidth();
-  const u32 height = scaled_rect.GetHeight();
-  const u32 x = scaled_rect.left;
-  const u32 y = scaled_rect.top;
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   const bool multisampled = m_vram_texture.IsMultisampled();
-
-  if (!multisampled && GLAD_GL_VERSION_4_3)
+  const bool use_blit = (multisampled || (!GLAD_GL_VERSION_4_3 && !GLAD_GL_EXT_copy_image && !GLAD_GL_OES_copy_image));
+  if (use_blit)
   {
-    glCopyImageSubData(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0,
-                       m_vram_read_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0, width, height, 1);
-  }
-  else if (!multisampled && GLAD_GL_EXT_copy_image)
-  {
-    glCopyImageSubDataEXT(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0,
-                          m_vram_read_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0, width, height, 1);
+    m_vram_read_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
+    glDisable(GL_SCISSOR_TEST);
   }
-  else if (!multisampled && GLAD_GL_OES_copy_image)
+
+  for (const Common::Rectangle<u32>& area : GetVRAMDirtyAreas())
   {
-    glCopyImageSubDataOES(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0,
-                          m_vram_read_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0, width, height, 1);
+    const auto scaled_rect = area * m_resolution_scale;
+    const u32 width = scaled_rect.GetWidth();
+    const u32 height = scaled_rect.GetHeight();
+    const u32 x = scaled_rect.left;
+    const u32 y = scaled_rect.top;
+
+    if (use_blit)
+    {
+      glBlitFramebuffer(x, y, x + width, y + height, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    else if (GLAD_GL_VERSION_4_3)
+    {
+      glCopyImageSubData(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0,
+                         m_vram_read_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0, width, height, 1);
+    }
+    else if (GLAD_GL_EXT_copy_image)
+    {
+      glCopyImageSubDataEXT(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0,
+                            m_vram_read_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0, width, height, 1);
+    }
+    else
+    {
+      glCopyImageSubDataOES(m_vram_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0,
+                            m_vram_read_texture.GetGLId(), m_vram_texture.GetGLTarget(), 0, x, y, 0, width, height, 1);
+    }
   }
-  else
+
+  if (use_blit)
   {
-    m_vram_read_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
-    glDisable(GL_SCISSOR_TEST);
-    glBlitFramebuffer(x, y, x + width, y + height, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
     glEnable(GL_SCISSOR_TEST);
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
   }
@@ -1271,10 +1357,11 @@ void GPU_HW_OpenGL::UpdateVRAMReadTexture()
 
 void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit()
 {
-  if (m_pgxp_depth_buffer)
+  if (m_pgxp_depth_buffer || !m_vram_depth_dirty_rect.Valid())
     return;
 
-  glDisable(GL_SCISSOR_TEST);
+  const Common::Rectangle<u32> scaled_rect(m_vram_depth_dirty_rect * m_resolution_scale);
+  glScissor(scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
   glDisable(GL_BLEND);
   glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
   glDepthFunc(GL_ALWAYS);
@@ -1286,22 +1373,28 @@ void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit()
 
   glBindVertexArray(m_vao_id);
   glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-  glEnable(GL_SCISSOR_TEST);
+  SetScissorFromDrawingArea();
 
   m_vram_read_texture.Bind();
+  m_vram_depth_dirty_rect.SetInvalid();
 }
 
 void GPU_HW_OpenGL::ClearDepthBuffer()
 {
+  m_last_depth_z = 1.0f;
+  if (!m_vram_depth_dirty_rect.Valid())
+    return;
+
   glDisable(GL_SCISSOR_TEST);
   IsGLES() ? glClearDepthf(1.0f) : glClearDepth(1.0f);
   glClear(GL_DEPTH_BUFFER_BIT);
   glEnable(GL_SCISSOR_TEST);
-  m_last_depth_z = 1.0f;
+  m_vram_depth_dirty_rect.SetInvalid();
 }
 
 void GPU_HW_OpenGL::DownsampleFramebuffer(GL::Texture& source, u32 left, u32 top, u32 width, u32 height)
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::Downsample);
   DebugAssert(m_downsample_mode != GPUDownsampleMode::Adaptive);
   DownsampleFramebufferBoxFilter(source, left, top, width, height);
 }
@@ -61,6 +61,7 @@ private:
   void CopyFramebufferForState(GLenum target, GLuint src_texture, u32 src_fbo, u32 src_x, u32 src_y, GLuint dst_texture,
                                u32 dst_fbo, u32 dst_x, u32 dst_y, u32 width, u32 height);
 
+  void CreateSharedStreamBuffer();
   bool CreateVertexBuffer();
   bool CreateUniformBuffer();
   bool CreateTextureBuffer();
@@ -83,15 +84,16 @@ private:
   GL::Texture m_display_texture;
   GL::Texture m_vram_write_replacement_texture;
 
-  std::unique_ptr<GL::StreamBuffer> m_vertex_stream_buffer;
+  // These point to the same buffer when it is a ring buffer shared by all uploads.
+  std::shared_ptr<GL::StreamBuffer> m_vertex_stream_buffer;
   GLuint m_vram_fbo_id = 0;
   GLuint m_vao_id = 0;
   GLuint m_attributeless_vao_id = 0;
   GLuint m_state_copy_fbo_id = 0;
 
-  std::unique_ptr<GL::StreamBuffer> m_uniform_stream_buffer;
+  std::shared_ptr<GL::StreamBuffer> m_uniform_stream_buffer;
 
-  std::unique_ptr<GL::StreamBuffer> m_texture_stream_buffer;
+  std::shared_ptr<GL::StreamBuffer> m_texture_stream_buffer;
   GLuint m_texture_buffer_r16ui_texture = 0;
 
   std::array<std::array<std::array<std::array<GL::Program, 2>, 2>, 9>, 4>
@@ -105,6 +107,7 @@ private:
 
   u32 m_uniform_buffer_alignment = 1;
   u32 m_texture_stream_buffer_size = 0;
+  u32 m_max_texture_stream_buffer_size = 0;
 
   bool m_use_texture_buffer_for_vram_writes = false;
   bool m_use_ssbo_for_vram_writes = false;
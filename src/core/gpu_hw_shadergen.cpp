@@ -5,8 +5,9 @@
 GPU_HW_ShaderGen::GPU_HW_ShaderGen(RenderAPI render_api, u32 resolution_scale, u32 multisamples,
                                    bool per_sample_shading, bool true_color, bool scaled_dithering,
                                    GPUTextureFilter texture_filtering, bool uv_limits, bool pgxp_depth,
-                                   bool disable_color_perspective, bool supports_dual_source_blend)
-  : ShaderGen(render_api, supports_dual_source_blend), m_resolution_scale(resolution_scale),
+                                   bool disable_color_perspective, bool supports_dual_source_blend,
+                                   bool supports_framebuffer_fetch /* = false */)
+  : ShaderGen(render_api, supports_dual_source_blend, supports_framebuffer_fetch), m_resolution_scale(resolution_scale),
     m_multisamples(multisamples), m_per_sample_shading(per_sample_shading), m_true_color(true_color),
     m_scaled_dithering(scaled_dithering), m_texture_filter(texture_filtering), m_uv_limits(uv_limits),
     m_pgxp_depth(pgxp_depth), m_disable_color_perspective(disable_color_perspective)
@@ -55,13 +56,16 @@ void GPU_HW_ShaderGen::WriteBatchUniformBuffer(std::stringstream& ss)
                        false);
 }
 
-std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
+std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured, bool decoded_texture_cache,
+                                                        bool dynamic_texture_mode)
 {
   std::stringstream ss;
   WriteHeader(ss);
   DefineMacro(ss, "TEXTURED", textured);
   DefineMacro(ss, "UV_LIMITS", m_uv_limits);
   DefineMacro(ss, "PGXP_DEPTH", m_pgxp_depth);
+  DefineMacro(ss, "DECODED_TEXTURE_CACHE", decoded_texture_cache);
+  DefineMacro(ss, "DYNAMIC_TEXTURE_MODE", dynamic_texture_mode);
 
   WriteCommonFunctions(ss);
   WriteBatchUniformBuffer(ss);
@@ -131,6 +135,20 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
     v_texpage.z = ((a_texpage >> 16) & 63u) * 16u * RESOLUTION_SCALE;
     v_texpage.w = ((a_texpage >> 22) & 511u) * RESOLUTION_SCALE;
 
+    #if DECODED_TEXTURE_CACHE
+      // Pages in the decoded texture cache carry their atlas slot instead of the palette.
+      if ((a_texpage & 0x8000u) != 0u)
+      {
+        uint slot = (a_texpage >> 16) & 63u;
+        v_texpage = uint4((slot & 7u) * 256u, (slot >> 3) * 256u, 0xFFFFFFFFu, 0u);
+      }
+    #endif
+
+    #if DYNAMIC_TEXTURE_MODE
+      // Batches mixing texture modes carry the mode and raw texture bit above the palette row.
+      v_texpage.w |= (((a_texpage >> 7) & 3u) << 16) | (((a_texpage >> 14) & 1u) << 18);
+    #endif
+
     #if UV_LIMITS
       v_uv_limits = a_uv_limits * float4(255.0, 255.0, 255.0, 255.0);
     #endif
@@ -627,15 +645,21 @@ void FilteredSampleFromVRAM(uint4 texpage, float2 coords, float4 uv_limits,
 }
 
 std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMode transparency,
-                                                          GPUTextureMode texture_mode, bool dithering, bool interlacing)
+                                                          GPUTextureMode texture_mode, bool dithering, bool interlacing,
+                                                          bool decoded_texture_cache)
 {
   const GPUTextureMode actual_texture_mode = texture_mode & ~GPUTextureMode::RawTextureBit;
-  const bool raw_texture = (texture_mode & GPUTextureMode::RawTextureBit) == GPUTextureMode::RawTextureBit;
+  const bool dynamic_texture_mode = (texture_mode == GPUTextureMode::Dynamic);
+  const bool raw_texture =
+    !dynamic_texture_mode && (texture_mode & GPUTextureMode::RawTextureBit) == GPUTextureMode::RawTextureBit;
+  const bool palette =
+    actual_texture_mode == GPUTextureMode::Palette4Bit || actual_texture_mode == GPUTextureMode::Palette8Bit;
   const bool textured = (texture_mode != GPUTextureMode::Disabled);
-  const bool use_dual_source =
-    m_supports_dual_source_blend && ((transparency != GPU_HW::BatchRenderMode::TransparencyDisabled &&
-                                      transparency != GPU_HW::BatchRenderMode::OnlyOpaque) ||
-                                     m_texture_filter != GPUTextureFilter::Nearest);
+  const bool needs_blending = ((transparency != GPU_HW::BatchRenderMode::TransparencyDisabled &&
+                                transparency != GPU_HW::BatchRenderMode::OnlyOpaque) ||
+                               m_texture_filter != GPUTextureFilter::Nearest);
+  const bool use_framebuffer_fetch = m_supports_framebuffer_fetch && needs_blending;
+  const bool use_dual_source = m_supports_dual_source_blend && !use_framebuffer_fetch && needs_blending;
 
   std::stringstream ss;
   WriteHeader(ss);
@@ -643,23 +667,40 @@ std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMod
   DefineMacro(ss, "TRANSPARENCY_ONLY_OPAQUE", transparency == GPU_HW::BatchRenderMode::OnlyOpaque);
   DefineMacro(ss, "TRANSPARENCY_ONLY_TRANSPARENT", transparency == GPU_HW::BatchRenderMode::OnlyTransparent);
   DefineMacro(ss, "TEXTURED", textured);
-  DefineMacro(ss, "PALETTE",
-              actual_texture_mode == GPUTextureMode::Palette4Bit || actual_texture_mode == GPUTextureMode::Palette8Bit);
+  DefineMacro(ss, "PALETTE", palette);
   DefineMacro(ss, "PALETTE_4_BIT", actual_texture_mode == GPUTextureMode::Palette4Bit);
   DefineMacro(ss, "PALETTE_8_BIT", actual_texture_mode == GPUTextureMode::Palette8Bit);
   DefineMacro(ss, "RAW_TEXTURE", raw_texture);
-  DefineMacro(ss, "DITHERING", dithering);
+  DefineMacro(ss, "DYNAMIC_TEXTURE_MODE", dynamic_texture_mode);
   DefineMacro(ss, "DITHERING_SCALED", m_scaled_dithering);
-  DefineMacro(ss, "INTERLACING", interlacing);
   DefineMacro(ss, "TRUE_COLOR", m_true_color);
   DefineMacro(ss, "TEXTURE_FILTERING", m_texture_filter != GPUTextureFilter::Nearest);
   DefineMacro(ss, "UV_LIMITS", m_uv_limits);
   DefineMacro(ss, "USE_DUAL_SOURCE", use_dual_source);
+  DefineMacro(ss, "USE_FRAMEBUFFER_FETCH", use_framebuffer_fetch);
   DefineMacro(ss, "PGXP_DEPTH", m_pgxp_depth);
+  DefineMacro(ss, "DECODED_TEXTURE_CACHE", decoded_texture_cache);
+
+  DeclareSpecializationConstant(ss, "DITHERING", BATCH_SPEC_CONSTANT_DITHERING, dithering);
+  DeclareSpecializationConstant(ss, "INTERLACING", BATCH_SPEC_CONSTANT_INTERLACING, interlacing);
+
+  // Dynamic batches read these from the bits the vertex shader packs above the palette row.
+  if (dynamic_texture_mode)
+  {
+    ss << "#define TEXPAGE_IS_PALETTE(texpage) ((((texpage).w >> 16) & 3u) < 2u)\n";
+    ss << "#define TEXPAGE_IS_RAW_TEXTURE(texpage) ((((texpage).w >> 18) & 1u) != 0u)\n";
+  }
+  else
+  {
+    ss << "#define TEXPAGE_IS_PALETTE(texpage) " << (palette ? "true" : "false") << "\n";
+    ss << "#define TEXPAGE_IS_RAW_TEXTURE(texpage) " << (raw_texture ? "true" : "false") << "\n";
+  }
 
   WriteCommonFunctions(ss);
   WriteBatchUniformBuffer(ss);
   DeclareTexture(ss, "samp0", 0);
+  if (decoded_texture_cache)
+    DeclareTexture(ss, "samp1", 1);
 
   if (m_glsl)
     ss << "CONSTANT int[16] s_dither_values = int[16]( ";
@@ -719,8 +760,37 @@ uint2 FloatToIntegerCoords(float2 coords)
 
 float4 SampleFromVRAM(uint4 texpage, float2 coords)
 {
-  #if PALETTE
+  #if DYNAMIC_TEXTURE_MODE
+    uint texture_mode = (texpage.w >> 16) & 3u;
+    if (texture_mode >= 2u)
+    {
+      uint2 direct_icoord = texpage.xy + ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));
+      return SAMPLE_TEXTURE(samp0, float2(direct_icoord) * RCP_VRAM_SIZE);
+    }
+
     uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
+    #if DECODED_TEXTURE_CACHE
+      if (texpage.z == 0xFFFFFFFFu)
+        return LOAD_TEXTURE(samp1, int2(texpage.xy + icoord), 0);
+    #endif
+
+    // 4-bit pages hold four indices per VRAM pixel, 8-bit pages two.
+    uint index_shift = 2u - texture_mode;
+    uint index_bits = 4u << texture_mode;
+    uint2 vicoord = texpage.xy + (uint2(icoord.x >> index_shift, icoord.y) * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
+    uint vram_value = RGBA8ToRGBA5551(SAMPLE_TEXTURE(samp0, float2(vicoord) * RCP_VRAM_SIZE));
+    uint subpixel = icoord.x & ((1u << index_shift) - 1u);
+    uint palette_index = (vram_value >> (subpixel * index_bits)) & ((1u << index_bits) - 1u);
+
+    uint2 palette_icoord = uint2(texpage.z + (palette_index * RESOLUTION_SCALE), texpage.w & 0xFFFFu);
+    return SAMPLE_TEXTURE(samp0, float2(palette_icoord) * RCP_VRAM_SIZE);
+  #elif PALETTE
+    uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
+    #if DECODED_TEXTURE_CACHE
+      if (texpage.z == 0xFFFFFFFFu)
+        return LOAD_TEXTURE(samp1, int2(texpage.xy + icoord), 0);
+    #endif
+
     uint2 index_coord = icoord;
     #if PALETTE_4_BIT
       index_coord.x /= 4u;
@@ -768,19 +838,19 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
       DeclareFragmentEntryPoint(ss, 1, 1,
                                 {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "float4 v_uv_limits"}},
                                 true, use_dual_source ? 2 : 1, !m_pgxp_depth, UsingMSAA(), UsingPerSampleShading(),
-                                false, m_disable_color_perspective);
+                                false, m_disable_color_perspective, use_framebuffer_fetch);
     }
     else
     {
       DeclareFragmentEntryPoint(ss, 1, 1, {{"nointerpolation", "uint4 v_texpage"}}, true, use_dual_source ? 2 : 1,
                                 !m_pgxp_depth, UsingMSAA(), UsingPerSampleShading(), false,
-                                m_disable_color_perspective);
+                                m_disable_color_perspective, use_framebuffer_fetch);
     }
   }
   else
   {
     DeclareFragmentEntryPoint(ss, 1, 0, {}, true, use_dual_source ? 2 : 1, !m_pgxp_depth, UsingMSAA(),
-                              UsingPerSampleShading(), false, m_disable_color_perspective);
+                              UsingPerSampleShading(), false, m_disable_color_perspective, use_framebuffer_fetch);
   }
 
   ss << R"(
@@ -792,28 +862,26 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
   float ialpha;
   float oalpha;
 
-  #if INTERLACING
-    if ((uint(v_pos.y) & 1u) == u_interlaced_displayed_field)
-      discard;
-  #endif
+  if (INTERLACING && (uint(v_pos.y) & 1u) == u_interlaced_displayed_field)
+    discard;
 
   #if TEXTURED
 
     // We can't currently use upscaled coordinate for palettes because of how they're packed.
     // Not that it would be any benefit anyway, render-to-texture effects don't use palettes.
     float2 coords = v_tex0;
-    #if PALETTE
+    if (TEXPAGE_IS_PALETTE(v_texpage))
       coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
-    #endif
 
     #if UV_LIMITS
       float4 uv_limits = v_uv_limits;
-      #if !PALETTE
+      if (!TEXPAGE_IS_PALETTE(v_texpage))
+      {
         // Extend the UV range to all "upscaled" pixels. This means 1-pixel-high polygon-based 
         // framebuffer effects won't be downsampled. (e.g. Mega Man Legends 2 haze effect)
         uv_limits *= float(RESOLUTION_SCALE);
         uv_limits.zw += float(RESOLUTION_SCALE - 1u);
-      #endif
+      }
     #endif
 
     float4 texcol;
@@ -838,24 +906,24 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     // If not using true color, truncate the framebuffer colors to 5-bit.
     #if !TRUE_COLOR
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0)) >> 3;
-      #if !RAW_TEXTURE
+      if (!TEXPAGE_IS_RAW_TEXTURE(v_texpage))
+      {
         icolor = (icolor * vertcol) >> 4;
-        #if DITHERING
+        if (DITHERING)
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-        #else
+        else
           icolor = min(icolor >> 3, uint3(31u, 31u, 31u));
-        #endif
-      #endif
+      }
     #else
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0));
-      #if !RAW_TEXTURE
+      if (!TEXPAGE_IS_RAW_TEXTURE(v_texpage))
+      {
         icolor = (icolor * vertcol) >> 7;
-        #if DITHERING
+        if (DITHERING)
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-        #else
+        else
           icolor = min(icolor, uint3(255u, 255u, 255u));
-        #endif
-      #endif
+      }
     #endif
 
     // Compute output alpha (mask bit)
@@ -866,12 +934,11 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     icolor = vertcol;
     ialpha = 1.0;
 
-    #if DITHERING
+    if (DITHERING)
       icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-    #else
-      #if !TRUE_COLOR
-        icolor >>= 3;
-      #endif
+    #if !TRUE_COLOR
+    else
+      icolor >>= 3;
     #endif
 
     // However, the mask bit is cleared if set mask bit is false.
@@ -894,6 +961,11 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     color = (float3(icolor) * premultiply_alpha) / float3(255.0, 255.0, 255.0);
   #endif
 
+  #if USE_FRAMEBUFFER_FETCH
+    // Blend against the current framebuffer contents ourselves, the source factor is negative for BG-FG.
+    float3 dst_color = o_col0.rgb;
+  #endif
+
   #if TRANSPARENCY && TEXTURED
     // Apply semitransparency. If not a semitransparent texel, destination alpha is ignored.
     if (semitransparent)
@@ -901,6 +973,8 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
       #if USE_DUAL_SOURCE
         o_col0 = float4(color, oalpha);
         o_col1 = float4(0.0, 0.0, 0.0, u_dst_alpha_factor / ialpha);
+      #elif USE_FRAMEBUFFER_FETCH
+        o_col0 = float4(clamp(color + dst_color * (u_dst_alpha_factor / ialpha), 0.0, 1.0), oalpha);
       #else
         o_col0 = float4(color, oalpha);
       #endif
@@ -918,6 +992,8 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
       #if USE_DUAL_SOURCE
         o_col0 = float4(color, oalpha);
         o_col1 = float4(0.0, 0.0, 0.0, 1.0 - ialpha);
+      #elif USE_FRAMEBUFFER_FETCH
+        o_col0 = float4(color + dst_color * (1.0 - ialpha), oalpha);
       #else
         o_col0 = float4(color, oalpha);
       #endif
@@ -935,6 +1011,8 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     #if USE_DUAL_SOURCE
       o_col0 = float4(color, oalpha);
       o_col1 = float4(0.0, 0.0, 0.0, u_dst_alpha_factor / ialpha);
+    #elif USE_FRAMEBUFFER_FETCH
+      o_col0 = float4(clamp(color + dst_color * (u_dst_alpha_factor / ialpha), 0.0, 1.0), oalpha);
     #else
       o_col0 = float4(color, oalpha);
     #endif
@@ -944,7 +1022,11 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     #endif
   #else
     // Non-transparency won't enable blending so we can write the mask here regardless.
-    o_col0 = float4(color, oalpha);
+    #if USE_FRAMEBUFFER_FETCH
+      o_col0 = float4(color + dst_color * (1.0 - ialpha), oalpha);
+    #else
+      o_col0 = float4(color, oalpha);
+    #endif
 
     #if USE_DUAL_SOURCE
       o_col1 = float4(0.0, 0.0, 0.0, 1.0 - ialpha);
@@ -1324,15 +1406,47 @@ std::string GPU_HW_ShaderGen::GenerateVRAMUpdateDepthFragmentShader()
   return ss.str();
 }
 
-std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleMipFragmentShader(bool first_pass)
+std::string GPU_HW_ShaderGen::GenerateDecodeTexturePageFragmentShader(GPUTextureMode texture_mode)
 {
   std::stringstream ss;
   WriteHeader(ss);
+  DefineMacro(ss, "PALETTE_4_BIT", texture_mode == GPUTextureMode::Palette4Bit);
+  DefineMacro(ss, "PALETTE_8_BIT", texture_mode == GPUTextureMode::Palette8Bit);
   WriteCommonFunctions(ss);
-  DeclareTexture(ss, "samp0", 0, false);
-  DeclareUniformBuffer(ss, {"float2 u_uv_min", "float2 u_uv_max", "float2 u_rcp_resolution"}, true);
-  DefineMacro(ss, "FIRST_PASS", first_pass);
+  DeclareUniformBuffer(ss, {"uint4 u_texpage", "uint2 u_slot_origin"}, true);
+  DeclareTexture(ss, "samp0", 0);
+  DeclareFragmentEntryPoint(ss, 0, 1, {}, true, 1);
 
+  // Same lookup as SampleFromVRAM() in the batch shader, once per texel of the page.
+  ss << R"(
+{
+  uint2 icoord = uint2(v_pos.xy) - u_slot_origin;
+  uint2 index_coord = icoord;
+  #if PALETTE_4_BIT
+    index_coord.x /= 4u;
+  #elif PALETTE_8_BIT
+    index_coord.x /= 2u;
+  #endif
+
+  uint2 vicoord = u_texpage.xy + (index_coord * uint2(RESOLUTION_SCALE, RESOLUTION_SCALE));
+  uint vram_value = RGBA8ToRGBA5551(SAMPLE_TEXTURE(samp0, float2(vicoord) * RCP_VRAM_SIZE));
+
+  #if PALETTE_4_BIT
+    uint palette_index = (vram_value >> ((icoord.x & 3u) * 4u)) & 0x0Fu;
+  #elif PALETTE_8_BIT
+    uint palette_index = (vram_value >> ((icoord.x & 1u) * 8u)) & 0xFFu;
+  #endif
+
+  uint2 palette_icoord = uint2(u_texpage.z + (palette_index * RESOLUTION_SCALE), u_texpage.w);
+  o_col0 = SAMPLE_TEXTURE(samp0, float2(palette_icoord) * RCP_VRAM_SIZE);
+}
+)";
+
+  return ss.str();
+}
+
+void GPU_HW_ShaderGen::WriteAdaptiveDownsampleBiasFunctions(std::stringstream& ss)
+{
   // mipmap_energy.glsl ported from parallel-rsx.
   ss << R"(
 
@@ -1359,6 +1473,17 @@ float4 get_bias(float4 c00, float4 c01, float4 c10, float4 c11)
 }
 
 )";
+}
+
+std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleMipFragmentShader(bool first_pass)
+{
+  std::stringstream ss;
+  WriteHeader(ss);
+  WriteCommonFunctions(ss);
+  DeclareTexture(ss, "samp0", 0, false);
+  DeclareUniformBuffer(ss, {"float2 u_uv_min", "float2 u_uv_max", "float2 u_rcp_resolution"}, true);
+  DefineMacro(ss, "FIRST_PASS", first_pass);
+  WriteAdaptiveDownsampleBiasFunctions(ss);
 
   DeclareFragmentEntryPoint(ss, 0, 1, {}, false, 1, false, false, false, false);
   ss << R"(
@@ -1383,6 +1508,112 @@ float4 get_bias(float4 c00, float4 c01, float4 c10, float4 c11)
   return ss.str();
 }
 
+std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleMipComputeShader(u32 levels)
+{
+  std::stringstream ss;
+  WriteHeader(ss);
+  WriteCommonFunctions(ss);
+  DeclareTexture(ss, "samp0", 0, false);
+  DeclareUniformBuffer(ss, {"uint4 u_rect", "uint2 u_base"}, true);
+  WriteAdaptiveDownsampleBiasFunctions(ss);
+
+  ss << "CONSTANT uint MIP_LEVELS = " << levels << "u;\n";
+  ss << "CONSTANT uint TILE_SIZE = " << static_cast<u32>(GPU_HW::SMOOTHING_COMPUTE_TILE_SIZE) << "u;\n";
+
+  // Each mip below the base gets its own storage image, mip 0 is only ever read through samp0.
+  for (u32 level = 1; level < levels; level++)
+  {
+    if (m_glsl)
+    {
+      if (IsVulkan())
+        ss << "layout(set = 0, binding = " << (level + 1u) << ", rgba8) ";
+      else if (m_use_glsl_binding_layout)
+        ss << "layout(binding = " << (level - 1u) << ", rgba8) ";
+
+      ss << "uniform restrict writeonly image2D dst_mip" << level << ";\n";
+    }
+    else
+    {
+      ss << "RWTexture2D<float4> dst_mip" << level << " : register(u" << (level - 1u) << ");\n";
+    }
+  }
+
+  ss << "\nvoid store_mip(uint level, uint2 coords, float4 value)\n{\n";
+  ss << "  uint2 start = u_rect.xy >> level;\n";
+  ss << "  uint2 end = start + (u_rect.zw >> level);\n";
+  ss << "  if (coords.x < start.x || coords.y < start.y || coords.x >= end.x || coords.y >= end.y)\n";
+  ss << "    return;\n\n";
+  for (u32 level = 1; level < levels; level++)
+  {
+    ss << "  " << ((level > 1) ? "else " : "") << "if (level == " << level << "u)\n";
+    if (m_glsl)
+      ss << "    imageStore(dst_mip" << level << ", int2(coords), value);\n";
+    else
+      ss << "    dst_mip" << level << "[coords] = value;\n";
+  }
+  ss << "}\n\n";
+
+  if (m_glsl)
+  {
+    ss << "shared float4 s_tile[TILE_SIZE * TILE_SIZE];\n";
+    ss << "#define GROUP_BARRIER() memoryBarrierShared(); barrier()\n\n";
+    ss << "layout(local_size_x = " << static_cast<u32>(GPU_HW::SMOOTHING_COMPUTE_TILE_SIZE)
+       << ", local_size_y = " << static_cast<u32>(GPU_HW::SMOOTHING_COMPUTE_TILE_SIZE) << ", local_size_z = 1) in;\n";
+    ss << "void main()\n{\n";
+    ss << "  uint2 local_id = gl_LocalInvocationID.xy;\n";
+    ss << "  uint2 group_id = gl_WorkGroupID.xy;\n";
+  }
+  else
+  {
+    ss << "groupshared float4 s_tile[TILE_SIZE * TILE_SIZE];\n";
+    ss << "#define GROUP_BARRIER() GroupMemoryBarrierWithGroupSync()\n\n";
+    ss << "[numthreads(" << static_cast<u32>(GPU_HW::SMOOTHING_COMPUTE_TILE_SIZE) << ", "
+       << static_cast<u32>(GPU_HW::SMOOTHING_COMPUTE_TILE_SIZE) << ", 1)]\n";
+    ss << "void main(uint3 local_id3 : SV_GroupThreadID, uint3 group_id3 : SV_GroupID)\n{\n";
+    ss << "  uint2 local_id = local_id3.xy;\n";
+    ss << "  uint2 group_id = group_id3.xy;\n";
+  }
+
+  // Same energy measure as the fragment passes, but the intermediate mips are kept in shared memory instead of
+  // being written out and read back by a separate pass for every level.
+  ss << R"(
+  uint2 coords = u_base + group_id * TILE_SIZE + local_id;
+  int2 src_max = int2(VRAM_SIZE) - int2(1, 1);
+  int2 src = int2(coords * 2u);
+  float3 c00 = LOAD_TEXTURE(samp0, min(src, src_max), 0).rgb;
+  float3 c01 = LOAD_TEXTURE(samp0, min(src + int2(0, 1), src_max), 0).rgb;
+  float3 c10 = LOAD_TEXTURE(samp0, min(src + int2(1, 0), src_max), 0).rgb;
+  float3 c11 = LOAD_TEXTURE(samp0, min(src + int2(1, 1), src_max), 0).rgb;
+  float4 value = get_bias(c00, c01, c10, c11);
+  store_mip(1u, coords, value);
+  s_tile[local_id.y * TILE_SIZE + local_id.x] = value;
+
+  uint tile_size = TILE_SIZE;
+  FOR_UNROLL (uint level = 2u; level < MIP_LEVELS; level++)
+  {
+    tile_size /= 2u;
+    bool in_tile = (local_id.x < tile_size && local_id.y < tile_size);
+
+    GROUP_BARRIER();
+    if (in_tile)
+    {
+      uint index = (local_id.y * 2u) * TILE_SIZE + (local_id.x * 2u);
+      value = get_bias(s_tile[index], s_tile[index + TILE_SIZE], s_tile[index + 1u], s_tile[index + TILE_SIZE + 1u]);
+    }
+
+    GROUP_BARRIER();
+    if (in_tile)
+    {
+      s_tile[local_id.y * TILE_SIZE + local_id.x] = value;
+      store_mip(level, (u_base >> (level - 1u)) + group_id * tile_size + local_id, value);
+    }
+  }
+}
+)";
+
+  return ss.str();
+}
+
 std::string GPU_HW_ShaderGen::GenerateAdaptiveDownsampleBlurFragmentShader()
 {
   std::stringstream ss;
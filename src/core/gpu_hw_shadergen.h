@@ -7,12 +7,22 @@ class GPU_HW_ShaderGen : public ShaderGen
 public:
   GPU_HW_ShaderGen(RenderAPI render_api, u32 resolution_scale, u32 multisamples, bool per_sample_shading,
                    bool true_color, bool scaled_dithering, GPUTextureFilter texture_filtering, bool uv_limits,
-                   bool pgxp_depth, bool disable_color_perspective, bool supports_dual_source_blend);
+                   bool pgxp_depth, bool disable_color_perspective, bool supports_dual_source_blend,
+                   bool supports_framebuffer_fetch = false);
   ~GPU_HW_ShaderGen();
 
-  std::string GenerateBatchVertexShader(bool textured);
+  /// Specialization constants of the batch fragment shader. The module only has to be compiled once for all of them.
+  enum : u32
+  {
+    BATCH_SPEC_CONSTANT_DITHERING,
+    BATCH_SPEC_CONSTANT_INTERLACING,
+    NUM_BATCH_SPEC_CONSTANTS
+  };
+
+  std::string GenerateBatchVertexShader(bool textured, bool decoded_texture_cache = false,
+                                        bool dynamic_texture_mode = false);
   std::string GenerateBatchFragmentShader(GPU_HW::BatchRenderMode transparency, GPUTextureMode texture_mode,
-                                          bool dithering, bool interlacing);
+                                          bool dithering, bool interlacing, bool decoded_texture_cache = false);
   std::string GenerateDisplayFragmentShader(bool depth_24bit, GPU_HW::InterlacedRenderMode interlace_mode,
                                             bool smooth_chroma);
   std::string GenerateVRAMReadFragmentShader();
@@ -20,8 +30,10 @@ public:
   std::string GenerateVRAMCopyFragmentShader();
   std::string GenerateVRAMFillFragmentShader(bool wrapped, bool interlaced);
   std::string GenerateVRAMUpdateDepthFragmentShader();
+  std::string GenerateDecodeTexturePageFragmentShader(GPUTextureMode texture_mode);
 
   std::string GenerateAdaptiveDownsampleMipFragmentShader(bool first_pass);
+  std::string GenerateAdaptiveDownsampleMipComputeShader(u32 levels);
   std::string GenerateAdaptiveDownsampleBlurFragmentShader();
   std::string GenerateAdaptiveDownsampleCompositeFragmentShader();
   std::string GenerateBoxSampleDownsampleFragmentShader();
@@ -33,6 +45,7 @@ private:
   void WriteCommonFunctions(std::stringstream& ss);
   void WriteBatchUniformBuffer(std::stringstream& ss);
   void WriteBatchTextureFilter(std::stringstream& ss, GPUTextureFilter texture_filter);
+  void WriteAdaptiveDownsampleBiasFunctions(std::stringstream& ss);
 
   u32 m_resolution_scale;
   u32 m_multisamples;
@@ -2,6 +2,7 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/scoped_guard.h"
+#include "common/string_util.h"
 #include "common/timer.h"
 #include "common/vulkan/builders.h"
 #include "common/vulkan/context.h"
@@ -206,13 +207,26 @@ void GPU_HW_Vulkan::UpdateSettings()
 {
   GPU_HW::UpdateSettings();
 
-  bool framebuffer_changed, shaders_changed;
-  UpdateHWSettings(&framebuffer_changed, &shaders_changed);
+  const u32 old_multisamples = m_multisamples;
+  const u8 changes = UpdateHWSettings();
+  if (changes == HW_SETTINGS_CHANGE_NONE)
+    return;
+
+  const bool framebuffer_changed = (changes & HW_SETTINGS_CHANGE_FRAMEBUFFER) != 0;
+  const bool batch_pipelines_changed = (changes & HW_SETTINGS_CHANGE_BATCH_PIPELINES) != 0;
+  const bool utility_pipelines_changed = (changes & HW_SETTINGS_CHANGE_UTILITY_PIPELINES) != 0;
 
+  // When only the scale changes, e.g. from dynamic resolution, resample the old VRAM texture into the new one. This
+  // avoids stalling on a readback, and keeps the upscaled detail which a round trip through 1x would lose.
+  const bool blit_old_vram = framebuffer_changed && m_multisamples == 1 && old_multisamples == 1;
+  Vulkan::Texture old_vram_texture;
   if (framebuffer_changed)
   {
     RestoreGraphicsAPIState();
-    ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    if (blit_old_vram)
+      old_vram_texture = std::move(m_vram_texture);
+    else
+      ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
     ResetGraphicsAPIState();
   }
 
@@ -223,18 +237,45 @@ void GPU_HW_Vulkan::UpdateSettings()
   if (framebuffer_changed)
     CreateFramebuffer();
 
-  if (shaders_changed)
+  // Only rebuild the group of pipelines the change affects, e.g. the batch pipelines for a texture filter change.
+  if (batch_pipelines_changed || utility_pipelines_changed)
   {
-    // clear it since we draw a loading screen and it's not in the correct state
-    DestroyPipelines();
-    CompilePipelines();
+    DestroyPipelines(batch_pipelines_changed, utility_pipelines_changed);
+    CompilePipelines(batch_pipelines_changed, utility_pipelines_changed);
   }
 
   // this has to be done here, because otherwise we're using destroyed pipelines in the same cmdbuffer
   if (framebuffer_changed)
   {
+    if (blit_old_vram)
+    {
+      VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+      const VkImageBlit blit = {
+        {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+        {
+          {0, 0, 0},
+          {static_cast<int32_t>(old_vram_texture.GetWidth()), static_cast<int32_t>(old_vram_texture.GetHeight()), 1},
+        },
+        {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+        {
+          {0, 0, 0},
+          {static_cast<int32_t>(m_vram_texture.GetWidth()), static_cast<int32_t>(m_vram_texture.GetHeight()), 1},
+        },
+      };
+      old_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+      m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+      vkCmdBlitImage(cmdbuf, old_vram_texture.GetImage(), old_vram_texture.GetLayout(), m_vram_texture.GetImage(),
+                     m_vram_texture.GetLayout(), 1, &blit, VK_FILTER_LINEAR);
+      m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+      old_vram_texture.Destroy(true);
+
+      // The read texture and decoded pages were recreated empty.
+      SetFullVRAMDirtyRectangle();
+    }
+
     RestoreGraphicsAPIState();
-    UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_ptr, false, false);
+    if (!blit_old_vram)
+      UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_ptr, false, false);
     UpdateDepthBufferFromMaskBit();
     UpdateDisplay();
     ResetGraphicsAPIState();
@@ -328,6 +369,8 @@ void GPU_HW_Vulkan::SetCapabilities()
   m_supports_per_sample_shading = g_vulkan_context->GetDeviceFeatures().sampleRateShading;
   m_supports_adaptive_downsampling = true;
   m_supports_disable_color_perspective = true;
+  m_supports_decoded_texture_cache = true;
+  m_supports_texture_mode_batching = true;
 
   Log_InfoPrintf("Dual-source blend: %s", m_supports_dual_source_blend ? "supported" : "not supported");
   Log_InfoPrintf("Per-sample shading: %s", m_supports_per_sample_shading ? "supported" : "not supported");
@@ -355,10 +398,13 @@ void GPU_HW_Vulkan::DestroyResources()
 
   DestroyFramebuffer();
   DestroyPipelines();
+  DestroySpeculativeReadbackBuffer();
 
   Vulkan::Util::SafeDestroyPipelineLayout(m_downsample_pipeline_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_downsample_composite_descriptor_set_layout);
   Vulkan::Util::SafeDestroyPipelineLayout(m_downsample_composite_pipeline_layout);
+  Vulkan::Util::SafeDestroyDescriptorSetLayout(m_downsample_compute_descriptor_set_layout);
+  Vulkan::Util::SafeDestroyPipelineLayout(m_downsample_compute_pipeline_layout);
 
   Vulkan::Util::SafeFreeGlobalDescriptorSet(m_vram_write_descriptor_set);
   Vulkan::Util::SafeDestroyBufferView(m_texture_stream_buffer_view);
@@ -432,6 +478,7 @@ bool GPU_HW_Vulkan::CreatePipelineLayouts()
   dslbuilder.AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1,
                         VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT);
   dslbuilder.AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
+  dslbuilder.AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT);
   m_batch_descriptor_set_layout = dslbuilder.Create(device);
   if (m_batch_descriptor_set_layout == VK_NULL_HANDLE)
     return false;
@@ -513,6 +560,24 @@ bool GPU_HW_Vulkan::CreatePipelineLayouts()
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_composite_pipeline_layout,
                               "Downsample Composite Pipeline Layout");
 
+  // mip 0 is sampled, the remaining levels are written as storage images
+  dslbuilder.AddBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+  for (u32 i = 0; i < MAX_SMOOTHING_COMPUTE_MIP_LEVELS; i++)
+    dslbuilder.AddBinding(2 + i, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+  m_downsample_compute_descriptor_set_layout = dslbuilder.Create(device);
+  if (m_downsample_compute_descriptor_set_layout == VK_NULL_HANDLE)
+    return false;
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_compute_descriptor_set_layout,
+                              "Downsample Compute Descriptor Set Layout");
+
+  plbuilder.AddDescriptorSet(m_downsample_compute_descriptor_set_layout);
+  plbuilder.AddPushConstants(VK_SHADER_STAGE_COMPUTE_BIT, 0, MAX_PUSH_CONSTANTS_SIZE);
+  m_downsample_compute_pipeline_layout = plbuilder.Create(device);
+  if (m_downsample_compute_pipeline_layout == VK_NULL_HANDLE)
+    return false;
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_compute_pipeline_layout,
+                              "Downsample Compute Pipeline Layout");
+
   return true;
 }
 
@@ -608,10 +673,39 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
   Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_vram_readback_texture.GetAllocation(),
                               "VRAM Readback Texture Memory");
 
+  if (m_decoded_texture_cache)
+  {
+    if (!m_decoded_texture_atlas.Create(DECODED_TEXTURE_ATLAS_SIZE, DECODED_TEXTURE_ATLAS_SIZE, 1, 1, texture_format,
+                                        VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
+                                        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT))
+    {
+      return false;
+    }
+
+    m_decoded_texture_render_pass = g_vulkan_context->GetRenderPass(texture_format, VK_FORMAT_UNDEFINED,
+                                                                    VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_LOAD);
+    if (m_decoded_texture_render_pass == VK_NULL_HANDLE)
+      return false;
+
+    m_decoded_texture_framebuffer = m_decoded_texture_atlas.CreateFramebuffer(m_decoded_texture_render_pass);
+    if (m_decoded_texture_framebuffer == VK_NULL_HANDLE)
+      return false;
+
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_decoded_texture_atlas.GetImage(),
+                                "Decoded Texture Atlas");
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_decoded_texture_atlas.GetView(),
+                                "Decoded Texture Atlas View");
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_decoded_texture_atlas.GetAllocation(),
+                                "Decoded Texture Atlas Memory");
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_decoded_texture_framebuffer,
+                                "Decoded Texture Atlas Framebuffer");
+  }
+  InvalidateAllDecodedTexturePages();
+
   m_vram_render_pass =
     g_vulkan_context->GetRenderPass(texture_format, depth_format, samples, VK_ATTACHMENT_LOAD_OP_LOAD);
   m_vram_update_depth_render_pass =
-    g_vulkan_context->GetRenderPass(VK_FORMAT_UNDEFINED, depth_format, samples, VK_ATTACHMENT_LOAD_OP_DONT_CARE);
+    g_vulkan_context->GetRenderPass(VK_FORMAT_UNDEFINED, depth_format, samples, VK_ATTACHMENT_LOAD_OP_LOAD);
   m_display_load_render_pass = g_vulkan_context->GetRenderPass(
     m_display_texture.GetVkFormat(), VK_FORMAT_UNDEFINED, m_display_texture.GetVkSamples(), VK_ATTACHMENT_LOAD_OP_LOAD);
   m_display_discard_render_pass =
@@ -663,6 +757,8 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
   m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  if (m_decoded_texture_cache)
+    m_decoded_texture_atlas.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
   Vulkan::DescriptorSetUpdateBuilder dsubuilder;
 
@@ -680,6 +776,11 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                                       m_uniform_stream_buffer.GetBuffer(), 0, sizeof(BatchUBOData));
   dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_batch_descriptor_set, 1, m_vram_read_texture.GetView(),
                                                     m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  if (m_decoded_texture_cache)
+  {
+    dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_batch_descriptor_set, 2, m_decoded_texture_atlas.GetView(),
+                                                      m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  }
   dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_vram_copy_descriptor_set, 1, m_vram_read_texture.GetView(),
                                                     m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_vram_read_descriptor_set, 1, m_vram_texture.GetView(),
@@ -694,7 +795,7 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
 
     if (!m_downsample_texture.Create(texture_width, texture_height, levels, 1, texture_format, VK_SAMPLE_COUNT_1_BIT,
                                      VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                     VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_STORAGE_BIT |
                                        VK_IMAGE_USAGE_TRANSFER_DST_BIT) ||
         !m_downsample_weight_texture.Create(VRAM_WIDTH, VRAM_HEIGHT, 1, 1, VK_FORMAT_R8_UNORM, VK_SAMPLE_COUNT_1_BIT,
                                             VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
@@ -705,12 +806,15 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
 
     m_downsample_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-    m_downsample_render_pass = g_vulkan_context->GetRenderPass(m_downsample_texture.GetVkFormat(), VK_FORMAT_UNDEFINED,
-                                                               VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_CLEAR);
     m_downsample_weight_render_pass =
       g_vulkan_context->GetRenderPass(m_downsample_weight_texture.GetVkFormat(), VK_FORMAT_UNDEFINED,
                                       VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_CLEAR);
-    if (m_downsample_render_pass == VK_NULL_HANDLE || m_downsample_weight_render_pass == VK_NULL_HANDLE)
+    if (m_downsample_weight_render_pass == VK_NULL_HANDLE)
+      return false;
+
+    m_downsample_compute_descriptor_set =
+      g_vulkan_context->AllocateGlobalDescriptorSet(m_downsample_compute_descriptor_set_layout);
+    if (m_downsample_compute_descriptor_set == VK_NULL_HANDLE)
       return false;
 
     m_downsample_weight_framebuffer = m_downsample_weight_texture.CreateFramebuffer(m_downsample_weight_render_pass);
@@ -746,12 +850,16 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                                                         m_downsample_mip_views[i].image_view, m_point_sampler,
                                                         VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-      fbb.AddAttachment(mv.image_view);
-      fbb.SetRenderPass(m_downsample_render_pass);
-      fbb.SetSize(texture_width >> i, texture_height >> i, 1);
-      mv.framebuffer = fbb.Create(g_vulkan_context->GetDevice());
-      if (mv.framebuffer == VK_NULL_HANDLE)
-        return false;
+      if (i == 0)
+      {
+        dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_downsample_compute_descriptor_set, 1, mv.image_view,
+                                                          m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+      }
+      else
+      {
+        dsubuilder.AddStorageImageDescriptorWrite(m_downsample_compute_descriptor_set, 1 + i, mv.image_view,
+                                                  VK_IMAGE_LAYOUT_GENERAL);
+      }
     }
 
     m_downsample_composite_descriptor_set =
@@ -817,6 +925,7 @@ void GPU_HW_Vulkan::ClearFramebuffer()
 void GPU_HW_Vulkan::DestroyFramebuffer()
 {
   Vulkan::Util::SafeFreeGlobalDescriptorSet(m_downsample_composite_descriptor_set);
+  Vulkan::Util::SafeFreeGlobalDescriptorSet(m_downsample_compute_descriptor_set);
 
   for (SmoothMipView& mv : m_downsample_mip_views)
   {
@@ -838,12 +947,15 @@ void GPU_HW_Vulkan::DestroyFramebuffer()
   Vulkan::Util::SafeDestroyFramebuffer(m_vram_update_depth_framebuffer);
   Vulkan::Util::SafeDestroyFramebuffer(m_vram_readback_framebuffer);
   Vulkan::Util::SafeDestroyFramebuffer(m_display_framebuffer);
+  Vulkan::Util::SafeDestroyFramebuffer(m_decoded_texture_framebuffer);
 
+  m_decoded_texture_atlas.Destroy(false);
   m_vram_read_texture.Destroy(false);
   m_vram_depth_texture.Destroy(false);
   m_vram_texture.Destroy(false);
   m_vram_readback_texture.Destroy(false);
   m_display_texture.Destroy(false);
+  DropSpeculativeReadback();
 }
 
 bool GPU_HW_Vulkan::CreateVertexBuffer()
@@ -918,22 +1030,129 @@ bool GPU_HW_Vulkan::CreateTextureBuffer()
   return true;
 }
 
-bool GPU_HW_Vulkan::CompilePipelines()
+void GPU_HW_Vulkan::PrecompileShaders(GPU_HW_ShaderGen& shadergen, const u8* texture_modes, u32 num_texture_modes,
+                                      bool batch_pipelines, bool utility_pipelines)
 {
-  VkDevice device = g_vulkan_context->GetDevice();
-  VkPipelineCache pipeline_cache = g_vulkan_shader_cache->GetPipelineCache();
+  using Vulkan::ShaderCompiler::Type;
+  Vulkan::ShaderCompiler::ShaderSourceList shaders;
+
+  if (batch_pipelines)
+  {
+    for (u8 textured = 0; textured < 2; textured++)
+    {
+      shaders.emplace_back(Type::Vertex,
+                           shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured),
+                                                               m_decoded_texture_cache, m_texture_mode_batching));
+    }
+    for (u8 render_mode = 0; render_mode < 4; render_mode++)
+    {
+      for (u32 i = 0; i < num_texture_modes; i++)
+      {
+        shaders.emplace_back(Type::Fragment, shadergen.GenerateBatchFragmentShader(
+                                               static_cast<BatchRenderMode>(render_mode),
+                                               static_cast<GPUTextureMode>(texture_modes[i]), false, false,
+                                               m_decoded_texture_cache));
+      }
+    }
+  }
+
+  if (!utility_pipelines)
+  {
+    g_vulkan_shader_cache->PrecompileShaders(shaders);
+    return;
+  }
+
+  shaders.emplace_back(Type::Vertex, shadergen.GenerateScreenQuadVertexShader());
+  shaders.emplace_back(Type::Vertex, shadergen.GenerateUVQuadVertexShader());
+  for (u8 wrapped = 0; wrapped < 2; wrapped++)
+  {
+    for (u8 interlaced = 0; interlaced < 2; interlaced++)
+    {
+      shaders.emplace_back(Type::Fragment,
+                           shadergen.GenerateVRAMFillFragmentShader(ConvertToBoolUnchecked(wrapped),
+                                                                    ConvertToBoolUnchecked(interlaced)));
+    }
+  }
+  shaders.emplace_back(Type::Fragment, shadergen.GenerateVRAMCopyFragmentShader());
+  shaders.emplace_back(Type::Fragment, shadergen.GenerateVRAMWriteFragmentShader(m_use_ssbos_for_vram_writes));
+  shaders.emplace_back(Type::Fragment, shadergen.GenerateVRAMUpdateDepthFragmentShader());
+  shaders.emplace_back(Type::Fragment, shadergen.GenerateVRAMReadFragmentShader());
+
+  if (m_decoded_texture_cache)
+  {
+    for (u8 i = 0; i < 2; i++)
+    {
+      shaders.emplace_back(Type::Fragment,
+                           shadergen.GenerateDecodeTexturePageFragmentShader(static_cast<GPUTextureMode>(i)));
+    }
+  }
 
+  for (u8 depth_24 = 0; depth_24 < 2; depth_24++)
+  {
+    for (u8 interlace_mode = 0; interlace_mode < 3; interlace_mode++)
+    {
+      shaders.emplace_back(Type::Fragment, shadergen.GenerateDisplayFragmentShader(
+                                             ConvertToBoolUnchecked(depth_24),
+                                             static_cast<InterlacedRenderMode>(interlace_mode), m_chroma_smoothing));
+    }
+  }
+
+  if (m_downsample_mode == GPUDownsampleMode::Adaptive)
+  {
+    shaders.emplace_back(Type::Compute,
+                         shadergen.GenerateAdaptiveDownsampleMipComputeShader(GetAdaptiveDownsamplingMipLevels()));
+    shaders.emplace_back(Type::Fragment, shadergen.GenerateAdaptiveDownsampleBlurFragmentShader());
+    shaders.emplace_back(Type::Fragment, shadergen.GenerateAdaptiveDownsampleCompositeFragmentShader());
+  }
+  else if (m_downsample_mode == GPUDownsampleMode::Box)
+  {
+    shaders.emplace_back(Type::Fragment, shadergen.GenerateBoxSampleDownsampleFragmentShader());
+  }
+
+  g_vulkan_shader_cache->PrecompileShaders(shaders);
+}
+
+bool GPU_HW_Vulkan::CompilePipelines(bool batch_pipelines /* = true */, bool utility_pipelines /* = true */)
+{
   GPU_HW_ShaderGen shadergen(g_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
                              m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
                              m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
 
-  ShaderCompileProgressTracker progress("Compiling Pipelines", 2 + (4 * 9 * 2 * 2) + (3 * 4 * 5 * 9 * 2 * 2) + 1 + 2 +
-                                                                 (2 * 2) + 2 + 1 + 1 + (2 * 3) + 1);
+  // With texture mode batching, every textured draw goes through the dynamic mode, so the others aren't needed.
+  static constexpr std::array<u8, 9> all_texture_modes = {{0, 1, 2, 3, 4, 5, 6, 7, 8}};
+  static constexpr std::array<u8, 2> batched_texture_modes = {
+    {static_cast<u8>(GPUTextureMode::Disabled), static_cast<u8>(GPUTextureMode::Dynamic)}};
+  const u8* texture_modes = m_texture_mode_batching ? batched_texture_modes.data() : all_texture_modes.data();
+  const u32 num_texture_modes =
+    static_cast<u32>(m_texture_mode_batching ? batched_texture_modes.size() : all_texture_modes.size());
+
+  // Compile any shaders which aren't cached all at once, so the lookups below are cache hits.
+  PrecompileShaders(shadergen, texture_modes, num_texture_modes, batch_pipelines, utility_pipelines);
+
+  const u32 num_library_steps = g_vulkan_context->SupportsGraphicsPipelineLibrary() ?
+                                  ((2 * 2) + (4 * 5) + (3 * 4 * num_texture_modes * 2 * 2)) :
+                                  0;
+  const u32 num_batch_steps =
+    2 + (4 * num_texture_modes) + num_library_steps + (3 * 4 * 5 * num_texture_modes * 2 * 2);
+  const u32 num_utility_steps = 1 + 2 + (2 * 2) + 2 + 1 + 1 + (2 * 3) + 1;
+  ShaderCompileProgressTracker progress("Compiling Pipelines", (batch_pipelines ? num_batch_steps : 0) +
+                                                                 (utility_pipelines ? num_utility_steps : 0));
+
+  return ((!batch_pipelines || CompileBatchPipelines(shadergen, progress, texture_modes, num_texture_modes)) &&
+          (!utility_pipelines || CompileUtilityPipelines(shadergen, progress)));
+}
+
+bool GPU_HW_Vulkan::CompileBatchPipelines(GPU_HW_ShaderGen& shadergen, ShaderCompileProgressTracker& progress,
+                                          const u8* texture_modes, u32 num_texture_modes)
+{
+  VkDevice device = g_vulkan_context->GetDevice();
+  VkPipelineCache pipeline_cache = g_vulkan_shader_cache->GetPipelineCache();
+  const bool use_pipeline_libraries = g_vulkan_context->SupportsGraphicsPipelineLibrary();
 
   // vertex shaders - [textured]
-  // fragment shaders - [render_mode][texture_mode][dithering][interlacing]
+  // fragment shaders - [render_mode][texture_mode], dithering and interlacing are specialization constants
   DimensionalArray<VkShaderModule, 2> batch_vertex_shaders{};
-  DimensionalArray<VkShaderModule, 2, 2, 9, 4> batch_fragment_shaders{};
+  DimensionalArray<VkShaderModule, 10, 4> batch_fragment_shaders{};
   ScopedGuard batch_shader_guard([&batch_vertex_shaders, &batch_fragment_shaders]() {
     batch_vertex_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
     batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
@@ -941,7 +1160,9 @@ bool GPU_HW_Vulkan::CompilePipelines()
 
   for (u8 textured = 0; textured < 2; textured++)
   {
-    const std::string vs = shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured));
+    const std::string vs =
+      shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured), m_decoded_texture_cache,
+                                          m_texture_mode_batching);
     VkShaderModule shader = g_vulkan_shader_cache->GetVertexShader(vs);
     if (shader == VK_NULL_HANDLE)
       return false;
@@ -950,124 +1171,242 @@ bool GPU_HW_Vulkan::CompilePipelines()
     progress.Increment();
   }
 
-  for (u8 render_mode = 0; render_mode < 4; render_mode++)
+  // Compiling the fragment shaders and creating the batch pipelines are by far the slowest parts, so spread them
+  // across all cores. Shader modules and pipelines can be created from any thread.
+  const bool shaders_compiled = progress.RunParallel(4 * num_texture_modes, 1, [&](u32 job) {
+    const u8 texture_mode = texture_modes[job % num_texture_modes];
+    const u8 render_mode = static_cast<u8>(job / num_texture_modes);
+    const std::string fs =
+      shadergen.GenerateBatchFragmentShader(static_cast<BatchRenderMode>(render_mode),
+                                            static_cast<GPUTextureMode>(texture_mode), false, false,
+                                            m_decoded_texture_cache);
+
+    VkShaderModule shader = g_vulkan_shader_cache->GetFragmentShader(fs);
+    batch_fragment_shaders[render_mode][texture_mode] = shader;
+    return (shader != VK_NULL_HANDLE);
+  });
+  if (!shaders_compiled)
+    return false;
+
+  static constexpr std::array<VkCompareOp, 3> depth_test_values = {
+    VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
+  static constexpr std::array<VkSpecializationMapEntry, GPU_HW_ShaderGen::NUM_BATCH_SPEC_CONSTANTS> spec_map_entries =
+    {{{GPU_HW_ShaderGen::BATCH_SPEC_CONSTANT_DITHERING, 0, sizeof(VkBool32)},
+      {GPU_HW_ShaderGen::BATCH_SPEC_CONSTANT_INTERLACING, sizeof(VkBool32), sizeof(VkBool32)}}};
+  using BatchSpecData = std::array<VkBool32, GPU_HW_ShaderGen::NUM_BATCH_SPEC_CONSTANTS>;
+
+  // Each part of the batch pipeline state is set up by one of these, so it can be built as a library on its own.
+  const auto set_batch_vertex_input = [this](Vulkan::GraphicsPipelineBuilder& gpbuilder, bool textured) {
+    gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
+    gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
+    gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
+    if (textured)
+    {
+      gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
+      gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
+      if (m_using_uv_limits)
+        gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
+    }
+
+    gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+  };
+  const auto set_batch_pre_rasterization = [this, &batch_vertex_shaders](Vulkan::GraphicsPipelineBuilder& gpbuilder,
+                                                                         bool textured) {
+    gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
+    gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+    gpbuilder.SetVertexShader(batch_vertex_shaders[BoolToUInt8(textured)]);
+    gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+    gpbuilder.SetDynamicViewportAndScissorState();
+  };
+  const auto set_batch_fragment_shader = [this, &batch_fragment_shaders](
+                                           Vulkan::GraphicsPipelineBuilder& gpbuilder, u8 depth_test, u8 render_mode,
+                                           u8 texture_mode, const BatchSpecData& spec_data) {
+    gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
+    gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+    gpbuilder.SetFragmentShader(batch_fragment_shaders[render_mode][texture_mode]);
+    gpbuilder.SetSpecializationInfo(VK_SHADER_STAGE_FRAGMENT_BIT,
+                                    {static_cast<u32>(spec_map_entries.size()), spec_map_entries.data(),
+                                     sizeof(spec_data), spec_data.data()});
+    gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
+    gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
+  };
+  const auto set_batch_fragment_output = [this](Vulkan::GraphicsPipelineBuilder& gpbuilder, u8 render_mode,
+                                                u8 transparency_mode) {
+    gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+    gpbuilder.SetNoBlendingState();
+    gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
+
+    if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
+         (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+          static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
+        m_texture_filtering != GPUTextureFilter::Nearest)
+    {
+      if (m_supports_dual_source_blend)
+      {
+        gpbuilder.SetBlendAttachment(
+          0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
+          (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+           static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+           static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+            VK_BLEND_OP_REVERSE_SUBTRACT :
+            VK_BLEND_OP_ADD,
+          VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+      }
+      else
+      {
+        const float factor = (static_cast<GPUTransparencyMode>(transparency_mode) ==
+                              GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
+                               0.5f :
+                               1.0f;
+        gpbuilder.SetBlendAttachment(
+          0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
+          (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+           static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+           static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+            VK_BLEND_OP_REVERSE_SUBTRACT :
+            VK_BLEND_OP_ADD,
+          VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+        gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
+      }
+    }
+  };
+
+  // With graphics pipeline libraries, each part is compiled once and the permutations are only linked, which is
+  // nearly free. The libraries aren't needed once the pipelines are linked.
+  // vertex input/pre-rasterization - [textured]
+  // fragment shader - [depth_test][render_mode][texture_mode][dithering][interlacing]
+  // fragment output - [render_mode][transparency_mode]
+  DimensionalArray<VkPipeline, 2> batch_vertex_input_libraries{};
+  DimensionalArray<VkPipeline, 2> batch_pre_rasterization_libraries{};
+  DimensionalArray<VkPipeline, 2, 2, 10, 4, 3> batch_fragment_shader_libraries{};
+  DimensionalArray<VkPipeline, 5, 4> batch_fragment_output_libraries{};
+  ScopedGuard batch_library_guard([&]() {
+    batch_vertex_input_libraries.enumerate(Vulkan::Util::SafeDestroyPipeline);
+    batch_pre_rasterization_libraries.enumerate(Vulkan::Util::SafeDestroyPipeline);
+    batch_fragment_shader_libraries.enumerate(Vulkan::Util::SafeDestroyPipeline);
+    batch_fragment_output_libraries.enumerate(Vulkan::Util::SafeDestroyPipeline);
+  });
+
+  if (use_pipeline_libraries)
   {
-    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+    Vulkan::GraphicsPipelineBuilder gpbuilder;
+    for (u8 textured = 0; textured < 2; textured++)
     {
+      gpbuilder.SetLibraryFlags(VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT);
+      set_batch_vertex_input(gpbuilder, ConvertToBoolUnchecked(textured));
+      batch_vertex_input_libraries[textured] = gpbuilder.Create(device, pipeline_cache);
+      if (batch_vertex_input_libraries[textured] == VK_NULL_HANDLE)
+        return false;
+
+      gpbuilder.SetLibraryFlags(VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT);
+      set_batch_pre_rasterization(gpbuilder, ConvertToBoolUnchecked(textured));
+      batch_pre_rasterization_libraries[textured] = gpbuilder.Create(device, pipeline_cache);
+      if (batch_pre_rasterization_libraries[textured] == VK_NULL_HANDLE)
+        return false;
+
+      progress.Increment(2);
+    }
+
+    for (u8 render_mode = 0; render_mode < 4; render_mode++)
+    {
+      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
+      {
+        gpbuilder.SetLibraryFlags(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT);
+        set_batch_fragment_output(gpbuilder, render_mode, transparency_mode);
+        batch_fragment_output_libraries[render_mode][transparency_mode] = gpbuilder.Create(device, pipeline_cache);
+        if (batch_fragment_output_libraries[render_mode][transparency_mode] == VK_NULL_HANDLE)
+          return false;
+
+        progress.Increment();
+      }
+    }
+
+    const bool libraries_created = progress.RunParallel(3 * 4 * num_texture_modes, 2 * 2, [&](u32 job) {
+      const u8 texture_mode = texture_modes[job % num_texture_modes];
+      const u8 render_mode = static_cast<u8>((job / num_texture_modes) % 4);
+      const u8 depth_test = static_cast<u8>(job / (num_texture_modes * 4));
+      Vulkan::GraphicsPipelineBuilder fsbuilder;
+
       for (u8 dithering = 0; dithering < 2; dithering++)
       {
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+          const BatchSpecData spec_data = {{static_cast<VkBool32>(dithering), static_cast<VkBool32>(interlacing)}};
+          fsbuilder.SetLibraryFlags(VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT);
+          set_batch_fragment_shader(fsbuilder, depth_test, render_mode, texture_mode, spec_data);
 
-          VkShaderModule shader = g_vulkan_shader_cache->GetFragmentShader(fs);
-          if (shader == VK_NULL_HANDLE)
+          VkPipeline library = fsbuilder.Create(device, pipeline_cache);
+          if (library == VK_NULL_HANDLE)
             return false;
 
-          batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader;
-          progress.Increment();
+          batch_fragment_shader_libraries[depth_test][render_mode][texture_mode][dithering][interlacing] = library;
         }
       }
-    }
-  }
 
-  Vulkan::GraphicsPipelineBuilder gpbuilder;
+      return true;
+    });
+    if (!libraries_created)
+      return false;
+  }
 
   // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  for (u8 depth_test = 0; depth_test < 3; depth_test++)
-  {
-    for (u8 render_mode = 0; render_mode < 4; render_mode++)
+  const bool batch_pipelines_created = progress.RunParallel(3 * 4 * 5, num_texture_modes * 2 * 2, [&](u32 job) {
+    const u8 transparency_mode = static_cast<u8>(job % 5);
+    const u8 render_mode = static_cast<u8>((job / 5) % 4);
+    const u8 depth_test = static_cast<u8>(job / 20);
+    Vulkan::GraphicsPipelineBuilder gpbuilder;
+
+    for (u32 texture_mode_index = 0; texture_mode_index < num_texture_modes; texture_mode_index++)
     {
-      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
+      const u8 texture_mode = texture_modes[texture_mode_index];
+      for (u8 dithering = 0; dithering < 2; dithering++)
       {
-        for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+        for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
-          for (u8 dithering = 0; dithering < 2; dithering++)
+          const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+          const BatchSpecData spec_data = {{static_cast<VkBool32>(dithering), static_cast<VkBool32>(interlacing)}};
+
+          if (use_pipeline_libraries)
           {
-            for (u8 interlacing = 0; interlacing < 2; interlacing++)
-            {
-              static constexpr std::array<VkCompareOp, 3> depth_test_values = {
-                VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
-              const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
-
-              gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
-              gpbuilder.SetRenderPass(m_vram_render_pass, 0);
-
-              gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
-              gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
-              gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
-              if (textured)
-              {
-                gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
-                gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
-                if (m_using_uv_limits)
-                  gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
-              }
-
-              gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-              gpbuilder.SetVertexShader(batch_vertex_shaders[BoolToUInt8(textured)]);
-              gpbuilder.SetFragmentShader(batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing]);
-
-              gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
-              gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
-              gpbuilder.SetNoBlendingState();
-              gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
-
-              if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
-                   (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                    static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
-                  m_texture_filtering != GPUTextureFilter::Nearest)
-              {
-                if (m_supports_dual_source_blend)
-                {
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                }
-                else
-                {
-                  const float factor = (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                                        GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
-                                         0.5f :
-                                         1.0f;
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                  gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
-                }
-              }
-
-              gpbuilder.SetDynamicViewportAndScissorState();
-
-              VkPipeline pipeline = gpbuilder.Create(device, pipeline_cache);
-              if (pipeline == VK_NULL_HANDLE)
-                return false;
-
-              m_batch_pipelines[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] =
-                pipeline;
-              progress.Increment();
-            }
+            gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
+            gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+            gpbuilder.AddLibrary(batch_vertex_input_libraries[BoolToUInt8(textured)]);
+            gpbuilder.AddLibrary(batch_pre_rasterization_libraries[BoolToUInt8(textured)]);
+            gpbuilder.AddLibrary(
+              batch_fragment_shader_libraries[depth_test][render_mode][texture_mode][dithering][interlacing]);
+            gpbuilder.AddLibrary(batch_fragment_output_libraries[render_mode][transparency_mode]);
           }
+          else
+          {
+            set_batch_vertex_input(gpbuilder, textured);
+            set_batch_pre_rasterization(gpbuilder, textured);
+            set_batch_fragment_shader(gpbuilder, depth_test, render_mode, texture_mode, spec_data);
+            set_batch_fragment_output(gpbuilder, render_mode, transparency_mode);
+          }
+
+          VkPipeline pipeline = gpbuilder.Create(device, pipeline_cache);
+          if (pipeline == VK_NULL_HANDLE)
+            return false;
+
+          m_batch_pipelines[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] =
+            pipeline;
         }
       }
     }
-  }
 
-  batch_shader_guard.Run();
+    return true;
+  });
+  if (!batch_pipelines_created)
+    return false;
+
+  return true;
+}
+
+bool GPU_HW_Vulkan::CompileUtilityPipelines(GPU_HW_ShaderGen& shadergen, ShaderCompileProgressTracker& progress)
+{
+  VkDevice device = g_vulkan_context->GetDevice();
+  VkPipelineCache pipeline_cache = g_vulkan_shader_cache->GetPipelineCache();
+  Vulkan::GraphicsPipelineBuilder gpbuilder;
 
   VkShaderModule fullscreen_quad_vertex_shader =
     g_vulkan_shader_cache->GetVertexShader(shadergen.GenerateScreenQuadVertexShader());
@@ -1222,6 +1561,36 @@ bool GPU_HW_Vulkan::CompilePipelines()
 
   gpbuilder.Clear();
 
+  // Decoded texture pages
+  if (m_decoded_texture_cache)
+  {
+    for (u8 i = 0; i < 2; i++)
+    {
+      VkShaderModule fs = g_vulkan_shader_cache->GetFragmentShader(
+        shadergen.GenerateDecodeTexturePageFragmentShader(static_cast<GPUTextureMode>(i)));
+      if (fs == VK_NULL_HANDLE)
+        return false;
+
+      gpbuilder.SetRenderPass(m_decoded_texture_render_pass, 0);
+      gpbuilder.SetPipelineLayout(m_single_sampler_pipeline_layout);
+      gpbuilder.SetVertexShader(fullscreen_quad_vertex_shader);
+      gpbuilder.SetFragmentShader(fs);
+      gpbuilder.SetNoCullRasterizationState();
+      gpbuilder.SetNoDepthTestState();
+      gpbuilder.SetNoBlendingState();
+      gpbuilder.SetDynamicViewportAndScissorState();
+
+      m_decode_texture_page_pipelines[i] = gpbuilder.Create(device, pipeline_cache, false);
+      vkDestroyShaderModule(device, fs, nullptr);
+      if (m_decode_texture_page_pipelines[i] == VK_NULL_HANDLE)
+        return false;
+
+      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_decode_texture_page_pipelines[i],
+                                  "Decode Texture Page Pipeline %u", i);
+      gpbuilder.Clear();
+    }
+  }
+
   // Display
   {
     gpbuilder.SetRenderPass(m_display_load_render_pass, 0);
@@ -1255,8 +1624,22 @@ bool GPU_HW_Vulkan::CompilePipelines()
 
   if (m_downsample_mode == GPUDownsampleMode::Adaptive)
   {
+    VkShaderModule cs = g_vulkan_shader_cache->GetComputeShader(
+      shadergen.GenerateAdaptiveDownsampleMipComputeShader(GetAdaptiveDownsamplingMipLevels()));
+    if (cs == VK_NULL_HANDLE)
+      return false;
+
+    Vulkan::ComputePipelineBuilder cpbuilder;
+    cpbuilder.SetShader(cs);
+    cpbuilder.SetPipelineLayout(m_downsample_compute_pipeline_layout);
+    m_downsample_compute_pipeline = cpbuilder.Create(device, pipeline_cache);
+    vkDestroyShaderModule(g_vulkan_context->GetDevice(), cs, nullptr);
+    if (m_downsample_compute_pipeline == VK_NULL_HANDLE)
+      return false;
+    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_compute_pipeline,
+                                "Downsample Mip Compute Pipeline");
+
     gpbuilder.Clear();
-    gpbuilder.SetRenderPass(m_downsample_render_pass, 0);
     gpbuilder.SetPipelineLayout(m_downsample_pipeline_layout);
     gpbuilder.SetVertexShader(uv_quad_vertex_shader);
     gpbuilder.SetNoCullRasterizationState();
@@ -1265,31 +1648,7 @@ bool GPU_HW_Vulkan::CompilePipelines()
     gpbuilder.SetDynamicViewportAndScissorState();
 
     VkShaderModule fs =
-      g_vulkan_shader_cache->GetFragmentShader(shadergen.GenerateAdaptiveDownsampleMipFragmentShader(true));
-    if (fs == VK_NULL_HANDLE)
-      return false;
-
-    gpbuilder.SetFragmentShader(fs);
-    m_downsample_first_pass_pipeline = gpbuilder.Create(device, pipeline_cache, false);
-    vkDestroyShaderModule(g_vulkan_context->GetDevice(), fs, nullptr);
-    if (m_downsample_first_pass_pipeline == VK_NULL_HANDLE)
-      return false;
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_first_pass_pipeline,
-                                "Downsample First Pass Pipeline");
-
-    fs = g_vulkan_shader_cache->GetFragmentShader(shadergen.GenerateAdaptiveDownsampleMipFragmentShader(false));
-    if (fs == VK_NULL_HANDLE)
-      return false;
-
-    gpbuilder.SetFragmentShader(fs);
-    m_downsample_mid_pass_pipeline = gpbuilder.Create(device, pipeline_cache, false);
-    vkDestroyShaderModule(g_vulkan_context->GetDevice(), fs, nullptr);
-    if (m_downsample_mid_pass_pipeline == VK_NULL_HANDLE)
-      return false;
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_downsample_mid_pass_pipeline,
-                                "Downsample Mid Pass Pipeline");
-
-    fs = g_vulkan_shader_cache->GetFragmentShader(shadergen.GenerateAdaptiveDownsampleBlurFragmentShader());
+      g_vulkan_shader_cache->GetFragmentShader(shadergen.GenerateAdaptiveDownsampleBlurFragmentShader());
     if (fs == VK_NULL_HANDLE)
       return false;
 
@@ -1349,9 +1708,13 @@ bool GPU_HW_Vulkan::CompilePipelines()
   return true;
 }
 
-void GPU_HW_Vulkan::DestroyPipelines()
+void GPU_HW_Vulkan::DestroyPipelines(bool batch_pipelines /* = true */, bool utility_pipelines /* = true */)
 {
-  m_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+  if (batch_pipelines)
+    m_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+
+  if (!utility_pipelines)
+    return;
 
   m_vram_fill_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
 
@@ -1364,8 +1727,11 @@ void GPU_HW_Vulkan::DestroyPipelines()
   Vulkan::Util::SafeDestroyPipeline(m_vram_readback_pipeline);
   Vulkan::Util::SafeDestroyPipeline(m_vram_update_depth_pipeline);
 
+  for (VkPipeline& p : m_decode_texture_page_pipelines)
+    Vulkan::Util::SafeDestroyPipeline(p);
+
   Vulkan::Util::SafeDestroyPipeline(m_downsample_first_pass_pipeline);
-  Vulkan::Util::SafeDestroyPipeline(m_downsample_mid_pass_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_downsample_compute_pipeline);
   Vulkan::Util::SafeDestroyPipeline(m_downsample_blur_pass_pipeline);
   Vulkan::Util::SafeDestroyPipeline(m_downsample_composite_pass_pipeline);
 
@@ -1418,9 +1784,13 @@ void GPU_HW_Vulkan::ClearDisplay()
 
 void GPU_HW_Vulkan::UpdateDisplay()
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::Display);
   GPU_HW::UpdateDisplay();
   EndRenderPass();
 
+  // The frame's drawing has been submitted, so start copying anything the game keeps reading back.
+  BeginSpeculativeReadback();
+
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::UpdateDisplay");
 
@@ -1428,7 +1798,7 @@ void GPU_HW_Vulkan::UpdateDisplay()
   {
     if (IsUsingMultisampling())
     {
-      if (m_vram_dirty_rect.Intersects(
+      if (IsVRAMAreaDirty(
             Common::Rectangle<u32>::FromExtents(m_crtc_state.display_vram_left, m_crtc_state.display_vram_top,
                                                 m_crtc_state.display_vram_width, m_crtc_state.display_vram_height)))
       {
@@ -1533,21 +1903,42 @@ void GPU_HW_Vulkan::UpdateDisplay()
 
 void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
-  if (IsUsingSoftwareRendererForReadbacks())
-  {
-    ReadSoftwareRendererVRAM(x, y, width, height);
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
+  if (IsUsingSoftwareRendererForReadbacks() && ReadSoftwareRendererVRAM(&x, &y, &width, &height))
     return;
-  }
 
   // Get bounds with wrap-around handled.
   const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
+  // Anything copied ahead of time has to land in the shadow buffer before we decide whether it's current.
+  CompleteSpeculativeReadback();
+  UpdateSpeculativeReadbackArea(copy_rect);
+
+  // Nothing has been drawn to this area since it was last read back, so the shadow copy is current.
+  if (!IsVRAMReadbackRequired(copy_rect))
+    return;
+
   EndRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::ReadVRAM: %u %u %ux%u", x, y, width, height);
+  EncodeVRAMForReadback(cmdbuf, copy_rect);
+
+  // Stage the readback and copy it into our shadow buffer (will execute command buffer and stall).
+  g_host_display->DownloadTexture(&m_vram_readback_texture, 0, 0, encoded_width, encoded_height,
+                                  &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
+                                  VRAM_WIDTH * sizeof(u16));
+  VRAMReadbackCompleted(copy_rect);
+
+  RestoreGraphicsAPIState();
+}
+
+void GPU_HW_Vulkan::EncodeVRAMForReadback(VkCommandBuffer cmdbuf, const Common::Rectangle<u32>& copy_rect)
+{
+  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = copy_rect.GetHeight();
 
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   m_vram_readback_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
@@ -1571,17 +1962,165 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 
   m_vram_readback_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+}
 
-  // Stage the readback and copy it into our shadow buffer (will execute command buffer and stall).
-  g_host_display->DownloadTexture(&m_vram_readback_texture, 0, 0, encoded_width, encoded_height,
-                                  &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
-                                  VRAM_WIDTH * sizeof(u16));
+void GPU_HW_Vulkan::UpdateSpeculativeReadbackArea(const Common::Rectangle<u32>& copy_rect)
+{
+  if (m_speculative_readback_rect == copy_rect)
+  {
+    m_speculative_readback_hits = std::min<u32>(m_speculative_readback_hits + 1, SPECULATIVE_READBACK_MIN_HITS);
+  }
+  else
+  {
+    m_speculative_readback_rect = copy_rect;
+    m_speculative_readback_hits = 1;
+  }
+}
 
-  RestoreGraphicsAPIState();
+bool GPU_HW_Vulkan::CreateSpeculativeReadbackBuffer()
+{
+  // Enough for the whole of VRAM, encoded as RGBA8 at half width.
+  const VkBufferCreateInfo bci = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                                  nullptr,
+                                  0u,
+                                  VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16),
+                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  VK_SHARING_MODE_EXCLUSIVE,
+                                  0u,
+                                  nullptr};
+
+  VmaAllocationCreateInfo aci = {};
+  aci.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+  aci.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  aci.preferredFlags = VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+  VmaAllocationInfo ai = {};
+  VkResult res = vmaCreateBuffer(g_vulkan_context->GetAllocator(), &bci, &aci, &m_speculative_readback_buffer,
+                                 &m_speculative_readback_allocation, &ai);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vmaCreateBuffer() for speculative readback failed: ");
+    return false;
+  }
+
+  m_speculative_readback_buffer_map = static_cast<const u8*>(ai.pMappedData);
+  return true;
+}
+
+void GPU_HW_Vulkan::DestroySpeculativeReadbackBuffer()
+{
+  DropSpeculativeReadback();
+
+  if (m_speculative_readback_buffer != VK_NULL_HANDLE)
+  {
+    g_vulkan_context->DeferBufferDestruction(m_speculative_readback_buffer, m_speculative_readback_allocation);
+    m_speculative_readback_buffer = VK_NULL_HANDLE;
+    m_speculative_readback_allocation = VK_NULL_HANDLE;
+    m_speculative_readback_buffer_map = nullptr;
+  }
+}
+
+void GPU_HW_Vulkan::BeginSpeculativeReadback()
+{
+  // A copy which was never picked up means the game has stopped reading this area.
+  if (m_speculative_readback_pending)
+  {
+    m_speculative_readback_hits = 0;
+    return;
+  }
+
+  if (m_speculative_readback_hits < SPECULATIVE_READBACK_MIN_HITS || IsUsingSoftwareRendererForReadbacks() ||
+      !IsVRAMReadbackRequired(m_speculative_readback_rect))
+  {
+    return;
+  }
+
+  if (m_speculative_readback_buffer == VK_NULL_HANDLE && !CreateSpeculativeReadbackBuffer())
+  {
+    m_speculative_readback_hits = 0;
+    return;
+  }
+
+  const Common::Rectangle<u32>& copy_rect = m_speculative_readback_rect;
+  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = copy_rect.GetHeight();
+  const u32 size = encoded_width * encoded_height * sizeof(u32);
+
+  EndRenderPass();
+
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::BeginSpeculativeReadback: %u %u %ux%u",
+                                            copy_rect.left, copy_rect.top, copy_rect.GetWidth(),
+                                            copy_rect.GetHeight());
+  EncodeVRAMForReadback(cmdbuf, copy_rect);
+
+  VkBufferImageCopy image_copy = {};
+  image_copy.bufferOffset = 0;
+  image_copy.bufferRowLength = encoded_width;
+  image_copy.bufferImageHeight = 0;
+  image_copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u};
+  image_copy.imageOffset = {0, 0, 0};
+  image_copy.imageExtent = {encoded_width, encoded_height, 1u};
+
+  Vulkan::Util::BufferMemoryBarrier(cmdbuf, m_speculative_readback_buffer, 0, VK_ACCESS_TRANSFER_WRITE_BIT, 0, size,
+                                    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+  vkCmdCopyImageToBuffer(cmdbuf, m_vram_readback_texture.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                         m_speculative_readback_buffer, 1, &image_copy);
+  Vulkan::Util::BufferMemoryBarrier(cmdbuf, m_speculative_readback_buffer, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                    VK_ACCESS_HOST_READ_BIT, 0, size, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                    VK_PIPELINE_STAGE_HOST_BIT);
+
+  // The copy goes out with this frame's command buffer, ReadVRAM() only waits if it hasn't finished by then.
+  m_speculative_readback_fence_counter = g_vulkan_context->GetCurrentFenceCounter();
+  m_speculative_readback_pending = true;
+  VRAMReadbackCompleted(copy_rect);
+}
+
+void GPU_HW_Vulkan::CompleteSpeculativeReadback()
+{
+  if (!m_speculative_readback_pending)
+    return;
+
+  m_speculative_readback_pending = false;
+
+  if (m_speculative_readback_fence_counter == g_vulkan_context->GetCurrentFenceCounter())
+  {
+    Log_PerfPrintf("Speculative readback not submitted yet, executing command buffer");
+    ExecuteCommandBuffer(true, true);
+  }
+  else
+  {
+    g_vulkan_context->WaitForFenceCounter(m_speculative_readback_fence_counter);
+  }
+
+  const Common::Rectangle<u32>& copy_rect = m_speculative_readback_rect;
+  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = copy_rect.GetHeight();
+  const u32 pitch = encoded_width * sizeof(u32);
+  const u32 size = pitch * encoded_height;
+
+  VkResult res = vmaInvalidateAllocation(g_vulkan_context->GetAllocator(), m_speculative_readback_allocation, 0, size);
+  if (res != VK_SUCCESS)
+    LOG_VULKAN_ERROR(res, "vmaInvalidateAllocation() failed, readback may be incorrect: ");
+
+  StringUtil::StrideMemCpy(&m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left], VRAM_WIDTH * sizeof(u16),
+                           m_speculative_readback_buffer_map, pitch, std::min<u32>(pitch, VRAM_WIDTH * sizeof(u16)),
+                           encoded_height);
+}
+
+void GPU_HW_Vulkan::DropSpeculativeReadback()
+{
+  if (!m_speculative_readback_pending)
+    return;
+
+  // The dirty area was cleared when the copy was queued, so put it back since the shadow buffer never got the data.
+  m_speculative_readback_pending = false;
+  IncludeVRAMDirtyRectangle(m_speculative_readback_rect);
 }
 
 void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   if (IsUsingSoftwareRendererForReadbacks())
     FillSoftwareRendererVRAM(x, y, width, height, color);
 
@@ -1610,6 +2149,7 @@ void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 
 void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   if (IsUsingSoftwareRendererForReadbacks())
     UpdateSoftwareRendererVRAM(x, y, width, height, data, set_mask, check_mask);
 
@@ -1669,17 +2209,26 @@ void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 
 void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
 {
+  // API copies can't wrap around the edge of VRAM, so oversized copies are done in pieces.
+  const bool use_shader = (UseVRAMCopyShader() || IsUsingMultisampling());
+  if (!use_shader && IsVRAMCopyOversized(src_x, src_y, dst_x, dst_y, width, height))
+  {
+    CopyOversizedVRAM(src_x, src_y, dst_x, dst_y, width, height);
+    return;
+  }
+
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::CopyVRAM: {%u, %u} {%u, %u} %ux%u", src_x, src_y,
                                             dst_x, dst_y, width, height);
   if (IsUsingSoftwareRendererForReadbacks())
     CopySoftwareRendererVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
-  if (UseVRAMCopyShader(src_x, src_y, dst_x, dst_y, width, height) || IsUsingMultisampling())
+  if (use_shader)
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
+    if (IsVRAMAreaDirty(src_bounds))
       UpdateVRAMReadTexture();
     IncludeVRAMDirtyRectangle(dst_bounds);
 
@@ -1705,6 +2254,12 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
     return;
   }
 
+  // Copies between overlapping regions of one image are undefined, so those come from the read texture instead.
+  const Common::Rectangle<u32> src_bounds = Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height);
+  const bool overlapping = src_bounds.Intersects(Common::Rectangle<u32>::FromExtents(dst_x, dst_y, width, height));
+  if (overlapping && IsVRAMAreaDirty(src_bounds))
+    UpdateVRAMReadTexture();
+
   GPU_HW::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
   src_x *= m_resolution_scale;
@@ -1716,21 +2271,58 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
 
   EndRenderPass();
 
+  Vulkan::Texture& src_texture = overlapping ? m_vram_read_texture : m_vram_texture;
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_GENERAL);
+  if (overlapping)
+    m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
 
   const VkImageCopy ic{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
                        {static_cast<s32>(src_x), static_cast<s32>(src_y), 0},
                        {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
                        {static_cast<s32>(dst_x), static_cast<s32>(dst_y), 0},
                        {width, height, 1u}};
-  vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_texture.GetImage(),
+  vkCmdCopyImage(cmdbuf, src_texture.GetImage(), src_texture.GetLayout(), m_vram_texture.GetImage(),
                  m_vram_texture.GetLayout(), 1, &ic);
 
+  if (overlapping)
+    m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 }
 
+void GPU_HW_Vulkan::DecodeTexturePage(u32 slot, GPUTextureMode mode, u32 page_x, u32 page_y, u32 palette_x,
+                                      u32 palette_y)
+{
+  EndRenderPass();
+
+  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::DecodeTexturePage: slot %u {%u, %u} {%u, %u}",
+                                            slot, page_x, page_y, palette_x, palette_y);
+
+  const u32 slot_x = (slot % DECODED_TEXTURE_ATLAS_SLOTS_X) * DECODED_TEXTURE_PAGE_SIZE;
+  const u32 slot_y = (slot / DECODED_TEXTURE_ATLAS_SLOTS_X) * DECODED_TEXTURE_PAGE_SIZE;
+  const u32 uniforms[6] = {page_x * m_resolution_scale,    page_y * m_resolution_scale, palette_x * m_resolution_scale,
+                           palette_y * m_resolution_scale, slot_x,                      slot_y};
+
+  m_decoded_texture_atlas.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  BeginRenderPass(m_decoded_texture_render_pass, m_decoded_texture_framebuffer, slot_x, slot_y,
+                  DECODED_TEXTURE_PAGE_SIZE, DECODED_TEXTURE_PAGE_SIZE);
+  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    m_decode_texture_page_pipelines[BoolToUInt8(mode == GPUTextureMode::Palette8Bit)]);
+  vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
+                          &m_vram_copy_descriptor_set, 0, nullptr);
+  vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
+                     uniforms);
+  Vulkan::Util::SetViewportAndScissor(cmdbuf, slot_x, slot_y, DECODED_TEXTURE_PAGE_SIZE, DECODED_TEXTURE_PAGE_SIZE);
+  vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+  EndRenderPass();
+
+  m_decoded_texture_atlas.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  RestoreGraphicsAPIState();
+}
+
 void GPU_HW_Vulkan::UpdateVRAMReadTexture()
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::VRAMTransfer);
   EndRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
@@ -1738,28 +2330,43 @@ void GPU_HW_Vulkan::UpdateVRAMReadTexture()
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
-
+  static constexpr VkImageSubresourceLayers subresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u};
+  const std::vector<Common::Rectangle<u32>>& areas = GetVRAMDirtyAreas();
   if (m_vram_texture.GetSamples() > VK_SAMPLE_COUNT_1_BIT)
   {
-    const VkImageResolve resolve{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                                 {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
-                                 {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                                 {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
-                                 {scaled_rect.GetWidth(), scaled_rect.GetHeight(), 1u}};
-    vkCmdResolveImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_read_texture.GetImage(),
-                      m_vram_read_texture.GetLayout(), 1, &resolve);
+    m_vram_read_texture_resolves.clear();
+    for (const Common::Rectangle<u32>& area : areas)
+    {
+      const auto scaled_rect = area * m_resolution_scale;
+      const VkOffset3D offset = {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0};
+      const VkExtent3D extent = {scaled_rect.GetWidth(), scaled_rect.GetHeight(), 1u};
+      m_vram_read_texture_resolves.push_back({subresource, offset, subresource, offset, extent});
+    }
+
+    if (!m_vram_read_texture_resolves.empty())
+    {
+      vkCmdResolveImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_read_texture.GetImage(),
+                        m_vram_read_texture.GetLayout(), static_cast<u32>(m_vram_read_texture_resolves.size()),
+                        m_vram_read_texture_resolves.data());
+    }
   }
   else
   {
-    const VkImageCopy copy{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                           {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
-                           {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                           {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
-                           {scaled_rect.GetWidth(), scaled_rect.GetHeight(), 1u}};
+    m_vram_read_texture_copies.clear();
+    for (const Common::Rectangle<u32>& area : areas)
+    {
+      const auto scaled_rect = area * m_resolution_scale;
+      const VkOffset3D offset = {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0};
+      const VkExtent3D extent = {scaled_rect.GetWidth(), scaled_rect.GetHeight(), 1u};
+      m_vram_read_texture_copies.push_back({subresource, offset, subresource, offset, extent});
+    }
 
-    vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_read_texture.GetImage(),
-                   m_vram_read_texture.GetLayout(), 1u, &copy);
+    if (!m_vram_read_texture_copies.empty())
+    {
+      vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_read_texture.GetImage(),
+                     m_vram_read_texture.GetLayout(), static_cast<u32>(m_vram_read_texture_copies.size()),
+                     m_vram_read_texture_copies.data());
+    }
   }
 
   m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
@@ -1769,7 +2376,7 @@ void GPU_HW_Vulkan::UpdateVRAMReadTexture()
 
 void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit()
 {
-  if (m_pgxp_depth_buffer)
+  if (m_pgxp_depth_buffer || !m_vram_depth_dirty_rect.Valid())
     return;
 
   EndRenderPass();
@@ -1777,24 +2384,32 @@ void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit()
   const Vulkan::Util::DebugScope debugScope(cmdbuf, "GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit");
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-  BeginRenderPass(m_vram_update_depth_render_pass, m_vram_update_depth_framebuffer, 0, 0, m_vram_texture.GetWidth(),
-                  m_vram_texture.GetHeight());
+  const Common::Rectangle<u32> scaled_rect(m_vram_depth_dirty_rect * m_resolution_scale);
+  BeginRenderPass(m_vram_update_depth_render_pass, m_vram_update_depth_framebuffer, scaled_rect.left, scaled_rect.top,
+                  scaled_rect.GetWidth(), scaled_rect.GetHeight());
 
   vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_update_depth_pipeline);
   vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
                           &m_vram_read_descriptor_set, 0, nullptr);
-  Vulkan::Util::SetViewportAndScissor(cmdbuf, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  Vulkan::Util::SetViewport(cmdbuf, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  Vulkan::Util::SetScissor(cmdbuf, scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(),
+                           scaled_rect.GetHeight());
   vkCmdDraw(cmdbuf, 3, 1, 0, 0);
 
   EndRenderPass();
 
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  m_vram_depth_dirty_rect.SetInvalid();
 
   RestoreGraphicsAPIState();
 }
 
 void GPU_HW_Vulkan::ClearDepthBuffer()
 {
+  m_last_depth_z = 1.0f;
+  if (!m_vram_depth_dirty_rect.Valid())
+    return;
+
   EndRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
@@ -1807,7 +2422,7 @@ void GPU_HW_Vulkan::ClearDepthBuffer()
                               &dsrr);
 
   m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-  m_last_depth_z = 1.0f;
+  m_vram_depth_dirty_rect.SetInvalid();
 }
 
 bool GPU_HW_Vulkan::BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width,
@@ -1852,6 +2467,7 @@ bool GPU_HW_Vulkan::BlitVRAMReplacementTexture(const TextureReplacementTexture*
 
 void GPU_HW_Vulkan::DownsampleFramebuffer(Vulkan::Texture& source, u32 left, u32 top, u32 width, u32 height)
 {
+  g_host_display->SetGPUTimingSection(GPUTimingSection::Downsample);
   if (m_downsample_mode == GPUDownsampleMode::Adaptive)
     DownsampleFramebufferAdaptive(source, left, top, width, height);
   else
@@ -1911,34 +2527,25 @@ void GPU_HW_Vulkan::DownsampleFramebufferAdaptive(Vulkan::Texture& source, u32 l
   m_downsample_texture.TransitionSubresourcesToLayout(cmdbuf, 0, 1, 0, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-  // creating mip chain
+  // creating mip chain, all levels in a single dispatch
   const u32 levels = m_downsample_texture.GetLevels();
-  for (u32 level = 1; level < levels; level++)
   {
-    const Vulkan::Util::DebugScope mip_scope(cmdbuf, "Generate Mip: %u", level);
-    m_downsample_texture.TransitionSubresourcesToLayout(
-      cmdbuf, level, 1, 0, 1, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-    static constexpr VkClearValue clear_color = {};
-    BeginRenderPass(m_downsample_render_pass, m_downsample_mip_views[level].framebuffer, 0, 0,
-                    m_downsample_texture.GetMipWidth(level), m_downsample_texture.GetMipHeight(level), &clear_color);
-    Vulkan::Util::SetViewportAndScissor(cmdbuf, left >> level, top >> level, width >> level, height >> level);
-    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      (level == 1) ? m_downsample_first_pass_pipeline : m_downsample_mid_pass_pipeline);
-    vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_downsample_pipeline_layout, 0, 1,
-                            &m_downsample_mip_views[level - 1].descriptor_set, 0, nullptr);
-
-    const SmoothingUBOData ubo = GetSmoothingUBO(level, left, top, width, height, m_downsample_texture.GetWidth(),
-                                                 m_downsample_texture.GetHeight());
-    vkCmdPushConstants(cmdbuf, m_downsample_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                       0, sizeof(ubo), &ubo);
-
-    vkCmdDraw(cmdbuf, 3, 1, 0, 0);
-
-    EndRenderPass();
-
-    m_downsample_texture.TransitionSubresourcesToLayout(
-      cmdbuf, level, 1, 0, 1, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    const Vulkan::Util::DebugScope mip_scope(cmdbuf, "Generate Mips");
+    m_downsample_texture.TransitionSubresourcesToLayout(cmdbuf, 1, levels - 1, 0, 1,
+                                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                        VK_IMAGE_LAYOUT_GENERAL);
+
+    u32 groups_x, groups_y;
+    const SmoothingComputeUBOData ubo = GetSmoothingComputeUBO(left, top, width, height, &groups_x, &groups_y);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_COMPUTE, m_downsample_compute_pipeline);
+    vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_COMPUTE, m_downsample_compute_pipeline_layout, 0, 1,
+                            &m_downsample_compute_descriptor_set, 0, nullptr);
+    vkCmdPushConstants(cmdbuf, m_downsample_compute_pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ubo),
+                       &ubo);
+    vkCmdDispatch(cmdbuf, groups_x, groups_y, 1);
+
+    m_downsample_texture.TransitionSubresourcesToLayout(cmdbuf, 1, levels - 1, 0, 1, VK_IMAGE_LAYOUT_GENERAL,
+                                                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   }
 
   // blur pass at lowest resolution
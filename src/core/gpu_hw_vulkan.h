@@ -8,6 +8,8 @@
 #include <memory>
 #include <tuple>
 
+class GPU_HW_ShaderGen;
+
 class GPU_HW_Vulkan : public GPU_HW
 {
 public:
@@ -39,11 +41,14 @@ protected:
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
   void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DecodeTexturePage(u32 slot, GPUTextureMode mode, u32 page_x, u32 page_y, u32 palette_x,
+                         u32 palette_y) override;
 
 private:
   enum : u32
   {
     MAX_PUSH_CONSTANTS_SIZE = 64,
+    SPECULATIVE_READBACK_MIN_HITS = 2,
   };
   void SetCapabilities();
   void DestroyResources();
@@ -55,6 +60,14 @@ private:
   void EndRenderPass();
   void ExecuteCommandBuffer(bool wait_for_completion, bool restore_state);
 
+  void EncodeVRAMForReadback(VkCommandBuffer cmdbuf, const Common::Rectangle<u32>& copy_rect);
+  void UpdateSpeculativeReadbackArea(const Common::Rectangle<u32>& copy_rect);
+  bool CreateSpeculativeReadbackBuffer();
+  void DestroySpeculativeReadbackBuffer();
+  void BeginSpeculativeReadback();
+  void CompleteSpeculativeReadback();
+  void DropSpeculativeReadback();
+
   bool CreatePipelineLayouts();
   bool CreateSamplers();
 
@@ -66,8 +79,13 @@ private:
   bool CreateUniformBuffer();
   bool CreateTextureBuffer();
 
-  bool CompilePipelines();
-  void DestroyPipelines();
+  void PrecompileShaders(GPU_HW_ShaderGen& shadergen, const u8* texture_modes, u32 num_texture_modes,
+                         bool batch_pipelines, bool utility_pipelines);
+  bool CompilePipelines(bool batch_pipelines = true, bool utility_pipelines = true);
+  bool CompileBatchPipelines(GPU_HW_ShaderGen& shadergen, ShaderCompileProgressTracker& progress,
+                             const u8* texture_modes, u32 num_texture_modes);
+  bool CompileUtilityPipelines(GPU_HW_ShaderGen& shadergen, ShaderCompileProgressTracker& progress);
+  void DestroyPipelines(bool batch_pipelines = true, bool utility_pipelines = true);
 
   bool BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
 
@@ -82,6 +100,7 @@ private:
   VkRenderPass m_display_load_render_pass = VK_NULL_HANDLE;
   VkRenderPass m_display_discard_render_pass = VK_NULL_HANDLE;
   VkRenderPass m_vram_readback_render_pass = VK_NULL_HANDLE;
+  VkRenderPass m_decoded_texture_render_pass = VK_NULL_HANDLE;
 
   VkDescriptorSetLayout m_batch_descriptor_set_layout = VK_NULL_HANDLE;
   VkDescriptorSetLayout m_single_sampler_descriptor_set_layout = VK_NULL_HANDLE;
@@ -97,12 +116,28 @@ private:
   Vulkan::Texture m_vram_read_texture;
   Vulkan::Texture m_vram_readback_texture;
   Vulkan::Texture m_display_texture;
+  Vulkan::Texture m_decoded_texture_atlas;
   bool m_use_ssbos_for_vram_writes = false;
 
   VkFramebuffer m_vram_framebuffer = VK_NULL_HANDLE;
   VkFramebuffer m_vram_update_depth_framebuffer = VK_NULL_HANDLE;
   VkFramebuffer m_vram_readback_framebuffer = VK_NULL_HANDLE;
   VkFramebuffer m_display_framebuffer = VK_NULL_HANDLE;
+  VkFramebuffer m_decoded_texture_framebuffer = VK_NULL_HANDLE;
+
+  // Per-area regions for UpdateVRAMReadTexture(), kept around to avoid reallocating.
+  std::vector<VkImageCopy> m_vram_read_texture_copies;
+  std::vector<VkImageResolve> m_vram_read_texture_resolves;
+
+  // Areas which are read back on consecutive frames are copied at the end of the frame into this buffer, so that
+  // ReadVRAM() only has to wait on the fence rather than stalling for the whole round trip.
+  VkBuffer m_speculative_readback_buffer = VK_NULL_HANDLE;
+  VmaAllocation m_speculative_readback_allocation = VK_NULL_HANDLE;
+  const u8* m_speculative_readback_buffer_map = nullptr;
+  Common::Rectangle<u32> m_speculative_readback_rect;
+  u64 m_speculative_readback_fence_counter = 0;
+  u32 m_speculative_readback_hits = 0;
+  bool m_speculative_readback_pending = false;
 
   VkSampler m_point_sampler = VK_NULL_HANDLE;
   VkSampler m_linear_sampler = VK_NULL_HANDLE;
@@ -122,7 +157,7 @@ private:
   VkBufferView m_texture_stream_buffer_view = VK_NULL_HANDLE;
 
   // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  DimensionalArray<VkPipeline, 2, 2, 5, 9, 4, 3> m_batch_pipelines{};
+  DimensionalArray<VkPipeline, 2, 2, 5, 10, 4, 3> m_batch_pipelines{};
 
   // [wrapped][interlaced]
   DimensionalArray<VkPipeline, 2, 2> m_vram_fill_pipelines{};
@@ -134,6 +169,9 @@ private:
   VkPipeline m_vram_readback_pipeline = VK_NULL_HANDLE;
   VkPipeline m_vram_update_depth_pipeline = VK_NULL_HANDLE;
 
+  // [texture_mode], 4-bit and 8-bit palettes
+  std::array<VkPipeline, 2> m_decode_texture_page_pipelines{};
+
   // [depth_24][interlace_mode]
   DimensionalArray<VkPipeline, 3, 2> m_display_pipelines{};
 
@@ -159,8 +197,11 @@ private:
   VkDescriptorSetLayout m_downsample_composite_descriptor_set_layout = VK_NULL_HANDLE;
   VkPipelineLayout m_downsample_composite_pipeline_layout = VK_NULL_HANDLE;
   VkDescriptorSet m_downsample_composite_descriptor_set = VK_NULL_HANDLE;
+  VkDescriptorSetLayout m_downsample_compute_descriptor_set_layout = VK_NULL_HANDLE;
+  VkPipelineLayout m_downsample_compute_pipeline_layout = VK_NULL_HANDLE;
+  VkDescriptorSet m_downsample_compute_descriptor_set = VK_NULL_HANDLE;
   VkPipeline m_downsample_first_pass_pipeline = VK_NULL_HANDLE;
-  VkPipeline m_downsample_mid_pass_pipeline = VK_NULL_HANDLE;
+  VkPipeline m_downsample_compute_pipeline = VK_NULL_HANDLE;
   VkPipeline m_downsample_blur_pass_pipeline = VK_NULL_HANDLE;
   VkPipeline m_downsample_composite_pass_pipeline = VK_NULL_HANDLE;
 };
@@ -3,6 +3,7 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/make_array.h"
+#include "common/pixel_conversion.h"
 #include "common/platform.h"
 #include "host_display.h"
 #include "system.h"
@@ -28,10 +29,7 @@ ALWAYS_INLINE static constexpr std::tuple<T, T> MinMax(T v1, T v2)
     return std::tie(v1, v2);
 }
 
-GPU_SW::GPU_SW()
-{
-  m_vram_ptr = m_backend.GetVRAM();
-}
+GPU_SW::GPU_SW() : m_backend(m_vram_shadow.data()) {}
 
 GPU_SW::~GPU_SW()
 {
@@ -235,15 +233,13 @@ ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGB565, u16>(const u16* src_
 template<>
 ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::RGBA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
 {
-  for (u32 col = 0; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::RGBA8, u32>(*(src_ptr++));
+  PixelConversion::ConvertRGBA5551ToRGBA8(dst_ptr, src_ptr, width);
 }
 
 template<>
 ALWAYS_INLINE void CopyOutRow16<GPUTexture::Format::BGRA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
 {
-  for (u32 col = 0; col < width; col++)
-    *(dst_ptr++) = VRAM16ToOutput<GPUTexture::Format::BGRA8, u32>(*(src_ptr++));
+  PixelConversion::ConvertRGBA5551ToBGRA8(dst_ptr, src_ptr, width, 0xFF000000u);
 }
 
 template<GPUTexture::Format display_format>
@@ -259,15 +255,15 @@ void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field
   if (!texture)
     return;
 
-  if (!interlaced)
-  {
-    if (!g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride))
-      return;
-  }
-  else
+  // Progressive output is converted straight into the display's upload memory. Interlaced output has to keep the
+  // other field around, so it goes through our buffer, as does anything the display can't map.
+  const bool direct_update =
+    !interlaced &&
+    g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride);
+  if (!direct_update)
   {
     dst_stride = GPU_MAX_DISPLAY_WIDTH * sizeof(OutputPixelType);
-    dst_ptr = m_display_texture_buffer.data() + (field != 0 ? dst_stride : 0);
+    dst_ptr = m_display_texture_buffer.data() + ((interlaced && field != 0) ? dst_stride : 0);
   }
 
   const u32 output_stride = dst_stride;
@@ -308,7 +304,7 @@ void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field
     }
   }
 
-  if (!interlaced)
+  if (direct_update)
     g_host_display->EndTextureUpdate(texture, 0, 0, width, height);
   else
     g_host_display->UpdateTexture(texture, 0, 0, width, height, m_display_texture_buffer.data(), output_stride);
@@ -352,15 +348,13 @@ void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 heigh
   if (!texture)
     return;
 
-  if (!interlaced)
-  {
-    if (!g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride))
-      return;
-  }
-  else
+  const bool direct_update =
+    !interlaced &&
+    g_host_display->BeginTextureUpdate(texture, width, height, reinterpret_cast<void**>(&dst_ptr), &dst_stride);
+  if (!direct_update)
   {
     dst_stride = Common::AlignUpPow2<u32>(width * sizeof(OutputPixelType), 4);
-    dst_ptr = m_display_texture_buffer.data() + (field != 0 ? dst_stride : 0);
+    dst_ptr = m_display_texture_buffer.data() + ((interlaced && field != 0) ? dst_stride : 0);
   }
 
   const u32 output_stride = dst_stride;
@@ -377,28 +371,11 @@ void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 heigh
     {
       if constexpr (display_format == GPUTexture::Format::RGBA8)
       {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = *(src_row_ptr++);
-          *(dst_row_ptr++) = 0xFF;
-        }
+        PixelConversion::ConvertRGB888ToRGBA8(reinterpret_cast<u32*>(dst_ptr), src_ptr, width);
       }
       else if constexpr (display_format == GPUTexture::Format::BGRA8)
       {
-        const u8* src_row_ptr = src_ptr;
-        u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-        for (u32 col = 0; col < width; col++)
-        {
-          *(dst_row_ptr++) = src_row_ptr[2];
-          *(dst_row_ptr++) = src_row_ptr[1];
-          *(dst_row_ptr++) = src_row_ptr[0];
-          *(dst_row_ptr++) = 0xFF;
-          src_row_ptr += 3;
-        }
+        PixelConversion::ConvertRGB888ToBGRA8(reinterpret_cast<u32*>(dst_ptr), src_ptr, width);
       }
       else if constexpr (display_format == GPUTexture::Format::RGB565)
       {
@@ -465,7 +442,7 @@ void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 heigh
     }
   }
 
-  if (!interlaced)
+  if (direct_update)
     g_host_display->EndTextureUpdate(texture, 0, 0, width, height);
   else
     g_host_display->UpdateTexture(texture, 0, 0, width, height, m_display_texture_buffer.data(), output_stride);
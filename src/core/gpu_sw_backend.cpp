@@ -1,23 +1,36 @@
 #include "gpu_sw_backend.h"
 #include "common/assert.h"
 #include "common/log.h"
-#include "gpu_sw_backend.h"
+#include "common/platform.h"
 #include "host_display.h"
+#include "settings.h"
 #include "system.h"
 #include <algorithm>
 Log_SetChannel(GPU_SW_Backend);
 
-GPU_SW_Backend::GPU_SW_Backend() : GPUBackend()
+#ifdef USE_SIMD_SPANS
+#include <emmintrin.h>
+#endif
+
+GPU_SW_Backend::GPU_SW_Backend(u16* vram) : GPUBackend()
 {
-  m_vram.fill(0);
-  m_vram_ptr = m_vram.data();
+  m_vram_ptr = vram;
+  std::fill_n(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT, static_cast<u16>(0));
 }
 
-GPU_SW_Backend::~GPU_SW_Backend() = default;
+GPU_SW_Backend::~GPU_SW_Backend()
+{
+  StopWorkerThreads();
+}
 
 bool GPU_SW_Backend::Initialize(bool force_thread)
 {
-  return GPUBackend::Initialize(force_thread);
+  if (!GPUBackend::Initialize(force_thread))
+    return false;
+
+  m_tile_binning = g_settings.gpu_sw_tile_binning;
+  StartWorkerThreads(g_settings.gpu_sw_worker_threads);
+  return true;
 }
 
 void GPU_SW_Backend::Reset(bool clear_vram)
@@ -25,10 +38,54 @@ void GPU_SW_Backend::Reset(bool clear_vram)
   GPUBackend::Reset(clear_vram);
 
   if (clear_vram)
-    m_vram.fill(0);
+    std::fill_n(m_vram_ptr, VRAM_WIDTH * VRAM_HEIGHT, static_cast<u16>(0));
+}
+
+void GPU_SW_Backend::Shutdown()
+{
+  GPUBackend::Shutdown();
+  StopWorkerThreads();
+}
+
+void GPU_SW_Backend::UpdateSettings()
+{
+  GPUBackend::UpdateSettings();
+  FlushRender();
+
+  m_tile_binning = g_settings.gpu_sw_tile_binning;
+
+  if (m_worker_threads.size() != g_settings.gpu_sw_worker_threads)
+  {
+    StopWorkerThreads();
+    StartWorkerThreads(g_settings.gpu_sw_worker_threads);
+  }
 }
 
 void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+{
+  if (IsQueueingDraws())
+    QueueDraw(cmd);
+  else
+    RasterizePolygon(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  if (IsQueueingDraws())
+    QueueDraw(cmd);
+  else
+    RasterizeRectangle(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  if (IsQueueingDraws())
+    QueueDraw(cmd);
+  else
+    RasterizeLine(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::RasterizePolygon(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& clip)
 {
   const GPURenderCommand rc{cmd->rc.bits};
   const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
@@ -36,28 +93,321 @@ void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
   const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
     rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
 
-  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2], clip);
   if (rc.quad_polygon)
-    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3], clip);
 }
 
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::RasterizeRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& clip)
 {
   const GPURenderCommand rc{cmd->rc.bits};
 
   const DrawRectangleFunction DrawFunction =
     GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
 
-  (this->*DrawFunction)(cmd);
+  (this->*DrawFunction)(cmd, clip);
 }
 
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+void GPU_SW_Backend::RasterizeLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& clip)
 {
   const DrawLineFunction DrawFunction =
     GetDrawLineFunction(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
 
   for (u16 i = 1; i < cmd->num_vertices; i++)
-    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i]);
+    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i], clip);
+}
+
+void GPU_SW_Backend::StartWorkerThreads(u32 count)
+{
+  DebugAssert(m_worker_threads.empty() && m_queued_draws.empty());
+  if (count == 0)
+    return;
+
+  m_workers_shutdown = false;
+  m_worker_threads.resize(count);
+  for (u32 i = 0; i < count; i++)
+  {
+    m_worker_threads[i].Start(
+      [this, i, generation = m_worker_generation]() { WorkerThreadEntryPoint(i + 1, generation); });
+  }
+
+  Log_InfoPrintf("Started %u software renderer worker threads.", count);
+}
+
+void GPU_SW_Backend::StopWorkerThreads()
+{
+  if (m_worker_threads.empty())
+    return;
+
+  FlushRender();
+
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_workers_shutdown = true;
+  }
+  m_worker_start_cv.notify_all();
+
+  for (Threading::Thread& thread : m_worker_threads)
+    thread.Join();
+  m_worker_threads.clear();
+}
+
+void GPU_SW_Backend::WorkerThreadEntryPoint(u32 slice, u32 generation)
+{
+  Threading::SetNameOfCurrentThread("GPU SW Worker");
+
+  for (;;)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_worker_mutex);
+      m_worker_start_cv.wait(lock, [this, generation]() {
+        return m_workers_shutdown || m_worker_generation != generation;
+      });
+      if (m_workers_shutdown)
+        break;
+
+      generation = m_worker_generation;
+    }
+
+    RasterizeQueuedDraws(slice);
+
+    {
+      std::unique_lock<std::mutex> lock(m_worker_mutex);
+      if ((--m_workers_remaining) == 0)
+        m_worker_done_cv.notify_one();
+    }
+  }
+}
+
+static bool RangesOverlap(u32 start, u32 length, u32 range_start, u32 range_end)
+{
+  // handle wrap-around by checking both halves
+  if ((start + length) > VRAM_WIDTH)
+  {
+    return RangesOverlap(start, VRAM_WIDTH - start, range_start, range_end) ||
+           RangesOverlap(0, start + length - VRAM_WIDTH, range_start, range_end);
+  }
+
+  return (start <= range_end && (start + length - 1) >= range_start);
+}
+
+bool GPU_SW_Backend::DoesDrawReadQueuedArea(const GPUBackendDrawCommand* cmd) const
+{
+  // Queued draws only ever write inside the drawing area, and the drawing area can't change while draws are queued.
+  if (cmd->type == GPUBackendCommandType::DrawLine || !cmd->rc.texture_enable)
+    return false;
+
+  u32 page_width;
+  u32 palette_width;
+  switch (cmd->draw_mode.texture_mode)
+  {
+    case GPUTextureMode::Palette4Bit:
+      page_width = TEXTURE_PAGE_WIDTH / 4;
+      palette_width = 16;
+      break;
+
+    case GPUTextureMode::Palette8Bit:
+      page_width = TEXTURE_PAGE_WIDTH / 2;
+      palette_width = 256;
+      break;
+
+    default:
+      page_width = TEXTURE_PAGE_WIDTH;
+      palette_width = 0;
+      break;
+  }
+
+  const u32 page_y = cmd->draw_mode.GetTexturePageBaseY();
+  if (page_y <= m_drawing_area.bottom && (page_y + TEXTURE_PAGE_HEIGHT - 1) >= m_drawing_area.top &&
+      RangesOverlap(cmd->draw_mode.GetTexturePageBaseX(), page_width, m_drawing_area.left, m_drawing_area.right))
+  {
+    return true;
+  }
+
+  const u32 palette_y = cmd->palette.GetYBase();
+  return (palette_width > 0 && palette_y >= m_drawing_area.top && palette_y <= m_drawing_area.bottom &&
+          RangesOverlap(cmd->palette.GetXBase(), palette_width, m_drawing_area.left, m_drawing_area.right));
+}
+
+void GPU_SW_Backend::QueueDraw(const GPUBackendDrawCommand* cmd)
+{
+  // Nothing can be drawn with an empty drawing area.
+  if (m_drawing_area.left > m_drawing_area.right || m_drawing_area.top > m_drawing_area.bottom)
+    return;
+
+  // Sampling from rows another thread is still writing to would race, so finish those draws first.
+  if (m_queued_draw_count > 0 && DoesDrawReadQueuedArea(cmd))
+    FlushRender();
+
+  const u8* cmd_ptr = reinterpret_cast<const u8*>(cmd);
+  const u32 offset = static_cast<u32>(m_queued_draws.size());
+  m_queued_draws.insert(m_queued_draws.end(), cmd_ptr, cmd_ptr + cmd->size);
+  m_queued_draw_count++;
+
+  if (m_tile_binning)
+    BinQueuedDraw(cmd, offset);
+
+  if (m_queued_draw_count >= MAX_QUEUED_DRAWS)
+    FlushRender();
+}
+
+Common::Rectangle<u32> GPU_SW_Backend::GetDrawBounds(const GPUBackendDrawCommand* cmd) const
+{
+  // Coordinates outside of the range the rasterizers see directly wrap around, so just assume the whole area.
+  s32 min_x, min_y, max_x, max_y;
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::DrawPolygon:
+    {
+      const GPUBackendDrawPolygonCommand* pcmd = static_cast<const GPUBackendDrawPolygonCommand*>(cmd);
+      const u32 num_vertices = pcmd->rc.quad_polygon ? 4 : 3;
+      min_x = max_x = pcmd->vertices[0].x;
+      min_y = max_y = pcmd->vertices[0].y;
+      for (u32 i = 1; i < num_vertices; i++)
+      {
+        min_x = std::min(min_x, pcmd->vertices[i].x);
+        max_x = std::max(max_x, pcmd->vertices[i].x);
+        min_y = std::min(min_y, pcmd->vertices[i].y);
+        max_y = std::max(max_y, pcmd->vertices[i].y);
+      }
+      if (min_x < -1024 || max_x > 1023 || min_y < -1024 || max_y > 1023)
+        return m_drawing_area;
+    }
+    break;
+
+    case GPUBackendCommandType::DrawRectangle:
+    {
+      const GPUBackendDrawRectangleCommand* rcmd = static_cast<const GPUBackendDrawRectangleCommand*>(cmd);
+      min_x = rcmd->x;
+      min_y = rcmd->y;
+      max_x = rcmd->x + static_cast<s32>(rcmd->width) - 1;
+      max_y = rcmd->y + static_cast<s32>(rcmd->height) - 1;
+    }
+    break;
+
+    case GPUBackendCommandType::DrawLine:
+    default:
+    {
+      const GPUBackendDrawLineCommand* lcmd = static_cast<const GPUBackendDrawLineCommand*>(cmd);
+      min_x = max_x = lcmd->vertices[0].x;
+      min_y = max_y = lcmd->vertices[0].y;
+      for (u32 i = 1; i < lcmd->num_vertices; i++)
+      {
+        min_x = std::min(min_x, lcmd->vertices[i].x);
+        max_x = std::max(max_x, lcmd->vertices[i].x);
+        min_y = std::min(min_y, lcmd->vertices[i].y);
+        max_y = std::max(max_y, lcmd->vertices[i].y);
+      }
+      if (min_x < 0 || max_x > 2047 || min_y < 0 || max_y > 2047)
+        return m_drawing_area;
+    }
+    break;
+  }
+
+  return Common::Rectangle<u32>(static_cast<u32>(std::max(min_x, static_cast<s32>(m_drawing_area.left))),
+                                static_cast<u32>(std::max(min_y, static_cast<s32>(m_drawing_area.top))),
+                                static_cast<u32>(std::min(max_x, static_cast<s32>(m_drawing_area.right))),
+                                static_cast<u32>(std::min(max_y, static_cast<s32>(m_drawing_area.bottom))));
+}
+
+void GPU_SW_Backend::BinQueuedDraw(const GPUBackendDrawCommand* cmd, u32 offset)
+{
+  // Tiles are laid out from the top-left of the drawing area, which stays the same while draws are queued.
+  const Common::Rectangle<u32> bounds = GetDrawBounds(cmd);
+  if (static_cast<s32>(bounds.left) > static_cast<s32>(bounds.right) ||
+      static_cast<s32>(bounds.top) > static_cast<s32>(bounds.bottom))
+  {
+    return;
+  }
+
+  const u32 tiles_x = ((m_drawing_area.right - m_drawing_area.left) / TILE_SIZE) + 1;
+  const u32 tiles_y = ((m_drawing_area.bottom - m_drawing_area.top) / TILE_SIZE) + 1;
+  if (m_tile_draws.size() < (tiles_x * tiles_y))
+    m_tile_draws.resize(tiles_x * tiles_y);
+
+  const u32 start_tile_x = (bounds.left - m_drawing_area.left) / TILE_SIZE;
+  const u32 end_tile_x = (bounds.right - m_drawing_area.left) / TILE_SIZE;
+  const u32 start_tile_y = (bounds.top - m_drawing_area.top) / TILE_SIZE;
+  const u32 end_tile_y = (bounds.bottom - m_drawing_area.top) / TILE_SIZE;
+  for (u32 tile_y = start_tile_y; tile_y <= end_tile_y; tile_y++)
+  {
+    for (u32 tile_x = start_tile_x; tile_x <= end_tile_x; tile_x++)
+      m_tile_draws[tile_y * tiles_x + tile_x].push_back(offset);
+  }
+}
+
+void GPU_SW_Backend::RasterizeQueuedDraw(const GPUBackendCommand* cmd, const Common::Rectangle<u32>& clip)
+{
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::DrawPolygon:
+      RasterizePolygon(static_cast<const GPUBackendDrawPolygonCommand*>(cmd), clip);
+      break;
+
+    case GPUBackendCommandType::DrawRectangle:
+      RasterizeRectangle(static_cast<const GPUBackendDrawRectangleCommand*>(cmd), clip);
+      break;
+
+    case GPUBackendCommandType::DrawLine:
+      RasterizeLine(static_cast<const GPUBackendDrawLineCommand*>(cmd), clip);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GPU_SW_Backend::RasterizeQueuedTiles()
+{
+  // Threads pick up tiles until there are none left. Each tile's draws are in submission order.
+  const u32 tiles_x = ((m_drawing_area.right - m_drawing_area.left) / TILE_SIZE) + 1;
+  const u32 tiles_y = ((m_drawing_area.bottom - m_drawing_area.top) / TILE_SIZE) + 1;
+  const u32 tile_count = std::min(tiles_x * tiles_y, static_cast<u32>(m_tile_draws.size()));
+  for (;;)
+  {
+    const u32 tile = m_next_tile.fetch_add(1, std::memory_order_relaxed);
+    if (tile >= tile_count)
+      break;
+
+    const std::vector<u32>& draws = m_tile_draws[tile];
+    if (draws.empty())
+      continue;
+
+    const u32 left = m_drawing_area.left + ((tile % tiles_x) * TILE_SIZE);
+    const u32 top = m_drawing_area.top + ((tile / tiles_x) * TILE_SIZE);
+    const Common::Rectangle<u32> clip(left, top, std::min(left + TILE_SIZE - 1, m_drawing_area.right),
+                                      std::min(top + TILE_SIZE - 1, m_drawing_area.bottom));
+    for (const u32 offset : draws)
+      RasterizeQueuedDraw(reinterpret_cast<const GPUBackendCommand*>(&m_queued_draws[offset]), clip);
+  }
+}
+
+void GPU_SW_Backend::RasterizeQueuedDraws(u32 slice)
+{
+  if (m_tile_binning)
+  {
+    RasterizeQueuedTiles();
+    return;
+  }
+
+  // Each thread owns a horizontal band of the drawing area, so draws can't race each other while staying in order.
+  const u32 slice_count = static_cast<u32>(m_worker_threads.size()) + 1;
+  const u32 area_height = m_drawing_area.bottom - m_drawing_area.top + 1;
+  const u32 band_top = m_drawing_area.top + ((area_height * slice) / slice_count);
+  const u32 band_bottom = m_drawing_area.top + ((area_height * (slice + 1)) / slice_count);
+  if (band_top == band_bottom)
+    return;
+
+  const Common::Rectangle<u32> clip(m_drawing_area.left, band_top, m_drawing_area.right, band_bottom - 1);
+
+  const u8* ptr = m_queued_draws.data();
+  const u8* end = ptr + m_queued_draws.size();
+  while (ptr < end)
+  {
+    const GPUBackendCommand* cmd = reinterpret_cast<const GPUBackendCommand*>(ptr);
+    ptr += cmd->size;
+    RasterizeQueuedDraw(cmd, clip);
+  }
 }
 
 constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
@@ -79,51 +429,50 @@ constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
 
 static constexpr GPU_SW_Backend::DitherLUT s_dither_lut = GPU_SW_Backend::ComputeDitherLUT();
 
-template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
-                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+u16 ALWAYS_INLINE_RELEASE GPU_SW_Backend::FetchTexel(const GPUBackendDrawCommand* cmd, u8 texcoord_x,
+                                                     u8 texcoord_y) const
 {
-  VRAMPixel color;
-  if constexpr (texture_enable)
-  {
-    // Apply texture window
-    texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
-    texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
+  // Apply texture window
+  texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
+  texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
-    VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
+  switch (cmd->draw_mode.texture_mode)
+  {
+    case GPUTextureMode::Palette4Bit:
     {
-      case GPUTextureMode::Palette4Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
 
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
 
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+    case GPUTextureMode::Palette8Bit:
+    {
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
 
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-      }
-      break;
+    default:
+    {
+      return GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
     }
+  }
+}
 
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
+                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+{
+  VRAMPixel color;
+  if constexpr (texture_enable)
+  {
+    const VRAMPixel texture_color{FetchTexel(cmd, texcoord_x, texcoord_y)};
     if (texture_color.bits == 0)
       return;
 
@@ -219,8 +568,168 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
   SetPixel(static_cast<u32>(x), static_cast<u32>(y), color.bits | cmd->params.GetMaskOR());
 }
 
+#ifdef USE_SIMD_SPANS
+
+bool GPU_SW_Backend::CanShadeSpanInGroups(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 width)
+{
+  // Texels are fetched for a whole group before any pixel is written, so the span can't sample the row it's drawing.
+  if (!cmd->rc.texture_enable)
+    return true;
+
+  u32 page_width;
+  u32 palette_width;
+  switch (cmd->draw_mode.texture_mode)
+  {
+    case GPUTextureMode::Palette4Bit:
+      page_width = TEXTURE_PAGE_WIDTH / 4;
+      palette_width = 16;
+      break;
+
+    case GPUTextureMode::Palette8Bit:
+      page_width = TEXTURE_PAGE_WIDTH / 2;
+      palette_width = 256;
+      break;
+
+    default:
+      page_width = TEXTURE_PAGE_WIDTH;
+      palette_width = 0;
+      break;
+  }
+
+  const u32 page_y = cmd->draw_mode.GetTexturePageBaseY();
+  if (y >= page_y && y < (page_y + TEXTURE_PAGE_HEIGHT) &&
+      RangesOverlap(cmd->draw_mode.GetTexturePageBaseX(), page_width, x, x + width - 1))
+  {
+    return false;
+  }
+
+  return (palette_width == 0 || y != cmd->palette.GetYBase() ||
+          !RangesOverlap(cmd->palette.GetXBase(), palette_width, x, x + width - 1));
+}
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixelGroup(const GPUBackendDrawCommand* cmd, u32 x, u32 y,
+                                                           const u8* color_r, const u8* color_g, const u8* color_b,
+                                                           const u16* texels)
+{
+  // Same as ShadePixel() for PIXEL_GROUP_SIZE consecutive pixels. The dither LUT is replaced by the equivalent
+  // clamp((value + offset) >> 3), and blending is done per-channel, which matches blargg's math bit-for-bit.
+  alignas(16) s16 dither_offsets[PIXEL_GROUP_SIZE];
+  for (u32 i = 0; i < PIXEL_GROUP_SIZE; i++)
+    dither_offsets[i] = static_cast<s16>(dithering_enable ? DITHER_MATRIX[y & 3u][(x + i) & 3u] : DITHER_MATRIX[2][3]);
+
+  u16* dst_ptr = GetPixelPtr(x, y);
+  const u16 mask_and = cmd->params.GetMaskAND();
+  const u16 mask_or = cmd->params.GetMaskOR();
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i channel_mask = _mm_set1_epi16(0x1F);
+  const __m128i max_channel = _mm_set1_epi16(0x1F);
+  const __m128i bit15 = _mm_set1_epi16(static_cast<s16>(0x8000));
+  const __m128i offsets = _mm_load_si128(reinterpret_cast<const __m128i*>(dither_offsets));
+
+  const auto dither = [&](__m128i value) {
+    return _mm_max_epi16(_mm_min_epi16(_mm_srai_epi16(_mm_add_epi16(value, offsets), 3), max_channel), zero);
+  };
+  const auto load_colors = [&](const u8* ptr) {
+    return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)), zero);
+  };
+
+  __m128i color;
+  __m128i write_mask = _mm_cmpeq_epi16(zero, zero);
+  if constexpr (texture_enable)
+  {
+    const __m128i texel = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texels));
+    write_mask = _mm_andnot_si128(_mm_cmpeq_epi16(texel, zero), write_mask);
+
+    if constexpr (raw_texture_enable)
+    {
+      color = texel;
+    }
+    else
+    {
+      const __m128i tr = _mm_and_si128(texel, channel_mask);
+      const __m128i tg = _mm_and_si128(_mm_srli_epi16(texel, 5), channel_mask);
+      const __m128i tb = _mm_and_si128(_mm_srli_epi16(texel, 10), channel_mask);
+      const __m128i r = dither(_mm_srli_epi16(_mm_mullo_epi16(tr, load_colors(color_r)), 4));
+      const __m128i g = dither(_mm_srli_epi16(_mm_mullo_epi16(tg, load_colors(color_g)), 4));
+      const __m128i b = dither(_mm_srli_epi16(_mm_mullo_epi16(tb, load_colors(color_b)), 4));
+      color = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi16(g, 5)),
+                           _mm_or_si128(_mm_slli_epi16(b, 10), _mm_and_si128(texel, bit15)));
+    }
+  }
+  else
+  {
+    const __m128i r = dither(load_colors(color_r));
+    const __m128i g = dither(load_colors(color_g));
+    const __m128i b = dither(load_colors(color_b));
+    color = _mm_or_si128(r, _mm_or_si128(_mm_slli_epi16(g, 5), _mm_slli_epi16(b, 10)));
+  }
+
+  const __m128i bg = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst_ptr));
+  if constexpr (transparency_enable)
+  {
+    const __m128i fr = _mm_and_si128(color, channel_mask);
+    const __m128i fg = _mm_and_si128(_mm_srli_epi16(color, 5), channel_mask);
+    const __m128i fb = _mm_and_si128(_mm_srli_epi16(color, 10), channel_mask);
+    const __m128i br = _mm_and_si128(bg, channel_mask);
+    const __m128i bgg = _mm_and_si128(_mm_srli_epi16(bg, 5), channel_mask);
+    const __m128i bb = _mm_and_si128(_mm_srli_epi16(bg, 10), channel_mask);
+
+    __m128i r, g, b;
+    switch (cmd->draw_mode.transparency_mode)
+    {
+      case GPUTransparencyMode::HalfBackgroundPlusHalfForeground:
+        r = _mm_srli_epi16(_mm_add_epi16(br, fr), 1);
+        g = _mm_srli_epi16(_mm_add_epi16(bgg, fg), 1);
+        b = _mm_srli_epi16(_mm_add_epi16(bb, fb), 1);
+        break;
+
+      case GPUTransparencyMode::BackgroundPlusForeground:
+        r = _mm_min_epi16(_mm_add_epi16(br, fr), max_channel);
+        g = _mm_min_epi16(_mm_add_epi16(bgg, fg), max_channel);
+        b = _mm_min_epi16(_mm_add_epi16(bb, fb), max_channel);
+        break;
+
+      case GPUTransparencyMode::BackgroundMinusForeground:
+        r = _mm_subs_epu16(br, fr);
+        g = _mm_subs_epu16(bgg, fg);
+        b = _mm_subs_epu16(bb, fb);
+        break;
+
+      case GPUTransparencyMode::BackgroundPlusQuarterForeground:
+      default:
+        r = _mm_min_epi16(_mm_add_epi16(br, _mm_srli_epi16(fr, 2)), max_channel);
+        g = _mm_min_epi16(_mm_add_epi16(bgg, _mm_srli_epi16(fg, 2)), max_channel);
+        b = _mm_min_epi16(_mm_add_epi16(bb, _mm_srli_epi16(fb, 2)), max_channel);
+        break;
+    }
+
+    // Non-textured transparent polygons don't set bit 15, but are treated as transparent.
+    __m128i blended = _mm_or_si128(r, _mm_or_si128(_mm_slli_epi16(g, 5), _mm_slli_epi16(b, 10)));
+    if constexpr (texture_enable)
+    {
+      const __m128i blend_mask = _mm_cmpeq_epi16(_mm_and_si128(color, bit15), bit15);
+      blended = _mm_or_si128(blended, bit15);
+      color = _mm_or_si128(_mm_and_si128(blend_mask, blended), _mm_andnot_si128(blend_mask, color));
+    }
+    else
+    {
+      color = blended;
+    }
+  }
+
+  write_mask =
+    _mm_and_si128(write_mask, _mm_cmpeq_epi16(_mm_and_si128(bg, _mm_set1_epi16(static_cast<s16>(mask_and))), zero));
+  color = _mm_or_si128(color, _mm_set1_epi16(static_cast<s16>(mask_or)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr),
+                   _mm_or_si128(_mm_and_si128(write_mask, color), _mm_andnot_si128(write_mask, bg)));
+}
+
+#endif // USE_SIMD_SPANS
+
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& clip)
 {
   const s32 origin_x = cmd->x;
   const s32 origin_y = cmd->y;
@@ -230,7 +739,7 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
   for (u32 offset_y = 0; offset_y < cmd->height; offset_y++)
   {
     const s32 y = origin_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom) ||
+    if (y < static_cast<s32>(clip.top) || y > static_cast<s32>(clip.bottom) ||
         (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)))
     {
       continue;
@@ -241,7 +750,7 @@ void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
     for (u32 offset_x = 0; offset_x < cmd->width; offset_x++)
     {
       const s32 x = origin_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
+      if (x < static_cast<s32>(clip.left) || x > static_cast<s32>(clip.right))
         continue;
 
       const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
@@ -361,7 +870,7 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::AddIDeltas_DY(i_group& ig, const i_de
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
          bool dithering_enable>
 void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                              const i_deltas& idl)
+                              const i_deltas& idl, const Common::Rectangle<u32>& clip)
 {
   if (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u))
     return;
@@ -370,16 +879,16 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   s32 w = x_bound - x_start;
   s32 x = TruncateGPUVertexPosition(x_start);
 
-  if (x < static_cast<s32>(m_drawing_area.left))
+  if (x < static_cast<s32>(clip.left))
   {
-    s32 delta = static_cast<s32>(m_drawing_area.left) - x;
+    s32 delta = static_cast<s32>(clip.left) - x;
     x_ig_adjust += delta;
     x += delta;
     w -= delta;
   }
 
-  if ((x + w) > (static_cast<s32>(m_drawing_area.right) + 1))
-    w = static_cast<s32>(m_drawing_area.right) + 1 - x;
+  if ((x + w) > (static_cast<s32>(clip.right) + 1))
+    w = static_cast<s32>(clip.right) + 1 - x;
 
   if (w <= 0)
     return;
@@ -387,6 +896,42 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, x_ig_adjust);
   AddIDeltas_DY<shading_enable, texture_enable>(ig, idl, y);
 
+#ifdef USE_SIMD_SPANS
+  if (w >= static_cast<s32>(PIXEL_GROUP_SIZE) &&
+      CanShadeSpanInGroups(cmd, static_cast<u32>(x), static_cast<u32>(y), static_cast<u32>(w)))
+  {
+    do
+    {
+      alignas(16) u8 group_r[PIXEL_GROUP_SIZE];
+      alignas(16) u8 group_g[PIXEL_GROUP_SIZE];
+      alignas(16) u8 group_b[PIXEL_GROUP_SIZE];
+      alignas(16) u16 group_texels[PIXEL_GROUP_SIZE];
+      for (u32 i = 0; i < PIXEL_GROUP_SIZE; i++)
+      {
+        group_r[i] = Truncate8(ig.r >> (COORD_FBS + COORD_POST_PADDING));
+        group_g[i] = Truncate8(ig.g >> (COORD_FBS + COORD_POST_PADDING));
+        group_b[i] = Truncate8(ig.b >> (COORD_FBS + COORD_POST_PADDING));
+        if constexpr (texture_enable)
+        {
+          group_texels[i] = FetchTexel(cmd, Truncate8(ig.u >> (COORD_FBS + COORD_POST_PADDING)),
+                                       Truncate8(ig.v >> (COORD_FBS + COORD_POST_PADDING)));
+        }
+
+        AddIDeltas_DX<shading_enable, texture_enable>(ig, idl);
+      }
+
+      ShadePixelGroup<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+        cmd, static_cast<u32>(x), static_cast<u32>(y), group_r, group_g, group_b, group_texels);
+
+      x += PIXEL_GROUP_SIZE;
+      w -= PIXEL_GROUP_SIZE;
+    } while (w >= static_cast<s32>(PIXEL_GROUP_SIZE));
+
+    if (w == 0)
+      return;
+  }
+#endif
+
   do
   {
     const u32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
@@ -409,7 +954,8 @@ template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool
 void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
                                   const GPUBackendDrawPolygonCommand::Vertex* v0,
                                   const GPUBackendDrawPolygonCommand::Vertex* v1,
-                                  const GPUBackendDrawPolygonCommand::Vertex* v2)
+                                  const GPUBackendDrawPolygonCommand::Vertex* v2,
+                                  const Common::Rectangle<u32>& clip)
 {
   u32 core_vertex;
   {
@@ -564,14 +1110,14 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
 
         s32 y = TruncateGPUVertexPosition(yi);
 
-        if (y < static_cast<s32>(m_drawing_area.top))
+        if (y < static_cast<s32>(clip.top))
           break;
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(clip.bottom))
           continue;
 
         DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+          cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl, clip);
       }
     }
     else
@@ -580,14 +1126,14 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
       {
         s32 y = TruncateGPUVertexPosition(yi);
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(clip.bottom))
           break;
 
-        if (y >= static_cast<s32>(m_drawing_area.top))
+        if (y >= static_cast<s32>(clip.top))
         {
 
           DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-            cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+            cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl, clip);
         }
 
         yi++;
@@ -633,7 +1179,7 @@ static ALWAYS_INLINE_RELEASE s64 LineDivide(s64 delta, s32 dk)
 
 template<bool shading_enable, bool transparency_enable, bool dithering_enable>
 void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                              const GPUBackendDrawLineCommand::Vertex* p1)
+                              const GPUBackendDrawLineCommand::Vertex* p1, const Common::Rectangle<u32>& clip)
 {
   const s32 i_dx = std::abs(p1->x - p0->x);
   const s32 i_dy = std::abs(p1->y - p0->y);
@@ -693,8 +1239,8 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
     const s32 y = (cur_point.y >> Line_XY_FractBits) & 2047;
 
     if ((!cmd->params.interlaced_rendering || cmd->params.active_line_lsb != (Truncate8(static_cast<u32>(y)) & 1u)) &&
-        x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+        x >= static_cast<s32>(clip.left) && x <= static_cast<s32>(clip.right) &&
+        y >= static_cast<s32>(clip.top) && y <= static_cast<s32>(clip.bottom))
     {
       const u8 r = shading_enable ? static_cast<u8>(cur_point.r >> Line_RGB_FractBits) : p0->r;
       const u8 g = shading_enable ? static_cast<u8>(cur_point.g >> Line_RGB_FractBits) : p0->g;
@@ -870,7 +1416,35 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
   }
 }
 
-void GPU_SW_Backend::FlushRender() {}
+void GPU_SW_Backend::FlushRender()
+{
+  if (m_queued_draw_count == 0)
+    return;
+
+  m_next_tile.store(0, std::memory_order_relaxed);
+
+  if (!m_worker_threads.empty())
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_workers_remaining = static_cast<u32>(m_worker_threads.size());
+    m_worker_generation++;
+  }
+  m_worker_start_cv.notify_all();
+
+  // This thread takes the first band.
+  RasterizeQueuedDraws(0);
+
+  if (!m_worker_threads.empty())
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_worker_done_cv.wait(lock, [this]() { return m_workers_remaining == 0; });
+  }
+
+  m_queued_draws.clear();
+  m_queued_draw_count = 0;
+  for (std::vector<u32>& draws : m_tile_draws)
+    draws.clear();
+}
 
 void GPU_SW_Backend::DrawingAreaChanged() {}
 
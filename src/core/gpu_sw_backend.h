@@ -1,22 +1,39 @@
 #pragma once
+#include "common/platform.h"
 #include "gpu_backend.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <vector>
 
+#if defined(CPU_X64)
+#define USE_SIMD_SPANS 1
+#endif
+
 class GPU_SW_Backend final : public GPUBackend
 {
 public:
-  GPU_SW_Backend();
+  // vram is owned by the GPU, and only accessed from the backend thread while it's running.
+  GPU_SW_Backend(u16* vram);
   ~GPU_SW_Backend() override;
 
   bool Initialize(bool force_thread) override;
+  void UpdateSettings() override;
   void Reset(bool clear_vram) override;
+  void Shutdown() override;
 
-  ALWAYS_INLINE_RELEASE u16 GetPixel(const u32 x, const u32 y) const { return m_vram[VRAM_WIDTH * y + x]; }
-  ALWAYS_INLINE_RELEASE const u16* GetPixelPtr(const u32 x, const u32 y) const { return &m_vram[VRAM_WIDTH * y + x]; }
-  ALWAYS_INLINE_RELEASE u16* GetPixelPtr(const u32 x, const u32 y) { return &m_vram[VRAM_WIDTH * y + x]; }
-  ALWAYS_INLINE_RELEASE void SetPixel(const u32 x, const u32 y, const u16 value) { m_vram[VRAM_WIDTH * y + x] = value; }
+  ALWAYS_INLINE_RELEASE u16 GetPixel(const u32 x, const u32 y) const { return m_vram_ptr[VRAM_WIDTH * y + x]; }
+  ALWAYS_INLINE_RELEASE const u16* GetPixelPtr(const u32 x, const u32 y) const
+  {
+    return &m_vram_ptr[VRAM_WIDTH * y + x];
+  }
+  ALWAYS_INLINE_RELEASE u16* GetPixelPtr(const u32 x, const u32 y) { return &m_vram_ptr[VRAM_WIDTH * y + x]; }
+  ALWAYS_INLINE_RELEASE void SetPixel(const u32 x, const u32 y, const u16 value)
+  {
+    m_vram_ptr[VRAM_WIDTH * y + x] = value;
+  }
 
   // this is actually (31 * 255) >> 4) == 494, but to simplify addressing we use the next power of two (512)
   static constexpr u32 DITHER_LUT_SIZE = 512;
@@ -95,17 +112,53 @@ protected:
   void FlushRender() override;
   void DrawingAreaChanged() override;
 
+  void RasterizePolygon(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& clip);
+  void RasterizeRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& clip);
+  void RasterizeLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& clip);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Worker threads
+  //////////////////////////////////////////////////////////////////////////
+  void StartWorkerThreads(u32 count);
+  void StopWorkerThreads();
+  void WorkerThreadEntryPoint(u32 slice, u32 generation);
+  bool DoesDrawReadQueuedArea(const GPUBackendDrawCommand* cmd) const;
+  void QueueDraw(const GPUBackendDrawCommand* cmd);
+  void RasterizeQueuedDraw(const GPUBackendCommand* cmd, const Common::Rectangle<u32>& clip);
+  void RasterizeQueuedDraws(u32 slice);
+
+  ALWAYS_INLINE bool IsQueueingDraws() const { return (m_tile_binning || !m_worker_threads.empty()); }
+
+  // Tile binning, draws are rasterized one tile of the drawing area at a time to keep the working set in cache.
+  Common::Rectangle<u32> GetDrawBounds(const GPUBackendDrawCommand* cmd) const;
+  void BinQueuedDraw(const GPUBackendDrawCommand* cmd, u32 offset);
+  void RasterizeQueuedTiles();
+
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
+  u16 FetchTexel(const GPUBackendDrawCommand* cmd, u8 texcoord_x, u8 texcoord_y) const;
+
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
   void ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
                   u8 texcoord_y);
 
+#ifdef USE_SIMD_SPANS
+  // Spans are shaded this many pixels at a time when the SIMD path can be used.
+  static constexpr u32 PIXEL_GROUP_SIZE = 8;
+
+  static bool CanShadeSpanInGroups(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u32 width);
+
+  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+  void ShadePixelGroup(const GPUBackendDrawCommand* cmd, u32 x, u32 y, const u8* color_r, const u8* color_g,
+                       const u8* color_b, const u16* texels);
+#endif
+
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& clip);
 
-  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd);
+  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd,
+                                                         const Common::Rectangle<u32>& clip);
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
@@ -140,28 +193,49 @@ protected:
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
   void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                const i_deltas& idl);
+                const i_deltas& idl, const Common::Rectangle<u32>& clip);
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
   void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const GPUBackendDrawPolygonCommand::Vertex* v0,
-                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2);
+                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2,
+                    const Common::Rectangle<u32>& clip);
 
   using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v0,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v1,
-                                                        const GPUBackendDrawPolygonCommand::Vertex* v2);
+                                                        const GPUBackendDrawPolygonCommand::Vertex* v2,
+                                                        const Common::Rectangle<u32>& clip);
   DrawTriangleFunction GetDrawTriangleFunction(bool shading_enable, bool texture_enable, bool raw_texture_enable,
                                                bool transparency_enable, bool dithering_enable);
 
   template<bool shading_enable, bool transparency_enable, bool dithering_enable>
   void DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                const GPUBackendDrawLineCommand::Vertex* p1);
+                const GPUBackendDrawLineCommand::Vertex* p1, const Common::Rectangle<u32>& clip);
 
   using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd,
                                                     const GPUBackendDrawLineCommand::Vertex* p0,
-                                                    const GPUBackendDrawLineCommand::Vertex* p1);
+                                                    const GPUBackendDrawLineCommand::Vertex* p1,
+                                                    const Common::Rectangle<u32>& clip);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
-  std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
+  // Draws are queued when worker threads or tile binning are used, and split by rows or tiles of the drawing area.
+  // Anything touching VRAM outside of a draw flushes the queue first.
+  static constexpr u32 MAX_QUEUED_DRAWS = 1024;
+  static constexpr u32 TILE_SIZE = 64;
+
+  std::vector<Threading::Thread> m_worker_threads;
+  std::vector<u8> m_queued_draws;
+  u32 m_queued_draw_count = 0;
+
+  std::vector<std::vector<u32>> m_tile_draws;
+  std::atomic<u32> m_next_tile{0};
+  bool m_tile_binning = false;
+
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_start_cv;
+  std::condition_variable m_worker_done_cv;
+  u32 m_worker_generation = 0;
+  u32 m_workers_remaining = 0;
+  bool m_workers_shutdown = false;
 };
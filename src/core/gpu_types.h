@@ -57,7 +57,10 @@ enum class GPUTextureMode : u8
   RawDirect16Bit = RawTextureBit | Direct16Bit,
   Reserved_RawDirect16Bit = RawTextureBit | Reserved_Direct16Bit,
 
-  Disabled = 8 // Not a register value
+  Disabled = 8, // Not a register value
+
+  // Hardware renderer batches which mix texture modes, the mode and raw texture bit are taken from each vertex.
+  Dynamic = 9
 };
 
 IMPLEMENT_ENUM_CLASS_BITWISE_OPERATORS(GPUTextureMode);
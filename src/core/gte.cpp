@@ -1,6 +1,7 @@
 #include "gte.h"
 #include "common/assert.h"
 #include "common/bitutils.h"
+#include "common/platform.h"
 #include "util/state_wrapper.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
@@ -12,6 +13,10 @@
 #include <array>
 #include <numeric>
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#endif
+
 namespace GTE {
 
 static constexpr s64 MAC0_MIN_VALUE = -(INT64_C(1) << 31);
@@ -468,28 +473,122 @@ ALWAYS_INLINE static u32 UNRDivide(u32 lhs, u32 rhs)
   return std::min<u32>(0x1FFFF, result);
 }
 
-static void MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+// Converts per-row overflow/underflow/saturation masks (bit N = row N) to MAC1-3/IR1-3 FLAG bits.
+ALWAYS_INLINE static u32 GetMAC123FlagBits(u32 overflow, u32 underflow)
 {
-#define dot3(i)                                                                                                        \
-  TruncateAndSetMACAndIR<i + 1>(SignExtendMACResult<i + 1>((s64(M[i][0]) * s64(Vx)) + (s64(M[i][1]) * s64(Vy))) +      \
-                                  (s64(M[i][2]) * s64(Vz)),                                                            \
-                                shift, lm)
+  return ((overflow & 1u) << 30) | ((overflow & 2u) << 28) | ((overflow & 4u) << 26) | ((underflow & 1u) << 27) |
+         ((underflow & 2u) << 25) | ((underflow & 4u) << 23);
+}
+ALWAYS_INLINE static u32 GetIR123FlagBits(u32 saturated)
+{
+  return ((saturated & 1u) << 24) | ((saturated & 2u) << 22) | ((saturated & 4u) << 20);
+}
 
-  dot3(0);
-  dot3(1);
-  dot3(2);
+// The row kernels below compute all three rows of MAC1-3 at once. Partial sums are overflow-checked and sign-extended
+// to 44 bits in the same order as the scalar TruncateAndSet*() helpers, so MAC, IR and FLAG results are bit-exact.
+//  - MulMatVecRows(): out = (T SHL 12) + M * V, without the overflow check of the final sum.
+//  - SetMAC123(): overflow check, MAC1-3 = in SAR shift.
+//  - SetMACAndIR123(): SetMAC123(), then IR1-3 = MAC1-3 saturated to -8000h/0..7FFFh.
 
-#undef dot3
+#if defined(CPU_X64)
+
+// The high dwords of each 64-bit accumulator, for rows 0-2 in lanes 0-2.
+ALWAYS_INLINE static __m128i GetMACHighBits(__m128i xy, __m128i z)
+{
+  return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(xy), _mm_castsi128_ps(z), _MM_SHUFFLE(1, 1, 3, 1)));
 }
 
-static void MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+ALWAYS_INLINE static u32 CheckMAC123Overflow(__m128i xy, __m128i z)
+{
+  // bits 43 and up must all be equal to the sign bit, the values never exceed 32 bits after shifting
+  const __m128i high = _mm_srai_epi32(GetMACHighBits(xy, z), 11);
+  const u32 overflow = static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(high, _mm_setzero_si128()))));
+  const u32 underflow = static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmplt_epi32(high, _mm_set1_epi32(-1)))));
+  return GetMAC123FlagBits(overflow, underflow);
+}
+
+ALWAYS_INLINE static __m128i SignExtendMAC123(__m128i value)
+{
+  const __m128i mask = _mm_set1_epi64x((INT64_C(1) << 44) - 1);
+  const __m128i sign = _mm_set1_epi64x(INT64_C(1) << 43);
+  return _mm_sub_epi64(_mm_xor_si128(_mm_and_si128(value, mask), sign), sign);
+}
+
+ALWAYS_INLINE static void MulMatVecRows(const s16 M[3][3], const s32 T[3], const s16 V[3], s64 out[3])
+{
+  __m128i xy = _mm_set_epi64x(s64(T[1]) << 12, s64(T[0]) << 12);
+  __m128i z = _mm_set_epi64x(0, s64(T[2]) << 12);
+  u32 flags = 0;
+
+  for (u32 i = 0; i < 3; i++)
+  {
+    // 16x16 products for each row of this column, sign-extended to 64 bits
+    const __m128i products = _mm_madd_epi16(_mm_setr_epi16(M[0][i], 0, M[1][i], 0, M[2][i], 0, 0, 0),
+                                            _mm_set1_epi32(static_cast<s32>(static_cast<u16>(V[i]))));
+    const __m128i products_sign = _mm_srai_epi32(products, 31);
+    xy = _mm_add_epi64(xy, _mm_unpacklo_epi32(products, products_sign));
+    z = _mm_add_epi64(z, _mm_unpackhi_epi32(products, products_sign));
+    if (i < 2)
+    {
+      flags |= CheckMAC123Overflow(xy, z);
+      xy = SignExtendMAC123(xy);
+      z = SignExtendMAC123(z);
+    }
+  }
+
+  REGS.FLAG.bits |= flags;
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), xy);
+  out[2] = _mm_cvtsi128_si64(z);
+}
+
+ALWAYS_INLINE static __m128i SetMAC123(const s64 in[3], u8 shift)
+{
+  const __m128i xy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  const __m128i z = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&in[2]));
+  REGS.FLAG.bits |= CheckMAC123Overflow(xy, z);
+
+  // logical shift is fine, only the low 32 bits are kept
+  const __m128i shift_count = _mm_cvtsi32_si128(shift);
+  const __m128i mac = _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(_mm_srl_epi64(xy, shift_count)),
+                                                      _mm_castsi128_ps(_mm_srl_epi64(z, shift_count)),
+                                                      _MM_SHUFFLE(0, 0, 2, 0)));
+
+  alignas(16) s32 values[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(values), mac);
+  REGS.MAC1 = values[0];
+  REGS.MAC2 = values[1];
+  REGS.MAC3 = values[2];
+  return mac;
+}
+
+ALWAYS_INLINE static void SetMACAndIR123(const s64 in[3], u8 shift, bool lm)
+{
+  const __m128i mac = SetMAC123(in, shift);
+
+  // saturate to -8000h..7FFFh, or 0..7FFFh with lm
+  __m128i ir = _mm_packs_epi32(mac, mac);
+  if (lm)
+    ir = _mm_max_epi16(ir, _mm_setzero_si128());
+  ir = _mm_srai_epi32(_mm_unpacklo_epi16(ir, ir), 16);
+
+  const u32 saturated = ~static_cast<u32>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(ir, mac)))) & 7u;
+  REGS.FLAG.bits |= GetIR123FlagBits(saturated);
+
+  alignas(16) s32 values[4];
+  _mm_store_si128(reinterpret_cast<__m128i*>(values), ir);
+  REGS.dr32[9] = static_cast<u32>(values[0]);
+  REGS.dr32[10] = static_cast<u32>(values[1]);
+  REGS.dr32[11] = static_cast<u32>(values[2]);
+}
+
+#else
+
+ALWAYS_INLINE static void MulMatVecRows(const s16 M[3][3], const s32 T[3], const s16 V[3], s64 out[3])
 {
 #define dot3(i)                                                                                                        \
-  TruncateAndSetMACAndIR<i + 1>(                                                                                       \
-    SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(T[i]) << 12) + (s64(M[i][0]) * s64(Vx))) +              \
-                               (s64(M[i][1]) * s64(Vy))) +                                                             \
-      (s64(M[i][2]) * s64(Vz)),                                                                                        \
-    shift, lm)
+  out[i] = SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(T[i]) << 12) + (s64(M[i][0]) * s64(V[0]))) +     \
+                                      (s64(M[i][1]) * s64(V[1]))) +                                                    \
+           (s64(M[i][2]) * s64(V[2]))
 
   dot3(0);
   dot3(1);
@@ -498,6 +597,37 @@ static void MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16
 #undef dot3
 }
 
+ALWAYS_INLINE static void SetMAC123(const s64 in[3], u8 shift)
+{
+  TruncateAndSetMAC<1>(in[0], shift);
+  TruncateAndSetMAC<2>(in[1], shift);
+  TruncateAndSetMAC<3>(in[2], shift);
+}
+
+ALWAYS_INLINE static void SetMACAndIR123(const s64 in[3], u8 shift, bool lm)
+{
+  TruncateAndSetMACAndIR<1>(in[0], shift, lm);
+  TruncateAndSetMACAndIR<2>(in[1], shift, lm);
+  TruncateAndSetMACAndIR<3>(in[2], shift, lm);
+}
+
+#endif
+
+static void MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+{
+  const s16 V[3] = {Vx, Vy, Vz};
+  s64 values[3];
+  MulMatVecRows(M, T, V, values);
+  SetMACAndIR123(values, shift, lm);
+}
+
+static void MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+{
+  // Without a translation vector, the first partial sum can't overflow, so this matches the hardware too.
+  static constexpr s32 zero_T[3] = {};
+  MulMatVec(M, zero_T, Vx, Vy, Vz, shift, lm);
+}
+
 static void MulMatVecBuggy(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift,
                            bool lm)
 {
@@ -640,20 +770,15 @@ static void Execute_OP(Instruction inst)
 
 static void RTPS(const s16 V[3], u8 shift, bool lm, bool last)
 {
-#define dot3(i)                                                                                                        \
-  SignExtendMACResult<i + 1>(SignExtendMACResult<i + 1>((s64(REGS.TR[i]) << 12) + (s64(REGS.RT[i][0]) * s64(V[0]))) +  \
-                             (s64(REGS.RT[i][1]) * s64(V[1]))) +                                                       \
-    (s64(REGS.RT[i][2]) * s64(V[2]))
-
   // IR1 = MAC1 = (TRX*1000h + RT11*VX0 + RT12*VY0 + RT13*VZ0) SAR (sf*12)
   // IR2 = MAC2 = (TRY*1000h + RT21*VX0 + RT22*VY0 + RT23*VZ0) SAR (sf*12)
   // IR3 = MAC3 = (TRZ*1000h + RT31*VX0 + RT32*VY0 + RT33*VZ0) SAR (sf*12)
-  const s64 x = dot3(0);
-  const s64 y = dot3(1);
-  const s64 z = dot3(2);
-  TruncateAndSetMAC<1>(x, shift);
-  TruncateAndSetMAC<2>(y, shift);
-  TruncateAndSetMAC<3>(z, shift);
+  s64 xyz[3];
+  MulMatVecRows(REGS.RT, REGS.TR, V, xyz);
+  SetMAC123(xyz, shift);
+  const s64 x = xyz[0];
+  const s64 y = xyz[1];
+  const s64 z = xyz[2];
   TruncateAndSetIR<1>(REGS.MAC1, lm);
   TruncateAndSetIR<2>(REGS.MAC2, lm);
 
@@ -662,7 +787,6 @@ static void RTPS(const s16 V[3], u8 shift, bool lm, bool last)
   // when "MAC3" exceeds -8000h..+7FFFh).
   TruncateAndSetIR<3>(s32(z >> 12), false);
   REGS.dr32[11] = std::clamp(REGS.MAC3, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE);
-#undef dot3
 
   // SZ3 = MAC3 SAR ((1-sf)*12)                           ;ScreenZ FIFO 0..+FFFFh
   PushSZ(s32(z >> 12));
@@ -857,15 +981,16 @@ static ALWAYS_INLINE void InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3
 {
   // [MAC1,MAC2,MAC3] = MAC+(FC-MAC)*IR0
   //   [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
-  TruncateAndSetMACAndIR<1>((s64(REGS.FC[0]) << 12) - in_MAC1, shift, false);
-  TruncateAndSetMACAndIR<2>((s64(REGS.FC[1]) << 12) - in_MAC2, shift, false);
-  TruncateAndSetMACAndIR<3>((s64(REGS.FC[2]) << 12) - in_MAC3, shift, false);
+  const s64 far_color[3] = {(s64(REGS.FC[0]) << 12) - in_MAC1, (s64(REGS.FC[1]) << 12) - in_MAC2,
+                            (s64(REGS.FC[2]) << 12) - in_MAC3};
+  SetMACAndIR123(far_color, shift, false);
 
   //   [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + [MAC1,MAC2,MAC3])
   // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)
-  TruncateAndSetMACAndIR<1>(s64(s32(REGS.IR1) * s32(REGS.IR0)) + in_MAC1, shift, lm);
-  TruncateAndSetMACAndIR<2>(s64(s32(REGS.IR2) * s32(REGS.IR0)) + in_MAC2, shift, lm);
-  TruncateAndSetMACAndIR<3>(s64(s32(REGS.IR3) * s32(REGS.IR0)) + in_MAC3, shift, lm);
+  const s64 interpolated[3] = {s64(s32(REGS.IR1) * s32(REGS.IR0)) + in_MAC1,
+                               s64(s32(REGS.IR2) * s32(REGS.IR0)) + in_MAC2,
+                               s64(s32(REGS.IR3) * s32(REGS.IR0)) + in_MAC3};
+  SetMACAndIR123(interpolated, shift, lm);
 }
 
 static void NCS(const s16 V[3], u8 shift, bool lm)
@@ -913,9 +1038,10 @@ static void NCCS(const s16 V[3], u8 shift, bool lm)
 
   // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4          ;<--- for NCDx/NCCx
   // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)       ;<--- for NCDx/NCCx
-  TruncateAndSetMACAndIR<1>(s64(s32(ZeroExtend32(REGS.RGBC[0])) * s32(REGS.IR1)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<2>(s64(s32(ZeroExtend32(REGS.RGBC[1])) * s32(REGS.IR2)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<3>(s64(s32(ZeroExtend32(REGS.RGBC[2])) * s32(REGS.IR3)) << 4, shift, lm);
+  const s64 color[3] = {s64(s32(ZeroExtend32(REGS.RGBC[0])) * s32(REGS.IR1)) << 4,
+                        s64(s32(ZeroExtend32(REGS.RGBC[1])) * s32(REGS.IR2)) << 4,
+                        s64(s32(ZeroExtend32(REGS.RGBC[2])) * s32(REGS.IR3)) << 4};
+  SetMACAndIR123(color, shift, lm);
 
   // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
   PushRGBFromMAC();
@@ -1000,9 +1126,10 @@ static void Execute_CC(Instruction inst)
 
   // [MAC1,MAC2,MAC3] = [R*IR1,G*IR2,B*IR3] SHL 4
   // [MAC1,MAC2,MAC3] = [MAC1,MAC2,MAC3] SAR (sf*12)
-  TruncateAndSetMACAndIR<1>(s64(s32(ZeroExtend32(REGS.RGBC[0])) * s32(REGS.IR1)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<2>(s64(s32(ZeroExtend32(REGS.RGBC[1])) * s32(REGS.IR2)) << 4, shift, lm);
-  TruncateAndSetMACAndIR<3>(s64(s32(ZeroExtend32(REGS.RGBC[2])) * s32(REGS.IR3)) << 4, shift, lm);
+  const s64 color[3] = {s64(s32(ZeroExtend32(REGS.RGBC[0])) * s32(REGS.IR1)) << 4,
+                        s64(s32(ZeroExtend32(REGS.RGBC[1])) * s32(REGS.IR2)) << 4,
+                        s64(s32(ZeroExtend32(REGS.RGBC[2])) * s32(REGS.IR3)) << 4};
+  SetMACAndIR123(color, shift, lm);
 
   // Color FIFO = [MAC1/16,MAC2/16,MAC3/16,CODE], [IR1,IR2,IR3] = [MAC1,MAC2,MAC3]
   PushRGBFromMAC();
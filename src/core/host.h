@@ -85,12 +85,12 @@ std::unique_ptr<AudioStream> CreateAudioStream(AudioBackend backend, u32 sample_
 float GetOSDScale();
 
 /// Adds OSD messages, duration is in seconds.
-void AddOSDMessage(std::string message, float duration = 2.0f);
-void AddKeyedOSDMessage(std::string key, std::string message, float duration = 2.0f);
-void AddIconOSDMessage(std::string key, const char* icon, std::string message, float duration = 2.0f);
+void AddOSDMessage(std::string_view message, float duration = 2.0f);
+void AddKeyedOSDMessage(std::string_view key, std::string_view message, float duration = 2.0f);
+void AddIconOSDMessage(std::string_view key, const char* icon, std::string_view message, float duration = 2.0f);
 void AddFormattedOSDMessage(float duration, const char* format, ...);
-void AddKeyedFormattedOSDMessage(std::string key, float duration, const char* format, ...);
-void RemoveKeyedOSDMessage(std::string key);
+void AddKeyedFormattedOSDMessage(std::string_view key, float duration, const char* format, ...);
+void RemoveKeyedOSDMessage(std::string_view key);
 void ClearOSDMessages();
 
 /// Displays an asynchronous error on the UI thread, i.e. doesn't block the caller.
@@ -113,6 +113,9 @@ void DisplayLoadingScreen(const char* message, int progress_min = -1, int progre
 /// Intensity is normalized from 0 to 1.
 void SetPadVibrationIntensity(u32 pad_index, float large_or_single_motor_intensity, float small_motor_intensity);
 
+/// Called by the pad when a controller read begins, so the host can refresh input state before it is latched.
+void PollInputForControllerRead();
+
 /// Enables "relative" mouse mode, locking the cursor position and returning relative coordinates.
 void SetMouseMode(bool relative, bool hide_cursor);
 
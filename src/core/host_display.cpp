@@ -1,24 +1,34 @@
 #include "host_display.h"
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/image.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "common/timer.h"
+#include "imgui.h"
 #include "settings.h"
 #include "stb_image.h"
 #include "stb_image_resize.h"
 #include "stb_image_write.h"
 #include <cerrno>
+#include <algorithm>
 #include <cmath>
 #include <cstring>
-#include <thread>
+#include <utility>
 #include <vector>
 Log_SetChannel(HostDisplay);
 
 std::unique_ptr<HostDisplay> g_host_display;
 
-HostDisplay::~HostDisplay() = default;
+// Screenshots and texture dumps are encoded and written by the shared pool.
+static Threading::ThreadPool::TaskGroup s_image_writes;
+
+HostDisplay::~HostDisplay()
+{
+  s_image_writes.Wait(Threading::ThreadPool::GetShared());
+}
 
 RenderAPI HostDisplay::GetPreferredAPI()
 {
@@ -117,6 +127,59 @@ bool HostDisplay::ShouldSkipDisplayingFrame()
   return false;
 }
 
+void HostDisplay::SetSkipDuplicateFrames(bool enabled)
+{
+  m_skip_duplicate_frames = enabled;
+  m_last_presented_frame_valid = false;
+}
+
+bool HostDisplay::IsDuplicateFrame(bool post_processing_uses_time)
+{
+  // Only frames the GPU has scanned out since the last call can be duplicates. Redraws while paused or for window
+  // events don't come with a new frame, and have to be presented.
+  const bool new_frame = std::exchange(m_new_display_frame, false);
+  if (!m_skip_duplicate_frames)
+    return false;
+
+  // Overlays such as the OSD can change without the display doing so, so frames with them are always presented.
+  bool has_overlays = post_processing_uses_time || HasSoftwareCursor();
+  if (!has_overlays && ImGui::GetCurrentContext())
+  {
+    ImGui::Render();
+    const ImDrawData* draw_data = ImGui::GetDrawData();
+    has_overlays = (draw_data && draw_data->TotalVtxCount > 0);
+  }
+
+  PresentedFrameState state = {};
+  state.texture = m_display_texture;
+  state.texture_view_x = m_display_texture_view_x;
+  state.texture_view_y = m_display_texture_view_y;
+  state.texture_view_width = m_display_texture_view_width;
+  state.texture_view_height = m_display_texture_view_height;
+  state.display_width = m_display_width;
+  state.display_height = m_display_height;
+  state.display_active_left = m_display_active_left;
+  state.display_active_top = m_display_active_top;
+  state.display_active_width = m_display_active_width;
+  state.display_active_height = m_display_active_height;
+  state.display_aspect_ratio = m_display_aspect_ratio;
+  state.window_width = m_window_info.surface_width;
+  state.window_height = m_window_info.surface_height;
+
+  // The frame after one with overlays has to be presented too, otherwise they'd stay on screen.
+  if (new_frame && !m_display_content_changed && !has_overlays && !m_last_presented_frame_had_overlays &&
+      m_last_presented_frame_valid && std::memcmp(&state, &m_last_presented_frame, sizeof(state)) == 0)
+  {
+    return true;
+  }
+
+  m_last_presented_frame = state;
+  m_last_presented_frame_valid = true;
+  m_last_presented_frame_had_overlays = has_overlays;
+  m_display_content_changed = false;
+  return false;
+}
+
 bool HostDisplay::GetHostRefreshRate(float* refresh_rate)
 {
   if (m_window_info.surface_refresh_rate > 0.0f)
@@ -138,6 +201,30 @@ float HostDisplay::GetAndResetAccumulatedGPUTime()
   return 0.0f;
 }
 
+void HostDisplay::GetAndResetAccumulatedGPUSectionTimes(GPUTimingSectionTimes* times)
+{
+  times->fill(0.0f);
+}
+
+void HostDisplay::ChangeGPUTimingSection(GPUTimingSection section)
+{
+  m_gpu_timing_section = section;
+}
+
+GPUTimingSection HostDisplay::GetPostProcessingTimingSection(u32 stage)
+{
+  return static_cast<GPUTimingSection>(static_cast<u32>(GPUTimingSection::PostProcessing) +
+                                       std::min(stage, MAX_TIMED_POST_PROCESSING_STAGES - 1));
+}
+
+const char* HostDisplay::GetGPUTimingSectionName(u32 section)
+{
+  static constexpr std::array<const char*, NUM_GPU_TIMING_SECTIONS> names = {
+    {"Other", "Draw", "VRAM Transfer", "Downsample", "Display", "Post-Process 1", "Post-Process 2", "Post-Process 3",
+     "Post-Process 4", "Post-Process 5", "Post-Process 6", "Post-Process 7", "Post-Process 8"}};
+  return (section < NUM_GPU_TIMING_SECTIONS) ? names[section] : "";
+}
+
 void HostDisplay::SetSoftwareCursor(std::unique_ptr<GPUTexture> texture, float scale /*= 1.0f*/)
 {
   m_cursor_texture = std::move(texture);
@@ -345,12 +432,11 @@ std::tuple<float, float> HostDisplay::ConvertWindowCoordinatesToDisplayCoordinat
   return std::make_tuple(display_x, display_y);
 }
 
-static bool CompressAndWriteTextureToFile(u32 width, u32 height, std::string filename, FileSystem::ManagedCFilePtr fp,
+static bool CompressAndWriteTextureToFile(u32 width, u32 height, const std::string& filename, std::FILE* fp,
                                           bool clear_alpha, bool flip_y, u32 resize_width, u32 resize_height,
                                           std::vector<u32> texture_data, u32 texture_data_stride,
                                           GPUTexture::Format texture_format)
 {
-
   const char* extension = std::strrchr(filename.c_str(), '.');
   if (!extension)
   {
@@ -396,19 +482,19 @@ static bool CompressAndWriteTextureToFile(u32 width, u32 height, std::string fil
   if (StringUtil::Strcasecmp(extension, ".png") == 0)
   {
     result =
-      (stbi_write_png_to_func(write_func, fp.get(), width, height, 4, texture_data.data(), texture_data_stride) != 0);
+      (stbi_write_png_to_func(write_func, fp, width, height, 4, texture_data.data(), texture_data_stride) != 0);
   }
   else if (StringUtil::Strcasecmp(extension, ".jpg") == 0)
   {
-    result = (stbi_write_jpg_to_func(write_func, fp.get(), width, height, 4, texture_data.data(), 95) != 0);
+    result = (stbi_write_jpg_to_func(write_func, fp, width, height, 4, texture_data.data(), 95) != 0);
   }
   else if (StringUtil::Strcasecmp(extension, ".tga") == 0)
   {
-    result = (stbi_write_tga_to_func(write_func, fp.get(), width, height, 4, texture_data.data()) != 0);
+    result = (stbi_write_tga_to_func(write_func, fp, width, height, 4, texture_data.data()) != 0);
   }
   else if (StringUtil::Strcasecmp(extension, ".bmp") == 0)
   {
-    result = (stbi_write_bmp_to_func(write_func, fp.get(), width, height, 4, texture_data.data()) != 0);
+    result = (stbi_write_bmp_to_func(write_func, fp, width, height, 4, texture_data.data()) != 0);
   }
 
   if (!result)
@@ -420,20 +506,12 @@ static bool CompressAndWriteTextureToFile(u32 width, u32 height, std::string fil
   return true;
 }
 
-bool HostDisplay::WriteTextureToFile(GPUTexture* texture, u32 x, u32 y, u32 width, u32 height, std::string filename,
-                                     bool clear_alpha /* = true */, bool flip_y /* = false */,
-                                     u32 resize_width /* = 0 */, u32 resize_height /* = 0 */,
-                                     bool compress_on_thread /* = false */)
+static bool WriteTextureDataToFile(u32 width, u32 height, std::string filename, bool clear_alpha, bool flip_y,
+                                   u32 resize_width, u32 resize_height, std::vector<u32> texture_data,
+                                   u32 texture_data_stride, GPUTexture::Format texture_format, bool compress_on_thread)
 {
-  std::vector<u32> texture_data(width * height);
-  u32 texture_data_stride = Common::AlignUpPow2(GPUTexture::GetPixelSize(texture->GetFormat()) * width, 4);
-  if (!DownloadTexture(texture, x, y, width, height, texture_data.data(), texture_data_stride))
-  {
-    Log_ErrorPrintf("Texture download failed");
-    return false;
-  }
-
-  auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "wb");
+  // opened up front, so failures can be reported to the caller
+  std::shared_ptr<std::FILE> fp(FileSystem::OpenManagedCFile(filename.c_str(), "wb"));
   if (!fp)
   {
     Log_ErrorPrintf("Can't open file '%s': errno %d", filename.c_str(), errno);
@@ -442,24 +520,41 @@ bool HostDisplay::WriteTextureToFile(GPUTexture* texture, u32 x, u32 y, u32 widt
 
   if (!compress_on_thread)
   {
-    return CompressAndWriteTextureToFile(width, height, std::move(filename), std::move(fp), clear_alpha, flip_y,
-                                         resize_width, resize_height, std::move(texture_data), texture_data_stride,
-                                         texture->GetFormat());
+    return CompressAndWriteTextureToFile(width, height, filename, fp.get(), clear_alpha, flip_y, resize_width,
+                                         resize_height, std::move(texture_data), texture_data_stride, texture_format);
   }
 
-  std::thread compress_thread(CompressAndWriteTextureToFile, width, height, std::move(filename), std::move(fp),
-                              clear_alpha, flip_y, resize_width, resize_height, std::move(texture_data),
-                              texture_data_stride, texture->GetFormat());
-  compress_thread.detach();
+  Threading::ThreadPool::GetShared().Submit(
+    [width, height, filename = std::move(filename), fp = std::move(fp), clear_alpha, flip_y, resize_width,
+     resize_height, texture_data = std::move(texture_data), texture_data_stride, texture_format]() mutable {
+      CompressAndWriteTextureToFile(width, height, filename, fp.get(), clear_alpha, flip_y, resize_width,
+                                    resize_height, std::move(texture_data), texture_data_stride, texture_format);
+    },
+    Threading::ThreadPool::Priority::Low, &s_image_writes);
   return true;
 }
 
-bool HostDisplay::WriteDisplayTextureToFile(std::string filename, bool full_resolution /* = true */,
-                                            bool apply_aspect_ratio /* = true */, bool compress_on_thread /* = false */)
+bool HostDisplay::WriteTextureToFile(GPUTexture* texture, u32 x, u32 y, u32 width, u32 height, std::string filename,
+                                     bool clear_alpha /* = true */, bool flip_y /* = false */,
+                                     u32 resize_width /* = 0 */, u32 resize_height /* = 0 */,
+                                     bool compress_on_thread /* = false */)
 {
-  if (!m_display_texture)
+  std::vector<u32> texture_data(width * height);
+  u32 texture_data_stride = Common::AlignUpPow2(GPUTexture::GetPixelSize(texture->GetFormat()) * width, 4);
+  if (!DownloadTexture(texture, x, y, width, height, texture_data.data(), texture_data_stride))
+  {
+    Log_ErrorPrintf("Texture download failed");
     return false;
+  }
 
+  return WriteTextureDataToFile(width, height, std::move(filename), clear_alpha, flip_y, resize_width, resize_height,
+                                std::move(texture_data), texture_data_stride, texture->GetFormat(),
+                                compress_on_thread);
+}
+
+bool HostDisplay::GetDisplayTextureSaveSize(bool full_resolution, bool apply_aspect_ratio, s32* width,
+                                            s32* height) const
+{
   s32 resize_width = 0;
   s32 resize_height = std::abs(m_display_texture_view_height);
   if (apply_aspect_ratio)
@@ -481,8 +576,20 @@ bool HostDisplay::WriteDisplayTextureToFile(std::string filename, bool full_reso
     resize_width /= resolution_scale;
   }
 
-  if (resize_width <= 0 || resize_height <= 0)
+  *width = resize_width;
+  *height = resize_height;
+  return (resize_width > 0 && resize_height > 0);
+}
+
+bool HostDisplay::WriteDisplayTextureToFile(std::string filename, bool full_resolution /* = true */,
+                                            bool apply_aspect_ratio /* = true */, bool compress_on_thread /* = false */)
+{
+  s32 resize_width, resize_height;
+  if (!m_display_texture || !GetDisplayTextureSaveSize(full_resolution, apply_aspect_ratio, &resize_width,
+                                                       &resize_height))
+  {
     return false;
+  }
 
   const bool flip_y = (m_display_texture_view_height < 0);
   s32 read_height = m_display_texture_view_height;
@@ -577,37 +684,86 @@ bool HostDisplay::WriteDisplayTextureToBuffer(std::vector<u32>* buffer, u32 resi
   return true;
 }
 
-bool HostDisplay::WriteScreenshotToFile(std::string filename, bool compress_on_thread /*= false*/)
+bool HostDisplay::ReadDisplayTexture(Common::RGBA8Image* image, u32* save_width, u32* save_height,
+                                     bool full_resolution /* = true */, bool apply_aspect_ratio /* = true */)
 {
-  const u32 width = m_window_info.surface_width;
-  const u32 height = m_window_info.surface_height;
-  if (width == 0 || height == 0)
+  s32 resize_width, resize_height;
+  std::vector<u32> pixels;
+  if (!m_display_texture ||
+      !GetDisplayTextureSaveSize(full_resolution, apply_aspect_ratio, &resize_width, &resize_height) ||
+      !WriteDisplayTextureToBuffer(&pixels))
+  {
     return false;
+  }
+
+  image->SetPixels(static_cast<u32>(m_display_texture_view_width),
+                   static_cast<u32>(std::abs(m_display_texture_view_height)), std::move(pixels));
+  *save_width = static_cast<u32>(resize_width);
+  *save_height = static_cast<u32>(resize_height);
+  return true;
+}
 
+bool HostDisplay::RenderScreenshotAsync(u32 width, u32 height, ScreenshotCallback callback)
+{
   std::vector<u32> pixels;
   u32 pixels_stride;
   GPUTexture::Format pixels_format;
   if (!RenderScreenshot(width, height, &pixels, &pixels_stride, &pixels_format))
-  {
-    Log_ErrorPrintf("Failed to render %ux%u screenshot", width, height);
     return false;
+
+  callback(width, height, std::move(pixels), pixels_stride, pixels_format);
+  return true;
+}
+
+bool HostDisplay::WriteScreenshotToFile(std::string filename, bool compress_on_thread /*= false*/)
+{
+  const u32 width = m_window_info.surface_width;
+  const u32 height = m_window_info.surface_height;
+  if (width == 0 || height == 0)
+    return false;
+
+  // synchronous writes can't wait for an asynchronous readback
+  const bool flip_y = UsesLowerLeftOrigin();
+  if (!compress_on_thread)
+  {
+    std::vector<u32> pixels;
+    u32 pixels_stride;
+    GPUTexture::Format pixels_format;
+    if (!RenderScreenshot(width, height, &pixels, &pixels_stride, &pixels_format))
+    {
+      Log_ErrorPrintf("Failed to render %ux%u screenshot", width, height);
+      return false;
+    }
+
+    return WriteTextureDataToFile(width, height, std::move(filename), true, flip_y, width, height, std::move(pixels),
+                                  pixels_stride, pixels_format, false);
   }
 
-  auto fp = FileSystem::OpenManagedCFile(filename.c_str(), "wb");
+  // Open the file now, so the caller hears about failures even though the readback completes later.
+  std::shared_ptr<std::FILE> fp(FileSystem::OpenManagedCFile(filename.c_str(), "wb"));
   if (!fp)
   {
     Log_ErrorPrintf("Can't open file '%s': errno %d", filename.c_str(), errno);
     return false;
   }
 
-  if (!compress_on_thread)
+  ScreenshotCallback callback = [filename, fp = std::move(fp), flip_y](u32 width, u32 height, std::vector<u32> pixels,
+                                                                        u32 stride, GPUTexture::Format format) mutable {
+    Threading::ThreadPool::GetShared().Submit(
+      [width, height, filename = std::move(filename), fp = std::move(fp), flip_y, pixels = std::move(pixels), stride,
+       format]() mutable {
+        CompressAndWriteTextureToFile(width, height, filename, fp.get(), true, flip_y, width, height,
+                                      std::move(pixels), stride, format);
+      },
+      Threading::ThreadPool::Priority::Low, &s_image_writes);
+  };
+
+  if (!RenderScreenshotAsync(width, height, std::move(callback)))
   {
-    return CompressAndWriteTextureToFile(width, height, std::move(filename), std::move(fp), true, UsesLowerLeftOrigin(),
-                                         width, height, std::move(pixels), pixels_stride, pixels_format);
+    Log_ErrorPrintf("Failed to render %ux%u screenshot", width, height);
+    FileSystem::DeleteFile(filename.c_str());
+    return false;
   }
 
-  std::thread compress_thread(CompressAndWriteTextureToFile, width, height, std::move(filename), std::move(fp), true,
-                              UsesLowerLeftOrigin(), width, height, std::move(pixels), pixels_stride, pixels_format);
-  compress_thread.detach();
   return true;
 }
@@ -3,12 +3,18 @@
 #include "common/rectangle.h"
 #include "common/window_info.h"
 #include "types.h"
+#include <array>
+#include <functional>
 #include <memory>
 #include <string>
 #include <string_view>
 #include <tuple>
 #include <vector>
 
+namespace Common {
+class RGBA8Image;
+}
+
 enum class RenderAPI : u32
 {
   None,
@@ -19,6 +25,18 @@ enum class RenderAPI : u32
   OpenGLES
 };
 
+// Parts of the frame which GPU time is broken down into. Each post-processing stage gets its own section, counting up
+// from PostProcessing.
+enum class GPUTimingSection : u8
+{
+  Other,
+  Draw,
+  VRAMTransfer,
+  Downsample,
+  Display,
+  PostProcessing,
+};
+
 // Interface to the frontend's renderer.
 class HostDisplay
 {
@@ -29,6 +47,11 @@ public:
     std::vector<std::string> fullscreen_modes;
   };
 
+  static constexpr u32 MAX_TIMED_POST_PROCESSING_STAGES = 8;
+  static constexpr u32 NUM_GPU_TIMING_SECTIONS =
+    static_cast<u32>(GPUTimingSection::PostProcessing) + MAX_TIMED_POST_PROCESSING_STAGES;
+  using GPUTimingSectionTimes = std::array<float, NUM_GPU_TIMING_SECTIONS>;
+
   virtual ~HostDisplay();
 
   /// Returns the default/preferred API for the system.
@@ -104,6 +127,15 @@ public:
   virtual bool RenderScreenshot(u32 width, u32 height, std::vector<u32>* out_pixels, u32* out_stride,
                                 GPUTexture::Format* out_format) = 0;
 
+  /// Receives a screenshot once it has been read back from the GPU.
+  using ScreenshotCallback =
+    std::function<void(u32 width, u32 height, std::vector<u32> pixels, u32 stride, GPUTexture::Format format)>;
+
+  /// Renders the display like RenderScreenshot(), but reads it back once the GPU is done with it rather than waiting.
+  /// The callback runs on the render thread, from a later Render() call, or immediately if the backend can't read
+  /// back asynchronously.
+  virtual bool RenderScreenshotAsync(u32 width, u32 height, ScreenshotCallback callback);
+
   virtual void SetVSync(bool enabled) = 0;
 
   /// ImGui context management, usually called by derived classes.
@@ -115,6 +147,19 @@ public:
   void SetDisplayMaxFPS(float max_fps);
   bool ShouldSkipDisplayingFrame();
 
+  /// Enables skipping presents of frames which would look the same as the last one presented.
+  void SetSkipDuplicateFrames(bool enabled);
+
+  /// Called by the GPU at vblank, content_changed is false when the scanned out image is the same as the last one.
+  ALWAYS_INLINE void NotifyDisplayFrame(bool content_changed)
+  {
+    m_new_display_frame = true;
+    m_display_content_changed |= content_changed;
+  }
+
+  /// Forces the next frame to be presented, e.g. after settings which affect drawing change.
+  ALWAYS_INLINE void InvalidatePresentedFrame() { m_last_presented_frame_valid = false; }
+
   void ClearDisplayTexture()
   {
     m_display_texture = nullptr;
@@ -167,6 +212,22 @@ public:
   /// Returns the amount of GPU time utilized since the last time this method was called.
   virtual float GetAndResetAccumulatedGPUTime();
 
+  /// Returns the GPU time in milliseconds spent in each section since the last time this method was called.
+  virtual void GetAndResetAccumulatedGPUSectionTimes(GPUTimingSectionTimes* times);
+
+  /// Attributes GPU work recorded from now on to the specified section, when GPU timing is enabled.
+  ALWAYS_INLINE void SetGPUTimingSection(GPUTimingSection section)
+  {
+    if (m_gpu_timing_enabled && m_gpu_timing_section != section)
+      ChangeGPUTimingSection(section);
+  }
+
+  /// Returns the section for a post-processing stage. Stages past the limit share the last section.
+  static GPUTimingSection GetPostProcessingTimingSection(u32 stage);
+
+  /// Returns the display name of a GPU timing section.
+  static const char* GetGPUTimingSectionName(u32 section);
+
   /// Sets the software cursor to the specified texture. Ownership of the texture is transferred.
   void SetSoftwareCursor(std::unique_ptr<GPUTexture> texture, float scale = 1.0f);
 
@@ -200,6 +261,11 @@ public:
   bool WriteDisplayTextureToBuffer(std::vector<u32>* buffer, u32 resize_width = 0, u32 resize_height = 0,
                                    bool clear_alpha = true);
 
+  /// Helper function to read the current display texture, along with the size WriteDisplayTextureToFile() would save
+  /// it at. Resizing and encoding are left to the caller, so they can happen on another thread.
+  bool ReadDisplayTexture(Common::RGBA8Image* image, u32* save_width, u32* save_height, bool full_resolution = true,
+                          bool apply_aspect_ratio = true);
+
   /// Helper function to save screenshot to PNG.
   bool WriteScreenshotToFile(std::string filename, bool compress_on_thread = false);
 
@@ -209,6 +275,16 @@ protected:
 
   bool IsUsingLinearFiltering() const;
 
+  /// Returns true if presenting can be skipped, because the frame would look the same as the last one presented.
+  /// Otherwise, records the frame as presented. May end the ImGui frame to check whether any overlays are drawn.
+  bool IsDuplicateFrame(bool post_processing_uses_time);
+
+  /// Returns the size the display texture is saved at, false if it's empty.
+  bool GetDisplayTextureSaveSize(bool full_resolution, bool apply_aspect_ratio, s32* width, s32* height) const;
+
+  /// Called when the GPU timing section changes, backends write a timestamp here before calling the base.
+  virtual void ChangeGPUTimingSection(GPUTimingSection section);
+
   void CalculateDrawRect(s32 window_width, s32 window_height, float* out_left, float* out_top, float* out_width,
                          float* out_height, float* out_left_padding, float* out_top_padding, float* out_scale,
                          float* out_x_scale, bool apply_aspect_ratio = true) const;
@@ -241,8 +317,33 @@ protected:
   std::unique_ptr<GPUTexture> m_cursor_texture;
   float m_cursor_texture_scale = 1.0f;
 
+  struct PresentedFrameState
+  {
+    const GPUTexture* texture;
+    s32 texture_view_x;
+    s32 texture_view_y;
+    s32 texture_view_width;
+    s32 texture_view_height;
+    s32 display_width;
+    s32 display_height;
+    s32 display_active_left;
+    s32 display_active_top;
+    s32 display_active_width;
+    s32 display_active_height;
+    float display_aspect_ratio;
+    u32 window_width;
+    u32 window_height;
+  };
+  PresentedFrameState m_last_presented_frame = {};
+  bool m_last_presented_frame_valid = false;
+  bool m_last_presented_frame_had_overlays = false;
+  bool m_new_display_frame = false;
+  bool m_display_content_changed = true;
+  bool m_skip_duplicate_frames = false;
+
   bool m_display_changed = false;
   bool m_gpu_timing_enabled = false;
+  GPUTimingSection m_gpu_timing_section = GPUTimingSection::Other;
 };
 
 /// Returns a pointer to the current host display abstraction. Assumes AcquireHostDisplay() has been caled.
@@ -3,6 +3,7 @@
 #include "common/types.h"
 #include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 class SettingsInterface;
@@ -40,6 +41,57 @@ float GetFloatSettingValue(const char* section, const char* key, float default_v
 double GetDoubleSettingValue(const char* section, const char* key, double default_value = 0.0);
 std::vector<std::string> GetStringListSetting(const char* section, const char* key);
 
+/// Returns a counter which is incremented whenever any setting may have changed.
+u32 GetSettingsGeneration();
+
+/// Caches a setting's value until settings next change, so frequent lookups skip the locked, layered string lookup.
+/// Each instance must only be used from one thread.
+template<typename T>
+class CachedSettingValue
+{
+public:
+  CachedSettingValue(const char* section, const char* key, T default_value)
+    : m_section(section), m_key(key), m_default_value(std::move(default_value))
+  {
+  }
+
+  const T& Get()
+  {
+    // read the generation first, so a change during the lookup forces another one next time
+    const u32 generation = GetSettingsGeneration();
+    if (m_generation != generation)
+    {
+      m_value = Lookup();
+      m_generation = generation;
+    }
+
+    return m_value;
+  }
+
+private:
+  T Lookup() const
+  {
+    if constexpr (std::is_same_v<T, bool>)
+      return GetBoolSettingValue(m_section, m_key, m_default_value);
+    else if constexpr (std::is_same_v<T, s32>)
+      return GetIntSettingValue(m_section, m_key, m_default_value);
+    else if constexpr (std::is_same_v<T, u32>)
+      return GetUIntSettingValue(m_section, m_key, m_default_value);
+    else if constexpr (std::is_same_v<T, float>)
+      return GetFloatSettingValue(m_section, m_key, m_default_value);
+    else if constexpr (std::is_same_v<T, double>)
+      return GetDoubleSettingValue(m_section, m_key, m_default_value);
+    else
+      return GetStringSettingValue(m_section, m_key, m_default_value.c_str());
+  }
+
+  const char* m_section;
+  const char* m_key;
+  T m_default_value;
+  T m_value{};
+  u32 m_generation = static_cast<u32>(-1);
+};
+
 /// Direct access to settings interface. Must hold the lock when calling GetSettingsInterface() and while using it.
 std::unique_lock<std::mutex> GetSettingsLock();
 SettingsInterface* GetSettingsInterface();
@@ -66,5 +118,8 @@ void SetGameSettingsLayer(SettingsInterface* sif);
 
 /// Sets the input profile settings layer. Called by VMManager when the game changes.
 void SetInputSettingsLayer(SettingsInterface* sif);
+
+/// Invalidates all cached setting values. Called when settings are applied.
+void InvalidateCachedSettings();
 } // namespace Internal
 } // namespace Host
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "mdec.h"
 #include "common/log.h"
+#include "common/platform.h"
 #include "cpu_core.h"
 #include "dma.h"
 #include "host.h"
@@ -9,6 +10,174 @@
 #include "util/state_wrapper.h"
 Log_SetChannel(MDEC);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#endif
+
+// The vector kernels below are bit-exact with the scalar code.
+//
+// IDCT: the first pass sums eight products of the 11-bit coefficients and the 16-bit scale table, which fits in 32
+// bits, but the second pass would need 64-bit products. Instead, each first pass value t is split into (t SAR 16) and
+// the two bytes of its low halfword, and the three parts are multiplied separately. Carrying the low sums into the high
+// sum leaves a remainder below 10000h, which can't change ((sum SAR 32) + sum bit 31) = (high + 8000h) SAR 16.
+//
+// YUV to RGB: the chroma terms use the same single-precision multiplies and adds as the scalar code, computed once per
+// chroma sample and duplicated for the two pixels which share it.
+
+#if defined(CPU_X64)
+
+// Interleaves rows u and u+1 of a block, so _mm_madd_epi16() with a broadcast coefficient pair sums two rows at once.
+ALWAYS_INLINE static void InterleaveRowPairs(const s16* block, __m128i pairs[8])
+{
+  for (u32 u = 0; u < 8; u += 2)
+  {
+    const __m128i row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&block[u * 8]));
+    const __m128i row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&block[(u + 1) * 8]));
+    pairs[u] = _mm_unpacklo_epi16(row0, row1);
+    pairs[u + 1] = _mm_unpackhi_epi16(row0, row1);
+  }
+}
+
+// Sum of coeffs[u] * row u, for columns 0-3 and 4-7.
+ALWAYS_INLINE static void MultiplyRows(const __m128i pairs[8], const s16* coeffs, __m128i* sum_lo, __m128i* sum_hi)
+{
+  __m128i lo = _mm_setzero_si128();
+  __m128i hi = _mm_setzero_si128();
+  for (u32 u = 0; u < 8; u += 2)
+  {
+    const __m128i coeff = _mm_set1_epi32(static_cast<s32>(ZeroExtend32(static_cast<u16>(coeffs[u])) |
+                                                          (ZeroExtend32(static_cast<u16>(coeffs[u + 1])) << 16)));
+    lo = _mm_add_epi32(lo, _mm_madd_epi16(pairs[u], coeff));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(pairs[u + 1], coeff));
+  }
+
+  *sum_lo = lo;
+  *sum_hi = hi;
+}
+
+ALWAYS_INLINE static __m128i CombineIDCTSums(__m128i high, __m128i mid, __m128i low)
+{
+  mid = _mm_add_epi32(mid, _mm_srai_epi32(low, 8));
+  high = _mm_add_epi32(high, _mm_srai_epi32(mid, 8));
+  const __m128i result = _mm_srai_epi32(_mm_add_epi32(high, _mm_set1_epi32(0x8000)), 16);
+  return _mm_srai_epi32(_mm_slli_epi32(result, 23), 23);
+}
+
+static void IDCTVector(s16* blk, const s16* scale_table)
+{
+  alignas(16) std::array<s16, 64> scale_transposed;
+  for (u32 i = 0; i < 64; i++)
+    scale_transposed[i] = scale_table[(i % 8) * 8 + (i / 8)];
+
+  __m128i pairs[8];
+  InterleaveRowPairs(blk, pairs);
+
+  alignas(16) std::array<s16, 64> temp_high, temp_mid, temp_low;
+  const __m128i byte_mask = _mm_set1_epi32(0xFF);
+  for (u32 y = 0; y < 8; y++)
+  {
+    __m128i sum_lo, sum_hi;
+    MultiplyRows(pairs, &scale_transposed[y * 8], &sum_lo, &sum_hi);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&temp_high[y * 8]),
+                    _mm_packs_epi32(_mm_srai_epi32(sum_lo, 16), _mm_srai_epi32(sum_hi, 16)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&temp_mid[y * 8]),
+                    _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(sum_lo, 8), byte_mask),
+                                    _mm_and_si128(_mm_srli_epi32(sum_hi, 8), byte_mask)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&temp_low[y * 8]),
+                    _mm_packs_epi32(_mm_and_si128(sum_lo, byte_mask), _mm_and_si128(sum_hi, byte_mask)));
+  }
+
+  InterleaveRowPairs(scale_table, pairs);
+  for (u32 y = 0; y < 8; y++)
+  {
+    __m128i high_lo, high_hi, mid_lo, mid_hi, low_lo, low_hi;
+    MultiplyRows(pairs, &temp_high[y * 8], &high_lo, &high_hi);
+    MultiplyRows(pairs, &temp_mid[y * 8], &mid_lo, &mid_hi);
+    MultiplyRows(pairs, &temp_low[y * 8], &low_lo, &low_hi);
+
+    const __m128i result =
+      _mm_packs_epi32(CombineIDCTSums(high_lo, mid_lo, low_lo), CombineIDCTSums(high_hi, mid_hi, low_hi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&blk[y * 8]),
+                     _mm_min_epi16(_mm_max_epi16(result, _mm_set1_epi16(-128)), _mm_set1_epi16(127)));
+  }
+}
+
+// Crblk/Cbblk point to the first chroma sample of the quadrant, out to its first pixel.
+static void YUVToRGBVector(u32* out, const s16* Crblk, const s16* Cbblk, const s16* Yblk)
+{
+  const __m128i min_value = _mm_set1_epi16(-128);
+  const __m128i max_value = _mm_set1_epi16(127);
+  const __m128i offset = _mm_set1_epi16(128);
+
+  for (u32 cy = 0; cy < 4; cy++)
+  {
+    const __m128i cr = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Crblk[cy * 8]));
+    const __m128i cb = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&Cbblk[cy * 8]));
+    const __m128 Rf = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cr, cr), 16));
+    const __m128 Bf = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(cb, cb), 16));
+
+    const __m128i G = _mm_cvttps_epi32(
+      _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.3437f), Bf), _mm_mul_ps(_mm_set1_ps(-0.7143f), Rf)));
+    const __m128i R = _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(1.402f), Rf));
+    const __m128i B = _mm_cvttps_epi32(_mm_mul_ps(_mm_set1_ps(1.772f), Bf));
+
+    const __m128i R16 = _mm_packs_epi32(R, R);
+    const __m128i G16 = _mm_packs_epi32(G, G);
+    const __m128i B16 = _mm_packs_epi32(B, B);
+    const __m128i Rx2 = _mm_unpacklo_epi16(R16, R16);
+    const __m128i Gx2 = _mm_unpacklo_epi16(G16, G16);
+    const __m128i Bx2 = _mm_unpacklo_epi16(B16, B16);
+
+    for (u32 y = cy * 2; y < (cy * 2 + 2); y++)
+    {
+      const __m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[y * 8]));
+      const __m128i r =
+        _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, Rx2), min_value), max_value), offset);
+      const __m128i g =
+        _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, Gx2), min_value), max_value), offset);
+      const __m128i b =
+        _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(_mm_add_epi16(Y, Bx2), min_value), max_value), offset);
+      const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[y * 16]), _mm_unpacklo_epi16(rg, b));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[y * 16 + 4]), _mm_unpackhi_epi16(rg, b));
+    }
+  }
+}
+
+static void YToMonoVector(u32* out, const s16* Yblk)
+{
+  for (u32 i = 0; i < 64; i += 8)
+  {
+    __m128i Y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&Yblk[i]));
+    Y = _mm_srai_epi16(_mm_slli_epi16(Y, 6), 6);
+    Y = _mm_add_epi16(_mm_min_epi16(_mm_max_epi16(Y, _mm_set1_epi16(-128)), _mm_set1_epi16(127)), _mm_set1_epi16(128));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i]), _mm_unpacklo_epi16(Y, _mm_setzero_si128()));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out[i + 4]), _mm_unpackhi_epi16(Y, _mm_setzero_si128()));
+  }
+}
+
+// Packs eight 24-bit pixels to 15-bit, two per word.
+ALWAYS_INLINE static void PackRGB15Vector(u32* out, const u32* in, u16 bit15)
+{
+  const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+  const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4));
+  const __m128i r_mask = _mm_set1_epi32(0x1F);
+  const __m128i g_mask = _mm_set1_epi32(0x1F << 5);
+  const __m128i b_mask = _mm_set1_epi32(0x1F << 10);
+  const __m128i v0 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(c0, 3), r_mask),
+                                               _mm_and_si128(_mm_srli_epi32(c0, 6), g_mask)),
+                                  _mm_and_si128(_mm_srli_epi32(c0, 9), b_mask));
+  const __m128i v1 = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(c1, 3), r_mask),
+                                               _mm_and_si128(_mm_srli_epi32(c1, 6), g_mask)),
+                                  _mm_and_si128(_mm_srli_epi32(c1, 9), b_mask));
+
+  // without bit 15 the values fit in a signed halfword, so the saturating pack doesn't clamp them
+  const __m128i packed = _mm_or_si128(_mm_packs_epi32(v0, v1), _mm_set1_epi16(static_cast<s16>(bit15 << 15)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+}
+
+#endif
+
 MDEC g_mdec;
 
 MDEC::MDEC() = default;
@@ -22,10 +191,25 @@ void MDEC::Initialize()
     [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<MDEC*>(param)->CopyOutBlock(); }, this, false);
   m_total_blocks_decoded = 0;
   Reset();
+
+  if (g_settings.mdec_decode_on_thread)
+    StartWorkerThread();
+}
+
+void MDEC::UpdateSettings()
+{
+  if (m_use_worker_thread == g_settings.mdec_decode_on_thread)
+    return;
+
+  if (g_settings.mdec_decode_on_thread)
+    StartWorkerThread();
+  else
+    StopWorkerThread();
 }
 
 void MDEC::Shutdown()
 {
+  StopWorkerThread();
   m_block_copy_out_event.reset();
 }
 
@@ -37,6 +221,12 @@ void MDEC::Reset()
 
 bool MDEC::DoState(StateWrapper& sw)
 {
+  WaitForWorkerThread();
+
+  // save states always have the blocks of a partially decoded macroblock transformed
+  if (sw.IsWriting() && m_state == State::DecodingMacroblock)
+    TransformDecodedBlocks();
+
   sw.Do(&m_status.bits);
   sw.Do(&m_enable_dma_in);
   sw.Do(&m_enable_dma_out);
@@ -53,6 +243,9 @@ bool MDEC::DoState(StateWrapper& sw)
   sw.Do(&m_current_q_scale);
   sw.Do(&m_block_rgb);
 
+  if (sw.IsReading())
+    m_blocks_transformed = (m_state == State::DecodingMacroblock) ? m_current_block : 0;
+
   bool block_copy_out_pending = HasPendingBlockCopyOut();
   sw.Do(&block_copy_out_pending);
   if (sw.IsReading())
@@ -154,6 +347,8 @@ bool MDEC::HasPendingBlockCopyOut() const
 
 void MDEC::SoftReset()
 {
+  WaitForWorkerThread();
+
   m_status.bits = 0;
   m_enable_dma_in = false;
   m_enable_dma_out = false;
@@ -170,6 +365,7 @@ void MDEC::SoftReset()
 
 void MDEC::ResetDecoder()
 {
+  m_blocks_transformed = 0;
   m_current_block = 0;
   m_current_coefficient = 64;
   m_current_q_scale = 0;
@@ -384,13 +580,11 @@ bool MDEC::DecodeMonoMacroblock()
   if (!rl_decode_block(m_blocks[0].data(), m_iq_y.data()))
     return false;
 
-  IDCT(m_blocks[0].data());
-
   Log_DebugPrintf("Decoded mono macroblock, %u words remaining", m_remaining_halfwords / 2);
   ResetDecoder();
   m_state = State::WritingMacroblock;
 
-  y_to_mono(m_blocks[0]);
+  FinishMacroblock(true, 0);
 
   ScheduleBlockCopyOut(s_ticks_per_block[static_cast<u8>(m_status.data_output_depth)] * 6);
 
@@ -405,7 +599,11 @@ bool MDEC::DecodeColoredMacroblock()
     if (!rl_decode_block(m_blocks[m_current_block].data(), (m_current_block >= 2) ? m_iq_y.data() : m_iq_uv.data()))
       return false;
 
-    IDCT(m_blocks[m_current_block].data());
+    if (!m_use_worker_thread)
+    {
+      IDCT(m_blocks[m_current_block].data());
+      m_blocks_transformed = m_current_block + 1;
+    }
   }
 
   if (!m_data_out_fifo.IsEmpty())
@@ -413,19 +611,61 @@ bool MDEC::DecodeColoredMacroblock()
 
   // done decoding
   Log_DebugPrintf("Decoded colored macroblock, %u words remaining", m_remaining_halfwords / 2);
+  const u32 blocks_transformed = m_blocks_transformed;
   ResetDecoder();
   m_state = State::WritingMacroblock;
 
-  yuv_to_rgb(0, 0, m_blocks[0], m_blocks[1], m_blocks[2]);
-  yuv_to_rgb(8, 0, m_blocks[0], m_blocks[1], m_blocks[3]);
-  yuv_to_rgb(0, 8, m_blocks[0], m_blocks[1], m_blocks[4]);
-  yuv_to_rgb(8, 8, m_blocks[0], m_blocks[1], m_blocks[5]);
+  FinishMacroblock(false, blocks_transformed);
   m_total_blocks_decoded += 4;
 
   ScheduleBlockCopyOut(s_ticks_per_block[static_cast<u8>(m_status.data_output_depth)] * 6);
   return true;
 }
 
+void MDEC::FinishMacroblock(bool mono, u32 first_untransformed_block)
+{
+  if (m_use_worker_thread)
+  {
+    {
+      std::unique_lock<std::mutex> lock(m_worker_mutex);
+      m_worker_mono = mono;
+      m_worker_first_block = first_untransformed_block;
+      m_worker_pending = true;
+    }
+
+    m_worker_busy = true;
+    m_worker_start_cv.notify_one();
+    return;
+  }
+
+  ConvertMacroblock(mono, first_untransformed_block);
+}
+
+void MDEC::ConvertMacroblock(bool mono, u32 first_untransformed_block)
+{
+  const u32 num_blocks = mono ? 1 : NUM_BLOCKS;
+  for (u32 i = first_untransformed_block; i < num_blocks; i++)
+    IDCT(m_blocks[i].data());
+
+  if (mono)
+  {
+    y_to_mono(m_blocks[0]);
+  }
+  else
+  {
+    yuv_to_rgb(0, 0, m_blocks[0], m_blocks[1], m_blocks[2]);
+    yuv_to_rgb(8, 0, m_blocks[0], m_blocks[1], m_blocks[3]);
+    yuv_to_rgb(0, 8, m_blocks[0], m_blocks[1], m_blocks[4]);
+    yuv_to_rgb(8, 8, m_blocks[0], m_blocks[1], m_blocks[5]);
+  }
+}
+
+void MDEC::TransformDecodedBlocks()
+{
+  for (; m_blocks_transformed < m_current_block; m_blocks_transformed++)
+    IDCT(m_blocks[m_blocks_transformed].data());
+}
+
 void MDEC::ScheduleBlockCopyOut(TickCount ticks)
 {
   DebugAssert(!HasPendingBlockCopyOut());
@@ -438,6 +678,7 @@ void MDEC::CopyOutBlock()
 {
   Assert(m_state == State::WritingMacroblock);
   m_block_copy_out_event->Deactivate();
+  WaitForWorkerThread();
 
   switch (m_status.data_output_depth)
   {
@@ -475,46 +716,28 @@ void MDEC::CopyOutBlock()
 
     case DataOutputDepth_24Bit:
     {
-      // pack tightly
-      u32 index = 0;
-      u32 state = 0;
-      u32 rgb = 0;
-      while (index < m_block_rgb.size())
+      // pack tightly, RGBR GBRG BRGB
+      std::array<u32, 64 * 3> words;
+      u8* out_ptr = reinterpret_cast<u8*>(words.data());
+      for (const u32 rgb : m_block_rgb)
       {
-        switch (state)
-        {
-          case 0:
-            rgb = m_block_rgb[index++]; // RGB-
-            state = 1;
-            break;
-          case 1:
-            rgb |= (m_block_rgb[index] & 0xFF) << 24; // RGBR
-            m_data_out_fifo.Push(rgb);
-            rgb = m_block_rgb[index] >> 8; // GB--
-            index++;
-            state = 2;
-            break;
-          case 2:
-            rgb |= m_block_rgb[index] << 16; // GBRG
-            m_data_out_fifo.Push(rgb);
-            rgb = m_block_rgb[index] >> 16; // B---
-            index++;
-            state = 3;
-            break;
-          case 3:
-            rgb |= m_block_rgb[index] << 8; // BRGB
-            m_data_out_fifo.Push(rgb);
-            index++;
-            state = 0;
-            break;
-        }
+        *(out_ptr++) = Truncate8(rgb);
+        *(out_ptr++) = Truncate8(rgb >> 8);
+        *(out_ptr++) = Truncate8(rgb >> 16);
       }
-      break;
+      m_data_out_fifo.PushRange(words.data(), static_cast<u32>(words.size()));
     }
+    break;
 
     case DataOutputDepth_15Bit:
     {
       const u16 a = ZeroExtend16(m_status.data_output_bit15.GetValue());
+#if defined(CPU_X64)
+      std::array<u32, 256 / 2> words;
+      for (u32 i = 0; i < static_cast<u32>(m_block_rgb.size()); i += 8)
+        PackRGB15Vector(&words[i / 2], &m_block_rgb[i], a);
+      m_data_out_fifo.PushRange(words.data(), static_cast<u32>(words.size()));
+#else
       for (u32 i = 0; i < static_cast<u32>(m_block_rgb.size());)
       {
         u32 color = m_block_rgb[i++];
@@ -531,6 +754,7 @@ void MDEC::CopyOutBlock()
 
         m_data_out_fifo.Push(ZeroExtend32(color15a) | (ZeroExtend32(color15b) << 16));
       }
+#endif
     }
     break;
 
@@ -623,6 +847,9 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
 
 void MDEC::IDCT(s16* blk)
 {
+#if defined(CPU_X64)
+  IDCTVector(blk, m_scale_table.data());
+#else
   std::array<s64, 64> temp_buffer;
   for (u32 x = 0; x < 8; x++)
   {
@@ -646,11 +873,16 @@ void MDEC::IDCT(s16* blk)
         static_cast<s16>(std::clamp<s32>(SignExtendN<9, s32>((sum >> 32) + ((sum >> 31) & 1)), -128, 127));
     }
   }
+#endif
 }
 
 void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
                       const std::array<s16, 64>& Yblk)
 {
+#if defined(CPU_X64)
+  const u32 chroma_offset = (xx / 2) + (yy / 2) * 8;
+  YUVToRGBVector(&m_block_rgb[xx + yy * 16], &Crblk[chroma_offset], &Cbblk[chroma_offset], Yblk.data());
+#else
   for (u32 y = 0; y < 8; y++)
   {
     for (u32 x = 0; x < 8; x++)
@@ -677,10 +909,14 @@ void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const st
                                                 (ZeroExtend32(static_cast<u16>(B)) << 16);
     }
   }
+#endif
 }
 
 void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
 {
+#if defined(CPU_X64)
+  YToMonoVector(m_block_rgb.data(), Yblk.data());
+#else
   for (u32 i = 0; i < 64; i++)
   {
     s16 Y = Yblk[i];
@@ -689,6 +925,81 @@ void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
     Y += 128;
     m_block_rgb[i] = static_cast<u32>(Y) & 0xFF;
   }
+#endif
+}
+
+void MDEC::StartWorkerThread()
+{
+  DebugAssert(!m_use_worker_thread);
+
+  // anything partially decoded so far was decoded without the worker, and is already transformed
+  m_worker_shutdown = false;
+  m_worker_pending = false;
+  m_worker_busy = false;
+  m_use_worker_thread = true;
+  m_worker_thread.Start([this]() { WorkerThreadEntryPoint(); });
+  Log_InfoPrint("MDEC worker thread started.");
+}
+
+void MDEC::StopWorkerThread()
+{
+  if (!m_use_worker_thread)
+    return;
+
+  WaitForWorkerThread();
+
+  {
+    std::unique_lock<std::mutex> lock(m_worker_mutex);
+    m_worker_shutdown = true;
+  }
+  m_worker_start_cv.notify_one();
+  m_worker_thread.Join();
+  m_use_worker_thread = false;
+
+  // the blocks of a partially decoded macroblock haven't been transformed yet
+  if (m_state == State::DecodingMacroblock)
+    TransformDecodedBlocks();
+
+  Log_InfoPrint("MDEC worker thread stopped.");
+}
+
+void MDEC::WorkerThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("MDEC Worker");
+
+  for (;;)
+  {
+    bool mono;
+    u32 first_block;
+    {
+      std::unique_lock<std::mutex> lock(m_worker_mutex);
+      m_worker_start_cv.wait(lock, [this]() { return m_worker_shutdown || m_worker_pending; });
+      if (m_worker_shutdown)
+        break;
+
+      mono = m_worker_mono;
+      first_block = m_worker_first_block;
+    }
+
+    // the CPU thread doesn't touch the blocks, scale table or RGB output until the copy out waits for us
+    ConvertMacroblock(mono, first_block);
+
+    {
+      std::unique_lock<std::mutex> lock(m_worker_mutex);
+      m_worker_pending = false;
+    }
+    m_worker_done_cv.notify_one();
+  }
+}
+
+void MDEC::WaitForWorkerThread()
+{
+  if (!m_worker_busy)
+    return;
+
+  std::unique_lock<std::mutex> lock(m_worker_mutex);
+  m_worker_done_cv.wait(lock, [this]() { return !m_worker_pending; });
+  m_worker_busy = false;
 }
 
 void MDEC::HandleSetQuantTableCommand()
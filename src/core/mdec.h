@@ -1,9 +1,12 @@
 #pragma once
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
+#include "common/threading.h"
 #include "types.h"
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
 class StateWrapper;
 
@@ -19,6 +22,7 @@ public:
   void Shutdown();
   void Reset();
   bool DoState(StateWrapper& sw);
+  void UpdateSettings();
 
   // I/O
   u32 ReadRegister(u32 offset);
@@ -27,6 +31,9 @@ public:
   void DMARead(u32* words, u32 word_count);
   void DMAWrite(const u32* words, u32 word_count);
 
+  /// Running count of decoded blocks, used to detect video playback.
+  u32 GetTotalBlocksDecoded() const { return m_total_blocks_decoded; }
+
   void DrawDebugStateWindow();
 
 private:
@@ -111,9 +118,17 @@ private:
 
   bool DecodeMonoMacroblock();
   bool DecodeColoredMacroblock();
+  void FinishMacroblock(bool mono, u32 first_untransformed_block);
+  void ConvertMacroblock(bool mono, u32 first_untransformed_block);
+  void TransformDecodedBlocks();
   void ScheduleBlockCopyOut(TickCount ticks);
   void CopyOutBlock();
 
+  void StartWorkerThread();
+  void StopWorkerThread();
+  void WorkerThreadEntryPoint();
+  void WaitForWorkerThread();
+
   // from nocash spec
   bool rl_decode_block(s16* blk, const u8* qt);
   void IDCT(s16* blk);
@@ -145,6 +160,20 @@ private:
   std::array<u32, 256> m_block_rgb{};
   std::unique_ptr<TimingEvent> m_block_copy_out_event;
 
+  // With the worker thread, blocks are only run-length decoded as data arrives, and the IDCT and colour conversion
+  // happen on the worker between the macroblock completing and its emulated copy out.
+  u32 m_blocks_transformed = 0;
+  Threading::Thread m_worker_thread;
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_start_cv;
+  std::condition_variable m_worker_done_cv;
+  u32 m_worker_first_block = 0;
+  bool m_worker_mono = false;
+  bool m_worker_pending = false;
+  bool m_worker_shutdown = false;
+  bool m_worker_busy = false;
+  bool m_use_worker_thread = false;
+
   u32 m_total_blocks_decoded = 0;
 };
 
@@ -5,12 +5,28 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "host.h"
 #include "system.h"
 #include "util/state_wrapper.h"
 #include <cstdio>
+#include <mutex>
+#include <unordered_map>
 Log_SetChannel(MemoryCard);
 
+namespace {
+struct PendingSave
+{
+  std::unique_ptr<MemoryCardImage::DataArray> data;
+  bool display_osd_message = false;
+};
+} // namespace
+
+// keyed by filename, an entry exists while a worker owns the file
+static std::mutex s_pending_saves_mutex;
+static std::unordered_map<std::string, PendingSave> s_pending_saves;
+static Threading::ThreadPool::TaskGroup s_background_saves;
+
 MemoryCard::MemoryCard()
 {
   m_FLAG.no_write_yet = true;
@@ -19,11 +35,17 @@ MemoryCard::MemoryCard()
     "Memory Card Host Flush", GetSaveDelayInTicks(), GetSaveDelayInTicks(),
     [](void* param, TickCount ticks, TickCount ticks_late) { static_cast<MemoryCard*>(param)->SaveIfChanged(true); },
     this, false);
+
+  // only writes to the host file, so there's no need to stop the CPU on time for it
+  m_save_event->SetTolerance(GetSaveDelayInTicks());
 }
 
 MemoryCard::~MemoryCard()
 {
   SaveIfChanged(false);
+
+  // the card is about to be removed or replaced, so make sure it's on disk before anyone reads it back
+  FlushBackgroundSaves();
 }
 
 std::string MemoryCard::SanitizeGameTitleForFileName(const std::string_view& name)
@@ -292,6 +314,7 @@ void MemoryCard::Format()
 
 bool MemoryCard::LoadFromFile()
 {
+  FlushBackgroundSaves();
   return MemoryCardImage::LoadFromFile(&m_data, m_filename.c_str());
 }
 
@@ -307,15 +330,76 @@ bool MemoryCard::SaveIfChanged(bool display_osd_message)
   if (m_filename.empty())
     return false;
 
+  QueueBackgroundSave(m_filename, m_data, display_osd_message);
+  return true;
+}
+
+void MemoryCard::QueueBackgroundSave(std::string filename, const MemoryCardImage::DataArray& data,
+                                     bool display_osd_message)
+{
+  std::unique_lock lock(s_pending_saves_mutex);
+  auto iter = s_pending_saves.find(filename);
+  if (iter != s_pending_saves.end())
+  {
+    // a worker already owns this file, it'll pick up the new snapshot once the current write finishes
+    if (iter->second.data)
+      Log_DevPrintf("Coalescing memory card save to '%s'", filename.c_str());
+    else
+      iter->second.data = std::make_unique<MemoryCardImage::DataArray>();
+
+    *iter->second.data = data;
+    iter->second.display_osd_message |= display_osd_message;
+    return;
+  }
+
+  PendingSave& save = s_pending_saves[filename];
+  save.data = std::make_unique<MemoryCardImage::DataArray>(data);
+  save.display_osd_message = display_osd_message;
+  lock.unlock();
+
+  Threading::ThreadPool::GetShared().Submit([filename = std::move(filename)]() { WriteBackgroundSaves(filename); },
+                                            Threading::ThreadPool::Priority::Low, &s_background_saves);
+}
+
+void MemoryCard::WriteBackgroundSaves(const std::string& filename)
+{
+  std::unique_lock lock(s_pending_saves_mutex);
+  for (;;)
+  {
+    auto iter = s_pending_saves.find(filename);
+    if (!iter->second.data)
+    {
+      s_pending_saves.erase(iter);
+      return;
+    }
+
+    std::unique_ptr<MemoryCardImage::DataArray> data = std::move(iter->second.data);
+    const bool display_osd_message = std::exchange(iter->second.display_osd_message, false);
+    lock.unlock();
+
+    WriteToFile(*data, filename, display_osd_message);
+
+    lock.lock();
+  }
+}
+
+void MemoryCard::FlushBackgroundSaves()
+{
+  s_background_saves.Wait(Threading::ThreadPool::GetShared());
+}
+
+bool MemoryCard::WriteToFile(const MemoryCardImage::DataArray& data, const std::string& filename,
+                             bool display_osd_message)
+{
   std::string osd_key;
   std::string display_name;
   if (display_osd_message)
   {
-    osd_key = fmt::format("memory_card_save_{}", m_filename);
-    display_name = FileSystem::GetDisplayNameFromPath(m_filename);
+    osd_key = fmt::format("memory_card_save_{}", filename);
+    display_name = FileSystem::GetDisplayNameFromPath(filename);
   }
 
-  if (!MemoryCardImage::SaveToFile(m_data, m_filename.c_str()))
+  if (!MemoryCardImage::SaveToFile(data, filename.c_str()))
   {
     if (display_osd_message)
     {
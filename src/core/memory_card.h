@@ -78,6 +78,17 @@ private:
 
   static TickCount GetSaveDelayInTicks();
 
+  /// Writes a snapshot of the card to disk on a worker thread. Later saves to the same file replace any snapshot
+  /// which hasn't been written yet, and writes to any one file never overlap.
+  static void QueueBackgroundSave(std::string filename, const MemoryCardImage::DataArray& data,
+                                  bool display_osd_message);
+  static void WriteBackgroundSaves(const std::string& filename);
+  static bool WriteToFile(const MemoryCardImage::DataArray& data, const std::string& filename,
+                          bool display_osd_message);
+
+  /// Blocks until all queued background saves have been written.
+  static void FlushBackgroundSaves();
+
   bool LoadFromFile();
   bool SaveIfChanged(bool display_osd_message);
   void QueueFileSave();
@@ -0,0 +1,257 @@
+#include "mmio_profiler.h"
+
+#ifdef WITH_MMIO_PROFILER
+
+#include "bus.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/path.h"
+#include "fmt/chrono.h"
+#include "fmt/format.h"
+#include "host.h"
+#include "imgui.h"
+#include "settings.h"
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+Log_SetChannel(MMIOProfiler);
+
+namespace MMIOProfiler {
+
+namespace {
+struct RegisterEntry
+{
+  u32 key;
+  u64 count;
+  std::vector<std::pair<VirtualMemoryAddress, u64>> pcs;
+};
+} // namespace
+
+enum : u32
+{
+  IO_BASE = Bus::MEMCTRL_BASE,
+  IO_SIZE = Bus::EXP2_BASE - Bus::MEMCTRL_BASE,
+  MAX_TOOLTIP_PCS = 10,
+};
+
+// register keys are the offset into the I/O area, the access type and the access size
+static constexpr u32 MakeRegisterKey(MemoryAccessType type, MemoryAccessSize size, u32 offset)
+{
+  return (offset << 3) | (static_cast<u32>(type) << 2) | static_cast<u32>(size);
+}
+static constexpr PhysicalMemoryAddress GetRegisterKeyAddress(u32 key)
+{
+  return IO_BASE + (key >> 3);
+}
+static constexpr MemoryAccessType GetRegisterKeyType(u32 key)
+{
+  return static_cast<MemoryAccessType>((key >> 2) & 1);
+}
+static constexpr u32 GetRegisterKeyBits(u32 key)
+{
+  return 8u << (key & 3);
+}
+
+static std::string GetRegisterName(PhysicalMemoryAddress address);
+static std::vector<RegisterEntry> GatherEntries();
+
+// keyed by PC in the upper half and register key in the lower half
+static std::unordered_map<u64, u64> s_pc_counts;
+static u64 s_total_count = 0;
+
+} // namespace MMIOProfiler
+
+void MMIOProfiler::RecordAccess(MemoryAccessType type, MemoryAccessSize size, PhysicalMemoryAddress address,
+                                VirtualMemoryAddress pc)
+{
+  const u32 offset = address - IO_BASE;
+  if (offset >= IO_SIZE)
+    return;
+
+  s_pc_counts[(static_cast<u64>(pc) << 32) | MakeRegisterKey(type, size, offset)]++;
+  s_total_count++;
+}
+
+void MMIOProfiler::Reset()
+{
+  s_pc_counts.clear();
+  s_total_count = 0;
+}
+
+std::string MMIOProfiler::GetRegisterName(PhysicalMemoryAddress address)
+{
+  static constexpr std::array<const char*, 4> dma_names = {{"MADR", "BCR", "CHCR", "?"}};
+  static constexpr std::array<const char*, 4> timer_names = {{"COUNT", "MODE", "TARGET", "?"}};
+  static constexpr std::array<const char*, 8> voice_names = {
+    {"VOL_L", "VOL_R", "PITCH", "START", "ADSR_LO", "ADSR_HI", "ADSR_VOL", "REPEAT"}};
+  static constexpr std::pair<PhysicalMemoryAddress, const char*> names[] = {
+    {0x1F801000, "EXP1_BASE"}, {0x1F801004, "EXP2_BASE"}, {0x1F801008, "EXP1_DELAY"}, {0x1F80100C, "EXP3_DELAY"},
+    {0x1F801010, "BIOS_DELAY"}, {0x1F801014, "SPU_DELAY"}, {0x1F801018, "CDROM_DELAY"}, {0x1F80101C, "EXP2_DELAY"},
+    {0x1F801020, "COM_DELAY"}, {0x1F801040, "JOY_DATA"}, {0x1F801044, "JOY_STAT"}, {0x1F801048, "JOY_MODE"},
+    {0x1F80104A, "JOY_CTRL"}, {0x1F80104E, "JOY_BAUD"}, {0x1F801050, "SIO_DATA"}, {0x1F801054, "SIO_STAT"},
+    {0x1F801058, "SIO_MODE"}, {0x1F80105A, "SIO_CTRL"}, {0x1F80105E, "SIO_BAUD"}, {0x1F801060, "RAM_SIZE"},
+    {0x1F801070, "I_STAT"}, {0x1F801074, "I_MASK"}, {0x1F8010F0, "DPCR"}, {0x1F8010F4, "DICR"},
+    {0x1F801800, "CDROM_STATUS"}, {0x1F801801, "CDROM_REG1"}, {0x1F801802, "CDROM_REG2"}, {0x1F801803, "CDROM_REG3"},
+    {0x1F801810, "GP0/GPUREAD"}, {0x1F801814, "GP1/GPUSTAT"}, {0x1F801820, "MDEC_CMD/DATA"},
+    {0x1F801824, "MDEC_CTRL/STAT"}, {0x1F801D80, "SPU_MAIN_VOL_L"}, {0x1F801D82, "SPU_MAIN_VOL_R"},
+    {0x1F801D84, "SPU_REVERB_VOL_L"}, {0x1F801D86, "SPU_REVERB_VOL_R"}, {0x1F801D88, "SPU_KEY_ON"},
+    {0x1F801D8C, "SPU_KEY_OFF"}, {0x1F801D90, "SPU_PITCH_MOD"}, {0x1F801D94, "SPU_NOISE_ON"},
+    {0x1F801D98, "SPU_REVERB_ON"}, {0x1F801D9C, "SPU_ENDX"}, {0x1F801DA2, "SPU_REVERB_BASE"},
+    {0x1F801DA4, "SPU_IRQ_ADDR"}, {0x1F801DA6, "SPU_TRANSFER_ADDR"}, {0x1F801DA8, "SPU_TRANSFER_FIFO"},
+    {0x1F801DAA, "SPUCNT"}, {0x1F801DAC, "SPU_TRANSFER_CTRL"}, {0x1F801DAE, "SPUSTAT"}, {0x1F801DB0, "SPU_CD_VOL"},
+    {0x1F801DB4, "SPU_EXT_VOL"}, {0x1F801DB8, "SPU_CURRENT_VOL"},
+  };
+
+  if (address >= 0x1F801080 && address < 0x1F8010F0)
+  {
+    return fmt::format("D{}_{}{}", (address - 0x1F801080) / 0x10, dma_names[(address >> 2) & 3],
+                       (address & 3) ? fmt::format("+{}", address & 3) : std::string());
+  }
+  else if (address >= 0x1F801100 && address < 0x1F801130)
+  {
+    return fmt::format("T{}_{}{}", (address - 0x1F801100) / 0x10, timer_names[(address >> 2) & 3],
+                       (address & 3) ? fmt::format("+{}", address & 3) : std::string());
+  }
+  else if (address >= 0x1F801C00 && address < 0x1F801D80)
+  {
+    return fmt::format("V{}_{}{}", (address - 0x1F801C00) / 0x10, voice_names[(address >> 1) & 7],
+                       (address & 1) ? "+1" : "");
+  }
+
+  // the closest register at or below the address, for accesses which don't start at the register
+  const auto it = std::upper_bound(std::begin(names), std::end(names), address,
+                                   [](PhysicalMemoryAddress lhs, const auto& rhs) { return lhs < rhs.first; });
+  if (it == std::begin(names) || (address - (it - 1)->first) >= 4)
+    return {};
+
+  const auto& [register_address, name] = *(it - 1);
+  return (address == register_address) ? std::string(name) : fmt::format("{}+{}", name, address - register_address);
+}
+
+std::vector<MMIOProfiler::RegisterEntry> MMIOProfiler::GatherEntries()
+{
+  std::unordered_map<u32, RegisterEntry> registers;
+  for (const auto& [key, count] : s_pc_counts)
+  {
+    RegisterEntry& entry = registers[static_cast<u32>(key)];
+    entry.key = static_cast<u32>(key);
+    entry.count += count;
+    entry.pcs.emplace_back(static_cast<VirtualMemoryAddress>(key >> 32), count);
+  }
+
+  std::vector<RegisterEntry> entries;
+  entries.reserve(registers.size());
+  for (auto& it : registers)
+  {
+    std::sort(it.second.pcs.begin(), it.second.pcs.end(),
+              [](const auto& lhs, const auto& rhs) { return (lhs.second > rhs.second); });
+    entries.push_back(std::move(it.second));
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const RegisterEntry& lhs, const RegisterEntry& rhs) {
+    return (lhs.count != rhs.count) ? (lhs.count > rhs.count) : (lhs.key < rhs.key);
+  });
+  return entries;
+}
+
+bool MMIOProfiler::DumpToFile(const char* filename)
+{
+  auto fp = FileSystem::OpenManagedCFile(filename, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", filename);
+    return false;
+  }
+
+  fmt::print(fp.get(), "{} register accesses\n", s_total_count);
+  for (const RegisterEntry& entry : GatherEntries())
+  {
+    const PhysicalMemoryAddress address = GetRegisterKeyAddress(entry.key);
+    fmt::print(fp.get(), "\n{:08X} {:<20} {:<5} {:>2}-bit {:>12} {:6.2f}%\n", address, GetRegisterName(address),
+               (GetRegisterKeyType(entry.key) == MemoryAccessType::Read) ? "Read" : "Write",
+               GetRegisterKeyBits(entry.key), entry.count,
+               static_cast<double>(entry.count) * 100.0 / static_cast<double>(s_total_count));
+
+    for (const auto& [pc, count] : entry.pcs)
+      fmt::print(fp.get(), "  PC {:08X} {:>12}\n", pc, count);
+  }
+
+  return (std::ferror(fp.get()) == 0);
+}
+
+void MMIOProfiler::DrawDebugWindow()
+{
+  const float framebuffer_scale = Host::GetOSDScale();
+
+  ImGui::SetNextWindowSize(ImVec2(700.0f * framebuffer_scale, 400.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
+  if (!ImGui::Begin("MMIO Access Counters", nullptr))
+  {
+    ImGui::End();
+    return;
+  }
+
+  if (ImGui::Button("Reset"))
+    Reset();
+
+  ImGui::SameLine();
+  if (ImGui::Button("Dump To File"))
+  {
+    const std::string filename(
+      Path::Combine(EmuFolders::Dumps, fmt::format("mmio_access_{:%Y-%m-%d_%H-%M-%S}.txt",
+                                                   fmt::localtime(std::time(nullptr)))));
+    if (DumpToFile(filename.c_str()))
+      Host::AddFormattedOSDMessage(5.0f, "MMIO access counters dumped to '%s'.", filename.c_str());
+  }
+
+  ImGui::SameLine();
+  ImGui::Text("%llu accesses, hover for PCs", static_cast<unsigned long long>(s_total_count));
+
+  ImGui::Separator();
+  ImGui::Columns(5);
+  ImGui::SetColumnWidth(0, 100.0f * framebuffer_scale);
+  ImGui::SetColumnWidth(1, 200.0f * framebuffer_scale);
+  ImGui::SetColumnWidth(2, 120.0f * framebuffer_scale);
+  ImGui::SetColumnWidth(3, 150.0f * framebuffer_scale);
+
+  for (const char* title : {"Address", "Register", "Access", "Count", "%"})
+  {
+    ImGui::TextUnformatted(title);
+    ImGui::NextColumn();
+  }
+
+  for (const RegisterEntry& entry : GatherEntries())
+  {
+    const PhysicalMemoryAddress address = GetRegisterKeyAddress(entry.key);
+    ImGui::PushID(static_cast<int>(entry.key));
+    ImGui::Selectable(fmt::format("{:08X}", address).c_str(), false, ImGuiSelectableFlags_SpanAllColumns);
+    if (ImGui::IsItemHovered())
+    {
+      ImGui::BeginTooltip();
+      for (size_t i = 0; i < std::min<size_t>(entry.pcs.size(), MAX_TOOLTIP_PCS); i++)
+        ImGui::Text("PC %08X: %llu", entry.pcs[i].first, static_cast<unsigned long long>(entry.pcs[i].second));
+      if (entry.pcs.size() > MAX_TOOLTIP_PCS)
+        ImGui::Text("%zu more", entry.pcs.size() - MAX_TOOLTIP_PCS);
+      ImGui::EndTooltip();
+    }
+    ImGui::PopID();
+    ImGui::NextColumn();
+    ImGui::TextUnformatted(GetRegisterName(address).c_str());
+    ImGui::NextColumn();
+    ImGui::Text("%s %u-bit", (GetRegisterKeyType(entry.key) == MemoryAccessType::Read) ? "Read" : "Write",
+                GetRegisterKeyBits(entry.key));
+    ImGui::NextColumn();
+    ImGui::Text("%llu", static_cast<unsigned long long>(entry.count));
+    ImGui::NextColumn();
+    ImGui::Text("%.2f%%", static_cast<double>(entry.count) * 100.0 / static_cast<double>(s_total_count));
+    ImGui::NextColumn();
+  }
+
+  ImGui::Columns(1);
+  ImGui::End();
+}
+
+#endif
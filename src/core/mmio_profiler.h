@@ -0,0 +1,24 @@
+#pragma once
+#include "types.h"
+
+/// Optional instrumentation which counts accesses to hardware registers, by register, access size and guest PC, to
+/// find the registers games poll. It puts a hash table lookup on every register access, so it is only compiled in when
+/// WITH_MMIO_PROFILER is defined (ENABLE_MMIO_PROFILER in CMake).
+namespace MMIOProfiler {
+
+#ifdef WITH_MMIO_PROFILER
+
+/// Called by the bus for every I/O register access, pc is the instruction which made it.
+void RecordAccess(MemoryAccessType type, MemoryAccessSize size, PhysicalMemoryAddress address,
+                  VirtualMemoryAddress pc);
+
+void Reset();
+
+/// Writes every accessed register to a text file, most accessed first, followed by the PCs which accessed it.
+bool DumpToFile(const char* filename);
+
+void DrawDebugWindow();
+
+#endif
+
+} // namespace MMIOProfiler
@@ -285,6 +285,14 @@ void Pad::SetController(u32 slot, std::unique_ptr<Controller> dev)
   m_controllers[slot] = std::move(dev);
 }
 
+std::unique_ptr<Controller> Pad::RemoveController(u32 slot)
+{
+  std::unique_ptr<Controller> ret = std::move(m_controllers[slot]);
+  if (ret)
+    ret->Reset();
+  return ret;
+}
+
 void Pad::SetMemoryCard(u32 slot, std::unique_ptr<MemoryCard> dev)
 {
   m_memory_cards[slot] = std::move(dev);
@@ -503,6 +511,15 @@ void Pad::DoTransfer(TickCount ticks_late)
       }
       else
       {
+        // 0x01 selects the controller, refresh input so the state it returns is as recent as possible
+        if (controller && data_out == 0x01)
+        {
+          if (g_settings.controller_poll_input_on_read)
+            Host::PollInputForControllerRead();
+          if (g_settings.display_show_input_latency)
+            System::OnInputLatencyControllerRead();
+        }
+
         if (!controller || (ack = controller->Transfer(data_out, &data_in)) == false)
         {
           if (!memory_card || (ack = memory_card->Transfer(data_out, &data_in)) == false)
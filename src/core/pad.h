@@ -25,6 +25,7 @@ public:
 
   Controller* GetController(u32 slot) const { return m_controllers[slot].get(); }
   void SetController(u32 slot, std::unique_ptr<Controller> dev);
+  std::unique_ptr<Controller> RemoveController(u32 slot);
 
   MemoryCard* GetMemoryCard(u32 slot) { return m_memory_cards[slot].get(); }
   void SetMemoryCard(u32 slot, std::unique_ptr<MemoryCard> dev);
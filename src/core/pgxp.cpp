@@ -20,11 +20,13 @@
 
 #include "pgxp.h"
 #include "bus.h"
+#include "common/assert.h"
 #include "common/log.h"
 #include "cpu_core.h"
 #include "settings.h"
 #include <climits>
 #include <cmath>
+#include <cstddef>
 Log_SetChannel(PGXP);
 
 namespace PGXP {
@@ -35,7 +37,11 @@ enum : u32
   VERTEX_CACHE_HEIGHT = 0x800 * 2,
   VERTEX_CACHE_SIZE = VERTEX_CACHE_WIDTH * VERTEX_CACHE_HEIGHT,
   PGXP_MEM_SIZE = (Bus::RAM_8MB_SIZE + CPU::DCACHE_SIZE) / 4,
-  PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4
+  PGXP_MEM_SCRATCH_OFFSET = Bus::RAM_8MB_SIZE / 4,
+  PGXP_MEM_PAGE_SHIFT = 10, // 4KB of PSX memory per page
+  PGXP_MEM_PAGE_SIZE = 1u << PGXP_MEM_PAGE_SHIFT,
+  PGXP_MEM_PAGE_MASK = PGXP_MEM_PAGE_SIZE - 1,
+  PGXP_MEM_PAGE_COUNT = (PGXP_MEM_SIZE + PGXP_MEM_PAGE_SIZE - 1) / PGXP_MEM_PAGE_SIZE
 };
 
 #define NONE 0
@@ -96,13 +102,20 @@ static double f16Sign(double in);
 static double f16Unsign(double in);
 static double f16Overflow(double in);
 
+static bool GetMemIndex(u32 addr, u32* index);
 static PGXP_value* GetPtr(u32 addr);
+static PGXP_value* GetWritePtr(u32 addr);
+static PGXP_value* AllocateMemPage(u32 page);
 static PGXP_value* ReadMem(u32 addr);
 
 static const PGXP_value PGXP_value_invalid = {0.f, 0.f, 0.f, {0}, 0};
 static const PGXP_value PGXP_value_zero = {0.f, 0.f, 0.f, {VALID_ALL}, 0};
 
 static PGXP_value CPU_reg[34];
+static_assert(sizeof(PGXP_value) == CPU_REG_VALUE_SIZE);
+static_assert(offsetof(PGXP_value, flags) == CPU_REG_VALUE_FLAGS_OFFSET);
+static_assert(offsetof(PGXP_value, value) == CPU_REG_VALUE_VALUE_OFFSET);
+static_assert(VALID_01 == CPU_REG_VALUE_LUI_FLAGS && INV_VALID_ALL == CPU_REG_VALUE_INVALID_FLAGS_MASK);
 static PGXP_value CP0_reg[32];
 #define CPU_Hi CPU_reg[32]
 #define CPU_Lo CPU_reg[33]
@@ -111,7 +124,11 @@ static PGXP_value CP0_reg[32];
 static PGXP_value GTE_data_reg[32];
 static PGXP_value GTE_ctrl_reg[32];
 
-static PGXP_value* Mem = nullptr;
+// Shadow memory is allocated on the first write to each page, most of RAM never holds a GTE value.
+static PGXP_value* MemPages[PGXP_MEM_PAGE_COUNT] = {};
+
+// Reads of unwritten pages alias this. It's zero, so validating it never changes anything.
+static PGXP_value EmptyMemValue = {};
 static PGXP_value* vertexCache = nullptr;
 
 ALWAYS_INLINE_RELEASE void MakeValid(PGXP_value* pV, u32 psxV)
@@ -155,16 +172,58 @@ ALWAYS_INLINE_RELEASE double f16Overflow(double in)
   return out;
 }
 
-ALWAYS_INLINE_RELEASE PGXP_value* GetPtr(u32 addr)
+ALWAYS_INLINE_RELEASE bool GetMemIndex(u32 addr, u32* index)
 {
   if ((addr & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION)
-    return &Mem[PGXP_MEM_SCRATCH_OFFSET + ((addr & CPU::DCACHE_OFFSET_MASK) >> 2)];
+  {
+    *index = PGXP_MEM_SCRATCH_OFFSET + ((addr & CPU::DCACHE_OFFSET_MASK) >> 2);
+    return true;
+  }
 
   const u32 paddr = (addr & CPU::PHYSICAL_MEMORY_ADDRESS_MASK);
   if (paddr < Bus::RAM_MIRROR_END)
-    return &Mem[(paddr & Bus::g_ram_mask) >> 2];
-  else
+  {
+    *index = (paddr & Bus::g_ram_mask) >> 2;
+    return true;
+  }
+
+  return false;
+}
+
+ALWAYS_INLINE_RELEASE PGXP_value* GetPtr(u32 addr)
+{
+  u32 index;
+  if (!GetMemIndex(addr, &index))
+    return nullptr;
+
+  PGXP_value* page = MemPages[index >> PGXP_MEM_PAGE_SHIFT];
+  return page ? &page[index & PGXP_MEM_PAGE_MASK] : &EmptyMemValue;
+}
+
+ALWAYS_INLINE_RELEASE PGXP_value* GetWritePtr(u32 addr)
+{
+  u32 index;
+  if (!GetMemIndex(addr, &index))
     return nullptr;
+
+  PGXP_value* page = MemPages[index >> PGXP_MEM_PAGE_SHIFT];
+  if (!page)
+    page = AllocateMemPage(index >> PGXP_MEM_PAGE_SHIFT);
+
+  return &page[index & PGXP_MEM_PAGE_MASK];
+}
+
+PGXP_value* AllocateMemPage(u32 page)
+{
+  PGXP_value* ptr = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_PAGE_SIZE, sizeof(PGXP_value)));
+  if (!ptr)
+  {
+    std::fprintf(stderr, "Failed to allocate PGXP memory\n");
+    std::abort();
+  }
+
+  MemPages[page] = ptr;
+  return ptr;
 }
 
 ALWAYS_INLINE_RELEASE PGXP_value* ReadMem(u32 addr)
@@ -230,7 +289,7 @@ ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 add
 
 ALWAYS_INLINE_RELEASE void WriteMem(const PGXP_value* value, u32 addr)
 {
-  PGXP_value* pMem = GetPtr(addr);
+  PGXP_value* pMem = GetWritePtr(addr);
 
   if (pMem)
     *pMem = *value;
@@ -238,7 +297,7 @@ ALWAYS_INLINE_RELEASE void WriteMem(const PGXP_value* value, u32 addr)
 
 ALWAYS_INLINE_RELEASE static void WriteMem16(const PGXP_value* src, u32 addr)
 {
-  PGXP_value* dest = GetPtr(addr);
+  PGXP_value* dest = GetWritePtr(addr);
   psx_value* pVal = NULL;
 
   if (dest)
@@ -277,16 +336,6 @@ void Initialize()
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
-  if (!Mem)
-  {
-    Mem = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXP_value)));
-    if (!Mem)
-    {
-      std::fprintf(stderr, "Failed to allocate PGXP memory\n");
-      std::abort();
-    }
-  }
-
   if (g_settings.gpu_pgxp_vertex_cache && !vertexCache)
   {
     vertexCache = static_cast<PGXP_value*>(std::calloc(VERTEX_CACHE_SIZE, sizeof(PGXP_value)));
@@ -309,8 +358,11 @@ void Reset()
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
-  if (Mem)
-    std::memset(Mem, 0, sizeof(PGXP_value) * PGXP_MEM_SIZE);
+  for (PGXP_value* page : MemPages)
+  {
+    if (page)
+      std::memset(page, 0, sizeof(PGXP_value) * PGXP_MEM_PAGE_SIZE);
+  }
 
   if (vertexCache)
     std::memset(vertexCache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
@@ -323,10 +375,10 @@ void Shutdown()
     std::free(vertexCache);
     vertexCache = nullptr;
   }
-  if (Mem)
+  for (PGXP_value*& page : MemPages)
   {
-    std::free(Mem);
-    Mem = nullptr;
+    std::free(page);
+    page = nullptr;
   }
 
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
@@ -512,9 +564,9 @@ static ALWAYS_INLINE_RELEASE float TruncateVertexPosition(float p)
   return static_cast<float>(static_cast<s16>(int_part << 5) >> 5) + (p - int_part_f);
 }
 
-static ALWAYS_INLINE_RELEASE bool IsWithinTolerance(float precise_x, float precise_y, int int_x, int int_y)
+static ALWAYS_INLINE_RELEASE bool IsWithinTolerance(float precise_x, float precise_y, int int_x, int int_y,
+                                                    float tolerance)
 {
-  const float tolerance = g_settings.gpu_pgxp_tolerance;
   if (tolerance < 0.0f)
     return true;
 
@@ -522,9 +574,10 @@ static ALWAYS_INLINE_RELEASE bool IsWithinTolerance(float precise_x, float preci
           std::abs(precise_y - static_cast<float>(int_y)) <= tolerance);
 }
 
-bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, float* out_x, float* out_y, float* out_w)
+static ALWAYS_INLINE_RELEASE bool GetPreciseVertex(const PGXP_value* vert, u32 value, int x, int y, int xOffs,
+                                                   int yOffs, float tolerance, bool use_vertex_cache, float* out_x,
+                                                   float* out_y, float* out_w)
 {
-  const PGXP_value* vert = ReadMem(addr);
   if (vert && ((vert->flags & VALID_01) == VALID_01) && (vert->value == value))
   {
     // There is a value here with valid X and Y coordinates
@@ -532,14 +585,14 @@ bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, f
     *out_y = TruncateVertexPosition(vert->y) + static_cast<float>(yOffs);
     *out_w = vert->z / 32768.0f;
 
-    if (IsWithinTolerance(*out_x, *out_y, x, y))
+    if (IsWithinTolerance(*out_x, *out_y, x, y, tolerance))
     {
       // check validity of z component
       return ((vert->flags & VALID_2) == VALID_2);
     }
   }
 
-  if (g_settings.gpu_pgxp_vertex_cache)
+  if (use_vertex_cache)
   {
     const short psx_x = (short)(value & 0xFFFFu);
     const short psx_y = (short)(value >> 16);
@@ -552,7 +605,7 @@ bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, f
       *out_y = TruncateVertexPosition(vert->y) + static_cast<float>(yOffs);
       *out_w = vert->z / 32768.0f;
 
-      if (IsWithinTolerance(*out_x, *out_y, x, y))
+      if (IsWithinTolerance(*out_x, *out_y, x, y, tolerance))
         return false;
     }
   }
@@ -564,6 +617,28 @@ bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, f
   return false;
 }
 
+bool GetPreciseVertices(u32 count, const u32* addrs, const u32* values, const s32* xs, const s32* ys, int xOffs,
+                        int yOffs, float* out_xs, float* out_ys, float* out_ws)
+{
+  DebugAssert(count <= MAX_POLYGON_VERTICES);
+
+  // Look up all of the shadow values before using any of them, so the cache misses overlap.
+  const PGXP_value* verts[MAX_POLYGON_VERTICES];
+  for (u32 i = 0; i < count; i++)
+    verts[i] = ReadMem(addrs[i]);
+
+  const float tolerance = g_settings.gpu_pgxp_tolerance;
+  const bool use_vertex_cache = g_settings.gpu_pgxp_vertex_cache;
+  bool valid_w = true;
+  for (u32 i = 0; i < count; i++)
+  {
+    valid_w &= GetPreciseVertex(verts[i], values[i], xs[i], ys[i], xOffs, yOffs, tolerance, use_vertex_cache,
+                                &out_xs[i], &out_ys[i], &out_ws[i]);
+  }
+
+  return valid_w;
+}
+
 // Instruction register decoding
 #define op(_instr) (_instr >> 26) // The op part of the instruction register
 #define func(_instr) ((_instr)&0x3F) // The funct part of the instruction register
@@ -581,6 +656,11 @@ void CPU_LW(u32 instr, u32 rtVal, u32 addr)
   ValidateAndCopyMem(&CPU_reg[rt(instr)], addr, rtVal);
 }
 
+u8* GetCPURegisterValuePointer(u32 reg)
+{
+  return reinterpret_cast<u8*>(&CPU_reg[reg]);
+}
+
 void CPU_LBx(u32 instr, u32 rtVal, u32 addr)
 {
   CPU_reg[rt(instr)] = PGXP_value_invalid;
@@ -42,10 +42,28 @@ void CPU_CTC2(u32 instr, u32 rdVal, u32 rtVal); // copy GPR reg to GTE ctrl reg
 void CPU_LWC2(u32 instr, u32 rtVal, u32 addr); // copy memory to GTE reg
 void CPU_SWC2(u32 instr, u32 rtVal, u32 addr); // copy GTE reg to memory
 
-bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, float* out_x, float* out_y,
-                      float* out_w);
+enum : u32
+{
+  MAX_POLYGON_VERTICES = 4
+};
+
+/// Looks up the precise positions of a polygon's vertices, falling back to the native positions.
+/// Returns true if every vertex has a valid depth.
+bool GetPreciseVertices(u32 count, const u32* addrs, const u32* values, const s32* xs, const s32* ys, int xOffs,
+                        int yOffs, float* out_xs, float* out_ys, float* out_ws);
 
 // -- CPU functions
+// Layout of the tracked CPU register values, so the recompiler can update them without calling out.
+enum : u32
+{
+  CPU_REG_VALUE_SIZE = 20,
+  CPU_REG_VALUE_FLAGS_OFFSET = 12,
+  CPU_REG_VALUE_VALUE_OFFSET = 16,
+  CPU_REG_VALUE_LUI_FLAGS = 0x00000101,
+  CPU_REG_VALUE_INVALID_FLAGS_MASK = 0xFEFEFEFE
+};
+u8* GetCPURegisterValuePointer(u32 reg);
+
 void CPU_LW(u32 instr, u32 rtVal, u32 addr);
 void CPU_LHx(u32 instr, u32 rtVal, u32 addr);
 void CPU_LBx(u32 instr, u32 rtVal, u32 addr);
@@ -6,7 +6,9 @@
 #include "common/path.h"
 #include "system.h"
 #include "zlib.h"
+#include <algorithm>
 #include <cctype>
+#include <cstdlib>
 #include <cstring>
 Log_SetChannel(PSFLoader);
 
@@ -39,6 +41,36 @@ std::optional<float> File::GetTagFloat(const char* tag_name) const
   return static_cast<float>(std::atof(it->second.c_str()));
 }
 
+std::optional<float> File::GetTagSeconds(const char* tag_name) const
+{
+  auto it = m_tags.find(tag_name);
+  if (it == m_tags.end())
+    return std::nullopt;
+
+  // some taggers use a comma for the fraction
+  std::string value(it->second);
+  std::replace(value.begin(), value.end(), ',', '.');
+
+  float seconds = 0.0f;
+  const char* str = value.c_str();
+  for (;;)
+  {
+    char* end;
+    const float component = static_cast<float>(std::strtod(str, &end));
+    if (end == str)
+      return std::nullopt;
+
+    seconds += component;
+    if (*end != ':')
+      break;
+
+    seconds *= 60.0f;
+    str = end + 1;
+  }
+
+  return seconds;
+}
+
 std::string File::GetTagString(const char* tag_name, const char* default_value) const
 {
   std::optional<std::string> value(GetTagString(tag_name));
@@ -33,6 +33,9 @@ public:
   std::optional<int> GetTagInt(const char* tag_name) const;
   std::optional<float> GetTagFloat(const char* tag_name) const;
 
+  /// Parses a [[h:]m:]s[.fff] duration tag, such as "length" or "fade", in seconds.
+  std::optional<float> GetTagSeconds(const char* tag_name) const;
+
   std::string GetTagString(const char* tag_name, const char* default_value) const;
   int GetTagInt(const char* tag_name, int default_value) const;
   float GetTagFloat(const char* tag_name, float default_value) const;
@@ -11,6 +11,7 @@
 #include "host_display.h"
 #include "host_settings.h"
 #include "system.h"
+#include "util/cd_image.h"
 #include <algorithm>
 #include <array>
 #include <cctype>
@@ -161,6 +162,7 @@ void Settings::Load(SettingsInterface& si)
   turbo_speed = si.GetFloatValue("Main", "TurboSpeed", 0.0f);
   sync_to_host_refresh_rate = si.GetBoolValue("Main", "SyncToHostRefreshRate", false);
   increase_timer_resolution = si.GetBoolValue("Main", "IncreaseTimerResolution", true);
+  precise_throttle = si.GetBoolValue("Main", "PreciseThrottle", false);
   inhibit_screensaver = si.GetBoolValue("Main", "InhibitScreensaver", true);
   start_paused = si.GetBoolValue("Main", "StartPaused", false);
   start_fullscreen = si.GetBoolValue("Main", "StartFullscreen", false);
@@ -169,10 +171,17 @@ void Settings::Load(SettingsInterface& si)
   save_state_on_exit = si.GetBoolValue("Main", "SaveStateOnExit", true);
   create_save_state_backups = si.GetBoolValue("Main", "CreateSaveStateBackups", DEFAULT_SAVE_STATE_BACKUPS);
   compress_save_states = si.GetBoolValue("Main", "CompressSaveStates", DEFAULT_SAVE_STATE_COMPRESSION);
+  save_state_compression_level =
+    si.GetIntValue("Main", "SaveStateCompressionLevel", DEFAULT_SAVE_STATE_COMPRESSION_LEVEL);
+  archival_save_state_compression_level =
+    si.GetIntValue("Main", "ArchivalSaveStateCompressionLevel", DEFAULT_ARCHIVAL_SAVE_STATE_COMPRESSION_LEVEL);
+  save_state_compression_threads = static_cast<u32>(
+    si.GetIntValue("Main", "SaveStateCompressionThreads", static_cast<int>(DEFAULT_SAVE_STATE_COMPRESSION_THREADS)));
   confim_power_off = si.GetBoolValue("Main", "ConfirmPowerOff", true);
   load_devices_from_save_states = si.GetBoolValue("Main", "LoadDevicesFromSaveStates", false);
   apply_compatibility_settings = si.GetBoolValue("Main", "ApplyCompatibilitySettings", true);
   apply_game_settings = si.GetBoolValue("Main", "ApplyGameSettings", true);
+  auto_tune_performance = si.GetBoolValue("Main", "AutoTunePerformance", false);
   auto_load_cheats = si.GetBoolValue("Main", "AutoLoadCheats", true);
   disable_all_enhancements = si.GetBoolValue("Main", "DisableAllEnhancements", false);
   rewind_enable = si.GetBoolValue("Main", "RewindEnable", false);
@@ -191,9 +200,19 @@ void Settings::Load(SettingsInterface& si)
   cpu_recompiler_memory_exceptions = si.GetBoolValue("CPU", "RecompilerMemoryExceptions", false);
   cpu_recompiler_block_linking = si.GetBoolValue("CPU", "RecompilerBlockLinking", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_recompiler_block_profile = si.GetBoolValue("CPU", "RecompilerBlockProfile", false);
+  cpu_recompiler_async_compilation = si.GetBoolValue("CPU", "RecompilerAsyncCompilation", false);
+  cpu_recompiler_trace_formation = si.GetBoolValue("CPU", "RecompilerTraceFormation", false);
+  cpu_recompiler_hot_code_layout = si.GetBoolValue("CPU", "RecompilerHotCodeLayout", false);
+  cpu_skip_idle_loops = si.GetBoolValue("CPU", "SkipIdleLoops", false);
+  cpu_hle_bios_memory_routines = si.GetBoolValue("CPU", "HLEBIOSMemoryRoutines", false);
+  cpu_recompiler_perf_map = si.GetBoolValue("CPU", "RecompilerPerfMap", false);
+  cpu_recompiler_statistics = si.GetBoolValue("CPU", "RecompilerStatistics", false);
   cpu_fastmem_mode = ParseCPUFastmemMode(
                        si.GetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(DEFAULT_CPU_FASTMEM_MODE)).c_str())
                        .value_or(DEFAULT_CPU_FASTMEM_MODE);
+  cpu_huge_pages = si.GetBoolValue("CPU", "HugePages", false);
+  cpu_thread_pinning = si.GetBoolValue("CPU", "ThreadPinning", false);
 
   gpu_renderer = ParseRendererName(si.GetStringValue("GPU", "Renderer", GetRendererName(DEFAULT_GPU_RENDERER)).c_str())
                    .value_or(DEFAULT_GPU_RENDERER);
@@ -201,9 +220,18 @@ void Settings::Load(SettingsInterface& si)
   gpu_resolution_scale = static_cast<u32>(si.GetIntValue("GPU", "ResolutionScale", 1));
   gpu_multisamples = static_cast<u32>(si.GetIntValue("GPU", "Multisamples", 1));
   gpu_use_debug_device = si.GetBoolValue("GPU", "UseDebugDevice", false);
+  gpu_frames_in_flight = static_cast<u32>(std::clamp(si.GetIntValue("GPU", "FramesInFlight", 3), 2, 4));
   gpu_per_sample_shading = si.GetBoolValue("GPU", "PerSampleShading", false);
   gpu_use_thread = si.GetBoolValue("GPU", "UseThread", true);
+  gpu_sw_worker_threads = static_cast<u32>(std::clamp(si.GetIntValue("GPU", "SoftwareWorkerThreads", 0), 0, 16));
+  gpu_sw_tile_binning = si.GetBoolValue("GPU", "SoftwareTileBinning", false);
   gpu_use_software_renderer_for_readbacks = si.GetBoolValue("GPU", "UseSoftwareRendererForReadbacks", false);
+  gpu_sw_readback_region_tracking = si.GetBoolValue("GPU", "SoftwareReadbackRegionTracking", false);
+  gpu_decoded_texture_cache = si.GetBoolValue("GPU", "DecodedTextureCache", false);
+  gpu_texture_mode_batching = si.GetBoolValue("GPU", "TextureModeBatching", false);
+  gpu_dynamic_resolution = si.GetBoolValue("GPU", "DynamicResolution", false);
+  gpu_dynamic_resolution_min_scale =
+    static_cast<u32>(std::clamp(si.GetIntValue("GPU", "DynamicResolutionMinScale", 1), 1, 16));
   gpu_threaded_presentation = si.GetBoolValue("GPU", "ThreadedPresentation", true);
   gpu_true_color = si.GetBoolValue("GPU", "TrueColor", true);
   gpu_scaled_dithering = si.GetBoolValue("GPU", "ScaledDithering", true);
@@ -261,10 +289,17 @@ void Settings::Load(SettingsInterface& si)
   display_show_resolution = si.GetBoolValue("Display", "ShowResolution", false);
   display_show_cpu = si.GetBoolValue("Display", "ShowCPU", false);
   display_show_gpu = si.GetBoolValue("Display", "ShowGPU", false);
+  display_log_gpu_timings = si.GetBoolValue("Display", "LogGPUTimings", false);
+  display_latency_reduction = si.GetBoolValue("Display", "LatencyReduction", false);
+  display_auto_frame_skip = si.GetBoolValue("Display", "AutoFrameSkip", false);
   display_show_status_indicators = si.GetBoolValue("Display", "ShowStatusIndicators", true);
   display_show_inputs = si.GetBoolValue("Display", "ShowInputs", false);
+  display_show_input_latency = si.GetBoolValue("Display", "ShowInputLatency", false);
+  display_input_latency_flash = si.GetBoolValue("Display", "InputLatencyFlash", false);
   display_show_enhancements = si.GetBoolValue("Display", "ShowEnhancements", false);
   display_all_frames = si.GetBoolValue("Display", "DisplayAllFrames", false);
+  display_vrr_frame_pacing = si.GetBoolValue("Display", "VRRFramePacing", false);
+  display_skip_duplicate_frames = si.GetBoolValue("Display", "SkipDuplicateFrames", false);
   display_internal_resolution_screenshots = si.GetBoolValue("Display", "InternalResolutionScreenshots", false);
   video_sync_enabled = si.GetBoolValue("Display", "VSync", DEFAULT_VSYNC_VALUE);
   display_post_process_chain = si.GetStringValue("Display", "PostProcessChain", "");
@@ -279,6 +314,15 @@ void Settings::Load(SettingsInterface& si)
   cdrom_mute_cd_audio = si.GetBoolValue("CDROM", "MuteCDAudio", false);
   cdrom_read_speedup = si.GetIntValue("CDROM", "ReadSpeedup", 1);
   cdrom_seek_speedup = si.GetIntValue("CDROM", "SeekSpeedup", 1);
+  cdrom_chd_hunk_cache_size = static_cast<u32>(
+    std::clamp(si.GetIntValue("CDROM", "CHDHunkCacheSize", DEFAULT_CDROM_CHD_HUNK_CACHE_SIZE), 1, 256));
+  cdrom_chd_prefetch = si.GetBoolValue("CDROM", "CHDPrefetch", false);
+  cdrom_precache_compressed = si.GetBoolValue("CDROM", "PrecacheCompressed", false);
+  cdrom_preload_next_disc = si.GetBoolValue("CDROM", "PreloadNextDisc", false);
+  cdrom_preload_next_disc_budget_mb = static_cast<u32>(std::clamp(
+    si.GetIntValue("CDROM", "PreloadNextDiscBudgetMB", DEFAULT_CDROM_PRELOAD_NEXT_DISC_BUDGET_MB), 0, 4096));
+
+  mdec_decode_on_thread = si.GetBoolValue("MDEC", "DecodeOnThread", false);
 
   audio_backend =
     ParseAudioBackend(si.GetStringValue("Audio", "Backend", GetAudioBackendName(DEFAULT_AUDIO_BACKEND)).c_str())
@@ -295,6 +339,8 @@ void Settings::Load(SettingsInterface& si)
 
   audio_output_muted = si.GetBoolValue("Audio", "OutputMuted", false);
   audio_dump_on_boot = si.GetBoolValue("Audio", "DumpOnBoot", false);
+  audio_mix_on_thread = si.GetBoolValue("Audio", "MixOnThread", false);
+  audio_fast_forward_decimation = si.GetBoolValue("Audio", "FastForwardDecimation", false);
 
   dma_max_slice_ticks = si.GetIntValue("Hacks", "DMAMaxSliceTicks", DEFAULT_DMA_MAX_SLICE_TICKS);
   dma_halt_ticks = si.GetIntValue("Hacks", "DMAHaltTicks", DEFAULT_DMA_HALT_TICKS);
@@ -303,11 +349,15 @@ void Settings::Load(SettingsInterface& si)
 
   bios_patch_tty_enable = si.GetBoolValue("BIOS", "PatchTTYEnable", false);
   bios_patch_fast_boot = si.GetBoolValue("BIOS", "PatchFastBoot", DEFAULT_FAST_BOOT_VALUE);
+  bios_boot_snapshot = si.GetBoolValue("BIOS", "BootSnapshot", false);
 
   multitap_mode =
     ParseMultitapModeName(
       si.GetStringValue("ControllerPorts", "MultitapMode", GetMultitapModeName(DEFAULT_MULTITAP_MODE)).c_str())
       .value_or(DEFAULT_MULTITAP_MODE);
+  controller_poll_input_on_read = si.GetBoolValue("ControllerPorts", "PollInputOnRead", false);
+  controller_poll_input_interval_us = static_cast<u32>(
+    si.GetIntValue("ControllerPorts", "PollInputIntervalUS", DEFAULT_CONTROLLER_POLL_INPUT_INTERVAL_US));
 
   controller_types[0] = ParseControllerTypeName(si.GetStringValue(Controller::GetSettingsSection(0).c_str(), "Type",
                                                                   GetControllerTypeName(DEFAULT_CONTROLLER_1_TYPE))
@@ -375,10 +425,14 @@ void Settings::Load(SettingsInterface& si)
   debugging.show_timers_state = si.GetBoolValue("Debug", "ShowTimersState");
   debugging.show_mdec_state = si.GetBoolValue("Debug", "ShowMDECState");
   debugging.show_dma_state = si.GetBoolValue("Debug", "ShowDMAState");
+  debugging.show_mmio_access_counters = si.GetBoolValue("Debug", "ShowMMIOAccessCounters");
 
   texture_replacements.enable_vram_write_replacements =
     si.GetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements", false);
   texture_replacements.preload_textures = si.GetBoolValue("TextureReplacements", "PreloadTextures", false);
+  texture_replacements.async_loading = si.GetBoolValue("TextureReplacements", "AsyncLoading", false);
+  texture_replacements.max_cache_size_mb =
+    static_cast<u32>(std::max(si.GetIntValue("TextureReplacements", "MaxCacheSize", 0), 0));
   texture_replacements.dump_vram_writes = si.GetBoolValue("TextureReplacements", "DumpVRAMWrites", false);
   texture_replacements.dump_vram_write_force_alpha_channel =
     si.GetBoolValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel", true);
@@ -398,6 +452,7 @@ void Settings::Save(SettingsInterface& si) const
   si.SetFloatValue("Main", "TurboSpeed", turbo_speed);
   si.SetBoolValue("Main", "SyncToHostRefreshRate", sync_to_host_refresh_rate);
   si.SetBoolValue("Main", "IncreaseTimerResolution", increase_timer_resolution);
+  si.SetBoolValue("Main", "PreciseThrottle", precise_throttle);
   si.SetBoolValue("Main", "InhibitScreensaver", inhibit_screensaver);
   si.SetBoolValue("Main", "StartPaused", start_paused);
   si.SetBoolValue("Main", "StartFullscreen", start_fullscreen);
@@ -406,10 +461,14 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Main", "SaveStateOnExit", save_state_on_exit);
   si.SetBoolValue("Main", "CreateSaveStateBackups", create_save_state_backups);
   si.SetBoolValue("Main", "CompressSaveStates", compress_save_states);
+  si.SetIntValue("Main", "SaveStateCompressionLevel", save_state_compression_level);
+  si.SetIntValue("Main", "ArchivalSaveStateCompressionLevel", archival_save_state_compression_level);
+  si.SetIntValue("Main", "SaveStateCompressionThreads", static_cast<int>(save_state_compression_threads));
   si.SetBoolValue("Main", "ConfirmPowerOff", confim_power_off);
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", load_devices_from_save_states);
   si.SetBoolValue("Main", "ApplyCompatibilitySettings", apply_compatibility_settings);
   si.SetBoolValue("Main", "ApplyGameSettings", apply_game_settings);
+  si.SetBoolValue("Main", "AutoTunePerformance", auto_tune_performance);
   si.SetBoolValue("Main", "AutoLoadCheats", auto_load_cheats);
   si.SetBoolValue("Main", "DisableAllEnhancements", disable_all_enhancements);
   si.SetBoolValue("Main", "RewindEnable", rewind_enable);
@@ -424,17 +483,35 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("CPU", "RecompilerMemoryExceptions", cpu_recompiler_memory_exceptions);
   si.SetBoolValue("CPU", "RecompilerBlockLinking", cpu_recompiler_block_linking);
   si.SetBoolValue("CPU", "RecompilerICache", cpu_recompiler_icache);
+  si.SetBoolValue("CPU", "RecompilerBlockProfile", cpu_recompiler_block_profile);
+  si.SetBoolValue("CPU", "RecompilerAsyncCompilation", cpu_recompiler_async_compilation);
+  si.SetBoolValue("CPU", "RecompilerTraceFormation", cpu_recompiler_trace_formation);
+  si.SetBoolValue("CPU", "RecompilerHotCodeLayout", cpu_recompiler_hot_code_layout);
+  si.SetBoolValue("CPU", "SkipIdleLoops", cpu_skip_idle_loops);
+  si.SetBoolValue("CPU", "HLEBIOSMemoryRoutines", cpu_hle_bios_memory_routines);
+  si.SetBoolValue("CPU", "RecompilerPerfMap", cpu_recompiler_perf_map);
+  si.SetBoolValue("CPU", "RecompilerStatistics", cpu_recompiler_statistics);
   si.SetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(cpu_fastmem_mode));
+  si.SetBoolValue("CPU", "HugePages", cpu_huge_pages);
+  si.SetBoolValue("CPU", "ThreadPinning", cpu_thread_pinning);
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
   si.SetStringValue("GPU", "Adapter", gpu_adapter.c_str());
   si.SetIntValue("GPU", "ResolutionScale", static_cast<long>(gpu_resolution_scale));
   si.SetIntValue("GPU", "Multisamples", static_cast<long>(gpu_multisamples));
   si.SetBoolValue("GPU", "UseDebugDevice", gpu_use_debug_device);
+  si.SetIntValue("GPU", "FramesInFlight", gpu_frames_in_flight);
   si.SetBoolValue("GPU", "PerSampleShading", gpu_per_sample_shading);
   si.SetBoolValue("GPU", "UseThread", gpu_use_thread);
+  si.SetIntValue("GPU", "SoftwareWorkerThreads", gpu_sw_worker_threads);
+  si.SetBoolValue("GPU", "SoftwareTileBinning", gpu_sw_tile_binning);
   si.SetBoolValue("GPU", "ThreadedPresentation", gpu_threaded_presentation);
   si.SetBoolValue("GPU", "UseSoftwareRendererForReadbacks", gpu_use_software_renderer_for_readbacks);
+  si.SetBoolValue("GPU", "SoftwareReadbackRegionTracking", gpu_sw_readback_region_tracking);
+  si.SetBoolValue("GPU", "DecodedTextureCache", gpu_decoded_texture_cache);
+  si.SetBoolValue("GPU", "TextureModeBatching", gpu_texture_mode_batching);
+  si.SetBoolValue("GPU", "DynamicResolution", gpu_dynamic_resolution);
+  si.SetIntValue("GPU", "DynamicResolutionMinScale", gpu_dynamic_resolution_min_scale);
   si.SetBoolValue("GPU", "TrueColor", gpu_true_color);
   si.SetBoolValue("GPU", "ScaledDithering", gpu_scaled_dithering);
   si.SetStringValue("GPU", "TextureFilter", GetTextureFilterName(gpu_texture_filter));
@@ -474,10 +551,17 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Display", "ShowResolution", display_show_resolution);
   si.SetBoolValue("Display", "ShowCPU", display_show_cpu);
   si.SetBoolValue("Display", "ShowGPU", display_show_gpu);
+  si.SetBoolValue("Display", "LogGPUTimings", display_log_gpu_timings);
+  si.SetBoolValue("Display", "LatencyReduction", display_latency_reduction);
+  si.SetBoolValue("Display", "AutoFrameSkip", display_auto_frame_skip);
   si.SetBoolValue("Display", "ShowStatusIndicators", display_show_status_indicators);
   si.SetBoolValue("Display", "ShowInputs", display_show_inputs);
+  si.SetBoolValue("Display", "ShowInputLatency", display_show_input_latency);
+  si.SetBoolValue("Display", "InputLatencyFlash", display_input_latency_flash);
   si.SetBoolValue("Display", "ShowEnhancements", display_show_enhancements);
   si.SetBoolValue("Display", "DisplayAllFrames", display_all_frames);
+  si.SetBoolValue("Display", "VRRFramePacing", display_vrr_frame_pacing);
+  si.SetBoolValue("Display", "SkipDuplicateFrames", display_skip_duplicate_frames);
   si.SetBoolValue("Display", "InternalResolutionScreenshots", display_internal_resolution_screenshots);
   si.SetBoolValue("Display", "VSync", video_sync_enabled);
   if (display_post_process_chain.empty())
@@ -494,6 +578,13 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("CDROM", "MuteCDAudio", cdrom_mute_cd_audio);
   si.SetIntValue("CDROM", "ReadSpeedup", cdrom_read_speedup);
   si.SetIntValue("CDROM", "SeekSpeedup", cdrom_seek_speedup);
+  si.SetIntValue("CDROM", "CHDHunkCacheSize", cdrom_chd_hunk_cache_size);
+  si.SetBoolValue("CDROM", "CHDPrefetch", cdrom_chd_prefetch);
+  si.SetBoolValue("CDROM", "PrecacheCompressed", cdrom_precache_compressed);
+  si.SetBoolValue("CDROM", "PreloadNextDisc", cdrom_preload_next_disc);
+  si.SetIntValue("CDROM", "PreloadNextDiscBudgetMB", cdrom_preload_next_disc_budget_mb);
+
+  si.SetBoolValue("MDEC", "DecodeOnThread", mdec_decode_on_thread);
 
   si.SetStringValue("Audio", "Backend", GetAudioBackendName(audio_backend));
   si.SetStringValue("Audio", "Driver", audio_driver.c_str());
@@ -504,6 +595,8 @@ void Settings::Save(SettingsInterface& si) const
   si.SetUIntValue("Audio", "FastForwardVolume", audio_fast_forward_volume);
   si.SetBoolValue("Audio", "OutputMuted", audio_output_muted);
   si.SetBoolValue("Audio", "DumpOnBoot", audio_dump_on_boot);
+  si.SetBoolValue("Audio", "MixOnThread", audio_mix_on_thread);
+  si.SetBoolValue("Audio", "FastForwardDecimation", audio_fast_forward_decimation);
 
   si.SetIntValue("Hacks", "DMAMaxSliceTicks", dma_max_slice_ticks);
   si.SetIntValue("Hacks", "DMAHaltTicks", dma_halt_ticks);
@@ -512,6 +605,7 @@ void Settings::Save(SettingsInterface& si) const
 
   si.SetBoolValue("BIOS", "PatchTTYEnable", bios_patch_tty_enable);
   si.SetBoolValue("BIOS", "PatchFastBoot", bios_patch_fast_boot);
+  si.SetBoolValue("BIOS", "BootSnapshot", bios_boot_snapshot);
 
   for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
     si.SetStringValue(Controller::GetSettingsSection(i).c_str(), "Type", GetControllerTypeName(controller_types[i]));
@@ -531,6 +625,8 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("MemoryCards", "UsePlaylistTitle", memory_card_use_playlist_title);
 
   si.SetStringValue("ControllerPorts", "MultitapMode", GetMultitapModeName(multitap_mode));
+  si.SetBoolValue("ControllerPorts", "PollInputOnRead", controller_poll_input_on_read);
+  si.SetIntValue("ControllerPorts", "PollInputIntervalUS", controller_poll_input_interval_us);
 
 #ifdef WITH_CHEEVOS
   si.SetBoolValue("Cheevos", "Enabled", achievements_enabled);
@@ -561,10 +657,13 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Debug", "ShowTimersState", debugging.show_timers_state);
   si.SetBoolValue("Debug", "ShowMDECState", debugging.show_mdec_state);
   si.SetBoolValue("Debug", "ShowDMAState", debugging.show_dma_state);
+  si.SetBoolValue("Debug", "ShowMMIOAccessCounters", debugging.show_mmio_access_counters);
 
   si.SetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements",
                   texture_replacements.enable_vram_write_replacements);
   si.SetBoolValue("TextureReplacements", "PreloadTextures", texture_replacements.preload_textures);
+  si.SetBoolValue("TextureReplacements", "AsyncLoading", texture_replacements.async_loading);
+  si.SetIntValue("TextureReplacements", "MaxCacheSize", texture_replacements.max_cache_size_mb);
   si.SetBoolValue("TextureReplacements", "DumpVRAMWrites", texture_replacements.dump_vram_writes);
   si.SetBoolValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel",
                   texture_replacements.dump_vram_write_force_alpha_channel);
@@ -598,6 +697,7 @@ void Settings::FixIncompatibleSettings(bool display_osd_messages)
     g_settings.cdrom_mute_cd_audio = false;
     g_settings.texture_replacements.enable_vram_write_replacements = false;
     g_settings.bios_patch_fast_boot = false;
+    g_settings.bios_boot_snapshot = false;
     g_settings.bios_patch_tty_enable = false;
   }
 
@@ -684,6 +784,7 @@ void Settings::FixIncompatibleSettings(bool display_osd_messages)
     g_settings.debugging.show_timers_state = false;
     g_settings.debugging.show_mdec_state = false;
     g_settings.debugging.show_dma_state = false;
+    g_settings.debugging.show_mmio_access_counters = false;
     g_settings.debugging.dump_cpu_to_vram_copies = false;
     g_settings.debugging.dump_vram_to_cpu_copies = false;
   }
@@ -1378,5 +1479,8 @@ bool EmuFolders::EnsureFoldersExist()
   result = FileSystem::EnsureDirectoryExists(Screenshots.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Shaders.c_str(), false) && result;
   result = FileSystem::EnsureDirectoryExists(Textures.c_str(), false) && result;
+
+  // created on demand
+  CDImage::SetHTTPCacheDirectory(Path::Combine(Cache, "http"));
   return result;
 }
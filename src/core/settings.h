@@ -61,13 +61,24 @@ struct Settings
   bool cpu_recompiler_memory_exceptions = false;
   bool cpu_recompiler_block_linking = true;
   bool cpu_recompiler_icache = false;
+  bool cpu_recompiler_block_profile = false;
+  bool cpu_recompiler_async_compilation = false;
+  bool cpu_recompiler_trace_formation = false;
+  bool cpu_recompiler_hot_code_layout = false;
+  bool cpu_skip_idle_loops = false;
+  bool cpu_hle_bios_memory_routines = false;
+  bool cpu_recompiler_perf_map = false;
+  bool cpu_recompiler_statistics = false;
   CPUFastmemMode cpu_fastmem_mode = DEFAULT_CPU_FASTMEM_MODE;
+  bool cpu_huge_pages = false;
+  bool cpu_thread_pinning = false;
 
   float emulation_speed = 1.0f;
   float fast_forward_speed = 0.0f;
   float turbo_speed = 0.0f;
   bool sync_to_host_refresh_rate = false;
   bool increase_timer_resolution = true;
+  bool precise_throttle = false;
   bool inhibit_screensaver = true;
   bool start_paused = false;
   bool start_fullscreen = false;
@@ -76,10 +87,14 @@ struct Settings
   bool save_state_on_exit = true;
   bool create_save_state_backups = DEFAULT_SAVE_STATE_BACKUPS;
   bool compress_save_states = DEFAULT_SAVE_STATE_COMPRESSION;
+  s32 save_state_compression_level = DEFAULT_SAVE_STATE_COMPRESSION_LEVEL;
+  s32 archival_save_state_compression_level = DEFAULT_ARCHIVAL_SAVE_STATE_COMPRESSION_LEVEL;
+  u32 save_state_compression_threads = DEFAULT_SAVE_STATE_COMPRESSION_THREADS;
   bool confim_power_off = true;
   bool load_devices_from_save_states = false;
   bool apply_compatibility_settings = true;
   bool apply_game_settings = true;
+  bool auto_tune_performance = false;
   bool auto_load_cheats = true;
   bool disable_all_enhancements = false;
 
@@ -94,9 +109,17 @@ struct Settings
   u32 gpu_resolution_scale = 1;
   u32 gpu_multisamples = 1;
   bool gpu_use_thread = true;
+  u32 gpu_sw_worker_threads = 0;
+  bool gpu_sw_tile_binning = false;
   bool gpu_use_software_renderer_for_readbacks = false;
+  bool gpu_sw_readback_region_tracking = false;
+  bool gpu_decoded_texture_cache = false;
+  bool gpu_texture_mode_batching = false;
+  bool gpu_dynamic_resolution = false;
+  u32 gpu_dynamic_resolution_min_scale = 1;
   bool gpu_threaded_presentation = true;
   bool gpu_use_debug_device = false;
+  u32 gpu_frames_in_flight = 3;
   bool gpu_per_sample_shading = false;
   bool gpu_true_color = true;
   bool gpu_scaled_dithering = true;
@@ -134,10 +157,17 @@ struct Settings
   bool display_show_resolution = false;
   bool display_show_cpu = false;
   bool display_show_gpu = false;
+  bool display_log_gpu_timings = false;
+  bool display_latency_reduction = false;
+  bool display_auto_frame_skip = false;
   bool display_show_status_indicators = true;
   bool display_show_inputs = false;
+  bool display_show_input_latency = false;
+  bool display_input_latency_flash = false;
   bool display_show_enhancements = false;
   bool display_all_frames = false;
+  bool display_vrr_frame_pacing = false;
+  bool display_skip_duplicate_frames = false;
   bool display_internal_resolution_screenshots = false;
   bool video_sync_enabled = DEFAULT_VSYNC_VALUE;
   float display_osd_scale = 100.0f;
@@ -152,6 +182,13 @@ struct Settings
   bool cdrom_mute_cd_audio = false;
   u32 cdrom_read_speedup = 1;
   u32 cdrom_seek_speedup = 1;
+  u32 cdrom_chd_hunk_cache_size = DEFAULT_CDROM_CHD_HUNK_CACHE_SIZE;
+  bool cdrom_chd_prefetch = false;
+  bool cdrom_precache_compressed = false;
+  bool cdrom_preload_next_disc = false;
+  u32 cdrom_preload_next_disc_budget_mb = DEFAULT_CDROM_PRELOAD_NEXT_DISC_BUDGET_MB;
+
+  bool mdec_decode_on_thread = false;
 
   AudioBackend audio_backend = DEFAULT_AUDIO_BACKEND;
   AudioStretchMode audio_stretch_mode = DEFAULT_AUDIO_STRETCH_MODE;
@@ -162,6 +199,8 @@ struct Settings
   u32 audio_fast_forward_volume = 100;
   bool audio_output_muted = false;
   bool audio_dump_on_boot = false;
+  bool audio_mix_on_thread = false;
+  bool audio_fast_forward_decimation = false;
 
   // timing hacks section
   TickCount dma_max_slice_ticks = DEFAULT_DMA_MAX_SLICE_TICKS;
@@ -199,6 +238,7 @@ struct Settings
     mutable bool show_timers_state = false;
     mutable bool show_mdec_state = false;
     mutable bool show_dma_state = false;
+    mutable bool show_mmio_access_counters = false;
   } debugging;
 
   // texture replacements
@@ -206,6 +246,8 @@ struct Settings
   {
     bool enable_vram_write_replacements = false;
     bool preload_textures = false;
+    bool async_loading = false;
+    u32 max_cache_size_mb = 0; // 0 for unlimited
 
     bool dump_vram_writes = false;
     bool dump_vram_write_force_alpha_channel = true;
@@ -224,10 +266,13 @@ struct Settings
 
   bool bios_patch_tty_enable = false;
   bool bios_patch_fast_boot = DEFAULT_FAST_BOOT_VALUE;
+  bool bios_boot_snapshot = false;
   bool enable_8mb_ram = false;
 
   std::array<ControllerType, NUM_CONTROLLER_AND_CARD_PORTS> controller_types{};
   bool controller_disable_analog_mode_forcing = false;
+  bool controller_poll_input_on_read = false;
+  u32 controller_poll_input_interval_us = DEFAULT_CONTROLLER_POLL_INPUT_INTERVAL_US;
 
   std::array<MemoryCardType, NUM_CONTROLLER_AND_CARD_PORTS> memory_card_types{};
   std::array<std::string, NUM_CONTROLLER_AND_CARD_PORTS> memory_card_paths{};
@@ -450,12 +495,15 @@ struct Settings
   static constexpr float DEFAULT_OSD_SCALE = 100.0f;
 
   static constexpr u8 DEFAULT_CDROM_READAHEAD_SECTORS = 8;
+  static constexpr u32 DEFAULT_CDROM_CHD_HUNK_CACHE_SIZE = 16;
+  static constexpr u32 DEFAULT_CDROM_PRELOAD_NEXT_DISC_BUDGET_MB = 1024;
 
   static constexpr ControllerType DEFAULT_CONTROLLER_1_TYPE = ControllerType::AnalogController;
   static constexpr ControllerType DEFAULT_CONTROLLER_2_TYPE = ControllerType::None;
   static constexpr MemoryCardType DEFAULT_MEMORY_CARD_1_TYPE = MemoryCardType::PerGameTitle;
   static constexpr MemoryCardType DEFAULT_MEMORY_CARD_2_TYPE = MemoryCardType::None;
   static constexpr MultitapMode DEFAULT_MULTITAP_MODE = MultitapMode::Disabled;
+  static constexpr u32 DEFAULT_CONTROLLER_POLL_INPUT_INTERVAL_US = 1000;
 
   static constexpr LOGLEVEL DEFAULT_LOG_LEVEL = LOGLEVEL_INFO;
 
@@ -468,6 +516,11 @@ struct Settings
 #endif
   static constexpr AudioStretchMode DEFAULT_AUDIO_STRETCH_MODE = AudioStretchMode::TimeStretch;
 
+  // Slot saves favour latency, resume states are kept around for longer and favour size.
+  static constexpr s32 DEFAULT_SAVE_STATE_COMPRESSION_LEVEL = 1;
+  static constexpr s32 DEFAULT_ARCHIVAL_SAVE_STATE_COMPRESSION_LEVEL = 12;
+  static constexpr u32 DEFAULT_SAVE_STATE_COMPRESSION_THREADS = 2;
+
   // Enable console logging by default on Linux platforms.
 #if defined(__linux__) && !defined(__ANDROID__)
   static constexpr bool DEFAULT_LOG_TO_CONSOLE = true;
@@ -10,9 +10,11 @@
 
 Log_SetChannel(ShaderGen);
 
-ShaderGen::ShaderGen(RenderAPI render_api, bool supports_dual_source_blend)
+ShaderGen::ShaderGen(RenderAPI render_api, bool supports_dual_source_blend,
+                     bool supports_framebuffer_fetch /* = false */)
   : m_render_api(render_api), m_glsl(render_api != RenderAPI::D3D11 && render_api != RenderAPI::D3D12),
-    m_supports_dual_source_blend(supports_dual_source_blend), m_use_glsl_interface_blocks(false)
+    m_supports_dual_source_blend(supports_dual_source_blend), m_supports_framebuffer_fetch(supports_framebuffer_fetch),
+    m_use_glsl_interface_blocks(false)
 {
 #if defined(WITH_OPENGL) || defined(WITH_VULKAN)
   if (m_glsl)
@@ -57,6 +59,15 @@ void ShaderGen::DefineMacro(std::stringstream& ss, const char* name, bool enable
   ss << "#define " << name << " " << BoolToUInt32(enabled) << "\n";
 }
 
+void ShaderGen::DeclareSpecializationConstant(std::stringstream& ss, const char* name, u32 constant_id, bool value)
+{
+  const char* value_str = value ? "true" : "false";
+  if (IsVulkan())
+    ss << "layout(constant_id = " << constant_id << ") const bool " << name << " = " << value_str << ";\n";
+  else
+    ss << "CONSTANT bool " << name << " = " << value_str << ";\n";
+}
+
 #ifdef WITH_OPENGL
 void ShaderGen::SetGLSLVersionString()
 {
@@ -147,6 +158,9 @@ void ShaderGen::WriteHeader(std::stringstream& ss)
     if (!GLAD_GL_VERSION_4_3 && !GLAD_GL_ES_VERSION_3_1 && GLAD_GL_ARB_shader_storage_buffer_object)
       ss << "#extension GL_ARB_shader_storage_buffer_object : require\n";
   }
+
+  if (m_supports_framebuffer_fetch)
+    ss << "#extension GL_EXT_shader_framebuffer_fetch : require\n";
 #endif
 
   DefineMacro(ss, "API_OPENGL", m_render_api == RenderAPI::OpenGL);
@@ -464,7 +478,7 @@ void ShaderGen::DeclareFragmentEntryPoint(
   const std::initializer_list<std::pair<const char*, const char*>>& additional_inputs,
   bool declare_fragcoord /* = false */, u32 num_color_outputs /* = 1 */, bool depth_output /* = false */,
   bool msaa /* = false */, bool ssaa /* = false */, bool declare_sample_id /* = false */,
-  bool noperspective_color /* = false */)
+  bool noperspective_color /* = false */, bool framebuffer_fetch /* = false */)
 {
   if (m_glsl)
   {
@@ -515,9 +529,11 @@ void ShaderGen::DeclareFragmentEntryPoint(
     if (depth_output)
       ss << "#define o_depth gl_FragDepth\n";
 
+    // Framebuffer fetch reads the current framebuffer value through the output.
+    const char* output_qualifier = framebuffer_fetch ? "inout" : "out";
     if (m_use_glsl_binding_layout)
     {
-      if (m_supports_dual_source_blend)
+      if (m_supports_dual_source_blend && !framebuffer_fetch)
       {
         for (u32 i = 0; i < num_color_outputs; i++)
           ss << "layout(location = 0, index = " << i << ") out float4 o_col" << i << ";\n";
@@ -526,13 +542,13 @@ void ShaderGen::DeclareFragmentEntryPoint(
       {
         Assert(num_color_outputs <= 1);
         for (u32 i = 0; i < num_color_outputs; i++)
-          ss << "layout(location = " << i << ") out float4 o_col" << i << ";\n";
+          ss << "layout(location = " << i << ") " << output_qualifier << " float4 o_col" << i << ";\n";
       }
     }
     else
     {
       for (u32 i = 0; i < num_color_outputs; i++)
-        ss << "out float4 o_col" << i << ";\n";
+        ss << output_qualifier << " float4 o_col" << i << ";\n";
     }
 
     ss << "\n";
@@ -7,7 +7,7 @@
 class ShaderGen
 {
 public:
-  ShaderGen(RenderAPI render_api, bool supports_dual_source_blend);
+  ShaderGen(RenderAPI render_api, bool supports_dual_source_blend, bool supports_framebuffer_fetch = false);
   ~ShaderGen();
 
   static bool UseGLSLBindingLayout();
@@ -29,6 +29,10 @@ protected:
 #endif
 
   void DefineMacro(std::stringstream& ss, const char* name, bool enabled);
+
+  /// Declares a boolean which can be tested with if() rather than #if. On Vulkan it is a specialization constant, so
+  /// the value can be changed at pipeline creation time without recompiling the module.
+  void DeclareSpecializationConstant(std::stringstream& ss, const char* name, u32 constant_id, bool value);
   void WriteHeader(std::stringstream& ss);
   void WriteUniformBufferDeclaration(std::stringstream& ss, bool push_constant_on_vulkan);
   void DeclareUniformBuffer(std::stringstream& ss, const std::initializer_list<const char*>& members,
@@ -44,11 +48,12 @@ protected:
                                  const std::initializer_list<std::pair<const char*, const char*>>& additional_inputs,
                                  bool declare_fragcoord = false, u32 num_color_outputs = 1, bool depth_output = false,
                                  bool msaa = false, bool ssaa = false, bool declare_sample_id = false,
-                                 bool noperspective_color = false);
+                                 bool noperspective_color = false, bool framebuffer_fetch = false);
 
   RenderAPI m_render_api;
   bool m_glsl;
   bool m_supports_dual_source_blend;
+  bool m_supports_framebuffer_fetch;
   bool m_use_glsl_interface_blocks;
   bool m_use_glsl_binding_layout;
 
@@ -2,6 +2,7 @@
 #include "cdrom.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/threading.h"
 #include "dma.h"
 #include "host.h"
 #include "imgui.h"
@@ -10,6 +11,14 @@
 #include "util/audio_stream.h"
 #include "util/state_wrapper.h"
 #include "util/wav_writer.h"
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#endif
+
 Log_SetChannel(SPU);
 
 // Enable to dump all voices of the SPU audio individually.
@@ -35,11 +44,18 @@ enum : u32
   VOICE_ADDRESS_SHIFT = 3,
   NUM_SAMPLES_PER_ADPCM_BLOCK = 28,
   NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK = 3,
+  NUM_INTERPOLATION_TAPS = 4,
   SYSCLK_TICKS_PER_SPU_TICK = System::MASTER_CLOCK / SAMPLE_RATE, // 0x300
   CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400,
+  NUM_CAPTURE_BUFFERS = 4,
+  CAPTURE_BUFFER_AREA_SIZE = CAPTURE_BUFFER_SIZE_PER_CHANNEL * NUM_CAPTURE_BUFFERS,
+  CAPTURE_BATCH_FRAMES = 32,
+  ADPCM_BLOCK_CACHE_SIZE = 256,
+  INVALID_ADPCM_BLOCK_CACHE_ADDRESS = 0xFFFFFFFFu,
   MINIMUM_TICKS_BETWEEN_KEY_ON_OFF = 2,
   NUM_REVERB_REGS = 32,
-  FIFO_SIZE_IN_HALFWORDS = 32
+  FIFO_SIZE_IN_HALFWORDS = 32,
+  LATE_OUTPUT_TOLERANCE_FRAMES = 64
 };
 enum : s16
 {
@@ -250,7 +266,6 @@ struct Voice
   void ForceOff();
 
   void DecodeBlock(const ADPCMBlock& block);
-  s32 Interpolate() const;
 
   // Switches to the specified phase, filling in target.
   void UpdateADSREnvelope();
@@ -296,6 +311,26 @@ struct ReverbRegisters
   };
 };
 
+// Block samples expanded from nibbles and shifted, but before the prediction filter is applied. The filter depends on
+// the previous samples of the voice playing the block, so only this part can be shared between voices.
+struct ADPCMBlockCacheEntry
+{
+  u32 address; // in 8-byte units
+  u8 shift_filter;
+  std::array<s16, NUM_SAMPLES_PER_ADPCM_BLOCK> samples;
+};
+
+// Interpolation inputs and results for the current frame in structure-of-arrays form, so that the Gaussian filter and
+// ADSR volume can be applied to several voices at once.
+struct VoiceMixBuffer
+{
+  alignas(16) std::array<std::array<s16, NUM_VOICES>, NUM_INTERPOLATION_TAPS> samples;
+  alignas(16) std::array<std::array<s16, NUM_VOICES>, NUM_INTERPOLATION_TAPS> weights;
+  alignas(16) std::array<s16, NUM_VOICES> adsr_volume;
+  alignas(16) std::array<s32, NUM_VOICES> volume;
+};
+static_assert((NUM_VOICES % 8) == 0, "voice count is a multiple of the SIMD width");
+
 static ADSRPhase GetNextADSRPhase(ADSRPhase phase);
 
 bool IsVoiceReverbEnabled(u32 i);
@@ -311,10 +346,15 @@ static bool CheckRAMIRQ(u32 address);
 static void TriggerRAMIRQ();
 static void CheckForLateRAMIRQs();
 
-static void WriteToCaptureBuffer(u32 index, s16 value);
-static void IncrementCaptureBufferPosition();
+static void QueueCaptureFrame(s16 cd_audio_left, s16 cd_audio_right, s16 voice1, s16 voice3);
+static void FlushCaptureBuffers();
 
 static void ReadADPCMBlock(u16 address, ADPCMBlock* block);
+static const s16* GetADPCMBlockSamples(u16 address, const ADPCMBlock& block);
+static void InvalidateADPCMBlockCache(u32 ram_address, u32 size);
+static void ClearADPCMBlockCache();
+static void PrepareVoice(u32 voice_index);
+static void InterpolateVoices();
 static std::tuple<s32, s32> SampleVoice(u32 voice_index);
 
 static void UpdateNoise();
@@ -325,8 +365,14 @@ static void ReverbWrite(u32 address, s16 data);
 static void ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
 
 static void Execute(void* param, TickCount ticks, TickCount ticks_late);
+static void GenerateFrames(u32 frames, const std::tuple<s16, s16>* cd_audio_frames);
 static void UpdateEventInterval();
 
+static void StartWorkerThread();
+static void StopWorkerThread();
+static void WorkerThreadEntryPoint();
+static void WaitForWorkerThread();
+
 static void ExecuteFIFOWriteToRAM(TickCount& ticks);
 static void ExecuteFIFOReadFromRAM(TickCount& ticks);
 static void ExecuteTransfer(void* param, TickCount ticks, TickCount ticks_late);
@@ -357,6 +403,10 @@ static u32 s_transfer_address = 0;
 static u16 s_irq_address = 0;
 static u16 s_capture_buffer_position = 0;
 
+// Capture buffer writes are queued and written out in blocks, before anything else reads the capture area.
+static std::array<std::array<s16, CAPTURE_BATCH_FRAMES>, NUM_CAPTURE_BUFFERS> s_capture_batch;
+static u32 s_capture_batch_frames = 0;
+
 static VolumeRegister s_main_volume_left_reg = {};
 static VolumeRegister s_main_volume_right_reg = {};
 static VolumeSweep s_main_volume_left = {};
@@ -386,11 +436,29 @@ static std::array<std::array<s16, 64>, 2> s_reverb_upsample_buffer;
 static s32 s_reverb_resample_buffer_position = 0;
 
 static std::array<Voice, NUM_VOICES> s_voices{};
+static VoiceMixBuffer s_voice_mix_buffer;
 
 static InlineFIFOQueue<u16, FIFO_SIZE_IN_HALFWORDS> s_transfer_fifo;
 
 static std::array<u8, RAM_SIZE> s_ram{};
 
+// Direct-mapped on the block address. Looped samples shared by several voices are only expanded once, until the RAM
+// they were read from is written again.
+static std::array<ADPCMBlockCacheEntry, ADPCM_BLOCK_CACHE_SIZE> s_adpcm_block_cache;
+
+// With the worker thread, slices of frames from the tick event are mixed while the CPU thread carries on. Anything
+// which can see or change SPU state waits for the slice to finish first, so the result is the same as mixing inline.
+static Threading::Thread s_worker_thread;
+static std::mutex s_worker_mutex;
+static std::condition_variable s_worker_start_cv;
+static std::condition_variable s_worker_done_cv;
+static std::vector<std::tuple<s16, s16>> s_worker_cd_audio_frames;
+static u32 s_worker_frames = 0;
+static bool s_worker_shutdown = false;
+static bool s_worker_busy = false;
+static bool s_use_worker_thread = false;
+static bool s_execute_on_cpu_thread = false;
+
 #ifdef SPU_DUMP_ALL_VOICES
 // +1 for reverb output
 static std::array<std::unique_ptr<Common::WAVWriter>, NUM_VOICES + 1> s_voice_dump_writers;
@@ -410,6 +478,9 @@ void SPU::Initialize()
 
   CreateOutputStream();
   Reset();
+
+  if (g_settings.audio_mix_on_thread)
+    StartWorkerThread();
 }
 
 void SPU::CreateOutputStream()
@@ -435,12 +506,15 @@ void SPU::CreateOutputStream()
 
 void SPU::RecreateOutputStream()
 {
+  WaitForWorkerThread();
   s_audio_stream.reset();
   CreateOutputStream();
 }
 
 void SPU::CPUClockChanged()
 {
+  WaitForWorkerThread();
+
   // (X * D) / N / 768 -> (X * D) / (N * 768)
   s_cpu_ticks_per_spu_tick = System::ScaleTicksToOverclock(SYSCLK_TICKS_PER_SPU_TICK);
   s_cpu_tick_divider = static_cast<TickCount>(g_settings.cpu_overclock_numerator * SYSCLK_TICKS_PER_SPU_TICK);
@@ -448,8 +522,20 @@ void SPU::CPUClockChanged()
   UpdateEventInterval();
 }
 
+void SPU::UpdateSettings()
+{
+  if (s_use_worker_thread == g_settings.audio_mix_on_thread)
+    return;
+
+  if (g_settings.audio_mix_on_thread)
+    StartWorkerThread();
+  else
+    StopWorkerThread();
+}
+
 void SPU::Shutdown()
 {
+  StopWorkerThread();
   StopDumpingAudio();
   s_tick_event.reset();
   s_transfer_event.reset();
@@ -458,6 +544,8 @@ void SPU::Shutdown()
 
 void SPU::Reset()
 {
+  WaitForWorkerThread();
+
   s_ticks_carry = 0;
 
   s_SPUCNT.bits = 0;
@@ -466,6 +554,7 @@ void SPU::Reset()
   s_transfer_address_reg = 0;
   s_irq_address = 0;
   s_capture_buffer_position = 0;
+  s_capture_batch_frames = 0;
   s_main_volume_left_reg.bits = 0;
   s_main_volume_right_reg.bits = 0;
   s_main_volume_left = {};
@@ -511,11 +600,14 @@ void SPU::Reset()
   s_transfer_fifo.Clear();
   s_transfer_event->Deactivate();
   s_ram.fill(0);
+  ClearADPCMBlockCache();
   UpdateEventInterval();
 }
 
 bool SPU::DoState(StateWrapper& sw)
 {
+  WaitForWorkerThread();
+
   sw.Do(&s_ticks_carry);
   sw.Do(&s_SPUCNT.bits);
   sw.Do(&s_SPUSTAT.bits);
@@ -577,6 +669,7 @@ bool SPU::DoState(StateWrapper& sw)
 
   if (sw.IsReading())
   {
+    ClearADPCMBlockCache();
     UpdateEventInterval();
     UpdateTransferEvent();
   }
@@ -586,6 +679,8 @@ bool SPU::DoState(StateWrapper& sw)
 
 u16 SPU::ReadRegister(u32 offset)
 {
+  WaitForWorkerThread();
+
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
@@ -710,6 +805,8 @@ u16 SPU::ReadRegister(u32 offset)
 
 void SPU::WriteRegister(u32 offset, u16 value)
 {
+  WaitForWorkerThread();
+
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
@@ -1170,23 +1267,60 @@ void SPU::CheckForLateRAMIRQs()
   }
 }
 
-void SPU::WriteToCaptureBuffer(u32 index, s16 value)
+void SPU::QueueCaptureFrame(s16 cd_audio_left, s16 cd_audio_right, s16 voice1, s16 voice3)
 {
-  const u32 ram_address = (index * CAPTURE_BUFFER_SIZE_PER_CHANNEL) | ZeroExtend16(s_capture_buffer_position);
-  // Log_DebugPrintf("write to capture buffer %u (0x%08X) <- 0x%04X", index, ram_address, u16(value));
-  std::memcpy(&s_ram[ram_address], &value, sizeof(value));
-  if (IsRAMIRQTriggerable() && CheckRAMIRQ(ram_address))
-  {
-    Log_DebugPrintf("Trigger IRQ @ %08X %04X from capture buffer", ram_address, ram_address / 8);
-    TriggerRAMIRQ();
-  }
-}
+  s_capture_batch[0][s_capture_batch_frames] = cd_audio_left;
+  s_capture_batch[1][s_capture_batch_frames] = cd_audio_right;
+  s_capture_batch[2][s_capture_batch_frames] = voice1;
+  s_capture_batch[3][s_capture_batch_frames] = voice3;
 
-void SPU::IncrementCaptureBufferPosition()
-{
   s_capture_buffer_position += sizeof(s16);
   s_capture_buffer_position %= CAPTURE_BUFFER_SIZE_PER_CHANNEL;
   s_SPUSTAT.second_half_capture_buffer = s_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
+
+  if ((++s_capture_batch_frames) == CAPTURE_BATCH_FRAMES)
+    FlushCaptureBuffers();
+}
+
+void SPU::FlushCaptureBuffers()
+{
+  if (s_capture_batch_frames == 0)
+    return;
+
+  // The batch ends at the current position, and may wrap around the end of the buffer.
+  const u32 batch_size = s_capture_batch_frames * sizeof(s16);
+  const u32 start_offset =
+    (ZeroExtend32(s_capture_buffer_position) + CAPTURE_BUFFER_SIZE_PER_CHANNEL - batch_size) %
+    CAPTURE_BUFFER_SIZE_PER_CHANNEL;
+  const u32 first_size = std::min(batch_size, CAPTURE_BUFFER_SIZE_PER_CHANNEL - start_offset);
+  for (u32 index = 0; index < NUM_CAPTURE_BUFFERS; index++)
+  {
+    const u32 buffer_address = index * CAPTURE_BUFFER_SIZE_PER_CHANNEL;
+    const u8* data = reinterpret_cast<const u8*>(s_capture_batch[index].data());
+    std::memcpy(&s_ram[buffer_address + start_offset], data, first_size);
+    InvalidateADPCMBlockCache(buffer_address + start_offset, first_size);
+    if (first_size < batch_size)
+    {
+      std::memcpy(&s_ram[buffer_address], data + first_size, batch_size - first_size);
+      InvalidateADPCMBlockCache(buffer_address, batch_size - first_size);
+    }
+  }
+  s_capture_batch_frames = 0;
+
+  // All four buffers are written at the same offsets, so one range check covers the whole block. The IRQ can only
+  // fire once, so it doesn't matter which write in the block would have hit it first.
+  const u32 irq_address = ZeroExtend32(s_irq_address) * 8;
+  if (irq_address >= CAPTURE_BUFFER_AREA_SIZE || !IsRAMIRQTriggerable())
+    return;
+
+  const u32 irq_offset_in_batch =
+    ((irq_address % CAPTURE_BUFFER_SIZE_PER_CHANNEL) + CAPTURE_BUFFER_SIZE_PER_CHANNEL - start_offset) %
+    CAPTURE_BUFFER_SIZE_PER_CHANNEL;
+  if (irq_offset_in_batch < batch_size)
+  {
+    Log_DebugPrintf("Trigger IRQ @ %08X %04X from capture buffer", irq_address, irq_address / 8);
+    TriggerRAMIRQ();
+  }
 }
 
 void ALWAYS_INLINE SPU::ExecuteFIFOReadFromRAM(TickCount& ticks)
@@ -1213,6 +1347,7 @@ void ALWAYS_INLINE SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
   {
     u16 value = s_transfer_fifo.Pop();
     std::memcpy(&s_ram[s_transfer_address], &value, sizeof(u16));
+    InvalidateADPCMBlockCache(s_transfer_address, sizeof(u16));
     s_transfer_address = (s_transfer_address + sizeof(u16)) & RAM_MASK;
     ticks -= TRANSFER_TICKS_PER_HALFWORD;
 
@@ -1226,6 +1361,8 @@ void ALWAYS_INLINE SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
 
 void SPU::ExecuteTransfer(void* param, TickCount ticks, TickCount ticks_late)
 {
+  WaitForWorkerThread();
+
   const RAMTransferMode mode = s_SPUCNT.ram_transfer_mode;
   Assert(mode != RAMTransferMode::Stopped);
 
@@ -1348,6 +1485,8 @@ void SPU::UpdateDMARequest()
 
 void SPU::DMARead(u32* words, u32 word_count)
 {
+  WaitForWorkerThread();
+
   /*
     From @JaCzekanski - behavior when block size is larger than the FIFO size
     for blocks <= 0x16 - all data is transferred correctly
@@ -1417,6 +1556,8 @@ void SPU::DMARead(u32* words, u32 word_count)
 
 void SPU::DMAWrite(const u32* words, u32 word_count)
 {
+  WaitForWorkerThread();
+
   const u16* halfwords = reinterpret_cast<const u16*>(words);
   u32 halfword_count = word_count * 2;
 
@@ -1430,7 +1571,7 @@ void SPU::DMAWrite(const u32* words, u32 word_count)
   UpdateTransferEvent();
 }
 
-void SPU::GeneratePendingSamples()
+void SPU::GeneratePendingSamples(bool allow_worker_thread)
 {
   if (s_transfer_event->IsActive())
     s_transfer_event->InvokeEarly();
@@ -1449,7 +1590,9 @@ void SPU::GeneratePendingSamples()
   }
 
   const bool force_exec = (frames_to_execute > 0);
+  s_execute_on_cpu_thread = !allow_worker_thread;
   s_tick_event->InvokeEarly(force_exec);
+  s_execute_on_cpu_thread = false;
 }
 
 bool SPU::IsDumpingAudio()
@@ -1459,6 +1602,8 @@ bool SPU::IsDumpingAudio()
 
 bool SPU::StartDumpingAudio(const char* filename)
 {
+  WaitForWorkerThread();
+
   s_dump_writer.reset();
   s_dump_writer = std::make_unique<Common::WAVWriter>();
   if (!s_dump_writer->Open(filename, SAMPLE_RATE, 2))
@@ -1494,6 +1639,7 @@ bool SPU::StartDumpingAudio(const char* filename)
 
 bool SPU::StopDumpingAudio()
 {
+  WaitForWorkerThread();
   if (!s_dump_writer)
     return false;
 
@@ -1509,11 +1655,16 @@ bool SPU::StopDumpingAudio()
 
 const std::array<u8, SPU::RAM_SIZE>& SPU::GetRAM()
 {
+  WaitForWorkerThread();
   return s_ram;
 }
 
 std::array<u8, SPU::RAM_SIZE>& SPU::GetWritableRAM()
 {
+  WaitForWorkerThread();
+
+  // The caller can write anywhere, so nothing cached can be trusted afterwards.
+  ClearADPCMBlockCache();
   return s_ram;
 }
 
@@ -1524,11 +1675,14 @@ bool SPU::IsAudioOutputMuted()
 
 void SPU::SetAudioOutputMuted(bool muted)
 {
+  WaitForWorkerThread();
   s_audio_output_muted = muted;
 }
 
 AudioStream* SPU::GetOutputStream()
 {
+  // The worker thread writes to the stream.
+  WaitForWorkerThread();
   return s_audio_stream.get();
 }
 
@@ -1770,9 +1924,20 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   current_block_samples[1] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
   current_block_samples[0] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 3];
 
-  // pre-lookup
-  const u8 shift = block.GetShift();
+  const s16* block_samples = GetADPCMBlockSamples(current_address, block);
   const u8 filter_index = block.GetFilter();
+  current_block_flags.bits = block.flags.bits;
+
+  // without a filter, the expanded samples are the output
+  if (filter_index == 0)
+  {
+    std::copy_n(block_samples, NUM_SAMPLES_PER_ADPCM_BLOCK, &current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK]);
+    adpcm_last_samples[0] = block_samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+    adpcm_last_samples[1] = block_samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+    return;
+  }
+
+  // pre-lookup
   const s32 filter_pos = filter_table_pos[filter_index];
   const s32 filter_neg = filter_table_neg[filter_index];
   s16 last_samples[2] = {adpcm_last_samples[0], adpcm_last_samples[1]};
@@ -1780,8 +1945,8 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   // samples
   for (u32 i = 0; i < NUM_SAMPLES_PER_ADPCM_BLOCK; i++)
   {
-    // extend 4-bit to 16-bit, apply shift from header and mix in previous samples
-    s32 sample = s32(static_cast<s16>(ZeroExtend16(block.GetNibble(i)) << 12) >> shift);
+    // mix in previous samples
+    s32 sample = block_samples[i];
     sample += (last_samples[0] * filter_pos) >> 6;
     sample += (last_samples[1] * filter_neg) >> 6;
 
@@ -1790,91 +1955,187 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   }
 
   std::copy(last_samples, last_samples + countof(last_samples), adpcm_last_samples.begin());
-  current_block_flags.bits = block.flags.bits;
 }
 
-s32 SPU::Voice::Interpolate() const
-{
-  static constexpr std::array<s16, 0x200> gauss = {{
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
-    0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
-    0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
-    0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
-    0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
-    0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
-    0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
-    0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
-    0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
-    0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
-    0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
-    0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
-    0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
-    0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
-    0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
-    0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
-    0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
-    0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
-    0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
-    0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
-    0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
-    0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
-    0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
-    0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
-    0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
-    0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
-    0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
-    0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
-    0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
-    0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
-    0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
-    0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
-    0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
-    0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
-    0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
-    0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
-    0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
-    0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
-    0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
-    0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
-    0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
-    0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
-    0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
-    0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
-    0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
-    0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
-    0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
-    0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
-    0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
-    0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
-    0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
-    0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
-    0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
-    0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
-    0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
-    0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
-    0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
-    0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
-    0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
-    0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
-    0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
-    0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
-    0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
-  }};
-
-  const u8 i = counter.interpolation_index;
-  const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(counter.sample_index.GetValue());
-
-  s32 out = s32(gauss[0x0FF - i]) * s32(current_block_samples[s - 3]);
-  out += s32(gauss[0x1FF - i]) * s32(current_block_samples[s - 2]);
-  out += s32(gauss[0x100 + i]) * s32(current_block_samples[s - 1]);
-  out += s32(gauss[0x000 + i]) * s32(current_block_samples[s - 0]);
-  return out >> 15;
+static constexpr std::array<s16, 0x200> s_gauss_table = {{
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, -0x001, //
+  0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0001, //
+  0x0001, 0x0001, 0x0001, 0x0002, 0x0002, 0x0002, 0x0003, 0x0003, //
+  0x0003, 0x0004, 0x0004, 0x0005, 0x0005, 0x0006, 0x0007, 0x0007, //
+  0x0008, 0x0009, 0x0009, 0x000A, 0x000B, 0x000C, 0x000D, 0x000E, //
+  0x000F, 0x0010, 0x0011, 0x0012, 0x0013, 0x0015, 0x0016, 0x0018, // entry
+  0x0019, 0x001B, 0x001C, 0x001E, 0x0020, 0x0021, 0x0023, 0x0025, // 000..07F
+  0x0027, 0x0029, 0x002C, 0x002E, 0x0030, 0x0033, 0x0035, 0x0038, //
+  0x003A, 0x003D, 0x0040, 0x0043, 0x0046, 0x0049, 0x004D, 0x0050, //
+  0x0054, 0x0057, 0x005B, 0x005F, 0x0063, 0x0067, 0x006B, 0x006F, //
+  0x0074, 0x0078, 0x007D, 0x0082, 0x0087, 0x008C, 0x0091, 0x0096, //
+  0x009C, 0x00A1, 0x00A7, 0x00AD, 0x00B3, 0x00BA, 0x00C0, 0x00C7, //
+  0x00CD, 0x00D4, 0x00DB, 0x00E3, 0x00EA, 0x00F2, 0x00FA, 0x0101, //
+  0x010A, 0x0112, 0x011B, 0x0123, 0x012C, 0x0135, 0x013F, 0x0148, //
+  0x0152, 0x015C, 0x0166, 0x0171, 0x017B, 0x0186, 0x0191, 0x019C, //
+  0x01A8, 0x01B4, 0x01C0, 0x01CC, 0x01D9, 0x01E5, 0x01F2, 0x0200, //
+  0x020D, 0x021B, 0x0229, 0x0237, 0x0246, 0x0255, 0x0264, 0x0273, //
+  0x0283, 0x0293, 0x02A3, 0x02B4, 0x02C4, 0x02D6, 0x02E7, 0x02F9, //
+  0x030B, 0x031D, 0x0330, 0x0343, 0x0356, 0x036A, 0x037E, 0x0392, //
+  0x03A7, 0x03BC, 0x03D1, 0x03E7, 0x03FC, 0x0413, 0x042A, 0x0441, //
+  0x0458, 0x0470, 0x0488, 0x04A0, 0x04B9, 0x04D2, 0x04EC, 0x0506, //
+  0x0520, 0x053B, 0x0556, 0x0572, 0x058E, 0x05AA, 0x05C7, 0x05E4, // entry
+  0x0601, 0x061F, 0x063E, 0x065C, 0x067C, 0x069B, 0x06BB, 0x06DC, // 080..0FF
+  0x06FD, 0x071E, 0x0740, 0x0762, 0x0784, 0x07A7, 0x07CB, 0x07EF, //
+  0x0813, 0x0838, 0x085D, 0x0883, 0x08A9, 0x08D0, 0x08F7, 0x091E, //
+  0x0946, 0x096F, 0x0998, 0x09C1, 0x09EB, 0x0A16, 0x0A40, 0x0A6C, //
+  0x0A98, 0x0AC4, 0x0AF1, 0x0B1E, 0x0B4C, 0x0B7A, 0x0BA9, 0x0BD8, //
+  0x0C07, 0x0C38, 0x0C68, 0x0C99, 0x0CCB, 0x0CFD, 0x0D30, 0x0D63, //
+  0x0D97, 0x0DCB, 0x0E00, 0x0E35, 0x0E6B, 0x0EA1, 0x0ED7, 0x0F0F, //
+  0x0F46, 0x0F7F, 0x0FB7, 0x0FF1, 0x102A, 0x1065, 0x109F, 0x10DB, //
+  0x1116, 0x1153, 0x118F, 0x11CD, 0x120B, 0x1249, 0x1288, 0x12C7, //
+  0x1307, 0x1347, 0x1388, 0x13C9, 0x140B, 0x144D, 0x1490, 0x14D4, //
+  0x1517, 0x155C, 0x15A0, 0x15E6, 0x162C, 0x1672, 0x16B9, 0x1700, //
+  0x1747, 0x1790, 0x17D8, 0x1821, 0x186B, 0x18B5, 0x1900, 0x194B, //
+  0x1996, 0x19E2, 0x1A2E, 0x1A7B, 0x1AC8, 0x1B16, 0x1B64, 0x1BB3, //
+  0x1C02, 0x1C51, 0x1CA1, 0x1CF1, 0x1D42, 0x1D93, 0x1DE5, 0x1E37, //
+  0x1E89, 0x1EDC, 0x1F2F, 0x1F82, 0x1FD6, 0x202A, 0x207F, 0x20D4, //
+  0x2129, 0x217F, 0x21D5, 0x222C, 0x2282, 0x22DA, 0x2331, 0x2389, // entry
+  0x23E1, 0x2439, 0x2492, 0x24EB, 0x2545, 0x259E, 0x25F8, 0x2653, // 100..17F
+  0x26AD, 0x2708, 0x2763, 0x27BE, 0x281A, 0x2876, 0x28D2, 0x292E, //
+  0x298B, 0x29E7, 0x2A44, 0x2AA1, 0x2AFF, 0x2B5C, 0x2BBA, 0x2C18, //
+  0x2C76, 0x2CD4, 0x2D33, 0x2D91, 0x2DF0, 0x2E4F, 0x2EAE, 0x2F0D, //
+  0x2F6C, 0x2FCC, 0x302B, 0x308B, 0x30EA, 0x314A, 0x31AA, 0x3209, //
+  0x3269, 0x32C9, 0x3329, 0x3389, 0x33E9, 0x3449, 0x34A9, 0x3509, //
+  0x3569, 0x35C9, 0x3629, 0x3689, 0x36E8, 0x3748, 0x37A8, 0x3807, //
+  0x3867, 0x38C6, 0x3926, 0x3985, 0x39E4, 0x3A43, 0x3AA2, 0x3B00, //
+  0x3B5F, 0x3BBD, 0x3C1B, 0x3C79, 0x3CD7, 0x3D35, 0x3D92, 0x3DEF, //
+  0x3E4C, 0x3EA9, 0x3F05, 0x3F62, 0x3FBD, 0x4019, 0x4074, 0x40D0, //
+  0x412A, 0x4185, 0x41DF, 0x4239, 0x4292, 0x42EB, 0x4344, 0x439C, //
+  0x43F4, 0x444C, 0x44A3, 0x44FA, 0x4550, 0x45A6, 0x45FC, 0x4651, //
+  0x46A6, 0x46FA, 0x474E, 0x47A1, 0x47F4, 0x4846, 0x4898, 0x48E9, //
+  0x493A, 0x498A, 0x49D9, 0x4A29, 0x4A77, 0x4AC5, 0x4B13, 0x4B5F, //
+  0x4BAC, 0x4BF7, 0x4C42, 0x4C8D, 0x4CD7, 0x4D20, 0x4D68, 0x4DB0, //
+  0x4DF7, 0x4E3E, 0x4E84, 0x4EC9, 0x4F0E, 0x4F52, 0x4F95, 0x4FD7, // entry
+  0x5019, 0x505A, 0x509A, 0x50DA, 0x5118, 0x5156, 0x5194, 0x51D0, // 180..1FF
+  0x520C, 0x5247, 0x5281, 0x52BA, 0x52F3, 0x532A, 0x5361, 0x5397, //
+  0x53CC, 0x5401, 0x5434, 0x5467, 0x5499, 0x54CA, 0x54FA, 0x5529, //
+  0x5558, 0x5585, 0x55B2, 0x55DE, 0x5609, 0x5632, 0x565B, 0x5684, //
+  0x56AB, 0x56D1, 0x56F6, 0x571B, 0x573E, 0x5761, 0x5782, 0x57A3, //
+  0x57C3, 0x57E2, 0x57FF, 0x581C, 0x5838, 0x5853, 0x586D, 0x5886, //
+  0x589E, 0x58B5, 0x58CB, 0x58E0, 0x58F4, 0x5907, 0x5919, 0x592A, //
+  0x593A, 0x5949, 0x5958, 0x5965, 0x5971, 0x597C, 0x5986, 0x598F, //
+  0x5997, 0x599E, 0x59A4, 0x59A9, 0x59AD, 0x59B0, 0x59B2, 0x59B3  //
+}};
+
+void SPU::PrepareVoice(u32 voice_index)
+{
+  Voice& voice = s_voices[voice_index];
+  VoiceMixBuffer& mb = s_voice_mix_buffer;
+  if (!voice.IsOn() && !s_SPUCNT.irq9_enable)
+  {
+    for (u32 i = 0; i < NUM_INTERPOLATION_TAPS; i++)
+    {
+      mb.samples[i][voice_index] = 0;
+      mb.weights[i][voice_index] = 0;
+    }
+    mb.adsr_volume[voice_index] = 0;
+    return;
+  }
+
+  if (!voice.has_samples)
+  {
+    ADPCMBlock block;
+    ReadADPCMBlock(voice.current_address, &block);
+    voice.DecodeBlock(block);
+    voice.has_samples = true;
+
+    if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
+    {
+      Log_TracePrintf("Voice %u loop start @ 0x%08X", voice_index, ZeroExtend32(voice.current_address));
+      voice.regs.adpcm_repeat_address = voice.current_address;
+    }
+  }
+
+  // Muted voices don't need to skip interpolation, a zero ADSR volume gives a zero result regardless of the sample.
+  mb.adsr_volume[voice_index] = voice.regs.adsr_volume;
+
+  if (IsVoiceNoiseEnabled(voice_index))
+  {
+    // Noise bypasses interpolation. (noise * 0x4000 + noise * 0x4000) >> 15 == noise, so it can share the filter.
+    const s16 noise_level = GetVoiceNoiseLevel();
+    mb.samples[0][voice_index] = noise_level;
+    mb.samples[1][voice_index] = noise_level;
+    mb.samples[2][voice_index] = 0;
+    mb.samples[3][voice_index] = 0;
+    mb.weights[0][voice_index] = 0x4000;
+    mb.weights[1][voice_index] = 0x4000;
+    mb.weights[2][voice_index] = 0;
+    mb.weights[3][voice_index] = 0;
+    return;
+  }
+
+  const u8 i = voice.counter.interpolation_index;
+  const u32 s = NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + ZeroExtend32(voice.counter.sample_index.GetValue());
+  mb.samples[0][voice_index] = voice.current_block_samples[s - 3];
+  mb.samples[1][voice_index] = voice.current_block_samples[s - 2];
+  mb.samples[2][voice_index] = voice.current_block_samples[s - 1];
+  mb.samples[3][voice_index] = voice.current_block_samples[s - 0];
+  mb.weights[0][voice_index] = s_gauss_table[0x0FF - i];
+  mb.weights[1][voice_index] = s_gauss_table[0x1FF - i];
+  mb.weights[2][voice_index] = s_gauss_table[0x100 + i];
+  mb.weights[3][voice_index] = s_gauss_table[0x000 + i];
+}
+
+// Computes ApplyVolume(Gaussian interpolation, ADSR volume) for eight voices per iteration. The filter output is at
+// most 0x7F83 in magnitude (the largest sum of absolute weights), so it can be kept in 16 bits without saturation,
+// and 32-bit products/sums never overflow, keeping the results identical to the scalar version.
+void SPU::InterpolateVoices()
+{
+  VoiceMixBuffer& mb = s_voice_mix_buffer;
+
+#if defined(CPU_X64)
+  for (u32 i = 0; i < NUM_VOICES; i += 8)
+  {
+    const __m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.samples[0][i]));
+    const __m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.samples[1][i]));
+    const __m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.samples[2][i]));
+    const __m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.samples[3][i]));
+    const __m128i w0 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.weights[0][i]));
+    const __m128i w1 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.weights[1][i]));
+    const __m128i w2 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.weights[2][i]));
+    const __m128i w3 = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.weights[3][i]));
+
+    const __m128i out_lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(w0, w1), _mm_unpacklo_epi16(s0, s1)),
+                                         _mm_madd_epi16(_mm_unpacklo_epi16(w2, w3), _mm_unpacklo_epi16(s2, s3)));
+    const __m128i out_hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(w0, w1), _mm_unpackhi_epi16(s0, s1)),
+                                         _mm_madd_epi16(_mm_unpackhi_epi16(w2, w3), _mm_unpackhi_epi16(s2, s3)));
+    const __m128i sample = _mm_packs_epi32(_mm_srai_epi32(out_lo, 15), _mm_srai_epi32(out_hi, 15));
+
+    const __m128i adsr_volume = _mm_load_si128(reinterpret_cast<const __m128i*>(&mb.adsr_volume[i]));
+    const __m128i product_lo = _mm_mullo_epi16(sample, adsr_volume);
+    const __m128i product_hi = _mm_mulhi_epi16(sample, adsr_volume);
+    _mm_store_si128(reinterpret_cast<__m128i*>(&mb.volume[i]),
+                    _mm_srai_epi32(_mm_unpacklo_epi16(product_lo, product_hi), 15));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&mb.volume[i + 4]),
+                    _mm_srai_epi32(_mm_unpackhi_epi16(product_lo, product_hi), 15));
+  }
+#else
+  for (u32 i = 0; i < NUM_VOICES; i++)
+  {
+    s32 out = s32(mb.weights[0][i]) * s32(mb.samples[0][i]);
+    out += s32(mb.weights[1][i]) * s32(mb.samples[1][i]);
+    out += s32(mb.weights[2][i]) * s32(mb.samples[2][i]);
+    out += s32(mb.weights[3][i]) * s32(mb.samples[3][i]);
+    mb.volume[i] = ApplyVolume(out >> 15, mb.adsr_volume[i]);
+  }
+#endif
 }
 
 void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
 {
   u32 ram_address = (ZeroExtend32(address) * 8) & RAM_MASK;
+
+  // Voices can play back the capture buffers, and blocks at the end of RAM wrap around to them.
+  if (ram_address < CAPTURE_BUFFER_AREA_SIZE || (ram_address + sizeof(ADPCMBlock)) > RAM_SIZE)
+    FlushCaptureBuffers();
+
   if (IsRAMIRQTriggerable() && (CheckRAMIRQ(ram_address) || CheckRAMIRQ((ram_address + 8) & RAM_MASK)))
   {
     Log_DebugPrintf("Trigger IRQ @ %08X %04X from ADPCM reader", ram_address, ram_address / 8);
@@ -1899,6 +2160,49 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
+const s16* SPU::GetADPCMBlockSamples(u16 address, const ADPCMBlock& block)
+{
+  ADPCMBlockCacheEntry& entry = s_adpcm_block_cache[address % ADPCM_BLOCK_CACHE_SIZE];
+  if (entry.address == address && entry.shift_filter == block.shift_filter.bits)
+    return entry.samples.data();
+
+  // extend 4-bit to 16-bit and apply shift from header
+  const u8 shift = block.GetShift();
+  for (u32 i = 0; i < NUM_SAMPLES_PER_ADPCM_BLOCK; i++)
+    entry.samples[i] = static_cast<s16>(ZeroExtend16(block.GetNibble(i)) << 12) >> shift;
+
+  entry.address = address;
+  entry.shift_filter = block.shift_filter.bits;
+  return entry.samples.data();
+}
+
+void SPU::InvalidateADPCMBlockCache(u32 ram_address, u32 size)
+{
+  // Blocks are 16 bytes but start on any 8-byte boundary, so the block starting before the write overlaps it too.
+  constexpr u32 ADDRESS_MASK = RAM_MASK >> VOICE_ADDRESS_SHIFT;
+  const u32 first_address = (ram_address >> VOICE_ADDRESS_SHIFT) - 1;
+  const u32 count = ((ram_address + size - 1) >> VOICE_ADDRESS_SHIFT) - first_address + 1;
+  if (count >= ADPCM_BLOCK_CACHE_SIZE)
+  {
+    ClearADPCMBlockCache();
+    return;
+  }
+
+  for (u32 i = 0; i < count; i++)
+  {
+    const u32 address = (first_address + i) & ADDRESS_MASK;
+    ADPCMBlockCacheEntry& entry = s_adpcm_block_cache[address % ADPCM_BLOCK_CACHE_SIZE];
+    if (entry.address == address)
+      entry.address = INVALID_ADPCM_BLOCK_CACHE_ADDRESS;
+  }
+}
+
+void SPU::ClearADPCMBlockCache()
+{
+  for (ADPCMBlockCacheEntry& entry : s_adpcm_block_cache)
+    entry.address = INVALID_ADPCM_BLOCK_CACHE_ADDRESS;
+}
+
 ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
 {
   Voice& voice = s_voices[voice_index];
@@ -1917,38 +2221,8 @@ ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
     return {};
   }
 
-  if (!voice.has_samples)
-  {
-    ADPCMBlock block;
-    ReadADPCMBlock(voice.current_address, &block);
-    voice.DecodeBlock(block);
-    voice.has_samples = true;
-
-    if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
-    {
-      Log_TracePrintf("Voice %u loop start @ 0x%08X", voice_index, ZeroExtend32(voice.current_address));
-      voice.regs.adpcm_repeat_address = voice.current_address;
-    }
-  }
-
-  // skip interpolation when the volume is muted anyway
-  s32 volume;
-  if (voice.regs.adsr_volume != 0)
-  {
-    // interpolate/sample and apply ADSR volume
-    s32 sample;
-    if (IsVoiceNoiseEnabled(voice_index))
-      sample = GetVoiceNoiseLevel();
-    else
-      sample = voice.Interpolate();
-
-    volume = ApplyVolume(sample, voice.regs.adsr_volume);
-  }
-  else
-  {
-    volume = 0;
-  }
-
+  // interpolated/sampled with ADSR volume applied, by PrepareVoice() and InterpolateVoices()
+  const s32 volume = s_voice_mix_buffer.volume[voice_index];
   voice.last_volume = volume;
 
   if (voice.adsr_phase != ADSRPhase::Off)
@@ -2067,6 +2341,7 @@ void SPU::ReverbWrite(u32 address, s16 data)
   // TODO: This should check interrupts.
   const u32 real_address = ReverbMemoryAddress(address << 2);
   std::memcpy(&s_ram[real_address], &data, sizeof(data));
+  InvalidateADPCMBlockCache(real_address, sizeof(data));
 }
 
 // Zeroes optimized out; middle removed too(it's 16384)
@@ -2076,15 +2351,61 @@ static constexpr std::array<s16, 20> s_reverb_resample_coefficients = {
 static s16 s_last_reverb_input[2];
 static s32 s_last_reverb_output[2];
 
-ALWAYS_INLINE static s32 Reverb4422(const s16* src)
+// The coefficients above expanded for the vector filters, padded to a multiple of eight taps with zeros. The
+// downsampler reads every other sample, so its taps are interleaved with zeros, and include the middle one.
+static constexpr u32 NUM_REVERB_DOWNSAMPLE_TAPS = 48;
+static constexpr u32 NUM_REVERB_UPSAMPLE_TAPS = 24;
+
+static constexpr std::array<s16, NUM_REVERB_DOWNSAMPLE_TAPS> ComputeReverbDownsampleCoefficients()
+{
+  std::array<s16, NUM_REVERB_DOWNSAMPLE_TAPS> coefficients = {};
+  for (u32 i = 0; i < s_reverb_resample_coefficients.size(); i++)
+    coefficients[i * 2] = s_reverb_resample_coefficients[i];
+  coefficients[19] = 0x4000;
+  return coefficients;
+}
+
+static constexpr std::array<s16, NUM_REVERB_UPSAMPLE_TAPS> ComputeReverbUpsampleCoefficients()
+{
+  std::array<s16, NUM_REVERB_UPSAMPLE_TAPS> coefficients = {};
+  for (u32 i = 0; i < s_reverb_resample_coefficients.size(); i++)
+    coefficients[i] = s_reverb_resample_coefficients[i];
+  return coefficients;
+}
+
+alignas(16) static constexpr std::array<s16, NUM_REVERB_DOWNSAMPLE_TAPS> s_reverb_downsample_coefficients =
+  ComputeReverbDownsampleCoefficients();
+alignas(16) static constexpr std::array<s16, NUM_REVERB_UPSAMPLE_TAPS> s_reverb_upsample_coefficients =
+  ComputeReverbUpsampleCoefficients();
+
+// Reads past the last real tap are multiplied by zero, and stay within the resample buffers because they're mirrored.
+template<u32 num_taps>
+ALWAYS_INLINE static s32 ReverbFilter(const s16* src, const s16* coefficients)
 {
-  s32 out = 0; // 32-bits is adequate(it won't overflow)
-  for (u32 i = 0; i < 20; i++)
-    out += s_reverb_resample_coefficients[i] * src[i * 2];
+  static_assert((num_taps % 8) == 0, "tap count is a multiple of the vector width");
+
+#if defined(CPU_X64)
+  __m128i sum = _mm_setzero_si128();
+  for (u32 i = 0; i < num_taps; i += 8)
+  {
+    sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)),
+                                            _mm_load_si128(reinterpret_cast<const __m128i*>(coefficients + i))));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+#else
+  s32 sum = 0;
+  for (u32 i = 0; i < num_taps; i++)
+    sum += s32(coefficients[i]) * s32(src[i]);
+  return sum;
+#endif
+}
 
-  // Middle non-zero
-  out += 0x4000 * src[19];
-  out >>= 15;
+ALWAYS_INLINE static s32 Reverb4422(const s16* src)
+{
+  // 32-bits is adequate(it won't overflow)
+  const s32 out = ReverbFilter<NUM_REVERB_DOWNSAMPLE_TAPS>(src, s_reverb_downsample_coefficients.data()) >> 15;
   return std::clamp<s32>(out, -32768, 32767);
 }
 
@@ -2099,11 +2420,7 @@ ALWAYS_INLINE static s32 Reverb2244(const s16* src)
   }
   else
   {
-    out = 0;
-    for (u32 i = 0; i < 20; i++)
-      out += s_reverb_resample_coefficients[i] * src[i];
-
-    out >>= 14;
+    out = ReverbFilter<NUM_REVERB_UPSAMPLE_TAPS>(src, s_reverb_upsample_coefficients.data()) >> 14;
     out = std::clamp<s32>(out, -32768, 32767);
   }
 
@@ -2245,6 +2562,31 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
     s_ticks_carry = (ticks + s_ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
   }
 
+  WaitForWorkerThread();
+
+  // RAM IRQs have to be raised at the right time on the CPU thread, so slices which could hit one are mixed inline.
+  // Nothing else that the mixer does is visible to the CPU until it touches the SPU again, which waits for the worker.
+  if (s_use_worker_thread && !s_execute_on_cpu_thread && remaining_frames > 0 && !IsRAMIRQTriggerable())
+  {
+    // CD audio is pulled here, since the CD-ROM carries on filling its FIFO while the worker is mixing.
+    s_worker_cd_audio_frames.resize(remaining_frames);
+    for (u32 i = 0; i < remaining_frames; i++)
+      s_worker_cd_audio_frames[i] = g_cdrom.GetAudioFrame();
+
+    {
+      std::unique_lock<std::mutex> lock(s_worker_mutex);
+      s_worker_frames = remaining_frames;
+    }
+    s_worker_start_cv.notify_one();
+    s_worker_busy = true;
+    return;
+  }
+
+  GenerateFrames(remaining_frames, nullptr);
+}
+
+void SPU::GenerateFrames(u32 remaining_frames, const std::tuple<s16, s16>* cd_audio_frames)
+{
   AudioStream* output_stream = s_audio_output_muted ? s_null_audio_stream.get() : s_audio_stream.get();
 
   while (remaining_frames > 0)
@@ -2264,6 +2606,12 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
 
       u32 reverb_on_register = s_reverb_on_register;
 
+      // Blocks are decoded and interpolation taps gathered first, so the filter can run across all voices at once.
+      // Nothing in SampleVoice() affects another voice's decoding, so this does not change the order of side effects.
+      for (u32 voice = 0; voice < NUM_VOICES; voice++)
+        PrepareVoice(voice);
+      InterpolateVoices();
+
       for (u32 voice = 0; voice < NUM_VOICES; voice++)
       {
         const auto [left, right] = SampleVoice(voice);
@@ -2288,7 +2636,7 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
       UpdateNoise();
 
       // Mix in CD audio.
-      const auto [cd_audio_left, cd_audio_right] = g_cdrom.GetAudioFrame();
+      const auto [cd_audio_left, cd_audio_right] = cd_audio_frames ? *(cd_audio_frames++) : g_cdrom.GetAudioFrame();
       if (s_SPUCNT.cd_audio_enable)
       {
         const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), s_cd_audio_volume_left);
@@ -2304,7 +2652,10 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
         }
       }
 
-      // Compute reverb.
+      // Compute reverb. The work area can overlap the capture buffers if the base address is low enough.
+      if ((s_reverb_base_address * sizeof(s16)) < CAPTURE_BUFFER_AREA_SIZE)
+        FlushCaptureBuffers();
+
       s32 reverb_out_left, reverb_out_right;
       ProcessReverb(static_cast<s16>(Clamp16(reverb_in_left)), static_cast<s16>(Clamp16(reverb_in_right)),
                     &reverb_out_left, &reverb_out_right);
@@ -2320,11 +2671,8 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
       s_main_volume_right.Tick();
 
       // Write to capture buffers.
-      WriteToCaptureBuffer(0, cd_audio_left);
-      WriteToCaptureBuffer(1, cd_audio_right);
-      WriteToCaptureBuffer(2, static_cast<s16>(Clamp16(s_voices[1].last_volume)));
-      WriteToCaptureBuffer(3, static_cast<s16>(Clamp16(s_voices[3].last_volume)));
-      IncrementCaptureBufferPosition();
+      QueueCaptureFrame(cd_audio_left, cd_audio_right, static_cast<s16>(Clamp16(s_voices[1].last_volume)),
+                        static_cast<s16>(Clamp16(s_voices[3].last_volume)));
 
       // Key off/on voices after the first frame.
       if (i == 0 && (s_key_off_register != 0 || s_key_on_register != 0))
@@ -2357,6 +2705,9 @@ void SPU::Execute(void* param, TickCount ticks, TickCount ticks_late)
     output_stream->EndWrite(frames_in_this_batch);
     remaining_frames -= frames_in_this_batch;
   }
+
+  // Registers and DMA can see the capture buffers after we return.
+  FlushCaptureBuffers();
 }
 
 void SPU::UpdateEventInterval()
@@ -2373,9 +2724,16 @@ void SPU::UpdateEventInterval()
     return;
 
   // Ensure all pending ticks have been executed, since we won't get them back after rescheduling.
+  s_execute_on_cpu_thread = true;
   s_tick_event->InvokeEarly(true);
+  s_execute_on_cpu_thread = false;
   s_tick_event->SetInterval(interval_ticks);
 
+  // Without the IRQ, output is only written in batches anyway, so the batch can run a little late to save stopping the
+  // CPU for it.
+  s_tick_event->SetTolerance(
+    (interval > 1) ? (static_cast<TickCount>(LATE_OUTPUT_TOLERANCE_FRAMES) * s_cpu_ticks_per_spu_tick) : 0);
+
   TickCount downcount = interval_ticks;
   if (!g_settings.cpu_overclock_active)
     downcount -= s_ticks_carry;
@@ -2383,8 +2741,75 @@ void SPU::UpdateEventInterval()
   s_tick_event->Schedule(downcount);
 }
 
+void SPU::StartWorkerThread()
+{
+  DebugAssert(!s_use_worker_thread);
+  s_worker_shutdown = false;
+  s_worker_frames = 0;
+  s_worker_busy = false;
+  s_use_worker_thread = true;
+  s_worker_thread.Start(&SPU::WorkerThreadEntryPoint);
+  Log_InfoPrint("SPU worker thread started.");
+}
+
+void SPU::StopWorkerThread()
+{
+  if (!s_use_worker_thread)
+    return;
+
+  WaitForWorkerThread();
+
+  {
+    std::unique_lock<std::mutex> lock(s_worker_mutex);
+    s_worker_shutdown = true;
+  }
+  s_worker_start_cv.notify_one();
+  s_worker_thread.Join();
+  s_use_worker_thread = false;
+  s_worker_cd_audio_frames = {};
+  Log_InfoPrint("SPU worker thread stopped.");
+}
+
+void SPU::WorkerThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("SPU Worker");
+
+  for (;;)
+  {
+    u32 frames;
+    {
+      std::unique_lock<std::mutex> lock(s_worker_mutex);
+      s_worker_start_cv.wait(lock, []() { return s_worker_shutdown || s_worker_frames != 0; });
+      if (s_worker_shutdown)
+        break;
+
+      frames = s_worker_frames;
+    }
+
+    GenerateFrames(frames, s_worker_cd_audio_frames.data());
+
+    {
+      std::unique_lock<std::mutex> lock(s_worker_mutex);
+      s_worker_frames = 0;
+    }
+    s_worker_done_cv.notify_one();
+  }
+}
+
+void SPU::WaitForWorkerThread()
+{
+  if (!s_worker_busy)
+    return;
+
+  std::unique_lock<std::mutex> lock(s_worker_mutex);
+  s_worker_done_cv.wait(lock, []() { return s_worker_frames == 0; });
+  s_worker_busy = false;
+}
+
 void SPU::DrawDebugStateWindow()
 {
+  WaitForWorkerThread();
+
   static const ImVec4 active_color{1.0f, 1.0f, 1.0f, 1.0f};
   static const ImVec4 inactive_color{0.4f, 0.4f, 0.4f, 1.0f};
   const float framebuffer_scale = Host::GetOSDScale();
@@ -21,6 +21,7 @@ enum : u32
 
 void Initialize();
 void CPUClockChanged();
+void UpdateSettings();
 void Shutdown();
 void Reset();
 bool DoState(StateWrapper& sw);
@@ -34,8 +35,9 @@ void DMAWrite(const u32* words, u32 word_count);
 // Render statistics debug window.
 void DrawDebugStateWindow();
 
-// Executes the SPU, generating any pending samples.
-void GeneratePendingSamples();
+// Executes the SPU, generating any pending samples. If allowed, they may still be being mixed on the worker thread when
+// this returns; that's fine for anything which doesn't look at SPU state itself.
+void GeneratePendingSamples(bool allow_worker_thread = false);
 
 /// Returns true if currently dumping audio.
 bool IsDumpingAudio();
@@ -5,13 +5,19 @@
 #include "bus.h"
 #include "cdrom.h"
 #include "cheats.h"
+#include "common/align.h"
+#include "common/allocation_profiler.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/make_array.h"
+#include "common/md5_digest.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/thread_placement.h"
+#include "common/thread_pool.h"
 #include "common/threading.h"
+#include "common/trace.h"
 #include "controller.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
@@ -43,13 +49,18 @@
 #include "util/iso_reader.h"
 #include "util/state_wrapper.h"
 #include "xxhash.h"
+#include <atomic>
 #include <cctype>
 #include <cinttypes>
 #include <cmath>
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
 #include <deque>
 #include <fstream>
+#include <functional>
 #include <limits>
+#include <mutex>
 #include <thread>
 Log_SetChannel(System);
 
@@ -74,21 +85,87 @@ struct MemorySaveState
 {
   std::unique_ptr<GPUTexture> vram_texture;
   std::unique_ptr<GrowableMemoryByteStream> state_stream;
+
+  // Rewind states other than the newest only keep the XOR of their state stream against the next newer state,
+  // run-length encoded on zero words. The full stream is rebuilt when the newer state is popped.
+  std::vector<u8> state_delta;
+  u32 state_size = 0;
+
+  // internal frame number the state was taken at
+  u32 frame_number = 0;
+};
+
+// Snapshot of the console when a fast boot reaches the BIOS shell, which only depends on the BIOS and region.
+static constexpr u32 BOOT_SNAPSHOT_MAGIC = 0x53425344; // DSBS
+static constexpr u32 BOOT_SNAPSHOT_VERSION = 1;
+static constexpr VirtualMemoryAddress BOOT_SNAPSHOT_SHELL_ENTRY = 0x80030000;
+
+#pragma pack(push, 1)
+struct BootSnapshotHeader
+{
+  u32 magic;
+  u32 version;
+  u32 state_version;
+  u32 ram_size;
+  u32 overclock_numerator;
+  u32 overclock_denominator;
+  u32 multitap_mode;
+  u32 state_size;
+};
+#pragma pack(pop)
+
+struct PadDevices
+{
+  std::array<std::unique_ptr<Controller>, NUM_CONTROLLER_AND_CARD_PORTS> controllers;
+  std::array<std::unique_ptr<MemoryCard>, NUM_CONTROLLER_AND_CARD_PORTS> memory_cards;
+};
+
+struct PendingSaveStateWrite
+{
+  std::string filename;
+  std::unique_ptr<GrowableMemoryByteStream> state_stream;
+  bool backup_existing_save;
+  bool compress;
+  s32 compression_level;
 };
 
 namespace System {
 static std::optional<ExtendedSaveStateInfo> InternalGetExtendedSaveStateInfo(ByteStream* stream);
 static bool InternalSaveState(ByteStream* state, u32 screenshot_size = 256,
                               u32 compression_method = SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE);
-static bool SaveMemoryState(MemorySaveState* mss);
-static bool LoadMemoryState(const MemorySaveState& mss);
+static bool SaveMemoryState(MemorySaveState* mss, bool host_vram = true);
+static bool LoadMemoryState(const MemorySaveState& mss, bool update_display = true);
+
+static void StartBootSnapshot(const BIOS::Image& image);
+static bool LoadBootSnapshot(const std::string& path);
+static void SaveBootSnapshot();
+static bool OnBootSnapshotShellEntry(VirtualMemoryAddress address);
+static void DetachPadDevices(PadDevices* devices);
+static void ReattachPadDevices(PadDevices* devices);
+
+static bool CreateSaveStateWrite(const char* filename, bool backup_existing_save, bool archival,
+                                 PendingSaveStateWrite* write);
+static void QueueSaveStateWrite(PendingSaveStateWrite write);
+static bool WriteSaveStateToFile(const PendingSaveStateWrite& write);
+static bool WriteAndReportSaveState(const PendingSaveStateWrite& write);
+static void SaveStateWriterThreadEntryPoint();
+static void WaitForSaveStateWrites();
+static void StopSaveStateWriter();
+
+static void QueueDumpWrite(std::string filename, const char* description, std::function<bool(const char*)> write);
+static void FlushDumpWrites();
 
 static bool LoadEXE(const char* filename);
 
-static std::string GetExecutableNameForImage(ISOReader& iso, bool strip_subdirectories);
-
-static bool ReadExecutableFromImage(ISOReader& iso, std::string* out_executable_name,
+static std::string ReadBootPathFromSystemCNF(ISOReader& iso);
+static std::string GetExecutableNameFromBootPath(std::string code, bool strip_subdirectories);
+static std::string GetSerialForExecutableName(std::string code);
+static bool ReadExecutableFromImage(ISOReader& iso, std::string executable_path, std::string* out_executable_name,
                                     std::vector<u8>* out_executable_data);
+static std::string GetGameHashId(const ISOReader& iso, u32 track_1_length, const std::string& exe_name,
+                                 const std::vector<u8>& exe_buffer);
+static std::string GetAchievementsHash(const std::string& exe_name, const std::vector<u8>& exe_buffer);
+static void ClearImageIdentification();
 
 static void StallCPU(TickCount ticks);
 
@@ -96,17 +173,26 @@ static void InternalReset();
 static void ClearRunningGame();
 static void DestroySystem();
 static std::string GetMediaPathFromSaveState(const char* path);
+static std::unique_ptr<ByteStream> OpenSaveStateFile(const char* filename, FileSystem::MappedFile* mapping);
 static bool DoLoadState(ByteStream* stream, bool force_software_renderer, bool update_display);
 static bool DoState(StateWrapper& sw, GPUTexture** host_texture, bool update_display, bool is_memory_state);
 static void DoRunFrame();
+static void DelayFrameStart(Common::Timer::Value work_time);
+static bool GetPresentationTiming(Common::Timer::Value* present_time, Common::Timer::Value* refresh_interval);
+static bool GetHostRefreshRate(float* refresh_rate);
+static void AlignThrottleToPresentation();
 static bool CreateGPU(GPURenderer renderer);
 static bool SaveUndoLoadState();
 
 static void SetRewinding(bool enabled);
 static bool SaveRewindState();
+static void EncodeRewindDelta(MemorySaveState* mss, const GrowableMemoryByteStream* ref_stream);
+static void DecodeRewindDelta(MemorySaveState* mss, std::unique_ptr<GrowableMemoryByteStream> ref_stream);
+static void PopRewindState();
 static void DoRewind();
 
 static void SaveRunaheadState();
+static void ReleaseRunaheadStates();
 static void DoRunahead();
 
 static void DoMemorySaveStates();
@@ -119,6 +205,21 @@ static bool CheckForSBIFile(CDImage* image);
 static std::unique_ptr<MemoryCard> GetMemoryCardForSlot(u32 slot, MemoryCardType type);
 
 static void SetTimerResolutionIncreased(bool enabled);
+
+static void WriteGPUTimingsLog();
+static void CloseGPUTimingsLog();
+static void PublishPerformanceMetrics(bool running);
+
+static void ResetFrameTimeStatistics();
+static void AddFrameTimeSample(FrameTimeCounter counter, float time_ms);
+static void UpdateFrameTimePercentiles();
+static void LogFrameTimeStatistics();
+static void UpdateInputLatency();
+
+static void LoadAutoTuneHistory();
+static void SaveAutoTuneHistory();
+static void ApplyAutoTuneSettings(bool display_osd_messages);
+static void AddAutoTuneSample();
 } // namespace System
 
 static std::unique_ptr<INISettingsInterface> s_game_settings_interface;
@@ -136,6 +237,13 @@ static u32 s_internal_frame_number = 1;
 
 static std::string s_running_game_path;
 static std::string s_running_game_serial;
+
+// Identification of the most recently identified image, so booting or changing discs only reads it once.
+static std::mutex s_image_identification_mutex;
+static const CDImage* s_identified_image = nullptr;
+static std::string s_identified_image_path;
+static u32 s_identified_subimage = 0;
+static System::ImageIdentification s_image_identification;
 static std::string s_running_game_title;
 static bool s_running_bios;
 
@@ -144,6 +252,24 @@ static float s_target_speed = 1.0f;
 static Common::Timer::Value s_frame_period = 0;
 static Common::Timer::Value s_next_frame_time = 0;
 
+// How far before the frame deadline the precise throttler stops sleeping, tracks the observed oversleep.
+static Common::Timer::Value s_throttle_oversleep = 0;
+static Common::Timer::Value s_throttle_sleep_margin = 0;
+
+// Worst recent time from frame start to presentation, for delaying the frame start when reducing latency.
+static Common::Timer::Value s_frame_work_time = 0;
+
+// Most recent scanout and refresh interval from the host's presentation feedback, written by the host's thread.
+// Feedback older than a second is ignored, e.g. when the window is hidden and nothing is being presented.
+static std::atomic<Common::Timer::Value> s_presentation_time{0};
+static std::atomic<Common::Timer::Value> s_presentation_refresh_interval{0};
+static std::atomic_bool s_presentation_refresh_interval_changed{false};
+
+// Frames which aren't presented when running behind, at most MAX_AUTO_SKIPPED_FRAMES in a row.
+static constexpr u32 MAX_AUTO_SKIPPED_FRAMES = 3;
+static bool s_skip_next_frame = false;
+static u32 s_frames_skipped_in_row = 0;
+
 static bool s_frame_step_request = false;
 static bool s_fast_forward_enabled = false;
 static bool s_turbo_enabled = false;
@@ -166,6 +292,56 @@ static float s_sw_thread_time = 0.0f;
 static float s_average_gpu_time = 0.0f;
 static float s_accumulated_gpu_time = 0.0f;
 static float s_gpu_usage = 0.0f;
+static HostDisplay::GPUTimingSectionTimes s_average_gpu_section_times = {};
+static HostDisplay::GPUTimingSectionTimes s_accumulated_gpu_section_times = {};
+static std::FILE* s_gpu_timings_log = nullptr;
+
+// Copy of the counters for other threads. The sequence is odd while the CPU thread is writing, readers retry if it
+// changed while they were copying.
+static std::atomic<u32> s_performance_metrics_sequence{0};
+static System::PerformanceMetrics s_performance_metrics = {};
+
+// Recent samples for the overlay, plus a histogram over the whole session in 0.1ms buckets up to 100ms.
+// The final histogram bucket collects everything slower than that.
+static constexpr u32 FRAME_TIME_HISTOGRAM_BUCKETS = 1000;
+static constexpr float FRAME_TIME_HISTOGRAM_BUCKET_SIZE = 0.1f;
+struct FrameTimeCounterState
+{
+  System::FrameTimeHistory history;
+  u32 history_pos;
+  u32 history_count;
+  std::array<u32, FRAME_TIME_HISTOGRAM_BUCKETS + 1> histogram;
+  u64 histogram_total;
+  System::FrameTimePercentiles percentiles;
+};
+static std::array<FrameTimeCounterState, static_cast<size_t>(System::FrameTimeCounter::Count)> s_frame_time_counters;
+
+// Per-game history of how often each resolution scale held full speed, one sample per performance counter update.
+// The history is kept per renderer, and only samples from this session are merged back into the game settings file,
+// so edits made to it by the settings UI while the game is running aren't lost.
+static constexpr u32 AUTO_TUNE_MIN_SAMPLES = 60;
+static constexpr u32 AUTO_TUNE_FULL_SPEED_PERCENT = 90;
+static constexpr float AUTO_TUNE_FULL_SPEED_THRESHOLD = 95.0f;
+static constexpr u32 AUTO_TUNE_WARMUP_SAMPLES = 3;
+struct AutoTuneLevel
+{
+  u32 samples;
+  u32 full_speed_samples;
+};
+using AutoTuneHistory = std::array<AutoTuneLevel, GPU::MAX_RESOLUTION_SCALE + 1>;
+static AutoTuneHistory s_auto_tune_history = {};
+static AutoTuneHistory s_auto_tune_session_samples = {};
+static std::string s_auto_tune_serial;
+static GPURenderer s_auto_tune_renderer = GPURenderer::Software;
+static u32 s_auto_tune_applied_scale = 0;
+static u32 s_auto_tune_warmup = 0;
+
+// Input currently being tracked for latency measurement, zero when nothing is in flight.
+static Common::Timer::Value s_input_latency_receive_time = 0;
+static Common::Timer::Value s_input_latency_read_time = 0;
+static u32 s_input_latency_read_frame = 0;
+static u64 s_last_frame_cpu_time = 0;
+static u64 s_last_frame_sw_time = 0;
 static u32 s_last_frame_number = 0;
 static u32 s_last_internal_frame_number = 0;
 static u32 s_last_global_tick_counter = 0;
@@ -181,6 +357,20 @@ static std::unique_ptr<CheatList> s_cheat_list;
 // temporary save state, created when loading, used to undo load state
 static std::unique_ptr<ByteStream> m_undo_load_state;
 
+// save states are compressed and written to disk in order on a worker thread
+static Threading::Thread s_save_state_writer_thread;
+static std::mutex s_save_state_writer_mutex;
+static std::condition_variable s_save_state_writer_start_cv;
+static std::condition_variable s_save_state_writer_done_cv;
+static std::deque<PendingSaveStateWrite> s_save_state_writer_queue;
+static bool s_save_state_writer_busy = false;
+static bool s_save_state_writer_shutdown = false;
+
+// RAM/VRAM dumps are snapshotted on the CPU thread and written by the shared pool
+static constexpr u32 MAX_QUEUED_DUMP_WRITES = 4;
+static Threading::ThreadPool::TaskGroup s_dump_writes;
+static std::atomic<u32> s_queued_dump_writes{0};
+
 static bool s_memory_saves_enabled = false;
 
 static std::deque<MemorySaveState> s_rewind_states;
@@ -189,8 +379,15 @@ static s32 s_rewind_load_counter = -1;
 static s32 s_rewind_save_frequency = -1;
 static s32 s_rewind_save_counter = -1;
 static bool s_rewinding_first_save = false;
+static std::vector<u64> s_rewind_delta_buffer;
+static std::unique_ptr<GrowableMemoryByteStream> s_rewind_spare_stream;
+
+// Where the boot snapshot is saved once the shell is reached, empty when we aren't waiting for it.
+static std::string s_boot_snapshot_path;
+static bool s_boot_snapshot_reached = false;
 
 static std::deque<MemorySaveState> s_runahead_states;
+static std::vector<MemorySaveState> s_runahead_free_states;
 static bool s_runahead_replay_pending = false;
 static u32 s_runahead_frames = 0;
 
@@ -368,6 +565,20 @@ float System::GetGPUAverageTime()
 {
   return s_average_gpu_time;
 }
+float System::GetGPUAverageSectionTime(u32 section)
+{
+  return (section < HostDisplay::NUM_GPU_TIMING_SECTIONS) ? s_average_gpu_section_times[section] : 0.0f;
+}
+System::FrameTimePercentiles System::GetFrameTimePercentiles(FrameTimeCounter counter)
+{
+  return s_frame_time_counters[static_cast<size_t>(counter)].percentiles;
+}
+const System::FrameTimeHistory& System::GetFrameTimeHistory(u32* oldest_pos)
+{
+  const FrameTimeCounterState& state = s_frame_time_counters[static_cast<size_t>(FrameTimeCounter::Frame)];
+  *oldest_pos = state.history_pos;
+  return state.history;
+}
 
 bool System::IsExeFileName(const std::string_view& path)
 {
@@ -430,48 +641,43 @@ std::string System::GetGameSerialForPath(const char* image_path, bool fallback_t
 
 std::string System::GetGameIdFromImage(CDImage* cdi, bool fallback_to_hash)
 {
-  std::string code(GetExecutableNameForImage(cdi));
-  if (!code.empty())
-  {
-    // SCES_123.45 -> SCES-12345
-    for (std::string::size_type pos = 0; pos < code.size();)
-    {
-      if (code[pos] == '.')
-      {
-        code.erase(pos, 1);
-        continue;
-      }
+  const ImageIdentification ident(GetImageIdentification(cdi));
+  if (!ident.serial.empty() || !fallback_to_hash)
+    return ident.serial;
 
-      if (code[pos] == '_')
-        code[pos] = '-';
-      else
-        code[pos] = static_cast<char>(std::toupper(code[pos]));
+  return ident.hash_id;
+}
+
+std::string System::GetGameHashIdFromImage(CDImage* cdi)
+{
+  return GetImageIdentification(cdi).hash_id;
+}
 
-      pos++;
+std::string System::GetSerialForExecutableName(std::string code)
+{
+  // SCES_123.45 -> SCES-12345
+  for (std::string::size_type pos = 0; pos < code.size();)
+  {
+    if (code[pos] == '.')
+    {
+      code.erase(pos, 1);
+      continue;
     }
 
-    return code;
-  }
+    if (code[pos] == '_')
+      code[pos] = '-';
+    else
+      code[pos] = static_cast<char>(std::toupper(code[pos]));
 
-  if (!fallback_to_hash)
-    return {};
+    pos++;
+  }
 
-  return GetGameHashIdFromImage(cdi);
+  return code;
 }
 
-std::string System::GetGameHashIdFromImage(CDImage* cdi)
+std::string System::GetGameHashId(const ISOReader& iso, u32 track_1_length, const std::string& exe_name,
+                                  const std::vector<u8>& exe_buffer)
 {
-  ISOReader iso;
-  if (!iso.Open(cdi, 1))
-    return {};
-
-  std::string exe_name;
-  std::vector<u8> exe_buffer;
-  if (!ReadExecutableFromImage(cdi, &exe_name, &exe_buffer))
-    return {};
-
-  const u32 track_1_length = cdi->GetTrackLength(1);
-
   XXH64_state_t* state = XXH64_createState();
   XXH64_reset(state, 0x4242D00C);
   XXH64_update(state, exe_name.c_str(), exe_name.size());
@@ -485,7 +691,96 @@ std::string System::GetGameHashIdFromImage(CDImage* cdi)
   return StringUtil::StdStringFromFormat("HASH-%" PRIX64, hash);
 }
 
-std::string System::GetExecutableNameForImage(ISOReader& iso, bool strip_subdirectories)
+std::string System::GetAchievementsHash(const std::string& exe_name, const std::vector<u8>& exe_buffer)
+{
+  BIOS::PSEXEHeader header;
+  if (exe_buffer.size() >= sizeof(header))
+    std::memcpy(&header, exe_buffer.data(), sizeof(header));
+  if (!BIOS::IsValidPSExeHeader(header, static_cast<u32>(exe_buffer.size())))
+  {
+    Log_ErrorPrintf("PS-EXE header is invalid in '%s' (%zu bytes)", exe_name.c_str(), exe_buffer.size());
+    return {};
+  }
+
+  // See rcheevos hash.c - rc_hash_psx().
+  const u32 MAX_HASH_SIZE = 64 * 1024 * 1024;
+  const u32 hash_size = std::min<u32>(sizeof(header) + header.file_size, MAX_HASH_SIZE);
+  Assert(hash_size <= exe_buffer.size());
+
+  MD5Digest digest;
+  digest.Update(exe_name.c_str(), static_cast<u32>(exe_name.size()));
+  if (hash_size > 0)
+    digest.Update(exe_buffer.data(), hash_size);
+
+  u8 hash[16];
+  digest.Final(hash);
+
+  std::string hash_str(StringUtil::StdStringFromFormat(
+    "%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x", hash[0], hash[1], hash[2], hash[3], hash[4],
+    hash[5], hash[6], hash[7], hash[8], hash[9], hash[10], hash[11], hash[12], hash[13], hash[14], hash[15]));
+
+  Log_InfoPrintf("Hash for '%s' (%zu bytes, %u bytes hashed): %s", exe_name.c_str(), exe_buffer.size(), hash_size,
+                 hash_str.c_str());
+  return hash_str;
+}
+
+bool System::IdentifyImage(CDImage* cdi, ImageIdentification* ident, bool hash_for_achievements)
+{
+  *ident = {};
+  ident->system_area_region = GetRegionFromSystemArea(cdi);
+
+  ISOReader iso;
+  if (!iso.Open(cdi, 1))
+    return false;
+
+  // SYSTEM.CNF and the executable are only read once, everything else is derived from them.
+  const std::string boot_path(ReadBootPathFromSystemCNF(iso));
+  if (!boot_path.empty())
+    ident->serial = GetSerialForExecutableName(GetExecutableNameFromBootPath(boot_path, true));
+
+  std::string executable_path;
+  if (!boot_path.empty())
+    executable_path = GetExecutableNameFromBootPath(boot_path, false);
+
+  std::vector<u8> exe_buffer;
+  if (!ReadExecutableFromImage(iso, std::move(executable_path), &ident->executable_path, &exe_buffer))
+    return true;
+
+  ident->hash_id = GetGameHashId(iso, cdi->GetTrackLength(1), ident->executable_path, exe_buffer);
+  if (hash_for_achievements)
+    ident->achievements_hash = GetAchievementsHash(ident->executable_path, exe_buffer);
+
+  return true;
+}
+
+System::ImageIdentification System::GetImageIdentification(CDImage* cdi)
+{
+  std::unique_lock lock(s_image_identification_mutex);
+  if (s_identified_image != cdi || s_identified_image_path != cdi->GetFileName() ||
+      s_identified_subimage != cdi->GetCurrentSubImage())
+  {
+#ifdef WITH_CHEEVOS
+    IdentifyImage(cdi, &s_image_identification, true);
+#else
+    IdentifyImage(cdi, &s_image_identification, false);
+#endif
+    s_identified_image = cdi;
+    s_identified_image_path = cdi->GetFileName();
+    s_identified_subimage = cdi->GetCurrentSubImage();
+  }
+
+  return s_image_identification;
+}
+
+void System::ClearImageIdentification()
+{
+  std::unique_lock lock(s_image_identification_mutex);
+  s_identified_image = nullptr;
+  s_identified_image_path = {};
+  s_image_identification = {};
+}
+
+std::string System::ReadBootPathFromSystemCNF(ISOReader& iso)
 {
   // Read SYSTEM.CNF
   std::vector<u8> system_cnf_data;
@@ -534,7 +829,11 @@ std::string System::GetExecutableNameForImage(ISOReader& iso, bool strip_subdire
   if (iter == lines.end())
     return {};
 
-  std::string code = iter->second;
+  return std::move(iter->second);
+}
+
+std::string System::GetExecutableNameFromBootPath(std::string code, bool strip_subdirectories)
+{
   std::string::size_type pos;
   if (strip_subdirectories)
   {
@@ -578,15 +877,15 @@ std::string System::GetExecutableNameForImage(CDImage* cdi)
   if (!iso.Open(cdi, 1))
     return {};
 
-  return GetExecutableNameForImage(iso, true);
+  const std::string boot_path(ReadBootPathFromSystemCNF(iso));
+  return boot_path.empty() ? std::string() : GetExecutableNameFromBootPath(boot_path, true);
 }
 
-bool System::ReadExecutableFromImage(ISOReader& iso, std::string* out_executable_name,
+bool System::ReadExecutableFromImage(ISOReader& iso, std::string executable_path, std::string* out_executable_name,
                                      std::vector<u8>* out_executable_data)
 {
   bool result = false;
 
-  std::string executable_path(GetExecutableNameForImage(iso, false));
   Log_DevPrintf("Executable path: '%s'", executable_path.c_str());
   if (!executable_path.empty())
   {
@@ -620,7 +919,11 @@ bool System::ReadExecutableFromImage(CDImage* cdi, std::string* out_executable_n
   if (!iso.Open(cdi, 1))
     return false;
 
-  return ReadExecutableFromImage(iso, out_executable_name, out_executable_data);
+  std::string executable_path(ReadBootPathFromSystemCNF(iso));
+  if (!executable_path.empty())
+    executable_path = GetExecutableNameFromBootPath(std::move(executable_path), false);
+
+  return ReadExecutableFromImage(iso, std::move(executable_path), out_executable_name, out_executable_data);
 }
 
 DiscRegion System::GetRegionForSerial(std::string_view serial)
@@ -669,15 +972,14 @@ DiscRegion System::GetRegionFromSystemArea(CDImage* cdi)
 
 DiscRegion System::GetRegionForImage(CDImage* cdi)
 {
-  DiscRegion system_area_region = GetRegionFromSystemArea(cdi);
-  if (system_area_region != DiscRegion::Other)
-    return system_area_region;
+  const ImageIdentification ident(GetImageIdentification(cdi));
+  if (ident.system_area_region != DiscRegion::Other)
+    return ident.system_area_region;
 
-  std::string serial = GetGameIdFromImage(cdi, false);
-  if (serial.empty())
+  if (ident.serial.empty())
     return DiscRegion::Other;
 
-  return GetRegionForSerial(serial);
+  return GetRegionForSerial(ident.serial);
 }
 
 DiscRegion System::GetRegionForExe(const char* path)
@@ -785,7 +1087,12 @@ void System::LoadSettings(bool display_osd_messages)
       entry->ApplySettings(g_settings, display_osd_messages);
   }
 
+  ApplyAutoTuneSettings(display_osd_messages);
+
   g_settings.FixIncompatibleSettings(display_osd_messages);
+
+  // threads which are already running keep their placement
+  Threading::SetThreadPinningEnabled(g_settings.cpu_thread_pinning);
 }
 
 void System::SetDefaultSettings(SettingsInterface& si)
@@ -799,6 +1106,7 @@ void System::SetDefaultSettings(SettingsInterface& si)
   temp.display_show_resolution = g_settings.display_show_resolution;
   temp.display_show_cpu = g_settings.display_show_cpu;
   temp.display_show_gpu = g_settings.display_show_gpu;
+  temp.display_show_input_latency = g_settings.display_show_input_latency;
 
   // keep controller, we reset it elsewhere
   for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
@@ -971,7 +1279,11 @@ bool System::LoadState(const char* filename)
 
   Common::Timer load_timer;
 
-  std::unique_ptr<ByteStream> stream = ByteStream::OpenFile(filename, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+  // make sure a save to the same file has finished
+  WaitForSaveStateWrites();
+
+  FileSystem::MappedFile mapping;
+  std::unique_ptr<ByteStream> stream = OpenSaveStateFile(filename, &mapping);
   if (!stream)
     return false;
 
@@ -1006,47 +1318,177 @@ bool System::LoadState(const char* filename)
   return true;
 }
 
-bool System::SaveState(const char* filename, bool backup_existing_save)
+bool System::SaveState(const char* filename, bool backup_existing_save, bool archival /* = false */)
+{
+  // Only the uncompressed snapshot is taken here, compression and the file write happen on the writer thread.
+  PendingSaveStateWrite write;
+  if (!CreateSaveStateWrite(filename, backup_existing_save, archival, &write))
+    return false;
+
+  QueueSaveStateWrite(std::move(write));
+  return true;
+}
+
+bool System::CreateSaveStateWrite(const char* filename, bool backup_existing_save, bool archival,
+                                  PendingSaveStateWrite* write)
+{
+  Common::Timer save_timer;
+
+  write->filename = filename;
+  write->state_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
+  write->backup_existing_save = backup_existing_save;
+  write->compress = g_settings.compress_save_states;
+  write->compression_level =
+    archival ? g_settings.archival_save_state_compression_level : g_settings.save_state_compression_level;
+
+  Log_InfoPrintf("Saving state to '%s'...", filename);
+
+  const u32 screenshot_size = 256;
+  if (!InternalSaveState(write->state_stream.get(), screenshot_size))
+  {
+    Host::ReportFormattedErrorAsync(Host::TranslateString("OSDMessage", "Save State"),
+                                    Host::TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
+    return false;
+  }
+
+  Log_VerbosePrintf("Saving state took %.2f msec", save_timer.GetTimeMilliseconds());
+  return true;
+}
+
+void System::QueueSaveStateWrite(PendingSaveStateWrite write)
+{
+  std::unique_lock<std::mutex> lock(s_save_state_writer_mutex);
+  if (!s_save_state_writer_thread.Joinable())
+  {
+    s_save_state_writer_shutdown = false;
+    s_save_state_writer_thread.Start(&SaveStateWriterThreadEntryPoint);
+  }
+
+  s_save_state_writer_queue.push_back(std::move(write));
+  s_save_state_writer_start_cv.notify_one();
+}
+
+bool System::WriteSaveStateToFile(const PendingSaveStateWrite& write)
 {
-  if (backup_existing_save && FileSystem::FileExists(filename))
+  Common::Timer write_timer;
+
+  const char* filename = write.filename.c_str();
+  if (write.backup_existing_save && FileSystem::FileExists(filename))
   {
     const std::string backup_filename(Path::ReplaceExtension(filename, "bak"));
     if (!FileSystem::RenamePath(filename, backup_filename.c_str()))
       Log_ErrorPrintf("Failed to rename save state backup '%s'", backup_filename.c_str());
   }
 
-  Common::Timer save_timer;
-
   std::unique_ptr<ByteStream> stream =
     ByteStream::OpenFile(filename, BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_TRUNCATE |
                                      BYTESTREAM_OPEN_ATOMIC_UPDATE | BYTESTREAM_OPEN_STREAMED);
   if (!stream)
     return false;
 
-  Log_InfoPrintf("Saving state to '%s'...", filename);
+  const u8* state_data = write.state_stream->GetMemoryPointer();
+  const u32 state_size = static_cast<u32>(write.state_stream->GetSize());
+
+  bool result;
+  if (!write.compress)
+  {
+    result = stream->Write2(state_data, state_size);
+  }
+  else
+  {
+    // Everything before the state data stays at the same offset, so only the header sizes need updating.
+    SAVE_STATE_HEADER header;
+    std::memcpy(&header, state_data, sizeof(header));
+
+    std::unique_ptr<ByteStream> cstream;
+    result = stream->Write2(state_data, header.offset_to_data) &&
+             (cstream = ByteStream::CreateZstdCompressStream(stream.get(), write.compression_level,
+                                                            g_settings.save_state_compression_threads)) &&
+             cstream->Write2(state_data + header.offset_to_data, state_size - header.offset_to_data) &&
+             cstream->Commit();
+    if (result)
+    {
+      header.data_compression_type = SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD;
+      header.data_compressed_size = static_cast<u32>(stream->GetPosition() - header.offset_to_data);
+      result = stream->SeekAbsolute(0) && stream->Write2(&header, sizeof(header));
+    }
+  }
 
-  const u32 screenshot_size = 256;
-  const bool result = InternalSaveState(stream.get(), screenshot_size,
-                                        g_settings.compress_save_states ? SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD :
-                                                                          SAVE_STATE_HEADER::COMPRESSION_TYPE_NONE);
   if (!result)
+  {
+    stream->Discard();
+    return false;
+  }
+
+  stream->Commit();
+  Log_VerbosePrintf("Writing state to '%s' took %.2f msec", filename, write_timer.GetTimeMilliseconds());
+  return true;
+}
+
+void System::SaveStateWriterThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Save State Writer");
+
+  std::unique_lock<std::mutex> lock(s_save_state_writer_mutex);
+  for (;;)
+  {
+    s_save_state_writer_start_cv.wait(
+      lock, []() { return s_save_state_writer_shutdown || !s_save_state_writer_queue.empty(); });
+    if (s_save_state_writer_queue.empty())
+      break;
+
+    PendingSaveStateWrite write(std::move(s_save_state_writer_queue.front()));
+    s_save_state_writer_queue.pop_front();
+    s_save_state_writer_busy = true;
+    lock.unlock();
+
+    WriteAndReportSaveState(write);
+
+    lock.lock();
+    s_save_state_writer_busy = false;
+    if (s_save_state_writer_queue.empty())
+      s_save_state_writer_done_cv.notify_all();
+  }
+}
+
+bool System::WriteAndReportSaveState(const PendingSaveStateWrite& write)
+{
+  const char* filename = write.filename.c_str();
+  if (!WriteSaveStateToFile(write))
   {
     Host::ReportFormattedErrorAsync(Host::TranslateString("OSDMessage", "Save State"),
                                     Host::TranslateString("OSDMessage", "Saving state to '%s' failed."), filename);
-    stream->Discard();
+    return false;
   }
-  else
+
+  const std::string display_name(FileSystem::GetDisplayNameFromPath(filename));
+  Host::AddIconOSDMessage("save_state", ICON_FA_SAVE,
+                          fmt::format(Host::TranslateString("OSDMessage", "State saved to '{}'.").GetCharArray(),
+                                      Path::GetFileName(display_name)),
+                          5.0f);
+  return true;
+}
+
+void System::WaitForSaveStateWrites()
+{
+  std::unique_lock<std::mutex> lock(s_save_state_writer_mutex);
+  s_save_state_writer_done_cv.wait(
+    lock, []() { return s_save_state_writer_queue.empty() && !s_save_state_writer_busy; });
+}
+
+void System::StopSaveStateWriter()
+{
   {
-    const std::string display_name(FileSystem::GetDisplayNameFromPath(filename));
-    Host::AddIconOSDMessage("save_state", ICON_FA_SAVE,
-                            fmt::format(Host::TranslateString("OSDMessage", "State saved to '{}'.").GetCharArray(),
-                                        Path::GetFileName(display_name)),
-                            5.0f);
-    stream->Commit();
+    std::unique_lock<std::mutex> lock(s_save_state_writer_mutex);
+    if (!s_save_state_writer_thread.Joinable())
+      return;
+
+    // any queued writes are still flushed before the thread exits
+    s_save_state_writer_shutdown = true;
+    s_save_state_writer_start_cv.notify_one();
   }
 
-  Log_VerbosePrintf("Saving state took %.2f msec", save_timer.GetTimeMilliseconds());
-  return result;
+  s_save_state_writer_thread.Join();
 }
 
 bool System::SaveResumeState()
@@ -1054,8 +1496,15 @@ bool System::SaveResumeState()
   if (s_running_game_serial.empty())
     return false;
 
+  // Written on this thread, so the caller finds out if it failed. Anything already queued for the same file has to
+  // land first, or it would overwrite this one.
   const std::string path(GetGameSaveStateFileName(s_running_game_serial, -1));
-  return SaveState(path.c_str(), false);
+  PendingSaveStateWrite write;
+  if (!CreateSaveStateWrite(path.c_str(), false, true, &write))
+    return false;
+
+  WaitForSaveStateWrites();
+  return WriteAndReportSaveState(write);
 }
 
 bool System::BootSystem(SystemBootParameters parameters)
@@ -1173,24 +1622,29 @@ bool System::BootSystem(SystemBootParameters parameters)
   }
 #endif
 
-  // Load BIOS image.
-  std::optional<BIOS::Image> bios_image(BIOS::GetBIOSImage(s_region));
-  if (!bios_image)
+  // Load BIOS image on a worker while the components are set up, GPU creation is usually the slowest part of boot.
+  std::optional<BIOS::Image> bios_image;
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  Threading::ThreadPool::TaskGroup bios_load;
+  pool.Submit([&bios_image, region = s_region]() { bios_image = BIOS::GetBIOSImage(region); },
+              Threading::ThreadPool::Priority::High, &bios_load);
+
+  // Component setup.
+  const bool initialized = Initialize(parameters.force_software_renderer);
+  bios_load.Wait(pool);
+  if (!initialized)
   {
-    Host::ReportFormattedErrorAsync("Error", Host::TranslateString("System", "Failed to load %s BIOS."),
-                                    Settings::GetConsoleRegionName(s_region));
     s_state = State::Shutdown;
     ClearRunningGame();
     Host::OnSystemDestroyed();
     return false;
   }
 
-  // Component setup.
-  if (!Initialize(parameters.force_software_renderer))
+  if (!bios_image)
   {
-    s_state = State::Shutdown;
-    ClearRunningGame();
-    Host::OnSystemDestroyed();
+    Host::ReportFormattedErrorAsync("Error", Host::TranslateString("System", "Failed to load %s BIOS."),
+                                    Settings::GetConsoleRegionName(s_region));
+    DestroySystem();
     return false;
   }
 
@@ -1203,6 +1657,14 @@ bool System::BootSystem(SystemBootParameters parameters)
   UpdateMultitaps();
   InternalReset();
 
+  // Warm up the code cache with the blocks from the last time this game was run with the same BIOS.
+  if (g_settings.cpu_recompiler_block_profile && g_settings.IsUsingCodeCache() && !s_running_game_serial.empty())
+  {
+    CPU::CodeCache::LoadBlockProfile(Path::Combine(
+      EmuFolders::Cache, fmt::format("blockprofile_{}_{}.bin", Path::SanitizeFileName(s_running_game_serial),
+                                     BIOS::GetImageHash(bios_image.value()).ToString())));
+  }
+
   // Enable tty by patching bios.
   const BIOS::ImageInfo* bios_info = BIOS::GetInfoForImage(bios_image.value());
   if (bios_info && bios_info->patch_compatible)
@@ -1227,15 +1689,20 @@ bool System::BootSystem(SystemBootParameters parameters)
   // Insert CD, and apply fastboot patch if enabled.
   if (media)
     g_cdrom.InsertMedia(std::move(media));
+  bool fast_boot_patched = false;
   if (g_cdrom.HasMedia() && (parameters.override_fast_boot.has_value() ? parameters.override_fast_boot.value() :
                                                                          g_settings.bios_patch_fast_boot))
   {
     if (bios_info && bios_info->patch_compatible)
-      BIOS::PatchBIOSFastBoot(Bus::g_bios, Bus::BIOS_SIZE);
+      fast_boot_patched = BIOS::PatchBIOSFastBoot(Bus::g_bios, Bus::BIOS_SIZE);
     else
       Log_ErrorPrintf("Not patching fast boot, as BIOS is not patch compatible.");
   }
 
+  // Skip the BIOS startup with the snapshot from an earlier boot, or take one when the shell is reached.
+  if (fast_boot_patched && g_settings.bios_boot_snapshot && parameters.save_state.empty())
+    StartBootSnapshot(bios_image.value());
+
   // Good to go.
   s_state =
     (g_settings.start_paused || parameters.override_start_paused.value_or(false)) ? State::Paused : State::Running;
@@ -1251,8 +1718,8 @@ bool System::BootSystem(SystemBootParameters parameters)
   // try to load the state, if it fails, bail out
   if (!parameters.save_state.empty())
   {
-    std::unique_ptr<ByteStream> stream =
-      ByteStream::OpenFile(parameters.save_state.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+    FileSystem::MappedFile mapping;
+    std::unique_ptr<ByteStream> stream = OpenSaveStateFile(parameters.save_state.c_str(), &mapping);
     if (!stream)
     {
       Host::ReportErrorAsync(
@@ -1312,6 +1779,8 @@ bool System::Initialize(bool force_software_renderer)
   s_average_gpu_time = 0.0f;
   s_accumulated_gpu_time = 0.0f;
   s_gpu_usage = 0.0f;
+  s_average_gpu_section_times.fill(0.0f);
+  s_accumulated_gpu_section_times.fill(0.0f);
   s_last_frame_number = 0;
   s_last_internal_frame_number = 0;
   s_last_global_tick_counter = 0;
@@ -1319,6 +1788,7 @@ bool System::Initialize(bool force_software_renderer)
   s_last_cpu_time = 0;
   s_fps_timer.Reset();
   s_frame_timer.Reset();
+  ResetFrameTimeStatistics();
 
   TimingEvents::Initialize();
 
@@ -1402,6 +1872,7 @@ bool System::Initialize(bool force_software_renderer)
   }
 
   s_cpu_thread_handle = Threading::ThreadHandle::GetForCallingThread();
+  Threading::ApplyThreadPlacement(Threading::ThreadClass::Emulation);
 
   UpdateThrottlePeriod();
   UpdateMemorySaveStateSettings();
@@ -1414,10 +1885,16 @@ void System::DestroySystem()
     return;
 
   SetTimerResolutionIncreased(false);
+  CloseGPUTimingsLog();
+  LogFrameTimeStatistics();
 
   s_cpu_thread_usage = {};
 
   ClearMemorySaveStates();
+  StopSaveStateWriter();
+  FlushDumpWrites();
+  s_boot_snapshot_path = {};
+  s_boot_snapshot_reached = false;
 
   g_texture_replacements.Shutdown();
 
@@ -1431,6 +1908,19 @@ void System::DestroySystem()
   g_interrupt_controller.Shutdown();
   g_dma.Shutdown();
   PGXP::Shutdown();
+  PublishPerformanceMetrics(false);
+#ifdef WITH_RECOMPILER
+  if (g_settings.cpu_recompiler_statistics && g_settings.IsUsingRecompiler())
+  {
+    const std::string base_path = Path::Combine(
+      EmuFolders::Dumps, fmt::format("recompiler_{}", s_running_game_serial.empty() ?
+                                                         std::string("unknown") :
+                                                         Path::SanitizeFileName(s_running_game_serial)));
+    CPU::CodeCache::SaveBlockSet((base_path + "_blocks.bin").c_str());
+    CPU::CodeCache::DumpStatistics((base_path + "_stats.csv").c_str());
+  }
+#endif
+  CPU::CodeCache::SaveBlockProfile();
   CPU::CodeCache::Shutdown();
   Bus::Shutdown();
   CPU::Shutdown();
@@ -1450,10 +1940,13 @@ void System::DestroySystem()
 
 void System::ClearRunningGame()
 {
+  SaveAutoTuneHistory();
+
   s_running_game_serial.clear();
   s_running_game_path.clear();
   s_running_game_title.clear();
   s_running_bios = false;
+  ClearImageIdentification();
   s_cheat_list.reset();
   s_state = State::Shutdown;
 
@@ -1468,10 +1961,14 @@ void System::Execute()
 {
   while (System::IsRunning())
   {
+    const Common::Timer::Value frame_start_time = Common::Timer::GetCurrentValue();
+    const bool skip_frame = (s_skip_next_frame && s_throttler_enabled);
+    g_gpu->SetFrameSkip(skip_frame);
     if (s_display_all_frames)
       System::RunFrame();
     else
       System::RunFrames();
+    g_gpu->SetFrameSkip(false);
 
     // this can shut us down
     Host::PumpMessagesOnCPUThread();
@@ -1484,19 +1981,94 @@ void System::Execute()
       PauseSystem(true);
     }
 
-    const bool skip_present = g_host_display->ShouldSkipDisplayingFrame();
-    Host::RenderDisplay(skip_present);
+    const Common::Timer::Value work_time = Common::Timer::GetCurrentValue() - frame_start_time;
+
+    // For VRR displays, throttle first and present straight after, so the refresh happens at the frame boundary.
+    const bool present_after_throttle = (s_throttler_enabled && g_settings.display_vrr_frame_pacing);
+    if (present_after_throttle)
+      System::Throttle();
+
+    const bool skip_present = skip_frame || g_host_display->ShouldSkipDisplayingFrame();
+    {
+      ALLOCATION_TAG("RenderDisplay");
+      Host::RenderDisplay(skip_present);
+    }
+    if (!skip_present && g_settings.display_show_input_latency)
+      UpdateInputLatency();
     if (!skip_present && g_host_display->IsGPUTimingEnabled())
     {
-      s_accumulated_gpu_time += g_host_display->GetAndResetAccumulatedGPUTime();
+      const float gpu_time = g_host_display->GetAndResetAccumulatedGPUTime();
+      s_accumulated_gpu_time += gpu_time;
       s_presents_since_last_update++;
+      AddFrameTimeSample(FrameTimeCounter::GPU, gpu_time);
+
+      HostDisplay::GPUTimingSectionTimes section_times;
+      g_host_display->GetAndResetAccumulatedGPUSectionTimes(&section_times);
+      for (u32 i = 0; i < HostDisplay::NUM_GPU_TIMING_SECTIONS; i++)
+        s_accumulated_gpu_section_times[i] += section_times[i];
     }
 
     System::UpdatePerformanceCounters();
+    AllocationProfiler::EndFrame();
+
+    // The refresh rate was only known approximately when the speed limiter was last set up.
+    if (s_presentation_refresh_interval_changed.exchange(false, std::memory_order_acquire))
+      UpdateSpeedLimiterState();
 
-    if (s_throttler_enabled)
+    if (s_throttler_enabled && !present_after_throttle)
       System::Throttle();
+
+    if (g_settings.display_latency_reduction)
+    {
+      // this polls input, so it can shut us down too
+      DelayFrameStart(work_time);
+      if (!IsValid())
+        return;
+    }
+  }
+}
+
+void System::DelayFrameStart(Common::Timer::Value work_time)
+{
+  // Only meaningful at normal speed, where each frame lines up with a host refresh.
+  if (s_target_speed != 1.0f || !s_display_all_frames)
+    return;
+
+  // Take any new worst case immediately, and let the estimate decay slowly, so a single slow frame doesn't
+  // turn into a missed refresh.
+  if (work_time > s_frame_work_time)
+    s_frame_work_time = work_time;
+  else
+    s_frame_work_time -= (s_frame_work_time - work_time) / 32;
+
+  // With presentation feedback, the next scanout is known. Otherwise, we've just presented (or throttled to the
+  // frame boundary), so assume the next refresh is one period away.
+  const Common::Timer::Value current_time = Common::Timer::GetCurrentValue();
+  Common::Timer::Value next_refresh_time;
+  Common::Timer::Value present_time, refresh_interval;
+  if (s_syncing_to_host && GetPresentationTiming(&present_time, &refresh_interval) && current_time >= present_time)
+  {
+    next_refresh_time = present_time + ((current_time - present_time) / refresh_interval + 1) * refresh_interval;
+  }
+  else
+  {
+    float refresh_rate;
+    if (!s_syncing_to_host || !GetHostRefreshRate(&refresh_rate) || refresh_rate <= 0.0f)
+      refresh_rate = s_throttle_frequency;
+
+    next_refresh_time =
+      current_time + Common::Timer::ConvertSecondsToValue(1.0 / static_cast<double>(refresh_rate));
   }
+
+  const Common::Timer::Value margin = Common::Timer::ConvertMillisecondsToValue(2.0) + s_frame_work_time / 4;
+  if ((current_time + s_frame_work_time + margin) >= next_refresh_time)
+    return;
+
+  TRACE_SCOPE("DelayFrameStart");
+  Common::Timer::SleepUntil(next_refresh_time - s_frame_work_time - margin, false);
+
+  // Sample input as late as possible before the frame starts.
+  Host::PumpMessagesOnCPUThread();
 }
 
 void System::RecreateSystem()
@@ -1757,6 +2329,18 @@ std::string System::GetMediaPathFromSaveState(const char* path)
   return ret;
 }
 
+std::unique_ptr<ByteStream> System::OpenSaveStateFile(const char* filename, FileSystem::MappedFile* mapping)
+{
+  // Reading from a mapping lets the large blocks (RAM, VRAM, SPU RAM) come straight out of the page cache in a
+  // single copy, instead of going through buffered reads.
+  auto fp = FileSystem::OpenManagedCFile(filename, "rb");
+  if (fp && mapping->Map(fp.get()) && mapping->GetSize() <= std::numeric_limits<u32>::max())
+    return ByteStream::CreateReadOnlyMemoryStream(mapping->GetData(), static_cast<u32>(mapping->GetSize()));
+
+  mapping->Unmap();
+  return ByteStream::OpenFile(filename, BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
+}
+
 bool System::DoLoadState(ByteStream* state, bool force_software_renderer, bool update_display)
 {
   Assert(IsValid());
@@ -2001,7 +2585,8 @@ bool System::InternalSaveState(ByteStream* state, u32 screenshot_size /* = 256 *
     }
     else if (compression_method == SAVE_STATE_HEADER::COMPRESSION_TYPE_ZSTD)
     {
-      std::unique_ptr<ByteStream> cstream(ByteStream::CreateZstdCompressStream(state, 0));
+      std::unique_ptr<ByteStream> cstream(ByteStream::CreateZstdCompressStream(
+        state, g_settings.save_state_compression_level, g_settings.save_state_compression_threads));
       StateWrapper sw(cstream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
       result = DoState(sw, nullptr, false, false) && cstream->Commit();
       header.data_uncompressed_size = static_cast<u32>(cstream->GetPosition());
@@ -2045,6 +2630,9 @@ void System::SingleStepCPU()
 
 void System::DoRunFrame()
 {
+  TRACE_SCOPE("DoRunFrame");
+  ALLOCATION_TAG("DoRunFrame");
+
   g_gpu->RestoreGraphicsAPIState();
 
   if (CPU::g_state.use_debug_dispatcher)
@@ -2074,8 +2662,17 @@ void System::DoRunFrame()
     }
   }
 
+  // Compile blocks from the profile between frames, so they don't stall execution when they're first reached.
+  if (g_settings.IsUsingCodeCache())
+    CPU::CodeCache::PrecompileProfiledBlocks();
+  if (g_settings.IsUsingRecompiler())
+  {
+    CPU::CodeCache::FormHotTraces();
+    CPU::CodeCache::LayoutHotBlocks();
+  }
+
   // Generate any pending samples from the SPU before sleeping, this way we reduce the chances of underruns.
-  SPU::GeneratePendingSamples();
+  SPU::GeneratePendingSamples(true);
 
   if (s_cheat_list)
     s_cheat_list->Apply();
@@ -2098,6 +2695,9 @@ void System::RunFrame()
 
   DoRunFrame();
 
+  if (s_boot_snapshot_reached)
+    SaveBootSnapshot();
+
   s_next_frame_time += s_frame_period;
 
   if (s_memory_saves_enabled)
@@ -2138,6 +2738,10 @@ void System::ResetThrottler()
 
 void System::Throttle()
 {
+  TRACE_SCOPE("Throttle");
+
+  AlignThrottleToPresentation();
+
   // If we're running too slow, advance the next frame time based on the time we lost. Effectively skips
   // running those frames at the intended time, because otherwise if we pause in the debugger, we'll run
   // hundreds of frames when we resume.
@@ -2146,16 +2750,109 @@ void System::Throttle()
   {
     const Common::Timer::Value diff = static_cast<s64>(current_time) - static_cast<s64>(s_next_frame_time);
     s_next_frame_time += (diff / s_frame_period) * s_frame_period;
+
+    // Catch up by not rendering the next frame, but still show one every so often.
+    s_skip_next_frame = (g_settings.display_auto_frame_skip && s_frames_skipped_in_row < MAX_AUTO_SKIPPED_FRAMES);
+    s_frames_skipped_in_row = s_skip_next_frame ? (s_frames_skipped_in_row + 1) : 0;
     return;
   }
 
-  Common::Timer::SleepUntil(s_next_frame_time, true);
-}
+  s_skip_next_frame = false;
+  s_frames_skipped_in_row = 0;
 
-void System::RunFrames()
-{
-  // If we're running more than this in a single loop... we're in for a bad time.
-  const u32 max_frames_to_run = 2;
+  if (!g_settings.precise_throttle)
+  {
+    Common::Timer::SleepUntil(s_next_frame_time, true);
+    return;
+  }
+
+  if (s_throttle_sleep_margin == 0)
+  {
+    s_throttle_oversleep = Common::Timer::ConvertMillisecondsToValue(1.0);
+    s_throttle_sleep_margin = s_throttle_oversleep;
+  }
+
+  // Sleep until just before the deadline, then spin for the remainder, so scheduler wakeup jitter doesn't
+  // land on the frame boundary. The oversleep estimate jumps up to any new worst case, and decays slowly.
+  if ((s_next_frame_time - current_time) > s_throttle_sleep_margin)
+  {
+    const Common::Timer::Value sleep_until = s_next_frame_time - s_throttle_sleep_margin;
+    Common::Timer::SleepUntil(sleep_until, false);
+
+    const Common::Timer::Value woke_time = Common::Timer::GetCurrentValue();
+    const Common::Timer::Value oversleep = (woke_time > sleep_until) ? (woke_time - sleep_until) : 0;
+    if (oversleep > s_throttle_oversleep)
+      s_throttle_oversleep = oversleep;
+    else
+      s_throttle_oversleep -= (s_throttle_oversleep - oversleep) / 32;
+
+    static const Common::Timer::Value min_margin = Common::Timer::ConvertMillisecondsToValue(0.1);
+    static const Common::Timer::Value max_margin = Common::Timer::ConvertMillisecondsToValue(4.0);
+    s_throttle_sleep_margin = std::clamp<Common::Timer::Value>(s_throttle_oversleep + s_throttle_oversleep / 4,
+                                                               min_margin, max_margin);
+  }
+
+  while (Common::Timer::GetCurrentValue() < s_next_frame_time)
+    Threading::Timeslice();
+}
+
+void System::ReportFramePresented(Common::Timer::Value present_time, Common::Timer::Value refresh_interval)
+{
+  if (refresh_interval != 0 &&
+      s_presentation_refresh_interval.exchange(refresh_interval, std::memory_order_relaxed) != refresh_interval)
+  {
+    s_presentation_refresh_interval_changed.store(true, std::memory_order_release);
+  }
+
+  s_presentation_time.store(present_time, std::memory_order_release);
+}
+
+bool System::GetPresentationTiming(Common::Timer::Value* present_time, Common::Timer::Value* refresh_interval)
+{
+  static const Common::Timer::Value max_age = Common::Timer::ConvertSecondsToValue(1.0);
+
+  *present_time = s_presentation_time.load(std::memory_order_acquire);
+  *refresh_interval = s_presentation_refresh_interval.load(std::memory_order_relaxed);
+  return (*present_time != 0 && *refresh_interval != 0 &&
+          (Common::Timer::GetCurrentValue() - *present_time) < max_age);
+}
+
+bool System::GetHostRefreshRate(float* refresh_rate)
+{
+  // The compositor's refresh interval is exact, the window system's mode list is often rounded.
+  const Common::Timer::Value refresh_interval = s_presentation_refresh_interval.load(std::memory_order_relaxed);
+  if (refresh_interval != 0)
+  {
+    *refresh_rate = static_cast<float>(1.0 / Common::Timer::ConvertValueToSeconds(refresh_interval));
+    return true;
+  }
+
+  return g_host_display->GetHostRefreshRate(refresh_rate);
+}
+
+void System::AlignThrottleToPresentation()
+{
+  // When pacing to the host's refresh, pull the frame deadline towards a scanout, so frames start right after one
+  // and have the whole refresh to be rendered in. Without this, the deadline slowly drifts against the compositor,
+  // and every so often a frame misses its refresh. Correct gradually, so a late feedback event can't cause a hitch.
+  Common::Timer::Value present_time, refresh_interval;
+  if (!s_syncing_to_host || !GetPresentationTiming(&present_time, &refresh_interval))
+    return;
+
+  const s64 interval = static_cast<s64>(refresh_interval);
+  s64 phase = (static_cast<s64>(s_next_frame_time) - static_cast<s64>(present_time)) % interval;
+  if (phase < 0)
+    phase += interval;
+  if (phase > (interval / 2))
+    phase -= interval;
+
+  s_next_frame_time = static_cast<Common::Timer::Value>(static_cast<s64>(s_next_frame_time) - (phase / 8));
+}
+
+void System::RunFrames()
+{
+  // If we're running more than this in a single loop... we're in for a bad time.
+  const u32 max_frames_to_run = 2;
   u32 frames_run = 0;
 
   Common::Timer::Value value = Common::Timer::GetCurrentValue();
@@ -2179,6 +2876,23 @@ void System::UpdatePerformanceCounters()
   const float frame_time = static_cast<float>(s_frame_timer.GetTimeMilliseconds());
   s_average_frame_time_accumulator += frame_time;
   s_worst_frame_time_accumulator = std::max(s_worst_frame_time_accumulator, frame_time);
+  AddFrameTimeSample(FrameTimeCounter::Frame, frame_time);
+
+  const double thread_ticks_to_ms = 1000.0 / static_cast<double>(Threading::GetThreadTicksPerSecond());
+  if (s_cpu_thread_handle)
+  {
+    const u64 cpu_time = s_cpu_thread_handle.GetCPUTime();
+    AddFrameTimeSample(FrameTimeCounter::CPUThread,
+                       static_cast<float>(static_cast<double>(cpu_time - s_last_frame_cpu_time) * thread_ticks_to_ms));
+    s_last_frame_cpu_time = cpu_time;
+  }
+  if (const Threading::Thread* sw_thread = g_gpu->GetSWThread(); sw_thread)
+  {
+    const u64 sw_time = sw_thread->GetCPUTime();
+    AddFrameTimeSample(FrameTimeCounter::SWThread,
+                       static_cast<float>(static_cast<double>(sw_time - s_last_frame_sw_time) * thread_ticks_to_ms));
+    s_last_frame_sw_time = sw_time;
+  }
 
   // update fps counter
   const Common::Timer::Value now_ticks = Common::Timer::GetCurrentValue();
@@ -2224,21 +2938,208 @@ void System::UpdatePerformanceCounters()
   s_sw_thread_time = static_cast<float>(static_cast<double>(sw_delta) * time_divider);
 
   s_fps_timer.ResetTo(now_ticks);
+  UpdateFrameTimePercentiles();
 
   if (g_host_display->IsGPUTimingEnabled())
   {
     s_average_gpu_time = s_accumulated_gpu_time / static_cast<float>(std::max(s_presents_since_last_update, 1u));
     s_gpu_usage = s_accumulated_gpu_time / (time * 10.0f);
+    for (u32 i = 0; i < HostDisplay::NUM_GPU_TIMING_SECTIONS; i++)
+    {
+      s_average_gpu_section_times[i] =
+        s_accumulated_gpu_section_times[i] / static_cast<float>(std::max(s_presents_since_last_update, 1u));
+    }
+
+    if (g_settings.display_log_gpu_timings)
+      WriteGPUTimingsLog();
+
+    // Only adjust at normal speed, fast forward would otherwise drop the resolution to the minimum.
+    if (s_presents_since_last_update > 0 && s_target_speed == 1.0f)
+      g_gpu->UpdateDynamicResolution(s_average_gpu_time, 1000.0f / s_throttle_frequency);
   }
   s_accumulated_gpu_time = 0.0f;
+  s_accumulated_gpu_section_times.fill(0.0f);
   s_presents_since_last_update = 0;
+  if (!g_settings.display_log_gpu_timings)
+    CloseGPUTimingsLog();
 
   Log_VerbosePrintf("FPS: %.2f VPS: %.2f CPU: %.2f GPU: %.2f Average: %.2fms Worst: %.2fms", s_fps, s_vps,
                     s_cpu_thread_usage, s_gpu_usage, s_average_frame_time, s_worst_frame_time);
 
+  AddAutoTuneSample();
+
+  PublishPerformanceMetrics(true);
   Host::OnPerformanceCountersUpdated();
 }
 
+void System::PublishPerformanceMetrics(bool running)
+{
+  PerformanceMetrics metrics = {};
+  if (running)
+  {
+    CPU::CodeCache::CodeBufferStatistics code_stats;
+    CPU::CodeCache::GetCodeBufferStatistics(&code_stats);
+    const AudioStream* stream = SPU::GetOutputStream();
+
+    metrics.fps = s_fps;
+    metrics.vps = s_vps;
+    metrics.speed = s_speed;
+    metrics.average_frame_time = s_average_frame_time;
+    metrics.worst_frame_time = s_worst_frame_time;
+    metrics.cpu_thread_usage = s_cpu_thread_usage;
+    metrics.sw_thread_usage = s_sw_thread_usage;
+    metrics.gpu_usage = s_gpu_usage;
+    metrics.frame_number = s_frame_number;
+    metrics.recompile_count = code_stats.recompile_count;
+    metrics.flush_count = code_stats.flush_count;
+    metrics.audio_underrun_count = stream ? stream->GetUnderrunCount() : 0;
+    metrics.running = true;
+  }
+
+  const u32 sequence = s_performance_metrics_sequence.load(std::memory_order_relaxed);
+  s_performance_metrics_sequence.store(sequence + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  std::memcpy(&s_performance_metrics, &metrics, sizeof(metrics));
+  s_performance_metrics_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+System::PerformanceMetrics System::GetPerformanceMetrics()
+{
+  PerformanceMetrics metrics;
+  for (;;)
+  {
+    const u32 sequence = s_performance_metrics_sequence.load(std::memory_order_acquire);
+    if (sequence & 1u)
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    std::memcpy(&metrics, &s_performance_metrics, sizeof(metrics));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (s_performance_metrics_sequence.load(std::memory_order_relaxed) == sequence)
+      return metrics;
+  }
+}
+
+void System::WriteGPUTimingsLog()
+{
+  if (!s_gpu_timings_log)
+  {
+    const std::string path =
+      Path::Combine(EmuFolders::Dumps, fmt::format("gpu_timings_{}.csv", GetTimestampStringForFileName()));
+    s_gpu_timings_log = FileSystem::OpenCFile(path.c_str(), "wb");
+    if (!s_gpu_timings_log)
+    {
+      Log_ErrorPrintf("Failed to open GPU timings log '%s', disabling.", path.c_str());
+      g_settings.display_log_gpu_timings = false;
+      return;
+    }
+
+    Log_InfoPrintf("Writing GPU timings to '%s'", path.c_str());
+    std::fprintf(s_gpu_timings_log, "frame,fps,gpu_time_ms");
+    for (u32 i = 0; i < HostDisplay::NUM_GPU_TIMING_SECTIONS; i++)
+      std::fprintf(s_gpu_timings_log, ",%s", HostDisplay::GetGPUTimingSectionName(i));
+    std::fputc('\n', s_gpu_timings_log);
+  }
+
+  // times are per presented frame, averaged over the last update period
+  std::fprintf(s_gpu_timings_log, "%u,%.2f,%.4f", s_frame_number, s_fps, s_average_gpu_time);
+  for (u32 i = 0; i < HostDisplay::NUM_GPU_TIMING_SECTIONS; i++)
+    std::fprintf(s_gpu_timings_log, ",%.4f", s_average_gpu_section_times[i]);
+  std::fputc('\n', s_gpu_timings_log);
+  std::fflush(s_gpu_timings_log);
+}
+
+void System::CloseGPUTimingsLog()
+{
+  if (!s_gpu_timings_log)
+    return;
+
+  std::fclose(s_gpu_timings_log);
+  s_gpu_timings_log = nullptr;
+}
+
+void System::ResetFrameTimeStatistics()
+{
+  for (FrameTimeCounterState& state : s_frame_time_counters)
+  {
+    state.history.fill(0.0f);
+    state.history_pos = 0;
+    state.history_count = 0;
+    state.histogram.fill(0);
+    state.histogram_total = 0;
+    state.percentiles = {};
+  }
+
+  s_last_frame_cpu_time = 0;
+  s_last_frame_sw_time = 0;
+}
+
+void System::AddFrameTimeSample(FrameTimeCounter counter, float time_ms)
+{
+  FrameTimeCounterState& state = s_frame_time_counters[static_cast<size_t>(counter)];
+  state.history[state.history_pos] = time_ms;
+  state.history_pos = (state.history_pos + 1) % FRAME_TIME_HISTORY_SIZE;
+  state.history_count = std::min(state.history_count + 1, FRAME_TIME_HISTORY_SIZE);
+
+  const u32 bucket = static_cast<u32>(std::max(time_ms, 0.0f) / FRAME_TIME_HISTOGRAM_BUCKET_SIZE);
+  state.histogram[std::min(bucket, FRAME_TIME_HISTOGRAM_BUCKETS)]++;
+  state.histogram_total++;
+}
+
+void System::UpdateFrameTimePercentiles()
+{
+  FrameTimeHistory sorted;
+  for (FrameTimeCounterState& state : s_frame_time_counters)
+  {
+    if (state.history_count == 0)
+      continue;
+
+    const u32 count = state.history_count;
+    std::copy_n(state.history.begin(), count, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + count);
+    state.percentiles.p50 = sorted[(count - 1) * 50 / 100];
+    state.percentiles.p95 = sorted[(count - 1) * 95 / 100];
+    state.percentiles.p99 = sorted[(count - 1) * 99 / 100];
+  }
+}
+
+void System::LogFrameTimeStatistics()
+{
+  static constexpr std::array<const char*, static_cast<size_t>(FrameTimeCounter::Count)> names = {
+    {"Frame", "CPU Thread", "SW Thread", "GPU", "Input Read", "Input Latency"}};
+
+  for (size_t i = 0; i < s_frame_time_counters.size(); i++)
+  {
+    const FrameTimeCounterState& state = s_frame_time_counters[i];
+    if (state.histogram_total == 0)
+      continue;
+
+    // Upper edge of the bucket the percentile lands in.
+    float percentiles[3] = {};
+    static constexpr u32 percentile_values[3] = {50, 95, 99};
+    for (u32 j = 0; j < std::size(percentiles); j++)
+    {
+      const u64 target = (state.histogram_total * percentile_values[j] + 99) / 100;
+      u64 seen = 0;
+      u32 bucket = 0;
+      for (; bucket < FRAME_TIME_HISTOGRAM_BUCKETS; bucket++)
+      {
+        seen += state.histogram[bucket];
+        if (seen >= target)
+          break;
+      }
+      percentiles[j] = static_cast<float>(bucket + 1) * FRAME_TIME_HISTOGRAM_BUCKET_SIZE;
+    }
+
+    Log_InfoPrintf("%s time over %" PRIu64 " samples: p50 %.1fms p95 %.1fms p99 %.1fms (%u over %.0fms)", names[i],
+                   state.histogram_total, percentiles[0], percentiles[1], percentiles[2],
+                   state.histogram[FRAME_TIME_HISTOGRAM_BUCKETS],
+                   FRAME_TIME_HISTOGRAM_BUCKETS * FRAME_TIME_HISTOGRAM_BUCKET_SIZE);
+  }
+}
+
 void System::ResetPerformanceCounters()
 {
   s_last_frame_number = s_frame_number;
@@ -2249,11 +3150,186 @@ void System::ResetPerformanceCounters()
     s_last_sw_time = sw_thread->GetCPUTime();
   else
     s_last_sw_time = 0;
+  s_last_frame_cpu_time = s_last_cpu_time;
+  s_last_frame_sw_time = s_last_sw_time;
 
   s_average_frame_time_accumulator = 0.0f;
   s_worst_frame_time_accumulator = 0.0f;
   s_fps_timer.Reset();
   ResetThrottler();
+
+  // don't count time spent paused or loading towards a tracked input
+  s_input_latency_receive_time = 0;
+  s_input_latency_read_time = 0;
+
+  // the first samples after a settings change include pipeline compilation
+  s_auto_tune_warmup = AUTO_TUNE_WARMUP_SAMPLES;
+}
+
+void System::LoadAutoTuneHistory()
+{
+  s_auto_tune_history = {};
+  s_auto_tune_session_samples = {};
+  s_auto_tune_serial = s_running_game_serial;
+  s_auto_tune_renderer = g_settings.gpu_renderer;
+  s_auto_tune_applied_scale = 0;
+  if (s_auto_tune_serial.empty())
+    return;
+
+  INISettingsInterface si(GetGameSettingsPath(s_auto_tune_serial));
+  if (!si.Load())
+    return;
+
+  const std::string section(fmt::format("AutoTune{}", Settings::GetRendererName(s_auto_tune_renderer)));
+  for (u32 scale = 1; scale < static_cast<u32>(s_auto_tune_history.size()); scale++)
+  {
+    AutoTuneLevel& level = s_auto_tune_history[scale];
+    level.samples = si.GetUIntValue(section.c_str(), fmt::format("Scale{}Samples", scale).c_str(), 0u);
+    level.full_speed_samples =
+      std::min(si.GetUIntValue(section.c_str(), fmt::format("Scale{}FullSpeedSamples", scale).c_str(), 0u),
+               level.samples);
+  }
+}
+
+void System::SaveAutoTuneHistory()
+{
+  if (s_auto_tune_serial.empty() ||
+      std::none_of(s_auto_tune_session_samples.begin(), s_auto_tune_session_samples.end(),
+                   [](const AutoTuneLevel& level) { return (level.samples > 0); }))
+  {
+    return;
+  }
+
+  // re-read the file, it may have been changed since the history was loaded
+  INISettingsInterface si(GetGameSettingsPath(s_auto_tune_serial));
+  si.Load();
+
+  const std::string section(fmt::format("AutoTune{}", Settings::GetRendererName(s_auto_tune_renderer)));
+  for (u32 scale = 1; scale < static_cast<u32>(s_auto_tune_session_samples.size()); scale++)
+  {
+    const AutoTuneLevel& level = s_auto_tune_session_samples[scale];
+    if (level.samples == 0)
+      continue;
+
+    const std::string samples_key(fmt::format("Scale{}Samples", scale));
+    const std::string full_speed_key(fmt::format("Scale{}FullSpeedSamples", scale));
+    si.SetUIntValue(section.c_str(), samples_key.c_str(),
+                    si.GetUIntValue(section.c_str(), samples_key.c_str(), 0u) + level.samples);
+    si.SetUIntValue(section.c_str(), full_speed_key.c_str(),
+                    si.GetUIntValue(section.c_str(), full_speed_key.c_str(), 0u) + level.full_speed_samples);
+  }
+
+  if (!si.Save())
+    Log_ErrorPrintf("Failed to save performance history to '%s'", si.GetFileName().c_str());
+
+  s_auto_tune_session_samples = {};
+}
+
+void System::ApplyAutoTuneSettings(bool display_osd_messages)
+{
+  if (s_auto_tune_serial != s_running_game_serial || s_auto_tune_renderer != g_settings.gpu_renderer)
+  {
+    SaveAutoTuneHistory();
+    LoadAutoTuneHistory();
+  }
+
+  // The configured scale is the upper bound. Automatic scale and dynamic resolution pick the scale themselves.
+  const u32 configured_scale = g_settings.gpu_resolution_scale;
+  if (!g_settings.auto_tune_performance || s_auto_tune_serial.empty() ||
+      g_settings.gpu_renderer == GPURenderer::Software || g_settings.gpu_dynamic_resolution || configured_scale <= 1)
+  {
+    return;
+  }
+
+  // Step down past every scale which has enough history, and fell short of full speed too often. A scale without
+  // enough history is tried, so each launch narrows it down further. Only previous sessions are considered, so the
+  // scale doesn't change while playing.
+  u32 scale = std::min(configured_scale, static_cast<u32>(s_auto_tune_history.size() - 1));
+  for (; scale > 1; scale--)
+  {
+    const AutoTuneLevel& level = s_auto_tune_history[scale];
+    if (level.samples < AUTO_TUNE_MIN_SAMPLES ||
+        (static_cast<u64>(level.full_speed_samples) * 100) >=
+          (static_cast<u64>(level.samples) * AUTO_TUNE_FULL_SPEED_PERCENT))
+    {
+      break;
+    }
+  }
+
+  if (scale != configured_scale && scale != s_auto_tune_applied_scale && display_osd_messages)
+  {
+    Host::AddKeyedFormattedOSDMessage(
+      "AutoTunePerformance", 5.0f,
+      Host::TranslateString("OSDMessage", "Resolution scale lowered to %ux, %ux did not hold full speed."), scale,
+      scale + 1);
+  }
+
+  g_settings.gpu_resolution_scale = scale;
+  s_auto_tune_applied_scale = scale;
+}
+
+void System::AddAutoTuneSample()
+{
+  if (!g_settings.auto_tune_performance || s_auto_tune_serial.empty() ||
+      s_auto_tune_renderer != g_settings.gpu_renderer || !g_gpu->IsHardwareRenderer() ||
+      g_settings.gpu_dynamic_resolution || !s_throttler_enabled || s_target_speed != 1.0f)
+  {
+    return;
+  }
+
+  if (s_auto_tune_warmup > 0)
+  {
+    s_auto_tune_warmup--;
+    return;
+  }
+
+  const u32 scale = g_settings.gpu_resolution_scale;
+  if (scale == 0 || scale >= static_cast<u32>(s_auto_tune_session_samples.size()))
+    return;
+
+  AutoTuneLevel& level = s_auto_tune_session_samples[scale];
+  level.samples++;
+  level.full_speed_samples += BoolToUInt32(s_speed >= AUTO_TUNE_FULL_SPEED_THRESHOLD);
+}
+
+void System::OnInputLatencyEventReceived()
+{
+  if (s_input_latency_receive_time != 0 || !IsRunning())
+    return;
+
+  s_input_latency_receive_time = Common::Timer::GetCurrentValue();
+}
+
+void System::OnInputLatencyControllerRead()
+{
+  if (s_input_latency_receive_time == 0 || s_input_latency_read_time != 0)
+    return;
+
+  s_input_latency_read_time = Common::Timer::GetCurrentValue();
+  s_input_latency_read_frame = s_internal_frame_number;
+}
+
+bool System::IsInputLatencyPresentPending()
+{
+  return (s_input_latency_read_time != 0 && s_internal_frame_number != s_input_latency_read_frame);
+}
+
+void System::UpdateInputLatency()
+{
+  if (!IsInputLatencyPresentPending())
+    return;
+
+  const Common::Timer::Value now = Common::Timer::GetCurrentValue();
+  const Common::Timer::Value read_ticks = s_input_latency_read_time - s_input_latency_receive_time;
+  const Common::Timer::Value total_ticks = now - s_input_latency_receive_time;
+  const float read_ms = static_cast<float>(Common::Timer::ConvertValueToMilliseconds(read_ticks));
+  const float total_ms = static_cast<float>(Common::Timer::ConvertValueToMilliseconds(total_ticks));
+  AddFrameTimeSample(FrameTimeCounter::InputRead, read_ms);
+  AddFrameTimeSample(FrameTimeCounter::InputLatency, total_ms);
+  Log_DevPrintf("Input latency: %.2fms to controller read, %.2fms to present", read_ms, total_ms);
+
+  s_input_latency_receive_time = 0;
+  s_input_latency_read_time = 0;
 }
 
 void System::UpdateSpeedLimiterState()
@@ -2265,12 +3341,13 @@ void System::UpdateSpeedLimiterState()
   s_throttler_enabled = (s_target_speed != 0.0f);
   s_display_all_frames = !s_throttler_enabled || g_settings.display_all_frames;
 
+  // With VRR pacing the display follows us, so run at the console's exact rate instead of the host's.
   s_syncing_to_host = false;
-  if (g_settings.sync_to_host_refresh_rate && (g_settings.audio_stretch_mode != AudioStretchMode::Off) &&
-      s_target_speed == 1.0f && IsValid())
+  if (g_settings.sync_to_host_refresh_rate && !g_settings.display_vrr_frame_pacing &&
+      (g_settings.audio_stretch_mode != AudioStretchMode::Off) && s_target_speed == 1.0f && IsValid())
   {
     float host_refresh_rate;
-    if (g_host_display->GetHostRefreshRate(&host_refresh_rate))
+    if (GetHostRefreshRate(&host_refresh_rate))
     {
       const float ratio = host_refresh_rate / System::GetThrottleFrequency();
       s_syncing_to_host = (ratio >= 0.95f && ratio <= 1.05f);
@@ -2297,10 +3374,18 @@ void System::UpdateSpeedLimiterState()
     stream->SetOutputVolume(GetAudioOutputVolume());
 
     // Adjust nominal rate when resampling, or syncing to host.
-    const bool rate_adjust =
-      (s_syncing_to_host || g_settings.audio_stretch_mode == AudioStretchMode::Resample) && s_target_speed > 0.0f;
+    const bool rate_adjust = (s_syncing_to_host || g_settings.audio_stretch_mode == AudioStretchMode::Resample ||
+                              g_settings.audio_stretch_mode == AudioStretchMode::RateControl) &&
+                             s_target_speed > 0.0f;
     stream->SetNominalRate(rate_adjust ? s_target_speed : 1.0f);
 
+    // Well above full speed, keep only as many chunks as play back in real time instead of stretching them.
+    static constexpr float DECIMATION_MIN_SPEED = 1.5f;
+    u32 decimation = 1;
+    if (g_settings.audio_fast_forward_decimation && (s_target_speed == 0.0f || s_target_speed >= DECIMATION_MIN_SPEED))
+      decimation = static_cast<u32>(std::lround(s_target_speed));
+    stream->SetChunkDecimation(decimation);
+
     if (old_target_speed < s_target_speed)
       stream->UpdateTargetTempo(s_target_speed);
 
@@ -2328,11 +3413,15 @@ void System::UpdateDisplaySync()
 
   g_host_display->SetDisplayMaxFPS(max_display_fps);
   g_host_display->SetVSync(video_sync_enabled);
+
+  // Throttling to host vsync relies on every frame being presented.
+  g_host_display->SetSkipDuplicateFrames(g_settings.display_skip_duplicate_frames && s_throttler_enabled);
 }
 
 bool System::ShouldUseVSync()
 {
-  return g_settings.video_sync_enabled && !IsRunningAtNonStandardSpeed();
+  // VRR displays refresh when we present, so waiting for vblank would only add latency, and they don't tear.
+  return g_settings.video_sync_enabled && !g_settings.display_vrr_frame_pacing && !IsRunningAtNonStandardSpeed();
 }
 
 bool System::IsFastForwardEnabled()
@@ -2823,12 +3912,39 @@ void System::UpdateMultitaps()
   }
 }
 
+void System::QueueDumpWrite(std::string filename, const char* description, std::function<bool(const char*)> write)
+{
+  // don't let repeated dumps to slow storage pile up snapshots in memory
+  if (s_queued_dump_writes.fetch_add(1, std::memory_order_acq_rel) >= MAX_QUEUED_DUMP_WRITES)
+    FlushDumpWrites();
+
+  Threading::ThreadPool::GetShared().Submit(
+    [filename = std::move(filename), description, write = std::move(write)]() {
+      if (write(filename.c_str()))
+        Host::AddOSDMessage(fmt::format("{} dumped to '{}'", description, filename), 10.0f);
+      else
+        Host::ReportErrorAsync("Error", fmt::format("Failed to dump {} to '{}'", description, filename));
+
+      s_queued_dump_writes.fetch_sub(1, std::memory_order_acq_rel);
+    },
+    Threading::ThreadPool::Priority::Low, &s_dump_writes);
+}
+
+void System::FlushDumpWrites()
+{
+  s_dump_writes.Wait(Threading::ThreadPool::GetShared());
+}
+
 bool System::DumpRAM(const char* filename)
 {
   if (!IsValid())
     return false;
 
-  return FileSystem::WriteBinaryFile(filename, Bus::g_ram, Bus::g_ram_size);
+  std::vector<u8> ram(Bus::g_ram, Bus::g_ram + Bus::g_ram_size);
+  QueueDumpWrite(filename, "RAM", [ram = std::move(ram)](const char* path) {
+    return FileSystem::WriteBinaryFile(path, ram.data(), ram.size());
+  });
+  return true;
 }
 
 bool System::DumpVRAM(const char* filename)
@@ -2836,11 +3952,14 @@ bool System::DumpVRAM(const char* filename)
   if (!IsValid())
     return false;
 
+  std::vector<u16> vram(VRAM_WIDTH * VRAM_HEIGHT);
   g_gpu->RestoreGraphicsAPIState();
-  const bool result = g_gpu->DumpVRAMToFile(filename);
+  g_gpu->CopyVRAM(vram.data());
   g_gpu->ResetGraphicsAPIState();
 
-  return result;
+  QueueDumpWrite(filename, "VRAM",
+                 [vram = std::move(vram)](const char* path) { return GPU::DumpVRAMToFile(path, vram.data()); });
+  return true;
 }
 
 bool System::DumpSPURAM(const char* filename)
@@ -2848,7 +3967,11 @@ bool System::DumpSPURAM(const char* filename)
   if (!IsValid())
     return false;
 
-  return FileSystem::WriteBinaryFile(filename, SPU::GetRAM().data(), SPU::RAM_SIZE);
+  std::vector<u8> spu_ram(SPU::GetRAM().begin(), SPU::GetRAM().end());
+  QueueDumpWrite(filename, "SPU RAM", [spu_ram = std::move(spu_ram)](const char* path) {
+    return FileSystem::WriteBinaryFile(path, spu_ram.data(), spu_ram.size());
+  });
+  return true;
 }
 
 bool System::HasMedia()
@@ -2906,6 +4029,8 @@ void System::UpdateRunningGame(const char* path, CDImage* image, bool booting)
   if (!booting && s_running_game_path == path)
     return;
 
+  SaveAutoTuneHistory();
+
   s_running_game_path.clear();
   s_running_game_serial.clear();
   s_running_game_title.clear();
@@ -3097,11 +4222,13 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
 {
   if (IsValid() && (g_settings.gpu_renderer != old_settings.gpu_renderer ||
                     g_settings.gpu_use_debug_device != old_settings.gpu_use_debug_device ||
-                    g_settings.gpu_threaded_presentation != old_settings.gpu_threaded_presentation))
+                    g_settings.gpu_threaded_presentation != old_settings.gpu_threaded_presentation ||
+                    g_settings.gpu_frames_in_flight != old_settings.gpu_frames_in_flight))
   {
-    // if debug device/threaded presentation change, we need to recreate the whole display
+    // if debug device/threaded presentation/frames in flight change, we need to recreate the whole display
     const bool recreate_display = (g_settings.gpu_use_debug_device != old_settings.gpu_use_debug_device ||
-                                   g_settings.gpu_threaded_presentation != old_settings.gpu_threaded_presentation);
+                                   g_settings.gpu_threaded_presentation != old_settings.gpu_threaded_presentation ||
+                                   g_settings.gpu_frames_in_flight != old_settings.gpu_frames_in_flight);
 
     Host::AddFormattedOSDMessage(5.0f, Host::TranslateString("OSDMessage", "Switching to %s%s GPU renderer."),
                                  Settings::GetRendererName(g_settings.gpu_renderer),
@@ -3113,6 +4240,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
   {
     ClearMemorySaveStates();
 
+    // filtering, scaling and so on can change without the display texture doing so
+    g_host_display->InvalidatePresentedFrame();
+
     if (g_settings.cpu_overclock_active != old_settings.cpu_overclock_active ||
         (g_settings.cpu_overclock_active &&
          (g_settings.cpu_overclock_numerator != old_settings.cpu_overclock_numerator ||
@@ -3133,6 +4263,8 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     }
     if (g_settings.audio_stretch_mode != old_settings.audio_stretch_mode)
       SPU::GetOutputStream()->SetStretchMode(g_settings.audio_stretch_mode);
+    if (g_settings.audio_mix_on_thread != old_settings.audio_mix_on_thread)
+      SPU::UpdateSettings();
     if (g_settings.audio_buffer_ms != old_settings.audio_buffer_ms ||
         g_settings.audio_output_latency_ms != old_settings.audio_output_latency_ms ||
         g_settings.audio_stretch_mode != old_settings.audio_stretch_mode)
@@ -3158,13 +4290,18 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
-         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache))
+         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+         g_settings.cpu_recompiler_async_compilation != old_settings.cpu_recompiler_async_compilation ||
+         g_settings.cpu_recompiler_trace_formation != old_settings.cpu_recompiler_trace_formation ||
+         g_settings.cpu_recompiler_hot_code_layout != old_settings.cpu_recompiler_hot_code_layout ||
+         g_settings.cpu_recompiler_perf_map != old_settings.cpu_recompiler_perf_map))
     {
       Host::AddOSDMessage(Host::TranslateStdString("OSDMessage", "Recompiler options changed, flushing all blocks."),
                           5.0f);
 
-      // changing memory exceptions can re-enable fastmem
-      if (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions)
+      // changing memory exceptions can re-enable fastmem, async compilation needs the compile thread started
+      if (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
+          g_settings.cpu_recompiler_async_compilation != old_settings.cpu_recompiler_async_compilation)
         CPU::CodeCache::Reinitialize();
       else
         CPU::CodeCache::Flush();
@@ -3173,13 +4310,29 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         CPU::ClearICache();
     }
 
+    // idle loops and the BIOS call stub are detected when blocks are compiled
+    if (g_settings.cpu_execution_mode != CPUExecutionMode::Interpreter &&
+        (g_settings.cpu_skip_idle_loops != old_settings.cpu_skip_idle_loops ||
+         g_settings.cpu_hle_bios_memory_routines != old_settings.cpu_hle_bios_memory_routines))
+    {
+      CPU::CodeCache::Flush();
+    }
+
     SPU::GetOutputStream()->SetOutputVolume(GetAudioOutputVolume());
 
     if (g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
         g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
         g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
         g_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        g_settings.gpu_sw_worker_threads != old_settings.gpu_sw_worker_threads ||
+        g_settings.gpu_sw_tile_binning != old_settings.gpu_sw_tile_binning ||
         g_settings.gpu_use_software_renderer_for_readbacks != old_settings.gpu_use_software_renderer_for_readbacks ||
+        g_settings.gpu_sw_readback_region_tracking != old_settings.gpu_sw_readback_region_tracking ||
+        g_settings.gpu_decoded_texture_cache != old_settings.gpu_decoded_texture_cache ||
+        g_settings.gpu_texture_mode_batching != old_settings.gpu_texture_mode_batching ||
+        g_settings.gpu_dynamic_resolution != old_settings.gpu_dynamic_resolution ||
+        g_settings.gpu_dynamic_resolution_min_scale != old_settings.gpu_dynamic_resolution_min_scale ||
+        g_settings.display_log_gpu_timings != old_settings.display_log_gpu_timings ||
         g_settings.gpu_fifo_size != old_settings.gpu_fifo_size ||
         g_settings.gpu_max_run_ahead != old_settings.gpu_max_run_ahead ||
         g_settings.gpu_true_color != old_settings.gpu_true_color ||
@@ -3240,6 +4393,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     if (g_settings.cdrom_readahead_sectors != old_settings.cdrom_readahead_sectors)
       g_cdrom.SetReadaheadSectors(g_settings.cdrom_readahead_sectors);
 
+    if (g_settings.mdec_decode_on_thread != old_settings.mdec_decode_on_thread)
+      g_mdec.UpdateSettings();
+
     if (g_settings.memory_card_types != old_settings.memory_card_types ||
       g_settings.memory_card_paths != old_settings.memory_card_paths ||
       (g_settings.memory_card_use_playlist_title != old_settings.memory_card_use_playlist_title &&
@@ -3259,7 +4415,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
 
     if (g_settings.texture_replacements.enable_vram_write_replacements !=
           old_settings.texture_replacements.enable_vram_write_replacements ||
-        g_settings.texture_replacements.preload_textures != old_settings.texture_replacements.preload_textures)
+        g_settings.texture_replacements.preload_textures != old_settings.texture_replacements.preload_textures ||
+        g_settings.texture_replacements.async_loading != old_settings.texture_replacements.async_loading ||
+        g_settings.texture_replacements.max_cache_size_mb != old_settings.texture_replacements.max_cache_size_mb)
     {
       g_texture_replacements.Reload();
     }
@@ -3272,8 +4430,11 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         g_settings.increase_timer_resolution != old_settings.increase_timer_resolution ||
         g_settings.emulation_speed != old_settings.emulation_speed ||
         g_settings.fast_forward_speed != old_settings.fast_forward_speed ||
+        g_settings.audio_fast_forward_decimation != old_settings.audio_fast_forward_decimation ||
         g_settings.display_max_fps != old_settings.display_max_fps ||
         g_settings.display_all_frames != old_settings.display_all_frames ||
+        g_settings.display_vrr_frame_pacing != old_settings.display_vrr_frame_pacing ||
+        g_settings.display_skip_duplicate_frames != old_settings.display_skip_duplicate_frames ||
         g_settings.sync_to_host_refresh_rate != old_settings.sync_to_host_refresh_rate)
     {
       UpdateSpeedLimiterState();
@@ -3330,7 +4491,10 @@ void System::CalculateRewindMemoryUsage(u32 num_saves, u64* ram_usage, u64* vram
 void System::ClearMemorySaveStates()
 {
   s_rewind_states.clear();
+  s_rewind_delta_buffer = {};
+  s_rewind_spare_stream.reset();
   s_runahead_states.clear();
+  s_runahead_free_states.clear();
 }
 
 void System::UpdateMemorySaveStateSettings()
@@ -3365,13 +4529,12 @@ void System::UpdateMemorySaveStateSettings()
     Log_InfoPrintf("Runahead is active with %u frames", s_runahead_frames);
 }
 
-bool System::LoadMemoryState(const MemorySaveState& mss)
+bool System::LoadMemoryState(const MemorySaveState& mss, bool update_display /* = true */)
 {
-  mss.state_stream->SeekAbsolute(0);
-
-  StateWrapper sw(mss.state_stream.get(), StateWrapper::Mode::Read, SAVE_STATE_VERSION);
+  StateWrapper sw(mss.state_stream->GetMemoryPointer(), static_cast<size_t>(mss.state_stream->GetSize()),
+                  StateWrapper::Mode::Read, SAVE_STATE_VERSION);
   GPUTexture* host_texture = mss.vram_texture.get();
-  if (!DoState(sw, &host_texture, true, true))
+  if (!DoState(sw, host_texture ? &host_texture : nullptr, update_display, true))
   {
     Host::ReportErrorAsync("Error", "Failed to load memory save state, resetting.");
     InternalReset();
@@ -3381,26 +4544,180 @@ bool System::LoadMemoryState(const MemorySaveState& mss)
   return true;
 }
 
-bool System::SaveMemoryState(MemorySaveState* mss)
+bool System::SaveMemoryState(MemorySaveState* mss, bool host_vram /* = true */)
 {
+  // serialize straight into the stream's memory, the state can't exceed MAX_SAVE_STATE_SIZE
   if (!mss->state_stream)
     mss->state_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, MAX_SAVE_STATE_SIZE);
-  else
-    mss->state_stream->SeekAbsolute(0);
+  else if (mss->state_stream->GetMemorySize() < MAX_SAVE_STATE_SIZE)
+    mss->state_stream->ResizeMemory(MAX_SAVE_STATE_SIZE);
 
   GPUTexture* host_texture = mss->vram_texture.release();
-  StateWrapper sw(mss->state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
-  if (!DoState(sw, &host_texture, false, true))
+  StateWrapper sw(mss->state_stream->GetMemoryPointer(), MAX_SAVE_STATE_SIZE, StateWrapper::Mode::Write,
+                  SAVE_STATE_VERSION);
+  if (!DoState(sw, host_vram ? &host_texture : nullptr, false, true))
   {
     Log_ErrorPrint("Failed to create rewind state.");
     delete host_texture;
     return false;
   }
 
+  mss->state_stream->Resize(static_cast<u32>(sw.GetPosition()));
+  mss->state_stream->SeekAbsolute(sw.GetPosition());
   mss->vram_texture.reset(host_texture);
   return true;
 }
 
+void System::StartBootSnapshot(const BIOS::Image& image)
+{
+#ifdef WITH_CHEEVOS
+  // hardcore mode has to see the BIOS run
+  if (Achievements::ChallengeModeActive())
+    return;
+#endif
+
+  std::string path(Path::Combine(EmuFolders::Cache,
+                                 fmt::format("bootsnapshot_{}_{}.bin", BIOS::GetImageHash(image).ToString(),
+                                             Settings::GetConsoleRegionName(s_region))));
+  if (LoadBootSnapshot(path))
+    return;
+
+  // runahead can reach the shell in a frame which is then rolled back
+  if (s_runahead_frames > 0)
+    return;
+
+  s_boot_snapshot_path = std::move(path);
+  CPU::AddBreakpointWithCallback(BOOT_SNAPSHOT_SHELL_ENTRY, &OnBootSnapshotShellEntry);
+}
+
+bool System::LoadBootSnapshot(const std::string& path)
+{
+  std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(path.c_str()));
+  if (!data.has_value())
+    return false;
+
+  BootSnapshotHeader header;
+  if (data->size() >= sizeof(header))
+    std::memcpy(&header, data->data(), sizeof(header));
+  if (data->size() < sizeof(header) || header.magic != BOOT_SNAPSHOT_MAGIC ||
+      header.version != BOOT_SNAPSHOT_VERSION || header.state_version != SAVE_STATE_VERSION ||
+      header.ram_size != Bus::g_ram_size ||
+      header.overclock_numerator != (g_settings.cpu_overclock_active ? g_settings.cpu_overclock_numerator : 1u) ||
+      header.overclock_denominator != (g_settings.cpu_overclock_active ? g_settings.cpu_overclock_denominator : 1u) ||
+      header.multitap_mode != static_cast<u32>(g_settings.multitap_mode) || header.state_size == 0 ||
+      header.state_size > MAX_SAVE_STATE_SIZE)
+  {
+    Log_WarningPrintf("Boot snapshot '%s' is invalid or from different settings, discarding", path.c_str());
+    FileSystem::DeleteFile(path.c_str());
+    return false;
+  }
+
+  MemorySaveState mss;
+  mss.state_stream = std::make_unique<GrowableMemoryByteStream>(nullptr, header.state_size);
+  mss.state_stream->Resize(header.state_size);
+  if (!ByteStream::DecompressZstd(data->data() + sizeof(header), static_cast<u32>(data->size() - sizeof(header)),
+                                  mss.state_stream->GetMemoryPointer(), header.state_size))
+  {
+    Log_WarningPrintf("Boot snapshot '%s' is corrupted, discarding", path.c_str());
+    FileSystem::DeleteFile(path.c_str());
+    return false;
+  }
+
+  // the snapshot is taken without devices, the user's controllers and cards are plugged back in afterwards
+  PadDevices devices;
+  DetachPadDevices(&devices);
+  const bool loaded = LoadMemoryState(mss);
+  ReattachPadDevices(&devices);
+  if (!loaded)
+  {
+    FileSystem::DeleteFile(path.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("Restored boot snapshot from '%s'", path.c_str());
+  return true;
+}
+
+void System::SaveBootSnapshot()
+{
+  const std::string path(std::move(s_boot_snapshot_path));
+  s_boot_snapshot_path = {};
+  s_boot_snapshot_reached = false;
+
+  // anything which could have made the state depend on the game or the user's setup rules it out
+  if (s_runahead_frames > 0 || (s_cheat_list && s_cheat_list->GetEnabledCodeCount() > 0) ||
+      g_pad.IsTransmitting() || g_cdrom.HasReceivedCommands())
+  {
+    Log_WarningPrintf("Not saving boot snapshot, the state at shell entry isn't independent of the game.");
+    return;
+  }
+
+  // VRAM goes in the stream so the snapshot can be loaded with any renderer
+  PadDevices devices;
+  DetachPadDevices(&devices);
+  MemorySaveState mss;
+  const bool saved = SaveMemoryState(&mss, false);
+  ReattachPadDevices(&devices);
+  if (!saved)
+    return;
+
+  BootSnapshotHeader header;
+  header.magic = BOOT_SNAPSHOT_MAGIC;
+  header.version = BOOT_SNAPSHOT_VERSION;
+  header.state_version = SAVE_STATE_VERSION;
+  header.ram_size = Bus::g_ram_size;
+  header.overclock_numerator = g_settings.cpu_overclock_active ? g_settings.cpu_overclock_numerator : 1u;
+  header.overclock_denominator = g_settings.cpu_overclock_active ? g_settings.cpu_overclock_denominator : 1u;
+  header.multitap_mode = static_cast<u32>(g_settings.multitap_mode);
+  header.state_size = static_cast<u32>(mss.state_stream->GetSize());
+
+  std::vector<u8> compressed;
+  if (!ByteStream::CompressZstd(mss.state_stream->GetMemoryPointer(), header.state_size, 0, &compressed))
+    return;
+
+  std::vector<u8> data(sizeof(header) + compressed.size());
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::memcpy(data.data() + sizeof(header), compressed.data(), compressed.size());
+
+  // write to a temporary first, so a crash can't leave a truncated snapshot behind
+  const std::string temp_path(path + ".tmp");
+  if (!FileSystem::WriteBinaryFile(temp_path.c_str(), data.data(), data.size()) ||
+      !FileSystem::RenamePath(temp_path.c_str(), path.c_str()))
+  {
+    Log_ErrorPrintf("Failed to write boot snapshot to '%s'", path.c_str());
+    FileSystem::DeleteFile(temp_path.c_str());
+    return;
+  }
+
+  Log_InfoPrintf("Saved boot snapshot to '%s' (%zu bytes)", path.c_str(), data.size());
+}
+
+bool System::OnBootSnapshotShellEntry(VirtualMemoryAddress address)
+{
+  // stop before the shell runs, the snapshot is saved once we're back out of the frame
+  s_boot_snapshot_reached = !s_boot_snapshot_path.empty();
+  CPU::ForceDispatcherExit();
+  return false;
+}
+
+void System::DetachPadDevices(PadDevices* devices)
+{
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    devices->controllers[i] = g_pad.RemoveController(i);
+    devices->memory_cards[i] = g_pad.RemoveMemoryCard(i);
+  }
+}
+
+void System::ReattachPadDevices(PadDevices* devices)
+{
+  for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
+  {
+    g_pad.SetController(i, std::move(devices->controllers[i]));
+    g_pad.SetMemoryCard(i, std::move(devices->memory_cards[i]));
+  }
+}
+
 bool System::SaveRewindState()
 {
 #ifdef PROFILE_MEMORY_SAVE_STATES
@@ -3416,24 +4733,157 @@ bool System::SaveRewindState()
     s_rewind_states.pop_front();
   }
 
+  // the recycled slot's delta storage is handed to the state we're about to encode, so neither the stream nor the
+  // delta buffers hit the allocator once the ring is full
+  std::vector<u8> recycled_delta(std::move(mss.state_delta));
+  mss.state_delta.clear();
+  if (!mss.state_stream)
+    mss.state_stream = std::move(s_rewind_spare_stream);
+
   if (!SaveMemoryState(&mss))
     return false;
 
+  mss.frame_number = s_internal_frame_number;
+
+  // the previous state only needs to be kept as a delta against this one
+  if (!s_rewind_states.empty())
+  {
+    MemorySaveState& prev = s_rewind_states.back();
+    prev.state_delta = std::move(recycled_delta);
+    EncodeRewindDelta(&prev, mss.state_stream.get());
+    s_rewind_spare_stream = std::move(prev.state_stream);
+  }
+
   s_rewind_states.push_back(std::move(mss));
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
-  Log_DevPrintf("Saved rewind state (%" PRIu64 " bytes, took %.4f ms)", s_rewind_states.back().state_stream->GetSize(),
+  Log_DevPrintf("Saved rewind state (%" PRIu64 " bytes, %zu byte delta, took %.4f ms)",
+                s_rewind_states.back().state_stream->GetSize(),
+                (s_rewind_states.size() > 1) ? s_rewind_states[s_rewind_states.size() - 2].state_delta.size() : 0,
                 save_timer.GetTimeMilliseconds());
 #endif
 
   return true;
 }
 
+void System::EncodeRewindDelta(MemorySaveState* mss, const GrowableMemoryByteStream* ref_stream)
+{
+  // Works on 64-bit words, anything past the end of either stream is treated as zero.
+  const u8* cur = mss->state_stream->GetMemoryPointer();
+  const u8* ref = ref_stream->GetMemoryPointer();
+  const u32 cur_size = static_cast<u32>(mss->state_stream->GetSize());
+  const u32 ref_size = static_cast<u32>(ref_stream->GetSize());
+  const u32 num_words = Common::AlignUpPow2(cur_size, sizeof(u64)) / sizeof(u64);
+  const u32 num_full_words = std::min(cur_size, ref_size) / sizeof(u64);
+
+  // Each run is a header word (zero words to skip in the low half, literal words in the high half), then the
+  // literal words themselves.
+  s_rewind_delta_buffer.clear();
+
+  u32 skip = 0;
+  u32 i = 0;
+  while (i < num_words)
+  {
+    u64 cur_word, ref_word;
+    if (i < num_full_words)
+    {
+      std::memcpy(&cur_word, cur + i * sizeof(u64), sizeof(u64));
+      std::memcpy(&ref_word, ref + i * sizeof(u64), sizeof(u64));
+    }
+    else
+    {
+      const u32 offset = i * sizeof(u64);
+      cur_word = 0;
+      ref_word = 0;
+      std::memcpy(&cur_word, cur + offset, std::min<u32>(cur_size - offset, sizeof(u64)));
+      if (offset < ref_size)
+        std::memcpy(&ref_word, ref + offset, std::min<u32>(ref_size - offset, sizeof(u64)));
+    }
+
+    const u64 diff = cur_word ^ ref_word;
+    if (diff == 0)
+    {
+      skip++;
+      i++;
+      continue;
+    }
+
+    const size_t header_pos = s_rewind_delta_buffer.size();
+    s_rewind_delta_buffer.push_back(0);
+    s_rewind_delta_buffer.push_back(diff);
+    i++;
+
+    u32 count = 1;
+    for (; i < num_full_words; i++, count++)
+    {
+      std::memcpy(&cur_word, cur + i * sizeof(u64), sizeof(u64));
+      std::memcpy(&ref_word, ref + i * sizeof(u64), sizeof(u64));
+      if (cur_word == ref_word)
+        break;
+
+      s_rewind_delta_buffer.push_back(cur_word ^ ref_word);
+    }
+
+    s_rewind_delta_buffer[header_pos] = static_cast<u64>(skip) | (static_cast<u64>(count) << 32);
+    skip = 0;
+  }
+
+  const u8* delta_bytes = reinterpret_cast<const u8*>(s_rewind_delta_buffer.data());
+  mss->state_delta.assign(delta_bytes, delta_bytes + s_rewind_delta_buffer.size() * sizeof(u64));
+  mss->state_size = cur_size;
+}
+
+void System::DecodeRewindDelta(MemorySaveState* mss, std::unique_ptr<GrowableMemoryByteStream> ref_stream)
+{
+  // The delta was computed against a zero-padded copy of the reference.
+  const u32 ref_size = static_cast<u32>(ref_stream->GetSize());
+  const u32 padded_size = Common::AlignUpPow2(mss->state_size, sizeof(u64));
+  if (padded_size > ref_size)
+  {
+    ref_stream->Resize(padded_size);
+    std::memset(ref_stream->GetMemoryPointer() + ref_size, 0, padded_size - ref_size);
+  }
+
+  u8* data = ref_stream->GetMemoryPointer();
+  const u8* delta = mss->state_delta.data();
+  const u8* delta_end = delta + mss->state_delta.size();
+  u32 offset = 0;
+  while (delta != delta_end)
+  {
+    u64 header;
+    std::memcpy(&header, delta, sizeof(header));
+    delta += sizeof(header);
+
+    offset += static_cast<u32>(header) * sizeof(u64);
+    const u32 count = static_cast<u32>(header >> 32);
+    for (u32 i = 0; i < count; i++, offset += sizeof(u64), delta += sizeof(u64))
+    {
+      u64 word, diff;
+      std::memcpy(&word, data + offset, sizeof(word));
+      std::memcpy(&diff, delta, sizeof(diff));
+      word ^= diff;
+      std::memcpy(data + offset, &word, sizeof(word));
+    }
+  }
+
+  ref_stream->Resize(mss->state_size);
+  mss->state_stream = std::move(ref_stream);
+  mss->state_delta = {};
+}
+
+void System::PopRewindState()
+{
+  std::unique_ptr<GrowableMemoryByteStream> stream = std::move(s_rewind_states.back().state_stream);
+  s_rewind_states.pop_back();
+  if (!s_rewind_states.empty())
+    DecodeRewindDelta(&s_rewind_states.back(), std::move(stream));
+}
+
 bool System::LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true */)
 {
   while (skip_saves > 0 && !s_rewind_states.empty())
   {
-    s_rewind_states.pop_back();
+    PopRewindState();
     skip_saves--;
   }
 
@@ -3444,11 +4894,14 @@ bool System::LoadRewindState(u32 skip_saves /*= 0*/, bool consume_state /*=true
   Common::Timer load_timer;
 #endif
 
+  const u32 frames_back = s_internal_frame_number - s_rewind_states.back().frame_number;
   if (!LoadMemoryState(s_rewind_states.back()))
     return false;
 
+  Log_DevPrintf("Rewound to frame %u (%u frames back)", s_rewind_states.back().frame_number, frames_back);
+
   if (consume_state)
-    s_rewind_states.pop_back();
+    PopRewindState();
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
   Log_DevPrintf("Rewind load took %.4f ms", load_timer.GetTimeMilliseconds());
@@ -3502,7 +4955,7 @@ void System::DoRewind()
 
 void System::SaveRunaheadState()
 {
-  // try to reuse the frontmost slot
+  // try to reuse the frontmost slot, or one released by a replay, so the VRAM textures are never reallocated
   MemorySaveState mss;
   while (s_runahead_states.size() >= s_runahead_frames)
   {
@@ -3510,6 +4963,12 @@ void System::SaveRunaheadState()
     s_runahead_states.pop_front();
   }
 
+  if (!mss.state_stream && !s_runahead_free_states.empty())
+  {
+    mss = std::move(s_runahead_free_states.back());
+    s_runahead_free_states.pop_back();
+  }
+
   if (!SaveMemoryState(&mss))
   {
     Log_ErrorPrint("Failed to save runahead state.");
@@ -3519,6 +4978,13 @@ void System::SaveRunaheadState()
   s_runahead_states.push_back(std::move(mss));
 }
 
+void System::ReleaseRunaheadStates()
+{
+  for (MemorySaveState& mss : s_runahead_states)
+    s_runahead_free_states.push_back(std::move(mss));
+  s_runahead_states.clear();
+}
+
 void System::DoRunahead()
 {
 #ifdef PROFILE_MEMORY_SAVE_STATES
@@ -3528,17 +4994,17 @@ void System::DoRunahead()
 
   if (s_runahead_replay_pending)
   {
-    // we need to replay and catch up - load the state,
+    // we need to replay and catch up - load the state, the display is updated by the frames we run below,
     s_runahead_replay_pending = false;
-    if (s_runahead_states.empty() || !LoadMemoryState(s_runahead_states.front()))
+    if (s_runahead_states.empty() || !LoadMemoryState(s_runahead_states.front(), false))
     {
-      s_runahead_states.clear();
+      ReleaseRunaheadStates();
       return;
     }
 
     // and throw away all the states, forcing us to catch up below
     // TODO: can we leave one frame here and run, avoiding the extra save?
-    s_runahead_states.clear();
+    ReleaseRunaheadStates();
 
 #ifdef PROFILE_MEMORY_SAVE_STATES
     Log_VerbosePrintf("Rewound to frame %u, took %.2f ms", s_frame_number, timer.GetTimeMilliseconds());
@@ -3611,6 +5077,29 @@ void System::SetRunaheadReplayFlag()
   s_runahead_replay_pending = true;
 }
 
+bool System::SaveStateSnapshot(std::vector<u8>* data, std::vector<std::pair<const char*, u32>>* sections)
+{
+  std::vector<std::pair<const char*, u64>> markers;
+  data->resize(MAX_SAVE_STATE_SIZE);
+
+  StateWrapper sw(data->data(), data->size(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  sw.SetMarkerLog(&markers);
+  if (!DoState(sw, nullptr, false, true))
+  {
+    data->clear();
+    return false;
+  }
+
+  data->resize(static_cast<size_t>(sw.GetPosition()));
+
+  sections->clear();
+  sections->reserve(markers.size());
+  for (const auto& [name, offset] : markers)
+    sections->emplace_back(name, static_cast<u32>(offset));
+
+  return true;
+}
+
 void System::ShutdownSystem(bool save_resume_state)
 {
   if (!IsValid())
@@ -3847,6 +5336,8 @@ std::optional<SaveStateInfo> System::GetSaveStateInfo(const char* serial, s32 sl
   const bool global = (!serial || serial[0] == 0);
   std::string path = global ? GetGlobalSaveStateFileName(slot) : GetGameSaveStateFileName(serial, slot);
 
+  WaitForSaveStateWrites();
+
   FILESYSTEM_STAT_DATA sd;
   if (!FileSystem::StatFile(path.c_str(), &sd))
     return std::nullopt;
@@ -3856,6 +5347,8 @@ std::optional<SaveStateInfo> System::GetSaveStateInfo(const char* serial, s32 sl
 
 std::optional<ExtendedSaveStateInfo> System::GetExtendedSaveStateInfo(const char* path)
 {
+  WaitForSaveStateWrites();
+
   FILESYSTEM_STAT_DATA sd;
   if (!FileSystem::StatFile(path, &sd))
     return std::nullopt;
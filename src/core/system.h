@@ -3,6 +3,7 @@
 #include "settings.h"
 #include "timing_event.h"
 #include "types.h"
+#include <array>
 #include <memory>
 #include <optional>
 #include <string>
@@ -95,6 +96,23 @@ bool IsSaveStateFilename(const std::string_view& path);
 /// Returns the preferred console type for a disc.
 ConsoleRegion GetConsoleRegionForDiscRegion(DiscRegion region);
 
+/// Identifying information for a disc image, gathered with a single read of SYSTEM.CNF and the executable.
+struct ImageIdentification
+{
+  std::string serial;                                ///< From SYSTEM.CNF, e.g. SCES-12345. Empty if not found.
+  std::string hash_id;                               ///< HASH-xxx identifier, for discs without a serial.
+  std::string executable_path;                       ///< Path of the boot executable on the disc.
+  std::string achievements_hash;                     ///< rcheevos hash of the executable.
+  DiscRegion system_area_region = DiscRegion::Other; ///< From the license string in the system area.
+};
+
+/// Reads the identification for the current subimage. Returns false if the image doesn't have an ISO filesystem.
+bool IdentifyImage(CDImage* cdi, ImageIdentification* ident, bool hash_for_achievements);
+
+/// Returns the identification for an image the system is booting or running. The result for the last image is kept
+/// until shutdown, so the region, database and achievements lookups don't each read it again.
+ImageIdentification GetImageIdentification(CDImage* cdi);
+
 std::string GetExecutableNameForImage(CDImage* cdi);
 bool ReadExecutableFromImage(CDImage* cdi, std::string* out_executable_name, std::vector<u8>* out_executable_data);
 
@@ -185,6 +203,66 @@ float GetSWThreadUsage();
 float GetSWThreadAverageTime();
 float GetGPUUsage();
 float GetGPUAverageTime();
+float GetGPUAverageSectionTime(u32 section);
+
+enum class FrameTimeCounter : u8
+{
+  Frame,
+  CPUThread,
+  SWThread,
+  GPU,
+  InputRead,
+  InputLatency,
+  Count
+};
+
+struct FrameTimePercentiles
+{
+  float p50;
+  float p95;
+  float p99;
+};
+
+/// Number of per-frame samples kept for the percentiles and frame time graph.
+static constexpr u32 FRAME_TIME_HISTORY_SIZE = 300;
+using FrameTimeHistory = std::array<float, FRAME_TIME_HISTORY_SIZE>;
+
+/// Percentiles over the most recent frames, updated along with the other performance counters.
+FrameTimePercentiles GetFrameTimePercentiles(FrameTimeCounter counter);
+
+/// Ring buffer of the most recent frame times in milliseconds, the oldest sample is at the returned position.
+const FrameTimeHistory& GetFrameTimeHistory(u32* oldest_pos);
+
+/// Copy of the performance counters, published once per second when they are updated.
+struct PerformanceMetrics
+{
+  float fps;
+  float vps;
+  float speed;
+  float average_frame_time;
+  float worst_frame_time;
+  float cpu_thread_usage;
+  float sw_thread_usage;
+  float gpu_usage;
+  u32 frame_number;
+  u32 recompile_count;
+  u32 flush_count;
+  u32 audio_underrun_count;
+  bool running;
+};
+
+/// Returns the most recently published performance counters. Can be called from any thread, and never waits for or
+/// blocks the CPU thread.
+PerformanceMetrics GetPerformanceMetrics();
+
+/// Input latency measurement. The receipt time is recorded when the host applies a pad input, the read time when the
+/// game next selects the controller, and the sample completes when the first frame rendered after that read is
+/// presented. Only one input is tracked at a time, anything arriving while it is in flight is ignored.
+void OnInputLatencyEventReceived();
+void OnInputLatencyControllerRead();
+
+/// Returns true if the frame about to be presented completes the tracked input, used for the indicator flash.
+bool IsInputLatencyPresentPending();
 
 /// Loads global settings (i.e. EmuConfig).
 void LoadSettings(bool display_osd_messages);
@@ -202,7 +280,13 @@ void ResetSystem();
 
 /// Loads state from the specified filename.
 bool LoadState(const char* filename);
-bool SaveState(const char* filename, bool backup_existing_save);
+
+/// Saves state to the specified filename. Archival states are compressed harder, at the cost of save latency.
+/// The file is written in the background, so this only fails if the state couldn't be captured. Write errors are
+/// reported through the host.
+bool SaveState(const char* filename, bool backup_existing_save, bool archival = false);
+
+/// Saves the resume state, waiting for the write to finish so the result covers it.
 bool SaveResumeState();
 
 /// Runs the VM until the CPU execution is canceled.
@@ -231,6 +315,10 @@ void ResetThrottler();
 /// Throttles the system, i.e. sleeps until it's time to execute the next frame.
 void Throttle();
 
+/// Reports when a frame was shown on screen, and the display's refresh interval (zero if unknown), from hosts whose
+/// window system provides presentation feedback. Both are Common::Timer values. Can be called from any thread.
+void ReportFramePresented(Common::Timer::Value present_time, Common::Timer::Value refresh_interval);
+
 void UpdatePerformanceCounters();
 void ResetPerformanceCounters();
 
@@ -251,13 +339,13 @@ void SwapMemoryCards();
 
 void UpdateMultitaps();
 
-/// Dumps RAM to a file.
+/// Dumps RAM to a file. The file is written in the background, and an OSD message is shown once it's done.
 bool DumpRAM(const char* filename);
 
-/// Dumps video RAM to a file.
+/// Dumps video RAM to a file. The file is written in the background, and an OSD message is shown once it's done.
 bool DumpVRAM(const char* filename);
 
-/// Dumps sound RAM to a file.
+/// Dumps sound RAM to a file. The file is written in the background, and an OSD message is shown once it's done.
 bool DumpSPURAM(const char* filename);
 
 bool HasMedia();
@@ -433,6 +521,10 @@ void UpdateMemorySaveStateSettings();
 bool LoadRewindState(u32 skip_saves = 0, bool consume_state = true);
 void SetRunaheadReplayFlag();
 
+/// Serializes the machine state into memory, for comparing runs. Each section is named after the state marker that
+/// starts it, and covers the data up to the next section.
+bool SaveStateSnapshot(std::vector<u8>* data, std::vector<std::pair<const char*, u32>>* sections);
+
 } // namespace System
 
 namespace Host {
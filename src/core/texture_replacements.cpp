@@ -1,9 +1,12 @@
 #include "texture_replacements.h"
+#include "common/allocation_profiler.h"
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "common/pixel_conversion.h"
 #include "common/platform.h"
 #include "common/string_util.h"
+#include "common/thirdparty/thread_pool.h"
 #include "common/timer.h"
 #include "fmt/format.h"
 #include "host.h"
@@ -12,27 +15,12 @@
 #if defined(CPU_X86) || defined(CPU_X64)
 #include "xxh_x86dispatch.h"
 #endif
+#include <algorithm>
 #include <cinttypes>
 Log_SetChannel(TextureReplacements);
 
 TextureReplacements g_texture_replacements;
 
-static constexpr u32 VRAMRGBA5551ToRGBA8888(u16 color)
-{
-  u8 r = Truncate8(color & 31);
-  u8 g = Truncate8((color >> 5) & 31);
-  u8 b = Truncate8((color >> 10) & 31);
-  u8 a = Truncate8((color >> 15) & 1);
-
-  // 00012345 -> 1234545
-  b = (b << 3) | (b & 0b111);
-  g = (g << 3) | (g & 0b111);
-  r = (r << 3) | (r & 0b111);
-  a = a ? 255 : 0;
-
-  return ZeroExtend32(r) | (ZeroExtend32(g) << 8) | (ZeroExtend32(b) << 16) | (ZeroExtend32(a) << 24);
-}
-
 std::string TextureReplacementHash::ToString() const
 {
   return StringUtil::StdStringFromFormat("%" PRIx64 "%" PRIx64, high, low);
@@ -63,6 +51,7 @@ void TextureReplacements::SetGameID(std::string game_id)
     return;
 
   m_game_id = game_id;
+  m_dumped_vram_writes.clear();
   Reload();
 }
 
@@ -79,41 +68,41 @@ const TextureReplacementTexture* TextureReplacements::GetVRAMWriteReplacement(u3
 
 void TextureReplacements::DumpVRAMWrite(u32 width, u32 height, const void* pixels)
 {
-  std::string filename = GetVRAMWriteDumpFilename(width, height, pixels);
-  if (filename.empty())
+  // games tend to upload the same data repeatedly, so skip everything for writes we've seen before
+  const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
+  if (!m_dumped_vram_writes.insert(hash).second)
     return;
 
-  Common::RGBA8Image image;
-  image.SetSize(width, height);
-
-  const u16* src_pixels = reinterpret_cast<const u16*>(pixels);
-
-  for (u32 y = 0; y < height; y++)
-  {
-    for (u32 x = 0; x < width; x++)
-    {
-      image.SetPixel(x, y, VRAMRGBA5551ToRGBA8888(*src_pixels));
-      src_pixels++;
-    }
-  }
-
-  if (g_settings.texture_replacements.dump_vram_write_force_alpha_channel)
-  {
-    for (u32 y = 0; y < height; y++)
-    {
-      for (u32 x = 0; x < width; x++)
-        image.SetPixel(x, y, image.GetPixel(x, y) | 0xFF000000u);
-    }
-  }
+  std::string filename = GetVRAMWriteDumpFilename(hash);
+  if (filename.empty())
+    return;
 
-  Log_InfoPrintf("Dumping %ux%u VRAM write to '%s'", width, height, filename.c_str());
-  if (!image.SaveToFile(filename.c_str()))
-    Log_ErrorPrintf("Failed to dump %ux%u VRAM write to '%s'", width, height, filename.c_str());
+  // conversion and encoding happen on a worker thread, only the source data is copied here
+  std::vector<u16> vram_pixels(static_cast<const u16*>(pixels), static_cast<const u16*>(pixels) + width * height);
+  const bool force_alpha_channel = g_settings.texture_replacements.dump_vram_write_force_alpha_channel;
+  GetThreadPool()->Schedule([width, height, filename = std::move(filename), vram_pixels = std::move(vram_pixels),
+                             force_alpha_channel]() {
+    Common::RGBA8Image image;
+    image.SetSize(width, height);
+
+    PixelConversion::ConvertRGBA5551ToRGBA8(image.GetPixels(), vram_pixels.data(), width * height,
+                                            force_alpha_channel ? 0xFF000000u : 0u);
+
+    Log_InfoPrintf("Dumping %ux%u VRAM write to '%s'", width, height, filename.c_str());
+    if (!image.SaveToFile(filename.c_str()))
+      Log_ErrorPrintf("Failed to dump %ux%u VRAM write to '%s'", width, height, filename.c_str());
+  });
 }
 
 void TextureReplacements::Shutdown()
 {
+  CancelTextureLoads();
+  m_thread_pool.reset();
+  m_dumped_vram_writes.clear();
+
   m_texture_cache.clear();
+  m_texture_lru.clear();
+  m_texture_cache_size = 0;
   m_vram_write_replacements.clear();
   m_game_id.clear();
 }
@@ -134,12 +123,11 @@ TextureReplacementHash TextureReplacements::GetVRAMWriteHash(u32 width, u32 heig
   return {hash.low64, hash.high64};
 }
 
-std::string TextureReplacements::GetVRAMWriteDumpFilename(u32 width, u32 height, const void* pixels) const
+std::string TextureReplacements::GetVRAMWriteDumpFilename(const TextureReplacementHash& hash) const
 {
   if (m_game_id.empty())
     return {};
 
-  const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
   const std::string dump_directory(GetDumpDirectory());
   std::string filename(Path::Combine(dump_directory, fmt::format("vram-write-{}.png", hash.ToString())));
 
@@ -154,28 +142,51 @@ std::string TextureReplacements::GetVRAMWriteDumpFilename(u32 width, u32 height,
 
 void TextureReplacements::Reload()
 {
+  CancelTextureLoads();
   m_vram_write_replacements.clear();
 
   if (g_settings.texture_replacements.AnyReplacementsEnabled())
     FindTextures(GetSourceDirectory());
 
+  PurgeUnreferencedTexturesFromCache();
+
+  if (g_settings.texture_replacements.max_cache_size_mb > 0)
+    EvictTexturesFromCache(static_cast<size_t>(g_settings.texture_replacements.max_cache_size_mb) * 1048576);
+
   if (g_settings.texture_replacements.preload_textures)
     PreloadTextures();
-
-  PurgeUnreferencedTexturesFromCache();
 }
 
 void TextureReplacements::PurgeUnreferencedTexturesFromCache()
 {
-  TextureCache old_map = std::move(m_texture_cache);
+  std::unordered_set<std::string> referenced_filenames;
   for (const auto& it : m_vram_write_replacements)
+    referenced_filenames.insert(it.second);
+
+  for (auto it = m_texture_cache.begin(); it != m_texture_cache.end();)
   {
-    auto it2 = old_map.find(it.second);
-    if (it2 != old_map.end())
+    if (referenced_filenames.find(it->first) != referenced_filenames.end())
     {
-      m_texture_cache[it.second] = std::move(it2->second);
-      old_map.erase(it2);
+      ++it;
+      continue;
     }
+
+    m_texture_cache_size -= it->second.texture.GetPitch() * it->second.texture.GetHeight();
+    m_texture_lru.erase(it->second.lru_it);
+    it = m_texture_cache.erase(it);
+  }
+}
+
+void TextureReplacements::EvictTexturesFromCache(size_t max_size)
+{
+  // never evict the most recently used texture, it's about to be uploaded
+  while (m_texture_cache_size > max_size && m_texture_lru.size() > 1)
+  {
+    auto it = m_texture_cache.find(m_texture_lru.back());
+    Log_DevPrintf("Evicting '%s' from replacement cache", it->first.c_str());
+    m_texture_cache_size -= it->second.texture.GetPitch() * it->second.texture.GetHeight();
+    m_texture_cache.erase(it);
+    m_texture_lru.pop_back();
   }
 }
 
@@ -214,7 +225,7 @@ bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
   extension++;
 
   bool valid_extension = false;
-  for (const char* test_extension : {"png", "jpg", "tga", "bmp"})
+  for (const char* test_extension : {"png", "jpg", "tga", "bmp", "dds"})
   {
     if (StringUtil::Strcasecmp(extension, test_extension) == 0)
     {
@@ -229,7 +240,8 @@ bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
 void TextureReplacements::FindTextures(const std::string& dir)
 {
   FileSystem::FindResultsArray files;
-  FileSystem::FindFiles(dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
+  // only the names matter, so a repeat scan of an unchanged pack can reuse the last enumeration
+  FileSystem::FindFilesCached(dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
 
   for (FILESYSTEM_FIND_DATA& fd : files)
   {
@@ -263,9 +275,21 @@ void TextureReplacements::FindTextures(const std::string& dir)
 
 const TextureReplacementTexture* TextureReplacements::LoadTexture(const std::string& filename)
 {
+  ReceiveLoadedTextures();
+
   auto it = m_texture_cache.find(filename);
   if (it != m_texture_cache.end())
-    return &it->second;
+  {
+    m_texture_lru.splice(m_texture_lru.begin(), m_texture_lru, it->second.lru_it);
+    return &it->second.texture;
+  }
+
+  // The original data is used until the image has been decoded.
+  if (g_settings.texture_replacements.async_loading)
+  {
+    QueueTextureLoad(filename);
+    return nullptr;
+  }
 
   Common::RGBA8Image image;
   if (!image.LoadFromFile(filename.c_str()))
@@ -275,14 +299,104 @@ const TextureReplacementTexture* TextureReplacements::LoadTexture(const std::str
   }
 
   Log_InfoPrintf("Loaded '%s': %ux%u", filename.c_str(), image.GetWidth(), image.GetHeight());
-  it = m_texture_cache.emplace(filename, std::move(image)).first;
-  return &it->second;
+  return InsertTexture(filename, std::move(image));
+}
+
+const TextureReplacementTexture* TextureReplacements::InsertTexture(const std::string& filename,
+                                                                    TextureReplacementTexture texture)
+{
+  ALLOCATION_TAG("TextureReplacements");
+
+  m_texture_lru.push_front(filename);
+  m_texture_cache_size += texture.GetPitch() * texture.GetHeight();
+
+  auto it = m_texture_cache.emplace(filename, CachedTexture{std::move(texture), m_texture_lru.begin()}).first;
+  if (g_settings.texture_replacements.max_cache_size_mb > 0)
+    EvictTexturesFromCache(static_cast<size_t>(g_settings.texture_replacements.max_cache_size_mb) * 1048576);
+
+  return &it->second.texture;
+}
+
+cb::ThreadPool* TextureReplacements::GetThreadPool()
+{
+  if (!m_thread_pool)
+  {
+    const int num_threads = static_cast<int>(std::clamp(cb::ThreadPool::GetNumLogicalCores() / 2, 1u, 4u));
+    m_thread_pool = std::make_unique<cb::ThreadPool>(num_threads);
+  }
+
+  return m_thread_pool.get();
+}
+
+void TextureReplacements::QueueTextureLoad(const std::string& filename)
+{
+  if (!m_pending_loads.insert(filename).second)
+    return;
+
+  const u32 generation = m_load_generation.load(std::memory_order_acquire);
+  GetThreadPool()->Schedule([this, filename, generation]() {
+    // skip loads which were queued before a reload
+    if (m_load_generation.load(std::memory_order_acquire) != generation)
+      return;
+
+    Common::RGBA8Image image;
+    if (!image.LoadFromFile(filename.c_str()))
+    {
+      Log_ErrorPrintf("Failed to load '%s'", filename.c_str());
+      return;
+    }
+
+    Log_InfoPrintf("Loaded '%s': %ux%u", filename.c_str(), image.GetWidth(), image.GetHeight());
+
+    std::unique_lock lock(m_loaded_textures_mutex);
+    if (m_load_generation.load(std::memory_order_acquire) == generation)
+      m_loaded_textures.emplace_back(filename, std::move(image));
+  });
+}
+
+void TextureReplacements::ReceiveLoadedTextures()
+{
+  if (m_pending_loads.empty())
+    return;
+
+  std::vector<std::pair<std::string, TextureReplacementTexture>> loaded_textures;
+  {
+    std::unique_lock lock(m_loaded_textures_mutex);
+    loaded_textures.swap(m_loaded_textures);
+  }
+
+  for (auto& [filename, texture] : loaded_textures)
+  {
+    m_pending_loads.erase(filename);
+    if (m_texture_cache.find(filename) == m_texture_cache.end())
+      InsertTexture(filename, std::move(texture));
+  }
+}
+
+void TextureReplacements::CancelTextureLoads()
+{
+  std::unique_lock lock(m_loaded_textures_mutex);
+  m_load_generation.fetch_add(1, std::memory_order_acq_rel);
+  m_loaded_textures.clear();
+  m_pending_loads.clear();
 }
 
 void TextureReplacements::PreloadTextures()
 {
   static constexpr float UPDATE_INTERVAL = 1.0f;
 
+  // decode in the background instead of behind a loading screen
+  if (g_settings.texture_replacements.async_loading)
+  {
+    for (const auto& it : m_vram_write_replacements)
+    {
+      if (m_texture_cache.find(it.second) == m_texture_cache.end())
+        QueueTextureLoad(it.second);
+    }
+
+    return;
+  }
+
   Common::Timer last_update_time;
   u32 num_textures_loaded = 0;
   const u32 total_textures = static_cast<u32>(m_vram_write_replacements.size());
@@ -2,11 +2,20 @@
 #include "common/hash_combine.h"
 #include "common/image.h"
 #include "types.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+namespace cb {
+class ThreadPool;
+}
+
 struct TextureReplacementHash
 {
   u64 low;
@@ -62,8 +71,14 @@ private:
     size_t operator()(const TextureReplacementHash& hash);
   };
 
+  struct CachedTexture
+  {
+    TextureReplacementTexture texture;
+    std::list<std::string>::iterator lru_it;
+  };
+
   using VRAMWriteReplacementMap = std::unordered_map<TextureReplacementHash, std::string>;
-  using TextureCache = std::unordered_map<std::string, TextureReplacementTexture>;
+  using TextureCache = std::unordered_map<std::string, CachedTexture>;
 
   static bool ParseReplacementFilename(const std::string& filename, TextureReplacementHash* replacement_hash,
                                        ReplacmentType* replacement_type);
@@ -72,17 +87,37 @@ private:
   std::string GetDumpDirectory() const;
 
   TextureReplacementHash GetVRAMWriteHash(u32 width, u32 height, const void* pixels) const;
-  std::string GetVRAMWriteDumpFilename(u32 width, u32 height, const void* pixels) const;
+  std::string GetVRAMWriteDumpFilename(const TextureReplacementHash& hash) const;
 
   void FindTextures(const std::string& dir);
 
   const TextureReplacementTexture* LoadTexture(const std::string& filename);
+  const TextureReplacementTexture* InsertTexture(const std::string& filename, TextureReplacementTexture texture);
+  void EvictTexturesFromCache(size_t max_size);
   void PreloadTextures();
   void PurgeUnreferencedTexturesFromCache();
 
+  cb::ThreadPool* GetThreadPool();
+  void QueueTextureLoad(const std::string& filename);
+  void ReceiveLoadedTextures();
+  void CancelTextureLoads();
+
   std::string m_game_id;
 
   TextureCache m_texture_cache;
+  std::list<std::string> m_texture_lru; // most recently used first
+  size_t m_texture_cache_size = 0;
+
+  // Background loading and dumping. Decoded textures are handed back through m_loaded_textures, and only
+  // inserted into the cache from the CPU thread, so cache lookups don't need a lock.
+  std::unique_ptr<cb::ThreadPool> m_thread_pool;
+  std::unordered_set<std::string> m_pending_loads;
+  std::mutex m_loaded_textures_mutex;
+  std::vector<std::pair<std::string, TextureReplacementTexture>> m_loaded_textures;
+  std::atomic<u32> m_load_generation{0};
+
+  // VRAM writes which have already been dumped, or were skipped because the file exists.
+  std::unordered_set<TextureReplacementHash> m_dumped_vram_writes;
 
   VRAMWriteReplacementMap m_vram_write_replacements;
 };
@@ -9,6 +9,9 @@ Log_SetChannel(Timers);
 
 Timers g_timers;
 
+// Upper bound on the sysclk event period when no IRQs are armed, in unscaled ticks.
+static constexpr TickCount MAX_LAZY_UPDATE_TICKS = System::MASTER_CLOCK;
+
 Timers::Timers() = default;
 
 Timers::~Timers() = default;
@@ -353,12 +356,14 @@ void Timers::UpdateIRQ(u32 index)
 
 TickCount Timers::GetTicksUntilNextInterrupt() const
 {
-  TickCount min_ticks = System::GetMaxSliceTicks();
+  // Counters without an IRQ pending are brought up to date lazily when they're accessed, so we only need to run often
+  // enough to keep the elapsed tick count small.
+  TickCount min_ticks = MAX_LAZY_UPDATE_TICKS;
   for (u32 i = 0; i < NUM_TIMERS; i++)
   {
     const CounterState& cs = m_states[i];
     if (!cs.counting_enabled || (i < 2 && cs.external_counting_enabled) ||
-        (!cs.mode.irq_at_target && !cs.mode.irq_on_overflow && (cs.mode.irq_repeat || !cs.irq_done)))
+        (!cs.mode.irq_at_target && !cs.mode.irq_on_overflow) || (!cs.mode.irq_repeat && cs.irq_done))
     {
       continue;
     }
@@ -387,7 +392,12 @@ TickCount Timers::GetTicksUntilNextInterrupt() const
 
 void Timers::UpdateSysClkEvent()
 {
-  m_sysclk_event->Schedule(GetTicksUntilNextInterrupt());
+  // Without an IRQ to raise, the event only stops the lazily updated counters falling too far behind, so it doesn't
+  // matter when it runs, as long as it does.
+  const TickCount ticks = GetTicksUntilNextInterrupt();
+  const TickCount lazy_update_ticks = System::ScaleTicksToOverclock(MAX_LAZY_UPDATE_TICKS);
+  m_sysclk_event->SetTolerance((ticks == lazy_update_ticks) ? lazy_update_ticks : 0);
+  m_sysclk_event->Schedule(ticks);
 }
 
 void Timers::DrawDebugStateWindow()
@@ -429,6 +439,9 @@ void Timers::DrawDebugStateWindow()
     ImGui::NextColumn();
   }
 
+  // Counters are updated lazily, so bring them up to date before displaying.
+  m_sysclk_event->InvokeEarly();
+
   for (u32 i = 0; i < NUM_TIMERS; i++)
   {
     const CounterState& cs = m_states[i];
@@ -1,20 +1,35 @@
 #include "timing_event.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/timer.h"
+#include "common/trace.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "system.h"
 #include "util/state_wrapper.h"
+#include <algorithm>
+#include <limits>
 Log_SetChannel(TimingEvents);
 
 namespace TimingEvents {
 
+// Active events are kept in a binary min-heap ordered by downcount, so rescheduling is O(log n).
+static std::vector<TimingEvent*> s_active_events;
+
+// Always the first event in the heap.
 static TimingEvent* s_active_events_head;
-static TimingEvent* s_active_events_tail;
+
+// Events can run up to their tolerance late, so rather than stopping at the head event, the CPU runs until the
+// earliest downcount plus tolerance of any event, and every event due by then is run together.
+static TickCount s_slice_downcount = std::numeric_limits<TickCount>::max();
+
 static TimingEvent* s_current_event = nullptr;
-static u32 s_active_event_count = 0;
 static u32 s_global_tick_counter = 0;
 
+// Every event which currently exists, for profiling.
+static std::vector<TimingEvent*> s_all_events;
+static bool s_profiling_enabled = false;
+
 u32 GetGlobalTickCounter()
 {
   return s_global_tick_counter;
@@ -32,7 +47,7 @@ void Reset()
 
 void Shutdown()
 {
-  Assert(s_active_event_count == 0);
+  Assert(s_active_events.empty());
 }
 
 std::unique_ptr<TimingEvent> CreateTimingEvent(std::string name, TickCount period, TickCount interval,
@@ -50,205 +65,152 @@ void UpdateCPUDowncount()
 {
   if (!CPU::g_state.frame_done && (!CPU::HasPendingInterrupt() || CPU::g_using_interpreter))
   {
-    CPU::g_state.downcount = s_active_events_head->GetDowncount();
+    CPU::g_state.downcount = s_slice_downcount;
   }
 }
 
-TimingEvent** GetHeadEventPtr()
+const TickCount* GetSliceDowncountPtr()
 {
-  return &s_active_events_head;
+  return &s_slice_downcount;
 }
 
-static void SortEvent(TimingEvent* event)
+static ALWAYS_INLINE void SetHeapEvent(u32 index, TimingEvent* event)
 {
-  const TickCount event_downcount = event->m_downcount;
+  s_active_events[index] = event;
+  event->m_heap_index = index;
+}
 
-  if (event->prev && event->prev->m_downcount > event_downcount)
+static u32 SiftEventUp(u32 index)
+{
+  TimingEvent* event = s_active_events[index];
+  while (index > 0)
   {
-    // move backwards
-    TimingEvent* current = event->prev;
-    while (current && current->m_downcount > event_downcount)
-      current = current->prev;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
-
-    // insert after current
-    if (current)
-    {
-      event->next = current->next;
-      if (current->next)
-        current->next->prev = event;
-      else
-        s_active_events_tail = event;
+    const u32 parent = (index - 1) / 2;
+    if (s_active_events[parent]->m_downcount <= event->m_downcount)
+      break;
 
-      event->prev = current;
-      current->next = event;
-    }
-    else
-    {
-      // insert at front
-      DebugAssert(s_active_events_head);
-      s_active_events_head->prev = event;
-      event->prev = nullptr;
-      event->next = s_active_events_head;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
+    SetHeapEvent(index, s_active_events[parent]);
+    index = parent;
   }
-  else if (event->next && event_downcount > event->next->m_downcount)
+
+  SetHeapEvent(index, event);
+  return index;
+}
+
+static u32 SiftEventDown(u32 index)
+{
+  TimingEvent* event = s_active_events[index];
+  const u32 count = static_cast<u32>(s_active_events.size());
+  for (;;)
   {
-    // move forwards
-    TimingEvent* current = event->next;
-    while (current && event_downcount > current->m_downcount)
-      current = current->next;
-
-    // unlink
-    if (event->prev)
-      event->prev->next = event->next;
-    else
-      s_active_events_head = event->next;
-    if (event->next)
-      event->next->prev = event->prev;
-    else
-      s_active_events_tail = event->prev;
-
-    // insert before current
-    if (current)
-    {
-      event->next = current;
-      event->prev = current->prev;
+    u32 child = (index * 2) + 1;
+    if (child >= count)
+      break;
 
-      if (current->prev)
-        current->prev->next = event;
-      else
-        s_active_events_head = event;
+    if ((child + 1) < count && s_active_events[child + 1]->m_downcount < s_active_events[child]->m_downcount)
+      child++;
 
-      current->prev = event;
-    }
-    else
-    {
-      // insert at back
-      DebugAssert(s_active_events_tail);
-      s_active_events_tail->next = event;
-      event->next = nullptr;
-      event->prev = s_active_events_tail;
-      s_active_events_tail = event;
-    }
+    if (event->m_downcount <= s_active_events[child]->m_downcount)
+      break;
+
+    SetHeapEvent(index, s_active_events[child]);
+    index = child;
   }
+
+  SetHeapEvent(index, event);
+  return index;
 }
 
-static void AddActiveEvent(TimingEvent* event)
+static void ClampSliceDowncount(u32 index, TickCount* downcount)
 {
-  DebugAssert(!event->prev && !event->next);
-  s_active_event_count++;
+  // Children are never due before their parent, so only subtrees due before the slice ends can shorten it.
+  if (index >= s_active_events.size() || s_active_events[index]->m_downcount >= *downcount)
+    return;
 
-  TimingEvent* current = nullptr;
-  TimingEvent* next = s_active_events_head;
-  while (next && event->m_downcount > next->m_downcount)
-  {
-    current = next;
-    next = next->next;
-  }
+  const TimingEvent* event = s_active_events[index];
+  *downcount = std::min(*downcount, event->m_downcount + event->m_tolerance);
+  ClampSliceDowncount((index * 2) + 1, downcount);
+  ClampSliceDowncount((index * 2) + 2, downcount);
+}
 
-  if (!next)
+static void UpdateSliceDowncount()
+{
+  TickCount downcount = std::numeric_limits<TickCount>::max();
+  if (s_active_events_head)
   {
-    // new tail
-    event->prev = s_active_events_tail;
-    if (s_active_events_tail)
+    // nothing else can be due before an exact head event
+    downcount = s_active_events_head->m_downcount + s_active_events_head->m_tolerance;
+    if (s_active_events_head->m_tolerance > 0)
     {
-      s_active_events_tail->next = event;
-      s_active_events_tail = event;
+      ClampSliceDowncount(1, &downcount);
+      ClampSliceDowncount(2, &downcount);
     }
-    else
-    {
-      // first event
-      s_active_events_tail = event;
-      s_active_events_head = event;
-      UpdateCPUDowncount();
-    }
-  }
-  else if (!current)
-  {
-    // new head
-    event->next = s_active_events_head;
-    s_active_events_head->prev = event;
-    s_active_events_head = event;
-    UpdateCPUDowncount();
-  }
-  else
-  {
-    // inbetween current < event > next
-    event->prev = current;
-    event->next = next;
-    current->next = event;
-    next->prev = event;
   }
+
+  if (s_slice_downcount == downcount)
+    return;
+
+  s_slice_downcount = downcount;
+  UpdateCPUDowncount();
+}
+
+static void SortEvent(TimingEvent* event)
+{
+  const u32 old_index = event->m_heap_index;
+  if (SiftEventUp(old_index) == old_index)
+    SiftEventDown(old_index);
+
+  s_active_events_head = s_active_events.front();
+  UpdateSliceDowncount();
+}
+
+static void AddActiveEvent(TimingEvent* event)
+{
+  const u32 index = static_cast<u32>(s_active_events.size());
+  s_active_events.push_back(event);
+  event->m_heap_index = index;
+
+  SiftEventUp(index);
+  s_active_events_head = s_active_events.front();
+  UpdateSliceDowncount();
 }
 
 static void RemoveActiveEvent(TimingEvent* event)
 {
-  DebugAssert(s_active_event_count > 0);
+  DebugAssert(!s_active_events.empty() && s_active_events[event->m_heap_index] == event);
 
-  if (event->next)
-  {
-    event->next->prev = event->prev;
-  }
-  else
-  {
-    s_active_events_tail = event->prev;
-  }
+  const u32 index = event->m_heap_index;
+  TimingEvent* last = s_active_events.back();
+  s_active_events.pop_back();
+  event->m_heap_index = 0;
 
-  if (event->prev)
-  {
-    event->prev->next = event->next;
-  }
-  else
+  if (last != event)
   {
-    s_active_events_head = event->next;
-    if (s_active_events_head)
-      UpdateCPUDowncount();
+    SetHeapEvent(index, last);
+    if (SiftEventUp(index) == index)
+      SiftEventDown(index);
   }
 
-  event->prev = nullptr;
-  event->next = nullptr;
-
-  s_active_event_count--;
+  s_active_events_head = s_active_events.empty() ? nullptr : s_active_events.front();
+  UpdateSliceDowncount();
 }
 
 static void SortEvents()
 {
-  std::vector<TimingEvent*> events;
-  events.reserve(s_active_event_count);
-
-  TimingEvent* next = s_active_events_head;
-  while (next)
-  {
-    TimingEvent* current = next;
-    events.push_back(current);
-    next = current->next;
-    current->prev = nullptr;
-    current->next = nullptr;
-  }
+  if (s_active_events.empty())
+    return;
 
-  s_active_events_head = nullptr;
-  s_active_events_tail = nullptr;
-  s_active_event_count = 0;
+  for (u32 i = static_cast<u32>(s_active_events.size()) / 2; i > 0; i--)
+    SiftEventDown(i - 1);
 
-  for (TimingEvent* event : events)
-    AddActiveEvent(event);
+  s_active_events_head = s_active_events.front();
+  UpdateSliceDowncount();
+  UpdateCPUDowncount();
 }
 
 static TimingEvent* FindActiveEvent(const char* name)
 {
-  for (TimingEvent* event = s_active_events_head; event; event = event->next)
+  for (TimingEvent* event : s_active_events)
   {
     if (event->GetName().compare(name) == 0)
       return event;
@@ -271,16 +233,17 @@ void RunEvents()
 
     // Apply downcount to all events.
     // This will result in a negative downcount for those events which are late.
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    // Every downcount drops by the same amount, so the heap order is unaffected.
+    for (TimingEvent* event : s_active_events)
     {
       event->m_downcount -= time;
       event->m_time_since_last_run += time;
     }
+    s_slice_downcount -= time;
 
     // Now we can actually run the callbacks.
     while (s_active_events_head->m_downcount <= 0)
     {
-      // move it to the end, since that'll likely be its new position
       TimingEvent* event = s_active_events_head;
       s_current_event = event;
 
@@ -291,7 +254,26 @@ void RunEvents()
       event->m_time_since_last_run = 0;
 
       // The cycles_late is only an indicator, it doesn't modify the cycles to execute.
-      event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
+      if (!s_profiling_enabled && !Trace::IsCapturing())
+      {
+        event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
+      }
+      else
+      {
+        const Common::Timer::Value start_time = Common::Timer::GetCurrentValue();
+        event->m_callback(event->m_callback_param, ticks_to_execute, ticks_late);
+        const Common::Timer::Value end_time = Common::Timer::GetCurrentValue();
+        event->m_profile_time += end_time - start_time;
+        event->m_profile_calls++;
+
+        if (Trace::IsCapturing())
+        {
+          if (!event->m_trace_name)
+            event->m_trace_name = Trace::InternName(event->m_name);
+          Trace::AddZone(event->m_trace_name, start_time, end_time);
+        }
+      }
+
       if (event->m_active)
         SortEvent(event);
     }
@@ -301,6 +283,33 @@ void RunEvents()
   UpdateCPUDowncount();
 }
 
+void SetProfilingEnabled(bool enabled)
+{
+  if (enabled)
+  {
+    for (TimingEvent* event : s_all_events)
+    {
+      event->m_profile_calls = 0;
+      event->m_profile_time = 0;
+    }
+  }
+
+  s_profiling_enabled = enabled;
+}
+
+std::vector<EventProfile> GetProfile()
+{
+  std::vector<EventProfile> ret;
+  ret.reserve(s_all_events.size());
+  for (const TimingEvent* event : s_all_events)
+  {
+    ret.push_back(EventProfile{event->GetName(), event->m_profile_calls,
+                               Common::Timer::ConvertValueToSeconds(event->m_profile_time)});
+  }
+
+  return ret;
+}
+
 bool DoState(StateWrapper& sw)
 {
   sw.Do(&s_global_tick_counter);
@@ -349,10 +358,11 @@ bool DoState(StateWrapper& sw)
   }
   else
   {
+    // Order doesn't matter, events are looked up by name and re-sorted when loading.
+    u32 event_count = static_cast<u32>(s_active_events.size());
+    sw.Do(&event_count);
 
-    sw.Do(&s_active_event_count);
-
-    for (TimingEvent* event = s_active_events_head; event; event = event->next)
+    for (TimingEvent* event : s_active_events)
     {
       sw.Do(&event->m_name);
       sw.Do(&event->m_downcount);
@@ -361,7 +371,7 @@ bool DoState(StateWrapper& sw)
       sw.Do(&event->m_interval);
     }
 
-    Log_DevPrintf("Wrote %u events to save state.", s_active_event_count);
+    Log_DevPrintf("Wrote %u events to save state.", event_count);
   }
 
   return !sw.HasError();
@@ -374,12 +384,23 @@ TimingEvent::TimingEvent(std::string name, TickCount period, TickCount interval,
   : m_callback(callback), m_callback_param(callback_param), m_downcount(interval), m_time_since_last_run(0),
     m_period(period), m_interval(interval), m_name(std::move(name))
 {
+  TimingEvents::s_all_events.push_back(this);
 }
 
 TimingEvent::~TimingEvent()
 {
   if (m_active)
     TimingEvents::RemoveActiveEvent(this);
+
+  TimingEvents::s_all_events.erase(
+    std::find(TimingEvents::s_all_events.begin(), TimingEvents::s_all_events.end(), this));
+}
+
+void TimingEvent::SetTolerance(TickCount tolerance)
+{
+  m_tolerance = tolerance;
+  if (m_active)
+    TimingEvents::UpdateSliceDowncount();
 }
 
 TickCount TimingEvent::GetTicksSinceLastExecution() const
@@ -26,6 +26,11 @@ public:
   ALWAYS_INLINE TickCount GetInterval() const { return m_interval; }
   ALWAYS_INLINE TickCount GetDowncount() const { return m_downcount; }
 
+  // Returns the number of ticks the event can run late by, so the CPU can keep running past it to a later event.
+  // Zero for events which have to run on time, e.g. ones which raise interrupts.
+  ALWAYS_INLINE TickCount GetTolerance() const { return m_tolerance; }
+  void SetTolerance(TickCount tolerance);
+
   // Includes pending time.
   TickCount GetTicksSinceLastExecution() const;
   TickCount GetTicksUntilNextExecution() const;
@@ -60,8 +65,8 @@ public:
   void SetInterval(TickCount interval) { m_interval = interval; }
   void SetPeriod(TickCount period) { m_period = period; }
 
-  TimingEvent* prev = nullptr;
-  TimingEvent* next = nullptr;
+  // Position in the active event heap, only meaningful while active.
+  u32 m_heap_index = 0;
 
   TimingEventCallback m_callback;
   void* m_callback_param;
@@ -70,8 +75,16 @@ public:
   TickCount m_time_since_last_run;
   TickCount m_period;
   TickCount m_interval;
+  TickCount m_tolerance = 0;
   bool m_active = false;
 
+  // Host time spent in the callback, only updated while profiling is enabled.
+  u64 m_profile_calls = 0;
+  u64 m_profile_time = 0;
+
+  // Zone name for trace captures, interned on first use.
+  const char* m_trace_name = nullptr;
+
   std::string m_name;
 };
 
@@ -94,6 +107,20 @@ void RunEvents();
 
 void UpdateCPUDowncount();
 
-TimingEvent** GetHeadEventPtr();
+/// The downcount the CPU runs to before running events, the recompiler dispatcher reads it through this pointer.
+const TickCount* GetSliceDowncountPtr();
+
+struct EventProfile
+{
+  std::string name;
+  u64 calls;
+  double seconds;
+};
+
+/// Accumulates the host time spent in each event callback dispatched from RunEvents(). Enabling resets the counters.
+void SetProfilingEnabled(bool enabled);
+
+/// Returns the accumulated time for every existing event, including inactive ones.
+std::vector<EventProfile> GetProfile();
 
 } // namespace TimingEvents
\ No newline at end of file
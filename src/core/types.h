@@ -179,8 +179,9 @@ enum class CPUFastmemMode
   Count
 };
 
+// RAM code tracking and the fastmem LUT work in 4KB pages. Host pages can be larger, see Bus::GetHostPageSize().
 enum : size_t
 {
-  HOST_PAGE_SIZE = 4096,
-  HOST_PAGE_OFFSET_MASK = HOST_PAGE_SIZE - 1,
+  CODE_PAGE_SIZE = 4096,
+  CODE_PAGE_OFFSET_MASK = CODE_PAGE_SIZE - 1,
 };
@@ -7,6 +7,7 @@
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/threading.h"
+#include "common/trace.h"
 #include "core/controller.h"
 #include "core/gpu.h"
 #include "core/host.h"
@@ -31,6 +32,8 @@
 #include <cmath>
 #include <condition_variable>
 #include <csignal>
+#include <iterator>
+#include <mutex>
 #include <thread>
 Log_SetChannel(NoGUIHost);
 
@@ -79,6 +82,10 @@ static void UpdateWindowTitle(const std::string& game_title);
 static void CancelAsyncOp();
 static void StartAsyncOp(std::function<void(ProgressCallback*)> callback);
 static void AsyncOpThreadEntryPoint(std::function<void(ProgressCallback*)> callback);
+static void StartMetricsExport();
+static void StopMetricsExport();
+static void MetricsThreadEntryPoint();
+static std::string FormatMetrics(const System::PerformanceMetrics& metrics);
 static bool AcquireHostDisplay(RenderAPI api);
 static void ReleaseHostDisplay();
 } // namespace NoGUIHost
@@ -105,6 +112,12 @@ static std::mutex s_async_op_mutex;
 static std::thread s_async_op_thread;
 static FullscreenUI::ProgressCallback* s_async_op_progress = nullptr;
 
+static std::string s_metrics_path;
+static std::thread s_metrics_thread;
+static std::mutex s_metrics_mutex;
+static std::condition_variable s_metrics_cv;
+static bool s_metrics_shutdown = false;
+
 //////////////////////////////////////////////////////////////////////////
 // Initialization/Shutdown
 //////////////////////////////////////////////////////////////////////////
@@ -786,7 +799,10 @@ void Host::RenderDisplay(bool skip_present)
     ImGuiManager::RenderDebugWindows();
   }
 
-  g_host_display->Render(skip_present);
+  {
+    TRACE_SCOPE("HostDisplay::Render");
+    g_host_display->Render(skip_present);
+  }
 
   ImGuiManager::NewFrame();
 }
@@ -939,6 +955,77 @@ void NoGUIHost::AsyncOpThreadEntryPoint(std::function<void(ProgressCallback*)> c
   s_async_op_progress = nullptr;
 }
 
+void NoGUIHost::StartMetricsExport()
+{
+  if (s_metrics_path.empty())
+    return;
+
+  s_metrics_shutdown = false;
+  s_metrics_thread = std::thread(MetricsThreadEntryPoint);
+}
+
+void NoGUIHost::StopMetricsExport()
+{
+  if (!s_metrics_thread.joinable())
+    return;
+
+  {
+    std::unique_lock lock(s_metrics_mutex);
+    s_metrics_shutdown = true;
+  }
+  s_metrics_cv.notify_one();
+  s_metrics_thread.join();
+}
+
+void NoGUIHost::MetricsThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("Metrics Export");
+
+  // Written to a temporary file and renamed, so scrapers never see a partial file.
+  const std::string temp_path = s_metrics_path + ".tmp";
+  std::unique_lock lock(s_metrics_mutex);
+  while (!s_metrics_shutdown)
+  {
+    lock.unlock();
+
+    const std::string text = FormatMetrics(System::GetPerformanceMetrics());
+    if (!FileSystem::WriteStringToFile(temp_path.c_str(), text) ||
+        !FileSystem::RenamePath(temp_path.c_str(), s_metrics_path.c_str()))
+    {
+      Log_ErrorPrintf("Failed to write metrics to '%s'", s_metrics_path.c_str());
+    }
+
+    lock.lock();
+    s_metrics_cv.wait_for(lock, std::chrono::seconds(1), []() { return s_metrics_shutdown; });
+  }
+}
+
+std::string NoGUIHost::FormatMetrics(const System::PerformanceMetrics& metrics)
+{
+  std::string ret;
+  const auto add = [&ret](const char* name, const char* type, const char* help, auto value) {
+    fmt::format_to(std::back_inserter(ret), "# HELP duckstation_{0} {1}\n# TYPE duckstation_{0} {2}\n", name, help,
+                   type);
+    fmt::format_to(std::back_inserter(ret), "duckstation_{} {}\n", name, value);
+  };
+
+  add("running", "gauge", "Whether a game is running.", metrics.running ? 1 : 0);
+  add("fps", "gauge", "Frames presented by the game per second.", metrics.fps);
+  add("vps", "gauge", "Emulated vertical blanks per second.", metrics.vps);
+  add("speed_percent", "gauge", "Emulation speed relative to the console.", metrics.speed);
+  add("frame_time_average_ms", "gauge", "Average host frame time over the last second.", metrics.average_frame_time);
+  add("frame_time_worst_ms", "gauge", "Worst host frame time over the last second.", metrics.worst_frame_time);
+  add("cpu_thread_usage_percent", "gauge", "CPU thread usage.", metrics.cpu_thread_usage);
+  add("sw_thread_usage_percent", "gauge", "GPU worker thread usage.", metrics.sw_thread_usage);
+  add("gpu_usage_percent", "gauge", "Host GPU usage, when GPU timing is enabled.", metrics.gpu_usage);
+  add("frames_total", "counter", "Frames emulated since the game started.", metrics.frame_number);
+  add("block_recompiles_total", "counter", "Code blocks recompiled after their code changed.",
+      metrics.recompile_count);
+  add("code_cache_flushes_total", "counter", "Full code cache flushes.", metrics.flush_count);
+  add("audio_underruns_total", "counter", "Times the audio output ran out of samples.", metrics.audio_underrun_count);
+  return ret;
+}
+
 void Host::RefreshGameListAsync(bool invalidate_cache)
 {
   NoGUIHost::StartAsyncOp(
@@ -1076,6 +1163,8 @@ void NoGUIHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -settings <filename>: Loads a custom settings configuration from the\n"
                        "    specified filename. Default settings applied if file not found.\n");
   std::fprintf(stderr, "  -earlyconsole: Creates console as early as possible, for logging.\n");
+  std::fprintf(stderr, "  -metricsfile <filename>: Writes performance counters to the specified\n"
+                       "    file every second, in the Prometheus text format.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -1203,6 +1292,12 @@ bool NoGUIHost::ParseCommandLineParametersAndInitializeConfig(int argc, char* ar
         InitializeEarlyConsole();
         continue;
       }
+      else if (CHECK_ARG_PARAM("-metricsfile"))
+      {
+        s_metrics_path = argv[++i];
+        Log_InfoPrintf("Command Line: Writing metrics to: %s", s_metrics_path.c_str());
+        continue;
+      }
       else if (CHECK_ARG("--"))
       {
         no_more_args = true;
@@ -1288,6 +1383,7 @@ int main(int argc, char* argv[])
   // the rest of initialization happens on the CPU thread.
   NoGUIHost::HookSignals();
   NoGUIHost::StartCPUThread();
+  NoGUIHost::StartMetricsExport();
 
   if (autoboot)
     NoGUIHost::StartSystem(std::move(autoboot.value()));
@@ -1295,6 +1391,7 @@ int main(int argc, char* argv[])
   g_nogui_window->RunMessageLoop();
 
   NoGUIHost::CancelAsyncOp();
+  NoGUIHost::StopMetricsExport();
   NoGUIHost::StopCPUThread();
 
   // Ensure log is flushed.
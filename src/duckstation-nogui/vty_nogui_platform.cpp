@@ -7,6 +7,7 @@
 #include "nogui_host.h"
 #include "resource.h"
 #include "vty_key_names.h"
+#include <cstdio>
 #include <fcntl.h>
 #include <linux/input-event-codes.h>
 #include <thread>
@@ -93,11 +94,22 @@ std::optional<WindowInfo> VTYNoGUIPlatform::GetPlatformWindowInfo()
     if (!DRMDisplay::GetCurrentMode(&wi.surface_width, &wi.surface_height, &wi.surface_refresh_rate))
       Log_ErrorPrintf("Failed to get current mode, will use default.");
   }
+
+  // render at a lower resolution and let the display plane scale it to the mode
+  const std::string scanout_resolution = Host::GetStringSettingValue("Display", "DRMScanoutResolution", "");
+  if (!scanout_resolution.empty() &&
+      std::sscanf(scanout_resolution.c_str(), "%ux%u", &wi.scanout_width, &wi.scanout_height) != 2)
+  {
+    Log_ErrorPrintf("Failed to parse scanout resolution '%s'", scanout_resolution.c_str());
+    wi.scanout_width = 0;
+    wi.scanout_height = 0;
+  }
 #endif
 
   // This isn't great, but it's an approximation at least..
-  if (wi.surface_width > 0)
-    wi.surface_scale = std::max(0.1f, static_cast<float>(wi.surface_width) / 1280.0f);
+  const u32 render_width = (wi.scanout_width > 0) ? wi.scanout_width : wi.surface_width;
+  if (render_width > 0)
+    wi.surface_scale = std::max(0.1f, static_cast<float>(render_width) / 1280.0f);
 
   return wi;
 }
@@ -3,14 +3,17 @@
 #include "common/log.h"
 #include "common/string_util.h"
 #include "common/threading.h"
+#include "common/timer.h"
 #include "core/host.h"
 #include "core/host_settings.h"
+#include "core/system.h"
 #include "nogui_host.h"
 #include "nogui_platform.h"
 
 #include <linux/input-event-codes.h>
 #include <sys/mman.h>
 #include <thread>
+#include <time.h>
 #include <unistd.h>
 
 Log_SetChannel(WaylandNoGUIPlatform);
@@ -34,6 +37,8 @@ WaylandNoGUIPlatform::~WaylandNoGUIPlatform()
     wl_seat_destroy(m_wl_seat);
   if (m_xkb_context)
     xkb_context_unref(m_xkb_context);
+  if (m_presentation)
+    wp_presentation_destroy(m_presentation);
   if (m_registry)
     wl_registry_destroy(m_registry);
 }
@@ -142,6 +147,8 @@ bool WaylandNoGUIPlatform::CreatePlatformWindow(std::string title)
   m_window_info.window_handle = m_surface;
   m_window_info.display_connection = m_display;
 
+  RequestPresentationFeedback();
+
   wl_display_dispatch_pending(m_display);
   wl_display_roundtrip(m_display);
   return true;
@@ -151,6 +158,8 @@ void WaylandNoGUIPlatform::DestroyPlatformWindow()
 {
   m_window_info = {};
 
+  DestroyPresentationFeedback();
+
   if (m_toplevel_decoration)
   {
     zxdg_toplevel_decoration_v1_destroy(m_toplevel_decoration);
@@ -231,6 +240,13 @@ void WaylandNoGUIPlatform::GlobalRegistryHandler(void* data, wl_registry* regist
     platform->m_decoration_manager = static_cast<zxdg_decoration_manager_v1*>(
       wl_registry_bind(platform->m_registry, id, &zxdg_decoration_manager_v1_interface, 1));
   }
+  else if (std::strcmp(interface, wp_presentation_interface.name) == 0)
+  {
+    static const wp_presentation_listener presentation_listener = {&WaylandNoGUIPlatform::PresentationClockID};
+    platform->m_presentation =
+      static_cast<wp_presentation*>(wl_registry_bind(platform->m_registry, id, &wp_presentation_interface, 1));
+    wp_presentation_add_listener(platform->m_presentation, &presentation_listener, platform);
+  }
   else if (std::strcmp(interface, wl_seat_interface.name) == 0)
   {
     static const wl_seat_listener seat_listener = {&WaylandNoGUIPlatform::SeatCapabilities};
@@ -410,6 +426,70 @@ void WaylandNoGUIPlatform::PointerAxis(void* data, wl_pointer* pointer, uint32_t
   NoGUIHost::ProcessPlatformMouseWheelEvent(x, y);
 }
 
+void WaylandNoGUIPlatform::RequestPresentationFeedback()
+{
+  // Feedback applies to the next commit of the surface, which the display's swap does on the CPU thread. Only one
+  // request is kept outstanding, the next is made when it completes.
+  if (!m_presentation || !m_surface || m_presentation_feedback)
+    return;
+
+  static const wp_presentation_feedback_listener feedback_listener = {
+    &WaylandNoGUIPlatform::PresentationFeedbackSyncOutput, &WaylandNoGUIPlatform::PresentationFeedbackPresented,
+    &WaylandNoGUIPlatform::PresentationFeedbackDiscarded};
+  m_presentation_feedback = wp_presentation_feedback(m_presentation, m_surface);
+  if (m_presentation_feedback)
+    wp_presentation_feedback_add_listener(m_presentation_feedback, &feedback_listener, this);
+}
+
+void WaylandNoGUIPlatform::DestroyPresentationFeedback()
+{
+  if (m_presentation_feedback)
+  {
+    wp_presentation_feedback_destroy(m_presentation_feedback);
+    m_presentation_feedback = nullptr;
+  }
+}
+
+void WaylandNoGUIPlatform::PresentationClockID(void* data, wp_presentation* presentation, uint32_t clk_id)
+{
+  // Our timer uses CLOCK_MONOTONIC, timestamps in any other domain can't be compared with it.
+  WaylandNoGUIPlatform* platform = static_cast<WaylandNoGUIPlatform*>(data);
+  platform->m_presentation_clock_monotonic = (clk_id == CLOCK_MONOTONIC);
+  if (!platform->m_presentation_clock_monotonic)
+    Log_WarningPrintf("Compositor presentation clock is %u, not CLOCK_MONOTONIC, ignoring feedback", clk_id);
+}
+
+void WaylandNoGUIPlatform::PresentationFeedbackSyncOutput(void* data, struct wp_presentation_feedback* feedback,
+                                                          wl_output* output)
+{
+}
+
+void WaylandNoGUIPlatform::PresentationFeedbackPresented(void* data, struct wp_presentation_feedback* feedback,
+                                                         uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec,
+                                                         uint32_t refresh, uint32_t seq_hi, uint32_t seq_lo,
+                                                         uint32_t flags)
+{
+  WaylandNoGUIPlatform* platform = static_cast<WaylandNoGUIPlatform*>(data);
+  platform->DestroyPresentationFeedback();
+
+  if (platform->m_presentation_clock_monotonic)
+  {
+    const u64 seconds = (static_cast<u64>(tv_sec_hi) << 32) | tv_sec_lo;
+    const double present_time_ns = static_cast<double>(seconds) * 1000000000.0 + static_cast<double>(tv_nsec);
+    System::ReportFramePresented(Common::Timer::ConvertNanosecondsToValue(present_time_ns),
+                                 Common::Timer::ConvertNanosecondsToValue(static_cast<double>(refresh)));
+  }
+
+  platform->RequestPresentationFeedback();
+}
+
+void WaylandNoGUIPlatform::PresentationFeedbackDiscarded(void* data, struct wp_presentation_feedback* feedback)
+{
+  WaylandNoGUIPlatform* platform = static_cast<WaylandNoGUIPlatform*>(data);
+  platform->DestroyPresentationFeedback();
+  platform->RequestPresentationFeedback();
+}
+
 void WaylandNoGUIPlatform::RunMessageLoop()
 {
   while (m_message_loop_running.load(std::memory_order_acquire))
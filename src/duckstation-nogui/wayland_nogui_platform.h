@@ -7,6 +7,7 @@
 
 #include "nogui_platform.h"
 
+#include "wayland-presentation-time-client-protocol.h"
 #include "wayland-xdg-decoration-client-protocol.h"
 #include "wayland-xdg-shell-client-protocol.h"
 #include <wayland-client-protocol.h>
@@ -70,6 +71,16 @@ private:
                                 uint32_t mods_latched, uint32_t mods_locked, uint32_t group);
   static void SeatCapabilities(void* data, wl_seat* seat, uint32_t capabilities);
   static void TopLevelClose(void* data, struct xdg_toplevel* xdg_toplevel);
+  static void PresentationClockID(void* data, wp_presentation* presentation, uint32_t clk_id);
+  static void PresentationFeedbackSyncOutput(void* data, struct wp_presentation_feedback* feedback,
+                                             wl_output* output);
+  static void PresentationFeedbackPresented(void* data, struct wp_presentation_feedback* feedback,
+                                            uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec, uint32_t refresh,
+                                            uint32_t seq_hi, uint32_t seq_lo, uint32_t flags);
+  static void PresentationFeedbackDiscarded(void* data, struct wp_presentation_feedback* feedback);
+
+  void RequestPresentationFeedback();
+  void DestroyPresentationFeedback();
 
   std::atomic_bool m_message_loop_running{false};
   // std::atomic_bool m_fullscreen{false};
@@ -86,6 +97,9 @@ private:
   xdg_toplevel* m_xdg_toplevel = nullptr;
   zxdg_decoration_manager_v1* m_decoration_manager = nullptr;
   zxdg_toplevel_decoration_v1* m_toplevel_decoration = nullptr;
+  wp_presentation* m_presentation = nullptr;
+  struct wp_presentation_feedback* m_presentation_feedback = nullptr;
+  bool m_presentation_clock_monotonic = false;
   wl_seat* m_wl_seat = nullptr;
   wl_keyboard* m_wl_keyboard = nullptr;
   wl_pointer* m_wl_pointer = nullptr;
@@ -251,15 +251,37 @@ void AdvancedSettingsWidget::addTweakOptions()
                         "RecompilerMemoryExceptions", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Linking"), "CPU",
                         "RecompilerBlockLinking", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Block Profile"), "CPU",
+                        "RecompilerBlockProfile", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Async Compilation"), "CPU",
+                        "RecompilerAsyncCompilation", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Trace Formation"), "CPU",
+                        "RecompilerTraceFormation", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Hot Code Layout"), "CPU",
+                        "RecompilerHotCodeLayout", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Skip CPU Idle Loops"), "CPU", "SkipIdleLoops", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("HLE BIOS Memory Routines"), "CPU",
+                        "HLEBIOSMemoryRoutines", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Write Recompiler Perf Map"), "CPU", "RecompilerPerfMap",
+                        false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Collect Recompiler Statistics"), "CPU",
+                        "RecompilerStatistics", false);
   addChoiceTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable Recompiler Fast Memory Access"), "CPU",
                        "FastmemMode", Settings::ParseCPUFastmemMode, Settings::GetCPUFastmemModeName,
                        Settings::GetCPUFastmemModeDisplayName, "CPUFastmemMode",
                        static_cast<u32>(CPUFastmemMode::Count), Settings::DEFAULT_CPU_FASTMEM_MODE);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Use Huge Pages"), "CPU", "HugePages", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Pin Threads To Performance/Efficiency Cores"), "CPU",
+                        "ThreadPinning", false);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Enable VRAM Write Texture Replacement"),
                         "TextureReplacements", "EnableVRAMWriteReplacements", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Preload Texture Replacements"), "TextureReplacements",
                         "PreloadTextures", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Load Texture Replacements In Background"),
+                        "TextureReplacements", "AsyncLoading", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Texture Replacement Cache Size (MB, 0 = Unlimited)"),
+                         "TextureReplacements", "MaxCacheSize", 0, 16384, 0);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Dump Replaceable VRAM Writes"), "TextureReplacements",
                         "DumpVRAMWrites", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Set Dumped VRAM Write Alpha Channel"),
@@ -279,14 +301,63 @@ void AdvancedSettingsWidget::addTweakOptions()
                          Settings::DEFAULT_GPU_FIFO_SIZE);
   addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("GPU Max Run-Ahead"), "Hacks", "GPUMaxRunAhead", 0, 1000,
                          Settings::DEFAULT_GPU_MAX_RUN_AHEAD);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Software Renderer Worker Threads"), "GPU",
+                         "SoftwareWorkerThreads", 0, 16, 0);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Software Renderer Tile Binning"), "GPU",
+                        "SoftwareTileBinning", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Software Readback Region Tracking"), "GPU",
+                        "SoftwareReadbackRegionTracking", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Decoded Palette Texture Cache (Vulkan)"), "GPU",
+                        "DecodedTextureCache", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Texture Mode Batching (Vulkan)"), "GPU",
+                        "TextureModeBatching", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Dynamic Resolution Scaling"), "GPU", "DynamicResolution",
+                        false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Dynamic Resolution Minimum Scale"), "GPU",
+                         "DynamicResolutionMinScale", 1, 16, 1);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Log GPU Pass Timings"), "Display", "LogGPUTimings",
+                        false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Delay Frame Start For Lower Latency"), "Display",
+                        "LatencyReduction", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Skip Frames When Running Slow"), "Display",
+                        "AutoFrameSkip", false);
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Use Debug Host GPU Device"), "GPU", "UseDebugDevice",
                         false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Vulkan Frames In Flight"), "GPU", "FramesInFlight", 2, 4,
+                         3);
+
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Mix SPU Audio On Worker Thread"), "Audio",
+                        "MixOnThread", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Skip Audio Chunks When Fast Forwarding"), "Audio",
+                        "FastForwardDecimation", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Decode MDEC Video On Worker Thread"), "MDEC",
+                        "DecodeOnThread", false);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Increase Timer Resolution"), "Main",
                         "IncreaseTimerResolution", true);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Precise Frame Throttling"), "Main", "PreciseThrottle",
+                        false);
+
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Show Input Latency"), "Display", "ShowInputLatency",
+                        false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Flash On Input Latency Present"), "Display",
+                        "InputLatencyFlash", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Poll Input On Controller Read"), "ControllerPorts",
+                        "PollInputOnRead", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Controller Read Poll Interval (us)"), "ControllerPorts",
+                         "PollInputIntervalUS", 0, 16000, Settings::DEFAULT_CONTROLLER_POLL_INPUT_INTERVAL_US);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Allow Booting Without SBI File"), "CDROM",
                         "AllowBootingWithoutSBIFile", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("CHD Hunk Cache Size"), "CDROM", "CHDHunkCacheSize", 1,
+                         256, Settings::DEFAULT_CDROM_CHD_HUNK_CACHE_SIZE);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Prefetch CHD Hunks"), "CDROM", "CHDPrefetch", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Keep Preloaded Images Compressed"), "CDROM",
+                        "PrecacheCompressed", false);
+  addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Preload Next Disc In Multi-Disc Sets"), "CDROM",
+                        "PreloadNextDisc", false);
+  addIntRangeTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Next Disc Preload Budget (MB)"), "CDROM",
+                         "PreloadNextDiscBudgetMB", 0, 4096, Settings::DEFAULT_CDROM_PRELOAD_NEXT_DISC_BUDGET_MB);
 
   addBooleanTweakOption(m_dialog, m_ui.tweakOptionTable, tr("Create Save State Backups"), "General",
                         "CreateSaveStateBackups", false);
@@ -309,9 +380,21 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
                              Settings::DEFAULT_GPU_PGXP_DEPTH_THRESHOLD); // PGXP depth clear threshold
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler memory exceptions
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);              // Recompiler block linking
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler block profile
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler async compilation
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler trace formation
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler hot code layout
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Skip idle loops
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // HLE BIOS memory routines
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler perf map
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);             // Recompiler statistics
     setChoiceTweakOption(m_ui.tweakOptionTable, i++, Settings::DEFAULT_CPU_FASTMEM_MODE); // Recompiler fastmem mode
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // Huge pages
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                             // Thread pinning
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // VRAM write texture replacement
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Preload texture replacements
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Load texture replacements in background
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);    // Texture replacement cache size
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Dump replacable VRAM writes
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false); // Set dumped VRAM write alpha channel
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
@@ -326,9 +409,36 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
                            static_cast<int>(Settings::DEFAULT_GPU_FIFO_SIZE)); // GPU FIFO size
     setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
                            static_cast<int>(Settings::DEFAULT_GPU_MAX_RUN_AHEAD)); // GPU max run-ahead
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 0);                         // Software renderer worker threads
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Software renderer tile binning
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Software readback region tracking
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Decoded palette texture cache
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Texture mode batching
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Dynamic resolution scaling
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 1);                         // Dynamic resolution min scale
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Log GPU pass timings
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Latency reduction
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Auto frame skip
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Use debug host GPU device
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++, 3);                         // Vulkan frames in flight
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Mix SPU audio on worker thread
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Fast forward audio decimation
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Decode MDEC on worker thread
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, true);                       // Increase timer resolution
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Precise frame throttling
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Show input latency
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Input latency flash
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Poll input on controller read
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
+                           static_cast<int>(Settings::DEFAULT_CONTROLLER_POLL_INPUT_INTERVAL_US)); // Poll interval
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Allow booting without SBI file
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
+                           static_cast<int>(Settings::DEFAULT_CDROM_CHD_HUNK_CACHE_SIZE)); // CHD hunk cache size
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                              // Prefetch CHD hunks
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                              // Keep preloaded images compressed
+    setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                              // Preload next disc
+    setIntRangeTweakOption(m_ui.tweakOptionTable, i++,
+                           static_cast<int>(Settings::DEFAULT_CDROM_PRELOAD_NEXT_DISC_BUDGET_MB)); // Preload budget
     setBooleanTweakOption(m_ui.tweakOptionTable, i++, false);                      // Create save state backups
 
     return;
@@ -352,9 +462,21 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("GPU", "PGXPDepthClearThreshold");
   sif->DeleteValue("CPU", "RecompilerMemoryExceptions");
   sif->DeleteValue("CPU", "RecompilerBlockLinking");
+  sif->DeleteValue("CPU", "RecompilerBlockProfile");
+  sif->DeleteValue("CPU", "RecompilerAsyncCompilation");
+  sif->DeleteValue("CPU", "RecompilerTraceFormation");
+  sif->DeleteValue("CPU", "RecompilerHotCodeLayout");
+  sif->DeleteValue("CPU", "SkipIdleLoops");
+  sif->DeleteValue("CPU", "HLEBIOSMemoryRoutines");
+  sif->DeleteValue("CPU", "RecompilerPerfMap");
+  sif->DeleteValue("CPU", "RecompilerStatistics");
   sif->DeleteValue("CPU", "FastmemMode");
+  sif->DeleteValue("CPU", "HugePages");
+  sif->DeleteValue("CPU", "ThreadPinning");
   sif->DeleteValue("TextureReplacements", "EnableVRAMWriteReplacements");
   sif->DeleteValue("TextureReplacements", "PreloadTextures");
+  sif->DeleteValue("TextureReplacements", "AsyncLoading");
+  sif->DeleteValue("TextureReplacements", "MaxCacheSize");
   sif->DeleteValue("TextureReplacements", "DumpVRAMWrites");
   sif->DeleteValue("TextureReplacements", "DumpVRAMWriteForceAlphaChannel");
   sif->DeleteValue("TextureReplacements", "DumpVRAMWriteWidthThreshold");
@@ -363,9 +485,33 @@ void AdvancedSettingsWidget::onResetToDefaultClicked()
   sif->DeleteValue("Hacks", "DMAHaltTicks");
   sif->DeleteValue("Hacks", "GPUFIFOSize");
   sif->DeleteValue("Hacks", "GPUMaxRunAhead");
+  sif->DeleteValue("GPU", "SoftwareWorkerThreads");
+  sif->DeleteValue("GPU", "SoftwareTileBinning");
+  sif->DeleteValue("GPU", "SoftwareReadbackRegionTracking");
+  sif->DeleteValue("GPU", "DecodedTextureCache");
+  sif->DeleteValue("GPU", "TextureModeBatching");
+  sif->DeleteValue("GPU", "DynamicResolution");
+  sif->DeleteValue("GPU", "DynamicResolutionMinScale");
+  sif->DeleteValue("Display", "LogGPUTimings");
+  sif->DeleteValue("Display", "LatencyReduction");
+  sif->DeleteValue("Display", "AutoFrameSkip");
   sif->DeleteValue("GPU", "UseDebugDevice");
+  sif->DeleteValue("GPU", "FramesInFlight");
+  sif->DeleteValue("Audio", "MixOnThread");
+  sif->DeleteValue("Audio", "FastForwardDecimation");
+  sif->DeleteValue("MDEC", "DecodeOnThread");
   sif->DeleteValue("Main", "IncreaseTimerResolution");
+  sif->DeleteValue("Main", "PreciseThrottle");
+  sif->DeleteValue("Display", "ShowInputLatency");
+  sif->DeleteValue("Display", "InputLatencyFlash");
+  sif->DeleteValue("ControllerPorts", "PollInputOnRead");
+  sif->DeleteValue("ControllerPorts", "PollInputIntervalUS");
   sif->DeleteValue("CDROM", "AllowBootingWithoutSBIFile");
+  sif->DeleteValue("CDROM", "CHDHunkCacheSize");
+  sif->DeleteValue("CDROM", "CHDPrefetch");
+  sif->DeleteValue("CDROM", "PrecacheCompressed");
+  sif->DeleteValue("CDROM", "PreloadNextDisc");
+  sif->DeleteValue("CDROM", "PreloadNextDiscBudgetMB");
   sif->DeleteValue("General", "CreateSaveStateBackups");
   sif->Save();
   while (m_ui.tweakOptionTable->rowCount() > 0)
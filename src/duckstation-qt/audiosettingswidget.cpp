@@ -84,7 +84,8 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsDialog* dialog, QWidget* parent
   dialog->registerWidgetHelp(
     m_ui.stretchMode, tr("Stretch Mode"), tr("Time Stretching"),
     tr("When running outside of 100% speed, adjusts the tempo on audio instead of dropping frames. Produces "
-       "much nicer fast forward/slowdown audio at a small cost to performance."));
+       "much nicer fast forward/slowdown audio at a small cost to performance. Rate Control keeps the buffer as small "
+       "as the host allows by slightly adjusting the playback rate, for the lowest latency."));
 }
 
 AudioSettingsWidget::~AudioSettingsWidget() = default;
@@ -15,10 +15,15 @@ BIOSSettingsWidget::BIOSSettingsWidget(SettingsDialog* dialog, QWidget* parent)
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.enableTTYOutput, "BIOS", "PatchTTYEnable", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.fastBoot, "BIOS", "PatchFastBoot", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.bootSnapshot, "BIOS", "BootSnapshot", false);
 
   dialog->registerWidgetHelp(m_ui.fastBoot, tr("Fast Boot"), tr("Unchecked"),
                              tr("Patches the BIOS to skip the console's boot animation. Does not work with all games, "
                                 "but usually safe to enable."));
+  dialog->registerWidgetHelp(
+    m_ui.bootSnapshot, tr("Cache Boot Snapshot"), tr("Unchecked"),
+    tr("Saves the console state when a fast boot reaches the BIOS shell, and restores it on later boots with the same "
+       "BIOS and region, skipping the BIOS startup. Only used when fast boot is enabled."));
   dialog->registerWidgetHelp(
     m_ui.enableTTYOutput, tr("Enable TTY Output"), tr("Unchecked"),
     tr("Patches the BIOS to log calls to printf(). Only use when debugging, can break games."));
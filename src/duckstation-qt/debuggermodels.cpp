@@ -1,4 +1,5 @@
 #include "debuggermodels.h"
+#include "core/cpu_code_cache.h"
 #include "core/cpu_core.h"
 #include "core/cpu_core_private.h"
 #include "core/cpu_disasm.h"
@@ -151,6 +152,21 @@ QVariant DebuggerCodeModel::data(const QModelIndex& index, int role /*= Qt::Disp
     else
       return QVariant();
   }
+  else if (role == Qt::ToolTipRole)
+  {
+    // code cache block statistics, useful for tracking down self-modifying code
+    CPU::CodeCache::BlockStatistics stats;
+    if (index.column() != 1 || !CPU::CodeCache::GetBlockStatistics(getAddressForRow(index.row()), &stats))
+      return QVariant();
+
+    return tr("Block: %1 instructions%2\nRecompiled %3 times since frame %4\nLast invalidated at frame %5%6")
+      .arg(stats.instruction_count)
+      .arg(stats.invalidated ? tr(" (invalidated)") : QString())
+      .arg(stats.recompile_count)
+      .arg(stats.recompile_frame_number)
+      .arg(stats.invalidate_frame_number)
+      .arg(stats.can_link ? QString() : tr("\nLinking disabled"));
+  }
   else
   {
     return QVariant();
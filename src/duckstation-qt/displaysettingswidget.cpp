@@ -120,8 +120,9 @@ DisplaySettingsWidget::DisplaySettingsWidget(SettingsDialog* dialog, QWidget* pa
     tr("Enable this option to match DuckStation's refresh rate with your current monitor or screen. "
        "VSync is automatically disabled when it is not possible (e.g. running at non-100% speed)."));
   dialog->registerWidgetHelp(m_ui.threadedPresentation, tr("Threaded Presentation"), tr("Checked"),
-                             tr("Presents frames on a background thread when fast forwarding or vsync is disabled. "
-                                "This can measurably improve performance in the Vulkan renderer."));
+                             tr("Presents frames on a background thread. In the Vulkan renderer this only applies "
+                                "when fast forwarding or vsync is disabled, and can measurably improve performance. "
+                                "In the D3D11 and D3D12 renderers, the next frame can start while waiting for vsync."));
   dialog->registerWidgetHelp(m_ui.gpuThread, tr("Threaded Rendering"), tr("Checked"),
                              tr("Uses a second thread for drawing graphics. Currently only available for the software "
                                 "renderer, but can provide a significant speed improvement, and is safe to use."));
@@ -194,10 +195,12 @@ void DisplaySettingsWidget::populateGPUAdaptersAndResolutions()
 #ifdef _WIN32
     case GPURenderer::HardwareD3D11:
       aml = D3D11HostDisplay::StaticGetAdapterAndModeList();
+      threaded_presentation_supported = true;
       break;
 
     case GPURenderer::HardwareD3D12:
       aml = D3D12HostDisplay::StaticGetAdapterAndModeList();
+      threaded_presentation_supported = true;
       break;
 #endif
 #ifdef WITH_VULKAN
@@ -16,6 +16,9 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsDialog* dialog, QWidget
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.syncToHostRefreshRate, "Main", "SyncToHostRefreshRate", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.displayAllFrames, "Display", "DisplayAllFrames", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.vrrFramePacing, "Display", "VRRFramePacing", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.skipDuplicateFrames, "Display", "SkipDuplicateFrames",
+                                               false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.rewindEnable, "Main", "RewindEnable", false);
   SettingWidgetBinder::BindWidgetToFloatSetting(sif, m_ui.rewindSaveFrequency, "Main", "RewindFrequency", 10.0f);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.rewindSaveSlots, "Main", "RewindSaveSlots", 10);
@@ -96,6 +99,16 @@ EmulationSettingsWidget::EmulationSettingsWidget(SettingsDialog* dialog, QWidget
                              tr("Enable this option will ensure every frame the console renders is displayed to the "
                                 "screen, for optimal frame pacing. If you are having difficulties maintaining full "
                                 "speed, or are getting audio glitches, try disabling this option."));
+  dialog->registerWidgetHelp(
+    m_ui.vrrFramePacing, tr("Variable Refresh Rate Pacing"), tr("Unchecked"),
+    tr("For displays which support variable refresh rate (G-Sync/FreeSync). Frames are presented as soon as the "
+       "emulator's own throttling says they are due, without waiting for VSync, so the display refreshes at the "
+       "console's exact rate with the lowest latency. Overrides VSync and Sync To Host Refresh Rate."));
+  dialog->registerWidgetHelp(
+    m_ui.skipDuplicateFrames, tr("Skip Duplicate Frames"), tr("Unchecked"),
+    tr("Does not draw or present frames which are identical to the previous one, e.g. in games which run at 30 FPS, "
+       "leaving the last frame on screen instead. Saves GPU power, which is useful on battery powered devices. Has no "
+       "effect when the emulator is throttled by VSync."));
   dialog->registerWidgetHelp(
     m_ui.rewindEnable, tr("Rewinding"), tr("Unchecked"),
     tr("<b>Enable Rewinding:</b> Saves state periodically so you can rewind any mistakes while playing.<br> "
@@ -2,10 +2,12 @@
 #include "common/file_system.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "core/settings.h"
 #include "core/system.h"
 #include "qthost.h"
 #include "qtutils.h"
 #include <QtConcurrent/QtConcurrent>
+#include <QtCore/QCryptographicHash>
 #include <QtCore/QDate>
 #include <QtCore/QDateTime>
 #include <QtCore/QFuture>
@@ -114,17 +116,27 @@ const char* GameListModel::getColumnName(Column col)
 GameListModel::GameListModel(QObject* parent /* = nullptr */)
   : QAbstractTableModel(parent), m_cover_pixmap_cache(MIN_COVER_CACHE_SIZE)
 {
+  const std::string thumbnail_directory(Path::Combine(EmuFolders::Cache, "thumbnails"));
+  if (!EmuFolders::Cache.empty() && FileSystem::EnsureDirectoryExists(thumbnail_directory.c_str(), false))
+    m_cover_thumbnail_directory = QString::fromStdString(thumbnail_directory);
+
   loadCommonImages();
   setCoverScale(1.0f);
   setColumnDisplayNames();
 }
-GameListModel::~GameListModel() = default;
+
+GameListModel::~GameListModel()
+{
+  cancelCoverLoads();
+  m_cover_thread_pool.waitForDone();
+}
 
 void GameListModel::setCoverScale(float scale)
 {
   if (m_cover_scale == scale)
     return;
 
+  cancelCoverLoads();
   m_cover_pixmap_cache.Clear();
   m_cover_scale = scale;
   m_loading_pixmap = QPixmap(getCoverArtWidth(), getCoverArtHeight());
@@ -133,6 +145,7 @@ void GameListModel::setCoverScale(float scale)
 
 void GameListModel::refreshCovers()
 {
+  cancelCoverLoads();
   m_cover_pixmap_cache.Clear();
   refresh();
 }
@@ -153,33 +166,105 @@ void GameListModel::reloadCommonImages()
   refresh();
 }
 
+void GameListModel::cancelCoverLoads()
+{
+  // anything already running will see the new generation and throw its result away
+  m_cover_thread_pool.clear();
+  m_cover_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+QString GameListModel::getCoverThumbnailPath(const std::string& cover_path, int width, int height) const
+{
+  FILESYSTEM_STAT_DATA sd;
+  if (m_cover_thumbnail_directory.isEmpty() || !FileSystem::StatFile(cover_path.c_str(), &sd))
+    return {};
+
+  // keyed on the modification time, so replacing a cover regenerates the thumbnail
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(QStringLiteral("%1|%2|%3x%4")
+                 .arg(QString::fromStdString(cover_path))
+                 .arg(static_cast<qint64>(sd.ModificationTime))
+                 .arg(width)
+                 .arg(height)
+                 .toUtf8());
+  return QStringLiteral("%1/%2.png").arg(m_cover_thumbnail_directory).arg(QString::fromLatin1(hash.result().toHex()));
+}
+
+QImage GameListModel::loadCoverImage(const std::string& cover_path, int width, int height) const
+{
+  const QString thumbnail_path(getCoverThumbnailPath(cover_path, width, height));
+  if (!thumbnail_path.isEmpty())
+  {
+    QImage thumbnail;
+    if (thumbnail.load(thumbnail_path))
+      return thumbnail;
+  }
+
+  QImage image(QString::fromStdString(cover_path));
+  if (image.isNull() || (image.width() <= width && image.height() <= height))
+    return image;
+
+  image = image.scaled(width, height, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+  if (!thumbnail_path.isEmpty() && !image.save(thumbnail_path))
+    qWarning("Failed to save cover thumbnail to '%s'", thumbnail_path.toUtf8().constData());
+
+  return image;
+}
+
 void GameListModel::loadOrGenerateCover(const GameList::Entry* ge)
 {
-  QFuture<QPixmap> future =
-    QtConcurrent::run([this, path = ge->path, title = ge->title, serial = ge->serial]() -> QPixmap {
-      QPixmap image;
-      const std::string cover_path(GameList::GetCoverImagePath(path, serial, title));
-      if (!cover_path.empty())
+  const float dpr = qApp->devicePixelRatio();
+  const int width = getCoverArtWidth();
+  const int height = getCoverArtHeight();
+  const u32 generation = m_cover_generation.load(std::memory_order_acquire);
+  const u32 request = m_cover_request_counter.fetch_add(1, std::memory_order_acq_rel) + 1;
+  const u32 max_pending = static_cast<u32>(m_cover_pixmap_cache.GetMaxCapacity());
+
+  QFuture<std::optional<QImage>> future =
+    QtConcurrent::task([this, path = ge->path, title = ge->title, serial = ge->serial, generation, request,
+                        max_pending, dpr_width = DPRScale(width, dpr),
+                        dpr_height = DPRScale(height, dpr)]() -> std::optional<QImage> {
+      // if enough newer covers have been requested to push this one out of the cache, it's no longer visible
+      if (generation != m_cover_generation.load(std::memory_order_acquire) ||
+          (m_cover_request_counter.load(std::memory_order_acquire) - request) > max_pending)
       {
-        const float dpr = qApp->devicePixelRatio();
-        image = QPixmap(QString::fromStdString(cover_path));
-        if (!image.isNull())
-        {
-          image.setDevicePixelRatio(dpr);
-          resizeAndPadPixmap(&image, getCoverArtWidth(), getCoverArtHeight(), dpr);
-        }
+        return std::nullopt;
       }
 
-      if (image.isNull())
-        image =
-          createPlaceholderImage(m_placeholder_pixmap, getCoverArtWidth(), getCoverArtHeight(), m_cover_scale, title);
+      const std::string cover_path(GameList::GetCoverImagePath(path, serial, title));
+      return cover_path.empty() ? QImage() : loadCoverImage(cover_path, dpr_width, dpr_height);
+    })
+      .onThreadPool(m_cover_thread_pool)
+      .withPriority(static_cast<int>(request & 0x7FFFFFFFu))
+      .spawn();
+
+  // Context must be 'this' so we run on the UI thread, QPixmap can't be used elsewhere.
+  future.then(this, [this, path = ge->path, title = ge->title, generation, width, height,
+                     dpr](std::optional<QImage> image) {
+    if (generation != m_cover_generation.load(std::memory_order_acquire))
+      return;
+
+    if (!image.has_value())
+    {
+      // skipped, drop the loading placeholder so it's requested again if the row does come back into view
+      m_cover_pixmap_cache.Remove(path);
+      invalidateCoverForPath(path);
+      return;
+    }
 
-      return image;
-    });
+    QPixmap pm;
+    if (!image->isNull())
+    {
+      pm = QPixmap::fromImage(std::move(image.value()));
+      pm.setDevicePixelRatio(dpr);
+      resizeAndPadPixmap(&pm, width, height, dpr);
+    }
+    else
+    {
+      pm = createPlaceholderImage(m_placeholder_pixmap, width, height, m_cover_scale, title);
+    }
 
-  // Context must be 'this' so we run on the UI thread.
-  future.then(this, [this, path = ge->path](QPixmap pm) {
-    m_cover_pixmap_cache.Insert(std::move(path), std::move(pm));
+    m_cover_pixmap_cache.Insert(path, std::move(pm));
     invalidateCoverForPath(path);
   });
 }
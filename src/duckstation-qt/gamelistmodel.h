@@ -5,9 +5,12 @@
 #include "core/types.h"
 #include "frontend-common/game_list.h"
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QThreadPool>
+#include <QtGui/QImage>
 #include <QtGui/QPixmap>
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <optional>
 
 class GameListModel final : public QAbstractTableModel
@@ -72,6 +75,9 @@ private:
   void setColumnDisplayNames();
   void loadOrGenerateCover(const GameList::Entry* ge);
   void invalidateCoverForPath(const std::string& path);
+  void cancelCoverLoads();
+  QImage loadCoverImage(const std::string& cover_path, int width, int height) const;
+  QString getCoverThumbnailPath(const std::string& cover_path, int width, int height) const;
 
   float m_cover_scale = 0.0f;
   bool m_show_titles_for_covers = false;
@@ -85,4 +91,11 @@ private:
   QPixmap m_loading_pixmap;
 
   mutable LRUCache<std::string, QPixmap> m_cover_pixmap_cache;
+
+  // Covers are decoded on their own pool, newest request first. Requests which have fallen further behind than the
+  // cache can hold have been scrolled past, and are dropped before they start.
+  QThreadPool m_cover_thread_pool;
+  std::atomic<u32> m_cover_generation{0};
+  std::atomic<u32> m_cover_request_counter{0};
+  QString m_cover_thumbnail_directory;
 };
\ No newline at end of file
@@ -23,6 +23,7 @@ GeneralSettingsWidget::GeneralSettingsWidget(SettingsDialog* dialog, QWidget* pa
                                                false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.applyGameSettings, "Main", "ApplyGameSettings", true);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.autoLoadCheats, "Main", "AutoLoadCheats", true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.autoTunePerformance, "Main", "AutoTunePerformance", false);
 
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.startFullscreen, "Main", "StartFullscreen", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.doubleClickTogglesFullscreen, "Main",
@@ -80,6 +81,11 @@ GeneralSettingsWidget::GeneralSettingsWidget(SettingsDialog* dialog, QWidget* pa
        "leave this option enabled except when testing enhancements with incompatible games."));
   dialog->registerWidgetHelp(m_ui.autoLoadCheats, tr("Automatically Load Cheats"), tr("Unchecked"),
                              tr("Automatically loads and applies cheats on game start."));
+  dialog->registerWidgetHelp(
+    m_ui.autoTunePerformance, tr("Auto-Tune Per-Game Performance"), tr("Unchecked"),
+    tr("Records how often each game runs at full speed at each resolution scale, and on later launches lowers the "
+       "resolution scale below the configured one if it did not hold full speed on this system. The history is "
+       "stored in the game's per-game settings file."));
 
 #ifdef WITH_DISCORD_PRESENCE
   {
@@ -29,6 +29,7 @@
 #include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtCore/QMimeData>
+#include <QtCore/QTimer>
 #include <QtCore/QUrl>
 #include <QtGui/QActionGroup>
 #include <QtGui/QCursor>
@@ -76,6 +77,9 @@ static bool s_use_central_widget = false;
 #endif
 
 // UI thread VM validity.
+/// How often the status bar picks up new performance counters. They only change once a second.
+static constexpr int STATUS_UPDATE_INTERVAL_MS = 250;
+
 static bool s_system_valid = false;
 static bool s_system_paused = false;
 
@@ -549,6 +553,7 @@ void MainWindow::onSystemStarted()
   updateEmulationActions(false, true, Achievements::ChallengeModeActive());
   updateWindowTitle();
   updateStatusBarWidgetVisibility();
+  m_status_update_timer->start();
 }
 
 void MainWindow::onSystemPaused()
@@ -560,6 +565,7 @@ void MainWindow::onSystemPaused()
   }
 
   s_system_paused = true;
+  m_status_update_timer->stop();
   updateStatusBarWidgetVisibility();
   m_ui.statusBar->showMessage(tr("Paused"));
   if (m_display_widget)
@@ -578,6 +584,7 @@ void MainWindow::onSystemResumed()
   m_was_disc_change_request = false;
   m_ui.statusBar->clearMessage();
   updateStatusBarWidgetVisibility();
+  m_status_update_timer->start();
   if (m_display_widget)
   {
     updateDisplayWidgetCursor();
@@ -585,6 +592,39 @@ void MainWindow::onSystemResumed()
   }
 }
 
+void MainWindow::updateStatusBarPerformanceCounters()
+{
+  const EmuThread::PerformanceCounters& pc = g_emu_thread->getPerformanceCounters();
+  const u32 generation = pc.generation.load(std::memory_order_acquire);
+  if (generation == m_last_performance_counters_generation)
+    return;
+
+  m_last_performance_counters_generation = generation;
+
+  const GPURenderer renderer = pc.renderer.load(std::memory_order_relaxed);
+  if (renderer == GPURenderer::Count)
+  {
+    m_status_renderer_widget->clear();
+    m_status_resolution_widget->clear();
+    m_status_fps_widget->clear();
+    m_status_vps_widget->clear();
+    return;
+  }
+
+  // QLabel::setText() skips the relayout when the text hasn't changed. The strings keep their old EmuThread context
+  // so existing translations still apply.
+  const float speed = pc.speed.load(std::memory_order_relaxed);
+  m_status_renderer_widget->setText(QString::fromUtf8(Settings::GetRendererName(renderer)));
+  m_status_resolution_widget->setText(qApp->translate("EmuThread", "%1x%2")
+                                        .arg(pc.render_width.load(std::memory_order_relaxed))
+                                        .arg(pc.render_height.load(std::memory_order_relaxed)));
+  m_status_fps_widget->setText(
+    qApp->translate("EmuThread", "Game: %1 FPS").arg(pc.game_fps.load(std::memory_order_relaxed), 0, 'f', 0));
+  m_status_vps_widget->setText(qApp->translate("EmuThread", "Video: %1 FPS (%2%)")
+                                 .arg(pc.video_fps.load(std::memory_order_relaxed), 0, 'f', 0)
+                                 .arg(speed, 0, 'f', 0));
+}
+
 void MainWindow::onSystemDestroyed()
 {
   // update UI
@@ -595,6 +635,8 @@ void MainWindow::onSystemDestroyed()
 
   s_system_valid = false;
   s_system_paused = false;
+  m_status_update_timer->stop();
+  updateStatusBarPerformanceCounters();
   updateEmulationActions(false, false, Achievements::ChallengeModeActive());
   switchToGameListView();
 
@@ -1483,6 +1525,10 @@ void MainWindow::setupAdditionalUi()
   m_status_vps_widget->setFixedSize(125, 16);
   m_status_vps_widget->hide();
 
+  m_status_update_timer = new QTimer(this);
+  m_status_update_timer->setInterval(STATUS_UPDATE_INTERVAL_MS);
+  connect(m_status_update_timer, &QTimer::timeout, this, &MainWindow::updateStatusBarPerformanceCounters);
+
   m_ui.actionGridViewShowTitles->setChecked(m_game_list_widget->getShowGridCoverTitles());
 
   updateDebugMenuVisibility();
@@ -1786,8 +1832,8 @@ bool MainWindow::isRenderingToMain() const
 
 bool MainWindow::shouldHideMouseCursor() const
 {
-  return m_hide_mouse_cursor ||
-         (isRenderingFullscreen() && Host::GetBoolSettingValue("Main", "HideCursorInFullscreen", true));
+  static Host::CachedSettingValue<bool> s_hide_cursor_in_fullscreen("Main", "HideCursorInFullscreen", true);
+  return m_hide_mouse_cursor || (isRenderingFullscreen() && s_hide_cursor_in_fullscreen.Get());
 }
 
 bool MainWindow::shouldHideMainWindow() const
@@ -2004,6 +2050,12 @@ void MainWindow::connectSignals()
                                                false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowMDECState, "Debug", "ShowMDECState", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowDMAState, "Debug", "ShowDMAState", false);
+#ifdef WITH_MMIO_PROFILER
+  SettingWidgetBinder::BindWidgetToBoolSetting(nullptr, m_ui.actionDebugShowMMIOAccessCounters, "Debug",
+                                               "ShowMMIOAccessCounters", false);
+#else
+  m_ui.actionDebugShowMMIOAccessCounters->setVisible(false);
+#endif
 
   addThemeToMenu(tr("Default"), QStringLiteral("default"));
   addThemeToMenu(tr("Fusion"), QStringLiteral("fusion"));
@@ -16,6 +16,7 @@
 class QLabel;
 class QThread;
 class QProgressBar;
+class QTimer;
 
 class GameListWidget;
 class EmuThread;
@@ -83,10 +84,6 @@ public:
   SystemLock pauseAndLockSystem();
 
   /// Accessors for the status bar widgets, updated by the emulation thread.
-  ALWAYS_INLINE QLabel* getStatusRendererWidget() const { return m_status_renderer_widget; }
-  ALWAYS_INLINE QLabel* getStatusResolutionWidget() const { return m_status_resolution_widget; }
-  ALWAYS_INLINE QLabel* getStatusFPSWidget() const { return m_status_fps_widget; }
-  ALWAYS_INLINE QLabel* getStatusVPSWidget() const { return m_status_vps_widget; }
 
 public Q_SLOTS:
   /// Updates debug menu visibility (hides if disabled).
@@ -121,6 +118,7 @@ private Q_SLOTS:
   void onSystemDestroyed();
   void onSystemPaused();
   void onSystemResumed();
+  void updateStatusBarPerformanceCounters();
   void onRunningGameChanged(const QString& filename, const QString& game_serial, const QString& game_title);
   void onAchievementsChallengeModeChanged();
   void onApplicationStateChanged(Qt::ApplicationState state);
@@ -257,6 +255,8 @@ private:
   QLabel* m_status_fps_widget = nullptr;
   QLabel* m_status_vps_widget = nullptr;
   QLabel* m_status_resolution_widget = nullptr;
+  QTimer* m_status_update_timer = nullptr;
+  u32 m_last_performance_counters_generation = 0;
 
   SettingsDialog* m_settings_dialog = nullptr;
   ControllerSettingsDialog* m_controller_settings_dialog = nullptr;
@@ -6,6 +6,7 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "common/window_info.h"
 #include "core/cheats.h"
 #include "core/controller.h"
@@ -1249,9 +1250,7 @@ void EmuThread::dumpRAM(const QString& filename)
   }
 
   const std::string filename_str = filename.toStdString();
-  if (System::DumpRAM(filename_str.c_str()))
-    Host::AddOSDMessage(fmt::format("RAM dumped to '{}'", filename_str), 10.0f);
-  else
+  if (!System::DumpRAM(filename_str.c_str()))
     Host::ReportErrorAsync("Error", fmt::format("Failed to dump RAM to '{}'", filename_str));
 }
 
@@ -1264,9 +1263,7 @@ void EmuThread::dumpVRAM(const QString& filename)
   }
 
   const std::string filename_str = filename.toStdString();
-  if (System::DumpVRAM(filename_str.c_str()))
-    Host::AddOSDMessage(fmt::format("VRAM dumped to '{}'", filename_str), 10.0f);
-  else
+  if (!System::DumpVRAM(filename_str.c_str()))
     Host::ReportErrorAsync("Error", fmt::format("Failed to dump VRAM to '{}'", filename_str));
 }
 
@@ -1279,9 +1276,7 @@ void EmuThread::dumpSPURAM(const QString& filename)
   }
 
   const std::string filename_str = filename.toStdString();
-  if (System::DumpSPURAM(filename_str.c_str()))
-    Host::AddOSDMessage(fmt::format("SPU RAM dumped to '{}'", filename_str), 10.0f);
-  else
+  if (!System::DumpSPURAM(filename_str.c_str()))
     Host::ReportErrorAsync("Error", fmt::format("Failed to dump SPU RAM to '{}'", filename_str));
 }
 
@@ -1466,7 +1461,10 @@ void EmuThread::renderDisplay(bool skip_present)
     ImGuiManager::RenderDebugWindows();
   }
 
-  g_host_display->Render(skip_present);
+  {
+    TRACE_SCOPE("HostDisplay::Render");
+    g_host_display->Render(skip_present);
+  }
 
   ImGuiManager::NewFrame();
 }
@@ -1628,58 +1626,27 @@ void EmuThread::updatePerformanceCounters()
     std::tie(render_width, render_height) = g_gpu->GetEffectiveDisplayResolution();
   }
 
-  if (renderer != m_last_renderer)
-  {
-    QMetaObject::invokeMethod(g_main_window->getStatusRendererWidget(), "setText", Qt::QueuedConnection,
-                              Q_ARG(const QString&, QString::fromUtf8(Settings::GetRendererName(renderer))));
-    m_last_renderer = renderer;
-  }
-  if (render_width != m_last_render_width || render_height != m_last_render_height)
-  {
-    QMetaObject::invokeMethod(g_main_window->getStatusResolutionWidget(), "setText", Qt::QueuedConnection,
-                              Q_ARG(const QString&, tr("%1x%2").arg(render_width).arg(render_height)));
-    m_last_render_width = render_width;
-    m_last_render_height = render_height;
-  }
-
-  const float gfps = System::GetFPS();
-  if (gfps != m_last_game_fps)
-  {
-    QMetaObject::invokeMethod(g_main_window->getStatusFPSWidget(), "setText", Qt::QueuedConnection,
-                              Q_ARG(const QString&, tr("Game: %1 FPS").arg(gfps, 0, 'f', 0)));
-    m_last_game_fps = gfps;
-  }
-
-  const float speed = System::GetEmulationSpeed();
-  const float vfps = System::GetVPS();
-  if (speed != m_last_speed || vfps != m_last_video_fps)
-  {
-    QMetaObject::invokeMethod(
-      g_main_window->getStatusVPSWidget(), "setText", Qt::QueuedConnection,
-      Q_ARG(const QString&, tr("Video: %1 FPS (%2%)").arg(vfps, 0, 'f', 0).arg(speed, 0, 'f', 0)));
-    m_last_speed = speed;
-    m_last_video_fps = vfps;
-  }
+  // Only raw values are published here, the UI thread formats them when it next polls.
+  PerformanceCounters& pc = m_performance_counters;
+  pc.speed.store(System::GetEmulationSpeed(), std::memory_order_relaxed);
+  pc.game_fps.store(System::GetFPS(), std::memory_order_relaxed);
+  pc.video_fps.store(System::GetVPS(), std::memory_order_relaxed);
+  pc.render_width.store(render_width, std::memory_order_relaxed);
+  pc.render_height.store(render_height, std::memory_order_relaxed);
+  pc.renderer.store(renderer, std::memory_order_relaxed);
+  pc.generation.fetch_add(1, std::memory_order_release);
 }
 
 void EmuThread::resetPerformanceCounters()
 {
-  m_last_speed = std::numeric_limits<float>::infinity();
-  m_last_game_fps = std::numeric_limits<float>::infinity();
-  m_last_video_fps = std::numeric_limits<float>::infinity();
-  m_last_render_width = std::numeric_limits<u32>::max();
-  m_last_render_height = std::numeric_limits<u32>::max();
-  m_last_renderer = GPURenderer::Count;
-
-  QString blank;
-  QMetaObject::invokeMethod(g_main_window->getStatusRendererWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
-  QMetaObject::invokeMethod(g_main_window->getStatusResolutionWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
-  QMetaObject::invokeMethod(g_main_window->getStatusFPSWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
-  QMetaObject::invokeMethod(g_main_window->getStatusVPSWidget(), "setText", Qt::QueuedConnection,
-                            Q_ARG(const QString&, blank));
+  PerformanceCounters& pc = m_performance_counters;
+  pc.speed.store(0.0f, std::memory_order_relaxed);
+  pc.game_fps.store(0.0f, std::memory_order_relaxed);
+  pc.video_fps.store(0.0f, std::memory_order_relaxed);
+  pc.render_width.store(0, std::memory_order_relaxed);
+  pc.render_height.store(0, std::memory_order_relaxed);
+  pc.renderer.store(GPURenderer::Count, std::memory_order_relaxed);
+  pc.generation.fetch_add(1, std::memory_order_release);
 }
 
 void Host::OnPerformanceCountersUpdated()
@@ -75,6 +75,21 @@ public:
     bool m_was_fullscreen;
   };
 
+  /// Latest performance counter values. Written by the emu thread when they're updated, and polled by the UI thread
+  /// at its own rate, so a busy UI doesn't build up a queue of status bar updates.
+  struct PerformanceCounters
+  {
+    std::atomic<float> speed{0.0f};
+    std::atomic<float> game_fps{0.0f};
+    std::atomic<float> video_fps{0.0f};
+    std::atomic<u32> render_width{0};
+    std::atomic<u32> render_height{0};
+    std::atomic<GPURenderer> renderer{GPURenderer::Count};
+
+    /// Incremented after each update, so the reader can skip unchanged values.
+    std::atomic<u32> generation{0};
+  };
+
 public:
   explicit EmuThread(QThread* ui_thread);
   ~EmuThread();
@@ -90,6 +105,7 @@ public:
   ALWAYS_INLINE bool isRenderingToMain() const { return m_is_rendering_to_main; }
   ALWAYS_INLINE bool isSurfaceless() const { return m_is_surfaceless; }
   ALWAYS_INLINE bool isRunningFullscreenUI() const { return m_run_fullscreen_ui; }
+  ALWAYS_INLINE const PerformanceCounters& getPerformanceCounters() const { return m_performance_counters; }
 
   bool acquireHostDisplay(RenderAPI api);
   void connectDisplaySignals(DisplayWidget* widget);
@@ -223,12 +239,7 @@ private:
 
   bool m_was_paused_by_focus_loss = false;
 
-  float m_last_speed = std::numeric_limits<float>::infinity();
-  float m_last_game_fps = std::numeric_limits<float>::infinity();
-  float m_last_video_fps = std::numeric_limits<float>::infinity();
-  u32 m_last_render_width = std::numeric_limits<u32>::max();
-  u32 m_last_render_height = std::numeric_limits<u32>::max();
-  GPURenderer m_last_renderer = GPURenderer::Count;
+  PerformanceCounters m_performance_counters;
 };
 
 extern EmuThread* g_emu_thread;
@@ -0,0 +1,594 @@
+#include "regtest_benchmarks.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/heap_array.h"
+#include "common/log.h"
+#include "common/rectangle.h"
+#include "common/timer.h"
+#include "core/bus.h"
+#include "core/cpu_core.h"
+#include "core/gpu_sw_backend.h"
+#include "core/gte.h"
+#include "core/mdec.h"
+#include "core/save_state_version.h"
+#include "core/settings.h"
+#include "core/spu.h"
+#include "core/system.h"
+#include "core/timing_event.h"
+#include "fmt/format.h"
+#include "util/cd_image.h"
+#include "util/state_wrapper.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <memory>
+#include <vector>
+Log_SetChannel(RegTestBenchmarks);
+
+namespace {
+struct BenchmarkResult
+{
+  std::string name;
+  u32 iterations;
+  double ns_per_op;
+};
+
+// xorshift32 with a fixed seed, so every run and every build sees the same inputs
+class FixedRandom
+{
+public:
+  ALWAYS_INLINE u32 Next()
+  {
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+    return m_state;
+  }
+
+  ALWAYS_INLINE u32 Next(u32 range) { return Next() % range; }
+
+private:
+  u32 m_state = 0x2545F491u;
+};
+
+struct BenchTriangle
+{
+  s32 x[3];
+  s32 y[3];
+  u32 color[3];
+  u16 texcoord[3];
+};
+} // namespace
+
+namespace RegTestBenchmarks {
+template<typename T>
+static void RunBenchmark(const char* name, const T& func);
+static bool IsSelected(const char* name);
+
+static void RunGTEBenchmarks();
+static bool RunGPUBenchmarks();
+static void RunMDECBenchmarks();
+static void RunSPUBenchmarks();
+static bool RunStateBenchmarks();
+static void RunTimingEventBenchmarks();
+static bool RunCDImageBenchmarks(const std::string& image_path);
+static bool WriteResults(const std::string& path);
+} // namespace RegTestBenchmarks
+
+// each benchmark is repeated until a single run takes at least this long, then the best of several runs is kept
+static constexpr double MIN_RUN_SECONDS = 0.2;
+static constexpr u32 NUM_RUNS = 3;
+static constexpr u32 MAX_ITERATIONS = 1u << 30;
+
+static std::string s_filter;
+static std::vector<BenchmarkResult> s_results;
+
+bool RegTestBenchmarks::IsSelected(const char* name)
+{
+  return (s_filter == "all" || std::strstr(name, s_filter.c_str()) != nullptr);
+}
+
+template<typename T>
+void RegTestBenchmarks::RunBenchmark(const char* name, const T& func)
+{
+  if (!IsSelected(name))
+    return;
+
+  // grow the iteration count until the run is long enough to time reliably
+  u32 iterations = 1;
+  double seconds;
+  for (;;)
+  {
+    Common::Timer timer;
+    func(iterations);
+    seconds = timer.GetTimeSeconds();
+    if (seconds >= MIN_RUN_SECONDS || iterations >= MAX_ITERATIONS)
+      break;
+
+    const double scale = (seconds > 0.0) ? std::min((MIN_RUN_SECONDS * 1.2) / seconds, 10.0) : 10.0;
+    iterations = static_cast<u32>(std::min(static_cast<double>(iterations) * scale + 1.0, double(MAX_ITERATIONS)));
+  }
+
+  for (u32 run = 1; run < NUM_RUNS; run++)
+  {
+    Common::Timer timer;
+    func(iterations);
+    seconds = std::min(seconds, timer.GetTimeSeconds());
+  }
+
+  const double ns_per_op = (seconds * 1000000000.0) / static_cast<double>(iterations);
+  Log_InfoPrintf("%-36s %12u iterations %14.2f ns/op", name, iterations, ns_per_op);
+  s_results.push_back(BenchmarkResult{name, iterations, ns_per_op});
+}
+
+void RegTestBenchmarks::RunGTEBenchmarks()
+{
+  GTE::Initialize();
+
+  // control registers start at index 32
+  static constexpr std::array<std::pair<u32, u32>, 28> control_regs = {{
+    {0, 0x00000FA0}, // RT11/RT12
+    {1, 0x0000FF80}, // RT13/RT21
+    {2, 0x0F800000}, // RT22/RT23
+    {3, 0x00800000}, // RT31/RT32
+    {4, 0x00000F80}, // RT33
+    {5, 0x00000100}, // TRX
+    {6, 0xFFFFFF80}, // TRY
+    {7, 0x00000800}, // TRZ
+    {8, 0x0000F800}, // L11/L12
+    {9, 0x08000000}, // L13/L21
+    {10, 0x00000800}, // L22/L23
+    {11, 0xF0000800}, // L31/L32
+    {12, 0x00000800}, // L33
+    {13, 0x00000200}, // RBK
+    {14, 0x00000200}, // GBK
+    {15, 0x00000200}, // BBK
+    {16, 0x00001000}, // LR1/LR2
+    {17, 0x00000000}, // LR3/LG1
+    {18, 0x00001000}, // LG2/LG3
+    {19, 0x00000000}, // LB1/LB2
+    {20, 0x00001000}, // LB3
+    {24, 0x01400000}, // OFX
+    {25, 0x00F00000}, // OFY
+    {26, 0x00000200}, // H
+    {27, 0xFFFFFF00}, // DQA
+    {28, 0x01400000}, // DQB
+    {29, 0x00000155}, // ZSF3
+    {30, 0x00000100}, // ZSF4
+  }};
+  for (const auto& [index, value] : control_regs)
+    GTE::WriteRegister(32 + index, value);
+
+  GTE::WriteRegister(0, 0xFF800080); // VXY0
+  GTE::WriteRegister(1, 0x00000040); // VZ0
+  GTE::WriteRegister(2, 0x00800100); // VXY1
+  GTE::WriteRegister(3, 0xFFFFFFC0); // VZ1
+  GTE::WriteRegister(4, 0x0040FF00); // VXY2
+  GTE::WriteRegister(5, 0x00000080); // VZ2
+  GTE::WriteRegister(6, 0x34806040); // RGBC
+
+  static constexpr std::array<std::pair<const char*, u32>, 8> instructions = {{
+    {"gte/rtps", 0x4A180001},
+    {"gte/rtpt", 0x4A280030},
+    {"gte/nclip", 0x4B400006},
+    {"gte/avsz3", 0x4B58002D},
+    {"gte/mvmva", 0x4A480012},
+    {"gte/ncds", 0x4AE80413},
+    {"gte/ncdt", 0x4AF80416},
+    {"gte/nct", 0x4AD80420},
+  }};
+  for (const auto& [name, inst_bits] : instructions)
+  {
+    RunBenchmark(name, [inst_bits = inst_bits](u32 iterations) {
+      for (u32 i = 0; i < iterations; i++)
+        GTE::ExecuteInstruction(inst_bits);
+    });
+  }
+}
+
+static void PushBenchTriangle(GPU_SW_Backend* backend, const BenchTriangle& tri, const GPURenderCommand rc,
+                              const GPUDrawModeReg draw_mode)
+{
+  GPUBackendDrawPolygonCommand* cmd = backend->NewDrawPolygonCommand(3);
+  cmd->params.bits = 0;
+  cmd->rc.bits = rc.bits;
+  cmd->draw_mode.bits = draw_mode.bits;
+  cmd->palette.bits = 0;
+  cmd->palette.y = 480;
+  cmd->window = GPUTextureWindow{0xFF, 0xFF, 0x00, 0x00};
+  for (u32 i = 0; i < 3; i++)
+    cmd->vertices[i].Set(tri.x[i], tri.y[i], tri.color[i], tri.texcoord[i]);
+  backend->PushCommand(cmd);
+}
+
+static void PushBenchRectangle(GPU_SW_Backend* backend, s32 x, s32 y, u16 size, u32 color, const GPURenderCommand rc,
+                               const GPUDrawModeReg draw_mode)
+{
+  GPUBackendDrawRectangleCommand* cmd = backend->NewDrawRectangleCommand();
+  cmd->params.bits = 0;
+  cmd->rc.bits = rc.bits;
+  cmd->draw_mode.bits = draw_mode.bits;
+  cmd->palette.bits = 0;
+  cmd->palette.y = 480;
+  cmd->window = GPUTextureWindow{0xFF, 0xFF, 0x00, 0x00};
+  cmd->x = x;
+  cmd->y = y;
+  cmd->width = size;
+  cmd->height = size;
+  cmd->texcoord = 0;
+  cmd->color = color;
+  backend->PushCommand(cmd);
+}
+
+bool RegTestBenchmarks::RunGPUBenchmarks()
+{
+  // draw on the calling thread, so the timings only cover rasterization
+  g_settings.gpu_use_thread = false;
+  g_settings.gpu_sw_worker_threads = 0;
+  g_settings.gpu_sw_tile_binning = false;
+
+  HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> vram;
+  std::unique_ptr<GPU_SW_Backend> backend = std::make_unique<GPU_SW_Backend>(vram.data());
+  if (!backend->Initialize(false))
+  {
+    Log_ErrorPrintf("Failed to initialize software GPU backend.");
+    return false;
+  }
+
+  backend->Reset(true);
+
+  // noise in VRAM gives the texture and blending paths varied inputs
+  FixedRandom rng;
+  for (u32 y = 0; y < VRAM_HEIGHT; y++)
+  {
+    for (u32 x = 0; x < VRAM_WIDTH; x++)
+      backend->SetPixel(x, y, static_cast<u16>(rng.Next()));
+  }
+
+  GPUBackendSetDrawingAreaCommand* area_cmd = backend->NewSetDrawingAreaCommand();
+  area_cmd->params.bits = 0;
+  area_cmd->new_area = Common::Rectangle<u32>(0, 0, 639, 479);
+  backend->PushCommand(area_cmd);
+
+  // game-sized triangles, up to 64 pixels across
+  static constexpr u32 NUM_TRIANGLES = 256;
+  std::vector<BenchTriangle> triangles(NUM_TRIANGLES);
+  for (BenchTriangle& tri : triangles)
+  {
+    const s32 base_x = static_cast<s32>(rng.Next(640 - 64));
+    const s32 base_y = static_cast<s32>(rng.Next(480 - 64));
+    for (u32 i = 0; i < 3; i++)
+    {
+      tri.x[i] = base_x + static_cast<s32>(rng.Next(64));
+      tri.y[i] = base_y + static_cast<s32>(rng.Next(64));
+      tri.color[i] = rng.Next() & 0xFFFFFFu;
+      tri.texcoord[i] = static_cast<u16>(rng.Next());
+    }
+  }
+
+  GPURenderCommand rc;
+  rc.bits = 0;
+  rc.primitive = GPUPrimitive::Polygon;
+  GPUDrawModeReg draw_mode;
+  draw_mode.bits = 0;
+  draw_mode.texture_page_x_base = 8;
+  draw_mode.dither_enable = true;
+
+  const auto run_triangles = [&backend, &triangles](const GPURenderCommand rc, const GPUDrawModeReg draw_mode) {
+    return [&backend, &triangles, rc, draw_mode](u32 iterations) {
+      for (u32 i = 0; i < iterations; i++)
+        PushBenchTriangle(backend.get(), triangles[i % NUM_TRIANGLES], rc, draw_mode);
+      backend->Sync(false);
+    };
+  };
+
+  RunBenchmark("gpu_sw/triangle_flat", run_triangles(rc, draw_mode));
+
+  rc.shading_enable = true;
+  RunBenchmark("gpu_sw/triangle_gouraud", run_triangles(rc, draw_mode));
+
+  rc.texture_enable = true;
+  draw_mode.texture_mode = GPUTextureMode::Palette4Bit;
+  RunBenchmark("gpu_sw/triangle_textured_4bpp", run_triangles(rc, draw_mode));
+
+  rc.transparency_enable = true;
+  draw_mode.texture_mode = GPUTextureMode::Direct16Bit;
+  draw_mode.transparency_mode = GPUTransparencyMode::HalfBackgroundPlusHalfForeground;
+  RunBenchmark("gpu_sw/triangle_textured_16bpp_blended", run_triangles(rc, draw_mode));
+
+  rc.bits = 0;
+  rc.primitive = GPUPrimitive::Rectangle;
+  draw_mode.bits = 0;
+  draw_mode.texture_page_x_base = 8;
+
+  const auto run_rectangles = [&backend](u16 size, const GPURenderCommand rc, const GPUDrawModeReg draw_mode) {
+    return [&backend, size, rc, draw_mode](u32 iterations) {
+      for (u32 i = 0; i < iterations; i++)
+      {
+        const s32 x = static_cast<s32>((i * 37u) % (640u - size));
+        const s32 y = static_cast<s32>((i * 23u) % (480u - size));
+        PushBenchRectangle(backend.get(), x, y, size, 0x808080u, rc, draw_mode);
+      }
+      backend->Sync(false);
+    };
+  };
+
+  RunBenchmark("gpu_sw/rectangle_fill_64x64", run_rectangles(64, rc, draw_mode));
+
+  rc.texture_enable = true;
+  rc.raw_texture_enable = true;
+  draw_mode.texture_mode = GPUTextureMode::Palette4Bit;
+  RunBenchmark("gpu_sw/rectangle_sprite_16x16", run_rectangles(16, rc, draw_mode));
+
+  backend->Shutdown();
+  return true;
+}
+
+void RegTestBenchmarks::RunMDECBenchmarks()
+{
+  g_settings.mdec_decode_on_thread = false;
+  g_mdec.Initialize();
+
+  // SetIqTab with both the luma and chroma tables
+  FixedRandom rng;
+  g_mdec.WriteRegister(0, 0x40000001u);
+  for (u32 i = 0; i < 32; i++)
+  {
+    u32 word = 0;
+    for (u32 j = 0; j < 4; j++)
+      word |= (2u + ((i * 4 + j) % 64) / 4) << (j * 8);
+    g_mdec.WriteRegister(0, word);
+  }
+
+  // one colour macroblock: six blocks of a DC coefficient, ten run-length coded AC coefficients and an end marker
+  static constexpr u32 HALFWORDS_PER_BLOCK = 12;
+  static constexpr u32 WORDS_PER_MACROBLOCK = (HALFWORDS_PER_BLOCK * 6) / 2;
+  std::array<u16, WORDS_PER_MACROBLOCK * 2> macroblock;
+  for (u32 block = 0; block < 6; block++)
+  {
+    u16* out = &macroblock[block * HALFWORDS_PER_BLOCK];
+    *(out++) = static_cast<u16>((8u << 10) | rng.Next(0x400));
+    for (u32 i = 0; i < HALFWORDS_PER_BLOCK - 2; i++)
+      *(out++) = static_cast<u16>((rng.Next(4) << 10) | ((rng.Next(64) - 32u) & 0x3FFu));
+    *out = 0xFE00;
+  }
+
+  // DecodeMacroblock with 15-bit output
+  static constexpr u32 DECODE_COMMAND = (1u << 29) | (3u << 27) | WORDS_PER_MACROBLOCK;
+  static constexpr TickCount TICKS_PER_MACROBLOCK = 550 * 6;
+  static constexpr u32 OUTPUT_WORDS = (16 * 16) / 2;
+  std::array<u32, WORDS_PER_MACROBLOCK> input;
+  std::memcpy(input.data(), macroblock.data(), sizeof(input));
+  std::array<u32, OUTPUT_WORDS> output;
+
+  RunBenchmark("mdec/decode_macroblock_15bpp", [&input, &output](u32 iterations) {
+    for (u32 i = 0; i < iterations; i++)
+    {
+      g_mdec.WriteRegister(0, DECODE_COMMAND);
+      g_mdec.DMAWrite(input.data(), WORDS_PER_MACROBLOCK);
+
+      // the decoded blocks are copied out by an event, as if the CPU had kept running
+      CPU::AddPendingTicks(TICKS_PER_MACROBLOCK);
+      TimingEvents::RunEvents();
+      g_mdec.DMARead(output.data(), OUTPUT_WORDS);
+    }
+  });
+
+  g_mdec.Shutdown();
+}
+
+void RegTestBenchmarks::RunSPUBenchmarks()
+{
+  g_settings.audio_backend = AudioBackend::Null;
+  g_settings.audio_mix_on_thread = false;
+  SPU::Initialize();
+
+  // a looping ADPCM sample, with every shift and filter combination
+  static constexpr u32 SAMPLE_ADDRESS = 0x1000;
+  static constexpr u32 SAMPLE_BLOCKS = 64;
+  FixedRandom rng;
+  std::array<u8, SPU::RAM_SIZE>& ram = SPU::GetWritableRAM();
+  for (u32 block = 0; block < SAMPLE_BLOCKS; block++)
+  {
+    u8* data = &ram[SAMPLE_ADDRESS + block * 16];
+    data[0] = static_cast<u8>((block % 13) | ((block % 5) << 4));
+    data[1] = (block == 0) ? 0x04 : ((block == SAMPLE_BLOCKS - 1) ? 0x03 : 0x00);
+    for (u32 i = 2; i < 16; i++)
+      data[i] = static_cast<u8>(rng.Next());
+  }
+
+  const auto write_reg = [](u32 address, u16 value) { SPU::WriteRegister(address - Bus::SPU_BASE, value); };
+  write_reg(0x1F801DAA, 0xC000); // SPUCNT: enable, unmute
+  write_reg(0x1F801D80, 0x3FFF);
+  write_reg(0x1F801D82, 0x3FFF);
+  for (u32 voice = 0; voice < 24; voice++)
+  {
+    const u32 base = 0x1F801C00 + voice * 0x10;
+    write_reg(base + 0x0, 0x0800);
+    write_reg(base + 0x2, 0x0800);
+    write_reg(base + 0x4, static_cast<u16>(0x0800 + voice * 0x80));
+    write_reg(base + 0x6, SAMPLE_ADDRESS / 8);
+    write_reg(base + 0x8, 0x000F); // fastest attack, full sustain
+    write_reg(base + 0xA, 0x0000);
+  }
+  write_reg(0x1F801D88, 0xFFFF);
+  write_reg(0x1F801D8A, 0x00FF);
+
+  // one iteration is one stereo frame, with all 24 voices playing, run a second at a time to keep the ticks in range
+  static constexpr u32 SAMPLE_RATE = 44100;
+  static constexpr TickCount TICKS_PER_FRAME = System::MASTER_CLOCK / SAMPLE_RATE;
+  RunBenchmark("spu/generate_frame_24_voices", [](u32 iterations) {
+    for (u32 done = 0; done < iterations;)
+    {
+      const u32 frames = std::min(iterations - done, SAMPLE_RATE);
+      CPU::AddPendingTicks(static_cast<TickCount>(frames) * TICKS_PER_FRAME);
+      TimingEvents::RunEvents();
+      SPU::GeneratePendingSamples();
+      done += frames;
+    }
+  });
+
+  SPU::Shutdown();
+}
+
+bool RegTestBenchmarks::RunStateBenchmarks()
+{
+  // the SPU contributes its 512KB of RAM, which dominates the size of a real save state as well
+  g_settings.mdec_decode_on_thread = false;
+  g_settings.audio_backend = AudioBackend::Null;
+  g_settings.audio_mix_on_thread = false;
+  GTE::Initialize();
+  g_mdec.Initialize();
+  SPU::Initialize();
+
+  std::vector<u8> buffer(2 * 1024 * 1024);
+  const auto do_state = [&buffer](StateWrapper::Mode mode) {
+    StateWrapper sw(buffer.data(), buffer.size(), mode, SAVE_STATE_VERSION);
+    GTE::DoState(sw);
+    g_mdec.DoState(sw);
+    SPU::DoState(sw);
+    return !sw.HasError();
+  };
+
+  bool result = do_state(StateWrapper::Mode::Write) && do_state(StateWrapper::Mode::Read);
+  if (result)
+  {
+    RunBenchmark("state/save", [&do_state, &result](u32 iterations) {
+      for (u32 i = 0; i < iterations; i++)
+        result &= do_state(StateWrapper::Mode::Write);
+    });
+    RunBenchmark("state/load", [&do_state, &result](u32 iterations) {
+      for (u32 i = 0; i < iterations; i++)
+        result &= do_state(StateWrapper::Mode::Read);
+    });
+  }
+
+  if (!result)
+    Log_ErrorPrintf("Failed to serialize state.");
+
+  SPU::Shutdown();
+  g_mdec.Shutdown();
+  return result;
+}
+
+void RegTestBenchmarks::RunTimingEventBenchmarks()
+{
+  // intervals roughly matching the mix of events while a game is running
+  static constexpr std::array<TickCount, 16> intervals = {
+    {37, 64, 128, 200, 768, 1024, 2048, 2170, 3413, 4096, 8192, 11111, 22050, 33868, 44100, 564480}};
+
+  u32 calls = 0;
+  std::array<std::unique_ptr<TimingEvent>, intervals.size()> events;
+  for (size_t i = 0; i < intervals.size(); i++)
+  {
+    events[i] = TimingEvents::CreateTimingEvent(
+      fmt::format("Benchmark Event {}", i), intervals[i], intervals[i],
+      [](void* param, TickCount ticks, TickCount ticks_late) { (*static_cast<u32*>(param))++; }, &calls, true);
+  }
+
+  RunBenchmark("timing/run_events_64_ticks", [](u32 iterations) {
+    for (u32 i = 0; i < iterations; i++)
+    {
+      CPU::AddPendingTicks(64);
+      TimingEvents::RunEvents();
+    }
+  });
+
+  RunBenchmark("timing/reschedule", [&events](u32 iterations) {
+    for (u32 i = 0; i < iterations; i++)
+      events[i % intervals.size()]->Schedule(intervals[(i * 7) % intervals.size()]);
+  });
+}
+
+bool RegTestBenchmarks::RunCDImageBenchmarks(const std::string& image_path)
+{
+  if (image_path.empty())
+  {
+    if (IsSelected("cdimage/"))
+      Log_WarningPrintf("No image specified with -microbenchimage, skipping CD image benchmarks.");
+    return true;
+  }
+
+  if (!IsSelected("cdimage/"))
+    return true;
+
+  Common::Error error;
+  std::unique_ptr<CDImage> image = CDImage::Open(image_path.c_str(), false, &error);
+  if (!image)
+  {
+    Log_ErrorPrintf("Failed to open '%s': %s", image_path.c_str(), error.GetCodeAndMessage().GetCharArray());
+    return false;
+  }
+
+  const CDImage::LBA lba_count = image->GetLBACount();
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
+  bool result = true;
+
+  RunBenchmark("cdimage/sequential_read", [&image, &sector, &result, lba_count](u32 iterations) {
+    for (u32 i = 0; i < iterations; i++)
+      result &= (image->Seek(i % lba_count) && image->ReadRawSector(sector.data(), nullptr));
+  });
+
+  RunBenchmark("cdimage/random_read", [&image, &sector, &result, lba_count](u32 iterations) {
+    FixedRandom rng;
+    for (u32 i = 0; i < iterations; i++)
+      result &= (image->Seek(rng.Next(lba_count)) && image->ReadRawSector(sector.data(), nullptr));
+  });
+
+  if (!result)
+    Log_ErrorPrintf("Failed to read sectors from '%s'", image_path.c_str());
+
+  return result;
+}
+
+bool RegTestBenchmarks::WriteResults(const std::string& path)
+{
+  std::string benchmarks;
+  for (const BenchmarkResult& res : s_results)
+  {
+    benchmarks += fmt::format("{}    {{\"name\": \"{}\", \"iterations\": {}, \"ns_per_op\": {:.3f}}}",
+                              benchmarks.empty() ? "" : ",\n", res.name, res.iterations, res.ns_per_op);
+  }
+
+  const std::string json = fmt::format("{{\n  \"benchmarks\": [\n{}\n  ]\n}}\n", benchmarks);
+  if (!FileSystem::WriteStringToFile(path.c_str(), json))
+  {
+    Log_ErrorPrintf("Failed to write benchmark results to '%s'", path.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool RegTestBenchmarks::Run(const std::string& filter, const std::string& image_path, const std::string& results_path)
+{
+  s_filter = filter;
+  s_results.clear();
+
+  // RunEvents() expects at least one event to be active, which is always the case in a running system
+  TimingEvents::Initialize();
+  std::unique_ptr<TimingEvent> idle_event = TimingEvents::CreateTimingEvent(
+    "Benchmark Idle", System::MASTER_CLOCK, System::MASTER_CLOCK,
+    [](void* param, TickCount ticks, TickCount ticks_late) {}, nullptr, true);
+
+  RunGTEBenchmarks();
+  bool result = RunGPUBenchmarks();
+  RunMDECBenchmarks();
+  RunSPUBenchmarks();
+  result &= RunStateBenchmarks();
+  RunTimingEventBenchmarks();
+  result &= RunCDImageBenchmarks(image_path);
+  idle_event.reset();
+  TimingEvents::Shutdown();
+
+  if (s_results.empty())
+  {
+    Log_ErrorPrintf("No benchmarks match '%s'.", filter.c_str());
+    return false;
+  }
+
+  if (!results_path.empty())
+    result &= WriteResults(results_path);
+
+  return result;
+}
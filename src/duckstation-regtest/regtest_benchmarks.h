@@ -0,0 +1,11 @@
+#pragma once
+#include <string>
+
+namespace RegTestBenchmarks {
+
+/// Runs the kernel microbenchmarks whose name contains filter, or all of them when filter is "all". Every kernel is
+/// fed fixed inputs, so timings are comparable between builds. The CD image benchmarks are skipped when image_path is
+/// empty. When results_path is not empty, the timings are also written there as JSON.
+bool Run(const std::string& filter, const std::string& image_path, const std::string& results_path);
+
+} // namespace RegTestBenchmarks
@@ -0,0 +1,313 @@
+#include "regtest_frame_dump.h"
+#include "common/byte_stream.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/path.h"
+#include "common/string_util.h"
+#include "common/thread_pool.h"
+#include "fmt/format.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+Log_SetChannel(RegTestFrameDump);
+
+namespace RegTestFrameDump {
+
+static constexpr u32 CONTAINER_MAGIC = 0x44465344; // DSFD
+static constexpr u32 CONTAINER_VERSION = 1;
+static constexpr int CONTAINER_COMPRESSION_LEVEL = 3;
+
+#pragma pack(push, 1)
+struct ContainerHeader
+{
+  u32 magic;
+  u32 version;
+  u32 compressed;
+};
+
+// Followed by data_size bytes of RGBA8 pixels, zstd compressed if the header says so.
+struct ContainerFrameHeader
+{
+  u32 frame;
+  u32 width;
+  u32 height;
+  u32 data_size;
+};
+#pragma pack(pop)
+
+static void EncodeFrame(u64 sequence, u32 frame, Common::RGBA8Image& image, u32 save_width, u32 save_height);
+static void WriteInOrder(u64 sequence, std::vector<u8> data);
+static void WaitForQueuedFrames();
+static void CloseOutputFile();
+
+static constexpr std::array<const char*, static_cast<size_t>(Format::Count)> s_format_names = {
+  {"png", "raw", "zstd", "hash"}};
+
+static Format s_format = Format::PNG;
+static std::unique_ptr<Threading::ThreadPool> s_pool;
+static std::unique_ptr<Threading::ThreadPool::TaskGroup> s_task_group;
+static std::string s_directory;
+static u32 s_max_queued_frames = 0;
+static u64 s_next_sequence = 0;
+static std::atomic_bool s_failed{false};
+
+// Frames queued but not yet written, so emulation can't run away from the encoders and use unbounded memory.
+static std::mutex s_queue_mutex;
+static std::condition_variable s_queue_cv;
+static u32 s_queued_frames = 0;
+
+// Containers and hash lists are written in frame order, workers park their output here until it's their turn.
+static std::mutex s_write_mutex;
+static std::FILE* s_output_file = nullptr;
+static std::map<u64, std::vector<u8>> s_pending_writes;
+static u64 s_next_write_sequence = 0;
+
+std::optional<Format> ParseFormat(const char* str)
+{
+  for (u32 i = 0; i < static_cast<u32>(Format::Count); i++)
+  {
+    if (StringUtil::Strcasecmp(s_format_names[i], str) == 0)
+      return static_cast<Format>(i);
+  }
+
+  return std::nullopt;
+}
+
+const char* GetFormatName(Format format)
+{
+  return s_format_names[static_cast<size_t>(format)];
+}
+
+void Start(Format format, u32 num_workers, u32 max_queued_frames)
+{
+  s_format = format;
+  s_max_queued_frames = std::max(max_queued_frames, 1u);
+  s_failed.store(false, std::memory_order_relaxed);
+  s_pool = std::make_unique<Threading::ThreadPool>(num_workers, "Frame Dump");
+  s_task_group = std::make_unique<Threading::ThreadPool::TaskGroup>();
+  Log_InfoPrintf("Encoding %s frame dumps with %u workers", GetFormatName(format), s_pool->GetThreadCount());
+}
+
+bool SetDirectory(std::string directory)
+{
+  WaitForQueuedFrames();
+  CloseOutputFile();
+
+  s_directory = std::move(directory);
+  s_next_sequence = 0;
+  s_next_write_sequence = 0;
+  if (s_format == Format::PNG)
+    return true;
+
+  const std::string path =
+    Path::Combine(s_directory, (s_format == Format::Hash) ? HASH_LOG_FILENAME : "frames.dsfd");
+  s_output_file = FileSystem::OpenCFile(path.c_str(), "wb");
+  if (!s_output_file)
+  {
+    Log_ErrorPrintf("Failed to open frame dump output '%s'", path.c_str());
+    s_failed.store(true, std::memory_order_relaxed);
+    return false;
+  }
+
+  if (s_format != Format::Hash)
+  {
+    ContainerHeader header;
+    header.magic = CONTAINER_MAGIC;
+    header.version = CONTAINER_VERSION;
+    header.compressed = (s_format == Format::Zstd) ? 1 : 0;
+    std::fwrite(&header, sizeof(header), 1, s_output_file);
+  }
+
+  return true;
+}
+
+void QueueFrame(u32 frame, Common::RGBA8Image image, u32 save_width, u32 save_height)
+{
+  if (!s_pool)
+    return;
+
+  {
+    std::unique_lock lock(s_queue_mutex);
+    s_queue_cv.wait(lock, []() { return (s_queued_frames < s_max_queued_frames); });
+    s_queued_frames++;
+  }
+
+  // hashing is cheaper than handing the frame to a worker
+  const u64 sequence = s_next_sequence++;
+  if (s_format == Format::Hash)
+  {
+    EncodeFrame(sequence, frame, image, save_width, save_height);
+
+    std::unique_lock lock(s_queue_mutex);
+    s_queued_frames--;
+    return;
+  }
+
+  s_pool->Submit(
+    [sequence, frame, image = std::move(image), save_width, save_height]() mutable {
+      EncodeFrame(sequence, frame, image, save_width, save_height);
+
+      std::unique_lock lock(s_queue_mutex);
+      s_queued_frames--;
+      s_queue_cv.notify_one();
+    },
+    Threading::ThreadPool::Priority::Normal, s_task_group.get());
+}
+
+bool Finish()
+{
+  if (!s_pool)
+    return true;
+
+  WaitForQueuedFrames();
+  CloseOutputFile();
+  s_task_group.reset();
+  s_pool.reset();
+  return !s_failed.load(std::memory_order_relaxed);
+}
+
+void EncodeFrame(u64 sequence, u32 frame, Common::RGBA8Image& image, u32 save_width, u32 save_height)
+{
+  const u32 size = image.GetPitch() * image.GetHeight();
+  switch (s_format)
+  {
+    case Format::PNG:
+    {
+      if (save_width != image.GetWidth() || save_height != image.GetHeight())
+        image.Resize(save_width, save_height);
+
+      const std::string path = Path::Combine(s_directory, fmt::format("frame_{:05d}.png", frame));
+      if (!image.SaveToFile(path.c_str()))
+      {
+        Log_ErrorPrintf("Failed to save frame %u to '%s'", frame, path.c_str());
+        s_failed.store(true, std::memory_order_relaxed);
+      }
+    }
+    break;
+
+    case Format::Raw:
+    case Format::Zstd:
+    {
+      ContainerFrameHeader header;
+      header.frame = frame;
+      header.width = image.GetWidth();
+      header.height = image.GetHeight();
+
+      std::vector<u8> data;
+      if (s_format == Format::Zstd)
+      {
+        std::vector<u8> compressed;
+        if (!ByteStream::CompressZstd(image.GetPixels(), size, CONTAINER_COMPRESSION_LEVEL, &compressed))
+        {
+          Log_ErrorPrintf("Failed to compress frame %u", frame);
+          s_failed.store(true, std::memory_order_relaxed);
+          WriteInOrder(sequence, {});
+          return;
+        }
+
+        header.data_size = static_cast<u32>(compressed.size());
+        data.resize(sizeof(header) + compressed.size());
+        std::memcpy(data.data() + sizeof(header), compressed.data(), compressed.size());
+      }
+      else
+      {
+        header.data_size = size;
+        data.resize(sizeof(header) + size);
+        std::memcpy(data.data() + sizeof(header), image.GetPixels(), size);
+      }
+
+      std::memcpy(data.data(), &header, sizeof(header));
+      WriteInOrder(sequence, std::move(data));
+    }
+    break;
+
+    case Format::Hash:
+    {
+      const std::string line = fmt::format("frame_{:05d} {}x{} {:016x}\n", frame, image.GetWidth(), image.GetHeight(),
+                                           XXH3_64bits(image.GetPixels(), size));
+      WriteInOrder(sequence, std::vector<u8>(line.begin(), line.end()));
+    }
+    break;
+
+    default:
+      break;
+  }
+}
+
+bool CompareHashLogs(const char* expected_path, const char* actual_path)
+{
+  std::optional<std::string> expected_log = FileSystem::ReadFileToString(expected_path);
+  std::optional<std::string> actual_log = FileSystem::ReadFileToString(actual_path);
+  if (!expected_log.has_value() || !actual_log.has_value())
+  {
+    Log_ErrorPrintf("Failed to read frame hashes from '%s' or '%s'", expected_path, actual_path);
+    return false;
+  }
+
+  // both logs are in frame order, so the first differing line is the first divergent frame
+  const std::vector<std::string_view> expected_lines(StringUtil::SplitString(expected_log.value(), '\n'));
+  const std::vector<std::string_view> actual_lines(StringUtil::SplitString(actual_log.value(), '\n'));
+  for (size_t i = 0; i < std::max(expected_lines.size(), actual_lines.size()); i++)
+  {
+    const std::string_view expected = (i < expected_lines.size()) ? expected_lines[i] : std::string_view();
+    const std::string_view actual = (i < actual_lines.size()) ? actual_lines[i] : std::string_view();
+    if (expected == actual)
+      continue;
+
+    Log_ErrorPrintf("Frames diverged after %zu matching frames:", i);
+    Log_ErrorPrintf("  expected: %.*s", static_cast<int>(expected.length()), expected.data());
+    Log_ErrorPrintf("  actual:   %.*s", static_cast<int>(actual.length()), actual.data());
+    return false;
+  }
+
+  Log_InfoPrintf("All %zu frames matched.", actual_lines.size());
+  return true;
+}
+
+void WriteInOrder(u64 sequence, std::vector<u8> data)
+{
+  std::unique_lock lock(s_write_mutex);
+  s_pending_writes.emplace(sequence, std::move(data));
+
+  for (auto it = s_pending_writes.find(s_next_write_sequence); it != s_pending_writes.end();
+       it = s_pending_writes.find(s_next_write_sequence))
+  {
+    if (!it->second.empty() && s_output_file &&
+        std::fwrite(it->second.data(), it->second.size(), 1, s_output_file) != 1)
+    {
+      Log_ErrorPrintf("Failed to write frame dump data");
+      s_failed.store(true, std::memory_order_relaxed);
+    }
+
+    s_pending_writes.erase(it);
+    s_next_write_sequence++;
+  }
+}
+
+void WaitForQueuedFrames()
+{
+  if (s_pool)
+    s_task_group->Wait(*s_pool);
+}
+
+void CloseOutputFile()
+{
+  if (!s_output_file)
+    return;
+
+  if (std::fclose(s_output_file) != 0)
+    s_failed.store(true, std::memory_order_relaxed);
+
+  s_output_file = nullptr;
+}
+
+} // namespace RegTestFrameDump
@@ -0,0 +1,41 @@
+#pragma once
+#include "common/image.h"
+#include "common/types.h"
+#include <optional>
+#include <string>
+
+namespace RegTestFrameDump {
+
+enum class Format : u8
+{
+  PNG,  // frame_NNNNN.png per dumped frame
+  Raw,  // every frame in frames.dsfd, uncompressed RGBA8
+  Zstd, // every frame in frames.dsfd, zstd compressed RGBA8
+  Hash, // one XXH3 line per frame in frame_hashes.txt, nothing is encoded
+  Count
+};
+
+/// Name of the log written in the dump directory by the hash format.
+static constexpr const char* HASH_LOG_FILENAME = "frame_hashes.txt";
+
+std::optional<Format> ParseFormat(const char* str);
+const char* GetFormatName(Format format);
+
+/// Starts the encoder workers. Frames are encoded out of order, but files are named and containers written in frame
+/// order. At most max_queued_frames are held in memory, queueing further frames waits for the oldest to be written.
+void Start(Format format, u32 num_workers, u32 max_queued_frames);
+
+/// Waits for the frames which are already queued, then sends further frames to directory.
+bool SetDirectory(std::string directory);
+
+/// Queues a frame for encoding. The image is resized to save_width x save_height when saving as PNG, the other
+/// formats store the image as-is.
+void QueueFrame(u32 frame, Common::RGBA8Image image, u32 save_width, u32 save_height);
+
+/// Waits for every queued frame to be written and stops the workers. Returns false if any frame failed.
+bool Finish();
+
+/// Compares two frame_hashes.txt files, logging the first frame which differs. Returns false if they diverge.
+bool CompareHashLogs(const char* expected_path, const char* actual_path);
+
+} // namespace RegTestFrameDump
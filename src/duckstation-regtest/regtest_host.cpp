@@ -1,21 +1,39 @@
 #include "common/assert.h"
 #include "common/crash_handler.h"
 #include "common/file_system.h"
+#include "common/image.h"
 #include "common/log.h"
 #include "common/memory_settings_interface.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/threading.h"
+#include "common/timer.h"
+#include "core/bus.h"
+#include "core/cpu_code_cache.h"
+#include "core/cpu_core.h"
+#include "core/gpu.h"
 #include "core/host.h"
 #include "core/host_display.h"
 #include "core/host_settings.h"
+#include "core/psf_loader.h"
+#include "core/settings.h"
 #include "core/system.h"
+#include "core/timing_event.h"
 #include "frontend-common/common_host.h"
 #include "frontend-common/game_list.h"
 #include "frontend-common/input_manager.h"
+#include "regtest_benchmarks.h"
+#include "regtest_frame_dump.h"
 #include "regtest_host_display.h"
 #include "scmversion/scmversion.h"
+#include "xxhash.h"
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
 #include <csignal>
 #include <cstdio>
+#include <mutex>
+#include <thread>
 Log_SetChannel(RegTestHost);
 
 #ifdef WITH_CHEEVOS
@@ -31,17 +49,74 @@ static void InitializeEarlyConsole();
 static void HookSignals();
 static void SetAppRoot();
 static bool SetFolders();
-static std::string GetFrameDumpFilename(u32 frame);
+static void StartStateHashing();
+static void QueueStateSnapshot(u32 frame);
+static void StateHashWorkerThread();
+static bool FinishStateHashing();
+static bool RunBatch();
+static bool WriteBenchmarkResults(double seconds, u32 frames, u32 internal_frames, u64 cpu_thread_time);
+static void UpdateFramesToRun(const std::string& boot_filename);
+static bool RunFrames(bool hash_states);
+static bool ReplayBlockSet();
 } // namespace RegTestHost
 
+namespace {
+struct StateChunkHash
+{
+  const char* section;
+  u32 offset;
+  u32 size;
+  u64 hash;
+};
+
+struct StateSnapshot
+{
+  u32 frame;
+  std::vector<u8> data;
+  std::vector<std::pair<const char*, u32>> sections;
+  std::vector<StateChunkHash> hashes;
+};
+} // namespace
+
+// sections are hashed in page-sized chunks, so a divergence in RAM or VRAM can be narrowed down
+static constexpr u32 STATE_HASH_CHUNK_SIZE = 4096;
+
 static std::unique_ptr<MemorySettingsInterface> s_base_settings_interface;
 
 static u32 s_frames_to_run = 60 * 60;
+static float s_seconds_to_run = 0.0f;
+static std::string s_audio_dump_path;
 static u32 s_frame_dump_interval = 0;
+static RegTestFrameDump::Format s_frame_dump_format = RegTestFrameDump::Format::PNG;
+static u32 s_frame_dump_threads = 0;
+static std::string s_frame_hash_verify_path;
+static std::string s_frame_hash_compare_path;
 static std::string s_dump_base_directory;
 static std::string s_dump_game_directory;
 static GPURenderer s_renderer_to_use = GPURenderer::Software;
 
+static u32 s_state_hash_interval = 60;
+static std::string s_state_hash_record_path;
+static std::string s_state_hash_verify_path;
+static std::vector<std::thread> s_state_hash_workers;
+static std::mutex s_state_hash_mutex;
+static std::condition_variable s_state_hash_cv;
+static std::vector<std::unique_ptr<StateSnapshot>> s_state_snapshots;
+static size_t s_state_snapshots_next = 0;
+static u32 s_state_snapshots_pending = 0;
+static bool s_state_hash_shutdown = false;
+
+static std::string s_boot_save_state_path;
+static std::string s_benchmark_path;
+static std::string s_microbench_filter;
+static std::string s_microbench_image_path;
+static std::string s_replay_blocks_path;
+
+static std::string s_batch_list_path;
+static std::string s_batch_directory;
+static u32 s_batch_jobs = 0;
+static bool s_batch_audio = false;
+
 bool RegTestHost::SetFolders()
 {
   std::string program_path(FileSystem::GetProgramPath());
@@ -243,6 +318,7 @@ void Host::OnGameChanged(const std::string& disc_path, const std::string& game_s
     }
 
     Log_InfoPrintf("Dumping frames to '%s'...", s_dump_game_directory.c_str());
+    RegTestFrameDump::SetDirectory(s_dump_game_directory);
   }
 }
 
@@ -298,8 +374,11 @@ void Host::RenderDisplay(bool skip_present)
   const u32 frame = System::GetFrameNumber();
   if (s_frame_dump_interval > 0 && (s_frame_dump_interval == 1 || (frame % s_frame_dump_interval) == 0))
   {
-    std::string dump_filename(RegTestHost::GetFrameDumpFilename(frame));
-    g_host_display->WriteDisplayTextureToFile(std::move(dump_filename));
+    // only the readback happens here, encoding is done by the frame dump workers
+    Common::RGBA8Image image;
+    u32 save_width, save_height;
+    if (g_host_display->ReadDisplayTexture(&image, &save_width, &save_height))
+      RegTestFrameDump::QueueFrame(frame, std::move(image), save_width, save_height);
   }
 }
 
@@ -352,9 +431,9 @@ void Host::OnInputDeviceDisconnected(const std::string_view& identifier)
   // noop
 }
 
-void* Host::GetTopLevelWindowHandle()
+std::optional<WindowInfo> Host::GetTopLevelWindowInfo()
 {
-  return nullptr;
+  return std::nullopt;
 }
 
 void Host::RefreshGameListAsync(bool invalidate_cache)
@@ -493,9 +572,34 @@ void RegTestHost::PrintCommandLineHelp(const char* progname)
   std::fprintf(stderr, "  -version: Displays version information and exits.\n");
   std::fprintf(stderr, "  -dumpdir: Set frame dump base directory (will be dumped to basedir/gametitle).\n");
   std::fprintf(stderr, "  -dumpinterval: Dumps every N frames.\n");
+  std::fprintf(stderr, "  -dumpformat <format>: png (default) writes an image per frame, raw or zstd write every\n"
+                       "    frame to frames.dsfd, and hash only writes a hash per frame to frame_hashes.txt.\n");
+  std::fprintf(stderr, "  -dumpthreads <count>: Number of frame encoding threads. Defaults to the CPU count.\n");
+  std::fprintf(stderr, "  -verifyframes <file>: Compares the frame hashes from -dumpformat hash against file.\n");
+  std::fprintf(stderr, "  -compareframes <expected> <actual>: Reports the first frame which differs between two\n"
+                       "    frame hash logs, instead of booting.\n");
   std::fprintf(stderr, "  -frames: Sets the number of frames to execute.\n");
+  std::fprintf(stderr, "  -seconds <seconds>: Sets the emulated time to execute, instead of a frame count.\n");
+  std::fprintf(stderr, "  -renderaudio <file>: Writes the SPU output to a WAV file. PSFs run for the length and fade\n"
+                       "    in their tags, unless -seconds is given.\n");
   std::fprintf(stderr, "  -log <level>: Sets the log level. Defaults to verbose.\n");
   std::fprintf(stderr, "  -renderer <renderer>: Sets the graphics renderer. Default to software.\n");
+  std::fprintf(stderr, "  -state <file>: Loads the save state after booting.\n");
+  std::fprintf(stderr, "  -benchmark <file>: Writes frame rate and time spent per subsystem to file as JSON.\n");
+  std::fprintf(stderr, "  -microbench <filter>: Times the emulation kernels whose name contains filter, or all of\n"
+                       "    them with \"all\", instead of booting. Results are written to the -benchmark file.\n");
+  std::fprintf(stderr, "  -microbenchimage <file>: Disc image to use for the CD image read microbenchmarks.\n");
+  std::fprintf(stderr, "  -replayblocks <file>: Recompiles a block set saved with recompiler statistics enabled,\n"
+                       "    and prints statistics for the generated code. Per-block results go to the -benchmark\n"
+                       "    file.\n");
+  std::fprintf(stderr, "  -recordstates <file>: Writes hashes of the machine state to file.\n");
+  std::fprintf(stderr, "  -verifystates <file>: Compares the machine state against hashes from -recordstates.\n");
+  std::fprintf(stderr, "  -stateinterval <frames>: Hashes the state every N frames. Defaults to 60.\n");
+  std::fprintf(stderr, "  -batch <file>: Runs each image listed in file (one per line) in its own process.\n");
+  std::fprintf(stderr, "  -batchdir <dir>: Directory for batch logs, state hashes and report.json.\n"
+                       "    With -verifystates, the states are checked against the hashes in that directory.\n");
+  std::fprintf(stderr, "  -jobs <count>: Number of batch processes to run at once. Defaults to the CPU count.\n");
+  std::fprintf(stderr, "  -batchaudio: Renders the audio of each batch image to a WAV file in the batch directory.\n");
   std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
                        "    parameters make up the filename. Use when the filename contains\n"
                        "    spaces or starts with a dash.\n");
@@ -552,6 +656,40 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
 
         continue;
       }
+      else if (CHECK_ARG_PARAM("-dumpformat"))
+      {
+        const std::optional<RegTestFrameDump::Format> format = RegTestFrameDump::ParseFormat(argv[++i]);
+        if (!format.has_value())
+        {
+          Log_ErrorPrintf("Invalid dump format specified: %s", argv[i]);
+          return false;
+        }
+
+        s_frame_dump_format = format.value();
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-dumpthreads"))
+      {
+        s_frame_dump_threads = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_frame_dump_threads == 0)
+        {
+          Log_ErrorPrintf("Invalid dump thread count specified: %s", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-verifyframes"))
+      {
+        s_frame_hash_verify_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG("-compareframes") && (i + 2) < argc)
+      {
+        s_frame_hash_verify_path = argv[++i];
+        s_frame_hash_compare_path = argv[++i];
+        continue;
+      }
       else if (CHECK_ARG_PARAM("-frames"))
       {
         s_frames_to_run = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
@@ -563,6 +701,22 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
 
         continue;
       }
+      else if (CHECK_ARG_PARAM("-seconds"))
+      {
+        s_seconds_to_run = StringUtil::FromChars<float>(argv[++i]).value_or(0.0f);
+        if (s_seconds_to_run <= 0.0f)
+        {
+          Log_ErrorPrintf("Invalid run time specified: %s", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-renderaudio"))
+      {
+        s_audio_dump_path = argv[++i];
+        continue;
+      }
       else if (CHECK_ARG_PARAM("-log"))
       {
         std::optional<LOGLEVEL> level = Settings::ParseLogLevelName(argv[++i]);
@@ -587,6 +741,84 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
         s_base_settings_interface->SetStringValue("GPU", "Renderer", Settings::GetRendererName(renderer.value()));
         continue;
       }
+      else if (CHECK_ARG_PARAM("-state"))
+      {
+        s_boot_save_state_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-benchmark"))
+      {
+        s_benchmark_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-microbench"))
+      {
+        s_microbench_filter = argv[++i];
+        if (s_microbench_filter.empty())
+        {
+          Log_ErrorPrintf("Invalid microbenchmark filter specified.");
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-microbenchimage"))
+      {
+        s_microbench_image_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-replayblocks"))
+      {
+        s_replay_blocks_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-recordstates"))
+      {
+        s_state_hash_record_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-verifystates"))
+      {
+        s_state_hash_verify_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-stateinterval"))
+      {
+        s_state_hash_interval = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_state_hash_interval == 0)
+        {
+          Log_ErrorPrintf("Invalid state interval specified: %s", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-batch"))
+      {
+        s_batch_list_path = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-batchdir"))
+      {
+        s_batch_directory = argv[++i];
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-jobs"))
+      {
+        s_batch_jobs = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_batch_jobs == 0)
+        {
+          Log_ErrorPrintf("Invalid job count specified: %s", argv[i]);
+          return false;
+        }
+
+        continue;
+      }
+      else if (CHECK_ARG("-batchaudio"))
+      {
+        s_batch_audio = true;
+        continue;
+      }
       else if (CHECK_ARG("--"))
       {
         no_more_args = true;
@@ -610,9 +842,430 @@ bool RegTestHost::ParseCommandLineParameters(int argc, char* argv[], std::option
   return true;
 }
 
-std::string RegTestHost::GetFrameDumpFilename(u32 frame)
+void RegTestHost::StartStateHashing()
+{
+  // hashing and comparing happens off the emulation thread
+  const u32 num_workers = std::clamp(std::thread::hardware_concurrency() / 2u, 1u, 4u);
+  s_state_hash_shutdown = false;
+  for (u32 i = 0; i < num_workers; i++)
+    s_state_hash_workers.emplace_back(&StateHashWorkerThread);
+
+  Log_InfoPrintf("Hashing machine state every %u frames on %u threads.", s_state_hash_interval, num_workers);
+}
+
+void RegTestHost::QueueStateSnapshot(u32 frame)
+{
+  std::unique_ptr<StateSnapshot> snapshot = std::make_unique<StateSnapshot>();
+  snapshot->frame = frame;
+  if (!System::SaveStateSnapshot(&snapshot->data, &snapshot->sections))
+  {
+    Log_ErrorPrintf("Failed to snapshot state at frame %u", frame);
+    return;
+  }
+
+  // don't let the emulator get too far ahead of the workers, the snapshots are several megabytes each
+  std::unique_lock<std::mutex> lock(s_state_hash_mutex);
+  s_state_hash_cv.wait(lock, []() { return s_state_snapshots_pending < (s_state_hash_workers.size() * 2); });
+  s_state_snapshots.push_back(std::move(snapshot));
+  s_state_snapshots_pending++;
+  s_state_hash_cv.notify_all();
+}
+
+void RegTestHost::StateHashWorkerThread()
+{
+  std::unique_lock<std::mutex> lock(s_state_hash_mutex);
+  for (;;)
+  {
+    s_state_hash_cv.wait(lock,
+                         []() { return s_state_hash_shutdown || s_state_snapshots_next < s_state_snapshots.size(); });
+    if (s_state_snapshots_next == s_state_snapshots.size())
+      break;
+
+    StateSnapshot* snapshot = s_state_snapshots[s_state_snapshots_next++].get();
+    lock.unlock();
+
+    const u32 data_size = static_cast<u32>(snapshot->data.size());
+    for (size_t i = 0; i < snapshot->sections.size(); i++)
+    {
+      const auto& [section, start] = snapshot->sections[i];
+      const u32 end = ((i + 1) < snapshot->sections.size()) ? snapshot->sections[i + 1].second : data_size;
+      for (u32 offset = start; offset < end; offset += STATE_HASH_CHUNK_SIZE)
+      {
+        const u32 size = std::min(end - offset, STATE_HASH_CHUNK_SIZE);
+        snapshot->hashes.push_back(
+          StateChunkHash{section, offset - start, size, XXH64(snapshot->data.data() + offset, size, 0)});
+      }
+    }
+    snapshot->data = {};
+
+    lock.lock();
+    s_state_snapshots_pending--;
+    s_state_hash_cv.notify_all();
+  }
+}
+
+bool RegTestHost::FinishStateHashing()
+{
+  {
+    std::unique_lock<std::mutex> lock(s_state_hash_mutex);
+    s_state_hash_shutdown = true;
+    s_state_hash_cv.notify_all();
+  }
+
+  for (std::thread& thread : s_state_hash_workers)
+    thread.join();
+  s_state_hash_workers.clear();
+
+  std::string hashes;
+  for (const std::unique_ptr<StateSnapshot>& snapshot : s_state_snapshots)
+  {
+    for (const StateChunkHash& ch : snapshot->hashes)
+      hashes += fmt::format("{} {} {} {} {:016x}\n", snapshot->frame, ch.section, ch.offset, ch.size, ch.hash);
+  }
+
+  if (!s_state_hash_record_path.empty())
+  {
+    if (!FileSystem::WriteStringToFile(s_state_hash_record_path.c_str(), hashes))
+    {
+      Log_ErrorPrintf("Failed to write state hashes to '%s'", s_state_hash_record_path.c_str());
+      return false;
+    }
+
+    Log_InfoPrintf("Wrote hashes of %zu states to '%s'.", s_state_snapshots.size(), s_state_hash_record_path.c_str());
+  }
+
+  if (!s_state_hash_verify_path.empty())
+  {
+    std::optional<std::string> golden = FileSystem::ReadFileToString(s_state_hash_verify_path.c_str());
+    if (!golden.has_value())
+    {
+      Log_ErrorPrintf("Failed to read state hashes from '%s'", s_state_hash_verify_path.c_str());
+      return false;
+    }
+
+    // both lists are in frame and section order, so the first differing line is the first divergence
+    const std::vector<std::string_view> expected_lines(StringUtil::SplitString(golden.value(), '\n'));
+    const std::vector<std::string_view> actual_lines(StringUtil::SplitString(hashes, '\n'));
+    for (size_t i = 0; i < std::max(expected_lines.size(), actual_lines.size()); i++)
+    {
+      const std::string_view expected = (i < expected_lines.size()) ? expected_lines[i] : std::string_view();
+      const std::string_view actual = (i < actual_lines.size()) ? actual_lines[i] : std::string_view();
+      if (expected == actual)
+        continue;
+
+      Log_ErrorPrintf("State diverged from '%s':", s_state_hash_verify_path.c_str());
+      Log_ErrorPrintf("  expected: %.*s", static_cast<int>(expected.length()), expected.data());
+      Log_ErrorPrintf("  actual:   %.*s", static_cast<int>(actual.length()), actual.data());
+      return false;
+    }
+
+    Log_InfoPrintf("All %zu states matched '%s'.", s_state_snapshots.size(), s_state_hash_verify_path.c_str());
+  }
+
+  s_state_snapshots.clear();
+  return true;
+}
+
+static std::string QuoteCommandLineArgument(const std::string_view& arg)
 {
-  return Path::Combine(s_dump_game_directory, fmt::format("frame_{:05d}.png", frame));
+  return fmt::format("\"{}\"", arg);
+}
+
+static std::string EscapeJSONString(const std::string_view& str)
+{
+  std::string ret;
+  ret.reserve(str.length());
+  for (const char ch : str)
+  {
+    if (ch == '"' || ch == '\\')
+    {
+      ret.push_back('\\');
+      ret.push_back(ch);
+    }
+    else if (static_cast<unsigned char>(ch) < 0x20)
+    {
+      ret += fmt::format("\\u{:04x}", static_cast<unsigned>(ch));
+    }
+    else
+    {
+      ret.push_back(ch);
+    }
+  }
+
+  return ret;
+}
+
+bool RegTestHost::RunBatch()
+{
+  // The emulator core is built around global state, so each game runs in a child process of its own.
+  if (s_batch_directory.empty())
+  {
+    Log_ErrorPrint("Batch directory not specified.");
+    return false;
+  }
+
+  std::optional<std::string> list = FileSystem::ReadFileToString(s_batch_list_path.c_str());
+  if (!list.has_value())
+  {
+    Log_ErrorPrintf("Failed to read batch list '%s'", s_batch_list_path.c_str());
+    return false;
+  }
+
+  std::vector<std::string> images;
+  for (const std::string_view& line : StringUtil::SplitString(list.value(), '\n'))
+  {
+    const std::string_view path = StringUtil::StripWhitespace(line);
+    if (!path.empty() && path[0] != '#')
+      images.emplace_back(path);
+  }
+
+  if (!FileSystem::DirectoryExists(s_batch_directory.c_str()) &&
+      !FileSystem::CreateDirectory(s_batch_directory.c_str(), false))
+  {
+    Log_ErrorPrintf("Failed to create batch directory '%s'", s_batch_directory.c_str());
+    return false;
+  }
+
+  // arguments shared by every child
+  std::string common_args = fmt::format("-frames {} -stateinterval {}", s_frames_to_run, s_state_hash_interval);
+  const std::string renderer(s_base_settings_interface->GetStringValue("GPU", "Renderer"));
+  if (s_seconds_to_run > 0.0f)
+    common_args += fmt::format(" -seconds {}", s_seconds_to_run);
+  if (!renderer.empty())
+    common_args += fmt::format(" -renderer {}", QuoteCommandLineArgument(renderer));
+  if (s_frame_dump_interval > 0 && !s_dump_base_directory.empty())
+  {
+    common_args += fmt::format(" -dumpinterval {} -dumpdir {} -dumpformat {}", s_frame_dump_interval,
+                               QuoteCommandLineArgument(s_dump_base_directory),
+                               RegTestFrameDump::GetFormatName(s_frame_dump_format));
+  }
+
+  struct BatchResult
+  {
+    std::string name;
+    int exit_status = -1;
+    double seconds = 0.0;
+    std::optional<u64> state_hash;
+  };
+
+  std::vector<BatchResult> results(images.size());
+  for (size_t i = 0; i < images.size(); i++)
+  {
+    results[i].name = fmt::format("{:04}_{}", i, Path::SanitizeFileName(Path::GetFileTitle(images[i])));
+  }
+
+  const std::string program_path(FileSystem::GetProgramPath());
+  const u32 num_jobs = (s_batch_jobs > 0) ? s_batch_jobs : std::max(std::thread::hardware_concurrency(), 1u);
+  Log_InfoPrintf("Running %zu images with %u jobs...", images.size(), num_jobs);
+
+  std::atomic<size_t> next_image{0};
+  auto worker = [&]() {
+    for (;;)
+    {
+      const size_t index = next_image.fetch_add(1);
+      if (index >= images.size())
+        break;
+
+      BatchResult& result = results[index];
+      const std::string hashes_path(Path::Combine(s_batch_directory, result.name + ".hashes"));
+      const std::string log_path(Path::Combine(s_batch_directory, result.name + ".log"));
+      std::string command = fmt::format("{} {} -recordstates {}", QuoteCommandLineArgument(program_path),
+                                        common_args, QuoteCommandLineArgument(hashes_path));
+      if (!s_state_hash_verify_path.empty())
+      {
+        const std::string golden_path(Path::Combine(s_state_hash_verify_path, result.name + ".hashes"));
+        command += fmt::format(" -verifystates {}", QuoteCommandLineArgument(golden_path));
+      }
+      if (s_batch_audio)
+      {
+        const std::string audio_path(Path::Combine(s_batch_directory, result.name + ".wav"));
+        command += fmt::format(" -renderaudio {}", QuoteCommandLineArgument(audio_path));
+      }
+      command += fmt::format(" -- {} > {} 2>&1", QuoteCommandLineArgument(images[index]),
+                             QuoteCommandLineArgument(log_path));
+#ifdef _WIN32
+      // cmd.exe strips the outer pair of quotes when the command has more than two
+      command = fmt::format("\"{}\"", command);
+#endif
+
+      Log_InfoPrintf("Starting '%s'...", images[index].c_str());
+      Common::Timer timer;
+      result.exit_status = std::system(command.c_str());
+      result.seconds = timer.GetTimeSeconds();
+
+      std::optional<std::string> hashes = FileSystem::ReadFileToString(hashes_path.c_str());
+      if (hashes.has_value())
+        result.state_hash = XXH64(hashes->data(), hashes->size(), 0);
+
+      Log_InfoPrintf("'%s' %s in %.2f seconds.", images[index].c_str(),
+                     (result.exit_status == 0) ? "passed" : "failed", result.seconds);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (u32 i = 1; i < num_jobs; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  std::string report = "{\n  \"games\": [\n";
+  u32 num_failed = 0;
+  for (size_t i = 0; i < images.size(); i++)
+  {
+    const BatchResult& result = results[i];
+    num_failed += BoolToUInt32(result.exit_status != 0);
+    report += fmt::format("    {{\"path\": \"{}\", \"name\": \"{}\", \"success\": {}, \"exit_status\": {}, "
+                          "\"seconds\": {:.3f}, \"state_hash\": {}}}{}\n",
+                          EscapeJSONString(images[i]), EscapeJSONString(result.name),
+                          (result.exit_status == 0) ? "true" : "false", result.exit_status, result.seconds,
+                          result.state_hash.has_value() ? fmt::format("\"{:016x}\"", result.state_hash.value()) :
+                                                          std::string("null"),
+                          ((i + 1) < images.size()) ? "," : "");
+  }
+  report += fmt::format("  ],\n  \"failed\": {}\n}}\n", num_failed);
+
+  const std::string report_path(Path::Combine(s_batch_directory, "report.json"));
+  if (!FileSystem::WriteStringToFile(report_path.c_str(), report))
+  {
+    Log_ErrorPrintf("Failed to write report to '%s'", report_path.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("%u of %zu images failed, report written to '%s'.", num_failed, images.size(), report_path.c_str());
+  return (num_failed == 0);
+}
+
+bool RegTestHost::WriteBenchmarkResults(double seconds, u32 frames, u32 internal_frames, u64 cpu_thread_time)
+{
+  const double thread_ticks_per_second = static_cast<double>(Threading::GetThreadTicksPerSecond());
+  const Threading::Thread* sw_thread = g_gpu->GetSWThread();
+  const double cpu_thread_seconds = static_cast<double>(cpu_thread_time) / thread_ticks_per_second;
+  const double sw_thread_seconds =
+    sw_thread ? (static_cast<double>(sw_thread->GetCPUTime()) / thread_ticks_per_second) : 0.0;
+
+  // Anything on the emulation thread which isn't an event callback is the CPU core, along with the device accesses
+  // it makes directly.
+  std::string events;
+  double event_seconds = 0.0;
+  for (const TimingEvents::EventProfile& ev : TimingEvents::GetProfile())
+  {
+    events += fmt::format("{}    {{\"name\": \"{}\", \"calls\": {}, \"seconds\": {:.6f}}}", events.empty() ? "" : ",\n",
+                          EscapeJSONString(ev.name), ev.calls, ev.seconds);
+    event_seconds += ev.seconds;
+  }
+
+  const std::string json = fmt::format("{{\n"
+                                       "  \"frames\": {},\n"
+                                       "  \"seconds\": {:.6f},\n"
+                                       "  \"vps\": {:.3f},\n"
+                                       "  \"fps\": {:.3f},\n"
+                                       "  \"cpu_thread_seconds\": {:.6f},\n"
+                                       "  \"cpu_core_seconds\": {:.6f},\n"
+                                       "  \"events_seconds\": {:.6f},\n"
+                                       "  \"sw_gpu_thread_seconds\": {:.6f},\n"
+                                       "  \"events\": [\n{}\n  ]\n"
+                                       "}}\n",
+                                       frames, seconds, static_cast<double>(frames) / seconds,
+                                       static_cast<double>(internal_frames) / seconds, cpu_thread_seconds,
+                                       std::max(cpu_thread_seconds - event_seconds, 0.0), event_seconds,
+                                       sw_thread_seconds, events);
+
+  if (!FileSystem::WriteStringToFile(s_benchmark_path.c_str(), json))
+  {
+    Log_ErrorPrintf("Failed to write benchmark results to '%s'", s_benchmark_path.c_str());
+    return false;
+  }
+
+  Log_InfoPrintf("Benchmark: %u frames in %.2f seconds, %.2f VPS", frames, seconds,
+                 static_cast<double>(frames) / seconds);
+  return true;
+}
+
+void RegTestHost::UpdateFramesToRun(const std::string& boot_filename)
+{
+  float seconds = s_seconds_to_run;
+  if (seconds <= 0.0f && !s_audio_dump_path.empty() && System::IsPsfFileName(boot_filename))
+  {
+    // render the whole track, including the fade out
+    PSFLoader::File psf;
+    if (psf.Load(boot_filename.c_str()))
+    {
+      const std::optional<float> length = psf.GetTagSeconds("length");
+      if (length.has_value())
+        seconds = length.value() + psf.GetTagSeconds("fade").value_or(0.0f);
+    }
+  }
+
+  if (seconds <= 0.0f)
+    return;
+
+  s_frames_to_run = std::max(static_cast<u32>(std::ceil(seconds * System::GetThrottleFrequency())), 1u);
+  Log_InfoPrintf("Running for %.2f seconds of emulated time.", seconds);
+}
+
+bool RegTestHost::RunFrames(bool hash_states)
+{
+  // regtest never throttles, and audio and presentation are already disabled
+  const bool benchmark = !s_benchmark_path.empty();
+  if (benchmark)
+    TimingEvents::SetProfilingEnabled(true);
+
+  const u32 start_frame = System::GetFrameNumber();
+  const u32 start_internal_frame = System::GetInternalFrameNumber();
+  const Threading::ThreadHandle cpu_thread = Threading::ThreadHandle::GetForCallingThread();
+  const u64 start_cpu_thread_time = cpu_thread.GetCPUTime();
+  Common::Timer run_timer;
+
+  for (u32 frame = 0; frame < s_frames_to_run; frame++)
+  {
+    System::RunFrame();
+    Host::RenderDisplay(false);
+    System::UpdatePerformanceCounters();
+
+    if (hash_states && (System::GetFrameNumber() % s_state_hash_interval) == 0)
+      QueueStateSnapshot(System::GetFrameNumber());
+  }
+
+  if (!benchmark)
+    return true;
+
+  const double seconds = run_timer.GetTimeSeconds();
+  TimingEvents::SetProfilingEnabled(false);
+  return WriteBenchmarkResults(seconds, System::GetFrameNumber() - start_frame,
+                               System::GetInternalFrameNumber() - start_internal_frame,
+                               cpu_thread.GetCPUTime() - start_cpu_thread_time);
+}
+
+bool RegTestHost::ReplayBlockSet()
+{
+#ifdef WITH_RECOMPILER
+  // Synchronous compilation, so every block's statistics are recorded before we dump them.
+  g_settings.cpu_execution_mode = CPUExecutionMode::Recompiler;
+  g_settings.cpu_recompiler_async_compilation = false;
+  g_settings.cpu_recompiler_statistics = true;
+
+  CPU::Initialize();
+  if (!Bus::Initialize())
+  {
+    Log_ErrorPrintf("Failed to initialize bus.");
+    CPU::Shutdown();
+    return false;
+  }
+
+  CPU::CodeCache::Initialize();
+  const bool result = CPU::CodeCache::ReplayBlockSet(s_replay_blocks_path.c_str());
+  if (result)
+    CPU::CodeCache::DumpStatistics(s_benchmark_path.empty() ? nullptr : s_benchmark_path.c_str());
+
+  CPU::CodeCache::Shutdown();
+  Bus::Shutdown();
+  CPU::Shutdown();
+  return result;
+#else
+  Log_ErrorPrintf("Block sets can't be replayed without the recompiler.");
+  return false;
+#endif
 }
 
 int main(int argc, char* argv[])
@@ -626,6 +1279,25 @@ int main(int argc, char* argv[])
   if (!RegTestHost::ParseCommandLineParameters(argc, argv, autoboot))
     return EXIT_FAILURE;
 
+  if (!s_batch_list_path.empty())
+    return RegTestHost::RunBatch() ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  if (!s_frame_hash_compare_path.empty())
+  {
+    return RegTestFrameDump::CompareHashLogs(s_frame_hash_verify_path.c_str(), s_frame_hash_compare_path.c_str()) ?
+             EXIT_SUCCESS :
+             EXIT_FAILURE;
+  }
+
+  if (!s_microbench_filter.empty())
+  {
+    return RegTestBenchmarks::Run(s_microbench_filter, s_microbench_image_path, s_benchmark_path) ? EXIT_SUCCESS :
+                                                                                                    EXIT_FAILURE;
+  }
+
+  if (!s_replay_blocks_path.empty())
+    return RegTestHost::ReplayBlockSet() ? EXIT_SUCCESS : EXIT_FAILURE;
+
   if (!autoboot || autoboot->filename.empty())
   {
     Log_ErrorPrintf("No boot path specified.");
@@ -634,11 +1306,15 @@ int main(int argc, char* argv[])
 
   RegTestHost::HookSignals();
 
+  if (!s_boot_save_state_path.empty())
+    autoboot->save_state = s_boot_save_state_path;
+
   int result = -1;
-  Log_InfoPrintf("Trying to boot '%s'...", autoboot->filename.c_str());
-  if (!System::BootSystem(std::move(autoboot.value())))
+  std::string boot_filename;
+  const bool hash_states = !s_state_hash_record_path.empty() || !s_state_hash_verify_path.empty();
+  if (!s_frame_hash_verify_path.empty() && s_frame_dump_format != RegTestFrameDump::Format::Hash)
   {
-    Log_ErrorPrintf("Failed to boot system.");
+    Log_ErrorPrint("Frame verification requires -dumpformat hash.");
     goto cleanup;
   }
 
@@ -650,24 +1326,65 @@ int main(int argc, char* argv[])
       goto cleanup;
     }
 
+    // the output directory is chosen when the game is identified during boot
+    const u32 num_threads =
+      (s_frame_dump_threads > 0) ? s_frame_dump_threads : std::max(std::thread::hardware_concurrency(), 1u);
+    RegTestFrameDump::Start(s_frame_dump_format, num_threads, num_threads * 2);
     Log_InfoPrintf("Dumping every %dth frame to '%s'.", s_frame_dump_interval, s_dump_base_directory.c_str());
   }
 
+  Log_InfoPrintf("Trying to boot '%s'...", autoboot->filename.c_str());
+  boot_filename = autoboot->filename;
+  if (!System::BootSystem(std::move(autoboot.value())))
+  {
+    Log_ErrorPrintf("Failed to boot system.");
+    goto cleanup;
+  }
+
+  // regtest never throttles, so this renders as fast as the CPU and SPU can go
+  if (!s_audio_dump_path.empty() && !System::StartDumpingAudio(s_audio_dump_path.c_str()))
+  {
+    Log_ErrorPrintf("Failed to start rendering audio to '%s'.", s_audio_dump_path.c_str());
+    System::ShutdownSystem(false);
+    goto cleanup;
+  }
+
+  RegTestHost::UpdateFramesToRun(boot_filename);
+
+  if (hash_states)
+    RegTestHost::StartStateHashing();
+
   Log_InfoPrintf("Running for %d frames...", s_frames_to_run);
 
-  for (u32 frame = 0; frame < s_frames_to_run; frame++)
+  if (!RegTestHost::RunFrames(hash_states))
   {
-    System::RunFrame();
-    Host::RenderDisplay(false);
-    System::UpdatePerformanceCounters();
+    System::ShutdownSystem(false);
+    goto cleanup;
   }
 
   Log_InfoPrintf("All done, shutting down system.");
   System::ShutdownSystem(false);
 
+  if (!RegTestFrameDump::Finish())
+  {
+    Log_ErrorPrintf("Failed to write some dumped frames.");
+    goto cleanup;
+  }
+
+  if (!s_frame_hash_verify_path.empty())
+  {
+    const std::string hash_log_path(Path::Combine(s_dump_game_directory, RegTestFrameDump::HASH_LOG_FILENAME));
+    if (!RegTestFrameDump::CompareHashLogs(s_frame_hash_verify_path.c_str(), hash_log_path.c_str()))
+      goto cleanup;
+  }
+
+  if (hash_states && !RegTestHost::FinishStateHashing())
+    goto cleanup;
+
   Log_InfoPrintf("Exiting with success.");
   result = 0;
 
 cleanup:
+  RegTestFrameDump::Finish();
   return result;
 }
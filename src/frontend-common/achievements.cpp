@@ -3,11 +3,9 @@
 #include "common/file_system.h"
 #include "common/http_downloader.h"
 #include "common/log.h"
-#include "common/md5_digest.h"
 #include "common/path.h"
 #include "common/platform.h"
 #include "common/string_util.h"
-#include "core/bios.h"
 #include "core/bus.h"
 #include "core/cpu_core.h"
 #include "core/host.h"
@@ -31,6 +29,7 @@
 #include <atomic>
 #include <cstdarg>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 #include <functional>
 #include <string>
@@ -91,7 +90,6 @@ static void GetUserUnlocks();
 static void GetPatchesCallback(s32 status_code, std::string content_type, Common::HTTPDownloader::Request::Data data);
 static void GetLbInfoCallback(s32 status_code, std::string content_type, Common::HTTPDownloader::Request::Data data);
 static void GetPatches(u32 game_id);
-static std::string GetGameHash(CDImage* image);
 static void SetChallengeMode(bool enabled);
 static void SendGetGameId();
 static void GetGameIdCallback(s32 status_code, std::string content_type, Common::HTTPDownloader::Request::Data data);
@@ -298,7 +296,7 @@ void Achievements::FormattedError(const char* format, ...)
   va_end(ap);
 
   Log_ErrorPrint(error.c_str());
-  Host::AddOSDMessage(std::move(error), 10.0f);
+  Host::AddOSDMessage(error, 10.0f);
 }
 
 void Achievements::LogFailedResponseJSON(const Common::HTTPDownloader::Request::Data& data)
@@ -1299,44 +1297,6 @@ void Achievements::GetPatches(u32 game_id)
   request.Send(GetPatchesCallback);
 }
 
-std::string Achievements::GetGameHash(CDImage* image)
-{
-  std::string executable_name;
-  std::vector<u8> executable_data;
-  if (!System::ReadExecutableFromImage(image, &executable_name, &executable_data))
-    return {};
-
-  BIOS::PSEXEHeader header;
-  if (executable_data.size() >= sizeof(header))
-    std::memcpy(&header, executable_data.data(), sizeof(header));
-  if (!BIOS::IsValidPSExeHeader(header, static_cast<u32>(executable_data.size())))
-  {
-    Log_ErrorPrintf("PS-EXE header is invalid in '%s' (%zu bytes)", executable_name.c_str(), executable_data.size());
-    return {};
-  }
-
-  // See rcheevos hash.c - rc_hash_psx().
-  const u32 MAX_HASH_SIZE = 64 * 1024 * 1024;
-  const u32 hash_size = std::min<u32>(sizeof(header) + header.file_size, MAX_HASH_SIZE);
-  Assert(hash_size <= executable_data.size());
-
-  MD5Digest digest;
-  digest.Update(executable_name.c_str(), static_cast<u32>(executable_name.size()));
-  if (hash_size > 0)
-    digest.Update(executable_data.data(), hash_size);
-
-  u8 hash[16];
-  digest.Final(hash);
-
-  std::string hash_str(StringUtil::StdStringFromFormat(
-    "%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x", hash[0], hash[1], hash[2], hash[3], hash[4],
-    hash[5], hash[6], hash[7], hash[8], hash[9], hash[10], hash[11], hash[12], hash[13], hash[14], hash[15]));
-
-  Log_InfoPrintf("Hash for '%s' (%zu bytes, %u bytes hashed): %s", executable_name.c_str(), executable_data.size(),
-                 hash_size, hash_str.c_str());
-  return hash_str;
-}
-
 void Achievements::GetGameIdCallback(s32 status_code, std::string content_type,
                                      Common::HTTPDownloader::Request::Data data)
 {
@@ -1386,7 +1346,18 @@ void Achievements::GameChanged(const std::string& path, CDImage* image)
   std::string game_hash;
   if (image)
   {
-    game_hash = GetGameHash(image);
+    // the system's image has usually just been identified, a temporary copy is read without disturbing that
+    if (temp_image)
+    {
+      System::ImageIdentification ident;
+      System::IdentifyImage(image, &ident, true);
+      game_hash = std::move(ident.achievements_hash);
+    }
+    else
+    {
+      game_hash = System::GetImageIdentification(image).achievements_hash;
+    }
+
     if (s_game_hash == game_hash)
     {
       // only the path has changed - different format/save state/etc.
@@ -1996,6 +1967,35 @@ void Achievements::CheevosEventHandler(const rc_runtime_event_t* runtime_event)
 
 unsigned Achievements::PeekMemory(unsigned address, unsigned num_bytes, void* ud)
 {
+  // Achievement addresses are offsets into RAM, so nearly every reference can be read directly, skipping the CPU's
+  // address translation and bus dispatch. Anything past the end of RAM still goes through the safe path.
+  if ((static_cast<u64>(address) + num_bytes) <= Bus::g_ram_size)
+  {
+    const u8* ptr = &Bus::g_ram[address];
+    switch (num_bytes)
+    {
+      case 1:
+        return *ptr;
+
+      case 2:
+      {
+        u16 value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+      }
+
+      case 4:
+      {
+        u32 value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+      }
+
+      default:
+        return 0;
+    }
+  }
+
   switch (num_bytes)
   {
     case 1:
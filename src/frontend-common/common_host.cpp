@@ -7,17 +7,20 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/trace.h"
 #include "core/cdrom.h"
 #include "core/cheats.h"
 #include "core/controller.h"
 #include "core/cpu_code_cache.h"
 #include "core/dma.h"
+#include "core/game_database.h"
 #include "core/gpu.h"
 #include "core/gte.h"
 #include "core/host.h"
 #include "core/host_display.h"
 #include "core/host_settings.h"
 #include "core/mdec.h"
+#include "core/mmio_profiler.h"
 #include "core/pgxp.h"
 #include "core/save_state_version.h"
 #include "core/settings.h"
@@ -25,6 +28,7 @@
 #include "core/system.h"
 #include "core/texture_replacements.h"
 #include "core/timers.h"
+#include "fmt/chrono.h"
 #include "fullscreen_ui.h"
 #include "game_list.h"
 #include "icon.h"
@@ -96,6 +100,9 @@ std::string m_discord_presence_cheevos_string;
 
 void CommonHost::Initialize()
 {
+  // Parse the game database while input sources are being initialized, it doesn't depend on settings.
+  GameDatabase::PreloadAsync();
+
   // This will call back to Host::LoadSettings() -> ReloadSources().
   System::LoadSettings(false);
 
@@ -214,6 +221,7 @@ std::unique_ptr<AudioStream> Host::CreateAudioStream(AudioBackend backend, u32 s
 void CommonHost::UpdateLogSettings()
 {
   Log::SetFilterLevel(g_settings.log_level);
+  Log::SetAsyncOutput(true);
   Log::SetConsoleOutputParams(g_settings.log_to_console,
                               g_settings.log_filter.empty() ? nullptr : g_settings.log_filter.c_str(),
                               g_settings.log_level);
@@ -356,6 +364,8 @@ void CommonHost::LoadSettings(SettingsInterface& si, std::unique_lock<std::mutex
 
 void CommonHost::CheckForSettingsChanges(const Settings& old_settings)
 {
+  Host::Internal::InvalidateCachedSettings();
+
   if (System::IsValid())
   {
     if (g_settings.inhibit_screensaver != old_settings.inhibit_screensaver)
@@ -412,6 +422,11 @@ void Host::SetPadVibrationIntensity(u32 pad_index, float large_or_single_motor_i
   InputManager::SetPadVibrationIntensity(pad_index, large_or_single_motor_intensity, small_motor_intensity);
 }
 
+void Host::PollInputForControllerRead()
+{
+  InputManager::PollSourcesForControllerRead();
+}
+
 void Host::DisplayLoadingScreen(const char* message, int progress_min /*= -1*/, int progress_max /*= -1*/,
                                 int progress_value /*= -1*/)
 {
@@ -488,6 +503,10 @@ void ImGuiManager::RenderDebugWindows()
       g_mdec.DrawDebugStateWindow();
     if (g_settings.debugging.show_dma_state)
       g_dma.DrawDebugStateWindow();
+#ifdef WITH_MMIO_PROFILER
+    if (g_settings.debugging.show_mmio_access_counters)
+      MMIOProfiler::DrawDebugWindow();
+#endif
   }
 }
 
@@ -720,6 +739,42 @@ DEFINE_HOTKEY("Screenshot", TRANSLATABLE("Hotkeys", "General"), TRANSLATABLE("Ho
                   System::SaveScreenshot();
               })
 
+DEFINE_HOTKEY("ToggleTraceCapture", TRANSLATABLE("Hotkeys", "General"),
+              TRANSLATABLE("Hotkeys", "Toggle Frame Timeline Capture"), [](s32 pressed) {
+                if (pressed)
+                  return;
+
+                if (!Trace::IsCapturing())
+                {
+                  Trace::StartCapture();
+                  Host::AddKeyedOSDMessage("ToggleTraceCapture",
+                                           Host::TranslateStdString("OSDMessage", "Frame timeline capture started."),
+                                           5.0f);
+                  return;
+                }
+
+                const std::string filename(
+                  Path::Combine(EmuFolders::DataRoot,
+                                fmt::format("trace_{:%Y-%m-%d_%H-%M-%S}.json", fmt::localtime(std::time(nullptr)))));
+                if (Trace::StopCapture(filename.c_str()))
+                {
+                  Host::AddKeyedOSDMessage(
+                    "ToggleTraceCapture",
+                    fmt::format(Host::TranslateString("OSDMessage", "Frame timeline saved to '{}'.").GetCharArray(),
+                                Path::GetFileName(filename)),
+                    10.0f);
+                }
+                else
+                {
+                  Host::AddKeyedOSDMessage(
+                    "ToggleTraceCapture",
+                    fmt::format(Host::TranslateString("OSDMessage", "Failed to save frame timeline to '{}'.")
+                                  .GetCharArray(),
+                                Path::GetFileName(filename)),
+                    10.0f);
+                }
+              })
+
 #if !defined(__ANDROID__) && defined(WITH_CHEEVOS)
 DEFINE_HOTKEY("OpenAchievements", TRANSLATABLE("Hotkeys", "General"), TRANSLATABLE("Hotkeys", "Open Achievement List"),
               [](s32 pressed) {
@@ -850,9 +905,10 @@ DEFINE_HOTKEY("DecreaseEmulationSpeed", TRANSLATABLE("Hotkeys", "System"),
 
 DEFINE_HOTKEY("ResetEmulationSpeed", TRANSLATABLE("Hotkeys", "System"),
               TRANSLATABLE("Hotkeys", "Reset Emulation Speed"), [](s32 pressed) {
+                static Host::CachedSettingValue<float> s_emulation_speed("Main", "EmulationSpeed", 1.0f);
                 if (!pressed && System::IsValid())
                 {
-                  g_settings.emulation_speed = Host::GetFloatSettingValue("Main", "EmulationSpeed", 1.0f);
+                  g_settings.emulation_speed = s_emulation_speed.Get();
                   System::UpdateSpeedLimiterState();
                   Host::AddKeyedFormattedOSDMessage("EmulationSpeedChange", 5.0f,
                                                     Host::TranslateString("OSDMessage", "Emulation speed set to %u%%."),
@@ -14,7 +14,9 @@
 #include "imgui.h"
 #include "imgui_impl_dx11.h"
 #include "postprocessing_shadergen.h"
+#include <algorithm>
 #include <array>
+#include <d3d11_4.h>
 #include <dxgi1_5.h>
 Log_SetChannel(D3D11HostDisplay);
 
@@ -27,6 +29,7 @@ D3D11HostDisplay::D3D11HostDisplay() = default;
 
 D3D11HostDisplay::~D3D11HostDisplay()
 {
+  m_present_thread.Stop();
   DestroyStagingBuffer();
   DestroyResources();
   DestroyRenderSurface();
@@ -279,6 +282,21 @@ bool D3D11HostDisplay::CreateRenderDevice(const WindowInfo& wi)
   if (SUCCEEDED(dxgi_device.As(&dxgi_device1)))
     dxgi_device1->SetMaximumFrameLatency(1);
 
+  // Present() goes through the immediate context, so it has to be locked against the CPU thread.
+  if (g_settings.gpu_threaded_presentation)
+  {
+    ComPtr<ID3D11Multithread> multithread;
+    if (SUCCEEDED(m_context.As(&multithread)))
+    {
+      multithread->SetMultithreadProtected(TRUE);
+      m_present_thread.Start();
+    }
+    else
+    {
+      Log_WarningPrint("ID3D11Multithread is not available, presenting on the CPU thread");
+    }
+  }
+
   DXGI_ADAPTER_DESC adapter_desc;
   if (SUCCEEDED(dxgi_adapter->GetDesc(&adapter_desc)))
   {
@@ -459,6 +477,9 @@ bool D3D11HostDisplay::ChangeRenderWindow(const WindowInfo& new_wi)
 
 void D3D11HostDisplay::DestroyRenderSurface()
 {
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   m_window_info.SetSurfaceless();
   if (IsFullscreen())
     SetFullscreen(false, 0, 0, 0.0f);
@@ -472,6 +493,9 @@ void D3D11HostDisplay::ResizeRenderWindow(s32 new_window_width, s32 new_window_h
   if (!m_swap_chain)
     return;
 
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   m_swap_chain_rtv.Reset();
 
   HRESULT hr = m_swap_chain->ResizeBuffers(0, 0, 0, DXGI_FORMAT_UNKNOWN,
@@ -499,6 +523,9 @@ bool D3D11HostDisplay::SetFullscreen(bool fullscreen, u32 width, u32 height, flo
   if (!m_swap_chain)
     return false;
 
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   BOOL is_fullscreen = FALSE;
   HRESULT hr = m_swap_chain->GetFullscreenState(&is_fullscreen, nullptr);
   if (!fullscreen)
@@ -630,8 +657,8 @@ bool D3D11HostDisplay::CreateResources()
 void D3D11HostDisplay::DestroyResources()
 {
   m_post_processing_chain.ClearStages();
-  m_post_processing_input_texture.Destroy();
   m_post_processing_stages.clear();
+  DestroyPostProcessingTargets();
 
   m_display_uniform_buffer.Release();
   m_border_sampler.Reset();
@@ -671,6 +698,10 @@ bool D3D11HostDisplay::Render(bool skip_present)
     return false;
   }
 
+  // Nothing on screen would change, so leave the last frame up rather than drawing and presenting it again.
+  if (IsDuplicateFrame(m_post_processing_chain.UsesTime()))
+    return true;
+
   // When using vsync, the time here seems to include the time for the buffer to become available.
   // This blows our our GPU usage number considerably, so read the timestamp before the final blit
   // in this configuration. It does reduce accuracy a little, but better than seeing 100% all of
@@ -678,6 +709,10 @@ bool D3D11HostDisplay::Render(bool skip_present)
   if (m_vsync && m_gpu_timing_enabled)
     PopTimestampQuery();
 
+  // The swap chain RTV refers to whichever buffer is current, which only moves on once the last present is done.
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   RenderDisplay();
 
   if (ImGui::GetCurrentContext())
@@ -688,10 +723,12 @@ bool D3D11HostDisplay::Render(bool skip_present)
   if (!m_vsync && m_gpu_timing_enabled)
     PopTimestampQuery();
 
-  if (!m_vsync && m_using_allow_tearing)
-    m_swap_chain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
+  const UINT sync_interval = BoolToUInt32(m_vsync);
+  const UINT present_flags = (!m_vsync && m_using_allow_tearing) ? DXGI_PRESENT_ALLOW_TEARING : 0;
+  if (m_present_thread.IsRunning())
+    m_present_thread.QueuePresent(m_swap_chain.Get(), sync_interval, present_flags);
   else
-    m_swap_chain->Present(BoolToUInt32(m_vsync), 0);
+    m_swap_chain->Present(sync_interval, present_flags);
 
   if (m_gpu_timing_enabled)
     KickTimestampQuery();
@@ -926,15 +963,20 @@ bool D3D11HostDisplay::SetPostProcessingChain(const std::string_view& config)
 {
   if (config.empty())
   {
-    m_post_processing_input_texture.Destroy();
     m_post_processing_stages.clear();
     m_post_processing_chain.ClearStages();
+    DestroyPostProcessingTargets();
     return true;
   }
 
-  if (!m_post_processing_chain.CreateFromString(config))
+  bool shaders_changed;
+  if (!m_post_processing_chain.CreateFromString(config, &shaders_changed))
     return false;
 
+  // options are passed through uniforms, so there's nothing to recompile when only they change
+  if (!shaders_changed && m_post_processing_stages.size() == m_post_processing_chain.GetStageCount())
+    return true;
+
   m_post_processing_stages.clear();
 
   D3D11::ShaderCache shader_cache;
@@ -979,34 +1021,73 @@ bool D3D11HostDisplay::SetPostProcessingChain(const std::string_view& config)
   return true;
 }
 
-bool D3D11HostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+D3D11::Texture* D3D11HostDisplay::GetPostProcessingTarget(u32 width, u32 height, const D3D11::Texture* input)
 {
-  DebugAssert(!m_post_processing_stages.empty());
-
-  const GPUTexture::Format format = GPUTexture::Format::RGBA8;
-  const u32 bind_flags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
-
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  // targets are shared between stages of the same size, as long as it's not the one the stage is reading from
+  for (const std::unique_ptr<PostProcessingTarget>& target : m_post_processing_targets)
   {
-    if (!m_post_processing_input_texture.Create(m_device.Get(), target_width, target_height, 1, 1, 1, format,
-                                                bind_flags))
+    if (&target->texture != input && target->texture.GetWidth() == width && target->texture.GetHeight() == height)
     {
-      return false;
+      target->last_used = m_post_processing_target_counter;
+      return &target->texture;
     }
   }
 
+  std::unique_ptr<PostProcessingTarget> target = std::make_unique<PostProcessingTarget>();
+  if (!target->texture.Create(m_device.Get(), width, height, 1, 1, 1, GPUTexture::Format::RGBA8,
+                              D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE))
+  {
+    return nullptr;
+  }
+
+  target->last_used = m_post_processing_target_counter;
+  m_post_processing_targets.push_back(std::move(target));
+  return &m_post_processing_targets.back()->texture;
+}
+
+void D3D11HostDisplay::DestroyPostProcessingTargets()
+{
+  m_post_processing_input_texture = nullptr;
+  for (PostProcessingStage& pps : m_post_processing_stages)
+    pps.output_texture = nullptr;
+  m_post_processing_targets.clear();
+  m_post_processing_chain.InvalidateIntermediateCache();
+}
+
+bool D3D11HostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height,
+                                                        const Common::Rectangle<s32>& final_rect)
+{
+  DebugAssert(!m_post_processing_stages.empty());
+
+  m_post_processing_target_counter++;
+  m_post_processing_input_texture = GetPostProcessingTarget(target_width, target_height, nullptr);
+  if (!m_post_processing_input_texture)
+    return false;
+
+  const D3D11::Texture* input = m_post_processing_input_texture;
   const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
   for (u32 i = 0; i < target_count; i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
-    {
-      if (!pps.output_texture.Create(m_device.Get(), target_width, target_height, 1, 1, 1, format, bind_flags))
-        return false;
-    }
+    u32 width = target_width;
+    u32 height = target_height;
+    pps.output_rect = m_post_processing_chain.GetShaderStage(i).GetScaledOutputRect(final_rect, &width, &height);
+    pps.output_texture = GetPostProcessingTarget(width, height, input);
+    if (!pps.output_texture)
+      return false;
+
+    input = pps.output_texture;
   }
 
+  // release anything which hasn't been needed for a while, e.g. from a screenshot
+  m_post_processing_targets.erase(
+    std::remove_if(m_post_processing_targets.begin(), m_post_processing_targets.end(),
+                   [this](const std::unique_ptr<PostProcessingTarget>& target) {
+                     return ((m_post_processing_target_counter - target->last_used) >
+                             FrontendCommon::PostProcessingChain::TARGET_POOL_LIFETIME);
+                   }),
+    m_post_processing_targets.end());
+
   return true;
 }
 
@@ -1015,55 +1096,69 @@ void D3D11HostDisplay::ApplyPostProcessingChain(ID3D11RenderTargetView* final_ta
                                                 s32 texture_view_x, s32 texture_view_y, s32 texture_view_width,
                                                 s32 texture_view_height, u32 target_width, u32 target_height)
 {
-  if (!CheckPostProcessingRenderTargets(target_width, target_height))
+  // intermediate stages only need to be re-run when the input or target changes, e.g. not while paused
+  const Common::Rectangle<s32> final_rect =
+    Common::Rectangle<s32>::FromExtents(final_left, final_top, final_width, final_height);
+  const bool use_cached_stages =
+    m_post_processing_chain.UpdateIntermediateCache(m_display_changed, target_width, target_height, final_rect);
+  m_display_changed = false;
+
+  if (!use_cached_stages)
   {
+    if (!CheckPostProcessingRenderTargets(target_width, target_height, final_rect))
+    {
+      m_post_processing_chain.InvalidateIntermediateCache();
+      RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
+                    texture_view_width, texture_view_height, IsUsingLinearFiltering());
+      return;
+    }
+
+    m_context->ClearRenderTargetView(m_post_processing_input_texture->GetD3DRTV(), s_clear_color.data());
+    m_context->OMSetRenderTargets(1, m_post_processing_input_texture->GetD3DRTVArray(), nullptr);
     RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
                   texture_view_width, texture_view_height, IsUsingLinearFiltering());
-    return;
   }
-
-  // downsample/upsample - use same viewport for remainder
-  m_context->ClearRenderTargetView(m_post_processing_input_texture.GetD3DRTV(), s_clear_color.data());
-  m_context->OMSetRenderTargets(1, m_post_processing_input_texture.GetD3DRTVArray(), nullptr);
-  RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
-                texture_view_width, texture_view_height, IsUsingLinearFiltering());
-
-  const s32 orig_texture_width = texture_view_width;
-  const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
-  texture_view_x = final_left;
-  texture_view_y = final_top;
-  texture_view_width = final_width;
-  texture_view_height = final_height;
+  else
+  {
+    // normally set up by RenderDisplay()
+    m_context->RSSetState(m_display_rasterizer_state.Get());
+    m_context->OMSetDepthStencilState(m_display_depth_stencil_state.Get(), 0);
+    m_context->OMSetBlendState(m_display_blend_state.Get(), nullptr, 0xFFFFFFFFu);
+  }
 
   const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  for (u32 i = use_cached_stages ? final_stage : 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
-    ID3D11RenderTargetView* rtv = (i == final_stage) ? final_target : pps.output_texture.GetD3DRTV();
+    const D3D11::Texture* input =
+      (i == 0) ? m_post_processing_input_texture : m_post_processing_stages[i - 1].output_texture;
+    const Common::Rectangle<s32>& input_rect = (i == 0) ? final_rect : m_post_processing_stages[i - 1].output_rect;
+
+    ID3D11RenderTargetView* rtv = (i == final_stage) ? final_target : pps.output_texture->GetD3DRTV();
+    const Common::Rectangle<s32>& output_rect = (i == final_stage) ? final_rect : pps.output_rect;
+    const CD3D11_VIEWPORT vp(static_cast<float>(output_rect.left), static_cast<float>(output_rect.top),
+                             static_cast<float>(output_rect.GetWidth()), static_cast<float>(output_rect.GetHeight()));
     m_context->ClearRenderTargetView(rtv, s_clear_color.data());
     m_context->OMSetRenderTargets(1, &rtv, nullptr);
+    m_context->RSSetViewports(1, &vp);
 
     m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     m_context->VSSetShader(pps.vertex_shader.Get(), nullptr, 0);
     m_context->PSSetShader(pps.pixel_shader.Get(), nullptr, 0);
-    m_context->PSSetShaderResources(0, 1, texture->GetD3DSRVArray());
+    m_context->PSSetShaderResources(0, 1, input->GetD3DSRVArray());
     m_context->PSSetSamplers(0, 1, m_border_sampler.GetAddressOf());
 
     const auto map =
       m_display_uniform_buffer.Map(m_context.Get(), m_display_uniform_buffer.GetSize(), pps.uniforms_size);
     m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-      map.pointer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
-      texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
+      map.pointer, input->GetWidth(), input->GetHeight(), input_rect.left, input_rect.top, input_rect.GetWidth(),
+      input_rect.GetHeight(), GetWindowWidth(), GetWindowHeight(), texture_view_width, texture_view_height,
       static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
     m_display_uniform_buffer.Unmap(m_context.Get(), pps.uniforms_size);
     m_context->VSSetConstantBuffers(0, 1, m_display_uniform_buffer.GetD3DBufferArray());
     m_context->PSSetConstantBuffers(0, 1, m_display_uniform_buffer.GetD3DBufferArray());
 
     m_context->Draw(3, 0);
-
-    if (i != final_stage)
-      texture = &pps.output_texture;
   }
 
   ID3D11ShaderResourceView* null_srv = nullptr;
@@ -5,6 +5,7 @@
 #include "common/window_info.h"
 #include "common/windows_headers.h"
 #include "core/host_display.h"
+#include "frontend-common/dxgi_present_thread.h"
 #include "frontend-common/postprocessing_chain.h"
 #include <d3d11.h>
 #include <dxgi.h>
@@ -100,11 +101,20 @@ protected:
   {
     ComPtr<ID3D11VertexShader> vertex_shader;
     ComPtr<ID3D11PixelShader> pixel_shader;
-    D3D11::Texture output_texture;
+    D3D11::Texture* output_texture = nullptr;
+    Common::Rectangle<s32> output_rect;
     u32 uniforms_size;
   };
 
-  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
+  struct PostProcessingTarget
+  {
+    D3D11::Texture texture;
+    u32 last_used = 0;
+  };
+
+  D3D11::Texture* GetPostProcessingTarget(u32 width, u32 height, const D3D11::Texture* input);
+  void DestroyPostProcessingTargets();
+  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height, const Common::Rectangle<s32>& final_rect);
   void ApplyPostProcessingChain(ID3D11RenderTargetView* final_target, s32 final_left, s32 final_top, s32 final_width,
                                 s32 final_height, D3D11::Texture* texture, s32 texture_view_x, s32 texture_view_y,
                                 s32 texture_view_width, s32 texture_view_height, u32 target_width, u32 target_height);
@@ -143,9 +153,13 @@ protected:
   bool m_using_allow_tearing = false;
   bool m_vsync = true;
 
+  DXGIPresentThread m_present_thread;
+
   FrontendCommon::PostProcessingChain m_post_processing_chain;
-  D3D11::Texture m_post_processing_input_texture;
+  D3D11::Texture* m_post_processing_input_texture = nullptr;
   std::vector<PostProcessingStage> m_post_processing_stages;
+  std::vector<std::unique_ptr<PostProcessingTarget>> m_post_processing_targets;
+  u32 m_post_processing_target_counter = 0;
   Common::Timer m_post_processing_timer;
 
   std::array<std::array<ComPtr<ID3D11Query>, 3>, NUM_TIMESTAMP_QUERIES> m_timestamp_queries = {};
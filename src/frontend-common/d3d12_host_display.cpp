@@ -12,6 +12,7 @@
 #include "frontend-common/postprocessing_shadergen.h"
 #include "imgui.h"
 #include "imgui_impl_dx12.h"
+#include <algorithm>
 #include <array>
 #include <dxgi1_5.h>
 Log_SetChannel(D3D12HostDisplay);
@@ -22,6 +23,7 @@ D3D12HostDisplay::D3D12HostDisplay() = default;
 
 D3D12HostDisplay::~D3D12HostDisplay()
 {
+  m_present_thread.Stop();
   if (!g_d3d12_context)
     return;
 
@@ -205,6 +207,10 @@ bool D3D12HostDisplay::CreateRenderDevice(const WindowInfo& wi)
     return false;
   }
 
+  // The command queue is free-threaded, so the present can go straight onto it from another thread.
+  if (g_settings.gpu_threaded_presentation)
+    m_present_thread.Start();
+
   return true;
 }
 
@@ -348,6 +354,9 @@ bool D3D12HostDisplay::ChangeRenderWindow(const WindowInfo& new_wi)
 
 void D3D12HostDisplay::DestroyRenderSurface()
 {
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   m_window_info.SetSurfaceless();
 
   // For some reason if we don't execute the command list here, the swap chain is in use.. not sure where.
@@ -365,6 +374,9 @@ void D3D12HostDisplay::ResizeRenderWindow(s32 new_window_width, s32 new_window_h
   if (!m_swap_chain)
     return;
 
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   // For some reason if we don't execute the command list here, the swap chain is in use.. not sure where.
   g_d3d12_context->ExecuteCommandList(true);
 
@@ -395,6 +407,9 @@ bool D3D12HostDisplay::SetFullscreen(bool fullscreen, u32 width, u32 height, flo
   if (!m_swap_chain)
     return false;
 
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   BOOL is_fullscreen = FALSE;
   HRESULT hr = m_swap_chain->GetFullscreenState(&is_fullscreen, nullptr);
   if (!fullscreen)
@@ -541,8 +556,8 @@ void D3D12HostDisplay::DestroyResources()
 {
   m_post_processing_cbuffer.Destroy(false);
   m_post_processing_chain.ClearStages();
-  m_post_processing_input_texture.Destroy();
   m_post_processing_stages.clear();
+  DestroyPostProcessingTargets();
   m_post_processing_cb_root_signature.Reset();
   m_post_processing_root_signature.Reset();
 
@@ -585,6 +600,10 @@ bool D3D12HostDisplay::Render(bool skip_present)
     return false;
   }
 
+  // Nothing on screen would change, so leave the last frame up rather than drawing and presenting it again.
+  if (IsDuplicateFrame(m_post_processing_chain.UsesTime()))
+    return true;
+
   D3D12::Texture& swap_chain_buf = m_swap_chain_buffers[m_current_swap_chain_buffer];
   m_current_swap_chain_buffer = ((m_current_swap_chain_buffer + 1) % static_cast<u32>(m_swap_chain_buffers.size()));
 
@@ -597,12 +616,19 @@ bool D3D12HostDisplay::Render(bool skip_present)
   RenderSoftwareCursor(cmdlist);
 
   swap_chain_buf.TransitionToState(D3D12_RESOURCE_STATE_PRESENT);
+
+  // Buffers are written in present order, so the last present has to be on the queue before this frame's commands.
+  if (m_present_thread.IsRunning())
+    m_present_thread.WaitForPresentComplete();
+
   g_d3d12_context->ExecuteCommandList(false);
 
-  if (!m_vsync && m_using_allow_tearing)
-    m_swap_chain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
+  const UINT sync_interval = BoolToUInt32(m_vsync);
+  const UINT present_flags = (!m_vsync && m_using_allow_tearing) ? DXGI_PRESENT_ALLOW_TEARING : 0;
+  if (m_present_thread.IsRunning())
+    m_present_thread.QueuePresent(m_swap_chain.Get(), sync_interval, present_flags);
   else
-    m_swap_chain->Present(BoolToUInt32(m_vsync), 0);
+    m_swap_chain->Present(sync_interval, present_flags);
 
   return true;
 }
@@ -828,32 +854,26 @@ HostDisplay::AdapterAndModeList D3D12HostDisplay::GetAdapterAndModeList(IDXGIFac
   return adapter_info;
 }
 
-D3D12HostDisplay::PostProcessingStage::PostProcessingStage(PostProcessingStage&& move)
-  : pipeline(std::move(move.pipeline)), output_texture(std::move(move.output_texture)),
-    uniforms_size(move.uniforms_size)
-{
-  move.uniforms_size = 0;
-}
-
-D3D12HostDisplay::PostProcessingStage::~PostProcessingStage()
-{
-  output_texture.Destroy(true);
-}
-
 bool D3D12HostDisplay::SetPostProcessingChain(const std::string_view& config)
 {
-  g_d3d12_context->ExecuteCommandList(true);
-
   if (config.empty())
   {
+    g_d3d12_context->ExecuteCommandList(true);
     m_post_processing_stages.clear();
     m_post_processing_chain.ClearStages();
+    DestroyPostProcessingTargets();
     return true;
   }
 
-  if (!m_post_processing_chain.CreateFromString(config))
+  bool shaders_changed;
+  if (!m_post_processing_chain.CreateFromString(config, &shaders_changed))
     return false;
 
+  // options are passed through uniforms, so there's nothing to recompile when only they change
+  if (!shaders_changed && m_post_processing_stages.size() == m_post_processing_chain.GetStageCount())
+    return true;
+
+  g_d3d12_context->ExecuteCommandList(true);
   m_post_processing_stages.clear();
 
   D3D12::ShaderCache shader_cache;
@@ -925,41 +945,79 @@ bool D3D12HostDisplay::SetPostProcessingChain(const std::string_view& config)
   return true;
 }
 
-bool D3D12HostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+D3D12::Texture* D3D12HostDisplay::GetPostProcessingTarget(u32 width, u32 height, const D3D12::Texture* input)
 {
-  DebugAssert(!m_post_processing_stages.empty());
+  // targets are shared between stages of the same size, as long as it's not the one the stage is reading from
+  for (const std::unique_ptr<PostProcessingTarget>& target : m_post_processing_targets)
+  {
+    if (&target->texture != input && target->texture.GetWidth() == width && target->texture.GetHeight() == height)
+    {
+      target->last_used = m_post_processing_target_counter;
+      return &target->texture;
+    }
+  }
 
   const DXGI_FORMAT tex_format = DXGI_FORMAT_R8G8B8A8_UNORM;
   const DXGI_FORMAT srv_format = DXGI_FORMAT_R8G8B8A8_UNORM;
   const DXGI_FORMAT rtv_format = DXGI_FORMAT_R8G8B8A8_UNORM;
 
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  std::unique_ptr<PostProcessingTarget> target = std::make_unique<PostProcessingTarget>();
+  if (!target->texture.Create(width, height, 1, 1, 1, tex_format, srv_format, rtv_format, DXGI_FORMAT_UNKNOWN,
+                              D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET))
   {
-    if (!m_post_processing_input_texture.Create(target_width, target_height, 1, 1, 1, tex_format, srv_format,
-                                                rtv_format, DXGI_FORMAT_UNKNOWN,
-                                                D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET))
-    {
-      return false;
-    }
-    D3D12::SetObjectName(m_post_processing_input_texture.GetResource(), "Post Processing Input Texture");
+    return nullptr;
   }
+  D3D12::SetObjectNameFormatted(target->texture.GetResource(), "Post Processing Target %u",
+                                static_cast<u32>(m_post_processing_targets.size()));
+
+  target->last_used = m_post_processing_target_counter;
+  m_post_processing_targets.push_back(std::move(target));
+  return &m_post_processing_targets.back()->texture;
+}
+
+void D3D12HostDisplay::DestroyPostProcessingTargets()
+{
+  m_post_processing_input_texture = nullptr;
+  for (PostProcessingStage& pps : m_post_processing_stages)
+    pps.output_texture = nullptr;
+  m_post_processing_targets.clear();
+  m_post_processing_chain.InvalidateIntermediateCache();
+}
 
+bool D3D12HostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height,
+                                                        const Common::Rectangle<s32>& final_rect)
+{
+  DebugAssert(!m_post_processing_stages.empty());
+
+  m_post_processing_target_counter++;
+  m_post_processing_input_texture = GetPostProcessingTarget(target_width, target_height, nullptr);
+  if (!m_post_processing_input_texture)
+    return false;
+
+  const D3D12::Texture* input = m_post_processing_input_texture;
   const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
   for (u32 i = 0; i < target_count; i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
-    {
-      if (!pps.output_texture.Create(target_width, target_height, 1, 1, 1, tex_format, srv_format, rtv_format,
-                                     DXGI_FORMAT_UNKNOWN, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET))
-      {
-        return false;
-      }
-      D3D12::SetObjectNameFormatted(pps.output_texture.GetResource(), "Post Processing Output Texture %u", i);
-    }
+    u32 width = target_width;
+    u32 height = target_height;
+    pps.output_rect = m_post_processing_chain.GetShaderStage(i).GetScaledOutputRect(final_rect, &width, &height);
+    pps.output_texture = GetPostProcessingTarget(width, height, input);
+    if (!pps.output_texture)
+      return false;
+
+    input = pps.output_texture;
   }
 
+  // release anything which hasn't been needed for a while, e.g. from a screenshot
+  m_post_processing_targets.erase(
+    std::remove_if(m_post_processing_targets.begin(), m_post_processing_targets.end(),
+                   [this](const std::unique_ptr<PostProcessingTarget>& target) {
+                     return ((m_post_processing_target_counter - target->last_used) >
+                             FrontendCommon::PostProcessingChain::TARGET_POOL_LIFETIME);
+                   }),
+    m_post_processing_targets.end());
+
   return true;
 }
 
@@ -969,38 +1027,44 @@ void D3D12HostDisplay::ApplyPostProcessingChain(ID3D12GraphicsCommandList* cmdli
                                                 s32 texture_view_width, s32 texture_view_height, u32 target_width,
                                                 u32 target_height)
 {
-  if (!CheckPostProcessingRenderTargets(target_width, target_height))
+  // intermediate stages only need to be re-run when the input or target changes, e.g. not while paused
+  const Common::Rectangle<s32> final_rect =
+    Common::Rectangle<s32>::FromExtents(final_left, final_top, final_width, final_height);
+  const bool use_cached_stages =
+    m_post_processing_chain.UpdateIntermediateCache(m_display_changed, target_width, target_height, final_rect);
+  m_display_changed = false;
+
+  if (!use_cached_stages)
   {
-    final_target->TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
-    cmdlist->ClearRenderTargetView(final_target->GetRTVOrDSVDescriptor(), s_clear_color.data(), 0, nullptr);
-    cmdlist->OMSetRenderTargets(1, &final_target->GetRTVOrDSVDescriptor().cpu_handle, FALSE, nullptr);
+    if (!CheckPostProcessingRenderTargets(target_width, target_height, final_rect))
+    {
+      m_post_processing_chain.InvalidateIntermediateCache();
+      final_target->TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
+      cmdlist->ClearRenderTargetView(final_target->GetRTVOrDSVDescriptor(), s_clear_color.data(), 0, nullptr);
+      cmdlist->OMSetRenderTargets(1, &final_target->GetRTVOrDSVDescriptor().cpu_handle, FALSE, nullptr);
+
+      RenderDisplay(cmdlist, final_left, final_top, final_width, final_height, texture, texture_view_x,
+                    texture_view_y, texture_view_width, texture_view_height, IsUsingLinearFiltering());
+      return;
+    }
 
+    m_post_processing_input_texture->TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
+    cmdlist->ClearRenderTargetView(m_post_processing_input_texture->GetRTVOrDSVDescriptor(), s_clear_color.data(), 0,
+                                   nullptr);
+    cmdlist->OMSetRenderTargets(1, &m_post_processing_input_texture->GetRTVOrDSVDescriptor().cpu_handle, FALSE,
+                                nullptr);
     RenderDisplay(cmdlist, final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
                   texture_view_width, texture_view_height, IsUsingLinearFiltering());
-    return;
+    m_post_processing_input_texture->TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
   }
 
-  // downsample/upsample - use same viewport for remainder
-  m_post_processing_input_texture.TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
-  cmdlist->ClearRenderTargetView(m_post_processing_input_texture.GetRTVOrDSVDescriptor(), s_clear_color.data(), 0,
-                                 nullptr);
-  cmdlist->OMSetRenderTargets(1, &m_post_processing_input_texture.GetRTVOrDSVDescriptor().cpu_handle, FALSE, nullptr);
-  RenderDisplay(cmdlist, final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
-                texture_view_width, texture_view_height, IsUsingLinearFiltering());
-  m_post_processing_input_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-
-  const s32 orig_texture_width = texture_view_width;
-  const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
-  texture_view_x = final_left;
-  texture_view_y = final_top;
-  texture_view_width = final_width;
-  texture_view_height = final_height;
-
   const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  for (u32 i = use_cached_stages ? final_stage : 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
+    const D3D12::Texture* input =
+      (i == 0) ? m_post_processing_input_texture : m_post_processing_stages[i - 1].output_texture;
+    const Common::Rectangle<s32>& input_rect = (i == 0) ? final_rect : m_post_processing_stages[i - 1].output_rect;
 
     const bool use_push_constants = m_post_processing_chain.GetShaderStage(i).UsePushConstants();
     if (use_push_constants)
@@ -1008,8 +1072,8 @@ void D3D12HostDisplay::ApplyPostProcessingChain(ID3D12GraphicsCommandList* cmdli
       u8 buffer[FrontendCommon::PostProcessingShader::PUSH_CONSTANT_SIZE_THRESHOLD];
       Assert(pps.uniforms_size <= sizeof(buffer));
       m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        buffer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
-        texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
+        buffer, input->GetWidth(), input->GetHeight(), input_rect.left, input_rect.top, input_rect.GetWidth(),
+        input_rect.GetHeight(), GetWindowWidth(), GetWindowHeight(), texture_view_width, texture_view_height,
         static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
 
       cmdlist->SetGraphicsRootSignature(m_post_processing_root_signature.Get());
@@ -1024,31 +1088,31 @@ void D3D12HostDisplay::ApplyPostProcessingChain(ID3D12GraphicsCommandList* cmdli
 
       const u32 offset = m_post_processing_cbuffer.GetCurrentOffset();
       m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        m_post_processing_cbuffer.GetCurrentHostPointer(), texture->GetWidth(), texture->GetHeight(), texture_view_x,
-        texture_view_y, texture_view_width, texture_view_height, GetWindowWidth(), GetWindowHeight(),
-        orig_texture_width, orig_texture_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
+        m_post_processing_cbuffer.GetCurrentHostPointer(), input->GetWidth(), input->GetHeight(), input_rect.left,
+        input_rect.top, input_rect.GetWidth(), input_rect.GetHeight(), GetWindowWidth(), GetWindowHeight(),
+        texture_view_width, texture_view_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
       m_post_processing_cbuffer.CommitMemory(pps.uniforms_size);
 
       cmdlist->SetGraphicsRootSignature(m_post_processing_cb_root_signature.Get());
       cmdlist->SetGraphicsRootConstantBufferView(0, m_post_processing_cbuffer.GetGPUPointer() + offset);
     }
 
-    D3D12::Texture* rt = (i != final_stage) ? &pps.output_texture : final_target;
+    D3D12::Texture* rt = (i != final_stage) ? pps.output_texture : final_target;
+    const Common::Rectangle<s32>& output_rect = (i != final_stage) ? pps.output_rect : final_rect;
     rt->TransitionToState(D3D12_RESOURCE_STATE_RENDER_TARGET);
     cmdlist->ClearRenderTargetView(rt->GetRTVOrDSVDescriptor(), s_clear_color.data(), 0, nullptr);
     cmdlist->OMSetRenderTargets(1, &rt->GetRTVOrDSVDescriptor().cpu_handle, FALSE, nullptr);
+    D3D12::SetViewportAndScissor(cmdlist, output_rect.left, output_rect.top, output_rect.GetWidth(),
+                                 output_rect.GetHeight());
 
     cmdlist->SetPipelineState(pps.pipeline.Get());
-    cmdlist->SetGraphicsRootDescriptorTable(1, texture->GetSRVDescriptor());
+    cmdlist->SetGraphicsRootDescriptorTable(1, input->GetSRVDescriptor());
     cmdlist->SetGraphicsRootDescriptorTable(2, m_border_sampler);
 
     cmdlist->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     cmdlist->DrawInstanced(3, 1, 0, 0);
 
     if (i != final_stage)
-    {
-      pps.output_texture.TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
-      texture = &pps.output_texture;
-    }
+      pps.output_texture->TransitionToState(D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
   }
 }
@@ -7,6 +7,7 @@
 #include "common/window_info.h"
 #include "common/windows_headers.h"
 #include "core/host_display.h"
+#include "dxgi_present_thread.h"
 #include "postprocessing_chain.h"
 #include <d3d12.h>
 #include <dxgi.h>
@@ -74,15 +75,18 @@ public:
 protected:
   struct PostProcessingStage
   {
-    PostProcessingStage() = default;
-    PostProcessingStage(PostProcessingStage&& move);
-    ~PostProcessingStage();
-
     ComPtr<ID3D12PipelineState> pipeline;
-    D3D12::Texture output_texture;
+    D3D12::Texture* output_texture = nullptr;
+    Common::Rectangle<s32> output_rect;
     u32 uniforms_size = 0;
   };
 
+  struct PostProcessingTarget
+  {
+    D3D12::Texture texture;
+    u32 last_used = 0;
+  };
+
   static AdapterAndModeList GetAdapterAndModeList(IDXGIFactory* dxgi_factory);
 
   virtual bool CreateResources() override;
@@ -106,7 +110,9 @@ protected:
   void RenderSoftwareCursor(ID3D12GraphicsCommandList* cmdlist, s32 left, s32 top, s32 width, s32 height,
                             GPUTexture* texture_handle);
 
-  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
+  D3D12::Texture* GetPostProcessingTarget(u32 width, u32 height, const D3D12::Texture* input);
+  void DestroyPostProcessingTargets();
+  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height, const Common::Rectangle<s32>& final_rect);
   void ApplyPostProcessingChain(ID3D12GraphicsCommandList* cmdlist, D3D12::Texture* final_target, s32 final_left,
                                 s32 final_top, s32 final_width, s32 final_height, D3D12::Texture* texture,
                                 s32 texture_view_x, s32 texture_view_y, s32 texture_view_width, s32 texture_view_height,
@@ -131,11 +137,15 @@ protected:
   ComPtr<ID3D12RootSignature> m_post_processing_cb_root_signature;
   FrontendCommon::PostProcessingChain m_post_processing_chain;
   D3D12::StreamBuffer m_post_processing_cbuffer;
-  D3D12::Texture m_post_processing_input_texture;
+  D3D12::Texture* m_post_processing_input_texture = nullptr;
   std::vector<PostProcessingStage> m_post_processing_stages;
+  std::vector<std::unique_ptr<PostProcessingTarget>> m_post_processing_targets;
+  u32 m_post_processing_target_counter = 0;
   Common::Timer m_post_processing_timer;
 
   bool m_allow_tearing_supported = false;
   bool m_using_allow_tearing = false;
   bool m_vsync = true;
+
+  DXGIPresentThread m_present_thread;
 };
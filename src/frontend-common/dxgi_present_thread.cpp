@@ -0,0 +1,83 @@
+#include "dxgi_present_thread.h"
+#include "common/assert.h"
+#include "common/log.h"
+Log_SetChannel(DXGIPresentThread);
+
+DXGIPresentThread::DXGIPresentThread() = default;
+
+DXGIPresentThread::~DXGIPresentThread()
+{
+  Stop();
+}
+
+void DXGIPresentThread::Start()
+{
+  Assert(!m_thread.Joinable());
+  m_shutdown = false;
+  m_thread.Start([this]() { ThreadEntryPoint(); });
+}
+
+void DXGIPresentThread::Stop()
+{
+  if (!m_thread.Joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    WaitForPresentComplete(lock);
+    m_shutdown = true;
+    m_present_queued_cv.notify_one();
+  }
+
+  m_thread.Join();
+}
+
+void DXGIPresentThread::QueuePresent(IDXGISwapChain* swap_chain, UINT sync_interval, UINT flags)
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  WaitForPresentComplete(lock);
+
+  m_queued_swap_chain = swap_chain;
+  m_queued_sync_interval = sync_interval;
+  m_queued_flags = flags;
+  m_present_pending = true;
+  m_present_queued_cv.notify_one();
+}
+
+void DXGIPresentThread::WaitForPresentComplete()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  WaitForPresentComplete(lock);
+}
+
+void DXGIPresentThread::WaitForPresentComplete(std::unique_lock<std::mutex>& lock)
+{
+  m_present_done_cv.wait(lock, [this]() { return !m_present_pending; });
+}
+
+void DXGIPresentThread::ThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("DXGI Present Thread");
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;)
+  {
+    m_present_queued_cv.wait(lock, [this]() { return m_present_pending || m_shutdown; });
+    if (!m_present_pending)
+      break;
+
+    IDXGISwapChain* const swap_chain = m_queued_swap_chain;
+    const UINT sync_interval = m_queued_sync_interval;
+    const UINT flags = m_queued_flags;
+    lock.unlock();
+
+    const HRESULT hr = swap_chain->Present(sync_interval, flags);
+    if (FAILED(hr))
+      Log_ErrorPrintf("Present() failed: 0x%08X", hr);
+
+    lock.lock();
+    m_queued_swap_chain = nullptr;
+    m_present_pending = false;
+    m_present_done_cv.notify_all();
+  }
+}
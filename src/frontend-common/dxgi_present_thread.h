@@ -0,0 +1,42 @@
+#pragma once
+#include "common/threading.h"
+#include "common/types.h"
+#include "common/windows_headers.h"
+#include <condition_variable>
+#include <dxgi.h>
+#include <mutex>
+
+/// Calls IDXGISwapChain::Present() on a worker thread, so the caller can get on with the next frame
+/// while the present blocks waiting for vsync. Only one present is in flight at a time.
+class DXGIPresentThread
+{
+public:
+  DXGIPresentThread();
+  ~DXGIPresentThread();
+
+  ALWAYS_INLINE bool IsRunning() const { return m_thread.Joinable(); }
+
+  void Start();
+  void Stop();
+
+  /// Waits for the previous present, then queues this one. The swap chain must stay alive until it completes.
+  void QueuePresent(IDXGISwapChain* swap_chain, UINT sync_interval, UINT flags);
+
+  /// Blocks until any queued present has completed. Call before resizing or releasing the swap chain.
+  void WaitForPresentComplete();
+
+private:
+  void ThreadEntryPoint();
+  void WaitForPresentComplete(std::unique_lock<std::mutex>& lock);
+
+  Threading::Thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_present_queued_cv;
+  std::condition_variable m_present_done_cv;
+
+  IDXGISwapChain* m_queued_swap_chain = nullptr;
+  UINT m_queued_sync_interval = 0;
+  UINT m_queued_flags = 0;
+  bool m_present_pending = false;
+  bool m_shutdown = false;
+};
@@ -2,6 +2,7 @@
 
 #include "fullscreen_ui.h"
 #include "IconsFontAwesome5.h"
+#include "common/align.h"
 #include "common/byte_stream.h"
 #include "common/file_system.h"
 #include "common/log.h"
@@ -96,6 +97,7 @@ using ImGuiFullscreen::EnumChoiceButton;
 using ImGuiFullscreen::FloatingButton;
 using ImGuiFullscreen::GetCachedTexture;
 using ImGuiFullscreen::GetCachedTextureAsync;
+using ImGuiFullscreen::GetCachedThumbnailAsync;
 using ImGuiFullscreen::GetPlaceholderTexture;
 using ImGuiFullscreen::LayoutScale;
 using ImGuiFullscreen::LoadTexture;
@@ -2629,6 +2631,9 @@ void FullscreenUI::DrawInterfaceSettingsPage()
                     "Main", "ApplyGameSettings", true);
   DrawToggleSetting(bsi, ICON_FA_FROWN " Automatically Load Cheats",
                     "Automatically loads and applies cheats on game start.", "Main", "AutoLoadCheats", true);
+  DrawToggleSetting(bsi, ICON_FA_STOPWATCH " Auto-Tune Per-Game Performance",
+                    "Lowers the resolution scale on later launches if a game did not hold full speed.", "Main",
+                    "AutoTunePerformance", false);
   if (DrawToggleSetting(bsi, ICON_FA_PAINT_BRUSH " Use Light Theme",
                         "Uses a light coloured theme instead of the default dark theme.", "Main",
                         "UseLightFullscreenUITheme", false))
@@ -2736,6 +2741,10 @@ void FullscreenUI::DrawBIOSSettingsPage()
 
   DrawToggleSetting(bsi, "Enable Fast Boot", "Patches the BIOS to skip the boot animation. Safe to enable.", "BIOS",
                     "PatchFastBoot", Settings::DEFAULT_FAST_BOOT_VALUE);
+  DrawToggleSetting(bsi, "Cache Boot Snapshot",
+                    "Saves the console state when fast boot reaches the shell, and restores it on later boots with the "
+                    "same BIOS and region instead of running the BIOS startup again.",
+                    "BIOS", "BootSnapshot", false);
   DrawToggleSetting(bsi, "Enable TTY Output",
                     "Patches the BIOS to log calls to printf(). Only use when debugging, can break games.", "BIOS",
                     "PatchTTYEnable", false);
@@ -2746,8 +2755,9 @@ void FullscreenUI::DrawBIOSSettingsPage()
 void FullscreenUI::DrawConsoleSettingsPage()
 {
   static constexpr auto cdrom_read_speeds =
-    make_array("None (Double Speed)", "2x (Quad Speed)", "3x (6x Speed)", "4x (8x Speed)", "5x (10x Speed)",
-               "6x (12x Speed)", "7x (14x Speed)", "8x (16x Speed)", "9x (18x Speed)", "10x (20x Speed)");
+    make_array("Automatic (Loading Only)", "None (Double Speed)", "2x (Quad Speed)", "3x (6x Speed)", "4x (8x Speed)",
+               "5x (10x Speed)", "6x (12x Speed)", "7x (14x Speed)", "8x (16x Speed)", "9x (18x Speed)",
+               "10x (20x Speed)");
 
   static constexpr auto cdrom_seek_speeds =
     make_array("Infinite/Instantaneous", "None (Normal Speed)", "2x", "3x", "4x", "5x", "6x", "7x", "8x", "9x", "10x");
@@ -2801,7 +2811,7 @@ void FullscreenUI::DrawConsoleSettingsPage()
   DrawIntListSetting(
     bsi, "Read Speedup",
     "Speeds up CD-ROM reads by the specified factor. May improve loading speeds in some games, and break others.",
-    "CDROM", "ReadSpeedup", 1, cdrom_read_speeds.data(), cdrom_read_speeds.size(), 1);
+    "CDROM", "ReadSpeedup", 1, cdrom_read_speeds.data(), cdrom_read_speeds.size());
   DrawIntListSetting(
     bsi, "Seek Speedup",
     "Speeds up CD-ROM seeks by the specified factor. May improve loading speeds in some games, and break others.",
@@ -3605,6 +3615,17 @@ void FullscreenUI::DrawDisplaySettingsPage()
       DrawToggleSetting(bsi, "Use Blit Swap Chain",
                         "Uses a blit presentation model instead of flipping. This may be needed on some systems.",
                         "Display", "UseBlitSwapChain", false);
+      DrawToggleSetting(bsi, "Threaded Presentation",
+                        "Presents frames on a background thread, so the next frame can start while waiting for vsync.",
+                        "GPU", "ThreadedPresentation", true);
+    }
+    break;
+
+    case GPURenderer::HardwareD3D12:
+    {
+      DrawToggleSetting(bsi, "Threaded Presentation",
+                        "Presents frames on a background thread, so the next frame can start while waiting for vsync.",
+                        "GPU", "ThreadedPresentation", true);
     }
     break;
 #endif
@@ -3653,6 +3674,16 @@ void FullscreenUI::DrawDisplaySettingsPage()
     "Ensures every frame generated is displayed for optimal pacing. Disable if you are having speed or sound issues.",
     "Display", "DisplayAllFrames", false);
 
+  DrawToggleSetting(bsi, "Variable Refresh Rate Pacing",
+                    "Presents each frame as soon as it is due without waiting for VSync, for displays which support "
+                    "G-Sync/FreeSync. Runs at the console's exact refresh rate.",
+                    "Display", "VRRFramePacing", false);
+
+  DrawToggleSetting(bsi, "Skip Duplicate Frames",
+                    "Leaves the last frame on screen instead of presenting identical frames, e.g. in 30 FPS games. "
+                    "Saves GPU power on battery powered devices.",
+                    "Display", "SkipDuplicateFrames", false);
+
   MenuHeading("Rendering");
 
   DrawIntListSetting(
@@ -3775,6 +3806,9 @@ void FullscreenUI::DrawDisplaySettingsPage()
   DrawToggleSetting(bsi, "Preload Replacement Textures",
                     "Loads all replacement texture to RAM, reducing stuttering at runtime.", "TextureReplacements",
                     "PreloadTextures", false);
+  DrawToggleSetting(bsi, "Load Replacement Textures In Background",
+                    "Decodes replacement textures on worker threads. Original textures are shown until loaded.",
+                    "TextureReplacements", "AsyncLoading", false);
 
   EndMenuButtons();
 }
@@ -6067,7 +6101,10 @@ GPUTexture* FullscreenUI::GetGameListCover(const GameList::Entry* entry)
     cover_it = s_cover_image_map.emplace(entry->path, std::move(cover_path)).first;
   }
 
-  GPUTexture* tex = (!cover_it->second.empty()) ? GetCachedTextureAsync(cover_it->second.c_str()) : nullptr;
+  // covers are drawn at most 350x350 layout units in both the list and grid, so load a copy at that size
+  // (rounded up to avoid regenerating thumbnails on every small window resize) rather than the full image
+  const u32 thumbnail_size = Common::AlignUpPow2(static_cast<u32>(std::ceil(LayoutScale(350.0f))), 64);
+  GPUTexture* tex = (!cover_it->second.empty()) ? GetCachedThumbnailAsync(cover_it->second, thumbnail_size) : nullptr;
   return tex ? tex : GetTextureForGameListEntryType(entry->type);
 }
 
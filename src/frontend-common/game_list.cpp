@@ -1,14 +1,15 @@
 #include "game_list.h"
 #include "common/assert.h"
-#include "common/byte_stream.h"
 #include "common/file_system.h"
 #include "common/heterogeneous_containers.h"
 #include "common/http_downloader.h"
 #include "common/log.h"
 #include "common/make_array.h"
+#include "common/mapped_cache.h"
 #include "common/path.h"
 #include "common/progress_callback.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "core/bios.h"
 #include "core/host.h"
 #include "core/host_settings.h"
@@ -18,7 +19,9 @@
 #include "util/cd_image.h"
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cctype>
+#include <cstring>
 #include <ctime>
 #include <string_view>
 #include <tinyxml2.h>
@@ -34,7 +37,7 @@ namespace GameList {
 enum : u32
 {
   GAME_LIST_CACHE_SIGNATURE = 0x45434C47,
-  GAME_LIST_CACHE_VERSION = 32,
+  GAME_LIST_CACHE_VERSION = 33,
 
   PLAYED_TIME_SERIAL_LENGTH = 32,
   PLAYED_TIME_LAST_TIME_LENGTH = 20,  // uint64
@@ -49,7 +52,43 @@ struct PlayedTimeEntry
   std::time_t total_played_time;
 };
 
-using CacheMap = UnorderedStringMap<Entry>;
+// The cache file is a MappedCache with a hash table of record indices keyed by path, so entries are only decoded when
+// a scanned file is looked up.
+struct CacheHeader
+{
+  u32 signature;
+  u32 version;
+  u32 num_records;
+  u32 num_buckets;
+  u32 string_pool_size;
+  u32 reserved;
+};
+
+struct CacheRecord
+{
+  u64 path_hash;
+  u64 total_size;
+  s64 last_modified_time;
+  u64 release_date;
+  MappedCache::String path;
+  MappedCache::String serial;
+  MappedCache::String title;
+  MappedCache::String genre;
+  MappedCache::String publisher;
+  MappedCache::String developer;
+  u32 supported_controllers;
+  u8 type;
+  u8 region;
+  u8 min_players;
+  u8 max_players;
+  u8 min_blocks;
+  u8 max_blocks;
+  u8 compatibility;
+  u8 reserved0;
+  u32 reserved1;
+};
+static_assert(sizeof(CacheHeader) == 24 && sizeof(CacheRecord) == 96, "Cache structures are packed");
+
 using PlayedTimeMap = UnorderedStringMap<PlayedTimeEntry>;
 
 static bool GetExeListEntry(const std::string& path, Entry* entry);
@@ -59,17 +98,23 @@ static bool GetDiscListEntry(const std::string& path, Entry* entry);
 static bool GetGameListEntryFromCache(const std::string& path, Entry* entry);
 static void ScanDirectory(const char* path, bool recursive, bool only_cache,
                           const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                          ProgressCallback* progress);
+                          u32 num_threads, ProgressCallback* progress);
 static bool AddFileFromCache(const std::string& path, std::time_t timestamp, const PlayedTimeMap& played_time_map);
 static bool ScanFile(std::string path, std::time_t timestamp, std::unique_lock<std::recursive_mutex>& lock,
                      const PlayedTimeMap& played_time_map);
+static void ScanFilesInParallel(std::vector<FILESYSTEM_FIND_DATA*>& files, u32 num_threads,
+                                const PlayedTimeMap& played_time_map, ProgressCallback* progress, u32 progress_base);
+static void FinishScannedEntry(Entry* entry, std::string path, std::time_t timestamp,
+                               const PlayedTimeMap& played_time_map);
+static u32 GetScanThreadCount();
 
 static std::string GetCacheFilename();
 static void LoadCache();
-static bool LoadEntriesFromCache(ByteStream* stream);
-static bool OpenCacheForWriting();
-static bool WriteEntryToCache(const Entry* entry);
-static void CloseCacheFileStream();
+static const CacheRecord* GetCacheRecords();
+static std::string_view GetCacheString(const MappedCache::String& str);
+static bool ReadCacheRecord(const CacheRecord& record, Entry* entry);
+static bool WriteCache();
+static void CloseCache();
 static void DeleteCacheFile();
 
 static std::string GetPlayedTimeFile();
@@ -82,8 +127,9 @@ static PlayedTimeEntry UpdatePlayedTimeFile(const std::string& path, const std::
 
 static std::vector<GameList::Entry> s_entries;
 static std::recursive_mutex s_mutex;
-static GameList::CacheMap s_cache_map;
-static std::unique_ptr<ByteStream> s_cache_write_stream;
+static FileSystem::MappedFile s_cache_file;
+static std::vector<bool> s_cache_record_used;
+static bool s_cache_dirty = false;
 
 static bool m_game_list_loaded = false;
 
@@ -201,8 +247,12 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
   entry->type = EntryType::Disc;
   entry->compatibility = GameDatabase::CompatibilityRating::Unknown;
 
+  // SYSTEM.CNF and the executable are only read once, for both the database lookup and the fallbacks
+  System::ImageIdentification ident;
+  System::IdentifyImage(cdi.get(), &ident, false);
+
   // try the database first
-  const GameDatabase::Entry* dentry = GameDatabase::GetEntryForDisc(cdi.get());
+  const GameDatabase::Entry* dentry = GameDatabase::GetEntryForIdentification(ident);
   if (dentry)
   {
     // pull from database
@@ -224,7 +274,7 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
     const std::string display_name(FileSystem::GetDisplayNameFromPath(path));
 
     // no game code, so use the filename title
-    entry->serial = System::GetGameIdFromImage(cdi.get(), true);
+    entry->serial = ident.serial.empty() ? std::move(ident.hash_id) : std::move(ident.serial);
     entry->title = Path::GetFileTitle(display_name);
     entry->compatibility = GameDatabase::CompatibilityRating::Unknown;
     entry->release_date = 0;
@@ -236,7 +286,7 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
   }
 
   // region detection
-  entry->region = System::GetRegionFromSystemArea(cdi.get());
+  entry->region = ident.system_area_region;
   if (entry->region == DiscRegion::Other)
     entry->region = System::GetRegionForSerial(entry->serial);
 
@@ -276,85 +326,71 @@ bool GameList::PopulateEntryFromPath(const std::string& path, Entry* entry)
 
 bool GameList::GetGameListEntryFromCache(const std::string& path, Entry* entry)
 {
-  auto iter = UnorderedStringMapFind(s_cache_map, path);
-  if (iter == s_cache_map.end())
+  if (!s_cache_file.IsValid())
     return false;
 
-  *entry = std::move(iter->second);
-  s_cache_map.erase(iter);
-  return true;
-}
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(s_cache_file.GetData());
+  const u32* buckets = MappedCache::GetBuckets(s_cache_file, sizeof(CacheHeader));
+  const CacheRecord* records = GetCacheRecords();
+  const u64 hash = MappedCache::HashKey(path);
+  const u32 record_index =
+    MappedCache::Find(buckets, header->num_buckets, header->num_records, hash, [records, hash, &path](u32 index) {
+      return (records[index].path_hash == hash && GetCacheString(records[index].path) == path);
+    });
+
+  // each record is only handed out once, and anything left over is carried over when the cache is rewritten
+  if (record_index == MappedCache::EMPTY_BUCKET || s_cache_record_used[record_index])
+    return false;
 
-bool GameList::LoadEntriesFromCache(ByteStream* stream)
-{
-  u32 file_signature, file_version;
-  if (!stream->ReadU32(&file_signature) || !stream->ReadU32(&file_version) ||
-      file_signature != GAME_LIST_CACHE_SIGNATURE || file_version != GAME_LIST_CACHE_VERSION)
+  s_cache_record_used[record_index] = true;
+  if (!ReadCacheRecord(records[record_index], entry))
   {
-    Log_WarningPrintf("Game list cache is corrupted");
+    Log_WarningPrintf("Game list cache entry for '%s' is corrupted", path.c_str());
     return false;
   }
 
-  while (stream->GetPosition() != stream->GetSize())
-  {
-    std::string path;
-    Entry ge;
-
-    u8 type;
-    u8 region;
-    u8 compatibility_rating;
-
-    if (!stream->ReadU8(&type) || !stream->ReadU8(&region) || !stream->ReadSizePrefixedString(&path) ||
-        !stream->ReadSizePrefixedString(&ge.serial) || !stream->ReadSizePrefixedString(&ge.title) ||
-        !stream->ReadSizePrefixedString(&ge.genre) || !stream->ReadSizePrefixedString(&ge.publisher) ||
-        !stream->ReadSizePrefixedString(&ge.developer) || !stream->ReadU64(&ge.total_size) ||
-        !stream->ReadU64(reinterpret_cast<u64*>(&ge.last_modified_time)) || !stream->ReadU64(&ge.release_date) ||
-        !stream->ReadU32(&ge.supported_controllers) || !stream->ReadU8(&ge.min_players) ||
-        !stream->ReadU8(&ge.max_players) || !stream->ReadU8(&ge.min_blocks) || !stream->ReadU8(&ge.max_blocks) ||
-        !stream->ReadU8(&compatibility_rating) || region >= static_cast<u8>(DiscRegion::Count) ||
-        type >= static_cast<u8>(EntryType::Count) ||
-        compatibility_rating >= static_cast<u8>(GameDatabase::CompatibilityRating::Count))
-    {
-      Log_WarningPrintf("Game list cache entry is corrupted");
-      return false;
-    }
-
-    ge.path = path;
-    ge.region = static_cast<DiscRegion>(region);
-    ge.type = static_cast<EntryType>(type);
-    ge.compatibility = static_cast<GameDatabase::CompatibilityRating>(compatibility_rating);
+  return true;
+}
 
-    auto iter = UnorderedStringMapFind(s_cache_map, ge.path);
-    if (iter != s_cache_map.end())
-      iter->second = std::move(ge);
-    else
-      s_cache_map.emplace(std::move(path), std::move(ge));
-  }
+const GameList::CacheRecord* GameList::GetCacheRecords()
+{
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(s_cache_file.GetData());
+  return reinterpret_cast<const CacheRecord*>(
+    MappedCache::GetRecords(s_cache_file, sizeof(CacheHeader), header->num_buckets));
+}
 
-  return true;
+std::string_view GameList::GetCacheString(const MappedCache::String& str)
+{
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(s_cache_file.GetData());
+  return MappedCache::GetString(s_cache_file, header->string_pool_size, str);
 }
 
-bool GameList::WriteEntryToCache(const Entry* entry)
+bool GameList::ReadCacheRecord(const CacheRecord& record, Entry* entry)
 {
-  bool result = true;
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->type));
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->region));
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->path);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->serial);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->title);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->genre);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->publisher);
-  result &= s_cache_write_stream->WriteSizePrefixedString(entry->developer);
-  result &= s_cache_write_stream->WriteU64(entry->total_size);
-  result &= s_cache_write_stream->WriteU64(entry->last_modified_time);
-  result &= s_cache_write_stream->WriteU64(entry->release_date);
-  result &= s_cache_write_stream->WriteU32(entry->supported_controllers);
-  result &= s_cache_write_stream->WriteU8(entry->min_players);
-  result &= s_cache_write_stream->WriteU8(entry->max_players);
-  result &= s_cache_write_stream->WriteU8(entry->min_blocks);
-  result &= s_cache_write_stream->WriteU8(entry->max_blocks);
-  result &= s_cache_write_stream->WriteU8(static_cast<u8>(entry->compatibility));
-  return result;
+  if (record.region >= static_cast<u8>(DiscRegion::Count) || record.type >= static_cast<u8>(EntryType::Count) ||
+      record.compatibility >= static_cast<u8>(GameDatabase::CompatibilityRating::Count))
+  {
+    return false;
+  }
+
+  entry->type = static_cast<EntryType>(record.type);
+  entry->region = static_cast<DiscRegion>(record.region);
+  entry->path = GetCacheString(record.path);
+  entry->serial = GetCacheString(record.serial);
+  entry->title = GetCacheString(record.title);
+  entry->genre = GetCacheString(record.genre);
+  entry->publisher = GetCacheString(record.publisher);
+  entry->developer = GetCacheString(record.developer);
+  entry->total_size = record.total_size;
+  entry->last_modified_time = static_cast<std::time_t>(record.last_modified_time);
+  entry->release_date = record.release_date;
+  entry->supported_controllers = record.supported_controllers;
+  entry->min_players = record.min_players;
+  entry->max_players = record.max_players;
+  entry->min_blocks = record.min_blocks;
+  entry->max_blocks = record.max_blocks;
+  entry->compatibility = static_cast<GameDatabase::CompatibilityRating>(record.compatibility);
+  return true;
 }
 
 static std::string GameList::GetCacheFilename()
@@ -364,75 +400,134 @@ static std::string GameList::GetCacheFilename()
 
 void GameList::LoadCache()
 {
-  std::string filename(GetCacheFilename());
-  std::unique_ptr<ByteStream> stream =
-    ByteStream::OpenFile(filename.c_str(), BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_STREAMED);
-  if (!stream)
+  CloseCache();
+
+  const std::string filename(GetCacheFilename());
+  std::FILE* fp = FileSystem::OpenCFile(filename.c_str(), "rb");
+  if (!fp)
     return;
 
-  if (!LoadEntriesFromCache(stream.get()))
+  const bool mapped = s_cache_file.Map(fp);
+  std::fclose(fp);
+  if (!mapped)
+    return;
+
+  const CacheHeader* header = reinterpret_cast<const CacheHeader*>(s_cache_file.GetData());
+  if (!MappedCache::CheckHeader(s_cache_file, sizeof(CacheHeader), GAME_LIST_CACHE_SIGNATURE,
+                                GAME_LIST_CACHE_VERSION) ||
+      !MappedCache::IsValidLayout(s_cache_file, sizeof(CacheHeader), header->num_buckets, header->num_records,
+                                  sizeof(CacheRecord) * static_cast<u64>(header->num_records),
+                                  header->string_pool_size))
   {
     Log_WarningPrintf("Deleting corrupted cache file '%s'", filename.c_str());
-    stream.reset();
-    s_cache_map.clear();
+    s_cache_file.Unmap();
     DeleteCacheFile();
     return;
   }
+
+  s_cache_record_used.assign(header->num_records, false);
+  Log_DevPrintf("Mapped game list cache with %u entries", header->num_records);
 }
 
-bool GameList::OpenCacheForWriting()
+bool GameList::WriteCache()
 {
-  const std::string cache_filename(GetCacheFilename());
-  Assert(!s_cache_write_stream);
-
-  s_cache_write_stream = ByteStream::OpenFile(cache_filename.c_str(),
-                                              BYTESTREAM_OPEN_READ | BYTESTREAM_OPEN_WRITE | BYTESTREAM_OPEN_SEEKABLE);
-  if (s_cache_write_stream)
+  // keep entries for files we didn't see this time, e.g. from a directory which is temporarily unavailable
+  std::vector<Entry> unused_entries;
+  if (s_cache_file.IsValid())
   {
-    // check the header
-    u32 signature, version;
-    if (s_cache_write_stream->ReadU32(&signature) && signature == GAME_LIST_CACHE_SIGNATURE &&
-        s_cache_write_stream->ReadU32(&version) && version == GAME_LIST_CACHE_VERSION &&
-        s_cache_write_stream->SeekToEnd())
+    const CacheRecord* records = GetCacheRecords();
+    for (size_t i = 0; i < s_cache_record_used.size(); i++)
     {
-      return true;
+      if (!s_cache_record_used[i] && !ReadCacheRecord(records[i], &unused_entries.emplace_back()))
+        unused_entries.pop_back();
     }
+  }
+
+  std::vector<const Entry*> entries;
+  entries.reserve(s_entries.size() + unused_entries.size());
+  for (const Entry& entry : s_entries)
+    entries.push_back(&entry);
+  for (const Entry& entry : unused_entries)
+    entries.push_back(&entry);
 
-    s_cache_write_stream.reset();
+  const u32 num_buckets = MappedCache::GetBucketCount(entries.size());
+  std::vector<u32> buckets(num_buckets, MappedCache::EMPTY_BUCKET);
+  std::vector<CacheRecord> records;
+  MappedCache::StringPool string_pool;
+  records.reserve(entries.size());
+
+  for (const Entry* entry : entries)
+  {
+    const u64 hash = MappedCache::HashKey(entry->path);
+    const u32 bucket =
+      MappedCache::FindFreeBucket(buckets.data(), num_buckets, hash, [&records, &string_pool, hash, entry](u32 index) {
+        return (records[index].path_hash == hash && string_pool.Get(records[index].path) == entry->path);
+      });
+    if (bucket == MappedCache::EMPTY_BUCKET)
+      continue;
+
+    CacheRecord& record = records.emplace_back();
+    std::memset(&record, 0, sizeof(record));
+    record.path_hash = hash;
+    record.total_size = entry->total_size;
+    record.last_modified_time = static_cast<s64>(entry->last_modified_time);
+    record.release_date = entry->release_date;
+    record.path = string_pool.Add(entry->path);
+    record.serial = string_pool.Add(entry->serial);
+    record.title = string_pool.Add(entry->title);
+    record.genre = string_pool.Add(entry->genre);
+    record.publisher = string_pool.Add(entry->publisher);
+    record.developer = string_pool.Add(entry->developer);
+    record.supported_controllers = entry->supported_controllers;
+    record.type = static_cast<u8>(entry->type);
+    record.region = static_cast<u8>(entry->region);
+    record.min_players = entry->min_players;
+    record.max_players = entry->max_players;
+    record.min_blocks = entry->min_blocks;
+    record.max_blocks = entry->max_blocks;
+    record.compatibility = static_cast<u8>(entry->compatibility);
+    buckets[bucket] = static_cast<u32>(records.size() - 1);
   }
 
-  Log_InfoPrintf("Creating new game list cache file: '%s'", cache_filename.c_str());
+  CacheHeader header = {};
+  header.signature = GAME_LIST_CACHE_SIGNATURE;
+  header.version = GAME_LIST_CACHE_VERSION;
+  header.num_records = static_cast<u32>(records.size());
+  header.num_buckets = num_buckets;
+  header.string_pool_size = string_pool.GetSize();
 
-  s_cache_write_stream = ByteStream::OpenFile(
-    cache_filename.c_str(), BYTESTREAM_OPEN_CREATE | BYTESTREAM_OPEN_TRUNCATE | BYTESTREAM_OPEN_WRITE);
-  if (!s_cache_write_stream)
-    return false;
+  // the old file can't be replaced while it's mapped on Windows
+  s_cache_file.Unmap();
 
-  // new cache file, write header
-  if (!s_cache_write_stream->WriteU32(GAME_LIST_CACHE_SIGNATURE) ||
-      !s_cache_write_stream->WriteU32(GAME_LIST_CACHE_VERSION))
+  const std::string filename(GetCacheFilename());
+  if (!MappedCache::WriteFile(filename, {{&header, sizeof(header)},
+                                         {buckets.data(), sizeof(u32) * buckets.size()},
+                                         {records.data(), sizeof(CacheRecord) * records.size()},
+                                         {string_pool.GetData(), string_pool.GetSize()}}))
   {
-    Log_ErrorPrintf("Failed to write game list cache header");
-    s_cache_write_stream.reset();
-    FileSystem::DeleteFile(cache_filename.c_str());
+    Log_ErrorPrintf("Failed to write game list cache '%s'", filename.c_str());
     return false;
   }
 
+  Log_InfoPrintf("Wrote game list cache with %u entries", header.num_records);
   return true;
 }
 
-void GameList::CloseCacheFileStream()
+void GameList::CloseCache()
 {
-  if (!s_cache_write_stream)
-    return;
+  if (s_cache_dirty)
+  {
+    WriteCache();
+    s_cache_dirty = false;
+  }
 
-  s_cache_write_stream->Commit();
-  s_cache_write_stream.reset();
+  s_cache_file.Unmap();
+  s_cache_record_used = {};
 }
 
 void GameList::DeleteCacheFile()
 {
-  Assert(!s_cache_write_stream);
+  Assert(!s_cache_file.IsValid());
 
   const std::string filename(GetCacheFilename());
   if (!FileSystem::FileExists(filename.c_str()))
@@ -451,7 +546,7 @@ static bool IsPathExcluded(const std::vector<std::string>& excluded_paths, const
 
 void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
                              const std::vector<std::string>& excluded_paths, const PlayedTimeMap& played_time_map,
-                             ProgressCallback* progress)
+                             u32 num_threads, ProgressCallback* progress)
 {
   Log_InfoPrintf("Scanning %s%s", path, recursive ? " (recursively)" : "");
 
@@ -469,14 +564,15 @@ void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
   progress->SetProgressRange(static_cast<u32>(files.size()));
   progress->SetProgressValue(0);
 
+  // pick up cached entries first, so only the files which need opening are left
+  std::vector<FILESYSTEM_FIND_DATA*> files_to_scan;
   u32 files_scanned = 0;
   for (FILESYSTEM_FIND_DATA& ffd : files)
   {
-    files_scanned++;
-
     if (progress->IsCancelled() || !GameList::IsScannableFilename(ffd.FileName) ||
         IsPathExcluded(excluded_paths, ffd.FileName))
     {
+      files_scanned++;
       continue;
     }
 
@@ -484,18 +580,112 @@ void GameList::ScanDirectory(const char* path, bool recursive, bool only_cache,
     if (GetEntryForPath(ffd.FileName.c_str()) ||
         AddFileFromCache(ffd.FileName, ffd.ModificationTime, played_time_map) || only_cache)
     {
+      files_scanned++;
       continue;
     }
 
-    progress->SetFormattedStatusText("Scanning '%s'...", FileSystem::GetDisplayNameFromPath(ffd.FileName).c_str());
-    ScanFile(std::move(ffd.FileName), ffd.ModificationTime, lock, played_time_map);
-    progress->SetProgressValue(files_scanned);
+    files_to_scan.push_back(&ffd);
   }
 
   progress->SetProgressValue(files_scanned);
+
+  if (num_threads > 1 && files_to_scan.size() > 1)
+  {
+    ScanFilesInParallel(files_to_scan, num_threads, played_time_map, progress, files_scanned);
+  }
+  else
+  {
+    for (FILESYSTEM_FIND_DATA* ffd : files_to_scan)
+    {
+      if (progress->IsCancelled())
+        break;
+
+      progress->SetFormattedStatusText("Scanning '%s'...", FileSystem::GetDisplayNameFromPath(ffd->FileName).c_str());
+
+      std::unique_lock lock(s_mutex);
+      ScanFile(std::move(ffd->FileName), ffd->ModificationTime, lock, played_time_map);
+      progress->SetProgressValue(++files_scanned);
+    }
+  }
+
+  progress->SetProgressValue(static_cast<u32>(files.size()));
   progress->PopState();
 }
 
+void GameList::ScanFilesInParallel(std::vector<FILESYSTEM_FIND_DATA*>& files, u32 num_threads,
+                                   const PlayedTimeMap& played_time_map, ProgressCallback* progress, u32 progress_base)
+{
+  // the database is loaded on first use, which isn't thread safe
+  GameDatabase::EnsureLoaded();
+
+  const u32 num_files = static_cast<u32>(files.size());
+  std::vector<Entry> entries(num_files);
+  std::vector<u8> entry_valid(num_files, 0);
+  std::atomic<u32> next_file{0};
+  std::atomic<u32> files_done{0};
+  std::atomic_bool cancelled{false};
+
+  auto scan_next_file = [&](bool report_progress) {
+    const u32 index = next_file.fetch_add(1, std::memory_order_relaxed);
+    if (index >= num_files || cancelled.load(std::memory_order_relaxed))
+      return false;
+
+    const std::string& path = files[index]->FileName;
+    if (report_progress)
+      progress->SetFormattedStatusText("Scanning '%s'...", FileSystem::GetDisplayNameFromPath(path).c_str());
+
+    Log_DevPrintf("Scanning '%s'...", path.c_str());
+    entry_valid[index] = PopulateEntryFromPath(path, &entries[index]);
+    files_done.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  };
+
+  // the calling thread is one of the scanners, the rest come from the shared pool
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  Threading::ThreadPool::TaskGroup group;
+  num_threads = std::min({num_threads, num_files, pool.GetThreadCount() + 1});
+  for (u32 i = 1; i < num_threads; i++)
+  {
+    pool.Submit(
+      [&scan_next_file]() {
+        while (scan_next_file(false))
+          ;
+      },
+      Threading::ThreadPool::Priority::Normal, &group);
+  }
+
+  // the calling thread scans too, and keeps the progress callback up to date
+  while (scan_next_file(true))
+  {
+    progress->SetProgressValue(progress_base + files_done.load(std::memory_order_relaxed));
+    if (progress->IsCancelled())
+      cancelled.store(true, std::memory_order_relaxed);
+  }
+
+  group.Wait(pool);
+
+  // cache writes and entry order are the same as a serial scan
+  for (u32 i = 0; i < num_files; i++)
+  {
+    if (entry_valid[i])
+      FinishScannedEntry(&entries[i], std::move(files[i]->FileName), files[i]->ModificationTime, played_time_map);
+  }
+
+  std::unique_lock lock(s_mutex);
+  for (u32 i = 0; i < num_files; i++)
+  {
+    if (entry_valid[i])
+      s_entries.push_back(std::move(entries[i]));
+  }
+}
+
+u32 GameList::GetScanThreadCount()
+{
+  // 0 means one thread per core, 1 scans on the calling thread
+  const u32 num_threads = Host::GetBaseUIntSettingValue("GameList", "ScanThreads", 0);
+  return (num_threads > 0) ? num_threads : (Threading::ThreadPool::GetShared().GetThreadCount() + 1);
+}
+
 bool GameList::AddFileFromCache(const std::string& path, std::time_t timestamp, const PlayedTimeMap& played_time_map)
 {
   Entry entry;
@@ -525,25 +715,28 @@ bool GameList::ScanFile(std::string path, std::time_t timestamp, std::unique_loc
   if (!PopulateEntryFromPath(path, &entry))
     return false;
 
-  entry.path = std::move(path);
-  entry.last_modified_time = timestamp;
+  FinishScannedEntry(&entry, std::move(path), timestamp, played_time_map);
 
-  if (s_cache_write_stream || OpenCacheForWriting())
-  {
-    if (!WriteEntryToCache(&entry))
-      Log_WarningPrintf("Failed to write entry '%s' to cache", entry.path.c_str());
-  }
+  lock.lock();
+  s_entries.push_back(std::move(entry));
+  return true;
+}
 
-  auto iter = UnorderedStringMapFind(played_time_map, entry.serial);
+void GameList::FinishScannedEntry(Entry* entry, std::string path, std::time_t timestamp,
+                                  const PlayedTimeMap& played_time_map)
+{
+  entry->path = std::move(path);
+  entry->last_modified_time = timestamp;
+
+  // written out when the scan finishes
+  s_cache_dirty = true;
+
+  auto iter = UnorderedStringMapFind(played_time_map, entry->serial);
   if (iter != played_time_map.end())
   {
-    entry.last_played_time = iter->second.last_played_time;
-    entry.total_played_time = iter->second.total_played_time;
+    entry->last_played_time = iter->second.last_played_time;
+    entry->total_played_time = iter->second.total_played_time;
   }
-
-  lock.lock();
-  s_entries.push_back(std::move(entry));
-  return true;
 }
 
 std::unique_lock<std::recursive_mutex> GameList::GetLock()
@@ -610,6 +803,7 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
   const std::vector<std::string> dirs(Host::GetBaseStringListSetting("GameList", "Paths"));
   const std::vector<std::string> recursive_dirs(Host::GetBaseStringListSetting("GameList", "RecursivePaths"));
   const PlayedTimeMap played_time(LoadPlayedTimeMap(GetPlayedTimeFile()));
+  const u32 num_threads = GetScanThreadCount();
 
   if (!dirs.empty() || !recursive_dirs.empty())
   {
@@ -623,7 +817,7 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
       if (progress->IsCancelled())
         break;
 
-      ScanDirectory(dir.c_str(), false, only_cache, excluded_paths, played_time, progress);
+      ScanDirectory(dir.c_str(), false, only_cache, excluded_paths, played_time, num_threads, progress);
       progress->SetProgressValue(++directory_counter);
     }
     for (const std::string& dir : recursive_dirs)
@@ -631,14 +825,13 @@ void GameList::Refresh(bool invalidate_cache, bool only_cache, ProgressCallback*
       if (progress->IsCancelled())
         break;
 
-      ScanDirectory(dir.c_str(), true, only_cache, excluded_paths, played_time, progress);
+      ScanDirectory(dir.c_str(), true, only_cache, excluded_paths, played_time, num_threads, progress);
       progress->SetProgressValue(++directory_counter);
     }
   }
 
-  // don't need unused cache entries
-  CloseCacheFileStream();
-  s_cache_map.clear();
+  // don't need the cache until the next refresh
+  CloseCache();
 }
 
 std::string GameList::GetCoverImagePathForEntry(const Entry* entry)
@@ -1054,6 +1247,10 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
     return false;
   }
 
+  // keep a few requests in flight, cover hosts are mostly latency bound
+  const u32 max_active_requests = std::max(Host::GetBaseUIntSettingValue("GameList", "MaxConcurrentDownloads", 8), 1u);
+  downloader->SetMaxActiveRequests(max_active_requests);
+
   progress->SetCancellable(true);
   progress->SetProgressRange(static_cast<u32>(download_urls.size()));
 
@@ -1075,11 +1272,12 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
       progress->SetFormattedStatusText("Downloading cover for %s...", entry->title.c_str());
     }
 
-    // we could actually do a few in parallel here...
     std::string filename(Common::HTTPDownloader::URLDecode(url));
     downloader->CreateRequest(
-      std::move(url), [use_serial, &save_callback, entry_path = std::move(entry_path), filename = std::move(filename)](
-                        s32 status_code, std::string content_type, Common::HTTPDownloader::Request::Data data) {
+      std::move(url), [use_serial, progress, &save_callback, entry_path = std::move(entry_path),
+                       filename = std::move(filename)](s32 status_code, std::string content_type,
+                                                       Common::HTTPDownloader::Request::Data data) {
+        progress->IncrementProgressValue();
         if (status_code != Common::HTTPDownloader::HTTP_OK || data.empty())
           return;
 
@@ -1110,9 +1308,11 @@ bool GameList::DownloadCovers(const std::vector<std::string>& url_templates, boo
         if (FileSystem::WriteBinaryFile(write_path.c_str(), data.data(), data.size()) && save_callback)
           save_callback(entry, std::move(write_path));
       });
-    downloader->WaitForAllRequests();
-    progress->IncrementProgressValue();
+
+    // only queue one request past the limit, so cancelling doesn't have to wait for the whole list
+    downloader->WaitForRequestCountBelow(max_active_requests + 1);
   }
 
+  downloader->WaitForAllRequests();
   return true;
 }
@@ -2,9 +2,11 @@
 #include "core/host_settings.h"
 #include "common/assert.h"
 #include "common/layered_settings_interface.h"
+#include <atomic>
 
 static std::mutex s_settings_mutex;
 static LayeredSettingsInterface s_layered_settings_interface;
+static std::atomic<u32> s_settings_generation{0};
 
 std::unique_lock<std::mutex> Host::GetSettingsLock()
 {
@@ -106,53 +108,73 @@ std::vector<std::string> Host::GetStringListSetting(const char* section, const c
 	return s_layered_settings_interface.GetStringList(section, key);
 }
 
+u32 Host::GetSettingsGeneration()
+{
+  return s_settings_generation.load(std::memory_order_acquire);
+}
+
 void Host::SetBaseBoolSettingValue(const char* section, const char* key, bool value)
 {
   std::unique_lock lock(s_settings_mutex);
   s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)->SetBoolValue(section, key, value);
+  Internal::InvalidateCachedSettings();
 }
 
 void Host::SetBaseIntSettingValue(const char* section, const char* key, int value)
 {
   std::unique_lock lock(s_settings_mutex);
   s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)->SetIntValue(section, key, value);
+  Internal::InvalidateCachedSettings();
 }
 
 void Host::SetBaseFloatSettingValue(const char* section, const char* key, float value)
 {
   std::unique_lock lock(s_settings_mutex);
   s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)->SetFloatValue(section, key, value);
+  Internal::InvalidateCachedSettings();
 }
 
 void Host::SetBaseStringSettingValue(const char* section, const char* key, const char* value)
 {
   std::unique_lock lock(s_settings_mutex);
   s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)->SetStringValue(section, key, value);
+  Internal::InvalidateCachedSettings();
 }
 
 void Host::SetBaseStringListSettingValue(const char* section, const char* key, const std::vector<std::string>& values)
 {
   std::unique_lock lock(s_settings_mutex);
   s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)->SetStringList(section, key, values);
+  Internal::InvalidateCachedSettings();
 }
 
 bool Host::AddValueToBaseStringListSetting(const char* section, const char* key, const char* value)
 {
   std::unique_lock lock(s_settings_mutex);
-  return s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)->AddToStringList(section, key, value);
+  SettingsInterface* sif = s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE);
+  if (!sif->AddToStringList(section, key, value))
+    return false;
+
+  Internal::InvalidateCachedSettings();
+  return true;
 }
 
 bool Host::RemoveValueFromBaseStringListSetting(const char* section, const char* key, const char* value)
 {
   std::unique_lock lock(s_settings_mutex);
-  return s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)
-    ->RemoveFromStringList(section, key, value);
+  SettingsInterface* sif = s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE);
+  if (!sif->RemoveFromStringList(section, key, value))
+    return false;
+
+  Internal::InvalidateCachedSettings();
+  return true;
 }
 
 void Host::DeleteBaseSettingValue(const char* section, const char* key)
 {
   std::unique_lock lock(s_settings_mutex);
   s_layered_settings_interface.GetLayer(LayeredSettingsInterface::LAYER_BASE)->DeleteValue(section, key);
+  Internal::InvalidateCachedSettings();
 }
 
 SettingsInterface* Host::Internal::GetBaseSettingsLayer()
@@ -180,10 +202,17 @@ void Host::Internal::SetGameSettingsLayer(SettingsInterface* sif)
 {
 	std::unique_lock lock(s_settings_mutex);
 	s_layered_settings_interface.SetLayer(LayeredSettingsInterface::LAYER_GAME, sif);
+	InvalidateCachedSettings();
 }
 
 void Host::Internal::SetInputSettingsLayer(SettingsInterface* sif)
 {
 	std::unique_lock lock(s_settings_mutex);
 	s_layered_settings_interface.SetLayer(LayeredSettingsInterface::LAYER_INPUT, sif);
+	InvalidateCachedSettings();
+}
+
+void Host::Internal::InvalidateCachedSettings()
+{
+  s_settings_generation.fetch_add(1, std::memory_order_acq_rel);
 }
@@ -8,12 +8,14 @@
 #include "common/image.h"
 #include "common/log.h"
 #include "common/lru_cache.h"
+#include "common/md5_digest.h"
 #include "common/path.h"
 #include "common/string_util.h"
 #include "common/threading.h"
 #include "common/timer.h"
 #include "core/host.h"
 #include "core/host_display.h"
+#include "core/settings.h"
 #include "fmt/core.h"
 #include "imgui_internal.h"
 #include "imgui_stdlib.h"
@@ -22,6 +24,7 @@
 #include <cmath>
 #include <condition_variable>
 #include <deque>
+#include <limits>
 #include <mutex>
 #include <thread>
 #include <variant>
@@ -32,7 +35,13 @@ namespace ImGuiFullscreen {
 using MessageDialogCallbackVariant = std::variant<InfoMessageDialogCallback, ConfirmMessageDialogCallback>;
 
 static std::optional<Common::RGBA8Image> LoadTextureImage(const char* path);
+static std::optional<Common::RGBA8Image> LoadThumbnailImage(const char* path, u32 size);
+static std::string GetThumbnailCachePath(const char* path, std::time_t modification_time, u32 size);
 static std::shared_ptr<GPUTexture> UploadTexture(const char* path, const Common::RGBA8Image& image);
+static std::shared_ptr<GPUTexture>* InsertCachedTexture(std::string key, std::shared_ptr<GPUTexture> texture);
+static size_t GetCachedTextureMemoryUsage(const std::shared_ptr<GPUTexture>& texture);
+static void TrimTextureCache();
+static void QueueTextureLoad(std::string key, std::string path, u32 thumbnail_size);
 static void TextureLoaderThread();
 
 static void DrawFileSelector();
@@ -78,12 +87,26 @@ static u32 s_menu_button_index = 0;
 static u32 s_close_button_state = 0;
 static bool s_focus_reset_queued = false;
 
-static LRUCache<std::string, std::shared_ptr<GPUTexture>> s_texture_cache(128, true);
+// Textures are bounded by GPU memory rather than count, and only trimmed at the start of a frame so that anything
+// referenced by the previous frame's draw lists has already been rendered.
+static constexpr size_t TEXTURE_CACHE_MEMORY_BUDGET = 128 * 1024 * 1024;
+static constexpr u32 MAX_TEXTURE_UPLOADS_PER_FRAME = 4;
+
+struct TextureLoadRequest
+{
+  std::string key;
+  std::string path;
+  u32 thumbnail_size;
+};
+
+static LRUCache<std::string, std::shared_ptr<GPUTexture>> s_texture_cache(std::numeric_limits<size_t>::max(), true);
+static size_t s_texture_cache_memory_usage = 0;
 static std::shared_ptr<GPUTexture> s_placeholder_texture;
+static std::string s_thumbnail_cache_directory;
 static std::atomic_bool s_texture_load_thread_quit{false};
 static std::mutex s_texture_load_mutex;
 static std::condition_variable s_texture_load_cv;
-static std::deque<std::string> s_texture_load_queue;
+static std::deque<TextureLoadRequest> s_texture_load_queue;
 static std::deque<std::pair<std::string, Common::RGBA8Image>> s_texture_upload_queue;
 static std::thread s_texture_load_thread;
 
@@ -185,6 +208,16 @@ bool ImGuiFullscreen::Initialize(const char* placeholder_image_path)
     return false;
   }
 
+  if (!EmuFolders::Cache.empty())
+  {
+    s_thumbnail_cache_directory = Path::Combine(EmuFolders::Cache, "thumbnails");
+    if (!FileSystem::EnsureDirectoryExists(s_thumbnail_cache_directory.c_str(), false))
+    {
+      Log_WarningPrintf("Failed to create thumbnail cache directory '%s'", s_thumbnail_cache_directory.c_str());
+      s_thumbnail_cache_directory.clear();
+    }
+  }
+
   s_texture_load_thread_quit.store(false, std::memory_order_release);
   s_texture_load_thread = std::thread(TextureLoaderThread);
   return true;
@@ -209,6 +242,8 @@ void ImGuiFullscreen::Shutdown()
   g_large_font = nullptr;
 
   s_texture_cache.Clear();
+  s_texture_cache_memory_usage = 0;
+  s_thumbnail_cache_directory.clear();
 
   s_notifications.clear();
   s_background_progress_dialogs.clear();
@@ -262,6 +297,55 @@ std::optional<Common::RGBA8Image> ImGuiFullscreen::LoadTextureImage(const char*
   return image;
 }
 
+std::optional<Common::RGBA8Image> ImGuiFullscreen::LoadThumbnailImage(const char* path, u32 size)
+{
+  // pre-scaled copies are keyed on the source's modification time, so replacing a cover regenerates it
+  std::string cache_path;
+  FILESYSTEM_STAT_DATA sd;
+  if (!s_thumbnail_cache_directory.empty() && Path::IsAbsolute(path) && FileSystem::StatFile(path, &sd))
+  {
+    cache_path = GetThumbnailCachePath(path, sd.ModificationTime, size);
+
+    Common::RGBA8Image cached_image;
+    if (FileSystem::FileExists(cache_path.c_str()) && cached_image.LoadFromFile(cache_path.c_str()))
+      return cached_image;
+  }
+
+  std::optional<Common::RGBA8Image> image(LoadTextureImage(path));
+  if (!image.has_value() || (image->GetWidth() <= size && image->GetHeight() <= size))
+    return image;
+
+  const float scale = static_cast<float>(size) / static_cast<float>(std::max(image->GetWidth(), image->GetHeight()));
+  const u32 new_width = std::max(static_cast<u32>(std::round(static_cast<float>(image->GetWidth()) * scale)), 1u);
+  const u32 new_height = std::max(static_cast<u32>(std::round(static_cast<float>(image->GetHeight()) * scale)), 1u);
+  image->Resize(new_width, new_height);
+
+  if (!cache_path.empty() && !image->SaveToFile(cache_path.c_str()))
+    Log_WarningPrintf("Failed to save thumbnail for '%s' to '%s'", path, cache_path.c_str());
+
+  return image;
+}
+
+std::string ImGuiFullscreen::GetThumbnailCachePath(const char* path, std::time_t modification_time, u32 size)
+{
+  const s64 mtime = static_cast<s64>(modification_time);
+  MD5Digest digest;
+  digest.Update(path, static_cast<u32>(std::strlen(path)));
+  digest.Update(&mtime, sizeof(mtime));
+  digest.Update(&size, sizeof(size));
+
+  u8 hash[16];
+  digest.Final(hash);
+
+  std::string name;
+  name.reserve(sizeof(hash) * 2 + 4);
+  for (const u8 byte : hash)
+    fmt::format_to(std::back_inserter(name), "{:02x}", byte);
+  name.append(".png");
+
+  return Path::Combine(s_thumbnail_cache_directory, name);
+}
+
 std::shared_ptr<GPUTexture> ImGuiFullscreen::UploadTexture(const char* path, const Common::RGBA8Image& image)
 {
   std::unique_ptr<GPUTexture> texture = g_host_display->CreateTexture(
@@ -290,13 +374,49 @@ std::shared_ptr<GPUTexture> ImGuiFullscreen::LoadTexture(const std::string_view&
   return s_placeholder_texture;
 }
 
+size_t ImGuiFullscreen::GetCachedTextureMemoryUsage(const std::shared_ptr<GPUTexture>& texture)
+{
+  // the placeholder is shared, and owned elsewhere
+  if (!texture || texture == s_placeholder_texture)
+    return 0;
+
+  return static_cast<size_t>(texture->GetWidth()) * static_cast<size_t>(texture->GetHeight()) * sizeof(u32);
+}
+
+std::shared_ptr<GPUTexture>* ImGuiFullscreen::InsertCachedTexture(std::string key,
+                                                                   std::shared_ptr<GPUTexture> texture)
+{
+  if (const std::shared_ptr<GPUTexture>* existing = s_texture_cache.Lookup(key); existing)
+    s_texture_cache_memory_usage -= GetCachedTextureMemoryUsage(*existing);
+
+  s_texture_cache_memory_usage += GetCachedTextureMemoryUsage(texture);
+  return s_texture_cache.Insert(std::move(key), std::move(texture));
+}
+
+void ImGuiFullscreen::TrimTextureCache()
+{
+  while (s_texture_cache_memory_usage > TEXTURE_CACHE_MEMORY_BUDGET &&
+         s_texture_cache.EvictOldest([](const std::shared_ptr<GPUTexture>& texture) {
+           s_texture_cache_memory_usage -= GetCachedTextureMemoryUsage(texture);
+         }))
+  {
+  }
+}
+
+void ImGuiFullscreen::QueueTextureLoad(std::string key, std::string path, u32 thumbnail_size)
+{
+  std::unique_lock lock(s_texture_load_mutex);
+  s_texture_load_queue.push_back(TextureLoadRequest{std::move(key), std::move(path), thumbnail_size});
+  s_texture_load_cv.notify_one();
+}
+
 GPUTexture* ImGuiFullscreen::GetCachedTexture(const std::string_view& name)
 {
   std::shared_ptr<GPUTexture>* tex_ptr = s_texture_cache.Lookup(name);
   if (!tex_ptr)
   {
     std::shared_ptr<GPUTexture> tex(LoadTexture(name));
-    tex_ptr = s_texture_cache.Insert(std::string(name), std::move(tex));
+    tex_ptr = InsertCachedTexture(std::string(name), std::move(tex));
   }
 
   return tex_ptr->get();
@@ -307,13 +427,22 @@ GPUTexture* ImGuiFullscreen::GetCachedTextureAsync(const std::string_view& name)
   std::shared_ptr<GPUTexture>* tex_ptr = s_texture_cache.Lookup(name);
   if (!tex_ptr)
   {
-    // insert the placeholder
-    tex_ptr = s_texture_cache.Insert(std::string(name), s_placeholder_texture);
+    // insert the placeholder, and queue the actual load
+    tex_ptr = InsertCachedTexture(std::string(name), s_placeholder_texture);
+    QueueTextureLoad(std::string(name), std::string(name), 0);
+  }
 
-    // queue the actual load
-    std::unique_lock lock(s_texture_load_mutex);
-    s_texture_load_queue.emplace_back(name);
-    s_texture_load_cv.notify_one();
+  return tex_ptr->get();
+}
+
+GPUTexture* ImGuiFullscreen::GetCachedThumbnailAsync(const std::string_view& path, u32 size)
+{
+  const std::string key(fmt::format("{}@{}", path, size));
+  std::shared_ptr<GPUTexture>* tex_ptr = s_texture_cache.Lookup(key);
+  if (!tex_ptr)
+  {
+    tex_ptr = InsertCachedTexture(key, s_placeholder_texture);
+    QueueTextureLoad(key, std::string(path), size);
   }
 
   return tex_ptr->get();
@@ -321,13 +450,22 @@ GPUTexture* ImGuiFullscreen::GetCachedTextureAsync(const std::string_view& name)
 
 bool ImGuiFullscreen::InvalidateCachedTexture(const std::string& path)
 {
+  const std::shared_ptr<GPUTexture>* tex_ptr = s_texture_cache.Lookup(path);
+  if (!tex_ptr)
+    return false;
+
+  s_texture_cache_memory_usage -= GetCachedTextureMemoryUsage(*tex_ptr);
   return s_texture_cache.Remove(path);
 }
 
 void ImGuiFullscreen::UploadAsyncTextures()
 {
+  TrimTextureCache();
+
+  // spread uploads over several frames, so a screen full of covers arriving at once doesn't hitch
+  u32 uploads_remaining = MAX_TEXTURE_UPLOADS_PER_FRAME;
   std::unique_lock lock(s_texture_load_mutex);
-  while (!s_texture_upload_queue.empty())
+  while (!s_texture_upload_queue.empty() && uploads_remaining > 0)
   {
     std::pair<std::string, Common::RGBA8Image> it(std::move(s_texture_upload_queue.front()));
     s_texture_upload_queue.pop_front();
@@ -335,8 +473,9 @@ void ImGuiFullscreen::UploadAsyncTextures()
 
     std::shared_ptr<GPUTexture> tex = UploadTexture(it.first.c_str(), it.second);
     if (tex)
-      s_texture_cache.Insert(std::move(it.first), std::move(tex));
+      InsertCachedTexture(std::move(it.first), std::move(tex));
 
+    uploads_remaining--;
     lock.lock();
   }
 }
@@ -358,16 +497,19 @@ void ImGuiFullscreen::TextureLoaderThread()
 
     while (!s_texture_load_queue.empty())
     {
-      std::string path(std::move(s_texture_load_queue.front()));
-      s_texture_load_queue.pop_front();
+      // newest first, so whatever was just scrolled into view loads before anything that has since scrolled past
+      TextureLoadRequest req(std::move(s_texture_load_queue.back()));
+      s_texture_load_queue.pop_back();
 
       lock.unlock();
-      std::optional<Common::RGBA8Image> image(LoadTextureImage(path.c_str()));
+      std::optional<Common::RGBA8Image> image((req.thumbnail_size > 0) ?
+                                                LoadThumbnailImage(req.path.c_str(), req.thumbnail_size) :
+                                                LoadTextureImage(req.path.c_str()));
       lock.lock();
 
       // don't bother queuing back if it doesn't exist
       if (image)
-        s_texture_upload_queue.emplace_back(std::move(path), std::move(image.value()));
+        s_texture_upload_queue.emplace_back(std::move(req.key), std::move(image.value()));
     }
   }
 
@@ -131,6 +131,8 @@ const std::shared_ptr<GPUTexture>& GetPlaceholderTexture();
 std::shared_ptr<GPUTexture> LoadTexture(const std::string_view& path);
 GPUTexture* GetCachedTexture(const std::string_view& name);
 GPUTexture* GetCachedTextureAsync(const std::string_view& name);
+/// Loads a copy of the image downscaled to fit within size x size on the loader thread, caching it on disk.
+GPUTexture* GetCachedThumbnailAsync(const std::string_view& path, u32 size);
 bool InvalidateCachedTexture(const std::string& path);
 void UploadAsyncTextures();
 
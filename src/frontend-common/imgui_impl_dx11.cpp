@@ -121,6 +121,10 @@ void ImGui_ImplDX11_RenderDrawData(ImDrawData* draw_data)
     if (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f)
         return;
 
+    // Nothing visible (no OSD/overlays/menus), skip the state backup and setup entirely
+    if (draw_data->TotalVtxCount == 0)
+        return;
+
     ImGui_ImplDX11_Data* bd = ImGui_ImplDX11_GetBackendData();
     ID3D11DeviceContext* ctx = bd->pd3dDeviceContext;
 
@@ -153,6 +153,10 @@ void ImGui_ImplDX12_RenderDrawData(ImDrawData* draw_data)
     if (draw_data->DisplaySize.x <= 0.0f || draw_data->DisplaySize.y <= 0.0f)
         return;
 
+    // Nothing visible (no OSD/overlays/menus), skip the state backup and setup entirely
+    if (draw_data->TotalVtxCount == 0)
+        return;
+
     // FIXME: I'm assuming that this only gets called once per frame!
     // If not, we can't just re-allocate the IB or VB, we'll have to do a proper allocator.
     ImGui_ImplDX12_Data* bd = ImGui_ImplDX12_GetBackendData();
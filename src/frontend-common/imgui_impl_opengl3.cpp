@@ -248,6 +248,10 @@ void    ImGui_ImplOpenGL3_RenderDrawData(ImDrawData* draw_data)
     if (fb_width <= 0 || fb_height <= 0)
         return;
 
+    // Nothing visible (no OSD/overlays/menus), skip the state setup entirely
+    if (draw_data->TotalVtxCount == 0)
+        return;
+
     ImGui_ImplOpenGL3_Data* bd = ImGui_ImplOpenGL3_GetBackendData();
 
     // Setup desired GL state
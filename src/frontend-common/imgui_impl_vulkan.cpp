@@ -277,6 +277,10 @@ void ImGui_ImplVulkan_RenderDrawData(ImDrawData* draw_data)
     if (fb_width <= 0 || fb_height <= 0)
         return;
 
+    // Nothing visible (no OSD/overlays/menus), skip the state setup entirely
+    if (draw_data->TotalVtxCount == 0)
+        return;
+
     ImGui_ImplVulkan_Data* bd = ImGui_ImplVulkan_GetBackendData();
     if (draw_data->TotalVtxCount > 0)
     {
@@ -359,17 +363,27 @@ void ImGui_ImplVulkan_RenderDrawData(ImDrawData* draw_data)
                 const Vulkan::Texture* tex = (const Vulkan::Texture*)pcmd->TextureId;
                 if (tex && last_texture != tex)
                 {
-                    // if we can't get a descriptor set, we'll we're in trouble, since we can't restart the render pass from here.
-                    VkDescriptorSet ds = g_vulkan_context->AllocateDescriptorSet(bd->DescriptorSetLayout);
-                    if (ds == VK_NULL_HANDLE)
+                    if (g_vulkan_context->SupportsPushDescriptors())
                     {
-                        continue;
+                        VkDescriptorImageInfo image_info = { bd->FontSampler, tex->GetView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+                        VkWriteDescriptorSet write = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+                        write.dstBinding = 0;
+                        write.descriptorCount = 1;
+                        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                        write.pImageInfo = &image_info;
+                        vkCmdPushDescriptorSetKHR(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bd->PipelineLayout, 0, 1, &write);
+                    }
+                    else
+                    {
+                        // if we can't get a descriptor set, we'll we're in trouble, since we can't restart the render pass from here.
+                        VkDescriptorSet ds = g_vulkan_context->GetImageSamplerDescriptorSet(bd->DescriptorSetLayout, 0, tex->GetView(), bd->FontSampler);
+                        if (ds == VK_NULL_HANDLE)
+                        {
+                            continue;
+                        }
+
+                        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bd->PipelineLayout, 0, 1, &ds, 0, nullptr);
                     }
-
-                    Vulkan::DescriptorSetUpdateBuilder dsb;
-                    dsb.AddCombinedImageSamplerDescriptorWrite(ds, 0, tex->GetView(), bd->FontSampler);
-                    dsb.Update(g_vulkan_context->GetDevice());
-                    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, bd->PipelineLayout, 0, 1, &ds, 0, nullptr);
                     last_texture = tex;
                 }
 
@@ -484,6 +498,7 @@ static bool ImGui_ImplVulkan_CreateDescriptorSetLayout(VkDevice device)
     binding[0].pImmutableSamplers = sampler;
     VkDescriptorSetLayoutCreateInfo info = {};
     info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    info.flags = g_vulkan_context->SupportsPushDescriptors() ? VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR : 0;
     info.bindingCount = 1;
     info.pBindings = binding;
     VkResult err = vkCreateDescriptorSetLayout(device, &info, nullptr, &bd->DescriptorSetLayout);
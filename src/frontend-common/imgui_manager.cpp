@@ -1,14 +1,19 @@
 #include "imgui_manager.h"
 #include "IconsFontAwesome5.h"
+#include "common/allocation_profiler.h"
 #include "common/assert.h"
+#include "common/byte_stream.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/md5_digest.h"
+#include "common/path.h"
 #include "common/string_util.h"
 #include "common/timer.h"
 #include "common_host.h"
 #include "core/gpu.h"
 #include "core/host.h"
 #include "core/host_display.h"
+#include "core/settings.h"
 #include "core/system.h"
 #include "fmt/format.h"
 #include "fullscreen_ui.h"
@@ -16,20 +21,68 @@
 #include "imgui_fullscreen.h"
 #include "imgui_internal.h"
 #include "input_manager.h"
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cmath>
-#include <deque>
+#include <cstring>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 Log_SetChannel(ImGuiManager);
 
+/// Built atlases are kept zstd compressed, both in memory and in the cache directory.
+struct FontAtlasCacheHeader
+{
+  u32 signature;
+  u32 version;
+  u64 key;
+  u32 uncompressed_size;
+  u32 compressed_size;
+};
+
+struct FontAtlasHeader
+{
+  u32 tex_width;
+  u32 tex_height;
+  u32 num_fonts;
+  u32 num_custom_rects;
+  s32 pack_id_mouse_cursors;
+  s32 pack_id_lines;
+  ImVec2 tex_uv_white_pixel;
+  ImVec4 tex_uv_lines[IM_DRAWLIST_TEX_LINES_WIDTH_MAX + 1];
+};
+
+struct FontAtlasFontHeader
+{
+  float ascent;
+  float descent;
+  s32 metrics_total_surface;
+  u32 num_glyphs;
+};
+
+struct CachedFontAtlas
+{
+  u64 key;
+  std::vector<u8> data;
+};
+
+static constexpr u32 FONT_ATLAS_CACHE_SIGNATURE = 0x41465449; // ITFA
+static constexpr u32 FONT_ATLAS_CACHE_VERSION = 1;
+static constexpr u32 MAX_CACHED_FONT_ATLASES = 4;
+
 namespace ImGuiManager {
 static void SetStyle();
 static void SetKeyMap();
 static bool LoadFontData();
 static bool AddImGuiFonts(bool fullscreen_fonts);
+static bool BuildFontAtlas();
+static u64 GetFontAtlasCacheKey(const ImFontAtlas* atlas);
+static std::string GetFontAtlasCacheFileName(u64 key);
+static std::vector<u8> PackFontAtlas(const ImFontAtlas* atlas, u64 key);
+static bool UnpackFontAtlas(ImFontAtlas* atlas, u64 key, const std::vector<u8>& file_data);
+static void AddCachedFontAtlas(u64 key, std::vector<u8> data);
 static ImFont* AddTextFont(float size);
 static ImFont* AddFixedFont(float size);
 static bool AddIconFonts(float size);
@@ -50,6 +103,10 @@ static ImFont* s_large_font;
 static std::vector<u8> s_standard_font_data;
 static std::vector<u8> s_fixed_font_data;
 static std::vector<u8> s_icon_font_data;
+static u64 s_font_data_hash = 0;
+
+// Most recently used atlases are at the back.
+static std::vector<CachedFontAtlas> s_cached_font_atlases;
 
 static Common::Timer s_last_render_time;
 
@@ -387,6 +444,7 @@ void ImGuiManager::SetKeyMap()
 
 bool ImGuiManager::LoadFontData()
 {
+  const bool reloaded = (s_standard_font_data.empty() || s_fixed_font_data.empty() || s_icon_font_data.empty());
   if (s_standard_font_data.empty())
   {
     std::optional<std::vector<u8>> font_data = s_font_path.empty() ?
@@ -416,6 +474,18 @@ bool ImGuiManager::LoadFontData()
     s_icon_font_data = std::move(font_data.value());
   }
 
+  if (reloaded)
+  {
+    MD5Digest digest;
+    digest.Update(s_standard_font_data.data(), static_cast<u32>(s_standard_font_data.size()));
+    digest.Update(s_fixed_font_data.data(), static_cast<u32>(s_fixed_font_data.size()));
+    digest.Update(s_icon_font_data.data(), static_cast<u32>(s_icon_font_data.size()));
+
+    u8 hash[16];
+    digest.Final(hash);
+    std::memcpy(&s_font_data_hash, hash, sizeof(s_font_data_hash));
+  }
+
   return true;
 }
 
@@ -519,7 +589,302 @@ bool ImGuiManager::AddImGuiFonts(bool fullscreen_fonts)
 
   ImGuiFullscreen::SetFonts(s_standard_font, s_medium_font, s_large_font);
 
-  return io.Fonts->Build();
+  return BuildFontAtlas();
+}
+
+bool ImGuiManager::BuildFontAtlas()
+{
+  ImFontAtlas* atlas = ImGui::GetIO().Fonts;
+  const u64 key = GetFontAtlasCacheKey(atlas);
+
+  for (auto it = s_cached_font_atlases.begin(); it != s_cached_font_atlases.end(); ++it)
+  {
+    if (it->key != key)
+      continue;
+
+    CachedFontAtlas cached(std::move(*it));
+    s_cached_font_atlases.erase(it);
+    if (!UnpackFontAtlas(atlas, key, cached.data))
+      break;
+
+    s_cached_font_atlases.push_back(std::move(cached));
+    return true;
+  }
+
+  const std::string filename(GetFontAtlasCacheFileName(key));
+  if (!filename.empty())
+  {
+    std::optional<std::vector<u8>> data(FileSystem::ReadBinaryFile(filename.c_str()));
+    if (data.has_value())
+    {
+      if (UnpackFontAtlas(atlas, key, data.value()))
+      {
+        AddCachedFontAtlas(key, std::move(data.value()));
+        return true;
+      }
+
+      Log_WarningPrintf("Font atlas cache '%s' is invalid, rebuilding.", filename.c_str());
+    }
+  }
+
+  Common::Timer timer;
+  if (!atlas->Build())
+    return false;
+
+  Log_DevPrintf("Built %dx%d font atlas in %.2f ms", atlas->TexWidth, atlas->TexHeight, timer.GetTimeMilliseconds());
+
+  std::vector<u8> data(PackFontAtlas(atlas, key));
+  if (data.empty())
+    return true;
+
+  if (!filename.empty())
+  {
+    // write to a temporary file first, so a crash can't leave a truncated cache behind
+    const std::string temp_filename(filename + ".tmp");
+    if (!FileSystem::EnsureDirectoryExists(std::string(Path::GetDirectory(filename)).c_str(), false) ||
+        !FileSystem::WriteBinaryFile(temp_filename.c_str(), data.data(), data.size()) ||
+        !FileSystem::RenamePath(temp_filename.c_str(), filename.c_str()))
+    {
+      Log_ErrorPrintf("Failed to write font atlas cache '%s'", filename.c_str());
+      FileSystem::DeleteFile(temp_filename.c_str());
+    }
+  }
+
+  AddCachedFontAtlas(key, std::move(data));
+  return true;
+}
+
+u64 ImGuiManager::GetFontAtlasCacheKey(const ImFontAtlas* atlas)
+{
+  MD5Digest digest;
+  const auto hash = [&digest](const auto& value) { digest.Update(&value, sizeof(value)); };
+  hash(FONT_ATLAS_CACHE_VERSION);
+  hash(IMGUI_VERSION_NUM);
+  hash(sizeof(ImFontGlyph));
+  hash(sizeof(ImFontAtlasCustomRect));
+  hash(s_font_data_hash);
+  hash(atlas->Flags);
+  hash(atlas->TexDesiredWidth);
+  hash(atlas->TexGlyphPadding);
+  hash(atlas->FontBuilderFlags);
+
+  for (const ImFontConfig& cfg : atlas->ConfigData)
+  {
+    // font data is identified by which of our buffers it came from, the contents are covered by s_font_data_hash
+    const u8 source = (cfg.FontData == s_standard_font_data.data()) ? 0 :
+                      ((cfg.FontData == s_fixed_font_data.data()) ? 1 : 2);
+    hash(source);
+    hash(cfg.FontNo);
+    hash(cfg.SizePixels);
+    hash(cfg.OversampleH);
+    hash(cfg.OversampleV);
+    hash(cfg.PixelSnapH);
+    hash(cfg.GlyphExtraSpacing);
+    hash(cfg.GlyphOffset);
+    hash(cfg.GlyphMinAdvanceX);
+    hash(cfg.GlyphMaxAdvanceX);
+    hash(cfg.MergeMode);
+    hash(cfg.FontBuilderFlags);
+    hash(cfg.RasterizerMultiply);
+    hash(cfg.EllipsisChar);
+    for (const ImWchar* range = cfg.GlyphRanges; range && *range != 0; range++)
+      hash(*range);
+    hash(static_cast<ImWchar>(0));
+  }
+
+  u8 digest_hash[16];
+  digest.Final(digest_hash);
+
+  u64 key;
+  std::memcpy(&key, digest_hash, sizeof(key));
+  return key;
+}
+
+std::string ImGuiManager::GetFontAtlasCacheFileName(u64 key)
+{
+  if (EmuFolders::Cache.empty())
+    return {};
+
+  return Path::Combine(EmuFolders::Cache, fmt::format("fonts" FS_OSPATH_SEPARATOR_STR "{:016x}.cache", key));
+}
+
+std::vector<u8> ImGuiManager::PackFontAtlas(const ImFontAtlas* atlas, u64 key)
+{
+  // custom glyphs would reference fonts by pointer, we don't use them
+  for (const ImFontAtlasCustomRect& rect : atlas->CustomRects)
+  {
+    if (rect.Font)
+      return {};
+  }
+
+  if (!atlas->TexPixelsAlpha8)
+    return {};
+
+  std::vector<u8> data;
+  const auto append = [&data](const void* src, size_t size) {
+    const size_t pos = data.size();
+    data.resize(pos + size);
+    std::memcpy(&data[pos], src, size);
+  };
+
+  FontAtlasHeader header = {};
+  header.tex_width = static_cast<u32>(atlas->TexWidth);
+  header.tex_height = static_cast<u32>(atlas->TexHeight);
+  header.num_fonts = static_cast<u32>(atlas->Fonts.Size);
+  header.num_custom_rects = static_cast<u32>(atlas->CustomRects.Size);
+  header.pack_id_mouse_cursors = atlas->PackIdMouseCursors;
+  header.pack_id_lines = atlas->PackIdLines;
+  header.tex_uv_white_pixel = atlas->TexUvWhitePixel;
+  std::memcpy(header.tex_uv_lines, atlas->TexUvLines, sizeof(header.tex_uv_lines));
+  append(&header, sizeof(header));
+
+  for (const ImFont* font : atlas->Fonts)
+  {
+    FontAtlasFontHeader font_header = {};
+    font_header.ascent = font->Ascent;
+    font_header.descent = font->Descent;
+    font_header.metrics_total_surface = font->MetricsTotalSurface;
+    font_header.num_glyphs = static_cast<u32>(font->Glyphs.Size);
+    append(&font_header, sizeof(font_header));
+    append(font->Glyphs.Data, sizeof(ImFontGlyph) * font->Glyphs.Size);
+  }
+
+  append(atlas->CustomRects.Data, sizeof(ImFontAtlasCustomRect) * atlas->CustomRects.Size);
+  append(atlas->TexPixelsAlpha8, static_cast<size_t>(atlas->TexWidth) * static_cast<size_t>(atlas->TexHeight));
+
+  std::vector<u8> compressed_data;
+  if (!ByteStream::CompressZstd(data.data(), static_cast<u32>(data.size()), 0, &compressed_data))
+    return {};
+
+  FontAtlasCacheHeader file_header = {};
+  file_header.signature = FONT_ATLAS_CACHE_SIGNATURE;
+  file_header.version = FONT_ATLAS_CACHE_VERSION;
+  file_header.key = key;
+  file_header.uncompressed_size = static_cast<u32>(data.size());
+  file_header.compressed_size = static_cast<u32>(compressed_data.size());
+  compressed_data.insert(compressed_data.begin(), reinterpret_cast<const u8*>(&file_header),
+                         reinterpret_cast<const u8*>(&file_header) + sizeof(file_header));
+  return compressed_data;
+}
+
+bool ImGuiManager::UnpackFontAtlas(ImFontAtlas* atlas, u64 key, const std::vector<u8>& file_data)
+{
+  FontAtlasCacheHeader file_header;
+  if (file_data.size() < sizeof(file_header))
+    return false;
+
+  std::memcpy(&file_header, file_data.data(), sizeof(file_header));
+  if (file_header.signature != FONT_ATLAS_CACHE_SIGNATURE || file_header.version != FONT_ATLAS_CACHE_VERSION ||
+      file_header.key != key || file_header.compressed_size != (file_data.size() - sizeof(file_header)))
+  {
+    return false;
+  }
+
+  std::vector<u8> data(file_header.uncompressed_size);
+  if (!ByteStream::DecompressZstd(file_data.data() + sizeof(file_header), file_header.compressed_size, data.data(),
+                                  file_header.uncompressed_size))
+  {
+    return false;
+  }
+
+  // validate everything before touching the atlas, so a bad cache leaves it intact for a normal build
+  size_t pos = 0;
+  const auto skip = [&data, &pos](size_t size) {
+    if ((data.size() - pos) < size)
+      return false;
+
+    pos += size;
+    return true;
+  };
+
+  FontAtlasHeader header;
+  if (!skip(sizeof(header)))
+    return false;
+
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (header.num_fonts != static_cast<u32>(atlas->Fonts.Size) || header.tex_width == 0 || header.tex_height == 0)
+    return false;
+
+  std::vector<size_t> font_offsets(header.num_fonts);
+  for (size_t& offset : font_offsets)
+  {
+    FontAtlasFontHeader font_header;
+    offset = pos;
+    if (!skip(sizeof(font_header)))
+      return false;
+
+    std::memcpy(&font_header, &data[offset], sizeof(font_header));
+    if (!skip(sizeof(ImFontGlyph) * static_cast<size_t>(font_header.num_glyphs)))
+      return false;
+  }
+
+  const size_t custom_rects_offset = pos;
+  const size_t pixels_size = static_cast<size_t>(header.tex_width) * static_cast<size_t>(header.tex_height);
+  if (!skip(sizeof(ImFontAtlasCustomRect) * static_cast<size_t>(header.num_custom_rects)) ||
+      (data.size() - pos) != pixels_size)
+  {
+    return false;
+  }
+
+  atlas->ClearTexData();
+  atlas->TexWidth = static_cast<int>(header.tex_width);
+  atlas->TexHeight = static_cast<int>(header.tex_height);
+  atlas->TexUvScale = ImVec2(1.0f / static_cast<float>(header.tex_width), 1.0f / static_cast<float>(header.tex_height));
+  atlas->TexUvWhitePixel = header.tex_uv_white_pixel;
+  std::memcpy(atlas->TexUvLines, header.tex_uv_lines, sizeof(atlas->TexUvLines));
+  atlas->PackIdMouseCursors = header.pack_id_mouse_cursors;
+  atlas->PackIdLines = header.pack_id_lines;
+  atlas->TexPixelsAlpha8 = static_cast<unsigned char*>(IM_ALLOC(pixels_size));
+  std::memcpy(atlas->TexPixelsAlpha8, &data[pos], pixels_size);
+
+  atlas->CustomRects.resize(static_cast<int>(header.num_custom_rects));
+  std::memcpy(atlas->CustomRects.Data, &data[custom_rects_offset],
+              sizeof(ImFontAtlasCustomRect) * header.num_custom_rects);
+  for (ImFontAtlasCustomRect& rect : atlas->CustomRects)
+    rect.Font = nullptr;
+
+  // equivalent of ImFontAtlasBuildSetupFont() and ImFontAtlasBuildFinish(), with the glyphs coming from the cache
+  for (u32 i = 0; i < header.num_fonts; i++)
+  {
+    FontAtlasFontHeader font_header;
+    std::memcpy(&font_header, &data[font_offsets[i]], sizeof(font_header));
+
+    ImFont* font = atlas->Fonts[i];
+    font->ClearOutputData();
+    font->ConfigData = nullptr;
+    font->ConfigDataCount = 0;
+    for (const ImFontConfig& cfg : atlas->ConfigData)
+    {
+      if (cfg.DstFont != font)
+        continue;
+
+      if (!font->ConfigData)
+        font->ConfigData = &cfg;
+      font->ConfigDataCount++;
+    }
+
+    font->FontSize = font->ConfigData ? font->ConfigData->SizePixels : 0.0f;
+    font->ContainerAtlas = atlas;
+    font->Ascent = font_header.ascent;
+    font->Descent = font_header.descent;
+    font->MetricsTotalSurface = font_header.metrics_total_surface;
+    font->Glyphs.resize(static_cast<int>(font_header.num_glyphs));
+    std::memcpy(font->Glyphs.Data, &data[font_offsets[i] + sizeof(font_header)],
+                sizeof(ImFontGlyph) * font_header.num_glyphs);
+    font->BuildLookupTable();
+  }
+
+  atlas->TexReady = true;
+  Log_DevPrintf("Loaded %ux%u font atlas from cache", header.tex_width, header.tex_height);
+  return true;
+}
+
+void ImGuiManager::AddCachedFontAtlas(u64 key, std::vector<u8> data)
+{
+  if (s_cached_font_atlases.size() == MAX_CACHED_FONT_ATLASES)
+    s_cached_font_atlases.erase(s_cached_font_atlases.begin());
+
+  s_cached_font_atlases.push_back(CachedFontAtlas{key, std::move(data)});
 }
 
 bool ImGuiManager::AddFullscreenFontsIfMissing()
@@ -549,114 +914,147 @@ bool ImGuiManager::HasFullscreenFonts()
 
 struct OSDMessage
 {
-  std::string key;
-  std::string text;
+  TinyString key;
+  SmallString text;
   std::chrono::steady_clock::time_point time;
   float duration;
+
+  // size of the wrapped text, only measured again when the text, font or wrap width changes
+  ImVec2 text_size;
+  float text_layout_width;
+  float text_layout_font_size;
 };
 
-static std::deque<OSDMessage> s_osd_active_messages;
-static std::deque<OSDMessage> s_osd_posted_messages;
+// Messages can be posted from any thread, they're handed to the render thread through a fixed ring, so posting a
+// message doesn't allocate. The oldest messages are dropped when either list is full, since there's only so many
+// which fit on screen anyway.
+static constexpr u32 MAX_POSTED_OSD_MESSAGES = 32;
+static constexpr u32 MAX_ACTIVE_OSD_MESSAGES = 32;
+static std::array<OSDMessage, MAX_POSTED_OSD_MESSAGES> s_osd_posted_messages;
+static u32 s_osd_posted_messages_start = 0;
+static std::atomic<u32> s_osd_posted_message_count{0};
 static std::mutex s_osd_messages_lock;
 
-void Host::AddOSDMessage(std::string message, float duration /*= 2.0f*/)
-{
-  AddKeyedOSDMessage(std::string(), std::move(message), duration);
-}
+// only touched by the render thread
+static std::array<OSDMessage, MAX_ACTIVE_OSD_MESSAGES> s_osd_active_messages;
+static u32 s_osd_active_message_count = 0;
 
-void Host::AddKeyedOSDMessage(std::string key, std::string message, float duration /* = 2.0f */)
+static void PostOSDMessage(std::string_view key, std::string_view text, float duration)
 {
-  OSDMessage msg;
-  msg.key = std::move(key);
-  msg.text = std::move(message);
+  ALLOCATION_TAG("OSDMessage");
+
+  std::unique_lock<std::mutex> lock(s_osd_messages_lock);
+  u32 count = s_osd_posted_message_count.load(std::memory_order_relaxed);
+  if (count == MAX_POSTED_OSD_MESSAGES)
+  {
+    s_osd_posted_messages_start = (s_osd_posted_messages_start + 1) % MAX_POSTED_OSD_MESSAGES;
+    count--;
+  }
+
+  OSDMessage& msg = s_osd_posted_messages[(s_osd_posted_messages_start + count) % MAX_POSTED_OSD_MESSAGES];
+  msg.key.Assign(key);
+  msg.text.Assign(text);
   msg.duration = duration;
   msg.time = std::chrono::steady_clock::now();
+  s_osd_posted_message_count.store(count + 1, std::memory_order_release);
+}
 
-  std::unique_lock<std::mutex> lock(s_osd_messages_lock);
-  s_osd_posted_messages.push_back(std::move(msg));
+void Host::AddOSDMessage(std::string_view message, float duration /*= 2.0f*/)
+{
+  PostOSDMessage(std::string_view(), message, duration);
+}
+
+void Host::AddKeyedOSDMessage(std::string_view key, std::string_view message, float duration /* = 2.0f */)
+{
+  PostOSDMessage(key, message, duration);
 }
 
 void Host::AddFormattedOSDMessage(float duration, const char* format, ...)
 {
+  SmallString text;
   std::va_list ap;
   va_start(ap, format);
-  std::string ret = StringUtil::StdStringFromFormatV(format, ap);
+  text.FormatVA(format, ap);
   va_end(ap);
-  return AddKeyedOSDMessage(std::string(), std::move(ret), duration);
+  PostOSDMessage(std::string_view(), text, duration);
 }
 
-void Host::AddIconOSDMessage(std::string key, const char* icon, std::string message, float duration /* = 2.0f */)
+void Host::AddIconOSDMessage(std::string_view key, const char* icon, std::string_view message,
+                             float duration /* = 2.0f */)
 {
-  return AddKeyedOSDMessage(std::move(key), fmt::format("{}  {}", icon, message), duration);
+  SmallString text;
+  fmt::format_to(std::back_inserter(text), "{}  {}", icon, message);
+  PostOSDMessage(key, text, duration);
 }
 
-void Host::AddKeyedFormattedOSDMessage(std::string key, float duration, const char* format, ...)
+void Host::AddKeyedFormattedOSDMessage(std::string_view key, float duration, const char* format, ...)
 {
+  SmallString text;
   std::va_list ap;
   va_start(ap, format);
-  std::string ret = StringUtil::StdStringFromFormatV(format, ap);
+  text.FormatVA(format, ap);
   va_end(ap);
-  return AddKeyedOSDMessage(std::move(key), std::move(ret), duration);
+  PostOSDMessage(key, text, duration);
 }
 
-void Host::RemoveKeyedOSDMessage(std::string key)
+void Host::RemoveKeyedOSDMessage(std::string_view key)
 {
-  OSDMessage msg;
-  msg.key = std::move(key);
-  msg.duration = 0.0f;
-  msg.time = std::chrono::steady_clock::now();
-
-  std::unique_lock<std::mutex> lock(s_osd_messages_lock);
-  s_osd_posted_messages.push_back(std::move(msg));
+  PostOSDMessage(key, std::string_view(), 0.0f);
 }
 
 void Host::ClearOSDMessages()
 {
   {
     std::unique_lock<std::mutex> lock(s_osd_messages_lock);
-    s_osd_posted_messages.clear();
+    s_osd_posted_message_count.store(0, std::memory_order_relaxed);
   }
 
-  s_osd_active_messages.clear();
+  s_osd_active_message_count = 0;
 }
 
 void ImGuiManager::AcquirePendingOSDMessages()
 {
-  std::atomic_thread_fence(std::memory_order_consume);
-  if (s_osd_posted_messages.empty())
+  if (s_osd_posted_message_count.load(std::memory_order_acquire) == 0)
     return;
 
   std::unique_lock lock(s_osd_messages_lock);
-  for (;;)
+  const u32 count = s_osd_posted_message_count.load(std::memory_order_relaxed);
+  for (u32 i = 0; i < count && g_settings.display_show_osd_messages; i++)
   {
-    if (s_osd_posted_messages.empty())
-      break;
-
-    if (g_settings.display_show_osd_messages)
+    const OSDMessage& new_msg = s_osd_posted_messages[(s_osd_posted_messages_start + i) % MAX_POSTED_OSD_MESSAGES];
+    OSDMessage* msg = nullptr;
+    if (!new_msg.key.IsEmpty())
     {
-      OSDMessage& new_msg = s_osd_posted_messages.front();
-      std::deque<OSDMessage>::iterator iter;
-      if (!new_msg.key.empty() && (iter = std::find_if(s_osd_active_messages.begin(), s_osd_active_messages.end(),
-                                                       [&new_msg](const OSDMessage& other) {
-                                                         return new_msg.key == other.key;
-                                                       })) != s_osd_active_messages.end())
+      for (u32 j = 0; j < s_osd_active_message_count; j++)
       {
-        iter->text = std::move(new_msg.text);
-        iter->duration = new_msg.duration;
-        iter->time = new_msg.time;
+        if (s_osd_active_messages[j].key == new_msg.key)
+        {
+          msg = &s_osd_active_messages[j];
+          break;
+        }
       }
-      else
+    }
+
+    if (!msg)
+    {
+      if (s_osd_active_message_count == MAX_ACTIVE_OSD_MESSAGES)
       {
-        s_osd_active_messages.push_back(std::move(new_msg));
+        std::copy(s_osd_active_messages.begin() + 1, s_osd_active_messages.end(), s_osd_active_messages.begin());
+        s_osd_active_message_count--;
       }
-    }
 
-    s_osd_posted_messages.pop_front();
+      msg = &s_osd_active_messages[s_osd_active_message_count++];
+      msg->key = new_msg.key;
+    }
 
-    static constexpr size_t MAX_ACTIVE_OSD_MESSAGES = 512;
-    if (s_osd_active_messages.size() > MAX_ACTIVE_OSD_MESSAGES)
-      s_osd_active_messages.pop_front();
+    msg->text = new_msg.text;
+    msg->duration = new_msg.duration;
+    msg->time = new_msg.time;
+    msg->text_layout_width = 0.0f;
   }
+
+  s_osd_posted_messages_start = (s_osd_posted_messages_start + count) % MAX_POSTED_OSD_MESSAGES;
+  s_osd_posted_message_count.store(0, std::memory_order_relaxed);
 }
 
 void ImGuiManager::DrawOSDMessages()
@@ -673,39 +1071,46 @@ void ImGuiManager::DrawOSDMessages()
 
   const auto now = std::chrono::steady_clock::now();
 
-  auto iter = s_osd_active_messages.begin();
-  while (iter != s_osd_active_messages.end())
+  // expired messages are removed in place, keeping the rest in order
+  u32 active_count = 0;
+  for (u32 i = 0; i < s_osd_active_message_count; i++)
   {
-    const OSDMessage& msg = *iter;
-    const double time = std::chrono::duration<double>(now - msg.time).count();
-    const float time_remaining = static_cast<float>(msg.duration - time);
+    const double time = std::chrono::duration<double>(now - s_osd_active_messages[i].time).count();
+    const float time_remaining = static_cast<float>(s_osd_active_messages[i].duration - time);
     if (time_remaining <= 0.0f)
-    {
-      iter = s_osd_active_messages.erase(iter);
       continue;
-    }
 
-    ++iter;
+    if (active_count != i)
+      s_osd_active_messages[active_count] = s_osd_active_messages[i];
+
+    OSDMessage& msg = s_osd_active_messages[active_count++];
+    if (position_y >= ImGui::GetIO().DisplaySize.y)
+      continue;
 
     const float opacity = std::min(time_remaining, 1.0f);
     const u32 alpha = static_cast<u32>(opacity * 255.0f);
 
-    if (position_y >= ImGui::GetIO().DisplaySize.y)
-      break;
+    if (msg.text_layout_width != max_width || msg.text_layout_font_size != font->FontSize)
+    {
+      msg.text_size = font->CalcTextSizeA(font->FontSize, max_width, max_width, msg.text.GetCharArray(),
+                                          msg.text.GetCharArray() + msg.text.GetLength());
+      msg.text_layout_width = max_width;
+      msg.text_layout_font_size = font->FontSize;
+    }
 
     const ImVec2 pos(position_x, position_y);
-    const ImVec2 text_size(font->CalcTextSizeA(font->FontSize, max_width, max_width, msg.text.c_str(),
-                                               msg.text.c_str() + msg.text.length()));
-    const ImVec2 size(text_size.x + padding * 2.0f, text_size.y + padding * 2.0f);
+    const ImVec2 size(msg.text_size.x + padding * 2.0f, msg.text_size.y + padding * 2.0f);
     const ImVec4 text_rect(pos.x + padding, pos.y + padding, pos.x + size.x - padding, pos.y + size.y - padding);
 
     ImDrawList* dl = ImGui::GetForegroundDrawList();
     dl->AddRectFilled(pos, ImVec2(pos.x + size.x, pos.y + size.y), IM_COL32(0x21, 0x21, 0x21, alpha), rounding);
     dl->AddRect(pos, ImVec2(pos.x + size.x, pos.y + size.y), IM_COL32(0x48, 0x48, 0x48, alpha), rounding);
     dl->AddText(font, font->FontSize, ImVec2(text_rect.x, text_rect.y), IM_COL32(0xff, 0xff, 0xff, alpha),
-                msg.text.c_str(), msg.text.c_str() + msg.text.length(), max_width, &text_rect);
+                msg.text.GetCharArray(), msg.text.GetCharArray() + msg.text.GetLength(), max_width, &text_rect);
     position_y += size.y + spacing;
   }
+
+  s_osd_active_message_count = active_count;
 }
 
 void ImGuiManager::RenderOSD()
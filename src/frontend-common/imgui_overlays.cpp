@@ -4,6 +4,7 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
 #include "common/timer.h"
 #include "common_host.h"
 #include "core/controller.h"
@@ -35,6 +36,8 @@ Log_SetChannel(ImGuiManager);
 
 namespace ImGuiManager {
 static void FormatProcessorStat(String& text, double usage, double time);
+static void FormatPercentileStat(String& text, System::FrameTimeCounter counter);
+static void DrawFrameTimeGraph(float& position_y, float margin, float spacing);
 static void DrawPerformanceOverlay();
 static void DrawEnhancementsOverlay();
 static void DrawInputsOverlay();
@@ -75,10 +78,49 @@ void ImGuiManager::FormatProcessorStat(String& text, double usage, double time)
     text.AppendFmtString("{:.1f}% ({:.2f}ms)", usage, time);
 }
 
+void ImGuiManager::FormatPercentileStat(String& text, System::FrameTimeCounter counter)
+{
+  text.AppendFmtString(" p99 {:.2f}ms", System::GetFrameTimePercentiles(counter).p99);
+}
+
+void ImGuiManager::DrawFrameTimeGraph(float& position_y, float margin, float spacing)
+{
+  const float scale = ImGuiManager::GetGlobalScale();
+  const float width = std::ceil(150.0f * scale);
+  const float height = std::ceil(50.0f * scale);
+  const float left = ImGui::GetIO().DisplaySize.x - margin - width;
+  const float top = position_y;
+
+  u32 pos;
+  const System::FrameTimeHistory& history = System::GetFrameTimeHistory(&pos);
+
+  // Scale to the slowest frame shown, but never below a 60hz frame so a steady game reads as a flat line.
+  float max_time = 1000.0f / 60.0f;
+  for (const float time : history)
+    max_time = std::max(max_time, time);
+
+  ImDrawList* dl = ImGui::GetBackgroundDrawList();
+  dl->AddRectFilled(ImVec2(left, top), ImVec2(left + width, top + height), IM_COL32(0, 0, 0, 100));
+
+  const float bar_width = width / static_cast<float>(System::FRAME_TIME_HISTORY_SIZE);
+  const float target_time = 1000.0f / System::GetThrottleFrequency();
+  for (u32 i = 0; i < System::FRAME_TIME_HISTORY_SIZE; i++)
+  {
+    const float time = history[(pos + i) % System::FRAME_TIME_HISTORY_SIZE];
+    const float x = left + static_cast<float>(i) * bar_width;
+    const float bar_height = std::min(time / max_time, 1.0f) * height;
+    const ImU32 color = (time > target_time * 1.5f) ? IM_COL32(255, 100, 100, 255) : IM_COL32(100, 255, 100, 255);
+    dl->AddRectFilled(ImVec2(x, top + height - bar_height), ImVec2(x + std::max(bar_width, 1.0f), top + height),
+                      color);
+  }
+
+  position_y += height + spacing;
+}
+
 void ImGuiManager::DrawPerformanceOverlay()
 {
   if (!(g_settings.display_show_fps || g_settings.display_show_speed || g_settings.display_show_resolution ||
-        g_settings.display_show_cpu ||
+        g_settings.display_show_cpu || g_settings.display_show_input_latency ||
         (g_settings.display_show_status_indicators &&
          (System::IsPaused() || System::IsFastForwardEnabled() || System::IsTurboEnabled()))))
   {
@@ -160,6 +202,12 @@ void ImGuiManager::DrawPerformanceOverlay()
       text.AppendFmtString("{:.2f}ms ({:.2f}ms worst)", System::GetAverageFrameTime(), System::GetWorstFrameTime());
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
 
+      const System::FrameTimePercentiles frame_pct = System::GetFrameTimePercentiles(System::FrameTimeCounter::Frame);
+      text.Fmt("p50 {:.2f} | p95 {:.2f} | p99 {:.2f}ms", frame_pct.p50, frame_pct.p95, frame_pct.p99);
+      DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      DrawFrameTimeGraph(position_y, margin, spacing);
+
       text.Clear();
       if (g_settings.cpu_overclock_active || (!g_settings.IsUsingRecompiler() || g_settings.cpu_recompiler_icache ||
                                               g_settings.cpu_recompiler_memory_exceptions))
@@ -202,12 +250,14 @@ void ImGuiManager::DrawPerformanceOverlay()
         text.Assign("CPU: ");
       }
       FormatProcessorStat(text, System::GetCPUThreadUsage(), System::GetCPUThreadAverageTime());
+      FormatPercentileStat(text, System::FrameTimeCounter::CPUThread);
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
 
       if (g_gpu->GetSWThread())
       {
         text.Assign("SW: ");
         FormatProcessorStat(text, System::GetSWThreadUsage(), System::GetSWThreadAverageTime());
+        FormatPercentileStat(text, System::FrameTimeCounter::SWThread);
         DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
       }
 
@@ -226,7 +276,38 @@ void ImGuiManager::DrawPerformanceOverlay()
     {
       text.Assign("GPU: ");
       FormatProcessorStat(text, System::GetGPUUsage(), System::GetGPUAverageTime());
+      FormatPercentileStat(text, System::FrameTimeCounter::GPU);
       DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      // per-pass breakdown, skipping passes which didn't run
+      for (u32 i = 0; i < HostDisplay::NUM_GPU_TIMING_SECTIONS; i++)
+      {
+        const float section_time = System::GetGPUAverageSectionTime(i);
+        if (section_time < 0.005f)
+          continue;
+
+        text.Fmt(" {}: {:.2f}ms", HostDisplay::GetGPUTimingSectionName(i), section_time);
+        DRAW_LINE(fixed_font, text, IM_COL32(200, 200, 200, 255));
+      }
+    }
+
+    if (g_settings.display_show_input_latency)
+    {
+      const System::FrameTimePercentiles read_pct =
+        System::GetFrameTimePercentiles(System::FrameTimeCounter::InputRead);
+      const System::FrameTimePercentiles total_pct =
+        System::GetFrameTimePercentiles(System::FrameTimeCounter::InputLatency);
+      text.Fmt("Input: p50 {:.1f} | p95 {:.1f} | p99 {:.1f}ms", total_pct.p50, total_pct.p95, total_pct.p99);
+      DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      text.Fmt(" Read: p50 {:.1f} | p95 {:.1f}ms", read_pct.p50, read_pct.p95);
+      DRAW_LINE(fixed_font, text, IM_COL32(200, 200, 200, 255));
+
+      // solid block in the corner on the frame which completes the input, for camera-based measurement
+      if (g_settings.display_input_latency_flash && System::IsInputLatencyPresentPending())
+      {
+        const float size = std::ceil(48.0f * scale);
+        dl->AddRectFilled(ImVec2(0.0f, 0.0f), ImVec2(size, size), IM_COL32(255, 255, 255, 255));
+      }
     }
 
     if (g_settings.display_show_status_indicators)
@@ -264,7 +345,9 @@ void ImGuiManager::DrawEnhancementsOverlay()
     text.AppendFormattedString(" CPU=%u%%", g_settings.GetCPUOverclockPercent());
   if (g_settings.enable_8mb_ram)
     text.AppendString(" 8MB");
-  if (g_settings.cdrom_read_speedup != 1)
+  if (g_settings.cdrom_read_speedup == 0)
+    text.AppendString(" CDR=Auto");
+  else if (g_settings.cdrom_read_speedup != 1)
     text.AppendFormattedString(" CDR=%ux", g_settings.cdrom_read_speedup);
   if (g_settings.cdrom_seek_speedup != 1)
     text.AppendFormattedString(" CDS=%ux", g_settings.cdrom_seek_speedup);
@@ -415,10 +498,22 @@ struct ListEntry
   std::unique_ptr<GPUTexture> preview_texture;
   s32 slot;
   bool global;
+  bool loading;
 };
 
+struct CachedStateInfo
+{
+  std::time_t modification_time;
+  s64 size;
+  std::optional<ExtendedSaveStateInfo> ssi;
+};
+
+static void AddListEntry(std::string path, s32 slot, bool global);
+static void LoadStateInfo(std::string path);
+static void ApplyLoadedStateInfo();
 static void InitializePlaceholderListEntry(ListEntry* li, std::string path, s32 slot, bool global);
-static void InitializeListEntry(ListEntry* li, ExtendedSaveStateInfo* ssi, std::string path, s32 slot, bool global);
+static void InitializeListEntry(ListEntry* li, const ExtendedSaveStateInfo& ssi, std::string path, s32 slot,
+                                bool global);
 
 static void RefreshHotkeyLegend();
 
@@ -432,6 +527,14 @@ static u32 s_current_selection = 0;
 
 static Common::Timer s_open_timer;
 static float s_open_time = 0.0f;
+
+// Opening every state and decompressing its screenshot is slow on some storage, so slots are read in the background
+// and cached until the file changes.
+static std::mutex s_state_info_mutex;
+static std::unordered_map<std::string, CachedStateInfo> s_state_info_cache;
+static bool s_state_info_loaded = false;
+static Threading::ThreadPool::TaskGroup s_state_info_group;
+static Threading::CancellationToken s_state_info_token;
 } // namespace SaveStateSelectorUI
 
 void SaveStateSelectorUI::Open(float open_time /* = DEFAULT_OPEN_TIME */)
@@ -460,6 +563,10 @@ void SaveStateSelectorUI::Close(bool reset_slot)
 
 void SaveStateSelectorUI::RefreshList()
 {
+  // loads for the previous list are still cached when they complete, but don't need to hold up this one
+  s_state_info_token.Cancel();
+  s_state_info_token = Threading::CancellationToken();
+
   s_slots.clear();
   if (System::IsShutdown())
     return;
@@ -467,42 +574,102 @@ void SaveStateSelectorUI::RefreshList()
   if (!System::GetRunningSerial().empty())
   {
     for (s32 i = 1; i <= System::PER_GAME_SAVE_STATE_SLOTS; i++)
-    {
-      std::string path(System::GetGameSaveStateFileName(System::GetRunningSerial(), i));
-      std::optional<ExtendedSaveStateInfo> ssi = System::GetExtendedSaveStateInfo(path.c_str());
+      AddListEntry(System::GetGameSaveStateFileName(System::GetRunningSerial(), i), i, false);
+  }
+
+  for (s32 i = 1; i <= System::GLOBAL_SAVE_STATE_SLOTS; i++)
+    AddListEntry(System::GetGlobalSaveStateFileName(i), i, true);
+
+  if (s_slots.empty() || s_current_selection >= s_slots.size())
+    s_current_selection = 0;
+}
+
+void SaveStateSelectorUI::AddListEntry(std::string path, s32 slot, bool global)
+{
+  ListEntry li;
+
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(path.c_str(), &sd))
+  {
+    InitializePlaceholderListEntry(&li, std::move(path), slot, global);
+    s_slots.push_back(std::move(li));
+    return;
+  }
 
-      ListEntry li;
-      if (ssi)
-        InitializeListEntry(&li, &ssi.value(), std::move(path), i, false);
+  {
+    std::unique_lock lock(s_state_info_mutex);
+    const auto iter = s_state_info_cache.find(path);
+    if (iter != s_state_info_cache.end() && iter->second.modification_time == sd.ModificationTime &&
+        iter->second.size == sd.Size)
+    {
+      if (iter->second.ssi.has_value())
+        InitializeListEntry(&li, iter->second.ssi.value(), std::move(path), slot, global);
       else
-        InitializePlaceholderListEntry(&li, std::move(path), i, false);
+        InitializePlaceholderListEntry(&li, std::move(path), slot, global);
 
       s_slots.push_back(std::move(li));
+      return;
     }
   }
 
-  for (s32 i = 1; i <= System::GLOBAL_SAVE_STATE_SLOTS; i++)
+  InitializePlaceholderListEntry(&li, path, slot, global);
+  li.title = Host::TranslateStdString("SaveStateSelectorUI", "Loading...");
+  li.loading = true;
+  s_slots.push_back(std::move(li));
+
+  Threading::ThreadPool::GetShared().Submit([path = std::move(path)]() mutable { LoadStateInfo(std::move(path)); },
+                                            Threading::ThreadPool::Priority::Low, &s_state_info_group,
+                                            &s_state_info_token);
+}
+
+void SaveStateSelectorUI::LoadStateInfo(std::string path)
+{
+  // this waits for any pending write to the state, so stat afterwards to key the cache on the final file
+  std::optional<ExtendedSaveStateInfo> ssi = System::GetExtendedSaveStateInfo(path.c_str());
+
+  FILESYSTEM_STAT_DATA sd;
+  const bool exists = FileSystem::StatFile(path.c_str(), &sd);
+
+  std::unique_lock lock(s_state_info_mutex);
+  if (exists)
+    s_state_info_cache[std::move(path)] = CachedStateInfo{sd.ModificationTime, sd.Size, std::move(ssi)};
+  else
+    s_state_info_cache.erase(path);
+
+  s_state_info_loaded = true;
+}
+
+void SaveStateSelectorUI::ApplyLoadedStateInfo()
+{
+  // textures have to be created on this thread, so the list is only updated here
+  std::unique_lock lock(s_state_info_mutex);
+  if (!s_state_info_loaded)
+    return;
+
+  s_state_info_loaded = false;
+  for (ListEntry& li : s_slots)
   {
-    std::string path(System::GetGlobalSaveStateFileName(i));
-    std::optional<ExtendedSaveStateInfo> ssi = System::GetExtendedSaveStateInfo(path.c_str());
+    if (!li.loading)
+      continue;
 
-    ListEntry li;
-    if (ssi)
-      InitializeListEntry(&li, &ssi.value(), std::move(path), i, true);
-    else
-      InitializePlaceholderListEntry(&li, std::move(path), i, true);
+    const auto iter = s_state_info_cache.find(li.path);
+    if (iter == s_state_info_cache.end())
+      continue;
 
-    s_slots.push_back(std::move(li));
+    if (iter->second.ssi.has_value())
+      InitializeListEntry(&li, iter->second.ssi.value(), std::move(li.path), li.slot, li.global);
+    else
+      InitializePlaceholderListEntry(&li, std::move(li.path), li.slot, li.global);
   }
-
-  if (s_slots.empty() || s_current_selection >= s_slots.size())
-    s_current_selection = 0;
 }
 
 void SaveStateSelectorUI::DestroyTextures()
 {
   Close();
 
+  s_state_info_token.Cancel();
+  s_state_info_group.Wait(Threading::ThreadPool::GetShared());
+
   for (ListEntry& entry : s_slots)
     entry.preview_texture.reset();
 }
@@ -549,26 +716,27 @@ void SaveStateSelectorUI::SelectPreviousSlot()
     (s_current_selection == 0) ? (static_cast<u32>(s_slots.size()) - 1u) : (s_current_selection - 1);
 }
 
-void SaveStateSelectorUI::InitializeListEntry(ListEntry* li, ExtendedSaveStateInfo* ssi, std::string path, s32 slot,
-                                              bool global)
+void SaveStateSelectorUI::InitializeListEntry(ListEntry* li, const ExtendedSaveStateInfo& ssi, std::string path,
+                                              s32 slot, bool global)
 {
-  li->title = std::move(ssi->title);
-  li->serial = std::move(ssi->serial);
+  li->title = ssi.title;
+  li->serial = ssi.serial;
   li->path = std::move(path);
-  li->formatted_timestamp = fmt::format("{:%c}", fmt::localtime(ssi->timestamp));
+  li->formatted_timestamp = fmt::format("{:%c}", fmt::localtime(ssi.timestamp));
   li->slot = slot;
   li->global = global;
+  li->loading = false;
 
   li->preview_texture.reset();
 
   // Might not have a display yet, we're called at startup..
   if (g_host_display)
   {
-    if (ssi && !ssi->screenshot_data.empty())
+    if (!ssi.screenshot_data.empty())
     {
       li->preview_texture =
-        g_host_display->CreateTexture(ssi->screenshot_width, ssi->screenshot_height, 1, 1, 1, GPUTexture::Format::RGBA8,
-                                      ssi->screenshot_data.data(), sizeof(u32) * ssi->screenshot_width, false);
+        g_host_display->CreateTexture(ssi.screenshot_width, ssi.screenshot_height, 1, 1, 1, GPUTexture::Format::RGBA8,
+                                      ssi.screenshot_data.data(), sizeof(u32) * ssi.screenshot_width, false);
     }
     else
     {
@@ -590,6 +758,7 @@ void SaveStateSelectorUI::InitializePlaceholderListEntry(ListEntry* li, std::str
   std::string().swap(li->formatted_timestamp);
   li->slot = slot;
   li->global = global;
+  li->loading = false;
 
   if (g_host_display)
   {
@@ -603,6 +772,8 @@ void SaveStateSelectorUI::InitializePlaceholderListEntry(ListEntry* li, std::str
 
 void SaveStateSelectorUI::Draw()
 {
+  ApplyLoadedStateInfo();
+
   const float framebuffer_scale = ImGui::GetIO().DisplayFramebufferScale.x;
   const float window_width = ImGui::GetIO().DisplaySize.x * (2.0f / 3.0f);
   const float window_height = ImGui::GetIO().DisplaySize.y * 0.5f;
@@ -720,6 +891,12 @@ void SaveStateSelectorUI::SaveCurrentSlot()
   if (s_slots.empty() || s_current_selection >= s_slots.size() || s_slots[s_current_selection].path.empty())
     return;
 
+  // the write happens in the background, so don't let a refresh before it finishes match the old file
+  {
+    std::unique_lock lock(s_state_info_mutex);
+    s_state_info_cache.erase(s_slots[s_current_selection].path);
+  }
+
   System::SaveState(s_slots[s_current_selection].path.c_str(), g_settings.create_save_state_backups);
   Close();
 }
@@ -51,6 +51,7 @@ struct InputBinding
   u8 num_keys = 0;
   u8 full_mask = 0;
   u8 current_mask = 0;
+  bool pad_binding = false;
 };
 
 struct PadVibrationBinding
@@ -76,6 +77,21 @@ struct PadVibrationBinding
   }
 };
 
+/// Binding which is fired by a key, and which of its chord keys that is.
+struct BindingDispatchEntry
+{
+  InputBinding* binding;
+  u32 key_index;
+};
+
+/// Slot in the open-addressed dispatch table, pointing to a contiguous run of entries. Unused when count is zero.
+struct BindingDispatchSlot
+{
+  InputBindingKey key;
+  u32 first_entry;
+  u32 num_entries;
+};
+
 struct MacroButton
 {
   std::vector<u32> buttons; ///< Buttons to activate.
@@ -98,7 +114,14 @@ static std::optional<InputBindingKey> ParseSensorKey(const std::string_view& sou
 
 static std::vector<std::string_view> SplitChord(const std::string_view& binding);
 static bool SplitBinding(const std::string_view& binding, std::string_view* source, std::string_view* sub_binding);
-static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler);
+static void AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                        bool pad_binding = false);
+static std::shared_ptr<InputBinding> CreateBinding(const std::string_view& binding, const InputEventHandler& handler);
+static void CompileBindingDispatchTable();
+static u32 GetBindingDispatchSlotIndex(InputBindingKey masked_key);
+static const BindingDispatchSlot* FindBindingDispatchSlot(InputBindingKey masked_key);
+static bool CanInvokeEventsDuringControllerRead(InputBindingKey key);
+static void InvokeDeferredEvents();
 
 static bool IsAxisHandler(const InputEventHandler& handler);
 
@@ -128,6 +151,23 @@ static BindingMap s_binding_map;
 static VibrationBindingArray s_pad_vibration_array;
 static std::mutex s_binding_map_write_lock;
 
+// The binding map is compiled into a flat table whenever it changes, so dispatching an event is a single probe and a
+// walk over contiguous entries, rather than hashing into and chasing the nodes of the multimap.
+static std::vector<BindingDispatchSlot> s_binding_dispatch_slots;
+static std::vector<BindingDispatchEntry> s_binding_dispatch_entries;
+static u32 s_binding_dispatch_shift = 64;
+
+// Events received while polling during a controller read, which can't be processed mid-frame.
+struct DeferredEvent
+{
+  InputBindingKey key;
+  float value;
+  GenericInputBinding generic_key;
+};
+static std::vector<DeferredEvent> s_deferred_events;
+static bool s_polling_for_controller_read = false;
+static u64 s_last_controller_read_poll_time = 0;
+
 // Hooks/intercepting (for setting bindings)
 static std::mutex m_event_intercept_mutex;
 static InputInterceptHook::Callback m_event_intercept_callback;
@@ -329,13 +369,36 @@ std::string InputManager::ConvertInputBindingKeysToString(const InputBindingKey*
   return ss.str();
 }
 
-void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler)
+void InputManager::AddBindings(const std::vector<std::string>& bindings, const InputEventHandler& handler,
+                               bool pad_binding /* = false */)
 {
   for (const std::string& binding : bindings)
-    AddBinding(binding, handler);
+  {
+    std::shared_ptr<InputBinding> ibinding(CreateBinding(binding, handler));
+    if (!ibinding)
+      continue;
+
+    ibinding->pad_binding = pad_binding;
+    for (u32 i = 0; i < ibinding->num_keys; i++)
+      s_binding_map.emplace(ibinding->keys[i].MaskDirection(), ibinding);
+  }
 }
 
 void InputManager::AddBinding(const std::string_view& binding, const InputEventHandler& handler)
+{
+  std::shared_ptr<InputBinding> ibinding(CreateBinding(binding, handler));
+  if (!ibinding)
+    return;
+
+  // plop it in the input map for all the keys
+  for (u32 i = 0; i < ibinding->num_keys; i++)
+    s_binding_map.emplace(ibinding->keys[i].MaskDirection(), ibinding);
+
+  CompileBindingDispatchTable();
+}
+
+std::shared_ptr<InputBinding> InputManager::CreateBinding(const std::string_view& binding,
+                                                          const InputEventHandler& handler)
 {
   std::shared_ptr<InputBinding> ibinding;
   const std::vector<std::string_view> chord_bindings(SplitChord(binding));
@@ -369,12 +432,7 @@ void InputManager::AddBinding(const std::string_view& binding, const InputEventH
     ibinding->num_keys++;
   }
 
-  if (!ibinding)
-    return;
-
-  // plop it in the input map for all the keys
-  for (u32 i = 0; i < ibinding->num_keys; i++)
-    s_binding_map.emplace(ibinding->keys[i].MaskDirection(), ibinding);
+  return ibinding;
 }
 
 void InputManager::AddVibrationBinding(u32 pad_index, const InputBindingKey* motor_0_binding,
@@ -629,9 +687,16 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
                       return;
 
                     Controller* c = System::GetController(pad_index);
-                    if (c)
-                      c->SetBindState(bind_index, value);
-                  }});
+                    if (!c)
+                      return;
+
+                    // only track presses, axis updates while held would never measure anything new
+                    if (g_settings.display_show_input_latency && value >= 0.5f && c->GetBindState(bind_index) < 0.5f)
+                      System::OnInputLatencyEventReceived();
+
+                    c->SetBindState(bind_index, value);
+                  }},
+                  true);
     }
   }
 
@@ -646,7 +711,8 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
                       return;
 
                     SetMacroButtonState(pad_index, macro_button_index, state);
-                  }});
+                  }},
+                  true);
     }
   }
 
@@ -687,10 +753,67 @@ void InputManager::AddPadBindings(SettingsInterface& si, const std::string& sect
 // Event Handling
 // ------------------------------------------------------------------------
 
+void InputManager::CompileBindingDispatchTable()
+{
+  s_binding_dispatch_entries.clear();
+  s_binding_dispatch_entries.reserve(s_binding_map.size());
+
+  // Keep the table at most half full, so probes stay short and always terminate.
+  u32 table_bits = 4;
+  while ((1u << table_bits) < (s_binding_map.size() * 2))
+    table_bits++;
+
+  s_binding_dispatch_shift = 64 - table_bits;
+  s_binding_dispatch_slots.assign(1u << table_bits, BindingDispatchSlot{});
+
+  // Equivalent keys are adjacent when iterating an unordered_multimap, so each key's entries form one run.
+  for (auto it = s_binding_map.begin(); it != s_binding_map.end();)
+  {
+    const InputBindingKey masked_key = it->first;
+    BindingDispatchSlot& slot = s_binding_dispatch_slots[GetBindingDispatchSlotIndex(masked_key)];
+    slot.key = masked_key;
+    slot.first_entry = static_cast<u32>(s_binding_dispatch_entries.size());
+
+    for (; it != s_binding_map.end() && it->first == masked_key; ++it)
+    {
+      // find the key which matches us, we shouldn't have the same key twice in the chord
+      InputBinding* binding = it->second.get();
+      const u32 last_key_index = static_cast<u32>(binding->num_keys - 1);
+      u32 key_index = 0;
+      while (key_index < last_key_index && binding->keys[key_index].MaskDirection() != masked_key)
+        key_index++;
+
+      s_binding_dispatch_entries.push_back(BindingDispatchEntry{binding, key_index});
+    }
+
+    slot.num_entries = static_cast<u32>(s_binding_dispatch_entries.size()) - slot.first_entry;
+  }
+}
+
+u32 InputManager::GetBindingDispatchSlotIndex(InputBindingKey masked_key)
+{
+  // Fibonacci hashing, the interesting bits of keys are spread across the whole 64-bit value.
+  const u32 mask = static_cast<u32>(s_binding_dispatch_slots.size()) - 1;
+  u32 index = static_cast<u32>((masked_key.bits * UINT64_C(0x9E3779B97F4A7C15)) >> s_binding_dispatch_shift);
+  while (s_binding_dispatch_slots[index].num_entries != 0 && s_binding_dispatch_slots[index].key != masked_key)
+    index = (index + 1) & mask;
+
+  return index;
+}
+
+const BindingDispatchSlot* InputManager::FindBindingDispatchSlot(InputBindingKey masked_key)
+{
+  if (s_binding_dispatch_slots.empty())
+    return nullptr;
+
+  const BindingDispatchSlot& slot = s_binding_dispatch_slots[GetBindingDispatchSlotIndex(masked_key)];
+  return (slot.num_entries != 0) ? &slot : nullptr;
+}
+
 bool InputManager::HasAnyBindingsForKey(InputBindingKey key)
 {
   std::unique_lock lock(s_binding_map_write_lock);
-  return (s_binding_map.find(key.MaskDirection()) != s_binding_map.end());
+  return (FindBindingDispatchSlot(key.MaskDirection()) != nullptr);
 }
 
 bool InputManager::HasAnyBindingsForSource(InputBindingKey key)
@@ -714,8 +837,34 @@ bool InputManager::IsAxisHandler(const InputEventHandler& handler)
   return std::holds_alternative<InputAxisEventHandler>(handler);
 }
 
+bool InputManager::CanInvokeEventsDuringControllerRead(InputBindingKey key)
+{
+  if (HasHook())
+    return false;
+
+  // Only single-key pad bindings are safe, hotkeys and chords can change emulator state or cancel other bindings.
+  const BindingDispatchSlot* slot = FindBindingDispatchSlot(key.MaskDirection());
+  if (!slot)
+    return true;
+
+  for (u32 i = 0; i < slot->num_entries; i++)
+  {
+    const InputBinding* binding = s_binding_dispatch_entries[slot->first_entry + i].binding;
+    if (!binding->pad_binding || binding->num_keys > 1)
+      return false;
+  }
+
+  return true;
+}
+
 bool InputManager::InvokeEvents(InputBindingKey key, float value, GenericInputBinding generic_key)
 {
+  if (s_polling_for_controller_read && !CanInvokeEventsDuringControllerRead(key))
+  {
+    s_deferred_events.push_back(DeferredEvent{key, value, generic_key});
+    return true;
+  }
+
   if (DoEventHook(key, value))
     return true;
 
@@ -724,92 +873,83 @@ bool InputManager::InvokeEvents(InputBindingKey key, float value, GenericInputBi
 
   // find all the bindings associated with this key
   const InputBindingKey masked_key = key.MaskDirection();
-  const auto range = s_binding_map.equal_range(masked_key);
-  if (range.first == s_binding_map.end())
+  const BindingDispatchSlot* slot = FindBindingDispatchSlot(masked_key);
+  if (!slot)
     return false;
 
   // Now we can actually fire/activate bindings.
   u32 min_num_keys = 0;
-  for (auto it = range.first; it != range.second; ++it)
+  for (u32 entry = 0; entry < slot->num_entries; entry++)
   {
-    InputBinding* binding = it->second.get();
-
-    // find the key which matches us
-    for (u32 i = 0; i < binding->num_keys; i++)
+    const BindingDispatchEntry& dentry = s_binding_dispatch_entries[slot->first_entry + entry];
+    InputBinding* binding = dentry.binding;
+    const u32 i = dentry.key_index;
+    const u8 bit = static_cast<u8>(1) << i;
+    const bool negative = binding->keys[i].negative;
+    const bool new_state = (negative ? (value < 0.0f) : (value > 0.0f));
+
+    // invert if we're negative, since the handler expects 0..1
+    const float value_to_pass = (negative ? ((value < 0.0f) ? -value : 0.0f) : (value > 0.0f) ? value : 0.0f);
+
+    // axes are fired regardless of a state change, unless they're zero
+    // (but going from not-zero to zero will still fire, because of the full state)
+    // for buttons, we can use the state of the last chord key, because it'll be 1 on press,
+    // and 0 on release (when the full state changes).
+    if (IsAxisHandler(binding->handler))
     {
-      if (binding->keys[i].MaskDirection() != masked_key)
-        continue;
-
-      const u8 bit = static_cast<u8>(1) << i;
-      const bool negative = binding->keys[i].negative;
-      const bool new_state = (negative ? (value < 0.0f) : (value > 0.0f));
-
-      // invert if we're negative, since the handler expects 0..1
-      const float value_to_pass = (negative ? ((value < 0.0f) ? -value : 0.0f) : (value > 0.0f) ? value : 0.0f);
-
-      // axes are fired regardless of a state change, unless they're zero
-      // (but going from not-zero to zero will still fire, because of the full state)
-      // for buttons, we can use the state of the last chord key, because it'll be 1 on press,
-      // and 0 on release (when the full state changes).
-      if (IsAxisHandler(binding->handler))
-      {
-        if (value_to_pass >= 0.0f)
-          std::get<InputAxisEventHandler>(binding->handler)(value_to_pass);
-      }
-      else if (binding->num_keys >= min_num_keys)
+      if (value_to_pass >= 0.0f)
+        std::get<InputAxisEventHandler>(binding->handler)(value_to_pass);
+    }
+    else if (binding->num_keys >= min_num_keys)
+    {
+      // update state based on whether the whole chord was activated
+      const u8 new_mask = (new_state ? (binding->current_mask | bit) : (binding->current_mask & ~bit));
+      const bool prev_full_state = (binding->current_mask == binding->full_mask);
+      const bool new_full_state = (new_mask == binding->full_mask);
+      binding->current_mask = new_mask;
+
+      // Workaround for multi-key bindings that share the same keys.
+      if (binding->num_keys > 1 && new_full_state && prev_full_state != new_full_state)
       {
-        // update state based on whether the whole chord was activated
-        const u8 new_mask = (new_state ? (binding->current_mask | bit) : (binding->current_mask & ~bit));
-        const bool prev_full_state = (binding->current_mask == binding->full_mask);
-        const bool new_full_state = (new_mask == binding->full_mask);
-        binding->current_mask = new_mask;
-
-        // Workaround for multi-key bindings that share the same keys.
-        if (binding->num_keys > 1 && new_full_state && prev_full_state != new_full_state && range.first != range.second)
+        // Because the binding map isn't ordered, we could iterate in the order of Shift+F1 and then
+        // F1, which would mean that F1 wouldn't get cancelled and still activate. So, to handle this
+        // case, we skip activating any future bindings with a fewer number of keys.
+        min_num_keys = std::max<u32>(min_num_keys, binding->num_keys);
+
+        // Basically, if we bind say, F1 and Shift+F1, and press shift and then F1, we'll fire bindings
+        // for both F1 and Shift+F1, when we really only want to fire the binding for Shift+F1. So,
+        // when we activate a multi-key chord (key press), we go through the binding map for all the
+        // other keys in the chord, and cancel them if they have a shorter chord. If they're longer,
+        // they could still activate and take precedence over us, so we leave them alone.
+        for (u32 j = 0; j < binding->num_keys; j++)
         {
-          // Because the binding map isn't ordered, we could iterate in the order of Shift+F1 and then
-          // F1, which would mean that F1 wouldn't get cancelled and still activate. So, to handle this
-          // case, we skip activating any future bindings with a fewer number of keys.
-          min_num_keys = std::max<u32>(min_num_keys, binding->num_keys);
-
-          // Basically, if we bind say, F1 and Shift+F1, and press shift and then F1, we'll fire bindings
-          // for both F1 and Shift+F1, when we really only want to fire the binding for Shift+F1. So,
-          // when we activate a multi-key chord (key press), we go through the binding map for all the
-          // other keys in the chord, and cancel them if they have a shorter chord. If they're longer,
-          // they could still activate and take precedence over us, so we leave them alone.
-          for (u32 j = 0; j < binding->num_keys; j++)
+          const BindingDispatchSlot* other_slot = FindBindingDispatchSlot(binding->keys[j].MaskDirection());
+          for (u32 other_entry = 0; other_slot && other_entry < other_slot->num_entries; other_entry++)
           {
-            const auto range2 = s_binding_map.equal_range(binding->keys[j].MaskDirection());
-            for (auto it2 = range2.first; it2 != range2.second; ++it2)
+            InputBinding* other_binding = s_binding_dispatch_entries[other_slot->first_entry + other_entry].binding;
+            if (other_binding == binding || IsAxisHandler(other_binding->handler) ||
+                other_binding->num_keys >= binding->num_keys)
             {
-              InputBinding* other_binding = it2->second.get();
-              if (other_binding == binding || IsAxisHandler(other_binding->handler) ||
-                  other_binding->num_keys >= binding->num_keys)
-              {
-                continue;
-              }
-
-              // We only need to cancel the binding if it was fully active before. Which in the above
-              // case of Shift+F1 / F1, it will be.
-              if (other_binding->current_mask == other_binding->full_mask)
-                std::get<InputButtonEventHandler>(other_binding->handler)(-1);
-
-              // Zero out the current bits so that we don't release this binding, if the other part
-              // of the chord releases first.
-              other_binding->current_mask = 0;
+              continue;
             }
-          }
-        }
 
-        if (prev_full_state != new_full_state && binding->num_keys >= min_num_keys)
-        {
-          const s32 pressed = skip_button_handlers ? -1 : static_cast<s32>(value_to_pass > 0.0f);
-          std::get<InputButtonEventHandler>(binding->handler)(pressed);
+            // We only need to cancel the binding if it was fully active before. Which in the above
+            // case of Shift+F1 / F1, it will be.
+            if (other_binding->current_mask == other_binding->full_mask)
+              std::get<InputButtonEventHandler>(other_binding->handler)(-1);
+
+            // Zero out the current bits so that we don't release this binding, if the other part
+            // of the chord releases first.
+            other_binding->current_mask = 0;
+          }
         }
       }
 
-      // bail out, since we shouldn't have the same key twice in the chord
-      break;
+      if (prev_full_state != new_full_state && binding->num_keys >= min_num_keys)
+      {
+        const s32 pressed = skip_button_handlers ? -1 : static_cast<s32>(value_to_pass > 0.0f);
+        std::get<InputButtonEventHandler>(binding->handler)(pressed);
+      }
     }
   }
 
@@ -1356,6 +1496,8 @@ void InputManager::ReloadBindings(SettingsInterface& si, SettingsInterface& bind
   std::unique_lock lock(s_binding_map_write_lock);
 
   s_binding_map.clear();
+  s_binding_dispatch_slots.clear();
+  s_binding_dispatch_entries.clear();
   s_pad_vibration_array.clear();
 
   // Hotkeys use the base configuration, except if the custom hotkeys option is enabled.
@@ -1375,6 +1517,8 @@ void InputManager::ReloadBindings(SettingsInterface& si, SettingsInterface& bind
     LoadMacroButtonConfig(binding_si, section, pad, cinfo);
   }
 
+  CompileBindingDispatchTable();
+
   for (u32 axis = 0; axis < static_cast<u32>(InputPointerAxis::Count); axis++)
   {
     // From lilypad: 1 mouse pixel = 1/8th way down.
@@ -1575,6 +1719,8 @@ void InputManager::CloseSources()
 
 void InputManager::PollSources()
 {
+  InvokeDeferredEvents();
+
   for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
   {
     if (s_input_sources[i])
@@ -1591,6 +1737,41 @@ void InputManager::PollSources()
   }
 }
 
+void InputManager::PollSourcesForControllerRead()
+{
+  if (!g_settings.controller_poll_input_on_read || s_polling_for_controller_read)
+    return;
+
+  const u64 current_time = Common::Timer::GetCurrentValue();
+  const u64 interval_ns = static_cast<u64>(g_settings.controller_poll_input_interval_us) * 1000u;
+  const u64 interval = Common::Timer::ConvertNanosecondsToValue(static_cast<double>(interval_ns));
+  if ((current_time - s_last_controller_read_poll_time) < interval)
+    return;
+
+  s_last_controller_read_poll_time = current_time;
+  s_polling_for_controller_read = true;
+
+  for (u32 i = FIRST_EXTERNAL_INPUT_SOURCE; i < LAST_EXTERNAL_INPUT_SOURCE; i++)
+  {
+    if (s_input_sources[i])
+      s_input_sources[i]->PollEvents();
+  }
+
+  s_polling_for_controller_read = false;
+}
+
+void InputManager::InvokeDeferredEvents()
+{
+  if (s_deferred_events.empty())
+    return;
+
+  // handlers could poll again, so take ownership of the list first
+  std::vector<DeferredEvent> events(std::move(s_deferred_events));
+  s_deferred_events.clear();
+  for (const DeferredEvent& event : events)
+    InvokeEvents(event.key, event.value, event.generic_key);
+}
+
 std::vector<std::pair<std::string, std::string>> InputManager::EnumerateDevices()
 {
   std::vector<std::pair<std::string, std::string>> ret;
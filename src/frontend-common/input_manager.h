@@ -234,6 +234,10 @@ void CloseSources();
 /// Polls input sources for events (e.g. external controllers).
 void PollSources();
 
+/// Polls input sources while the emulated controller is being read. Only events which solely affect pad state are
+/// processed immediately, everything else is deferred until the next call to PollSources().
+void PollSourcesForControllerRead();
+
 /// Returns true if any bindings exist for the specified key.
 /// Can be safely called on another thread.
 bool HasAnyBindingsForKey(InputBindingKey key);
@@ -1,14 +1,20 @@
 #include "opengl_host_display.h"
 #include "common/align.h"
 #include "common/assert.h"
+#include "common/gl/shader_cache.h"
 #include "common/log.h"
 #include "common/string_util.h"
 #include "common_host.h"
+#include "core/settings.h"
+#include "core/shader_cache_version.h"
 #include "imgui.h"
 #include "imgui_impl_opengl3.h"
 #include "postprocessing_shadergen.h"
+#include <algorithm>
 #include <array>
 #include <tuple>
+#include <utility>
+#include <vector>
 Log_SetChannel(OpenGLHostDisplay);
 
 enum : u32
@@ -597,9 +603,9 @@ void main()
 void OpenGLHostDisplay::DestroyResources()
 {
   m_post_processing_chain.ClearStages();
-  m_post_processing_input_texture.Destroy();
   m_post_processing_ubo.reset();
   m_post_processing_stages.clear();
+  DestroyPostProcessingTargets();
 
   if (m_display_vao != 0)
   {
@@ -636,11 +642,16 @@ bool OpenGLHostDisplay::Render(bool skip_present)
     return false;
   }
 
+  // Nothing on screen would change, so leave the last frame up rather than drawing and presenting it again.
+  if (IsDuplicateFrame(m_post_processing_chain.UsesTime()))
+    return true;
+
   glDisable(GL_SCISSOR_TEST);
   glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
   RenderDisplay();
 
+  SetGPUTimingSection(GPUTimingSection::Other);
   if (ImGui::GetCurrentContext())
     RenderImGui();
 
@@ -709,6 +720,8 @@ void OpenGLHostDisplay::RenderImGui()
 
 void OpenGLHostDisplay::RenderDisplay()
 {
+  SetGPUTimingSection(GPUTimingSection::Display);
+
   const auto [left, top, width, height] = CalculateDrawRect(GetWindowWidth(), GetWindowHeight());
 
   if (HasDisplayTexture() && !m_post_processing_chain.IsEmpty())
@@ -835,28 +848,43 @@ bool OpenGLHostDisplay::SetPostProcessingChain(const std::string_view& config)
 {
   if (config.empty())
   {
-    m_post_processing_input_texture.Destroy();
     m_post_processing_stages.clear();
     m_post_processing_chain.ClearStages();
+    DestroyPostProcessingTargets();
     return true;
   }
 
-  if (!m_post_processing_chain.CreateFromString(config))
+  bool shaders_changed;
+  if (!m_post_processing_chain.CreateFromString(config, &shaders_changed))
     return false;
 
+  // options are passed through uniforms, so there's nothing to recompile when only they change
+  if (!shaders_changed && m_post_processing_stages.size() == m_post_processing_chain.GetStageCount())
+    return true;
+
   m_post_processing_stages.clear();
 
+  GL::ShaderCache shader_cache;
+  shader_cache.Open(m_gl_context->IsGLES(), EmuFolders::Cache, SHADER_CACHE_VERSION);
+
   FrontendCommon::PostProcessingShaderGen shadergen(GetRenderAPI(), false);
 
+  // Generate every stage's program first, so drivers with parallel shader compilation can work on them all at once.
+  std::vector<std::pair<std::string, std::string>> programs;
+  programs.reserve(m_post_processing_chain.GetStageCount());
   for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
   {
     const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
-    const std::string vs = shadergen.GeneratePostProcessingVertexShader(shader);
-    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(shader);
+    programs.emplace_back(shadergen.GeneratePostProcessingVertexShader(shader),
+                          shadergen.GeneratePostProcessingFragmentShader(shader));
+    shader_cache.PrecompileProgram(programs.back().first, {}, programs.back().second);
+  }
 
-    PostProcessingStage stage;
-    stage.uniforms_size = shader.GetUniformsSize();
-    if (!stage.program.Compile(vs, {}, ps))
+  for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
+  {
+    const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
+    std::optional<GL::Program> program = shader_cache.GetProgram(programs[i].first, {}, programs[i].second);
+    if (!program)
     {
       Log_InfoPrintf("Failed to compile post-processing program, disabling.");
       m_post_processing_stages.clear();
@@ -866,19 +894,14 @@ bool OpenGLHostDisplay::SetPostProcessingChain(const std::string_view& config)
 
     if (!shadergen.UseGLSLBindingLayout())
     {
-      stage.program.BindUniformBlock("UBOBlock", 1);
-      stage.program.Bind();
-      stage.program.Uniform1i("samp0", 0);
-    }
-
-    if (!stage.program.Link())
-    {
-      Log_InfoPrintf("Failed to link post-processing program, disabling.");
-      m_post_processing_stages.clear();
-      m_post_processing_chain.ClearStages();
-      return false;
+      program->BindUniformBlock("UBOBlock", 1);
+      program->Bind();
+      program->Uniform1i("samp0", 0);
     }
 
+    PostProcessingStage stage;
+    stage.program = std::move(program.value());
+    stage.uniforms_size = shader.GetUniformsSize();
     m_post_processing_stages.push_back(std::move(stage));
   }
 
@@ -900,34 +923,73 @@ bool OpenGLHostDisplay::SetPostProcessingChain(const std::string_view& config)
   return true;
 }
 
-bool OpenGLHostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+GL::Texture* OpenGLHostDisplay::GetPostProcessingTarget(u32 width, u32 height, const GL::Texture* input)
 {
-  DebugAssert(!m_post_processing_stages.empty());
-
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  // targets are shared between stages of the same size, as long as it's not the one the stage is reading from
+  for (const std::unique_ptr<PostProcessingTarget>& target : m_post_processing_targets)
   {
-    if (!m_post_processing_input_texture.Create(target_width, target_height, 1, 1, 1, GPUTexture::Format::RGBA8) ||
-        !m_post_processing_input_texture.CreateFramebuffer())
+    if (&target->texture != input && target->texture.GetWidth() == width && target->texture.GetHeight() == height)
     {
-      return false;
+      target->last_used = m_post_processing_target_counter;
+      return &target->texture;
     }
   }
 
+  std::unique_ptr<PostProcessingTarget> target = std::make_unique<PostProcessingTarget>();
+  if (!target->texture.Create(width, height, 1, 1, 1, GPUTexture::Format::RGBA8) ||
+      !target->texture.CreateFramebuffer())
+  {
+    return nullptr;
+  }
+
+  target->last_used = m_post_processing_target_counter;
+  m_post_processing_targets.push_back(std::move(target));
+  return &m_post_processing_targets.back()->texture;
+}
+
+void OpenGLHostDisplay::DestroyPostProcessingTargets()
+{
+  m_post_processing_input_texture = nullptr;
+  for (PostProcessingStage& pps : m_post_processing_stages)
+    pps.output_texture = nullptr;
+  m_post_processing_targets.clear();
+  m_post_processing_chain.InvalidateIntermediateCache();
+}
+
+bool OpenGLHostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height,
+                                                         const Common::Rectangle<s32>& final_rect)
+{
+  DebugAssert(!m_post_processing_stages.empty());
+
+  m_post_processing_target_counter++;
+  m_post_processing_input_texture = GetPostProcessingTarget(target_width, target_height, nullptr);
+  if (!m_post_processing_input_texture)
+    return false;
+
+  const GL::Texture* input = m_post_processing_input_texture;
   const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
   for (u32 i = 0; i < target_count; i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
-    {
-      if (!pps.output_texture.Create(target_width, target_height, 1, 1, 1, GPUTexture::Format::RGBA8) ||
-          !pps.output_texture.CreateFramebuffer())
-      {
-        return false;
-      }
-    }
+    u32 width = target_width;
+    u32 height = target_height;
+    pps.output_rect = m_post_processing_chain.GetShaderStage(i).GetScaledOutputRect(final_rect, &width, &height);
+    pps.output_texture = GetPostProcessingTarget(width, height, input);
+    if (!pps.output_texture)
+      return false;
+
+    input = pps.output_texture;
   }
 
+  // release anything which hasn't been needed for a while, e.g. from a screenshot
+  m_post_processing_targets.erase(
+    std::remove_if(m_post_processing_targets.begin(), m_post_processing_targets.end(),
+                   [this](const std::unique_ptr<PostProcessingTarget>& target) {
+                     return ((m_post_processing_target_counter - target->last_used) >
+                             FrontendCommon::PostProcessingChain::TARGET_POOL_LIFETIME);
+                   }),
+    m_post_processing_targets.end());
+
   return true;
 }
 
@@ -936,54 +998,78 @@ void OpenGLHostDisplay::ApplyPostProcessingChain(GLuint final_target, s32 final_
                                                  s32 texture_view_y, s32 texture_view_width, s32 texture_view_height,
                                                  u32 target_width, u32 target_height)
 {
-  if (!CheckPostProcessingRenderTargets(target_width, target_height))
+  // intermediate stages only need to be re-run when the input or target changes, e.g. not while paused
+  const Common::Rectangle<s32> final_rect =
+    Common::Rectangle<s32>::FromExtents(final_left, final_top, final_width, final_height);
+  const bool use_cached_stages =
+    m_post_processing_chain.UpdateIntermediateCache(m_display_changed, target_width, target_height, final_rect);
+  m_display_changed = false;
+
+  if (!use_cached_stages)
   {
+    if (!CheckPostProcessingRenderTargets(target_width, target_height, final_rect))
+    {
+      m_post_processing_chain.InvalidateIntermediateCache();
+      RenderDisplay(final_left, target_height - final_top - final_height, final_width, final_height, texture,
+                    texture_view_x, texture_view_y, texture_view_width, texture_view_height,
+                    IsUsingLinearFiltering());
+      return;
+    }
+
+    m_post_processing_input_texture->BindFramebuffer(GL_FRAMEBUFFER);
+    glClear(GL_COLOR_BUFFER_BIT);
     RenderDisplay(final_left, target_height - final_top - final_height, final_width, final_height, texture,
                   texture_view_x, texture_view_y, texture_view_width, texture_view_height, IsUsingLinearFiltering());
-    return;
   }
-
-  // downsample/upsample - use same viewport for remainder
-  m_post_processing_input_texture.BindFramebuffer(GL_FRAMEBUFFER);
-  glClear(GL_COLOR_BUFFER_BIT);
-  RenderDisplay(final_left, target_height - final_top - final_height, final_width, final_height, texture,
-                texture_view_x, texture_view_y, texture_view_width, texture_view_height, IsUsingLinearFiltering());
-
-  const s32 orig_texture_width = texture_view_width;
-  const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
-  texture_view_x = final_left;
-  texture_view_y = final_top;
-  texture_view_width = final_width;
-  texture_view_height = final_height;
+  else
+  {
+    // normally set up by RenderDisplay()
+    glDisable(GL_BLEND);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDepthMask(GL_FALSE);
+    glBindVertexArray(m_display_vao);
+  }
 
   m_post_processing_ubo->Bind();
 
   const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  for (u32 i = use_cached_stages ? final_stage : 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
-    glBindFramebuffer(GL_FRAMEBUFFER, (i == final_stage) ? final_target : pps.output_texture.GetGLFramebufferID());
+    const GL::Texture* input =
+      (i == 0) ? m_post_processing_input_texture : m_post_processing_stages[i - 1].output_texture;
+    const Common::Rectangle<s32>& input_rect = (i == 0) ? final_rect : m_post_processing_stages[i - 1].output_rect;
+
+    SetGPUTimingSection(GetPostProcessingTimingSection(i));
+    if (i != final_stage)
+    {
+      pps.output_texture->BindFramebuffer(GL_FRAMEBUFFER);
+      glViewport(pps.output_rect.left, static_cast<s32>(pps.output_texture->GetHeight()) - pps.output_rect.bottom,
+                 pps.output_rect.GetWidth(), pps.output_rect.GetHeight());
+    }
+    else
+    {
+      glBindFramebuffer(GL_FRAMEBUFFER, final_target);
+      glViewport(final_left, target_height - final_top - final_height, final_width, final_height);
+    }
     glClear(GL_COLOR_BUFFER_BIT);
 
     pps.program.Bind();
 
-    static_cast<const GL::Texture*>(texture)->Bind();
+    input->Bind();
     glBindSampler(0, m_display_border_sampler);
 
     const auto map_result = m_post_processing_ubo->Map(m_uniform_buffer_alignment, pps.uniforms_size);
     m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-      map_result.pointer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
-      texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
-      static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
+      map_result.pointer, input->GetWidth(), input->GetHeight(), input_rect.left, input_rect.top,
+      input_rect.GetWidth(), input_rect.GetHeight(), GetWindowWidth(), GetWindowHeight(), texture_view_width,
+      texture_view_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
     m_post_processing_ubo->Unmap(pps.uniforms_size);
     glBindBufferRange(GL_UNIFORM_BUFFER, 1, m_post_processing_ubo->GetGLBufferId(), map_result.buffer_offset,
                       pps.uniforms_size);
 
     glDrawArrays(GL_TRIANGLES, 0, 3);
-
-    if (i != final_stage)
-      texture = &pps.output_texture;
   }
 
   glBindSampler(0, 0);
@@ -1054,20 +1140,14 @@ void OpenGLHostDisplay::PopTimestampQuery()
 
     u64 result = 0;
     GetQueryObjectui64v(m_timestamp_queries[m_read_timestamp_query], GL_QUERY_RESULT, &result);
-    m_accumulated_gpu_time += static_cast<float>(static_cast<double>(result) / 1000000.0);
+    const float time = static_cast<float>(static_cast<double>(result) / 1000000.0);
+    m_accumulated_gpu_time += time;
+    m_accumulated_gpu_section_times[m_timestamp_query_sections[m_read_timestamp_query]] += time;
     m_read_timestamp_query = (m_read_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
     m_waiting_timestamp_queries--;
   }
 
-  if (m_timestamp_query_started)
-  {
-    const auto EndQuery = gles ? glEndQueryEXT : glEndQuery;
-    EndQuery(GL_TIME_ELAPSED);
-
-    m_write_timestamp_query = (m_write_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
-    m_timestamp_query_started = false;
-    m_waiting_timestamp_queries++;
-  }
+  EndTimestampQuery();
 }
 
 void OpenGLHostDisplay::KickTimestampQuery()
@@ -1079,9 +1159,36 @@ void OpenGLHostDisplay::KickTimestampQuery()
   const auto BeginQuery = gles ? glBeginQueryEXT : glBeginQuery;
 
   BeginQuery(GL_TIME_ELAPSED, m_timestamp_queries[m_write_timestamp_query]);
+  m_timestamp_query_sections[m_write_timestamp_query] = static_cast<u8>(m_gpu_timing_section);
   m_timestamp_query_started = true;
 }
 
+void OpenGLHostDisplay::EndTimestampQuery()
+{
+  if (!m_timestamp_query_started)
+    return;
+
+  const auto EndQuery = m_gl_context->IsGLES() ? glEndQueryEXT : glEndQuery;
+  EndQuery(GL_TIME_ELAPSED);
+
+  m_write_timestamp_query = (m_write_timestamp_query + 1) % NUM_TIMESTAMP_QUERIES;
+  m_timestamp_query_started = false;
+  m_waiting_timestamp_queries++;
+}
+
+void OpenGLHostDisplay::ChangeGPUTimingSection(GPUTimingSection section)
+{
+  HostDisplay::ChangeGPUTimingSection(section);
+
+  // Time elapsed queries can't be nested, so split the current one. If the ring is full, the remainder of the frame
+  // is attributed to the previous section instead.
+  if (m_timestamp_query_started && (m_waiting_timestamp_queries + 1) < NUM_TIMESTAMP_QUERIES)
+  {
+    EndTimestampQuery();
+    KickTimestampQuery();
+  }
+}
+
 bool OpenGLHostDisplay::SetGPUTimingEnabled(bool enabled)
 {
   if (m_gpu_timing_enabled == enabled)
@@ -1109,6 +1216,12 @@ float OpenGLHostDisplay::GetAndResetAccumulatedGPUTime()
   return value;
 }
 
+void OpenGLHostDisplay::GetAndResetAccumulatedGPUSectionTimes(GPUTimingSectionTimes* times)
+{
+  *times = m_accumulated_gpu_section_times;
+  m_accumulated_gpu_section_times.fill(0.0f);
+}
+
 GL::StreamBuffer* OpenGLHostDisplay::GetTextureStreamBuffer()
 {
   if (m_use_gles2_draw_path || m_texture_stream_buffer)
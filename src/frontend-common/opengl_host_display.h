@@ -57,6 +57,7 @@ public:
 
   bool SetGPUTimingEnabled(bool enabled) override;
   float GetAndResetAccumulatedGPUTime() override;
+  void GetAndResetAccumulatedGPUSectionTimes(GPUTimingSectionTimes* times) override;
 
   ALWAYS_INLINE GL::Context* GetGLContext() const { return m_gl_context.get(); }
   ALWAYS_INLINE bool UsePBOForUploads() const { return m_use_pbo_for_pixels; }
@@ -66,7 +67,8 @@ public:
   GL::StreamBuffer* GetTextureStreamBuffer();
 
 protected:
-  static constexpr u8 NUM_TIMESTAMP_QUERIES = 3;
+  // Each GPU timing section change ends the current query and starts a new one, so keep enough for a few frames.
+  static constexpr u8 NUM_TIMESTAMP_QUERIES = 128;
 
   const char* GetGLSLVersionString() const;
   std::string GetGLSLVersionHeader() const;
@@ -89,11 +91,20 @@ protected:
   struct PostProcessingStage
   {
     GL::Program program;
-    GL::Texture output_texture;
+    GL::Texture* output_texture = nullptr;
+    Common::Rectangle<s32> output_rect;
     u32 uniforms_size;
   };
 
-  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
+  struct PostProcessingTarget
+  {
+    GL::Texture texture;
+    u32 last_used = 0;
+  };
+
+  GL::Texture* GetPostProcessingTarget(u32 width, u32 height, const GL::Texture* input);
+  void DestroyPostProcessingTargets();
+  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height, const Common::Rectangle<s32>& final_rect);
   void ApplyPostProcessingChain(GLuint final_target, s32 final_left, s32 final_top, s32 final_width, s32 final_height,
                                 GL::Texture* texture, s32 texture_view_x, s32 texture_view_y, s32 texture_view_width,
                                 s32 texture_view_height, u32 target_width, u32 target_height);
@@ -102,6 +113,8 @@ protected:
   void DestroyTimestampQueries();
   void PopTimestampQuery();
   void KickTimestampQuery();
+  void EndTimestampQuery();
+  void ChangeGPUTimingSection(GPUTimingSection section) override;
 
   std::unique_ptr<GL::Context> m_gl_context;
 
@@ -118,12 +131,16 @@ protected:
   u32 m_texture_stream_buffer_offset = 0;
 
   FrontendCommon::PostProcessingChain m_post_processing_chain;
-  GL::Texture m_post_processing_input_texture;
+  GL::Texture* m_post_processing_input_texture = nullptr;
   std::unique_ptr<GL::StreamBuffer> m_post_processing_ubo;
   std::vector<PostProcessingStage> m_post_processing_stages;
+  std::vector<std::unique_ptr<PostProcessingTarget>> m_post_processing_targets;
+  u32 m_post_processing_target_counter = 0;
   Common::Timer m_post_processing_timer;
 
   std::array<GLuint, NUM_TIMESTAMP_QUERIES> m_timestamp_queries = {};
+  std::array<u8, NUM_TIMESTAMP_QUERIES> m_timestamp_query_sections = {};
+  GPUTimingSectionTimes m_accumulated_gpu_section_times = {};
   float m_accumulated_gpu_time = 0.0f;
   u8 m_read_timestamp_query = 0;
   u8 m_write_timestamp_query = 0;
@@ -7,6 +7,7 @@
 #include "core/host.h"
 #include "core/settings.h"
 #include "fmt/format.h"
+#include <algorithm>
 #include <sstream>
 Log_SetChannel(PostProcessingChain);
 
@@ -36,6 +37,7 @@ PostProcessingChain::~PostProcessingChain() = default;
 void PostProcessingChain::AddShader(PostProcessingShader shader)
 {
   m_shaders.push_back(std::move(shader));
+  m_cache_valid = false;
 }
 
 bool PostProcessingChain::AddStage(const std::string_view& name)
@@ -45,6 +47,7 @@ bool PostProcessingChain::AddStage(const std::string_view& name)
     return false;
 
   m_shaders.push_back(std::move(shader));
+  m_cache_valid = false;
   return true;
 }
 
@@ -69,7 +72,7 @@ std::string PostProcessingChain::GetConfigString() const
   return ss.str();
 }
 
-bool PostProcessingChain::CreateFromString(const std::string_view& chain_config)
+bool PostProcessingChain::CreateFromString(const std::string_view& chain_config, bool* shaders_changed /* = nullptr */)
 {
   std::vector<PostProcessingShader> shaders;
 
@@ -107,7 +110,16 @@ bool PostProcessingChain::CreateFromString(const std::string_view& chain_config)
     return false;
   }
 
+  if (shaders_changed)
+  {
+    *shaders_changed = !std::equal(m_shaders.begin(), m_shaders.end(), shaders.begin(), shaders.end(),
+                                   [](const PostProcessingShader& lhs, const PostProcessingShader& rhs) {
+                                     return (lhs.GetName() == rhs.GetName() && lhs.GetCode() == rhs.GetCode());
+                                   });
+  }
+
   m_shaders = std::move(shaders);
+  m_cache_valid = false;
   Log_InfoPrintf("Loaded postprocessing chain of %zu shaders", m_shaders.size());
   return true;
 }
@@ -150,6 +162,7 @@ void PostProcessingChain::RemoveStage(u32 index)
 {
   Assert(index < m_shaders.size());
   m_shaders.erase(m_shaders.begin() + index);
+  m_cache_valid = false;
 }
 
 void PostProcessingChain::MoveStageUp(u32 index)
@@ -161,6 +174,7 @@ void PostProcessingChain::MoveStageUp(u32 index)
   PostProcessingShader shader = std::move(m_shaders[index]);
   m_shaders.erase(m_shaders.begin() + index);
   m_shaders.insert(m_shaders.begin() + (index - 1u), std::move(shader));
+  m_cache_valid = false;
 }
 
 void PostProcessingChain::MoveStageDown(u32 index)
@@ -172,11 +186,40 @@ void PostProcessingChain::MoveStageDown(u32 index)
   PostProcessingShader shader = std::move(m_shaders[index]);
   m_shaders.erase(m_shaders.begin() + index);
   m_shaders.insert(m_shaders.begin() + (index + 1u), std::move(shader));
+  m_cache_valid = false;
 }
 
 void PostProcessingChain::ClearStages()
 {
   m_shaders.clear();
+  m_cache_valid = false;
+}
+
+bool PostProcessingChain::UpdateIntermediateCache(bool input_changed, u32 target_width, u32 target_height,
+                                                  const Common::Rectangle<s32>& final_rect)
+{
+  if (m_cache_valid && !input_changed && m_cached_target_width == target_width &&
+      m_cached_target_height == target_height && m_cached_final_rect == final_rect)
+  {
+    return true;
+  }
+
+  m_cached_final_rect = final_rect;
+  m_cached_target_width = target_width;
+  m_cached_target_height = target_height;
+  m_cache_valid = !UsesTime();
+  return false;
+}
+
+bool PostProcessingChain::UsesTime() const
+{
+  return std::any_of(m_shaders.begin(), m_shaders.end(),
+                     [](const PostProcessingShader& shader) { return shader.UsesTime(); });
+}
+
+void PostProcessingChain::InvalidateIntermediateCache()
+{
+  m_cache_valid = false;
 }
 
 } // namespace FrontendCommon
\ No newline at end of file
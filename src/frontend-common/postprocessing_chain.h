@@ -8,6 +8,9 @@ namespace FrontendCommon {
 class PostProcessingChain
 {
 public:
+  /// Number of chain applications a pooled intermediate target is kept for after it was last used.
+  static constexpr u32 TARGET_POOL_LIFETIME = 60;
+
   PostProcessingChain();
   ~PostProcessingChain();
 
@@ -25,12 +28,29 @@ public:
 
   std::string GetConfigString() const;
 
-  bool CreateFromString(const std::string_view& chain_config);
+  /// Returns true if any stage depends on the frame time, so the output can change even if the input doesn't.
+  bool UsesTime() const;
+
+  /// If shaders_changed is provided, it is set to false when the new chain has the same shaders with the same code as
+  /// the old one, i.e. only option values differ, so compiled stages can be kept.
+  bool CreateFromString(const std::string_view& chain_config, bool* shaders_changed = nullptr);
+
+  /// Returns true if the outputs of the intermediate stages from the last application of the chain can be reused,
+  /// because neither the input, the target nor the stages have changed, and no stage depends on the frame time.
+  /// Otherwise, records the new state, on the assumption that the caller will re-run the whole chain.
+  bool UpdateIntermediateCache(bool input_changed, u32 target_width, u32 target_height,
+                               const Common::Rectangle<s32>& final_rect);
+  void InvalidateIntermediateCache();
 
   static std::vector<std::string> GetAvailableShaderNames();
 
 private:
   std::vector<PostProcessingShader> m_shaders;
+
+  Common::Rectangle<s32> m_cached_final_rect;
+  u32 m_cached_target_width = 0;
+  u32 m_cached_target_height = 0;
+  bool m_cache_valid = false;
 };
 
 } // namespace FrontendCommon
@@ -3,7 +3,9 @@
 #include "common/log.h"
 #include "common/string_util.h"
 #include "core/shadergen.h"
+#include <algorithm>
 #include <cctype>
+#include <cmath>
 #include <cstring>
 #include <sstream>
 Log_SetChannel(PostProcessingShader);
@@ -93,12 +95,13 @@ PostProcessingShader::PostProcessingShader(std::string name, std::string code) :
 }
 
 PostProcessingShader::PostProcessingShader(const PostProcessingShader& copy)
-  : m_name(copy.m_name), m_code(copy.m_code), m_options(copy.m_options)
+  : m_name(copy.m_name), m_code(copy.m_code), m_options(copy.m_options), m_uses_time(copy.m_uses_time)
 {
 }
 
 PostProcessingShader::PostProcessingShader(PostProcessingShader& move)
-  : m_name(std::move(move.m_name)), m_code(std::move(move.m_code)), m_options(std::move(move.m_options))
+  : m_name(std::move(move.m_name)), m_code(std::move(move.m_code)), m_options(std::move(move.m_options)),
+    m_uses_time(move.m_uses_time)
 {
 }
 
@@ -118,6 +121,7 @@ bool PostProcessingShader::LoadFromString(std::string name, std::string code)
   m_name = std::move(name);
   m_code = std::move(code);
   m_options.clear();
+  m_uses_time = (m_code.find("GetTime()") != std::string::npos);
   LoadOptions();
   return true;
 }
@@ -235,6 +239,31 @@ void PostProcessingShader::SetConfigString(const std::string_view& str)
   }
 }
 
+float PostProcessingShader::GetOutputScale() const
+{
+  const Option* option = GetOptionByName(OUTPUT_SCALE_OPTION_NAME);
+  if (!option || option->type != Option::Type::Float)
+    return 1.0f;
+
+  return std::clamp(option->value[0].float_value, MIN_OUTPUT_SCALE, MAX_OUTPUT_SCALE);
+}
+
+Common::Rectangle<s32> PostProcessingShader::GetScaledOutputRect(const Common::Rectangle<s32>& rect,
+                                                                 u32* target_width, u32* target_height) const
+{
+  const float scale = GetOutputScale();
+  if (scale == 1.0f)
+    return rect;
+
+  // round the edges outwards so the rectangle never collapses, and stays within the scaled target
+  *target_width = std::max(static_cast<u32>(std::ceil(static_cast<float>(*target_width) * scale)), 1u);
+  *target_height = std::max(static_cast<u32>(std::ceil(static_cast<float>(*target_height) * scale)), 1u);
+  return Common::Rectangle<s32>(static_cast<s32>(std::floor(static_cast<float>(rect.left) * scale)),
+                                static_cast<s32>(std::floor(static_cast<float>(rect.top) * scale)),
+                                static_cast<s32>(std::ceil(static_cast<float>(rect.right) * scale)),
+                                static_cast<s32>(std::ceil(static_cast<float>(rect.bottom) * scale)));
+}
+
 bool PostProcessingShader::UsePushConstants() const
 {
   return GetUniformsSize() <= PUSH_CONSTANT_SIZE_THRESHOLD;
@@ -295,6 +324,7 @@ FrontendCommon::PostProcessingShader& PostProcessingShader::operator=(const Post
   m_name = copy.m_name;
   m_code = copy.m_code;
   m_options = copy.m_options;
+  m_uses_time = copy.m_uses_time;
   return *this;
 }
 
@@ -303,6 +333,7 @@ FrontendCommon::PostProcessingShader& PostProcessingShader::operator=(PostProces
   m_name = std::move(move.m_name);
   m_code = std::move(move.m_code);
   m_options = std::move(move.m_options);
+  m_uses_time = move.m_uses_time;
   return *this;
 }
 
@@ -16,6 +16,11 @@ public:
     PUSH_CONSTANT_SIZE_THRESHOLD = 128
   };
 
+  /// Float option which, when declared by a shader, scales the output of the stage relative to the display.
+  static constexpr const char* OUTPUT_SCALE_OPTION_NAME = "OutputScale";
+  static constexpr float MIN_OUTPUT_SCALE = 0.125f;
+  static constexpr float MAX_OUTPUT_SCALE = 1.0f;
+
   struct Option
   {
     enum : u32
@@ -67,6 +72,7 @@ public:
   ALWAYS_INLINE const std::vector<Option>& GetOptions() const { return m_options; }
   ALWAYS_INLINE std::vector<Option>& GetOptions() { return m_options; }
   ALWAYS_INLINE bool HasOptions() const { return !m_options.empty(); }
+  ALWAYS_INLINE bool UsesTime() const { return m_uses_time; }
 
   bool IsValid() const;
 
@@ -79,6 +85,13 @@ public:
   bool LoadFromFile(std::string name, const char* filename);
   bool LoadFromString(std::string name, std::string code);
 
+  /// Returns the scale of the stage's output relative to the final target. Only applies to intermediate stages.
+  float GetOutputScale() const;
+
+  /// Scales a rectangle within a target of the given size by the output scale. The target size is updated in place.
+  Common::Rectangle<s32> GetScaledOutputRect(const Common::Rectangle<s32>& rect, u32* target_width,
+                                             u32* target_height) const;
+
   bool UsePushConstants() const;
   u32 GetUniformsSize() const;
   void FillUniformBuffer(void* buffer, u32 texture_width, s32 texture_height, s32 texture_view_x, s32 texture_view_y,
@@ -105,6 +118,7 @@ private:
   std::string m_name;
   std::string m_code;
   std::vector<Option> m_options;
+  bool m_uses_time = false;
 };
 
 } // namespace FrontendCommon
\ No newline at end of file
@@ -15,6 +15,7 @@
 #include "imgui.h"
 #include "imgui_impl_vulkan.h"
 #include "postprocessing_shadergen.h"
+#include <algorithm>
 #include <array>
 Log_SetChannel(VulkanHostDisplay);
 
@@ -27,6 +28,7 @@ VulkanHostDisplay::~VulkanHostDisplay()
 
   g_vulkan_context->WaitForGPUIdle();
 
+  CompletePendingScreenshots(true);
   DestroyStagingBuffer();
   DestroyResources();
 
@@ -218,7 +220,7 @@ bool VulkanHostDisplay::CreateRenderDevice(const WindowInfo& wi)
 {
   WindowInfo local_wi(wi);
   if (!Vulkan::Context::Create(g_settings.gpu_adapter, &local_wi, &m_swap_chain, g_settings.gpu_threaded_presentation,
-                               g_settings.gpu_use_debug_device, false))
+                               g_settings.gpu_frames_in_flight, g_settings.gpu_use_debug_device, false))
   {
     Log_ErrorPrintf("Failed to create Vulkan context");
     m_window_info = {};
@@ -531,9 +533,8 @@ void VulkanHostDisplay::DestroyResources()
   Vulkan::Util::SafeDestroyPipelineLayout(m_post_process_ubo_pipeline_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_post_process_descriptor_set_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_post_process_ubo_descriptor_set_layout);
-  m_post_processing_input_texture.Destroy(false);
-  Vulkan::Util::SafeDestroyFramebuffer(m_post_processing_input_framebuffer);
   m_post_processing_stages.clear();
+  DestroyPostProcessingTargets();
   m_post_processing_ubo.Destroy(true);
   m_post_processing_chain.ClearStages();
 
@@ -583,6 +584,8 @@ bool VulkanHostDisplay::DoneRenderContextCurrent()
 
 bool VulkanHostDisplay::Render(bool skip_present)
 {
+  CompletePendingScreenshots(false);
+
   if (skip_present || !m_swap_chain)
   {
     if (ImGui::GetCurrentContext())
@@ -591,6 +594,10 @@ bool VulkanHostDisplay::Render(bool skip_present)
     return false;
   }
 
+  // Nothing on screen would change, so leave the last frame up rather than drawing and presenting it again.
+  if (IsDuplicateFrame(m_post_processing_chain.UsesTime()))
+    return true;
+
   // Previous frame needs to be presented before we can acquire the swap chain.
   g_vulkan_context->WaitForPresentComplete();
 
@@ -638,6 +645,7 @@ bool VulkanHostDisplay::Render(bool skip_present)
 
     RenderDisplay();
 
+    SetGPUTimingSection(GPUTimingSection::Other);
     if (ImGui::GetCurrentContext())
       RenderImGui();
 
@@ -657,57 +665,39 @@ bool VulkanHostDisplay::Render(bool skip_present)
   return true;
 }
 
-bool VulkanHostDisplay::RenderScreenshot(u32 width, u32 height, std::vector<u32>* out_pixels, u32* out_stride,
-                                         GPUTexture::Format* out_format)
+bool VulkanHostDisplay::GetScreenshotFormat(VkFormat format, GPUTexture::Format* out_format)
 {
-  // in theory we could do this without a swap chain, but postprocessing assumes it for now...
-  if (!m_swap_chain)
-    return false;
-
-  const VkFormat format = m_swap_chain ? m_swap_chain->GetTextureFormat() : VK_FORMAT_R8G8B8A8_UNORM;
   switch (format)
   {
     case VK_FORMAT_R8G8B8A8_UNORM:
     case VK_FORMAT_R8G8B8A8_SRGB:
       *out_format = GPUTexture::Format::RGBA8;
-      *out_stride = sizeof(u32) * width;
-      out_pixels->resize(width * height);
-      break;
+      return true;
 
     case VK_FORMAT_B8G8R8A8_UNORM:
     case VK_FORMAT_B8G8R8A8_SRGB:
       *out_format = GPUTexture::Format::BGRA8;
-      *out_stride = sizeof(u32) * width;
-      out_pixels->resize(width * height);
-      break;
+      return true;
 
     case VK_FORMAT_A1R5G5B5_UNORM_PACK16:
       *out_format = GPUTexture::Format::RGBA5551;
-      *out_stride = sizeof(u16) * width;
-      out_pixels->resize(((width * height) + 1) / 2);
-      break;
+      return true;
 
     case VK_FORMAT_R5G6B5_UNORM_PACK16:
       *out_format = GPUTexture::Format::RGB565;
-      *out_stride = sizeof(u16) * width;
-      out_pixels->resize(((width * height) + 1) / 2);
-      break;
+      return true;
 
     default:
       Log_ErrorPrintf("Unhandled swap chain pixel format %u", static_cast<unsigned>(format));
-      break;
-  }
-
-  // if we don't have a texture (display off), then just write out nothing.
-  if (!HasDisplayTexture())
-  {
-    std::fill(out_pixels->begin(), out_pixels->end(), static_cast<u32>(0));
-    return true;
+      return false;
   }
+}
 
-  Vulkan::Texture tex;
-  if (!tex.Create(width, height, 1, 1, format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                  VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
+bool VulkanHostDisplay::RenderScreenshotToTexture(u32 width, u32 height, VkFormat format, Vulkan::Texture* tex,
+                                                  VkFramebuffer* fb)
+{
+  if (!tex->Create(width, height, 1, 1, format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
+                   VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT))
   {
     return false;
   }
@@ -719,24 +709,25 @@ bool VulkanHostDisplay::RenderScreenshot(u32 width, u32 height, std::vector<u32>
   if (!rp)
     return false;
 
-  const VkFramebuffer fb = tex.CreateFramebuffer(rp);
-  if (!fb)
+  *fb = tex->CreateFramebuffer(rp);
+  if (!*fb)
     return false;
   const Vulkan::Util::DebugScope debugScope(g_vulkan_context->GetCurrentCommandBuffer(),
                                             "VulkanHostDisplay::RenderScreenshot: %ux%u", width, height);
-  tex.TransitionToLayout(g_vulkan_context->GetCurrentCommandBuffer(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  tex->TransitionToLayout(g_vulkan_context->GetCurrentCommandBuffer(), VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  SetGPUTimingSection(GPUTimingSection::Display);
 
   const auto [left, top, draw_width, draw_height] = CalculateDrawRect(width, height);
 
   if (!m_post_processing_chain.IsEmpty())
   {
-    ApplyPostProcessingChain(fb, left, top, draw_width, draw_height, static_cast<Vulkan::Texture*>(m_display_texture),
+    ApplyPostProcessingChain(*fb, left, top, draw_width, draw_height, static_cast<Vulkan::Texture*>(m_display_texture),
                              m_display_texture_view_x, m_display_texture_view_y, m_display_texture_view_width,
                              m_display_texture_view_height, width, height);
   }
   else
   {
-    BeginSwapChainRenderPass(fb, width, height);
+    BeginSwapChainRenderPass(*fb, width, height);
     RenderDisplay(left, top, draw_width, draw_height, static_cast<Vulkan::Texture*>(m_display_texture),
                   m_display_texture_view_x, m_display_texture_view_y, m_display_texture_view_width,
                   m_display_texture_view_height, IsUsingLinearFiltering());
@@ -744,7 +735,40 @@ bool VulkanHostDisplay::RenderScreenshot(u32 width, u32 height, std::vector<u32>
 
   vkCmdEndRenderPass(g_vulkan_context->GetCurrentCommandBuffer());
   Vulkan::Util::EndDebugScope(g_vulkan_context->GetCurrentCommandBuffer());
-  tex.TransitionToLayout(g_vulkan_context->GetCurrentCommandBuffer(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+  tex->TransitionToLayout(g_vulkan_context->GetCurrentCommandBuffer(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+  return true;
+}
+
+bool VulkanHostDisplay::RenderScreenshot(u32 width, u32 height, std::vector<u32>* out_pixels, u32* out_stride,
+                                         GPUTexture::Format* out_format)
+{
+  // in theory we could do this without a swap chain, but postprocessing assumes it for now...
+  if (!m_swap_chain)
+    return false;
+
+  const VkFormat format = m_swap_chain ? m_swap_chain->GetTextureFormat() : VK_FORMAT_R8G8B8A8_UNORM;
+  if (!GetScreenshotFormat(format, out_format))
+    return false;
+
+  *out_stride = GPUTexture::GetPixelSize(*out_format) * width;
+  out_pixels->resize(((*out_stride * height) + (sizeof(u32) - 1)) / sizeof(u32));
+
+  // if we don't have a texture (display off), then just write out nothing.
+  if (!HasDisplayTexture())
+  {
+    std::fill(out_pixels->begin(), out_pixels->end(), static_cast<u32>(0));
+    return true;
+  }
+
+  Vulkan::Texture tex;
+  VkFramebuffer fb = VK_NULL_HANDLE;
+  if (!RenderScreenshotToTexture(width, height, format, &tex, &fb))
+  {
+    if (fb != VK_NULL_HANDLE)
+      vkDestroyFramebuffer(g_vulkan_context->GetDevice(), fb, nullptr);
+    return false;
+  }
+
   DownloadTexture(&tex, 0, 0, width, height, out_pixels->data(), *out_stride);
 
   // destroying these immediately should be safe since nothing's going to access them, and it's not part of the command
@@ -754,6 +778,111 @@ bool VulkanHostDisplay::RenderScreenshot(u32 width, u32 height, std::vector<u32>
   return true;
 }
 
+bool VulkanHostDisplay::RenderScreenshotAsync(u32 width, u32 height, ScreenshotCallback callback)
+{
+  // a blank screenshot doesn't need to go through the GPU
+  if (!m_swap_chain || !HasDisplayTexture())
+    return HostDisplay::RenderScreenshotAsync(width, height, std::move(callback));
+
+  const VkFormat format = m_swap_chain->GetTextureFormat();
+  GPUTexture::Format texture_format;
+  if (!GetScreenshotFormat(format, &texture_format))
+    return false;
+
+  const u32 pitch = Common::AlignUp(GPUTexture::GetPixelSize(texture_format) * width,
+                                    g_vulkan_context->GetBufferCopyRowPitchAlignment());
+  const VkBufferCreateInfo bci = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                                  nullptr,
+                                  0u,
+                                  pitch * height,
+                                  VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                  VK_SHARING_MODE_EXCLUSIVE,
+                                  0u,
+                                  nullptr};
+
+  VmaAllocationCreateInfo aci = {};
+  aci.usage = VMA_MEMORY_USAGE_GPU_TO_CPU;
+  aci.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  aci.preferredFlags = m_is_adreno ? (VK_MEMORY_PROPERTY_HOST_CACHED_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) :
+                                     VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+
+  PendingScreenshot ps;
+  VmaAllocationInfo ai = {};
+  VkResult res = vmaCreateBuffer(g_vulkan_context->GetAllocator(), &bci, &aci, &ps.buffer, &ps.allocation, &ai);
+  if (res != VK_SUCCESS)
+  {
+    LOG_VULKAN_ERROR(res, "vmaCreateBuffer() failed: ");
+    return false;
+  }
+
+  Vulkan::Texture tex;
+  VkFramebuffer fb = VK_NULL_HANDLE;
+  if (!RenderScreenshotToTexture(width, height, format, &tex, &fb))
+  {
+    if (fb != VK_NULL_HANDLE)
+      vkDestroyFramebuffer(g_vulkan_context->GetDevice(), fb, nullptr);
+    vmaDestroyBuffer(g_vulkan_context->GetAllocator(), ps.buffer, ps.allocation);
+    return false;
+  }
+
+  const VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  VkBufferImageCopy image_copy = {};
+  image_copy.bufferRowLength = pitch / GPUTexture::GetPixelSize(texture_format);
+  image_copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u};
+  image_copy.imageExtent = {width, height, 1u};
+  vkCmdCopyImageToBuffer(cmdbuf, tex.GetImage(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ps.buffer, 1, &image_copy);
+  Vulkan::Util::BufferMemoryBarrier(cmdbuf, ps.buffer, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_HOST_READ_BIT, 0,
+                                    pitch * height, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT);
+
+  // The texture and framebuffer are released once this command buffer completes, the buffer when it's read.
+  g_vulkan_context->DeferFramebufferDestruction(fb);
+  tex.Destroy(true);
+
+  ps.map = static_cast<const u8*>(ai.pMappedData);
+  ps.fence_counter = g_vulkan_context->GetCurrentFenceCounter();
+  ps.width = width;
+  ps.height = height;
+  ps.pitch = pitch;
+  ps.format = texture_format;
+  ps.callback = std::move(callback);
+  m_pending_screenshots.push_back(std::move(ps));
+  return true;
+}
+
+void VulkanHostDisplay::CompletePendingScreenshots(bool wait)
+{
+  while (!m_pending_screenshots.empty())
+  {
+    PendingScreenshot& ps = m_pending_screenshots.front();
+    if (g_vulkan_context->GetCompletedFenceCounter() < ps.fence_counter)
+    {
+      if (!wait)
+        break;
+
+      if (ps.fence_counter == g_vulkan_context->GetCurrentFenceCounter())
+        g_vulkan_context->ExecuteCommandBuffer(true);
+      else
+        g_vulkan_context->WaitForFenceCounter(ps.fence_counter);
+    }
+
+    VkResult res = vmaInvalidateAllocation(g_vulkan_context->GetAllocator(), ps.allocation, 0, ps.pitch * ps.height);
+    if (res != VK_SUCCESS)
+      LOG_VULKAN_ERROR(res, "vmaInvalidateAllocation() failed, screenshot may be incorrect: ");
+
+    const u32 stride = GPUTexture::GetPixelSize(ps.format) * ps.width;
+    std::vector<u32> pixels(((stride * ps.height) + (sizeof(u32) - 1)) / sizeof(u32));
+    StringUtil::StrideMemCpy(pixels.data(), stride, ps.map, ps.pitch, stride, ps.height);
+    vmaDestroyBuffer(g_vulkan_context->GetAllocator(), ps.buffer, ps.allocation);
+
+    ScreenshotCallback callback = std::move(ps.callback);
+    const u32 width = ps.width;
+    const u32 height = ps.height;
+    const GPUTexture::Format format = ps.format;
+    m_pending_screenshots.pop_front();
+    callback(width, height, std::move(pixels), stride, format);
+  }
+}
+
 void VulkanHostDisplay::BeginSwapChainRenderPass(VkFramebuffer framebuffer, u32 width, u32 height)
 {
   const VkClearValue clear_value = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
@@ -773,6 +902,7 @@ void VulkanHostDisplay::RenderDisplay()
 {
   const Vulkan::Util::DebugScope debugScope(g_vulkan_context->GetCurrentCommandBuffer(),
                                             "VulkanHostDisplay::RenderDisplay");
+  SetGPUTimingSection(GPUTimingSection::Display);
   if (!HasDisplayTexture())
   {
     BeginSwapChainRenderPass(m_swap_chain->GetCurrentFramebuffer(), m_swap_chain->GetWidth(),
@@ -806,20 +936,15 @@ void VulkanHostDisplay::RenderDisplay(s32 left, s32 top, s32 width, s32 height,
     cmdbuffer, "VulkanHostDisplay::RenderDisplay: {%u,%u} %ux%u | %ux%u | {%u,%u} %ux%u", left, top, width, height,
     texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width, texture_view_height);
 
-  VkDescriptorSet ds = g_vulkan_context->AllocateDescriptorSet(m_descriptor_set_layout);
+  VkDescriptorSet ds = g_vulkan_context->GetImageSamplerDescriptorSet(
+    m_descriptor_set_layout, 0, texture->GetView(), linear_filter ? m_linear_sampler : m_point_sampler,
+    texture->GetLayout());
   if (ds == VK_NULL_HANDLE)
   {
     Log_ErrorPrintf("Skipping rendering display because of no descriptor set");
     return;
   }
 
-  {
-    Vulkan::DescriptorSetUpdateBuilder dsupdate;
-    dsupdate.AddCombinedImageSamplerDescriptorWrite(
-      ds, 0, texture->GetView(), linear_filter ? m_linear_sampler : m_point_sampler, texture->GetLayout());
-    dsupdate.Update(g_vulkan_context->GetDevice());
-  }
-
   const float position_adjust = IsUsingLinearFiltering() ? 0.5f : 0.0f;
   const float size_adjust = IsUsingLinearFiltering() ? 1.0f : 0.0f;
   const PushConstants pc{
@@ -857,20 +982,14 @@ void VulkanHostDisplay::RenderSoftwareCursor(s32 left, s32 top, s32 width, s32 h
   const Vulkan::Util::DebugScope debugScope(cmdbuffer, "VulkanHostDisplay::RenderSoftwareCursor: {%u,%u} %ux%u", left,
                                             top, width, height);
 
-  VkDescriptorSet ds = g_vulkan_context->AllocateDescriptorSet(m_descriptor_set_layout);
+  VkDescriptorSet ds = g_vulkan_context->GetImageSamplerDescriptorSet(
+    m_descriptor_set_layout, 0, static_cast<Vulkan::Texture*>(texture)->GetView(), m_linear_sampler);
   if (ds == VK_NULL_HANDLE)
   {
     Log_ErrorPrintf("Skipping rendering software cursor because of no descriptor set");
     return;
   }
 
-  {
-    Vulkan::DescriptorSetUpdateBuilder dsupdate;
-    dsupdate.AddCombinedImageSamplerDescriptorWrite(ds, 0, static_cast<Vulkan::Texture*>(texture)->GetView(),
-                                                    m_linear_sampler);
-    dsupdate.Update(g_vulkan_context->GetDevice());
-  }
-
   const PushConstants pc{0.0f, 0.0f, 1.0f, 1.0f};
   vkCmdBindPipeline(cmdbuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_cursor_pipeline);
   vkCmdPushConstants(cmdbuffer, m_pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pc), &pc);
@@ -895,6 +1014,18 @@ float VulkanHostDisplay::GetAndResetAccumulatedGPUTime()
   return g_vulkan_context->GetAndResetAccumulatedGPUTime();
 }
 
+void VulkanHostDisplay::GetAndResetAccumulatedGPUSectionTimes(GPUTimingSectionTimes* times)
+{
+  static_assert(NUM_GPU_TIMING_SECTIONS <= Vulkan::Context::MAX_GPU_TIMING_SECTIONS);
+  g_vulkan_context->GetAndResetAccumulatedGPUSectionTimes(times->data(), static_cast<u32>(times->size()));
+}
+
+void VulkanHostDisplay::ChangeGPUTimingSection(GPUTimingSection section)
+{
+  g_vulkan_context->SetGPUTimingSection(static_cast<u32>(section));
+  HostDisplay::ChangeGPUTimingSection(section);
+}
+
 HostDisplay::AdapterAndModeList VulkanHostDisplay::StaticGetAdapterAndModeList(const WindowInfo* wi)
 {
   AdapterAndModeList ret;
@@ -935,49 +1066,72 @@ HostDisplay::AdapterAndModeList VulkanHostDisplay::StaticGetAdapterAndModeList(c
   return ret;
 }
 
+VulkanHostDisplay::PostProcessingTarget::~PostProcessingTarget()
+{
+  if (framebuffer != VK_NULL_HANDLE)
+    g_vulkan_context->DeferFramebufferDestruction(framebuffer);
+
+  texture.Destroy(true);
+}
+
 VulkanHostDisplay::PostProcessingStage::PostProcessingStage(PostProcessingStage&& move)
-  : pipeline(move.pipeline), output_framebuffer(move.output_framebuffer),
-    output_texture(std::move(move.output_texture)), uniforms_size(move.uniforms_size)
+  : pipeline(move.pipeline), output_target(move.output_target), output_rect(move.output_rect),
+    uniforms_size(move.uniforms_size)
 {
-  move.output_framebuffer = VK_NULL_HANDLE;
   move.pipeline = VK_NULL_HANDLE;
+  move.output_target = nullptr;
   move.uniforms_size = 0;
 }
 
 VulkanHostDisplay::PostProcessingStage::~PostProcessingStage()
 {
-  if (output_framebuffer != VK_NULL_HANDLE)
-    g_vulkan_context->DeferFramebufferDestruction(output_framebuffer);
-
-  output_texture.Destroy(true);
   if (pipeline != VK_NULL_HANDLE)
     g_vulkan_context->DeferPipelineDestruction(pipeline);
 }
 
 bool VulkanHostDisplay::SetPostProcessingChain(const std::string_view& config)
 {
-  g_vulkan_context->ExecuteCommandBuffer(true);
-
   if (config.empty())
   {
+    g_vulkan_context->ExecuteCommandBuffer(true);
     m_post_processing_stages.clear();
     m_post_processing_chain.ClearStages();
+    DestroyPostProcessingTargets();
     return true;
   }
 
-  if (!m_post_processing_chain.CreateFromString(config))
+  bool shaders_changed;
+  if (!m_post_processing_chain.CreateFromString(config, &shaders_changed))
     return false;
 
+  // options are passed through uniforms, so there's nothing to recompile when only they change
+  if (!shaders_changed && m_post_processing_stages.size() == m_post_processing_chain.GetStageCount())
+    return true;
+
+  g_vulkan_context->ExecuteCommandBuffer(true);
   m_post_processing_stages.clear();
 
   FrontendCommon::PostProcessingShaderGen shadergen(RenderAPI::Vulkan, false);
   bool only_use_push_constants = true;
 
+  // Generate every stage's shaders first, so any which aren't cached are compiled in parallel.
+  Vulkan::ShaderCompiler::ShaderSourceList shader_sources;
+  shader_sources.reserve(m_post_processing_chain.GetStageCount() * 2);
+  for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
+  {
+    const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
+    shader_sources.emplace_back(Vulkan::ShaderCompiler::Type::Vertex,
+                                shadergen.GeneratePostProcessingVertexShader(shader));
+    shader_sources.emplace_back(Vulkan::ShaderCompiler::Type::Fragment,
+                                shadergen.GeneratePostProcessingFragmentShader(shader));
+  }
+  g_vulkan_shader_cache->PrecompileShaders(shader_sources);
+
   for (u32 i = 0; i < m_post_processing_chain.GetStageCount(); i++)
   {
     const FrontendCommon::PostProcessingShader& shader = m_post_processing_chain.GetShaderStage(i);
-    const std::string vs = shadergen.GeneratePostProcessingVertexShader(shader);
-    const std::string ps = shadergen.GeneratePostProcessingFragmentShader(shader);
+    const std::string& vs = shader_sources[i * 2].second;
+    const std::string& ps = shader_sources[i * 2 + 1].second;
     const bool use_push_constants = shader.UsePushConstants();
     only_use_push_constants &= use_push_constants;
 
@@ -1042,63 +1196,86 @@ bool VulkanHostDisplay::SetPostProcessingChain(const std::string_view& config)
   return true;
 }
 
-bool VulkanHostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height)
+VulkanHostDisplay::PostProcessingTarget* VulkanHostDisplay::GetPostProcessingTarget(u32 width, u32 height,
+                                                                                    const PostProcessingTarget* input)
 {
-  DebugAssert(!m_post_processing_stages.empty());
-
-  if (m_post_processing_input_texture.GetWidth() != target_width ||
-      m_post_processing_input_texture.GetHeight() != target_height)
+  // targets are shared between stages of the same size, as long as it's not the one the stage is reading from
+  const VkFormat format = m_swap_chain->GetTextureFormat();
+  for (const std::unique_ptr<PostProcessingTarget>& target : m_post_processing_targets)
   {
-    if (m_post_processing_input_framebuffer != VK_NULL_HANDLE)
+    if (target.get() != input && target->texture.GetWidth() == width && target->texture.GetHeight() == height &&
+        target->texture.GetVkFormat() == format)
     {
-      g_vulkan_context->DeferFramebufferDestruction(m_post_processing_input_framebuffer);
-      m_post_processing_input_framebuffer = VK_NULL_HANDLE;
+      target->last_used = m_post_processing_target_counter;
+      return target.get();
     }
+  }
 
-    if (!m_post_processing_input_texture.Create(target_width, target_height, 1, 1, m_swap_chain->GetTextureFormat(),
-                                                VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                                                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT) ||
-        (m_post_processing_input_framebuffer =
-           m_post_processing_input_texture.CreateFramebuffer(GetRenderPassForDisplay())) == VK_NULL_HANDLE)
-    {
-      return false;
-    }
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_input_texture.GetImage(),
-                                "Post Processing Input Texture");
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_input_texture.GetView(),
-                                "Post Processing Input Texture View");
-    Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), m_post_processing_input_texture.GetAllocation(),
-                                "Post Processing Input Texture Memory");
+  std::unique_ptr<PostProcessingTarget> target = std::make_unique<PostProcessingTarget>();
+  if (!target->texture.Create(width, height, 1, 1, format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D,
+                              VK_IMAGE_TILING_OPTIMAL,
+                              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT) ||
+      (target->framebuffer = target->texture.CreateFramebuffer(GetRenderPassForDisplay())) == VK_NULL_HANDLE)
+  {
+    return nullptr;
   }
 
+  const u32 index = static_cast<u32>(m_post_processing_targets.size());
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), target->texture.GetImage(),
+                              "Post Processing Target %u", index);
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), target->texture.GetAllocation(),
+                              "Post Processing Target Memory %u", index);
+  Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), target->texture.GetView(),
+                              "Post Processing Target View %u", index);
+
+  target->last_used = m_post_processing_target_counter;
+  m_post_processing_targets.push_back(std::move(target));
+  return m_post_processing_targets.back().get();
+}
+
+void VulkanHostDisplay::DestroyPostProcessingTargets()
+{
+  m_post_processing_input_target = nullptr;
+  for (PostProcessingStage& pps : m_post_processing_stages)
+    pps.output_target = nullptr;
+  m_post_processing_targets.clear();
+  m_post_processing_chain.InvalidateIntermediateCache();
+}
+
+bool VulkanHostDisplay::CheckPostProcessingRenderTargets(u32 target_width, u32 target_height,
+                                                         const Common::Rectangle<s32>& final_rect)
+{
+  DebugAssert(!m_post_processing_stages.empty());
+
+  m_post_processing_target_counter++;
+  m_post_processing_input_target = GetPostProcessingTarget(target_width, target_height, nullptr);
+  if (!m_post_processing_input_target)
+    return false;
+
+  const PostProcessingTarget* input = m_post_processing_input_target;
   const u32 target_count = (static_cast<u32>(m_post_processing_stages.size()) - 1);
   for (u32 i = 0; i < target_count; i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
-    if (pps.output_texture.GetWidth() != target_width || pps.output_texture.GetHeight() != target_height)
-    {
-      if (pps.output_framebuffer != VK_NULL_HANDLE)
-      {
-        g_vulkan_context->DeferFramebufferDestruction(pps.output_framebuffer);
-        pps.output_framebuffer = VK_NULL_HANDLE;
-      }
+    u32 width = target_width;
+    u32 height = target_height;
+    pps.output_rect = m_post_processing_chain.GetShaderStage(i).GetScaledOutputRect(final_rect, &width, &height);
+    pps.output_target = GetPostProcessingTarget(width, height, input);
+    if (!pps.output_target)
+      return false;
 
-      if (!pps.output_texture.Create(target_width, target_height, 1, 1, m_swap_chain->GetTextureFormat(),
-                                     VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
-                                     VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT) ||
-          (pps.output_framebuffer = pps.output_texture.CreateFramebuffer(GetRenderPassForDisplay())) == VK_NULL_HANDLE)
-      {
-        return false;
-      }
-      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), pps.output_texture.GetImage(),
-                                  "Post Processing Output Texture %u", i);
-      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), pps.output_texture.GetAllocation(),
-                                  "Post Processing Output Texture Memory %u", i);
-      Vulkan::Util::SetObjectName(g_vulkan_context->GetDevice(), pps.output_texture.GetView(),
-                                  "Post Processing Output Texture View %u", i);
-    }
+    input = pps.output_target;
   }
 
+  // release anything which hasn't been needed for a while, e.g. from a screenshot
+  m_post_processing_targets.erase(
+    std::remove_if(m_post_processing_targets.begin(), m_post_processing_targets.end(),
+                   [this](const std::unique_ptr<PostProcessingTarget>& target) {
+                     return ((m_post_processing_target_counter - target->last_used) >
+                             FrontendCommon::PostProcessingChain::TARGET_POOL_LIFETIME);
+                   }),
+    m_post_processing_targets.end());
+
   return true;
 }
 
@@ -1110,46 +1287,58 @@ void VulkanHostDisplay::ApplyPostProcessingChain(VkFramebuffer target_fb, s32 fi
   VkCommandBuffer cmdbuffer = g_vulkan_context->GetCurrentCommandBuffer();
   const Vulkan::Util::DebugScope post_scope(cmdbuffer, "VulkanHostDisplay::ApplyPostProcessingChain");
 
-  if (!CheckPostProcessingRenderTargets(target_width, target_height))
+  // intermediate stages only need to be re-run when the input or target changes, e.g. not while paused
+  const Common::Rectangle<s32> final_rect =
+    Common::Rectangle<s32>::FromExtents(final_left, final_top, final_width, final_height);
+  const bool use_cached_stages =
+    m_post_processing_chain.UpdateIntermediateCache(m_display_changed, target_width, target_height, final_rect);
+  m_display_changed = false;
+
+  if (!use_cached_stages)
   {
-    BeginSwapChainRenderPass(target_fb, target_width, target_height);
+    if (!CheckPostProcessingRenderTargets(target_width, target_height, final_rect))
+    {
+      m_post_processing_chain.InvalidateIntermediateCache();
+      BeginSwapChainRenderPass(target_fb, target_width, target_height);
+      RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
+                    texture_view_width, texture_view_height, IsUsingLinearFiltering());
+      return;
+    }
+
+    Vulkan::Texture& input_texture = m_post_processing_input_target->texture;
+    input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    BeginSwapChainRenderPass(m_post_processing_input_target->framebuffer, target_width, target_height);
     RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
                   texture_view_width, texture_view_height, IsUsingLinearFiltering());
-    return;
+    vkCmdEndRenderPass(cmdbuffer);
+    Vulkan::Util::EndDebugScope(g_vulkan_context->GetCurrentCommandBuffer());
+    input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   }
 
-  // downsample/upsample - use same viewport for remainder
-  m_post_processing_input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-  BeginSwapChainRenderPass(m_post_processing_input_framebuffer, target_width, target_height);
-  RenderDisplay(final_left, final_top, final_width, final_height, texture, texture_view_x, texture_view_y,
-                texture_view_width, texture_view_height, IsUsingLinearFiltering());
-  vkCmdEndRenderPass(cmdbuffer);
-  Vulkan::Util::EndDebugScope(g_vulkan_context->GetCurrentCommandBuffer());
-  m_post_processing_input_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-  const s32 orig_texture_width = texture_view_width;
-  const s32 orig_texture_height = texture_view_height;
-  texture = &m_post_processing_input_texture;
-  texture_view_x = final_left;
-  texture_view_y = final_top;
-  texture_view_width = final_width;
-  texture_view_height = final_height;
-
   const u32 final_stage = static_cast<u32>(m_post_processing_stages.size()) - 1u;
-  for (u32 i = 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
+  for (u32 i = use_cached_stages ? final_stage : 0; i < static_cast<u32>(m_post_processing_stages.size()); i++)
   {
     PostProcessingStage& pps = m_post_processing_stages[i];
     const Vulkan::Util::DebugScope stage_scope(g_vulkan_context->GetCurrentCommandBuffer(), "Post Processing Stage: %s",
                                                m_post_processing_chain.GetShaderStage(i).GetName().c_str());
+    SetGPUTimingSection(GetPostProcessingTimingSection(i));
+
+    const Vulkan::Texture* input =
+      &((i == 0) ? m_post_processing_input_target : m_post_processing_stages[i - 1].output_target)->texture;
+    const Common::Rectangle<s32>& input_rect = (i == 0) ? final_rect : m_post_processing_stages[i - 1].output_rect;
 
     if (i != final_stage)
     {
-      pps.output_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-      BeginSwapChainRenderPass(pps.output_framebuffer, target_width, target_height);
+      pps.output_target->texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+      BeginSwapChainRenderPass(pps.output_target->framebuffer, pps.output_target->texture.GetWidth(),
+                               pps.output_target->texture.GetHeight());
+      Vulkan::Util::SetViewportAndScissor(cmdbuffer, pps.output_rect.left, pps.output_rect.top,
+                                          pps.output_rect.GetWidth(), pps.output_rect.GetHeight());
     }
     else
     {
       BeginSwapChainRenderPass(target_fb, target_width, target_height);
+      Vulkan::Util::SetViewportAndScissor(cmdbuffer, final_left, final_top, final_width, final_height);
     }
 
     const bool use_push_constants = m_post_processing_chain.GetShaderStage(i).UsePushConstants();
@@ -1162,15 +1351,15 @@ void VulkanHostDisplay::ApplyPostProcessingChain(VkFramebuffer target_fb, s32 fi
     }
 
     Vulkan::DescriptorSetUpdateBuilder dsupdate;
-    dsupdate.AddCombinedImageSamplerDescriptorWrite(ds, 1, texture->GetView(), m_border_sampler, texture->GetLayout());
+    dsupdate.AddCombinedImageSamplerDescriptorWrite(ds, 1, input->GetView(), m_border_sampler, input->GetLayout());
 
     if (use_push_constants)
     {
       u8 buffer[FrontendCommon::PostProcessingShader::PUSH_CONSTANT_SIZE_THRESHOLD];
       Assert(pps.uniforms_size <= sizeof(buffer));
       m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        buffer, texture->GetWidth(), texture->GetHeight(), texture_view_x, texture_view_y, texture_view_width,
-        texture_view_height, GetWindowWidth(), GetWindowHeight(), orig_texture_width, orig_texture_height,
+        buffer, input->GetWidth(), input->GetHeight(), input_rect.left, input_rect.top, input_rect.GetWidth(),
+        input_rect.GetHeight(), GetWindowWidth(), GetWindowHeight(), texture_view_width, texture_view_height,
         static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
 
       vkCmdPushConstants(cmdbuffer, m_post_process_pipeline_layout,
@@ -1190,9 +1379,9 @@ void VulkanHostDisplay::ApplyPostProcessingChain(VkFramebuffer target_fb, s32 fi
 
       const u32 offset = m_post_processing_ubo.GetCurrentOffset();
       m_post_processing_chain.GetShaderStage(i).FillUniformBuffer(
-        m_post_processing_ubo.GetCurrentHostPointer(), texture->GetWidth(), texture->GetHeight(), texture_view_x,
-        texture_view_y, texture_view_width, texture_view_height, GetWindowWidth(), GetWindowHeight(),
-        orig_texture_width, orig_texture_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
+        m_post_processing_ubo.GetCurrentHostPointer(), input->GetWidth(), input->GetHeight(), input_rect.left,
+        input_rect.top, input_rect.GetWidth(), input_rect.GetHeight(), GetWindowWidth(), GetWindowHeight(),
+        texture_view_width, texture_view_height, static_cast<float>(m_post_processing_timer.GetTimeSeconds()));
       m_post_processing_ubo.CommitMemory(pps.uniforms_size);
 
       dsupdate.AddBufferDescriptorWrite(ds, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
@@ -1210,8 +1399,7 @@ void VulkanHostDisplay::ApplyPostProcessingChain(VkFramebuffer target_fb, s32 fi
     {
       vkCmdEndRenderPass(cmdbuffer);
       Vulkan::Util::EndDebugScope(g_vulkan_context->GetCurrentCommandBuffer());
-      pps.output_texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-      texture = &pps.output_texture;
+      pps.output_target->texture.TransitionToLayout(cmdbuffer, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
   }
 }
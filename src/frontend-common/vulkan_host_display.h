@@ -6,6 +6,7 @@
 #include "common/window_info.h"
 #include "core/host_display.h"
 #include "postprocessing_chain.h"
+#include <deque>
 #include <memory>
 #include <string_view>
 
@@ -58,13 +59,17 @@ public:
   bool Render(bool skip_present) override;
   bool RenderScreenshot(u32 width, u32 height, std::vector<u32>* out_pixels, u32* out_stride,
                         GPUTexture::Format* out_format) override;
+  bool RenderScreenshotAsync(u32 width, u32 height, ScreenshotCallback callback) override;
 
   bool SetGPUTimingEnabled(bool enabled) override;
   float GetAndResetAccumulatedGPUTime() override;
+  void GetAndResetAccumulatedGPUSectionTimes(GPUTimingSectionTimes* times) override;
 
   static AdapterAndModeList StaticGetAdapterAndModeList(const WindowInfo* wi);
 
 protected:
+  void ChangeGPUTimingSection(GPUTimingSection section) override;
+
   struct PushConstants
   {
     float src_rect_left;
@@ -73,6 +78,16 @@ protected:
     float src_rect_height;
   };
 
+  struct PostProcessingTarget
+  {
+    PostProcessingTarget() = default;
+    ~PostProcessingTarget();
+
+    Vulkan::Texture texture;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    u32 last_used = 0;
+  };
+
   struct PostProcessingStage
   {
     PostProcessingStage() = default;
@@ -80,16 +95,37 @@ protected:
     ~PostProcessingStage();
 
     VkPipeline pipeline = VK_NULL_HANDLE;
-    VkFramebuffer output_framebuffer = VK_NULL_HANDLE;
-    Vulkan::Texture output_texture;
+    PostProcessingTarget* output_target = nullptr;
+    Common::Rectangle<s32> output_rect;
     u32 uniforms_size = 0;
   };
 
-  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height);
+  PostProcessingTarget* GetPostProcessingTarget(u32 width, u32 height, const PostProcessingTarget* input);
+  void DestroyPostProcessingTargets();
+  bool CheckPostProcessingRenderTargets(u32 target_width, u32 target_height, const Common::Rectangle<s32>& final_rect);
   void ApplyPostProcessingChain(VkFramebuffer target_fb, s32 final_left, s32 final_top, s32 final_width,
                                 s32 final_height, Vulkan::Texture* texture, s32 texture_view_x, s32 texture_view_y,
                                 s32 texture_view_width, s32 texture_view_height, u32 target_width, u32 target_height);
 
+  struct PendingScreenshot
+  {
+    VkBuffer buffer;
+    VmaAllocation allocation;
+    const u8* map;
+    u64 fence_counter;
+    u32 width;
+    u32 height;
+    u32 pitch;
+    GPUTexture::Format format;
+    ScreenshotCallback callback;
+  };
+
+  static bool GetScreenshotFormat(VkFormat format, GPUTexture::Format* out_format);
+  bool RenderScreenshotToTexture(u32 width, u32 height, VkFormat format, Vulkan::Texture* tex, VkFramebuffer* fb);
+
+  /// Hands screenshots whose readback has completed to their callbacks. If wait is set, waits for all of them.
+  void CompletePendingScreenshots(bool wait);
+
   VkRenderPass GetRenderPassForDisplay() const;
 
   bool CheckStagingBufferSize(u32 required_size);
@@ -127,15 +163,18 @@ protected:
   u32 m_readback_staging_buffer_size = 0;
   bool m_is_adreno = false;
 
+  std::deque<PendingScreenshot> m_pending_screenshots;
+
   VkDescriptorSetLayout m_post_process_descriptor_set_layout = VK_NULL_HANDLE;
   VkDescriptorSetLayout m_post_process_ubo_descriptor_set_layout = VK_NULL_HANDLE;
   VkPipelineLayout m_post_process_pipeline_layout = VK_NULL_HANDLE;
   VkPipelineLayout m_post_process_ubo_pipeline_layout = VK_NULL_HANDLE;
 
   FrontendCommon::PostProcessingChain m_post_processing_chain;
-  Vulkan::Texture m_post_processing_input_texture;
-  VkFramebuffer m_post_processing_input_framebuffer = VK_NULL_HANDLE;
+  PostProcessingTarget* m_post_processing_input_target = nullptr;
   Vulkan::StreamBuffer m_post_processing_ubo;
   std::vector<PostProcessingStage> m_post_processing_stages;
+  std::vector<std::unique_ptr<PostProcessingTarget>> m_post_processing_targets;
+  u32 m_post_processing_target_counter = 0;
   Common::Timer m_post_processing_timer;
 };
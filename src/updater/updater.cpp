@@ -4,6 +4,7 @@
 #include "common/minizip_helpers.h"
 #include "common/string_util.h"
 #include "common/win32_progress_callback.h"
+#include "xxhash.h"
 #include <algorithm>
 #include <cstdio>
 #include <cstring>
@@ -90,8 +91,7 @@ bool Updater::ParseZip()
       return false;
     }
 
-    FileToUpdate entry;
-    entry.original_zip_filename = zip_filename_buffer;
+    const std::string original_zip_filename(zip_filename_buffer);
 
     // replace forward slashes with backslashes
     size_t len = std::strlen(zip_filename_buffer);
@@ -108,12 +108,28 @@ bool Updater::ParseZip()
     // skip directories (we sort them out later)
     if (len > 0 && zip_filename_buffer[len - 1] != FS_OSPATH_SEPARATOR_CHARACTER)
     {
+      // deltas share an entry with the whole file, if the package has both
+      const size_t extension_len = std::strlen(DELTA_EXTENSION);
+      const bool is_delta = (len > extension_len &&
+                             StringUtil::Strcasecmp(&zip_filename_buffer[len - extension_len], DELTA_EXTENSION) == 0);
+      if (is_delta)
+        zip_filename_buffer[len - extension_len] = '\0';
+
       // skip updater itself, since it was already pre-extracted.
       if (StringUtil::Strcasecmp(zip_filename_buffer, "updater.exe") != 0)
       {
-        entry.destination_filename = zip_filename_buffer;
-        m_progress->DisplayFormattedInformation("Found file in zip: '%s'", entry.destination_filename.c_str());
-        m_update_paths.push_back(std::move(entry));
+        auto iter = std::find_if(m_update_paths.begin(), m_update_paths.end(), [&zip_filename_buffer](const auto& it) {
+          return (it.destination_filename == zip_filename_buffer);
+        });
+        if (iter == m_update_paths.end())
+        {
+          iter = m_update_paths.emplace(m_update_paths.end());
+          iter->destination_filename = zip_filename_buffer;
+        }
+
+        (is_delta ? iter->delta_zip_filename : iter->original_zip_filename) = original_zip_filename;
+        m_progress->DisplayFormattedInformation("Found %s in zip: '%s'", is_delta ? "delta" : "file",
+                                                iter->destination_filename.c_str());
       }
     }
 
@@ -199,66 +215,244 @@ bool Updater::StageUpdate()
 
   for (const FileToUpdate& ftu : m_update_paths)
   {
+    const std::string destination_file = StringUtil::StdStringFromFormat(
+      "%s" FS_OSPATH_SEPARATOR_STR "%s", m_staging_directory.c_str(), ftu.destination_filename.c_str());
+
+    if (!ftu.delta_zip_filename.empty())
+    {
+      m_progress->SetFormattedStatusText("Patching '%s'...", ftu.destination_filename.c_str());
+      if (ApplyDelta(ftu, destination_file))
+      {
+        m_progress->IncrementProgressValue();
+        continue;
+      }
+
+      if (ftu.original_zip_filename.empty())
+      {
+        m_progress->DisplayFormattedModalError(
+          "Failed to patch '%s', and the update has no full copy of it. Please download the full release instead.",
+          ftu.destination_filename.c_str());
+        return false;
+      }
+
+      m_progress->DisplayFormattedWarning("Patching '%s' failed, extracting full file instead",
+                                          ftu.destination_filename.c_str());
+    }
+
     m_progress->SetFormattedStatusText("Extracting '%s'...", ftu.original_zip_filename.c_str());
+    if (!ExtractFile(ftu, destination_file))
+      return false;
 
-    if (unzLocateFile(m_zf, ftu.original_zip_filename.c_str(), 0) != UNZ_OK)
+    m_progress->IncrementProgressValue();
+  }
+
+  return true;
+}
+
+bool Updater::OpenZipFile(const std::string& zip_filename)
+{
+  if (unzLocateFile(m_zf, zip_filename.c_str(), 0) != UNZ_OK)
+  {
+    m_progress->DisplayFormattedError("Unable to locate file '%s' in zip", zip_filename.c_str());
+    return false;
+  }
+  else if (unzOpenCurrentFile(m_zf) != UNZ_OK)
+  {
+    m_progress->DisplayFormattedError("Failed to open file '%s' in zip", zip_filename.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool Updater::ReadZipFile(const std::string& zip_filename, void* buffer, u32 size)
+{
+  u8* ptr = static_cast<u8*>(buffer);
+  while (size > 0)
+  {
+    const int byte_count = unzReadCurrentFile(m_zf, ptr, size);
+    if (byte_count <= 0)
     {
-      m_progress->DisplayFormattedModalError("Unable to locate file '%s' in zip", ftu.original_zip_filename.c_str());
+      m_progress->DisplayFormattedError("Failed to read file '%s' from zip", zip_filename.c_str());
       return false;
     }
-    else if (unzOpenCurrentFile(m_zf) != UNZ_OK)
+
+    ptr += static_cast<u32>(byte_count);
+    size -= static_cast<u32>(byte_count);
+  }
+
+  return true;
+}
+
+bool Updater::ExtractFile(const FileToUpdate& ftu, const std::string& destination_file)
+{
+  if (!OpenZipFile(ftu.original_zip_filename))
+  {
+    m_progress->DisplayFormattedModalError("Failed to extract '%s' from zip", ftu.original_zip_filename.c_str());
+    return false;
+  }
+
+  m_progress->DisplayFormattedInformation("Extracting '%s'...", ftu.destination_filename.c_str());
+
+  std::FILE* fp = FileSystem::OpenCFile(destination_file.c_str(), "wb");
+  if (!fp)
+  {
+    m_progress->DisplayFormattedModalError("Failed to open staging output file '%s'", destination_file.c_str());
+    unzCloseCurrentFile(m_zf);
+    return false;
+  }
+
+  static constexpr u32 CHUNK_SIZE = 4096;
+  u8 buffer[CHUNK_SIZE];
+  for (;;)
+  {
+    int byte_count = unzReadCurrentFile(m_zf, buffer, CHUNK_SIZE);
+    if (byte_count < 0)
     {
-      m_progress->DisplayFormattedModalError("Failed to open file '%s' in zip", ftu.original_zip_filename.c_str());
+      m_progress->DisplayFormattedModalError("Failed to read file '%s' from zip", ftu.original_zip_filename.c_str());
+      std::fclose(fp);
+      FileSystem::DeleteFile(destination_file.c_str());
+      unzCloseCurrentFile(m_zf);
       return false;
     }
+    else if (byte_count == 0)
+    {
+      // end of file
+      break;
+    }
 
-    m_progress->DisplayFormattedInformation("Extracting '%s'...", ftu.destination_filename.c_str());
-
-    const std::string destination_file = StringUtil::StdStringFromFormat(
-      "%s" FS_OSPATH_SEPARATOR_STR "%s", m_staging_directory.c_str(), ftu.destination_filename.c_str());
-    std::FILE* fp = FileSystem::OpenCFile(destination_file.c_str(), "wb");
-    if (!fp)
+    if (std::fwrite(buffer, static_cast<size_t>(byte_count), 1, fp) != 1)
     {
-      m_progress->DisplayFormattedModalError("Failed to open staging output file '%s'", destination_file.c_str());
+      m_progress->DisplayFormattedModalError("Failed to write to file '%s'", destination_file.c_str());
+      std::fclose(fp);
+      FileSystem::DeleteFile(destination_file.c_str());
       unzCloseCurrentFile(m_zf);
       return false;
     }
+  }
+
+  std::fclose(fp);
+  unzCloseCurrentFile(m_zf);
+  return true;
+}
+
+bool Updater::ApplyDelta(const FileToUpdate& ftu, const std::string& destination_file)
+{
+  const std::string source_file = StringUtil::StdStringFromFormat(
+    "%s" FS_OSPATH_SEPARATOR_STR "%s", m_destination_directory.c_str(), ftu.destination_filename.c_str());
+  m_progress->DisplayFormattedInformation("Patching '%s'...", source_file.c_str());
+
+  if (!OpenZipFile(ftu.delta_zip_filename))
+    return false;
+
+  DeltaHeader header;
+  if (!ReadZipFile(ftu.delta_zip_filename, &header, sizeof(header)) || header.magic != DELTA_MAGIC ||
+      header.version != DELTA_VERSION)
+  {
+    m_progress->DisplayFormattedError("Delta '%s' is invalid or unsupported", ftu.delta_zip_filename.c_str());
+    unzCloseCurrentFile(m_zf);
+    return false;
+  }
+
+  FileSystem::ManagedCFilePtr source_fp = FileSystem::OpenManagedCFile(source_file.c_str(), "rb");
+  FileSystem::ManagedCFilePtr output_fp = FileSystem::OpenManagedCFile(destination_file.c_str(), "wb");
+  std::unique_ptr<XXH64_state_t, decltype(&XXH64_freeState)> hash_state(XXH64_createState(), XXH64_freeState);
+  if (!source_fp || !output_fp || !hash_state)
+  {
+    m_progress->DisplayFormattedError("Failed to open '%s' or '%s'", source_file.c_str(), destination_file.c_str());
+    unzCloseCurrentFile(m_zf);
+    return false;
+  }
+
+  static constexpr u32 CHUNK_SIZE = 65536;
+  std::vector<u8> buffer(CHUNK_SIZE);
+
+  // The delta only describes how to get from one particular build, so make sure that's what is installed.
+  bool result = (FileSystem::FSize64(source_fp.get()) == static_cast<s64>(header.source_size));
+  XXH64_reset(hash_state.get(), 0);
+  for (u64 remaining = header.source_size; result && remaining > 0;)
+  {
+    const u32 size = static_cast<u32>(std::min<u64>(remaining, CHUNK_SIZE));
+    result = (std::fread(buffer.data(), size, 1, source_fp.get()) == 1);
+    XXH64_update(hash_state.get(), buffer.data(), size);
+    remaining -= size;
+  }
+  if (!result || XXH64_digest(hash_state.get()) != header.source_hash)
+  {
+    m_progress->DisplayFormattedError("Installed '%s' doesn't match the version the delta was built from",
+                                      ftu.destination_filename.c_str());
+    output_fp.reset();
+    FileSystem::DeleteFile(destination_file.c_str());
+    unzCloseCurrentFile(m_zf);
+    return false;
+  }
+
+  // Ops and inserted data are streamed straight from the zip into the staged file, hashing the output as it's written.
+  u64 output_size = 0;
+  XXH64_reset(hash_state.get(), 0);
+  for (;;)
+  {
+    DeltaOp op;
+    if (!ReadZipFile(ftu.delta_zip_filename, &op, sizeof(op)))
+    {
+      result = false;
+      break;
+    }
 
-    static constexpr u32 CHUNK_SIZE = 4096;
-    u8 buffer[CHUNK_SIZE];
-    for (;;)
+    if (op.type == DeltaOpType::End)
+      break;
+
+    if ((op.type != DeltaOpType::Copy && op.type != DeltaOpType::Insert) ||
+        (op.type == DeltaOpType::Copy &&
+         (op.source_offset > header.source_size || op.length > (header.source_size - op.source_offset) ||
+          FileSystem::FSeek64(source_fp.get(), static_cast<s64>(op.source_offset), SEEK_SET) != 0)))
     {
-      int byte_count = unzReadCurrentFile(m_zf, buffer, CHUNK_SIZE);
-      if (byte_count < 0)
-      {
-        m_progress->DisplayFormattedModalError("Failed to read file '%s' from zip", ftu.original_zip_filename.c_str());
-        std::fclose(fp);
-        FileSystem::DeleteFile(destination_file.c_str());
-        unzCloseCurrentFile(m_zf);
-        return false;
-      }
-      else if (byte_count == 0)
-      {
-        // end of file
-        break;
-      }
+      m_progress->DisplayFormattedError("Delta '%s' is corrupted", ftu.delta_zip_filename.c_str());
+      result = false;
+      break;
+    }
+
+    for (u32 remaining = op.length; result && remaining > 0;)
+    {
+      const u32 size = std::min(remaining, CHUNK_SIZE);
+      if (op.type == DeltaOpType::Copy)
+        result = (std::fread(buffer.data(), size, 1, source_fp.get()) == 1);
+      else
+        result = ReadZipFile(ftu.delta_zip_filename, buffer.data(), size);
 
-      if (std::fwrite(buffer, static_cast<size_t>(byte_count), 1, fp) != 1)
+      if (result && std::fwrite(buffer.data(), size, 1, output_fp.get()) != 1)
       {
-        m_progress->DisplayFormattedModalError("Failed to write to file '%s'", destination_file.c_str());
-        std::fclose(fp);
-        FileSystem::DeleteFile(destination_file.c_str());
-        unzCloseCurrentFile(m_zf);
-        return false;
+        m_progress->DisplayFormattedError("Failed to write to file '%s'", destination_file.c_str());
+        result = false;
       }
+
+      XXH64_update(hash_state.get(), buffer.data(), size);
+      output_size += size;
+      remaining -= size;
     }
 
-    std::fclose(fp);
-    unzCloseCurrentFile(m_zf);
-    m_progress->IncrementProgressValue();
+    if (!result)
+      break;
   }
 
-  return true;
+  unzCloseCurrentFile(m_zf);
+  if (result && std::fflush(output_fp.get()) != 0)
+  {
+    m_progress->DisplayFormattedError("Failed to write to file '%s'", destination_file.c_str());
+    result = false;
+  }
+  output_fp.reset();
+
+  if (result && (output_size != header.target_size || XXH64_digest(hash_state.get()) != header.target_hash))
+  {
+    m_progress->DisplayFormattedError("Patched '%s' doesn't match the expected hash", ftu.destination_filename.c_str());
+    result = false;
+  }
+
+  if (!result)
+    FileSystem::DeleteFile(destination_file.c_str());
+
+  return result;
 }
 
 bool Updater::CommitUpdate()
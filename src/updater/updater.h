@@ -21,14 +21,53 @@ public:
 private:
   static bool RecursiveDeleteDirectory(const char* path);
 
+  // Delta packages carry "<file>.dsdelta" entries, which rebuild a file from the installed copy. They consist of a
+  // DeltaHeader, followed by DeltaOps, each INSERT op followed by its data, and end with an END op. Little-endian.
+  static constexpr u32 DELTA_MAGIC = 0x4C445344; // DSDL
+  static constexpr u32 DELTA_VERSION = 1;
+  static constexpr const char* DELTA_EXTENSION = ".dsdelta";
+
+#pragma pack(push, 1)
+  struct DeltaHeader
+  {
+    u32 magic;
+    u32 version;
+    u64 source_size;
+    u64 source_hash; // XXH64, seed 0
+    u64 target_size;
+    u64 target_hash;
+  };
+
+  enum class DeltaOpType : u32
+  {
+    Copy,   // copy length bytes from source_offset in the installed file
+    Insert, // copy length bytes which follow the op
+    End
+  };
+
+  struct DeltaOp
+  {
+    DeltaOpType type;
+    u32 length;
+    u64 source_offset;
+  };
+#pragma pack(pop)
+
   struct FileToUpdate
   {
+    // either can be empty, when both are present the whole file is the fallback for the delta
     std::string original_zip_filename;
+    std::string delta_zip_filename;
     std::string destination_filename;
   };
 
   bool ParseZip();
 
+  bool OpenZipFile(const std::string& zip_filename);
+  bool ReadZipFile(const std::string& zip_filename, void* buffer, u32 size);
+  bool ExtractFile(const FileToUpdate& ftu, const std::string& destination_file);
+  bool ApplyDelta(const FileToUpdate& ftu, const std::string& destination_file);
+
   std::string m_destination_directory;
   std::string m_staging_directory;
 
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <limits>
 
 #ifdef __APPLE__
 #include <stdlib.h> // alloca
@@ -61,8 +62,9 @@ u32 AudioStream::GetMSForBufferSize(u32 sample_rate, u32 buffer_size)
   return (buffer_size * 1000u) / sample_rate;
 }
 
-static constexpr const auto s_stretch_mode_names = make_array("None", "Resample", "TimeStretch");
-static constexpr const auto s_stretch_mode_display_names = make_array("None", "Resampling", "Time Stretching");
+static constexpr const auto s_stretch_mode_names = make_array("None", "Resample", "TimeStretch", "RateControl");
+static constexpr const auto s_stretch_mode_display_names =
+  make_array("None", "Resampling", "Time Stretching", "Rate Control (Low Latency)");
 
 const char* AudioStream::GetStretchModeName(AudioStretchMode mode)
 {
@@ -100,10 +102,16 @@ void AudioStream::ReadFrames(s16* bData, u32 nFrames)
   u32 frames_to_read = nFrames;
   u32 silence_frames = 0;
 
+  if (m_stretch_mode == AudioStretchMode::RateControl)
+    RateControlUpdateTarget(available_frames, nFrames);
+
   if (m_filling)
   {
-    u32 toFill = m_buffer_size / ((m_stretch_mode != AudioStretchMode::TimeStretch) ? 32 : 400);
-    toFill = GetAlignedBufferSize(toFill);
+    u32 toFill;
+    if (m_stretch_mode == AudioStretchMode::RateControl)
+      toFill = m_rate_control_target.load(std::memory_order_relaxed);
+    else
+      toFill = GetAlignedBufferSize(m_buffer_size / ((m_stretch_mode != AudioStretchMode::TimeStretch) ? 32 : 400));
 
     if (available_frames < toFill)
     {
@@ -122,6 +130,7 @@ void AudioStream::ReadFrames(s16* bData, u32 nFrames)
     silence_frames = frames_to_read - available_frames;
     frames_to_read = available_frames;
     m_filling = true;
+    m_underrun_count.fetch_add(1, std::memory_order_relaxed);
 
     if (m_stretch_mode == AudioStretchMode::TimeStretch)
       StretchUnderrun();
@@ -240,6 +249,7 @@ void AudioStream::BaseInitialize()
 void AudioStream::AllocateBuffer()
 {
   // use a larger buffer when time stretching, since we need more input
+  // rate control also gets some headroom, so the target can be raised up to the requested buffer size
   const u32 multplier =
     (m_stretch_mode == AudioStretchMode::TimeStretch) ? 16 : ((m_stretch_mode == AudioStretchMode::Off) ? 1 : 2);
   m_buffer_size = GetAlignedBufferSize(((m_buffer_ms * multplier) * m_sample_rate) / 1000);
@@ -259,7 +269,7 @@ void AudioStream::DestroyBuffer()
 
 void AudioStream::EmptyBuffer()
 {
-  if (m_stretch_mode != AudioStretchMode::Off)
+  if (m_soundtouch)
   {
     m_soundtouch->clear();
     if (m_stretch_mode == AudioStretchMode::TimeStretch)
@@ -317,6 +327,19 @@ void AudioStream::SetStretchMode(AudioStretchMode mode)
     SetPaused(false);
 }
 
+void AudioStream::SetChunkDecimation(u32 factor)
+{
+  if (m_chunk_decimation == factor)
+    return;
+
+  // don't let the stretcher pick up where it left off before the gap
+  if (m_chunk_decimation == 1 && m_soundtouch)
+    m_soundtouch->clear();
+
+  m_chunk_decimation = factor;
+  m_chunk_decimation_counter = 0;
+}
+
 void AudioStream::SetPaused(bool paused)
 {
   m_paused = paused;
@@ -329,7 +352,27 @@ void AudioStream::SetOutputVolume(u32 volume)
 
 void AudioStream::BeginWrite(SampleType** buffer_ptr, u32* num_frames)
 {
-  // TODO: Write directly to buffer when not using stretching.
+  // Without stretching, the ring is already in the format the backend reads, so frames can be written straight into
+  // it. Only the writer moves wpos, so the space between it and rpos can't change under us, other than growing.
+  // A partially filled staging chunk has to be finished first, to keep the frames in order.
+  if (m_stretch_mode == AudioStretchMode::Off && m_chunk_decimation == 1 && m_volume != 0 &&
+      m_staging_buffer_pos == 0)
+  {
+    // one frame is always left empty, since wpos == rpos means the buffer is empty
+    const u32 wpos = m_wpos.load(std::memory_order_relaxed);
+    const u32 free = m_buffer_size - GetBufferedFramesRelaxed() - 1;
+    const u32 contiguous = std::min(m_buffer_size - wpos, free);
+    if (contiguous > 0)
+    {
+      *buffer_ptr = reinterpret_cast<s16*>(&m_buffer[wpos]);
+      *num_frames = contiguous;
+      m_direct_write = true;
+      return;
+    }
+
+    // full, let the staging path drop the chunk
+  }
+
   *buffer_ptr = reinterpret_cast<s16*>(&m_staging_buffer[m_staging_buffer_pos]);
   *num_frames = CHUNK_SIZE - m_staging_buffer_pos;
 }
@@ -341,6 +384,17 @@ void AudioStream::WriteFrames(const SampleType* frames, u32 num_frames)
 
 void AudioStream::EndWrite(u32 num_frames)
 {
+  if (m_direct_write)
+  {
+    m_direct_write = false;
+
+    u32 wpos = m_wpos.load(std::memory_order_relaxed) + num_frames;
+    DebugAssert(wpos <= m_buffer_size);
+    wpos = (wpos == m_buffer_size) ? 0 : wpos;
+    m_wpos.store(wpos, std::memory_order_release);
+    return;
+  }
+
   // don't bother committing anything when muted
   if (m_volume == 0)
     return;
@@ -352,7 +406,19 @@ void AudioStream::EndWrite(u32 num_frames)
 
   m_staging_buffer_pos = 0;
 
-  if (m_stretch_mode != AudioStretchMode::Off)
+  if (m_chunk_decimation != 1)
+  {
+    if (m_chunk_decimation == 0 || (++m_chunk_decimation_counter) < m_chunk_decimation)
+      return;
+
+    m_chunk_decimation_counter = 0;
+    InternalWriteFrames(m_staging_buffer.data(), CHUNK_SIZE);
+    return;
+  }
+
+  if (m_stretch_mode == AudioStretchMode::RateControl)
+    RateControlWrite();
+  else if (m_stretch_mode != AudioStretchMode::Off)
     StretchWrite();
   else
     InternalWriteFrames(m_staging_buffer.data(), CHUNK_SIZE);
@@ -503,6 +569,22 @@ void AudioStream::StretchAllocate()
   if (m_stretch_mode == AudioStretchMode::Off)
     return;
 
+  if (m_stretch_mode == AudioStretchMode::RateControl)
+  {
+    // Start at half of the requested buffer, and let underruns raise it.
+    m_rate_control_target.store(
+      std::max<u32>(GetAlignedBufferSize(m_target_buffer_size / 2), RATE_CONTROL_MIN_TARGET),
+      std::memory_order_relaxed);
+    m_rate_control_position = 0;
+    m_rate_control_buffer_pos = 0;
+    m_rate_control_last_frame = 0;
+    m_rate_control_correction = 1.0f;
+    m_rate_control_min_margin = std::numeric_limits<u32>::max();
+    m_rate_control_reads = 0;
+    m_staging_buffer_pos = 0;
+    return;
+  }
+
   m_soundtouch = std::make_unique<soundtouch::SoundTouch>();
   m_soundtouch->setSampleRate(m_sample_rate);
   m_soundtouch->setChannels(m_channels);
@@ -680,3 +762,81 @@ void AudioStream::StretchOverrun()
   const u32 discard = CHUNK_SIZE * 2;
   m_rpos.store((m_rpos.load(std::memory_order_acquire) + discard) % m_buffer_size, std::memory_order_release);
 }
+
+// Rate control: instead of stretching, the input is resampled at a rate slightly off the nominal rate, depending on
+// how far the buffer is from its target. A 0.5% change isn't audible as a pitch shift, and linear interpolation is
+// far cheaper than SoundTouch, so the buffer can be kept much smaller.
+
+void AudioStream::RateControlWrite()
+{
+  static constexpr float MAX_ADJUSTMENT = 0.005f;
+  static constexpr float SMOOTHING = 1.0f / 16.0f;
+
+  const float target = static_cast<float>(m_rate_control_target.load(std::memory_order_relaxed));
+  const float usage = static_cast<float>(GetBufferedFramesRelaxed());
+  const float direction = std::clamp((usage - target) / target, -1.0f, 1.0f);
+  m_rate_control_correction += ((1.0f + direction * MAX_ADJUSTMENT) - m_rate_control_correction) * SMOOTHING;
+
+  // 16.16 position in the staging buffer, with the last frame of the previous chunk before index 0
+  const u32 step = std::max(static_cast<u32>(65536.0f * m_nominal_rate * m_rate_control_correction), 1u);
+  u32 pos = m_rate_control_position;
+  while (pos < (CHUNK_SIZE << 16))
+  {
+    const u32 index = pos >> 16;
+    const s32 frac = static_cast<s32>((pos & 0xFFFFu) >> 1);
+    const u32 frame0 = static_cast<u32>((index == 0) ? m_rate_control_last_frame : m_staging_buffer[index - 1]);
+    const u32 frame1 = static_cast<u32>(m_staging_buffer[index]);
+
+    const s32 left0 = static_cast<s16>(frame0);
+    const s32 right0 = static_cast<s16>(frame0 >> 16);
+    const s32 left = left0 + (((static_cast<s32>(static_cast<s16>(frame1)) - left0) * frac) >> 15);
+    const s32 right = right0 + (((static_cast<s32>(static_cast<s16>(frame1 >> 16)) - right0) * frac) >> 15);
+    m_rate_control_buffer[m_rate_control_buffer_pos++] =
+      static_cast<s32>((static_cast<u32>(left) & 0xFFFFu) | (static_cast<u32>(right) << 16));
+    if (m_rate_control_buffer_pos == CHUNK_SIZE)
+    {
+      InternalWriteFrames(m_rate_control_buffer.data(), CHUNK_SIZE);
+      m_rate_control_buffer_pos = 0;
+    }
+
+    pos += step;
+  }
+
+  m_rate_control_position = pos - (CHUNK_SIZE << 16);
+  m_rate_control_last_frame = m_staging_buffer[CHUNK_SIZE - 1];
+}
+
+void AudioStream::RateControlUpdateTarget(u32 available_frames, u32 read_frames)
+{
+  // The target follows the jitter of the writer and the backend's callbacks: it grows by half when the buffer runs
+  // dry, and shrinks by an eighth when it hasn't come close to running dry over the last window of reads.
+  const u32 max_target = std::min(m_target_buffer_size, m_buffer_size - (CHUNK_SIZE * 2));
+  u32 target = m_rate_control_target.load(std::memory_order_relaxed);
+  if (available_frames < read_frames)
+  {
+    if (!m_filling && target < max_target)
+    {
+      target = std::min(GetAlignedBufferSize(target + (target / 2)), max_target);
+      m_rate_control_target.store(target, std::memory_order_relaxed);
+      Log_VerbosePrintf("Underrun, raising rate control target to %u frames", target);
+    }
+
+    m_rate_control_min_margin = std::numeric_limits<u32>::max();
+    m_rate_control_reads = 0;
+    return;
+  }
+
+  m_rate_control_min_margin = std::min(m_rate_control_min_margin, available_frames - read_frames);
+  if ((++m_rate_control_reads) < RATE_CONTROL_WINDOW)
+    return;
+
+  if (m_rate_control_min_margin > (target / 2) && target > RATE_CONTROL_MIN_TARGET)
+  {
+    target = std::max<u32>(Common::AlignDownPow2(target - (target / 8), CHUNK_SIZE), RATE_CONTROL_MIN_TARGET);
+    m_rate_control_target.store(target, std::memory_order_relaxed);
+    Log_DebugPrintf("Lowering rate control target to %u frames", target);
+  }
+
+  m_rate_control_min_margin = std::numeric_limits<u32>::max();
+  m_rate_control_reads = 0;
+}
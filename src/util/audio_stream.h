@@ -19,6 +19,7 @@ enum class AudioStretchMode : u8
   Off,
   Resample,
   TimeStretch,
+  RateControl,
   Count
 };
 
@@ -54,11 +55,16 @@ public:
 
   u32 GetBufferedFramesRelaxed() const;
 
+  /// Number of times the output ran dry since the stream was created. Can be read from any thread.
+  ALWAYS_INLINE u32 GetUnderrunCount() const { return m_underrun_count.load(std::memory_order_relaxed); }
+
   /// Temporarily pauses the stream, preventing it from requesting data.
   virtual void SetPaused(bool paused);
 
   virtual void SetOutputVolume(u32 volume);
 
+  /// Returns space for up to num_frames frames. With stretching off, this points directly into the output ring, so
+  /// the frames reach the backend as soon as EndWrite() is called, rather than once a whole chunk has been staged.
   void BeginWrite(SampleType** buffer_ptr, u32* num_frames);
   void WriteFrames(const SampleType* frames, u32 num_frames);
   void EndWrite(u32 num_frames);
@@ -72,6 +78,10 @@ public:
 
   void SetStretchMode(AudioStretchMode mode);
 
+  /// Writes only one of every N chunks, bypassing stretching. Used when fast forwarding, where the stretcher's cost
+  /// grows with the speed. 1 writes every chunk as normal, 0 drops all of them.
+  void SetChunkDecimation(u32 factor);
+
   static std::unique_ptr<AudioStream> CreateNullStream(u32 sample_rate, u32 channels, u32 buffer_ms);
 
 protected:
@@ -97,6 +107,9 @@ private:
     AVERAGING_WINDOW = 50,
     STRETCH_RESET_THRESHOLD = 5,
     TARGET_IPS = 691,
+
+    RATE_CONTROL_MIN_TARGET = CHUNK_SIZE * 2,
+    RATE_CONTROL_WINDOW = 64,
   };
 
   void AllocateBuffer();
@@ -113,11 +126,15 @@ private:
   float AddAndGetAverageTempo(float val);
   void UpdateStretchTempo();
 
+  void RateControlWrite();
+  void RateControlUpdateTarget(u32 available_frames, u32 read_frames);
+
   u32 m_buffer_size = 0;
   std::unique_ptr<s32[]> m_buffer;
 
   std::atomic<u32> m_rpos{0};
   std::atomic<u32> m_wpos{0};
+  std::atomic<u32> m_underrun_count{0};
 
   std::unique_ptr<soundtouch::SoundTouch> m_soundtouch;
 
@@ -132,6 +149,12 @@ private:
   u32 m_average_available = 0;
   u32 m_staging_buffer_pos = 0;
 
+  u32 m_chunk_decimation = 1;
+  u32 m_chunk_decimation_counter = 0;
+
+  // set by BeginWrite() when it returned a pointer into the ring rather than the staging buffer
+  bool m_direct_write = false;
+
   std::array<float, AVERAGING_BUFFER_SIZE> m_average_fullness = {};
 
   // temporary staging buffer, used for timestretching
@@ -139,6 +162,17 @@ private:
 
   // float buffer, soundtouch only accepts float samples as input
   alignas(16) std::array<float, CHUNK_SIZE * MAX_CHANNELS> m_float_buffer;
+
+  // rate control, resampler state is only touched by the writer, and the target by the reader
+  u32 m_rate_control_position = 0;
+  u32 m_rate_control_buffer_pos = 0;
+  s32 m_rate_control_last_frame = 0;
+  float m_rate_control_correction = 1.0f;
+  std::atomic<u32> m_rate_control_target{0};
+  u32 m_rate_control_min_margin = 0;
+  u32 m_rate_control_reads = 0;
+
+  alignas(16) std::array<s32, CHUNK_SIZE> m_rate_control_buffer;
 };
 
 #ifdef _MSC_VER
@@ -0,0 +1,278 @@
+#include "cd_flac_reader.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include <algorithm>
+#include <cstring>
+Log_SetChannel(CDFLACReader);
+
+// Sync code, header fields, up to 7 bytes of coded frame number, 16-bit block size and CRC.
+static constexpr u32 MAX_FRAME_HEADER_SIZE = 16;
+
+static size_t FLACReadCallback(void* userdata, void* buffer, size_t bytes)
+{
+  return std::fread(buffer, 1, bytes, static_cast<std::FILE*>(userdata));
+}
+
+static drflac_bool32 FLACSeekCallback(void* userdata, int offset, drflac_seek_origin origin)
+{
+  return (FileSystem::FSeek64(static_cast<std::FILE*>(userdata), offset,
+                              (origin == drflac_seek_origin_start) ? SEEK_SET : SEEK_CUR) == 0);
+}
+
+static u8 ComputeFrameHeaderCRC(const u8* data, u32 size)
+{
+  u8 crc = 0;
+  for (u32 i = 0; i < size; i++)
+  {
+    crc ^= data[i];
+    for (u32 bit = 0; bit < 8; bit++)
+      crc = (crc & 0x80) ? static_cast<u8>((crc << 1) ^ 0x07) : static_cast<u8>(crc << 1);
+  }
+
+  return crc;
+}
+
+static bool ParseFrameHeader(const u8* data, u32 max_block_size, u64* first_frame, u32* block_size)
+{
+  // 14-bit sync code, a reserved zero bit, then fixed or variable block size
+  if (data[0] != 0xFF || (data[1] & 0xFE) != 0xF8)
+    return false;
+
+  // CD audio is always 44.1KHz 16-bit stereo, which also weeds out most sync codes which are really audio data
+  const u32 block_size_code = data[2] >> 4;
+  const u32 sample_rate_code = data[2] & 0x0F;
+  const u32 channel_assignment = data[3] >> 4;
+  const u32 sample_size_code = (data[3] >> 1) & 0x07;
+  if (block_size_code == 0 || (sample_rate_code != 0 && sample_rate_code != 9) ||
+      (channel_assignment != 1 && (channel_assignment < 8 || channel_assignment > 10)) ||
+      (sample_size_code != 0 && sample_size_code != 4) || (data[3] & 0x01) != 0)
+  {
+    return false;
+  }
+
+  // frame number for fixed block sizes, sample number for variable, coded like UTF-8
+  u32 pos = 4;
+  u64 number = data[pos++];
+  u32 extra_bytes = 0;
+  if (number & 0x80)
+  {
+    u32 mask = 0x40;
+    for (; number & mask; mask >>= 1)
+      extra_bytes++;
+    if (extra_bytes == 0 || extra_bytes > 6)
+      return false;
+
+    number &= mask - 1;
+  }
+  for (u32 i = 0; i < extra_bytes; i++)
+  {
+    const u8 byte = data[pos++];
+    if ((byte & 0xC0) != 0x80)
+      return false;
+
+    number = (number << 6) | (byte & 0x3F);
+  }
+
+  u32 size;
+  if (block_size_code == 1)
+  {
+    size = 192;
+  }
+  else if (block_size_code <= 5)
+  {
+    size = 576u << (block_size_code - 2);
+  }
+  else if (block_size_code == 6)
+  {
+    size = ZeroExtend32(data[pos++]) + 1;
+  }
+  else if (block_size_code == 7)
+  {
+    size = ((ZeroExtend32(data[pos]) << 8) | ZeroExtend32(data[pos + 1])) + 1;
+    pos += 2;
+  }
+  else
+  {
+    size = 256u << (block_size_code - 8);
+  }
+
+  if (size > max_block_size || data[pos] != ComputeFrameHeaderCRC(data, pos))
+    return false;
+
+  *first_frame = (data[1] & 0x01) ? number : (number * max_block_size);
+  *block_size = size;
+  return true;
+}
+
+CDFLACReader::CDFLACReader() = default;
+
+CDFLACReader::~CDFLACReader()
+{
+  if (m_flac)
+    drflac_close(m_flac);
+}
+
+bool CDFLACReader::IsFLACFile(std::FILE* fp)
+{
+  char marker[4];
+  const bool result = (std::fread(marker, sizeof(marker), 1, fp) == 1 && std::memcmp(marker, "fLaC", 4) == 0);
+  FileSystem::FSeek64(fp, 0, SEEK_SET);
+  return result;
+}
+
+bool CDFLACReader::Open(std::FILE* fp, Common::Error* error)
+{
+  m_fp = fp;
+  m_flac = drflac_open(FLACReadCallback, FLACSeekCallback, fp, nullptr);
+  if (!m_flac)
+  {
+    if (error)
+      error->SetMessage("Failed to open FLAC stream");
+
+    return false;
+  }
+
+  if (m_flac->sampleRate != 44100 || m_flac->channels != 2 || m_flac->bitsPerSample != 16)
+  {
+    if (error)
+    {
+      error->SetFormattedMessage("FLAC audio must be 44100Hz 16-bit stereo, got %uHz %u-bit %u channels",
+                                 m_flac->sampleRate, m_flac->bitsPerSample, m_flac->channels);
+    }
+
+    return false;
+  }
+
+  if (m_flac->totalPCMFrameCount == 0)
+  {
+    if (error)
+      error->SetMessage("FLAC stream does not specify its length");
+
+    return false;
+  }
+
+  m_sector_count = static_cast<u32>((m_flac->totalPCMFrameCount + (FRAMES_PER_SECTOR - 1)) / FRAMES_PER_SECTOR);
+  m_ring = std::make_unique<u8[]>(RING_SECTORS * SECTOR_SIZE);
+  BuildSeekTable();
+  return true;
+}
+
+void CDFLACReader::BuildSeekTable()
+{
+  // Without a seek table, drflac has to binary search the whole file, which reads a frame at each step. Few files
+  // have a fine grained enough table of their own, so probe for a frame header at regular intervals instead. That
+  // only reads a small window at each point, rather than the whole file.
+  if (m_flac->container != drflac_container_native)
+    return;
+
+  const s64 start_position = FileSystem::FTell64(m_fp);
+  const s64 file_size = FileSystem::FSize64(m_fp);
+  std::unique_ptr<u8[]> buffer = std::make_unique<u8[]>(SEEK_POINT_SEARCH_SIZE);
+
+  for (u64 probe = m_flac->firstFLACFramePosInBytes; static_cast<s64>(probe) < file_size;
+       probe += SEEK_POINT_INTERVAL)
+  {
+    if (FileSystem::FSeek64(m_fp, static_cast<s64>(probe), SEEK_SET) != 0)
+      break;
+
+    const u32 size = static_cast<u32>(std::fread(buffer.get(), 1, SEEK_POINT_SEARCH_SIZE, m_fp));
+    for (u32 offset = 0; (offset + MAX_FRAME_HEADER_SIZE) <= size; offset++)
+    {
+      u64 first_frame;
+      u32 block_size;
+      if (!ParseFrameHeader(&buffer[offset], m_flac->maxBlockSizeInPCMFrames, &first_frame, &block_size))
+        continue;
+
+      // sync codes in the audio data can still get through, but they won't be in order
+      const u64 frame_offset = probe + offset - m_flac->firstFLACFramePosInBytes;
+      if (first_frame >= m_flac->totalPCMFrameCount ||
+          (!m_seek_table.empty() && (first_frame <= m_seek_table.back().firstPCMFrame ||
+                                     frame_offset <= m_seek_table.back().flacFrameOffset)))
+      {
+        continue;
+      }
+
+      m_seek_table.push_back(drflac_seekpoint{first_frame, frame_offset, static_cast<drflac_uint16>(block_size)});
+      break;
+    }
+  }
+
+  FileSystem::FSeek64(m_fp, start_position, SEEK_SET);
+
+  Log_DevPrintf("Built %zu point seek table for %u sectors", m_seek_table.size(), m_sector_count);
+  if (m_seek_table.empty() || m_seek_table.front().firstPCMFrame != 0)
+  {
+    m_seek_table.clear();
+    return;
+  }
+
+  m_flac->pSeekpoints = m_seek_table.data();
+  m_flac->seekpointCount = static_cast<drflac_uint32>(m_seek_table.size());
+}
+
+bool CDFLACReader::ReadSector(u32 sector, void* buffer)
+{
+  if (sector >= m_sector_count)
+    return false;
+
+  if (sector < m_ring_start || sector >= m_ring_end)
+  {
+    // decoding through a short gap is cheaper than seeking
+    if (sector < m_ring_start || (sector - m_ring_end) >= RING_SECTORS)
+    {
+      if (!Seek(sector))
+        return false;
+    }
+
+    const u32 decode_end = std::min(sector + DECODE_AHEAD_SECTORS, m_sector_count);
+    while (m_ring_end < decode_end)
+    {
+      if (!DecodeSector())
+        return false;
+    }
+  }
+
+  std::memcpy(buffer, &m_ring[(sector % RING_SECTORS) * SECTOR_SIZE], SECTOR_SIZE);
+  return true;
+}
+
+bool CDFLACReader::Seek(u32 sector)
+{
+  m_ring_start = sector;
+  m_ring_end = sector;
+  if (drflac_seek_to_pcm_frame(m_flac, static_cast<drflac_uint64>(sector) * FRAMES_PER_SECTOR))
+    return true;
+
+  // force the next read to seek again
+  Log_ErrorPrintf("Failed to seek to sector %u", sector);
+  m_ring_start = m_sector_count;
+  m_ring_end = m_sector_count;
+  return false;
+}
+
+bool CDFLACReader::DecodeSector()
+{
+  u8* const sector_data = &m_ring[(m_ring_end % RING_SECTORS) * SECTOR_SIZE];
+  const u32 frames = static_cast<u32>(
+    drflac_read_pcm_frames_s16(m_flac, FRAMES_PER_SECTOR, reinterpret_cast<drflac_int16*>(sector_data)));
+  if (frames < FRAMES_PER_SECTOR)
+  {
+    // only the last sector can be short, it's padded with silence
+    if (m_ring_end != (m_sector_count - 1))
+    {
+      Log_ErrorPrintf("Failed to decode sector %u", m_ring_end);
+      m_ring_start = m_sector_count;
+      m_ring_end = m_sector_count;
+      return false;
+    }
+
+    std::memset(sector_data + frames * (SECTOR_SIZE / FRAMES_PER_SECTOR), 0,
+                (FRAMES_PER_SECTOR - frames) * (SECTOR_SIZE / FRAMES_PER_SECTOR));
+  }
+
+  m_ring_end++;
+  if ((m_ring_end - m_ring_start) > RING_SECTORS)
+    m_ring_start = m_ring_end - RING_SECTORS;
+  return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "common/types.h"
+#include "dr_libs/dr_flac.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace Common {
+class Error;
+}
+
+/// Reads CD-DA sectors out of a FLAC file, which must be 44.1KHz 16-bit stereo. Sectors are decoded on demand on the
+/// reading thread, a little ahead of sequential reads, into a small ring of decoded sectors.
+class CDFLACReader
+{
+public:
+  CDFLACReader();
+  ~CDFLACReader();
+
+  /// Returns true if the file starts with the FLAC stream marker. Leaves the file at the start.
+  static bool IsFLACFile(std::FILE* fp);
+
+  ALWAYS_INLINE u32 GetSectorCount() const { return m_sector_count; }
+
+  /// The file is not owned by the reader, and must stay open for as long as it is.
+  bool Open(std::FILE* fp, Common::Error* error);
+
+  bool ReadSector(u32 sector, void* buffer);
+
+private:
+  enum : u32
+  {
+    FRAMES_PER_SECTOR = 588,
+    SECTOR_SIZE = FRAMES_PER_SECTOR * 2 * sizeof(s16),
+
+    // ~0.4 seconds of audio, reads behind the decoder position within this are served without seeking
+    RING_SECTORS = 32,
+    DECODE_AHEAD_SECTORS = 8,
+
+    // distance between the frames the seek table is built from, in compressed bytes
+    SEEK_POINT_INTERVAL = 65536,
+    SEEK_POINT_SEARCH_SIZE = 32768,
+  };
+
+  void BuildSeekTable();
+  bool Seek(u32 sector);
+  bool DecodeSector();
+
+  std::FILE* m_fp = nullptr;
+  drflac* m_flac = nullptr;
+  u32 m_sector_count = 0;
+
+  // replaces the file's own seek table, if any, drflac reads it through its pointer
+  std::vector<drflac_seekpoint> m_seek_table;
+
+  // decoded sectors [m_ring_start, m_ring_end), the decoder is always positioned at m_ring_end
+  std::unique_ptr<u8[]> m_ring;
+  u32 m_ring_start = 0;
+  u32 m_ring_end = 0;
+};
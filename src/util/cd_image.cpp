@@ -5,7 +5,10 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
+#include <algorithm>
 #include <array>
+#include <atomic>
 Log_SetChannel(CDImage);
 
 CDImage::CDImage() = default;
@@ -39,7 +42,11 @@ std::unique_ptr<CDImage> CDImage::Open(const char* filename, bool allow_patches,
   }
 
   std::unique_ptr<CDImage> image;
-  if (StringUtil::Strcasecmp(extension, ".cue") == 0)
+  if (IsHTTPURL(filename))
+  {
+    image = OpenHTTPImage(filename, error);
+  }
+  else if (StringUtil::Strcasecmp(extension, ".cue") == 0)
   {
     image = OpenCueSheetImage(filename, error);
   }
@@ -360,6 +367,81 @@ bool CDImage::IsPrecached() const
   return false;
 }
 
+void CDImage::ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed) {}
+
+void CDImage::ConfigureSubImagePreload(bool enabled, u32 precache_budget_mb) {}
+
+void CDImage::SetReadaheadHint(u32 sectors) {}
+
+u32 CDImage::GetParallelDecompressionWorkerCount(u32 num_blocks)
+{
+  // the calling thread decompresses too, alongside the shared pool's workers
+  return std::max(std::min(Threading::ThreadPool::GetShared().GetThreadCount() + 1, num_blocks), 1u);
+}
+
+bool CDImage::DecompressBlocksInParallel(u32 num_blocks, ProgressCallback* progress,
+                                         const std::function<bool(u32, u32)>& decompress_block)
+{
+  std::atomic<u32> next_block{0};
+  std::atomic<u32> blocks_done{0};
+  std::atomic_bool failed{false};
+
+  auto run_block = [&](u32 worker_index) {
+    const u32 block = next_block.fetch_add(1, std::memory_order_relaxed);
+    if (block >= num_blocks || failed.load(std::memory_order_relaxed))
+      return false;
+
+    if (!decompress_block(worker_index, block))
+      failed.store(true, std::memory_order_relaxed);
+
+    blocks_done.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  };
+
+  const u32 num_workers = GetParallelDecompressionWorkerCount(num_blocks);
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  Threading::ThreadPool::TaskGroup group;
+  for (u32 i = 1; i < num_workers; i++)
+  {
+    pool.Submit(
+      [&run_block, i]() {
+        while (run_block(i))
+          ;
+      },
+      Threading::ThreadPool::Priority::Normal, &group);
+  }
+
+  progress->SetProgressRange(num_blocks);
+  progress->SetProgressValue(0);
+
+  bool cancelled = false;
+  while (run_block(0))
+  {
+    progress->SetProgressValue(blocks_done.load(std::memory_order_relaxed));
+    if (progress->IsCancelled())
+    {
+      // stops the other workers after their current block
+      failed.store(true, std::memory_order_relaxed);
+      cancelled = true;
+    }
+  }
+
+  group.Wait(pool);
+
+  progress->SetProgressValue(blocks_done.load(std::memory_order_relaxed));
+  if (failed.load(std::memory_order_relaxed))
+  {
+    if (cancelled)
+      Log_WarningPrintf("Decompression cancelled after %u of %u blocks", blocks_done.load(), num_blocks);
+    else
+      Log_ErrorPrintf("Failed to decompress %u blocks", num_blocks);
+
+    return false;
+  }
+
+  return true;
+}
+
 void CDImage::ClearTOC()
 {
   m_lba_count = 0;
@@ -3,6 +3,7 @@
 #include "common/progress_callback.h"
 #include "common/types.h"
 #include <array>
+#include <functional>
 #include <memory>
 #include <string>
 #include <tuple>
@@ -216,6 +217,12 @@ public:
   /// Returns true if the specified filename is a CD-ROM device name.
   static bool IsDeviceName(const char* filename);
 
+  /// Returns true if the specified filename is a http:// or https:// URL, which is streamed with range requests.
+  static bool IsHTTPURL(const char* filename);
+
+  /// Sets where streamed images keep downloaded blocks between runs. If empty, blocks are only kept in memory.
+  static void SetHTTPCacheDirectory(std::string directory);
+
   // Opening disc image.
   static std::unique_ptr<CDImage> Open(const char* filename, bool allow_patches, Common::Error* error);
   static std::unique_ptr<CDImage> OpenBinImage(const char* filename, Common::Error* error);
@@ -226,6 +233,7 @@ public:
   static std::unique_ptr<CDImage> OpenPBPImage(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage> OpenM3uImage(const char* filename, bool apply_patches, Common::Error* error);
   static std::unique_ptr<CDImage> OpenDeviceImage(const char* filename, Common::Error* error);
+  static std::unique_ptr<CDImage> OpenHTTPImage(const char* url, Common::Error* error);
   static std::unique_ptr<CDImage>
   CreateMemoryImage(CDImage* image, ProgressCallback* progress = ProgressCallback::NullProgressCallback);
   static std::unique_ptr<CDImage> OverlayPPFPatch(const char* filename, std::unique_ptr<CDImage> parent_image,
@@ -347,6 +355,20 @@ public:
   virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback);
   virtual bool IsPrecached() const;
 
+  // Sets how many decompressed blocks compressed images keep, and whether the next block is decompressed on another
+  // thread ahead of sequential reads. With precache_compressed, Precache() keeps the compressed data in memory and
+  // decompresses on demand, instead of decompressing the whole image. Ignored by uncompressed images.
+  virtual void ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed);
+
+  // Lets multi-disc sets which keep each disc in its own image open the disc after the current one on another thread,
+  // so switching to it doesn't have to wait. If the disc's raw size fits in precache_budget_mb, it's precached too.
+  // Ignored by everything else.
+  virtual void ConfigureSubImagePreload(bool enabled, u32 precache_budget_mb);
+
+  // Tells images which fetch data slowly how many sectors the reader currently keeps ahead of the drive, so they can
+  // fetch that far ahead of sequential reads. Ignored by everything else.
+  virtual void SetReadaheadHint(u32 sectors);
+
 protected:
   void ClearTOC();
   void CopyTOC(const CDImage* image);
@@ -363,6 +385,14 @@ protected:
   /// Synthesis of lead-out data.
   void AddLeadOutIndex();
 
+  /// Returns the number of threads used to decompress num_blocks blocks in parallel.
+  static u32 GetParallelDecompressionWorkerCount(u32 num_blocks);
+
+  /// Calls decompress_block(worker_index, block_index) for every block across GetParallelDecompressionWorkerCount()
+  /// threads. Progress and cancellation are handled on the calling thread, which is always worker zero.
+  static bool DecompressBlocksInParallel(u32 num_blocks, ProgressCallback* progress,
+                                         const std::function<bool(u32, u32)>& decompress_block);
+
   std::string m_filename;
   u32 m_lba_count = 0;
 
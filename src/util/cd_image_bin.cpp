@@ -4,6 +4,7 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include <cerrno>
+#include <cstring>
 Log_SetChannel(CDImageBin);
 
 class CDImageBin : public CDImage
@@ -24,6 +25,9 @@ private:
   std::FILE* m_fp = nullptr;
   u64 m_file_position = 0;
 
+  // Sectors are copied straight out of the mapping when the file could be mapped.
+  FileSystem::MappedFile m_mapped_file;
+
   CDSubChannelReplacement m_sbi;
 };
 
@@ -56,6 +60,9 @@ bool CDImageBin::Open(const char* filename, Common::Error* error)
 
   m_lba_count = file_size / track_sector_size;
 
+  if (!m_mapped_file.Map(m_fp))
+    Log_WarningPrintf("Failed to map binfile '%s', falling back to buffered reads", filename);
+
   SubChannelQ::Control control = {};
   TrackMode mode = TrackMode::Mode2Raw;
   control.data = mode != TrackMode::Audio;
@@ -115,6 +122,15 @@ bool CDImageBin::HasNonStandardSubchannel() const
 bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (m_mapped_file.IsValid())
+  {
+    if ((file_position + index.file_sector_size) > m_mapped_file.GetSize())
+      return false;
+
+    std::memcpy(buffer, m_mapped_file.GetData() + file_position, index.file_sector_size);
+    return true;
+  }
+
   if (m_file_position != file_position)
   {
     if (std::fseek(m_fp, static_cast<long>(file_position), SEEK_SET) != 0)
@@ -10,14 +10,17 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/platform.h"
+#include "common/threading.h"
 #include "fmt/format.h"
 #include "libchdr/chd.h"
 #include <algorithm>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
 #include <cstring>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
 Log_SetChannel(CDImageCHD);
 
@@ -55,6 +58,7 @@ public:
   bool HasNonStandardSubchannel() const override;
   PrecacheResult Precache(ProgressCallback* progress) override;
   bool IsPrecached() const override;
+  void ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -63,19 +67,50 @@ private:
   enum : u32
   {
     CHD_CD_SECTOR_DATA_SIZE = 2352 + 96,
-    CHD_CD_TRACK_ALIGNMENT = 4
+    CHD_CD_TRACK_ALIGNMENT = 4,
+    MAX_CACHED_HUNKS = 256,
+    INVALID_HUNK_INDEX = static_cast<u32>(-1)
   };
 
   bool ReadHunk(u32 hunk_index);
+  bool DecompressAllHunks(ProgressCallback* progress);
+  u32 GetCacheSlotForHunk(u32 hunk_index) const;
+
+  void StartPrefetchThread();
+  void StopPrefetchThread();
+  void PrefetchThreadEntryPoint();
+  void QueuePrefetch(u32 hunk_index);
+  bool TakePrefetchedHunk(u32 hunk_index, u8* dst);
 
   std::FILE* m_fp = nullptr;
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
+  u32 m_hunk_count = 0;
   u32 m_sectors_per_hunk = 0;
 
+  // Decompressed hunks, evicted least recently used first.
   std::vector<u8> m_hunk_buffer;
-  u32 m_current_hunk_index = static_cast<u32>(-1);
+  std::vector<u32> m_cached_hunk_indices;
+  std::vector<u32> m_cached_hunk_last_use;
+  u32 m_hunk_use_counter = 0;
+  const u8* m_current_hunk_data = nullptr;
+  u32 m_current_hunk_index = INVALID_HUNK_INDEX;
   bool m_precached = false;
+  bool m_all_hunks_decompressed = false;
+  bool m_precache_compressed = false;
+
+  // chd_file isn't thread safe, so the prefetch thread decompresses through a second handle.
+  std::FILE* m_prefetch_fp = nullptr;
+  chd_file* m_prefetch_chd = nullptr;
+  Threading::Thread m_prefetch_thread;
+  std::mutex m_prefetch_mutex;
+  std::condition_variable m_prefetch_start_cv;
+  std::condition_variable m_prefetch_done_cv;
+  std::vector<u8> m_prefetch_buffer;
+  u32 m_prefetch_queued_hunk = INVALID_HUNK_INDEX;
+  u32 m_prefetch_busy_hunk = INVALID_HUNK_INDEX;
+  u32 m_prefetch_ready_hunk = INVALID_HUNK_INDEX;
+  bool m_prefetch_shutdown = false;
 
   CDSubChannelReplacement m_sbi;
 };
@@ -84,6 +119,7 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  StopPrefetchThread();
   if (m_chd)
     chd_close(m_chd);
   if (m_fp)
@@ -124,8 +160,11 @@ bool CDImageCHD::Open(const char* filename, Common::Error* error)
     return false;
   }
 
+  m_hunk_count = header->totalhunks;
   m_sectors_per_hunk = m_hunk_size / CHD_CD_SECTOR_DATA_SIZE;
   m_hunk_buffer.resize(m_hunk_size);
+  m_cached_hunk_indices.assign(1, INVALID_HUNK_INDEX);
+  m_cached_hunk_last_use.assign(1, 0);
   m_filename = filename;
 
   u32 disc_lba = 0;
@@ -309,6 +348,22 @@ CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress)
   if (m_precached)
     return CDImage::PrecacheResult::Success;
 
+  if (!m_precache_compressed)
+  {
+    progress->SetStatusText(
+      fmt::format("Decompressing {}...", FileSystem::GetDisplayNameFromPath(m_filename)).c_str());
+    if (DecompressAllHunks(progress))
+    {
+      m_precached = true;
+      return CDImage::PrecacheResult::Success;
+    }
+    else if (progress->IsCancelled())
+    {
+      return CDImage::PrecacheResult::ReadError;
+    }
+  }
+
+  // Keep the compressed data in memory, hunks are decompressed on demand through the cache.
   progress->SetStatusText(fmt::format("Precaching {}...", FileSystem::GetDisplayNameFromPath(m_filename)).c_str());
   progress->SetProgressRange(100);
 
@@ -329,6 +384,76 @@ bool CDImageCHD::IsPrecached() const
   return m_precached;
 }
 
+bool CDImageCHD::DecompressAllHunks(ProgressCallback* progress)
+{
+  const u64 total_size = static_cast<u64>(m_hunk_count) * static_cast<u64>(m_hunk_size);
+  if (total_size >= static_cast<u64>(std::numeric_limits<size_t>::max()))
+  {
+    Log_WarningPrintf("Insufficient address space to decompress %u hunks", m_hunk_count);
+    return false;
+  }
+
+  // chd_file isn't thread safe, so every worker other than the calling thread needs its own handle.
+  const u32 num_workers = GetParallelDecompressionWorkerCount(m_hunk_count);
+  std::vector<std::FILE*> worker_fps(num_workers, nullptr);
+  std::vector<chd_file*> worker_chds(num_workers, nullptr);
+  worker_chds[0] = m_chd;
+
+  auto close_worker_handles = [&worker_fps, &worker_chds]() {
+    for (size_t i = 1; i < worker_chds.size(); i++)
+    {
+      if (worker_chds[i])
+        chd_close(worker_chds[i]);
+      if (worker_fps[i])
+        std::fclose(worker_fps[i]);
+    }
+  };
+
+  for (u32 i = 1; i < num_workers; i++)
+  {
+    worker_fps[i] = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+    const chd_error err =
+      worker_fps[i] ? chd_open_file(worker_fps[i], CHD_OPEN_READ, nullptr, &worker_chds[i]) : CHDERR_FILE_NOT_FOUND;
+    if (err != CHDERR_NONE)
+    {
+      Log_ErrorPrintf("Failed to reopen CHD '%s' for decompression: %s", m_filename.c_str(), chd_error_string(err));
+      worker_chds[i] = nullptr;
+      close_worker_handles();
+      return false;
+    }
+  }
+
+  Log_DevPrintf("Decompressing %u hunks with %u threads", m_hunk_count, num_workers);
+
+  std::vector<u8> buffer(static_cast<size_t>(total_size));
+  const bool result =
+    DecompressBlocksInParallel(m_hunk_count, progress, [this, &worker_chds, &buffer](u32 worker_index, u32 hunk_index) {
+      const chd_error err = chd_read(worker_chds[worker_index], hunk_index,
+                                     &buffer[static_cast<size_t>(hunk_index) * static_cast<size_t>(m_hunk_size)]);
+      if (err != CHDERR_NONE)
+      {
+        Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+        return false;
+      }
+
+      return true;
+    });
+
+  close_worker_handles();
+  if (!result)
+    return false;
+
+  // Every hunk is resident now, so there's nothing left to cache or prefetch.
+  StopPrefetchThread();
+  m_hunk_buffer = std::move(buffer);
+  m_cached_hunk_indices.clear();
+  m_cached_hunk_last_use.clear();
+  m_current_hunk_data = nullptr;
+  m_current_hunk_index = INVALID_HUNK_INDEX;
+  m_all_hunks_decompressed = true;
+  return true;
+}
+
 // There's probably a more efficient way of doing this with vectorization...
 ALWAYS_INLINE static void CopyAndSwap(void* dst_ptr, const u8* src_ptr, u32 data_size)
 {
@@ -381,26 +506,205 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
 
   // Audio data is in big-endian, so we have to swap it for little endian hosts...
   if (index.mode == TrackMode::Audio)
-    CopyAndSwap(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    CopyAndSwap(buffer, &m_current_hunk_data[hunk_offset], RAW_SECTOR_SIZE);
   else
-    std::memcpy(buffer, &m_hunk_buffer[hunk_offset], RAW_SECTOR_SIZE);
+    std::memcpy(buffer, &m_current_hunk_data[hunk_offset], RAW_SECTOR_SIZE);
 
   return true;
 }
 
 bool CDImageCHD::ReadHunk(u32 hunk_index)
 {
-  const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
+  if (m_all_hunks_decompressed)
+  {
+    if (hunk_index >= m_hunk_count)
+    {
+      Log_ErrorPrintf("Hunk %u is out of range", hunk_index);
+      return false;
+    }
+
+    m_current_hunk_data = &m_hunk_buffer[static_cast<size_t>(hunk_index) * static_cast<size_t>(m_hunk_size)];
+    m_current_hunk_index = hunk_index;
+    return true;
+  }
+
+  u32 slot = GetCacheSlotForHunk(hunk_index);
+  if (slot == INVALID_HUNK_INDEX)
+  {
+    slot = static_cast<u32>(std::distance(
+      m_cached_hunk_last_use.begin(), std::min_element(m_cached_hunk_last_use.begin(), m_cached_hunk_last_use.end())));
+
+    u8* data = &m_hunk_buffer[slot * m_hunk_size];
+    if (!TakePrefetchedHunk(hunk_index, data))
+    {
+      const chd_error err = chd_read(m_chd, hunk_index, data);
+      if (err != CHDERR_NONE)
+      {
+        Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+
+        // data might have been partially written
+        m_cached_hunk_indices[slot] = INVALID_HUNK_INDEX;
+        m_cached_hunk_last_use[slot] = 0;
+        m_current_hunk_index = INVALID_HUNK_INDEX;
+        return false;
+      }
+    }
+
+    m_cached_hunk_indices[slot] = hunk_index;
+  }
+
+  m_cached_hunk_last_use[slot] = ++m_hunk_use_counter;
+  m_current_hunk_data = &m_hunk_buffer[slot * m_hunk_size];
+  m_current_hunk_index = hunk_index;
+
+  // Assume the read is sequential, and start on the next hunk.
+  if (m_prefetch_chd && (hunk_index + 1) < m_hunk_count && GetCacheSlotForHunk(hunk_index + 1) == INVALID_HUNK_INDEX)
+    QueuePrefetch(hunk_index + 1);
+
+  return true;
+}
+
+u32 CDImageCHD::GetCacheSlotForHunk(u32 hunk_index) const
+{
+  const auto iter = std::find(m_cached_hunk_indices.begin(), m_cached_hunk_indices.end(), hunk_index);
+  return (iter != m_cached_hunk_indices.end()) ? static_cast<u32>(std::distance(m_cached_hunk_indices.begin(), iter)) :
+                                                 INVALID_HUNK_INDEX;
+}
+
+void CDImageCHD::ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed)
+{
+  m_precache_compressed = precache_compressed;
+  if (m_all_hunks_decompressed)
+    return;
+
+  StopPrefetchThread();
+
+  const u32 num_hunks = std::clamp<u32>(num_blocks, 1, MAX_CACHED_HUNKS);
+  m_hunk_buffer.resize(num_hunks * m_hunk_size);
+  m_cached_hunk_indices.assign(num_hunks, INVALID_HUNK_INDEX);
+  m_cached_hunk_last_use.assign(num_hunks, 0);
+  m_hunk_use_counter = 0;
+  m_current_hunk_data = nullptr;
+  m_current_hunk_index = INVALID_HUNK_INDEX;
+
+  if (prefetch)
+    StartPrefetchThread();
+
+  Log_DevPrintf("Caching %u hunks of %u bytes, prefetch %s", num_hunks, m_hunk_size,
+                m_prefetch_chd ? "enabled" : "disabled");
+}
+
+void CDImageCHD::StartPrefetchThread()
+{
+  m_prefetch_fp = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+  if (!m_prefetch_fp)
+  {
+    Log_ErrorPrintf("Failed to reopen CHD '%s' for prefetching: errno %d", m_filename.c_str(), errno);
+    return;
+  }
+
+  const chd_error err = chd_open_file(m_prefetch_fp, CHD_OPEN_READ, nullptr, &m_prefetch_chd);
   if (err != CHDERR_NONE)
   {
-    Log_ErrorPrintf("chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+    Log_ErrorPrintf("Failed to reopen CHD '%s' for prefetching: %s", m_filename.c_str(), chd_error_string(err));
+    std::fclose(m_prefetch_fp);
+    m_prefetch_fp = nullptr;
+    m_prefetch_chd = nullptr;
+    return;
+  }
+
+  m_prefetch_buffer.resize(m_hunk_size);
+  m_prefetch_queued_hunk = INVALID_HUNK_INDEX;
+  m_prefetch_busy_hunk = INVALID_HUNK_INDEX;
+  m_prefetch_ready_hunk = INVALID_HUNK_INDEX;
+  m_prefetch_shutdown = false;
+  m_prefetch_thread.Start([this]() { PrefetchThreadEntryPoint(); });
+}
+
+void CDImageCHD::StopPrefetchThread()
+{
+  if (!m_prefetch_chd)
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+    m_prefetch_shutdown = true;
+  }
+  m_prefetch_start_cv.notify_one();
+  m_prefetch_thread.Join();
+
+  chd_close(m_prefetch_chd);
+  m_prefetch_chd = nullptr;
+  std::fclose(m_prefetch_fp);
+  m_prefetch_fp = nullptr;
+  m_prefetch_buffer = {};
+}
 
-    // data might have been partially written
-    m_current_hunk_index = static_cast<u32>(-1);
+void CDImageCHD::PrefetchThreadEntryPoint()
+{
+  Threading::SetNameOfCurrentThread("CHD Prefetch");
+
+  for (;;)
+  {
+    u32 hunk_index;
+    {
+      std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+      m_prefetch_start_cv.wait(lock,
+                               [this]() { return m_prefetch_shutdown || m_prefetch_queued_hunk != INVALID_HUNK_INDEX; });
+      if (m_prefetch_shutdown)
+        break;
+
+      hunk_index = m_prefetch_queued_hunk;
+      m_prefetch_queued_hunk = INVALID_HUNK_INDEX;
+      m_prefetch_busy_hunk = hunk_index;
+      m_prefetch_ready_hunk = INVALID_HUNK_INDEX;
+    }
+
+    const chd_error err = chd_read(m_prefetch_chd, hunk_index, m_prefetch_buffer.data());
+    if (err != CHDERR_NONE)
+      Log_WarningPrintf("Prefetching chd_read(%u) failed: %s", hunk_index, chd_error_string(err));
+
+    {
+      std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+      m_prefetch_busy_hunk = INVALID_HUNK_INDEX;
+      m_prefetch_ready_hunk = (err == CHDERR_NONE) ? hunk_index : INVALID_HUNK_INDEX;
+    }
+    m_prefetch_done_cv.notify_one();
+  }
+}
+
+void CDImageCHD::QueuePrefetch(u32 hunk_index)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+    if (m_prefetch_busy_hunk == hunk_index || m_prefetch_ready_hunk == hunk_index)
+      return;
+
+    m_prefetch_queued_hunk = hunk_index;
+  }
+  m_prefetch_start_cv.notify_one();
+}
+
+bool CDImageCHD::TakePrefetchedHunk(u32 hunk_index, u8* dst)
+{
+  if (!m_prefetch_chd)
+    return false;
+
+  std::unique_lock<std::mutex> lock(m_prefetch_mutex);
+
+  // Not started yet, it's no slower to decompress it here.
+  if (m_prefetch_queued_hunk == hunk_index)
+  {
+    m_prefetch_queued_hunk = INVALID_HUNK_INDEX;
     return false;
   }
 
-  m_current_hunk_index = hunk_index;
+  m_prefetch_done_cv.wait(lock, [this, hunk_index]() { return m_prefetch_busy_hunk != hunk_index; });
+  if (m_prefetch_ready_hunk != hunk_index)
+    return false;
+
+  std::memcpy(dst, m_prefetch_buffer.data(), m_hunk_size);
+  m_prefetch_ready_hunk = INVALID_HUNK_INDEX;
   return true;
 }
 
@@ -1,3 +1,4 @@
+#include "cd_flac_reader.h"
 #include "cd_image.h"
 #include "cd_subchannel_replacement.h"
 #include "common/assert.h"
@@ -9,6 +10,7 @@
 #include <algorithm>
 #include <cerrno>
 #include <cinttypes>
+#include <cstring>
 #include <map>
 Log_SetChannel(CDImageCueSheet);
 
@@ -32,6 +34,12 @@ private:
     std::string filename;
     std::FILE* file;
     u64 file_position;
+
+    // Sectors are copied straight out of the mapping when the file could be mapped.
+    FileSystem::MappedFile mapping;
+
+    // Set for FLAC audio files, which are decoded as they're read instead.
+    std::unique_ptr<CDFLACReader> flac;
   };
 
   std::vector<TrackFile> m_files;
@@ -42,7 +50,10 @@ CDImageCueSheet::CDImageCueSheet() = default;
 
 CDImageCueSheet::~CDImageCueSheet()
 {
-  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) { std::fclose(t.file); });
+  std::for_each(m_files.begin(), m_files.end(), [](TrackFile& t) {
+    t.flac.reset();
+    std::fclose(t.file);
+  });
 }
 
 bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
@@ -119,11 +130,45 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
       }
 
       m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0});
+      TrackFile& tf = m_files.back();
+      if (CDFLACReader::IsFLACFile(track_fp))
+      {
+        tf.flac = std::make_unique<CDFLACReader>();
+        if (!tf.flac->Open(track_fp, error))
+        {
+          Log_ErrorPrintf("Failed to open FLAC track file '%s'", tf.filename.c_str());
+          return false;
+        }
+      }
+      else if (track->file_type == CueParser::FileType::Wave)
+      {
+        Log_ErrorPrintf("Track file '%s' is not FLAC, which is the only supported audio format",
+                        tf.filename.c_str());
+        if (error)
+        {
+          error->SetFormattedMessage("Track file '%s' is not FLAC, which is the only supported audio format",
+                                     tf.filename.c_str());
+        }
+
+        return false;
+      }
+      else if (!tf.mapping.Map(track_fp))
+      {
+        Log_WarningPrintf("Failed to map track file '%s', falling back to buffered reads", tf.filename.c_str());
+      }
     }
 
     // data type determines the sector size
     const TrackMode mode = track->mode;
     const u32 track_sector_size = GetBytesPerSector(mode);
+    if (m_files[track_file_index].flac && mode != TrackMode::Audio)
+    {
+      Log_ErrorPrintf("Track %u in '%s' is a data track, but its file is FLAC audio", track_num, filename);
+      if (error)
+        error->SetFormattedMessage("Track %u in '%s' is a data track, but its file is FLAC audio", track_num, filename);
+
+      return false;
+    }
 
     // precompute subchannel q flags for the whole track
     SubChannelQ::Control control{};
@@ -136,11 +181,19 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
     LBA track_length;
     if (!track->length.has_value())
     {
-      FileSystem::FSeek64(m_files[track_file_index].file, 0, SEEK_END);
-      u64 file_size = static_cast<u64>(FileSystem::FTell64(m_files[track_file_index].file));
-      FileSystem::FSeek64(m_files[track_file_index].file, 0, SEEK_SET);
+      const TrackFile& tf = m_files[track_file_index];
+      u64 file_size;
+      if (tf.flac)
+      {
+        file_size = tf.flac->GetSectorCount();
+      }
+      else
+      {
+        FileSystem::FSeek64(tf.file, 0, SEEK_END);
+        file_size = static_cast<u64>(FileSystem::FTell64(tf.file)) / track_sector_size;
+        FileSystem::FSeek64(tf.file, 0, SEEK_SET);
+      }
 
-      file_size /= track_sector_size;
       if (track_start >= file_size)
       {
         Log_ErrorPrintf("Failed to open track %u in '%s': track start is out of range (%u vs %" PRIu64 ")", track_num,
@@ -312,6 +365,18 @@ bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA
 
   TrackFile& tf = m_files[index.file_index];
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (tf.flac)
+    return tf.flac->ReadSector(static_cast<u32>(file_position / index.file_sector_size), buffer);
+
+  if (tf.mapping.IsValid())
+  {
+    if ((file_position + index.file_sector_size) > tf.mapping.GetSize())
+      return false;
+
+    std::memcpy(buffer, tf.mapping.GetData() + file_position, index.file_sector_size);
+    return true;
+  }
+
   if (tf.file_position != file_position)
   {
     if (std::fseek(tf.file, static_cast<long>(file_position), SEEK_SET) != 0)
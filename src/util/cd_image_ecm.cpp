@@ -4,9 +4,10 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include <algorithm>
 #include <array>
 #include <cerrno>
-#include <map>
+#include <vector>
 Log_SetChannel(CDImageEcm);
 
 // unecm.c by Neill Corlett (c) 2002, GPL licensed
@@ -170,8 +171,6 @@ protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
-  bool ReadChunks(u32 disc_offset, u32 size);
-
   std::FILE* m_fp = nullptr;
 
   enum class SectorType : u32
@@ -199,14 +198,27 @@ private:
 
   struct SectorEntry
   {
+    u32 disc_offset;
     u32 file_offset;
     u32 chunk_size;
     SectorType type;
   };
 
-  using DataMap = std::map<u32, SectorEntry>;
+  using SectorIndex = std::vector<SectorEntry>;
+
+  static constexpr u32 GetDataOffset(SectorType type) { return (type == SectorType::Mode1) ? 0 : 0x10; }
+
+  /// Returns the entry which disc_offset falls into.
+  SectorIndex::const_iterator FindEntry(u32 disc_offset) const;
+
+  /// Reads a Mode 1 or Mode 2 entry and reconstructs the full raw sector in sector, which must be RAW_SECTOR_SIZE.
+  /// The entry's data starts at sector + GetDataOffset(type).
+  bool DecodeSector(const SectorEntry& entry, u8* sector);
 
-  DataMap m_data_map;
+  bool ReadChunks(u32 disc_offset, u32 size);
+
+  // Built in disc order, so it's sorted by disc_offset.
+  SectorIndex m_sector_index;
   std::vector<u8> m_chunk_buffer;
   u32 m_chunk_start = 0;
 
@@ -256,18 +268,19 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
     return false;
   }
 
-  // build sector map
+  // build sector index, every entry takes up at least a Mode 1 sector worth of file data outside of short raw runs
   u32 file_offset = static_cast<u32>(std::ftell(m_fp));
   u32 disc_offset = 0;
+  m_sector_index.reserve(static_cast<size_t>(file_size / s_sector_sizes[static_cast<u32>(SectorType::Mode1)]) + 1);
 
   for (;;)
   {
     int bits = std::fgetc(m_fp);
     if (bits == EOF)
     {
-      Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_data_map.size());
+      Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_sector_index.size());
       if (error)
-        error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_data_map.size());
+        error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_sector_index.size());
 
       return false;
     }
@@ -281,9 +294,9 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
       bits = std::fgetc(m_fp);
       if (bits == EOF)
       {
-        Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_data_map.size());
+        Log_ErrorPrintf("Unexpected EOF after %zu chunks", m_sector_index.size());
         if (error)
-          error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_data_map.size());
+          error->SetFormattedMessage("Unexpected EOF after %zu chunks", m_sector_index.size());
 
         return false;
       }
@@ -301,9 +314,9 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
 
     if (count >= 0x80000000u)
     {
-      Log_ErrorPrintf("Corrupted header after %zu chunks", m_data_map.size());
+      Log_ErrorPrintf("Corrupted header after %zu chunks", m_sector_index.size());
       if (error)
-        error->SetFormattedMessage("Corrupted header after %zu chunks", m_data_map.size());
+        error->SetFormattedMessage("Corrupted header after %zu chunks", m_sector_index.size());
 
       return false;
     }
@@ -313,16 +326,16 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
       while (count > 0)
       {
         const u32 size = std::min<u32>(count, 2352);
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, size, type});
+        m_sector_index.push_back(SectorEntry{disc_offset, file_offset, size, type});
         disc_offset += size;
         file_offset += size;
         count -= size;
 
         if (static_cast<s64>(file_offset) > file_size)
         {
-          Log_ErrorPrintf("Out of file bounds after %zu chunks", m_data_map.size());
+          Log_ErrorPrintf("Out of file bounds after %zu chunks", m_sector_index.size());
           if (error)
-            error->SetFormattedMessage("Out of file bounds after %zu chunks", m_data_map.size());
+            error->SetFormattedMessage("Out of file bounds after %zu chunks", m_sector_index.size());
         }
       }
     }
@@ -332,30 +345,30 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
       const u32 chunk_size = s_chunk_sizes[static_cast<u32>(type)];
       for (u32 i = 0; i < count; i++)
       {
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, chunk_size, type});
+        m_sector_index.push_back(SectorEntry{disc_offset, file_offset, chunk_size, type});
         disc_offset += chunk_size;
         file_offset += size;
 
         if (static_cast<s64>(file_offset) > file_size)
         {
-          Log_ErrorPrintf("Out of file bounds after %zu chunks", m_data_map.size());
+          Log_ErrorPrintf("Out of file bounds after %zu chunks", m_sector_index.size());
           if (error)
-            error->SetFormattedMessage("Out of file bounds after %zu chunks", m_data_map.size());
+            error->SetFormattedMessage("Out of file bounds after %zu chunks", m_sector_index.size());
         }
       }
     }
 
     if (std::fseek(m_fp, file_offset, SEEK_SET) != 0)
     {
-      Log_ErrorPrintf("Failed to seek to offset %u after %zu chunks", file_offset, m_data_map.size());
+      Log_ErrorPrintf("Failed to seek to offset %u after %zu chunks", file_offset, m_sector_index.size());
       if (error)
-        error->SetFormattedMessage("Failed to seek to offset %u after %zu chunks", file_offset, m_data_map.size());
+        error->SetFormattedMessage("Failed to seek to offset %u after %zu chunks", file_offset, m_sector_index.size());
 
       return false;
     }
   }
 
-  if (m_data_map.empty())
+  if (m_sector_index.empty())
   {
     Log_ErrorPrintf("No data in image '%s'", filename);
     if (error)
@@ -414,101 +427,117 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
   return Seek(1, Position{0, 0, 0});
 }
 
-bool CDImageEcm::ReadChunks(u32 disc_offset, u32 size)
+CDImageEcm::SectorIndex::const_iterator CDImageEcm::FindEntry(u32 disc_offset) const
+{
+  // first entry is always at offset zero
+  auto iter = std::upper_bound(m_sector_index.begin(), m_sector_index.end(), disc_offset,
+                               [](u32 offset, const SectorEntry& entry) { return (offset < entry.disc_offset); });
+  return (iter != m_sector_index.begin()) ? (iter - 1) : iter;
+}
+
+bool CDImageEcm::DecodeSector(const SectorEntry& entry, u8* sector)
 {
-  DataMap::iterator next =
-    m_data_map.lower_bound((disc_offset > RAW_SECTOR_SIZE) ? (disc_offset - RAW_SECTOR_SIZE) : 0);
-  DataMap::iterator current = m_data_map.begin();
-  while (next != m_data_map.end() && next->first <= disc_offset)
-    current = next++;
+  if (std::fseek(m_fp, entry.file_offset, SEEK_SET) != 0)
+    return false;
 
-  // extra bytes if we need to buffer some at the start
-  m_chunk_start = current->first;
-  m_chunk_buffer.clear();
-  if (m_chunk_start < disc_offset)
-    size += (disc_offset - current->first);
+  // TODO: needed?
+  std::memset(sector, 0, RAW_SECTOR_SIZE);
+  std::memset(sector + 1, 0xFF, 10);
 
-  u32 total_bytes_read = 0;
-  while (total_bytes_read < size)
+  switch (entry.type)
   {
-    if (current == m_data_map.end() || std::fseek(m_fp, current->second.file_offset, SEEK_SET) != 0)
-      return false;
+    case SectorType::Mode1:
+    {
+      sector[0x0F] = 0x01;
+      if (std::fread(sector + 0x00C, 0x003, 1, m_fp) != 1 || std::fread(sector + 0x010, 0x800, 1, m_fp) != 1)
+        return false;
 
-    const u32 chunk_size = current->second.chunk_size;
-    const u32 chunk_start = static_cast<u32>(m_chunk_buffer.size());
-    m_chunk_buffer.resize(chunk_start + chunk_size);
+      eccedc_generate(sector, 1);
+    }
+    break;
 
-    if (current->second.type == SectorType::Raw)
+    case SectorType::Mode2Form1:
     {
-      if (std::fread(&m_chunk_buffer[chunk_start], chunk_size, 1, m_fp) != 1)
+      sector[0x0F] = 0x02;
+      if (std::fread(sector + 0x014, 0x804, 1, m_fp) != 1)
         return false;
 
-      total_bytes_read += chunk_size;
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
+
+      eccedc_generate(sector, 2);
     }
-    else
-    {
-      // u8* sector = &m_chunk_buffer[chunk_start];
-      u8 sector[RAW_SECTOR_SIZE];
+    break;
 
-      // TODO: needed?
-      std::memset(sector, 0, RAW_SECTOR_SIZE);
-      std::memset(sector + 1, 0xFF, 10);
+    case SectorType::Mode2Form2:
+    {
+      sector[0x0F] = 0x02;
+      if (std::fread(sector + 0x014, 0x918, 1, m_fp) != 1)
+        return false;
 
-      u32 skip;
-      switch (current->second.type)
-      {
-        case SectorType::Mode1:
-        {
-          sector[0x0F] = 0x01;
-          if (std::fread(sector + 0x00C, 0x003, 1, m_fp) != 1 || std::fread(sector + 0x010, 0x800, 1, m_fp) != 1)
-            return false;
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
 
-          eccedc_generate(sector, 1);
-          skip = 0;
-        }
-        break;
+      eccedc_generate(sector, 3);
+    }
+    break;
 
-        case SectorType::Mode2Form1:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x804, 1, m_fp) != 1)
-            return false;
+    default:
+      UnreachableCode();
+      return false;
+  }
 
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
+  return true;
+}
 
-          eccedc_generate(sector, 2);
-          skip = 0x10;
-        }
-        break;
+bool CDImageEcm::ReadChunks(u32 disc_offset, u32 size)
+{
+  SectorIndex::const_iterator current = FindEntry(disc_offset);
 
-        case SectorType::Mode2Form2:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x918, 1, m_fp) != 1)
-            return false;
+  // extra bytes if we need to buffer some at the start
+  m_chunk_start = current->disc_offset;
+  m_chunk_buffer.clear();
+  if (m_chunk_start < disc_offset)
+    size += (disc_offset - current->disc_offset);
 
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
+  u32 total_bytes_read = 0;
+  while (total_bytes_read < size)
+  {
+    if (current == m_sector_index.end())
+      return false;
 
-          eccedc_generate(sector, 3);
-          skip = 0x10;
-        }
-        break;
+    const u32 chunk_size = current->chunk_size;
+    const u32 chunk_start = static_cast<u32>(m_chunk_buffer.size());
+    m_chunk_buffer.resize(chunk_start + chunk_size);
 
-        default:
-          UnreachableCode();
-          return false;
+    if (current->type == SectorType::Raw)
+    {
+      if (std::fseek(m_fp, current->file_offset, SEEK_SET) != 0 ||
+          std::fread(&m_chunk_buffer[chunk_start], chunk_size, 1, m_fp) != 1)
+      {
+        return false;
       }
+    }
+    else if (current->type == SectorType::Mode1)
+    {
+      // whole sector, so it can be rebuilt in place
+      if (!DecodeSector(*current, &m_chunk_buffer[chunk_start]))
+        return false;
+    }
+    else
+    {
+      u8 sector[RAW_SECTOR_SIZE];
+      if (!DecodeSector(*current, sector))
+        return false;
 
-      std::memcpy(&m_chunk_buffer[chunk_start], sector + skip, chunk_size);
-      total_bytes_read += chunk_size;
+      std::memcpy(&m_chunk_buffer[chunk_start], sector + GetDataOffset(current->type), chunk_size);
     }
 
+    total_bytes_read += chunk_size;
     ++current;
   }
 
@@ -535,6 +564,20 @@ bool CDImageEcm::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
 
   if (file_start < m_chunk_start || file_end > (m_chunk_start + m_chunk_buffer.size()))
   {
+    // Sectors which line up with a single entry skip the chunk buffer.
+    const SectorEntry& entry = *FindEntry(file_start);
+    if (entry.disc_offset == file_start)
+    {
+      if (entry.type == SectorType::Mode1)
+        return DecodeSector(entry, static_cast<u8*>(buffer));
+
+      if (entry.type == SectorType::Raw && entry.chunk_size == RAW_SECTOR_SIZE)
+      {
+        return (std::fseek(m_fp, entry.file_offset, SEEK_SET) == 0 &&
+                std::fread(buffer, RAW_SECTOR_SIZE, 1, m_fp) == 1);
+      }
+    }
+
     if (!ReadChunks(file_start, RAW_SECTOR_SIZE))
       return false;
   }
@@ -1,7 +1,13 @@
 #include "cd_image_hasher.h"
 #include "cd_image.h"
+#include "common/log.h"
 #include "common/md5_digest.h"
 #include "common/string_util.h"
+#include "common/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+Log_SetChannel(CDImageHasher);
 
 namespace CDImageHasher {
 
@@ -75,6 +81,59 @@ static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallb
   return true;
 }
 
+static u32 GetTrackHashLength(CDImage* image, u8 track)
+{
+  // matches ReadTrack(), index 0 is skipped for the data track
+  u32 length = image->GetTrackIndexLength(track, 1);
+  if (track != 1)
+    length += image->GetTrackIndexLength(track, 0);
+
+  return length;
+}
+
+static bool HashTrackInParallel(CDImage* image, u8 track, Hash* out_hash, std::atomic<u32>& sectors_done,
+                                const std::atomic_bool& stop, ProgressCallback* progress_callback)
+{
+  MD5Digest digest;
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
+
+  for (u8 index = (track == 1) ? 1 : 0; index < 2; index++)
+  {
+    const CDImage::LBA index_start = image->GetTrackIndexPosition(track, index);
+    const u32 index_length = image->GetTrackIndexLength(track, index);
+    if (index_length > 0 && !image->Seek(index_start))
+    {
+      Log_ErrorPrintf("Failed to seek to sector %u for track %u index %u", index_start, track, index);
+      return false;
+    }
+
+    for (u32 lba = 0; lba < index_length; lba++)
+    {
+      if (!image->ReadRawSector(sector.data(), nullptr))
+      {
+        Log_ErrorPrintf("Failed to read sector %u from image", image->GetPositionOnDisc());
+        return false;
+      }
+
+      digest.Update(sector.data(), static_cast<u32>(sector.size()));
+
+      // only the calling thread touches the progress callback
+      const u32 done = sectors_done.fetch_add(1, std::memory_order_relaxed) + 1;
+      if (progress_callback && (lba % 1024) == 0)
+      {
+        progress_callback->SetProgressValue(done);
+        if (progress_callback->IsCancelled())
+          return false;
+      }
+      if (stop.load(std::memory_order_relaxed))
+        return false;
+    }
+  }
+
+  digest.Final(out_hash->data());
+  return true;
+}
+
 std::string HashToString(const Hash& hash)
 {
   return StringUtil::StdStringFromFormat("%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x", hash[0],
@@ -128,4 +187,87 @@ bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
   return true;
 }
 
-} // namespace CDImageHasher
\ No newline at end of file
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+{
+  const u32 num_tracks = image->GetTrackCount();
+  out_hashes->resize(num_tracks);
+  if (num_tracks == 0)
+    return true;
+
+  u32 total_sectors = 0;
+  for (u32 i = 1; i <= num_tracks; i++)
+    total_sectors += GetTrackHashLength(image, static_cast<u8>(i));
+
+  // CDImage isn't thread safe, so each worker reads from its own copy. The first one uses the image passed in.
+  Threading::ThreadPool& pool = Threading::ThreadPool::GetShared();
+  const u32 max_workers = std::min(pool.GetThreadCount() + 1, num_tracks);
+  std::vector<std::unique_ptr<CDImage>> worker_images;
+  for (u32 i = 1; i < max_workers; i++)
+  {
+    std::unique_ptr<CDImage> worker_image = CDImage::Open(image->GetFileName().c_str(), false, nullptr);
+    if (!worker_image || worker_image->GetTrackCount() != num_tracks ||
+        (image->HasSubImages() && !worker_image->SwitchSubImage(image->GetCurrentSubImage(), nullptr)))
+    {
+      break;
+    }
+
+    worker_images.push_back(std::move(worker_image));
+  }
+
+  const u32 num_workers = static_cast<u32>(worker_images.size()) + 1;
+  Log_DevPrintf("Hashing %u tracks with %u workers", num_tracks, num_workers);
+
+  progress_callback->SetStatusText("Computing track hashes...");
+  progress_callback->SetProgressRange(total_sectors);
+  progress_callback->SetProgressValue(0);
+
+  std::atomic<u32> next_track{0};
+  std::atomic<u32> sectors_done{0};
+  std::atomic_bool failed{false};
+
+  auto run_track = [&](u32 worker_index) {
+    const u32 track_index = next_track.fetch_add(1, std::memory_order_relaxed);
+    if (track_index >= num_tracks || failed.load(std::memory_order_relaxed))
+      return false;
+
+    CDImage* worker_image = (worker_index == 0) ? image : worker_images[worker_index - 1].get();
+    if (!HashTrackInParallel(worker_image, static_cast<u8>(track_index + 1), &(*out_hashes)[track_index],
+                             sectors_done, failed, (worker_index == 0) ? progress_callback : nullptr))
+    {
+      failed.store(true, std::memory_order_relaxed);
+    }
+
+    return true;
+  };
+
+  Threading::ThreadPool::TaskGroup group;
+  for (u32 i = 1; i < num_workers; i++)
+  {
+    pool.Submit(
+      [&run_track, i]() {
+        while (run_track(i))
+          ;
+      },
+      Threading::ThreadPool::Priority::Normal, &group);
+  }
+
+  while (run_track(0))
+    progress_callback->SetProgressValue(sectors_done.load(std::memory_order_relaxed));
+
+  group.Wait(pool);
+
+  if (failed.load(std::memory_order_relaxed))
+  {
+    if (!progress_callback->IsCancelled())
+      progress_callback->DisplayFormattedModalError("Failed to compute track hashes for '%s'",
+                                                    image->GetFileName().c_str());
+
+    return false;
+  }
+
+  progress_callback->SetProgressValue(total_sectors);
+  return true;
+}
+
+} // namespace CDImageHasher
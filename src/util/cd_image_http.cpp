@@ -0,0 +1,494 @@
+#include "cd_image.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/http_downloader.h"
+#include "common/log.h"
+#include "common/path.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+#include "fmt/format.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdlib>
+#include <limits>
+#include <map>
+Log_SetChannel(CDImageHTTP);
+
+static std::string s_http_cache_directory;
+
+class CDImageHTTP : public CDImage
+{
+public:
+  CDImageHTTP();
+  ~CDImageHTTP() override;
+
+  bool Open(const char* url, Common::Error* error);
+
+  void SetReadaheadHint(u32 sectors) override;
+
+protected:
+  bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+
+private:
+  enum : u32
+  {
+    // Blocks are whole sectors, so a sector never straddles two blocks.
+    SECTORS_PER_BLOCK = 64,
+    BLOCK_SIZE = SECTORS_PER_BLOCK * RAW_SECTOR_SIZE,
+
+    MAX_PREFETCH_BLOCKS = 8,
+
+    // Without a cache directory, downloaded blocks are only kept in memory.
+    MAX_MEMORY_BLOCKS = 32,
+
+    CACHE_MAGIC = 0x48434344, // DCCH
+    CACHE_VERSION = 1,
+  };
+
+  enum class BlockState : u8
+  {
+    Missing,
+    Requested,
+    Cached,
+  };
+
+#pragma pack(push, 1)
+  // Followed by one byte per block, which is non-zero if the block is present in the data file.
+  struct CacheHeader
+  {
+    u32 magic;
+    u32 version;
+    u32 block_size;
+    u32 block_count;
+    u64 resource_size;
+  };
+#pragma pack(pop)
+
+  u32 GetBlockSize(u32 block) const;
+
+  bool OpenCache(const std::string& base_path, u64 resource_size);
+  void CloseCache();
+
+  void RequestBlock(u32 block);
+  void OnBlockReceived(u32 block, s32 status_code, std::vector<u8> data);
+  void StoreBlock(u32 block, std::vector<u8> data);
+  bool LoadBlock(u32 block);
+  void PrefetchAfterBlock(u32 block);
+
+  std::unique_ptr<Common::HTTPDownloader> m_downloader;
+  u64 m_resource_size = 0;
+  u32 m_block_count = 0;
+  std::vector<BlockState> m_block_states;
+  u32 m_readahead_sectors = 0;
+
+  // Persistent cache, a sparse copy of the image and a map of which blocks it contains.
+  std::FILE* m_cache_data_fp = nullptr;
+  std::FILE* m_cache_map_fp = nullptr;
+
+  std::map<u32, std::vector<u8>> m_memory_blocks;
+
+  std::vector<u8> m_current_block;
+  u32 m_current_block_index = std::numeric_limits<u32>::max();
+};
+
+CDImageHTTP::CDImageHTTP() = default;
+
+CDImageHTTP::~CDImageHTTP()
+{
+  // callbacks reference the image, so make sure none are still outstanding
+  if (m_downloader)
+    m_downloader->WaitForAllRequests();
+
+  CloseCache();
+}
+
+bool CDImageHTTP::Open(const char* url, Common::Error* error)
+{
+  m_filename = url;
+
+  m_downloader = Common::HTTPDownloader::Create();
+  if (!m_downloader)
+  {
+    Log_ErrorPrintf("Failed to create HTTP downloader for '%s'", url);
+    if (error)
+      error->SetMessage("Failed to create HTTP downloader.");
+    return false;
+  }
+  m_downloader->SetMaxActiveRequests(MAX_PREFETCH_BLOCKS + 1);
+
+  const std::string cache_base_path =
+    s_http_cache_directory.empty() ?
+      std::string() :
+      Path::Combine(s_http_cache_directory, fmt::format("{:016x}", XXH64(m_filename.data(), m_filename.size(), 0)));
+
+  // the first block tells us how large the image is
+  s32 probe_status = -1;
+  u64 probe_size = 0;
+  std::vector<u8> probe_data;
+  m_downloader->CreateRangeRequest(
+    m_filename, 0, BLOCK_SIZE,
+    [&probe_status, &probe_size, &probe_data](s32 status_code, u64 resource_size, std::vector<u8> data) {
+      probe_status = status_code;
+      probe_size = resource_size;
+      probe_data = std::move(data);
+    });
+  m_downloader->WaitForAllRequests();
+
+  if (probe_status == Common::HTTPDownloader::HTTP_PARTIAL_CONTENT && probe_size > 0)
+  {
+    m_resource_size = probe_size;
+    m_block_count = static_cast<u32>((m_resource_size + (BLOCK_SIZE - 1)) / BLOCK_SIZE);
+    m_block_states.resize(m_block_count, BlockState::Missing);
+    if (!cache_base_path.empty() && !OpenCache(cache_base_path, m_resource_size))
+      Log_WarningPrintf("Failed to open cache for '%s', blocks will only be kept in memory", url);
+
+    if (probe_data.size() != GetBlockSize(0))
+    {
+      Log_ErrorPrintf("Server returned %zu bytes for first block of '%s', expected %u", probe_data.size(), url,
+                      GetBlockSize(0));
+      if (error)
+        error->SetMessage("Server returned an incomplete block.");
+      return false;
+    }
+
+    if (m_block_states[0] != BlockState::Cached)
+      StoreBlock(0, std::move(probe_data));
+  }
+  else if (probe_status == Common::HTTPDownloader::HTTP_OK)
+  {
+    Log_ErrorPrintf("Server for '%s' does not support range requests", url);
+    if (error)
+      error->SetMessage("Server does not support range requests.");
+    return false;
+  }
+  else if (cache_base_path.empty() || !OpenCache(cache_base_path, 0))
+  {
+    Log_ErrorPrintf("Failed to fetch '%s': status %d", url, probe_status);
+    if (error)
+      error->SetFormattedMessage("Failed to fetch image, HTTP status %d.", probe_status);
+    return false;
+  }
+  else
+  {
+    // carry on with whatever we downloaded last time, missing blocks will fail to read
+    Log_WarningPrintf("Failed to fetch '%s' (status %d), using cached blocks only", url, probe_status);
+  }
+
+  // same layout as a single bin file
+  m_lba_count = static_cast<u32>(m_resource_size / RAW_SECTOR_SIZE);
+
+  SubChannelQ::Control control = {};
+  TrackMode mode = TrackMode::Mode2Raw;
+  control.data = mode != TrackMode::Audio;
+
+  // Two seconds default pregap.
+  const u32 pregap_frames = 2 * FRAMES_PER_SECOND;
+  Index pregap_index = {};
+  pregap_index.file_sector_size = RAW_SECTOR_SIZE;
+  pregap_index.start_lba_on_disc = 0;
+  pregap_index.start_lba_in_track = static_cast<LBA>(-static_cast<s32>(pregap_frames));
+  pregap_index.length = pregap_frames;
+  pregap_index.track_number = 1;
+  pregap_index.index_number = 0;
+  pregap_index.mode = mode;
+  pregap_index.control.bits = control.bits;
+  pregap_index.is_pregap = true;
+  m_indices.push_back(pregap_index);
+
+  // Data index.
+  Index data_index = {};
+  data_index.file_index = 0;
+  data_index.file_offset = 0;
+  data_index.file_sector_size = RAW_SECTOR_SIZE;
+  data_index.start_lba_on_disc = pregap_index.length;
+  data_index.track_number = 1;
+  data_index.index_number = 1;
+  data_index.start_lba_in_track = 0;
+  data_index.length = m_lba_count;
+  data_index.mode = mode;
+  data_index.control.bits = control.bits;
+  m_indices.push_back(data_index);
+
+  // Assume a single track.
+  m_tracks.push_back(
+    Track{static_cast<u32>(1), data_index.start_lba_on_disc, static_cast<u32>(0), m_lba_count, mode, control});
+
+  AddLeadOutIndex();
+
+  Log_InfoPrintf("Streaming '%s': %" PRIu64 " bytes in %u blocks", url, m_resource_size, m_block_count);
+  return Seek(1, Position{0, 0, 0});
+}
+
+u32 CDImageHTTP::GetBlockSize(u32 block) const
+{
+  const u64 offset = static_cast<u64>(block) * BLOCK_SIZE;
+  return static_cast<u32>(std::min<u64>(m_resource_size - offset, BLOCK_SIZE));
+}
+
+bool CDImageHTTP::OpenCache(const std::string& base_path, u64 resource_size)
+{
+  const std::string data_path = base_path + ".bin";
+  const std::string map_path = base_path + ".map";
+
+  // reuse the existing cache if it's for an image of the same size
+  m_cache_map_fp = FileSystem::OpenCFile(map_path.c_str(), "r+b");
+  m_cache_data_fp = m_cache_map_fp ? FileSystem::OpenCFile(data_path.c_str(), "r+b") : nullptr;
+  if (m_cache_map_fp && m_cache_data_fp)
+  {
+    CacheHeader header;
+    if (std::fread(&header, sizeof(header), 1, m_cache_map_fp) == 1 && header.magic == CACHE_MAGIC &&
+        header.version == CACHE_VERSION && header.block_size == BLOCK_SIZE &&
+        (resource_size == 0 || header.resource_size == resource_size))
+    {
+      if (resource_size == 0)
+      {
+        m_resource_size = header.resource_size;
+        m_block_count = header.block_count;
+        m_block_states.resize(m_block_count, BlockState::Missing);
+      }
+
+      std::vector<u8> present(m_block_count);
+      if (header.block_count == m_block_count &&
+          std::fread(present.data(), present.size(), 1, m_cache_map_fp) == 1)
+      {
+        u32 cached_blocks = 0;
+        for (u32 i = 0; i < m_block_count; i++)
+        {
+          if (present[i] != 0)
+          {
+            m_block_states[i] = BlockState::Cached;
+            cached_blocks++;
+          }
+        }
+
+        Log_InfoPrintf("Using cache '%s' with %u of %u blocks", data_path.c_str(), cached_blocks, m_block_count);
+        return true;
+      }
+    }
+
+    Log_WarningPrintf("Discarding outdated cache '%s'", data_path.c_str());
+  }
+
+  CloseCache();
+  if (resource_size == 0)
+    return false;
+
+  // start a new cache
+  if (!FileSystem::EnsureDirectoryExists(s_http_cache_directory.c_str(), false))
+    return false;
+
+  m_cache_map_fp = FileSystem::OpenCFile(map_path.c_str(), "w+b");
+  m_cache_data_fp = FileSystem::OpenCFile(data_path.c_str(), "w+b");
+  if (!m_cache_map_fp || !m_cache_data_fp)
+  {
+    Log_ErrorPrintf("Failed to create cache '%s': errno %d", data_path.c_str(), errno);
+    CloseCache();
+    return false;
+  }
+
+  CacheHeader header;
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.block_size = BLOCK_SIZE;
+  header.block_count = m_block_count;
+  header.resource_size = resource_size;
+  const std::vector<u8> present(m_block_count, 0);
+  if (std::fwrite(&header, sizeof(header), 1, m_cache_map_fp) != 1 ||
+      std::fwrite(present.data(), present.size(), 1, m_cache_map_fp) != 1 || std::fflush(m_cache_map_fp) != 0)
+  {
+    Log_ErrorPrintf("Failed to write cache map '%s'", map_path.c_str());
+    CloseCache();
+    return false;
+  }
+
+  return true;
+}
+
+void CDImageHTTP::CloseCache()
+{
+  if (m_cache_data_fp)
+  {
+    std::fclose(m_cache_data_fp);
+    m_cache_data_fp = nullptr;
+  }
+  if (m_cache_map_fp)
+  {
+    std::fclose(m_cache_map_fp);
+    m_cache_map_fp = nullptr;
+  }
+}
+
+void CDImageHTTP::RequestBlock(u32 block)
+{
+  Log_DevPrintf("Requesting block %u of '%s'", block, m_filename.c_str());
+  m_block_states[block] = BlockState::Requested;
+  m_downloader->CreateRangeRequest(m_filename, static_cast<u64>(block) * BLOCK_SIZE, GetBlockSize(block),
+                                   [this, block](s32 status_code, u64 resource_size, std::vector<u8> data) {
+                                     OnBlockReceived(block, status_code, std::move(data));
+                                   });
+}
+
+void CDImageHTTP::OnBlockReceived(u32 block, s32 status_code, std::vector<u8> data)
+{
+  if (status_code != Common::HTTPDownloader::HTTP_PARTIAL_CONTENT || data.size() != GetBlockSize(block))
+  {
+    Log_ErrorPrintf("Failed to fetch block %u of '%s': status %d, %zu bytes", block, m_filename.c_str(), status_code,
+                    data.size());
+    m_block_states[block] = BlockState::Missing;
+    return;
+  }
+
+  StoreBlock(block, std::move(data));
+}
+
+void CDImageHTTP::StoreBlock(u32 block, std::vector<u8> data)
+{
+  if (m_cache_data_fp)
+  {
+    const u8 present = 1;
+    if (FileSystem::FSeek64(m_cache_data_fp, static_cast<s64>(block) * BLOCK_SIZE, SEEK_SET) == 0 &&
+        std::fwrite(data.data(), data.size(), 1, m_cache_data_fp) == 1 && std::fflush(m_cache_data_fp) == 0 &&
+        FileSystem::FSeek64(m_cache_map_fp, static_cast<s64>(sizeof(CacheHeader) + block), SEEK_SET) == 0 &&
+        std::fwrite(&present, sizeof(present), 1, m_cache_map_fp) == 1 && std::fflush(m_cache_map_fp) == 0)
+    {
+      m_block_states[block] = BlockState::Cached;
+      return;
+    }
+
+    Log_ErrorPrintf("Failed to write block %u to cache, keeping it in memory", block);
+  }
+
+  // drop whichever block is furthest from where we're reading
+  while (m_memory_blocks.size() >= MAX_MEMORY_BLOCKS)
+  {
+    auto furthest = m_memory_blocks.begin();
+    for (auto it = m_memory_blocks.begin(); it != m_memory_blocks.end(); ++it)
+    {
+      if (std::abs(static_cast<s64>(it->first) - block) > std::abs(static_cast<s64>(furthest->first) - block))
+        furthest = it;
+    }
+
+    m_block_states[furthest->first] = BlockState::Missing;
+    m_memory_blocks.erase(furthest);
+  }
+
+  m_memory_blocks[block] = std::move(data);
+  m_block_states[block] = BlockState::Cached;
+}
+
+bool CDImageHTTP::LoadBlock(u32 block)
+{
+  if (m_block_states[block] == BlockState::Missing)
+    RequestBlock(block);
+
+  // callbacks only run when we poll, so this is the only place blocks arrive
+  while (m_block_states[block] == BlockState::Requested)
+  {
+    m_downloader->PollRequests();
+    if (m_block_states[block] == BlockState::Requested)
+      Common::Timer::NanoSleep(1000000);
+  }
+
+  if (m_block_states[block] != BlockState::Cached)
+    return false;
+
+  auto it = m_memory_blocks.find(block);
+  if (it != m_memory_blocks.end())
+  {
+    m_current_block = it->second;
+  }
+  else
+  {
+    m_current_block.resize(GetBlockSize(block));
+    if (FileSystem::FSeek64(m_cache_data_fp, static_cast<s64>(block) * BLOCK_SIZE, SEEK_SET) != 0 ||
+        std::fread(m_current_block.data(), m_current_block.size(), 1, m_cache_data_fp) != 1)
+    {
+      Log_ErrorPrintf("Failed to read block %u from cache", block);
+      m_current_block_index = std::numeric_limits<u32>::max();
+      return false;
+    }
+  }
+
+  m_current_block_index = block;
+  return true;
+}
+
+void CDImageHTTP::PrefetchAfterBlock(u32 block)
+{
+  // at least one block ahead, and enough to cover what the reader wants ahead of the current sector
+  const u32 count =
+    std::min<u32>(1 + (m_readahead_sectors + (SECTORS_PER_BLOCK - 1)) / SECTORS_PER_BLOCK, MAX_PREFETCH_BLOCKS);
+  for (u32 i = 1; i <= count && (block + i) < m_block_count; i++)
+  {
+    if (m_block_states[block + i] == BlockState::Missing)
+      RequestBlock(block + i);
+  }
+}
+
+void CDImageHTTP::SetReadaheadHint(u32 sectors)
+{
+  m_readahead_sectors = sectors;
+}
+
+bool CDImageHTTP::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
+{
+  const u64 offset = index.file_offset + static_cast<u64>(lba_in_index) * index.file_sector_size;
+  const u32 block = static_cast<u32>(offset / BLOCK_SIZE);
+  const u32 offset_in_block = static_cast<u32>(offset % BLOCK_SIZE);
+  if (block >= m_block_count)
+    return false;
+
+  if (block != m_current_block_index)
+  {
+    const bool sequential = (block == m_current_block_index + 1);
+    if (!LoadBlock(block))
+      return false;
+
+    if (sequential)
+      PrefetchAfterBlock(block);
+  }
+  else
+  {
+    // hand completed prefetches over to the cache
+    m_downloader->PollRequests();
+  }
+
+  if ((offset_in_block + RAW_SECTOR_SIZE) > m_current_block.size())
+    return false;
+
+  std::memcpy(buffer, &m_current_block[offset_in_block], RAW_SECTOR_SIZE);
+  return true;
+}
+
+bool CDImage::IsHTTPURL(const char* filename)
+{
+  return (StringUtil::StartsWithNoCase(filename, "http://") || StringUtil::StartsWithNoCase(filename, "https://"));
+}
+
+void CDImage::SetHTTPCacheDirectory(std::string directory)
+{
+  s_http_cache_directory = std::move(directory);
+}
+
+std::unique_ptr<CDImage> CDImage::OpenHTTPImage(const char* url, Common::Error* error)
+{
+  // only raw images can be read block by block
+  std::string_view path(url);
+  path = path.substr(0, path.find_first_of("?#"));
+  if (!StringUtil::EndsWithNoCase(path, ".bin") && !StringUtil::EndsWithNoCase(path, ".img") &&
+      !StringUtil::EndsWithNoCase(path, ".iso"))
+  {
+    Log_ErrorPrintf("Only bin/img/iso images can be streamed: '%s'", url);
+    if (error)
+      error->SetMessage("Only bin/img/iso images can be streamed.");
+    return {};
+  }
+
+  std::unique_ptr<CDImageHTTP> image = std::make_unique<CDImageHTTP>();
+  if (!image->Open(url, error))
+    return {};
+
+  return image;
+}
@@ -5,12 +5,39 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "common/progress_callback.h"
+#include "common/threading.h"
 #include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <map>
 #include <sstream>
+#include <thread>
 Log_SetChannel(CDImageMemory);
 
+namespace {
+// Stops a preload's precache when the disc isn't wanted any more.
+class PreloadProgressCallback final : public BaseProgressCallback
+{
+public:
+  explicit PreloadProgressCallback(const std::atomic_bool& cancelled) : m_cancel_flag(cancelled) {}
+
+  bool IsCancelled() const override { return m_cancel_flag.load(std::memory_order_relaxed); }
+
+  void SetTitle(const char* title) override {}
+  void DisplayError(const char* message) override { Log_ErrorPrint(message); }
+  void DisplayWarning(const char* message) override { Log_WarningPrint(message); }
+  void DisplayInformation(const char* message) override { Log_InfoPrint(message); }
+  void DisplayDebugMessage(const char* message) override { Log_DevPrint(message); }
+  void ModalError(const char* message) override { Log_ErrorPrint(message); }
+  bool ModalConfirmation(const char* message) override { return false; }
+  void ModalInformation(const char* message) override { Log_InfoPrint(message); }
+
+private:
+  const std::atomic_bool& m_cancel_flag;
+};
+} // namespace
+
 class CDImageM3u : public CDImage
 {
 public:
@@ -27,6 +54,8 @@ public:
   u32 GetCurrentSubImage() const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
   bool SwitchSubImage(u32 index, Common::Error* error) override;
+  void ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed) override;
+  void ConfigureSubImagePreload(bool enabled, u32 precache_budget_mb) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -39,15 +68,35 @@ private:
     std::string title;
   };
 
+  void StartPreload(u32 index);
+  void CancelPreload();
+
+  /// Waits for the preload and returns its image if it's for index, otherwise discards it.
+  std::unique_ptr<CDImage> TakePreloadedImage(u32 index);
+
   std::vector<Entry> m_entries;
   std::unique_ptr<CDImage> m_current_image;
   u32 m_current_image_index = UINT32_C(0xFFFFFFFF);
+  u32 m_decompression_cache_blocks = 1;
+  bool m_decompression_prefetch = false;
+  bool m_precache_compressed = false;
   bool m_apply_patches = false;
+
+  // The preload thread owns m_preload_image until it's joined.
+  std::thread m_preload_thread;
+  std::unique_ptr<CDImage> m_preload_image;
+  u32 m_preload_image_index = UINT32_C(0xFFFFFFFF);
+  std::atomic_bool m_preload_cancelled{false};
+  bool m_preload_enabled = false;
+  u32 m_preload_budget_mb = 0;
 };
 
 CDImageM3u::CDImageM3u() = default;
 
-CDImageM3u::~CDImageM3u() = default;
+CDImageM3u::~CDImageM3u()
+{
+  CancelPreload();
+}
 
 bool CDImageM3u::Open(const char* path, bool apply_patches, Common::Error* error)
 {
@@ -133,7 +182,9 @@ bool CDImageM3u::SwitchSubImage(u32 index, Common::Error* error)
     return true;
 
   const Entry& entry = m_entries[index];
-  std::unique_ptr<CDImage> new_image = CDImage::Open(entry.filename.c_str(), m_apply_patches, error);
+  std::unique_ptr<CDImage> new_image = TakePreloadedImage(index);
+  if (!new_image)
+    new_image = CDImage::Open(entry.filename.c_str(), m_apply_patches, error);
   if (!new_image)
   {
     Log_ErrorPrintf("Failed to load subimage %u (%s)", index, entry.filename.c_str());
@@ -141,14 +192,99 @@ bool CDImageM3u::SwitchSubImage(u32 index, Common::Error* error)
   }
 
   CopyTOC(new_image.get());
+  new_image->ConfigureDecompressionCache(m_decompression_cache_blocks, m_decompression_prefetch,
+                                         m_precache_compressed);
   m_current_image = std::move(new_image);
   m_current_image_index = index;
   if (!Seek(1, Position{0, 0, 0}))
     Panic("Failed to seek to start after sub-image change.");
 
+  if (m_preload_enabled && (index + 1) < m_entries.size())
+    StartPreload(index + 1);
+
   return true;
 }
 
+void CDImageM3u::ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed)
+{
+  // applied to sub-images as they're switched to
+  m_decompression_cache_blocks = num_blocks;
+  m_decompression_prefetch = prefetch;
+  m_precache_compressed = precache_compressed;
+  m_current_image->ConfigureDecompressionCache(num_blocks, prefetch, precache_compressed);
+}
+
+void CDImageM3u::ConfigureSubImagePreload(bool enabled, u32 precache_budget_mb)
+{
+  m_preload_enabled = enabled;
+  m_preload_budget_mb = precache_budget_mb;
+  if (!enabled)
+  {
+    CancelPreload();
+    return;
+  }
+
+  const u32 next_index = m_current_image_index + 1;
+  if (next_index < m_entries.size() && (!m_preload_thread.joinable() || m_preload_image_index != next_index))
+    StartPreload(next_index);
+}
+
+void CDImageM3u::StartPreload(u32 index)
+{
+  CancelPreload();
+
+  Log_InfoPrintf("Preloading subimage %u (%s)", index, m_entries[index].filename.c_str());
+  m_preload_image_index = index;
+  m_preload_cancelled.store(false, std::memory_order_relaxed);
+  m_preload_thread = std::thread([this, filename = m_entries[index].filename, apply_patches = m_apply_patches,
+                                  cache_blocks = m_decompression_cache_blocks, prefetch = m_decompression_prefetch,
+                                  precache_compressed = m_precache_compressed,
+                                  budget = static_cast<u64>(m_preload_budget_mb) * 1048576u]() {
+    Threading::SetNameOfCurrentThread("Disc Preload");
+
+    std::unique_ptr<CDImage> image = CDImage::Open(filename.c_str(), apply_patches, nullptr);
+    if (!image)
+    {
+      Log_WarningPrintf("Failed to preload '%s'", filename.c_str());
+      return;
+    }
+
+    image->ConfigureDecompressionCache(cache_blocks, prefetch, precache_compressed);
+    if ((static_cast<u64>(image->GetLBACount()) * RAW_SECTOR_SIZE) <= budget)
+    {
+      PreloadProgressCallback callback(m_preload_cancelled);
+      if (image->Precache(&callback) == PrecacheResult::ReadError && !callback.IsCancelled())
+        Log_WarningPrintf("Failed to precache '%s', it will be read from disk", filename.c_str());
+    }
+
+    m_preload_image = std::move(image);
+  });
+}
+
+void CDImageM3u::CancelPreload()
+{
+  if (!m_preload_thread.joinable())
+    return;
+
+  m_preload_cancelled.store(true, std::memory_order_relaxed);
+  m_preload_thread.join();
+  m_preload_image.reset();
+  m_preload_image_index = UINT32_C(0xFFFFFFFF);
+}
+
+std::unique_ptr<CDImage> CDImageM3u::TakePreloadedImage(u32 index)
+{
+  if (!m_preload_thread.joinable() || m_preload_image_index != index)
+  {
+    CancelPreload();
+    return {};
+  }
+
+  m_preload_thread.join();
+  m_preload_image_index = UINT32_C(0xFFFFFFFF);
+  return std::move(m_preload_image);
+}
+
 std::string CDImageM3u::GetSubImageMetadata(u32 index, const std::string_view& type) const
 {
   if (index > m_entries.size())
@@ -5,12 +5,15 @@
 #include "common/file_system.h"
 #include "common/log.h"
 #include "common/path.h"
+#include "common/progress_callback.h"
 #include "common/string_util.h"
 #include "pbp_types.h"
 #include "string.h"
 #include "zlib.h"
+#include <algorithm>
 #include <array>
 #include <cstdio>
+#include <limits>
 #include <vector>
 Log_SetChannel(CDImagePBP);
 
@@ -36,6 +39,10 @@ public:
   std::string GetMetadata(const std::string_view& type) const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
 
+  PrecacheResult Precache(ProgressCallback* progress) override;
+  bool IsPrecached() const override;
+  void ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed) override;
+
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
@@ -60,9 +67,15 @@ private:
 
   bool IsValidEboot(Common::Error* error);
 
-  bool InitDecompressionStream();
+  static bool InitDecompressionStream(z_stream* stream);
+  static bool InflateBlock(z_stream* stream, const u8* compressed_block, u32 compressed_size, u8* decompressed_block);
+  static bool DecompressBlock(FILE* fp, z_stream* stream, std::vector<u8>& compressed_block, u8* decompressed_block,
+                              const BlockInfo& block_info);
   bool DecompressBlock(const BlockInfo& block_info);
 
+  u32 GetBlockCount() const;
+  PrecacheResult PrecacheCompressed(ProgressCallback* progress);
+
   bool OpenDisc(u32 index, Common::Error* error);
 
   static const std::string* LookupStringSFOTableEntry(const char* key, const SFOTable& table);
@@ -87,6 +100,14 @@ private:
   std::array<u8, DECOMPRESSED_BLOCK_SIZE> m_decompressed_block;
   std::vector<u8> m_compressed_block;
 
+  // Every block of the current disc, filled by Precache().
+  std::vector<u8> m_precached_blocks;
+
+  // Compressed blocks of the current disc, starting at m_precached_compressed_offset in the file.
+  std::vector<u8> m_precached_compressed_data;
+  u32 m_precached_compressed_offset = 0;
+  bool m_precache_compressed = false;
+
   z_stream m_inflate_stream;
 
   CDSubChannelReplacement m_sbi;
@@ -454,6 +475,9 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
   m_toc.fill({});
   m_decompressed_block.fill(0x00);
   m_compressed_block.clear();
+  m_precached_blocks = {};
+  m_precached_compressed_data = {};
+  m_precached_compressed_offset = 0;
 
   // Go to ISO header
   const u32 iso_header_start = m_disc_offsets[index];
@@ -667,7 +691,7 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
   AddLeadOutIndex();
 
   // Initialize zlib stream
-  if (!InitDecompressionStream())
+  if (!InitDecompressionStream(&m_inflate_stream))
   {
     Log_ErrorPrint("Failed to initialize zlib decompression stream");
     return false;
@@ -699,45 +723,48 @@ const std::string* CDImagePBP::LookupStringSFOTableEntry(const char* key, const
   return &std::get<std::string>(data_value);
 }
 
-bool CDImagePBP::InitDecompressionStream()
+bool CDImagePBP::InitDecompressionStream(z_stream* stream)
 {
-  m_inflate_stream = {};
-  m_inflate_stream.next_in = Z_NULL;
-  m_inflate_stream.avail_in = 0;
-  m_inflate_stream.zalloc = Z_NULL;
-  m_inflate_stream.zfree = Z_NULL;
-  m_inflate_stream.opaque = Z_NULL;
-
-  int ret = inflateInit2(&m_inflate_stream, -MAX_WBITS);
+  *stream = {};
+  stream->next_in = Z_NULL;
+  stream->avail_in = 0;
+  stream->zalloc = Z_NULL;
+  stream->zfree = Z_NULL;
+  stream->opaque = Z_NULL;
+
+  int ret = inflateInit2(stream, -MAX_WBITS);
   return ret == Z_OK;
 }
 
-bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
+bool CDImagePBP::DecompressBlock(FILE* fp, z_stream* stream, std::vector<u8>& compressed_block,
+                                 u8* decompressed_block, const BlockInfo& block_info)
 {
-  if (FSeek64(m_file, block_info.offset, SEEK_SET) != 0)
+  if (FSeek64(fp, block_info.offset, SEEK_SET) != 0)
     return false;
 
   // Compression level 0 has compressed size == decompressed size.
-  if (block_info.size == m_decompressed_block.size())
-  {
-    return (fread(m_decompressed_block.data(), sizeof(u8), m_decompressed_block.size(), m_file) ==
-            m_decompressed_block.size());
-  }
+  if (block_info.size == DECOMPRESSED_BLOCK_SIZE)
+    return (fread(decompressed_block, sizeof(u8), DECOMPRESSED_BLOCK_SIZE, fp) == DECOMPRESSED_BLOCK_SIZE);
 
-  m_compressed_block.resize(block_info.size);
+  compressed_block.resize(block_info.size);
 
-  if (fread(m_compressed_block.data(), sizeof(u8), m_compressed_block.size(), m_file) != m_compressed_block.size())
+  if (fread(compressed_block.data(), sizeof(u8), compressed_block.size(), fp) != compressed_block.size())
     return false;
 
-  m_inflate_stream.next_in = m_compressed_block.data();
-  m_inflate_stream.avail_in = static_cast<uInt>(m_compressed_block.size());
-  m_inflate_stream.next_out = m_decompressed_block.data();
-  m_inflate_stream.avail_out = static_cast<uInt>(m_decompressed_block.size());
+  return InflateBlock(stream, compressed_block.data(), block_info.size, decompressed_block);
+}
+
+bool CDImagePBP::InflateBlock(z_stream* stream, const u8* compressed_block, u32 compressed_size, u8* decompressed_block)
+{
+  stream->next_in = const_cast<u8*>(compressed_block);
+  stream->avail_in = static_cast<uInt>(compressed_size);
+  stream->next_out = decompressed_block;
+  stream->avail_out = static_cast<uInt>(DECOMPRESSED_BLOCK_SIZE);
 
-  if (inflateReset(&m_inflate_stream) != Z_OK)
+  if (inflateReset(stream) != Z_OK)
     return false;
 
-  int err = inflate(&m_inflate_stream, Z_FINISH);
+  int err = inflate(stream, Z_FINISH);
   if (err != Z_STREAM_END)
   {
     Log_ErrorPrintf("Inflate error %d", err);
@@ -747,6 +774,169 @@ bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
   return true;
 }
 
+bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
+{
+  if (m_precached_compressed_data.empty())
+    return DecompressBlock(m_file, &m_inflate_stream, m_compressed_block, m_decompressed_block.data(), block_info);
+
+  const u8* compressed_block = &m_precached_compressed_data[block_info.offset - m_precached_compressed_offset];
+  if (block_info.size == DECOMPRESSED_BLOCK_SIZE)
+  {
+    std::memcpy(m_decompressed_block.data(), compressed_block, DECOMPRESSED_BLOCK_SIZE);
+    return true;
+  }
+
+  return InflateBlock(&m_inflate_stream, compressed_block, block_info.size, m_decompressed_block.data());
+}
+
+u32 CDImagePBP::GetBlockCount() const
+{
+  u32 num_blocks = 0;
+  for (u32 i = 0; i < BLOCK_TABLE_NUM_ENTRIES; i++)
+  {
+    if (m_blockinfo_table[i].size != 0)
+      num_blocks = i + 1;
+  }
+
+  return num_blocks;
+}
+
+void CDImagePBP::ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed)
+{
+  m_precache_compressed = precache_compressed;
+}
+
+CDImage::PrecacheResult CDImagePBP::PrecacheCompressed(ProgressCallback* progress)
+{
+  u32 start_offset = std::numeric_limits<u32>::max();
+  u32 end_offset = 0;
+  for (const BlockInfo& bi : m_blockinfo_table)
+  {
+    if (bi.size == 0)
+      continue;
+
+    start_offset = std::min(start_offset, bi.offset);
+    end_offset = std::max(end_offset, bi.offset + bi.size);
+  }
+  if (start_offset >= end_offset)
+    return PrecacheResult::Unsupported;
+
+  static constexpr u32 CHUNK_SIZE = 1024 * 1024;
+  const u32 size = end_offset - start_offset;
+  const u32 num_chunks = (size + CHUNK_SIZE - 1) / CHUNK_SIZE;
+  progress->SetFormattedStatusText("Precaching %u compressed bytes...", size);
+  progress->SetProgressRange(num_chunks);
+  progress->SetProgressValue(0);
+
+  std::vector<u8> data(size);
+  if (FSeek64(m_file, start_offset, SEEK_SET) != 0)
+    return PrecacheResult::ReadError;
+
+  for (u32 i = 0; i < num_chunks; i++)
+  {
+    if (progress->IsCancelled())
+      return PrecacheResult::ReadError;
+
+    const u32 offset = i * CHUNK_SIZE;
+    const u32 chunk_size = std::min(size - offset, CHUNK_SIZE);
+    if (fread(&data[offset], sizeof(u8), chunk_size, m_file) != chunk_size)
+    {
+      Log_ErrorPrintf("Failed to read %u bytes at offset %u", chunk_size, start_offset + offset);
+      return PrecacheResult::ReadError;
+    }
+
+    progress->SetProgressValue(i + 1);
+  }
+
+  m_precached_compressed_data = std::move(data);
+  m_precached_compressed_offset = start_offset;
+  return PrecacheResult::Success;
+}
+
+CDImage::PrecacheResult CDImagePBP::Precache(ProgressCallback* progress)
+{
+  if (IsPrecached())
+    return PrecacheResult::Success;
+  else if (m_precache_compressed)
+    return PrecacheCompressed(progress);
+
+  const u32 num_blocks = GetBlockCount();
+  if (num_blocks == 0)
+    return PrecacheResult::Unsupported;
+
+  // Each worker needs its own zlib stream, and all but the calling thread need their own file handle.
+  struct Worker
+  {
+    FILE* fp = nullptr;
+    z_stream stream = {};
+    bool stream_initialized = false;
+    std::vector<u8> compressed_block;
+  };
+  const u32 num_workers = GetParallelDecompressionWorkerCount(num_blocks);
+  std::vector<Worker> workers(num_workers);
+  workers[0].fp = m_file;
+
+  auto close_workers = [this, &workers]() {
+    for (Worker& worker : workers)
+    {
+      if (worker.stream_initialized)
+        inflateEnd(&worker.stream);
+      if (worker.fp && worker.fp != m_file)
+        fclose(worker.fp);
+    }
+  };
+
+  for (u32 i = 0; i < num_workers; i++)
+  {
+    Worker& worker = workers[i];
+    if (i > 0)
+      worker.fp = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+    worker.stream_initialized = (worker.fp && InitDecompressionStream(&worker.stream));
+    if (!worker.stream_initialized)
+    {
+      Log_ErrorPrintf("Failed to reopen PBP '%s' for decompression", m_filename.c_str());
+      close_workers();
+      return PrecacheResult::ReadError;
+    }
+  }
+
+  progress->SetFormattedStatusText("Decompressing %u blocks...", num_blocks);
+
+  std::vector<u8> buffer(static_cast<size_t>(num_blocks) * DECOMPRESSED_BLOCK_SIZE);
+  const bool result =
+    DecompressBlocksInParallel(num_blocks, progress, [this, &workers, &buffer](u32 worker_index, u32 block_index) {
+      const BlockInfo& bi = m_blockinfo_table[block_index];
+      if (bi.size == 0)
+        return true;
+
+      Worker& worker = workers[worker_index];
+      if (!DecompressBlock(worker.fp, &worker.stream, worker.compressed_block,
+                           &buffer[static_cast<size_t>(block_index) * DECOMPRESSED_BLOCK_SIZE], bi))
+      {
+        Log_ErrorPrintf("Failed to decompress block %u", block_index);
+        return false;
+      }
+
+      return true;
+    });
+
+  close_workers();
+
+  // m_file was repositioned by worker zero
+  m_current_block = static_cast<u32>(-1);
+
+  if (!result)
+    return PrecacheResult::ReadError;
+
+  m_precached_blocks = std::move(buffer);
+  return PrecacheResult::Success;
+}
+
+bool CDImagePBP::IsPrecached() const
+{
+  return (!m_precached_blocks.empty() || !m_precached_compressed_data.empty());
+}
+
 bool CDImagePBP::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   if (m_sbi.GetReplacementSubChannelQ(index.start_lba_on_disc + lba_in_index, subq))
@@ -774,10 +964,24 @@ bool CDImagePBP::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
     return false;
   }
 
-  if (m_current_block != requested_block && !DecompressBlock(bi))
+  if (!m_precached_blocks.empty())
   {
-    Log_ErrorPrintf("Failed to decompress block %u", requested_block);
-    return false;
+    std::memcpy(buffer,
+                &m_precached_blocks[static_cast<size_t>(requested_block) * DECOMPRESSED_BLOCK_SIZE + offset_in_block],
+                RAW_SECTOR_SIZE);
+    return true;
+  }
+
+  if (m_current_block != requested_block)
+  {
+    if (!DecompressBlock(bi))
+    {
+      Log_ErrorPrintf("Failed to decompress block %u", requested_block);
+      m_current_block = static_cast<u32>(-1);
+      return false;
+    }
+
+    m_current_block = requested_block;
   }
 
   std::memcpy(buffer, &m_decompressed_block[offset_in_block], RAW_SECTOR_SIZE);
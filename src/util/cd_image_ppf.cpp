@@ -6,7 +6,7 @@
 #include <algorithm>
 #include <cerrno>
 #include <map>
-#include <unordered_map>
+#include <vector>
 Log_SetChannel(CDImagePPF);
 
 enum : u32
@@ -30,6 +30,8 @@ public:
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
 
   PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback) override;
+  void ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed) override;
+  void SetReadaheadHint(u32 sectors) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -41,10 +43,16 @@ private:
   u32 ReadFileIDDiz(std::FILE* fp, u32 version);
 
   bool AddPatch(u64 offset, const u8* patch, u32 patch_size);
+  u32 GetReplacementSectorCount() const;
+
+  static constexpr u32 NO_REPLACEMENT = 0xFFFFFFFFu;
 
   std::unique_ptr<CDImage> m_parent_image;
   std::vector<u8> m_replacement_data;
-  std::unordered_map<u32, u32> m_replacement_map;
+
+  // Offset of each sector on the disc in m_replacement_data, or NO_REPLACEMENT when it isn't patched. Indexed
+  // directly by LBA, so unpatched sectors only cost a load and a compare on every read.
+  std::vector<u32> m_replacement_sector_offsets;
   u32 m_replacement_offset = 0;
 };
 
@@ -78,6 +86,7 @@ bool CDImagePPF::Open(const char* filename, std::unique_ptr<CDImage> parent_imag
   m_tracks = parent_image->GetTracks();
   m_indices = parent_image->GetIndices();
   m_parent_image = std::move(parent_image);
+  m_replacement_sector_offsets.resize(m_parent_image->GetLBACount(), NO_REPLACEMENT);
 
   if (magic == 0x33465050) // PPF3
     return ReadV3Patch(fp.get());
@@ -177,7 +186,7 @@ bool CDImagePPF::ReadV1Patch(std::FILE* fp)
     count -= sizeof(offset) + sizeof(chunk_size) + chunk_size;
   }
 
-  Log_InfoPrintf("Loaded %zu replacement sectors from version 1 PPF", m_replacement_map.size());
+  Log_InfoPrintf("Loaded %u replacement sectors from version 1 PPF", GetReplacementSectorCount());
   return true;
 }
 
@@ -266,7 +275,7 @@ bool CDImagePPF::ReadV2Patch(std::FILE* fp)
     count -= sizeof(offset) + sizeof(chunk_size) + chunk_size;
   }
 
-  Log_InfoPrintf("Loaded %zu replacement sectors from version 2 PPF", m_replacement_map.size());
+  Log_InfoPrintf("Loaded %u replacement sectors from version 2 PPF", GetReplacementSectorCount());
   return true;
 }
 
@@ -346,7 +355,7 @@ bool CDImagePPF::ReadV3Patch(std::FILE* fp)
     count -= sizeof(offset) + sizeof(chunk_size) + chunk_size;
   }
 
-  Log_InfoPrintf("Loaded %zu replacement sectors from version 3 PPF", m_replacement_map.size());
+  Log_InfoPrintf("Loaded %u replacement sectors from version 3 PPF", GetReplacementSectorCount());
   return true;
 }
 
@@ -366,24 +375,24 @@ bool CDImagePPF::AddPatch(u64 offset, const u8* patch, u32 patch_size)
 
     const u32 bytes_to_patch = std::min(patch_size, RAW_SECTOR_SIZE - sector_offset);
 
-    auto iter = m_replacement_map.find(sector_index);
-    if (iter == m_replacement_map.end())
+    u32& replacement_buffer_start = m_replacement_sector_offsets[sector_index];
+    if (replacement_buffer_start == NO_REPLACEMENT)
     {
-      const u32 replacement_buffer_start = static_cast<u32>(m_replacement_data.size());
+      const u32 new_buffer_start = static_cast<u32>(m_replacement_data.size());
       m_replacement_data.resize(m_replacement_data.size() + RAW_SECTOR_SIZE);
       if (!m_parent_image->Seek(sector_index) ||
-          !m_parent_image->ReadRawSector(&m_replacement_data[replacement_buffer_start], nullptr))
+          !m_parent_image->ReadRawSector(&m_replacement_data[new_buffer_start], nullptr))
       {
         Log_ErrorPrintf("Failed to read sector %u from parent image", sector_index);
         return false;
       }
 
-      iter = m_replacement_map.emplace(sector_index, replacement_buffer_start).first;
+      replacement_buffer_start = new_buffer_start;
     }
 
     // patch it!
     Log_DebugPrintf("  Patching %u bytes at sector %u offset %u", bytes_to_patch, sector_index, sector_offset);
-    std::memcpy(&m_replacement_data[iter->second + sector_offset], patch, bytes_to_patch);
+    std::memcpy(&m_replacement_data[replacement_buffer_start + sector_offset], patch, bytes_to_patch);
     offset += bytes_to_patch;
     patch += bytes_to_patch;
     patch_size -= bytes_to_patch;
@@ -392,6 +401,11 @@ bool CDImagePPF::AddPatch(u64 offset, const u8* patch, u32 patch_size)
   return true;
 }
 
+u32 CDImagePPF::GetReplacementSectorCount() const
+{
+  return static_cast<u32>(m_replacement_data.size() / RAW_SECTOR_SIZE);
+}
+
 bool CDImagePPF::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   return m_parent_image->ReadSubChannelQ(subq, index, lba_in_index);
@@ -422,16 +436,28 @@ CDImage::PrecacheResult CDImagePPF::Precache(ProgressCallback* progress /*= Prog
   return m_parent_image->Precache(progress);
 }
 
+void CDImagePPF::ConfigureDecompressionCache(u32 num_blocks, bool prefetch, bool precache_compressed)
+{
+  m_parent_image->ConfigureDecompressionCache(num_blocks, prefetch, precache_compressed);
+}
+
+void CDImagePPF::SetReadaheadHint(u32 sectors)
+{
+  m_parent_image->SetReadaheadHint(sectors);
+}
+
 bool CDImagePPF::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   DebugAssert(index.file_index == 0);
 
   const u32 sector_number = index.start_lba_on_disc + lba_in_index;
-  const auto it = m_replacement_map.find(sector_number);
-  if (it == m_replacement_map.end())
+  const u32 replacement_buffer_start = (sector_number < m_replacement_sector_offsets.size()) ?
+                                         m_replacement_sector_offsets[sector_number] :
+                                         NO_REPLACEMENT;
+  if (replacement_buffer_start == NO_REPLACEMENT)
     return m_parent_image->ReadSectorFromIndex(buffer, index, lba_in_index);
 
-  std::memcpy(buffer, &m_replacement_data[it->second], RAW_SECTOR_SIZE);
+  std::memcpy(buffer, &m_replacement_data[replacement_buffer_start], RAW_SECTOR_SIZE);
   return true;
 }
 
@@ -218,9 +218,17 @@ bool File::HandleFileCommand(const char* line, u32 line_number, Common::Error* e
     return false;
   }
 
-  if (!TokenMatch(mode, "BINARY"))
+  if (TokenMatch(mode, "BINARY"))
   {
-    SetError(line_number, error, "Only BINARY modes are supported");
+    m_current_file_type = FileType::Binary;
+  }
+  else if (TokenMatch(mode, "WAVE"))
+  {
+    m_current_file_type = FileType::Wave;
+  }
+  else
+  {
+    SetError(line_number, error, "Only BINARY and WAVE modes are supported");
     return false;
   }
 
@@ -281,6 +289,7 @@ bool File::HandleTrackCommand(const char* line, u32 line_number, Common::Error*
   m_current_track = Track();
   m_current_track->number = static_cast<u32>(track_number.value());
   m_current_track->file = m_current_file.value();
+  m_current_track->file_type = m_current_file_type;
   m_current_track->mode = mode;
   return true;
 }
@@ -23,6 +23,12 @@ enum : s32
   MAX_INDEX_NUMBER = 99
 };
 
+enum class FileType : u8
+{
+  Binary,
+  Wave,
+};
+
 enum class TrackFlag : u32
 {
   PreEmphasis = (1 << 0),
@@ -36,6 +42,7 @@ struct Track
   u32 number;
   u32 flags;
   std::string file;
+  FileType file_type;
   std::vector<std::pair<u32, MSF>> indices;
   TrackMode mode;
   MSF start;
@@ -80,6 +87,7 @@ private:
 
   std::vector<Track> m_tracks;
   std::optional<std::string> m_current_file;
+  FileType m_current_file_type = FileType::Binary;
   std::optional<Track> m_current_track;
 };
 
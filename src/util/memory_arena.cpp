@@ -94,6 +94,19 @@ void* MemoryArena::FindBaseAddressForMapping(size_t size)
   return base_address;
 }
 
+size_t MemoryArena::GetPageSize()
+{
+#if defined(_WIN32)
+  SYSTEM_INFO si;
+  GetSystemInfo(&si);
+  return si.dwPageSize;
+#elif defined(__linux__) || defined(ANDROID) || defined(__APPLE__) || defined(__FreeBSD__)
+  return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+  return 4096;
+#endif
+}
+
 bool MemoryArena::IsValid() const
 {
 #if defined(_WIN32)
@@ -359,6 +372,22 @@ bool MemoryArena::SetPageProtection(void* address, size_t length, bool readable,
 #endif
 }
 
+bool MemoryArena::AdviseHugePages(void* address, size_t length)
+{
+#if defined(__linux__) && !defined(ANDROID) && defined(MADV_HUGEPAGE)
+  if (madvise(address, length, MADV_HUGEPAGE) != 0)
+  {
+    Log_WarningPrintf("madvise(%p, %zu, MADV_HUGEPAGE) failed: %d", address, length, errno);
+    return false;
+  }
+
+  return true;
+#else
+  // Windows can only use large pages for new allocations, and needs SeLockMemoryPrivilege.
+  return false;
+#endif
+}
+
 MemoryArena::View::View(MemoryArena* parent, void* base_pointer, size_t arena_offset, size_t mapping_size,
                         bool writable)
   : m_parent(parent), m_base_pointer(base_pointer), m_arena_offset(arena_offset), m_mapping_size(mapping_size),
@@ -37,6 +37,9 @@ public:
 
   static void* FindBaseAddressForMapping(size_t size);
 
+  /// Returns the granularity of page protection on the host, e.g. 16KB on Apple Silicon.
+  static size_t GetPageSize();
+
   ALWAYS_INLINE size_t GetSize() const { return m_size; }
   ALWAYS_INLINE bool IsWritable() const { return m_writable; }
   ALWAYS_INLINE bool IsExecutable() const { return m_executable; }
@@ -59,6 +62,9 @@ public:
 
   static bool SetPageProtection(void* address, size_t length, bool readable, bool writable, bool executable);
 
+  /// Asks the kernel to back the range with transparent huge pages. Only a hint, returns false if unsupported.
+  static bool AdviseHugePages(void* address, size_t length);
+
 private:
 #if defined(_WIN32)
   void* m_file_handle = nullptr;
@@ -7,6 +7,7 @@
 #include <deque>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 class String;
@@ -21,10 +22,16 @@ public:
   };
 
   StateWrapper(ByteStream* stream, Mode mode, u32 version);
+
+  /// Serializes directly to/from a contiguous buffer, skipping the virtual stream calls. The stream format is the
+  /// same. When writing, size is the capacity of the buffer, and the number of bytes written is GetPosition().
+  StateWrapper(u8* buffer, size_t size, Mode mode, u32 version);
+
   StateWrapper(const StateWrapper&) = delete;
   ~StateWrapper();
 
   ByteStream* GetStream() const { return m_stream; }
+  u64 GetPosition() const { return m_buffer ? m_buffer_position : m_stream->GetPosition(); }
   bool HasError() const { return m_error; }
   bool IsReading() const { return (m_mode == Mode::Read); }
   bool IsWriting() const { return (m_mode == Mode::Write); }
@@ -32,19 +39,22 @@ public:
   void SetMode(Mode mode) { m_mode = mode; }
   u32 GetVersion() const { return m_version; }
 
+  /// When set, the name and position of each marker written is appended to the log.
+  void SetMarkerLog(std::vector<std::pair<const char*, u64>>* log) { m_marker_log = log; }
+
   /// Overload for integral or floating-point types. Writes bytes as-is.
   template<typename T, std::enable_if_t<std::is_integral_v<T> || std::is_floating_point_v<T>, int> = 0>
   void Do(T* value_ptr)
   {
     if (m_mode == Mode::Read)
     {
-      if (m_error || (m_error |= !m_stream->Read2(value_ptr, sizeof(T))) == true)
+      if (m_error || (m_error |= !ReadData(value_ptr, sizeof(T))) == true)
         *value_ptr = static_cast<T>(0);
     }
     else
     {
       if (!m_error)
-        m_error |= !m_stream->Write2(value_ptr, sizeof(T));
+        m_error |= !WriteData(value_ptr, sizeof(T));
     }
   }
 
@@ -56,7 +66,7 @@ public:
     if (m_mode == Mode::Read)
     {
       TType temp;
-      if (m_error || (m_error |= !m_stream->Read2(&temp, sizeof(TType))) == true)
+      if (m_error || (m_error |= !ReadData(&temp, sizeof(TType))) == true)
         temp = static_cast<TType>(0);
 
       *value_ptr = static_cast<T>(temp);
@@ -66,7 +76,7 @@ public:
       TType temp;
       std::memcpy(&temp, value_ptr, sizeof(TType));
       if (!m_error)
-        m_error |= !m_stream->Write2(&temp, sizeof(TType));
+        m_error |= !WriteData(&temp, sizeof(TType));
     }
   }
 
@@ -76,21 +86,29 @@ public:
   {
     if (m_mode == Mode::Read)
     {
-      if (m_error || (m_error |= !m_stream->Read2(value_ptr, sizeof(T))) == true)
+      if (m_error || (m_error |= !ReadData(value_ptr, sizeof(T))) == true)
         std::memset(value_ptr, 0, sizeof(*value_ptr));
     }
     else
     {
       if (!m_error)
-        m_error |= !m_stream->Write2(value_ptr, sizeof(T));
+        m_error |= !WriteData(value_ptr, sizeof(T));
     }
   }
 
   template<typename T>
   void DoArray(T* values, size_t count)
   {
-    for (size_t i = 0; i < count; i++)
-      Do(&values[i]);
+    // values are written as-is, so arrays of them can be copied in one go
+    if constexpr ((std::is_integral_v<T> || std::is_floating_point_v<T>) && !std::is_same_v<T, bool>)
+    {
+      DoBytes(values, sizeof(T) * count);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; i++)
+        Do(&values[i]);
+    }
   }
 
   template<typename T>
@@ -196,12 +214,53 @@ public:
       return;
     }
 
-    if (!m_error)
+    if (m_error)
+      return;
+
+    if (m_buffer)
+    {
+      m_error = (count > (m_buffer_size - m_buffer_position));
+      if (!m_error)
+        m_buffer_position += count;
+    }
+    else
+    {
       m_error = !m_stream->SeekRelative(static_cast<s64>(count));
+    }
   }
 
 private:
-  ByteStream* m_stream;
+  ALWAYS_INLINE bool ReadData(void* data, size_t length)
+  {
+    if (!m_buffer)
+      return m_stream->Read2(data, static_cast<u32>(length));
+
+    if (length > (m_buffer_size - m_buffer_position))
+      return false;
+
+    std::memcpy(data, m_buffer + m_buffer_position, length);
+    m_buffer_position += length;
+    return true;
+  }
+
+  ALWAYS_INLINE bool WriteData(const void* data, size_t length)
+  {
+    if (!m_buffer)
+      return m_stream->Write2(data, static_cast<u32>(length));
+
+    if (length > (m_buffer_size - m_buffer_position))
+      return false;
+
+    std::memcpy(m_buffer + m_buffer_position, data, length);
+    m_buffer_position += length;
+    return true;
+  }
+
+  ByteStream* m_stream = nullptr;
+  std::vector<std::pair<const char*, u64>>* m_marker_log = nullptr;
+  u8* m_buffer = nullptr;
+  size_t m_buffer_size = 0;
+  size_t m_buffer_position = 0;
   Mode m_mode;
   u32 m_version;
   bool m_error = false;
@@ -1,8 +1,13 @@
 #include "wav_writer.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include <utility>
 Log_SetChannel(WAVWriter);
 
+// 64KiB buffers, at most ~6 seconds of 44.1KHz stereo audio waiting to be written
+static constexpr u32 BUFFER_SIZE = 64 * 1024;
+static constexpr u32 MAX_QUEUED_BUFFERS = 16;
+
 #pragma pack(push, 1)
 struct WAV_HEADER
 {
@@ -51,6 +56,9 @@ bool WAVWriter::Open(const char* filename, u32 sample_rate, u32 num_channels)
 
   m_sample_rate = sample_rate;
   m_num_channels = num_channels;
+  m_num_frames = 0;
+  m_num_frames_written = 0;
+  m_buffer.reserve(BUFFER_SIZE / sizeof(SampleType));
 
   if (!WriteHeader())
   {
@@ -70,6 +78,10 @@ void WAVWriter::Close()
   if (!IsOpen())
     return;
 
+  if (!m_buffer.empty())
+    QueueBuffer();
+  m_write_group.Wait(Threading::ThreadPool::GetShared());
+
   if (std::fseek(m_file, 0, SEEK_SET) != 0 || !WriteHeader())
     Log_ErrorPrintf("Failed to re-write header on file, file may be unplayable");
 
@@ -78,21 +90,64 @@ void WAVWriter::Close()
   m_sample_rate = 0;
   m_num_channels = 0;
   m_num_frames = 0;
+  m_num_frames_written = 0;
+  m_buffer = {};
 }
 
 void WAVWriter::WriteFrames(const s16* samples, u32 num_frames)
 {
-  const u32 num_frames_written =
-    static_cast<u32>(std::fwrite(samples, sizeof(s16) * m_num_channels, num_frames, m_file));
-  if (num_frames_written != num_frames)
-    Log_ErrorPrintf("Only wrote %u of %u frames to output file", num_frames_written, num_frames);
+  m_buffer.insert(m_buffer.end(), samples, samples + num_frames * m_num_channels);
+  m_num_frames += num_frames;
+
+  if ((m_buffer.size() * sizeof(SampleType)) >= BUFFER_SIZE)
+    QueueBuffer();
+}
+
+void WAVWriter::QueueBuffer()
+{
+  std::vector<SampleType> buffer;
+  buffer.reserve(BUFFER_SIZE / sizeof(SampleType));
+  std::swap(buffer, m_buffer);
+
+  std::unique_lock lock(m_queue_mutex);
+  m_queue_cv.wait(lock, [this]() { return (m_queue.size() < MAX_QUEUED_BUFFERS); });
+  m_queue.push_back(std::move(buffer));
+  if (m_writer_active)
+    return;
+
+  m_writer_active = true;
+  lock.unlock();
+
+  Threading::ThreadPool::GetShared().Submit([this]() { WriteQueuedBuffers(); }, Threading::ThreadPool::Priority::Low,
+                                            &m_write_group);
+}
+
+void WAVWriter::WriteQueuedBuffers()
+{
+  std::unique_lock lock(m_queue_mutex);
+  while (!m_queue.empty())
+  {
+    std::vector<SampleType> buffer = std::move(m_queue.front());
+    m_queue.pop_front();
+    m_queue_cv.notify_one();
+    lock.unlock();
+
+    const u32 num_frames = static_cast<u32>(buffer.size() / m_num_channels);
+    const u32 num_frames_written =
+      static_cast<u32>(std::fwrite(buffer.data(), sizeof(SampleType) * m_num_channels, num_frames, m_file));
+    if (num_frames_written != num_frames)
+      Log_ErrorPrintf("Only wrote %u of %u frames to output file", num_frames_written, num_frames);
+
+    m_num_frames_written += num_frames_written;
+    lock.lock();
+  }
 
-  m_num_frames += num_frames_written;
+  m_writer_active = false;
 }
 
 bool WAVWriter::WriteHeader()
 {
-  const u32 data_size = sizeof(SampleType) * m_num_channels * m_num_frames;
+  const u32 data_size = sizeof(SampleType) * m_num_channels * m_num_frames_written;
 
   WAV_HEADER header = {};
   header.chunk_id = 0x46464952; // 0x52494646
@@ -1,6 +1,11 @@
 #pragma once
+#include "common/thread_pool.h"
 #include "common/types.h"
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <mutex>
+#include <vector>
 
 namespace Common {
 
@@ -18,17 +23,31 @@ public:
   bool Open(const char* filename, u32 sample_rate, u32 num_channels);
   void Close();
 
+  /// Frames are buffered and written to the file on the shared thread pool, so slow storage doesn't hold up the
+  /// caller. Only blocks when too much audio is already waiting to be written.
   void WriteFrames(const s16* samples, u32 num_frames);
 
 private:
   using SampleType = s16;
 
   bool WriteHeader();
+  void QueueBuffer();
+  void WriteQueuedBuffers();
 
   std::FILE* m_file = nullptr;
   u32 m_sample_rate = 0;
   u32 m_num_channels = 0;
   u32 m_num_frames = 0;
+
+  std::vector<SampleType> m_buffer;
+
+  // buffers waiting for the file, a task on the shared pool owns the file while m_writer_active is set
+  std::mutex m_queue_mutex;
+  std::condition_variable m_queue_cv;
+  std::deque<std::vector<SampleType>> m_queue;
+  bool m_writer_active = false;
+  u32 m_num_frames_written = 0;
+  Threading::ThreadPool::TaskGroup m_write_group;
 };
 
 } // namespace Common
\ No newline at end of file